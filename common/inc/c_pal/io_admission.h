@@ -0,0 +1,69 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef IO_ADMISSION_H
+#define IO_ADMISSION_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+typedef struct IO_ADMISSION_TAG* IO_ADMISSION_HANDLE;
+
+typedef void(*IO_ADMISSION_ON_ADMITTED)(void* context);
+
+/*IO_ADMISSION_PRIORITY_LOW waiters are only admitted when no IO_ADMISSION_PRIORITY_NORMAL waiter is queued*/
+#define IO_ADMISSION_PRIORITY_VALUES \
+    IO_ADMISSION_PRIORITY_NORMAL, \
+    IO_ADMISSION_PRIORITY_LOW
+MU_DEFINE_ENUM(IO_ADMISSION_PRIORITY, IO_ADMISSION_PRIORITY_VALUES);
+
+/*to be embedded by the caller in its per-I/O context, it must stay valid until on_admitted is called*/
+typedef struct IO_ADMISSION_WAITER_TAG
+{
+    IO_ADMISSION_ON_ADMITTED on_admitted;
+    void* on_admitted_context;
+    IO_ADMISSION_PRIORITY priority;
+    struct IO_ADMISSION_WAITER_TAG* next; /*owned by the admission while the waiter is queued*/
+} IO_ADMISSION_WAITER;
+
+/*IO_ADMISSION_QUEUED: on_admitted of the waiter is called once a slot is released for it*/
+#define IO_ADMISSION_RESULT_VALUES \
+    IO_ADMISSION_ADMITTED, \
+    IO_ADMISSION_QUEUED, \
+    IO_ADMISSION_BUSY, \
+    IO_ADMISSION_ERROR
+MU_DEFINE_ENUM(IO_ADMISSION_RESULT, IO_ADMISSION_RESULT_VALUES);
+
+typedef struct IO_ADMISSION_STATISTICS_TAG
+{
+    uint32_t max_outstanding_count;
+    uint32_t outstanding_count; /*I/Os that hold a slot*/
+    uint32_t peak_outstanding_count;
+    uint32_t queued_count; /*I/Os waiting for a slot*/
+    uint32_t peak_queued_count;
+    uint64_t busy_count; /*number of times io_admission_try_acquire returned IO_ADMISSION_BUSY*/
+} IO_ADMISSION_STATISTICS;
+
+#include "umock_c/umock_c_prod.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    MOCKABLE_FUNCTION(, IO_ADMISSION_HANDLE, io_admission_create, uint32_t, max_outstanding_count);
+    MOCKABLE_FUNCTION(, void, io_admission_destroy, IO_ADMISSION_HANDLE, admission);
+
+    MOCKABLE_FUNCTION_WITH_RETURNS(, IO_ADMISSION_RESULT, io_admission_try_acquire, IO_ADMISSION_HANDLE, admission)(IO_ADMISSION_ADMITTED, IO_ADMISSION_ERROR);
+    MOCKABLE_FUNCTION_WITH_RETURNS(, IO_ADMISSION_RESULT, io_admission_acquire, IO_ADMISSION_HANDLE, admission, IO_ADMISSION_WAITER*, waiter)(IO_ADMISSION_ADMITTED, IO_ADMISSION_ERROR);
+    MOCKABLE_FUNCTION(, void, io_admission_release, IO_ADMISSION_HANDLE, admission);
+
+    MOCKABLE_FUNCTION_WITH_RETURNS(, int, io_admission_get_statistics, IO_ADMISSION_HANDLE, admission, IO_ADMISSION_STATISTICS*, statistics)(0, MU_FAILURE);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IO_ADMISSION_H
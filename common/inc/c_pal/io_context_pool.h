@@ -0,0 +1,41 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef IO_CONTEXT_POOL_H
+#define IO_CONTEXT_POOL_H
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+typedef struct IO_CONTEXT_POOL_TAG* IO_CONTEXT_POOL_HANDLE;
+
+typedef struct IO_CONTEXT_POOL_STATISTICS_TAG
+{
+    uint64_t hit_count; /*number of contexts handed out from the pool*/
+    uint64_t miss_count; /*number of contexts that had to be allocated*/
+} IO_CONTEXT_POOL_STATISTICS;
+
+#include "umock_c/umock_c_prod.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    MOCKABLE_FUNCTION(, IO_CONTEXT_POOL_HANDLE, io_context_pool_create, size_t, context_size, uint32_t, max_cached_count);
+    MOCKABLE_FUNCTION(, void, io_context_pool_destroy, IO_CONTEXT_POOL_HANDLE, pool);
+
+    MOCKABLE_FUNCTION(, void*, io_context_pool_get, IO_CONTEXT_POOL_HANDLE, pool, size_t, size);
+    MOCKABLE_FUNCTION(, void, io_context_pool_release, IO_CONTEXT_POOL_HANDLE, pool, void*, context);
+
+    MOCKABLE_FUNCTION_WITH_RETURNS(, int, io_context_pool_get_statistics, IO_CONTEXT_POOL_HANDLE, pool, IO_CONTEXT_POOL_STATISTICS*, statistics)(0, MU_FAILURE);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IO_CONTEXT_POOL_H
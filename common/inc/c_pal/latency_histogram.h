@@ -0,0 +1,50 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_pal/interlocked.h"
+
+/*bucket 0 counts the samples under 1 microsecond, bucket i counts the samples of at least 2^(i-1) and under 2^i microseconds, the last bucket counts all the longer samples*/
+#define LATENCY_HISTOGRAM_BUCKET_COUNT 24
+
+/*to be embedded by the owner, recording a sample does not allocate or take a lock*/
+typedef struct LATENCY_HISTOGRAM_TAG
+{
+    volatile_atomic int64_t sample_count;
+    volatile_atomic int64_t total_us;
+    volatile_atomic int64_t max_us;
+    volatile_atomic int64_t bucket_counts[LATENCY_HISTOGRAM_BUCKET_COUNT];
+} LATENCY_HISTOGRAM;
+
+typedef struct LATENCY_HISTOGRAM_STATISTICS_TAG
+{
+    uint64_t sample_count;
+    uint64_t total_us;
+    uint64_t max_us;
+    uint64_t bucket_counts[LATENCY_HISTOGRAM_BUCKET_COUNT];
+} LATENCY_HISTOGRAM_STATISTICS;
+
+#include "umock_c/umock_c_prod.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    MOCKABLE_FUNCTION(, void, latency_histogram_init, LATENCY_HISTOGRAM*, histogram);
+    MOCKABLE_FUNCTION(, void, latency_histogram_record, LATENCY_HISTOGRAM*, histogram, double, latency_us);
+    /*adds the samples of histogram to statistics, so that the histograms of several threads can be merged when they are read*/
+    MOCKABLE_FUNCTION(, void, latency_histogram_add_to_statistics, LATENCY_HISTOGRAM*, histogram, LATENCY_HISTOGRAM_STATISTICS*, statistics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,63 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef READ_AHEAD_H
+#define READ_AHEAD_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdbool.h>
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+typedef struct READ_AHEAD_TAG* READ_AHEAD_HANDLE;
+
+/*a block read that the owner has to issue*/
+typedef struct READ_AHEAD_IO_TAG
+{
+    uint64_t position; /*multiple of the block size of the read-ahead*/
+    unsigned char* buffer; /*aligned to the alignment of the read-ahead*/
+    uint32_t size; /*the block size of the read-ahead*/
+} READ_AHEAD_IO;
+
+typedef void(*READ_AHEAD_READ_CB)(void* user_context, bool is_successful);
+
+/*shall start reading io from the file and call read_ahead_io_complete when done, returns 0 if the I/O was started*/
+typedef int(*READ_AHEAD_ISSUE_IO)(void* context, READ_AHEAD_IO* io);
+
+#define READ_AHEAD_MODE_VALUES \
+    READ_AHEAD_MODE_AUTO, \
+    READ_AHEAD_MODE_SEQUENTIAL, \
+    READ_AHEAD_MODE_OFF
+MU_DEFINE_ENUM(READ_AHEAD_MODE, READ_AHEAD_MODE_VALUES);
+
+/*READ_AHEAD_READ_OK: the user callback is called once the block is read, READ_AHEAD_READ_COPIED: the data was copied and the user callback is not called*/
+#define READ_AHEAD_READ_RESULT_VALUES \
+    READ_AHEAD_READ_OK, \
+    READ_AHEAD_READ_COPIED, \
+    READ_AHEAD_READ_NOT_HANDLED, \
+    READ_AHEAD_READ_ERROR
+MU_DEFINE_ENUM(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_RESULT_VALUES);
+
+#include "umock_c/umock_c_prod.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    MOCKABLE_FUNCTION(, READ_AHEAD_HANDLE, read_ahead_create, uint32_t, alignment, uint32_t, block_size, uint32_t, block_count, READ_AHEAD_ISSUE_IO, issue_io, void*, context);
+    MOCKABLE_FUNCTION(, void, read_ahead_destroy, READ_AHEAD_HANDLE, read_ahead);
+
+    MOCKABLE_FUNCTION_WITH_RETURNS(, int, read_ahead_set_mode, READ_AHEAD_HANDLE, read_ahead, READ_AHEAD_MODE, mode)(0, MU_FAILURE);
+    MOCKABLE_FUNCTION_WITH_RETURNS(, READ_AHEAD_READ_RESULT, read_ahead_read, READ_AHEAD_HANDLE, read_ahead, unsigned char*, destination, uint32_t, size, uint64_t, position, READ_AHEAD_READ_CB, user_callback, void*, user_context)(READ_AHEAD_READ_OK, READ_AHEAD_READ_ERROR);
+    MOCKABLE_FUNCTION_WITH_RETURNS(, int, read_ahead_will_need, READ_AHEAD_HANDLE, read_ahead, uint64_t, position, uint64_t, size)(0, MU_FAILURE);
+    MOCKABLE_FUNCTION(, void, read_ahead_invalidate, READ_AHEAD_HANDLE, read_ahead, uint64_t, position, uint64_t, size);
+
+    MOCKABLE_FUNCTION(, void, read_ahead_io_complete, READ_AHEAD_HANDLE, read_ahead, READ_AHEAD_IO*, io, bool, is_successful, uint32_t, bytes_read);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // READ_AHEAD_H
@@ -0,0 +1,33 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef THREADPOOL_SERIAL_QUEUE_H
+#define THREADPOOL_SERIAL_QUEUE_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_pal/threadpool.h"
+
+typedef struct THREADPOOL_SERIAL_QUEUE_TAG* THREADPOOL_SERIAL_QUEUE_HANDLE;
+
+#include "umock_c/umock_c_prod.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    /*max_batch_size is the number of work items executed before the threadpool thread is yielded, 0 means no limit*/
+    MOCKABLE_FUNCTION(, THREADPOOL_SERIAL_QUEUE_HANDLE, threadpool_serial_queue_create, THREADPOOL_HANDLE, threadpool, uint32_t, max_batch_size);
+    MOCKABLE_FUNCTION(, void, threadpool_serial_queue_destroy, THREADPOOL_SERIAL_QUEUE_HANDLE, serial_queue);
+
+    MOCKABLE_FUNCTION(, int, threadpool_serial_queue_schedule_work, THREADPOOL_SERIAL_QUEUE_HANDLE, serial_queue, THREADPOOL_WORK_FUNCTION, work_function, void*, work_function_context);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // THREADPOOL_SERIAL_QUEUE_H
@@ -0,0 +1,53 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef THREADPOOL_STATISTICS_H
+#define THREADPOOL_STATISTICS_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_pal/interlocked.h"
+#include "c_pal/latency_histogram.h"
+#include "c_pal/threadpool.h"
+
+typedef struct THREADPOOL_STATISTICS_RECORDER_TAG* THREADPOOL_STATISTICS_RECORDER_HANDLE;
+
+/*to be embedded in the timer instance of the threadpool implementations*/
+typedef struct THREADPOOL_TIMER_LATENESS_TAG
+{
+    volatile_atomic int64_t due_time_us; /*as returned by timer_global_get_elapsed_us*/
+    volatile_atomic int32_t period_ms;
+    LATENCY_HISTOGRAM lateness;
+} THREADPOOL_TIMER_LATENESS;
+
+#include "umock_c/umock_c_prod.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    MOCKABLE_FUNCTION(, THREADPOOL_STATISTICS_RECORDER_HANDLE, threadpool_statistics_recorder_create);
+    MOCKABLE_FUNCTION(, void, threadpool_statistics_recorder_destroy, THREADPOOL_STATISTICS_RECORDER_HANDLE, recorder);
+
+    MOCKABLE_FUNCTION(, void, threadpool_statistics_recorder_on_queued, THREADPOOL_STATISTICS_RECORDER_HANDLE, recorder, uint32_t, work_item_count);
+    /*returns the time the work item started, to be passed to threadpool_statistics_recorder_on_completed*/
+    MOCKABLE_FUNCTION(, double, threadpool_statistics_recorder_on_started, THREADPOOL_STATISTICS_RECORDER_HANDLE, recorder, double, schedule_time_us);
+    /*returns the time the work item completed*/
+    MOCKABLE_FUNCTION(, double, threadpool_statistics_recorder_on_completed, THREADPOOL_STATISTICS_RECORDER_HANDLE, recorder, double, start_time_us);
+    /*fills everything but idle_worker_count, which only the threadpool implementation knows*/
+    MOCKABLE_FUNCTION(, void, threadpool_statistics_recorder_get, THREADPOOL_STATISTICS_RECORDER_HANDLE, recorder, THREADPOOL_STATISTICS*, statistics);
+
+    MOCKABLE_FUNCTION(, void, threadpool_timer_lateness_init, THREADPOOL_TIMER_LATENESS*, timer_lateness);
+    MOCKABLE_FUNCTION(, void, threadpool_timer_lateness_set_due_time, THREADPOOL_TIMER_LATENESS*, timer_lateness, uint32_t, start_delay_ms, uint32_t, period_ms);
+    MOCKABLE_FUNCTION(, void, threadpool_timer_lateness_on_fired, THREADPOOL_TIMER_LATENESS*, timer_lateness);
+    MOCKABLE_FUNCTION(, void, threadpool_timer_lateness_get, THREADPOOL_TIMER_LATENESS*, timer_lateness, THREADPOOL_TIMER_STATISTICS*, statistics);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // THREADPOOL_STATISTICS_H
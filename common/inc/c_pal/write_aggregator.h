@@ -0,0 +1,59 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef WRITE_AGGREGATOR_H
+#define WRITE_AGGREGATOR_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdbool.h>
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+typedef struct WRITE_AGGREGATOR_TAG* WRITE_AGGREGATOR_HANDLE;
+
+/*an aggregated I/O that the owner has to write to the file*/
+typedef struct WRITE_AGGREGATOR_IO_TAG
+{
+    uint64_t position; /*multiple of the alignment of the aggregator*/
+    const unsigned char* buffer; /*aligned to the alignment of the aggregator*/
+    uint32_t size; /*multiple of the alignment of the aggregator*/
+} WRITE_AGGREGATOR_IO;
+
+typedef void(*WRITE_AGGREGATOR_WRITE_CB)(void* user_context, bool is_successful);
+
+/*shall start writing io to the file and call write_aggregator_io_complete when done, returns 0 if the I/O was started*/
+typedef int(*WRITE_AGGREGATOR_ISSUE_IO)(void* context, WRITE_AGGREGATOR_IO* io);
+/*shall call write_aggregator_on_timer with timer_id once delay_ms have elapsed, returns 0 if the timer was started*/
+typedef int(*WRITE_AGGREGATOR_START_TIMER)(void* context, uint32_t delay_ms, uint64_t timer_id);
+/*shall set the size of the file to file_size (dropping the padding written after the data), returns 0 if the size was set*/
+typedef int(*WRITE_AGGREGATOR_SET_FILE_SIZE)(void* context, uint64_t file_size);
+
+#define WRITE_AGGREGATOR_ADD_RESULT_VALUES \
+    WRITE_AGGREGATOR_ADD_OK, \
+    WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, \
+    WRITE_AGGREGATOR_ADD_ERROR
+MU_DEFINE_ENUM(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_RESULT_VALUES);
+
+#include "umock_c/umock_c_prod.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    MOCKABLE_FUNCTION(, WRITE_AGGREGATOR_HANDLE, write_aggregator_create, uint32_t, alignment, uint32_t, max_aggregated_size, uint32_t, max_delay_ms, uint64_t, file_size, WRITE_AGGREGATOR_ISSUE_IO, issue_io, WRITE_AGGREGATOR_START_TIMER, start_timer, WRITE_AGGREGATOR_SET_FILE_SIZE, set_file_size, void*, context);
+    MOCKABLE_FUNCTION(, void, write_aggregator_destroy, WRITE_AGGREGATOR_HANDLE, write_aggregator);
+
+    MOCKABLE_FUNCTION_WITH_RETURNS(, WRITE_AGGREGATOR_ADD_RESULT, write_aggregator_add, WRITE_AGGREGATOR_HANDLE, write_aggregator, const unsigned char*, source, uint32_t, size, uint64_t, position, WRITE_AGGREGATOR_WRITE_CB, user_callback, void*, user_context)(WRITE_AGGREGATOR_ADD_OK, WRITE_AGGREGATOR_ADD_ERROR);
+    MOCKABLE_FUNCTION(, void, write_aggregator_note_write, WRITE_AGGREGATOR_HANDLE, write_aggregator, uint64_t, position, uint64_t, size);
+    MOCKABLE_FUNCTION(, void, write_aggregator_flush, WRITE_AGGREGATOR_HANDLE, write_aggregator);
+
+    MOCKABLE_FUNCTION(, void, write_aggregator_on_timer, WRITE_AGGREGATOR_HANDLE, write_aggregator, uint64_t, timer_id);
+    MOCKABLE_FUNCTION(, void, write_aggregator_io_complete, WRITE_AGGREGATOR_HANDLE, write_aggregator, WRITE_AGGREGATOR_IO*, io, bool, is_successful);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WRITE_AGGREGATOR_H
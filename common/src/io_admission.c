@@ -0,0 +1,315 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/srw_lock.h"
+
+#include "c_pal/io_admission.h"
+
+MU_DEFINE_ENUM_STRINGS(IO_ADMISSION_RESULT, IO_ADMISSION_RESULT_VALUES)
+MU_DEFINE_ENUM_STRINGS(IO_ADMISSION_PRIORITY, IO_ADMISSION_PRIORITY_VALUES)
+
+typedef struct IO_ADMISSION_QUEUE_TAG
+{
+    IO_ADMISSION_WAITER* first_waiter;
+    IO_ADMISSION_WAITER* last_waiter;
+} IO_ADMISSION_QUEUE;
+
+typedef struct IO_ADMISSION_TAG
+{
+    uint32_t max_outstanding_count;
+
+    SRW_LOCK_HANDLE lock;
+
+    /*all the fields below are protected by lock*/
+    uint32_t outstanding_count;
+    uint32_t peak_outstanding_count;
+    uint32_t queued_count;
+    uint32_t peak_queued_count;
+    uint64_t busy_count;
+    IO_ADMISSION_QUEUE normal_priority_queue;
+    IO_ADMISSION_QUEUE low_priority_queue;
+} IO_ADMISSION;
+
+/*called with the lock held, there is no free slot while I/Os are queued since io_admission_release hands the slots to them*/
+static bool try_take_slot(IO_ADMISSION_HANDLE admission)
+{
+    bool result;
+
+    if (admission->outstanding_count >= admission->max_outstanding_count)
+    {
+        result = false;
+    }
+    else
+    {
+        admission->outstanding_count++;
+        if (admission->outstanding_count > admission->peak_outstanding_count)
+        {
+            admission->peak_outstanding_count = admission->outstanding_count;
+        }
+        result = true;
+    }
+
+    return result;
+}
+
+static void queue_init(IO_ADMISSION_QUEUE* queue)
+{
+    queue->first_waiter = NULL;
+    queue->last_waiter = NULL;
+}
+
+static void queue_append(IO_ADMISSION_QUEUE* queue, IO_ADMISSION_WAITER* waiter)
+{
+    waiter->next = NULL;
+    if (queue->last_waiter == NULL)
+    {
+        queue->first_waiter = waiter;
+    }
+    else
+    {
+        queue->last_waiter->next = waiter;
+    }
+    queue->last_waiter = waiter;
+}
+
+static IO_ADMISSION_WAITER* queue_remove_first(IO_ADMISSION_QUEUE* queue)
+{
+    IO_ADMISSION_WAITER* result = queue->first_waiter;
+    if (result != NULL)
+    {
+        queue->first_waiter = result->next;
+        if (queue->first_waiter == NULL)
+        {
+            queue->last_waiter = NULL;
+        }
+    }
+    return result;
+}
+
+IO_ADMISSION_HANDLE io_admission_create(uint32_t max_outstanding_count)
+{
+    IO_ADMISSION_HANDLE result;
+
+    if (max_outstanding_count == 0)
+    {
+        /*Codes_SRS_IO_ADMISSION_01_001: [ If max_outstanding_count is 0, io_admission_create shall fail and return NULL. ]*/
+        LogError("Invalid arguments: uint32_t max_outstanding_count=%" PRIu32 "", max_outstanding_count);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_IO_ADMISSION_01_002: [ io_admission_create shall allocate memory for the admission. ]*/
+        result = malloc(sizeof(IO_ADMISSION));
+        if (result == NULL)
+        {
+            /*Codes_SRS_IO_ADMISSION_01_004: [ If any error occurs, io_admission_create shall fail and return NULL. ]*/
+            LogError("failure in malloc(sizeof(IO_ADMISSION)=%zu)", sizeof(IO_ADMISSION));
+        }
+        else
+        {
+            /*Codes_SRS_IO_ADMISSION_01_024: [ io_admission_create shall create the lock by calling srw_lock_create. ]*/
+            result->lock = srw_lock_create(false, "io_admission");
+            if (result->lock == NULL)
+            {
+                /*Codes_SRS_IO_ADMISSION_01_004: [ If any error occurs, io_admission_create shall fail and return NULL. ]*/
+                LogError("failure in srw_lock_create(false, \"io_admission\")");
+                free(result);
+                result = NULL;
+            }
+            else
+            {
+                /*Codes_SRS_IO_ADMISSION_01_003: [ io_admission_create shall set the number of outstanding and queued I/Os and all the counters to 0 and succeed. ]*/
+                result->max_outstanding_count = max_outstanding_count;
+                result->outstanding_count = 0;
+                result->peak_outstanding_count = 0;
+                result->queued_count = 0;
+                result->peak_queued_count = 0;
+                result->busy_count = 0;
+                queue_init(&result->normal_priority_queue);
+                queue_init(&result->low_priority_queue);
+            }
+        }
+    }
+
+    return result;
+}
+
+void io_admission_destroy(IO_ADMISSION_HANDLE admission)
+{
+    if (admission == NULL)
+    {
+        /*Codes_SRS_IO_ADMISSION_01_005: [ If admission is NULL, io_admission_destroy shall return. ]*/
+        LogError("Invalid arguments: IO_ADMISSION_HANDLE admission=%p", admission);
+    }
+    else
+    {
+        /*Codes_SRS_IO_ADMISSION_01_006: [ io_admission_destroy shall destroy the lock and free the memory of the admission. ]*/
+        srw_lock_destroy(admission->lock);
+        free(admission);
+    }
+}
+
+IO_ADMISSION_RESULT io_admission_try_acquire(IO_ADMISSION_HANDLE admission)
+{
+    IO_ADMISSION_RESULT result;
+
+    if (admission == NULL)
+    {
+        /*Codes_SRS_IO_ADMISSION_01_007: [ If admission is NULL, io_admission_try_acquire shall fail and return IO_ADMISSION_ERROR. ]*/
+        LogError("Invalid arguments: IO_ADMISSION_HANDLE admission=%p", admission);
+        result = IO_ADMISSION_ERROR;
+    }
+    else
+    {
+        srw_lock_acquire_exclusive(admission->lock);
+
+        /*Codes_SRS_IO_ADMISSION_01_008: [ If no I/O is queued and fewer than max_outstanding_count I/Os are outstanding, io_admission_try_acquire shall increment the number of outstanding I/Os, update the peak number of outstanding I/Os and return IO_ADMISSION_ADMITTED. ]*/
+        if (try_take_slot(admission))
+        {
+            result = IO_ADMISSION_ADMITTED;
+        }
+        else
+        {
+            /*Codes_SRS_IO_ADMISSION_01_009: [ Otherwise io_admission_try_acquire shall increment the busy counter and return IO_ADMISSION_BUSY. ]*/
+            admission->busy_count++;
+            result = IO_ADMISSION_BUSY;
+        }
+
+        srw_lock_release_exclusive(admission->lock);
+    }
+
+    return result;
+}
+
+IO_ADMISSION_RESULT io_admission_acquire(IO_ADMISSION_HANDLE admission, IO_ADMISSION_WAITER* waiter)
+{
+    IO_ADMISSION_RESULT result;
+
+    if (
+        /*Codes_SRS_IO_ADMISSION_01_010: [ If admission is NULL, io_admission_acquire shall fail and return IO_ADMISSION_ERROR. ]*/
+        (admission == NULL) ||
+        /*Codes_SRS_IO_ADMISSION_01_011: [ If waiter is NULL, io_admission_acquire shall fail and return IO_ADMISSION_ERROR. ]*/
+        (waiter == NULL) ||
+        /*Codes_SRS_IO_ADMISSION_01_012: [ If the on_admitted field of waiter is NULL, io_admission_acquire shall fail and return IO_ADMISSION_ERROR. ]*/
+        (waiter->on_admitted == NULL) ||
+        /*Codes_SRS_IO_ADMISSION_01_022: [ If the priority field of waiter is not IO_ADMISSION_PRIORITY_NORMAL or IO_ADMISSION_PRIORITY_LOW, io_admission_acquire shall fail and return IO_ADMISSION_ERROR. ]*/
+        ((waiter->priority != IO_ADMISSION_PRIORITY_NORMAL) && (waiter->priority != IO_ADMISSION_PRIORITY_LOW))
+        )
+    {
+        LogError("Invalid arguments: IO_ADMISSION_HANDLE admission=%p, IO_ADMISSION_WAITER* waiter=%p, IO_ADMISSION_ON_ADMITTED on_admitted=%p, IO_ADMISSION_PRIORITY priority=%" PRI_MU_ENUM "",
+            admission, waiter, (waiter == NULL) ? NULL : (void*)waiter->on_admitted, MU_ENUM_VALUE(IO_ADMISSION_PRIORITY, (waiter == NULL) ? IO_ADMISSION_PRIORITY_NORMAL : waiter->priority));
+        result = IO_ADMISSION_ERROR;
+    }
+    else
+    {
+        srw_lock_acquire_exclusive(admission->lock);
+
+        /*Codes_SRS_IO_ADMISSION_01_013: [ If no I/O is queued and fewer than max_outstanding_count I/Os are outstanding, io_admission_acquire shall increment the number of outstanding I/Os, update the peak number of outstanding I/Os and return IO_ADMISSION_ADMITTED. ]*/
+        if (try_take_slot(admission))
+        {
+            result = IO_ADMISSION_ADMITTED;
+        }
+        else
+        {
+            /*Codes_SRS_IO_ADMISSION_01_014: [ Otherwise io_admission_acquire shall append waiter to the queue of its priority, increment the number of queued I/Os, update the peak number of queued I/Os and return IO_ADMISSION_QUEUED. ]*/
+            queue_append((waiter->priority == IO_ADMISSION_PRIORITY_LOW) ? &admission->low_priority_queue : &admission->normal_priority_queue, waiter);
+
+            admission->queued_count++;
+            if (admission->queued_count > admission->peak_queued_count)
+            {
+                admission->peak_queued_count = admission->queued_count;
+            }
+            result = IO_ADMISSION_QUEUED;
+        }
+
+        srw_lock_release_exclusive(admission->lock);
+    }
+
+    return result;
+}
+
+void io_admission_release(IO_ADMISSION_HANDLE admission)
+{
+    if (admission == NULL)
+    {
+        /*Codes_SRS_IO_ADMISSION_01_015: [ If admission is NULL, io_admission_release shall return. ]*/
+        LogError("Invalid arguments: IO_ADMISSION_HANDLE admission=%p", admission);
+    }
+    else
+    {
+        IO_ADMISSION_WAITER* admitted_waiter;
+
+        srw_lock_acquire_exclusive(admission->lock);
+
+        /*Codes_SRS_IO_ADMISSION_01_023: [ io_admission_release shall take the first waiter of the IO_ADMISSION_PRIORITY_NORMAL queue if it is not empty and the first waiter of the IO_ADMISSION_PRIORITY_LOW queue otherwise. ]*/
+        admitted_waiter = queue_remove_first(&admission->normal_priority_queue);
+        if (admitted_waiter == NULL)
+        {
+            admitted_waiter = queue_remove_first(&admission->low_priority_queue);
+        }
+
+        if (admitted_waiter != NULL)
+        {
+            /*Codes_SRS_IO_ADMISSION_01_016: [ If an I/O is queued, io_admission_release shall remove the first waiter from the queue and decrement the number of queued I/Os, the released slot is handed to that waiter. ]*/
+            admission->queued_count--;
+        }
+        else
+        {
+            /*Codes_SRS_IO_ADMISSION_01_017: [ Otherwise io_admission_release shall decrement the number of outstanding I/Os. ]*/
+            admission->outstanding_count--;
+        }
+
+        srw_lock_release_exclusive(admission->lock);
+
+        if (admitted_waiter != NULL)
+        {
+            /*Codes_SRS_IO_ADMISSION_01_018: [ io_admission_release shall call the on_admitted callback of the removed waiter with its on_admitted_context, without holding the lock. ]*/
+            admitted_waiter->on_admitted(admitted_waiter->on_admitted_context);
+        }
+    }
+}
+
+int io_admission_get_statistics(IO_ADMISSION_HANDLE admission, IO_ADMISSION_STATISTICS* statistics)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_IO_ADMISSION_01_019: [ If admission is NULL, io_admission_get_statistics shall fail and return a non-zero value. ]*/
+        (admission == NULL) ||
+        /*Codes_SRS_IO_ADMISSION_01_020: [ If statistics is NULL, io_admission_get_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments: IO_ADMISSION_HANDLE admission=%p, IO_ADMISSION_STATISTICS* statistics=%p", admission, statistics);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        srw_lock_acquire_shared(admission->lock);
+
+        /*Codes_SRS_IO_ADMISSION_01_021: [ io_admission_get_statistics shall fill statistics with max_outstanding_count, the current and peak numbers of outstanding and queued I/Os and the busy counter and return 0. ]*/
+        statistics->max_outstanding_count = admission->max_outstanding_count;
+        statistics->outstanding_count = admission->outstanding_count;
+        statistics->peak_outstanding_count = admission->peak_outstanding_count;
+        statistics->queued_count = admission->queued_count;
+        statistics->peak_queued_count = admission->peak_queued_count;
+        statistics->busy_count = admission->busy_count;
+
+        srw_lock_release_shared(admission->lock);
+
+        result = 0;
+    }
+
+    return result;
+}
@@ -0,0 +1,285 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+
+#include "c_pal/io_context_pool.h"
+
+#ifdef _MSC_VER
+#define IO_CONTEXT_POOL_THREAD_LOCAL __declspec(thread)
+#else
+#define IO_CONTEXT_POOL_THREAD_LOCAL _Thread_local
+#endif
+
+/*only the address of this variable is used, it is different for every thread*/
+static IO_CONTEXT_POOL_THREAD_LOCAL uint8_t io_context_pool_thread_marker;
+
+typedef union IO_CONTEXT_POOL_BLOCK_HEADER_TAG
+{
+    bool is_pooled; /*false for blocks bigger than context_size, which bypass the pool*/
+    /*the members below make sure the context that follows the header is suitably aligned*/
+    void* align_pointer;
+    uint64_t align_uint64;
+    double align_double;
+} IO_CONTEXT_POOL_BLOCK_HEADER;
+
+typedef struct IO_CONTEXT_POOL_SLOT_TAG
+{
+    /*either NULL or owns one cached block. Blocks move in and out of the slots with a single interlocked operation, so there is no ABA problem*/
+    void* volatile_atomic block;
+    /*counted by the threads that start at this slot, so that threads starting at different slots do not update the same counters*/
+    volatile_atomic int64_t hit_count;
+    volatile_atomic int64_t miss_count;
+} IO_CONTEXT_POOL_SLOT;
+
+typedef struct IO_CONTEXT_POOL_TAG
+{
+    size_t context_size;
+    uint32_t max_cached_count;
+    IO_CONTEXT_POOL_SLOT slots[];
+} IO_CONTEXT_POOL;
+
+/*Codes_SRS_IO_CONTEXT_POOL_01_027: [ The start slot of a thread shall be computed from the address of a thread local variable, so that threads start looking at different slots. ]*/
+static uint32_t get_start_slot(IO_CONTEXT_POOL_HANDLE pool)
+{
+    /*Fibonacci hashing spreads the thread local addresses, which are usually far apart and equally aligned*/
+    uint64_t hash = (uint64_t)(uintptr_t)&io_context_pool_thread_marker * 0x9E3779B97F4A7C15ULL;
+    return (uint32_t)(hash >> 32) % pool->max_cached_count;
+}
+
+IO_CONTEXT_POOL_HANDLE io_context_pool_create(size_t context_size, uint32_t max_cached_count)
+{
+    IO_CONTEXT_POOL_HANDLE result;
+
+    if (
+        /*Codes_SRS_IO_CONTEXT_POOL_01_001: [ If context_size is 0, io_context_pool_create shall fail and return NULL. ]*/
+        (context_size == 0) ||
+        /*Codes_SRS_IO_CONTEXT_POOL_01_002: [ If context_size is greater than SIZE_MAX - sizeof(IO_CONTEXT_POOL_BLOCK_HEADER), io_context_pool_create shall fail and return NULL. ]*/
+        (context_size > SIZE_MAX - sizeof(IO_CONTEXT_POOL_BLOCK_HEADER)) ||
+        /*Codes_SRS_IO_CONTEXT_POOL_01_003: [ If max_cached_count is 0, io_context_pool_create shall fail and return NULL. ]*/
+        (max_cached_count == 0)
+        )
+    {
+        LogError("Invalid arguments: size_t context_size=%zu, uint32_t max_cached_count=%" PRIu32 "",
+            context_size, max_cached_count);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_IO_CONTEXT_POOL_01_004: [ io_context_pool_create shall allocate memory for the pool and for max_cached_count slots. ]*/
+        result = malloc(sizeof(IO_CONTEXT_POOL) + (size_t)max_cached_count * sizeof(IO_CONTEXT_POOL_SLOT));
+        if (result == NULL)
+        {
+            /*Codes_SRS_IO_CONTEXT_POOL_01_006: [ If any error occurs, io_context_pool_create shall fail and return NULL. ]*/
+            LogError("failure in malloc, max_cached_count=%" PRIu32 "", max_cached_count);
+        }
+        else
+        {
+            result->context_size = context_size;
+            result->max_cached_count = max_cached_count;
+
+            /*Codes_SRS_IO_CONTEXT_POOL_01_005: [ io_context_pool_create shall initialize all slots to NULL and the hit and miss counters of all slots to 0. ]*/
+            for (uint32_t i = 0; i < max_cached_count; i++)
+            {
+                (void)interlocked_exchange_pointer(&result->slots[i].block, NULL);
+                (void)interlocked_exchange_64(&result->slots[i].hit_count, 0);
+                (void)interlocked_exchange_64(&result->slots[i].miss_count, 0);
+            }
+        }
+    }
+
+    return result;
+}
+
+void io_context_pool_destroy(IO_CONTEXT_POOL_HANDLE pool)
+{
+    if (pool == NULL)
+    {
+        /*Codes_SRS_IO_CONTEXT_POOL_01_007: [ If pool is NULL, io_context_pool_destroy shall return. ]*/
+        LogError("Invalid arguments: IO_CONTEXT_POOL_HANDLE pool=%p", pool);
+    }
+    else
+    {
+        /*Codes_SRS_IO_CONTEXT_POOL_01_008: [ io_context_pool_destroy shall free all the cached blocks. ]*/
+        for (uint32_t i = 0; i < pool->max_cached_count; i++)
+        {
+            void* block = interlocked_exchange_pointer(&pool->slots[i].block, NULL);
+            if (block != NULL)
+            {
+                free(block);
+            }
+        }
+
+        /*Codes_SRS_IO_CONTEXT_POOL_01_009: [ io_context_pool_destroy shall free the memory of the pool. ]*/
+        free(pool);
+    }
+}
+
+void* io_context_pool_get(IO_CONTEXT_POOL_HANDLE pool, size_t size)
+{
+    void* result;
+
+    if (
+        /*Codes_SRS_IO_CONTEXT_POOL_01_010: [ If pool is NULL, io_context_pool_get shall fail and return NULL. ]*/
+        (pool == NULL) ||
+        /*Codes_SRS_IO_CONTEXT_POOL_01_011: [ If size is 0, io_context_pool_get shall fail and return NULL. ]*/
+        (size == 0) ||
+        /*Codes_SRS_IO_CONTEXT_POOL_01_012: [ If size is greater than SIZE_MAX - sizeof(IO_CONTEXT_POOL_BLOCK_HEADER), io_context_pool_get shall fail and return NULL. ]*/
+        (size > SIZE_MAX - sizeof(IO_CONTEXT_POOL_BLOCK_HEADER))
+        )
+    {
+        LogError("Invalid arguments: IO_CONTEXT_POOL_HANDLE pool=%p, size_t size=%zu", pool, size);
+        result = NULL;
+    }
+    else
+    {
+        IO_CONTEXT_POOL_BLOCK_HEADER* block = NULL;
+        uint32_t start_slot = get_start_slot(pool);
+
+        if (size <= pool->context_size)
+        {
+            /*Codes_SRS_IO_CONTEXT_POOL_01_013: [ If size is less than or equal to context_size, io_context_pool_get shall look at every slot once, starting at the start slot of the calling thread, and take ownership of the first cached block it finds by exchanging its slot with NULL. ]*/
+            uint32_t slot_index = start_slot;
+            for (uint32_t i = 0; i < pool->max_cached_count; i++)
+            {
+                /*Codes_SRS_IO_CONTEXT_POOL_01_028: [ io_context_pool_get shall only call interlocked_exchange_pointer on slots that are not NULL when read. ]*/
+                /*a plain read does not lock the bus, so looking at an empty pool does not cost max_cached_count interlocked operations*/
+                if (pool->slots[slot_index].block != NULL)
+                {
+                    block = interlocked_exchange_pointer(&pool->slots[slot_index].block, NULL);
+                    if (block != NULL)
+                    {
+                        break;
+                    }
+                }
+
+                slot_index++;
+                if (slot_index == pool->max_cached_count)
+                {
+                    slot_index = 0;
+                }
+            }
+        }
+
+        if (block != NULL)
+        {
+            /*Codes_SRS_IO_CONTEXT_POOL_01_014: [ If a cached block was found, io_context_pool_get shall increment the hit counter of the start slot of the calling thread and return the context of the block. ]*/
+            (void)interlocked_increment_64(&pool->slots[start_slot].hit_count);
+            result = block + 1;
+        }
+        else
+        {
+            /*Codes_SRS_IO_CONTEXT_POOL_01_015: [ Otherwise io_context_pool_get shall increment the miss counter of the start slot of the calling thread. ]*/
+            (void)interlocked_increment_64(&pool->slots[start_slot].miss_count);
+
+            bool is_pooled = (size <= pool->context_size);
+
+            /*Codes_SRS_IO_CONTEXT_POOL_01_016: [ If size is less than or equal to context_size, io_context_pool_get shall allocate a block big enough for a header and context_size bytes. ]*/
+            /*Codes_SRS_IO_CONTEXT_POOL_01_017: [ If size is greater than context_size, io_context_pool_get shall allocate a block big enough for a header and size bytes and mark the block as not pooled. ]*/
+            block = malloc(sizeof(IO_CONTEXT_POOL_BLOCK_HEADER) + (is_pooled ? pool->context_size : size));
+            if (block == NULL)
+            {
+                /*Codes_SRS_IO_CONTEXT_POOL_01_019: [ If any error occurs, io_context_pool_get shall fail and return NULL. ]*/
+                LogError("failure in malloc, size=%zu, context_size=%zu", size, pool->context_size);
+                result = NULL;
+            }
+            else
+            {
+                /*Codes_SRS_IO_CONTEXT_POOL_01_018: [ io_context_pool_get shall return the memory following the header. ]*/
+                block->is_pooled = is_pooled;
+                result = block + 1;
+            }
+        }
+    }
+
+    return result;
+}
+
+void io_context_pool_release(IO_CONTEXT_POOL_HANDLE pool, void* context)
+{
+    if (
+        /*Codes_SRS_IO_CONTEXT_POOL_01_020: [ If pool is NULL, io_context_pool_release shall return. ]*/
+        (pool == NULL) ||
+        /*Codes_SRS_IO_CONTEXT_POOL_01_021: [ If context is NULL, io_context_pool_release shall return. ]*/
+        (context == NULL)
+        )
+    {
+        LogError("Invalid arguments: IO_CONTEXT_POOL_HANDLE pool=%p, void* context=%p", pool, context);
+    }
+    else
+    {
+        IO_CONTEXT_POOL_BLOCK_HEADER* block = (IO_CONTEXT_POOL_BLOCK_HEADER*)context - 1;
+        bool is_cached = false;
+
+        if (block->is_pooled)
+        {
+            /*Codes_SRS_IO_CONTEXT_POOL_01_022: [ If the block is pooled, io_context_pool_release shall look at every slot once, starting at the start slot of the calling thread, and store the block in the first empty slot by calling interlocked_compare_exchange_pointer. ]*/
+            uint32_t slot_index = get_start_slot(pool);
+            for (uint32_t i = 0; i < pool->max_cached_count; i++)
+            {
+                /*Codes_SRS_IO_CONTEXT_POOL_01_029: [ io_context_pool_release shall only call interlocked_compare_exchange_pointer on slots that are NULL when read. ]*/
+                if (
+                    (pool->slots[slot_index].block == NULL) &&
+                    (interlocked_compare_exchange_pointer(&pool->slots[slot_index].block, block, NULL) == NULL)
+                    )
+                {
+                    is_cached = true;
+                    break;
+                }
+
+                slot_index++;
+                if (slot_index == pool->max_cached_count)
+                {
+                    slot_index = 0;
+                }
+            }
+        }
+
+        if (!is_cached)
+        {
+            /*Codes_SRS_IO_CONTEXT_POOL_01_023: [ If the block is not pooled or if there is no empty slot, io_context_pool_release shall free the block. ]*/
+            free(block);
+        }
+    }
+}
+
+int io_context_pool_get_statistics(IO_CONTEXT_POOL_HANDLE pool, IO_CONTEXT_POOL_STATISTICS* statistics)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_IO_CONTEXT_POOL_01_024: [ If pool is NULL, io_context_pool_get_statistics shall fail and return a non-zero value. ]*/
+        (pool == NULL) ||
+        /*Codes_SRS_IO_CONTEXT_POOL_01_025: [ If statistics is NULL, io_context_pool_get_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments: IO_CONTEXT_POOL_HANDLE pool=%p, IO_CONTEXT_POOL_STATISTICS* statistics=%p", pool, statistics);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_IO_CONTEXT_POOL_01_026: [ io_context_pool_get_statistics shall fill statistics with the sums of the hit and miss counters of all slots and return 0. ]*/
+        statistics->hit_count = 0;
+        statistics->miss_count = 0;
+        for (uint32_t i = 0; i < pool->max_cached_count; i++)
+        {
+            statistics->hit_count += (uint64_t)interlocked_add_64(&pool->slots[i].hit_count, 0);
+            statistics->miss_count += (uint64_t)interlocked_add_64(&pool->slots[i].miss_count, 0);
+        }
+        result = 0;
+    }
+
+    return result;
+}
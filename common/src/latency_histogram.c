@@ -0,0 +1,112 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+
+#include "c_pal/interlocked.h"
+
+#include "c_pal/latency_histogram.h"
+
+static uint32_t get_bucket_index(int64_t latency_us)
+{
+    uint32_t result = 0;
+
+    while ((latency_us != 0) && (result < LATENCY_HISTOGRAM_BUCKET_COUNT - 1))
+    {
+        latency_us >>= 1;
+        result++;
+    }
+
+    return result;
+}
+
+void latency_histogram_init(LATENCY_HISTOGRAM* histogram)
+{
+    if (histogram == NULL)
+    {
+        /*Codes_SRS_LATENCY_HISTOGRAM_01_001: [ If histogram is NULL, latency_histogram_init shall return. ]*/
+        LogError("Invalid arguments: LATENCY_HISTOGRAM* histogram=%p", histogram);
+    }
+    else
+    {
+        /*Codes_SRS_LATENCY_HISTOGRAM_01_002: [ latency_histogram_init shall set the sample count, the total and maximum latency and all the bucket counts to 0. ]*/
+        (void)interlocked_exchange_64(&histogram->sample_count, 0);
+        (void)interlocked_exchange_64(&histogram->total_us, 0);
+        (void)interlocked_exchange_64(&histogram->max_us, 0);
+        for (uint32_t i = 0; i < LATENCY_HISTOGRAM_BUCKET_COUNT; i++)
+        {
+            (void)interlocked_exchange_64(&histogram->bucket_counts[i], 0);
+        }
+    }
+}
+
+void latency_histogram_record(LATENCY_HISTOGRAM* histogram, double latency_us)
+{
+    if (histogram == NULL)
+    {
+        /*Codes_SRS_LATENCY_HISTOGRAM_01_003: [ If histogram is NULL, latency_histogram_record shall return. ]*/
+        LogError("Invalid arguments: LATENCY_HISTOGRAM* histogram=%p, double latency_us=%f", histogram, latency_us);
+    }
+    else
+    {
+        /*Codes_SRS_LATENCY_HISTOGRAM_01_004: [ If latency_us is negative, latency_histogram_record shall record a latency of 0. ]*/
+        /*the timers return -1 on failure, which must not make the total go backwards*/
+        int64_t sample_us = (latency_us > 0) ? (int64_t)latency_us : 0;
+
+        /*Codes_SRS_LATENCY_HISTOGRAM_01_005: [ latency_histogram_record shall increment the sample count and add the latency to the total latency by calling interlocked_increment_64 and interlocked_add_64. ]*/
+        (void)interlocked_increment_64(&histogram->sample_count);
+        (void)interlocked_add_64(&histogram->total_us, sample_us);
+
+        /*Codes_SRS_LATENCY_HISTOGRAM_01_006: [ latency_histogram_record shall increment the count of the bucket of the latency: bucket 0 for latencies under 1 microsecond, bucket i for latencies of at least 2^(i-1) and under 2^i microseconds and the last bucket for all the longer latencies. ]*/
+        (void)interlocked_increment_64(&histogram->bucket_counts[get_bucket_index(sample_us)]);
+
+        /*Codes_SRS_LATENCY_HISTOGRAM_01_007: [ If the latency is greater than the maximum latency, latency_histogram_record shall set the maximum latency to it by calling interlocked_compare_exchange_64 until it succeeds or the maximum latency is not smaller anymore. ]*/
+        int64_t max_us = interlocked_add_64(&histogram->max_us, 0);
+        while (sample_us > max_us)
+        {
+            int64_t current_max_us = interlocked_compare_exchange_64(&histogram->max_us, sample_us, max_us);
+            if (current_max_us == max_us)
+            {
+                break;
+            }
+
+            max_us = current_max_us;
+        }
+    }
+}
+
+void latency_histogram_add_to_statistics(LATENCY_HISTOGRAM* histogram, LATENCY_HISTOGRAM_STATISTICS* statistics)
+{
+    if (
+        /*Codes_SRS_LATENCY_HISTOGRAM_01_008: [ If histogram is NULL, latency_histogram_add_to_statistics shall return. ]*/
+        (histogram == NULL) ||
+        /*Codes_SRS_LATENCY_HISTOGRAM_01_009: [ If statistics is NULL, latency_histogram_add_to_statistics shall return. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments: LATENCY_HISTOGRAM* histogram=%p, LATENCY_HISTOGRAM_STATISTICS* statistics=%p", histogram, statistics);
+    }
+    else
+    {
+        /*Codes_SRS_LATENCY_HISTOGRAM_01_010: [ latency_histogram_add_to_statistics shall add the sample count, the total latency and the bucket counts of histogram to the ones of statistics. ]*/
+        /*the counters are read one at a time, so they can be off by the samples recorded meanwhile*/
+        statistics->sample_count += (uint64_t)interlocked_add_64(&histogram->sample_count, 0);
+        statistics->total_us += (uint64_t)interlocked_add_64(&histogram->total_us, 0);
+        for (uint32_t i = 0; i < LATENCY_HISTOGRAM_BUCKET_COUNT; i++)
+        {
+            statistics->bucket_counts[i] += (uint64_t)interlocked_add_64(&histogram->bucket_counts[i], 0);
+        }
+
+        /*Codes_SRS_LATENCY_HISTOGRAM_01_011: [ If the maximum latency of histogram is greater than the one of statistics, latency_histogram_add_to_statistics shall set the maximum latency of statistics to it. ]*/
+        uint64_t max_us = (uint64_t)interlocked_add_64(&histogram->max_us, 0);
+        if (max_us > statistics->max_us)
+        {
+            statistics->max_us = max_us;
+        }
+    }
+}
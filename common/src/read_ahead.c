@@ -0,0 +1,790 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/srw_lock.h"
+
+#include "c_pal/read_ahead.h"
+
+MU_DEFINE_ENUM_STRINGS(READ_AHEAD_MODE, READ_AHEAD_MODE_VALUES)
+MU_DEFINE_ENUM_STRINGS(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_RESULT_VALUES)
+
+/*no read can end at UINT64_MAX (see read_ahead_read), so this means "unknown end of file"*/
+#define READ_AHEAD_NO_POSITION UINT64_MAX
+
+#define READ_AHEAD_BLOCK_STATE_VALUES \
+    READ_AHEAD_BLOCK_FREE, \
+    READ_AHEAD_BLOCK_READING, \
+    READ_AHEAD_BLOCK_READY
+MU_DEFINE_ENUM(READ_AHEAD_BLOCK_STATE, READ_AHEAD_BLOCK_STATE_VALUES);
+
+typedef struct READ_AHEAD_WAITER_TAG
+{
+    struct READ_AHEAD_WAITER_TAG* next;
+    unsigned char* destination;
+    uint32_t offset; /*in the block*/
+    uint32_t size;
+    bool is_successful;
+    READ_AHEAD_READ_CB user_callback;
+    void* user_context;
+} READ_AHEAD_WAITER;
+
+typedef struct READ_AHEAD_BLOCK_TAG
+{
+    READ_AHEAD_IO io; /*first member, read_ahead_io_complete gets the block back from it*/
+    struct READ_AHEAD_BLOCK_TAG* next_to_issue;
+    READ_AHEAD_BLOCK_STATE state;
+    bool is_valid; /*false once a write overlapped the block, reads do not find the block anymore*/
+    uint32_t data_size; /*bytes read, can be less than the block size at the end of the file*/
+    uint32_t pin_count; /*copies in progress out of the buffer, the block cannot be reused while it is not 0*/
+    READ_AHEAD_WAITER* first_waiter;
+    READ_AHEAD_WAITER* last_waiter;
+} READ_AHEAD_BLOCK;
+
+typedef struct READ_AHEAD_TAG
+{
+    uint32_t alignment;
+    uint32_t block_size;
+    uint32_t block_count;
+    READ_AHEAD_ISSUE_IO issue_io;
+    void* context;
+
+    SRW_LOCK_HANDLE lock;
+
+    /*all the fields below are protected by lock*/
+    READ_AHEAD_MODE mode;
+    uint64_t last_read_end; /*where the last read ended, to detect sequential reads, starts at 0 so that a scan from the start of the file is sequential*/
+    uint64_t known_file_end; /*set by a short block read, nothing is read ahead past it until a write is seen*/
+    READ_AHEAD_WAITER* free_waiters;
+    READ_AHEAD_BLOCK* blocks;
+} READ_AHEAD;
+
+/*returns position + size, saturated at READ_AHEAD_NO_POSITION*/
+static uint64_t saturated_end(uint64_t position, uint64_t size)
+{
+    return (position > READ_AHEAD_NO_POSITION - size) ? READ_AHEAD_NO_POSITION : position + size;
+}
+
+/*called with the lock held*/
+static READ_AHEAD_BLOCK* find_block(READ_AHEAD_HANDLE read_ahead, uint64_t block_position)
+{
+    READ_AHEAD_BLOCK* result = NULL;
+
+    for (uint32_t i = 0; i < read_ahead->block_count; i++)
+    {
+        READ_AHEAD_BLOCK* block = &read_ahead->blocks[i];
+        if (
+            (block->state != READ_AHEAD_BLOCK_FREE) &&
+            block->is_valid &&
+            (block->io.position == block_position)
+            )
+        {
+            result = block;
+            break;
+        }
+    }
+
+    return result;
+}
+
+/*called with the lock held, blocks that are read outside of [window_start, window_end) can be reused*/
+static READ_AHEAD_BLOCK* acquire_block(READ_AHEAD_HANDLE read_ahead, uint64_t window_start, uint64_t window_end)
+{
+    READ_AHEAD_BLOCK* result = NULL;
+
+    for (uint32_t i = 0; i < read_ahead->block_count; i++)
+    {
+        READ_AHEAD_BLOCK* block = &read_ahead->blocks[i];
+        if (block->state == READ_AHEAD_BLOCK_FREE)
+        {
+            result = block;
+            break;
+        }
+        else if (
+            (result == NULL) &&
+            (block->state == READ_AHEAD_BLOCK_READY) &&
+            (block->pin_count == 0) &&
+            (
+                !block->is_valid ||
+                (block->io.position < window_start) ||
+                (block->io.position >= window_end)
+            )
+            )
+        {
+            /*keep looking for a free block, but this one can be reused*/
+            result = block;
+        }
+        else
+        {
+            /*in use*/
+        }
+    }
+
+    if (result != NULL)
+    {
+        result->state = READ_AHEAD_BLOCK_READING;
+        result->is_valid = true;
+        result->data_size = 0;
+        result->first_waiter = NULL;
+        result->last_waiter = NULL;
+        result->next_to_issue = NULL;
+    }
+
+    return result;
+}
+
+/*called with the lock held*/
+static READ_AHEAD_WAITER* get_waiter(READ_AHEAD_HANDLE read_ahead)
+{
+    READ_AHEAD_WAITER* result = read_ahead->free_waiters;
+
+    if (result != NULL)
+    {
+        read_ahead->free_waiters = result->next;
+    }
+    else
+    {
+        result = malloc(sizeof(READ_AHEAD_WAITER));
+        if (result == NULL)
+        {
+            LogError("failure in malloc(sizeof(READ_AHEAD_WAITER)=%zu)", sizeof(READ_AHEAD_WAITER));
+        }
+    }
+
+    if (result != NULL)
+    {
+        result->next = NULL;
+    }
+
+    return result;
+}
+
+/*called with the lock held*/
+static void add_waiter(READ_AHEAD_BLOCK* block, READ_AHEAD_WAITER* waiter, unsigned char* destination, uint32_t size, uint64_t position, READ_AHEAD_READ_CB user_callback, void* user_context)
+{
+    waiter->destination = destination;
+    waiter->offset = (uint32_t)(position - block->io.position);
+    waiter->size = size;
+    waiter->user_callback = user_callback;
+    waiter->user_context = user_context;
+
+    if (block->last_waiter == NULL)
+    {
+        block->first_waiter = waiter;
+    }
+    else
+    {
+        block->last_waiter->next = waiter;
+    }
+    block->last_waiter = waiter;
+}
+
+/*called with the lock held, adds the block to the list of blocks to issue once the lock is released (most recent first)*/
+static void start_block_read(READ_AHEAD_BLOCK* block, uint64_t block_position, READ_AHEAD_BLOCK** blocks_to_issue)
+{
+    block->io.position = block_position;
+    block->next_to_issue = *blocks_to_issue;
+    *blocks_to_issue = block;
+}
+
+/*called with the lock held, starts reading the blocks after block_position that are in the window of the reader and not cached yet*/
+static void read_ahead_of(READ_AHEAD_HANDLE read_ahead, uint64_t block_position, READ_AHEAD_BLOCK** blocks_to_issue)
+{
+    uint64_t window_end = saturated_end(block_position, (uint64_t)read_ahead->block_size * read_ahead->block_count);
+
+    for (
+        uint64_t position = saturated_end(block_position, read_ahead->block_size);
+        (position < window_end) && (position < read_ahead->known_file_end);
+        position += read_ahead->block_size
+        )
+    {
+        if (find_block(read_ahead, position) == NULL)
+        {
+            READ_AHEAD_BLOCK* block = acquire_block(read_ahead, block_position, window_end);
+            if (block == NULL)
+            {
+                /*all the blocks are in use, the reader will catch up*/
+                break;
+            }
+
+            start_block_read(block, position, blocks_to_issue);
+        }
+    }
+}
+
+/*copies the data of the block to the waiters, the block shall not be reused while this is in progress*/
+static void copy_to_waiters(READ_AHEAD_BLOCK* block, READ_AHEAD_WAITER* waiters, bool is_successful)
+{
+    for (READ_AHEAD_WAITER* waiter = waiters; waiter != NULL; waiter = waiter->next)
+    {
+        waiter->is_successful = is_successful && (waiter->offset + waiter->size <= block->data_size);
+        if (waiter->is_successful)
+        {
+            (void)memcpy(waiter->destination, block->io.buffer + waiter->offset, waiter->size);
+        }
+    }
+}
+
+static void complete_waiters(READ_AHEAD_HANDLE read_ahead, READ_AHEAD_WAITER* waiters)
+{
+    if (waiters != NULL)
+    {
+        READ_AHEAD_WAITER* last_waiter = NULL;
+
+        for (READ_AHEAD_WAITER* waiter = waiters; waiter != NULL; waiter = waiter->next)
+        {
+            waiter->user_callback(waiter->user_context, waiter->is_successful);
+            last_waiter = waiter;
+        }
+
+        srw_lock_acquire_exclusive(read_ahead->lock);
+        last_waiter->next = read_ahead->free_waiters;
+        read_ahead->free_waiters = waiters;
+        srw_lock_release_exclusive(read_ahead->lock);
+    }
+}
+
+/*called with the lock held*/
+static void unpin_block(READ_AHEAD_BLOCK* block)
+{
+    block->pin_count--;
+    if (
+        (block->pin_count == 0) &&
+        !block->is_valid
+        )
+    {
+        block->state = READ_AHEAD_BLOCK_FREE;
+    }
+}
+
+static void issue_blocks(READ_AHEAD_HANDLE read_ahead, READ_AHEAD_BLOCK* blocks_to_issue)
+{
+    /*blocks are pushed most recent first, reverse them so that the block the reader waits for is read first*/
+    READ_AHEAD_BLOCK* block = NULL;
+    while (blocks_to_issue != NULL)
+    {
+        READ_AHEAD_BLOCK* next = blocks_to_issue->next_to_issue;
+        blocks_to_issue->next_to_issue = block;
+        block = blocks_to_issue;
+        blocks_to_issue = next;
+    }
+
+    while (block != NULL)
+    {
+        READ_AHEAD_BLOCK* next_block = block->next_to_issue;
+        block->next_to_issue = NULL;
+
+        /*Codes_SRS_READ_AHEAD_01_040: [ A block is read by calling issue_io with context and the READ_AHEAD_IO of the block. ]*/
+        if (read_ahead->issue_io(read_ahead->context, &block->io) != 0)
+        {
+            READ_AHEAD_WAITER* waiters;
+
+            /*Codes_SRS_READ_AHEAD_01_041: [ If issue_io fails, the block shall be freed and the user callbacks of the reads waiting for it shall be called with is_successful set to false. ]*/
+            LogError("failure in issue_io(context=%p, io=%p), position=%" PRIu64 ", size=%" PRIu32 "",
+                read_ahead->context, &block->io, block->io.position, block->io.size);
+
+            srw_lock_acquire_exclusive(read_ahead->lock);
+            waiters = block->first_waiter;
+            block->first_waiter = NULL;
+            block->last_waiter = NULL;
+            block->state = READ_AHEAD_BLOCK_FREE;
+            srw_lock_release_exclusive(read_ahead->lock);
+
+            copy_to_waiters(block, waiters, false);
+            complete_waiters(read_ahead, waiters);
+        }
+
+        block = next_block;
+    }
+}
+
+READ_AHEAD_HANDLE read_ahead_create(uint32_t alignment, uint32_t block_size, uint32_t block_count, READ_AHEAD_ISSUE_IO issue_io, void* context)
+{
+    READ_AHEAD_HANDLE result;
+
+    if (
+        /*Codes_SRS_READ_AHEAD_01_001: [ If alignment is 0 or is not a power of 2, read_ahead_create shall fail and return NULL. ]*/
+        (alignment == 0) ||
+        ((alignment & (alignment - 1)) != 0) ||
+        /*Codes_SRS_READ_AHEAD_01_002: [ If block_size is 0 or is not a multiple of alignment, read_ahead_create shall fail and return NULL. ]*/
+        (block_size == 0) ||
+        ((block_size % alignment) != 0) ||
+        /*Codes_SRS_READ_AHEAD_01_003: [ If block_count is 0, read_ahead_create shall fail and return NULL. ]*/
+        (block_count == 0) ||
+        /*Codes_SRS_READ_AHEAD_01_004: [ If issue_io is NULL, read_ahead_create shall fail and return NULL. ]*/
+        (issue_io == NULL)
+        )
+    {
+        LogError("Invalid arguments: uint32_t alignment=%" PRIu32 ", uint32_t block_size=%" PRIu32 ", uint32_t block_count=%" PRIu32 ", READ_AHEAD_ISSUE_IO issue_io=%p, void* context=%p",
+            alignment, block_size, block_count, issue_io, context);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_READ_AHEAD_01_005: [ read_ahead_create shall allocate memory for the read-ahead and for block_count blocks. ]*/
+        result = malloc(sizeof(READ_AHEAD));
+        if (result == NULL)
+        {
+            /*Codes_SRS_READ_AHEAD_01_008: [ If any error occurs, read_ahead_create shall fail and return NULL. ]*/
+            LogError("failure in malloc(sizeof(READ_AHEAD)=%zu)", sizeof(READ_AHEAD));
+        }
+        else if ((result->blocks = calloc(block_count, sizeof(READ_AHEAD_BLOCK))) == NULL)
+        {
+            /*Codes_SRS_READ_AHEAD_01_008: [ If any error occurs, read_ahead_create shall fail and return NULL. ]*/
+            LogError("failure in calloc(block_count=%" PRIu32 ", sizeof(READ_AHEAD_BLOCK)=%zu)", block_count, sizeof(READ_AHEAD_BLOCK));
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            uint32_t i;
+
+            for (i = 0; i < block_count; i++)
+            {
+                /*Codes_SRS_READ_AHEAD_01_006: [ read_ahead_create shall allocate a buffer of block_size bytes aligned to alignment for each block by calling gballoc_hl_aligned_malloc. ]*/
+                result->blocks[i].io.buffer = gballoc_hl_aligned_malloc(alignment, block_size);
+                if (result->blocks[i].io.buffer == NULL)
+                {
+                    /*Codes_SRS_READ_AHEAD_01_008: [ If any error occurs, read_ahead_create shall fail and return NULL. ]*/
+                    LogError("failure in gballoc_hl_aligned_malloc(alignment=%" PRIu32 ", block_size=%" PRIu32 ")", alignment, block_size);
+                    break;
+                }
+
+                result->blocks[i].io.size = block_size;
+                result->blocks[i].io.position = 0;
+                result->blocks[i].next_to_issue = NULL;
+                result->blocks[i].state = READ_AHEAD_BLOCK_FREE;
+                result->blocks[i].is_valid = false;
+                result->blocks[i].data_size = 0;
+                result->blocks[i].pin_count = 0;
+                result->blocks[i].first_waiter = NULL;
+                result->blocks[i].last_waiter = NULL;
+            }
+
+            if (i == block_count)
+            {
+                /*Codes_SRS_READ_AHEAD_01_051: [ read_ahead_create shall create the lock by calling srw_lock_create. ]*/
+                result->lock = srw_lock_create(false, "read_ahead");
+                if (result->lock == NULL)
+                {
+                    /*Codes_SRS_READ_AHEAD_01_008: [ If any error occurs, read_ahead_create shall fail and return NULL. ]*/
+                    LogError("failure in srw_lock_create(false, \"read_ahead\")");
+                }
+                else
+                {
+                    result->alignment = alignment;
+                    result->block_size = block_size;
+                    result->block_count = block_count;
+                    result->issue_io = issue_io;
+                    result->context = context;
+
+                    /*Codes_SRS_READ_AHEAD_01_007: [ read_ahead_create shall set the mode to READ_AHEAD_MODE_AUTO, start with all the blocks free and the end of the last read at 0 and return the read-ahead. ]*/
+                    result->mode = READ_AHEAD_MODE_AUTO;
+                    result->last_read_end = 0;
+                    result->known_file_end = READ_AHEAD_NO_POSITION;
+                    result->free_waiters = NULL;
+
+                    goto all_ok;
+                }
+            }
+
+            while (i > 0)
+            {
+                i--;
+                gballoc_hl_aligned_free(result->blocks[i].io.buffer);
+            }
+            free(result->blocks);
+            free(result);
+            result = NULL;
+        }
+    }
+
+all_ok:
+    return result;
+}
+
+void read_ahead_destroy(READ_AHEAD_HANDLE read_ahead)
+{
+    if (read_ahead == NULL)
+    {
+        /*Codes_SRS_READ_AHEAD_01_009: [ If read_ahead is NULL, read_ahead_destroy shall return. ]*/
+        LogError("Invalid arguments: READ_AHEAD_HANDLE read_ahead=%p", read_ahead);
+    }
+    else
+    {
+        /*Codes_SRS_READ_AHEAD_01_010: [ read_ahead_destroy shall destroy the lock and free the buffers of all the blocks, the cached waiters and the memory of the read-ahead. ]*/
+        srw_lock_destroy(read_ahead->lock);
+
+        for (uint32_t i = 0; i < read_ahead->block_count; i++)
+        {
+            gballoc_hl_aligned_free(read_ahead->blocks[i].io.buffer);
+        }
+
+        READ_AHEAD_WAITER* waiter = read_ahead->free_waiters;
+        while (waiter != NULL)
+        {
+            READ_AHEAD_WAITER* next_waiter = waiter->next;
+            free(waiter);
+            waiter = next_waiter;
+        }
+
+        free(read_ahead->blocks);
+        free(read_ahead);
+    }
+}
+
+int read_ahead_set_mode(READ_AHEAD_HANDLE read_ahead, READ_AHEAD_MODE mode)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_READ_AHEAD_01_011: [ If read_ahead is NULL, read_ahead_set_mode shall fail and return a non-zero value. ]*/
+        (read_ahead == NULL) ||
+        /*Codes_SRS_READ_AHEAD_01_012: [ If mode is not a valid READ_AHEAD_MODE value, read_ahead_set_mode shall fail and return a non-zero value. ]*/
+        ((mode != READ_AHEAD_MODE_AUTO) && (mode != READ_AHEAD_MODE_SEQUENTIAL) && (mode != READ_AHEAD_MODE_OFF))
+        )
+    {
+        LogError("Invalid arguments: READ_AHEAD_HANDLE read_ahead=%p, READ_AHEAD_MODE mode=%" PRI_MU_ENUM "",
+            read_ahead, MU_ENUM_VALUE(READ_AHEAD_MODE, mode));
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_READ_AHEAD_01_013: [ read_ahead_set_mode shall set the mode of the read-ahead and return 0. ]*/
+        srw_lock_acquire_exclusive(read_ahead->lock);
+        read_ahead->mode = mode;
+        srw_lock_release_exclusive(read_ahead->lock);
+
+        result = 0;
+    }
+
+    return result;
+}
+
+READ_AHEAD_READ_RESULT read_ahead_read(READ_AHEAD_HANDLE read_ahead, unsigned char* destination, uint32_t size, uint64_t position, READ_AHEAD_READ_CB user_callback, void* user_context)
+{
+    READ_AHEAD_READ_RESULT result;
+
+    if (
+        /*Codes_SRS_READ_AHEAD_01_014: [ If read_ahead is NULL, read_ahead_read shall fail and return READ_AHEAD_READ_ERROR. ]*/
+        (read_ahead == NULL) ||
+        /*Codes_SRS_READ_AHEAD_01_015: [ If destination is NULL, read_ahead_read shall fail and return READ_AHEAD_READ_ERROR. ]*/
+        (destination == NULL) ||
+        /*Codes_SRS_READ_AHEAD_01_016: [ If size is 0, read_ahead_read shall fail and return READ_AHEAD_READ_ERROR. ]*/
+        (size == 0) ||
+        /*Codes_SRS_READ_AHEAD_01_017: [ If position + size is greater than or equal to UINT64_MAX, read_ahead_read shall fail and return READ_AHEAD_READ_ERROR. ]*/
+        (position >= UINT64_MAX - size) ||
+        /*Codes_SRS_READ_AHEAD_01_018: [ If user_callback is NULL, read_ahead_read shall fail and return READ_AHEAD_READ_ERROR. ]*/
+        (user_callback == NULL)
+        )
+    {
+        LogError("Invalid arguments: READ_AHEAD_HANDLE read_ahead=%p, unsigned char* destination=%p, uint32_t size=%" PRIu32 ", uint64_t position=%" PRIu64 ", READ_AHEAD_READ_CB user_callback=%p, void* user_context=%p",
+            read_ahead, destination, size, position, user_callback, user_context);
+        result = READ_AHEAD_READ_ERROR;
+    }
+    else
+    {
+        READ_AHEAD_BLOCK* blocks_to_issue = NULL;
+        READ_AHEAD_BLOCK* hit_block = NULL;
+        uint64_t block_position = position - (position % read_ahead->block_size);
+
+        srw_lock_acquire_exclusive(read_ahead->lock);
+
+        /*Codes_SRS_READ_AHEAD_01_019: [ A read is sequential if the mode is READ_AHEAD_MODE_SEQUENTIAL, or if the mode is READ_AHEAD_MODE_AUTO and position is where the previous read ended. ]*/
+        bool is_sequential =
+            (read_ahead->mode == READ_AHEAD_MODE_SEQUENTIAL) ||
+            ((read_ahead->mode == READ_AHEAD_MODE_AUTO) && (position == read_ahead->last_read_end));
+
+        /*Codes_SRS_READ_AHEAD_01_020: [ read_ahead_read shall record position + size as the end of the last read. ]*/
+        read_ahead->last_read_end = position + size;
+
+        if (position + size > block_position + read_ahead->block_size)
+        {
+            /*Codes_SRS_READ_AHEAD_01_021: [ If the read does not fit in one block, read_ahead_read shall return READ_AHEAD_READ_NOT_HANDLED. ]*/
+            result = READ_AHEAD_READ_NOT_HANDLED;
+        }
+        else
+        {
+            READ_AHEAD_BLOCK* block = find_block(read_ahead, block_position);
+
+            if (block != NULL)
+            {
+                if (block->state == READ_AHEAD_BLOCK_READY)
+                {
+                    if (position + size > block->io.position + block->data_size)
+                    {
+                        /*Codes_SRS_READ_AHEAD_01_023: [ If the block holding the read was read but is too short to contain it, read_ahead_read shall return READ_AHEAD_READ_NOT_HANDLED. ]*/
+                        result = READ_AHEAD_READ_NOT_HANDLED;
+                    }
+                    else
+                    {
+                        /*Codes_SRS_READ_AHEAD_01_022: [ If the block holding the read was read, read_ahead_read shall pin the block, copy the data to destination once the lock is released, unpin the block and return READ_AHEAD_READ_COPIED without calling user_callback. ]*/
+                        block->pin_count++;
+                        hit_block = block;
+                        result = READ_AHEAD_READ_COPIED;
+                    }
+                }
+                else
+                {
+                    /*Codes_SRS_READ_AHEAD_01_024: [ If the block holding the read is being read, read_ahead_read shall add the read to the reads waiting for the block and return READ_AHEAD_READ_OK. ]*/
+                    READ_AHEAD_WAITER* waiter = get_waiter(read_ahead);
+                    if (waiter == NULL)
+                    {
+                        /*Codes_SRS_READ_AHEAD_01_029: [ If any error occurs, read_ahead_read shall fail and return READ_AHEAD_READ_ERROR. ]*/
+                        LogError("failure in get_waiter");
+                        result = READ_AHEAD_READ_ERROR;
+                    }
+                    else
+                    {
+                        add_waiter(block, waiter, destination, size, position, user_callback, user_context);
+                        result = READ_AHEAD_READ_OK;
+                    }
+                }
+            }
+            else if (
+                !is_sequential ||
+                (block_position >= read_ahead->known_file_end)
+                )
+            {
+                /*Codes_SRS_READ_AHEAD_01_025: [ If the block holding the read is not cached and the read is not sequential or the block starts after the known end of the file, read_ahead_read shall return READ_AHEAD_READ_NOT_HANDLED. ]*/
+                result = READ_AHEAD_READ_NOT_HANDLED;
+            }
+            else
+            {
+                /*Codes_SRS_READ_AHEAD_01_026: [ Otherwise read_ahead_read shall take a free block or a block that was read outside of the block_count blocks starting at the block holding the read, add the read to the reads waiting for it, start reading it and return READ_AHEAD_READ_OK. ]*/
+                uint64_t window_end = saturated_end(block_position, (uint64_t)read_ahead->block_size * read_ahead->block_count);
+                block = acquire_block(read_ahead, block_position, window_end);
+                if (block == NULL)
+                {
+                    /*Codes_SRS_READ_AHEAD_01_027: [ If no block can be taken, read_ahead_read shall return READ_AHEAD_READ_NOT_HANDLED. ]*/
+                    result = READ_AHEAD_READ_NOT_HANDLED;
+                }
+                else
+                {
+                    READ_AHEAD_WAITER* waiter = get_waiter(read_ahead);
+                    if (waiter == NULL)
+                    {
+                        /*Codes_SRS_READ_AHEAD_01_029: [ If any error occurs, read_ahead_read shall fail and return READ_AHEAD_READ_ERROR. ]*/
+                        LogError("failure in get_waiter");
+                        block->state = READ_AHEAD_BLOCK_FREE;
+                        result = READ_AHEAD_READ_ERROR;
+                    }
+                    else
+                    {
+                        block->io.position = block_position;
+                        add_waiter(block, waiter, destination, size, position, user_callback, user_context);
+                        start_block_read(block, block_position, &blocks_to_issue);
+                        result = READ_AHEAD_READ_OK;
+                    }
+                }
+            }
+
+            if (
+                is_sequential &&
+                (result != READ_AHEAD_READ_ERROR)
+                )
+            {
+                /*Codes_SRS_READ_AHEAD_01_028: [ If the read is sequential, read_ahead_read shall start reading the blocks that follow the block holding the read, up to block_count blocks in total and not past the known end of the file, that are not cached yet and for which a block can be taken. ]*/
+                read_ahead_of(read_ahead, block_position, &blocks_to_issue);
+            }
+        }
+
+        srw_lock_release_exclusive(read_ahead->lock);
+
+        /*Codes_SRS_READ_AHEAD_01_030: [ After releasing the lock, read_ahead_read shall read all the blocks it started, in the order they were started. ]*/
+        issue_blocks(read_ahead, blocks_to_issue);
+
+        if (hit_block != NULL)
+        {
+            (void)memcpy(destination, hit_block->io.buffer + (position - hit_block->io.position), size);
+
+            srw_lock_acquire_exclusive(read_ahead->lock);
+            unpin_block(hit_block);
+            srw_lock_release_exclusive(read_ahead->lock);
+        }
+    }
+
+    return result;
+}
+
+int read_ahead_will_need(READ_AHEAD_HANDLE read_ahead, uint64_t position, uint64_t size)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_READ_AHEAD_01_031: [ If read_ahead is NULL, read_ahead_will_need shall fail and return a non-zero value. ]*/
+        (read_ahead == NULL) ||
+        /*Codes_SRS_READ_AHEAD_01_032: [ If size is 0, read_ahead_will_need shall fail and return a non-zero value. ]*/
+        (size == 0) ||
+        /*Codes_SRS_READ_AHEAD_01_033: [ If position + size is greater than or equal to UINT64_MAX, read_ahead_will_need shall fail and return a non-zero value. ]*/
+        (position >= UINT64_MAX - size)
+        )
+    {
+        LogError("Invalid arguments: READ_AHEAD_HANDLE read_ahead=%p, uint64_t position=%" PRIu64 ", uint64_t size=%" PRIu64 "",
+            read_ahead, position, size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        READ_AHEAD_BLOCK* blocks_to_issue = NULL;
+        uint64_t first_block_position = position - (position % read_ahead->block_size);
+        uint64_t window_end = saturated_end(first_block_position, (uint64_t)read_ahead->block_size * read_ahead->block_count);
+        uint64_t range_end = position + size;
+
+        srw_lock_acquire_exclusive(read_ahead->lock);
+
+        /*Codes_SRS_READ_AHEAD_01_034: [ read_ahead_will_need shall start reading the blocks holding the range, up to block_count blocks, that are not cached yet and for which a block can be taken. ]*/
+        for (
+            uint64_t block_position = first_block_position;
+            (block_position < range_end) && (block_position < window_end);
+            block_position += read_ahead->block_size
+            )
+        {
+            if (find_block(read_ahead, block_position) == NULL)
+            {
+                READ_AHEAD_BLOCK* block = acquire_block(read_ahead, first_block_position, window_end);
+                if (block == NULL)
+                {
+                    break;
+                }
+
+                start_block_read(block, block_position, &blocks_to_issue);
+            }
+        }
+
+        srw_lock_release_exclusive(read_ahead->lock);
+
+        /*Codes_SRS_READ_AHEAD_01_035: [ After releasing the lock, read_ahead_will_need shall read all the blocks it started, in the order they were started, and return 0. ]*/
+        issue_blocks(read_ahead, blocks_to_issue);
+
+        result = 0;
+    }
+
+    return result;
+}
+
+void read_ahead_invalidate(READ_AHEAD_HANDLE read_ahead, uint64_t position, uint64_t size)
+{
+    if (read_ahead == NULL)
+    {
+        /*Codes_SRS_READ_AHEAD_01_036: [ If read_ahead is NULL, read_ahead_invalidate shall return. ]*/
+        LogError("Invalid arguments: READ_AHEAD_HANDLE read_ahead=%p, uint64_t position=%" PRIu64 ", uint64_t size=%" PRIu64 "",
+            read_ahead, position, size);
+    }
+    else
+    {
+        uint64_t range_end = saturated_end(position, size);
+
+        srw_lock_acquire_exclusive(read_ahead->lock);
+
+        for (uint32_t i = 0; i < read_ahead->block_count; i++)
+        {
+            READ_AHEAD_BLOCK* block = &read_ahead->blocks[i];
+            if (
+                (block->state != READ_AHEAD_BLOCK_FREE) &&
+                (block->io.position < range_end) &&
+                (position < block->io.position + read_ahead->block_size)
+                )
+            {
+                /*Codes_SRS_READ_AHEAD_01_037: [ read_ahead_invalidate shall mark all the blocks that overlap the range as not valid, so that reads do not find them anymore. ]*/
+                block->is_valid = false;
+
+                /*Codes_SRS_READ_AHEAD_01_038: [ read_ahead_invalidate shall free the blocks that overlap the range, were read and are not pinned. ]*/
+                if (
+                    (block->state == READ_AHEAD_BLOCK_READY) &&
+                    (block->pin_count == 0)
+                    )
+                {
+                    block->state = READ_AHEAD_BLOCK_FREE;
+                }
+            }
+        }
+
+        /*Codes_SRS_READ_AHEAD_01_039: [ read_ahead_invalidate shall forget the known end of the file, since the write can extend the file. ]*/
+        read_ahead->known_file_end = READ_AHEAD_NO_POSITION;
+
+        srw_lock_release_exclusive(read_ahead->lock);
+    }
+}
+
+void read_ahead_io_complete(READ_AHEAD_HANDLE read_ahead, READ_AHEAD_IO* io, bool is_successful, uint32_t bytes_read)
+{
+    if (
+        /*Codes_SRS_READ_AHEAD_01_042: [ If read_ahead is NULL, read_ahead_io_complete shall return. ]*/
+        (read_ahead == NULL) ||
+        /*Codes_SRS_READ_AHEAD_01_043: [ If io is NULL, read_ahead_io_complete shall return. ]*/
+        (io == NULL)
+        )
+    {
+        LogError("Invalid arguments: READ_AHEAD_HANDLE read_ahead=%p, READ_AHEAD_IO* io=%p, bool is_successful=%d, uint32_t bytes_read=%" PRIu32 "",
+            read_ahead, io, is_successful, bytes_read);
+    }
+    else
+    {
+        READ_AHEAD_BLOCK* block = (READ_AHEAD_BLOCK*)io;
+        READ_AHEAD_WAITER* waiters;
+
+        if (bytes_read > io->size)
+        {
+            bytes_read = io->size;
+        }
+
+        srw_lock_acquire_exclusive(read_ahead->lock);
+
+        /*Codes_SRS_READ_AHEAD_01_044: [ read_ahead_io_complete shall take the reads waiting for the block. ]*/
+        waiters = block->first_waiter;
+        block->first_waiter = NULL;
+        block->last_waiter = NULL;
+
+        if (is_successful)
+        {
+            /*Codes_SRS_READ_AHEAD_01_045: [ If is_successful is true, read_ahead_io_complete shall mark the block as read with bytes_read bytes of data and pin it. ]*/
+            block->state = READ_AHEAD_BLOCK_READY;
+            block->data_size = bytes_read;
+            block->pin_count++;
+
+            if (bytes_read < io->size)
+            {
+                /*Codes_SRS_READ_AHEAD_01_046: [ If bytes_read is less than the block size, read_ahead_io_complete shall record the end of the data as the known end of the file. ]*/
+                uint64_t data_end = io->position + bytes_read;
+                if (data_end < read_ahead->known_file_end)
+                {
+                    read_ahead->known_file_end = data_end;
+                }
+            }
+        }
+        else
+        {
+            /*Codes_SRS_READ_AHEAD_01_047: [ If is_successful is false, read_ahead_io_complete shall free the block. ]*/
+            LogError("failure reading block at position %" PRIu64 "", io->position);
+            block->state = READ_AHEAD_BLOCK_FREE;
+        }
+
+        srw_lock_release_exclusive(read_ahead->lock);
+
+        /*Codes_SRS_READ_AHEAD_01_048: [ read_ahead_io_complete shall copy the data of the block to every waiting read that the data covers. ]*/
+        copy_to_waiters(block, waiters, is_successful);
+
+        if (is_successful)
+        {
+            /*Codes_SRS_READ_AHEAD_01_049: [ read_ahead_io_complete shall unpin the block and free it if a write overlapped it in the meantime. ]*/
+            srw_lock_acquire_exclusive(read_ahead->lock);
+            unpin_block(block);
+            srw_lock_release_exclusive(read_ahead->lock);
+        }
+
+        /*Codes_SRS_READ_AHEAD_01_050: [ read_ahead_io_complete shall call the user callbacks of the waiting reads, in the order they were added, with is_successful set to true if and only if the data covers the read. ]*/
+        complete_waiters(read_ahead, waiters);
+    }
+}
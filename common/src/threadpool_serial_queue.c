@@ -0,0 +1,265 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sync.h"
+#include "c_pal/threadpool.h"
+
+#include "c_pal/threadpool_serial_queue.h"
+
+typedef struct THREADPOOL_SERIAL_QUEUE_NODE_TAG
+{
+    struct THREADPOOL_SERIAL_QUEUE_NODE_TAG* next;
+    THREADPOOL_WORK_FUNCTION work_function;
+    void* work_function_context;
+} THREADPOOL_SERIAL_QUEUE_NODE;
+
+typedef struct THREADPOOL_SERIAL_QUEUE_TAG
+{
+    THREADPOOL_HANDLE threadpool;
+    THREADPOOL_WORK_ITEM_HANDLE drain_work_item;
+    uint32_t max_batch_size;
+
+    /*number of work items scheduled and not executed yet, the drain is scheduled by whoever moves it from 0 to 1*/
+    volatile_atomic int32_t pending_count;
+
+    /*THREADPOOL_SERIAL_QUEUE_NODE*, most recent first, pushed to by any thread*/
+    void* volatile_atomic submitted_nodes;
+
+    /*only accessed by the drain: nodes taken from submitted_nodes, oldest first*/
+    THREADPOOL_SERIAL_QUEUE_NODE* batch;
+} THREADPOOL_SERIAL_QUEUE;
+
+/*moves all the submitted nodes to the batch of the drain, reversing them so that they execute in the order they were scheduled*/
+static void take_submitted_nodes(THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue)
+{
+    THREADPOOL_SERIAL_QUEUE_NODE* node = interlocked_exchange_pointer(&serial_queue->submitted_nodes, NULL);
+    THREADPOOL_SERIAL_QUEUE_NODE* batch = NULL;
+
+    while (node != NULL)
+    {
+        THREADPOOL_SERIAL_QUEUE_NODE* next = node->next;
+        node->next = batch;
+        batch = node;
+        node = next;
+    }
+
+    serial_queue->batch = batch;
+}
+
+static void threadpool_serial_queue_drain(void* context)
+{
+    if (context == NULL)
+    {
+        /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_014: [ If context is NULL, threadpool_serial_queue_drain shall return. ]*/
+        LogError("Invalid arguments: void* context=%p", context);
+    }
+    else
+    {
+        THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = context;
+        bool yielded = false;
+
+        do
+        {
+            int32_t executed_count = 0;
+
+            /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_016: [ threadpool_serial_queue_drain shall stop after executing max_batch_size work items if max_batch_size is not 0. ]*/
+            while ((serial_queue->max_batch_size == 0) || ((uint32_t)executed_count < serial_queue->max_batch_size))
+            {
+                THREADPOOL_SERIAL_QUEUE_NODE* node;
+
+                if (serial_queue->batch == NULL)
+                {
+                    /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_015: [ When it has no work item left, threadpool_serial_queue_drain shall take all the scheduled work items with interlocked_exchange_pointer and reverse them to obtain them in the order they were scheduled. ]*/
+                    take_submitted_nodes(serial_queue);
+                }
+
+                node = serial_queue->batch;
+                if (node == NULL)
+                {
+                    /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_017: [ threadpool_serial_queue_drain shall stop when no work item is left. ]*/
+                    break;
+                }
+
+                serial_queue->batch = node->next;
+
+                /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_018: [ threadpool_serial_queue_drain shall call the work_function of each work item with its work_function_context and free the memory of the work item. ]*/
+                node->work_function(node->work_function_context);
+                free(node);
+                executed_count++;
+            }
+
+            /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_019: [ threadpool_serial_queue_drain shall subtract the number of executed work items from the number of pending work items. ]*/
+            if (interlocked_add(&serial_queue->pending_count, -executed_count) == 0)
+            {
+                /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_020: [ If no work item is pending, threadpool_serial_queue_drain shall wake up threadpool_serial_queue_destroy by calling wake_by_address_all and return. ]*/
+                wake_by_address_all(&serial_queue->pending_count);
+                yielded = true;
+            }
+            else
+            {
+                /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_021: [ Otherwise threadpool_serial_queue_drain shall reschedule itself by calling threadpool_schedule_work_item and return, giving the threadpool thread back. ]*/
+                if (threadpool_schedule_work_item(serial_queue->threadpool, serial_queue->drain_work_item) != 0)
+                {
+                    /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_022: [ If threadpool_schedule_work_item fails, threadpool_serial_queue_drain shall keep executing the pending work items on the current thread. ]*/
+                    LogError("failure in threadpool_schedule_work_item(threadpool=%p, drain_work_item=%p), draining on the current thread",
+                        serial_queue->threadpool, serial_queue->drain_work_item);
+                }
+                else
+                {
+                    yielded = true;
+                }
+            }
+        } while (!yielded);
+    }
+}
+
+THREADPOOL_SERIAL_QUEUE_HANDLE threadpool_serial_queue_create(THREADPOOL_HANDLE threadpool, uint32_t max_batch_size)
+{
+    THREADPOOL_SERIAL_QUEUE_HANDLE result;
+
+    if (threadpool == NULL)
+    {
+        /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_001: [ If threadpool is NULL, threadpool_serial_queue_create shall fail and return NULL. ]*/
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, uint32_t max_batch_size=%" PRIu32 "", threadpool, max_batch_size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_002: [ threadpool_serial_queue_create shall allocate memory for the serial queue. ]*/
+        result = malloc(sizeof(THREADPOOL_SERIAL_QUEUE));
+        if (result == NULL)
+        {
+            /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_005: [ If any error occurs, threadpool_serial_queue_create shall fail and return NULL. ]*/
+            LogError("failure in malloc(sizeof(THREADPOOL_SERIAL_QUEUE)=%zu)", sizeof(THREADPOOL_SERIAL_QUEUE));
+        }
+        else
+        {
+            /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_003: [ threadpool_serial_queue_create shall create the work item that drains the serial queue by calling threadpool_create_work_item with threadpool_serial_queue_drain. ]*/
+            result->drain_work_item = threadpool_create_work_item(threadpool, threadpool_serial_queue_drain, result);
+            if (result->drain_work_item == NULL)
+            {
+                /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_005: [ If any error occurs, threadpool_serial_queue_create shall fail and return NULL. ]*/
+                LogError("failure in threadpool_create_work_item(threadpool=%p, threadpool_serial_queue_drain, result=%p)", threadpool, result);
+                free(result);
+                result = NULL;
+            }
+            else
+            {
+                /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_004: [ threadpool_serial_queue_create shall set the number of pending work items to 0, empty the queue and succeed. ]*/
+                result->threadpool = threadpool;
+                result->max_batch_size = max_batch_size;
+                (void)interlocked_exchange(&result->pending_count, 0);
+                (void)interlocked_exchange_pointer(&result->submitted_nodes, NULL);
+                result->batch = NULL;
+            }
+        }
+    }
+
+    return result;
+}
+
+void threadpool_serial_queue_destroy(THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue)
+{
+    if (serial_queue == NULL)
+    {
+        /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_006: [ If serial_queue is NULL, threadpool_serial_queue_destroy shall return. ]*/
+        LogError("Invalid arguments: THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue=%p", serial_queue);
+    }
+    else
+    {
+        int32_t pending_count;
+
+        /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_007: [ threadpool_serial_queue_destroy shall wait with wait_on_address until the number of pending work items is 0. ]*/
+        while ((pending_count = interlocked_add(&serial_queue->pending_count, 0)) != 0)
+        {
+            (void)wait_on_address(&serial_queue->pending_count, pending_count, UINT32_MAX);
+        }
+
+        /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_008: [ threadpool_serial_queue_destroy shall destroy the drain work item by calling threadpool_destroy_work_item. ]*/
+        threadpool_destroy_work_item(serial_queue->threadpool, serial_queue->drain_work_item);
+
+        /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_009: [ threadpool_serial_queue_destroy shall free the memory of the serial queue. ]*/
+        free(serial_queue);
+    }
+}
+
+int threadpool_serial_queue_schedule_work(THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_010: [ If serial_queue is NULL, threadpool_serial_queue_schedule_work shall fail and return a non-zero value. ]*/
+        (serial_queue == NULL) ||
+        /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_011: [ If work_function is NULL, threadpool_serial_queue_schedule_work shall fail and return a non-zero value. ]*/
+        (work_function == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue=%p, THREADPOOL_WORK_FUNCTION work_function=%p, void* work_function_context=%p",
+            serial_queue, work_function, work_function_context);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_012: [ threadpool_serial_queue_schedule_work shall allocate memory for the work item. ]*/
+        THREADPOOL_SERIAL_QUEUE_NODE* node = malloc(sizeof(THREADPOOL_SERIAL_QUEUE_NODE));
+        if (node == NULL)
+        {
+            /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_013: [ If any error occurs, threadpool_serial_queue_schedule_work shall fail and return a non-zero value. ]*/
+            LogError("failure in malloc(sizeof(THREADPOOL_SERIAL_QUEUE_NODE)=%zu)", sizeof(THREADPOOL_SERIAL_QUEUE_NODE));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            THREADPOOL_SERIAL_QUEUE_NODE* current_nodes = NULL;
+            THREADPOOL_SERIAL_QUEUE_NODE* previous_nodes;
+            int32_t pending_count;
+
+            node->work_function = work_function;
+            node->work_function_context = work_function_context;
+
+            /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_023: [ threadpool_serial_queue_schedule_work shall increment the number of pending work items before pushing the work item, so that the drain cannot execute a work item that is not counted. ]*/
+            pending_count = interlocked_increment(&serial_queue->pending_count);
+
+            /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_024: [ threadpool_serial_queue_schedule_work shall push the work item to the serial queue with interlocked_compare_exchange_pointer. ]*/
+            do
+            {
+                node->next = current_nodes;
+                previous_nodes = interlocked_compare_exchange_pointer(&serial_queue->submitted_nodes, node, current_nodes);
+                if (previous_nodes == current_nodes)
+                {
+                    break;
+                }
+                current_nodes = previous_nodes;
+            } while (1);
+
+            if (pending_count == 1)
+            {
+                /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_025: [ If the number of pending work items was 0, threadpool_serial_queue_schedule_work shall schedule the drain work item by calling threadpool_schedule_work_item. ]*/
+                if (threadpool_schedule_work_item(serial_queue->threadpool, serial_queue->drain_work_item) != 0)
+                {
+                    /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_026: [ If threadpool_schedule_work_item fails, threadpool_serial_queue_schedule_work shall drain the serial queue on the calling thread. ]*/
+                    LogError("failure in threadpool_schedule_work_item(threadpool=%p, drain_work_item=%p), draining on the calling thread",
+                        serial_queue->threadpool, serial_queue->drain_work_item);
+                    threadpool_serial_queue_drain(serial_queue);
+                }
+            }
+
+            /*Codes_SRS_THREADPOOL_SERIAL_QUEUE_01_027: [ threadpool_serial_queue_schedule_work shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+
+    return result;
+}
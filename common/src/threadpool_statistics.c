@@ -0,0 +1,320 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sysinfo.h"
+#include "c_pal/timer.h"
+#include "c_pal/latency_histogram.h"
+#include "c_pal/threadpool.h"
+
+#include "c_pal/threadpool_statistics.h"
+
+/*the counters written by the threads running on one processor*/
+typedef struct THREADPOOL_STATISTICS_SHARD_TAG
+{
+    LATENCY_HISTOGRAM queue_wait;
+    LATENCY_HISTOGRAM run_time;
+    volatile_atomic int64_t started_count;
+    volatile_atomic int64_t completed_count;
+} THREADPOOL_STATISTICS_SHARD;
+
+typedef struct THREADPOOL_STATISTICS_RECORDER_TAG
+{
+    /*the queue depth is shared, the peak cannot be computed from per processor counts*/
+    volatile_atomic int64_t queue_depth;
+    volatile_atomic int64_t peak_queue_depth;
+    uint32_t shard_count;
+    THREADPOOL_STATISTICS_SHARD shards[];
+} THREADPOOL_STATISTICS_RECORDER;
+
+static THREADPOOL_STATISTICS_SHARD* get_current_shard(THREADPOOL_STATISTICS_RECORDER* recorder)
+{
+    return &recorder->shards[sysinfo_get_current_processor() % recorder->shard_count];
+}
+
+static void update_max(volatile_atomic int64_t* max_value, int64_t value)
+{
+    int64_t current_max = interlocked_add_64(max_value, 0);
+    while (value > current_max)
+    {
+        int64_t previous_max = interlocked_compare_exchange_64(max_value, value, current_max);
+        if (previous_max == current_max)
+        {
+            break;
+        }
+
+        current_max = previous_max;
+    }
+}
+
+static uint32_t to_uint32_count(int64_t count)
+{
+    /*the counters are read one at a time, so a difference of counters can be briefly negative*/
+    return (count < 0) ? 0 : ((count > UINT32_MAX) ? UINT32_MAX : (uint32_t)count);
+}
+
+THREADPOOL_STATISTICS_RECORDER_HANDLE threadpool_statistics_recorder_create(void)
+{
+    THREADPOOL_STATISTICS_RECORDER_HANDLE result;
+
+    /*Codes_SRS_THREADPOOL_STATISTICS_01_001: [ threadpool_statistics_recorder_create shall obtain the number of processors by calling sysinfo_get_processor_count. ]*/
+    uint32_t shard_count = sysinfo_get_processor_count();
+    if (shard_count == 0)
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_002: [ If sysinfo_get_processor_count returns 0, threadpool_statistics_recorder_create shall use 1 set of counters. ]*/
+        LogWarning("sysinfo_get_processor_count returned 0, using a single set of counters");
+        shard_count = 1;
+    }
+
+    /*Codes_SRS_THREADPOOL_STATISTICS_01_003: [ threadpool_statistics_recorder_create shall allocate a recorder with a set of counters for each processor. ]*/
+    result = malloc(sizeof(THREADPOOL_STATISTICS_RECORDER) + (size_t)shard_count * sizeof(THREADPOOL_STATISTICS_SHARD));
+    if (result == NULL)
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_005: [ If any error occurs, threadpool_statistics_recorder_create shall fail and return NULL. ]*/
+        LogError("malloc(sizeof(THREADPOOL_STATISTICS_RECORDER) + %" PRIu32 " * sizeof(THREADPOOL_STATISTICS_SHARD)) failed", shard_count);
+    }
+    else
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_004: [ threadpool_statistics_recorder_create shall initialize the queue depth, the peak queue depth and all the counters to 0. ]*/
+        result->shard_count = shard_count;
+        (void)interlocked_exchange_64(&result->queue_depth, 0);
+        (void)interlocked_exchange_64(&result->peak_queue_depth, 0);
+        for (uint32_t i = 0; i < shard_count; i++)
+        {
+            latency_histogram_init(&result->shards[i].queue_wait);
+            latency_histogram_init(&result->shards[i].run_time);
+            (void)interlocked_exchange_64(&result->shards[i].started_count, 0);
+            (void)interlocked_exchange_64(&result->shards[i].completed_count, 0);
+        }
+    }
+
+    return result;
+}
+
+void threadpool_statistics_recorder_destroy(THREADPOOL_STATISTICS_RECORDER_HANDLE recorder)
+{
+    if (recorder == NULL)
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_006: [ If recorder is NULL, threadpool_statistics_recorder_destroy shall return. ]*/
+        LogError("Invalid arguments: THREADPOOL_STATISTICS_RECORDER_HANDLE recorder=%p", recorder);
+    }
+    else
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_007: [ threadpool_statistics_recorder_destroy shall free the recorder. ]*/
+        free(recorder);
+    }
+}
+
+void threadpool_statistics_recorder_on_queued(THREADPOOL_STATISTICS_RECORDER_HANDLE recorder, uint32_t work_item_count)
+{
+    if (recorder == NULL)
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_008: [ If recorder is NULL, threadpool_statistics_recorder_on_queued shall return. ]*/
+        LogError("Invalid arguments: THREADPOOL_STATISTICS_RECORDER_HANDLE recorder=%p, uint32_t work_item_count=%" PRIu32 "", recorder, work_item_count);
+    }
+    else
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_009: [ threadpool_statistics_recorder_on_queued shall add work_item_count to the queue depth by calling interlocked_add_64. ]*/
+        int64_t queue_depth = interlocked_add_64(&recorder->queue_depth, work_item_count);
+
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_010: [ If the new queue depth is greater than the peak queue depth, threadpool_statistics_recorder_on_queued shall set the peak queue depth to it by calling interlocked_compare_exchange_64 until it succeeds or the peak is not smaller anymore. ]*/
+        update_max(&recorder->peak_queue_depth, queue_depth);
+    }
+}
+
+double threadpool_statistics_recorder_on_started(THREADPOOL_STATISTICS_RECORDER_HANDLE recorder, double schedule_time_us)
+{
+    double result;
+
+    if (recorder == NULL)
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_011: [ If recorder is NULL, threadpool_statistics_recorder_on_started shall return 0. ]*/
+        LogError("Invalid arguments: THREADPOOL_STATISTICS_RECORDER_HANDLE recorder=%p, double schedule_time_us=%f", recorder, schedule_time_us);
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_012: [ threadpool_statistics_recorder_on_started shall obtain the current time by calling timer_global_get_elapsed_us. ]*/
+        result = timer_global_get_elapsed_us();
+
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_013: [ threadpool_statistics_recorder_on_started shall pick the counters of the current processor, obtained by calling sysinfo_get_current_processor. ]*/
+        THREADPOOL_STATISTICS_SHARD* shard = get_current_shard(recorder);
+
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_014: [ threadpool_statistics_recorder_on_started shall record the time elapsed since schedule_time_us in the queue wait histogram of the processor by calling latency_histogram_record. ]*/
+        latency_histogram_record(&shard->queue_wait, result - schedule_time_us);
+
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_015: [ threadpool_statistics_recorder_on_started shall increment the count of started work items of the processor and decrement the queue depth. ]*/
+        (void)interlocked_increment_64(&shard->started_count);
+        (void)interlocked_decrement_64(&recorder->queue_depth);
+
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_016: [ threadpool_statistics_recorder_on_started shall return the current time. ]*/
+    }
+
+    return result;
+}
+
+double threadpool_statistics_recorder_on_completed(THREADPOOL_STATISTICS_RECORDER_HANDLE recorder, double start_time_us)
+{
+    double result;
+
+    if (recorder == NULL)
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_017: [ If recorder is NULL, threadpool_statistics_recorder_on_completed shall return 0. ]*/
+        LogError("Invalid arguments: THREADPOOL_STATISTICS_RECORDER_HANDLE recorder=%p, double start_time_us=%f", recorder, start_time_us);
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_018: [ threadpool_statistics_recorder_on_completed shall obtain the current time by calling timer_global_get_elapsed_us. ]*/
+        result = timer_global_get_elapsed_us();
+
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_019: [ threadpool_statistics_recorder_on_completed shall pick the counters of the current processor, obtained by calling sysinfo_get_current_processor. ]*/
+        /*the thread can have moved to another processor while it executed the work item, the counts only make sense summed anyway*/
+        THREADPOOL_STATISTICS_SHARD* shard = get_current_shard(recorder);
+
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_020: [ threadpool_statistics_recorder_on_completed shall record the time elapsed since start_time_us in the run time histogram of the processor by calling latency_histogram_record. ]*/
+        latency_histogram_record(&shard->run_time, result - start_time_us);
+
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_021: [ threadpool_statistics_recorder_on_completed shall increment the count of completed work items of the processor. ]*/
+        (void)interlocked_increment_64(&shard->completed_count);
+
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_022: [ threadpool_statistics_recorder_on_completed shall return the current time. ]*/
+    }
+
+    return result;
+}
+
+void threadpool_statistics_recorder_get(THREADPOOL_STATISTICS_RECORDER_HANDLE recorder, THREADPOOL_STATISTICS* statistics)
+{
+    if (
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_023: [ If recorder is NULL, threadpool_statistics_recorder_get shall return. ]*/
+        (recorder == NULL) ||
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_024: [ If statistics is NULL, threadpool_statistics_recorder_get shall return. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_STATISTICS_RECORDER_HANDLE recorder=%p, THREADPOOL_STATISTICS* statistics=%p", recorder, statistics);
+    }
+    else
+    {
+        int64_t started_count = 0;
+        int64_t completed_count = 0;
+
+        (void)memset(statistics, 0, sizeof(THREADPOOL_STATISTICS));
+
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_025: [ threadpool_statistics_recorder_get shall merge the queue wait and run time histograms of all the processors by calling latency_histogram_add_to_statistics. ]*/
+        for (uint32_t i = 0; i < recorder->shard_count; i++)
+        {
+            latency_histogram_add_to_statistics(&recorder->shards[i].queue_wait, &statistics->queue_wait);
+            latency_histogram_add_to_statistics(&recorder->shards[i].run_time, &statistics->run_time);
+            started_count += interlocked_add_64(&recorder->shards[i].started_count, 0);
+            completed_count += interlocked_add_64(&recorder->shards[i].completed_count, 0);
+        }
+
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_026: [ threadpool_statistics_recorder_get shall set the queue depth and the peak queue depth, counting a negative queue depth as 0. ]*/
+        /*a work item can start before the thread that queued it accounted for it*/
+        statistics->queue_depth = to_uint32_count(interlocked_add_64(&recorder->queue_depth, 0));
+        statistics->peak_queue_depth = to_uint32_count(interlocked_add_64(&recorder->peak_queue_depth, 0));
+
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_027: [ threadpool_statistics_recorder_get shall set the active worker count to the number of started work items minus the number of completed work items of all the processors. ]*/
+        statistics->active_worker_count = to_uint32_count(started_count - completed_count);
+
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_028: [ threadpool_statistics_recorder_get shall set the idle worker count to 0. ]*/
+        statistics->idle_worker_count = 0;
+    }
+}
+
+void threadpool_timer_lateness_init(THREADPOOL_TIMER_LATENESS* timer_lateness)
+{
+    if (timer_lateness == NULL)
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_029: [ If timer_lateness is NULL, threadpool_timer_lateness_init shall return. ]*/
+        LogError("Invalid arguments: THREADPOOL_TIMER_LATENESS* timer_lateness=%p", timer_lateness);
+    }
+    else
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_030: [ threadpool_timer_lateness_init shall set the due time and the period to 0 and initialize the lateness histogram by calling latency_histogram_init. ]*/
+        (void)interlocked_exchange_64(&timer_lateness->due_time_us, 0);
+        (void)interlocked_exchange(&timer_lateness->period_ms, 0);
+        latency_histogram_init(&timer_lateness->lateness);
+    }
+}
+
+void threadpool_timer_lateness_set_due_time(THREADPOOL_TIMER_LATENESS* timer_lateness, uint32_t start_delay_ms, uint32_t period_ms)
+{
+    if (timer_lateness == NULL)
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_031: [ If timer_lateness is NULL, threadpool_timer_lateness_set_due_time shall return. ]*/
+        LogError("Invalid arguments: THREADPOOL_TIMER_LATENESS* timer_lateness=%p, uint32_t start_delay_ms=%" PRIu32 ", uint32_t period_ms=%" PRIu32 "",
+            timer_lateness, start_delay_ms, period_ms);
+    }
+    else
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_032: [ threadpool_timer_lateness_set_due_time shall set the due time to the current time, obtained by calling timer_global_get_elapsed_us, plus start_delay_ms. ]*/
+        int64_t now_us = (int64_t)timer_global_get_elapsed_us();
+        (void)interlocked_exchange_64(&timer_lateness->due_time_us, now_us + ((int64_t)start_delay_ms * 1000));
+
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_033: [ threadpool_timer_lateness_set_due_time shall save period_ms. ]*/
+        (void)interlocked_exchange(&timer_lateness->period_ms, (int32_t)period_ms);
+    }
+}
+
+void threadpool_timer_lateness_on_fired(THREADPOOL_TIMER_LATENESS* timer_lateness)
+{
+    if (timer_lateness == NULL)
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_034: [ If timer_lateness is NULL, threadpool_timer_lateness_on_fired shall return. ]*/
+        LogError("Invalid arguments: THREADPOOL_TIMER_LATENESS* timer_lateness=%p", timer_lateness);
+    }
+    else
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_035: [ threadpool_timer_lateness_on_fired shall record the time elapsed since the due time, obtained by calling timer_global_get_elapsed_us, in the lateness histogram by calling latency_histogram_record. ]*/
+        int64_t now_us = (int64_t)timer_global_get_elapsed_us();
+        int64_t due_time_us = interlocked_add_64(&timer_lateness->due_time_us, 0);
+        latency_histogram_record(&timer_lateness->lateness, (double)(now_us - due_time_us));
+
+        int64_t period_us = (int64_t)(uint32_t)interlocked_add(&timer_lateness->period_ms, 0) * 1000;
+        if (period_us != 0)
+        {
+            /*Codes_SRS_THREADPOOL_STATISTICS_01_036: [ If the period is not 0, threadpool_timer_lateness_on_fired shall add to the due time the smallest multiple of the period that makes it later than the current time, by calling interlocked_compare_exchange_64 so that a concurrent threadpool_timer_lateness_set_due_time wins. ]*/
+            /*the expirations missed while the timer was late are not fired*/
+            int64_t next_due_time_us = due_time_us + period_us;
+            if (next_due_time_us <= now_us)
+            {
+                next_due_time_us += ((now_us - next_due_time_us) / period_us + 1) * period_us;
+            }
+
+            (void)interlocked_compare_exchange_64(&timer_lateness->due_time_us, next_due_time_us, due_time_us);
+        }
+    }
+}
+
+void threadpool_timer_lateness_get(THREADPOOL_TIMER_LATENESS* timer_lateness, THREADPOOL_TIMER_STATISTICS* statistics)
+{
+    if (
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_037: [ If timer_lateness is NULL, threadpool_timer_lateness_get shall return. ]*/
+        (timer_lateness == NULL) ||
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_038: [ If statistics is NULL, threadpool_timer_lateness_get shall return. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_TIMER_LATENESS* timer_lateness=%p, THREADPOOL_TIMER_STATISTICS* statistics=%p", timer_lateness, statistics);
+    }
+    else
+    {
+        /*Codes_SRS_THREADPOOL_STATISTICS_01_039: [ threadpool_timer_lateness_get shall fill statistics with the lateness histogram by calling latency_histogram_add_to_statistics. ]*/
+        (void)memset(statistics, 0, sizeof(THREADPOOL_TIMER_STATISTICS));
+        latency_histogram_add_to_statistics(&timer_lateness->lateness, &statistics->lateness);
+    }
+}
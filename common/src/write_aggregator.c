@@ -0,0 +1,696 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/srw_lock.h"
+
+#include "c_pal/write_aggregator.h"
+
+MU_DEFINE_ENUM_STRINGS(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_RESULT_VALUES)
+
+/*no write can end at UINT64_MAX (see write_aggregator_add), so this means "no stream yet"*/
+#define WRITE_AGGREGATOR_NO_STREAM UINT64_MAX
+
+typedef struct WRITE_AGGREGATOR_WRITE_TAG
+{
+    struct WRITE_AGGREGATOR_WRITE_TAG* next;
+    WRITE_AGGREGATOR_WRITE_CB user_callback;
+    void* user_context;
+} WRITE_AGGREGATOR_WRITE;
+
+typedef struct WRITE_AGGREGATOR_BLOCK_TAG
+{
+    WRITE_AGGREGATOR_IO io; /*first member, write_aggregator_io_complete gets the block back from it*/
+    struct WRITE_AGGREGATOR_BLOCK_TAG* next; /*used by the list of ready blocks and by the list of free blocks*/
+    unsigned char* buffer; /*max_aggregated_size + alignment bytes*/
+    uint32_t data_size;
+    uint64_t timer_id;
+    WRITE_AGGREGATOR_WRITE* first_write;
+    WRITE_AGGREGATOR_WRITE* last_write;
+} WRITE_AGGREGATOR_BLOCK;
+
+typedef struct WRITE_AGGREGATOR_TAG
+{
+    uint32_t alignment;
+    uint32_t max_aggregated_size;
+    uint32_t max_delay_ms;
+    WRITE_AGGREGATOR_ISSUE_IO issue_io;
+    WRITE_AGGREGATOR_START_TIMER start_timer;
+    WRITE_AGGREGATOR_SET_FILE_SIZE set_file_size;
+    void* context;
+
+    SRW_LOCK_HANDLE lock;
+
+    /*all the fields below are protected by lock*/
+    WRITE_AGGREGATOR_BLOCK* open_block;
+    uint64_t stream_end; /*the position where the last aggregated write ended*/
+    uint64_t file_end; /*the highest position written so far, aggregated or not, the logical size of the file*/
+    unsigned char* tail; /*alignment bytes, the data between the last aligned position and stream_end*/
+    /*only one aggregated I/O is in flight at a time, so that a block rewriting the partial tail of the previous one always lands after it*/
+    bool is_io_in_progress;
+    WRITE_AGGREGATOR_BLOCK* ready_blocks_head;
+    WRITE_AGGREGATOR_BLOCK* ready_blocks_tail;
+    WRITE_AGGREGATOR_BLOCK* free_blocks;
+    WRITE_AGGREGATOR_WRITE* free_writes;
+    uint64_t last_timer_id;
+} WRITE_AGGREGATOR;
+
+static void free_block(WRITE_AGGREGATOR_BLOCK* block)
+{
+    gballoc_hl_aligned_free(block->buffer);
+    free(block);
+}
+
+/*called with the lock held*/
+static WRITE_AGGREGATOR_BLOCK* get_block(WRITE_AGGREGATOR_HANDLE write_aggregator)
+{
+    WRITE_AGGREGATOR_BLOCK* result = write_aggregator->free_blocks;
+
+    if (result != NULL)
+    {
+        write_aggregator->free_blocks = result->next;
+    }
+    else
+    {
+        result = malloc(sizeof(WRITE_AGGREGATOR_BLOCK));
+        if (result == NULL)
+        {
+            LogError("failure in malloc(sizeof(WRITE_AGGREGATOR_BLOCK)=%zu)", sizeof(WRITE_AGGREGATOR_BLOCK));
+        }
+        else
+        {
+            result->buffer = gballoc_hl_aligned_malloc(write_aggregator->alignment, (size_t)write_aggregator->max_aggregated_size + write_aggregator->alignment);
+            if (result->buffer == NULL)
+            {
+                LogError("failure in gballoc_hl_aligned_malloc(alignment=%" PRIu32 ", size=%zu)",
+                    write_aggregator->alignment, (size_t)write_aggregator->max_aggregated_size + write_aggregator->alignment);
+                free(result);
+                result = NULL;
+            }
+        }
+    }
+
+    if (result != NULL)
+    {
+        result->next = NULL;
+        result->data_size = 0;
+        result->first_write = NULL;
+        result->last_write = NULL;
+    }
+
+    return result;
+}
+
+/*called with the lock held*/
+static WRITE_AGGREGATOR_WRITE* get_write(WRITE_AGGREGATOR_HANDLE write_aggregator)
+{
+    WRITE_AGGREGATOR_WRITE* result = write_aggregator->free_writes;
+
+    if (result != NULL)
+    {
+        write_aggregator->free_writes = result->next;
+    }
+    else
+    {
+        result = malloc(sizeof(WRITE_AGGREGATOR_WRITE));
+        if (result == NULL)
+        {
+            LogError("failure in malloc(sizeof(WRITE_AGGREGATOR_WRITE)=%zu)", sizeof(WRITE_AGGREGATOR_WRITE));
+        }
+    }
+
+    if (result != NULL)
+    {
+        result->next = NULL;
+    }
+
+    return result;
+}
+
+/*called with the lock held*/
+static void record_file_end(WRITE_AGGREGATOR_HANDLE write_aggregator, uint64_t write_end)
+{
+    if (write_end > write_aggregator->file_end)
+    {
+        write_aggregator->file_end = write_end;
+    }
+}
+
+/*called with the lock held, returns the block if it has to be issued by the caller once the lock is released*/
+static WRITE_AGGREGATOR_BLOCK* close_open_block(WRITE_AGGREGATOR_HANDLE write_aggregator)
+{
+    WRITE_AGGREGATOR_BLOCK* result;
+    WRITE_AGGREGATOR_BLOCK* block = write_aggregator->open_block;
+    uint32_t tail_size = block->data_size % write_aggregator->alignment;
+    uint32_t padding_size = (tail_size == 0) ? 0 : write_aggregator->alignment - tail_size;
+
+    write_aggregator->open_block = NULL;
+
+    /*Codes_SRS_WRITE_AGGREGATOR_01_036: [ close_open_block shall save the data after the last aligned position of the block as the tail of the stream. ]*/
+    (void)memcpy(write_aggregator->tail, block->buffer + block->data_size - tail_size, tail_size);
+
+    /*Codes_SRS_WRITE_AGGREGATOR_01_037: [ close_open_block shall pad the block with zeroes up to the next multiple of alignment. ]*/
+    (void)memset(block->buffer + block->data_size, 0, padding_size);
+    block->io.buffer = block->buffer;
+    block->io.size = block->data_size + padding_size;
+
+    if (write_aggregator->is_io_in_progress)
+    {
+        /*Codes_SRS_WRITE_AGGREGATOR_01_038: [ If an aggregated I/O is in progress, close_open_block shall append the block to the list of ready blocks. ]*/
+        if (write_aggregator->ready_blocks_tail == NULL)
+        {
+            write_aggregator->ready_blocks_head = block;
+        }
+        else
+        {
+            write_aggregator->ready_blocks_tail->next = block;
+        }
+        write_aggregator->ready_blocks_tail = block;
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_WRITE_AGGREGATOR_01_039: [ Otherwise close_open_block shall mark an aggregated I/O as being in progress and issue the block once the lock is released. ]*/
+        write_aggregator->is_io_in_progress = true;
+        result = block;
+    }
+
+    return result;
+}
+
+/*returns the writes of the block and the next block to issue, if any*/
+static WRITE_AGGREGATOR_BLOCK* release_block(WRITE_AGGREGATOR_HANDLE write_aggregator, WRITE_AGGREGATOR_BLOCK* block, WRITE_AGGREGATOR_WRITE** writes)
+{
+    WRITE_AGGREGATOR_BLOCK* result;
+
+    srw_lock_acquire_exclusive(write_aggregator->lock);
+
+    *writes = block->first_write;
+    block->first_write = NULL;
+    block->last_write = NULL;
+    block->next = write_aggregator->free_blocks;
+    write_aggregator->free_blocks = block;
+
+    result = write_aggregator->ready_blocks_head;
+    if (result == NULL)
+    {
+        write_aggregator->is_io_in_progress = false;
+    }
+    else
+    {
+        write_aggregator->ready_blocks_head = result->next;
+        if (write_aggregator->ready_blocks_head == NULL)
+        {
+            write_aggregator->ready_blocks_tail = NULL;
+        }
+        result->next = NULL;
+    }
+
+    srw_lock_release_exclusive(write_aggregator->lock);
+
+    return result;
+}
+
+static void complete_writes(WRITE_AGGREGATOR_HANDLE write_aggregator, WRITE_AGGREGATOR_WRITE* writes, bool is_successful)
+{
+    if (writes != NULL)
+    {
+        WRITE_AGGREGATOR_WRITE* last_write = NULL;
+
+        for (WRITE_AGGREGATOR_WRITE* write = writes; write != NULL; write = write->next)
+        {
+            write->user_callback(write->user_context, is_successful);
+            last_write = write;
+        }
+
+        srw_lock_acquire_exclusive(write_aggregator->lock);
+        last_write->next = write_aggregator->free_writes;
+        write_aggregator->free_writes = writes;
+        srw_lock_release_exclusive(write_aggregator->lock);
+    }
+}
+
+static void issue_blocks(WRITE_AGGREGATOR_HANDLE write_aggregator, WRITE_AGGREGATOR_BLOCK* block)
+{
+    while (block != NULL)
+    {
+        /*Codes_SRS_WRITE_AGGREGATOR_01_040: [ A block is issued by calling issue_io with context and the WRITE_AGGREGATOR_IO of the block. ]*/
+        if (write_aggregator->issue_io(write_aggregator->context, &block->io) == 0)
+        {
+            break;
+        }
+        else
+        {
+            WRITE_AGGREGATOR_WRITE* writes;
+
+            /*Codes_SRS_WRITE_AGGREGATOR_01_041: [ If issue_io fails, the user callbacks of all the writes in the block shall be called with is_successful set to false and the next ready block, if any, shall be issued. ]*/
+            LogError("failure in issue_io(context=%p, io=%p), position=%" PRIu64 ", size=%" PRIu32 "",
+                write_aggregator->context, &block->io, block->io.position, block->io.size);
+            WRITE_AGGREGATOR_BLOCK* next_block = release_block(write_aggregator, block, &writes);
+            complete_writes(write_aggregator, writes, false);
+            block = next_block;
+        }
+    }
+}
+
+static void fail_block_list(WRITE_AGGREGATOR_BLOCK* block)
+{
+    while (block != NULL)
+    {
+        WRITE_AGGREGATOR_BLOCK* next_block = block->next;
+        WRITE_AGGREGATOR_WRITE* write = block->first_write;
+        while (write != NULL)
+        {
+            WRITE_AGGREGATOR_WRITE* next_write = write->next;
+            write->user_callback(write->user_context, false);
+            free(write);
+            write = next_write;
+        }
+        free_block(block);
+        block = next_block;
+    }
+}
+
+WRITE_AGGREGATOR_HANDLE write_aggregator_create(uint32_t alignment, uint32_t max_aggregated_size, uint32_t max_delay_ms, uint64_t file_size, WRITE_AGGREGATOR_ISSUE_IO issue_io, WRITE_AGGREGATOR_START_TIMER start_timer, WRITE_AGGREGATOR_SET_FILE_SIZE set_file_size, void* context)
+{
+    WRITE_AGGREGATOR_HANDLE result;
+
+    if (
+        /*Codes_SRS_WRITE_AGGREGATOR_01_001: [ If alignment is 0 or is not a power of 2, write_aggregator_create shall fail and return NULL. ]*/
+        (alignment == 0) ||
+        ((alignment & (alignment - 1)) != 0) ||
+        /*Codes_SRS_WRITE_AGGREGATOR_01_002: [ If max_aggregated_size is 0 or is not a multiple of alignment, write_aggregator_create shall fail and return NULL. ]*/
+        (max_aggregated_size == 0) ||
+        ((max_aggregated_size % alignment) != 0) ||
+        /*Codes_SRS_WRITE_AGGREGATOR_01_003: [ If max_aggregated_size is greater than UINT32_MAX - alignment, write_aggregator_create shall fail and return NULL. ]*/
+        (max_aggregated_size > UINT32_MAX - alignment) ||
+        /*Codes_SRS_WRITE_AGGREGATOR_01_004: [ If max_delay_ms is 0, write_aggregator_create shall fail and return NULL. ]*/
+        (max_delay_ms == 0) ||
+        /*Codes_SRS_WRITE_AGGREGATOR_01_005: [ If issue_io is NULL, write_aggregator_create shall fail and return NULL. ]*/
+        (issue_io == NULL) ||
+        /*Codes_SRS_WRITE_AGGREGATOR_01_006: [ If start_timer is NULL, write_aggregator_create shall fail and return NULL. ]*/
+        (start_timer == NULL) ||
+        /*Codes_SRS_WRITE_AGGREGATOR_01_052: [ If set_file_size is NULL and alignment is not 1, write_aggregator_create shall fail and return NULL. ]*/
+        ((set_file_size == NULL) && (alignment != 1))
+        )
+    {
+        LogError("Invalid arguments: uint32_t alignment=%" PRIu32 ", uint32_t max_aggregated_size=%" PRIu32 ", uint32_t max_delay_ms=%" PRIu32 ", uint64_t file_size=%" PRIu64 ", WRITE_AGGREGATOR_ISSUE_IO issue_io=%p, WRITE_AGGREGATOR_START_TIMER start_timer=%p, WRITE_AGGREGATOR_SET_FILE_SIZE set_file_size=%p, void* context=%p",
+            alignment, max_aggregated_size, max_delay_ms, file_size, issue_io, start_timer, set_file_size, context);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_WRITE_AGGREGATOR_01_007: [ write_aggregator_create shall allocate memory for the aggregator. ]*/
+        result = malloc(sizeof(WRITE_AGGREGATOR));
+        if (result == NULL)
+        {
+            /*Codes_SRS_WRITE_AGGREGATOR_01_010: [ If any error occurs, write_aggregator_create shall fail and return NULL. ]*/
+            LogError("failure in malloc(sizeof(WRITE_AGGREGATOR)=%zu)", sizeof(WRITE_AGGREGATOR));
+        }
+        else
+        {
+            /*Codes_SRS_WRITE_AGGREGATOR_01_008: [ write_aggregator_create shall allocate alignment bytes for the tail of the stream. ]*/
+            result->tail = malloc(alignment);
+            if (result->tail == NULL)
+            {
+                /*Codes_SRS_WRITE_AGGREGATOR_01_010: [ If any error occurs, write_aggregator_create shall fail and return NULL. ]*/
+                LogError("failure in malloc(alignment=%" PRIu32 ")", alignment);
+            }
+            else
+            {
+                /*Codes_SRS_WRITE_AGGREGATOR_01_061: [ write_aggregator_create shall create the lock by calling srw_lock_create. ]*/
+                result->lock = srw_lock_create(false, "write_aggregator");
+                if (result->lock == NULL)
+                {
+                    /*Codes_SRS_WRITE_AGGREGATOR_01_010: [ If any error occurs, write_aggregator_create shall fail and return NULL. ]*/
+                    LogError("failure in srw_lock_create(false, \"write_aggregator\")");
+                }
+                else
+                {
+                    result->alignment = alignment;
+                    result->max_aggregated_size = max_aggregated_size;
+                    result->max_delay_ms = max_delay_ms;
+                    result->issue_io = issue_io;
+                    result->start_timer = start_timer;
+                    result->set_file_size = set_file_size;
+                    result->context = context;
+
+                    /*Codes_SRS_WRITE_AGGREGATOR_01_009: [ write_aggregator_create shall start with no open block, no stream and no aggregated I/O in progress and return the aggregator. ]*/
+                    result->open_block = NULL;
+                    result->stream_end = WRITE_AGGREGATOR_NO_STREAM;
+                    /*Codes_SRS_WRITE_AGGREGATOR_01_053: [ write_aggregator_create shall record file_size as the end of the file. ]*/
+                    result->file_end = file_size;
+                    result->is_io_in_progress = false;
+                    result->ready_blocks_head = NULL;
+                    result->ready_blocks_tail = NULL;
+                    result->free_blocks = NULL;
+                    result->free_writes = NULL;
+                    result->last_timer_id = 0;
+
+                    goto all_ok;
+                }
+                free(result->tail);
+            }
+            free(result);
+            result = NULL;
+        }
+    }
+
+all_ok:
+    return result;
+}
+
+void write_aggregator_destroy(WRITE_AGGREGATOR_HANDLE write_aggregator)
+{
+    if (write_aggregator == NULL)
+    {
+        /*Codes_SRS_WRITE_AGGREGATOR_01_011: [ If write_aggregator is NULL, write_aggregator_destroy shall return. ]*/
+        LogError("Invalid arguments: WRITE_AGGREGATOR_HANDLE write_aggregator=%p", write_aggregator);
+    }
+    else
+    {
+        /*Codes_SRS_WRITE_AGGREGATOR_01_012: [ write_aggregator_destroy shall call the user callbacks of all the writes that were not issued with is_successful set to false. ]*/
+        fail_block_list(write_aggregator->open_block);
+        fail_block_list(write_aggregator->ready_blocks_head);
+
+        /*Codes_SRS_WRITE_AGGREGATOR_01_013: [ write_aggregator_destroy shall free all the cached blocks and writes. ]*/
+        fail_block_list(write_aggregator->free_blocks);
+        WRITE_AGGREGATOR_WRITE* write = write_aggregator->free_writes;
+        while (write != NULL)
+        {
+            WRITE_AGGREGATOR_WRITE* next_write = write->next;
+            free(write);
+            write = next_write;
+        }
+
+        /*Codes_SRS_WRITE_AGGREGATOR_01_014: [ write_aggregator_destroy shall destroy the lock and free the tail and the memory of the aggregator. ]*/
+        srw_lock_destroy(write_aggregator->lock);
+        free(write_aggregator->tail);
+        free(write_aggregator);
+    }
+}
+
+WRITE_AGGREGATOR_ADD_RESULT write_aggregator_add(WRITE_AGGREGATOR_HANDLE write_aggregator, const unsigned char* source, uint32_t size, uint64_t position, WRITE_AGGREGATOR_WRITE_CB user_callback, void* user_context)
+{
+    WRITE_AGGREGATOR_ADD_RESULT result;
+
+    if (
+        /*Codes_SRS_WRITE_AGGREGATOR_01_015: [ If write_aggregator is NULL, write_aggregator_add shall fail and return WRITE_AGGREGATOR_ADD_ERROR. ]*/
+        (write_aggregator == NULL) ||
+        /*Codes_SRS_WRITE_AGGREGATOR_01_016: [ If source is NULL, write_aggregator_add shall fail and return WRITE_AGGREGATOR_ADD_ERROR. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_WRITE_AGGREGATOR_01_017: [ If size is 0, write_aggregator_add shall fail and return WRITE_AGGREGATOR_ADD_ERROR. ]*/
+        (size == 0) ||
+        /*Codes_SRS_WRITE_AGGREGATOR_01_018: [ If position + size is greater than or equal to UINT64_MAX, write_aggregator_add shall fail and return WRITE_AGGREGATOR_ADD_ERROR. ]*/
+        (position >= UINT64_MAX - size) ||
+        /*Codes_SRS_WRITE_AGGREGATOR_01_019: [ If user_callback is NULL, write_aggregator_add shall fail and return WRITE_AGGREGATOR_ADD_ERROR. ]*/
+        (user_callback == NULL)
+        )
+    {
+        LogError("Invalid arguments: WRITE_AGGREGATOR_HANDLE write_aggregator=%p, const unsigned char* source=%p, uint32_t size=%" PRIu32 ", uint64_t position=%" PRIu64 ", WRITE_AGGREGATOR_WRITE_CB user_callback=%p, void* user_context=%p",
+            write_aggregator, source, size, position, user_callback, user_context);
+        result = WRITE_AGGREGATOR_ADD_ERROR;
+    }
+    else
+    {
+        WRITE_AGGREGATOR_BLOCK* block_to_issue = NULL;
+        bool start_timer = false;
+        uint64_t timer_id = 0;
+
+        srw_lock_acquire_exclusive(write_aggregator->lock);
+
+        if (
+            /*Codes_SRS_WRITE_AGGREGATOR_01_020: [ If size is greater than or equal to max_aggregated_size, write_aggregator_add shall return WRITE_AGGREGATOR_ADD_NOT_AGGREGATED. ]*/
+            (size >= write_aggregator->max_aggregated_size) ||
+            /*Codes_SRS_WRITE_AGGREGATOR_01_021: [ If position is not where the last aggregated write ended and is not a multiple of alignment, write_aggregator_add shall return WRITE_AGGREGATOR_ADD_NOT_AGGREGATED. ]*/
+            ((position != write_aggregator->stream_end) && ((position % write_aggregator->alignment) != 0)) ||
+            /*Codes_SRS_WRITE_AGGREGATOR_01_054: [ If alignment is not 1 and position is before the end of the file, write_aggregator_add shall return WRITE_AGGREGATOR_ADD_NOT_AGGREGATED. ]*/
+            ((write_aggregator->alignment != 1) && (position < write_aggregator->file_end))
+            )
+        {
+            /*padding an aligned block that holds data written before would overwrite that data with zeroes, so only appends are aggregated*/
+            /*Codes_SRS_WRITE_AGGREGATOR_01_055: [ If write_aggregator_add returns WRITE_AGGREGATOR_ADD_OK or WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, it shall record position + size as the end of the file if it is past the end of the file. ]*/
+            record_file_end(write_aggregator, position + size);
+            result = WRITE_AGGREGATOR_ADD_NOT_AGGREGATED;
+        }
+        else
+        {
+            /*Codes_SRS_WRITE_AGGREGATOR_01_022: [ write_aggregator_add shall obtain a write entry, reusing a previously released one if available. ]*/
+            WRITE_AGGREGATOR_WRITE* write = get_write(write_aggregator);
+            if (write == NULL)
+            {
+                /*Codes_SRS_WRITE_AGGREGATOR_01_035: [ If any error occurs, write_aggregator_add shall fail and return WRITE_AGGREGATOR_ADD_ERROR. ]*/
+                LogError("failure in get_write");
+                result = WRITE_AGGREGATOR_ADD_ERROR;
+            }
+            else
+            {
+                if (
+                    (write_aggregator->open_block != NULL) &&
+                    (
+                        (position != write_aggregator->stream_end) ||
+                        (write_aggregator->open_block->data_size + size > write_aggregator->max_aggregated_size)
+                    )
+                    )
+                {
+                    /*Codes_SRS_WRITE_AGGREGATOR_01_023: [ If there is an open block and the write does not continue it or does not fit in it, write_aggregator_add shall close the open block. ]*/
+                    block_to_issue = close_open_block(write_aggregator);
+                }
+
+                if (write_aggregator->open_block == NULL)
+                {
+                    /*Codes_SRS_WRITE_AGGREGATOR_01_024: [ If there is no open block, write_aggregator_add shall obtain a block, reusing a previously released one if available. ]*/
+                    WRITE_AGGREGATOR_BLOCK* block = get_block(write_aggregator);
+                    if (block == NULL)
+                    {
+                        LogError("failure in get_block");
+                        write->next = write_aggregator->free_writes;
+                        write_aggregator->free_writes = write;
+                    }
+                    else
+                    {
+                        /*the prefix is only non-empty for writes continuing a stream that ended in the middle of an aligned block*/
+                        uint32_t prefix_size = (uint32_t)(position % write_aggregator->alignment);
+
+                        /*Codes_SRS_WRITE_AGGREGATOR_01_025: [ write_aggregator_add shall start the block at position rounded down to a multiple of alignment and copy the saved tail of the stream before the data. ]*/
+                        block->io.position = position - prefix_size;
+                        (void)memcpy(block->buffer, write_aggregator->tail, prefix_size);
+                        block->data_size = prefix_size;
+
+                        /*Codes_SRS_WRITE_AGGREGATOR_01_026: [ write_aggregator_add shall assign a new timer id to the block and make it the open block. ]*/
+                        block->timer_id = ++write_aggregator->last_timer_id;
+                        write_aggregator->open_block = block;
+
+                        start_timer = true;
+                        timer_id = block->timer_id;
+                    }
+                }
+
+                if (write_aggregator->open_block == NULL)
+                {
+                    /*Codes_SRS_WRITE_AGGREGATOR_01_035: [ If any error occurs, write_aggregator_add shall fail and return WRITE_AGGREGATOR_ADD_ERROR. ]*/
+                    result = WRITE_AGGREGATOR_ADD_ERROR;
+                }
+                else
+                {
+                    WRITE_AGGREGATOR_BLOCK* block = write_aggregator->open_block;
+
+                    /*Codes_SRS_WRITE_AGGREGATOR_01_027: [ write_aggregator_add shall copy size bytes from source at the end of the open block. ]*/
+                    (void)memcpy(block->buffer + block->data_size, source, size);
+                    block->data_size += size;
+
+                    /*Codes_SRS_WRITE_AGGREGATOR_01_028: [ write_aggregator_add shall append user_callback and user_context to the writes of the open block. ]*/
+                    write->user_callback = user_callback;
+                    write->user_context = user_context;
+                    if (block->last_write == NULL)
+                    {
+                        block->first_write = write;
+                    }
+                    else
+                    {
+                        block->last_write->next = write;
+                    }
+                    block->last_write = write;
+
+                    /*Codes_SRS_WRITE_AGGREGATOR_01_029: [ write_aggregator_add shall record position + size as the end of the stream. ]*/
+                    write_aggregator->stream_end = position + size;
+                    /*Codes_SRS_WRITE_AGGREGATOR_01_055: [ If write_aggregator_add returns WRITE_AGGREGATOR_ADD_OK or WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, it shall record position + size as the end of the file if it is past the end of the file. ]*/
+                    record_file_end(write_aggregator, position + size);
+
+                    if (block->data_size >= write_aggregator->max_aggregated_size)
+                    {
+                        /*Codes_SRS_WRITE_AGGREGATOR_01_030: [ If the open block holds at least max_aggregated_size bytes, write_aggregator_add shall close it. ]*/
+                        WRITE_AGGREGATOR_BLOCK* full_block = close_open_block(write_aggregator);
+                        if (full_block != NULL)
+                        {
+                            block_to_issue = full_block;
+                        }
+                        start_timer = false;
+                    }
+
+                    /*Codes_SRS_WRITE_AGGREGATOR_01_034: [ write_aggregator_add shall succeed and return WRITE_AGGREGATOR_ADD_OK. ]*/
+                    result = WRITE_AGGREGATOR_ADD_OK;
+                }
+            }
+        }
+
+        srw_lock_release_exclusive(write_aggregator->lock);
+
+        /*Codes_SRS_WRITE_AGGREGATOR_01_031: [ After releasing the lock, write_aggregator_add shall issue any block that was closed. ]*/
+        issue_blocks(write_aggregator, block_to_issue);
+
+        if (start_timer)
+        {
+            /*Codes_SRS_WRITE_AGGREGATOR_01_032: [ If a new block was opened and is still open, write_aggregator_add shall call start_timer with context, max_delay_ms and the timer id of the block. ]*/
+            if (write_aggregator->start_timer(write_aggregator->context, write_aggregator->max_delay_ms, timer_id) != 0)
+            {
+                /*Codes_SRS_WRITE_AGGREGATOR_01_033: [ If start_timer fails, write_aggregator_add shall close the block as if the timer had expired. ]*/
+                LogError("failure in start_timer(context=%p, max_delay_ms=%" PRIu32 ", timer_id=%" PRIu64 ")",
+                    write_aggregator->context, write_aggregator->max_delay_ms, timer_id);
+                write_aggregator_on_timer(write_aggregator, timer_id);
+            }
+        }
+    }
+
+    return result;
+}
+
+void write_aggregator_note_write(WRITE_AGGREGATOR_HANDLE write_aggregator, uint64_t position, uint64_t size)
+{
+    if (
+        /*Codes_SRS_WRITE_AGGREGATOR_01_056: [ If write_aggregator is NULL, write_aggregator_note_write shall return. ]*/
+        (write_aggregator == NULL) ||
+        /*Codes_SRS_WRITE_AGGREGATOR_01_057: [ If position + size is greater than UINT64_MAX, write_aggregator_note_write shall return. ]*/
+        (size > UINT64_MAX - position)
+        )
+    {
+        LogError("Invalid arguments: WRITE_AGGREGATOR_HANDLE write_aggregator=%p, uint64_t position=%" PRIu64 ", uint64_t size=%" PRIu64 "",
+            write_aggregator, position, size);
+    }
+    else
+    {
+        srw_lock_acquire_exclusive(write_aggregator->lock);
+
+        /*Codes_SRS_WRITE_AGGREGATOR_01_058: [ write_aggregator_note_write shall record position + size as the end of the file if it is past the end of the file. ]*/
+        record_file_end(write_aggregator, position + size);
+
+        srw_lock_release_exclusive(write_aggregator->lock);
+    }
+}
+
+void write_aggregator_flush(WRITE_AGGREGATOR_HANDLE write_aggregator)
+{
+    if (write_aggregator == NULL)
+    {
+        /*Codes_SRS_WRITE_AGGREGATOR_01_042: [ If write_aggregator is NULL, write_aggregator_flush shall return. ]*/
+        LogError("Invalid arguments: WRITE_AGGREGATOR_HANDLE write_aggregator=%p", write_aggregator);
+    }
+    else
+    {
+        WRITE_AGGREGATOR_BLOCK* block_to_issue = NULL;
+
+        srw_lock_acquire_exclusive(write_aggregator->lock);
+
+        if (write_aggregator->open_block != NULL)
+        {
+            /*Codes_SRS_WRITE_AGGREGATOR_01_043: [ If there is an open block, write_aggregator_flush shall close it and issue it if no aggregated I/O is in progress. ]*/
+            block_to_issue = close_open_block(write_aggregator);
+        }
+
+        srw_lock_release_exclusive(write_aggregator->lock);
+
+        issue_blocks(write_aggregator, block_to_issue);
+    }
+}
+
+void write_aggregator_on_timer(WRITE_AGGREGATOR_HANDLE write_aggregator, uint64_t timer_id)
+{
+    if (write_aggregator == NULL)
+    {
+        /*Codes_SRS_WRITE_AGGREGATOR_01_044: [ If write_aggregator is NULL, write_aggregator_on_timer shall return. ]*/
+        LogError("Invalid arguments: WRITE_AGGREGATOR_HANDLE write_aggregator=%p, uint64_t timer_id=%" PRIu64 "", write_aggregator, timer_id);
+    }
+    else
+    {
+        WRITE_AGGREGATOR_BLOCK* block_to_issue = NULL;
+
+        srw_lock_acquire_exclusive(write_aggregator->lock);
+
+        /*Codes_SRS_WRITE_AGGREGATOR_01_046: [ Otherwise write_aggregator_on_timer shall return, the block the timer was started for was already closed. ]*/
+        if (
+            (write_aggregator->open_block != NULL) &&
+            (write_aggregator->open_block->timer_id == timer_id)
+            )
+        {
+            /*Codes_SRS_WRITE_AGGREGATOR_01_045: [ If the open block has the timer id timer_id, write_aggregator_on_timer shall close it and issue it if no aggregated I/O is in progress. ]*/
+            block_to_issue = close_open_block(write_aggregator);
+        }
+
+        srw_lock_release_exclusive(write_aggregator->lock);
+
+        issue_blocks(write_aggregator, block_to_issue);
+    }
+}
+
+void write_aggregator_io_complete(WRITE_AGGREGATOR_HANDLE write_aggregator, WRITE_AGGREGATOR_IO* io, bool is_successful)
+{
+    if (
+        /*Codes_SRS_WRITE_AGGREGATOR_01_047: [ If write_aggregator is NULL, write_aggregator_io_complete shall return. ]*/
+        (write_aggregator == NULL) ||
+        /*Codes_SRS_WRITE_AGGREGATOR_01_048: [ If io is NULL, write_aggregator_io_complete shall return. ]*/
+        (io == NULL)
+        )
+    {
+        LogError("Invalid arguments: WRITE_AGGREGATOR_HANDLE write_aggregator=%p, WRITE_AGGREGATOR_IO* io=%p, bool is_successful=%d",
+            write_aggregator, io, is_successful);
+    }
+    else
+    {
+        WRITE_AGGREGATOR_BLOCK* block = (WRITE_AGGREGATOR_BLOCK*)io;
+        WRITE_AGGREGATOR_WRITE* writes;
+
+        if (
+            is_successful &&
+            (block->io.size != block->data_size)
+            )
+        {
+            uint64_t data_end = block->io.position + block->data_size;
+
+            /*the lock is held while setting the size so that no write past data_end can be admitted or noted in the meantime*/
+            srw_lock_acquire_exclusive(write_aggregator->lock);
+
+            if (data_end == write_aggregator->file_end)
+            {
+                /*Codes_SRS_WRITE_AGGREGATOR_01_059: [ If is_successful is true, the block was padded and the data of the block ends at the end of the file, write_aggregator_io_complete shall call set_file_size with context and the end of the data of the block while holding the lock. ]*/
+                if (write_aggregator->set_file_size(write_aggregator->context, data_end) != 0)
+                {
+                    /*Codes_SRS_WRITE_AGGREGATOR_01_060: [ If set_file_size fails, write_aggregator_io_complete shall call the user callbacks of the writes in the block with is_successful set to false. ]*/
+                    LogError("failure in set_file_size(context=%p, file_size=%" PRIu64 ")", write_aggregator->context, data_end);
+                    is_successful = false;
+                }
+            }
+
+            srw_lock_release_exclusive(write_aggregator->lock);
+        }
+
+        /*Codes_SRS_WRITE_AGGREGATOR_01_049: [ write_aggregator_io_complete shall release the block and take the next ready block, if any. ]*/
+        WRITE_AGGREGATOR_BLOCK* next_block = release_block(write_aggregator, block, &writes);
+
+        /*Codes_SRS_WRITE_AGGREGATOR_01_050: [ write_aggregator_io_complete shall issue the next ready block. ]*/
+        issue_blocks(write_aggregator, next_block);
+
+        /*Codes_SRS_WRITE_AGGREGATOR_01_051: [ write_aggregator_io_complete shall call the user callbacks of all the writes in the block, in the order they were added, with is_successful. ]*/
+        complete_writes(write_aggregator, writes, is_successful);
+    }
+}
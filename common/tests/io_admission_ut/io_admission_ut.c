@@ -0,0 +1,708 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#else
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#endif
+
+#include "macro_utils/macro_utils.h" // IWYU pragma: keep
+
+#include "real_gballoc_ll.h"
+static void* real_malloc(size_t size)
+{
+    return real_gballoc_ll_malloc(size);
+}
+
+static void real_free(void* ptr)
+{
+    real_gballoc_ll_free(ptr);
+}
+
+// IWYU pragma: no_include <wchar.h>
+#include "testrunnerswitcher.h"
+
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umock_c_negative_tests.h"
+
+#define ENABLE_MOCKS
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/srw_lock.h"
+
+MOCKABLE_FUNCTION(, void, test_on_admitted, void*, context);
+#undef ENABLE_MOCKS
+
+#include "real_gballoc_hl.h"
+
+#include "c_pal/io_admission.h"
+
+#define TEST_MAX_OUTSTANDING_COUNT 2
+
+static SRW_LOCK_HANDLE test_srw_lock = (SRW_LOCK_HANDLE)0x4400;
+static void* test_context_1 = (void*)0x4401;
+static void* test_context_2 = (void*)0x4402;
+static void* test_context_3 = (void*)0x4403;
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+TEST_DEFINE_ENUM_TYPE(IO_ADMISSION_RESULT, IO_ADMISSION_RESULT_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static void expect_lock(void)
+{
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(test_srw_lock));
+}
+
+static void expect_unlock(void)
+{
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(test_srw_lock));
+}
+
+static void init_waiter(IO_ADMISSION_WAITER* waiter, void* context)
+{
+    waiter->on_admitted = test_on_admitted;
+    waiter->on_admitted_context = context;
+    waiter->priority = IO_ADMISSION_PRIORITY_NORMAL;
+    waiter->next = NULL;
+}
+
+/*creates an admission with all TEST_MAX_OUTSTANDING_COUNT slots taken*/
+static IO_ADMISSION_HANDLE test_create_full_admission(void)
+{
+    IO_ADMISSION_HANDLE admission = io_admission_create(TEST_MAX_OUTSTANDING_COUNT);
+    ASSERT_IS_NOT_NULL(admission);
+    for (uint32_t i = 0; i < TEST_MAX_OUTSTANDING_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_ADMITTED, io_admission_try_acquire(admission));
+    }
+    umock_c_reset_all_calls();
+    return admission;
+}
+
+static void test_get_statistics(IO_ADMISSION_HANDLE admission, IO_ADMISSION_STATISTICS* statistics)
+{
+    ASSERT_ARE_EQUAL(int, 0, io_admission_get_statistics(admission, statistics));
+    umock_c_reset_all_calls();
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init");
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+
+    REGISTER_UMOCK_ALIAS_TYPE(SRW_LOCK_HANDLE, void*);
+
+    REGISTER_GLOBAL_MOCK_HOOK(malloc, real_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
+
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(srw_lock_create, test_srw_lock, NULL);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+    ASSERT_ARE_EQUAL(int, 0, umock_c_negative_tests_init());
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    umock_c_negative_tests_deinit();
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+/* io_admission_create */
+
+/* Tests_SRS_IO_ADMISSION_01_001: [ If max_outstanding_count is 0, io_admission_create shall fail and return NULL. ]*/
+TEST_FUNCTION(io_admission_create_with_max_outstanding_count_0_fails)
+{
+    // arrange
+
+    // act
+    IO_ADMISSION_HANDLE admission = io_admission_create(0);
+
+    // assert
+    ASSERT_IS_NULL(admission);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_IO_ADMISSION_01_002: [ io_admission_create shall allocate memory for the admission. ]*/
+/* Tests_SRS_IO_ADMISSION_01_024: [ io_admission_create shall create the lock by calling srw_lock_create. ]*/
+/* Tests_SRS_IO_ADMISSION_01_003: [ io_admission_create shall set the number of outstanding and queued I/Os and all the counters to 0 and succeed. ]*/
+TEST_FUNCTION(io_admission_create_succeeds)
+{
+    // arrange
+    IO_ADMISSION_STATISTICS statistics;
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_create(false, IGNORED_ARG));
+
+    // act
+    IO_ADMISSION_HANDLE admission = io_admission_create(TEST_MAX_OUTSTANDING_COUNT);
+
+    // assert
+    ASSERT_IS_NOT_NULL(admission);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    test_get_statistics(admission, &statistics);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_MAX_OUTSTANDING_COUNT, statistics.max_outstanding_count);
+    ASSERT_ARE_EQUAL(uint32_t, 0, statistics.outstanding_count);
+    ASSERT_ARE_EQUAL(uint32_t, 0, statistics.peak_outstanding_count);
+    ASSERT_ARE_EQUAL(uint32_t, 0, statistics.queued_count);
+    ASSERT_ARE_EQUAL(uint32_t, 0, statistics.peak_queued_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.busy_count);
+
+    // cleanup
+    io_admission_destroy(admission);
+}
+
+/* Tests_SRS_IO_ADMISSION_01_004: [ If any error occurs, io_admission_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_io_admission_create_also_fails)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_create(false, IGNORED_ARG));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            IO_ADMISSION_HANDLE admission = io_admission_create(TEST_MAX_OUTSTANDING_COUNT);
+
+            // assert
+            ASSERT_IS_NULL(admission, "On failed call %zu", i);
+        }
+    }
+}
+
+/* io_admission_destroy */
+
+/* Tests_SRS_IO_ADMISSION_01_005: [ If admission is NULL, io_admission_destroy shall return. ]*/
+TEST_FUNCTION(io_admission_destroy_with_NULL_admission_returns)
+{
+    // arrange
+
+    // act
+    io_admission_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_IO_ADMISSION_01_006: [ io_admission_destroy shall destroy the lock and free the memory of the admission. ]*/
+TEST_FUNCTION(io_admission_destroy_frees_the_memory)
+{
+    // arrange
+    IO_ADMISSION_HANDLE admission = io_admission_create(TEST_MAX_OUTSTANDING_COUNT);
+    ASSERT_IS_NOT_NULL(admission);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(srw_lock_destroy(test_srw_lock));
+    STRICT_EXPECTED_CALL(free(admission));
+
+    // act
+    io_admission_destroy(admission);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* io_admission_try_acquire */
+
+/* Tests_SRS_IO_ADMISSION_01_007: [ If admission is NULL, io_admission_try_acquire shall fail and return IO_ADMISSION_ERROR. ]*/
+TEST_FUNCTION(io_admission_try_acquire_with_NULL_admission_fails)
+{
+    // arrange
+
+    // act
+    IO_ADMISSION_RESULT result = io_admission_try_acquire(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_IO_ADMISSION_01_008: [ If no I/O is queued and fewer than max_outstanding_count I/Os are outstanding, io_admission_try_acquire shall increment the number of outstanding I/Os, update the peak number of outstanding I/Os and return IO_ADMISSION_ADMITTED. ]*/
+TEST_FUNCTION(io_admission_try_acquire_takes_a_free_slot)
+{
+    // arrange
+    IO_ADMISSION_STATISTICS statistics;
+    IO_ADMISSION_HANDLE admission = io_admission_create(TEST_MAX_OUTSTANDING_COUNT);
+    ASSERT_IS_NOT_NULL(admission);
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    IO_ADMISSION_RESULT result = io_admission_try_acquire(admission);
+
+    // assert
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_ADMITTED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    test_get_statistics(admission, &statistics);
+    ASSERT_ARE_EQUAL(uint32_t, 1, statistics.outstanding_count);
+    ASSERT_ARE_EQUAL(uint32_t, 1, statistics.peak_outstanding_count);
+
+    // cleanup
+    io_admission_release(admission);
+    io_admission_destroy(admission);
+}
+
+/* Tests_SRS_IO_ADMISSION_01_009: [ Otherwise io_admission_try_acquire shall increment the busy counter and return IO_ADMISSION_BUSY. ]*/
+TEST_FUNCTION(io_admission_try_acquire_when_all_slots_are_taken_returns_BUSY)
+{
+    // arrange
+    IO_ADMISSION_STATISTICS statistics;
+    IO_ADMISSION_HANDLE admission = test_create_full_admission();
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    IO_ADMISSION_RESULT result = io_admission_try_acquire(admission);
+
+    // assert
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_BUSY, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    test_get_statistics(admission, &statistics);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_MAX_OUTSTANDING_COUNT, statistics.outstanding_count);
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.busy_count);
+
+    // cleanup
+    io_admission_destroy(admission);
+}
+
+/* io_admission_acquire */
+
+/* Tests_SRS_IO_ADMISSION_01_010: [ If admission is NULL, io_admission_acquire shall fail and return IO_ADMISSION_ERROR. ]*/
+TEST_FUNCTION(io_admission_acquire_with_NULL_admission_fails)
+{
+    // arrange
+    IO_ADMISSION_WAITER waiter;
+    init_waiter(&waiter, test_context_1);
+
+    // act
+    IO_ADMISSION_RESULT result = io_admission_acquire(NULL, &waiter);
+
+    // assert
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_IO_ADMISSION_01_011: [ If waiter is NULL, io_admission_acquire shall fail and return IO_ADMISSION_ERROR. ]*/
+TEST_FUNCTION(io_admission_acquire_with_NULL_waiter_fails)
+{
+    // arrange
+    IO_ADMISSION_HANDLE admission = io_admission_create(TEST_MAX_OUTSTANDING_COUNT);
+    ASSERT_IS_NOT_NULL(admission);
+    umock_c_reset_all_calls();
+
+    // act
+    IO_ADMISSION_RESULT result = io_admission_acquire(admission, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_admission_destroy(admission);
+}
+
+/* Tests_SRS_IO_ADMISSION_01_012: [ If the on_admitted field of waiter is NULL, io_admission_acquire shall fail and return IO_ADMISSION_ERROR. ]*/
+TEST_FUNCTION(io_admission_acquire_with_NULL_on_admitted_fails)
+{
+    // arrange
+    IO_ADMISSION_WAITER waiter;
+    IO_ADMISSION_HANDLE admission = io_admission_create(TEST_MAX_OUTSTANDING_COUNT);
+    ASSERT_IS_NOT_NULL(admission);
+    umock_c_reset_all_calls();
+    init_waiter(&waiter, test_context_1);
+    waiter.on_admitted = NULL;
+
+    // act
+    IO_ADMISSION_RESULT result = io_admission_acquire(admission, &waiter);
+
+    // assert
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_admission_destroy(admission);
+}
+
+/* Tests_SRS_IO_ADMISSION_01_022: [ If the priority field of waiter is not IO_ADMISSION_PRIORITY_NORMAL or IO_ADMISSION_PRIORITY_LOW, io_admission_acquire shall fail and return IO_ADMISSION_ERROR. ]*/
+TEST_FUNCTION(io_admission_acquire_with_invalid_priority_fails)
+{
+    // arrange
+    IO_ADMISSION_WAITER waiter;
+    IO_ADMISSION_HANDLE admission = io_admission_create(TEST_MAX_OUTSTANDING_COUNT);
+    ASSERT_IS_NOT_NULL(admission);
+    umock_c_reset_all_calls();
+    init_waiter(&waiter, test_context_1);
+    waiter.priority = (IO_ADMISSION_PRIORITY)0x42;
+
+    // act
+    IO_ADMISSION_RESULT result = io_admission_acquire(admission, &waiter);
+
+    // assert
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_admission_destroy(admission);
+}
+
+/* Tests_SRS_IO_ADMISSION_01_013: [ If no I/O is queued and fewer than max_outstanding_count I/Os are outstanding, io_admission_acquire shall increment the number of outstanding I/Os, update the peak number of outstanding I/Os and return IO_ADMISSION_ADMITTED. ]*/
+TEST_FUNCTION(io_admission_acquire_takes_a_free_slot)
+{
+    // arrange
+    IO_ADMISSION_STATISTICS statistics;
+    IO_ADMISSION_WAITER waiter;
+    IO_ADMISSION_HANDLE admission = io_admission_create(TEST_MAX_OUTSTANDING_COUNT);
+    ASSERT_IS_NOT_NULL(admission);
+    umock_c_reset_all_calls();
+    init_waiter(&waiter, test_context_1);
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    IO_ADMISSION_RESULT result = io_admission_acquire(admission, &waiter);
+
+    // assert
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_ADMITTED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    test_get_statistics(admission, &statistics);
+    ASSERT_ARE_EQUAL(uint32_t, 1, statistics.outstanding_count);
+    ASSERT_ARE_EQUAL(uint32_t, 1, statistics.peak_outstanding_count);
+    ASSERT_ARE_EQUAL(uint32_t, 0, statistics.queued_count);
+
+    // cleanup
+    io_admission_release(admission);
+    io_admission_destroy(admission);
+}
+
+/* Tests_SRS_IO_ADMISSION_01_014: [ Otherwise io_admission_acquire shall append waiter to the queue of its priority, increment the number of queued I/Os, update the peak number of queued I/Os and return IO_ADMISSION_QUEUED. ]*/
+TEST_FUNCTION(io_admission_acquire_when_all_slots_are_taken_queues_the_waiter)
+{
+    // arrange
+    IO_ADMISSION_STATISTICS statistics;
+    IO_ADMISSION_WAITER waiter_1;
+    IO_ADMISSION_WAITER waiter_2;
+    IO_ADMISSION_HANDLE admission = test_create_full_admission();
+    init_waiter(&waiter_1, test_context_1);
+    init_waiter(&waiter_2, test_context_2);
+
+    expect_lock();
+    expect_unlock();
+    expect_lock();
+    expect_unlock();
+
+    // act
+    IO_ADMISSION_RESULT result_1 = io_admission_acquire(admission, &waiter_1);
+    IO_ADMISSION_RESULT result_2 = io_admission_acquire(admission, &waiter_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_QUEUED, result_1);
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_QUEUED, result_2);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    test_get_statistics(admission, &statistics);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_MAX_OUTSTANDING_COUNT, statistics.outstanding_count);
+    ASSERT_ARE_EQUAL(uint32_t, 2, statistics.queued_count);
+    ASSERT_ARE_EQUAL(uint32_t, 2, statistics.peak_queued_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.busy_count);
+
+    // cleanup
+    io_admission_release(admission);
+    io_admission_release(admission);
+    io_admission_destroy(admission);
+}
+
+/* io_admission_release */
+
+/* Tests_SRS_IO_ADMISSION_01_015: [ If admission is NULL, io_admission_release shall return. ]*/
+TEST_FUNCTION(io_admission_release_with_NULL_admission_returns)
+{
+    // arrange
+
+    // act
+    io_admission_release(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_IO_ADMISSION_01_017: [ Otherwise io_admission_release shall decrement the number of outstanding I/Os. ]*/
+TEST_FUNCTION(io_admission_release_frees_the_slot)
+{
+    // arrange
+    IO_ADMISSION_STATISTICS statistics;
+    IO_ADMISSION_HANDLE admission = test_create_full_admission();
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    io_admission_release(admission);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    test_get_statistics(admission, &statistics);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_MAX_OUTSTANDING_COUNT - 1, statistics.outstanding_count);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_MAX_OUTSTANDING_COUNT, statistics.peak_outstanding_count);
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_ADMITTED, io_admission_try_acquire(admission));
+
+    // cleanup
+    io_admission_release(admission);
+    io_admission_release(admission);
+    io_admission_destroy(admission);
+}
+
+/* Tests_SRS_IO_ADMISSION_01_016: [ If an I/O is queued, io_admission_release shall remove the first waiter from the queue and decrement the number of queued I/Os, the released slot is handed to that waiter. ]*/
+/* Tests_SRS_IO_ADMISSION_01_018: [ io_admission_release shall call the on_admitted callback of the removed waiter with its on_admitted_context, without holding the lock. ]*/
+TEST_FUNCTION(io_admission_release_admits_the_first_queued_io)
+{
+    // arrange
+    IO_ADMISSION_STATISTICS statistics;
+    IO_ADMISSION_WAITER waiter_1;
+    IO_ADMISSION_WAITER waiter_2;
+    IO_ADMISSION_HANDLE admission = test_create_full_admission();
+    init_waiter(&waiter_1, test_context_1);
+    init_waiter(&waiter_2, test_context_2);
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_QUEUED, io_admission_acquire(admission, &waiter_1));
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_QUEUED, io_admission_acquire(admission, &waiter_2));
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_on_admitted(test_context_1));
+
+    // act
+    io_admission_release(admission);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    test_get_statistics(admission, &statistics);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_MAX_OUTSTANDING_COUNT, statistics.outstanding_count);
+    ASSERT_ARE_EQUAL(uint32_t, 1, statistics.queued_count);
+    ASSERT_ARE_EQUAL(uint32_t, 2, statistics.peak_queued_count);
+
+    // cleanup
+    io_admission_release(admission);
+    io_admission_destroy(admission);
+}
+
+/* Tests_SRS_IO_ADMISSION_01_016: [ If an I/O is queued, io_admission_release shall remove the first waiter from the queue and decrement the number of queued I/Os, the released slot is handed to that waiter. ]*/
+TEST_FUNCTION(io_admission_release_admits_the_queued_ios_in_order)
+{
+    // arrange
+    IO_ADMISSION_STATISTICS statistics;
+    IO_ADMISSION_WAITER waiter_1;
+    IO_ADMISSION_WAITER waiter_2;
+    IO_ADMISSION_HANDLE admission = test_create_full_admission();
+    init_waiter(&waiter_1, test_context_1);
+    init_waiter(&waiter_2, test_context_2);
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_QUEUED, io_admission_acquire(admission, &waiter_1));
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_QUEUED, io_admission_acquire(admission, &waiter_2));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_on_admitted(test_context_1));
+    STRICT_EXPECTED_CALL(test_on_admitted(test_context_2));
+
+    // act
+    io_admission_release(admission);
+    io_admission_release(admission);
+    io_admission_release(admission);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    test_get_statistics(admission, &statistics);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_MAX_OUTSTANDING_COUNT - 1, statistics.outstanding_count);
+    ASSERT_ARE_EQUAL(uint32_t, 0, statistics.queued_count);
+
+    // cleanup
+    io_admission_release(admission);
+    io_admission_destroy(admission);
+}
+
+/* Tests_SRS_IO_ADMISSION_01_014: [ Otherwise io_admission_acquire shall append waiter to the queue of its priority, increment the number of queued I/Os, update the peak number of queued I/Os and return IO_ADMISSION_QUEUED. ]*/
+/* Tests_SRS_IO_ADMISSION_01_023: [ io_admission_release shall take the first waiter of the IO_ADMISSION_PRIORITY_NORMAL queue if it is not empty and the first waiter of the IO_ADMISSION_PRIORITY_LOW queue otherwise. ]*/
+TEST_FUNCTION(io_admission_release_admits_the_normal_priority_ios_before_the_low_priority_ios)
+{
+    // arrange
+    IO_ADMISSION_STATISTICS statistics;
+    IO_ADMISSION_WAITER waiter_1;
+    IO_ADMISSION_WAITER waiter_2;
+    IO_ADMISSION_WAITER waiter_3;
+    IO_ADMISSION_HANDLE admission = test_create_full_admission();
+    init_waiter(&waiter_1, test_context_1);
+    waiter_1.priority = IO_ADMISSION_PRIORITY_LOW;
+    init_waiter(&waiter_2, test_context_2);
+    init_waiter(&waiter_3, test_context_3);
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_QUEUED, io_admission_acquire(admission, &waiter_1));
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_QUEUED, io_admission_acquire(admission, &waiter_2));
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_QUEUED, io_admission_acquire(admission, &waiter_3));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_on_admitted(test_context_2));
+    STRICT_EXPECTED_CALL(test_on_admitted(test_context_3));
+    STRICT_EXPECTED_CALL(test_on_admitted(test_context_1));
+
+    // act
+    io_admission_release(admission);
+    io_admission_release(admission);
+    io_admission_release(admission);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    test_get_statistics(admission, &statistics);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_MAX_OUTSTANDING_COUNT, statistics.outstanding_count);
+    ASSERT_ARE_EQUAL(uint32_t, 0, statistics.queued_count);
+
+    // cleanup
+    io_admission_release(admission);
+    io_admission_release(admission);
+    io_admission_destroy(admission);
+}
+
+/* Tests_SRS_IO_ADMISSION_01_023: [ io_admission_release shall take the first waiter of the IO_ADMISSION_PRIORITY_NORMAL queue if it is not empty and the first waiter of the IO_ADMISSION_PRIORITY_LOW queue otherwise. ]*/
+TEST_FUNCTION(io_admission_release_admits_the_low_priority_ios_in_order)
+{
+    // arrange
+    IO_ADMISSION_WAITER waiter_1;
+    IO_ADMISSION_WAITER waiter_2;
+    IO_ADMISSION_HANDLE admission = test_create_full_admission();
+    init_waiter(&waiter_1, test_context_1);
+    waiter_1.priority = IO_ADMISSION_PRIORITY_LOW;
+    init_waiter(&waiter_2, test_context_2);
+    waiter_2.priority = IO_ADMISSION_PRIORITY_LOW;
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_QUEUED, io_admission_acquire(admission, &waiter_1));
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_QUEUED, io_admission_acquire(admission, &waiter_2));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_on_admitted(test_context_1));
+    STRICT_EXPECTED_CALL(test_on_admitted(test_context_2));
+
+    // act
+    io_admission_release(admission);
+    io_admission_release(admission);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_admission_release(admission);
+    io_admission_release(admission);
+    io_admission_destroy(admission);
+}
+
+/* io_admission_get_statistics */
+
+/* Tests_SRS_IO_ADMISSION_01_019: [ If admission is NULL, io_admission_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(io_admission_get_statistics_with_NULL_admission_fails)
+{
+    // arrange
+    IO_ADMISSION_STATISTICS statistics;
+
+    // act
+    int result = io_admission_get_statistics(NULL, &statistics);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_IO_ADMISSION_01_020: [ If statistics is NULL, io_admission_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(io_admission_get_statistics_with_NULL_statistics_fails)
+{
+    // arrange
+    IO_ADMISSION_HANDLE admission = io_admission_create(TEST_MAX_OUTSTANDING_COUNT);
+    ASSERT_IS_NOT_NULL(admission);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = io_admission_get_statistics(admission, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_admission_destroy(admission);
+}
+
+/* Tests_SRS_IO_ADMISSION_01_021: [ io_admission_get_statistics shall fill statistics with max_outstanding_count, the current and peak numbers of outstanding and queued I/Os and the busy counter and return 0. ]*/
+TEST_FUNCTION(io_admission_get_statistics_returns_the_counters)
+{
+    // arrange
+    IO_ADMISSION_STATISTICS statistics;
+    IO_ADMISSION_WAITER waiter;
+    IO_ADMISSION_HANDLE admission = test_create_full_admission();
+    init_waiter(&waiter, test_context_1);
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_BUSY, io_admission_try_acquire(admission));
+    ASSERT_ARE_EQUAL(IO_ADMISSION_RESULT, IO_ADMISSION_QUEUED, io_admission_acquire(admission, &waiter));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(srw_lock_acquire_shared(test_srw_lock));
+    STRICT_EXPECTED_CALL(srw_lock_release_shared(test_srw_lock));
+
+    // act
+    int result = io_admission_get_statistics(admission, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, TEST_MAX_OUTSTANDING_COUNT, statistics.max_outstanding_count);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_MAX_OUTSTANDING_COUNT, statistics.outstanding_count);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_MAX_OUTSTANDING_COUNT, statistics.peak_outstanding_count);
+    ASSERT_ARE_EQUAL(uint32_t, 1, statistics.queued_count);
+    ASSERT_ARE_EQUAL(uint32_t, 1, statistics.peak_queued_count);
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.busy_count);
+
+    // cleanup
+    io_admission_release(admission);
+    io_admission_destroy(admission);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
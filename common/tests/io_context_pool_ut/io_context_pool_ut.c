@@ -0,0 +1,595 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#include "macro_utils/macro_utils.h" // IWYU pragma: keep
+
+#include "real_gballoc_ll.h"
+static void* real_malloc(size_t size)
+{
+    return real_gballoc_ll_malloc(size);
+}
+
+static void real_free(void* ptr)
+{
+    real_gballoc_ll_free(ptr);
+}
+
+// IWYU pragma: no_include <wchar.h>
+#include "testrunnerswitcher.h"
+
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umock_c_negative_tests.h"
+
+#define ENABLE_MOCKS
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#undef ENABLE_MOCKS
+
+#include "real_gballoc_hl.h"
+#include "real_interlocked.h"
+
+#include "c_pal/io_context_pool.h"
+
+#define TEST_CONTEXT_SIZE 64
+#define TEST_MAX_CACHED_COUNT 2
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static IO_CONTEXT_POOL_HANDLE test_create_pool(void)
+{
+    IO_CONTEXT_POOL_HANDLE pool = io_context_pool_create(TEST_CONTEXT_SIZE, TEST_MAX_CACHED_COUNT);
+    ASSERT_IS_NOT_NULL(pool);
+    umock_c_reset_all_calls();
+    return pool;
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init");
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+
+    REGISTER_GLOBAL_MOCK_HOOK(malloc, real_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
+    REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
+
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+    ASSERT_ARE_EQUAL(int, 0, umock_c_negative_tests_init());
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    umock_c_negative_tests_deinit();
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+/* io_context_pool_create */
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_001: [ If context_size is 0, io_context_pool_create shall fail and return NULL. ]*/
+TEST_FUNCTION(io_context_pool_create_with_context_size_0_fails)
+{
+    // arrange
+
+    // act
+    IO_CONTEXT_POOL_HANDLE pool = io_context_pool_create(0, TEST_MAX_CACHED_COUNT);
+
+    // assert
+    ASSERT_IS_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_002: [ If context_size is greater than SIZE_MAX - sizeof(IO_CONTEXT_POOL_BLOCK_HEADER), io_context_pool_create shall fail and return NULL. ]*/
+TEST_FUNCTION(io_context_pool_create_with_context_size_too_big_fails)
+{
+    // arrange
+
+    // act
+    IO_CONTEXT_POOL_HANDLE pool = io_context_pool_create(SIZE_MAX, TEST_MAX_CACHED_COUNT);
+
+    // assert
+    ASSERT_IS_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_003: [ If max_cached_count is 0, io_context_pool_create shall fail and return NULL. ]*/
+TEST_FUNCTION(io_context_pool_create_with_max_cached_count_0_fails)
+{
+    // arrange
+
+    // act
+    IO_CONTEXT_POOL_HANDLE pool = io_context_pool_create(TEST_CONTEXT_SIZE, 0);
+
+    // assert
+    ASSERT_IS_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_004: [ io_context_pool_create shall allocate memory for the pool and for max_cached_count slots. ]*/
+/* Tests_SRS_IO_CONTEXT_POOL_01_005: [ io_context_pool_create shall initialize all slots to NULL and the hit and miss counters of all slots to 0. ]*/
+TEST_FUNCTION(io_context_pool_create_succeeds)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    for (uint32_t i = 0; i < TEST_MAX_CACHED_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+        STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    }
+
+    // act
+    IO_CONTEXT_POOL_HANDLE pool = io_context_pool_create(TEST_CONTEXT_SIZE, TEST_MAX_CACHED_COUNT);
+
+    // assert
+    ASSERT_IS_NOT_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_context_pool_destroy(pool);
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_006: [ If any error occurs, io_context_pool_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_io_context_pool_create_fails)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    // act
+    IO_CONTEXT_POOL_HANDLE pool = io_context_pool_create(TEST_CONTEXT_SIZE, TEST_MAX_CACHED_COUNT);
+
+    // assert
+    ASSERT_IS_NULL(pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* io_context_pool_destroy */
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_007: [ If pool is NULL, io_context_pool_destroy shall return. ]*/
+TEST_FUNCTION(io_context_pool_destroy_with_NULL_pool_returns)
+{
+    // arrange
+
+    // act
+    io_context_pool_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_008: [ io_context_pool_destroy shall free all the cached blocks. ]*/
+/* Tests_SRS_IO_CONTEXT_POOL_01_009: [ io_context_pool_destroy shall free the memory of the pool. ]*/
+TEST_FUNCTION(io_context_pool_destroy_frees_the_cached_blocks_and_the_pool)
+{
+    // arrange
+    IO_CONTEXT_POOL_HANDLE pool = test_create_pool();
+    void* context = io_context_pool_get(pool, TEST_CONTEXT_SIZE);
+    ASSERT_IS_NOT_NULL(context);
+    io_context_pool_release(pool, context);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(free(pool));
+
+    // act
+    io_context_pool_destroy(pool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* io_context_pool_get */
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_010: [ If pool is NULL, io_context_pool_get shall fail and return NULL. ]*/
+TEST_FUNCTION(io_context_pool_get_with_NULL_pool_fails)
+{
+    // arrange
+
+    // act
+    void* context = io_context_pool_get(NULL, TEST_CONTEXT_SIZE);
+
+    // assert
+    ASSERT_IS_NULL(context);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_011: [ If size is 0, io_context_pool_get shall fail and return NULL. ]*/
+TEST_FUNCTION(io_context_pool_get_with_size_0_fails)
+{
+    // arrange
+    IO_CONTEXT_POOL_HANDLE pool = test_create_pool();
+
+    // act
+    void* context = io_context_pool_get(pool, 0);
+
+    // assert
+    ASSERT_IS_NULL(context);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_context_pool_destroy(pool);
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_012: [ If size is greater than SIZE_MAX - sizeof(IO_CONTEXT_POOL_BLOCK_HEADER), io_context_pool_get shall fail and return NULL. ]*/
+TEST_FUNCTION(io_context_pool_get_with_size_too_big_fails)
+{
+    // arrange
+    IO_CONTEXT_POOL_HANDLE pool = test_create_pool();
+
+    // act
+    void* context = io_context_pool_get(pool, SIZE_MAX);
+
+    // assert
+    ASSERT_IS_NULL(context);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_context_pool_destroy(pool);
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_013: [ If size is less than or equal to context_size, io_context_pool_get shall look at every slot once, starting at the start slot of the calling thread, and take ownership of the first cached block it finds by exchanging its slot with NULL. ]*/
+/* Tests_SRS_IO_CONTEXT_POOL_01_028: [ io_context_pool_get shall only call interlocked_exchange_pointer on slots that are not NULL when read. ]*/
+/* Tests_SRS_IO_CONTEXT_POOL_01_015: [ Otherwise io_context_pool_get shall increment the miss counter of the start slot of the calling thread. ]*/
+/* Tests_SRS_IO_CONTEXT_POOL_01_016: [ If size is less than or equal to context_size, io_context_pool_get shall allocate a block big enough for a header and context_size bytes. ]*/
+/* Tests_SRS_IO_CONTEXT_POOL_01_018: [ io_context_pool_get shall return the memory following the header. ]*/
+TEST_FUNCTION(io_context_pool_get_on_empty_pool_allocates_a_block)
+{
+    // arrange
+    IO_CONTEXT_POOL_HANDLE pool = test_create_pool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment_64(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    // act
+    void* context = io_context_pool_get(pool, 1);
+
+    // assert
+    ASSERT_IS_NOT_NULL(context);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    (void)memset(context, 0xAA, TEST_CONTEXT_SIZE);
+
+    // cleanup
+    io_context_pool_release(pool, context);
+    io_context_pool_destroy(pool);
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_013: [ If size is less than or equal to context_size, io_context_pool_get shall look at every slot once, starting at the start slot of the calling thread, and take ownership of the first cached block it finds by exchanging its slot with NULL. ]*/
+/* Tests_SRS_IO_CONTEXT_POOL_01_028: [ io_context_pool_get shall only call interlocked_exchange_pointer on slots that are not NULL when read. ]*/
+/* Tests_SRS_IO_CONTEXT_POOL_01_027: [ The start slot of a thread shall be computed from the address of a thread local variable, so that threads start looking at different slots. ]*/
+/* Tests_SRS_IO_CONTEXT_POOL_01_014: [ If a cached block was found, io_context_pool_get shall increment the hit counter of the start slot of the calling thread and return the context of the block. ]*/
+TEST_FUNCTION(io_context_pool_get_returns_a_cached_block)
+{
+    // arrange
+    IO_CONTEXT_POOL_HANDLE pool = test_create_pool();
+    void* first_context = io_context_pool_get(pool, TEST_CONTEXT_SIZE);
+    ASSERT_IS_NOT_NULL(first_context);
+    io_context_pool_release(pool, first_context);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_increment_64(IGNORED_ARG));
+
+    // act
+    void* context = io_context_pool_get(pool, TEST_CONTEXT_SIZE);
+
+    // assert
+    ASSERT_ARE_EQUAL(void_ptr, first_context, context);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_context_pool_release(pool, context);
+    io_context_pool_destroy(pool);
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_027: [ The start slot of a thread shall be computed from the address of a thread local variable, so that threads start looking at different slots. ]*/
+/* Tests_SRS_IO_CONTEXT_POOL_01_028: [ io_context_pool_get shall only call interlocked_exchange_pointer on slots that are not NULL when read. ]*/
+/* Tests_SRS_IO_CONTEXT_POOL_01_029: [ io_context_pool_release shall only call interlocked_compare_exchange_pointer on slots that are NULL when read. ]*/
+TEST_FUNCTION(io_context_pool_with_many_slots_costs_one_interlocked_operation_on_the_slots_per_get_and_release)
+{
+    // arrange
+    IO_CONTEXT_POOL_HANDLE pool = io_context_pool_create(TEST_CONTEXT_SIZE, 64);
+    ASSERT_IS_NOT_NULL(pool);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment_64(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_increment_64(IGNORED_ARG));
+
+    // act
+    void* first_context = io_context_pool_get(pool, TEST_CONTEXT_SIZE);
+    io_context_pool_release(pool, first_context);
+    void* context = io_context_pool_get(pool, TEST_CONTEXT_SIZE);
+
+    // assert
+    ASSERT_IS_NOT_NULL(first_context);
+    ASSERT_ARE_EQUAL(void_ptr, first_context, context);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_context_pool_release(pool, context);
+    io_context_pool_destroy(pool);
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_015: [ Otherwise io_context_pool_get shall increment the miss counter of the start slot of the calling thread. ]*/
+/* Tests_SRS_IO_CONTEXT_POOL_01_017: [ If size is greater than context_size, io_context_pool_get shall allocate a block big enough for a header and size bytes and mark the block as not pooled. ]*/
+TEST_FUNCTION(io_context_pool_get_with_size_bigger_than_context_size_allocates_a_block_without_looking_in_the_pool)
+{
+    // arrange
+    IO_CONTEXT_POOL_HANDLE pool = test_create_pool();
+    void* cached_context = io_context_pool_get(pool, TEST_CONTEXT_SIZE);
+    ASSERT_IS_NOT_NULL(cached_context);
+    io_context_pool_release(pool, cached_context);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment_64(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    // act
+    void* context = io_context_pool_get(pool, TEST_CONTEXT_SIZE + 1);
+
+    // assert
+    ASSERT_IS_NOT_NULL(context);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, cached_context, context);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    (void)memset(context, 0xAA, TEST_CONTEXT_SIZE + 1);
+
+    // cleanup
+    io_context_pool_release(pool, context);
+    io_context_pool_destroy(pool);
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_019: [ If any error occurs, io_context_pool_get shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_io_context_pool_get_fails)
+{
+    // arrange
+    IO_CONTEXT_POOL_HANDLE pool = test_create_pool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment_64(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    // act
+    void* context = io_context_pool_get(pool, TEST_CONTEXT_SIZE);
+
+    // assert
+    ASSERT_IS_NULL(context);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_context_pool_destroy(pool);
+}
+
+/* io_context_pool_release */
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_020: [ If pool is NULL, io_context_pool_release shall return. ]*/
+TEST_FUNCTION(io_context_pool_release_with_NULL_pool_returns)
+{
+    // arrange
+    IO_CONTEXT_POOL_HANDLE pool = test_create_pool();
+    void* context = io_context_pool_get(pool, TEST_CONTEXT_SIZE);
+    ASSERT_IS_NOT_NULL(context);
+    umock_c_reset_all_calls();
+
+    // act
+    io_context_pool_release(NULL, context);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_context_pool_release(pool, context);
+    io_context_pool_destroy(pool);
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_021: [ If context is NULL, io_context_pool_release shall return. ]*/
+TEST_FUNCTION(io_context_pool_release_with_NULL_context_returns)
+{
+    // arrange
+    IO_CONTEXT_POOL_HANDLE pool = test_create_pool();
+
+    // act
+    io_context_pool_release(pool, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_context_pool_destroy(pool);
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_022: [ If the block is pooled, io_context_pool_release shall look at every slot once, starting at the start slot of the calling thread, and store the block in the first empty slot by calling interlocked_compare_exchange_pointer. ]*/
+/* Tests_SRS_IO_CONTEXT_POOL_01_029: [ io_context_pool_release shall only call interlocked_compare_exchange_pointer on slots that are NULL when read. ]*/
+TEST_FUNCTION(io_context_pool_release_stores_the_block_in_the_first_empty_slot)
+{
+    // arrange
+    IO_CONTEXT_POOL_HANDLE pool = test_create_pool();
+    void* context_1 = io_context_pool_get(pool, TEST_CONTEXT_SIZE);
+    ASSERT_IS_NOT_NULL(context_1);
+    void* context_2 = io_context_pool_get(pool, TEST_CONTEXT_SIZE);
+    ASSERT_IS_NOT_NULL(context_2);
+    io_context_pool_release(pool, context_1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL));
+
+    // act
+    io_context_pool_release(pool, context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_context_pool_destroy(pool);
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_029: [ io_context_pool_release shall only call interlocked_compare_exchange_pointer on slots that are NULL when read. ]*/
+/* Tests_SRS_IO_CONTEXT_POOL_01_023: [ If the block is not pooled or if there is no empty slot, io_context_pool_release shall free the block. ]*/
+TEST_FUNCTION(io_context_pool_release_frees_the_block_when_all_slots_are_full)
+{
+    // arrange
+    IO_CONTEXT_POOL_HANDLE pool = test_create_pool();
+    void* context_1 = io_context_pool_get(pool, TEST_CONTEXT_SIZE);
+    ASSERT_IS_NOT_NULL(context_1);
+    void* context_2 = io_context_pool_get(pool, TEST_CONTEXT_SIZE);
+    ASSERT_IS_NOT_NULL(context_2);
+    void* context_3 = io_context_pool_get(pool, TEST_CONTEXT_SIZE);
+    ASSERT_IS_NOT_NULL(context_3);
+    io_context_pool_release(pool, context_1);
+    io_context_pool_release(pool, context_2);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    io_context_pool_release(pool, context_3);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_context_pool_destroy(pool);
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_023: [ If the block is not pooled or if there is no empty slot, io_context_pool_release shall free the block. ]*/
+TEST_FUNCTION(io_context_pool_release_frees_a_block_that_is_not_pooled)
+{
+    // arrange
+    IO_CONTEXT_POOL_HANDLE pool = test_create_pool();
+    void* context = io_context_pool_get(pool, TEST_CONTEXT_SIZE + 1);
+    ASSERT_IS_NOT_NULL(context);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    io_context_pool_release(pool, context);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_context_pool_destroy(pool);
+}
+
+/* io_context_pool_get_statistics */
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_024: [ If pool is NULL, io_context_pool_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(io_context_pool_get_statistics_with_NULL_pool_fails)
+{
+    // arrange
+    IO_CONTEXT_POOL_STATISTICS statistics;
+
+    // act
+    int result = io_context_pool_get_statistics(NULL, &statistics);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_025: [ If statistics is NULL, io_context_pool_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(io_context_pool_get_statistics_with_NULL_statistics_fails)
+{
+    // arrange
+    IO_CONTEXT_POOL_HANDLE pool = test_create_pool();
+
+    // act
+    int result = io_context_pool_get_statistics(pool, NULL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_context_pool_destroy(pool);
+}
+
+/* Tests_SRS_IO_CONTEXT_POOL_01_026: [ io_context_pool_get_statistics shall fill statistics with the sums of the hit and miss counters of all slots and return 0. ]*/
+TEST_FUNCTION(io_context_pool_get_statistics_returns_the_hit_and_miss_counts)
+{
+    // arrange
+    IO_CONTEXT_POOL_HANDLE pool = test_create_pool();
+    void* context = io_context_pool_get(pool, TEST_CONTEXT_SIZE); /*miss*/
+    ASSERT_IS_NOT_NULL(context);
+    io_context_pool_release(pool, context);
+    context = io_context_pool_get(pool, TEST_CONTEXT_SIZE); /*hit*/
+    ASSERT_IS_NOT_NULL(context);
+    io_context_pool_release(pool, context);
+    context = io_context_pool_get(pool, TEST_CONTEXT_SIZE); /*hit*/
+    ASSERT_IS_NOT_NULL(context);
+    io_context_pool_release(pool, context);
+    umock_c_reset_all_calls();
+
+    IO_CONTEXT_POOL_STATISTICS statistics;
+
+    for (uint32_t i = 0; i < TEST_MAX_CACHED_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    }
+
+    // act
+    int result = io_context_pool_get_statistics(pool, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 2, statistics.hit_count);
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.miss_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    io_context_pool_destroy(pool);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,376 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#endif
+
+#include "macro_utils/macro_utils.h" // IWYU pragma: keep
+
+// IWYU pragma: no_include <wchar.h>
+#include "testrunnerswitcher.h"
+
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes.h"
+#include "umock_c/umocktypes_stdint.h"
+
+#define ENABLE_MOCKS
+#include "c_pal/interlocked.h"
+#undef ENABLE_MOCKS
+
+#include "real_interlocked.h"
+
+#include "c_pal/latency_histogram.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static void test_init_histogram(LATENCY_HISTOGRAM* histogram)
+{
+    latency_histogram_init(histogram);
+    umock_c_reset_all_calls();
+}
+
+static void setup_latency_histogram_record_expected_calls(LATENCY_HISTOGRAM* histogram, int64_t sample_us, uint32_t bucket_index, int64_t max_us)
+{
+    STRICT_EXPECTED_CALL(interlocked_increment_64(&histogram->sample_count));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&histogram->total_us, sample_us));
+    STRICT_EXPECTED_CALL(interlocked_increment_64(&histogram->bucket_counts[bucket_index]));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&histogram->max_us, 0));
+    if (sample_us > max_us)
+    {
+        STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(&histogram->max_us, sample_us, max_us));
+    }
+}
+
+static void setup_latency_histogram_add_to_statistics_expected_calls(LATENCY_HISTOGRAM* histogram)
+{
+    STRICT_EXPECTED_CALL(interlocked_add_64(&histogram->sample_count, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&histogram->total_us, 0));
+    for (uint32_t i = 0; i < LATENCY_HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add_64(&histogram->bucket_counts[i], 0));
+    }
+    STRICT_EXPECTED_CALL(interlocked_add_64(&histogram->max_us, 0));
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init");
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+
+    REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+/* latency_histogram_init */
+
+/* Tests_SRS_LATENCY_HISTOGRAM_01_001: [ If histogram is NULL, latency_histogram_init shall return. ]*/
+TEST_FUNCTION(latency_histogram_init_with_NULL_histogram_returns)
+{
+    // arrange
+
+    // act
+    latency_histogram_init(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_LATENCY_HISTOGRAM_01_002: [ latency_histogram_init shall set the sample count, the total and maximum latency and all the bucket counts to 0. ]*/
+TEST_FUNCTION(latency_histogram_init_zeroes_all_the_counters)
+{
+    // arrange
+    LATENCY_HISTOGRAM histogram;
+    (void)memset(&histogram, 0x42, sizeof(histogram));
+
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(&histogram.sample_count, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(&histogram.total_us, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(&histogram.max_us, 0));
+    for (uint32_t i = 0; i < LATENCY_HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_exchange_64(&histogram.bucket_counts[i], 0));
+    }
+
+    // act
+    latency_histogram_init(&histogram);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 0, histogram.sample_count);
+    ASSERT_ARE_EQUAL(int64_t, 0, histogram.total_us);
+    ASSERT_ARE_EQUAL(int64_t, 0, histogram.max_us);
+    for (uint32_t i = 0; i < LATENCY_HISTOGRAM_BUCKET_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(int64_t, 0, histogram.bucket_counts[i]);
+    }
+}
+
+/* latency_histogram_record */
+
+/* Tests_SRS_LATENCY_HISTOGRAM_01_003: [ If histogram is NULL, latency_histogram_record shall return. ]*/
+TEST_FUNCTION(latency_histogram_record_with_NULL_histogram_returns)
+{
+    // arrange
+
+    // act
+    latency_histogram_record(NULL, 42);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_LATENCY_HISTOGRAM_01_005: [ latency_histogram_record shall increment the sample count and add the latency to the total latency by calling interlocked_increment_64 and interlocked_add_64. ]*/
+/* Tests_SRS_LATENCY_HISTOGRAM_01_006: [ latency_histogram_record shall increment the count of the bucket of the latency: bucket 0 for latencies under 1 microsecond, bucket i for latencies of at least 2^(i-1) and under 2^i microseconds and the last bucket for all the longer latencies. ]*/
+/* Tests_SRS_LATENCY_HISTOGRAM_01_007: [ If the latency is greater than the maximum latency, latency_histogram_record shall set the maximum latency to it by calling interlocked_compare_exchange_64 until it succeeds or the maximum latency is not smaller anymore. ]*/
+TEST_FUNCTION(latency_histogram_record_records_the_sample)
+{
+    // arrange
+    LATENCY_HISTOGRAM histogram;
+    test_init_histogram(&histogram);
+
+    setup_latency_histogram_record_expected_calls(&histogram, 100, 7, 0);
+
+    // act
+    latency_histogram_record(&histogram, 100.7);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 1, histogram.sample_count);
+    ASSERT_ARE_EQUAL(int64_t, 100, histogram.total_us);
+    ASSERT_ARE_EQUAL(int64_t, 100, histogram.max_us);
+    ASSERT_ARE_EQUAL(int64_t, 1, histogram.bucket_counts[7]);
+}
+
+/* Tests_SRS_LATENCY_HISTOGRAM_01_006: [ latency_histogram_record shall increment the count of the bucket of the latency: bucket 0 for latencies under 1 microsecond, bucket i for latencies of at least 2^(i-1) and under 2^i microseconds and the last bucket for all the longer latencies. ]*/
+TEST_FUNCTION(latency_histogram_record_puts_the_samples_in_power_of_2_buckets)
+{
+    // arrange
+    LATENCY_HISTOGRAM histogram;
+    test_init_histogram(&histogram);
+
+    // act
+    latency_histogram_record(&histogram, 0.5);
+    latency_histogram_record(&histogram, 1);
+    latency_histogram_record(&histogram, 2);
+    latency_histogram_record(&histogram, 3);
+    latency_histogram_record(&histogram, 4);
+    latency_histogram_record(&histogram, 1023);
+    latency_histogram_record(&histogram, 1024);
+
+    // assert
+    ASSERT_ARE_EQUAL(int64_t, 7, histogram.sample_count);
+    ASSERT_ARE_EQUAL(int64_t, 1, histogram.bucket_counts[0]);
+    ASSERT_ARE_EQUAL(int64_t, 1, histogram.bucket_counts[1]);
+    ASSERT_ARE_EQUAL(int64_t, 2, histogram.bucket_counts[2]);
+    ASSERT_ARE_EQUAL(int64_t, 1, histogram.bucket_counts[3]);
+    ASSERT_ARE_EQUAL(int64_t, 1, histogram.bucket_counts[10]);
+    ASSERT_ARE_EQUAL(int64_t, 1, histogram.bucket_counts[11]);
+    ASSERT_ARE_EQUAL(int64_t, 1024, histogram.max_us);
+}
+
+/* Tests_SRS_LATENCY_HISTOGRAM_01_006: [ latency_histogram_record shall increment the count of the bucket of the latency: bucket 0 for latencies under 1 microsecond, bucket i for latencies of at least 2^(i-1) and under 2^i microseconds and the last bucket for all the longer latencies. ]*/
+TEST_FUNCTION(latency_histogram_record_puts_the_longest_samples_in_the_last_bucket)
+{
+    // arrange
+    LATENCY_HISTOGRAM histogram;
+    test_init_histogram(&histogram);
+
+    setup_latency_histogram_record_expected_calls(&histogram, INT64_C(1) << 40, LATENCY_HISTOGRAM_BUCKET_COUNT - 1, 0);
+
+    // act
+    latency_histogram_record(&histogram, (double)(INT64_C(1) << 40));
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 1, histogram.bucket_counts[LATENCY_HISTOGRAM_BUCKET_COUNT - 1]);
+}
+
+/* Tests_SRS_LATENCY_HISTOGRAM_01_004: [ If latency_us is negative, latency_histogram_record shall record a latency of 0. ]*/
+TEST_FUNCTION(latency_histogram_record_with_negative_latency_records_0)
+{
+    // arrange
+    LATENCY_HISTOGRAM histogram;
+    test_init_histogram(&histogram);
+
+    setup_latency_histogram_record_expected_calls(&histogram, 0, 0, 0);
+
+    // act
+    latency_histogram_record(&histogram, -1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 1, histogram.sample_count);
+    ASSERT_ARE_EQUAL(int64_t, 0, histogram.total_us);
+    ASSERT_ARE_EQUAL(int64_t, 1, histogram.bucket_counts[0]);
+}
+
+/* Tests_SRS_LATENCY_HISTOGRAM_01_007: [ If the latency is greater than the maximum latency, latency_histogram_record shall set the maximum latency to it by calling interlocked_compare_exchange_64 until it succeeds or the maximum latency is not smaller anymore. ]*/
+TEST_FUNCTION(latency_histogram_record_with_a_smaller_latency_does_not_change_the_maximum)
+{
+    // arrange
+    LATENCY_HISTOGRAM histogram;
+    test_init_histogram(&histogram);
+    latency_histogram_record(&histogram, 50);
+    umock_c_reset_all_calls();
+
+    setup_latency_histogram_record_expected_calls(&histogram, 10, 4, 50);
+
+    // act
+    latency_histogram_record(&histogram, 10);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 2, histogram.sample_count);
+    ASSERT_ARE_EQUAL(int64_t, 60, histogram.total_us);
+    ASSERT_ARE_EQUAL(int64_t, 50, histogram.max_us);
+}
+
+/* Tests_SRS_LATENCY_HISTOGRAM_01_007: [ If the latency is greater than the maximum latency, latency_histogram_record shall set the maximum latency to it by calling interlocked_compare_exchange_64 until it succeeds or the maximum latency is not smaller anymore. ]*/
+TEST_FUNCTION(latency_histogram_record_retries_setting_the_maximum_when_it_changed_meanwhile)
+{
+    // arrange
+    LATENCY_HISTOGRAM histogram;
+    test_init_histogram(&histogram);
+
+    STRICT_EXPECTED_CALL(interlocked_increment_64(&histogram.sample_count));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&histogram.total_us, 100));
+    STRICT_EXPECTED_CALL(interlocked_increment_64(&histogram.bucket_counts[7]));
+    STRICT_EXPECTED_CALL(interlocked_add_64(&histogram.max_us, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(&histogram.max_us, 100, 0))
+        .CallCannotFail()
+        .SetReturn(20);
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(&histogram.max_us, 100, 20))
+        .SetReturn(20);
+
+    // act
+    latency_histogram_record(&histogram, 100);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* latency_histogram_add_to_statistics */
+
+/* Tests_SRS_LATENCY_HISTOGRAM_01_008: [ If histogram is NULL, latency_histogram_add_to_statistics shall return. ]*/
+TEST_FUNCTION(latency_histogram_add_to_statistics_with_NULL_histogram_returns)
+{
+    // arrange
+    LATENCY_HISTOGRAM_STATISTICS statistics;
+    (void)memset(&statistics, 0, sizeof(statistics));
+
+    // act
+    latency_histogram_add_to_statistics(NULL, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.sample_count);
+}
+
+/* Tests_SRS_LATENCY_HISTOGRAM_01_009: [ If statistics is NULL, latency_histogram_add_to_statistics shall return. ]*/
+TEST_FUNCTION(latency_histogram_add_to_statistics_with_NULL_statistics_returns)
+{
+    // arrange
+    LATENCY_HISTOGRAM histogram;
+    test_init_histogram(&histogram);
+
+    // act
+    latency_histogram_add_to_statistics(&histogram, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_LATENCY_HISTOGRAM_01_010: [ latency_histogram_add_to_statistics shall add the sample count, the total latency and the bucket counts of histogram to the ones of statistics. ]*/
+/* Tests_SRS_LATENCY_HISTOGRAM_01_011: [ If the maximum latency of histogram is greater than the one of statistics, latency_histogram_add_to_statistics shall set the maximum latency of statistics to it. ]*/
+TEST_FUNCTION(latency_histogram_add_to_statistics_merges_the_samples)
+{
+    // arrange
+    LATENCY_HISTOGRAM histogram_1;
+    LATENCY_HISTOGRAM histogram_2;
+    LATENCY_HISTOGRAM_STATISTICS statistics;
+    test_init_histogram(&histogram_1);
+    test_init_histogram(&histogram_2);
+    latency_histogram_record(&histogram_1, 3);
+    latency_histogram_record(&histogram_1, 100);
+    latency_histogram_record(&histogram_2, 2);
+    latency_histogram_record(&histogram_2, 5000);
+    umock_c_reset_all_calls();
+    (void)memset(&statistics, 0, sizeof(statistics));
+
+    setup_latency_histogram_add_to_statistics_expected_calls(&histogram_1);
+    setup_latency_histogram_add_to_statistics_expected_calls(&histogram_2);
+
+    // act
+    latency_histogram_add_to_statistics(&histogram_1, &statistics);
+    latency_histogram_add_to_statistics(&histogram_2, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 4, statistics.sample_count);
+    ASSERT_ARE_EQUAL(uint64_t, 5105, statistics.total_us);
+    ASSERT_ARE_EQUAL(uint64_t, 5000, statistics.max_us);
+    ASSERT_ARE_EQUAL(uint64_t, 2, statistics.bucket_counts[2]);
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.bucket_counts[7]);
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.bucket_counts[13]);
+}
+
+/* Tests_SRS_LATENCY_HISTOGRAM_01_011: [ If the maximum latency of histogram is greater than the one of statistics, latency_histogram_add_to_statistics shall set the maximum latency of statistics to it. ]*/
+TEST_FUNCTION(latency_histogram_add_to_statistics_keeps_the_greater_maximum)
+{
+    // arrange
+    LATENCY_HISTOGRAM histogram;
+    LATENCY_HISTOGRAM_STATISTICS statistics;
+    test_init_histogram(&histogram);
+    latency_histogram_record(&histogram, 10);
+    umock_c_reset_all_calls();
+    (void)memset(&statistics, 0, sizeof(statistics));
+    statistics.max_us = 20;
+
+    // act
+    latency_histogram_add_to_statistics(&histogram, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.sample_count);
+    ASSERT_ARE_EQUAL(uint64_t, 20, statistics.max_us);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,1347 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#else
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#include "macro_utils/macro_utils.h" // IWYU pragma: keep
+
+#include "real_gballoc_ll.h"
+static void* real_malloc(size_t size)
+{
+    return real_gballoc_ll_malloc(size);
+}
+
+static void* real_calloc(size_t nmemb, size_t size)
+{
+    return real_gballoc_ll_calloc(nmemb, size);
+}
+
+static void real_free(void* ptr)
+{
+    real_gballoc_ll_free(ptr);
+}
+
+// IWYU pragma: no_include <wchar.h>
+#include "testrunnerswitcher.h"
+
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes.h"
+#include "umock_c/umocktypes_bool.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umock_c_negative_tests.h"
+
+#define ENABLE_MOCKS
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/srw_lock.h"
+
+#include "c_pal/read_ahead.h"
+
+MOCKABLE_FUNCTION(, int, test_issue_io, void*, context, READ_AHEAD_IO*, io);
+MOCKABLE_FUNCTION(, void, test_user_callback, void*, user_context, bool, is_successful);
+#undef ENABLE_MOCKS
+
+#include "real_gballoc_hl.h"
+
+#include "c_pal/read_ahead.h"
+
+#define TEST_ALIGNMENT 16
+#define TEST_BLOCK_SIZE 64
+#define TEST_BLOCK_COUNT 4
+
+static SRW_LOCK_HANDLE test_srw_lock = (SRW_LOCK_HANDLE)0x4300;
+static void* test_context = (void*)0x4301;
+static void* test_user_context_1 = (void*)0x4302;
+static void* test_user_context_2 = (void*)0x4303;
+
+static unsigned char test_file[512];
+
+static READ_AHEAD_IO* captured_ios[16];
+static uint32_t captured_io_count;
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+TEST_DEFINE_ENUM_TYPE(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_RESULT_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static int hook_test_issue_io(void* context, READ_AHEAD_IO* io)
+{
+    (void)context;
+    if (captured_io_count < sizeof(captured_ios) / sizeof(captured_ios[0]))
+    {
+        captured_ios[captured_io_count] = io;
+    }
+    captured_io_count++;
+    return 0;
+}
+
+static void expect_lock(void)
+{
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(test_srw_lock));
+}
+
+static void expect_unlock(void)
+{
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(test_srw_lock));
+}
+
+static READ_AHEAD_HANDLE test_create_read_ahead(void)
+{
+    READ_AHEAD_HANDLE read_ahead = read_ahead_create(TEST_ALIGNMENT, TEST_BLOCK_SIZE, TEST_BLOCK_COUNT, test_issue_io, test_context);
+    ASSERT_IS_NOT_NULL(read_ahead);
+    umock_c_reset_all_calls();
+    return read_ahead;
+}
+
+static void test_read(READ_AHEAD_HANDLE read_ahead, unsigned char* destination, uint32_t size, uint64_t position, void* user_context, READ_AHEAD_READ_RESULT expected_result)
+{
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, expected_result, read_ahead_read(read_ahead, destination, size, position, test_user_callback, user_context));
+    umock_c_reset_all_calls();
+}
+
+/*simulates the owner reading the block from test_file*/
+static void test_complete_io(READ_AHEAD_HANDLE read_ahead, uint32_t io_index, uint32_t bytes_read)
+{
+    (void)memcpy(captured_ios[io_index]->buffer, test_file + captured_ios[io_index]->position, bytes_read);
+    read_ahead_io_complete(read_ahead, captured_ios[io_index], true, bytes_read);
+    umock_c_reset_all_calls();
+}
+
+static void test_fail_io(READ_AHEAD_HANDLE read_ahead, uint32_t io_index)
+{
+    read_ahead_io_complete(read_ahead, captured_ios[io_index], false, 0);
+    umock_c_reset_all_calls();
+}
+
+/*reads at 0 and completes the TEST_BLOCK_COUNT blocks that are read ahead*/
+static READ_AHEAD_HANDLE test_create_read_ahead_with_all_blocks_read(unsigned char* destination)
+{
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    test_read(read_ahead, destination, 16, 0, test_user_context_1, READ_AHEAD_READ_OK);
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        test_complete_io(read_ahead, i, TEST_BLOCK_SIZE);
+    }
+    return read_ahead;
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init");
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_bool_register_types());
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+
+    REGISTER_UMOCK_ALIAS_TYPE(READ_AHEAD_IO*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(SRW_LOCK_HANDLE, void*);
+
+    REGISTER_GLOBAL_MOCK_HOOK(malloc, real_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(calloc, real_calloc);
+    REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_hl_aligned_malloc, real_gballoc_hl_aligned_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_hl_aligned_free, real_gballoc_hl_aligned_free);
+    REGISTER_GLOBAL_MOCK_HOOK(test_issue_io, hook_test_issue_io);
+
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(calloc, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(gballoc_hl_aligned_malloc, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(srw_lock_create, test_srw_lock, NULL);
+
+    for (size_t i = 0; i < sizeof(test_file); i++)
+    {
+        test_file[i] = (unsigned char)(i + 1);
+    }
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    captured_io_count = 0;
+
+    umock_c_reset_all_calls();
+    ASSERT_ARE_EQUAL(int, 0, umock_c_negative_tests_init());
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    umock_c_negative_tests_deinit();
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+/* read_ahead_create */
+
+/* Tests_SRS_READ_AHEAD_01_001: [ If alignment is 0 or is not a power of 2, read_ahead_create shall fail and return NULL. ]*/
+TEST_FUNCTION(read_ahead_create_with_alignment_0_fails)
+{
+    // arrange
+
+    // act
+    READ_AHEAD_HANDLE read_ahead = read_ahead_create(0, TEST_BLOCK_SIZE, TEST_BLOCK_COUNT, test_issue_io, test_context);
+
+    // assert
+    ASSERT_IS_NULL(read_ahead);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_READ_AHEAD_01_001: [ If alignment is 0 or is not a power of 2, read_ahead_create shall fail and return NULL. ]*/
+TEST_FUNCTION(read_ahead_create_with_alignment_not_a_power_of_2_fails)
+{
+    // arrange
+
+    // act
+    READ_AHEAD_HANDLE read_ahead = read_ahead_create(24, 48, TEST_BLOCK_COUNT, test_issue_io, test_context);
+
+    // assert
+    ASSERT_IS_NULL(read_ahead);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_READ_AHEAD_01_002: [ If block_size is 0 or is not a multiple of alignment, read_ahead_create shall fail and return NULL. ]*/
+TEST_FUNCTION(read_ahead_create_with_block_size_0_fails)
+{
+    // arrange
+
+    // act
+    READ_AHEAD_HANDLE read_ahead = read_ahead_create(TEST_ALIGNMENT, 0, TEST_BLOCK_COUNT, test_issue_io, test_context);
+
+    // assert
+    ASSERT_IS_NULL(read_ahead);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_READ_AHEAD_01_002: [ If block_size is 0 or is not a multiple of alignment, read_ahead_create shall fail and return NULL. ]*/
+TEST_FUNCTION(read_ahead_create_with_block_size_not_a_multiple_of_alignment_fails)
+{
+    // arrange
+
+    // act
+    READ_AHEAD_HANDLE read_ahead = read_ahead_create(TEST_ALIGNMENT, TEST_BLOCK_SIZE + 1, TEST_BLOCK_COUNT, test_issue_io, test_context);
+
+    // assert
+    ASSERT_IS_NULL(read_ahead);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_READ_AHEAD_01_003: [ If block_count is 0, read_ahead_create shall fail and return NULL. ]*/
+TEST_FUNCTION(read_ahead_create_with_block_count_0_fails)
+{
+    // arrange
+
+    // act
+    READ_AHEAD_HANDLE read_ahead = read_ahead_create(TEST_ALIGNMENT, TEST_BLOCK_SIZE, 0, test_issue_io, test_context);
+
+    // assert
+    ASSERT_IS_NULL(read_ahead);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_READ_AHEAD_01_004: [ If issue_io is NULL, read_ahead_create shall fail and return NULL. ]*/
+TEST_FUNCTION(read_ahead_create_with_NULL_issue_io_fails)
+{
+    // arrange
+
+    // act
+    READ_AHEAD_HANDLE read_ahead = read_ahead_create(TEST_ALIGNMENT, TEST_BLOCK_SIZE, TEST_BLOCK_COUNT, NULL, test_context);
+
+    // assert
+    ASSERT_IS_NULL(read_ahead);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_READ_AHEAD_01_005: [ read_ahead_create shall allocate memory for the read-ahead and for block_count blocks. ]*/
+/* Tests_SRS_READ_AHEAD_01_006: [ read_ahead_create shall allocate a buffer of block_size bytes aligned to alignment for each block by calling gballoc_hl_aligned_malloc. ]*/
+/* Tests_SRS_READ_AHEAD_01_051: [ read_ahead_create shall create the lock by calling srw_lock_create. ]*/
+/* Tests_SRS_READ_AHEAD_01_007: [ read_ahead_create shall set the mode to READ_AHEAD_MODE_AUTO, start with all the blocks free and the end of the last read at 0 and return the read-ahead. ]*/
+TEST_FUNCTION(read_ahead_create_succeeds)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(calloc(TEST_BLOCK_COUNT, IGNORED_ARG));
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(gballoc_hl_aligned_malloc(TEST_ALIGNMENT, TEST_BLOCK_SIZE));
+    }
+    STRICT_EXPECTED_CALL(srw_lock_create(false, IGNORED_ARG));
+
+    // act
+    READ_AHEAD_HANDLE read_ahead = read_ahead_create(TEST_ALIGNMENT, TEST_BLOCK_SIZE, TEST_BLOCK_COUNT, test_issue_io, test_context);
+
+    // assert
+    ASSERT_IS_NOT_NULL(read_ahead);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_008: [ If any error occurs, read_ahead_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_read_ahead_create_also_fails)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(calloc(TEST_BLOCK_COUNT, IGNORED_ARG));
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(gballoc_hl_aligned_malloc(TEST_ALIGNMENT, TEST_BLOCK_SIZE));
+    }
+    STRICT_EXPECTED_CALL(srw_lock_create(false, IGNORED_ARG));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            READ_AHEAD_HANDLE read_ahead = read_ahead_create(TEST_ALIGNMENT, TEST_BLOCK_SIZE, TEST_BLOCK_COUNT, test_issue_io, test_context);
+
+            // assert
+            ASSERT_IS_NULL(read_ahead, "On failed call %zu", i);
+        }
+    }
+}
+
+/* read_ahead_destroy */
+
+/* Tests_SRS_READ_AHEAD_01_009: [ If read_ahead is NULL, read_ahead_destroy shall return. ]*/
+TEST_FUNCTION(read_ahead_destroy_with_NULL_read_ahead_returns)
+{
+    // arrange
+
+    // act
+    read_ahead_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_READ_AHEAD_01_010: [ read_ahead_destroy shall destroy the lock and free the buffers of all the blocks, the cached waiters and the memory of the read-ahead. ]*/
+TEST_FUNCTION(read_ahead_destroy_frees_the_memory)
+{
+    // arrange
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+
+    STRICT_EXPECTED_CALL(srw_lock_destroy(test_srw_lock));
+
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(gballoc_hl_aligned_free(IGNORED_ARG));
+    }
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(read_ahead));
+
+    // act
+    read_ahead_destroy(read_ahead);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_READ_AHEAD_01_010: [ read_ahead_destroy shall destroy the lock and free the buffers of all the blocks, the cached waiters and the memory of the read-ahead. ]*/
+TEST_FUNCTION(read_ahead_destroy_frees_the_cached_waiters)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead_with_all_blocks_read(destination);
+
+    STRICT_EXPECTED_CALL(srw_lock_destroy(test_srw_lock));
+
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(gballoc_hl_aligned_free(IGNORED_ARG));
+    }
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(read_ahead));
+
+    // act
+    read_ahead_destroy(read_ahead);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* read_ahead_set_mode */
+
+/* Tests_SRS_READ_AHEAD_01_011: [ If read_ahead is NULL, read_ahead_set_mode shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(read_ahead_set_mode_with_NULL_read_ahead_fails)
+{
+    // arrange
+
+    // act
+    int result = read_ahead_set_mode(NULL, READ_AHEAD_MODE_SEQUENTIAL);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_READ_AHEAD_01_012: [ If mode is not a valid READ_AHEAD_MODE value, read_ahead_set_mode shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(read_ahead_set_mode_with_invalid_mode_fails)
+{
+    // arrange
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+
+    // act
+    int result = read_ahead_set_mode(read_ahead, (READ_AHEAD_MODE)0x42);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_013: [ read_ahead_set_mode shall set the mode of the read-ahead and return 0. ]*/
+TEST_FUNCTION(read_ahead_set_mode_succeeds)
+{
+    // arrange
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    int result = read_ahead_set_mode(read_ahead, READ_AHEAD_MODE_OFF);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* read_ahead_read */
+
+/* Tests_SRS_READ_AHEAD_01_014: [ If read_ahead is NULL, read_ahead_read shall fail and return READ_AHEAD_READ_ERROR. ]*/
+TEST_FUNCTION(read_ahead_read_with_NULL_read_ahead_fails)
+{
+    // arrange
+    unsigned char destination[16];
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(NULL, destination, sizeof(destination), 0, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_READ_AHEAD_01_015: [ If destination is NULL, read_ahead_read shall fail and return READ_AHEAD_READ_ERROR. ]*/
+TEST_FUNCTION(read_ahead_read_with_NULL_destination_fails)
+{
+    // arrange
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, NULL, 16, 0, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_016: [ If size is 0, read_ahead_read shall fail and return READ_AHEAD_READ_ERROR. ]*/
+TEST_FUNCTION(read_ahead_read_with_size_0_fails)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, 0, 0, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_017: [ If position + size is greater than or equal to UINT64_MAX, read_ahead_read shall fail and return READ_AHEAD_READ_ERROR. ]*/
+TEST_FUNCTION(read_ahead_read_with_position_plus_size_UINT64_MAX_fails)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), UINT64_MAX - sizeof(destination), test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_018: [ If user_callback is NULL, read_ahead_read shall fail and return READ_AHEAD_READ_ERROR. ]*/
+TEST_FUNCTION(read_ahead_read_with_NULL_user_callback_fails)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), 0, NULL, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_021: [ If the read does not fit in one block, read_ahead_read shall return READ_AHEAD_READ_NOT_HANDLED. ]*/
+TEST_FUNCTION(read_ahead_read_that_crosses_a_block_boundary_is_not_handled)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), TEST_BLOCK_SIZE - 8, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_NOT_HANDLED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_007: [ read_ahead_create shall set the mode to READ_AHEAD_MODE_AUTO, start with all the blocks free and the end of the last read at 0 and return the read-ahead. ]*/
+/* Tests_SRS_READ_AHEAD_01_019: [ A read is sequential if the mode is READ_AHEAD_MODE_SEQUENTIAL, or if the mode is READ_AHEAD_MODE_AUTO and position is where the previous read ended. ]*/
+/* Tests_SRS_READ_AHEAD_01_026: [ Otherwise read_ahead_read shall take a free block or a block that was read outside of the block_count blocks starting at the block holding the read, add the read to the reads waiting for it, start reading it and return READ_AHEAD_READ_OK. ]*/
+/* Tests_SRS_READ_AHEAD_01_028: [ If the read is sequential, read_ahead_read shall start reading the blocks that follow the block holding the read, up to block_count blocks in total and not past the known end of the file, that are not cached yet and for which a block can be taken. ]*/
+/* Tests_SRS_READ_AHEAD_01_030: [ After releasing the lock, read_ahead_read shall read all the blocks it started, in the order they were started. ]*/
+/* Tests_SRS_READ_AHEAD_01_040: [ A block is read by calling issue_io with context and the READ_AHEAD_IO of the block. ]*/
+TEST_FUNCTION(read_ahead_read_at_the_start_of_the_file_reads_the_block_and_the_next_ones)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    expect_unlock();
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+    }
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), 0, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, TEST_BLOCK_COUNT, captured_io_count);
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(uint64_t, (uint64_t)i * TEST_BLOCK_SIZE, captured_ios[i]->position);
+        ASSERT_ARE_EQUAL(uint32_t, TEST_BLOCK_SIZE, captured_ios[i]->size);
+        ASSERT_IS_NOT_NULL(captured_ios[i]->buffer);
+    }
+
+    // cleanup
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        test_complete_io(read_ahead, i, TEST_BLOCK_SIZE);
+    }
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_020: [ read_ahead_read shall record position + size as the end of the last read. ]*/
+/* Tests_SRS_READ_AHEAD_01_025: [ If the block holding the read is not cached and the read is not sequential or the block starts after the known end of the file, read_ahead_read shall return READ_AHEAD_READ_NOT_HANDLED. ]*/
+TEST_FUNCTION(read_ahead_read_of_a_block_not_cached_that_is_not_sequential_is_not_handled)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    test_read(read_ahead, destination, sizeof(destination), 2 * TEST_BLOCK_SIZE, test_user_context_1, READ_AHEAD_READ_NOT_HANDLED);
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), TEST_BLOCK_SIZE, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_NOT_HANDLED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, captured_io_count);
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_020: [ read_ahead_read shall record position + size as the end of the last read. ]*/
+/* Tests_SRS_READ_AHEAD_01_019: [ A read is sequential if the mode is READ_AHEAD_MODE_SEQUENTIAL, or if the mode is READ_AHEAD_MODE_AUTO and position is where the previous read ended. ]*/
+TEST_FUNCTION(read_ahead_read_that_continues_the_previous_read_is_sequential)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    test_read(read_ahead, destination, sizeof(destination), 2 * TEST_BLOCK_SIZE - sizeof(destination), test_user_context_1, READ_AHEAD_READ_NOT_HANDLED);
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    expect_unlock();
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+    }
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), 2 * TEST_BLOCK_SIZE, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 2 * TEST_BLOCK_SIZE, captured_ios[0]->position);
+    ASSERT_ARE_EQUAL(uint64_t, 5 * TEST_BLOCK_SIZE, captured_ios[3]->position);
+
+    // cleanup
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        test_complete_io(read_ahead, i, TEST_BLOCK_SIZE);
+    }
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_019: [ A read is sequential if the mode is READ_AHEAD_MODE_SEQUENTIAL, or if the mode is READ_AHEAD_MODE_AUTO and position is where the previous read ended. ]*/
+TEST_FUNCTION(read_ahead_read_in_sequential_mode_reads_ahead_at_any_position)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    ASSERT_ARE_EQUAL(int, 0, read_ahead_set_mode(read_ahead, READ_AHEAD_MODE_SEQUENTIAL));
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    expect_unlock();
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+    }
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), 3 * TEST_BLOCK_SIZE + 8, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 3 * TEST_BLOCK_SIZE, captured_ios[0]->position);
+
+    // cleanup
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        test_complete_io(read_ahead, i, TEST_BLOCK_SIZE);
+    }
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_019: [ A read is sequential if the mode is READ_AHEAD_MODE_SEQUENTIAL, or if the mode is READ_AHEAD_MODE_AUTO and position is where the previous read ended. ]*/
+/* Tests_SRS_READ_AHEAD_01_025: [ If the block holding the read is not cached and the read is not sequential or the block starts after the known end of the file, read_ahead_read shall return READ_AHEAD_READ_NOT_HANDLED. ]*/
+TEST_FUNCTION(read_ahead_read_in_off_mode_does_not_read_ahead)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    ASSERT_ARE_EQUAL(int, 0, read_ahead_set_mode(read_ahead, READ_AHEAD_MODE_OFF));
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), 0, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_NOT_HANDLED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, captured_io_count);
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_024: [ If the block holding the read is being read, read_ahead_read shall add the read to the reads waiting for the block and return READ_AHEAD_READ_OK. ]*/
+TEST_FUNCTION(read_ahead_read_of_a_block_being_read_waits_for_it)
+{
+    // arrange
+    unsigned char destination_1[16];
+    unsigned char destination_2[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    test_read(read_ahead, destination_1, sizeof(destination_1), 0, test_user_context_1, READ_AHEAD_READ_OK);
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    expect_unlock();
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination_2, sizeof(destination_2), 16, test_user_callback, test_user_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, TEST_BLOCK_COUNT, captured_io_count);
+
+    // cleanup
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        test_complete_io(read_ahead, i, TEST_BLOCK_SIZE);
+    }
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_022: [ If the block holding the read was read, read_ahead_read shall pin the block, copy the data to destination once the lock is released, unpin the block and return READ_AHEAD_READ_COPIED without calling user_callback. ]*/
+TEST_FUNCTION(read_ahead_read_of_a_block_that_was_read_copies_the_data)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead_with_all_blocks_read(destination);
+
+    expect_lock();
+    expect_unlock();
+    expect_lock();
+    expect_unlock();
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), 16, test_user_callback, test_user_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_COPIED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_file + 16, destination, sizeof(destination)));
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_023: [ If the block holding the read was read but is too short to contain it, read_ahead_read shall return READ_AHEAD_READ_NOT_HANDLED. ]*/
+TEST_FUNCTION(read_ahead_read_past_the_data_of_a_short_block_is_not_handled)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    test_read(read_ahead, destination, sizeof(destination), 0, test_user_context_1, READ_AHEAD_READ_OK);
+    test_complete_io(read_ahead, 0, 20);
+    for (uint32_t i = 1; i < TEST_BLOCK_COUNT; i++)
+    {
+        test_complete_io(read_ahead, i, 0);
+    }
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), 16, test_user_callback, test_user_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_NOT_HANDLED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_025: [ If the block holding the read is not cached and the read is not sequential or the block starts after the known end of the file, read_ahead_read shall return READ_AHEAD_READ_NOT_HANDLED. ]*/
+/* Tests_SRS_READ_AHEAD_01_046: [ If bytes_read is less than the block size, read_ahead_io_complete shall record the end of the data as the known end of the file. ]*/
+TEST_FUNCTION(read_ahead_read_past_the_known_end_of_the_file_is_not_handled)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    ASSERT_ARE_EQUAL(int, 0, read_ahead_set_mode(read_ahead, READ_AHEAD_MODE_SEQUENTIAL));
+    test_read(read_ahead, destination, sizeof(destination), 0, test_user_context_1, READ_AHEAD_READ_OK);
+    test_complete_io(read_ahead, 0, 30);
+    for (uint32_t i = 1; i < TEST_BLOCK_COUNT; i++)
+    {
+        test_fail_io(read_ahead, i);
+    }
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), TEST_BLOCK_SIZE, test_user_callback, test_user_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_NOT_HANDLED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, TEST_BLOCK_COUNT, captured_io_count);
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_027: [ If no block can be taken, read_ahead_read shall return READ_AHEAD_READ_NOT_HANDLED. ]*/
+TEST_FUNCTION(read_ahead_read_when_all_the_blocks_are_being_read_is_not_handled)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    ASSERT_ARE_EQUAL(int, 0, read_ahead_set_mode(read_ahead, READ_AHEAD_MODE_SEQUENTIAL));
+    test_read(read_ahead, destination, sizeof(destination), 0, test_user_context_1, READ_AHEAD_READ_OK);
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), 6 * TEST_BLOCK_SIZE, test_user_callback, test_user_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_NOT_HANDLED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, TEST_BLOCK_COUNT, captured_io_count);
+
+    // cleanup
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        test_complete_io(read_ahead, i, TEST_BLOCK_SIZE);
+    }
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_026: [ Otherwise read_ahead_read shall take a free block or a block that was read outside of the block_count blocks starting at the block holding the read, add the read to the reads waiting for it, start reading it and return READ_AHEAD_READ_OK. ]*/
+/* Tests_SRS_READ_AHEAD_01_028: [ If the read is sequential, read_ahead_read shall start reading the blocks that follow the block holding the read, up to block_count blocks in total and not past the known end of the file, that are not cached yet and for which a block can be taken. ]*/
+TEST_FUNCTION(read_ahead_read_reuses_the_blocks_behind_the_reader)
+{
+    // arrange
+    unsigned char destination[16];
+    unsigned char first_read[48];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead_with_all_blocks_read(destination);
+    test_read(read_ahead, first_read, sizeof(first_read), 16, test_user_context_1, READ_AHEAD_READ_COPIED);
+
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+    expect_lock();
+    expect_unlock();
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), TEST_BLOCK_SIZE, test_user_callback, test_user_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_COPIED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_file + TEST_BLOCK_SIZE, destination, sizeof(destination)));
+    ASSERT_ARE_EQUAL(uint32_t, TEST_BLOCK_COUNT + 1, captured_io_count);
+    ASSERT_ARE_EQUAL(void_ptr, captured_ios[0], captured_ios[TEST_BLOCK_COUNT]);
+    ASSERT_ARE_EQUAL(uint64_t, TEST_BLOCK_COUNT * TEST_BLOCK_SIZE, captured_ios[TEST_BLOCK_COUNT]->position);
+
+    // cleanup
+    test_complete_io(read_ahead, TEST_BLOCK_COUNT, TEST_BLOCK_SIZE);
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_041: [ If issue_io fails, the block shall be freed and the user callbacks of the reads waiting for it shall be called with is_successful set to false. ]*/
+TEST_FUNCTION(when_issue_io_fails_read_ahead_read_calls_the_user_callback_with_false)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, false));
+    expect_lock();
+    expect_unlock();
+    for (uint32_t i = 1; i < TEST_BLOCK_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+    }
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), 0, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, TEST_BLOCK_COUNT - 1, captured_io_count);
+
+    // cleanup
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT - 1; i++)
+    {
+        test_complete_io(read_ahead, i, TEST_BLOCK_SIZE);
+    }
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_029: [ If any error occurs, read_ahead_read shall fail and return READ_AHEAD_READ_ERROR. ]*/
+TEST_FUNCTION(when_malloc_fails_read_ahead_read_fails)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+    expect_unlock();
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), 0, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, captured_io_count);
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_029: [ If any error occurs, read_ahead_read shall fail and return READ_AHEAD_READ_ERROR. ]*/
+TEST_FUNCTION(when_malloc_fails_read_ahead_read_of_a_block_being_read_fails)
+{
+    // arrange
+    unsigned char destination_1[16];
+    unsigned char destination_2[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    test_read(read_ahead, destination_1, sizeof(destination_1), 0, test_user_context_1, READ_AHEAD_READ_OK);
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+    expect_unlock();
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination_2, sizeof(destination_2), 16, test_user_callback, test_user_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        test_complete_io(read_ahead, i, TEST_BLOCK_SIZE);
+    }
+    read_ahead_destroy(read_ahead);
+}
+
+/* read_ahead_will_need */
+
+/* Tests_SRS_READ_AHEAD_01_031: [ If read_ahead is NULL, read_ahead_will_need shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(read_ahead_will_need_with_NULL_read_ahead_fails)
+{
+    // arrange
+
+    // act
+    int result = read_ahead_will_need(NULL, 0, TEST_BLOCK_SIZE);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_READ_AHEAD_01_032: [ If size is 0, read_ahead_will_need shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(read_ahead_will_need_with_size_0_fails)
+{
+    // arrange
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+
+    // act
+    int result = read_ahead_will_need(read_ahead, 0, 0);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_033: [ If position + size is greater than or equal to UINT64_MAX, read_ahead_will_need shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(read_ahead_will_need_with_position_plus_size_UINT64_MAX_fails)
+{
+    // arrange
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+
+    // act
+    int result = read_ahead_will_need(read_ahead, UINT64_MAX - TEST_BLOCK_SIZE, TEST_BLOCK_SIZE);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_034: [ read_ahead_will_need shall start reading the blocks holding the range, up to block_count blocks, that are not cached yet and for which a block can be taken. ]*/
+/* Tests_SRS_READ_AHEAD_01_035: [ After releasing the lock, read_ahead_will_need shall read all the blocks it started, in the order they were started, and return 0. ]*/
+TEST_FUNCTION(read_ahead_will_need_reads_the_blocks_holding_the_range)
+{
+    // arrange
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+
+    // act
+    int result = read_ahead_will_need(read_ahead, TEST_BLOCK_SIZE + 36, TEST_BLOCK_SIZE);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, captured_io_count);
+    ASSERT_ARE_EQUAL(uint64_t, TEST_BLOCK_SIZE, captured_ios[0]->position);
+    ASSERT_ARE_EQUAL(uint64_t, 2 * TEST_BLOCK_SIZE, captured_ios[1]->position);
+
+    // cleanup
+    test_complete_io(read_ahead, 0, TEST_BLOCK_SIZE);
+    test_complete_io(read_ahead, 1, TEST_BLOCK_SIZE);
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_034: [ read_ahead_will_need shall start reading the blocks holding the range, up to block_count blocks, that are not cached yet and for which a block can be taken. ]*/
+TEST_FUNCTION(read_ahead_will_need_skips_the_blocks_already_cached)
+{
+    // arrange
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    ASSERT_ARE_EQUAL(int, 0, read_ahead_will_need(read_ahead, 0, TEST_BLOCK_SIZE));
+    test_complete_io(read_ahead, 0, TEST_BLOCK_SIZE);
+
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+
+    // act
+    int result = read_ahead_will_need(read_ahead, 0, 2 * TEST_BLOCK_SIZE);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, captured_io_count);
+    ASSERT_ARE_EQUAL(uint64_t, TEST_BLOCK_SIZE, captured_ios[1]->position);
+
+    // cleanup
+    test_complete_io(read_ahead, 1, TEST_BLOCK_SIZE);
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_034: [ read_ahead_will_need shall start reading the blocks holding the range, up to block_count blocks, that are not cached yet and for which a block can be taken. ]*/
+TEST_FUNCTION(read_ahead_will_need_in_off_mode_makes_reads_hit)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    ASSERT_ARE_EQUAL(int, 0, read_ahead_set_mode(read_ahead, READ_AHEAD_MODE_OFF));
+    ASSERT_ARE_EQUAL(int, 0, read_ahead_will_need(read_ahead, 3 * TEST_BLOCK_SIZE, 10 * TEST_BLOCK_SIZE));
+    ASSERT_ARE_EQUAL(uint32_t, TEST_BLOCK_COUNT, captured_io_count);
+    for (uint32_t i = 0; i < TEST_BLOCK_COUNT; i++)
+    {
+        test_complete_io(read_ahead, i, TEST_BLOCK_SIZE);
+    }
+
+    // act
+    READ_AHEAD_READ_RESULT result = read_ahead_read(read_ahead, destination, sizeof(destination), 5 * TEST_BLOCK_SIZE, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_COPIED, result);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_file + 5 * TEST_BLOCK_SIZE, destination, sizeof(destination)));
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* read_ahead_invalidate */
+
+/* Tests_SRS_READ_AHEAD_01_036: [ If read_ahead is NULL, read_ahead_invalidate shall return. ]*/
+TEST_FUNCTION(read_ahead_invalidate_with_NULL_read_ahead_returns)
+{
+    // arrange
+
+    // act
+    read_ahead_invalidate(NULL, 0, TEST_BLOCK_SIZE);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_READ_AHEAD_01_037: [ read_ahead_invalidate shall mark all the blocks that overlap the range as not valid, so that reads do not find them anymore. ]*/
+/* Tests_SRS_READ_AHEAD_01_038: [ read_ahead_invalidate shall free the blocks that overlap the range, were read and are not pinned. ]*/
+TEST_FUNCTION(read_ahead_invalidate_makes_the_next_read_read_the_block_again)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead_with_all_blocks_read(destination);
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    read_ahead_invalidate(read_ahead, 20, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    test_read(read_ahead, destination, sizeof(destination), 16, test_user_context_2, READ_AHEAD_READ_OK);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_BLOCK_COUNT + 1, captured_io_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, captured_ios[TEST_BLOCK_COUNT]->position);
+
+    // cleanup
+    test_complete_io(read_ahead, TEST_BLOCK_COUNT, TEST_BLOCK_SIZE);
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_037: [ read_ahead_invalidate shall mark all the blocks that overlap the range as not valid, so that reads do not find them anymore. ]*/
+/* Tests_SRS_READ_AHEAD_01_049: [ read_ahead_io_complete shall unpin the block and free it if a write overlapped it in the meantime. ]*/
+TEST_FUNCTION(read_ahead_invalidate_of_a_block_being_read_frees_it_once_read)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    test_read(read_ahead, destination, sizeof(destination), 0, test_user_context_1, READ_AHEAD_READ_OK);
+
+    // act
+    read_ahead_invalidate(read_ahead, 0, 1);
+
+    // assert
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, true));
+    (void)memcpy(captured_ios[0]->buffer, test_file, TEST_BLOCK_SIZE);
+    read_ahead_io_complete(read_ahead, captured_ios[0], true, TEST_BLOCK_SIZE);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_file, destination, sizeof(destination)));
+    for (uint32_t i = 1; i < TEST_BLOCK_COUNT; i++)
+    {
+        test_complete_io(read_ahead, i, TEST_BLOCK_SIZE);
+    }
+    test_read(read_ahead, destination, sizeof(destination), 16, test_user_context_2, READ_AHEAD_READ_OK);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_BLOCK_COUNT + 1, captured_io_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, captured_ios[TEST_BLOCK_COUNT]->position);
+
+    // cleanup
+    test_complete_io(read_ahead, TEST_BLOCK_COUNT, TEST_BLOCK_SIZE);
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_039: [ read_ahead_invalidate shall forget the known end of the file, since the write can extend the file. ]*/
+TEST_FUNCTION(read_ahead_invalidate_forgets_the_known_end_of_the_file)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    ASSERT_ARE_EQUAL(int, 0, read_ahead_set_mode(read_ahead, READ_AHEAD_MODE_SEQUENTIAL));
+    test_read(read_ahead, destination, sizeof(destination), 0, test_user_context_1, READ_AHEAD_READ_OK);
+    test_complete_io(read_ahead, 0, 30);
+    for (uint32_t i = 1; i < TEST_BLOCK_COUNT; i++)
+    {
+        test_fail_io(read_ahead, i);
+    }
+
+    // act
+    read_ahead_invalidate(read_ahead, 30, 2 * TEST_BLOCK_SIZE);
+
+    // assert
+    test_read(read_ahead, destination, sizeof(destination), TEST_BLOCK_SIZE, test_user_context_2, READ_AHEAD_READ_OK);
+    ASSERT_ARE_EQUAL(uint64_t, TEST_BLOCK_SIZE, captured_ios[TEST_BLOCK_COUNT]->position);
+
+    // cleanup
+    for (uint32_t i = TEST_BLOCK_COUNT; i < captured_io_count; i++)
+    {
+        test_complete_io(read_ahead, i, TEST_BLOCK_SIZE);
+    }
+    read_ahead_destroy(read_ahead);
+}
+
+/* read_ahead_io_complete */
+
+/* Tests_SRS_READ_AHEAD_01_042: [ If read_ahead is NULL, read_ahead_io_complete shall return. ]*/
+TEST_FUNCTION(read_ahead_io_complete_with_NULL_read_ahead_returns)
+{
+    // arrange
+    READ_AHEAD_IO io = { 0 };
+
+    // act
+    read_ahead_io_complete(NULL, &io, true, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_READ_AHEAD_01_043: [ If io is NULL, read_ahead_io_complete shall return. ]*/
+TEST_FUNCTION(read_ahead_io_complete_with_NULL_io_returns)
+{
+    // arrange
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+
+    // act
+    read_ahead_io_complete(read_ahead, NULL, true, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_044: [ read_ahead_io_complete shall take the reads waiting for the block. ]*/
+/* Tests_SRS_READ_AHEAD_01_045: [ If is_successful is true, read_ahead_io_complete shall mark the block as read with bytes_read bytes of data and pin it. ]*/
+/* Tests_SRS_READ_AHEAD_01_048: [ read_ahead_io_complete shall copy the data of the block to every waiting read that the data covers. ]*/
+/* Tests_SRS_READ_AHEAD_01_049: [ read_ahead_io_complete shall unpin the block and free it if a write overlapped it in the meantime. ]*/
+/* Tests_SRS_READ_AHEAD_01_050: [ read_ahead_io_complete shall call the user callbacks of the waiting reads, in the order they were added, with is_successful set to true if and only if the data covers the read. ]*/
+TEST_FUNCTION(read_ahead_io_complete_copies_the_data_to_the_waiting_reads)
+{
+    // arrange
+    unsigned char destination_1[16];
+    unsigned char destination_2[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    test_read(read_ahead, destination_1, sizeof(destination_1), 0, test_user_context_1, READ_AHEAD_READ_OK);
+    test_read(read_ahead, destination_2, sizeof(destination_2), 16, test_user_context_2, READ_AHEAD_READ_OK);
+    (void)memcpy(captured_ios[0]->buffer, test_file, TEST_BLOCK_SIZE);
+
+    expect_lock();
+    expect_unlock();
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, true));
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_2, true));
+    expect_lock();
+    expect_unlock();
+
+    // act
+    read_ahead_io_complete(read_ahead, captured_ios[0], true, TEST_BLOCK_SIZE);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_file, destination_1, sizeof(destination_1)));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_file + 16, destination_2, sizeof(destination_2)));
+
+    // cleanup
+    for (uint32_t i = 1; i < TEST_BLOCK_COUNT; i++)
+    {
+        test_complete_io(read_ahead, i, TEST_BLOCK_SIZE);
+    }
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_050: [ read_ahead_io_complete shall call the user callbacks of the waiting reads, in the order they were added, with is_successful set to true if and only if the data covers the read. ]*/
+TEST_FUNCTION(read_ahead_io_complete_with_a_short_read_fails_the_reads_past_the_data)
+{
+    // arrange
+    unsigned char destination_1[16];
+    unsigned char destination_2[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    test_read(read_ahead, destination_1, sizeof(destination_1), 0, test_user_context_1, READ_AHEAD_READ_OK);
+    test_read(read_ahead, destination_2, sizeof(destination_2), 16, test_user_context_2, READ_AHEAD_READ_OK);
+    (void)memcpy(captured_ios[0]->buffer, test_file, 20);
+
+    expect_lock();
+    expect_unlock();
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, true));
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_2, false));
+    expect_lock();
+    expect_unlock();
+
+    // act
+    read_ahead_io_complete(read_ahead, captured_ios[0], true, 20);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, memcmp(test_file, destination_1, sizeof(destination_1)));
+
+    // cleanup
+    for (uint32_t i = 1; i < TEST_BLOCK_COUNT; i++)
+    {
+        test_complete_io(read_ahead, i, 0);
+    }
+    read_ahead_destroy(read_ahead);
+}
+
+/* Tests_SRS_READ_AHEAD_01_047: [ If is_successful is false, read_ahead_io_complete shall free the block. ]*/
+/* Tests_SRS_READ_AHEAD_01_050: [ read_ahead_io_complete shall call the user callbacks of the waiting reads, in the order they were added, with is_successful set to true if and only if the data covers the read. ]*/
+TEST_FUNCTION(read_ahead_io_complete_with_is_successful_false_fails_the_waiting_reads)
+{
+    // arrange
+    unsigned char destination[16];
+    READ_AHEAD_HANDLE read_ahead = test_create_read_ahead();
+    test_read(read_ahead, destination, sizeof(destination), 0, test_user_context_1, READ_AHEAD_READ_OK);
+
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, false));
+    expect_lock();
+    expect_unlock();
+
+    // act
+    read_ahead_io_complete(read_ahead, captured_ios[0], false, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // the block was freed, so the next read reads it again
+    test_read(read_ahead, destination, sizeof(destination), 16, test_user_context_2, READ_AHEAD_READ_OK);
+    ASSERT_ARE_EQUAL(uint64_t, 0, captured_ios[TEST_BLOCK_COUNT]->position);
+
+    // cleanup
+    for (uint32_t i = 1; i <= TEST_BLOCK_COUNT; i++)
+    {
+        test_complete_io(read_ahead, i, TEST_BLOCK_SIZE);
+    }
+    read_ahead_destroy(read_ahead);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,586 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#else
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#endif
+
+#include "macro_utils/macro_utils.h" // IWYU pragma: keep
+
+#include "real_gballoc_ll.h"
+static void* real_malloc(size_t size)
+{
+    return real_gballoc_ll_malloc(size);
+}
+
+static void real_free(void* ptr)
+{
+    real_gballoc_ll_free(ptr);
+}
+
+// IWYU pragma: no_include <wchar.h>
+#include "testrunnerswitcher.h"
+
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umock_c_negative_tests.h"
+
+#define ENABLE_MOCKS
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sync.h"
+#include "c_pal/threadpool.h"
+
+MOCKABLE_FUNCTION(, void, test_work_function, void*, context);
+#undef ENABLE_MOCKS
+
+#include "real_gballoc_hl.h"
+#include "real_interlocked.h"
+
+#include "c_pal/threadpool_serial_queue.h"
+
+#define TEST_MAX_BATCH_SIZE 2
+
+static THREADPOOL_HANDLE test_threadpool = (THREADPOOL_HANDLE)0x4501;
+static THREADPOOL_WORK_ITEM_HANDLE test_drain_work_item = (THREADPOOL_WORK_ITEM_HANDLE)0x4502;
+
+static void* test_context_1 = (void*)0x4511;
+static void* test_context_2 = (void*)0x4512;
+static void* test_context_3 = (void*)0x4513;
+
+static THREADPOOL_WORK_FUNCTION captured_drain_function;
+static void* captured_drain_context;
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static THREADPOOL_WORK_ITEM_HANDLE hook_threadpool_create_work_item(THREADPOOL_HANDLE threadpool, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+{
+    (void)threadpool;
+    captured_drain_function = work_function;
+    captured_drain_context = work_function_context;
+    return test_drain_work_item;
+}
+
+/*runs the drain that the serial queue scheduled on the threadpool*/
+static void run_drain(void)
+{
+    captured_drain_function(captured_drain_context);
+}
+
+/*the drain is the only thing that brings the number of pending work items back to 0, so it is run from the wait of threadpool_serial_queue_destroy*/
+static bool hook_wait_on_address(volatile_atomic int32_t* address, int32_t compare_value, uint32_t timeout_ms)
+{
+    (void)address;
+    (void)compare_value;
+    (void)timeout_ms;
+    run_drain();
+    return true;
+}
+
+static THREADPOOL_SERIAL_QUEUE_HANDLE test_create_serial_queue(uint32_t max_batch_size)
+{
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = threadpool_serial_queue_create(test_threadpool, max_batch_size);
+    ASSERT_IS_NOT_NULL(serial_queue);
+    umock_c_reset_all_calls();
+    return serial_queue;
+}
+
+static void test_schedule_work(THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue, void* context)
+{
+    ASSERT_ARE_EQUAL(int, 0, threadpool_serial_queue_schedule_work(serial_queue, test_work_function, context));
+    umock_c_reset_all_calls();
+}
+
+static void setup_execute_work_item_expected_calls(void* context)
+{
+    STRICT_EXPECTED_CALL(test_work_function(context));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init");
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+
+    REGISTER_GLOBAL_MOCK_HOOK(malloc, real_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
+    REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_HOOK(threadpool_create_work_item, hook_threadpool_create_work_item);
+    REGISTER_GLOBAL_MOCK_HOOK(wait_on_address, hook_wait_on_address);
+
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(threadpool_create_work_item, NULL);
+
+    REGISTER_UMOCK_ALIAS_TYPE(THREADPOOL_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(THREADPOOL_WORK_ITEM_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(THREADPOOL_WORK_FUNCTION, void*);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    captured_drain_function = NULL;
+    captured_drain_context = NULL;
+
+    umock_c_reset_all_calls();
+    ASSERT_ARE_EQUAL(int, 0, umock_c_negative_tests_init());
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    umock_c_negative_tests_deinit();
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+/* threadpool_serial_queue_create */
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_001: [ If threadpool is NULL, threadpool_serial_queue_create shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_serial_queue_create_with_NULL_threadpool_fails)
+{
+    // arrange
+
+    // act
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = threadpool_serial_queue_create(NULL, TEST_MAX_BATCH_SIZE);
+
+    // assert
+    ASSERT_IS_NULL(serial_queue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_002: [ threadpool_serial_queue_create shall allocate memory for the serial queue. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_003: [ threadpool_serial_queue_create shall create the work item that drains the serial queue by calling threadpool_create_work_item with threadpool_serial_queue_drain. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_004: [ threadpool_serial_queue_create shall set the number of pending work items to 0, empty the queue and succeed. ]*/
+TEST_FUNCTION(threadpool_serial_queue_create_succeeds)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(threadpool_create_work_item(test_threadpool, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+
+    // act
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = threadpool_serial_queue_create(test_threadpool, TEST_MAX_BATCH_SIZE);
+
+    // assert
+    ASSERT_IS_NOT_NULL(serial_queue);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_drain_function);
+    ASSERT_ARE_EQUAL(void_ptr, serial_queue, captured_drain_context);
+
+    // cleanup
+    threadpool_serial_queue_destroy(serial_queue);
+}
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_005: [ If any error occurs, threadpool_serial_queue_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_serial_queue_create_also_fails)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(threadpool_create_work_item(test_threadpool, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL))
+        .CallCannotFail();
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = threadpool_serial_queue_create(test_threadpool, TEST_MAX_BATCH_SIZE);
+
+            // assert
+            ASSERT_IS_NULL(serial_queue, "On failed call %zu", i);
+        }
+    }
+}
+
+/* threadpool_serial_queue_destroy */
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_006: [ If serial_queue is NULL, threadpool_serial_queue_destroy shall return. ]*/
+TEST_FUNCTION(threadpool_serial_queue_destroy_with_NULL_serial_queue_returns)
+{
+    // arrange
+
+    // act
+    threadpool_serial_queue_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_007: [ threadpool_serial_queue_destroy shall wait with wait_on_address until the number of pending work items is 0. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_008: [ threadpool_serial_queue_destroy shall destroy the drain work item by calling threadpool_destroy_work_item. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_009: [ threadpool_serial_queue_destroy shall free the memory of the serial queue. ]*/
+TEST_FUNCTION(threadpool_serial_queue_destroy_with_no_pending_work_frees_the_serial_queue)
+{
+    // arrange
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = test_create_serial_queue(TEST_MAX_BATCH_SIZE);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(threadpool_destroy_work_item(test_threadpool, test_drain_work_item));
+    STRICT_EXPECTED_CALL(free(serial_queue));
+
+    // act
+    threadpool_serial_queue_destroy(serial_queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_007: [ threadpool_serial_queue_destroy shall wait with wait_on_address until the number of pending work items is 0. ]*/
+TEST_FUNCTION(threadpool_serial_queue_destroy_waits_for_the_pending_work_items)
+{
+    // arrange
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = test_create_serial_queue(TEST_MAX_BATCH_SIZE);
+    test_schedule_work(serial_queue, test_context_1);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 1, UINT32_MAX));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    setup_execute_work_item_expected_calls(test_context_1);
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, -1));
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(threadpool_destroy_work_item(test_threadpool, test_drain_work_item));
+    STRICT_EXPECTED_CALL(free(serial_queue));
+
+    // act
+    threadpool_serial_queue_destroy(serial_queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* threadpool_serial_queue_schedule_work */
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_010: [ If serial_queue is NULL, threadpool_serial_queue_schedule_work shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_serial_queue_schedule_work_with_NULL_serial_queue_fails)
+{
+    // arrange
+
+    // act
+    int result = threadpool_serial_queue_schedule_work(NULL, test_work_function, test_context_1);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_011: [ If work_function is NULL, threadpool_serial_queue_schedule_work shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_serial_queue_schedule_work_with_NULL_work_function_fails)
+{
+    // arrange
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = test_create_serial_queue(TEST_MAX_BATCH_SIZE);
+
+    // act
+    int result = threadpool_serial_queue_schedule_work(serial_queue, NULL, test_context_1);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_serial_queue_destroy(serial_queue);
+}
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_012: [ threadpool_serial_queue_schedule_work shall allocate memory for the work item. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_023: [ threadpool_serial_queue_schedule_work shall increment the number of pending work items before pushing the work item, so that the drain cannot execute a work item that is not counted. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_024: [ threadpool_serial_queue_schedule_work shall push the work item to the serial queue with interlocked_compare_exchange_pointer. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_025: [ If the number of pending work items was 0, threadpool_serial_queue_schedule_work shall schedule the drain work item by calling threadpool_schedule_work_item. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_027: [ threadpool_serial_queue_schedule_work shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_serial_queue_schedule_work_on_an_empty_serial_queue_schedules_the_drain)
+{
+    // arrange
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = test_create_serial_queue(TEST_MAX_BATCH_SIZE);
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(threadpool_schedule_work_item(test_threadpool, test_drain_work_item));
+
+    // act
+    int result = threadpool_serial_queue_schedule_work(serial_queue, test_work_function, test_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    run_drain();
+    threadpool_serial_queue_destroy(serial_queue);
+}
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_024: [ threadpool_serial_queue_schedule_work shall push the work item to the serial queue with interlocked_compare_exchange_pointer. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_027: [ threadpool_serial_queue_schedule_work shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_serial_queue_schedule_work_on_a_non_empty_serial_queue_does_not_schedule_the_drain)
+{
+    // arrange
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = test_create_serial_queue(TEST_MAX_BATCH_SIZE);
+    test_schedule_work(serial_queue, test_context_1);
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    // act
+    int result = threadpool_serial_queue_schedule_work(serial_queue, test_work_function, test_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    run_drain();
+    threadpool_serial_queue_destroy(serial_queue);
+}
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_013: [ If any error occurs, threadpool_serial_queue_schedule_work shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_malloc_fails_threadpool_serial_queue_schedule_work_also_fails)
+{
+    // arrange
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = test_create_serial_queue(TEST_MAX_BATCH_SIZE);
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    // act
+    int result = threadpool_serial_queue_schedule_work(serial_queue, test_work_function, test_context_1);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_serial_queue_destroy(serial_queue);
+}
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_026: [ If threadpool_schedule_work_item fails, threadpool_serial_queue_schedule_work shall drain the serial queue on the calling thread. ]*/
+TEST_FUNCTION(when_threadpool_schedule_work_item_fails_threadpool_serial_queue_schedule_work_executes_the_work_item_on_the_calling_thread)
+{
+    // arrange
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = test_create_serial_queue(TEST_MAX_BATCH_SIZE);
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(threadpool_schedule_work_item(test_threadpool, test_drain_work_item))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    setup_execute_work_item_expected_calls(test_context_1);
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, -1));
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+
+    // act
+    int result = threadpool_serial_queue_schedule_work(serial_queue, test_work_function, test_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_serial_queue_destroy(serial_queue);
+}
+
+/* threadpool_serial_queue_drain */
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_014: [ If context is NULL, threadpool_serial_queue_drain shall return. ]*/
+TEST_FUNCTION(threadpool_serial_queue_drain_with_NULL_context_returns)
+{
+    // arrange
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = test_create_serial_queue(TEST_MAX_BATCH_SIZE);
+
+    // act
+    captured_drain_function(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_serial_queue_destroy(serial_queue);
+}
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_015: [ When it has no work item left, threadpool_serial_queue_drain shall take all the scheduled work items with interlocked_exchange_pointer and reverse them to obtain them in the order they were scheduled. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_018: [ threadpool_serial_queue_drain shall call the work_function of each work item with its work_function_context and free the memory of the work item. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_017: [ threadpool_serial_queue_drain shall stop when no work item is left. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_019: [ threadpool_serial_queue_drain shall subtract the number of executed work items from the number of pending work items. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_020: [ If no work item is pending, threadpool_serial_queue_drain shall wake up threadpool_serial_queue_destroy by calling wake_by_address_all and return. ]*/
+TEST_FUNCTION(threadpool_serial_queue_drain_executes_the_work_items_in_the_order_they_were_scheduled)
+{
+    // arrange
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = test_create_serial_queue(0);
+    test_schedule_work(serial_queue, test_context_1);
+    test_schedule_work(serial_queue, test_context_2);
+    test_schedule_work(serial_queue, test_context_3);
+
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    setup_execute_work_item_expected_calls(test_context_1);
+    setup_execute_work_item_expected_calls(test_context_2);
+    setup_execute_work_item_expected_calls(test_context_3);
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, -3));
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+
+    // act
+    run_drain();
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_serial_queue_destroy(serial_queue);
+}
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_025: [ If the number of pending work items was 0, threadpool_serial_queue_schedule_work shall schedule the drain work item by calling threadpool_schedule_work_item. ]*/
+TEST_FUNCTION(threadpool_serial_queue_schedule_work_after_the_drain_emptied_the_serial_queue_schedules_the_drain_again)
+{
+    // arrange
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = test_create_serial_queue(TEST_MAX_BATCH_SIZE);
+    test_schedule_work(serial_queue, test_context_1);
+    run_drain();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(threadpool_schedule_work_item(test_threadpool, test_drain_work_item));
+
+    // act
+    int result = threadpool_serial_queue_schedule_work(serial_queue, test_work_function, test_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    run_drain();
+    threadpool_serial_queue_destroy(serial_queue);
+}
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_016: [ threadpool_serial_queue_drain shall stop after executing max_batch_size work items if max_batch_size is not 0. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_019: [ threadpool_serial_queue_drain shall subtract the number of executed work items from the number of pending work items. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_021: [ Otherwise threadpool_serial_queue_drain shall reschedule itself by calling threadpool_schedule_work_item and return, giving the threadpool thread back. ]*/
+TEST_FUNCTION(threadpool_serial_queue_drain_reschedules_itself_after_max_batch_size_work_items)
+{
+    // arrange
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = test_create_serial_queue(TEST_MAX_BATCH_SIZE);
+    test_schedule_work(serial_queue, test_context_1);
+    test_schedule_work(serial_queue, test_context_2);
+    test_schedule_work(serial_queue, test_context_3);
+
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    setup_execute_work_item_expected_calls(test_context_1);
+    setup_execute_work_item_expected_calls(test_context_2);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, -2));
+    STRICT_EXPECTED_CALL(threadpool_schedule_work_item(test_threadpool, test_drain_work_item));
+
+    // act
+    run_drain();
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    run_drain();
+    threadpool_serial_queue_destroy(serial_queue);
+}
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_018: [ threadpool_serial_queue_drain shall call the work_function of each work item with its work_function_context and free the memory of the work item. ]*/
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_020: [ If no work item is pending, threadpool_serial_queue_drain shall wake up threadpool_serial_queue_destroy by calling wake_by_address_all and return. ]*/
+TEST_FUNCTION(threadpool_serial_queue_drain_rescheduled_executes_the_rest_of_the_batch)
+{
+    // arrange
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = test_create_serial_queue(TEST_MAX_BATCH_SIZE);
+    test_schedule_work(serial_queue, test_context_1);
+    test_schedule_work(serial_queue, test_context_2);
+    test_schedule_work(serial_queue, test_context_3);
+    run_drain();
+    umock_c_reset_all_calls();
+
+    setup_execute_work_item_expected_calls(test_context_3);
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, -1));
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+
+    // act
+    run_drain();
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_serial_queue_destroy(serial_queue);
+}
+
+/* Tests_SRS_THREADPOOL_SERIAL_QUEUE_01_022: [ If threadpool_schedule_work_item fails, threadpool_serial_queue_drain shall keep executing the pending work items on the current thread. ]*/
+TEST_FUNCTION(when_threadpool_schedule_work_item_fails_threadpool_serial_queue_drain_keeps_executing_the_work_items)
+{
+    // arrange
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = test_create_serial_queue(1);
+    test_schedule_work(serial_queue, test_context_1);
+    test_schedule_work(serial_queue, test_context_2);
+
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    setup_execute_work_item_expected_calls(test_context_1);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, -1));
+    STRICT_EXPECTED_CALL(threadpool_schedule_work_item(test_threadpool, test_drain_work_item))
+        .SetReturn(MU_FAILURE);
+    setup_execute_work_item_expected_calls(test_context_2);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, -1));
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+
+    // act
+    run_drain();
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_serial_queue_destroy(serial_queue);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
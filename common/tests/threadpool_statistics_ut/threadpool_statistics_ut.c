@@ -0,0 +1,696 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#include "macro_utils/macro_utils.h" // IWYU pragma: keep
+
+#include "real_gballoc_ll.h"
+static void* real_malloc(size_t size)
+{
+    return real_gballoc_ll_malloc(size);
+}
+
+static void real_free(void* ptr)
+{
+    real_gballoc_ll_free(ptr);
+}
+
+// IWYU pragma: no_include <wchar.h>
+#include "testrunnerswitcher.h"
+
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes.h"
+#include "umock_c/umocktypes_stdint.h"
+
+#define ENABLE_MOCKS
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sysinfo.h"
+#include "c_pal/timer.h"
+#include "c_pal/latency_histogram.h"
+#undef ENABLE_MOCKS
+
+#include "real_gballoc_hl.h"
+#include "real_interlocked.h"
+
+#include "c_pal/threadpool.h"
+
+#include "c_pal/threadpool_statistics.h"
+
+#define TEST_PROCESSOR_COUNT 2
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static THREADPOOL_STATISTICS_RECORDER_HANDLE test_create_recorder(void)
+{
+    THREADPOOL_STATISTICS_RECORDER_HANDLE recorder = threadpool_statistics_recorder_create();
+    ASSERT_IS_NOT_NULL(recorder);
+    umock_c_reset_all_calls();
+    return recorder;
+}
+
+static void test_init_timer_lateness(THREADPOOL_TIMER_LATENESS* timer_lateness, double now_us, uint32_t start_delay_ms, uint32_t period_ms)
+{
+    threadpool_timer_lateness_init(timer_lateness);
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(now_us);
+    threadpool_timer_lateness_set_due_time(timer_lateness, start_delay_ms, period_ms);
+    umock_c_reset_all_calls();
+}
+
+static void setup_threadpool_statistics_recorder_create_expected_calls(uint32_t shard_count)
+{
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    for (uint32_t i = 0; i < shard_count; i++)
+    {
+        STRICT_EXPECTED_CALL(latency_histogram_init(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(latency_histogram_init(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    }
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init");
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+
+    REGISTER_GLOBAL_MOCK_HOOK(malloc, real_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
+    REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
+
+    REGISTER_GLOBAL_MOCK_RETURN(sysinfo_get_processor_count, TEST_PROCESSOR_COUNT);
+    REGISTER_GLOBAL_MOCK_RETURN(sysinfo_get_current_processor, 0);
+    REGISTER_GLOBAL_MOCK_RETURN(timer_global_get_elapsed_us, 0);
+
+    REGISTER_UMOCK_ALIAS_TYPE(THREADPOOL_STATISTICS_RECORDER_HANDLE, void*);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+/* threadpool_statistics_recorder_create */
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_001: [ threadpool_statistics_recorder_create shall obtain the number of processors by calling sysinfo_get_processor_count. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_003: [ threadpool_statistics_recorder_create shall allocate a recorder with a set of counters for each processor. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_004: [ threadpool_statistics_recorder_create shall initialize the queue depth, the peak queue depth and all the counters to 0. ]*/
+TEST_FUNCTION(threadpool_statistics_recorder_create_succeeds)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(sysinfo_get_processor_count());
+    setup_threadpool_statistics_recorder_create_expected_calls(TEST_PROCESSOR_COUNT);
+
+    // act
+    THREADPOOL_STATISTICS_RECORDER_HANDLE recorder = threadpool_statistics_recorder_create();
+
+    // assert
+    ASSERT_IS_NOT_NULL(recorder);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_statistics_recorder_destroy(recorder);
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_002: [ If sysinfo_get_processor_count returns 0, threadpool_statistics_recorder_create shall use 1 set of counters. ]*/
+TEST_FUNCTION(threadpool_statistics_recorder_create_with_0_processors_uses_1_set_of_counters)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(sysinfo_get_processor_count())
+        .SetReturn(0);
+    setup_threadpool_statistics_recorder_create_expected_calls(1);
+
+    // act
+    THREADPOOL_STATISTICS_RECORDER_HANDLE recorder = threadpool_statistics_recorder_create();
+
+    // assert
+    ASSERT_IS_NOT_NULL(recorder);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_statistics_recorder_destroy(recorder);
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_005: [ If any error occurs, threadpool_statistics_recorder_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_threadpool_statistics_recorder_create_fails)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(sysinfo_get_processor_count());
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    // act
+    THREADPOOL_STATISTICS_RECORDER_HANDLE recorder = threadpool_statistics_recorder_create();
+
+    // assert
+    ASSERT_IS_NULL(recorder);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* threadpool_statistics_recorder_destroy */
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_006: [ If recorder is NULL, threadpool_statistics_recorder_destroy shall return. ]*/
+TEST_FUNCTION(threadpool_statistics_recorder_destroy_with_NULL_recorder_returns)
+{
+    // arrange
+
+    // act
+    threadpool_statistics_recorder_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_007: [ threadpool_statistics_recorder_destroy shall free the recorder. ]*/
+TEST_FUNCTION(threadpool_statistics_recorder_destroy_frees_the_recorder)
+{
+    // arrange
+    THREADPOOL_STATISTICS_RECORDER_HANDLE recorder = test_create_recorder();
+
+    STRICT_EXPECTED_CALL(free(recorder));
+
+    // act
+    threadpool_statistics_recorder_destroy(recorder);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* threadpool_statistics_recorder_on_queued */
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_008: [ If recorder is NULL, threadpool_statistics_recorder_on_queued shall return. ]*/
+TEST_FUNCTION(threadpool_statistics_recorder_on_queued_with_NULL_recorder_returns)
+{
+    // arrange
+
+    // act
+    threadpool_statistics_recorder_on_queued(NULL, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_009: [ threadpool_statistics_recorder_on_queued shall add work_item_count to the queue depth by calling interlocked_add_64. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_010: [ If the new queue depth is greater than the peak queue depth, threadpool_statistics_recorder_on_queued shall set the peak queue depth to it by calling interlocked_compare_exchange_64 until it succeeds or the peak is not smaller anymore. ]*/
+TEST_FUNCTION(threadpool_statistics_recorder_on_queued_adds_to_the_queue_depth_and_updates_the_peak)
+{
+    // arrange
+    THREADPOOL_STATISTICS_RECORDER_HANDLE recorder = test_create_recorder();
+    THREADPOOL_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 3));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 3, 0));
+
+    // act
+    threadpool_statistics_recorder_on_queued(recorder, 3);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    threadpool_statistics_recorder_get(recorder, &statistics);
+    ASSERT_ARE_EQUAL(uint32_t, 3, statistics.queue_depth);
+    ASSERT_ARE_EQUAL(uint32_t, 3, statistics.peak_queue_depth);
+
+    // cleanup
+    threadpool_statistics_recorder_destroy(recorder);
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_010: [ If the new queue depth is greater than the peak queue depth, threadpool_statistics_recorder_on_queued shall set the peak queue depth to it by calling interlocked_compare_exchange_64 until it succeeds or the peak is not smaller anymore. ]*/
+TEST_FUNCTION(threadpool_statistics_recorder_on_queued_below_the_peak_does_not_change_the_peak)
+{
+    // arrange
+    THREADPOOL_STATISTICS_RECORDER_HANDLE recorder = test_create_recorder();
+    THREADPOOL_STATISTICS statistics;
+    threadpool_statistics_recorder_on_queued(recorder, 3);
+    (void)threadpool_statistics_recorder_on_started(recorder, 0);
+    (void)threadpool_statistics_recorder_on_started(recorder, 0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    // act
+    threadpool_statistics_recorder_on_queued(recorder, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    threadpool_statistics_recorder_get(recorder, &statistics);
+    ASSERT_ARE_EQUAL(uint32_t, 2, statistics.queue_depth);
+    ASSERT_ARE_EQUAL(uint32_t, 3, statistics.peak_queue_depth);
+
+    // cleanup
+    threadpool_statistics_recorder_destroy(recorder);
+}
+
+/* threadpool_statistics_recorder_on_started */
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_011: [ If recorder is NULL, threadpool_statistics_recorder_on_started shall return 0. ]*/
+TEST_FUNCTION(threadpool_statistics_recorder_on_started_with_NULL_recorder_returns_0)
+{
+    // arrange
+
+    // act
+    double start_time_us = threadpool_statistics_recorder_on_started(NULL, 100);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(double, 0, start_time_us);
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_012: [ threadpool_statistics_recorder_on_started shall obtain the current time by calling timer_global_get_elapsed_us. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_013: [ threadpool_statistics_recorder_on_started shall pick the counters of the current processor, obtained by calling sysinfo_get_current_processor. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_014: [ threadpool_statistics_recorder_on_started shall record the time elapsed since schedule_time_us in the queue wait histogram of the processor by calling latency_histogram_record. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_015: [ threadpool_statistics_recorder_on_started shall increment the count of started work items of the processor and decrement the queue depth. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_016: [ threadpool_statistics_recorder_on_started shall return the current time. ]*/
+TEST_FUNCTION(threadpool_statistics_recorder_on_started_records_the_queue_wait)
+{
+    // arrange
+    THREADPOOL_STATISTICS_RECORDER_HANDLE recorder = test_create_recorder();
+    THREADPOOL_STATISTICS statistics;
+    threadpool_statistics_recorder_on_queued(recorder, 1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(150);
+    STRICT_EXPECTED_CALL(sysinfo_get_current_processor())
+        .SetReturn(3);
+    STRICT_EXPECTED_CALL(latency_histogram_record(IGNORED_ARG, 50));
+    STRICT_EXPECTED_CALL(interlocked_increment_64(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement_64(IGNORED_ARG));
+
+    // act
+    double start_time_us = threadpool_statistics_recorder_on_started(recorder, 100);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(double, 150, start_time_us);
+    threadpool_statistics_recorder_get(recorder, &statistics);
+    ASSERT_ARE_EQUAL(uint32_t, 0, statistics.queue_depth);
+    ASSERT_ARE_EQUAL(uint32_t, 1, statistics.active_worker_count);
+
+    // cleanup
+    threadpool_statistics_recorder_destroy(recorder);
+}
+
+/* threadpool_statistics_recorder_on_completed */
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_017: [ If recorder is NULL, threadpool_statistics_recorder_on_completed shall return 0. ]*/
+TEST_FUNCTION(threadpool_statistics_recorder_on_completed_with_NULL_recorder_returns_0)
+{
+    // arrange
+
+    // act
+    double end_time_us = threadpool_statistics_recorder_on_completed(NULL, 100);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(double, 0, end_time_us);
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_018: [ threadpool_statistics_recorder_on_completed shall obtain the current time by calling timer_global_get_elapsed_us. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_019: [ threadpool_statistics_recorder_on_completed shall pick the counters of the current processor, obtained by calling sysinfo_get_current_processor. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_020: [ threadpool_statistics_recorder_on_completed shall record the time elapsed since start_time_us in the run time histogram of the processor by calling latency_histogram_record. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_021: [ threadpool_statistics_recorder_on_completed shall increment the count of completed work items of the processor. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_022: [ threadpool_statistics_recorder_on_completed shall return the current time. ]*/
+TEST_FUNCTION(threadpool_statistics_recorder_on_completed_records_the_run_time)
+{
+    // arrange
+    THREADPOOL_STATISTICS_RECORDER_HANDLE recorder = test_create_recorder();
+    THREADPOOL_STATISTICS statistics;
+    threadpool_statistics_recorder_on_queued(recorder, 1);
+    (void)threadpool_statistics_recorder_on_started(recorder, 0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1150);
+    /*the thread moved to another processor while executing the work item*/
+    STRICT_EXPECTED_CALL(sysinfo_get_current_processor())
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(latency_histogram_record(IGNORED_ARG, 1000));
+    STRICT_EXPECTED_CALL(interlocked_increment_64(IGNORED_ARG));
+
+    // act
+    double end_time_us = threadpool_statistics_recorder_on_completed(recorder, 150);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(double, 1150, end_time_us);
+    threadpool_statistics_recorder_get(recorder, &statistics);
+    ASSERT_ARE_EQUAL(uint32_t, 0, statistics.active_worker_count);
+
+    // cleanup
+    threadpool_statistics_recorder_destroy(recorder);
+}
+
+/* threadpool_statistics_recorder_get */
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_023: [ If recorder is NULL, threadpool_statistics_recorder_get shall return. ]*/
+TEST_FUNCTION(threadpool_statistics_recorder_get_with_NULL_recorder_returns)
+{
+    // arrange
+    THREADPOOL_STATISTICS statistics;
+
+    // act
+    threadpool_statistics_recorder_get(NULL, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_024: [ If statistics is NULL, threadpool_statistics_recorder_get shall return. ]*/
+TEST_FUNCTION(threadpool_statistics_recorder_get_with_NULL_statistics_returns)
+{
+    // arrange
+    THREADPOOL_STATISTICS_RECORDER_HANDLE recorder = test_create_recorder();
+
+    // act
+    threadpool_statistics_recorder_get(recorder, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_statistics_recorder_destroy(recorder);
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_025: [ threadpool_statistics_recorder_get shall merge the queue wait and run time histograms of all the processors by calling latency_histogram_add_to_statistics. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_026: [ threadpool_statistics_recorder_get shall set the queue depth and the peak queue depth, counting a negative queue depth as 0. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_027: [ threadpool_statistics_recorder_get shall set the active worker count to the number of started work items minus the number of completed work items of all the processors. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_028: [ threadpool_statistics_recorder_get shall set the idle worker count to 0. ]*/
+TEST_FUNCTION(threadpool_statistics_recorder_get_merges_the_counters_of_all_the_processors)
+{
+    // arrange
+    THREADPOOL_STATISTICS_RECORDER_HANDLE recorder = test_create_recorder();
+    THREADPOOL_STATISTICS statistics;
+    threadpool_statistics_recorder_on_queued(recorder, 4);
+    STRICT_EXPECTED_CALL(sysinfo_get_current_processor())
+        .SetReturn(0);
+    (void)threadpool_statistics_recorder_on_started(recorder, 0);
+    STRICT_EXPECTED_CALL(sysinfo_get_current_processor())
+        .SetReturn(1);
+    (void)threadpool_statistics_recorder_on_started(recorder, 0);
+    STRICT_EXPECTED_CALL(sysinfo_get_current_processor())
+        .SetReturn(1);
+    (void)threadpool_statistics_recorder_on_started(recorder, 0);
+    STRICT_EXPECTED_CALL(sysinfo_get_current_processor())
+        .SetReturn(0);
+    (void)threadpool_statistics_recorder_on_completed(recorder, 0);
+    umock_c_reset_all_calls();
+    (void)memset(&statistics, 0x42, sizeof(statistics));
+
+    for (uint32_t i = 0; i < TEST_PROCESSOR_COUNT; i++)
+    {
+        STRICT_EXPECTED_CALL(latency_histogram_add_to_statistics(IGNORED_ARG, &statistics.queue_wait));
+        STRICT_EXPECTED_CALL(latency_histogram_add_to_statistics(IGNORED_ARG, &statistics.run_time));
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    }
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    // act
+    threadpool_statistics_recorder_get(recorder, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.queue_wait.sample_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.run_time.sample_count);
+    ASSERT_ARE_EQUAL(uint32_t, 1, statistics.queue_depth);
+    ASSERT_ARE_EQUAL(uint32_t, 4, statistics.peak_queue_depth);
+    ASSERT_ARE_EQUAL(uint32_t, 2, statistics.active_worker_count);
+    ASSERT_ARE_EQUAL(uint32_t, 0, statistics.idle_worker_count);
+
+    // cleanup
+    threadpool_statistics_recorder_destroy(recorder);
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_026: [ threadpool_statistics_recorder_get shall set the queue depth and the peak queue depth, counting a negative queue depth as 0. ]*/
+TEST_FUNCTION(threadpool_statistics_recorder_get_counts_a_negative_queue_depth_as_0)
+{
+    // arrange
+    THREADPOOL_STATISTICS_RECORDER_HANDLE recorder = test_create_recorder();
+    THREADPOOL_STATISTICS statistics;
+    /*the work item started before the thread that queued it accounted for it*/
+    (void)threadpool_statistics_recorder_on_started(recorder, 0);
+    umock_c_reset_all_calls();
+
+    // act
+    threadpool_statistics_recorder_get(recorder, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(uint32_t, 0, statistics.queue_depth);
+    ASSERT_ARE_EQUAL(uint32_t, 0, statistics.peak_queue_depth);
+    ASSERT_ARE_EQUAL(uint32_t, 1, statistics.active_worker_count);
+
+    // cleanup
+    threadpool_statistics_recorder_destroy(recorder);
+}
+
+/* threadpool_timer_lateness_init */
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_029: [ If timer_lateness is NULL, threadpool_timer_lateness_init shall return. ]*/
+TEST_FUNCTION(threadpool_timer_lateness_init_with_NULL_timer_lateness_returns)
+{
+    // arrange
+
+    // act
+    threadpool_timer_lateness_init(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_030: [ threadpool_timer_lateness_init shall set the due time and the period to 0 and initialize the lateness histogram by calling latency_histogram_init. ]*/
+TEST_FUNCTION(threadpool_timer_lateness_init_initializes_the_timer_lateness)
+{
+    // arrange
+    THREADPOOL_TIMER_LATENESS timer_lateness;
+    (void)memset(&timer_lateness, 0x42, sizeof(timer_lateness));
+
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(&timer_lateness.due_time_us, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(&timer_lateness.period_ms, 0));
+    STRICT_EXPECTED_CALL(latency_histogram_init(&timer_lateness.lateness));
+
+    // act
+    threadpool_timer_lateness_init(&timer_lateness);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 0, timer_lateness.due_time_us);
+    ASSERT_ARE_EQUAL(int32_t, 0, timer_lateness.period_ms);
+}
+
+/* threadpool_timer_lateness_set_due_time */
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_031: [ If timer_lateness is NULL, threadpool_timer_lateness_set_due_time shall return. ]*/
+TEST_FUNCTION(threadpool_timer_lateness_set_due_time_with_NULL_timer_lateness_returns)
+{
+    // arrange
+
+    // act
+    threadpool_timer_lateness_set_due_time(NULL, 42, 2000);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_032: [ threadpool_timer_lateness_set_due_time shall set the due time to the current time, obtained by calling timer_global_get_elapsed_us, plus start_delay_ms. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_033: [ threadpool_timer_lateness_set_due_time shall save period_ms. ]*/
+TEST_FUNCTION(threadpool_timer_lateness_set_due_time_sets_the_due_time_and_the_period)
+{
+    // arrange
+    THREADPOOL_TIMER_LATENESS timer_lateness;
+    threadpool_timer_lateness_init(&timer_lateness);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1000);
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(&timer_lateness.due_time_us, 43000));
+    STRICT_EXPECTED_CALL(interlocked_exchange(&timer_lateness.period_ms, 2000));
+
+    // act
+    threadpool_timer_lateness_set_due_time(&timer_lateness, 42, 2000);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 43000, timer_lateness.due_time_us);
+    ASSERT_ARE_EQUAL(int32_t, 2000, timer_lateness.period_ms);
+}
+
+/* threadpool_timer_lateness_on_fired */
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_034: [ If timer_lateness is NULL, threadpool_timer_lateness_on_fired shall return. ]*/
+TEST_FUNCTION(threadpool_timer_lateness_on_fired_with_NULL_timer_lateness_returns)
+{
+    // arrange
+
+    // act
+    threadpool_timer_lateness_on_fired(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_035: [ threadpool_timer_lateness_on_fired shall record the time elapsed since the due time, obtained by calling timer_global_get_elapsed_us, in the lateness histogram by calling latency_histogram_record. ]*/
+TEST_FUNCTION(threadpool_timer_lateness_on_fired_for_a_one_shot_timer_records_the_lateness)
+{
+    // arrange
+    THREADPOOL_TIMER_LATENESS timer_lateness;
+    test_init_timer_lateness(&timer_lateness, 1000, 10, 0);
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(11500);
+    STRICT_EXPECTED_CALL(interlocked_add_64(&timer_lateness.due_time_us, 0));
+    STRICT_EXPECTED_CALL(latency_histogram_record(&timer_lateness.lateness, 500));
+    STRICT_EXPECTED_CALL(interlocked_add(&timer_lateness.period_ms, 0));
+
+    // act
+    threadpool_timer_lateness_on_fired(&timer_lateness);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 11000, timer_lateness.due_time_us);
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_035: [ threadpool_timer_lateness_on_fired shall record the time elapsed since the due time, obtained by calling timer_global_get_elapsed_us, in the lateness histogram by calling latency_histogram_record. ]*/
+/* Tests_SRS_THREADPOOL_STATISTICS_01_036: [ If the period is not 0, threadpool_timer_lateness_on_fired shall add to the due time the smallest multiple of the period that makes it later than the current time, by calling interlocked_compare_exchange_64 so that a concurrent threadpool_timer_lateness_set_due_time wins. ]*/
+TEST_FUNCTION(threadpool_timer_lateness_on_fired_for_a_periodic_timer_moves_the_due_time_by_a_period)
+{
+    // arrange
+    THREADPOOL_TIMER_LATENESS timer_lateness;
+    test_init_timer_lateness(&timer_lateness, 1000, 10, 2);
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(11500);
+    STRICT_EXPECTED_CALL(interlocked_add_64(&timer_lateness.due_time_us, 0));
+    STRICT_EXPECTED_CALL(latency_histogram_record(&timer_lateness.lateness, 500));
+    STRICT_EXPECTED_CALL(interlocked_add(&timer_lateness.period_ms, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(&timer_lateness.due_time_us, 13000, 11000));
+
+    // act
+    threadpool_timer_lateness_on_fired(&timer_lateness);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 13000, timer_lateness.due_time_us);
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_036: [ If the period is not 0, threadpool_timer_lateness_on_fired shall add to the due time the smallest multiple of the period that makes it later than the current time, by calling interlocked_compare_exchange_64 so that a concurrent threadpool_timer_lateness_set_due_time wins. ]*/
+TEST_FUNCTION(threadpool_timer_lateness_on_fired_late_by_more_than_a_period_skips_the_missed_expirations)
+{
+    // arrange
+    THREADPOOL_TIMER_LATENESS timer_lateness;
+    test_init_timer_lateness(&timer_lateness, 1000, 10, 2);
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(16500);
+    STRICT_EXPECTED_CALL(interlocked_add_64(&timer_lateness.due_time_us, 0));
+    STRICT_EXPECTED_CALL(latency_histogram_record(&timer_lateness.lateness, 5500));
+    STRICT_EXPECTED_CALL(interlocked_add(&timer_lateness.period_ms, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(&timer_lateness.due_time_us, 17000, 11000));
+
+    // act
+    threadpool_timer_lateness_on_fired(&timer_lateness);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, 17000, timer_lateness.due_time_us);
+}
+
+/* threadpool_timer_lateness_get */
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_037: [ If timer_lateness is NULL, threadpool_timer_lateness_get shall return. ]*/
+TEST_FUNCTION(threadpool_timer_lateness_get_with_NULL_timer_lateness_returns)
+{
+    // arrange
+    THREADPOOL_TIMER_STATISTICS statistics;
+
+    // act
+    threadpool_timer_lateness_get(NULL, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_038: [ If statistics is NULL, threadpool_timer_lateness_get shall return. ]*/
+TEST_FUNCTION(threadpool_timer_lateness_get_with_NULL_statistics_returns)
+{
+    // arrange
+    THREADPOOL_TIMER_LATENESS timer_lateness;
+    test_init_timer_lateness(&timer_lateness, 1000, 10, 0);
+
+    // act
+    threadpool_timer_lateness_get(&timer_lateness, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_STATISTICS_01_039: [ threadpool_timer_lateness_get shall fill statistics with the lateness histogram by calling latency_histogram_add_to_statistics. ]*/
+TEST_FUNCTION(threadpool_timer_lateness_get_fills_the_lateness_histogram)
+{
+    // arrange
+    THREADPOOL_TIMER_LATENESS timer_lateness;
+    THREADPOOL_TIMER_STATISTICS statistics;
+    test_init_timer_lateness(&timer_lateness, 1000, 10, 0);
+    (void)memset(&statistics, 0x42, sizeof(statistics));
+
+    STRICT_EXPECTED_CALL(latency_histogram_add_to_statistics(&timer_lateness.lateness, &statistics.lateness));
+
+    // act
+    threadpool_timer_lateness_get(&timer_lateness, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.lateness.sample_count);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,1564 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#else
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#endif
+
+#include "macro_utils/macro_utils.h" // IWYU pragma: keep
+
+#include "real_gballoc_ll.h"
+static void* real_malloc(size_t size)
+{
+    return real_gballoc_ll_malloc(size);
+}
+
+static void real_free(void* ptr)
+{
+    real_gballoc_ll_free(ptr);
+}
+
+// IWYU pragma: no_include <wchar.h>
+#include "testrunnerswitcher.h"
+
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes.h"
+#include "umock_c/umocktypes_bool.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umock_c_negative_tests.h"
+
+#define ENABLE_MOCKS
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/srw_lock.h"
+
+#include "c_pal/write_aggregator.h"
+
+MOCKABLE_FUNCTION(, int, test_issue_io, void*, context, WRITE_AGGREGATOR_IO*, io);
+MOCKABLE_FUNCTION(, int, test_start_timer, void*, context, uint32_t, delay_ms, uint64_t, timer_id);
+MOCKABLE_FUNCTION(, int, test_set_file_size, void*, context, uint64_t, file_size);
+MOCKABLE_FUNCTION(, void, test_user_callback, void*, user_context, bool, is_successful);
+#undef ENABLE_MOCKS
+
+#include "real_gballoc_hl.h"
+
+#include "c_pal/write_aggregator.h"
+
+#define TEST_ALIGNMENT 16
+#define TEST_MAX_AGGREGATED_SIZE 64
+#define TEST_MAX_DELAY_MS 10
+
+static SRW_LOCK_HANDLE test_srw_lock = (SRW_LOCK_HANDLE)0x4200;
+static void* test_context = (void*)0x4201;
+static void* test_user_context_1 = (void*)0x4202;
+static void* test_user_context_2 = (void*)0x4203;
+static void* test_user_context_3 = (void*)0x4204;
+
+static unsigned char test_data[256];
+
+static WRITE_AGGREGATOR_IO* captured_ios[4];
+static uint32_t captured_io_count;
+static uint64_t captured_timer_id;
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+TEST_DEFINE_ENUM_TYPE(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_RESULT_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static int hook_test_issue_io(void* context, WRITE_AGGREGATOR_IO* io)
+{
+    (void)context;
+    if (captured_io_count < sizeof(captured_ios) / sizeof(captured_ios[0]))
+    {
+        captured_ios[captured_io_count] = io;
+    }
+    captured_io_count++;
+    return 0;
+}
+
+static int hook_test_start_timer(void* context, uint32_t delay_ms, uint64_t timer_id)
+{
+    (void)context;
+    (void)delay_ms;
+    captured_timer_id = timer_id;
+    return 0;
+}
+
+static void expect_lock(void)
+{
+    STRICT_EXPECTED_CALL(srw_lock_acquire_exclusive(test_srw_lock));
+}
+
+static void expect_unlock(void)
+{
+    STRICT_EXPECTED_CALL(srw_lock_release_exclusive(test_srw_lock));
+}
+
+static WRITE_AGGREGATOR_HANDLE test_create_write_aggregator(void)
+{
+    WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(TEST_ALIGNMENT, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, 0, test_issue_io, test_start_timer, test_set_file_size, test_context);
+    ASSERT_IS_NOT_NULL(write_aggregator);
+    umock_c_reset_all_calls();
+    return write_aggregator;
+}
+
+static void test_add(WRITE_AGGREGATOR_HANDLE write_aggregator, uint32_t size, uint64_t position, void* user_context)
+{
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_OK, write_aggregator_add(write_aggregator, test_data + position, size, position, test_user_callback, user_context));
+    umock_c_reset_all_calls();
+}
+
+static void test_complete_io(WRITE_AGGREGATOR_HANDLE write_aggregator, uint32_t io_index)
+{
+    write_aggregator_io_complete(write_aggregator, captured_ios[io_index], true);
+    umock_c_reset_all_calls();
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init");
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_bool_register_types());
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+
+    REGISTER_UMOCK_ALIAS_TYPE(WRITE_AGGREGATOR_IO*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(SRW_LOCK_HANDLE, void*);
+
+    REGISTER_GLOBAL_MOCK_HOOK(malloc, real_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_hl_aligned_malloc, real_gballoc_hl_aligned_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_hl_aligned_free, real_gballoc_hl_aligned_free);
+    REGISTER_GLOBAL_MOCK_HOOK(test_issue_io, hook_test_issue_io);
+    REGISTER_GLOBAL_MOCK_HOOK(test_start_timer, hook_test_start_timer);
+
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(gballoc_hl_aligned_malloc, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(srw_lock_create, test_srw_lock, NULL);
+
+    for (size_t i = 0; i < sizeof(test_data); i++)
+    {
+        test_data[i] = (unsigned char)(i + 1);
+    }
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    captured_io_count = 0;
+    captured_timer_id = 0;
+
+    umock_c_reset_all_calls();
+    ASSERT_ARE_EQUAL(int, 0, umock_c_negative_tests_init());
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    umock_c_negative_tests_deinit();
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+/* write_aggregator_create */
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_001: [ If alignment is 0 or is not a power of 2, write_aggregator_create shall fail and return NULL. ]*/
+TEST_FUNCTION(write_aggregator_create_with_alignment_0_fails)
+{
+    // arrange
+
+    // act
+    WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(0, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, 0, test_issue_io, test_start_timer, test_set_file_size, test_context);
+
+    // assert
+    ASSERT_IS_NULL(write_aggregator);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_001: [ If alignment is 0 or is not a power of 2, write_aggregator_create shall fail and return NULL. ]*/
+TEST_FUNCTION(write_aggregator_create_with_alignment_not_a_power_of_2_fails)
+{
+    // arrange
+
+    // act
+    WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(24, 48, TEST_MAX_DELAY_MS, 0, test_issue_io, test_start_timer, test_set_file_size, test_context);
+
+    // assert
+    ASSERT_IS_NULL(write_aggregator);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_002: [ If max_aggregated_size is 0 or is not a multiple of alignment, write_aggregator_create shall fail and return NULL. ]*/
+TEST_FUNCTION(write_aggregator_create_with_max_aggregated_size_0_fails)
+{
+    // arrange
+
+    // act
+    WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(TEST_ALIGNMENT, 0, TEST_MAX_DELAY_MS, 0, test_issue_io, test_start_timer, test_set_file_size, test_context);
+
+    // assert
+    ASSERT_IS_NULL(write_aggregator);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_002: [ If max_aggregated_size is 0 or is not a multiple of alignment, write_aggregator_create shall fail and return NULL. ]*/
+TEST_FUNCTION(write_aggregator_create_with_max_aggregated_size_not_a_multiple_of_alignment_fails)
+{
+    // arrange
+
+    // act
+    WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(TEST_ALIGNMENT, TEST_MAX_AGGREGATED_SIZE + 1, TEST_MAX_DELAY_MS, 0, test_issue_io, test_start_timer, test_set_file_size, test_context);
+
+    // assert
+    ASSERT_IS_NULL(write_aggregator);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_003: [ If max_aggregated_size is greater than UINT32_MAX - alignment, write_aggregator_create shall fail and return NULL. ]*/
+TEST_FUNCTION(write_aggregator_create_with_max_aggregated_size_too_big_fails)
+{
+    // arrange
+
+    // act
+    WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(TEST_ALIGNMENT, UINT32_MAX - (TEST_ALIGNMENT - 1), TEST_MAX_DELAY_MS, 0, test_issue_io, test_start_timer, test_set_file_size, test_context);
+
+    // assert
+    ASSERT_IS_NULL(write_aggregator);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_004: [ If max_delay_ms is 0, write_aggregator_create shall fail and return NULL. ]*/
+TEST_FUNCTION(write_aggregator_create_with_max_delay_ms_0_fails)
+{
+    // arrange
+
+    // act
+    WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(TEST_ALIGNMENT, TEST_MAX_AGGREGATED_SIZE, 0, 0, test_issue_io, test_start_timer, test_set_file_size, test_context);
+
+    // assert
+    ASSERT_IS_NULL(write_aggregator);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_005: [ If issue_io is NULL, write_aggregator_create shall fail and return NULL. ]*/
+TEST_FUNCTION(write_aggregator_create_with_NULL_issue_io_fails)
+{
+    // arrange
+
+    // act
+    WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(TEST_ALIGNMENT, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, 0, NULL, test_start_timer, test_set_file_size, test_context);
+
+    // assert
+    ASSERT_IS_NULL(write_aggregator);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_006: [ If start_timer is NULL, write_aggregator_create shall fail and return NULL. ]*/
+TEST_FUNCTION(write_aggregator_create_with_NULL_start_timer_fails)
+{
+    // arrange
+
+    // act
+    WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(TEST_ALIGNMENT, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, 0, test_issue_io, NULL, test_set_file_size, test_context);
+
+    // assert
+    ASSERT_IS_NULL(write_aggregator);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_052: [ If set_file_size is NULL and alignment is not 1, write_aggregator_create shall fail and return NULL. ]*/
+TEST_FUNCTION(write_aggregator_create_with_NULL_set_file_size_fails)
+{
+    // arrange
+
+    // act
+    WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(TEST_ALIGNMENT, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, 0, test_issue_io, test_start_timer, NULL, test_context);
+
+    // assert
+    ASSERT_IS_NULL(write_aggregator);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_052: [ If set_file_size is NULL and alignment is not 1, write_aggregator_create shall fail and return NULL. ]*/
+TEST_FUNCTION(write_aggregator_create_with_NULL_set_file_size_and_alignment_1_succeeds)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(1));
+    STRICT_EXPECTED_CALL(srw_lock_create(false, IGNORED_ARG));
+
+    // act
+    WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(1, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, 0, test_issue_io, test_start_timer, NULL, test_context);
+
+    // assert
+    ASSERT_IS_NOT_NULL(write_aggregator);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_007: [ write_aggregator_create shall allocate memory for the aggregator. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_008: [ write_aggregator_create shall allocate alignment bytes for the tail of the stream. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_061: [ write_aggregator_create shall create the lock by calling srw_lock_create. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_009: [ write_aggregator_create shall start with no open block, no stream and no aggregated I/O in progress and return the aggregator. ]*/
+TEST_FUNCTION(write_aggregator_create_succeeds)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(TEST_ALIGNMENT));
+    STRICT_EXPECTED_CALL(srw_lock_create(false, IGNORED_ARG));
+
+    // act
+    WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(TEST_ALIGNMENT, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, 0, test_issue_io, test_start_timer, test_set_file_size, test_context);
+
+    // assert
+    ASSERT_IS_NOT_NULL(write_aggregator);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_010: [ If any error occurs, write_aggregator_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_write_aggregator_create_also_fails)
+{
+    // arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(TEST_ALIGNMENT));
+    STRICT_EXPECTED_CALL(srw_lock_create(false, IGNORED_ARG));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(TEST_ALIGNMENT, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, 0, test_issue_io, test_start_timer, test_set_file_size, test_context);
+
+            // assert
+            ASSERT_IS_NULL(write_aggregator, "On failed call %zu", i);
+        }
+    }
+}
+
+/* write_aggregator_destroy */
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_011: [ If write_aggregator is NULL, write_aggregator_destroy shall return. ]*/
+TEST_FUNCTION(write_aggregator_destroy_with_NULL_write_aggregator_returns)
+{
+    // arrange
+
+    // act
+    write_aggregator_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_014: [ write_aggregator_destroy shall destroy the lock and free the tail and the memory of the aggregator. ]*/
+TEST_FUNCTION(write_aggregator_destroy_frees_the_memory)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    STRICT_EXPECTED_CALL(srw_lock_destroy(test_srw_lock));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(write_aggregator));
+
+    // act
+    write_aggregator_destroy(write_aggregator);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_012: [ write_aggregator_destroy shall call the user callbacks of all the writes that were not issued with is_successful set to false. ]*/
+TEST_FUNCTION(write_aggregator_destroy_with_an_open_block_fails_its_writes)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 10, 0, test_user_context_1);
+    test_add(write_aggregator, 10, 10, test_user_context_2);
+
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, false));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_2, false));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_hl_aligned_free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_destroy(test_srw_lock));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(write_aggregator));
+
+    // act
+    write_aggregator_destroy(write_aggregator);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_013: [ write_aggregator_destroy shall free all the cached blocks and writes. ]*/
+TEST_FUNCTION(write_aggregator_destroy_frees_the_cached_blocks_and_writes)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 10, 0, test_user_context_1);
+    write_aggregator_flush(write_aggregator);
+    test_complete_io(write_aggregator, 0);
+
+    STRICT_EXPECTED_CALL(gballoc_hl_aligned_free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(srw_lock_destroy(test_srw_lock));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(write_aggregator));
+
+    // act
+    write_aggregator_destroy(write_aggregator);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* write_aggregator_add */
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_015: [ If write_aggregator is NULL, write_aggregator_add shall fail and return WRITE_AGGREGATOR_ADD_ERROR. ]*/
+TEST_FUNCTION(write_aggregator_add_with_NULL_write_aggregator_fails)
+{
+    // arrange
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(NULL, test_data, 10, 0, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_016: [ If source is NULL, write_aggregator_add shall fail and return WRITE_AGGREGATOR_ADD_ERROR. ]*/
+TEST_FUNCTION(write_aggregator_add_with_NULL_source_fails)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, NULL, 10, 0, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_017: [ If size is 0, write_aggregator_add shall fail and return WRITE_AGGREGATOR_ADD_ERROR. ]*/
+TEST_FUNCTION(write_aggregator_add_with_size_0_fails)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data, 0, 0, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_018: [ If position + size is greater than or equal to UINT64_MAX, write_aggregator_add shall fail and return WRITE_AGGREGATOR_ADD_ERROR. ]*/
+TEST_FUNCTION(write_aggregator_add_with_position_too_big_fails)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data, 10, UINT64_MAX - 10, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_019: [ If user_callback is NULL, write_aggregator_add shall fail and return WRITE_AGGREGATOR_ADD_ERROR. ]*/
+TEST_FUNCTION(write_aggregator_add_with_NULL_user_callback_fails)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data, 10, 0, NULL, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_020: [ If size is greater than or equal to max_aggregated_size, write_aggregator_add shall return WRITE_AGGREGATOR_ADD_NOT_AGGREGATED. ]*/
+TEST_FUNCTION(write_aggregator_add_with_size_equal_to_max_aggregated_size_returns_NOT_AGGREGATED)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data, TEST_MAX_AGGREGATED_SIZE, 0, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_021: [ If position is not where the last aggregated write ended and is not a multiple of alignment, write_aggregator_add shall return WRITE_AGGREGATOR_ADD_NOT_AGGREGATED. ]*/
+TEST_FUNCTION(write_aggregator_add_with_unaligned_position_and_no_stream_returns_NOT_AGGREGATED)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data, 10, 3, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_021: [ If position is not where the last aggregated write ended and is not a multiple of alignment, write_aggregator_add shall return WRITE_AGGREGATOR_ADD_NOT_AGGREGATED. ]*/
+TEST_FUNCTION(write_aggregator_add_with_unaligned_position_not_continuing_the_stream_returns_NOT_AGGREGATED)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 10, 0, test_user_context_1);
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data, 10, 11, test_user_callback, test_user_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, false));
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_053: [ write_aggregator_create shall record file_size as the end of the file. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_054: [ If alignment is not 1 and position is before the end of the file, write_aggregator_add shall return WRITE_AGGREGATOR_ADD_NOT_AGGREGATED. ]*/
+TEST_FUNCTION(write_aggregator_add_with_aligned_position_inside_the_initial_file_returns_NOT_AGGREGATED)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(TEST_ALIGNMENT, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, 40, test_issue_io, test_start_timer, test_set_file_size, test_context);
+    ASSERT_IS_NOT_NULL(write_aggregator);
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data + 16, 10, 16, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_053: [ write_aggregator_create shall record file_size as the end of the file. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_054: [ If alignment is not 1 and position is before the end of the file, write_aggregator_add shall return WRITE_AGGREGATOR_ADD_NOT_AGGREGATED. ]*/
+TEST_FUNCTION(write_aggregator_add_at_the_end_of_the_initial_file_is_aggregated)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(TEST_ALIGNMENT, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, 32, test_issue_io, test_start_timer, test_set_file_size, test_context);
+    ASSERT_IS_NOT_NULL(write_aggregator);
+    umock_c_reset_all_calls();
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data + 32, 10, 32, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_OK, result);
+
+    // cleanup
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, false));
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_054: [ If alignment is not 1 and position is before the end of the file, write_aggregator_add shall return WRITE_AGGREGATOR_ADD_NOT_AGGREGATED. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_055: [ If write_aggregator_add returns WRITE_AGGREGATOR_ADD_OK or WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, it shall record position + size as the end of the file if it is past the end of the file. ]*/
+TEST_FUNCTION(write_aggregator_add_overwriting_aggregated_data_returns_NOT_AGGREGATED)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 20, 0, test_user_context_1);
+    write_aggregator_flush(write_aggregator);
+    test_complete_io(write_aggregator, 0);
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    /*aggregating this write would pad the block with zeroes over the data at 10..16*/
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data, 10, 0, test_user_callback, test_user_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, captured_io_count);
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_055: [ If write_aggregator_add returns WRITE_AGGREGATOR_ADD_OK or WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, it shall record position + size as the end of the file if it is past the end of the file. ]*/
+TEST_FUNCTION(write_aggregator_add_records_the_end_of_writes_that_are_not_aggregated)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, write_aggregator_add(write_aggregator, test_data, TEST_MAX_AGGREGATED_SIZE, 0, test_user_callback, test_user_context_1));
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data + 48, 10, 48, test_user_callback, test_user_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_054: [ If alignment is not 1 and position is before the end of the file, write_aggregator_add shall return WRITE_AGGREGATOR_ADD_NOT_AGGREGATED. ]*/
+TEST_FUNCTION(write_aggregator_add_with_alignment_1_aggregates_overwrites)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(1, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, 100, test_issue_io, test_start_timer, NULL, test_context);
+    ASSERT_IS_NOT_NULL(write_aggregator);
+    umock_c_reset_all_calls();
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data + 3, 10, 3, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_OK, result);
+
+    // cleanup
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, false));
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_022: [ write_aggregator_add shall obtain a write entry, reusing a previously released one if available. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_024: [ If there is no open block, write_aggregator_add shall obtain a block, reusing a previously released one if available. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_025: [ write_aggregator_add shall start the block at position rounded down to a multiple of alignment and copy the saved tail of the stream before the data. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_026: [ write_aggregator_add shall assign a new timer id to the block and make it the open block. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_027: [ write_aggregator_add shall copy size bytes from source at the end of the open block. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_028: [ write_aggregator_add shall append user_callback and user_context to the writes of the open block. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_029: [ write_aggregator_add shall record position + size as the end of the stream. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_032: [ If a new block was opened and is still open, write_aggregator_add shall call start_timer with context, max_delay_ms and the timer id of the block. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_034: [ write_aggregator_add shall succeed and return WRITE_AGGREGATOR_ADD_OK. ]*/
+TEST_FUNCTION(write_aggregator_add_opens_a_block_and_starts_the_timer)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_hl_aligned_malloc(TEST_ALIGNMENT, TEST_MAX_AGGREGATED_SIZE + TEST_ALIGNMENT));
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_start_timer(test_context, TEST_MAX_DELAY_MS, 1));
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data + 32, 10, 32, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, false));
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_027: [ write_aggregator_add shall copy size bytes from source at the end of the open block. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_028: [ write_aggregator_add shall append user_callback and user_context to the writes of the open block. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_034: [ write_aggregator_add shall succeed and return WRITE_AGGREGATOR_ADD_OK. ]*/
+TEST_FUNCTION(write_aggregator_add_continuing_the_open_block_only_copies_the_data)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 10, 0, test_user_context_1);
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    expect_unlock();
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data + 10, 7, 10, test_user_callback, test_user_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, false));
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_2, false));
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_023: [ If there is an open block and the write does not continue it or does not fit in it, write_aggregator_add shall close the open block. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_031: [ After releasing the lock, write_aggregator_add shall issue any block that was closed. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_037: [ close_open_block shall pad the block with zeroes up to the next multiple of alignment. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_039: [ Otherwise close_open_block shall mark an aggregated I/O as being in progress and issue the block once the lock is released. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_040: [ A block is issued by calling issue_io with context and the WRITE_AGGREGATOR_IO of the block. ]*/
+TEST_FUNCTION(write_aggregator_add_not_continuing_the_open_block_closes_and_issues_it)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 10, 0, test_user_context_1);
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_hl_aligned_malloc(TEST_ALIGNMENT, TEST_MAX_AGGREGATED_SIZE + TEST_ALIGNMENT));
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_start_timer(test_context, TEST_MAX_DELAY_MS, 2));
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data + 128, 10, 128, test_user_callback, test_user_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, captured_io_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, captured_ios[0]->position);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_ALIGNMENT, captured_ios[0]->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(captured_ios[0]->buffer, test_data, 10));
+    for (uint32_t i = 10; i < TEST_ALIGNMENT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, (int)captured_ios[0]->buffer[i]);
+    }
+
+    // cleanup
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, true));
+    write_aggregator_io_complete(write_aggregator, captured_ios[0], true);
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_2, false));
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_023: [ If there is an open block and the write does not continue it or does not fit in it, write_aggregator_add shall close the open block. ]*/
+TEST_FUNCTION(write_aggregator_add_not_fitting_in_the_open_block_closes_and_issues_it)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 40, 0, test_user_context_1);
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_hl_aligned_malloc(TEST_ALIGNMENT, TEST_MAX_AGGREGATED_SIZE + TEST_ALIGNMENT));
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_start_timer(test_context, TEST_MAX_DELAY_MS, 2));
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data + 40, 30, 40, test_user_callback, test_user_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, captured_io_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, captured_ios[0]->position);
+    ASSERT_ARE_EQUAL(uint32_t, 48, captured_ios[0]->size);
+
+    // cleanup
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, true));
+    write_aggregator_io_complete(write_aggregator, captured_ios[0], true);
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_2, false));
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_030: [ If the open block holds at least max_aggregated_size bytes, write_aggregator_add shall close it. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_031: [ After releasing the lock, write_aggregator_add shall issue any block that was closed. ]*/
+TEST_FUNCTION(write_aggregator_add_filling_the_block_issues_it_without_waiting_for_the_timer)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 32, 0, test_user_context_1);
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data + 32, 32, 32, test_user_callback, test_user_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, captured_io_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, captured_ios[0]->position);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_MAX_AGGREGATED_SIZE, captured_ios[0]->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(captured_ios[0]->buffer, test_data, TEST_MAX_AGGREGATED_SIZE));
+
+    // cleanup
+    test_complete_io(write_aggregator, 0);
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_025: [ write_aggregator_add shall start the block at position rounded down to a multiple of alignment and copy the saved tail of the stream before the data. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_036: [ close_open_block shall save the data after the last aligned position of the block as the tail of the stream. ]*/
+TEST_FUNCTION(write_aggregator_add_continuing_a_closed_block_rewrites_its_partial_tail)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 20, 0, test_user_context_1);
+    write_aggregator_flush(write_aggregator);
+    test_complete_io(write_aggregator, 0);
+    test_add(write_aggregator, 5, 20, test_user_context_2);
+
+    // act
+    write_aggregator_flush(write_aggregator);
+
+    // assert
+    ASSERT_ARE_EQUAL(uint32_t, 2, captured_io_count);
+    ASSERT_ARE_EQUAL(uint64_t, TEST_ALIGNMENT, captured_ios[1]->position);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_ALIGNMENT, captured_ios[1]->size);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(captured_ios[1]->buffer, test_data + TEST_ALIGNMENT, 9));
+    for (uint32_t i = 9; i < TEST_ALIGNMENT; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, (int)captured_ios[1]->buffer[i]);
+    }
+
+    // cleanup
+    test_complete_io(write_aggregator, 1);
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_022: [ write_aggregator_add shall obtain a write entry, reusing a previously released one if available. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_024: [ If there is no open block, write_aggregator_add shall obtain a block, reusing a previously released one if available. ]*/
+TEST_FUNCTION(write_aggregator_add_reuses_released_blocks_and_writes)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 16, 0, test_user_context_1);
+    write_aggregator_flush(write_aggregator);
+    test_complete_io(write_aggregator, 0);
+
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_start_timer(test_context, TEST_MAX_DELAY_MS, 2));
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data + 16, 16, 16, test_user_callback, test_user_context_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_2, false));
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_033: [ If start_timer fails, write_aggregator_add shall close the block as if the timer had expired. ]*/
+TEST_FUNCTION(when_start_timer_fails_write_aggregator_add_issues_the_block)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_hl_aligned_malloc(TEST_ALIGNMENT, TEST_MAX_AGGREGATED_SIZE + TEST_ALIGNMENT));
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_start_timer(test_context, TEST_MAX_DELAY_MS, 1))
+        .SetReturn(MU_FAILURE);
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data, 10, 0, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, captured_io_count);
+
+    // cleanup
+    test_complete_io(write_aggregator, 0);
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_035: [ If any error occurs, write_aggregator_add shall fail and return WRITE_AGGREGATOR_ADD_ERROR. ]*/
+TEST_FUNCTION(when_allocating_the_write_fails_write_aggregator_add_fails)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+    expect_unlock();
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data, 10, 0, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_035: [ If any error occurs, write_aggregator_add shall fail and return WRITE_AGGREGATOR_ADD_ERROR. ]*/
+TEST_FUNCTION(when_allocating_the_block_fails_write_aggregator_add_fails)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+    expect_unlock();
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data, 10, 0, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_035: [ If any error occurs, write_aggregator_add shall fail and return WRITE_AGGREGATOR_ADD_ERROR. ]*/
+TEST_FUNCTION(when_allocating_the_block_buffer_fails_write_aggregator_add_fails)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_hl_aligned_malloc(TEST_ALIGNMENT, TEST_MAX_AGGREGATED_SIZE + TEST_ALIGNMENT))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    expect_unlock();
+
+    // act
+    WRITE_AGGREGATOR_ADD_RESULT result = write_aggregator_add(write_aggregator, test_data, 10, 0, test_user_callback, test_user_context_1);
+
+    // assert
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Closing and issuing blocks */
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_038: [ If an aggregated I/O is in progress, close_open_block shall append the block to the list of ready blocks. ]*/
+TEST_FUNCTION(a_block_closed_while_an_io_is_in_progress_is_not_issued)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 16, 0, test_user_context_1);
+    write_aggregator_flush(write_aggregator);
+    test_add(write_aggregator, 16, 16, test_user_context_2);
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    write_aggregator_flush(write_aggregator);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, captured_io_count);
+
+    // cleanup
+    test_complete_io(write_aggregator, 0);
+    test_complete_io(write_aggregator, 1);
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_041: [ If issue_io fails, the user callbacks of all the writes in the block shall be called with is_successful set to false and the next ready block, if any, shall be issued. ]*/
+TEST_FUNCTION(when_issue_io_fails_the_writes_of_the_block_fail)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 10, 0, test_user_context_1);
+    test_add(write_aggregator, 10, 10, test_user_context_2);
+
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, false));
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_2, false));
+    expect_lock();
+    expect_unlock();
+
+    // act
+    write_aggregator_flush(write_aggregator);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_041: [ If issue_io fails, the user callbacks of all the writes in the block shall be called with is_successful set to false and the next ready block, if any, shall be issued. ]*/
+TEST_FUNCTION(when_issue_io_fails_for_a_ready_block_the_next_ready_block_is_issued)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 16, 0, test_user_context_1);
+    write_aggregator_flush(write_aggregator);
+    test_add(write_aggregator, 16, 16, test_user_context_2);
+    write_aggregator_flush(write_aggregator);
+    test_add(write_aggregator, 16, 32, test_user_context_3);
+    write_aggregator_flush(write_aggregator);
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_2, false));
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, true));
+    expect_lock();
+    expect_unlock();
+
+    // act
+    write_aggregator_io_complete(write_aggregator, captured_ios[0], true);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 32, captured_ios[captured_io_count - 1]->position);
+
+    // cleanup
+    test_complete_io(write_aggregator, captured_io_count - 1);
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* write_aggregator_note_write */
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_056: [ If write_aggregator is NULL, write_aggregator_note_write shall return. ]*/
+TEST_FUNCTION(write_aggregator_note_write_with_NULL_write_aggregator_returns)
+{
+    // arrange
+
+    // act
+    write_aggregator_note_write(NULL, 0, 10);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_057: [ If position + size is greater than UINT64_MAX, write_aggregator_note_write shall return. ]*/
+TEST_FUNCTION(write_aggregator_note_write_with_position_plus_size_overflowing_returns)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    // act
+    write_aggregator_note_write(write_aggregator, UINT64_MAX - 9, 10);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_058: [ write_aggregator_note_write shall record position + size as the end of the file if it is past the end of the file. ]*/
+TEST_FUNCTION(write_aggregator_note_write_records_the_end_of_the_file)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    write_aggregator_note_write(write_aggregator, 0, 40);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, write_aggregator_add(write_aggregator, test_data + 32, 4, 32, test_user_callback, test_user_context_1));
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_OK, write_aggregator_add(write_aggregator, test_data + 48, 4, 48, test_user_callback, test_user_context_1));
+
+    // cleanup
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, false));
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_058: [ write_aggregator_note_write shall record position + size as the end of the file if it is past the end of the file. ]*/
+TEST_FUNCTION(write_aggregator_note_write_before_the_end_of_the_file_keeps_the_end_of_the_file)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    write_aggregator_note_write(write_aggregator, 0, 40);
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    write_aggregator_note_write(write_aggregator, 0, 16);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, write_aggregator_add(write_aggregator, test_data + 32, 4, 32, test_user_callback, test_user_context_1));
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* write_aggregator_flush */
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_042: [ If write_aggregator is NULL, write_aggregator_flush shall return. ]*/
+TEST_FUNCTION(write_aggregator_flush_with_NULL_write_aggregator_returns)
+{
+    // arrange
+
+    // act
+    write_aggregator_flush(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_043: [ If there is an open block, write_aggregator_flush shall close it and issue it if no aggregated I/O is in progress. ]*/
+TEST_FUNCTION(write_aggregator_flush_issues_the_open_block)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 10, 0, test_user_context_1);
+
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+
+    // act
+    write_aggregator_flush(write_aggregator);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, captured_io_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, captured_ios[0]->position);
+    ASSERT_ARE_EQUAL(uint32_t, TEST_ALIGNMENT, captured_ios[0]->size);
+
+    // cleanup
+    test_complete_io(write_aggregator, 0);
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_043: [ If there is an open block, write_aggregator_flush shall close it and issue it if no aggregated I/O is in progress. ]*/
+TEST_FUNCTION(write_aggregator_flush_without_an_open_block_does_nothing)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    write_aggregator_flush(write_aggregator);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, captured_io_count);
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* write_aggregator_on_timer */
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_044: [ If write_aggregator is NULL, write_aggregator_on_timer shall return. ]*/
+TEST_FUNCTION(write_aggregator_on_timer_with_NULL_write_aggregator_returns)
+{
+    // arrange
+
+    // act
+    write_aggregator_on_timer(NULL, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_045: [ If the open block has the timer id timer_id, write_aggregator_on_timer shall close it and issue it if no aggregated I/O is in progress. ]*/
+TEST_FUNCTION(write_aggregator_on_timer_issues_the_open_block_it_was_started_for)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 10, 0, test_user_context_1);
+
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+
+    // act
+    write_aggregator_on_timer(write_aggregator, captured_timer_id);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, captured_io_count);
+
+    // cleanup
+    test_complete_io(write_aggregator, 0);
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_046: [ Otherwise write_aggregator_on_timer shall return, the block the timer was started for was already closed. ]*/
+TEST_FUNCTION(write_aggregator_on_timer_for_a_closed_block_does_nothing)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 16, 0, test_user_context_1);
+    uint64_t first_timer_id = captured_timer_id;
+    write_aggregator_flush(write_aggregator);
+    test_complete_io(write_aggregator, 0);
+    test_add(write_aggregator, 16, 16, test_user_context_2);
+
+    expect_lock();
+    expect_unlock();
+
+    // act
+    write_aggregator_on_timer(write_aggregator, first_timer_id);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, captured_io_count);
+
+    // cleanup
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_2, false));
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* write_aggregator_io_complete */
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_047: [ If write_aggregator is NULL, write_aggregator_io_complete shall return. ]*/
+TEST_FUNCTION(write_aggregator_io_complete_with_NULL_write_aggregator_returns)
+{
+    // arrange
+    WRITE_AGGREGATOR_IO io = { 0 };
+
+    // act
+    write_aggregator_io_complete(NULL, &io, true);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_048: [ If io is NULL, write_aggregator_io_complete shall return. ]*/
+TEST_FUNCTION(write_aggregator_io_complete_with_NULL_io_returns)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+
+    // act
+    write_aggregator_io_complete(write_aggregator, NULL, true);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_049: [ write_aggregator_io_complete shall release the block and take the next ready block, if any. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_051: [ write_aggregator_io_complete shall call the user callbacks of all the writes in the block, in the order they were added, with is_successful. ]*/
+TEST_FUNCTION(write_aggregator_io_complete_calls_the_user_callbacks_in_order)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 10, 0, test_user_context_1);
+    test_add(write_aggregator, 10, 10, test_user_context_2);
+    test_add(write_aggregator, 10, 20, test_user_context_3);
+    write_aggregator_flush(write_aggregator);
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(test_set_file_size(test_context, 30));
+    expect_unlock();
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, true));
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_2, true));
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_3, true));
+    expect_lock();
+    expect_unlock();
+
+    // act
+    write_aggregator_io_complete(write_aggregator, captured_ios[0], true);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_051: [ write_aggregator_io_complete shall call the user callbacks of all the writes in the block, in the order they were added, with is_successful. ]*/
+TEST_FUNCTION(write_aggregator_io_complete_with_failure_fails_the_writes)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 10, 0, test_user_context_1);
+    test_add(write_aggregator, 10, 10, test_user_context_2);
+    write_aggregator_flush(write_aggregator);
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, false));
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_2, false));
+    expect_lock();
+    expect_unlock();
+
+    // act
+    write_aggregator_io_complete(write_aggregator, captured_ios[0], false);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_049: [ write_aggregator_io_complete shall release the block and take the next ready block, if any. ]*/
+/* Tests_SRS_WRITE_AGGREGATOR_01_050: [ write_aggregator_io_complete shall issue the next ready block. ]*/
+TEST_FUNCTION(write_aggregator_io_complete_issues_the_next_ready_block)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 16, 0, test_user_context_1);
+    write_aggregator_flush(write_aggregator);
+    test_add(write_aggregator, 16, 16, test_user_context_2);
+    write_aggregator_flush(write_aggregator);
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, true));
+    expect_lock();
+    expect_unlock();
+
+    // act
+    write_aggregator_io_complete(write_aggregator, captured_ios[0], true);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, captured_io_count);
+    ASSERT_ARE_EQUAL(uint64_t, 16, captured_ios[1]->position);
+
+    // cleanup
+    test_complete_io(write_aggregator, 1);
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_059: [ If is_successful is true, the block was padded and the data of the block ends at the end of the file, write_aggregator_io_complete shall call set_file_size with context and the end of the data of the block while holding the lock. ]*/
+TEST_FUNCTION(write_aggregator_io_complete_for_a_padded_block_at_the_end_of_the_file_restores_the_file_size)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 10, 32, test_user_context_1);
+    write_aggregator_flush(write_aggregator);
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(test_set_file_size(test_context, 42));
+    expect_unlock();
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, true));
+    expect_lock();
+    expect_unlock();
+
+    // act
+    write_aggregator_io_complete(write_aggregator, captured_ios[0], true);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_059: [ If is_successful is true, the block was padded and the data of the block ends at the end of the file, write_aggregator_io_complete shall call set_file_size with context and the end of the data of the block while holding the lock. ]*/
+TEST_FUNCTION(write_aggregator_io_complete_for_a_padded_block_before_the_end_of_the_file_does_not_set_the_file_size)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 10, 0, test_user_context_1);
+    write_aggregator_flush(write_aggregator);
+    write_aggregator_note_write(write_aggregator, 16, 16);
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    expect_unlock();
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, true));
+    expect_lock();
+    expect_unlock();
+
+    // act
+    write_aggregator_io_complete(write_aggregator, captured_ios[0], true);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_059: [ If is_successful is true, the block was padded and the data of the block ends at the end of the file, write_aggregator_io_complete shall call set_file_size with context and the end of the data of the block while holding the lock. ]*/
+TEST_FUNCTION(write_aggregator_io_complete_for_a_padded_block_continued_by_a_ready_block_does_not_set_the_file_size)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 10, 0, test_user_context_1);
+    write_aggregator_flush(write_aggregator);
+    test_add(write_aggregator, 16, 10, test_user_context_2);
+    write_aggregator_flush(write_aggregator);
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    expect_unlock();
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_issue_io(test_context, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, true));
+    expect_lock();
+    expect_unlock();
+
+    // act
+    write_aggregator_io_complete(write_aggregator, captured_ios[0], true);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, captured_io_count);
+
+    // cleanup
+    test_complete_io(write_aggregator, 1);
+    write_aggregator_destroy(write_aggregator);
+}
+
+/* Tests_SRS_WRITE_AGGREGATOR_01_060: [ If set_file_size fails, write_aggregator_io_complete shall call the user callbacks of the writes in the block with is_successful set to false. ]*/
+TEST_FUNCTION(when_set_file_size_fails_write_aggregator_io_complete_fails_the_writes)
+{
+    // arrange
+    WRITE_AGGREGATOR_HANDLE write_aggregator = test_create_write_aggregator();
+    test_add(write_aggregator, 10, 0, test_user_context_1);
+    test_add(write_aggregator, 10, 10, test_user_context_2);
+    write_aggregator_flush(write_aggregator);
+    umock_c_reset_all_calls();
+
+    expect_lock();
+    STRICT_EXPECTED_CALL(test_set_file_size(test_context, 20))
+        .SetReturn(MU_FAILURE);
+    expect_unlock();
+    expect_lock();
+    expect_unlock();
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_1, false));
+    STRICT_EXPECTED_CALL(test_user_callback(test_user_context_2, false));
+    expect_lock();
+    expect_unlock();
+
+    // act
+    write_aggregator_io_complete(write_aggregator, captured_ios[0], true);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    write_aggregator_destroy(write_aggregator);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -5,6 +5,7 @@
 
 #include "macro_utils/macro_utils.h"
 #include "c_pal/execution_engine.h"
+#include "c_pal/io_context_pool.h"
 #include "socket_handle.h"
 #include "umock_c/umock_c_prod.h"
 
@@ -65,6 +66,8 @@ MOCKABLE_FUNCTION(, void, async_socket_close, ASYNC_SOCKET_HANDLE, async_socket)
 MOCKABLE_FUNCTION(, ASYNC_SOCKET_SEND_SYNC_RESULT, async_socket_send_async, ASYNC_SOCKET_HANDLE, async_socket, const ASYNC_SOCKET_BUFFER*, payload, uint32_t, buffer_count, ON_ASYNC_SOCKET_SEND_COMPLETE, on_send_complete, void*, on_send_complete_context);
 MOCKABLE_FUNCTION(, int, async_socket_receive_async, ASYNC_SOCKET_HANDLE, async_socket, ASYNC_SOCKET_BUFFER*, payload, uint32_t, buffer_count, ON_ASYNC_SOCKET_RECEIVE_COMPLETE, on_receive_complete, void*, on_receive_complete_context);
 
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, async_socket_get_io_context_pool_statistics, ASYNC_SOCKET_HANDLE, async_socket, IO_CONTEXT_POOL_STATISTICS*, statistics)(0, MU_FAILURE);
+
 #ifdef __cplusplus
 }
 #endif
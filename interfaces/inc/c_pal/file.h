@@ -13,6 +13,8 @@
 
 #include "macro_utils/macro_utils.h"
 #include "c_pal/execution_engine.h"
+#include "c_pal/io_context_pool.h"
+#include "c_pal/io_admission.h"
 #include "umock_c/umock_c_prod.h"
 #ifdef __cplusplus
 extern "C" {
@@ -22,14 +24,16 @@ extern "C" {
     FILE_WRITE_ASYNC_INVALID_ARGS, \
     FILE_WRITE_ASYNC_WRITE_ERROR, \
     FILE_WRITE_ASYNC_ERROR,\
-    FILE_WRITE_ASYNC_OK
+    FILE_WRITE_ASYNC_OK, \
+    FILE_WRITE_ASYNC_BUSY
 MU_DEFINE_ENUM(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_VALUES);
 
 #define FILE_READ_ASYNC_VALUES \
     FILE_READ_ASYNC_INVALID_ARGS, \
     FILE_READ_ASYNC_READ_ERROR, \
     FILE_READ_ASYNC_ERROR,\
-    FILE_READ_ASYNC_OK
+    FILE_READ_ASYNC_OK, \
+    FILE_READ_ASYNC_BUSY
 MU_DEFINE_ENUM(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_VALUES);
 
 typedef struct FILE_HANDLE_DATA_TAG* FILE_HANDLE;
@@ -37,13 +41,72 @@ typedef void(*FILE_REPORT_FAULT)(void* user_report_fault_context, const char* in
 
 typedef void(*FILE_CB)(void* user_context, bool is_successful);
 
+typedef struct FILE_BUFFER_TAG
+{
+    void* buffer;
+    uint32_t length;
+} FILE_BUFFER;
+
+typedef struct FILE_BATCH_TAG* FILE_BATCH_HANDLE;
+
+#define FILE_ACCESS_HINT_VALUES \
+    FILE_ACCESS_HINT_NORMAL, \
+    FILE_ACCESS_HINT_SEQUENTIAL, \
+    FILE_ACCESS_HINT_RANDOM, \
+    FILE_ACCESS_HINT_WILL_NEED
+MU_DEFINE_ENUM(FILE_ACCESS_HINT, FILE_ACCESS_HINT_VALUES);
+
+typedef struct FILE_MAPPED_REGION_TAG* FILE_MAPPED_REGION_HANDLE;
+
+#define FILE_IO_LIMIT_MODE_VALUES \
+    FILE_IO_LIMIT_MODE_BUSY, \
+    FILE_IO_LIMIT_MODE_QUEUE
+MU_DEFINE_ENUM(FILE_IO_LIMIT_MODE, FILE_IO_LIMIT_MODE_VALUES);
+
+#define FILE_IO_PRIORITY_VALUES \
+    FILE_IO_PRIORITY_NORMAL, \
+    FILE_IO_PRIORITY_LOW
+MU_DEFINE_ENUM(FILE_IO_PRIORITY, FILE_IO_PRIORITY_VALUES);
+
 MOCKABLE_FUNCTION(, FILE_HANDLE, file_create, EXECUTION_ENGINE_HANDLE, execution_engine, const char*, full_file_name, FILE_REPORT_FAULT, user_report_fault_callback, void*, user_report_fault_context);
 MOCKABLE_FUNCTION(, void, file_destroy, FILE_HANDLE, handle);
 
 MOCKABLE_FUNCTION_WITH_RETURNS(, FILE_WRITE_ASYNC_RESULT, file_write_async, FILE_HANDLE, handle, const unsigned char*, source, uint32_t, size, uint64_t, position, FILE_CB, user_callback, void*, user_context)(FILE_WRITE_ASYNC_OK, FILE_WRITE_ASYNC_ERROR);
 MOCKABLE_FUNCTION_WITH_RETURNS(, FILE_READ_ASYNC_RESULT, file_read_async, FILE_HANDLE, handle, unsigned char*, destination, uint32_t, size, uint64_t, position, FILE_CB, user_callback, void*, user_context)(FILE_READ_ASYNC_OK, FILE_READ_ASYNC_ERROR);
 
+MOCKABLE_FUNCTION_WITH_RETURNS(, FILE_WRITE_ASYNC_RESULT, file_write_async_v, FILE_HANDLE, handle, const FILE_BUFFER*, buffers, uint32_t, buffer_count, uint64_t, position, FILE_CB, user_callback, void*, user_context)(FILE_WRITE_ASYNC_OK, FILE_WRITE_ASYNC_ERROR);
+MOCKABLE_FUNCTION_WITH_RETURNS(, FILE_READ_ASYNC_RESULT, file_read_async_v, FILE_HANDLE, handle, const FILE_BUFFER*, buffers, uint32_t, buffer_count, uint64_t, position, FILE_CB, user_callback, void*, user_context)(FILE_READ_ASYNC_OK, FILE_READ_ASYNC_ERROR);
+
+MOCKABLE_FUNCTION(, FILE_BATCH_HANDLE, file_batch_begin, FILE_HANDLE, handle, uint32_t, max_io_count);
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, file_batch_add_write, FILE_BATCH_HANDLE, batch, const unsigned char*, source, uint32_t, size, uint64_t, position, FILE_CB, user_callback, void*, user_context)(0, MU_FAILURE);
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, file_batch_add_read, FILE_BATCH_HANDLE, batch, unsigned char*, destination, uint32_t, size, uint64_t, position, FILE_CB, user_callback, void*, user_context)(0, MU_FAILURE);
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, file_batch_submit, FILE_BATCH_HANDLE, batch, uint32_t*, submitted_count)(0, MU_FAILURE);
+MOCKABLE_FUNCTION(, void, file_batch_cancel, FILE_BATCH_HANDLE, batch);
+
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, file_flush_async, FILE_HANDLE, handle, FILE_CB, user_callback, void*, user_context)(0, MU_FAILURE);
+
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, file_copy_range_async, FILE_HANDLE, source, uint64_t, source_position, FILE_HANDLE, destination, uint64_t, destination_position, uint64_t, size, FILE_CB, user_callback, void*, user_context)(0, MU_FAILURE);
+
+MOCKABLE_FUNCTION(, FILE_MAPPED_REGION_HANDLE, file_map_region, FILE_HANDLE, handle, uint64_t, position, uint32_t, size, FILE_ACCESS_HINT, access_hint);
+MOCKABLE_FUNCTION(, const unsigned char*, file_mapped_region_get_data, FILE_MAPPED_REGION_HANDLE, region);
+MOCKABLE_FUNCTION(, void, file_unmap_region, FILE_MAPPED_REGION_HANDLE, region);
+
 MOCKABLE_FUNCTION_WITH_RETURNS(, int, file_extend, FILE_HANDLE, handle, uint64_t, desired_size)(0, MU_FAILURE);
+
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, file_set_preallocation, FILE_HANDLE, handle, uint64_t, chunk_size)(0, MU_FAILURE);
+
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, file_set_write_aggregation, FILE_HANDLE, handle, uint32_t, max_aggregated_size, uint32_t, max_delay_ms)(0, MU_FAILURE);
+
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, file_set_read_ahead, FILE_HANDLE, handle, uint32_t, block_size, uint32_t, block_count)(0, MU_FAILURE);
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, file_set_access_hint, FILE_HANDLE, handle, FILE_ACCESS_HINT, access_hint)(0, MU_FAILURE);
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, file_will_need, FILE_HANDLE, handle, uint64_t, position, uint64_t, size)(0, MU_FAILURE);
+
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, file_set_io_limit, FILE_HANDLE, handle, uint32_t, max_outstanding_io, FILE_IO_LIMIT_MODE, mode)(0, MU_FAILURE);
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, file_get_io_admission_statistics, FILE_HANDLE, handle, IO_ADMISSION_STATISTICS*, statistics)(0, MU_FAILURE);
+
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, file_set_io_priority, FILE_HANDLE, handle, FILE_IO_PRIORITY, priority)(0, MU_FAILURE);
+
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, file_get_io_context_pool_statistics, FILE_HANDLE, handle, IO_CONTEXT_POOL_STATISTICS*, statistics)(0, MU_FAILURE);
 #ifdef __cplusplus
 }
 #endif
@@ -46,6 +46,9 @@ extern "C" {
     MOCKABLE_FUNCTION(, void*, gballoc_hl_realloc, void*, ptr, size_t, size);
     MOCKABLE_FUNCTION(, void, gballoc_hl_free, void*, ptr);
 
+    MOCKABLE_FUNCTION(, void*, gballoc_hl_aligned_malloc, size_t, alignment, size_t, size);
+    MOCKABLE_FUNCTION(, void, gballoc_hl_aligned_free, void*, ptr);
+
     MOCKABLE_FUNCTION(, void, gballoc_hl_reset_counters);
 
     MOCKABLE_FUNCTION(, int, gballoc_hl_get_malloc_latency_buckets, GBALLOC_LATENCY_BUCKETS*, latency_buckets_out);
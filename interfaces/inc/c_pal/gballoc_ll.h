@@ -25,7 +25,11 @@ extern "C"
     MOCKABLE_FUNCTION(, void*, gballoc_ll_calloc, size_t, nmemb, size_t, size);
     MOCKABLE_FUNCTION(, void*, gballoc_ll_realloc, void*, ptr, size_t, size);
 
+    MOCKABLE_FUNCTION(, void*, gballoc_ll_aligned_malloc, size_t, alignment, size_t, size);
+    MOCKABLE_FUNCTION(, void, gballoc_ll_aligned_free, void*, ptr);
+
     MOCKABLE_FUNCTION(, size_t, gballoc_ll_size, void*, ptr);
+    MOCKABLE_FUNCTION(, size_t, gballoc_ll_aligned_size, void*, ptr);
 
 #ifdef __cplusplus
 }
@@ -18,6 +18,9 @@ extern "C"
 #endif
 
 MOCKABLE_FUNCTION(, uint32_t, sysinfo_get_processor_count);
+MOCKABLE_FUNCTION(, uint32_t, sysinfo_get_numa_node_count);
+MOCKABLE_FUNCTION(, uint32_t, sysinfo_get_current_numa_node);
+MOCKABLE_FUNCTION(, uint32_t, sysinfo_get_current_processor);
 
 #ifdef __cplusplus
 }
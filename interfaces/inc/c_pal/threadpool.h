@@ -11,6 +11,7 @@
 
 #include "macro_utils/macro_utils.h"
 #include "c_pal/execution_engine.h"
+#include "c_pal/latency_histogram.h"
 #include "umock_c/umock_c_prod.h"
 
 #ifdef __cplusplus
@@ -19,6 +20,7 @@ extern "C" {
 
 typedef struct THREADPOOL_TAG* THREADPOOL_HANDLE;
 typedef struct TIMER_INSTANCE_TAG* TIMER_INSTANCE_HANDLE;
+typedef struct THREADPOOL_WORK_ITEM_TAG* THREADPOOL_WORK_ITEM_HANDLE;
 
 #define THREADPOOL_OPEN_RESULT_VALUES \
     THREADPOOL_OPEN_OK, \
@@ -29,6 +31,44 @@ MU_DEFINE_ENUM(THREADPOOL_OPEN_RESULT, THREADPOOL_OPEN_RESULT_VALUES)
 typedef void (*ON_THREADPOOL_OPEN_COMPLETE)(void* context, THREADPOOL_OPEN_RESULT open_result);
 typedef void (*THREADPOOL_WORK_FUNCTION)(void* context);
 
+typedef struct THREADPOOL_WORK_BATCH_ITEM_TAG
+{
+    THREADPOOL_WORK_FUNCTION work_function;
+    void* work_function_context;
+} THREADPOOL_WORK_BATCH_ITEM;
+
+/*THREADPOOL_PRIORITY_HIGH work runs before any queued THREADPOOL_PRIORITY_NORMAL work, THREADPOOL_PRIORITY_LOW is for background work*/
+#define THREADPOOL_PRIORITY_VALUES \
+    THREADPOOL_PRIORITY_HIGH, \
+    THREADPOOL_PRIORITY_NORMAL, \
+    THREADPOOL_PRIORITY_LOW
+
+MU_DEFINE_ENUM(THREADPOOL_PRIORITY, THREADPOOL_PRIORITY_VALUES)
+
+/*the time work functions spent queued before starting to execute*/
+typedef struct THREADPOOL_QUEUE_WAIT_STATISTICS_TAG
+{
+    uint64_t work_item_count; /*number of work functions that started executing*/
+    uint64_t total_queue_wait_us;
+    uint64_t max_queue_wait_us;
+} THREADPOOL_QUEUE_WAIT_STATISTICS;
+
+/*collected once threadpool_enable_statistics was called*/
+typedef struct THREADPOOL_STATISTICS_TAG
+{
+    LATENCY_HISTOGRAM_STATISTICS queue_wait; /*between a work item being scheduled and starting to execute*/
+    LATENCY_HISTOGRAM_STATISTICS run_time; /*of the work functions*/
+    uint32_t queue_depth; /*work items scheduled and not started yet*/
+    uint32_t peak_queue_depth;
+    uint32_t active_worker_count; /*threads executing a work function*/
+    uint32_t idle_worker_count; /*threads waiting for work*/
+} THREADPOOL_STATISTICS;
+
+typedef struct THREADPOOL_TIMER_STATISTICS_TAG
+{
+    LATENCY_HISTOGRAM_STATISTICS lateness; /*between the time the timer was due and its callback starting to execute*/
+} THREADPOOL_TIMER_STATISTICS;
+
 MOCKABLE_FUNCTION(, THREADPOOL_HANDLE, threadpool_create, EXECUTION_ENGINE_HANDLE, execution_engine);
 MOCKABLE_FUNCTION(, void, threadpool_destroy, THREADPOOL_HANDLE, threadpool);
 
@@ -36,15 +76,31 @@ MOCKABLE_FUNCTION(, int, threadpool_open_async, THREADPOOL_HANDLE, threadpool, O
 MOCKABLE_FUNCTION(, void, threadpool_close, THREADPOOL_HANDLE, threadpool);
 
 MOCKABLE_FUNCTION(, int, threadpool_schedule_work, THREADPOOL_HANDLE, threadpool, THREADPOOL_WORK_FUNCTION, work_function, void*, work_function_context);
+MOCKABLE_FUNCTION(, int, threadpool_schedule_work_with_priority, THREADPOOL_HANDLE, threadpool, THREADPOOL_PRIORITY, priority, THREADPOOL_WORK_FUNCTION, work_function, void*, work_function_context);
+MOCKABLE_FUNCTION(, int, threadpool_schedule_work_batch, THREADPOOL_HANDLE, threadpool, const THREADPOOL_WORK_BATCH_ITEM*, work_items, uint32_t, work_item_count);
+MOCKABLE_FUNCTION(, int, threadpool_schedule_work_on_node, THREADPOOL_HANDLE, threadpool, uint32_t, numa_node, THREADPOOL_WORK_FUNCTION, work_function, void*, work_function_context);
+
+MOCKABLE_FUNCTION(, THREADPOOL_WORK_ITEM_HANDLE, threadpool_create_work_item, THREADPOOL_HANDLE, threadpool, THREADPOOL_WORK_FUNCTION, work_function, void*, work_function_context);
+MOCKABLE_FUNCTION(, int, threadpool_schedule_work_item, THREADPOOL_HANDLE, threadpool, THREADPOOL_WORK_ITEM_HANDLE, work_item);
+MOCKABLE_FUNCTION(, void, threadpool_destroy_work_item, THREADPOOL_HANDLE, threadpool, THREADPOOL_WORK_ITEM_HANDLE, work_item);
 
 MOCKABLE_FUNCTION(, int, threadpool_timer_start, THREADPOOL_HANDLE, threadpool, uint32_t, start_delay_ms, uint32_t, timer_period_ms, THREADPOOL_WORK_FUNCTION, work_function, void*, work_function_context, TIMER_INSTANCE_HANDLE*, timer_handle);
+MOCKABLE_FUNCTION(, int, threadpool_timer_start_with_priority, THREADPOOL_HANDLE, threadpool, THREADPOOL_PRIORITY, priority, uint32_t, start_delay_ms, uint32_t, timer_period_ms, THREADPOOL_WORK_FUNCTION, work_function, void*, work_function_context, TIMER_INSTANCE_HANDLE*, timer_handle);
+MOCKABLE_FUNCTION(, int, threadpool_timer_start_with_tolerance, THREADPOOL_HANDLE, threadpool, uint32_t, start_delay_ms, uint32_t, timer_period_ms, uint32_t, tolerance_ms, THREADPOOL_WORK_FUNCTION, work_function, void*, work_function_context, TIMER_INSTANCE_HANDLE*, timer_handle);
 
 MOCKABLE_FUNCTION(, int, threadpool_timer_restart, TIMER_INSTANCE_HANDLE, timer, uint32_t, start_delay_ms, uint32_t, timer_period_ms);
+MOCKABLE_FUNCTION(, int, threadpool_timer_restart_with_tolerance, TIMER_INSTANCE_HANDLE, timer, uint32_t, start_delay_ms, uint32_t, timer_period_ms, uint32_t, tolerance_ms);
 
 MOCKABLE_FUNCTION(, void, threadpool_timer_cancel, TIMER_INSTANCE_HANDLE, timer);
 
 MOCKABLE_FUNCTION(, void, threadpool_timer_destroy, TIMER_INSTANCE_HANDLE, timer);
 
+MOCKABLE_FUNCTION(, int, threadpool_get_queue_wait_statistics, THREADPOOL_HANDLE, threadpool, THREADPOOL_PRIORITY, priority, THREADPOOL_QUEUE_WAIT_STATISTICS*, statistics);
+
+MOCKABLE_FUNCTION(, int, threadpool_enable_statistics, THREADPOOL_HANDLE, threadpool);
+MOCKABLE_FUNCTION(, int, threadpool_get_statistics, THREADPOOL_HANDLE, threadpool, THREADPOOL_STATISTICS*, statistics);
+MOCKABLE_FUNCTION(, int, threadpool_timer_get_statistics, TIMER_INSTANCE_HANDLE, timer, THREADPOOL_TIMER_STATISTICS*, statistics);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,8 @@
         gballoc_hl_calloc                        ,\
         gballoc_hl_realloc                       ,\
         gballoc_hl_free                          ,\
+        gballoc_hl_aligned_malloc                ,\
+        gballoc_hl_aligned_free                  ,\
         gballoc_hl_reset_counters                ,\
         gballoc_hl_get_malloc_latency_buckets    ,\
         gballoc_hl_get_realloc_latency_buckets   ,\
@@ -43,6 +45,9 @@ extern "C" {
     void* real_gballoc_hl_realloc(void* ptr, size_t size);
     void real_gballoc_hl_free(void* ptr);
 
+    void* real_gballoc_hl_aligned_malloc(size_t alignment, size_t size);
+    void real_gballoc_hl_aligned_free(void* ptr);
+
     void real_gballoc_hl_reset_counters(void);
 
     int real_gballoc_hl_get_malloc_latency_buckets(GBALLOC_LATENCY_BUCKETS* latency_buckets_out);
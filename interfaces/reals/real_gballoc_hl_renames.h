@@ -7,6 +7,8 @@
 #define gballoc_hl_calloc                        real_gballoc_hl_calloc
 #define gballoc_hl_realloc                       real_gballoc_hl_realloc
 #define gballoc_hl_free                          real_gballoc_hl_free
+#define gballoc_hl_aligned_malloc                real_gballoc_hl_aligned_malloc
+#define gballoc_hl_aligned_free                  real_gballoc_hl_aligned_free
 #define gballoc_hl_reset_counters                real_gballoc_hl_reset_counters
 #define gballoc_hl_get_malloc_latency_buckets    real_gballoc_hl_get_malloc_latency_buckets
 #define gballoc_hl_get_realloc_latency_buckets   real_gballoc_hl_get_realloc_latency_buckets
@@ -20,7 +20,10 @@
         gballoc_ll_free    ,\
         gballoc_ll_calloc  ,\
         gballoc_ll_realloc ,\
-        gballoc_ll_size     \
+        gballoc_ll_aligned_malloc ,\
+        gballoc_ll_aligned_free   ,\
+        gballoc_ll_size    ,\
+        gballoc_ll_aligned_size   \
 )
 
 #include "umock_c/umock_c_prod.h"
@@ -38,7 +41,11 @@ extern "C"
     void* real_gballoc_ll_calloc(size_t nmemb, size_t size);
     void* real_gballoc_ll_realloc(void* ptr, size_t size);
 
+    void* real_gballoc_ll_aligned_malloc(size_t alignment, size_t size);
+    void real_gballoc_ll_aligned_free(void* ptr);
+
     size_t real_gballoc_ll_size(void* ptr);
+    size_t real_gballoc_ll_aligned_size(void* ptr);
 
 #ifdef __cplusplus
 }
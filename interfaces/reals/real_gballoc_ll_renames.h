@@ -7,4 +7,7 @@
 #define gballoc_ll_free        real_gballoc_ll_free
 #define gballoc_ll_calloc      real_gballoc_ll_calloc
 #define gballoc_ll_realloc     real_gballoc_ll_realloc
+#define gballoc_ll_aligned_malloc real_gballoc_ll_aligned_malloc
+#define gballoc_ll_aligned_free   real_gballoc_ll_aligned_free
 #define gballoc_ll_size        real_gballoc_ll_size
+#define gballoc_ll_aligned_size   real_gballoc_ll_aligned_size
@@ -75,6 +75,22 @@ static void wait_on_address_helper(volatile_atomic int32_t* address, int32_t old
     } while (current_value == old_value);
 }
 
+/*the linux implementation opens the files with O_DIRECT, so the buffers, sizes and positions of the I/Os are aligned*/
+#define TEST_BLOCK_SIZE 4096
+
+static unsigned char* aligned_blocks_create(uint32_t block_count, unsigned char value)
+{
+    unsigned char* result = (unsigned char*)gballoc_hl_aligned_malloc(TEST_BLOCK_SIZE, (size_t)block_count * TEST_BLOCK_SIZE);
+    ASSERT_IS_NOT_NULL(result);
+    (void)memset(result, value, (size_t)block_count * TEST_BLOCK_SIZE);
+    return result;
+}
+
+static unsigned char* aligned_block_create(unsigned char value)
+{
+    return aligned_blocks_create(1, value);
+}
+
 static FILE_HANDLE file_create_helper(const char* filename)
 {
     (void)delete_file(filename);
@@ -159,15 +175,13 @@ TEST_FUNCTION(file_create_creates_new_file)
 TEST_FUNCTION(write_to_a_file_and_read_from_it)
 {
     ///arrange
-    const int size = 5;
-
-    unsigned char source[] = "abcd";
+    unsigned char* source = aligned_block_create('a');
     WRITE_COMPLETE_CONTEXT write_context;
     write_context.pre_callback_value = 41;
     (void)interlocked_exchange(&write_context.value, write_context.pre_callback_value);
     write_context.post_callback_value = 42;
 
-    unsigned char destination[5];
+    unsigned char* destination = aligned_block_create(0);
     READ_COMPLETE_CONTEXT read_context;
     read_context.pre_callback_value = 43;
     (void)interlocked_exchange(&read_context.value, read_context.pre_callback_value);
@@ -177,7 +191,7 @@ TEST_FUNCTION(write_to_a_file_and_read_from_it)
     FILE_HANDLE file_handle = file_create_helper(filename);
 
     ///act
-    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, size, 0, write_callback, &write_context));
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, TEST_BLOCK_SIZE, 0, write_callback, &write_context));
     
     ///assert
     wait_on_address_helper(&write_context.value, write_context.pre_callback_value, UINT32_MAX);
@@ -185,15 +199,17 @@ TEST_FUNCTION(write_to_a_file_and_read_from_it)
     ASSERT_IS_TRUE(write_context.did_write_succeed);
 
     ///act
-    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async(file_handle, destination, sizeof(destination), 0, read_callback, &read_context));
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async(file_handle, destination, TEST_BLOCK_SIZE, 0, read_callback, &read_context));
 
     ///assert
     wait_on_address_helper(&read_context.value, read_context.pre_callback_value, UINT32_MAX);
     ASSERT_ARE_EQUAL(int32_t, read_context.post_callback_value, interlocked_or(&read_context.value, 0), "value should be post_callback_value");
     ASSERT_IS_TRUE(read_context.did_read_succeed);
-    ASSERT_ARE_EQUAL(char_ptr, source, destination);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source, destination, TEST_BLOCK_SIZE));
 
     //cleanup
+    gballoc_hl_aligned_free(destination);
+    gballoc_hl_aligned_free(source);
     file_destroy(file_handle);
     (void)delete_file(filename);
 }
@@ -212,21 +228,19 @@ TEST_FUNCTION(write_to_a_file_and_read_from_it)
 TEST_FUNCTION(write_twice_to_a_file_contiguously_and_read_from_it)
 {
     ///arrange
-    const int size = 5;
-
-    unsigned char source1[] = "abcd";
+    unsigned char* source1 = aligned_block_create('a');
     WRITE_COMPLETE_CONTEXT write_context1;
     write_context1.pre_callback_value = 41;
     (void)interlocked_exchange(&write_context1.value, write_context1.pre_callback_value);
     write_context1.post_callback_value = 42;
 
-    unsigned char source2[] = "efgh";
+    unsigned char* source2 = aligned_block_create('e');
     WRITE_COMPLETE_CONTEXT write_context2;
     write_context2.pre_callback_value = 45;
     (void)interlocked_exchange(&write_context2.value, write_context2.pre_callback_value);
     write_context2.post_callback_value = 46;
 
-    unsigned char destination[9];
+    unsigned char* destination = aligned_blocks_create(2, 0);
     READ_COMPLETE_CONTEXT read_context;
     read_context.pre_callback_value = 43;
     (void)interlocked_exchange(&read_context.value, read_context.pre_callback_value);
@@ -236,8 +250,8 @@ TEST_FUNCTION(write_twice_to_a_file_contiguously_and_read_from_it)
     FILE_HANDLE file_handle = file_create_helper(filename);
 
     ///act
-    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source1, size, 0, write_callback, &write_context1));
-    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source2, size, 4, write_callback, &write_context2));
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source1, TEST_BLOCK_SIZE, 0, write_callback, &write_context1));
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source2, TEST_BLOCK_SIZE, TEST_BLOCK_SIZE, write_callback, &write_context2));
    
     ///assert
     wait_on_address_helper(&write_context1.value, write_context1.pre_callback_value, UINT32_MAX);
@@ -249,15 +263,19 @@ TEST_FUNCTION(write_twice_to_a_file_contiguously_and_read_from_it)
     ASSERT_IS_TRUE(write_context2.did_write_succeed);
 
     ///act
-    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async(file_handle, destination, sizeof(destination), 0, read_callback, &read_context));
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async(file_handle, destination, 2 * TEST_BLOCK_SIZE, 0, read_callback, &read_context));
 
     ///assert
     wait_on_address_helper(&read_context.value, read_context.pre_callback_value, UINT32_MAX);
     ASSERT_ARE_EQUAL(int32_t, read_context.post_callback_value, interlocked_or(&read_context.value, 0), "value should be post_callback_value");
     ASSERT_IS_TRUE(read_context.did_read_succeed);
-    ASSERT_ARE_EQUAL(char_ptr, "abcdefgh", destination);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source1, destination, TEST_BLOCK_SIZE));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source2, &destination[TEST_BLOCK_SIZE], TEST_BLOCK_SIZE));
 
     //cleanup
+    gballoc_hl_aligned_free(destination);
+    gballoc_hl_aligned_free(source2);
+    gballoc_hl_aligned_free(source1);
     file_destroy(file_handle);
     (void)delete_file(filename);
 }
@@ -276,30 +294,28 @@ TEST_FUNCTION(write_twice_to_a_file_contiguously_and_read_from_it)
 TEST_FUNCTION(write_twice_to_a_file_non_contiguously_and_read_from_it)
 {
     ///arrange
-    const int size = 5;
-
-    unsigned char source1[] = "abcd";
+    unsigned char* source1 = aligned_block_create('a');
     WRITE_COMPLETE_CONTEXT write_context1;
     write_context1.pre_callback_value = 41;
     (void)interlocked_exchange(&write_context1.value, write_context1.pre_callback_value);
     write_context1.post_callback_value = 42;
 
 
-    unsigned char source2[] = "efgh";
+    unsigned char* source2 = aligned_block_create('e');
     WRITE_COMPLETE_CONTEXT write_context2;
     write_context2.pre_callback_value = 45;
     (void)interlocked_exchange(&write_context2.value, write_context2.pre_callback_value);
     write_context2.post_callback_value = 46;
 
 
-    unsigned char destination1[5];
+    unsigned char* destination1 = aligned_block_create(0);
     READ_COMPLETE_CONTEXT read_context1;
     read_context1.pre_callback_value = 43;
     (void)interlocked_exchange(&read_context1.value, read_context1.pre_callback_value);
     read_context1.post_callback_value = 44;
 
 
-    unsigned char destination2[5];
+    unsigned char* destination2 = aligned_block_create(0);
     READ_COMPLETE_CONTEXT read_context2;
     read_context2.pre_callback_value = 43;
     (void)interlocked_exchange(&read_context2.value, read_context2.pre_callback_value);
@@ -308,11 +324,11 @@ TEST_FUNCTION(write_twice_to_a_file_non_contiguously_and_read_from_it)
     char filename[] = "write_twice_to_a_file_non_contiguously_and_read_from_it.txt";
     FILE_HANDLE file_handle = file_create_helper(filename);
 
-    uint64_t second_write_position = 50;
+    uint64_t second_write_position = 50 * TEST_BLOCK_SIZE;
 
     ///act
-    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source1, size, 0, write_callback, &write_context1));
-    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source2, size, second_write_position, write_callback, &write_context2));
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source1, TEST_BLOCK_SIZE, 0, write_callback, &write_context1));
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source2, TEST_BLOCK_SIZE, second_write_position, write_callback, &write_context2));
    
     ///assert
     wait_on_address_helper(&write_context1.value, write_context1.pre_callback_value, UINT32_MAX);
@@ -324,8 +340,8 @@ TEST_FUNCTION(write_twice_to_a_file_non_contiguously_and_read_from_it)
     ASSERT_IS_TRUE(write_context2.did_write_succeed);
 
     ///act
-    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async(file_handle, destination1, sizeof(destination1), 0, read_callback, &read_context1));
-    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async(file_handle, destination2, sizeof(destination2), second_write_position, read_callback, &read_context2));
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async(file_handle, destination1, TEST_BLOCK_SIZE, 0, read_callback, &read_context1));
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async(file_handle, destination2, TEST_BLOCK_SIZE, second_write_position, read_callback, &read_context2));
 
     ///assert
     wait_on_address_helper(&read_context1.value, read_context1.pre_callback_value, UINT32_MAX);
@@ -336,10 +352,14 @@ TEST_FUNCTION(write_twice_to_a_file_non_contiguously_and_read_from_it)
     ASSERT_ARE_EQUAL(int32_t, read_context2.post_callback_value, interlocked_or(&read_context2.value, 0), "value should be post_callback_value");
     ASSERT_IS_TRUE(read_context2.did_read_succeed);
 
-    ASSERT_ARE_EQUAL(char_ptr, source1, destination1);
-    ASSERT_ARE_EQUAL(char_ptr, source2, destination2);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source1, destination1, TEST_BLOCK_SIZE));
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source2, destination2, TEST_BLOCK_SIZE));
 
     //cleanup
+    gballoc_hl_aligned_free(destination2);
+    gballoc_hl_aligned_free(destination1);
+    gballoc_hl_aligned_free(source2);
+    gballoc_hl_aligned_free(source1);
     file_destroy(file_handle);
     (void)delete_file(filename);
 }
@@ -358,16 +378,14 @@ TEST_FUNCTION(write_twice_to_a_file_non_contiguously_and_read_from_it)
 TEST_FUNCTION(perform_operations_open_write_close_open_read_close)
 {
     ///arrange
-    const int size = 5;
-
-    unsigned char source[] = "abcd";
+    unsigned char* source = aligned_block_create('a');
     WRITE_COMPLETE_CONTEXT write_context;
     write_context.pre_callback_value = 41;
     (void)interlocked_exchange(&write_context.value, write_context.pre_callback_value);
     write_context.post_callback_value = 42;
 
 
-    unsigned char destination[5];
+    unsigned char* destination = aligned_block_create(0);
     READ_COMPLETE_CONTEXT read_context;
     read_context.pre_callback_value = 43;
     (void)interlocked_exchange(&read_context.value, read_context.pre_callback_value);
@@ -383,7 +401,7 @@ TEST_FUNCTION(perform_operations_open_write_close_open_read_close)
     FILE_HANDLE file_handle1 = file_create(execution_engine, filename, NULL, NULL);
     ASSERT_IS_NOT_NULL(file_handle1);
 
-    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle1, source, size, 0, write_callback, &write_context));
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle1, source, TEST_BLOCK_SIZE, 0, write_callback, &write_context));
     wait_on_address_helper(&write_context.value, write_context.pre_callback_value, UINT32_MAX);
     file_destroy(file_handle1);
    
@@ -395,16 +413,18 @@ TEST_FUNCTION(perform_operations_open_write_close_open_read_close)
     FILE_HANDLE file_handle2 = file_create(execution_engine, filename, NULL, NULL);
     ASSERT_IS_NOT_NULL(file_handle2);
 
-    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async(file_handle2, destination, sizeof(destination), 0, read_callback, &read_context));
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async(file_handle2, destination, TEST_BLOCK_SIZE, 0, read_callback, &read_context));
     file_destroy(file_handle2);
 
     ///assert
     wait_on_address_helper(&read_context.value, read_context.pre_callback_value, UINT32_MAX);
     ASSERT_ARE_EQUAL(int32_t, read_context.post_callback_value, interlocked_or(&read_context.value, 0), "value should be post_callback_value");
     ASSERT_IS_TRUE(read_context.did_read_succeed);
-    ASSERT_ARE_EQUAL(char_ptr, source, destination);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source, destination, TEST_BLOCK_SIZE));
 
     // cleanup
+    gballoc_hl_aligned_free(destination);
+    gballoc_hl_aligned_free(source);
     execution_engine_dec_ref(execution_engine);
 }
 
@@ -412,27 +432,25 @@ TEST_FUNCTION(perform_operations_open_write_close_open_read_close)
 TEST_FUNCTION(read_across_eof_fails)
 {
     ///arrange
-    const int size = 5;
-
-    unsigned char source[] = "abcd";
+    unsigned char* source = aligned_block_create('a');
     WRITE_COMPLETE_CONTEXT write_context;
     write_context.pre_callback_value = 41;
     (void)interlocked_exchange(&write_context.value, write_context.pre_callback_value);
     write_context.post_callback_value = 42;
 
-    unsigned char destination[5];
+    unsigned char* destination = aligned_blocks_create(2, 0);
     READ_COMPLETE_CONTEXT read_context;
     read_context.pre_callback_value = 43;
     (void)interlocked_exchange(&read_context.value, read_context.pre_callback_value);
     read_context.post_callback_value = 44;
 
-    uint32_t read_position = 2;
+    uint32_t read_position = 0;
 
     char filename[] = "read_across_eof_fails.txt";
     FILE_HANDLE file_handle = file_create_helper(filename);
 
     ///act
-    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, size, 0, write_callback, &write_context));
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, TEST_BLOCK_SIZE, 0, write_callback, &write_context));
 
     ///assert
 
@@ -441,7 +459,7 @@ TEST_FUNCTION(read_across_eof_fails)
     ASSERT_IS_TRUE(write_context.did_write_succeed);
 
     ///act
-    file_read_async(file_handle, destination, sizeof(destination), read_position, read_callback, &read_context);
+    file_read_async(file_handle, destination, 2 * TEST_BLOCK_SIZE, read_position, read_callback, &read_context);
 
     ///assert
     wait_on_address_helper(&read_context.value, read_context.pre_callback_value, UINT32_MAX);
@@ -449,6 +467,8 @@ TEST_FUNCTION(read_across_eof_fails)
     ASSERT_IS_FALSE(read_context.did_read_succeed);
 
     //cleanup
+    gballoc_hl_aligned_free(destination);
+    gballoc_hl_aligned_free(source);
     file_destroy(file_handle);
     (void)delete_file(filename);
 }
@@ -457,26 +477,24 @@ TEST_FUNCTION(read_across_eof_fails)
 TEST_FUNCTION(read_beyond_eof_fails)
 {
     ///arrange
-    const int size = 5;
-
-    unsigned char source[] = "abcd";
+    unsigned char* source = aligned_block_create('a');
     WRITE_COMPLETE_CONTEXT write_context;
     write_context.pre_callback_value = 41;
     (void)interlocked_exchange(&write_context.value, write_context.pre_callback_value);
     write_context.post_callback_value = 42;
 
-    unsigned char destination[5];
+    unsigned char* destination = aligned_block_create(0);
     READ_COMPLETE_CONTEXT read_context;
     read_context.pre_callback_value = 43;
     (void)interlocked_exchange(&read_context.value, read_context.pre_callback_value);
     read_context.post_callback_value = 44;
 
-    uint32_t read_position = 5;
+    uint32_t read_position = TEST_BLOCK_SIZE;
 
     char filename[] = "read_beyond_eof_fails.txt";
     FILE_HANDLE file_handle = file_create_helper(filename);
 
-    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, size, 0, write_callback, &write_context));
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, TEST_BLOCK_SIZE, 0, write_callback, &write_context));
     
 
     wait_on_address_helper(&write_context.value, write_context.pre_callback_value, UINT32_MAX);
@@ -484,7 +502,7 @@ TEST_FUNCTION(read_beyond_eof_fails)
     ASSERT_IS_TRUE(write_context.did_write_succeed);
 
     ///act
-    file_read_async(file_handle, destination, sizeof(destination), read_position, read_callback, &read_context);
+    file_read_async(file_handle, destination, TEST_BLOCK_SIZE, read_position, read_callback, &read_context);
 
     ///assert
     wait_on_address_helper(&read_context.value, read_context.pre_callback_value, UINT32_MAX);
@@ -492,6 +510,8 @@ TEST_FUNCTION(read_beyond_eof_fails)
     ASSERT_IS_FALSE(read_context.did_read_succeed);
 
     //cleanup
+    gballoc_hl_aligned_free(destination);
+    gballoc_hl_aligned_free(source);
     file_destroy(file_handle);
     (void)delete_file(filename);
 }
@@ -521,7 +541,7 @@ TEST_FUNCTION(large_simultaneous_writes_succeed)
     ///act
     for (int i = 0; i < num_blocks; ++i)
     {
-        sources[i] = (unsigned char*)malloc(block_size);
+        sources[i] = (unsigned char*)gballoc_hl_aligned_malloc(block_size, block_size);
         ASSERT_IS_NOT_NULL(sources[i]);
         (void)memset(sources[i], 'a' + i, block_size);
         contexts[i].pre_callback_value = num_blocks + 1;
@@ -540,7 +560,7 @@ TEST_FUNCTION(large_simultaneous_writes_succeed)
     }
 
     ///assert
-    unsigned char* destination = (unsigned char*)malloc(block_size * num_blocks);
+    unsigned char* destination = (unsigned char*)gballoc_hl_aligned_malloc(block_size, block_size * num_blocks);
     ASSERT_IS_NOT_NULL(destination);
     READ_COMPLETE_CONTEXT read_context;
     read_context.pre_callback_value = 0;
@@ -559,10 +579,10 @@ TEST_FUNCTION(large_simultaneous_writes_succeed)
 
 
     //cleanup
-    free(destination);
+    gballoc_hl_aligned_free(destination);
     for (int i = 0; i < num_blocks; ++i)
     {
-        free(sources[i]);
+        gballoc_hl_aligned_free(sources[i]);
     }
     file_destroy(file_handle);
     (void)delete_file(filename);
@@ -585,7 +605,7 @@ TEST_FUNCTION(large_simultaneous_reads_succeed)
     ///arrange
     int block_size = 4096;
     int num_blocks = 50;
-    unsigned char* source = (unsigned char*)malloc(block_size*num_blocks);
+    unsigned char* source = (unsigned char*)gballoc_hl_aligned_malloc(block_size, block_size*num_blocks);
     ASSERT_IS_NOT_NULL(source);
 
     for (int i = 0; i < num_blocks; ++i)
@@ -613,7 +633,7 @@ TEST_FUNCTION(large_simultaneous_reads_succeed)
     ///act
     for (int i = 0; i < num_blocks; ++i)
     {
-        destinations[i] = (unsigned char*)malloc(block_size);
+        destinations[i] = (unsigned char*)gballoc_hl_aligned_malloc(block_size, block_size);
         ASSERT_IS_NOT_NULL(destinations[i]);
         contexts[i].pre_callback_value = num_blocks + 1;
         (void)interlocked_exchange(&contexts[i].value, contexts[i].pre_callback_value);
@@ -636,12 +656,215 @@ TEST_FUNCTION(large_simultaneous_reads_succeed)
     }
 
     //cleanup
-    free(source);
+    gballoc_hl_aligned_free(source);
+    for (int i = 0; i < num_blocks; ++i)
+    {
+        gballoc_hl_aligned_free(destinations[i]);
+    }
+    file_destroy(file_handle);
+    (void)delete_file(filename);
+}
+
+/*Tests_SRS_FILE_01_069: [ file_map_region shall map size bytes of the file starting at position as a read-only view and return a handle to it. ]*/
+/*Tests_SRS_FILE_01_073: [ file_mapped_region_get_data shall return a pointer to the byte of the view that corresponds to position in the file. ]*/
+/*Tests_SRS_FILE_01_075: [ file_unmap_region shall unmap the view and free region. ]*/
+TEST_FUNCTION(write_to_a_file_and_read_it_through_a_mapped_region)
+{
+    ///arrange
+    const uint32_t block_size = 4096;
+    const int num_blocks = 4;
+    unsigned char* source = (unsigned char*)gballoc_hl_aligned_malloc(block_size, block_size * num_blocks);
+    ASSERT_IS_NOT_NULL(source);
+    for (uint32_t i = 0; i < block_size * num_blocks; ++i)
+    {
+        source[i] = (unsigned char)(i % 251);
+    }
+
+    WRITE_COMPLETE_CONTEXT write_context;
+    write_context.pre_callback_value = 41;
+    (void)interlocked_exchange(&write_context.value, write_context.pre_callback_value);
+    write_context.post_callback_value = 42;
+
+    char filename[] = "write_to_a_file_and_read_it_through_a_mapped_region.txt";
+    FILE_HANDLE file_handle = file_create_helper(filename);
+
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, block_size * num_blocks, 0, write_callback, &write_context));
+    wait_on_address_helper(&write_context.value, write_context.pre_callback_value, UINT32_MAX);
+    ASSERT_IS_TRUE(write_context.did_write_succeed);
+
+    ///act
+    /*a region that does not start on a page boundary*/
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, block_size + 100, block_size, FILE_ACCESS_HINT_RANDOM);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(region);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(&source[block_size + 100], file_mapped_region_get_data(region), block_size));
+
+    /*a region past the end of the file cannot be mapped*/
+    ASSERT_IS_NULL(file_map_region(file_handle, block_size * num_blocks - 10, 11, FILE_ACCESS_HINT_NORMAL));
+
+    //cleanup
+    file_unmap_region(region);
+    gballoc_hl_aligned_free(source);
+    file_destroy(file_handle);
+    (void)delete_file(filename);
+}
+
+/*Tests_SRS_FILE_01_080: [ file_set_preallocation shall set chunk_size as the preallocation chunk size of handle and return 0. ]*/
+/*Tests_SRS_FILE_01_081: [ When a write started by file_write_async, file_write_async_v or file_batch_submit ends less than chunk_size / 2 bytes before the end of the reserved storage and no reservation is in progress, storage shall be reserved in the background, without changing the size of the file, up to chunk_size bytes past the end of the write. ]*/
+TEST_FUNCTION(appending_writes_with_a_preallocation_policy_succeed)
+{
+    ///arrange
+    const uint32_t block_size = 4096;
+    const int num_blocks = 64;
+    WRITE_COMPLETE_CONTEXT contexts[64];
+    unsigned char* source = (unsigned char*)gballoc_hl_aligned_malloc(block_size, block_size * num_blocks);
+    ASSERT_IS_NOT_NULL(source);
+    for (int i = 0; i < num_blocks; ++i)
+    {
+        (void)memset(&source[i * block_size], 'a' + (i % 26), block_size);
+    }
+
+    char filename[] = "appending_writes_with_a_preallocation_policy_succeed.txt";
+    FILE_HANDLE file_handle = file_create_helper(filename);
+    ASSERT_ARE_EQUAL(int, 0, file_set_preallocation(file_handle, 16 * block_size));
+
+    ///act
+    for (int i = 0; i < num_blocks; ++i)
+    {
+        contexts[i].pre_callback_value = num_blocks + 1;
+        (void)interlocked_exchange(&contexts[i].value, contexts[i].pre_callback_value);
+        contexts[i].post_callback_value = i;
+
+        ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, &source[i * block_size], block_size, (uint64_t)block_size * i, write_callback, &contexts[i]));
+    }
+
     for (int i = 0; i < num_blocks; ++i)
     {
-        free(destinations[i]);
+        wait_on_address_helper(&contexts[i].value, contexts[i].pre_callback_value, UINT32_MAX);
+        ASSERT_IS_TRUE(contexts[i].did_write_succeed);
+    }
+
+    ///assert
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, 0, block_size * num_blocks, FILE_ACCESS_HINT_SEQUENTIAL);
+    ASSERT_IS_NOT_NULL(region);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source, file_mapped_region_get_data(region), block_size * num_blocks));
+
+    /*the reserved storage does not change the size of the file*/
+    ASSERT_IS_NULL(file_map_region(file_handle, block_size * num_blocks - 10, 11, FILE_ACCESS_HINT_NORMAL));
+
+    //cleanup
+    file_unmap_region(region);
+    gballoc_hl_aligned_free(source);
+    file_destroy(file_handle);
+    (void)delete_file(filename);
+}
+/*Tests_SRS_FILE_01_089: [ When a write aggregation policy is set, file_write_async shall copy writes smaller than max_aggregated_size that continue the previous write or start at an aligned position into the aggregation buffer and return FILE_WRITE_ASYNC_OK. ]*/
+/*Tests_SRS_FILE_01_141: [ Aggregated writes shall not change data outside of the written ranges and shall not leave the file bigger than the end of the last byte written. ]*/
+TEST_FUNCTION(aggregated_appends_keep_the_size_of_the_file)
+{
+    ///arrange
+    const uint32_t block_size = 4096;
+    unsigned char* source = (unsigned char*)malloc(block_size);
+    ASSERT_IS_NOT_NULL(source);
+    for (uint32_t i = 0; i < block_size; ++i)
+    {
+        source[i] = (unsigned char)(i % 251);
+    }
+
+    WRITE_COMPLETE_CONTEXT contexts[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        contexts[i].pre_callback_value = 41;
+        (void)interlocked_exchange(&contexts[i].value, contexts[i].pre_callback_value);
+        contexts[i].post_callback_value = 42;
+    }
+
+    char filename[] = "aggregated_appends_keep_the_size_of_the_file.txt";
+    FILE_HANDLE file_handle = file_create_helper(filename);
+    ASSERT_ARE_EQUAL(int, 0, file_set_write_aggregation(file_handle, 16 * block_size, 10));
+
+    ///act
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, 100, 0, write_callback, &contexts[0]));
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, &source[100], 50, 100, write_callback, &contexts[1]));
+    for (int i = 0; i < 2; ++i)
+    {
+        wait_on_address_helper(&contexts[i].value, contexts[i].pre_callback_value, UINT32_MAX);
+        ASSERT_IS_TRUE(contexts[i].did_write_succeed);
     }
+
+    ///assert
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, 0, 150, FILE_ACCESS_HINT_NORMAL);
+    ASSERT_IS_NOT_NULL(region);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(source, file_mapped_region_get_data(region), 150));
+
+    /*the padding of the aggregated write is not part of the file*/
+    ASSERT_IS_NULL(file_map_region(file_handle, 140, 11, FILE_ACCESS_HINT_NORMAL));
+
+    //cleanup
+    file_unmap_region(region);
+    free(source);
     file_destroy(file_handle);
     (void)delete_file(filename);
 }
+
+/*Tests_SRS_FILE_01_136: [ file_copy_range_async shall start copying size bytes of source starting at source_position to destination starting at destination_position and return 0. ]*/
+/*Tests_SRS_FILE_01_137: [ When the copy ends, user_callback shall be called with user_context and is_successful as true if and only if all size bytes were copied. ]*/
+TEST_FUNCTION(copy_of_an_unaligned_range_copies_the_bytes)
+{
+    ///arrange
+    const uint32_t block_size = 4096;
+    const int num_blocks = 4;
+    /*no file system shares extents for ranges that are not aligned to its blocks, so the data is really moved, also where reflinks are supported*/
+    const uint64_t source_position = 100;
+    const uint64_t destination_position = 300;
+    const uint64_t size = 2 * block_size + 17;
+    unsigned char* source = (unsigned char*)gballoc_hl_aligned_malloc(block_size, block_size * num_blocks);
+    ASSERT_IS_NOT_NULL(source);
+    for (uint32_t i = 0; i < block_size * num_blocks; ++i)
+    {
+        source[i] = (unsigned char)(i % 251);
+    }
+
+    WRITE_COMPLETE_CONTEXT write_context;
+    write_context.pre_callback_value = 41;
+    (void)interlocked_exchange(&write_context.value, write_context.pre_callback_value);
+    write_context.post_callback_value = 42;
+
+    WRITE_COMPLETE_CONTEXT copy_context;
+    copy_context.pre_callback_value = 41;
+    (void)interlocked_exchange(&copy_context.value, copy_context.pre_callback_value);
+    copy_context.post_callback_value = 42;
+
+    char source_filename[] = "copy_of_an_unaligned_range_copies_the_bytes_source.txt";
+    char destination_filename[] = "copy_of_an_unaligned_range_copies_the_bytes_destination.txt";
+    FILE_HANDLE source_handle = file_create_helper(source_filename);
+    FILE_HANDLE destination_handle = file_create_helper(destination_filename);
+
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(source_handle, source, block_size * num_blocks, 0, write_callback, &write_context));
+    wait_on_address_helper(&write_context.value, write_context.pre_callback_value, UINT32_MAX);
+    ASSERT_IS_TRUE(write_context.did_write_succeed);
+
+    ///act
+    ASSERT_ARE_EQUAL(int, 0, file_copy_range_async(source_handle, source_position, destination_handle, destination_position, size, write_callback, &copy_context));
+    wait_on_address_helper(&copy_context.value, copy_context.pre_callback_value, UINT32_MAX);
+
+    ///assert
+    ASSERT_IS_TRUE(copy_context.did_write_succeed);
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(destination_handle, destination_position, (uint32_t)size, FILE_ACCESS_HINT_SEQUENTIAL);
+    ASSERT_IS_NOT_NULL(region);
+    ASSERT_ARE_EQUAL(int, 0, memcmp(&source[source_position], file_mapped_region_get_data(region), (size_t)size));
+
+    /*the copy ends the destination at the end of the range*/
+    ASSERT_IS_NULL(file_map_region(destination_handle, destination_position + size - 10, 11, FILE_ACCESS_HINT_NORMAL));
+
+    //cleanup
+    file_unmap_region(region);
+    gballoc_hl_aligned_free(source);
+    file_destroy(source_handle);
+    file_destroy(destination_handle);
+    (void)delete_file(source_filename);
+    (void)delete_file(destination_filename);
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
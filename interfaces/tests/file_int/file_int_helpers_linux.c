@@ -6,10 +6,17 @@
 #include <cstdlib>
 #else
 #include <stdlib.h>
+#include <stdbool.h>
 #endif
+#include <unistd.h>
 #include "file_int_helpers.h"
 
-void delete_all_txt_files()
+int delete_file(const char* filename)
 {
-    system("rm *.txt");
+    return unlink(filename);
+}
+
+bool check_file_exists(const char* filename)
+{
+    return access(filename, F_OK) == 0;
 }
@@ -0,0 +1,374 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cinttypes>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_logging/xlogging.h"
+#include "testrunnerswitcher.h"
+
+#include "c_pal/timer.h"
+#include "c_pal/sync.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/execution_engine.h"
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+
+#include "c_pal/file.h"
+
+/*every run keeps queue_depth I/Os in flight for FILE_PERF_RUN_DURATION_MS and then reports one line that starts with FILE_PERF_RESULT_TAG followed by a JSON object*/
+#define FILE_PERF_RESULT_TAG "FILE_PERF_RESULT"
+
+#define FILE_PERF_FILE_NAME "file_perf.bin"
+#define FILE_PERF_FILE_SIZE ((uint64_t)1024 * 1024 * 1024)
+#define FILE_PERF_PREPARE_BLOCK_SIZE (1024 * 1024)
+#define FILE_PERF_PREPARE_QUEUE_DEPTH 16
+#define FILE_PERF_RUN_DURATION_MS 1000
+#define FILE_PERF_MAX_IOS_PER_RUN (4 * 1024 * 1024)
+/*the Linux implementation opens the file with O_DIRECT*/
+#define FILE_PERF_BUFFER_ALIGNMENT 4096
+
+static const uint32_t queue_depths[] = { 1, 4, 16, 64, 256 };
+static const uint32_t block_sizes[] = { 4 * 1024, 64 * 1024, 1024 * 1024 };
+
+#define FILE_PERF_OPERATION_VALUES \
+    FILE_PERF_OPERATION_WRITE, \
+    FILE_PERF_OPERATION_READ
+
+MU_DEFINE_ENUM(FILE_PERF_OPERATION, FILE_PERF_OPERATION_VALUES)
+MU_DEFINE_ENUM_STRINGS(FILE_PERF_OPERATION, FILE_PERF_OPERATION_VALUES)
+
+#define FILE_PERF_PATTERN_VALUES \
+    FILE_PERF_PATTERN_SEQUENTIAL, \
+    FILE_PERF_PATTERN_RANDOM
+
+MU_DEFINE_ENUM(FILE_PERF_PATTERN, FILE_PERF_PATTERN_VALUES)
+MU_DEFINE_ENUM_STRINGS(FILE_PERF_PATTERN, FILE_PERF_PATTERN_VALUES)
+
+typedef struct FILE_PERF_RUN_TAG
+{
+    FILE_HANDLE file_handle;
+    FILE_PERF_OPERATION operation;
+    FILE_PERF_PATTERN pattern;
+    uint32_t block_size;
+    bool single_pass; /*when true the run stops once the sequential cursor reached the end of the file instead of after FILE_PERF_RUN_DURATION_MS*/
+    double end_time_ms;
+    volatile_atomic int64_t next_sequential_position;
+    volatile_atomic int32_t pending_ios;
+    volatile_atomic int32_t completed_ios;
+    volatile_atomic int32_t failed_ios;
+    double* latencies_us;
+} FILE_PERF_RUN;
+
+typedef struct FILE_PERF_IO_TAG
+{
+    FILE_PERF_RUN* run;
+    unsigned char* buffer;
+    uint64_t random_state;
+    double start_time_us;
+} FILE_PERF_IO;
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+static EXECUTION_ENGINE_HANDLE execution_engine;
+
+static uint64_t xorshift64(uint64_t* state)
+{
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+    return x;
+}
+
+static bool get_next_position(FILE_PERF_IO* io, uint64_t* position)
+{
+    bool result;
+    FILE_PERF_RUN* run = io->run;
+    uint64_t block_count = FILE_PERF_FILE_SIZE / run->block_size;
+
+    if (run->pattern == FILE_PERF_PATTERN_RANDOM)
+    {
+        *position = (xorshift64(&io->random_state) % block_count) * run->block_size;
+        result = true;
+    }
+    else
+    {
+        uint64_t block_index = (uint64_t)interlocked_increment_64(&run->next_sequential_position) - 1;
+        if (run->single_pass && (block_index >= block_count))
+        {
+            result = false;
+        }
+        else
+        {
+            *position = (block_index % block_count) * run->block_size;
+            result = true;
+        }
+    }
+
+    return result;
+}
+
+static void on_io_complete(void* context, bool is_successful);
+
+static bool start_io(FILE_PERF_IO* io)
+{
+    bool result;
+    FILE_PERF_RUN* run = io->run;
+    uint64_t position;
+
+    if (
+        (!run->single_pass && (timer_global_get_elapsed_ms() >= run->end_time_ms)) ||
+        (interlocked_add(&run->completed_ios, 0) >= FILE_PERF_MAX_IOS_PER_RUN) ||
+        !get_next_position(io, &position)
+        )
+    {
+        result = false;
+    }
+    else
+    {
+        io->start_time_us = timer_global_get_elapsed_us();
+        if (run->operation == FILE_PERF_OPERATION_WRITE)
+        {
+            result = (file_write_async(run->file_handle, io->buffer, run->block_size, position, on_io_complete, io) == FILE_WRITE_ASYNC_OK);
+        }
+        else
+        {
+            result = (file_read_async(run->file_handle, io->buffer, run->block_size, position, on_io_complete, io) == FILE_READ_ASYNC_OK);
+        }
+
+        if (!result)
+        {
+            LogError("Starting %" PRI_MU_ENUM " of %" PRIu32 " bytes at %" PRIu64 " failed",
+                MU_ENUM_VALUE(FILE_PERF_OPERATION, run->operation), run->block_size, position);
+            (void)interlocked_increment(&run->failed_ios);
+        }
+    }
+
+    return result;
+}
+
+static void retire_io(FILE_PERF_RUN* run)
+{
+    if (interlocked_decrement(&run->pending_ios) == 0)
+    {
+        wake_by_address_single(&run->pending_ios);
+    }
+}
+
+static void on_io_complete(void* context, bool is_successful)
+{
+    FILE_PERF_IO* io = (FILE_PERF_IO*)context;
+    FILE_PERF_RUN* run = io->run;
+    double latency_us = timer_global_get_elapsed_us() - io->start_time_us;
+
+    int32_t index = interlocked_increment(&run->completed_ios) - 1;
+    if (index < FILE_PERF_MAX_IOS_PER_RUN)
+    {
+        run->latencies_us[index] = latency_us;
+    }
+
+    if (!is_successful)
+    {
+        (void)interlocked_increment(&run->failed_ios);
+    }
+
+    /*the I/O keeps its slot in the queue until the run is over*/
+    if (!start_io(io))
+    {
+        retire_io(run);
+    }
+}
+
+static int compare_doubles(const void* left, const void* right)
+{
+    double left_value = *(const double*)left;
+    double right_value = *(const double*)right;
+    return (left_value > right_value) - (left_value < right_value);
+}
+
+static double get_percentile(const double* sorted_values, uint32_t count, double percentile)
+{
+    return (count == 0) ? 0.0 : sorted_values[(uint32_t)((count - 1) * percentile / 100.0)];
+}
+
+static void run_file_perf(FILE_HANDLE file_handle, FILE_PERF_OPERATION operation, FILE_PERF_PATTERN pattern, uint32_t queue_depth, uint32_t block_size, bool single_pass)
+{
+    ///arrange
+    uint32_t i;
+    FILE_PERF_RUN run;
+    run.file_handle = file_handle;
+    run.operation = operation;
+    run.pattern = pattern;
+    run.block_size = block_size;
+    run.single_pass = single_pass;
+    (void)interlocked_exchange_64(&run.next_sequential_position, 0);
+    (void)interlocked_exchange(&run.pending_ios, (int32_t)queue_depth);
+    (void)interlocked_exchange(&run.completed_ios, 0);
+    (void)interlocked_exchange(&run.failed_ios, 0);
+    run.latencies_us = malloc(sizeof(double) * FILE_PERF_MAX_IOS_PER_RUN);
+    ASSERT_IS_NOT_NULL(run.latencies_us);
+
+    FILE_PERF_IO* ios = malloc(sizeof(FILE_PERF_IO) * queue_depth);
+    ASSERT_IS_NOT_NULL(ios);
+
+    for (i = 0; i < queue_depth; i++)
+    {
+        ios[i].run = &run;
+        ios[i].random_state = 0x9E3779B97F4A7C15ULL * (i + 1);
+        ios[i].buffer = gballoc_hl_aligned_malloc(FILE_PERF_BUFFER_ALIGNMENT, block_size);
+        ASSERT_IS_NOT_NULL(ios[i].buffer);
+        (void)memset(ios[i].buffer, (int)('a' + (i % 26)), block_size);
+    }
+
+    double start_time_ms = timer_global_get_elapsed_ms();
+    run.end_time_ms = start_time_ms + FILE_PERF_RUN_DURATION_MS;
+
+    ///act
+    for (i = 0; i < queue_depth; i++)
+    {
+        if (!start_io(&ios[i]))
+        {
+            retire_io(&run);
+        }
+    }
+
+    int32_t pending_ios;
+    while ((pending_ios = interlocked_add(&run.pending_ios, 0)) != 0)
+    {
+        (void)wait_on_address(&run.pending_ios, pending_ios, UINT32_MAX);
+    }
+
+    double elapsed_ms = timer_global_get_elapsed_ms() - start_time_ms;
+
+    ///assert
+    ASSERT_ARE_EQUAL(int32_t, 0, interlocked_add(&run.failed_ios, 0));
+
+    int32_t completed_ios = interlocked_add(&run.completed_ios, 0);
+    uint32_t latency_count = (completed_ios < FILE_PERF_MAX_IOS_PER_RUN) ? (uint32_t)completed_ios : FILE_PERF_MAX_IOS_PER_RUN;
+    qsort(run.latencies_us, latency_count, sizeof(double), compare_doubles);
+
+    double iops = (elapsed_ms > 0) ? (completed_ios * 1000.0 / elapsed_ms) : 0.0;
+    double mb_per_second = iops * block_size / (1024.0 * 1024.0);
+
+    if (!single_pass)
+    {
+        LogInfo(FILE_PERF_RESULT_TAG " {\"operation\":\"%s\",\"pattern\":\"%s\",\"queue_depth\":%" PRIu32 ",\"block_size\":%" PRIu32 ",\"ios\":%" PRId32 ",\"elapsed_ms\":%.3f,\"iops\":%.1f,\"mb_per_second\":%.2f,"
+            "\"latency_us\":{\"min\":%.1f,\"p50\":%.1f,\"p90\":%.1f,\"p99\":%.1f,\"p99_9\":%.1f,\"max\":%.1f}}",
+            (operation == FILE_PERF_OPERATION_WRITE) ? "write" : "read",
+            (pattern == FILE_PERF_PATTERN_SEQUENTIAL) ? "sequential" : "random",
+            queue_depth, block_size, completed_ios, elapsed_ms, iops, mb_per_second,
+            get_percentile(run.latencies_us, latency_count, 0),
+            get_percentile(run.latencies_us, latency_count, 50),
+            get_percentile(run.latencies_us, latency_count, 90),
+            get_percentile(run.latencies_us, latency_count, 99),
+            get_percentile(run.latencies_us, latency_count, 99.9),
+            get_percentile(run.latencies_us, latency_count, 100));
+    }
+
+    ///cleanup
+    for (i = 0; i < queue_depth; i++)
+    {
+        gballoc_hl_aligned_free(ios[i].buffer);
+    }
+    free(ios);
+    free(run.latencies_us);
+}
+
+static FILE_HANDLE create_prepared_file(void)
+{
+    FILE_HANDLE file_handle = file_create(execution_engine, FILE_PERF_FILE_NAME, NULL, NULL);
+    ASSERT_IS_NOT_NULL(file_handle);
+
+    /*write the whole file once so that reads do not hit holes and writes do not extend the file*/
+    run_file_perf(file_handle, FILE_PERF_OPERATION_WRITE, FILE_PERF_PATTERN_SEQUENTIAL, FILE_PERF_PREPARE_QUEUE_DEPTH, FILE_PERF_PREPARE_BLOCK_SIZE, true);
+
+    return file_handle;
+}
+
+static void run_file_perf_matrix(FILE_PERF_OPERATION operation, FILE_PERF_PATTERN pattern)
+{
+    FILE_HANDLE file_handle = create_prepared_file();
+
+    for (uint32_t i = 0; i < MU_COUNT_ARRAY_ITEMS(block_sizes); i++)
+    {
+        for (uint32_t j = 0; j < MU_COUNT_ARRAY_ITEMS(queue_depths); j++)
+        {
+            run_file_perf(file_handle, operation, pattern, queue_depths[j], block_sizes[i], false);
+        }
+    }
+
+    file_destroy(file_handle);
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    execution_engine = execution_engine_create(NULL);
+    ASSERT_IS_NOT_NULL(execution_engine);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    execution_engine_dec_ref(execution_engine);
+    (void)remove(FILE_PERF_FILE_NAME);
+
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+TEST_FUNCTION(file_perf_sequential_writes)
+{
+    run_file_perf_matrix(FILE_PERF_OPERATION_WRITE, FILE_PERF_PATTERN_SEQUENTIAL);
+}
+
+TEST_FUNCTION(file_perf_random_writes)
+{
+    run_file_perf_matrix(FILE_PERF_OPERATION_WRITE, FILE_PERF_PATTERN_RANDOM);
+}
+
+TEST_FUNCTION(file_perf_sequential_reads)
+{
+    run_file_perf_matrix(FILE_PERF_OPERATION_READ, FILE_PERF_PATTERN_SEQUENTIAL);
+}
+
+TEST_FUNCTION(file_perf_random_reads)
+{
+    run_file_perf_matrix(FILE_PERF_OPERATION_READ, FILE_PERF_PATTERN_RANDOM);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -63,4 +63,49 @@ TEST_FUNCTION(sysinfo_get_processor_count_returns_processor_count)
 /* Tests_SRS_SYSINFO_01_002: [ If any error occurs, `sysinfo_get_processor_count` shall return 0. ]*/
 /* Can't really be induced on "any" platform, tested independently for each psupported platform */
 
+/* sysinfo_get_numa_node_count */
+
+/* Tests_SRS_SYSINFO_01_003: [ sysinfo_get_numa_node_count shall obtain the number of NUMA nodes as reported by the operating system. ]*/
+/* Tests_SRS_SYSINFO_01_004: [ If the host is not NUMA or any error occurs, sysinfo_get_numa_node_count shall return 1. ]*/
+TEST_FUNCTION(sysinfo_get_numa_node_count_returns_at_least_1)
+{
+    ///arrange
+
+    ///act
+    uint32_t numa_node_count = sysinfo_get_numa_node_count();
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(uint32_t, 0, numa_node_count);
+}
+
+/* sysinfo_get_current_numa_node */
+
+/* Tests_SRS_SYSINFO_01_005: [ sysinfo_get_current_numa_node shall obtain the NUMA node of the processor the calling thread is running on as reported by the operating system. ]*/
+TEST_FUNCTION(sysinfo_get_current_numa_node_returns_a_node_less_than_the_node_count)
+{
+    ///arrange
+    uint32_t numa_node_count = sysinfo_get_numa_node_count();
+
+    ///act
+    uint32_t numa_node = sysinfo_get_current_numa_node();
+
+    ///assert
+    ASSERT_IS_TRUE(numa_node < numa_node_count);
+}
+
+/* sysinfo_get_current_processor */
+
+/* Tests_SRS_SYSINFO_01_007: [ sysinfo_get_current_processor shall obtain the processor the calling thread is running on as reported by the operating system. ]*/
+TEST_FUNCTION(sysinfo_get_current_processor_does_not_crash)
+{
+    ///arrange
+
+    ///act
+    uint32_t processor = sysinfo_get_current_processor();
+
+    ///assert
+    /*processors can be numbered sparsely (e.g. offline CPUs or processor groups), so only the call is checked*/
+    (void)processor;
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,55 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef EXECUTION_ENGINE_LINUX_H
+#define EXECUTION_ENGINE_LINUX_H
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+#include "c_pal/execution_engine.h"
+#include "c_pal/io_admission.h"
+#include "c_pal/io_ring_linux.h"
+#include "c_pal/worker_pool_linux.h"
+#include "c_pal/timer_wheel_linux.h"
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+    typedef struct EXECUTION_ENGINE_PARAMETERS_LINUX_TAG
+    {
+        uint32_t min_thread_count;
+        uint32_t max_thread_count;
+        uint32_t max_outstanding_io;
+        size_t stack_size;
+        uint32_t cpu_count;
+        const uint32_t* cpus;
+        uint32_t idle_timeout_ms;
+        uint32_t max_injected_thread_count;
+    } EXECUTION_ENGINE_PARAMETERS_LINUX;
+
+#define DEFAULT_MIN_THREAD_COUNT 4
+#define DEFAULT_MAX_THREAD_COUNT 0 // as many threads as processors the threads can run on
+#define DEFAULT_MAX_OUTSTANDING_IO 0 // no limit on the outstanding file I/Os
+#define DEFAULT_STACK_SIZE 0 // default pthread stack size
+#define DEFAULT_IDLE_TIMEOUT_MS 20000 // worker threads above min_thread_count exit after being idle for 20 seconds
+#define DEFAULT_MAX_INJECTED_THREAD_COUNT 0 // no worker threads above max_thread_count
+
+MOCKABLE_FUNCTION(, IO_RING_LINUX_HANDLE, execution_engine_linux_get_io_ring, EXECUTION_ENGINE_HANDLE, execution_engine);
+MOCKABLE_FUNCTION(, IO_ADMISSION_HANDLE, execution_engine_linux_get_io_admission, EXECUTION_ENGINE_HANDLE, execution_engine);
+MOCKABLE_FUNCTION(, WORKER_POOL_LINUX_HANDLE, execution_engine_linux_get_worker_pool, EXECUTION_ENGINE_HANDLE, execution_engine);
+MOCKABLE_FUNCTION(, TIMER_WHEEL_LINUX_HANDLE, execution_engine_linux_get_timer_wheel, EXECUTION_ENGINE_HANDLE, execution_engine);
+MOCKABLE_FUNCTION(, WORKER_POOL_LINUX_HANDLE, execution_engine_linux_get_numa_node_worker_pool, EXECUTION_ENGINE_HANDLE, execution_engine, uint32_t, numa_node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EXECUTION_ENGINE_LINUX_H
@@ -0,0 +1,57 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef IO_RING_LINUX_H
+#define IO_RING_LINUX_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define IO_RING_LINUX_DEFAULT_ENTRIES 1024
+
+typedef struct IO_RING_LINUX_TAG* IO_RING_LINUX_HANDLE;
+
+/*result is the res field of the completion queue entry: number of bytes transferred or -errno*/
+typedef void(*IO_RING_LINUX_ON_IO_COMPLETE)(void* context, int32_t result);
+
+/*to be embedded by the caller in its per-I/O context, it must stay valid until on_io_complete is called*/
+typedef struct IO_RING_LINUX_IO_TAG
+{
+    IO_RING_LINUX_ON_IO_COMPLETE on_io_complete;
+    void* on_io_complete_context;
+} IO_RING_LINUX_IO;
+
+typedef struct IO_RING_LINUX_SQE_TAG
+{
+    uint8_t opcode; /*one of the IORING_OP_* values*/
+    uint16_t ioprio;
+    int32_t fd;
+    uint64_t offset;
+    void* address;
+    uint32_t length;
+    uint32_t op_flags; /*rw_flags, fsync_flags, splice_flags etc., depending on opcode*/
+    IO_RING_LINUX_IO* io;
+    /*IORING_OP_SPLICE only: the data is moved from splice_fd_in at splice_offset_in (-1 for a pipe) to fd at offset (-1 for a pipe)*/
+    int32_t splice_fd_in;
+    uint64_t splice_offset_in;
+} IO_RING_LINUX_SQE;
+
+MOCKABLE_FUNCTION(, IO_RING_LINUX_HANDLE, io_ring_linux_create, uint32_t, entries);
+MOCKABLE_FUNCTION(, void, io_ring_linux_destroy, IO_RING_LINUX_HANDLE, io_ring);
+
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, io_ring_linux_submit, IO_RING_LINUX_HANDLE, io_ring, const IO_RING_LINUX_SQE*, sqes, uint32_t, sqe_count, uint32_t*, submitted_count)(0, MU_FAILURE);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IO_RING_LINUX_H
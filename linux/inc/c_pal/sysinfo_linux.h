@@ -0,0 +1,29 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef SYSINFO_LINUX_H
+#define SYSINFO_LINUX_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_pal/sysinfo.h"
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*fills cpus with the CPUs of numa_node, cpu_count is 0 for a node without CPUs*/
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, sysinfo_linux_get_numa_node_cpus, uint32_t, numa_node, uint32_t*, cpus, uint32_t, cpu_capacity, uint32_t*, cpu_count)(0, MU_FAILURE);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SYSINFO_LINUX_H
@@ -0,0 +1,55 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef TIMER_WHEEL_LINUX_H
+#define TIMER_WHEEL_LINUX_H
+
+#ifdef __cplusplus
+#include <cstdint>
+#else
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "c_pal/interlocked.h"
+#include "c_pal/worker_pool_linux.h"
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct TIMER_WHEEL_LINUX_TAG* TIMER_WHEEL_LINUX_HANDLE;
+
+typedef void(*TIMER_WHEEL_LINUX_ON_TIMER_EXPIRED)(void* context);
+
+/*to be embedded by the caller in its timer context, it must stay valid until timer_wheel_linux_timer_cancel returns*/
+typedef struct TIMER_WHEEL_LINUX_TIMER_TAG
+{
+    /*the fields below are owned by the timer wheel*/
+    struct TIMER_WHEEL_LINUX_TIMER_TAG* next;
+    struct TIMER_WHEEL_LINUX_TIMER_TAG** pprev; /*NULL when the timer is not in the wheel*/
+    uint64_t expire_tick;
+    uint64_t due_tick; /*the tick the timer is due at, expire_tick is up to tolerance_ms later*/
+    uint32_t period_ms;
+    uint32_t tolerance_ms;
+    uint16_t slot;
+    volatile_atomic int32_t callback_state;
+    WORKER_POOL_LINUX_WORK_ITEM work_item;
+    TIMER_WHEEL_LINUX_ON_TIMER_EXPIRED on_timer_expired;
+    void* on_timer_expired_context;
+} TIMER_WHEEL_LINUX_TIMER;
+
+MOCKABLE_FUNCTION(, TIMER_WHEEL_LINUX_HANDLE, timer_wheel_linux_create, WORKER_POOL_LINUX_HANDLE, worker_pool);
+MOCKABLE_FUNCTION(, void, timer_wheel_linux_destroy, TIMER_WHEEL_LINUX_HANDLE, timer_wheel);
+
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, timer_wheel_linux_timer_init, TIMER_WHEEL_LINUX_TIMER*, timer, WORKER_POOL_LINUX_PRIORITY, priority, TIMER_WHEEL_LINUX_ON_TIMER_EXPIRED, on_timer_expired, void*, on_timer_expired_context)(0, MU_FAILURE);
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, timer_wheel_linux_timer_start, TIMER_WHEEL_LINUX_HANDLE, timer_wheel, TIMER_WHEEL_LINUX_TIMER*, timer, uint32_t, start_delay_ms, uint32_t, period_ms, uint32_t, tolerance_ms)(0, MU_FAILURE);
+MOCKABLE_FUNCTION(, void, timer_wheel_linux_timer_cancel, TIMER_WHEEL_LINUX_HANDLE, timer_wheel, TIMER_WHEEL_LINUX_TIMER*, timer);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TIMER_WHEEL_LINUX_H
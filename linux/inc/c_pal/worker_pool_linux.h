@@ -0,0 +1,79 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#ifndef WORKER_POOL_LINUX_H
+#define WORKER_POOL_LINUX_H
+
+#ifdef __cplusplus
+#include <cstddef>
+#include <cstdint>
+#else
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct WORKER_POOL_LINUX_TAG* WORKER_POOL_LINUX_HANDLE;
+
+typedef void(*WORKER_POOL_LINUX_WORK_FUNCTION)(void* context);
+
+/*WORKER_POOL_LINUX_PRIORITY_HIGH work items run before any other queued work item*/
+/*WORKER_POOL_LINUX_PRIORITY_LOW work items run when no other work item is queued, and every now and then so that they are not starved*/
+#define WORKER_POOL_LINUX_PRIORITY_VALUES \
+    WORKER_POOL_LINUX_PRIORITY_HIGH, \
+    WORKER_POOL_LINUX_PRIORITY_NORMAL, \
+    WORKER_POOL_LINUX_PRIORITY_LOW
+MU_DEFINE_ENUM(WORKER_POOL_LINUX_PRIORITY, WORKER_POOL_LINUX_PRIORITY_VALUES);
+
+/*the work item memory is owned by the caller and has to stay valid until work_function is called*/
+/*the worker pool does not touch the work item after calling work_function, so work_function is free to reuse or free it*/
+typedef struct WORKER_POOL_LINUX_WORK_ITEM_TAG
+{
+    WORKER_POOL_LINUX_WORK_FUNCTION work_function;
+    void* work_function_context;
+    WORKER_POOL_LINUX_PRIORITY priority;
+    struct WORKER_POOL_LINUX_WORK_ITEM_TAG* next; /*used by the worker pool while the work item is queued*/
+} WORKER_POOL_LINUX_WORK_ITEM;
+
+typedef struct WORKER_POOL_LINUX_PARAMETERS_TAG
+{
+    uint32_t min_thread_count;
+    uint32_t max_thread_count;
+    size_t stack_size; /*0 for the default pthread stack size*/
+    uint32_t cpu_count; /*0 for no affinity*/
+    const uint32_t* cpus; /*the CPUs the worker threads are allowed to run on*/
+    uint32_t idle_timeout_ms; /*worker threads above min_thread_count exit after being idle that long, 0 for worker threads to never exit*/
+    uint32_t max_injected_thread_count; /*worker threads that can be started above max_thread_count while queued work items make no progress, 0 for none*/
+} WORKER_POOL_LINUX_PARAMETERS;
+
+typedef struct WORKER_POOL_LINUX_STATISTICS_TAG
+{
+    uint32_t thread_count; /*started worker threads*/
+    uint32_t idle_thread_count;
+    uint32_t peak_thread_count;
+    uint64_t started_thread_count; /*worker threads started since the worker pool was created*/
+    uint64_t injected_thread_count; /*worker threads started because queued work items made no progress, included in started_thread_count*/
+    uint64_t retired_thread_count; /*worker threads that exited after being idle for idle_timeout_ms*/
+} WORKER_POOL_LINUX_STATISTICS;
+
+MOCKABLE_FUNCTION(, WORKER_POOL_LINUX_HANDLE, worker_pool_linux_create, const WORKER_POOL_LINUX_PARAMETERS*, parameters);
+MOCKABLE_FUNCTION(, void, worker_pool_linux_destroy, WORKER_POOL_LINUX_HANDLE, worker_pool);
+
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, worker_pool_linux_submit, WORKER_POOL_LINUX_HANDLE, worker_pool, WORKER_POOL_LINUX_WORK_ITEM*, work_item)(0, MU_FAILURE);
+/*work_items is a list linked through next and terminated by NULL, all the work items have the same priority*/
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, worker_pool_linux_submit_batch, WORKER_POOL_LINUX_HANDLE, worker_pool, WORKER_POOL_LINUX_WORK_ITEM*, work_items)(0, MU_FAILURE);
+/*the counts are read one at a time, so they are a snapshot that can be off while worker threads start or park*/
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, worker_pool_linux_get_thread_counts, WORKER_POOL_LINUX_HANDLE, worker_pool, uint32_t*, thread_count, uint32_t*, idle_thread_count)(0, MU_FAILURE);
+MOCKABLE_FUNCTION_WITH_RETURNS(, int, worker_pool_linux_get_statistics, WORKER_POOL_LINUX_HANDLE, worker_pool, WORKER_POOL_LINUX_STATISTICS*, statistics)(0, MU_FAILURE);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WORKER_POOL_LINUX_H
@@ -0,0 +1,8 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include "real_gballoc_hl_renames.h" // IWYU pragma: keep
+
+#include "real_srw_lock_renames.h" // IWYU pragma: keep
+
+#include "../src/srw_lock_linux.c"
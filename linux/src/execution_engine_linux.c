@@ -0,0 +1,463 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/refcount.h"
+#include "c_pal/call_once.h"
+#include "c_pal/lazy_init.h"
+#include "c_pal/sysinfo.h"
+#include "c_pal/sysinfo_linux.h"
+#include "c_pal/io_ring_linux.h"
+#include "c_pal/io_admission.h"
+#include "c_pal/worker_pool_linux.h"
+#include "c_pal/timer_wheel_linux.h"
+
+#include "c_pal/execution_engine.h"
+#include "c_pal/execution_engine_linux.h"
+
+typedef struct NUMA_NODE_WORKER_POOL_TAG
+{
+    struct EXECUTION_ENGINE_TAG* execution_engine;
+    uint32_t numa_node;
+    call_once_t worker_pool_init;
+    WORKER_POOL_LINUX_HANDLE worker_pool;
+} NUMA_NODE_WORKER_POOL;
+
+typedef struct EXECUTION_ENGINE_TAG
+{
+    call_once_t io_ring_init;
+    IO_RING_LINUX_HANDLE io_ring;
+    IO_ADMISSION_HANDLE io_admission;
+    WORKER_POOL_LINUX_HANDLE worker_pool;
+    call_once_t timer_wheel_init;
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel;
+    uint32_t min_thread_count;
+    uint32_t max_thread_count;
+    size_t stack_size;
+    uint32_t idle_timeout_ms;
+    uint32_t max_injected_thread_count;
+    uint32_t numa_node_count;
+    NUMA_NODE_WORKER_POOL numa_node_worker_pools[]; /*numa_node_count entries, none on hosts with a single NUMA node*/
+}EXECUTION_ENGINE;
+
+DEFINE_REFCOUNT_TYPE(EXECUTION_ENGINE);
+
+static int create_io_ring(void* params)
+{
+    int result;
+    EXECUTION_ENGINE* execution_engine = params;
+
+    /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_008: [ The first call to execution_engine_linux_get_io_ring shall create the ring by calling io_ring_linux_create with IO_RING_LINUX_DEFAULT_ENTRIES. ]*/
+    execution_engine->io_ring = io_ring_linux_create(IO_RING_LINUX_DEFAULT_ENTRIES);
+    if (execution_engine->io_ring == NULL)
+    {
+        LogError("io_ring_linux_create(%" PRIu32 ") failed", (uint32_t)IO_RING_LINUX_DEFAULT_ENTRIES);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+static int create_timer_wheel(void* params)
+{
+    int result;
+    EXECUTION_ENGINE* execution_engine = params;
+
+    /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_026: [ The first call to execution_engine_linux_get_timer_wheel shall create the timer wheel by calling timer_wheel_linux_create with the worker pool of the execution engine. ]*/
+    execution_engine->timer_wheel = timer_wheel_linux_create(execution_engine->worker_pool);
+    if (execution_engine->timer_wheel == NULL)
+    {
+        LogError("timer_wheel_linux_create(%p) failed", execution_engine->worker_pool);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        result = 0;
+    }
+
+    return result;
+}
+
+static uint32_t divide_round_up(uint32_t value, uint32_t divisor)
+{
+    return (value / divisor) + (((value % divisor) == 0) ? 0 : 1);
+}
+
+static int create_numa_node_worker_pool(void* params)
+{
+    int result;
+    NUMA_NODE_WORKER_POOL* numa_node_worker_pool = params;
+    EXECUTION_ENGINE* execution_engine = numa_node_worker_pool->execution_engine;
+
+    /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_036: [ The first call for a node shall obtain the CPUs of the node by calling sysinfo_linux_get_numa_node_cpus with room for as many CPUs as returned by sysinfo_get_processor_count. ]*/
+    uint32_t processor_count = sysinfo_get_processor_count();
+    if (processor_count == 0)
+    {
+        LogError("sysinfo_get_processor_count failed");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        uint32_t* cpus = malloc(processor_count * sizeof(uint32_t));
+        if (cpus == NULL)
+        {
+            LogError("malloc(%zu) failed", processor_count * sizeof(uint32_t));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            WORKER_POOL_LINUX_PARAMETERS worker_pool_parameters;
+
+            if (sysinfo_linux_get_numa_node_cpus(numa_node_worker_pool->numa_node, cpus, processor_count, &worker_pool_parameters.cpu_count) != 0)
+            {
+                LogError("sysinfo_linux_get_numa_node_cpus(numa_node=%" PRIu32 ", cpu_capacity=%" PRIu32 ") failed", numa_node_worker_pool->numa_node, processor_count);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_037: [ The first call for a node shall create the worker threads of the node by calling worker_pool_linux_create with the CPUs of the node, stack_size, idle_timeout_ms and min_thread_count, max_thread_count and max_injected_thread_count divided by the number of nodes, rounded up. ]*/
+                worker_pool_parameters.min_thread_count = divide_round_up(execution_engine->min_thread_count, execution_engine->numa_node_count);
+                worker_pool_parameters.max_thread_count = divide_round_up(execution_engine->max_thread_count, execution_engine->numa_node_count);
+                worker_pool_parameters.stack_size = execution_engine->stack_size;
+                worker_pool_parameters.cpus = cpus;
+                worker_pool_parameters.idle_timeout_ms = execution_engine->idle_timeout_ms;
+                worker_pool_parameters.max_injected_thread_count = divide_round_up(execution_engine->max_injected_thread_count, execution_engine->numa_node_count);
+
+                numa_node_worker_pool->worker_pool = worker_pool_linux_create(&worker_pool_parameters);
+                if (numa_node_worker_pool->worker_pool == NULL)
+                {
+                    LogError("worker_pool_linux_create(numa_node=%" PRIu32 ", min_thread_count=%" PRIu32 ", max_thread_count=%" PRIu32 ", cpu_count=%" PRIu32 ") failed",
+                        numa_node_worker_pool->numa_node, worker_pool_parameters.min_thread_count, worker_pool_parameters.max_thread_count, worker_pool_parameters.cpu_count);
+                    result = MU_FAILURE;
+                }
+                else
+                {
+                    result = 0;
+                }
+            }
+
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_038: [ The CPUs of the node shall be freed once the worker threads of the node are created. ]*/
+            free(cpus);
+        }
+    }
+
+    return result;
+}
+
+EXECUTION_ENGINE_HANDLE execution_engine_create(void* execution_engine_parameters)
+{
+    EXECUTION_ENGINE_HANDLE result;
+    EXECUTION_ENGINE_PARAMETERS_LINUX parameters_to_use;
+
+    if (execution_engine_parameters == NULL)
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_001: [ If execution_engine_parameters is NULL, execution_engine_create shall use the defaults DEFAULT_MIN_THREAD_COUNT, DEFAULT_MAX_THREAD_COUNT, DEFAULT_MAX_OUTSTANDING_IO, DEFAULT_STACK_SIZE, DEFAULT_IDLE_TIMEOUT_MS and DEFAULT_MAX_INJECTED_THREAD_COUNT, with no CPU affinity, as parameters. ]*/
+        parameters_to_use.min_thread_count = DEFAULT_MIN_THREAD_COUNT;
+        parameters_to_use.max_thread_count = DEFAULT_MAX_THREAD_COUNT;
+        parameters_to_use.max_outstanding_io = DEFAULT_MAX_OUTSTANDING_IO;
+        parameters_to_use.stack_size = DEFAULT_STACK_SIZE;
+        parameters_to_use.cpu_count = 0;
+        parameters_to_use.cpus = NULL;
+        parameters_to_use.idle_timeout_ms = DEFAULT_IDLE_TIMEOUT_MS;
+        parameters_to_use.max_injected_thread_count = DEFAULT_MAX_INJECTED_THREAD_COUNT;
+    }
+    else
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_013: [ execution_engine_parameters shall be interpreted as EXECUTION_ENGINE_PARAMETERS_LINUX. ]*/
+        EXECUTION_ENGINE_PARAMETERS_LINUX* execution_engine_parameters_linux = (EXECUTION_ENGINE_PARAMETERS_LINUX*)execution_engine_parameters;
+
+        parameters_to_use = *execution_engine_parameters_linux;
+    }
+
+    /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_030: [ execution_engine_create shall obtain the number of NUMA nodes of the host by calling sysinfo_get_numa_node_count. ]*/
+    uint32_t numa_node_count = sysinfo_get_numa_node_count();
+
+    /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_002: [ execution_engine_create shall allocate a new execution engine and on success shall return a non-NULL handle. ]*/
+    /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_031: [ If there is more than one NUMA node, execution_engine_create shall allocate a NUMA node worker group for each node. ]*/
+    result = REFCOUNT_TYPE_CREATE_WITH_EXTRA_SIZE(EXECUTION_ENGINE, (numa_node_count > 1) ? (size_t)numa_node_count * sizeof(NUMA_NODE_WORKER_POOL) : 0);
+    if (result == NULL)
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_003: [ If any error occurs, execution_engine_create shall fail and return NULL. ]*/
+        LogError("REFCOUNT_TYPE_CREATE failed.");
+    }
+    else
+    {
+        WORKER_POOL_LINUX_PARAMETERS worker_pool_parameters;
+        worker_pool_parameters.min_thread_count = parameters_to_use.min_thread_count;
+        worker_pool_parameters.max_thread_count = parameters_to_use.max_thread_count;
+        worker_pool_parameters.stack_size = parameters_to_use.stack_size;
+        worker_pool_parameters.cpu_count = parameters_to_use.cpu_count;
+        worker_pool_parameters.cpus = parameters_to_use.cpus;
+        worker_pool_parameters.idle_timeout_ms = parameters_to_use.idle_timeout_ms;
+        worker_pool_parameters.max_injected_thread_count = parameters_to_use.max_injected_thread_count;
+
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_019: [ execution_engine_create shall create the worker threads of the execution engine by calling worker_pool_linux_create with min_thread_count, max_thread_count, stack_size, cpu_count, cpus, idle_timeout_ms and max_injected_thread_count. ]*/
+        result->worker_pool = worker_pool_linux_create(&worker_pool_parameters);
+        if (result->worker_pool == NULL)
+        {
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_003: [ If any error occurs, execution_engine_create shall fail and return NULL. ]*/
+            LogError("worker_pool_linux_create(min_thread_count=%" PRIu32 ", max_thread_count=%" PRIu32 ", stack_size=%zu, cpu_count=%" PRIu32 ") failed",
+                parameters_to_use.min_thread_count, parameters_to_use.max_thread_count, parameters_to_use.stack_size, parameters_to_use.cpu_count);
+            REFCOUNT_TYPE_DESTROY(EXECUTION_ENGINE, result);
+            result = NULL;
+        }
+        else if (parameters_to_use.max_outstanding_io == 0)
+        {
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_015: [ If max_outstanding_io is 0, execution_engine_create shall not limit the number of outstanding file I/Os. ]*/
+            result->io_admission = NULL;
+        }
+        else
+        {
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_014: [ If max_outstanding_io is not 0, execution_engine_create shall create an admission bounding the outstanding file I/Os of the execution engine by calling io_admission_create with max_outstanding_io. ]*/
+            result->io_admission = io_admission_create(parameters_to_use.max_outstanding_io);
+            if (result->io_admission == NULL)
+            {
+                /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_003: [ If any error occurs, execution_engine_create shall fail and return NULL. ]*/
+                LogError("io_admission_create(max_outstanding_io=%" PRIu32 ") failed", parameters_to_use.max_outstanding_io);
+                worker_pool_linux_destroy(result->worker_pool);
+                REFCOUNT_TYPE_DESTROY(EXECUTION_ENGINE, result);
+                result = NULL;
+            }
+        }
+
+        if (result != NULL)
+        {
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_004: [ execution_engine_create shall not create the I/O ring, it is created on first use. ]*/
+            (void)interlocked_exchange(&result->io_ring_init, LAZY_INIT_NOT_DONE);
+            result->io_ring = NULL;
+
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_023: [ execution_engine_create shall not create the timer wheel, it is created on first use. ]*/
+            (void)interlocked_exchange(&result->timer_wheel_init, LAZY_INIT_NOT_DONE);
+            result->timer_wheel = NULL;
+
+            result->min_thread_count = parameters_to_use.min_thread_count;
+            result->max_thread_count = parameters_to_use.max_thread_count;
+            result->stack_size = parameters_to_use.stack_size;
+            result->idle_timeout_ms = parameters_to_use.idle_timeout_ms;
+            result->max_injected_thread_count = parameters_to_use.max_injected_thread_count;
+            result->numa_node_count = numa_node_count;
+
+            if (numa_node_count > 1)
+            {
+                for (uint32_t i = 0; i < numa_node_count; i++)
+                {
+                    /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_032: [ execution_engine_create shall not create the worker threads of the NUMA nodes, they are created on first use. ]*/
+                    result->numa_node_worker_pools[i].execution_engine = result;
+                    result->numa_node_worker_pools[i].numa_node = i;
+                    (void)interlocked_exchange(&result->numa_node_worker_pools[i].worker_pool_init, LAZY_INIT_NOT_DONE);
+                    result->numa_node_worker_pools[i].worker_pool = NULL;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+void execution_engine_dec_ref(EXECUTION_ENGINE_HANDLE execution_engine)
+{
+    if (execution_engine == NULL)
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_005: [ If execution_engine is NULL, execution_engine_dec_ref shall return. ]*/
+        LogError("Invalid arguments: EXECUTION_ENGINE_HANDLE execution_engine=%p", execution_engine);
+    }
+    else
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_006: [ Otherwise execution_engine_dec_ref shall decrement the refcount. ]*/
+        if (DEC_REF(EXECUTION_ENGINE, execution_engine) == 0)
+        {
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_007: [ If the refcount is zero execution_engine_dec_ref shall destroy the I/O ring if it was created and free the execution engine. ]*/
+            if (execution_engine->io_ring != NULL)
+            {
+                io_ring_linux_destroy(execution_engine->io_ring);
+            }
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_024: [ If the refcount is zero execution_engine_dec_ref shall destroy the timer wheel if it was created, before destroying the worker threads. ]*/
+            if (execution_engine->timer_wheel != NULL)
+            {
+                timer_wheel_linux_destroy(execution_engine->timer_wheel);
+            }
+            if (execution_engine->numa_node_count > 1)
+            {
+                for (uint32_t i = 0; i < execution_engine->numa_node_count; i++)
+                {
+                    /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_033: [ If the refcount is zero execution_engine_dec_ref shall destroy the worker threads of the NUMA nodes that were created by calling worker_pool_linux_destroy. ]*/
+                    if (execution_engine->numa_node_worker_pools[i].worker_pool != NULL)
+                    {
+                        worker_pool_linux_destroy(execution_engine->numa_node_worker_pools[i].worker_pool);
+                    }
+                }
+            }
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_020: [ If the refcount is zero execution_engine_dec_ref shall destroy the worker threads by calling worker_pool_linux_destroy after destroying the I/O ring. ]*/
+            worker_pool_linux_destroy(execution_engine->worker_pool);
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_016: [ If the refcount is zero execution_engine_dec_ref shall destroy the admission if it was created. ]*/
+            if (execution_engine->io_admission != NULL)
+            {
+                io_admission_destroy(execution_engine->io_admission);
+            }
+            REFCOUNT_TYPE_DESTROY(EXECUTION_ENGINE, execution_engine);
+        }
+    }
+}
+
+void execution_engine_inc_ref(EXECUTION_ENGINE_HANDLE execution_engine)
+{
+    if (execution_engine == NULL)
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_03_001: [ If execution_engine is NULL, execution_engine_inc_ref shall return. ]*/
+        LogError("Invalid arguments: EXECUTION_ENGINE_HANDLE execution_engine=%p", execution_engine);
+    }
+    else
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_03_002: [ Otherwise execution_engine_inc_ref shall increment the reference count for execution_engine. ]*/
+        INC_REF(EXECUTION_ENGINE, execution_engine);
+    }
+}
+
+IO_RING_LINUX_HANDLE execution_engine_linux_get_io_ring(EXECUTION_ENGINE_HANDLE execution_engine)
+{
+    IO_RING_LINUX_HANDLE result;
+
+    if (execution_engine == NULL)
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_009: [ If execution_engine is NULL, execution_engine_linux_get_io_ring shall fail and return NULL. ]*/
+        LogError("Invalid arguments: EXECUTION_ENGINE_HANDLE execution_engine=%p", execution_engine);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_010: [ execution_engine_linux_get_io_ring shall call lazy_init to create the I/O ring only once. ]*/
+        if (lazy_init(&execution_engine->io_ring_init, create_io_ring, execution_engine) != LAZY_INIT_OK)
+        {
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_011: [ If lazy_init fails, execution_engine_linux_get_io_ring shall fail and return NULL. ]*/
+            LogError("lazy_init failed");
+            result = NULL;
+        }
+        else
+        {
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_012: [ Otherwise execution_engine_linux_get_io_ring shall return the I/O ring handle. ]*/
+            result = execution_engine->io_ring;
+        }
+    }
+
+    return result;
+}
+
+IO_ADMISSION_HANDLE execution_engine_linux_get_io_admission(EXECUTION_ENGINE_HANDLE execution_engine)
+{
+    IO_ADMISSION_HANDLE result;
+
+    if (execution_engine == NULL)
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_017: [ If execution_engine is NULL, execution_engine_linux_get_io_admission shall fail and return NULL. ]*/
+        LogError("Invalid arguments: EXECUTION_ENGINE_HANDLE execution_engine=%p", execution_engine);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_018: [ Otherwise execution_engine_linux_get_io_admission shall return the admission created in execution_engine_create, or NULL if max_outstanding_io was 0. ]*/
+        result = execution_engine->io_admission;
+    }
+
+    return result;
+}
+
+WORKER_POOL_LINUX_HANDLE execution_engine_linux_get_worker_pool(EXECUTION_ENGINE_HANDLE execution_engine)
+{
+    WORKER_POOL_LINUX_HANDLE result;
+
+    if (execution_engine == NULL)
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_021: [ If execution_engine is NULL, execution_engine_linux_get_worker_pool shall fail and return NULL. ]*/
+        LogError("Invalid arguments: EXECUTION_ENGINE_HANDLE execution_engine=%p", execution_engine);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_022: [ Otherwise execution_engine_linux_get_worker_pool shall return the worker pool created in execution_engine_create. ]*/
+        result = execution_engine->worker_pool;
+    }
+
+    return result;
+}
+
+TIMER_WHEEL_LINUX_HANDLE execution_engine_linux_get_timer_wheel(EXECUTION_ENGINE_HANDLE execution_engine)
+{
+    TIMER_WHEEL_LINUX_HANDLE result;
+
+    if (execution_engine == NULL)
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_025: [ If execution_engine is NULL, execution_engine_linux_get_timer_wheel shall fail and return NULL. ]*/
+        LogError("Invalid arguments: EXECUTION_ENGINE_HANDLE execution_engine=%p", execution_engine);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_027: [ execution_engine_linux_get_timer_wheel shall call lazy_init to create the timer wheel only once. ]*/
+        if (lazy_init(&execution_engine->timer_wheel_init, create_timer_wheel, execution_engine) != LAZY_INIT_OK)
+        {
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_028: [ If lazy_init fails, execution_engine_linux_get_timer_wheel shall fail and return NULL. ]*/
+            LogError("lazy_init failed");
+            result = NULL;
+        }
+        else
+        {
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_029: [ Otherwise execution_engine_linux_get_timer_wheel shall return the timer wheel handle. ]*/
+            result = execution_engine->timer_wheel;
+        }
+    }
+
+    return result;
+}
+
+WORKER_POOL_LINUX_HANDLE execution_engine_linux_get_numa_node_worker_pool(EXECUTION_ENGINE_HANDLE execution_engine, uint32_t numa_node)
+{
+    WORKER_POOL_LINUX_HANDLE result;
+
+    if (
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_034: [ If execution_engine is NULL, execution_engine_linux_get_numa_node_worker_pool shall fail and return NULL. ]*/
+        (execution_engine == NULL) ||
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_035: [ If numa_node is greater than or equal to the number of NUMA nodes, execution_engine_linux_get_numa_node_worker_pool shall fail and return NULL. ]*/
+        (numa_node >= execution_engine->numa_node_count)
+        )
+    {
+        LogError("Invalid arguments: EXECUTION_ENGINE_HANDLE execution_engine=%p, uint32_t numa_node=%" PRIu32 ", numa_node_count=%" PRIu32,
+            execution_engine, numa_node, (execution_engine == NULL) ? 0 : execution_engine->numa_node_count);
+        result = NULL;
+    }
+    else if (execution_engine->numa_node_count == 1)
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_039: [ If there is only one NUMA node, execution_engine_linux_get_numa_node_worker_pool shall return the worker pool created in execution_engine_create. ]*/
+        result = execution_engine->worker_pool;
+    }
+    else
+    {
+        NUMA_NODE_WORKER_POOL* numa_node_worker_pool = &execution_engine->numa_node_worker_pools[numa_node];
+
+        /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_040: [ Otherwise execution_engine_linux_get_numa_node_worker_pool shall call lazy_init to create the worker threads of the node only once. ]*/
+        if (lazy_init(&numa_node_worker_pool->worker_pool_init, create_numa_node_worker_pool, numa_node_worker_pool) != LAZY_INIT_OK)
+        {
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_041: [ If lazy_init fails, execution_engine_linux_get_numa_node_worker_pool shall fail and return NULL. ]*/
+            LogError("lazy_init failed for NUMA node %" PRIu32, numa_node);
+            result = NULL;
+        }
+        else
+        {
+            /* Codes_SRS_EXECUTION_ENGINE_LINUX_01_042: [ Otherwise execution_engine_linux_get_numa_node_worker_pool shall return the worker pool of the node. ]*/
+            result = numa_node_worker_pool->worker_pool;
+        }
+    }
+
+    return result;
+}
@@ -1,34 +1,3232 @@
 // Copyright (C) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
+#define _GNU_SOURCE
+
+#include <inttypes.h>
+#include <stdbool.h>
 #include <stdint.h>
+#include <stdio.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <linux/falloc.h>
+#include <linux/fs.h>
+#include <linux/io_uring.h>
+
+#include "macro_utils/macro_utils.h"
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sync.h"
+#include "c_pal/execution_engine.h"
+#include "c_pal/execution_engine_linux.h"
+#include "c_pal/io_ring_linux.h"
+#include "c_pal/io_context_pool.h"
+#include "c_pal/write_aggregator.h"
+#include "c_pal/read_ahead.h"
+#include "c_pal/io_admission.h"
 
 #include "c_pal/file.h"
 
+MU_DEFINE_ENUM_STRINGS(FILE_ACCESS_HINT, FILE_ACCESS_HINT_VALUES)
+MU_DEFINE_ENUM_STRINGS(FILE_IO_LIMIT_MODE, FILE_IO_LIMIT_MODE_VALUES)
+MU_DEFINE_ENUM_STRINGS(FILE_IO_PRIORITY, FILE_IO_PRIORITY_VALUES)
+
+/*ioprio values as in linux/ioprio.h, the lowest level of the best-effort class is used for the low priority I/Os rather than the idle class, which can starve them forever on a busy device*/
+#define FILE_LINUX_IOPRIO_CLASS_SHIFT 13
+#define FILE_LINUX_IOPRIO_CLASS_BE 2
+#define FILE_LINUX_IOPRIO_BE_LOWEST_LEVEL 7
+#define FILE_LINUX_IOPRIO_NORMAL 0 /*the priority of the thread that submits the I/O*/
+#define FILE_LINUX_IOPRIO_LOW ((FILE_LINUX_IOPRIO_CLASS_BE << FILE_LINUX_IOPRIO_CLASS_SHIFT) | FILE_LINUX_IOPRIO_BE_LOWEST_LEVEL)
+
+typedef struct FILE_LINUX_FLUSH_REQUEST_TAG
+{
+    struct FILE_LINUX_FLUSH_REQUEST_TAG* next;
+    FILE_CB user_callback;
+    void* user_context;
+}FILE_LINUX_FLUSH_REQUEST;
+
+/*start of the context of every I/O sent to the device for a file handle: the I/Os of the user, the aggregated writes, the read-ahead block reads and the fsync of the flushes.
+Each holds a slot of the I/O limits of the file handle and of the execution engine until it completes*/
+typedef struct FILE_LINUX_ADMITTED_IO_TAG
+{
+    IO_RING_LINUX_IO io; /*also called with -ECANCELED by fail_queued_io when a queued I/O cannot be submitted*/
+    FILE_HANDLE handle;
+    bool is_admitted; /*the I/O holds a slot of the I/O limits of the file handle and of the execution engine*/
+    uint64_t write_end; /*passed to preallocate_ahead_if_needed once the I/O is submitted, 0 if the I/O does not preallocate*/
+    IO_ADMISSION_WAITER admission_waiter; /*used while the I/O is queued for a slot*/
+    IO_RING_LINUX_SQE sqe; /*submitted once the I/O holds its slots*/
+}FILE_LINUX_ADMITTED_IO;
+
 typedef struct FILE_HANDLE_DATA_TAG
 {
-    int handle;
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    IO_RING_LINUX_HANDLE io_ring;
+    IO_CONTEXT_POOL_HANDLE io_context_pool;
+    int h_file;
+    volatile_atomic int32_t pending_io_count;
+    /*group commit: file_flush_async pushes requests to flush_requests, one fsync at a time takes all of them*/
+    void* volatile_atomic flush_requests; /*FILE_LINUX_FLUSH_REQUEST*, most recent first*/
+    volatile_atomic int32_t flush_in_progress;
+    FILE_LINUX_FLUSH_REQUEST* flushing_requests; /*the requests served by the fsync in progress*/
+    FILE_LINUX_ADMITTED_IO flush_io;
+    /*preallocation: storage is reserved with fallocate(FALLOC_FL_KEEP_SIZE) ahead of the writes, one reservation at a time*/
+    uint64_t preallocation_chunk_size; /*0 if no policy was set, only written by file_set_preallocation before any write*/
+    volatile_atomic int64_t preallocated_end; /*storage is reserved up to this offset*/
+    volatile_atomic int32_t preallocation_in_progress;
+    int64_t preallocation_target; /*end of the reservation in progress*/
+    IO_RING_LINUX_IO preallocation_io;
+    WRITE_AGGREGATOR_HANDLE write_aggregator; /*NULL if no policy was set, only written by file_set_write_aggregation before any write*/
+    READ_AHEAD_HANDLE read_ahead; /*NULL if no policy was set, only written by file_set_read_ahead before any I/O*/
+    /*I/O limit: every I/O sent to the device holds a slot of both admissions until it completes*/
+    IO_ADMISSION_HANDLE io_admission; /*NULL if the file handle has no limit, only written by file_set_io_limit before any I/O*/
+    IO_ADMISSION_HANDLE engine_io_admission; /*NULL if the execution engine has no limit*/
+    FILE_IO_LIMIT_MODE io_limit_mode;
+    bool is_io_limit_set;
+    /*priority: only written by file_set_io_priority before any I/O*/
+    uint16_t ioprio; /*ioprio of the read and write entries of the handle*/
+    IO_ADMISSION_PRIORITY admission_priority; /*priority of the I/Os of the handle that wait for a slot*/
     FILE_REPORT_FAULT user_report_fault_callback;
     void* user_report_fault_context;
 }FILE_HANDLE_DATA;
 
-typedef struct FILE_LINUX_WRITE_TAG
+typedef struct FILE_LINUX_IO_TAG
 {
-    FILE_HANDLE handle;
+    FILE_LINUX_ADMITTED_IO admitted_io;
     FILE_CB user_callback;
     void* user_context;
-    const unsigned char* source;
     uint32_t size;
-}FILE_LINUX_WRITE;
+    bool is_write; /*the read-ahead blocks of the written range are dropped again when the write completes*/
+    uint64_t position;
+    struct iovec iovecs[]; /*only used by the vectored operations, has to live until the I/O completes*/
+}FILE_LINUX_IO;
+
+/*contexts of I/Os with up to FILE_LINUX_POOLED_IOVEC_COUNT buffers come from the pool of the file handle, bigger ones are allocated*/
+#define FILE_LINUX_POOLED_IOVEC_COUNT 4
+#define FILE_LINUX_IO_CONTEXT_SIZE (sizeof(FILE_LINUX_IO) + FILE_LINUX_POOLED_IOVEC_COUNT * sizeof(struct iovec))
+#define FILE_LINUX_IO_CONTEXT_POOL_SIZE 64
+
+/*aggregated writes are issued on a file opened with O_DIRECT, 4096 is a multiple of the logical block size of the devices we run on*/
+#define FILE_LINUX_WRITE_ALIGNMENT 4096
+
+/*context of an aggregated write or of an aggregation timer, also comes from the pool of the file handle, a timer does not use the admission fields of admitted_io*/
+typedef struct FILE_LINUX_AGGREGATOR_IO_TAG
+{
+    FILE_LINUX_ADMITTED_IO admitted_io;
+    WRITE_AGGREGATOR_IO* aggregated_io;
+    uint64_t timer_id;
+    struct __kernel_timespec timeout; /*has to live until the timeout completes*/
+}FILE_LINUX_AGGREGATOR_IO;
+
+/*context of a read-ahead block read, also comes from the pool of the file handle*/
+typedef struct FILE_LINUX_READ_AHEAD_IO_TAG
+{
+    FILE_LINUX_ADMITTED_IO admitted_io;
+    READ_AHEAD_IO* read_ahead_io;
+}FILE_LINUX_READ_AHEAD_IO;
+
+typedef struct FILE_MAPPED_REGION_TAG
+{
+    void* map_address; /*as returned by mmap, page aligned*/
+    size_t map_length;
+    const unsigned char* data; /*the byte at the position requested by the user*/
+}FILE_MAPPED_REGION;
 
-typedef struct FILE_LINUX_READ_TAG
+typedef struct FILE_BATCH_TAG
 {
     FILE_HANDLE handle;
+    uint32_t max_io_count;
+    uint32_t io_count;
+    IO_RING_LINUX_SQE sqes[]; /*copies of the entries of the I/Os, sqes[i].io->on_io_complete_context is the FILE_LINUX_IO of the entry*/
+}FILE_BATCH;
+
+/*file_copy_range_async: FICLONERANGE and copy_file_range block until the kernel is done, so they run on a worker thread of the execution engine.
+When neither of them can copy the range, the kernel moves the data through pipes with splices,
+each lane filling its pipe from the source and draining it to the destination for its chunks while the other lanes do the same for theirs.
+The files are opened with O_DIRECT, so ranges that are not aligned are copied through descriptors of the files opened again without O_DIRECT*/
+#define FILE_LINUX_COPY_LANE_COUNT 2
+#define FILE_LINUX_COPY_CHUNK_SIZE (1024 * 1024) /*also the size requested for the pipes, the default maximum size of a pipe for an unprivileged process*/
+
+typedef struct FILE_LINUX_COPY_TAG FILE_LINUX_COPY;
+
+typedef struct FILE_LINUX_COPY_LANE_TAG
+{
+    IO_RING_LINUX_IO io;
+    FILE_LINUX_COPY* copy;
+    int pipe_fds[2]; /*read end, write end*/
+    bool is_filling_pipe; /*direction of the splice in flight*/
+    /*offsets relative to the start of the range: the bytes before read_end were moved to the pipe, the bytes before write_end to the destination*/
+    uint64_t chunk_start;
+    uint64_t chunk_end;
+    uint64_t read_end;
+    uint64_t write_end;
+}FILE_LINUX_COPY_LANE;
+
+struct FILE_LINUX_COPY_TAG
+{
+    WORKER_POOL_LINUX_WORK_ITEM work_item;
+    FILE_HANDLE source;
+    FILE_HANDLE destination;
+    uint64_t source_position;
+    uint64_t destination_position;
+    uint64_t size;
+    int source_fd; /*h_file of source, or source opened again without O_DIRECT*/
+    int destination_fd; /*h_file of destination, or destination opened again without O_DIRECT*/
     FILE_CB user_callback;
     void* user_context;
-    unsigned char* destination;
-    uint32_t size;
-}FILE_LINUX_READ;
+    uint32_t lane_count; /*lanes that have a pipe*/
+    volatile_atomic int32_t pending_lane_count;
+    volatile_atomic int32_t failed;
+    FILE_LINUX_COPY_LANE lanes[FILE_LINUX_COPY_LANE_COUNT];
+};
+
+#define FILE_LINUX_START_IO_RESULT_VALUES \
+    FILE_LINUX_START_IO_OK, \
+    FILE_LINUX_START_IO_BUSY, \
+    FILE_LINUX_START_IO_SUBMIT_ERROR, \
+    FILE_LINUX_START_IO_ERROR
+MU_DEFINE_ENUM(FILE_LINUX_START_IO_RESULT, FILE_LINUX_START_IO_RESULT_VALUES);
+
+#define FILE_LINUX_COPY_RANGE_RESULT_VALUES \
+    FILE_LINUX_COPY_RANGE_OK, \
+    FILE_LINUX_COPY_RANGE_NOT_SUPPORTED, \
+    FILE_LINUX_COPY_RANGE_ERROR
+MU_DEFINE_ENUM(FILE_LINUX_COPY_RANGE_RESULT, FILE_LINUX_COPY_RANGE_RESULT_VALUES);
+
+static FILE_LINUX_START_IO_RESULT start_io(FILE_LINUX_ADMITTED_IO* admitted_io, FILE_IO_LIMIT_MODE io_limit_mode);
+
+static bool get_file_buffers_total_size(const FILE_BUFFER* buffers, uint32_t buffer_count, uint32_t* total_size)
+{
+    bool result = true;
+    uint64_t size = 0;
+
+    for (uint32_t i = 0; i < buffer_count; i++)
+    {
+        if (
+            (buffers[i].buffer == NULL) ||
+            (buffers[i].length == 0)
+            )
+        {
+            LogError("Invalid buffer at index %" PRIu32 ": void* buffer=%p, uint32_t length=%" PRIu32 "",
+                i, buffers[i].buffer, buffers[i].length);
+            result = false;
+            break;
+        }
+
+        size += buffers[i].length;
+        if (size > UINT32_MAX)
+        {
+            LogError("Sum of buffer lengths exceeds UINT32_MAX at index %" PRIu32 "", i);
+            result = false;
+            break;
+        }
+    }
+
+    if (result)
+    {
+        *total_size = (uint32_t)size;
+    }
+
+    return result;
+}
+
+static void release_io_slots(FILE_HANDLE handle)
+{
+    /*Codes_SRS_FILE_LINUX_01_155: [ release_io_slots shall call io_admission_release on the admission of the execution engine and then on the admission of the file handle, for the ones that exist. ]*/
+    if (handle->engine_io_admission != NULL)
+    {
+        io_admission_release(handle->engine_io_admission);
+    }
+    if (handle->io_admission != NULL)
+    {
+        io_admission_release(handle->io_admission);
+    }
+}
+
+static void on_file_io_complete_linux(void* context, int32_t io_result)
+{
+    /*Codes_SRS_FILE_LINUX_01_010: [ on_file_io_complete_linux shall recover the file handle, the number of bytes requested by the user, user_callback and user_context from context. ]*/
+    FILE_LINUX_IO* io_context = context;
+    FILE_HANDLE handle = io_context->admitted_io.handle;
+
+    FILE_CB user_callback = io_context->user_callback;
+    void* user_callback_context = io_context->user_context;
+
+    bool all_bytes_were_transferred = (io_result >= 0) && ((uint32_t)io_result == io_context->size);
+    bool is_admitted = io_context->admitted_io.is_admitted;
+    bool is_write = io_context->is_write;
+    uint64_t position = io_context->position;
+    uint32_t size = io_context->size;
+
+    /*Codes_SRS_FILE_LINUX_01_045: [ on_file_io_complete_linux shall release context to the I/O context pool of the file handle. ]*/
+    io_context_pool_release(handle->io_context_pool, io_context);
+
+    if (is_write && (handle->read_ahead != NULL))
+    {
+        /*Codes_SRS_FILE_LINUX_01_230: [ If the I/O is a write and a read-ahead policy is set, on_file_io_complete_linux shall call read_ahead_invalidate with the position and size of the write before calling user_callback. ]*/
+        /*Codes_SRS_FILE_01_142: [ When a read-ahead policy is set, the blocks that overlap the written range shall be dropped again when the write completes, before its user_callback is called, so that a block read while the write was in flight is not served. ]*/
+        /*a block read ahead while the write was in flight can hold the data from before the write*/
+        read_ahead_invalidate(handle->read_ahead, position, size);
+    }
+
+    if (is_admitted)
+    {
+        /*Codes_SRS_FILE_LINUX_01_154: [ If the I/O holds slots of the I/O limits, on_file_io_complete_linux shall call release_io_slots before calling user_callback. ]*/
+        release_io_slots(handle);
+    }
+
+    if (io_result < 0)
+    {
+        LogError("Error in asynchronous operation, error=%" PRId32 "", -io_result);
+    }
+    else if (!all_bytes_were_transferred)
+    {
+        LogError("All bytes were not transferred, transferred %" PRId32 " bytes", io_result);
+    }
+    else
+    {
+        /*all good*/
+    }
+
+    /*Codes_SRS_FILE_LINUX_01_011: [ on_file_io_complete_linux shall call user_callback with is_successful as true if and only if io_result is equal to the number of bytes requested by the user. ]*/
+    /*Codes_SRS_FILE_LINUX_01_012: [ If io_result is negative or not equal to the number of bytes requested by the user, on_file_io_complete_linux shall call user_callback with is_successful as false. ]*/
+    user_callback(user_callback_context, all_bytes_were_transferred);
+
+    /*Codes_SRS_FILE_LINUX_01_013: [ on_file_io_complete_linux shall decrement the number of pending I/O operations and wake up file_destroy if it reaches 0. ]*/
+    if (interlocked_decrement(&handle->pending_io_count) == 0)
+    {
+        wake_by_address_single(&handle->pending_io_count);
+    }
+}
+
+static void complete_flush_requests(FILE_HANDLE handle, FILE_LINUX_FLUSH_REQUEST* requests, bool is_successful)
+{
+    /*requests are pushed most recent first, reverse them so that callbacks are called in the order of the file_flush_async calls*/
+    FILE_LINUX_FLUSH_REQUEST* ordered_requests = NULL;
+    while (requests != NULL)
+    {
+        FILE_LINUX_FLUSH_REQUEST* next = requests->next;
+        requests->next = ordered_requests;
+        ordered_requests = requests;
+        requests = next;
+    }
+
+    while (ordered_requests != NULL)
+    {
+        FILE_LINUX_FLUSH_REQUEST* next = ordered_requests->next;
+        FILE_CB user_callback = ordered_requests->user_callback;
+        void* user_context = ordered_requests->user_context;
+
+        io_context_pool_release(handle->io_context_pool, ordered_requests);
+
+        user_callback(user_context, is_successful);
+
+        if (interlocked_decrement(&handle->pending_io_count) == 0)
+        {
+            wake_by_address_single(&handle->pending_io_count);
+        }
+
+        ordered_requests = next;
+    }
+}
+
+static void start_flush_if_idle(FILE_HANDLE handle)
+{
+    /*Codes_SRS_FILE_LINUX_01_058: [ To start a flush, file_flush_async shall mark the flush as in progress, and if another flush is already in progress it shall return, leaving the requests to be served by the next flush. ]*/
+    while (interlocked_compare_exchange(&handle->flush_in_progress, 1, 0) == 0)
+    {
+        /*Codes_SRS_FILE_LINUX_01_059: [ file_flush_async shall take all the requests from the list of flush requests. ]*/
+        FILE_LINUX_FLUSH_REQUEST* requests = interlocked_exchange_pointer(&handle->flush_requests, NULL);
+        if (requests == NULL)
+        {
+            /*Codes_SRS_FILE_LINUX_01_060: [ If there are no requests, file_flush_async shall mark the flush as not in progress and try again if a request was added in the meantime. ]*/
+            (void)interlocked_exchange(&handle->flush_in_progress, 0);
+            if (interlocked_compare_exchange_pointer(&handle->flush_requests, NULL, NULL) == NULL)
+            {
+                break;
+            }
+        }
+        else
+        {
+            handle->flushing_requests = requests;
+
+            /*Codes_SRS_FILE_LINUX_01_061: [ file_flush_async shall increment the number of pending I/O operations for the flush and prepare an IORING_OP_FSYNC entry for the file descriptor with IORING_FSYNC_DATASYNC as flags. ]*/
+            (void)interlocked_increment(&handle->pending_io_count);
+
+            handle->flush_io.write_end = 0;
+            handle->flush_io.sqe.opcode = IORING_OP_FSYNC;
+            handle->flush_io.sqe.ioprio = 0;
+            handle->flush_io.sqe.fd = handle->h_file;
+            handle->flush_io.sqe.offset = 0;
+            handle->flush_io.sqe.address = NULL;
+            handle->flush_io.sqe.length = 0;
+            handle->flush_io.sqe.op_flags = IORING_FSYNC_DATASYNC;
+            handle->flush_io.sqe.io = &handle->flush_io.io;
+
+            /*Codes_SRS_FILE_01_147: [ The aggregated writes, the reads of read-ahead blocks and the flushes of handle shall be queued when no slot of the I/O limits is free, whatever the mode of handle. ]*/
+            /*Codes_SRS_FILE_LINUX_01_241: [ file_flush_async shall start the flush by calling start_io with FILE_IO_LIMIT_MODE_QUEUE. ]*/
+            if (start_io(&handle->flush_io, FILE_IO_LIMIT_MODE_QUEUE) == FILE_LINUX_START_IO_OK)
+            {
+                break;
+            }
+
+            /*Codes_SRS_FILE_LINUX_01_062: [ If start_io fails, file_flush_async shall call the user_callback of all the taken requests with is_successful as false, release them to the I/O context pool, decrement the number of pending I/O operations for each of them and for the flush and mark the flush as not in progress. ]*/
+            LogError("failure in start_io");
+            complete_flush_requests(handle, requests, false);
+            (void)interlocked_exchange(&handle->flush_in_progress, 0);
+            if (interlocked_decrement(&handle->pending_io_count) == 0)
+            {
+                wake_by_address_single(&handle->pending_io_count);
+            }
+        }
+    }
+}
+
+static void on_file_flush_complete_linux(void* context, int32_t io_result)
+{
+    FILE_HANDLE handle = context;
+
+    if (io_result < 0)
+    {
+        LogError("Error in asynchronous flush, error=%" PRId32 "", -io_result);
+    }
+
+    if (handle->flush_io.is_admitted)
+    {
+        /*Codes_SRS_FILE_LINUX_01_242: [ If the flush holds slots of the I/O limits, on_file_flush_complete_linux shall call release_io_slots. ]*/
+        release_io_slots(handle);
+    }
+
+    /*Codes_SRS_FILE_LINUX_01_063: [ on_file_flush_complete_linux shall call the user_callback of all the requests served by the flush, in the order in which file_flush_async was called, with is_successful as true if and only if io_result is 0. ]*/
+    /*Codes_SRS_FILE_LINUX_01_064: [ on_file_flush_complete_linux shall release each request to the I/O context pool and decrement the number of pending I/O operations for it. ]*/
+    complete_flush_requests(handle, handle->flushing_requests, io_result == 0);
+
+    /*Codes_SRS_FILE_LINUX_01_065: [ on_file_flush_complete_linux shall mark the flush as not in progress and start a new flush if requests were added while the flush was in progress. ]*/
+    (void)interlocked_exchange(&handle->flush_in_progress, 0);
+    start_flush_if_idle(handle);
+
+    /*Codes_SRS_FILE_LINUX_01_066: [ on_file_flush_complete_linux shall decrement the number of pending I/O operations for the flush and wake up file_destroy if it reaches 0. ]*/
+    if (interlocked_decrement(&handle->pending_io_count) == 0)
+    {
+        wake_by_address_single(&handle->pending_io_count);
+    }
+}
+
+static void preallocate_ahead_if_needed(FILE_HANDLE handle, uint64_t write_end)
+{
+    /*Codes_SRS_FILE_LINUX_01_084: [ If no preallocation policy is set on handle, preallocate_ahead_if_needed shall return. ]*/
+    uint64_t chunk_size = handle->preallocation_chunk_size;
+    if (chunk_size != 0)
+    {
+        /*Codes_SRS_FILE_01_081: [ When a write started by file_write_async, file_write_async_v or file_batch_submit ends less than chunk_size / 2 bytes before the end of the reserved storage and no reservation is in progress, storage shall be reserved in the background, without changing the size of the file, up to chunk_size bytes past the end of the write. ]*/
+        /*Codes_SRS_FILE_LINUX_01_085: [ If write_end + chunk_size / 2 is not greater than the preallocated end of the file, preallocate_ahead_if_needed shall return. ]*/
+        if (
+            (write_end + chunk_size / 2 > (uint64_t)interlocked_add_64(&handle->preallocated_end, 0)) &&
+            /*Codes_SRS_FILE_LINUX_01_086: [ preallocate_ahead_if_needed shall mark the preallocation as in progress, and if a preallocation is already in progress it shall return. ]*/
+            (interlocked_compare_exchange(&handle->preallocation_in_progress, 1, 0) == 0)
+            )
+        {
+            /*only the preallocation in progress writes preallocated_end*/
+            int64_t preallocation_start = interlocked_add_64(&handle->preallocated_end, 0);
+            uint32_t submitted_count;
+            IO_RING_LINUX_SQE sqe;
+
+            /*Codes_SRS_FILE_LINUX_01_087: [ preallocate_ahead_if_needed shall compute the preallocation target as write_end + chunk_size, capped at INT64_MAX. ]*/
+            handle->preallocation_target = (write_end > INT64_MAX - chunk_size) ? INT64_MAX : (int64_t)(write_end + chunk_size);
+
+            /*Codes_SRS_FILE_LINUX_01_088: [ preallocate_ahead_if_needed shall increment the number of pending I/O operations and call io_ring_linux_submit with an IORING_OP_FALLOCATE entry for the file descriptor that reserves the storage between the preallocated end and the preallocation target with FALLOC_FL_KEEP_SIZE as mode. ]*/
+            (void)interlocked_increment(&handle->pending_io_count);
+
+            /*for IORING_OP_FALLOCATE the length of the range goes in addr and the mode goes in len*/
+            sqe.opcode = IORING_OP_FALLOCATE;
+            sqe.ioprio = 0;
+            sqe.fd = handle->h_file;
+            sqe.offset = (uint64_t)preallocation_start;
+            sqe.address = (void*)(uintptr_t)(handle->preallocation_target - preallocation_start);
+            sqe.length = FALLOC_FL_KEEP_SIZE;
+            sqe.op_flags = 0;
+            sqe.io = &handle->preallocation_io;
+
+            if (io_ring_linux_submit(handle->io_ring, &sqe, 1, &submitted_count) != 0)
+            {
+                /*Codes_SRS_FILE_01_082: [ A failure to reserve storage shall not fail the write. ]*/
+                /*Codes_SRS_FILE_LINUX_01_089: [ If io_ring_linux_submit fails, preallocate_ahead_if_needed shall mark the preallocation as not in progress and decrement the number of pending I/O operations. ]*/
+                LogError("failure in io_ring_linux_submit, preallocation from %" PRId64 " to %" PRId64 "", preallocation_start, handle->preallocation_target);
+                (void)interlocked_exchange(&handle->preallocation_in_progress, 0);
+                if (interlocked_decrement(&handle->pending_io_count) == 0)
+                {
+                    wake_by_address_single(&handle->pending_io_count);
+                }
+            }
+        }
+    }
+}
+
+static void on_file_preallocate_complete_linux(void* context, int32_t io_result)
+{
+    FILE_HANDLE handle = context;
+
+    if (io_result < 0)
+    {
+        /*Codes_SRS_FILE_01_082: [ A failure to reserve storage shall not fail the write. ]*/
+        /*Codes_SRS_FILE_LINUX_01_090: [ If io_result is negative, on_file_preallocate_complete_linux shall log the error. ]*/
+        LogError("Error in asynchronous preallocation up to %" PRId64 ", error=%" PRId32 "", handle->preallocation_target, -io_result);
+    }
+
+    /*Codes_SRS_FILE_LINUX_01_091: [ on_file_preallocate_complete_linux shall set the preallocated end of the file to the preallocation target, even if the preallocation failed, so that a failing file system is only asked again once the writes get past the target. ]*/
+    (void)interlocked_exchange_64(&handle->preallocated_end, handle->preallocation_target);
+
+    /*Codes_SRS_FILE_LINUX_01_092: [ on_file_preallocate_complete_linux shall mark the preallocation as not in progress. ]*/
+    (void)interlocked_exchange(&handle->preallocation_in_progress, 0);
+
+    /*Codes_SRS_FILE_LINUX_01_093: [ on_file_preallocate_complete_linux shall decrement the number of pending I/O operations and wake up file_destroy if it reaches 0. ]*/
+    if (interlocked_decrement(&handle->pending_io_count) == 0)
+    {
+        wake_by_address_single(&handle->pending_io_count);
+    }
+}
+
+static void on_file_aggregated_write_complete_linux(void* context, int32_t io_result)
+{
+    FILE_LINUX_AGGREGATOR_IO* io_context = context;
+    FILE_HANDLE handle = io_context->admitted_io.handle;
+    WRITE_AGGREGATOR_IO* aggregated_io = io_context->aggregated_io;
+
+    bool all_bytes_were_transferred = (io_result >= 0) && ((uint32_t)io_result == aggregated_io->size);
+    bool is_admitted = io_context->admitted_io.is_admitted;
+
+    /*Codes_SRS_FILE_LINUX_01_117: [ on_file_aggregated_write_complete_linux shall release context to the I/O context pool of the file handle. ]*/
+    io_context_pool_release(handle->io_context_pool, io_context);
+
+    if (handle->read_ahead != NULL)
+    {
+        /*Codes_SRS_FILE_LINUX_01_231: [ If a read-ahead policy is set, on_file_aggregated_write_complete_linux shall call read_ahead_invalidate with the position and size of the aggregated write. ]*/
+        read_ahead_invalidate(handle->read_ahead, aggregated_io->position, aggregated_io->size);
+    }
+
+    if (is_admitted)
+    {
+        /*Codes_SRS_FILE_LINUX_01_243: [ If the aggregated write holds slots of the I/O limits, on_file_aggregated_write_complete_linux shall call release_io_slots before calling write_aggregator_io_complete. ]*/
+        release_io_slots(handle);
+    }
+
+    if (!all_bytes_were_transferred)
+    {
+        LogError("Error in aggregated write at position %" PRIu64 " of %" PRIu32 " bytes, io_result=%" PRId32 "", aggregated_io->position, aggregated_io->size, io_result);
+    }
+
+    /*Codes_SRS_FILE_01_091: [ When the aggregated write completes, the user_callback of every write copied in it shall be called with user_context and the result of the aggregated write. ]*/
+    /*Codes_SRS_FILE_LINUX_01_118: [ on_file_aggregated_write_complete_linux shall call write_aggregator_io_complete with is_successful as true if and only if io_result is equal to the size of the aggregated write. ]*/
+    write_aggregator_io_complete(handle->write_aggregator, aggregated_io, all_bytes_were_transferred);
+
+    /*Codes_SRS_FILE_LINUX_01_119: [ on_file_aggregated_write_complete_linux shall decrement the number of pending I/O operations and wake up file_destroy if it reaches 0. ]*/
+    if (interlocked_decrement(&handle->pending_io_count) == 0)
+    {
+        wake_by_address_single(&handle->pending_io_count);
+    }
+}
+
+static int issue_aggregated_write(void* context, WRITE_AGGREGATOR_IO* aggregated_io)
+{
+    int result;
+    FILE_HANDLE handle = context;
+
+    /*Codes_SRS_FILE_LINUX_01_112: [ issue_aggregated_write shall get a context from the I/O context pool by calling io_context_pool_get. ]*/
+    FILE_LINUX_AGGREGATOR_IO* io_context = io_context_pool_get(handle->io_context_pool, sizeof(FILE_LINUX_AGGREGATOR_IO));
+    if (io_context == NULL)
+    {
+        /*Codes_SRS_FILE_LINUX_01_113: [ If io_context_pool_get fails, issue_aggregated_write shall fail and return a non-zero value. ]*/
+        LogError("failure in io_context_pool_get");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        io_context->admitted_io.io.on_io_complete = on_file_aggregated_write_complete_linux;
+        io_context->admitted_io.io.on_io_complete_context = io_context;
+        io_context->admitted_io.handle = handle;
+        /*the copied writes were already preallocated for by file_write_async*/
+        io_context->admitted_io.write_end = 0;
+        io_context->aggregated_io = aggregated_io;
+
+        /*Codes_SRS_FILE_LINUX_01_114: [ issue_aggregated_write shall increment the number of pending I/O operations and prepare an IORING_OP_WRITE entry for the file descriptor and the buffer, size and position of the aggregated write. ]*/
+        (void)interlocked_increment(&handle->pending_io_count);
+
+        io_context->admitted_io.sqe.opcode = IORING_OP_WRITE;
+        /*Codes_SRS_FILE_LINUX_01_192: [ The IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READV and IORING_OP_WRITEV entries prepared for handle shall have the io_uring priority of handle as ioprio. ]*/
+        io_context->admitted_io.sqe.ioprio = handle->ioprio;
+        io_context->admitted_io.sqe.fd = handle->h_file;
+        io_context->admitted_io.sqe.offset = aggregated_io->position;
+        io_context->admitted_io.sqe.address = (void*)aggregated_io->buffer;
+        io_context->admitted_io.sqe.length = aggregated_io->size;
+        io_context->admitted_io.sqe.op_flags = 0;
+        io_context->admitted_io.sqe.io = &io_context->admitted_io.io;
+
+        /*Codes_SRS_FILE_01_147: [ The aggregated writes, the reads of read-ahead blocks and the flushes of handle shall be queued when no slot of the I/O limits is free, whatever the mode of handle. ]*/
+        /*Codes_SRS_FILE_LINUX_01_244: [ issue_aggregated_write shall start the write by calling start_io with FILE_IO_LIMIT_MODE_QUEUE. ]*/
+        if (start_io(&io_context->admitted_io, FILE_IO_LIMIT_MODE_QUEUE) != FILE_LINUX_START_IO_OK)
+        {
+            /*Codes_SRS_FILE_LINUX_01_115: [ If start_io fails, issue_aggregated_write shall decrement the number of pending I/O operations, release the context and return a non-zero value. ]*/
+            LogError("failure in start_io");
+            if (interlocked_decrement(&handle->pending_io_count) == 0)
+            {
+                wake_by_address_single(&handle->pending_io_count);
+            }
+            io_context_pool_release(handle->io_context_pool, io_context);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_LINUX_01_116: [ Otherwise issue_aggregated_write shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static void on_file_aggregation_timer_linux(void* context, int32_t io_result)
+{
+    FILE_LINUX_AGGREGATOR_IO* io_context = context;
+    FILE_HANDLE handle = io_context->admitted_io.handle;
+    uint64_t timer_id = io_context->timer_id;
+
+    /*an expired timeout completes with -ETIME*/
+    if ((io_result != -ETIME) && (io_result != 0))
+    {
+        /*Codes_SRS_FILE_LINUX_01_124: [ If io_result is neither -ETIME nor 0, on_file_aggregation_timer_linux shall log the error and still consider the timer expired. ]*/
+        LogError("Error in aggregation timer, error=%" PRId32 "", -io_result);
+    }
+
+    /*Codes_SRS_FILE_LINUX_01_125: [ on_file_aggregation_timer_linux shall release context to the I/O context pool and call write_aggregator_on_timer with the timer id. ]*/
+    io_context_pool_release(handle->io_context_pool, io_context);
+    write_aggregator_on_timer(handle->write_aggregator, timer_id);
+
+    /*Codes_SRS_FILE_LINUX_01_126: [ on_file_aggregation_timer_linux shall decrement the number of pending I/O operations and wake up file_destroy if it reaches 0. ]*/
+    if (interlocked_decrement(&handle->pending_io_count) == 0)
+    {
+        wake_by_address_single(&handle->pending_io_count);
+    }
+}
+
+static int start_aggregation_timer(void* context, uint32_t delay_ms, uint64_t timer_id)
+{
+    int result;
+    FILE_HANDLE handle = context;
+
+    /*Codes_SRS_FILE_LINUX_01_120: [ start_aggregation_timer shall get a context from the I/O context pool by calling io_context_pool_get. ]*/
+    FILE_LINUX_AGGREGATOR_IO* io_context = io_context_pool_get(handle->io_context_pool, sizeof(FILE_LINUX_AGGREGATOR_IO));
+    if (io_context == NULL)
+    {
+        /*Codes_SRS_FILE_LINUX_01_121: [ If io_context_pool_get fails, start_aggregation_timer shall fail and return a non-zero value. ]*/
+        LogError("failure in io_context_pool_get");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        uint32_t submitted_count;
+        IO_RING_LINUX_SQE sqe;
+
+        io_context->admitted_io.io.on_io_complete = on_file_aggregation_timer_linux;
+        io_context->admitted_io.io.on_io_complete_context = io_context;
+        io_context->admitted_io.handle = handle;
+        io_context->timer_id = timer_id;
+        io_context->timeout.tv_sec = delay_ms / 1000;
+        io_context->timeout.tv_nsec = (long long)(delay_ms % 1000) * 1000000;
+
+        /*Codes_SRS_FILE_LINUX_01_122: [ start_aggregation_timer shall increment the number of pending I/O operations and call io_ring_linux_submit with an IORING_OP_TIMEOUT entry that expires after delay_ms milliseconds. ]*/
+        (void)interlocked_increment(&handle->pending_io_count);
+
+        /*a pure timeout: no completion count (offset 0) and one timespec*/
+        sqe.opcode = IORING_OP_TIMEOUT;
+        sqe.ioprio = 0;
+        sqe.fd = -1;
+        sqe.offset = 0;
+        sqe.address = &io_context->timeout;
+        sqe.length = 1;
+        sqe.op_flags = 0;
+        sqe.io = &io_context->admitted_io.io;
+
+        if (io_ring_linux_submit(handle->io_ring, &sqe, 1, &submitted_count) != 0)
+        {
+            /*Codes_SRS_FILE_LINUX_01_123: [ If io_ring_linux_submit fails, start_aggregation_timer shall decrement the number of pending I/O operations, release the context and return a non-zero value. ]*/
+            LogError("failure in io_ring_linux_submit");
+            if (interlocked_decrement(&handle->pending_io_count) == 0)
+            {
+                wake_by_address_single(&handle->pending_io_count);
+            }
+            io_context_pool_release(handle->io_context_pool, io_context);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_LINUX_01_127: [ Otherwise start_aggregation_timer shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static int set_aggregated_file_size(void* context, uint64_t file_size)
+{
+    int result;
+    FILE_HANDLE handle = context;
+
+    /*Codes_SRS_FILE_01_141: [ Aggregated writes shall not change data outside of the written ranges and shall not leave the file bigger than the end of the last byte written. ]*/
+    /*Codes_SRS_FILE_LINUX_01_224: [ set_aggregated_file_size shall call ftruncate with the file descriptor and file_size to drop the padding written after the aggregated data. ]*/
+    if (ftruncate(handle->h_file, (off_t)file_size) != 0)
+    {
+        /*Codes_SRS_FILE_LINUX_01_225: [ If ftruncate fails, set_aggregated_file_size shall fail and return a non-zero value. ]*/
+        LogError("failure in ftruncate(h_file=%d, file_size=%" PRIu64 "), errno=%d", handle->h_file, file_size, errno);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_LINUX_01_226: [ Otherwise set_aggregated_file_size shall succeed and return 0. ]*/
+        result = 0;
+    }
+
+    return result;
+}
+
+static void on_file_read_ahead_complete_linux(void* context, int32_t io_result)
+{
+    FILE_LINUX_READ_AHEAD_IO* io_context = context;
+    FILE_HANDLE handle = io_context->admitted_io.handle;
+    READ_AHEAD_IO* read_ahead_io = io_context->read_ahead_io;
+    bool is_admitted = io_context->admitted_io.is_admitted;
+
+    /*Codes_SRS_FILE_LINUX_01_147: [ on_file_read_ahead_complete_linux shall release context to the I/O context pool of the file handle. ]*/
+    io_context_pool_release(handle->io_context_pool, io_context);
+
+    if (is_admitted)
+    {
+        /*Codes_SRS_FILE_LINUX_01_245: [ If the block read holds slots of the I/O limits, on_file_read_ahead_complete_linux shall call release_io_slots before calling read_ahead_io_complete. ]*/
+        release_io_slots(handle);
+    }
+
+    if (io_result < 0)
+    {
+        LogError("Error in read-ahead of block at position %" PRIu64 " of %" PRIu32 " bytes, error=%" PRId32 "", read_ahead_io->position, read_ahead_io->size, -io_result);
+    }
+
+    /*Codes_SRS_FILE_LINUX_01_148: [ on_file_read_ahead_complete_linux shall call read_ahead_io_complete with is_successful as true if and only if io_result is not negative and with io_result as the number of bytes read. ]*/
+    read_ahead_io_complete(handle->read_ahead, read_ahead_io, (io_result >= 0), (io_result >= 0) ? (uint32_t)io_result : 0);
+
+    /*Codes_SRS_FILE_LINUX_01_149: [ on_file_read_ahead_complete_linux shall decrement the number of pending I/O operations and wake up file_destroy if it reaches 0. ]*/
+    if (interlocked_decrement(&handle->pending_io_count) == 0)
+    {
+        wake_by_address_single(&handle->pending_io_count);
+    }
+}
+
+static int issue_read_ahead(void* context, READ_AHEAD_IO* read_ahead_io)
+{
+    int result;
+    FILE_HANDLE handle = context;
+
+    /*Codes_SRS_FILE_LINUX_01_142: [ issue_read_ahead shall get a context from the I/O context pool by calling io_context_pool_get. ]*/
+    FILE_LINUX_READ_AHEAD_IO* io_context = io_context_pool_get(handle->io_context_pool, sizeof(FILE_LINUX_READ_AHEAD_IO));
+    if (io_context == NULL)
+    {
+        /*Codes_SRS_FILE_LINUX_01_143: [ If io_context_pool_get fails, issue_read_ahead shall fail and return a non-zero value. ]*/
+        LogError("failure in io_context_pool_get");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        io_context->admitted_io.io.on_io_complete = on_file_read_ahead_complete_linux;
+        io_context->admitted_io.io.on_io_complete_context = io_context;
+        io_context->admitted_io.handle = handle;
+        io_context->admitted_io.write_end = 0;
+        io_context->read_ahead_io = read_ahead_io;
+
+        /*Codes_SRS_FILE_LINUX_01_144: [ issue_read_ahead shall increment the number of pending I/O operations and prepare an IORING_OP_READ entry for the file descriptor and the buffer, size and position of the block. ]*/
+        (void)interlocked_increment(&handle->pending_io_count);
+
+        io_context->admitted_io.sqe.opcode = IORING_OP_READ;
+        /*Codes_SRS_FILE_LINUX_01_192: [ The IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READV and IORING_OP_WRITEV entries prepared for handle shall have the io_uring priority of handle as ioprio. ]*/
+        io_context->admitted_io.sqe.ioprio = handle->ioprio;
+        io_context->admitted_io.sqe.fd = handle->h_file;
+        io_context->admitted_io.sqe.offset = read_ahead_io->position;
+        io_context->admitted_io.sqe.address = read_ahead_io->buffer;
+        io_context->admitted_io.sqe.length = read_ahead_io->size;
+        io_context->admitted_io.sqe.op_flags = 0;
+        io_context->admitted_io.sqe.io = &io_context->admitted_io.io;
+
+        /*Codes_SRS_FILE_01_147: [ The aggregated writes, the reads of read-ahead blocks and the flushes of handle shall be queued when no slot of the I/O limits is free, whatever the mode of handle. ]*/
+        /*Codes_SRS_FILE_LINUX_01_246: [ issue_read_ahead shall start the read by calling start_io with FILE_IO_LIMIT_MODE_QUEUE. ]*/
+        if (start_io(&io_context->admitted_io, FILE_IO_LIMIT_MODE_QUEUE) != FILE_LINUX_START_IO_OK)
+        {
+            /*Codes_SRS_FILE_LINUX_01_145: [ If start_io fails, issue_read_ahead shall decrement the number of pending I/O operations, release the context and return a non-zero value. ]*/
+            LogError("failure in start_io");
+            if (interlocked_decrement(&handle->pending_io_count) == 0)
+            {
+                wake_by_address_single(&handle->pending_io_count);
+            }
+            io_context_pool_release(handle->io_context_pool, io_context);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_LINUX_01_146: [ Otherwise issue_read_ahead shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static int submit_io(FILE_LINUX_ADMITTED_IO* admitted_io)
+{
+    int result;
+    uint32_t submitted_count;
+    FILE_HANDLE handle = admitted_io->handle;
+
+    /*the I/O can complete and its context be reused as soon as it is submitted*/
+    uint64_t write_end = admitted_io->write_end;
+
+    /*Codes_SRS_FILE_LINUX_01_156: [ submit_io shall call io_ring_linux_submit with the entry stored in the I/O context. ]*/
+    if (io_ring_linux_submit(handle->io_ring, &admitted_io->sqe, 1, &submitted_count) != 0)
+    {
+        /*Codes_SRS_FILE_LINUX_01_157: [ If io_ring_linux_submit fails, submit_io shall fail and return a non-zero value. ]*/
+        LogError("failure in io_ring_linux_submit");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        if (write_end != 0)
+        {
+            /*Codes_SRS_FILE_LINUX_01_238: [ If io_ring_linux_submit succeeds and the I/O context has a write end, submit_io shall call preallocate_ahead_if_needed with it. ]*/
+            preallocate_ahead_if_needed(handle, write_end);
+        }
+
+        /*Codes_SRS_FILE_LINUX_01_158: [ Otherwise submit_io shall succeed and return 0. ]*/
+        result = 0;
+    }
+
+    return result;
+}
+
+static void fail_queued_io(FILE_LINUX_ADMITTED_IO* admitted_io)
+{
+    /*Codes_SRS_FILE_01_120: [ If a queued I/O fails to start, its user_callback shall be called with user_context and is_successful as false. ]*/
+    /*Codes_SRS_FILE_LINUX_01_159: [ fail_queued_io shall mark the I/O as not holding slots and call the completion callback of the I/O with -ECANCELED as io_result. ]*/
+    admitted_io->is_admitted = false;
+    admitted_io->io.on_io_complete(admitted_io->io.on_io_complete_context, -ECANCELED);
+}
+
+static void on_file_io_admitted_by_engine(void* context)
+{
+    FILE_LINUX_ADMITTED_IO* admitted_io = context;
+
+    /*Codes_SRS_FILE_LINUX_01_160: [ on_file_io_admitted_by_engine shall call submit_io. ]*/
+    if (submit_io(admitted_io) != 0)
+    {
+        /*Codes_SRS_FILE_LINUX_01_161: [ If submit_io fails, on_file_io_admitted_by_engine shall call release_io_slots and fail_queued_io. ]*/
+        release_io_slots(admitted_io->handle);
+        fail_queued_io(admitted_io);
+    }
+}
+
+/*returns IO_ADMISSION_ADMITTED, IO_ADMISSION_QUEUED (on_file_io_admitted_by_engine is called later) or IO_ADMISSION_ERROR*/
+static IO_ADMISSION_RESULT acquire_engine_io_slot(FILE_LINUX_ADMITTED_IO* admitted_io)
+{
+    IO_ADMISSION_RESULT result;
+    FILE_HANDLE handle = admitted_io->handle;
+
+    if (handle->engine_io_admission == NULL)
+    {
+        result = IO_ADMISSION_ADMITTED;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_LINUX_01_162: [ acquire_engine_io_slot shall call io_admission_acquire on the admission of the execution engine with on_file_io_admitted_by_engine as on_admitted. ]*/
+        admitted_io->admission_waiter.on_admitted = on_file_io_admitted_by_engine;
+        admitted_io->admission_waiter.on_admitted_context = admitted_io;
+        /*Codes_SRS_FILE_LINUX_01_193: [ acquire_io_slots and acquire_engine_io_slot shall call io_admission_acquire with the admission priority of the file handle as priority of the waiter. ]*/
+        admitted_io->admission_waiter.priority = handle->admission_priority;
+        result = io_admission_acquire(handle->engine_io_admission, &admitted_io->admission_waiter);
+        if (result == IO_ADMISSION_ERROR)
+        {
+            /*Codes_SRS_FILE_LINUX_01_163: [ If io_admission_acquire fails, acquire_engine_io_slot shall release the slot of the file handle admission. ]*/
+            LogError("failure in io_admission_acquire");
+            if (handle->io_admission != NULL)
+            {
+                io_admission_release(handle->io_admission);
+            }
+        }
+    }
+
+    return result;
+}
+
+static void on_file_io_admitted_by_handle(void* context)
+{
+    FILE_LINUX_ADMITTED_IO* admitted_io = context;
+
+    /*Codes_SRS_FILE_LINUX_01_164: [ on_file_io_admitted_by_handle shall call acquire_engine_io_slot. ]*/
+    IO_ADMISSION_RESULT admission_result = acquire_engine_io_slot(admitted_io);
+    if (admission_result == IO_ADMISSION_ADMITTED)
+    {
+        /*Codes_SRS_FILE_LINUX_01_165: [ If acquire_engine_io_slot returns IO_ADMISSION_ADMITTED, on_file_io_admitted_by_handle shall call on_file_io_admitted_by_engine. ]*/
+        on_file_io_admitted_by_engine(admitted_io);
+    }
+    else if (admission_result == IO_ADMISSION_QUEUED)
+    {
+        /*Codes_SRS_FILE_LINUX_01_166: [ If acquire_engine_io_slot returns IO_ADMISSION_QUEUED, on_file_io_admitted_by_handle shall return. ]*/
+    }
+    else
+    {
+        /*Codes_SRS_FILE_LINUX_01_167: [ If acquire_engine_io_slot fails, on_file_io_admitted_by_handle shall call fail_queued_io. ]*/
+        fail_queued_io(admitted_io);
+    }
+}
+
+/*returns IO_ADMISSION_ADMITTED (the I/O holds its slots or there is no limit), IO_ADMISSION_QUEUED (the I/O is submitted by on_file_io_admitted_by_handle or on_file_io_admitted_by_engine), IO_ADMISSION_BUSY or IO_ADMISSION_ERROR*/
+static IO_ADMISSION_RESULT acquire_io_slots(FILE_LINUX_ADMITTED_IO* admitted_io, FILE_IO_LIMIT_MODE io_limit_mode)
+{
+    IO_ADMISSION_RESULT result;
+    FILE_HANDLE handle = admitted_io->handle;
+
+    /*Codes_SRS_FILE_01_117: [ An I/O issued by file_write_async or file_read_async shall hold a slot of the I/O limit of handle and of the I/O limit of the execution engine from the moment it is started until it completes. ]*/
+    /*Codes_SRS_FILE_01_143: [ The I/Os of file_write_async_v, file_read_async_v and of the batches, the aggregated writes, the reads of read-ahead blocks and the flushes of handle shall also hold a slot of the I/O limit of handle and of the I/O limit of the execution engine from the moment they are started until they complete. ]*/
+    admitted_io->is_admitted = (handle->io_admission != NULL) || (handle->engine_io_admission != NULL);
+    if (!admitted_io->is_admitted)
+    {
+        /*Codes_SRS_FILE_LINUX_01_168: [ If neither the file handle nor the execution engine have an I/O limit, acquire_io_slots shall return IO_ADMISSION_ADMITTED. ]*/
+        result = IO_ADMISSION_ADMITTED;
+    }
+    else
+    {
+        if (handle->io_admission == NULL)
+        {
+            result = IO_ADMISSION_ADMITTED;
+        }
+        else if (io_limit_mode == FILE_IO_LIMIT_MODE_BUSY)
+        {
+            /*Codes_SRS_FILE_LINUX_01_169: [ If io_limit_mode is FILE_IO_LIMIT_MODE_BUSY, acquire_io_slots shall call io_admission_try_acquire on the admission of the file handle, if it exists. ]*/
+            result = io_admission_try_acquire(handle->io_admission);
+        }
+        else
+        {
+            /*Codes_SRS_FILE_LINUX_01_171: [ If io_limit_mode is FILE_IO_LIMIT_MODE_QUEUE, acquire_io_slots shall call io_admission_acquire on the admission of the file handle with on_file_io_admitted_by_handle as on_admitted, if it exists. ]*/
+            admitted_io->admission_waiter.on_admitted = on_file_io_admitted_by_handle;
+            admitted_io->admission_waiter.on_admitted_context = admitted_io;
+            /*Codes_SRS_FILE_LINUX_01_193: [ acquire_io_slots and acquire_engine_io_slot shall call io_admission_acquire with the admission priority of the file handle as priority of the waiter. ]*/
+            admitted_io->admission_waiter.priority = handle->admission_priority;
+            result = io_admission_acquire(handle->io_admission, &admitted_io->admission_waiter);
+        }
+
+        if (result == IO_ADMISSION_ADMITTED)
+        {
+            /*the I/O limit of the execution engine is shared by all the files, its waiters are always queued so that they are started in priority order, whatever the mode of handle*/
+            /*Codes_SRS_FILE_LINUX_01_172: [ If the file handle admission returns IO_ADMISSION_ADMITTED or the file handle has no I/O limit, acquire_io_slots shall call acquire_engine_io_slot, whatever the mode. ]*/
+            result = acquire_engine_io_slot(admitted_io);
+        }
+    }
+
+    return result;
+}
+
+static FILE_LINUX_START_IO_RESULT start_io(FILE_LINUX_ADMITTED_IO* admitted_io, FILE_IO_LIMIT_MODE io_limit_mode)
+{
+    FILE_LINUX_START_IO_RESULT result;
+
+    /*Codes_SRS_FILE_LINUX_01_239: [ start_io shall call acquire_io_slots with io_limit_mode. ]*/
+    IO_ADMISSION_RESULT admission_result = acquire_io_slots(admitted_io, io_limit_mode);
+    if (admission_result == IO_ADMISSION_ADMITTED)
+    {
+        /*Codes_SRS_FILE_LINUX_01_240: [ If acquire_io_slots returns IO_ADMISSION_ADMITTED, start_io shall call submit_io. ]*/
+        if (submit_io(admitted_io) != 0)
+        {
+            /*Codes_SRS_FILE_LINUX_01_173: [ If submit_io fails, start_io shall call release_io_slots if the I/O holds slots and return FILE_LINUX_START_IO_SUBMIT_ERROR. ]*/
+            if (admitted_io->is_admitted)
+            {
+                release_io_slots(admitted_io->handle);
+            }
+            result = FILE_LINUX_START_IO_SUBMIT_ERROR;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_LINUX_01_174: [ If the I/O holds its slots and submit_io succeeds, start_io shall return FILE_LINUX_START_IO_OK. ]*/
+            result = FILE_LINUX_START_IO_OK;
+        }
+    }
+    else if (admission_result == IO_ADMISSION_QUEUED)
+    {
+        /*Codes_SRS_FILE_01_119: [ When the mode is FILE_IO_LIMIT_MODE_QUEUE and no slot of the I/O limit of handle is free, or when no slot of the I/O limit of the execution engine is free, file_write_async and file_read_async shall queue the I/O and return FILE_WRITE_ASYNC_OK and FILE_READ_ASYNC_OK, the queued I/Os are started in order as slots are freed. ]*/
+        /*Codes_SRS_FILE_LINUX_01_175: [ If the I/O was queued, start_io shall return FILE_LINUX_START_IO_OK. ]*/
+        result = FILE_LINUX_START_IO_OK;
+    }
+    else if (admission_result == IO_ADMISSION_BUSY)
+    {
+        /*Codes_SRS_FILE_LINUX_01_176: [ If io_admission_try_acquire returns IO_ADMISSION_BUSY, start_io shall return FILE_LINUX_START_IO_BUSY. ]*/
+        result = FILE_LINUX_START_IO_BUSY;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_LINUX_01_177: [ If acquiring a slot fails, start_io shall return FILE_LINUX_START_IO_ERROR. ]*/
+        LogError("failure acquiring a slot for the I/O");
+        result = FILE_LINUX_START_IO_ERROR;
+    }
+
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, FILE_HANDLE, file_create, EXECUTION_ENGINE_HANDLE, execution_engine, const char*, full_file_name, FILE_REPORT_FAULT, user_report_fault_callback, void*, user_report_fault_context)
+{
+    FILE_HANDLE result;
+    if (
+        /*Codes_SRS_FILE_43_033: [ If execution_engine is NULL, file_create shall fail and return NULL. ]*/
+        /*Codes_SRS_FILE_LINUX_43_037: [ If execution_engine is NULL, file_create shall fail and return NULL. ]*/
+        (execution_engine == NULL) ||
+        /*Codes_SRS_FILE_43_002: [ If full_file_name is NULL then file_create shall fail and return NULL. ]*/
+        /*Codes_SRS_FILE_LINUX_43_038: [ If full_file_name is NULL then file_create shall fail and return NULL. ]*/
+        (full_file_name == NULL) ||
+        /*Codes_SRS_FILE_43_037: [ If full_file_name is an empty string, file_create shall fail and return NULL. ]*/
+        /*Codes_SRS_FILE_LINUX_43_050: [ If full_file_name is an empty string, file_create shall fail and return NULL. ]*/
+        (full_file_name[0] == '\0')
+        )
+    {
+        LogError("Invalid arguments to file_create: EXECUTION_ENGINE_HANDLE execution_engine=%p, const char* full_file_name=%s, FILE_REPORT_FAULT user_report_callback=%p, void* user_report_faul_context=%p",
+            execution_engine, MU_P_OR_NULL(full_file_name), user_report_fault_callback, user_report_fault_context);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_LINUX_43_029: [ file_create shall allocate a FILE_HANDLE. ]*/
+        result = malloc(sizeof(FILE_HANDLE_DATA));
+        if (result == NULL)
+        {
+            /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
+            /*Codes_SRS_FILE_LINUX_01_003: [ If there are any failures, file_create shall fail and return NULL. ]*/
+            LogError("Failure in malloc");
+        }
+        else
+        {
+            /*Codes_SRS_FILE_LINUX_01_001: [ file_create shall increment the reference count of execution_engine in order to hold on to it. ]*/
+            execution_engine_inc_ref(execution_engine);
+            result->execution_engine = execution_engine;
+
+            /*Codes_SRS_FILE_LINUX_01_002: [ file_create shall obtain the I/O ring of the execution engine by calling execution_engine_linux_get_io_ring. ]*/
+            result->io_ring = execution_engine_linux_get_io_ring(execution_engine);
+            if (result->io_ring == NULL)
+            {
+                /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
+                /*Codes_SRS_FILE_LINUX_01_003: [ If there are any failures, file_create shall fail and return NULL. ]*/
+                LogError("Failure in execution_engine_linux_get_io_ring, full_file_name=%s", full_file_name);
+            }
+            else
+            {
+                /*Codes_SRS_FILE_LINUX_01_043: [ file_create shall create a pool of I/O contexts by calling io_context_pool_create with a context size that fits an I/O with up to FILE_LINUX_POOLED_IOVEC_COUNT buffers and FILE_LINUX_IO_CONTEXT_POOL_SIZE as the maximum number of cached contexts. ]*/
+                result->io_context_pool = io_context_pool_create(FILE_LINUX_IO_CONTEXT_SIZE, FILE_LINUX_IO_CONTEXT_POOL_SIZE);
+                if (result->io_context_pool == NULL)
+                {
+                    /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
+                    /*Codes_SRS_FILE_LINUX_01_003: [ If there are any failures, file_create shall fail and return NULL. ]*/
+                    LogError("Failure in io_context_pool_create, full_file_name=%s", full_file_name);
+                }
+                else
+                {
+                    /*Codes_SRS_FILE_43_003: [ If a file with name full_file_name does not exist, file_create shall create a file with that name.]*/
+                    /*Codes_SRS_FILE_43_001: [ file_create shall open the file named full_file_name for asynchronous operations and return its handle. ]*/
+                    /*Codes_SRS_FILE_LINUX_43_001: [ file_create shall call open with full_file_name as pathname and flags O_CREAT, O_RDWR, O_DIRECT and O_LARGEFILE. ]*/
+                    result->h_file = open(full_file_name, O_CREAT | O_RDWR | O_DIRECT | O_LARGEFILE, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP);
+                    if (result->h_file == -1)
+                    {
+                        /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
+                        /*Codes_SRS_FILE_LINUX_01_003: [ If there are any failures, file_create shall fail and return NULL. ]*/
+                        LogError("Failure in open, full_file_name=%s, errno=%d", full_file_name, errno);
+                    }
+                    else
+                    {
+                        /*Codes_SRS_FILE_LINUX_43_002: [ file_create shall return the file handle returned by the call to open.]*/
+                        (void)interlocked_exchange(&result->pending_io_count, 0);
+
+                        /*Codes_SRS_FILE_LINUX_01_049: [ file_create shall initialize the list of flush requests as empty and mark the flush as not in progress. ]*/
+                        (void)interlocked_exchange_pointer(&result->flush_requests, NULL);
+                        (void)interlocked_exchange(&result->flush_in_progress, 0);
+                        result->flushing_requests = NULL;
+                        result->flush_io.io.on_io_complete = on_file_flush_complete_linux;
+                        result->flush_io.io.on_io_complete_context = result;
+                        result->flush_io.handle = result;
+
+                        /*Codes_SRS_FILE_LINUX_01_083: [ file_create shall set no preallocation policy on the file handle. ]*/
+                        result->preallocation_chunk_size = 0;
+                        result->preallocation_io.on_io_complete = on_file_preallocate_complete_linux;
+                        result->preallocation_io.on_io_complete_context = result;
+
+                        /*Codes_SRS_FILE_LINUX_01_101: [ file_create shall set no write aggregation policy on the file handle. ]*/
+                        result->write_aggregator = NULL;
+
+                        /*Codes_SRS_FILE_LINUX_01_128: [ file_create shall set no read-ahead policy on the file handle. ]*/
+                        result->read_ahead = NULL;
+
+                        /*Codes_SRS_FILE_LINUX_01_182: [ file_create shall obtain the I/O limit of the execution engine by calling execution_engine_linux_get_io_admission and set no I/O limit on the file handle, with the mode FILE_IO_LIMIT_MODE_QUEUE. ]*/
+                        result->engine_io_admission = execution_engine_linux_get_io_admission(execution_engine);
+                        result->io_admission = NULL;
+                        result->io_limit_mode = FILE_IO_LIMIT_MODE_QUEUE;
+                        result->is_io_limit_set = false;
+
+                        /*Codes_SRS_FILE_LINUX_01_190: [ file_create shall set the io_uring priority of the file handle to 0 and its admission priority to IO_ADMISSION_PRIORITY_NORMAL. ]*/
+                        result->ioprio = FILE_LINUX_IOPRIO_NORMAL;
+                        result->admission_priority = IO_ADMISSION_PRIORITY_NORMAL;
+
+                        result->user_report_fault_callback = user_report_fault_callback;
+                        result->user_report_fault_context = user_report_fault_context;
+                        goto all_ok;
+                    }
+                    io_context_pool_destroy(result->io_context_pool);
+                }
+            }
+            execution_engine_dec_ref(result->execution_engine);
+            free(result);
+        }
+        result = NULL;
+    }
+all_ok:
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, void, file_destroy, FILE_HANDLE, handle)
+{
+    if (handle == NULL)
+    {
+        /*Codes_SRS_FILE_43_005: [ If handle is NULL, file_destroy shall return. ]*/
+        /*Codes_SRS_FILE_LINUX_43_036: [ If handle is NULL, file_destroy shall return. ]*/
+        LogError("Invalid argument to file_destroy: FILE_HANDLE=%p", handle);
+    }
+    else
+    {
+        if (handle->write_aggregator != NULL)
+        {
+            /*Codes_SRS_FILE_LINUX_01_102: [ If a write aggregation policy is set, file_destroy shall call write_aggregator_flush to start writing the aggregated data that is not written yet. ]*/
+            write_aggregator_flush(handle->write_aggregator);
+        }
+
+        /*Codes_SRS_FILE_43_006: [ file_destroy shall wait for all pending I/O operations to complete. ]*/
+        /*Codes_SRS_FILE_LINUX_01_004: [ file_destroy shall wait for the number of pending I/O operations to reach 0 by calling wait_on_address. ]*/
+        int32_t pending_io_count;
+        while ((pending_io_count = interlocked_add(&handle->pending_io_count, 0)) != 0)
+        {
+            (void)wait_on_address(&handle->pending_io_count, pending_io_count, UINT32_MAX);
+        }
+
+        if (handle->write_aggregator != NULL)
+        {
+            /*Codes_SRS_FILE_LINUX_01_103: [ If a write aggregation policy is set, file_destroy shall call write_aggregator_destroy once all pending I/O operations completed. ]*/
+            write_aggregator_destroy(handle->write_aggregator);
+        }
+
+        if (handle->read_ahead != NULL)
+        {
+            /*Codes_SRS_FILE_LINUX_01_129: [ If a read-ahead policy is set, file_destroy shall call read_ahead_destroy once all pending I/O operations completed. ]*/
+            read_ahead_destroy(handle->read_ahead);
+        }
+
+        if (handle->io_admission != NULL)
+        {
+            /*Codes_SRS_FILE_LINUX_01_183: [ If an I/O limit is set on the file handle, file_destroy shall call io_admission_destroy once all pending I/O operations completed. ]*/
+            io_admission_destroy(handle->io_admission);
+        }
+
+        /*Codes_SRS_FILE_43_007: [ file_destroy shall close the file handle handle. ]*/
+        /*Codes_SRS_FILE_LINUX_43_003: [ file_destroy shall call close with fd as handle.]*/
+        if (close(handle->h_file) != 0)
+        {
+            LogError("failure in close, errno=%d", errno);
+        }
+
+        /*Codes_SRS_FILE_LINUX_01_044: [ file_destroy shall destroy the I/O context pool. ]*/
+        io_context_pool_destroy(handle->io_context_pool);
+
+        /*Codes_SRS_FILE_LINUX_01_005: [ file_destroy shall decrement the reference count for the execution engine. ]*/
+        execution_engine_dec_ref(handle->execution_engine);
 
-static void on_file_write_complete_linux( FILE_LINUX_WRITE* write_info);
-static void on_file_read_complete_linux( FILE_LINUX_READ* read_info);
+        /*Codes_SRS_FILE_LINUX_43_030: [ file_destroy shall free the FILE_HANDLE. ]*/
+        free(handle);
+    }
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, FILE_WRITE_ASYNC_RESULT, file_write_async, FILE_HANDLE, handle, const unsigned char*, source, uint32_t, size, uint64_t, position, FILE_CB, user_callback, void*, user_context)
+{
+    FILE_WRITE_ASYNC_RESULT result;
+    if
+    (
+        /*Codes_SRS_FILE_43_009: [ If handle is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_LINUX_43_031: [ If handle is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_43_010: [ If source is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_LINUX_43_032: [ If source is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_FILE_43_012: [ If user_callback is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_LINUX_43_033: [ If user_callback is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        (user_callback == NULL) ||
+        /*Codes_SRS_FILE_43_040: [ If position + size is greater than INT64_MAX, then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_LINUX_43_051: [ If position + size is greater than INT64_MAX, then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        ((position + size) > INT64_MAX) ||
+        /*Codes_SRS_FILE_43_042: [ If size is 0 then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_LINUX_43_048: [ If size is 0 then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        (size == 0)
+    )
+    {
+        LogError("Invalid arguments to file_write_async: FILE_HANDLE file_handle=%p, const unsigned char* source=%p, uin32_t size=%" PRIu32 ", uint64_t position=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
+            handle, source, size, position, user_callback, user_context);
+        result = FILE_WRITE_ASYNC_INVALID_ARGS;
+    }
+    else
+    {
+        if (handle->read_ahead != NULL)
+        {
+            /*Codes_SRS_FILE_01_100: [ When a read-ahead policy is set, file_write_async, file_write_async_v and file_batch_add_write shall drop the blocks that overlap the written range. ]*/
+            /*Codes_SRS_FILE_LINUX_01_130: [ If a read-ahead policy is set, file_write_async shall call read_ahead_invalidate with position and size. ]*/
+            read_ahead_invalidate(handle->read_ahead, position, size);
+        }
+
+        /*Codes_SRS_FILE_LINUX_01_104: [ If a write aggregation policy is set, file_write_async shall call write_aggregator_add with source, size, position, user_callback and user_context. ]*/
+        WRITE_AGGREGATOR_ADD_RESULT add_result = (handle->write_aggregator == NULL) ?
+            WRITE_AGGREGATOR_ADD_NOT_AGGREGATED :
+            write_aggregator_add(handle->write_aggregator, source, size, position, user_callback, user_context);
+
+        if (add_result == WRITE_AGGREGATOR_ADD_OK)
+        {
+            /*Codes_SRS_FILE_01_089: [ When a write aggregation policy is set, file_write_async shall copy writes smaller than max_aggregated_size that continue the previous write or start at an aligned position into the aggregation buffer and return FILE_WRITE_ASYNC_OK. ]*/
+            /*Codes_SRS_FILE_LINUX_01_105: [ If write_aggregator_add returns WRITE_AGGREGATOR_ADD_OK, file_write_async shall call preallocate_ahead_if_needed with position + size and return FILE_WRITE_ASYNC_OK. ]*/
+            preallocate_ahead_if_needed(handle, position + size);
+            result = FILE_WRITE_ASYNC_OK;
+        }
+        else if (add_result == WRITE_AGGREGATOR_ADD_ERROR)
+        {
+            /*Codes_SRS_FILE_LINUX_01_106: [ If write_aggregator_add returns WRITE_AGGREGATOR_ADD_ERROR, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
+            LogError("failure in write_aggregator_add, size=%" PRIu32 ", position=%" PRIu64 "", size, position);
+            result = FILE_WRITE_ASYNC_ERROR;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_LINUX_01_107: [ If no write aggregation policy is set or write_aggregator_add returns WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, file_write_async shall issue the write by itself. ]*/
+            /*Codes_SRS_FILE_LINUX_43_019: [ file_write_async shall get a struct to hold handle, source, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+            FILE_LINUX_IO* io_context = io_context_pool_get(handle->io_context_pool, sizeof(FILE_LINUX_IO));
+            if (io_context == NULL)
+            {
+                /*Codes_SRS_FILE_43_015: [ If there are any failures, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
+                /*Codes_SRS_FILE_LINUX_43_013: [ If there are any other failures, file_write_async shall return FILE_WRITE_ASYNC_ERROR. ]*/
+                LogError("failure in io_context_pool_get");
+                result = FILE_WRITE_ASYNC_ERROR;
+            }
+            else
+            {
+                FILE_LINUX_START_IO_RESULT start_result;
+
+                io_context->admitted_io.io.on_io_complete = on_file_io_complete_linux;
+                io_context->admitted_io.io.on_io_complete_context = io_context;
+                io_context->admitted_io.handle = handle;
+                /*Codes_SRS_FILE_LINUX_01_094: [ file_write_async shall set the write end of the I/O context to position + size, so that preallocate_ahead_if_needed is called with it once the write is submitted. ]*/
+                io_context->admitted_io.write_end = position + size;
+                io_context->user_callback = user_callback;
+                io_context->user_context = user_context;
+                io_context->size = size;
+                io_context->is_write = true;
+                io_context->position = position;
+
+                /*Codes_SRS_FILE_LINUX_01_006: [ file_write_async shall increment the number of pending I/O operations. ]*/
+                (void)interlocked_increment(&handle->pending_io_count);
+
+                /*Codes_SRS_FILE_43_014: [ file_write_async shall enqueue a write request to write source's content to the position offset in the file. ]*/
+                /*Codes_SRS_FILE_43_041: [ If position + size is greater than the size of the file and the call to write is successfull, file_write_async shall grow the file to accomodate the write. ]*/
+                /*Codes_SRS_FILE_LINUX_01_007: [ file_write_async shall call io_ring_linux_submit with a IORING_OP_WRITE entry for the file descriptor, source, size and position. ]*/
+                io_context->admitted_io.sqe.opcode = IORING_OP_WRITE;
+                /*Codes_SRS_FILE_LINUX_01_192: [ The IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READV and IORING_OP_WRITEV entries prepared for handle shall have the io_uring priority of handle as ioprio. ]*/
+                io_context->admitted_io.sqe.ioprio = handle->ioprio;
+                io_context->admitted_io.sqe.fd = handle->h_file;
+                io_context->admitted_io.sqe.offset = position;
+                io_context->admitted_io.sqe.address = (void*)source;
+                io_context->admitted_io.sqe.length = size;
+                io_context->admitted_io.sqe.op_flags = 0;
+                io_context->admitted_io.sqe.io = &io_context->admitted_io.io;
+
+                /*Codes_SRS_FILE_LINUX_01_178: [ file_write_async shall start the write by calling start_io with the mode of the file handle, which submits it once it holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+                start_result = start_io(&io_context->admitted_io, handle->io_limit_mode);
+                if (start_result == FILE_LINUX_START_IO_OK)
+                {
+                    /*Codes_SRS_FILE_43_008: [ file_write_async shall call user_call_back passing user_context and success depending on the success of the asynchronous write operation.]*/
+                    /*Codes_SRS_FILE_43_030: [ file_write_async shall succeed and return FILE_WRITE_ASYNC_OK. ]*/
+                    /*Codes_SRS_FILE_LINUX_43_007: [ If io_ring_linux_submit succeeds, file_write_async shall return FILE_WRITE_ASYNC_OK. ]*/
+                    result = FILE_WRITE_ASYNC_OK;
+                }
+                else
+                {
+                    if (interlocked_decrement(&handle->pending_io_count) == 0)
+                    {
+                        wake_by_address_single(&handle->pending_io_count);
+                    }
+                    io_context_pool_release(handle->io_context_pool, io_context);
+
+                    if (start_result == FILE_LINUX_START_IO_SUBMIT_ERROR)
+                    {
+                        /*Codes_SRS_FILE_43_035: [ If the call to write the file fails, file_write_async shall fail and return FILE_WRITE_ASYNC_WRITE_ERROR. ]*/
+                        /*Codes_SRS_FILE_LINUX_43_012: [ If io_ring_linux_submit fails, file_write_async shall decrement the number of pending I/O operations and return FILE_WRITE_ASYNC_WRITE_ERROR. ]*/
+                        LogError("failure in start_io, size=%" PRIu32 ", position=%" PRIu64 "", size, position);
+                        result = FILE_WRITE_ASYNC_WRITE_ERROR;
+                    }
+                    else if (start_result == FILE_LINUX_START_IO_BUSY)
+                    {
+                        /*Codes_SRS_FILE_01_118: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and no slot of the I/O limit of handle is free, file_write_async shall fail and return FILE_WRITE_ASYNC_BUSY and file_read_async shall fail and return FILE_READ_ASYNC_BUSY, without calling user_callback. ]*/
+                        /*Codes_SRS_FILE_LINUX_01_179: [ If start_io returns FILE_LINUX_START_IO_BUSY, file_write_async shall decrement the number of pending I/O operations, release the context and return FILE_WRITE_ASYNC_BUSY. ]*/
+                        result = FILE_WRITE_ASYNC_BUSY;
+                    }
+                    else
+                    {
+                        /*Codes_SRS_FILE_43_015: [ If there are any failures, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
+                        /*Codes_SRS_FILE_LINUX_43_013: [ If there are any other failures, file_write_async shall return FILE_WRITE_ASYNC_ERROR. ]*/
+                        LogError("failure in start_io, size=%" PRIu32 ", position=%" PRIu64 "", size, position);
+                        result = FILE_WRITE_ASYNC_ERROR;
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, FILE_READ_ASYNC_RESULT, file_read_async, FILE_HANDLE, handle, unsigned char*, destination, uint32_t, size, uint64_t, position, FILE_CB, user_callback, void*, user_context)
+{
+    FILE_READ_ASYNC_RESULT result;
+    if
+    (
+        /*Codes_SRS_FILE_43_017: [ If handle is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_LINUX_43_034: [ If handle is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_43_032: [ If destination is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_LINUX_43_043: [ If destination is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (destination == NULL) ||
+        /*Codes_SRS_FILE_43_020: [ If user_callback is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_LINUX_43_035: [ If user_callback is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (user_callback == NULL) ||
+        /*Codes_SRS_FILE_43_043: [ If size is 0 then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_LINUX_43_052: [ If size is 0 then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (size == 0)
+    )
+    {
+        LogError("Invalid arguments to file_read_async: FILE_HANDLE file_handle=%p, unsigned char* destination=%p, uin32_t size=%" PRIu32 ", uint64_t position=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
+            handle, destination, size, position, user_callback, user_context);
+        result = FILE_READ_ASYNC_INVALID_ARGS;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_LINUX_01_131: [ If a read-ahead policy is set, file_read_async shall call read_ahead_read with destination, size, position, user_callback and user_context. ]*/
+        READ_AHEAD_READ_RESULT read_ahead_result = (handle->read_ahead == NULL) ?
+            READ_AHEAD_READ_NOT_HANDLED :
+            read_ahead_read(handle->read_ahead, destination, size, position, user_callback, user_context);
+
+        if (read_ahead_result == READ_AHEAD_READ_OK)
+        {
+            /*Codes_SRS_FILE_01_098: [ When a read-ahead policy is set, file_read_async shall serve reads that fit in one block from the blocks of handle and, when the reads are sequential, keep up to block_count blocks following the read in flight. ]*/
+            /*Codes_SRS_FILE_LINUX_01_132: [ If read_ahead_read returns READ_AHEAD_READ_OK, file_read_async shall return FILE_READ_ASYNC_OK. ]*/
+            result = FILE_READ_ASYNC_OK;
+        }
+        else if (read_ahead_result == READ_AHEAD_READ_ERROR)
+        {
+            /*Codes_SRS_FILE_LINUX_01_133: [ If read_ahead_read returns READ_AHEAD_READ_ERROR, file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+            LogError("failure in read_ahead_read, size=%" PRIu32 ", position=%" PRIu64 "", size, position);
+            result = FILE_READ_ASYNC_ERROR;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_LINUX_43_045: [ file_read_async shall get a struct to hold handle, destination, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+            FILE_LINUX_IO* io_context = io_context_pool_get(handle->io_context_pool, sizeof(FILE_LINUX_IO));
+            if (io_context == NULL)
+            {
+                /*Codes_SRS_FILE_43_022: [ If there are any failures then file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+                /*Codes_SRS_FILE_LINUX_43_015: [ If there are any failures, file_read_async shall return FILE_READ_ASYNC_ERROR. ]*/
+                LogError("failure in io_context_pool_get");
+                result = FILE_READ_ASYNC_ERROR;
+            }
+            else
+            {
+                FILE_LINUX_START_IO_RESULT start_result;
+
+                io_context->admitted_io.io.on_io_complete = on_file_io_complete_linux;
+                io_context->admitted_io.io.on_io_complete_context = io_context;
+                io_context->admitted_io.handle = handle;
+                io_context->admitted_io.write_end = 0;
+                io_context->user_callback = user_callback;
+                io_context->user_context = user_context;
+                io_context->is_write = false;
+
+                /*Codes_SRS_FILE_LINUX_01_008: [ file_read_async shall increment the number of pending I/O operations. ]*/
+                (void)interlocked_increment(&handle->pending_io_count);
+
+                io_context->admitted_io.sqe.op_flags = 0;
+                io_context->admitted_io.sqe.io = &io_context->admitted_io.io;
+
+                if (read_ahead_result == READ_AHEAD_READ_COPIED)
+                {
+                    /*Codes_SRS_FILE_01_099: [ A read served from a block shall call user_callback asynchronously, after file_read_async returned. ]*/
+                    /*Codes_SRS_FILE_LINUX_01_134: [ If read_ahead_read returns READ_AHEAD_READ_COPIED, file_read_async shall call io_ring_linux_submit with an IORING_OP_NOP entry for 0 bytes, so that user_callback is called with is_successful as true when it completes. ]*/
+                    io_context->size = 0;
+                    /*the copy does not reach the device, it does not take a slot of the I/O limits*/
+                    io_context->admitted_io.is_admitted = false;
+
+                    io_context->admitted_io.sqe.opcode = IORING_OP_NOP;
+                    io_context->admitted_io.sqe.ioprio = 0;
+                    io_context->admitted_io.sqe.fd = -1;
+                    io_context->admitted_io.sqe.offset = 0;
+                    io_context->admitted_io.sqe.address = NULL;
+                    io_context->admitted_io.sqe.length = 0;
+
+                    start_result = (submit_io(&io_context->admitted_io) == 0) ? FILE_LINUX_START_IO_OK : FILE_LINUX_START_IO_SUBMIT_ERROR;
+                }
+                else
+                {
+                    /*Codes_SRS_FILE_LINUX_01_135: [ If no read-ahead policy is set or read_ahead_read returns READ_AHEAD_READ_NOT_HANDLED, file_read_async shall issue the read by itself. ]*/
+                    io_context->size = size;
+
+                    /*Codes_SRS_FILE_43_021: [ file_read_async shall enqueue a read request to read handle's content at position offset and write it to destination. ]*/
+                    /*Codes_SRS_FILE_43_039: [ If position + size exceeds the size of the file, user_callback shall be called with success as false. ]*/
+                    /*Codes_SRS_FILE_LINUX_01_009: [ file_read_async shall call io_ring_linux_submit with a IORING_OP_READ entry for the file descriptor, destination, size and position. ]*/
+                    io_context->admitted_io.sqe.opcode = IORING_OP_READ;
+                    /*Codes_SRS_FILE_LINUX_01_192: [ The IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READV and IORING_OP_WRITEV entries prepared for handle shall have the io_uring priority of handle as ioprio. ]*/
+                    io_context->admitted_io.sqe.ioprio = handle->ioprio;
+                    io_context->admitted_io.sqe.fd = handle->h_file;
+                    io_context->admitted_io.sqe.offset = position;
+                    io_context->admitted_io.sqe.address = destination;
+                    io_context->admitted_io.sqe.length = size;
+
+                    /*Codes_SRS_FILE_LINUX_01_180: [ file_read_async shall start the read by calling start_io with the mode of the file handle, which submits it once it holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+                    start_result = start_io(&io_context->admitted_io, handle->io_limit_mode);
+                }
+
+                if (start_result == FILE_LINUX_START_IO_OK)
+                {
+                    /*Codes_SRS_FILE_43_016: [ file_read_async shall call user_callback passing user_context and success depending on the success of the asynchronous read operation.]*/
+                    /*Codes_SRS_FILE_43_031: [ file_read_async shall succeed and return FILE_READ_ASYNC_OK. ]*/
+                    /*Codes_SRS_FILE_LINUX_43_014: [ If io_ring_linux_submit succeeds, file_read_async shall return FILE_READ_ASYNC_OK. ]*/
+                    result = FILE_READ_ASYNC_OK;
+                }
+                else
+                {
+                    if (interlocked_decrement(&handle->pending_io_count) == 0)
+                    {
+                        wake_by_address_single(&handle->pending_io_count);
+                    }
+                    io_context_pool_release(handle->io_context_pool, io_context);
+
+                    if (start_result == FILE_LINUX_START_IO_SUBMIT_ERROR)
+                    {
+                        /*Codes_SRS_FILE_43_036: [ If the call to read the file fails, file_read_async shall fail and return FILE_READ_ASYNC_READ_ERROR. ]*/
+                        /*Codes_SRS_FILE_LINUX_43_011: [ If io_ring_linux_submit fails, file_read_async shall decrement the number of pending I/O operations and return FILE_READ_ASYNC_READ_ERROR. ]*/
+                        LogError("failure in start_io, size=%" PRIu32 ", position=%" PRIu64 "", size, position);
+                        result = FILE_READ_ASYNC_READ_ERROR;
+                    }
+                    else if (start_result == FILE_LINUX_START_IO_BUSY)
+                    {
+                        /*Codes_SRS_FILE_01_118: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and no slot of the I/O limit of handle is free, file_write_async shall fail and return FILE_WRITE_ASYNC_BUSY and file_read_async shall fail and return FILE_READ_ASYNC_BUSY, without calling user_callback. ]*/
+                        /*Codes_SRS_FILE_LINUX_01_181: [ If start_io returns FILE_LINUX_START_IO_BUSY, file_read_async shall decrement the number of pending I/O operations, release the context and return FILE_READ_ASYNC_BUSY. ]*/
+                        result = FILE_READ_ASYNC_BUSY;
+                    }
+                    else
+                    {
+                        /*Codes_SRS_FILE_43_022: [ If there are any failures then file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+                        /*Codes_SRS_FILE_LINUX_43_015: [ If there are any failures, file_read_async shall return FILE_READ_ASYNC_ERROR. ]*/
+                        LogError("failure in start_io, size=%" PRIu32 ", position=%" PRIu64 "", size, position);
+                        result = FILE_READ_ASYNC_ERROR;
+                    }
+                }
+            }
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, FILE_WRITE_ASYNC_RESULT, file_write_async_v, FILE_HANDLE, handle, const FILE_BUFFER*, buffers, uint32_t, buffer_count, uint64_t, position, FILE_CB, user_callback, void*, user_context)
+{
+    FILE_WRITE_ASYNC_RESULT result;
+    uint32_t total_size = 0;
+    if
+    (
+        /*Codes_SRS_FILE_01_001: [ If handle is NULL then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_002: [ If buffers is NULL then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        (buffers == NULL) ||
+        /*Codes_SRS_FILE_01_003: [ If buffer_count is 0 then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        (buffer_count == 0) ||
+        /*Codes_SRS_FILE_LINUX_01_014: [ If buffer_count is greater than IOV_MAX then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        (buffer_count > IOV_MAX) ||
+        /*Codes_SRS_FILE_01_004: [ If user_callback is NULL then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        (user_callback == NULL) ||
+        /*Codes_SRS_FILE_01_005: [ If any of the buffers has a NULL buffer or a length of 0 then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_01_006: [ If the sum of the buffer lengths is greater than UINT32_MAX then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        !get_file_buffers_total_size(buffers, buffer_count, &total_size) ||
+        /*Codes_SRS_FILE_01_007: [ If position + the sum of the buffer lengths is greater than INT64_MAX, then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        ((position + total_size) > INT64_MAX)
+    )
+    {
+        LogError("Invalid arguments to file_write_async_v: FILE_HANDLE file_handle=%p, const FILE_BUFFER* buffers=%p, uint32_t buffer_count=%" PRIu32 ", uint64_t position=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
+            handle, buffers, buffer_count, position, user_callback, user_context);
+        result = FILE_WRITE_ASYNC_INVALID_ARGS;
+    }
+    else
+    {
+        if (handle->read_ahead != NULL)
+        {
+            /*Codes_SRS_FILE_LINUX_01_136: [ If a read-ahead policy is set, file_write_async_v shall call read_ahead_invalidate with position and the sum of the buffer lengths. ]*/
+            read_ahead_invalidate(handle->read_ahead, position, total_size);
+        }
+
+        if (handle->write_aggregator != NULL)
+        {
+            /*Codes_SRS_FILE_LINUX_01_227: [ If a write aggregation policy is set, file_write_async_v shall call write_aggregator_note_write with position and the sum of the buffer lengths. ]*/
+            write_aggregator_note_write(handle->write_aggregator, position, total_size);
+        }
+
+        /*Codes_SRS_FILE_LINUX_01_015: [ file_write_async_v shall get a struct to hold handle, an iovec for each buffer, the sum of the buffer lengths, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+        FILE_LINUX_IO* io_context = io_context_pool_get(handle->io_context_pool, sizeof(FILE_LINUX_IO) + buffer_count * sizeof(struct iovec));
+        if (io_context == NULL)
+        {
+            /*Codes_SRS_FILE_01_011: [ If there are any other failures, file_write_async_v shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
+            /*Codes_SRS_FILE_LINUX_01_019: [ If there are any other failures, file_write_async_v shall return FILE_WRITE_ASYNC_ERROR. ]*/
+            LogError("failure in io_context_pool_get, buffer_count=%" PRIu32 "", buffer_count);
+            result = FILE_WRITE_ASYNC_ERROR;
+        }
+        else
+        {
+            FILE_LINUX_START_IO_RESULT start_result;
+
+            io_context->admitted_io.io.on_io_complete = on_file_io_complete_linux;
+            io_context->admitted_io.io.on_io_complete_context = io_context;
+            io_context->admitted_io.handle = handle;
+            /*Codes_SRS_FILE_LINUX_01_095: [ file_write_async_v shall set the write end of the I/O context to position + the sum of the buffer lengths, so that preallocate_ahead_if_needed is called with it once the write is submitted. ]*/
+            io_context->admitted_io.write_end = position + total_size;
+            io_context->user_callback = user_callback;
+            io_context->user_context = user_context;
+            io_context->size = total_size;
+            io_context->is_write = true;
+            io_context->position = position;
+            for (uint32_t i = 0; i < buffer_count; i++)
+            {
+                io_context->iovecs[i].iov_base = buffers[i].buffer;
+                io_context->iovecs[i].iov_len = buffers[i].length;
+            }
+
+            /*Codes_SRS_FILE_LINUX_01_016: [ file_write_async_v shall increment the number of pending I/O operations. ]*/
+            (void)interlocked_increment(&handle->pending_io_count);
+
+            /*Codes_SRS_FILE_01_008: [ file_write_async_v shall enqueue a write request to write the contents of all the buffers, in order, starting at the position offset in the file. ]*/
+            /*Codes_SRS_FILE_LINUX_01_017: [ file_write_async_v shall prepare a IORING_OP_WRITEV entry for the file descriptor, the iovecs, buffer_count and position. ]*/
+            io_context->admitted_io.sqe.opcode = IORING_OP_WRITEV;
+            /*Codes_SRS_FILE_LINUX_01_192: [ The IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READV and IORING_OP_WRITEV entries prepared for handle shall have the io_uring priority of handle as ioprio. ]*/
+            io_context->admitted_io.sqe.ioprio = handle->ioprio;
+            io_context->admitted_io.sqe.fd = handle->h_file;
+            io_context->admitted_io.sqe.offset = position;
+            io_context->admitted_io.sqe.address = io_context->iovecs;
+            io_context->admitted_io.sqe.length = buffer_count;
+            io_context->admitted_io.sqe.op_flags = 0;
+            io_context->admitted_io.sqe.io = &io_context->admitted_io.io;
+
+            /*Codes_SRS_FILE_LINUX_01_247: [ file_write_async_v shall start the write by calling start_io with the mode of the file handle. ]*/
+            start_result = start_io(&io_context->admitted_io, handle->io_limit_mode);
+            if (start_result == FILE_LINUX_START_IO_OK)
+            {
+                /*Codes_SRS_FILE_01_010: [ file_write_async_v shall call user_callback passing user_context and is_successful as true if and only if all the bytes of all the buffers were written. ]*/
+                /*Codes_SRS_FILE_01_012: [ file_write_async_v shall succeed and return FILE_WRITE_ASYNC_OK. ]*/
+                /*Codes_SRS_FILE_LINUX_01_020: [ If start_io succeeds, file_write_async_v shall return FILE_WRITE_ASYNC_OK. ]*/
+                result = FILE_WRITE_ASYNC_OK;
+            }
+            else
+            {
+                if (interlocked_decrement(&handle->pending_io_count) == 0)
+                {
+                    wake_by_address_single(&handle->pending_io_count);
+                }
+                io_context_pool_release(handle->io_context_pool, io_context);
+
+                if (start_result == FILE_LINUX_START_IO_SUBMIT_ERROR)
+                {
+                    /*Codes_SRS_FILE_01_009: [ If the call to write the file fails, file_write_async_v shall fail and return FILE_WRITE_ASYNC_WRITE_ERROR. ]*/
+                    /*Codes_SRS_FILE_LINUX_01_018: [ If start_io returns FILE_LINUX_START_IO_SUBMIT_ERROR, file_write_async_v shall decrement the number of pending I/O operations, release the context and return FILE_WRITE_ASYNC_WRITE_ERROR. ]*/
+                    LogError("failure in start_io, buffer_count=%" PRIu32 ", position=%" PRIu64 "", buffer_count, position);
+                    result = FILE_WRITE_ASYNC_WRITE_ERROR;
+                }
+                else if (start_result == FILE_LINUX_START_IO_BUSY)
+                {
+                    /*Codes_SRS_FILE_01_144: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and no slot of the I/O limit of handle is free, file_write_async_v shall fail and return FILE_WRITE_ASYNC_BUSY and file_read_async_v shall fail and return FILE_READ_ASYNC_BUSY, without calling user_callback. ]*/
+                    /*Codes_SRS_FILE_LINUX_01_248: [ If start_io returns FILE_LINUX_START_IO_BUSY, file_write_async_v shall decrement the number of pending I/O operations, release the context and return FILE_WRITE_ASYNC_BUSY. ]*/
+                    result = FILE_WRITE_ASYNC_BUSY;
+                }
+                else
+                {
+                    /*Codes_SRS_FILE_01_011: [ If there are any other failures, file_write_async_v shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
+                    /*Codes_SRS_FILE_LINUX_01_019: [ If there are any other failures, file_write_async_v shall return FILE_WRITE_ASYNC_ERROR. ]*/
+                    LogError("failure in start_io, buffer_count=%" PRIu32 ", position=%" PRIu64 "", buffer_count, position);
+                    result = FILE_WRITE_ASYNC_ERROR;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, FILE_READ_ASYNC_RESULT, file_read_async_v, FILE_HANDLE, handle, const FILE_BUFFER*, buffers, uint32_t, buffer_count, uint64_t, position, FILE_CB, user_callback, void*, user_context)
+{
+    FILE_READ_ASYNC_RESULT result;
+    uint32_t total_size = 0;
+    if
+    (
+        /*Codes_SRS_FILE_01_013: [ If handle is NULL then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_014: [ If buffers is NULL then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (buffers == NULL) ||
+        /*Codes_SRS_FILE_01_015: [ If buffer_count is 0 then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (buffer_count == 0) ||
+        /*Codes_SRS_FILE_LINUX_01_021: [ If buffer_count is greater than IOV_MAX then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (buffer_count > IOV_MAX) ||
+        /*Codes_SRS_FILE_01_016: [ If user_callback is NULL then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (user_callback == NULL) ||
+        /*Codes_SRS_FILE_01_017: [ If any of the buffers has a NULL buffer or a length of 0 then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_01_018: [ If the sum of the buffer lengths is greater than UINT32_MAX then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        !get_file_buffers_total_size(buffers, buffer_count, &total_size)
+    )
+    {
+        LogError("Invalid arguments to file_read_async_v: FILE_HANDLE file_handle=%p, const FILE_BUFFER* buffers=%p, uint32_t buffer_count=%" PRIu32 ", uint64_t position=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
+            handle, buffers, buffer_count, position, user_callback, user_context);
+        result = FILE_READ_ASYNC_INVALID_ARGS;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_LINUX_01_022: [ file_read_async_v shall get a struct to hold handle, an iovec for each buffer, the sum of the buffer lengths, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+        FILE_LINUX_IO* io_context = io_context_pool_get(handle->io_context_pool, sizeof(FILE_LINUX_IO) + buffer_count * sizeof(struct iovec));
+        if (io_context == NULL)
+        {
+            /*Codes_SRS_FILE_01_022: [ If there are any other failures, file_read_async_v shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+            /*Codes_SRS_FILE_LINUX_01_026: [ If there are any other failures, file_read_async_v shall return FILE_READ_ASYNC_ERROR. ]*/
+            LogError("failure in io_context_pool_get, buffer_count=%" PRIu32 "", buffer_count);
+            result = FILE_READ_ASYNC_ERROR;
+        }
+        else
+        {
+            FILE_LINUX_START_IO_RESULT start_result;
+
+            io_context->admitted_io.io.on_io_complete = on_file_io_complete_linux;
+            io_context->admitted_io.io.on_io_complete_context = io_context;
+            io_context->admitted_io.handle = handle;
+            io_context->admitted_io.write_end = 0;
+            io_context->user_callback = user_callback;
+            io_context->user_context = user_context;
+            io_context->size = total_size;
+            io_context->is_write = false;
+            for (uint32_t i = 0; i < buffer_count; i++)
+            {
+                io_context->iovecs[i].iov_base = buffers[i].buffer;
+                io_context->iovecs[i].iov_len = buffers[i].length;
+            }
+
+            /*Codes_SRS_FILE_LINUX_01_023: [ file_read_async_v shall increment the number of pending I/O operations. ]*/
+            (void)interlocked_increment(&handle->pending_io_count);
+
+            /*Codes_SRS_FILE_01_019: [ file_read_async_v shall enqueue a read request to read handle's content starting at the position offset into all the buffers, in order. ]*/
+            /*Codes_SRS_FILE_LINUX_01_024: [ file_read_async_v shall prepare a IORING_OP_READV entry for the file descriptor, the iovecs, buffer_count and position. ]*/
+            io_context->admitted_io.sqe.opcode = IORING_OP_READV;
+            /*Codes_SRS_FILE_LINUX_01_192: [ The IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READV and IORING_OP_WRITEV entries prepared for handle shall have the io_uring priority of handle as ioprio. ]*/
+            io_context->admitted_io.sqe.ioprio = handle->ioprio;
+            io_context->admitted_io.sqe.fd = handle->h_file;
+            io_context->admitted_io.sqe.offset = position;
+            io_context->admitted_io.sqe.address = io_context->iovecs;
+            io_context->admitted_io.sqe.length = buffer_count;
+            io_context->admitted_io.sqe.op_flags = 0;
+            io_context->admitted_io.sqe.io = &io_context->admitted_io.io;
+
+            /*Codes_SRS_FILE_LINUX_01_249: [ file_read_async_v shall start the read by calling start_io with the mode of the file handle. ]*/
+            start_result = start_io(&io_context->admitted_io, handle->io_limit_mode);
+            if (start_result == FILE_LINUX_START_IO_OK)
+            {
+                /*Codes_SRS_FILE_01_021: [ file_read_async_v shall call user_callback passing user_context and is_successful as true if and only if all the buffers were filled. If position + the sum of the buffer lengths exceeds the size of the file, user_callback shall be called with is_successful as false. ]*/
+                /*Codes_SRS_FILE_01_023: [ file_read_async_v shall succeed and return FILE_READ_ASYNC_OK. ]*/
+                /*Codes_SRS_FILE_LINUX_01_027: [ If start_io succeeds, file_read_async_v shall return FILE_READ_ASYNC_OK. ]*/
+                result = FILE_READ_ASYNC_OK;
+            }
+            else
+            {
+                if (interlocked_decrement(&handle->pending_io_count) == 0)
+                {
+                    wake_by_address_single(&handle->pending_io_count);
+                }
+                io_context_pool_release(handle->io_context_pool, io_context);
+
+                if (start_result == FILE_LINUX_START_IO_SUBMIT_ERROR)
+                {
+                    /*Codes_SRS_FILE_01_020: [ If the call to read the file fails, file_read_async_v shall fail and return FILE_READ_ASYNC_READ_ERROR. ]*/
+                    /*Codes_SRS_FILE_LINUX_01_025: [ If start_io returns FILE_LINUX_START_IO_SUBMIT_ERROR, file_read_async_v shall decrement the number of pending I/O operations, release the context and return FILE_READ_ASYNC_READ_ERROR. ]*/
+                    LogError("failure in start_io, buffer_count=%" PRIu32 ", position=%" PRIu64 "", buffer_count, position);
+                    result = FILE_READ_ASYNC_READ_ERROR;
+                }
+                else if (start_result == FILE_LINUX_START_IO_BUSY)
+                {
+                    /*Codes_SRS_FILE_01_144: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and no slot of the I/O limit of handle is free, file_write_async_v shall fail and return FILE_WRITE_ASYNC_BUSY and file_read_async_v shall fail and return FILE_READ_ASYNC_BUSY, without calling user_callback. ]*/
+                    /*Codes_SRS_FILE_LINUX_01_250: [ If start_io returns FILE_LINUX_START_IO_BUSY, file_read_async_v shall decrement the number of pending I/O operations, release the context and return FILE_READ_ASYNC_BUSY. ]*/
+                    result = FILE_READ_ASYNC_BUSY;
+                }
+                else
+                {
+                    /*Codes_SRS_FILE_01_022: [ If there are any other failures, file_read_async_v shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+                    /*Codes_SRS_FILE_LINUX_01_026: [ If there are any other failures, file_read_async_v shall return FILE_READ_ASYNC_ERROR. ]*/
+                    LogError("failure in start_io, buffer_count=%" PRIu32 ", position=%" PRIu64 "", buffer_count, position);
+                    result = FILE_READ_ASYNC_ERROR;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+static int file_batch_add(FILE_BATCH_HANDLE batch, uint8_t opcode, void* buffer, uint32_t size, uint64_t position, FILE_CB user_callback, void* user_context)
+{
+    int result;
+    FILE_LINUX_IO* io_context = io_context_pool_get(batch->handle->io_context_pool, sizeof(FILE_LINUX_IO));
+    if (io_context == NULL)
+    {
+        LogError("failure in io_context_pool_get");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        IO_RING_LINUX_SQE* sqe = &io_context->admitted_io.sqe;
+
+        io_context->admitted_io.io.on_io_complete = on_file_io_complete_linux;
+        io_context->admitted_io.io.on_io_complete_context = io_context;
+        io_context->admitted_io.handle = batch->handle;
+        io_context->admitted_io.is_admitted = false;
+        /*a write queued for a slot preallocates when it is submitted, the writes submitted with the batch preallocate once in file_batch_submit*/
+        io_context->admitted_io.write_end = (opcode == IORING_OP_WRITE) ? position + size : 0;
+        io_context->user_callback = user_callback;
+        io_context->user_context = user_context;
+        io_context->size = size;
+        io_context->is_write = (opcode == IORING_OP_WRITE);
+        io_context->position = position;
+
+        sqe->opcode = opcode;
+        /*Codes_SRS_FILE_LINUX_01_192: [ The IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READV and IORING_OP_WRITEV entries prepared for handle shall have the io_uring priority of handle as ioprio. ]*/
+        sqe->ioprio = batch->handle->ioprio;
+        sqe->fd = batch->handle->h_file;
+        sqe->offset = position;
+        sqe->address = buffer;
+        sqe->length = size;
+        sqe->op_flags = 0;
+        sqe->io = &io_context->admitted_io.io;
+
+        batch->sqes[batch->io_count] = *sqe;
+        batch->io_count++;
+        result = 0;
+    }
+    return result;
+}
+
+static void file_batch_free_ios(FILE_BATCH_HANDLE batch, uint32_t first_io, uint32_t end_io)
+{
+    for (uint32_t i = first_io; i < end_io; i++)
+    {
+        FILE_LINUX_IO* io_context = batch->sqes[i].io->on_io_complete_context;
+        if (io_context->admitted_io.is_admitted)
+        {
+            release_io_slots(batch->handle);
+        }
+        io_context_pool_release(batch->handle->io_context_pool, io_context);
+    }
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, FILE_BATCH_HANDLE, file_batch_begin, FILE_HANDLE, handle, uint32_t, max_io_count)
+{
+    FILE_BATCH_HANDLE result;
+    if (
+        /*Codes_SRS_FILE_01_024: [ If handle is NULL then file_batch_begin shall fail and return NULL. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_025: [ If max_io_count is 0 then file_batch_begin shall fail and return NULL. ]*/
+        (max_io_count == 0)
+        )
+    {
+        LogError("Invalid arguments to file_batch_begin: FILE_HANDLE handle=%p, uint32_t max_io_count=%" PRIu32 "",
+            handle, max_io_count);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_026: [ file_batch_begin shall create a batch that can hold up to max_io_count I/Os and return it. ]*/
+        /*Codes_SRS_FILE_LINUX_01_028: [ file_batch_begin shall allocate a batch with room for max_io_count submission queue entries. ]*/
+        result = malloc(sizeof(FILE_BATCH) + max_io_count * sizeof(IO_RING_LINUX_SQE));
+        if (result == NULL)
+        {
+            /*Codes_SRS_FILE_01_027: [ If there are any failures, file_batch_begin shall fail and return NULL. ]*/
+            /*Codes_SRS_FILE_LINUX_01_029: [ If there are any failures, file_batch_begin shall fail and return NULL. ]*/
+            LogError("failure in malloc, max_io_count=%" PRIu32 "", max_io_count);
+        }
+        else
+        {
+            result->handle = handle;
+            result->max_io_count = max_io_count;
+            result->io_count = 0;
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_batch_add_write, FILE_BATCH_HANDLE, batch, const unsigned char*, source, uint32_t, size, uint64_t, position, FILE_CB, user_callback, void*, user_context)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_028: [ If batch is NULL then file_batch_add_write shall fail and return a non-zero value. ]*/
+        (batch == NULL) ||
+        /*Codes_SRS_FILE_01_029: [ If source is NULL then file_batch_add_write shall fail and return a non-zero value. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_FILE_01_030: [ If size is 0 then file_batch_add_write shall fail and return a non-zero value. ]*/
+        (size == 0) ||
+        /*Codes_SRS_FILE_01_031: [ If user_callback is NULL then file_batch_add_write shall fail and return a non-zero value. ]*/
+        (user_callback == NULL) ||
+        /*Codes_SRS_FILE_01_032: [ If position + size is greater than INT64_MAX then file_batch_add_write shall fail and return a non-zero value. ]*/
+        ((position + size) > INT64_MAX)
+        )
+    {
+        LogError("Invalid arguments to file_batch_add_write: FILE_BATCH_HANDLE batch=%p, const unsigned char* source=%p, uint32_t size=%" PRIu32 ", uint64_t position=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
+            batch, source, size, position, user_callback, user_context);
+        result = MU_FAILURE;
+    }
+    /*Codes_SRS_FILE_01_033: [ If batch already holds max_io_count I/Os then file_batch_add_write shall fail and return a non-zero value. ]*/
+    else if (batch->io_count == batch->max_io_count)
+    {
+        LogError("batch=%p is full, it already holds %" PRIu32 " I/Os", batch, batch->io_count);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        if (batch->handle->read_ahead != NULL)
+        {
+            /*Codes_SRS_FILE_LINUX_01_137: [ If a read-ahead policy is set, file_batch_add_write shall call read_ahead_invalidate with position and size. ]*/
+            read_ahead_invalidate(batch->handle->read_ahead, position, size);
+        }
+
+        if (batch->handle->write_aggregator != NULL)
+        {
+            /*Codes_SRS_FILE_LINUX_01_228: [ If a write aggregation policy is set, file_batch_add_write shall call write_aggregator_note_write with position and size. ]*/
+            write_aggregator_note_write(batch->handle->write_aggregator, position, size);
+        }
+
+        /*Codes_SRS_FILE_01_034: [ file_batch_add_write shall queue in batch a write request to write source's content to the position offset in the file. ]*/
+        /*Codes_SRS_FILE_LINUX_01_030: [ file_batch_add_write shall get a struct to hold the file handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+        /*Codes_SRS_FILE_LINUX_01_031: [ file_batch_add_write shall fill the next entry of the batch with IORING_OP_WRITE for the file descriptor, source, size and position. ]*/
+        if (file_batch_add(batch, IORING_OP_WRITE, (void*)source, size, position, user_callback, user_context) != 0)
+        {
+            /*Codes_SRS_FILE_01_035: [ If there are any other failures, file_batch_add_write shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_LINUX_01_032: [ If there are any failures, file_batch_add_write shall fail and return a non-zero value. ]*/
+            LogError("file_batch_add failed");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_01_036: [ file_batch_add_write shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_batch_add_read, FILE_BATCH_HANDLE, batch, unsigned char*, destination, uint32_t, size, uint64_t, position, FILE_CB, user_callback, void*, user_context)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_037: [ If batch is NULL then file_batch_add_read shall fail and return a non-zero value. ]*/
+        (batch == NULL) ||
+        /*Codes_SRS_FILE_01_038: [ If destination is NULL then file_batch_add_read shall fail and return a non-zero value. ]*/
+        (destination == NULL) ||
+        /*Codes_SRS_FILE_01_039: [ If size is 0 then file_batch_add_read shall fail and return a non-zero value. ]*/
+        (size == 0) ||
+        /*Codes_SRS_FILE_01_040: [ If user_callback is NULL then file_batch_add_read shall fail and return a non-zero value. ]*/
+        (user_callback == NULL)
+        )
+    {
+        LogError("Invalid arguments to file_batch_add_read: FILE_BATCH_HANDLE batch=%p, unsigned char* destination=%p, uint32_t size=%" PRIu32 ", uint64_t position=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
+            batch, destination, size, position, user_callback, user_context);
+        result = MU_FAILURE;
+    }
+    /*Codes_SRS_FILE_01_041: [ If batch already holds max_io_count I/Os then file_batch_add_read shall fail and return a non-zero value. ]*/
+    else if (batch->io_count == batch->max_io_count)
+    {
+        LogError("batch=%p is full, it already holds %" PRIu32 " I/Os", batch, batch->io_count);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_042: [ file_batch_add_read shall queue in batch a read request to read handle's content at the position offset into destination. ]*/
+        /*Codes_SRS_FILE_LINUX_01_033: [ file_batch_add_read shall get a struct to hold the file handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+        /*Codes_SRS_FILE_LINUX_01_034: [ file_batch_add_read shall fill the next entry of the batch with IORING_OP_READ for the file descriptor, destination, size and position. ]*/
+        if (file_batch_add(batch, IORING_OP_READ, destination, size, position, user_callback, user_context) != 0)
+        {
+            /*Codes_SRS_FILE_01_043: [ If there are any other failures, file_batch_add_read shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_LINUX_01_035: [ If there are any failures, file_batch_add_read shall fail and return a non-zero value. ]*/
+            LogError("file_batch_add failed");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_01_044: [ file_batch_add_read shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_batch_submit, FILE_BATCH_HANDLE, batch, uint32_t*, submitted_count)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_045: [ If batch is NULL then file_batch_submit shall fail and return a non-zero value. ]*/
+        (batch == NULL) ||
+        /*Codes_SRS_FILE_01_046: [ If submitted_count is NULL then file_batch_submit shall fail and return a non-zero value. ]*/
+        (submitted_count == NULL)
+        )
+    {
+        LogError("Invalid arguments to file_batch_submit: FILE_BATCH_HANDLE batch=%p, uint32_t* submitted_count=%p",
+            batch, submitted_count);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        if (batch->io_count == 0)
+        {
+            /*Codes_SRS_FILE_01_047: [ If batch holds no I/Os then file_batch_submit shall set submitted_count to 0, free batch and return 0. ]*/
+            *submitted_count = 0;
+            result = 0;
+        }
+        else
+        {
+            FILE_HANDLE handle = batch->handle;
+            bool has_reserved_slots = false;
+            bool is_successful = true;
+            uint32_t started_count = 0; /*the I/Os of the batch that went through admission, the others were not issued*/
+            uint32_t admitted_count = 0; /*the I/Os that hold their slots are moved to the start of sqes to be submitted together*/
+            uint32_t queued_count = 0; /*the I/Os queued for a slot are submitted once they hold their slots and count as issued*/
+            uint32_t ring_submitted_count = 0;
+
+            /*Codes_SRS_FILE_LINUX_01_036: [ file_batch_submit shall add the number of I/Os in the batch to the number of pending I/O operations. ]*/
+            (void)interlocked_add(&handle->pending_io_count, (int32_t)batch->io_count);
+
+            if (
+                (handle->io_admission != NULL) &&
+                (handle->io_limit_mode == FILE_IO_LIMIT_MODE_BUSY)
+                )
+            {
+                uint32_t reserved_count = 0;
+
+                /*Codes_SRS_FILE_LINUX_01_251: [ If the file handle has an I/O limit in FILE_IO_LIMIT_MODE_BUSY, file_batch_submit shall call io_admission_try_acquire on the admission of the file handle once for each I/O in the batch. ]*/
+                while (
+                    (reserved_count < batch->io_count) &&
+                    (io_admission_try_acquire(handle->io_admission) == IO_ADMISSION_ADMITTED)
+                    )
+                {
+                    reserved_count++;
+                }
+
+                if (reserved_count < batch->io_count)
+                {
+                    /*Codes_SRS_FILE_01_145: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and the I/O limit of handle does not have a free slot for each of the I/Os of batch, file_batch_submit shall discard all the I/Os of batch without calling their user_callback, set submitted_count to 0, free batch and return a non-zero value. ]*/
+                    /*Codes_SRS_FILE_LINUX_01_252: [ If io_admission_try_acquire does not return IO_ADMISSION_ADMITTED for each I/O, file_batch_submit shall call io_admission_release for each acquired slot, release the structs of all the I/Os to the I/O context pool, subtract their number from the number of pending I/O operations (waking up file_destroy if it reaches 0), set submitted_count to 0 and return a non-zero value. ]*/
+                    LogError("the I/O limit of the file handle does not have %" PRIu32 " free slots for the batch, it has %" PRIu32 "", batch->io_count, reserved_count);
+                    for (uint32_t i = 0; i < reserved_count; i++)
+                    {
+                        io_admission_release(handle->io_admission);
+                    }
+                    is_successful = false;
+                }
+                else
+                {
+                    has_reserved_slots = true;
+                }
+            }
+
+            /*Codes_SRS_FILE_01_048: [ file_batch_submit shall issue all the I/Os queued in batch, in the order in which they were added. ]*/
+            /*Codes_SRS_FILE_01_049: [ file_batch_submit shall call the user_callback of each issued I/O passing its user_context and is_successful as true if and only if all its bytes were transferred. ]*/
+            while (
+                is_successful &&
+                (started_count < batch->io_count)
+                )
+            {
+                FILE_LINUX_IO* io_context = batch->sqes[started_count].io->on_io_complete_context;
+                IO_ADMISSION_RESULT admission_result;
+
+                if (has_reserved_slots)
+                {
+                    /*Codes_SRS_FILE_LINUX_01_253: [ If the slots of the file handle were acquired for the batch, file_batch_submit shall call acquire_engine_io_slot for each I/O. ]*/
+                    io_context->admitted_io.is_admitted = true;
+                    admission_result = acquire_engine_io_slot(&io_context->admitted_io);
+                }
+                else
+                {
+                    /*Codes_SRS_FILE_LINUX_01_254: [ Otherwise file_batch_submit shall call acquire_io_slots with the mode of the file handle for each I/O. ]*/
+                    admission_result = acquire_io_slots(&io_context->admitted_io, handle->io_limit_mode);
+                }
+
+                if (admission_result == IO_ADMISSION_ADMITTED)
+                {
+                    batch->sqes[admitted_count] = batch->sqes[started_count];
+                    admitted_count++;
+                    started_count++;
+                }
+                else if (admission_result == IO_ADMISSION_QUEUED)
+                {
+                    /*Codes_SRS_FILE_01_146: [ An I/O of a batch that waits for a slot of the I/O limits shall be queued and counted as issued by file_batch_submit. ]*/
+                    /*Codes_SRS_FILE_LINUX_01_255: [ An I/O queued for a slot shall count as submitted, it is submitted by on_file_io_admitted_by_handle or on_file_io_admitted_by_engine. ]*/
+                    queued_count++;
+                    started_count++;
+                }
+                else
+                {
+                    /*Codes_SRS_FILE_01_050: [ If issuing an I/O fails, file_batch_submit shall not issue the I/Os that follow it, discard all the I/Os that were not issued without calling their user_callback, set submitted_count to the number of issued I/Os and return a non-zero value. ]*/
+                    /*Codes_SRS_FILE_LINUX_01_256: [ If acquiring the slots of an I/O fails, file_batch_submit shall release the slots of the file handle acquired for the I/Os that follow it, not start them and submit the I/Os that hold their slots. ]*/
+                    LogError("failure acquiring the slots of I/O %" PRIu32 " of the batch", started_count);
+                    if (has_reserved_slots)
+                    {
+                        for (uint32_t i = started_count + 1; i < batch->io_count; i++)
+                        {
+                            io_admission_release(handle->io_admission);
+                        }
+                    }
+                    is_successful = false;
+                }
+            }
+
+            if (admitted_count != 0)
+            {
+                /*Codes_SRS_FILE_LINUX_01_037: [ file_batch_submit shall call io_ring_linux_submit once with the entries of all the I/Os of the batch that hold their slots. ]*/
+                if (io_ring_linux_submit(handle->io_ring, batch->sqes, admitted_count, &ring_submitted_count) != 0)
+                {
+                    LogError("failure in io_ring_linux_submit, submitted %" PRIu32 " out of %" PRIu32 " I/Os", ring_submitted_count, admitted_count);
+                    is_successful = false;
+                }
+            }
+
+            if (!is_successful)
+            {
+                /*Codes_SRS_FILE_LINUX_01_038: [ If io_ring_linux_submit fails, file_batch_submit shall release the slots and the structs of the I/Os that were not submitted to the I/O context pool, subtract their number from the number of pending I/O operations (waking up file_destroy if it reaches 0), set submitted_count to the number of submitted I/Os and return a non-zero value. ]*/
+                uint32_t issued_count = ring_submitted_count + queued_count;
+
+                file_batch_free_ios(batch, ring_submitted_count, admitted_count);
+                for (uint32_t i = started_count; i < batch->io_count; i++)
+                {
+                    io_context_pool_release(handle->io_context_pool, batch->sqes[i].io->on_io_complete_context);
+                }
+
+                if (interlocked_add(&handle->pending_io_count, -(int32_t)(batch->io_count - issued_count)) == 0)
+                {
+                    wake_by_address_single(&handle->pending_io_count);
+                }
+                *submitted_count = issued_count;
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /*Codes_SRS_FILE_01_052: [ On success file_batch_submit shall set submitted_count to the number of I/Os in batch and return 0. ]*/
+                uint64_t write_end = 0;
+                for (uint32_t i = 0; i < admitted_count; i++)
+                {
+                    if (
+                        (batch->sqes[i].opcode == IORING_OP_WRITE) &&
+                        (batch->sqes[i].offset + batch->sqes[i].length > write_end)
+                        )
+                    {
+                        write_end = batch->sqes[i].offset + batch->sqes[i].length;
+                    }
+                }
+
+                /*Codes_SRS_FILE_LINUX_01_096: [ If io_ring_linux_submit succeeds and the submitted entries hold writes, file_batch_submit shall call preallocate_ahead_if_needed with the highest end of these writes. ]*/
+                if (write_end != 0)
+                {
+                    preallocate_ahead_if_needed(handle, write_end);
+                }
+
+                /*Codes_SRS_FILE_LINUX_01_040: [ If all the I/Os of the batch were submitted or queued, file_batch_submit shall set submitted_count to the number of I/Os in the batch and return 0. ]*/
+                *submitted_count = batch->io_count;
+                result = 0;
+            }
+        }
+
+        /*Codes_SRS_FILE_01_051: [ file_batch_submit shall free batch. ]*/
+        /*Codes_SRS_FILE_LINUX_01_039: [ file_batch_submit shall free the batch. ]*/
+        free(batch);
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, void, file_batch_cancel, FILE_BATCH_HANDLE, batch)
+{
+    if (batch == NULL)
+    {
+        /*Codes_SRS_FILE_01_053: [ If batch is NULL then file_batch_cancel shall return. ]*/
+        /*Codes_SRS_FILE_LINUX_01_041: [ If batch is NULL then file_batch_cancel shall return. ]*/
+        LogError("Invalid arguments to file_batch_cancel: FILE_BATCH_HANDLE batch=%p", batch);
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_054: [ file_batch_cancel shall discard all the I/Os queued in batch without calling their user_callback and free batch. ]*/
+        /*Codes_SRS_FILE_LINUX_01_042: [ file_batch_cancel shall release the structs of all the I/Os in the batch to the I/O context pool and free the batch. ]*/
+        file_batch_free_ios(batch, 0, batch->io_count);
+        free(batch);
+    }
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_flush_async, FILE_HANDLE, handle, FILE_CB, user_callback, void*, user_context)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_058: [ If handle is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+        /*Codes_SRS_FILE_LINUX_01_050: [ If handle is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_059: [ If user_callback is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+        /*Codes_SRS_FILE_LINUX_01_051: [ If user_callback is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+        (user_callback == NULL)
+        )
+    {
+        LogError("Invalid arguments to file_flush_async: FILE_HANDLE handle=%p, FILE_CB user_callback=%p, void* user_context=%p",
+            handle, user_callback, user_context);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_LINUX_01_052: [ file_flush_async shall get a flush request to hold user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+        FILE_LINUX_FLUSH_REQUEST* request = io_context_pool_get(handle->io_context_pool, sizeof(FILE_LINUX_FLUSH_REQUEST));
+        if (request == NULL)
+        {
+            /*Codes_SRS_FILE_01_063: [ If there are any other failures, file_flush_async shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_LINUX_01_053: [ If there are any failures, file_flush_async shall fail and return a non-zero value. ]*/
+            LogError("failure in io_context_pool_get");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            void* current_requests = NULL;
+            void* previous_requests;
+
+            request->user_callback = user_callback;
+            request->user_context = user_context;
+
+            /*Codes_SRS_FILE_LINUX_01_054: [ file_flush_async shall increment the number of pending I/O operations. ]*/
+            (void)interlocked_increment(&handle->pending_io_count);
+
+            /*Codes_SRS_FILE_LINUX_01_055: [ file_flush_async shall add the request to the list of flush requests of handle by calling interlocked_compare_exchange_pointer. ]*/
+            do
+            {
+                request->next = current_requests;
+                previous_requests = interlocked_compare_exchange_pointer(&handle->flush_requests, request, current_requests);
+                if (previous_requests == current_requests)
+                {
+                    break;
+                }
+                current_requests = previous_requests;
+            } while (1);
+
+            /*Codes_SRS_FILE_01_060: [ file_flush_async shall call user_callback with is_successful as true once the data of all the writes that completed before file_flush_async was called is durable. ]*/
+            /*Codes_SRS_FILE_01_061: [ A flush of the file shall serve all the file_flush_async requests that were queued when the flush started. ]*/
+            /*Codes_SRS_FILE_01_062: [ If flushing the file fails, file_flush_async shall call user_callback with is_successful as false. ]*/
+            /*Codes_SRS_FILE_LINUX_01_056: [ file_flush_async shall start a flush. ]*/
+            start_flush_if_idle(handle);
+
+            /*Codes_SRS_FILE_01_064: [ file_flush_async shall succeed and return 0. ]*/
+            /*Codes_SRS_FILE_LINUX_01_057: [ file_flush_async shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+    return result;
+}
+
+static int open_without_direct_io(int fd, int flags)
+{
+    /*opening the link of the descriptor creates a new open file description, so clearing O_DIRECT does not affect the I/Os of the handle*/
+    char path[sizeof("/proc/self/fd/") + 11];
+    (void)snprintf(path, sizeof(path), "/proc/self/fd/%d", fd);
+    return open(path, flags | O_CLOEXEC | O_LARGEFILE, 0);
+}
+
+static int open_copy_fds(FILE_LINUX_COPY* copy)
+{
+    int result;
+
+    if (
+        (copy->source_position % FILE_LINUX_WRITE_ALIGNMENT == 0) &&
+        (copy->destination_position % FILE_LINUX_WRITE_ALIGNMENT == 0) &&
+        (copy->size % FILE_LINUX_WRITE_ALIGNMENT == 0)
+        )
+    {
+        /*Codes_SRS_FILE_LINUX_01_233: [ If source_position, destination_position and size are multiples of FILE_LINUX_WRITE_ALIGNMENT, the copy shall use the file descriptors of source and destination. ]*/
+        result = 0;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_LINUX_01_234: [ Otherwise on_file_copy_work_linux shall open the source again without O_DIRECT by calling open with /proc/self/fd/ followed by the file descriptor of source and O_RDONLY, O_CLOEXEC and O_LARGEFILE, open the destination again in the same way with O_WRONLY, O_CLOEXEC and O_LARGEFILE and use these file descriptors for the copy. ]*/
+        int source_fd = open_without_direct_io(copy->source->h_file, O_RDONLY);
+        if (source_fd < 0)
+        {
+            /*Codes_SRS_FILE_LINUX_01_235: [ If open fails, on_file_copy_work_linux shall close the file descriptor that was opened and call end_copy with is_successful as false. ]*/
+            LogError("failure in open of the source without O_DIRECT, errno=%d", errno);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            int destination_fd = open_without_direct_io(copy->destination->h_file, O_WRONLY);
+            if (destination_fd < 0)
+            {
+                /*Codes_SRS_FILE_LINUX_01_235: [ If open fails, on_file_copy_work_linux shall close the file descriptor that was opened and call end_copy with is_successful as false. ]*/
+                LogError("failure in open of the destination without O_DIRECT, errno=%d", errno);
+                (void)close(source_fd);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                copy->source_fd = source_fd;
+                copy->destination_fd = destination_fd;
+                result = 0;
+            }
+        }
+    }
+
+    return result;
+}
+
+static void close_copy_fds(FILE_LINUX_COPY* copy)
+{
+    if (copy->source_fd != copy->source->h_file)
+    {
+        (void)close(copy->source_fd);
+    }
+    if (copy->destination_fd != copy->destination->h_file)
+    {
+        (void)close(copy->destination_fd);
+    }
+}
+
+static void end_copy(FILE_LINUX_COPY* copy, bool is_successful)
+{
+    FILE_HANDLE source = copy->source;
+    FILE_HANDLE destination = copy->destination;
+    FILE_CB user_callback = copy->user_callback;
+    void* user_context = copy->user_context;
+
+    if (destination->read_ahead != NULL)
+    {
+        /*Codes_SRS_FILE_LINUX_01_232: [ If a read-ahead policy is set on destination, end_copy shall call read_ahead_invalidate with the destination range. ]*/
+        read_ahead_invalidate(destination->read_ahead, copy->destination_position, copy->size);
+    }
+
+    /*Codes_SRS_FILE_LINUX_01_206: [ end_copy shall close the pipes that were created for the lanes and free the copy context. ]*/
+    for (uint32_t i = 0; i < copy->lane_count; i++)
+    {
+        (void)close(copy->lanes[i].pipe_fds[0]);
+        (void)close(copy->lanes[i].pipe_fds[1]);
+    }
+    /*Codes_SRS_FILE_LINUX_01_236: [ end_copy shall close the file descriptors opened without O_DIRECT. ]*/
+    close_copy_fds(copy);
+    free(copy);
+
+    /*Codes_SRS_FILE_LINUX_01_207: [ end_copy shall call user_callback with user_context and is_successful. ]*/
+    user_callback(user_context, is_successful);
+
+    /*Codes_SRS_FILE_LINUX_01_208: [ end_copy shall decrement the number of pending I/O operations of source and of destination and wake up file_destroy if they reach 0. ]*/
+    if (interlocked_decrement(&source->pending_io_count) == 0)
+    {
+        wake_by_address_single(&source->pending_io_count);
+    }
+    if (interlocked_decrement(&destination->pending_io_count) == 0)
+    {
+        wake_by_address_single(&destination->pending_io_count);
+    }
+}
+
+static void prepare_copy_splice(FILE_LINUX_COPY_LANE* lane, IO_RING_LINUX_SQE* sqe)
+{
+    FILE_LINUX_COPY* copy = lane->copy;
+
+    sqe->opcode = IORING_OP_SPLICE;
+    sqe->ioprio = 0;
+    sqe->address = NULL;
+    sqe->op_flags = 0;
+    sqe->io = &lane->io;
+
+    if (lane->write_end == lane->read_end)
+    {
+        /*Codes_SRS_FILE_LINUX_01_210: [ If the pipe of the lane is empty, the next splice of the lane shall be an IORING_OP_SPLICE entry that moves the rest of the chunk of the lane from the source file to the pipe. ]*/
+        lane->is_filling_pipe = true;
+        sqe->splice_fd_in = copy->source_fd;
+        sqe->splice_offset_in = copy->source_position + lane->read_end;
+        sqe->fd = lane->pipe_fds[1];
+        sqe->offset = UINT64_MAX;
+        sqe->length = (uint32_t)(lane->chunk_end - lane->read_end);
+    }
+    else
+    {
+        /*Codes_SRS_FILE_LINUX_01_211: [ Otherwise the next splice of the lane shall be an IORING_OP_SPLICE entry that moves all the bytes in the pipe of the lane to the destination file. ]*/
+        lane->is_filling_pipe = false;
+        sqe->splice_fd_in = lane->pipe_fds[0];
+        sqe->splice_offset_in = UINT64_MAX;
+        sqe->fd = copy->destination_fd;
+        sqe->offset = copy->destination_position + lane->write_end;
+        sqe->length = (uint32_t)(lane->read_end - lane->write_end);
+    }
+}
+
+static void start_copy_chunk(FILE_LINUX_COPY_LANE* lane, uint64_t chunk_start)
+{
+    FILE_LINUX_COPY* copy = lane->copy;
+
+    lane->chunk_start = chunk_start;
+    lane->chunk_end = (copy->size - chunk_start > FILE_LINUX_COPY_CHUNK_SIZE) ? chunk_start + FILE_LINUX_COPY_CHUNK_SIZE : copy->size;
+    lane->read_end = chunk_start;
+    lane->write_end = chunk_start;
+}
+
+static void end_copy_lane(FILE_LINUX_COPY_LANE* lane)
+{
+    FILE_LINUX_COPY* copy = lane->copy;
+
+    /*Codes_SRS_FILE_LINUX_01_212: [ When the last lane ends, the copy shall call end_copy with is_successful as true if and only if no lane failed. ]*/
+    if (interlocked_decrement(&copy->pending_lane_count) == 0)
+    {
+        end_copy(copy, interlocked_add(&copy->failed, 0) == 0);
+    }
+}
+
+static void on_file_copy_splice_complete_linux(void* context, int32_t io_result)
+{
+    FILE_LINUX_COPY_LANE* lane = context;
+    FILE_LINUX_COPY* copy = lane->copy;
+    bool lane_ended = true;
+
+    if (io_result <= 0)
+    {
+        /*Codes_SRS_FILE_LINUX_01_213: [ If io_result is 0 or negative, on_file_copy_splice_complete_linux shall mark the copy as failed and end the lane. ]*/
+        /*0 means that the source file ends before the end of the range*/
+        LogError("Error in asynchronous splice, is_filling_pipe=%d, error=%" PRId32 "", (int)lane->is_filling_pipe, -io_result);
+        (void)interlocked_exchange(&copy->failed, 1);
+    }
+    else
+    {
+        /*Codes_SRS_FILE_LINUX_01_214: [ Otherwise on_file_copy_splice_complete_linux shall add io_result to the number of bytes moved to the pipe or to the destination file, depending on the direction of the splice. ]*/
+        if (lane->is_filling_pipe)
+        {
+            lane->read_end += (uint32_t)io_result;
+        }
+        else
+        {
+            lane->write_end += (uint32_t)io_result;
+        }
+
+        if (interlocked_add(&copy->failed, 0) != 0)
+        {
+            /*Codes_SRS_FILE_LINUX_01_215: [ If another lane failed, on_file_copy_splice_complete_linux shall end the lane. ]*/
+        }
+        else
+        {
+            bool has_next_splice = true;
+
+            if (
+                (lane->write_end == lane->chunk_end) &&
+                (lane->read_end == lane->chunk_end)
+                )
+            {
+                /*Codes_SRS_FILE_LINUX_01_216: [ When the chunk of the lane is copied, on_file_copy_splice_complete_linux shall move the lane to its next chunk, lane_count chunks further, or end the lane if that chunk is past the end of the range. ]*/
+                uint64_t next_chunk_start = lane->chunk_start + (uint64_t)copy->lane_count * FILE_LINUX_COPY_CHUNK_SIZE;
+                if (next_chunk_start >= copy->size)
+                {
+                    has_next_splice = false;
+                }
+                else
+                {
+                    start_copy_chunk(lane, next_chunk_start);
+                }
+            }
+
+            if (has_next_splice)
+            {
+                IO_RING_LINUX_SQE sqe;
+                uint32_t submitted_count;
+
+                /*Codes_SRS_FILE_LINUX_01_217: [ on_file_copy_splice_complete_linux shall call io_ring_linux_submit with the next splice of the lane. ]*/
+                prepare_copy_splice(lane, &sqe);
+                if (io_ring_linux_submit(copy->destination->io_ring, &sqe, 1, &submitted_count) != 0)
+                {
+                    /*Codes_SRS_FILE_LINUX_01_218: [ If io_ring_linux_submit fails, on_file_copy_splice_complete_linux shall mark the copy as failed and end the lane. ]*/
+                    LogError("failure in io_ring_linux_submit");
+                    (void)interlocked_exchange(&copy->failed, 1);
+                }
+                else
+                {
+                    lane_ended = false;
+                }
+            }
+        }
+    }
+
+    if (lane_ended)
+    {
+        end_copy_lane(lane);
+    }
+}
+
+static int start_copy_lanes(FILE_LINUX_COPY* copy)
+{
+    int result;
+    uint64_t chunk_count = (copy->size + FILE_LINUX_COPY_CHUNK_SIZE - 1) / FILE_LINUX_COPY_CHUNK_SIZE;
+    uint32_t lane_count = (chunk_count < FILE_LINUX_COPY_LANE_COUNT) ? (uint32_t)chunk_count : FILE_LINUX_COPY_LANE_COUNT;
+    uint32_t i;
+
+    /*Codes_SRS_FILE_LINUX_01_200: [ on_file_copy_work_linux shall split the range in chunks of FILE_LINUX_COPY_CHUNK_SIZE bytes and use up to FILE_LINUX_COPY_LANE_COUNT lanes, lane i copying the chunks i, i + lane_count, i + 2 * lane_count etc. ]*/
+    for (i = 0; i < lane_count; i++)
+    {
+        FILE_LINUX_COPY_LANE* lane = &copy->lanes[i];
+
+        /*Codes_SRS_FILE_LINUX_01_201: [ on_file_copy_work_linux shall create a pipe for each lane by calling pipe2 with O_CLOEXEC. ]*/
+        if (pipe2(lane->pipe_fds, O_CLOEXEC) != 0)
+        {
+            LogError("failure in pipe2, errno=%d", errno);
+            break;
+        }
+
+        /*Codes_SRS_FILE_LINUX_01_202: [ on_file_copy_work_linux shall call fcntl with F_SETPIPE_SZ to make the pipe of each lane hold FILE_LINUX_COPY_CHUNK_SIZE bytes. ]*/
+        if (fcntl(lane->pipe_fds[1], F_SETPIPE_SZ, FILE_LINUX_COPY_CHUNK_SIZE) < 0)
+        {
+            /*the splices of the lane are just shorter with the default pipe size*/
+            LogWarning("failure in fcntl(F_SETPIPE_SZ), errno=%d", errno);
+        }
+
+        lane->io.on_io_complete = on_file_copy_splice_complete_linux;
+        lane->io.on_io_complete_context = lane;
+        lane->copy = copy;
+        start_copy_chunk(lane, (uint64_t)i * FILE_LINUX_COPY_CHUNK_SIZE);
+    }
+    copy->lane_count = i;
+
+    if (i != lane_count)
+    {
+        /*Codes_SRS_FILE_LINUX_01_203: [ If pipe2 fails, starting the splices shall fail. ]*/
+        result = MU_FAILURE;
+    }
+    else
+    {
+        IO_RING_LINUX_SQE sqes[FILE_LINUX_COPY_LANE_COUNT];
+        uint32_t submitted_count = 0;
+
+        for (i = 0; i < lane_count; i++)
+        {
+            prepare_copy_splice(&copy->lanes[i], &sqes[i]);
+        }
+
+        (void)interlocked_exchange(&copy->pending_lane_count, (int32_t)lane_count);
+
+        /*Codes_SRS_FILE_LINUX_01_204: [ on_file_copy_work_linux shall call io_ring_linux_submit once with the first splice of every lane. ]*/
+        if (io_ring_linux_submit(copy->destination->io_ring, sqes, lane_count, &submitted_count) != 0)
+        {
+            LogError("failure in io_ring_linux_submit, submitted %" PRIu32 " out of %" PRIu32 " splices", submitted_count, lane_count);
+            if (submitted_count == 0)
+            {
+                /*Codes_SRS_FILE_LINUX_01_205: [ If io_ring_linux_submit fails and no splice was submitted, starting the splices shall fail. ]*/
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /*Codes_SRS_FILE_LINUX_01_219: [ If io_ring_linux_submit fails after submitting the splices of some lanes, on_file_copy_work_linux shall mark the copy as failed and end the other lanes, the copy ending when the submitted splices complete. ]*/
+                (void)interlocked_exchange(&copy->failed, 1);
+                for (i = submitted_count; i < lane_count; i++)
+                {
+                    end_copy_lane(&copy->lanes[i]);
+                }
+                result = 0;
+            }
+        }
+        else
+        {
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static FILE_LINUX_COPY_RANGE_RESULT copy_range_in_kernel(FILE_LINUX_COPY* copy)
+{
+    FILE_LINUX_COPY_RANGE_RESULT result = FILE_LINUX_COPY_RANGE_OK;
+    loff_t source_offset = (loff_t)copy->source_position;
+    loff_t destination_offset = (loff_t)copy->destination_position;
+    uint64_t copied = 0;
+
+    while ((result == FILE_LINUX_COPY_RANGE_OK) && (copied < copy->size))
+    {
+        size_t length = (copy->size - copied > SSIZE_MAX) ? SSIZE_MAX : (size_t)(copy->size - copied);
+
+        /*Codes_SRS_FILE_LINUX_01_259: [ on_file_copy_work_linux shall call copy_file_range with the file descriptors of the copy until size bytes are copied. ]*/
+        ssize_t copy_result = copy_file_range(copy->source_fd, &source_offset, copy->destination_fd, &destination_offset, length, 0);
+        if (copy_result > 0)
+        {
+            copied += (uint64_t)copy_result;
+        }
+        else if (copy_result == 0)
+        {
+            /*Codes_SRS_FILE_LINUX_01_262: [ If copy_file_range returns 0 or fails in any other way, on_file_copy_work_linux shall call end_copy with is_successful as false. ]*/
+            LogError("the source ended %" PRIu64 " bytes into a copy of %" PRIu64 " bytes", copied, copy->size);
+            result = FILE_LINUX_COPY_RANGE_ERROR;
+        }
+        else if (errno == EINTR)
+        {
+            /*interrupted before copying anything, try again*/
+        }
+        else if (
+            (copied == 0) &&
+            ((errno == EXDEV) || (errno == EOPNOTSUPP) || (errno == EINVAL) || (errno == ENOSYS))
+            )
+        {
+            /*Codes_SRS_FILE_LINUX_01_260: [ If copy_file_range fails with EXDEV, EOPNOTSUPP, EINVAL or ENOSYS before copying any byte, on_file_copy_work_linux shall copy the range through pipes. ]*/
+            result = FILE_LINUX_COPY_RANGE_NOT_SUPPORTED;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_LINUX_01_262: [ If copy_file_range returns 0 or fails in any other way, on_file_copy_work_linux shall call end_copy with is_successful as false. ]*/
+            LogError("failure in copy_file_range after copying %" PRIu64 " out of %" PRIu64 " bytes, errno=%d", copied, copy->size, errno);
+            result = FILE_LINUX_COPY_RANGE_ERROR;
+        }
+    }
+
+    return result;
+}
+
+static void on_file_copy_work_linux(void* context)
+{
+    FILE_LINUX_COPY* copy = context;
+    struct file_clone_range clone_range;
+
+    clone_range.src_fd = copy->source->h_file;
+    clone_range.src_offset = copy->source_position;
+    clone_range.src_length = copy->size;
+    clone_range.dest_offset = copy->destination_position;
+
+    /*Codes_SRS_FILE_01_137: [ When the copy ends, user_callback shall be called with user_context and is_successful as true if and only if all size bytes were copied. ]*/
+    /*Codes_SRS_FILE_LINUX_01_198: [ on_file_copy_work_linux shall call ioctl with FICLONERANGE on destination to share the extents of the source range with the destination range. ]*/
+    if (ioctl(copy->destination->h_file, FICLONERANGE, &clone_range) == 0)
+    {
+        /*Codes_SRS_FILE_LINUX_01_199: [ If ioctl succeeds, on_file_copy_work_linux shall call end_copy with is_successful as true. ]*/
+        end_copy(copy, true);
+    }
+    else
+    {
+        /*EOPNOTSUPP, EXDEV or EINVAL (ranges not aligned to the blocks of the file system) are expected, the kernel then copies the data itself*/
+        if (open_copy_fds(copy) != 0)
+        {
+            /*Codes_SRS_FILE_LINUX_01_235: [ If open fails, on_file_copy_work_linux shall close the file descriptor that was opened and call end_copy with is_successful as false. ]*/
+            end_copy(copy, false);
+        }
+        else
+        {
+            FILE_LINUX_COPY_RANGE_RESULT copy_range_result = copy_range_in_kernel(copy);
+            if (copy_range_result == FILE_LINUX_COPY_RANGE_OK)
+            {
+                /*Codes_SRS_FILE_LINUX_01_261: [ If copy_file_range copies all size bytes, on_file_copy_work_linux shall call end_copy with is_successful as true. ]*/
+                end_copy(copy, true);
+            }
+            else if (copy_range_result == FILE_LINUX_COPY_RANGE_ERROR)
+            {
+                end_copy(copy, false);
+            }
+            else
+            {
+                if (start_copy_lanes(copy) != 0)
+                {
+                    /*Codes_SRS_FILE_LINUX_01_237: [ If starting the splices fails, on_file_copy_work_linux shall call end_copy with is_successful as false. ]*/
+                    end_copy(copy, false);
+                }
+                else
+                {
+                    /*the copy ends when the last lane ends*/
+                }
+            }
+        }
+    }
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_copy_range_async, FILE_HANDLE, source, uint64_t, source_position, FILE_HANDLE, destination, uint64_t, destination_position, uint64_t, size, FILE_CB, user_callback, void*, user_context)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_131: [ If source is NULL then file_copy_range_async shall fail and return a non-zero value. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_FILE_01_132: [ If destination is NULL then file_copy_range_async shall fail and return a non-zero value. ]*/
+        (destination == NULL) ||
+        /*Codes_SRS_FILE_01_133: [ If size is 0 then file_copy_range_async shall fail and return a non-zero value. ]*/
+        (size == 0) ||
+        /*Codes_SRS_FILE_01_134: [ If source_position + size or destination_position + size is greater than INT64_MAX then file_copy_range_async shall fail and return a non-zero value. ]*/
+        (size > INT64_MAX) ||
+        (source_position > INT64_MAX - size) ||
+        (destination_position > INT64_MAX - size) ||
+        /*Codes_SRS_FILE_01_140: [ If source and destination are the same file handle and the source and destination ranges overlap then file_copy_range_async shall fail and return a non-zero value. ]*/
+        (
+            (source == destination) &&
+            (source_position < destination_position + size) &&
+            (destination_position < source_position + size)
+        ) ||
+        /*Codes_SRS_FILE_01_135: [ If user_callback is NULL then file_copy_range_async shall fail and return a non-zero value. ]*/
+        (user_callback == NULL)
+        )
+    {
+        LogError("Invalid arguments to file_copy_range_async: FILE_HANDLE source=%p, uint64_t source_position=%" PRIu64 ", FILE_HANDLE destination=%p, uint64_t destination_position=%" PRIu64 ", uint64_t size=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
+            source, source_position, destination, destination_position, size, user_callback, user_context);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_LINUX_01_194: [ file_copy_range_async shall allocate a copy context to hold the ranges, user_callback and user_context. ]*/
+        FILE_LINUX_COPY* copy = malloc(sizeof(FILE_LINUX_COPY));
+        if (copy == NULL)
+        {
+            /*Codes_SRS_FILE_01_139: [ If there are any other failures, file_copy_range_async shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_LINUX_01_195: [ If there are any failures, file_copy_range_async shall fail and return a non-zero value. ]*/
+            LogError("failure in malloc(sizeof(FILE_LINUX_COPY)=%zu)", sizeof(FILE_LINUX_COPY));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            WORKER_POOL_LINUX_HANDLE worker_pool;
+
+            copy->source = source;
+            copy->destination = destination;
+            copy->source_position = source_position;
+            copy->destination_position = destination_position;
+            copy->size = size;
+            copy->source_fd = source->h_file;
+            copy->destination_fd = destination->h_file;
+            copy->user_callback = user_callback;
+            copy->user_context = user_context;
+            copy->lane_count = 0;
+            (void)interlocked_exchange(&copy->pending_lane_count, 0);
+            (void)interlocked_exchange(&copy->failed, 0);
+
+            if (destination->read_ahead != NULL)
+            {
+                /*Codes_SRS_FILE_01_138: [ When a read-ahead policy is set on destination, file_copy_range_async shall drop the blocks of destination that overlap the destination range. ]*/
+                /*Codes_SRS_FILE_LINUX_01_196: [ If a read-ahead policy is set on destination, file_copy_range_async shall call read_ahead_invalidate with the destination range. ]*/
+                read_ahead_invalidate(destination->read_ahead, destination_position, size);
+            }
+
+            if (destination->write_aggregator != NULL)
+            {
+                /*Codes_SRS_FILE_LINUX_01_229: [ If a write aggregation policy is set on destination, file_copy_range_async shall call write_aggregator_note_write with the destination range. ]*/
+                write_aggregator_note_write(destination->write_aggregator, destination_position, size);
+            }
+
+            /*Codes_SRS_FILE_LINUX_01_197: [ file_copy_range_async shall increment the number of pending I/O operations of source and of destination. ]*/
+            (void)interlocked_increment(&source->pending_io_count);
+            (void)interlocked_increment(&destination->pending_io_count);
+
+            /*Codes_SRS_FILE_LINUX_01_257: [ file_copy_range_async shall obtain the worker pool of the execution engine of destination by calling execution_engine_linux_get_worker_pool. ]*/
+            worker_pool = execution_engine_linux_get_worker_pool(destination->execution_engine);
+            if (worker_pool == NULL)
+            {
+                LogError("failure in execution_engine_linux_get_worker_pool");
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /*Codes_SRS_FILE_01_136: [ file_copy_range_async shall start copying size bytes of source starting at source_position to destination starting at destination_position and return 0. ]*/
+                /*Codes_SRS_FILE_LINUX_01_258: [ file_copy_range_async shall call worker_pool_linux_submit with a work item of priority WORKER_POOL_LINUX_PRIORITY_NORMAL that calls on_file_copy_work_linux, so that the calling thread does not wait for the kernel to copy the range. ]*/
+                copy->work_item.work_function = on_file_copy_work_linux;
+                copy->work_item.work_function_context = copy;
+                copy->work_item.priority = WORKER_POOL_LINUX_PRIORITY_NORMAL;
+
+                result = worker_pool_linux_submit(worker_pool, &copy->work_item);
+                if (result != 0)
+                {
+                    LogError("failure in worker_pool_linux_submit");
+                }
+            }
+
+            if (result != 0)
+            {
+                /*Codes_SRS_FILE_LINUX_01_220: [ If execution_engine_linux_get_worker_pool or worker_pool_linux_submit fails, file_copy_range_async shall decrement the number of pending I/O operations of source and of destination, free the copy context and fail. ]*/
+                if (interlocked_decrement(&source->pending_io_count) == 0)
+                {
+                    wake_by_address_single(&source->pending_io_count);
+                }
+                if (interlocked_decrement(&destination->pending_io_count) == 0)
+                {
+                    wake_by_address_single(&destination->pending_io_count);
+                }
+                free(copy);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /*Codes_SRS_FILE_LINUX_01_221: [ file_copy_range_async shall succeed and return 0. ]*/
+            }
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, FILE_MAPPED_REGION_HANDLE, file_map_region, FILE_HANDLE, handle, uint64_t, position, uint32_t, size, FILE_ACCESS_HINT, access_hint)
+{
+    FILE_MAPPED_REGION_HANDLE result;
+    if (
+        /*Codes_SRS_FILE_01_065: [ If handle is NULL then file_map_region shall fail and return NULL. ]*/
+        /*Codes_SRS_FILE_LINUX_01_067: [ If handle is NULL then file_map_region shall fail and return NULL. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_066: [ If size is 0 then file_map_region shall fail and return NULL. ]*/
+        /*Codes_SRS_FILE_LINUX_01_068: [ If size is 0 then file_map_region shall fail and return NULL. ]*/
+        (size == 0) ||
+        /*Codes_SRS_FILE_01_067: [ If position + size is greater than INT64_MAX then file_map_region shall fail and return NULL. ]*/
+        /*Codes_SRS_FILE_LINUX_01_069: [ If position + size is greater than INT64_MAX then file_map_region shall fail and return NULL. ]*/
+        ((position + size) > INT64_MAX)
+        )
+    {
+        LogError("Invalid arguments to file_map_region: FILE_HANDLE handle=%p, uint64_t position=%" PRIu64 ", uint32_t size=%" PRIu32 ", FILE_ACCESS_HINT access_hint=%" PRI_MU_ENUM "",
+            handle, position, size, MU_ENUM_VALUE(FILE_ACCESS_HINT, access_hint));
+        result = NULL;
+    }
+    else
+    {
+        struct stat file_stat;
+        /*Codes_SRS_FILE_LINUX_01_070: [ file_map_region shall call fstat to get the size of the file. ]*/
+        if (fstat(handle->h_file, &file_stat) != 0)
+        {
+            /*Codes_SRS_FILE_01_071: [ If there are any other failures, file_map_region shall fail and return NULL. ]*/
+            /*Codes_SRS_FILE_LINUX_01_076: [ If there are any failures, file_map_region shall fail and return NULL. ]*/
+            LogError("failure in fstat, errno=%d", errno);
+            result = NULL;
+        }
+        /*Codes_SRS_FILE_01_068: [ If position + size is greater than the size of the file then file_map_region shall fail and return NULL. ]*/
+        /*Codes_SRS_FILE_LINUX_01_071: [ If position + size is greater than the size of the file, file_map_region shall fail and return NULL. ]*/
+        else if (position + size > (uint64_t)file_stat.st_size)
+        {
+            LogError("Cannot map a region past the end of the file: uint64_t position=%" PRIu64 ", uint32_t size=%" PRIu32 ", file size=%" PRId64 "",
+                position, size, (int64_t)file_stat.st_size);
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_LINUX_01_072: [ file_map_region shall allocate a FILE_MAPPED_REGION. ]*/
+            result = malloc(sizeof(FILE_MAPPED_REGION));
+            if (result == NULL)
+            {
+                /*Codes_SRS_FILE_01_071: [ If there are any other failures, file_map_region shall fail and return NULL. ]*/
+                /*Codes_SRS_FILE_LINUX_01_076: [ If there are any failures, file_map_region shall fail and return NULL. ]*/
+                LogError("failure in malloc(sizeof(FILE_MAPPED_REGION)=%zu)", sizeof(FILE_MAPPED_REGION));
+            }
+            else
+            {
+                /*the offset given to mmap has to be a multiple of the page size*/
+                uint64_t page_size = (uint64_t)sysconf(_SC_PAGESIZE);
+                uint64_t map_offset = position - (position % page_size);
+
+                result->map_length = (size_t)(position - map_offset) + size;
+
+                /*Codes_SRS_FILE_01_069: [ file_map_region shall map size bytes of the file starting at position as a read-only view and return a handle to it. ]*/
+                /*Codes_SRS_FILE_LINUX_01_073: [ file_map_region shall call mmap with PROT_READ, MAP_SHARED, the file descriptor, position rounded down to a multiple of the page size as offset and size plus the bytes between offset and position as length. ]*/
+                result->map_address = mmap(NULL, result->map_length, PROT_READ, MAP_SHARED, handle->h_file, (off_t)map_offset);
+                if (result->map_address == MAP_FAILED)
+                {
+                    /*Codes_SRS_FILE_01_071: [ If there are any other failures, file_map_region shall fail and return NULL. ]*/
+                    /*Codes_SRS_FILE_LINUX_01_076: [ If there are any failures, file_map_region shall fail and return NULL. ]*/
+                    LogError("failure in mmap(length=%zu, offset=%" PRIu64 "), errno=%d", result->map_length, map_offset, errno);
+                    free(result);
+                    result = NULL;
+                }
+                else
+                {
+                    int advice;
+                    /*Codes_SRS_FILE_LINUX_01_074: [ If access_hint is FILE_ACCESS_HINT_SEQUENTIAL, FILE_ACCESS_HINT_RANDOM or FILE_ACCESS_HINT_WILL_NEED, file_map_region shall call madvise on the mapping with MADV_SEQUENTIAL, MADV_RANDOM or MADV_WILLNEED respectively. ]*/
+                    switch (access_hint)
+                    {
+                        case FILE_ACCESS_HINT_SEQUENTIAL:
+                            advice = MADV_SEQUENTIAL;
+                            break;
+                        case FILE_ACCESS_HINT_RANDOM:
+                            advice = MADV_RANDOM;
+                            break;
+                        case FILE_ACCESS_HINT_WILL_NEED:
+                            advice = MADV_WILLNEED;
+                            break;
+                        default:
+                            advice = MADV_NORMAL;
+                            break;
+                    }
+
+                    if (advice != MADV_NORMAL)
+                    {
+                        if (madvise(result->map_address, result->map_length, advice) != 0)
+                        {
+                            /*Codes_SRS_FILE_01_070: [ Failing to apply access_hint shall not make file_map_region fail. ]*/
+                            /*Codes_SRS_FILE_LINUX_01_075: [ If madvise fails, file_map_region shall log the failure and continue. ]*/
+                            LogError("failure in madvise(advice=%d), errno=%d, continuing", advice, errno);
+                        }
+                    }
+
+                    result->data = (const unsigned char*)result->map_address + (position - map_offset);
+
+                    /*Codes_SRS_FILE_LINUX_01_077: [ file_map_region shall succeed and return the allocated FILE_MAPPED_REGION. ]*/
+                }
+            }
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, const unsigned char*, file_mapped_region_get_data, FILE_MAPPED_REGION_HANDLE, region)
+{
+    const unsigned char* result;
+    if (region == NULL)
+    {
+        /*Codes_SRS_FILE_01_072: [ If region is NULL then file_mapped_region_get_data shall return NULL. ]*/
+        /*Codes_SRS_FILE_LINUX_01_078: [ If region is NULL then file_mapped_region_get_data shall return NULL. ]*/
+        LogError("Invalid arguments to file_mapped_region_get_data: FILE_MAPPED_REGION_HANDLE region=%p", region);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_073: [ file_mapped_region_get_data shall return a pointer to the byte of the view that corresponds to position in the file. ]*/
+        /*Codes_SRS_FILE_LINUX_01_079: [ file_mapped_region_get_data shall return the address in the mapping of the byte at position. ]*/
+        result = region->data;
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, void, file_unmap_region, FILE_MAPPED_REGION_HANDLE, region)
+{
+    if (region == NULL)
+    {
+        /*Codes_SRS_FILE_01_074: [ If region is NULL then file_unmap_region shall return. ]*/
+        /*Codes_SRS_FILE_LINUX_01_080: [ If region is NULL then file_unmap_region shall return. ]*/
+        LogError("Invalid arguments to file_unmap_region: FILE_MAPPED_REGION_HANDLE region=%p", region);
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_075: [ file_unmap_region shall unmap the view and free region. ]*/
+        /*Codes_SRS_FILE_LINUX_01_081: [ file_unmap_region shall call munmap with the address and the length of the mapping. ]*/
+        if (munmap(region->map_address, region->map_length) != 0)
+        {
+            LogError("failure in munmap, errno=%d", errno);
+        }
+
+        /*Codes_SRS_FILE_LINUX_01_082: [ file_unmap_region shall free region. ]*/
+        free(region);
+    }
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_extend, FILE_HANDLE, handle, uint64_t, desired_size)
+{
+    (void)handle;
+    (void)desired_size;
+    /*Codes_SRS_FILE_LINUX_43_018: [ file_extend shall return 0. ]*/
+    return 0;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_set_preallocation, FILE_HANDLE, handle, uint64_t, chunk_size)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_076: [ If handle is NULL then file_set_preallocation shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_077: [ If chunk_size is 0 then file_set_preallocation shall fail and return a non-zero value. ]*/
+        (chunk_size == 0) ||
+        /*Codes_SRS_FILE_01_078: [ If chunk_size is greater than INT64_MAX then file_set_preallocation shall fail and return a non-zero value. ]*/
+        (chunk_size > INT64_MAX)
+        )
+    {
+        LogError("Invalid arguments to file_set_preallocation: FILE_HANDLE handle=%p, uint64_t chunk_size=%" PRIu64 "",
+            handle, chunk_size);
+        result = MU_FAILURE;
+    }
+    else if (handle->preallocation_chunk_size != 0)
+    {
+        /*Codes_SRS_FILE_01_079: [ If a preallocation policy was already set on handle then file_set_preallocation shall fail and return a non-zero value. ]*/
+        LogError("A preallocation policy was already set on handle=%p, chunk_size=%" PRIu64 "", handle, handle->preallocation_chunk_size);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        struct stat file_stat;
+
+        /*Codes_SRS_FILE_LINUX_01_097: [ file_set_preallocation shall call fstat to get the size of the file. ]*/
+        if (fstat(handle->h_file, &file_stat) != 0)
+        {
+            /*Codes_SRS_FILE_01_083: [ If there are any other failures, file_set_preallocation shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_LINUX_01_098: [ If fstat fails, file_set_preallocation shall fail and return a non-zero value. ]*/
+            LogError("failure in fstat, errno=%d", errno);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_LINUX_01_099: [ file_set_preallocation shall set the preallocated end of the file to the size of the file and mark the preallocation as not in progress. ]*/
+            (void)interlocked_exchange_64(&handle->preallocated_end, (int64_t)file_stat.st_size);
+            (void)interlocked_exchange(&handle->preallocation_in_progress, 0);
+
+            /*Codes_SRS_FILE_01_080: [ file_set_preallocation shall set chunk_size as the preallocation chunk size of handle and return 0. ]*/
+            /*Codes_SRS_FILE_LINUX_01_100: [ file_set_preallocation shall set chunk_size as the preallocation chunk size of handle and return 0. ]*/
+            handle->preallocation_chunk_size = chunk_size;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_set_write_aggregation, FILE_HANDLE, handle, uint32_t, max_aggregated_size, uint32_t, max_delay_ms)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_084: [ If handle is NULL then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_085: [ If max_aggregated_size is 0 then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+        (max_aggregated_size == 0) ||
+        /*Codes_SRS_FILE_LINUX_01_108: [ If max_aggregated_size is not a multiple of FILE_LINUX_WRITE_ALIGNMENT then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+        ((max_aggregated_size % FILE_LINUX_WRITE_ALIGNMENT) != 0) ||
+        /*Codes_SRS_FILE_01_086: [ If max_delay_ms is 0 then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+        (max_delay_ms == 0)
+        )
+    {
+        LogError("Invalid arguments to file_set_write_aggregation: FILE_HANDLE handle=%p, uint32_t max_aggregated_size=%" PRIu32 ", uint32_t max_delay_ms=%" PRIu32 "",
+            handle, max_aggregated_size, max_delay_ms);
+        result = MU_FAILURE;
+    }
+    else if (handle->write_aggregator != NULL)
+    {
+        /*Codes_SRS_FILE_01_087: [ If a write aggregation policy was already set on handle then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+        LogError("A write aggregation policy was already set on handle=%p", handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        struct stat file_stat;
+
+        /*Codes_SRS_FILE_LINUX_01_222: [ file_set_write_aggregation shall call fstat to get the size of the file. ]*/
+        if (fstat(handle->h_file, &file_stat) != 0)
+        {
+            /*Codes_SRS_FILE_01_092: [ If there are any other failures, file_set_write_aggregation shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_LINUX_01_223: [ If fstat fails, file_set_write_aggregation shall fail and return a non-zero value. ]*/
+            LogError("failure in fstat, errno=%d", errno);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_01_090: [ The aggregation buffer shall be written when it holds max_aggregated_size bytes, when max_delay_ms milliseconds elapsed since it was started, when a write does not continue it, or when the file is destroyed. ]*/
+            /*Codes_SRS_FILE_LINUX_01_109: [ file_set_write_aggregation shall call write_aggregator_create with FILE_LINUX_WRITE_ALIGNMENT, max_aggregated_size, max_delay_ms, the size of the file, issue_aggregated_write, start_aggregation_timer, set_aggregated_file_size and handle. ]*/
+            WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(FILE_LINUX_WRITE_ALIGNMENT, max_aggregated_size, max_delay_ms, (uint64_t)file_stat.st_size, issue_aggregated_write, start_aggregation_timer, set_aggregated_file_size, handle);
+            if (write_aggregator == NULL)
+            {
+                /*Codes_SRS_FILE_01_092: [ If there are any other failures, file_set_write_aggregation shall fail and return a non-zero value. ]*/
+                /*Codes_SRS_FILE_LINUX_01_110: [ If write_aggregator_create fails, file_set_write_aggregation shall fail and return a non-zero value. ]*/
+                LogError("failure in write_aggregator_create, max_aggregated_size=%" PRIu32 ", max_delay_ms=%" PRIu32 "", max_aggregated_size, max_delay_ms);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /*Codes_SRS_FILE_01_088: [ file_set_write_aggregation shall set the write aggregation policy of handle and return 0. ]*/
+                /*Codes_SRS_FILE_LINUX_01_111: [ file_set_write_aggregation shall store the write aggregator in handle and return 0. ]*/
+                handle->write_aggregator = write_aggregator;
+                result = 0;
+            }
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_set_read_ahead, FILE_HANDLE, handle, uint32_t, block_size, uint32_t, block_count)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_093: [ If handle is NULL then file_set_read_ahead shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_094: [ If block_size is 0 then file_set_read_ahead shall fail and return a non-zero value. ]*/
+        (block_size == 0) ||
+        /*Codes_SRS_FILE_LINUX_01_138: [ If block_size is not a multiple of FILE_LINUX_WRITE_ALIGNMENT then file_set_read_ahead shall fail and return a non-zero value. ]*/
+        ((block_size % FILE_LINUX_WRITE_ALIGNMENT) != 0) ||
+        /*Codes_SRS_FILE_01_095: [ If block_count is 0 then file_set_read_ahead shall fail and return a non-zero value. ]*/
+        (block_count == 0)
+        )
+    {
+        LogError("Invalid arguments to file_set_read_ahead: FILE_HANDLE handle=%p, uint32_t block_size=%" PRIu32 ", uint32_t block_count=%" PRIu32 "",
+            handle, block_size, block_count);
+        result = MU_FAILURE;
+    }
+    else if (handle->read_ahead != NULL)
+    {
+        /*Codes_SRS_FILE_01_096: [ If a read-ahead policy was already set on handle then file_set_read_ahead shall fail and return a non-zero value. ]*/
+        LogError("A read-ahead policy was already set on handle=%p", handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_LINUX_01_139: [ file_set_read_ahead shall call read_ahead_create with FILE_LINUX_WRITE_ALIGNMENT, block_size, block_count, issue_read_ahead and handle. ]*/
+        READ_AHEAD_HANDLE read_ahead = read_ahead_create(FILE_LINUX_WRITE_ALIGNMENT, block_size, block_count, issue_read_ahead, handle);
+        if (read_ahead == NULL)
+        {
+            /*Codes_SRS_FILE_01_101: [ If there are any other failures, file_set_read_ahead shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_LINUX_01_140: [ If read_ahead_create fails, file_set_read_ahead shall fail and return a non-zero value. ]*/
+            LogError("failure in read_ahead_create, block_size=%" PRIu32 ", block_count=%" PRIu32 "", block_size, block_count);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_01_097: [ file_set_read_ahead shall set the read-ahead policy of handle and return 0. ]*/
+            /*Codes_SRS_FILE_LINUX_01_141: [ file_set_read_ahead shall store the read-ahead in handle and return 0. ]*/
+            handle->read_ahead = read_ahead;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_set_access_hint, FILE_HANDLE, handle, FILE_ACCESS_HINT, access_hint)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_102: [ If handle is NULL then file_set_access_hint shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_103: [ If access_hint is not FILE_ACCESS_HINT_NORMAL, FILE_ACCESS_HINT_SEQUENTIAL or FILE_ACCESS_HINT_RANDOM then file_set_access_hint shall fail and return a non-zero value. ]*/
+        (
+            (access_hint != FILE_ACCESS_HINT_NORMAL) &&
+            (access_hint != FILE_ACCESS_HINT_SEQUENTIAL) &&
+            (access_hint != FILE_ACCESS_HINT_RANDOM)
+        )
+        )
+    {
+        LogError("Invalid arguments to file_set_access_hint: FILE_HANDLE handle=%p, FILE_ACCESS_HINT access_hint=%" PRI_MU_ENUM "",
+            handle, MU_ENUM_VALUE(FILE_ACCESS_HINT, access_hint));
+        result = MU_FAILURE;
+    }
+    else if (handle->read_ahead == NULL)
+    {
+        /*Codes_SRS_FILE_01_104: [ If no read-ahead policy was set on handle then file_set_access_hint shall fail and return a non-zero value. ]*/
+        LogError("No read-ahead policy was set on handle=%p", handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_LINUX_01_150: [ file_set_access_hint shall call read_ahead_set_mode with READ_AHEAD_MODE_AUTO for FILE_ACCESS_HINT_NORMAL, READ_AHEAD_MODE_SEQUENTIAL for FILE_ACCESS_HINT_SEQUENTIAL and READ_AHEAD_MODE_OFF for FILE_ACCESS_HINT_RANDOM. ]*/
+        READ_AHEAD_MODE mode =
+            (access_hint == FILE_ACCESS_HINT_SEQUENTIAL) ? READ_AHEAD_MODE_SEQUENTIAL :
+            (access_hint == FILE_ACCESS_HINT_RANDOM) ? READ_AHEAD_MODE_OFF :
+            READ_AHEAD_MODE_AUTO;
+
+        if (read_ahead_set_mode(handle->read_ahead, mode) != 0)
+        {
+            /*Codes_SRS_FILE_01_106: [ If there are any other failures, file_set_access_hint shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_LINUX_01_151: [ If read_ahead_set_mode fails, file_set_access_hint shall fail and return a non-zero value. ]*/
+            LogError("failure in read_ahead_set_mode, mode=%" PRI_MU_ENUM "", MU_ENUM_VALUE(READ_AHEAD_MODE, mode));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_01_105: [ file_set_access_hint shall apply access_hint to the read-ahead policy of handle and return 0. ]*/
+            result = 0;
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_will_need, FILE_HANDLE, handle, uint64_t, position, uint64_t, size)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_107: [ If handle is NULL then file_will_need shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_108: [ If size is 0 then file_will_need shall fail and return a non-zero value. ]*/
+        (size == 0) ||
+        /*Codes_SRS_FILE_01_109: [ If position + size overflows then file_will_need shall fail and return a non-zero value. ]*/
+        (position > UINT64_MAX - size)
+        )
+    {
+        LogError("Invalid arguments to file_will_need: FILE_HANDLE handle=%p, uint64_t position=%" PRIu64 ", uint64_t size=%" PRIu64 "",
+            handle, position, size);
+        result = MU_FAILURE;
+    }
+    else if (handle->read_ahead == NULL)
+    {
+        /*Codes_SRS_FILE_01_110: [ If no read-ahead policy was set on handle then file_will_need shall fail and return a non-zero value. ]*/
+        LogError("No read-ahead policy was set on handle=%p", handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_111: [ file_will_need shall start reading the blocks that hold size bytes starting at position, up to block_count blocks, and return 0. ]*/
+        /*Codes_SRS_FILE_LINUX_01_152: [ file_will_need shall call read_ahead_will_need with position and size. ]*/
+        if (read_ahead_will_need(handle->read_ahead, position, size) != 0)
+        {
+            /*Codes_SRS_FILE_01_112: [ If there are any other failures, file_will_need shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_LINUX_01_153: [ If read_ahead_will_need fails, file_will_need shall fail and return a non-zero value. ]*/
+            LogError("failure in read_ahead_will_need, position=%" PRIu64 ", size=%" PRIu64 "", position, size);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            result = 0;
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_set_io_limit, FILE_HANDLE, handle, uint32_t, max_outstanding_io, FILE_IO_LIMIT_MODE, mode)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_113: [ If handle is NULL then file_set_io_limit shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_114: [ If mode is not FILE_IO_LIMIT_MODE_BUSY or FILE_IO_LIMIT_MODE_QUEUE then file_set_io_limit shall fail and return a non-zero value. ]*/
+        (
+            (mode != FILE_IO_LIMIT_MODE_BUSY) &&
+            (mode != FILE_IO_LIMIT_MODE_QUEUE)
+        )
+        )
+    {
+        LogError("Invalid arguments to file_set_io_limit: FILE_HANDLE handle=%p, uint32_t max_outstanding_io=%" PRIu32 ", FILE_IO_LIMIT_MODE mode=%" PRI_MU_ENUM "",
+            handle, max_outstanding_io, MU_ENUM_VALUE(FILE_IO_LIMIT_MODE, mode));
+        result = MU_FAILURE;
+    }
+    else if (handle->is_io_limit_set)
+    {
+        /*Codes_SRS_FILE_01_115: [ If an I/O limit was already set on handle then file_set_io_limit shall fail and return a non-zero value. ]*/
+        LogError("An I/O limit was already set on handle=%p", handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_LINUX_01_184: [ If max_outstanding_io is 0, file_set_io_limit shall not create an admission for handle. ]*/
+        /*Codes_SRS_FILE_LINUX_01_185: [ Otherwise file_set_io_limit shall call io_admission_create with max_outstanding_io. ]*/
+        IO_ADMISSION_HANDLE io_admission = (max_outstanding_io == 0) ? NULL : io_admission_create(max_outstanding_io);
+        if (
+            (max_outstanding_io != 0) &&
+            (io_admission == NULL)
+            )
+        {
+            /*Codes_SRS_FILE_01_121: [ If there are any other failures, file_set_io_limit shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_LINUX_01_186: [ If io_admission_create fails, file_set_io_limit shall fail and return a non-zero value. ]*/
+            LogError("failure in io_admission_create, max_outstanding_io=%" PRIu32 "", max_outstanding_io);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_01_116: [ file_set_io_limit shall set the I/O limit of handle to max_outstanding_io (no limit if max_outstanding_io is 0) and the mode to mode and return 0. ]*/
+            /*Codes_SRS_FILE_LINUX_01_187: [ file_set_io_limit shall store the admission and mode in handle, mark the I/O limit as set and return 0. ]*/
+            handle->io_admission = io_admission;
+            handle->io_limit_mode = mode;
+            handle->is_io_limit_set = true;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_get_io_admission_statistics, FILE_HANDLE, handle, IO_ADMISSION_STATISTICS*, statistics)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_122: [ If handle is NULL then file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_123: [ If statistics is NULL then file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments to file_get_io_admission_statistics: FILE_HANDLE handle=%p, IO_ADMISSION_STATISTICS* statistics=%p",
+            handle, statistics);
+        result = MU_FAILURE;
+    }
+    else if (handle->io_admission == NULL)
+    {
+        /*Codes_SRS_FILE_01_124: [ If no I/O limit was set on handle or it was set with max_outstanding_io 0 then file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+        LogError("No I/O limit was set on handle=%p", handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_125: [ file_get_io_admission_statistics shall fill statistics with the counters of the I/O limit of handle and return 0. ]*/
+        /*Codes_SRS_FILE_LINUX_01_188: [ file_get_io_admission_statistics shall call io_admission_get_statistics on the admission of handle. ]*/
+        if (io_admission_get_statistics(handle->io_admission, statistics) != 0)
+        {
+            /*Codes_SRS_FILE_LINUX_01_189: [ If io_admission_get_statistics fails, file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+            LogError("failure in io_admission_get_statistics");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            result = 0;
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_set_io_priority, FILE_HANDLE, handle, FILE_IO_PRIORITY, priority)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_126: [ If handle is NULL then file_set_io_priority shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_127: [ If priority is not FILE_IO_PRIORITY_NORMAL or FILE_IO_PRIORITY_LOW then file_set_io_priority shall fail and return a non-zero value. ]*/
+        (
+            (priority != FILE_IO_PRIORITY_NORMAL) &&
+            (priority != FILE_IO_PRIORITY_LOW)
+        )
+        )
+    {
+        LogError("Invalid arguments to file_set_io_priority: FILE_HANDLE handle=%p, FILE_IO_PRIORITY priority=%" PRI_MU_ENUM "",
+            handle, MU_ENUM_VALUE(FILE_IO_PRIORITY, priority));
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_128: [ file_set_io_priority shall set the priority class of the I/Os of handle to priority and return 0. ]*/
+        /*Codes_SRS_FILE_01_129: [ An I/O of a FILE_IO_PRIORITY_LOW file handle that waits for a slot of an I/O limit shall only be started when no I/O of a FILE_IO_PRIORITY_NORMAL file handle waits for a slot of the same limit. ]*/
+        /*Codes_SRS_FILE_LINUX_01_191: [ file_set_io_priority shall set the io_uring priority of handle to 0 and its admission priority to IO_ADMISSION_PRIORITY_NORMAL for FILE_IO_PRIORITY_NORMAL, and to the lowest level of the best-effort class and IO_ADMISSION_PRIORITY_LOW for FILE_IO_PRIORITY_LOW, and return 0. ]*/
+        if (priority == FILE_IO_PRIORITY_LOW)
+        {
+            handle->ioprio = FILE_LINUX_IOPRIO_LOW;
+            handle->admission_priority = IO_ADMISSION_PRIORITY_LOW;
+        }
+        else
+        {
+            handle->ioprio = FILE_LINUX_IOPRIO_NORMAL;
+            handle->admission_priority = IO_ADMISSION_PRIORITY_NORMAL;
+        }
+        result = 0;
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_get_io_context_pool_statistics, FILE_HANDLE, handle, IO_CONTEXT_POOL_STATISTICS*, statistics)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_055: [ If handle is NULL then file_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_056: [ If statistics is NULL then file_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments to file_get_io_context_pool_statistics: FILE_HANDLE handle=%p, IO_CONTEXT_POOL_STATISTICS* statistics=%p",
+            handle, statistics);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_057: [ file_get_io_context_pool_statistics shall fill statistics with the hit and miss counters of the I/O context pool of handle and return 0. ]*/
+        /*Codes_SRS_FILE_LINUX_01_046: [ file_get_io_context_pool_statistics shall call io_context_pool_get_statistics on the I/O context pool of handle. ]*/
+        if (io_context_pool_get_statistics(handle->io_context_pool, statistics) != 0)
+        {
+            /*Codes_SRS_FILE_LINUX_01_047: [ If io_context_pool_get_statistics fails, file_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+            LogError("failure in io_context_pool_get_statistics");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_LINUX_01_048: [ Otherwise file_get_io_context_pool_statistics shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+    return result;
+}
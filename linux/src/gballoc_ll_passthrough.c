@@ -69,6 +69,44 @@ void* gballoc_ll_realloc(void* ptr, size_t size)
     return result;
 }
 
+void* gballoc_ll_aligned_malloc(size_t alignment, size_t size)
+{
+    void* result;
+
+    if (
+        /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_001: [ If alignment is 0 or is not a power of 2, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+        (alignment == 0) ||
+        ((alignment & (alignment - 1)) != 0) ||
+        /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_002: [ If size is 0, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+        (size == 0)
+        )
+    {
+        LogError("Invalid arguments: size_t alignment=%zu, size_t size=%zu", alignment, size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_003: [ On Linux, gballoc_ll_aligned_malloc shall call posix_memalign with the greater of alignment and sizeof(void*) and size. ]*/
+        /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_005: [ gballoc_ll_aligned_malloc shall succeed and return the aligned memory block. ]*/
+        int posix_memalign_result = posix_memalign(&result, (alignment < sizeof(void*)) ? sizeof(void*) : alignment, size);
+        if (posix_memalign_result != 0)
+        {
+            /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_006: [ If any error occurs, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+            LogError("failure in posix_memalign(&result, alignment=%zu, size=%zu), error=%d", alignment, size, posix_memalign_result);
+            result = NULL;
+        }
+    }
+
+    return result;
+}
+
+void gballoc_ll_aligned_free(void* ptr)
+{
+    /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_007: [ If ptr is NULL, gballoc_ll_aligned_free shall return. ]*/
+    /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_008: [ On Linux, gballoc_ll_aligned_free shall call free(ptr). ]*/
+    free(ptr);
+}
+
 size_t gballoc_ll_size(void* ptr)
 {
     size_t result;
@@ -78,3 +116,13 @@ size_t gballoc_ll_size(void* ptr)
 
     return result;
 }
+
+size_t gballoc_ll_aligned_size(void* ptr)
+{
+    size_t result;
+
+    /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_010: [ On Linux, gballoc_ll_aligned_size shall return what malloc_usable_size returns. ]*/
+    result = malloc_usable_size(ptr);
+
+    return result;
+}
@@ -0,0 +1,545 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#include "macro_utils/macro_utils.h"
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/threadapi.h"
+
+#include "c_pal/io_ring_linux.h"
+
+/*a submission that finds the completion queue backed up waits for the reaper thread this many times before giving up*/
+#define IO_RING_LINUX_SUBMIT_WAIT_MS 1
+#define IO_RING_LINUX_SUBMIT_MAX_WAIT_COUNT 1000
+
+typedef struct IO_RING_LINUX_SUBMISSION_QUEUE_TAG
+{
+    unsigned* head;
+    unsigned* tail;
+    unsigned* ring_mask;
+    unsigned* array;
+    uint32_t entries;
+    struct io_uring_sqe* sqes;
+} IO_RING_LINUX_SUBMISSION_QUEUE;
+
+typedef struct IO_RING_LINUX_COMPLETION_QUEUE_TAG
+{
+    unsigned* head;
+    unsigned* tail;
+    unsigned* ring_mask;
+    struct io_uring_cqe* cqes;
+} IO_RING_LINUX_COMPLETION_QUEUE;
+
+typedef struct IO_RING_LINUX_COMPLETION_TAG
+{
+    uint64_t user_data;
+    int32_t res;
+} IO_RING_LINUX_COMPLETION;
+
+typedef struct IO_RING_LINUX_TAG
+{
+    int ring_fd;
+    void* sq_ring;
+    size_t sq_ring_size;
+    void* cq_ring;
+    size_t cq_ring_size;
+    size_t sqes_size;
+    IO_RING_LINUX_SUBMISSION_QUEUE sq;
+    IO_RING_LINUX_COMPLETION_QUEUE cq;
+    pthread_mutex_t submit_lock;
+    THREAD_HANDLE reaper_thread;
+    /*completions taken off the completion queue by a submission from the reaper thread, only touched by the reaper thread*/
+    IO_RING_LINUX_COMPLETION* backlog;
+    uint32_t backlog_count;
+    uint32_t backlog_capacity;
+} IO_RING_LINUX;
+
+/*the ring whose reaper thread is the current thread, so that a submission from a completion callback can be told apart*/
+static __thread IO_RING_LINUX* io_ring_linux_reaper_ring;
+
+static int io_uring_setup_syscall(uint32_t entries, struct io_uring_params* params)
+{
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int io_uring_enter_syscall(int ring_fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags)
+{
+    return (int)syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static void prepare_sqe(struct io_uring_sqe* sqe, const IO_RING_LINUX_SQE* io_ring_sqe)
+{
+    (void)memset(sqe, 0, sizeof(struct io_uring_sqe));
+    sqe->opcode = io_ring_sqe->opcode;
+    sqe->ioprio = io_ring_sqe->ioprio;
+    sqe->fd = io_ring_sqe->fd;
+    sqe->off = io_ring_sqe->offset;
+    sqe->addr = (uint64_t)(uintptr_t)io_ring_sqe->address;
+    sqe->len = io_ring_sqe->length;
+    sqe->rw_flags = (__kernel_rwf_t)io_ring_sqe->op_flags;
+    if (io_ring_sqe->opcode == IORING_OP_SPLICE)
+    {
+        /*Codes_SRS_IO_RING_LINUX_01_022: [ For an IORING_OP_SPLICE entry, io_ring_linux_submit shall also copy splice_fd_in and splice_offset_in in the submission queue entry. ]*/
+        /*splice_flags shares the union of rw_flags*/
+        sqe->splice_fd_in = io_ring_sqe->splice_fd_in;
+        sqe->splice_off_in = io_ring_sqe->splice_offset_in;
+    }
+    /*a NULL io (user_data 0) is reserved for the shutdown request*/
+    sqe->user_data = (uint64_t)(uintptr_t)io_ring_sqe->io;
+}
+
+/*shall be called on the reaper thread, moves the completion queue entries to the backlog without calling their callbacks*/
+static int move_completions_to_backlog(IO_RING_LINUX* io_ring, uint32_t* moved_count)
+{
+    int result;
+    unsigned head = *io_ring->cq.head;
+    unsigned tail = __atomic_load_n(io_ring->cq.tail, __ATOMIC_ACQUIRE);
+    uint32_t count = (uint32_t)(tail - head);
+
+    if (io_ring->backlog_count + count > io_ring->backlog_capacity)
+    {
+        uint32_t new_capacity = 2 * (io_ring->backlog_count + count);
+        IO_RING_LINUX_COMPLETION* new_backlog = realloc(io_ring->backlog, new_capacity * sizeof(IO_RING_LINUX_COMPLETION));
+        if (new_backlog == NULL)
+        {
+            LogError("failure in realloc(%p, %zu)", io_ring->backlog, new_capacity * sizeof(IO_RING_LINUX_COMPLETION));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            io_ring->backlog = new_backlog;
+            io_ring->backlog_capacity = new_capacity;
+            result = 0;
+        }
+    }
+    else
+    {
+        result = 0;
+    }
+
+    if (result == 0)
+    {
+        for (; head != tail; head++)
+        {
+            struct io_uring_cqe* cqe = &io_ring->cq.cqes[head & *io_ring->cq.ring_mask];
+            io_ring->backlog[io_ring->backlog_count].user_data = cqe->user_data;
+            io_ring->backlog[io_ring->backlog_count].res = cqe->res;
+            io_ring->backlog_count++;
+        }
+        __atomic_store_n(io_ring->cq.head, head, __ATOMIC_RELEASE);
+        *moved_count = count;
+    }
+
+    return result;
+}
+
+/*takes submit_lock, which is released while waiting for the completion queue to drain so that a submission from an on_io_complete callback can go through*/
+static int submit_sqes(IO_RING_LINUX* io_ring, const IO_RING_LINUX_SQE* sqes, uint32_t sqe_count, uint32_t* submitted_count)
+{
+    int result = 0;
+    uint32_t submitted = 0;
+    uint32_t wait_count = 0;
+
+    (void)pthread_mutex_lock(&io_ring->submit_lock);
+
+    while ((submitted < sqe_count) && (result == 0))
+    {
+        /*only submitters (serialized by submit_lock) write the tail, the kernel only moves the head*/
+        unsigned tail = *io_ring->sq.tail;
+        unsigned head = __atomic_load_n(io_ring->sq.head, __ATOMIC_ACQUIRE);
+        uint32_t to_fill = io_ring->sq.entries - (uint32_t)(tail - head);
+        bool is_backed_up = false;
+        if (to_fill > sqe_count - submitted)
+        {
+            to_fill = sqe_count - submitted;
+        }
+
+        for (uint32_t i = 0; i < to_fill; i++)
+        {
+            unsigned index = tail & *io_ring->sq.ring_mask;
+            prepare_sqe(&io_ring->sq.sqes[index], &sqes[submitted + i]);
+            io_ring->sq.array[index] = index;
+            tail++;
+        }
+        __atomic_store_n(io_ring->sq.tail, tail, __ATOMIC_RELEASE);
+
+        /*one kernel transition for all the entries that were just filled*/
+        uint32_t to_submit = to_fill;
+        while ((to_submit > 0) && (result == 0) && !is_backed_up)
+        {
+            int enter_result = io_uring_enter_syscall(io_ring->ring_fd, to_submit, 0, 0);
+            if (enter_result > 0)
+            {
+                to_submit -= (uint32_t)enter_result;
+                submitted += (uint32_t)enter_result;
+                wait_count = 0;
+            }
+            else if ((enter_result < 0) && (errno == EINTR))
+            {
+                /*interrupted before anything was consumed, try again*/
+            }
+            else if ((enter_result == 0) || (errno == EAGAIN) || (errno == EBUSY))
+            {
+                uint32_t moved_count = 0;
+
+                if (io_ring_linux_reaper_ring == io_ring)
+                {
+                    /*Codes_SRS_IO_RING_LINUX_01_023: [ If io_uring_enter fails with EAGAIN or EBUSY while io_ring_linux_submit is called from an on_io_complete callback, io_ring_linux_submit shall move the completion queue entries to a backlog whose callbacks are called later by the reaper thread and retry. ]*/
+                    /*the reaper is the one submitting, nobody else makes room in the completion queue*/
+                    if (move_completions_to_backlog(io_ring, &moved_count) != 0)
+                    {
+                        LogError("io_uring_enter failed, errno=%d, and the completion queue cannot be drained, submitted %" PRIu32 " out of %" PRIu32 "", errno, submitted, sqe_count);
+                        result = MU_FAILURE;
+                    }
+                }
+
+                if ((result == 0) && (moved_count == 0))
+                {
+                    /*the completion queue is backed up or the kernel is short on resources, the reaper thread has to make room*/
+                    is_backed_up = true;
+                }
+            }
+            else
+            {
+                LogError("io_uring_enter failed, errno=%d, submitted %" PRIu32 " out of %" PRIu32 "", errno, submitted, sqe_count);
+                result = MU_FAILURE;
+            }
+        }
+
+        if ((result != 0) || is_backed_up)
+        {
+            /*drop the entries that the kernel did not consume so that they are not picked up by another submission, they are filled again after the wait*/
+            __atomic_store_n(io_ring->sq.tail, __atomic_load_n(io_ring->sq.head, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+        }
+
+        if (is_backed_up)
+        {
+            if (wait_count == IO_RING_LINUX_SUBMIT_MAX_WAIT_COUNT)
+            {
+                /*Codes_SRS_IO_RING_LINUX_01_025: [ If no entry could be submitted after waiting IO_RING_LINUX_SUBMIT_MAX_WAIT_COUNT times, io_ring_linux_submit shall fail. ]*/
+                LogError("the completion queue stayed backed up for %" PRIu32 " waits of %" PRIu32 " ms, submitted %" PRIu32 " out of %" PRIu32 "",
+                    wait_count, (uint32_t)IO_RING_LINUX_SUBMIT_WAIT_MS, submitted, sqe_count);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /*Codes_SRS_IO_RING_LINUX_01_024: [ If io_uring_enter fails with EAGAIN or EBUSY or consumes no entry and the completion queue cannot be drained by the calling thread, io_ring_linux_submit shall discard the entries not consumed by the kernel, release the submission lock, wait IO_RING_LINUX_SUBMIT_WAIT_MS milliseconds, take the lock again and retry with the entries that were not submitted. ]*/
+                /*a callback running on the reaper thread may be waiting for the lock to submit, it could never return if the lock was held during the wait*/
+                wait_count++;
+                (void)pthread_mutex_unlock(&io_ring->submit_lock);
+                ThreadAPI_Sleep(IO_RING_LINUX_SUBMIT_WAIT_MS);
+                (void)pthread_mutex_lock(&io_ring->submit_lock);
+            }
+        }
+    }
+
+    (void)pthread_mutex_unlock(&io_ring->submit_lock);
+
+    *submitted_count = submitted;
+    return result;
+}
+
+static void dispatch_completion(uint64_t user_data, int32_t res, bool* shutdown_requested)
+{
+    if (user_data == 0)
+    {
+        *shutdown_requested = true;
+    }
+    else
+    {
+        IO_RING_LINUX_IO* io = (IO_RING_LINUX_IO*)(uintptr_t)user_data;
+        io->on_io_complete(io->on_io_complete_context, res);
+    }
+}
+
+static int io_ring_linux_reaper_thread(void* arg)
+{
+    IO_RING_LINUX* io_ring = arg;
+    bool shutdown_requested = false;
+
+    io_ring_linux_reaper_ring = io_ring;
+
+    while (!shutdown_requested)
+    {
+        if (io_ring->backlog_count > 0)
+        {
+            /*the backlog was taken off the completion queue before anything that is in it now, so it goes first*/
+            /*a callback can append to the backlog (and move it), so it is indexed again for every entry*/
+            for (uint32_t i = 0; (i < io_ring->backlog_count) && !shutdown_requested; i++)
+            {
+                IO_RING_LINUX_COMPLETION completion = io_ring->backlog[i];
+                dispatch_completion(completion.user_data, completion.res, &shutdown_requested);
+            }
+            io_ring->backlog_count = 0;
+        }
+        else
+        {
+            /*the reaper is the only consumer of the completion queue*/
+            unsigned head = *io_ring->cq.head;
+            unsigned tail = __atomic_load_n(io_ring->cq.tail, __ATOMIC_ACQUIRE);
+
+            if (head == tail)
+            {
+                if (io_uring_enter_syscall(io_ring->ring_fd, 0, 1, IORING_ENTER_GETEVENTS) < 0)
+                {
+                    if (errno != EINTR)
+                    {
+                        LogError("io_uring_enter with IORING_ENTER_GETEVENTS failed, errno=%d", errno);
+                    }
+                }
+            }
+            else
+            {
+                /*one entry at a time: a callback that submits may move the entries after it to the backlog*/
+                struct io_uring_cqe* cqe = &io_ring->cq.cqes[head & *io_ring->cq.ring_mask];
+                uint64_t user_data = cqe->user_data;
+                int32_t res = cqe->res;
+
+                /*release the slot before calling the callback, the callback may submit more I/O*/
+                __atomic_store_n(io_ring->cq.head, head + 1, __ATOMIC_RELEASE);
+
+                dispatch_completion(user_data, res, &shutdown_requested);
+            }
+        }
+    }
+
+    return 0;
+}
+
+IO_RING_LINUX_HANDLE io_ring_linux_create(uint32_t entries)
+{
+    IO_RING_LINUX_HANDLE result;
+
+    if (entries == 0)
+    {
+        /*Codes_SRS_IO_RING_LINUX_01_001: [ If entries is 0, io_ring_linux_create shall fail and return NULL. ]*/
+        LogError("Invalid arguments: uint32_t entries=%" PRIu32 "", entries);
+    }
+    else
+    {
+        /*Codes_SRS_IO_RING_LINUX_01_002: [ io_ring_linux_create shall allocate memory for the ring. ]*/
+        result = malloc(sizeof(IO_RING_LINUX));
+        if (result == NULL)
+        {
+            /*Codes_SRS_IO_RING_LINUX_01_009: [ If any error occurs, io_ring_linux_create shall fail and return NULL. ]*/
+            LogError("failure in malloc(%zu)", sizeof(IO_RING_LINUX));
+        }
+        else
+        {
+            struct io_uring_params params;
+            (void)memset(&params, 0, sizeof(params));
+
+            /*Codes_SRS_IO_RING_LINUX_01_003: [ io_ring_linux_create shall call io_uring_setup with entries submission queue entries and 2 * entries completion queue entries. ]*/
+            params.flags = IORING_SETUP_CQSIZE;
+            params.cq_entries = 2 * entries;
+
+            result->ring_fd = io_uring_setup_syscall(entries, &params);
+            if (result->ring_fd < 0)
+            {
+                /*Codes_SRS_IO_RING_LINUX_01_009: [ If any error occurs, io_ring_linux_create shall fail and return NULL. ]*/
+                LogError("io_uring_setup(entries=%" PRIu32 ") failed, errno=%d", entries, errno);
+            }
+            else
+            {
+                /*Codes_SRS_IO_RING_LINUX_01_004: [ io_ring_linux_create shall map the submission queue ring, the completion queue ring (unless the kernel reports IORING_FEAT_SINGLE_MMAP) and the submission queue entries. ]*/
+                result->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                result->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+                result->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+                if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+                {
+                    if (result->cq_ring_size > result->sq_ring_size)
+                    {
+                        result->sq_ring_size = result->cq_ring_size;
+                    }
+                    result->cq_ring_size = result->sq_ring_size;
+                }
+
+                result->sq_ring = mmap(NULL, result->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, result->ring_fd, IORING_OFF_SQ_RING);
+                if (result->sq_ring == MAP_FAILED)
+                {
+                    /*Codes_SRS_IO_RING_LINUX_01_009: [ If any error occurs, io_ring_linux_create shall fail and return NULL. ]*/
+                    LogError("mmap of the submission queue ring failed, errno=%d", errno);
+                }
+                else
+                {
+                    if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0)
+                    {
+                        result->cq_ring = result->sq_ring;
+                    }
+                    else
+                    {
+                        result->cq_ring = mmap(NULL, result->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, result->ring_fd, IORING_OFF_CQ_RING);
+                    }
+
+                    if (result->cq_ring == MAP_FAILED)
+                    {
+                        /*Codes_SRS_IO_RING_LINUX_01_009: [ If any error occurs, io_ring_linux_create shall fail and return NULL. ]*/
+                        LogError("mmap of the completion queue ring failed, errno=%d", errno);
+                    }
+                    else
+                    {
+                        result->sq.sqes = mmap(NULL, result->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, result->ring_fd, IORING_OFF_SQES);
+                        if (result->sq.sqes == MAP_FAILED)
+                        {
+                            /*Codes_SRS_IO_RING_LINUX_01_009: [ If any error occurs, io_ring_linux_create shall fail and return NULL. ]*/
+                            LogError("mmap of the submission queue entries failed, errno=%d", errno);
+                        }
+                        else
+                        {
+                            unsigned char* sq_ring = result->sq_ring;
+                            unsigned char* cq_ring = result->cq_ring;
+
+                            result->sq.head = (unsigned*)(sq_ring + params.sq_off.head);
+                            result->sq.tail = (unsigned*)(sq_ring + params.sq_off.tail);
+                            result->sq.ring_mask = (unsigned*)(sq_ring + params.sq_off.ring_mask);
+                            result->sq.array = (unsigned*)(sq_ring + params.sq_off.array);
+                            result->sq.entries = params.sq_entries;
+
+                            result->cq.head = (unsigned*)(cq_ring + params.cq_off.head);
+                            result->cq.tail = (unsigned*)(cq_ring + params.cq_off.tail);
+                            result->cq.ring_mask = (unsigned*)(cq_ring + params.cq_off.ring_mask);
+                            result->cq.cqes = (struct io_uring_cqe*)(cq_ring + params.cq_off.cqes);
+
+                            /*the backlog is only allocated if a callback submits while the completion queue is backed up*/
+                            result->backlog = NULL;
+                            result->backlog_count = 0;
+                            result->backlog_capacity = 0;
+
+                            /*Codes_SRS_IO_RING_LINUX_01_005: [ io_ring_linux_create shall initialize a mutex used to serialize submissions. ]*/
+                            if (pthread_mutex_init(&result->submit_lock, NULL) != 0)
+                            {
+                                /*Codes_SRS_IO_RING_LINUX_01_009: [ If any error occurs, io_ring_linux_create shall fail and return NULL. ]*/
+                                LogError("pthread_mutex_init failed");
+                            }
+                            else
+                            {
+                                /*Codes_SRS_IO_RING_LINUX_01_006: [ io_ring_linux_create shall create a reaper thread that waits for completions and calls on_io_complete for each of them. ]*/
+                                if (ThreadAPI_Create(&result->reaper_thread, io_ring_linux_reaper_thread, result) != THREADAPI_OK)
+                                {
+                                    /*Codes_SRS_IO_RING_LINUX_01_009: [ If any error occurs, io_ring_linux_create shall fail and return NULL. ]*/
+                                    LogError("ThreadAPI_Create failed");
+                                }
+                                else
+                                {
+                                    /*Codes_SRS_IO_RING_LINUX_01_007: [ io_ring_linux_create shall succeed and return a non-NULL handle. ]*/
+                                    goto all_ok;
+                                }
+                                (void)pthread_mutex_destroy(&result->submit_lock);
+                            }
+                            (void)munmap(result->sq.sqes, result->sqes_size);
+                        }
+                        if (result->cq_ring != result->sq_ring)
+                        {
+                            (void)munmap(result->cq_ring, result->cq_ring_size);
+                        }
+                    }
+                    (void)munmap(result->sq_ring, result->sq_ring_size);
+                }
+                (void)close(result->ring_fd);
+            }
+            free(result);
+        }
+    }
+
+    result = NULL;
+
+all_ok:
+    return result;
+}
+
+void io_ring_linux_destroy(IO_RING_LINUX_HANDLE io_ring)
+{
+    if (io_ring == NULL)
+    {
+        /*Codes_SRS_IO_RING_LINUX_01_010: [ If io_ring is NULL, io_ring_linux_destroy shall return. ]*/
+        LogError("Invalid arguments: IO_RING_LINUX_HANDLE io_ring=%p", io_ring);
+    }
+    else
+    {
+        IO_RING_LINUX_SQE shutdown_sqe = { .opcode = IORING_OP_NOP, .fd = -1, .io = NULL };
+        uint32_t submitted_count;
+        int thread_result;
+
+        /*Codes_SRS_IO_RING_LINUX_01_011: [ io_ring_linux_destroy shall submit a IORING_OP_NOP with no IO_RING_LINUX_IO to signal the reaper thread to stop. ]*/
+        int submit_result = submit_sqes(io_ring, &shutdown_sqe, 1, &submitted_count);
+
+        if (submit_result != 0)
+        {
+            /*without the NOP the reaper never wakes up, leak rather than unmap memory it is using*/
+            LogError("Cannot signal the reaper thread, leaking the ring");
+        }
+        else
+        {
+            /*Codes_SRS_IO_RING_LINUX_01_012: [ io_ring_linux_destroy shall join the reaper thread. ]*/
+            if (ThreadAPI_Join(io_ring->reaper_thread, &thread_result) != THREADAPI_OK)
+            {
+                LogError("ThreadAPI_Join failed");
+            }
+
+            /*Codes_SRS_IO_RING_LINUX_01_013: [ io_ring_linux_destroy shall unmap the rings, close the ring file descriptor and free the memory. ]*/
+            (void)pthread_mutex_destroy(&io_ring->submit_lock);
+            (void)munmap(io_ring->sq.sqes, io_ring->sqes_size);
+            if (io_ring->cq_ring != io_ring->sq_ring)
+            {
+                (void)munmap(io_ring->cq_ring, io_ring->cq_ring_size);
+            }
+            (void)munmap(io_ring->sq_ring, io_ring->sq_ring_size);
+            (void)close(io_ring->ring_fd);
+            if (io_ring->backlog != NULL)
+            {
+                free(io_ring->backlog);
+            }
+            free(io_ring);
+        }
+    }
+}
+
+int io_ring_linux_submit(IO_RING_LINUX_HANDLE io_ring, const IO_RING_LINUX_SQE* sqes, uint32_t sqe_count, uint32_t* submitted_count)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_IO_RING_LINUX_01_014: [ If io_ring is NULL, io_ring_linux_submit shall fail and return a non-zero value. ]*/
+        (io_ring == NULL) ||
+        /*Codes_SRS_IO_RING_LINUX_01_015: [ If sqes is NULL, io_ring_linux_submit shall fail and return a non-zero value. ]*/
+        (sqes == NULL) ||
+        /*Codes_SRS_IO_RING_LINUX_01_016: [ If sqe_count is 0, io_ring_linux_submit shall fail and return a non-zero value. ]*/
+        (sqe_count == 0) ||
+        /*Codes_SRS_IO_RING_LINUX_01_017: [ If submitted_count is NULL, io_ring_linux_submit shall fail and return a non-zero value. ]*/
+        (submitted_count == NULL)
+        )
+    {
+        LogError("Invalid arguments: IO_RING_LINUX_HANDLE io_ring=%p, const IO_RING_LINUX_SQE* sqes=%p, uint32_t sqe_count=%" PRIu32 ", uint32_t* submitted_count=%p",
+            io_ring, sqes, sqe_count, submitted_count);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_IO_RING_LINUX_01_018: [ io_ring_linux_submit shall copy all sqes in the submission queue and call io_uring_enter once for as many entries as fit in the submission queue. ]*/
+        /*Codes_SRS_IO_RING_LINUX_01_019: [ If io_uring_enter fails with EINTR, io_ring_linux_submit shall retry. ]*/
+        result = submit_sqes(io_ring, sqes, sqe_count, submitted_count);
+
+        if (result != 0)
+        {
+            /*Codes_SRS_IO_RING_LINUX_01_020: [ If io_uring_enter fails, io_ring_linux_submit shall discard the entries not consumed by the kernel, set submitted_count to the number of submitted entries and return a non-zero value. ]*/
+            LogError("submit_sqes failed, submitted %" PRIu32 " out of %" PRIu32 "", *submitted_count, sqe_count);
+        }
+        /*Codes_SRS_IO_RING_LINUX_01_021: [ On success io_ring_linux_submit shall set submitted_count to sqe_count and return 0. ]*/
+    }
+
+    return result;
+}
@@ -0,0 +1,178 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+
+#include "c_pal/srw_lock.h"
+
+typedef struct SRW_LOCK_HANDLE_DATA_TAG
+{
+    pthread_rwlock_t lock;
+} SRW_LOCK_HANDLE_DATA;
+
+SRW_LOCK_HANDLE srw_lock_create(bool do_statistics, const char* lock_name)
+{
+    SRW_LOCK_HANDLE result;
+
+    /*the statistics are not implemented on Linux*/
+    (void)do_statistics;
+    (void)lock_name;
+
+    /*Codes_SRS_SRW_LOCK_LINUX_01_001: [ srw_lock_create shall allocate memory for SRW_LOCK_HANDLE. ]*/
+    result = malloc(sizeof(SRW_LOCK_HANDLE_DATA));
+    if (result == NULL)
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_004: [ If there are any failures then srw_lock_create shall fail and return NULL. ]*/
+        LogError("failure in malloc(sizeof(SRW_LOCK_HANDLE_DATA)=%zu)", sizeof(SRW_LOCK_HANDLE_DATA));
+    }
+    else
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_002: [ srw_lock_create shall initialize the lock by calling pthread_rwlock_init. ]*/
+        int pthread_result = pthread_rwlock_init(&result->lock, NULL);
+        if (pthread_result != 0)
+        {
+            /*Codes_SRS_SRW_LOCK_LINUX_01_004: [ If there are any failures then srw_lock_create shall fail and return NULL. ]*/
+            LogError("failure in pthread_rwlock_init(&result->lock, NULL), result=%d", pthread_result);
+            free(result);
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_SRW_LOCK_LINUX_01_003: [ srw_lock_create shall succeed and return a non-NULL value. ]*/
+        }
+    }
+
+    return result;
+}
+
+void srw_lock_acquire_exclusive(SRW_LOCK_HANDLE handle)
+{
+    if (handle == NULL)
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_005: [ If handle is NULL then srw_lock_acquire_exclusive shall return. ]*/
+        LogError("invalid argument SRW_LOCK_HANDLE handle=%p", handle);
+    }
+    else
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_006: [ srw_lock_acquire_exclusive shall call pthread_rwlock_wrlock. ]*/
+        (void)pthread_rwlock_wrlock(&handle->lock);
+    }
+}
+
+SRW_LOCK_TRY_ACQUIRE_RESULT srw_lock_try_acquire_exclusive(SRW_LOCK_HANDLE handle)
+{
+    SRW_LOCK_TRY_ACQUIRE_RESULT result;
+
+    if (handle == NULL)
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_007: [ If handle is NULL then srw_lock_try_acquire_exclusive shall fail and return SRW_LOCK_TRY_ACQUIRE_INVALID_ARGS. ]*/
+        LogError("invalid argument SRW_LOCK_HANDLE handle=%p", handle);
+        result = SRW_LOCK_TRY_ACQUIRE_INVALID_ARGS;
+    }
+    else
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_008: [ Otherwise srw_lock_try_acquire_exclusive shall call pthread_rwlock_trywrlock. ]*/
+        if (pthread_rwlock_trywrlock(&handle->lock) != 0)
+        {
+            /*Codes_SRS_SRW_LOCK_LINUX_01_009: [ If pthread_rwlock_trywrlock fails, srw_lock_try_acquire_exclusive shall return SRW_LOCK_TRY_ACQUIRE_COULD_NOT_ACQUIRE. ]*/
+            result = SRW_LOCK_TRY_ACQUIRE_COULD_NOT_ACQUIRE;
+        }
+        else
+        {
+            /*Codes_SRS_SRW_LOCK_LINUX_01_010: [ If pthread_rwlock_trywrlock succeeds, srw_lock_try_acquire_exclusive shall return SRW_LOCK_TRY_ACQUIRE_OK. ]*/
+            result = SRW_LOCK_TRY_ACQUIRE_OK;
+        }
+    }
+
+    return result;
+}
+
+void srw_lock_release_exclusive(SRW_LOCK_HANDLE handle)
+{
+    if (handle == NULL)
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_011: [ If handle is NULL then srw_lock_release_exclusive shall return. ]*/
+        LogError("invalid argument SRW_LOCK_HANDLE handle=%p", handle);
+    }
+    else
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_012: [ srw_lock_release_exclusive shall call pthread_rwlock_unlock. ]*/
+        (void)pthread_rwlock_unlock(&handle->lock);
+    }
+}
+
+void srw_lock_acquire_shared(SRW_LOCK_HANDLE handle)
+{
+    if (handle == NULL)
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_013: [ If handle is NULL then srw_lock_acquire_shared shall return. ]*/
+        LogError("invalid argument SRW_LOCK_HANDLE handle=%p", handle);
+    }
+    else
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_014: [ srw_lock_acquire_shared shall call pthread_rwlock_rdlock. ]*/
+        (void)pthread_rwlock_rdlock(&handle->lock);
+    }
+}
+
+SRW_LOCK_TRY_ACQUIRE_RESULT srw_lock_try_acquire_shared(SRW_LOCK_HANDLE handle)
+{
+    SRW_LOCK_TRY_ACQUIRE_RESULT result;
+
+    if (handle == NULL)
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_015: [ If handle is NULL then srw_lock_try_acquire_shared shall fail and return SRW_LOCK_TRY_ACQUIRE_INVALID_ARGS. ]*/
+        LogError("invalid argument SRW_LOCK_HANDLE handle=%p", handle);
+        result = SRW_LOCK_TRY_ACQUIRE_INVALID_ARGS;
+    }
+    else
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_016: [ Otherwise srw_lock_try_acquire_shared shall call pthread_rwlock_tryrdlock. ]*/
+        if (pthread_rwlock_tryrdlock(&handle->lock) != 0)
+        {
+            /*Codes_SRS_SRW_LOCK_LINUX_01_017: [ If pthread_rwlock_tryrdlock fails, srw_lock_try_acquire_shared shall return SRW_LOCK_TRY_ACQUIRE_COULD_NOT_ACQUIRE. ]*/
+            result = SRW_LOCK_TRY_ACQUIRE_COULD_NOT_ACQUIRE;
+        }
+        else
+        {
+            /*Codes_SRS_SRW_LOCK_LINUX_01_018: [ If pthread_rwlock_tryrdlock succeeds, srw_lock_try_acquire_shared shall return SRW_LOCK_TRY_ACQUIRE_OK. ]*/
+            result = SRW_LOCK_TRY_ACQUIRE_OK;
+        }
+    }
+
+    return result;
+}
+
+void srw_lock_release_shared(SRW_LOCK_HANDLE handle)
+{
+    if (handle == NULL)
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_019: [ If handle is NULL then srw_lock_release_shared shall return. ]*/
+        LogError("invalid argument SRW_LOCK_HANDLE handle=%p", handle);
+    }
+    else
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_020: [ srw_lock_release_shared shall call pthread_rwlock_unlock. ]*/
+        (void)pthread_rwlock_unlock(&handle->lock);
+    }
+}
+
+void srw_lock_destroy(SRW_LOCK_HANDLE handle)
+{
+    if (handle == NULL)
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_021: [ If handle is NULL then srw_lock_destroy shall return. ]*/
+        LogError("invalid arguments SRW_LOCK_HANDLE handle=%p", handle);
+    }
+    else
+    {
+        /*Codes_SRS_SRW_LOCK_LINUX_01_022: [ srw_lock_destroy shall call pthread_rwlock_destroy and free the memory of the lock. ]*/
+        (void)pthread_rwlock_destroy(&handle->lock);
+        free(handle);
+    }
+}
@@ -1,10 +1,117 @@
 // Copyright (C) Microsoft Corporation. All rights reserved.
 
+#define _GNU_SOURCE
+
 #include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
 #include <unistd.h>
 
+#include "macro_utils/macro_utils.h"
 #include "c_logging/xlogging.h"
 #include "c_pal/sysinfo.h"
+#include "c_pal/sysinfo_linux.h"
+
+#define SYSFS_NUMA_NODE_ONLINE_PATH "/sys/devices/system/node/online"
+#define SYSFS_NUMA_NODE_CPULIST_PATH_FORMAT "/sys/devices/system/node/node%" PRIu32 "/cpulist"
+#define SYSFS_PATH_MAX_LENGTH 64
+/*sysfs attributes are at most a page*/
+#define SYSFS_LIST_MAX_LENGTH 4096
+
+/*parses a sysfs list of ids like "0-3,8,10-11", an empty list is valid*/
+/*ids can be NULL when only the count and the highest id are needed*/
+static int parse_id_list(const char* list, uint32_t* ids, uint32_t id_capacity, uint32_t* id_count, uint32_t* max_id)
+{
+    int result = 0;
+    const char* current = list;
+    uint32_t count = 0;
+    uint32_t max = 0;
+
+    while ((result == 0) && (*current != '\0') && (*current != '\n'))
+    {
+        char* end;
+        unsigned long first = strtoul(current, &end, 10);
+        unsigned long last = first;
+        bool is_malformed = (end == current);
+
+        if ((!is_malformed) && (*end == '-'))
+        {
+            current = end + 1;
+            last = strtoul(current, &end, 10);
+            is_malformed = (end == current);
+        }
+
+        if (is_malformed || (last < first) || (last > UINT32_MAX))
+        {
+            LogError("Malformed id list: %s", list);
+            result = MU_FAILURE;
+        }
+        else if (ids == NULL)
+        {
+            count += (uint32_t)(last - first + 1);
+            max = (uint32_t)last;
+            current = (*end == ',') ? end + 1 : end;
+        }
+        else if (last - first + 1 > (unsigned long)(id_capacity - count))
+        {
+            LogError("More than %" PRIu32 " ids in list: %s", id_capacity, list);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            for (unsigned long id = first; id <= last; id++)
+            {
+                ids[count] = (uint32_t)id;
+                count++;
+            }
+
+            max = (uint32_t)last;
+            current = (*end == ',') ? end + 1 : end;
+        }
+    }
+
+    if (result == 0)
+    {
+        *id_count = count;
+        *max_id = max;
+    }
+
+    return result;
+}
+
+static int read_id_list(const char* path, uint32_t* ids, uint32_t id_capacity, uint32_t* id_count, uint32_t* max_id)
+{
+    int result;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        LogError("open(%s, O_RDONLY) failed with errno=%d", path, errno);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        char buffer[SYSFS_LIST_MAX_LENGTH + 1];
+        ssize_t bytes_read = read(fd, buffer, SYSFS_LIST_MAX_LENGTH);
+        if (bytes_read < 0)
+        {
+            LogError("read(%s) failed with errno=%d", path, errno);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            buffer[bytes_read] = '\0';
+            result = parse_id_list(buffer, ids, id_capacity, id_count, max_id);
+        }
+
+        (void)close(fd);
+    }
+
+    return result;
+}
 
 uint32_t sysinfo_get_processor_count(void)
 {
@@ -36,3 +143,129 @@ uint32_t sysinfo_get_processor_count(void)
 
     return result;
 }
+
+uint32_t sysinfo_get_numa_node_count(void)
+{
+    uint32_t result;
+    uint32_t online_node_count;
+    uint32_t max_online_node;
+
+    /* Codes_SRS_SYSINFO_01_003: [ sysinfo_get_numa_node_count shall obtain the number of NUMA nodes as reported by the operating system. ]*/
+    /* Codes_SRS_SYSINFO_LINUX_01_004: [ sysinfo_get_numa_node_count shall read the list of online NUMA nodes from /sys/devices/system/node/online. ]*/
+    if (read_id_list(SYSFS_NUMA_NODE_ONLINE_PATH, NULL, 0, &online_node_count, &max_online_node) != 0)
+    {
+        /* Codes_SRS_SYSINFO_01_004: [ If the host is not NUMA or any error occurs, sysinfo_get_numa_node_count shall return 1. ]*/
+        /* Codes_SRS_SYSINFO_LINUX_01_006: [ If the list cannot be read, is malformed or is empty, sysinfo_get_numa_node_count shall return 1. ]*/
+        LogWarning("Cannot read the online NUMA nodes, assuming a single node");
+        result = 1;
+    }
+    else if (online_node_count == 0)
+    {
+        /* Codes_SRS_SYSINFO_LINUX_01_006: [ If the list cannot be read, is malformed or is empty, sysinfo_get_numa_node_count shall return 1. ]*/
+        LogWarning("No online NUMA nodes, assuming a single node");
+        result = 1;
+    }
+    else if (max_online_node == UINT32_MAX)
+    {
+        /* Codes_SRS_SYSINFO_LINUX_01_006: [ If the list cannot be read, is malformed or is empty, sysinfo_get_numa_node_count shall return 1. ]*/
+        LogError("NUMA node %" PRIu32 " is out of range, assuming a single node", max_online_node);
+        result = 1;
+    }
+    else
+    {
+        /* Codes_SRS_SYSINFO_LINUX_01_005: [ Otherwise sysinfo_get_numa_node_count shall return the highest online node plus 1. ]*/
+        result = max_online_node + 1;
+        LogInfo("Detected %" PRIu32 " NUMA nodes", result);
+    }
+
+    return result;
+}
+
+uint32_t sysinfo_get_current_numa_node(void)
+{
+    uint32_t result;
+    unsigned int cpu;
+    unsigned int numa_node;
+
+    /* Codes_SRS_SYSINFO_01_005: [ sysinfo_get_current_numa_node shall obtain the NUMA node of the processor the calling thread is running on as reported by the operating system. ]*/
+    /* Codes_SRS_SYSINFO_LINUX_01_007: [ sysinfo_get_current_numa_node shall call getcpu to obtain the NUMA node of the calling thread. ]*/
+    if (getcpu(&cpu, &numa_node) != 0)
+    {
+        /* Codes_SRS_SYSINFO_01_006: [ If any error occurs, sysinfo_get_current_numa_node shall return 0. ]*/
+        /* Codes_SRS_SYSINFO_LINUX_01_008: [ If getcpu fails, sysinfo_get_current_numa_node shall return 0. ]*/
+        LogError("getcpu failed with errno=%d", errno);
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_SYSINFO_LINUX_01_009: [ Otherwise sysinfo_get_current_numa_node shall return the NUMA node returned by getcpu. ]*/
+        result = numa_node;
+    }
+
+    return result;
+}
+
+uint32_t sysinfo_get_current_processor(void)
+{
+    uint32_t result;
+    unsigned int cpu;
+    unsigned int numa_node;
+
+    /* Codes_SRS_SYSINFO_01_007: [ sysinfo_get_current_processor shall obtain the processor the calling thread is running on as reported by the operating system. ]*/
+    /* Codes_SRS_SYSINFO_LINUX_01_017: [ sysinfo_get_current_processor shall call getcpu to obtain the CPU of the calling thread. ]*/
+    if (getcpu(&cpu, &numa_node) != 0)
+    {
+        /* Codes_SRS_SYSINFO_01_008: [ If any error occurs, sysinfo_get_current_processor shall return 0. ]*/
+        /* Codes_SRS_SYSINFO_LINUX_01_018: [ If getcpu fails, sysinfo_get_current_processor shall return 0. ]*/
+        LogError("getcpu failed with errno=%d", errno);
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_SYSINFO_LINUX_01_019: [ Otherwise sysinfo_get_current_processor shall return the CPU returned by getcpu. ]*/
+        result = cpu;
+    }
+
+    return result;
+}
+
+int sysinfo_linux_get_numa_node_cpus(uint32_t numa_node, uint32_t* cpus, uint32_t cpu_capacity, uint32_t* cpu_count)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_SYSINFO_LINUX_01_010: [ If cpus is NULL, sysinfo_linux_get_numa_node_cpus shall fail and return a non-zero value. ]*/
+        (cpus == NULL) ||
+        /* Codes_SRS_SYSINFO_LINUX_01_011: [ If cpu_count is NULL, sysinfo_linux_get_numa_node_cpus shall fail and return a non-zero value. ]*/
+        (cpu_count == NULL)
+        )
+    {
+        LogError("Invalid arguments: uint32_t numa_node=%" PRIu32 ", uint32_t* cpus=%p, uint32_t cpu_capacity=%" PRIu32 ", uint32_t* cpu_count=%p",
+            numa_node, cpus, cpu_capacity, cpu_count);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        char path[SYSFS_PATH_MAX_LENGTH];
+        uint32_t max_cpu;
+
+        (void)snprintf(path, sizeof(path), SYSFS_NUMA_NODE_CPULIST_PATH_FORMAT, numa_node);
+
+        /* Codes_SRS_SYSINFO_LINUX_01_012: [ sysinfo_linux_get_numa_node_cpus shall read the list of CPUs of the node from /sys/devices/system/node/node{numa_node}/cpulist. ]*/
+        /* Codes_SRS_SYSINFO_LINUX_01_013: [ sysinfo_linux_get_numa_node_cpus shall store the CPUs of the node in cpus and their number in cpu_count. ]*/
+        if (read_id_list(path, cpus, cpu_capacity, cpu_count, &max_cpu) != 0)
+        {
+            /* Codes_SRS_SYSINFO_LINUX_01_014: [ If the node has more CPUs than cpu_capacity, sysinfo_linux_get_numa_node_cpus shall fail and return a non-zero value. ]*/
+            /* Codes_SRS_SYSINFO_LINUX_01_015: [ If the list cannot be read or is malformed, sysinfo_linux_get_numa_node_cpus shall fail and return a non-zero value. ]*/
+            LogError("Cannot read the CPUs of NUMA node %" PRIu32 " from %s", numa_node, path);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_SYSINFO_LINUX_01_016: [ Otherwise sysinfo_linux_get_numa_node_cpus shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+
+    return result;
+}
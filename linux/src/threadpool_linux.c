@@ -0,0 +1,1425 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "macro_utils/macro_utils.h"
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sync.h"
+#include "c_pal/timer.h"
+#include "c_pal/execution_engine.h"
+#include "c_pal/execution_engine_linux.h"
+#include "c_pal/worker_pool_linux.h"
+#include "c_pal/timer_wheel_linux.h"
+#include "c_pal/threadpool_statistics.h"
+
+#include "c_pal/threadpool.h"
+
+#define THREADPOOL_LINUX_STATE_VALUES \
+    THREADPOOL_LINUX_STATE_CLOSED, \
+    THREADPOOL_LINUX_STATE_OPENING, \
+    THREADPOOL_LINUX_STATE_OPEN, \
+    THREADPOOL_LINUX_STATE_CLOSING
+
+MU_DEFINE_ENUM(THREADPOOL_LINUX_STATE, THREADPOOL_LINUX_STATE_VALUES)
+MU_DEFINE_ENUM_STRINGS(THREADPOOL_LINUX_STATE, THREADPOOL_LINUX_STATE_VALUES)
+
+MU_DEFINE_ENUM_STRINGS(THREADPOOL_OPEN_RESULT, THREADPOOL_OPEN_RESULT_VALUES)
+MU_DEFINE_ENUM_STRINGS(THREADPOOL_PRIORITY, THREADPOOL_PRIORITY_VALUES)
+
+typedef struct THREADPOOL_QUEUE_WAIT_TAG
+{
+    volatile_atomic int64_t work_item_count;
+    volatile_atomic int64_t total_queue_wait_us;
+    volatile_atomic int64_t max_queue_wait_us;
+} THREADPOOL_QUEUE_WAIT;
+
+typedef struct THREADPOOL_TAG
+{
+    volatile_atomic int32_t state;
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    WORKER_POOL_LINUX_HANDLE worker_pool;
+    volatile_atomic int32_t pending_api_calls;
+    /*work items scheduled and not yet completed, threadpool_close waits for them*/
+    volatile_atomic int32_t pending_work_item_count;
+    /*how long the work items of each priority waited in the worker pool queues*/
+    THREADPOOL_QUEUE_WAIT high_priority_queue_wait;
+    THREADPOOL_QUEUE_WAIT normal_priority_queue_wait;
+    THREADPOOL_QUEUE_WAIT low_priority_queue_wait;
+    /*NULL unless threadpool_enable_statistics was called, it is only set while the threadpool is closed*/
+    THREADPOOL_STATISTICS_RECORDER_HANDLE statistics_recorder;
+} THREADPOOL;
+
+typedef struct WORK_ITEM_CONTEXT_TAG
+{
+    /*the worker pool work item lives in the context, so scheduling takes a single allocation*/
+    WORKER_POOL_LINUX_WORK_ITEM worker_pool_work_item;
+    THREADPOOL* threadpool;
+    THREADPOOL_WORK_FUNCTION work_function;
+    void* work_function_context;
+    THREADPOOL_QUEUE_WAIT* queue_wait;
+    double schedule_time_us;
+} WORK_ITEM_CONTEXT;
+
+typedef struct WORK_BATCH_ITEM_CONTEXT_TAG
+{
+    WORKER_POOL_LINUX_WORK_ITEM worker_pool_work_item;
+    struct WORK_BATCH_CONTEXT_TAG* work_batch;
+    THREADPOOL_WORK_FUNCTION work_function;
+    void* work_function_context;
+} WORK_BATCH_ITEM_CONTEXT;
+
+typedef struct WORK_BATCH_CONTEXT_TAG
+{
+    THREADPOOL* threadpool;
+    /*work items of the batch not executed yet, the last one to execute frees the batch*/
+    volatile_atomic int32_t pending_work_item_count;
+    /*only set when the statistics are enabled*/
+    double schedule_time_us;
+    /*all the work items of a batch take a single allocation*/
+    WORK_BATCH_ITEM_CONTEXT work_items[];
+} WORK_BATCH_CONTEXT;
+
+typedef struct THREADPOOL_WORK_ITEM_TAG
+{
+    /*embedded so that scheduling the work item does not allocate*/
+    WORKER_POOL_LINUX_WORK_ITEM worker_pool_work_item;
+    THREADPOOL* threadpool;
+    THREADPOOL_WORK_FUNCTION work_function;
+    void* work_function_context;
+    /*schedules not yet executed, the worker pool work item is only queued when this goes from 0 to 1*/
+    volatile_atomic int32_t pending_schedule_count;
+    /*when the work item was submitted, only set when the statistics are enabled*/
+    double schedule_time_us;
+} THREADPOOL_WORK_ITEM;
+
+typedef struct TIMER_INSTANCE_TAG
+{
+    /*the timer wheel timer lives in the instance, so expirations do not allocate*/
+    TIMER_WHEEL_LINUX_TIMER timer;
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel;
+    /*when the statistics are enabled the timer wheel calls on_timer_callback, which records the lateness and calls work_function*/
+    bool is_lateness_recorded;
+    THREADPOOL_TIMER_LATENESS lateness;
+    THREADPOOL_WORK_FUNCTION work_function;
+    void* work_function_context;
+    /*kept so that threadpool_timer_restart restarts the timer with the same tolerance*/
+    uint32_t tolerance_ms;
+} TIMER_INSTANCE;
+
+static bool is_valid_priority(THREADPOOL_PRIORITY priority)
+{
+    return (priority == THREADPOOL_PRIORITY_HIGH) || (priority == THREADPOOL_PRIORITY_NORMAL) || (priority == THREADPOOL_PRIORITY_LOW);
+}
+
+static WORKER_POOL_LINUX_PRIORITY get_worker_pool_priority(THREADPOOL_PRIORITY priority)
+{
+    WORKER_POOL_LINUX_PRIORITY result;
+
+    if (priority == THREADPOOL_PRIORITY_HIGH)
+    {
+        result = WORKER_POOL_LINUX_PRIORITY_HIGH;
+    }
+    else if (priority == THREADPOOL_PRIORITY_LOW)
+    {
+        result = WORKER_POOL_LINUX_PRIORITY_LOW;
+    }
+    else
+    {
+        result = WORKER_POOL_LINUX_PRIORITY_NORMAL;
+    }
+
+    return result;
+}
+
+static THREADPOOL_QUEUE_WAIT* get_queue_wait(THREADPOOL* threadpool, THREADPOOL_PRIORITY priority)
+{
+    THREADPOOL_QUEUE_WAIT* result;
+
+    if (priority == THREADPOOL_PRIORITY_HIGH)
+    {
+        result = &threadpool->high_priority_queue_wait;
+    }
+    else if (priority == THREADPOOL_PRIORITY_LOW)
+    {
+        result = &threadpool->low_priority_queue_wait;
+    }
+    else
+    {
+        result = &threadpool->normal_priority_queue_wait;
+    }
+
+    return result;
+}
+
+static void queue_wait_init(THREADPOOL_QUEUE_WAIT* queue_wait)
+{
+    (void)interlocked_exchange_64(&queue_wait->work_item_count, 0);
+    (void)interlocked_exchange_64(&queue_wait->total_queue_wait_us, 0);
+    (void)interlocked_exchange_64(&queue_wait->max_queue_wait_us, 0);
+}
+
+static void queue_wait_record(THREADPOOL_QUEUE_WAIT* queue_wait, double schedule_time_us, double start_time_us)
+{
+    double queue_wait_us = start_time_us - schedule_time_us;
+    /*the timer returns -1 on failure, which must not make the wait negative*/
+    int64_t wait_us = (queue_wait_us > 0) ? (int64_t)queue_wait_us : 0;
+
+    (void)interlocked_increment_64(&queue_wait->work_item_count);
+    (void)interlocked_add_64(&queue_wait->total_queue_wait_us, wait_us);
+
+    int64_t max_wait_us = interlocked_add_64(&queue_wait->max_queue_wait_us, 0);
+    while (wait_us > max_wait_us)
+    {
+        int64_t current_max_wait_us = interlocked_compare_exchange_64(&queue_wait->max_queue_wait_us, wait_us, max_wait_us);
+        if (current_max_wait_us == max_wait_us)
+        {
+            break;
+        }
+
+        max_wait_us = current_max_wait_us;
+    }
+}
+
+static void on_work_callback(void* context)
+{
+    if (context == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_026: [ If context is NULL, on_work_callback shall return. ]*/
+        LogError("Invalid arguments: void* context=%p", context);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_027: [ Otherwise context shall be used as the context created in threadpool_schedule_work. ]*/
+        WORK_ITEM_CONTEXT* work_item_context = context;
+        THREADPOOL* threadpool = work_item_context->threadpool;
+
+        if (threadpool->statistics_recorder == NULL)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_028: [ The work_function callback passed to threadpool_schedule_work shall be called, passing to it the work_function_context argument passed to threadpool_schedule_work. ]*/
+            work_item_context->work_function(work_item_context->work_function_context);
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_143: [ If the statistics are enabled, on_work_callback shall call threadpool_statistics_recorder_on_started with the time the work item was scheduled before calling work_function and threadpool_statistics_recorder_on_completed after it. ]*/
+            double start_time_us = threadpool_statistics_recorder_on_started(threadpool->statistics_recorder, work_item_context->schedule_time_us);
+
+            /* Codes_SRS_THREADPOOL_LINUX_01_109: [ If the statistics are enabled, on_work_callback shall add the time the work item waited between being scheduled and the start time returned by threadpool_statistics_recorder_on_started to the queue wait statistics of its priority. ]*/
+            queue_wait_record(work_item_context->queue_wait, work_item_context->schedule_time_us, start_time_us);
+
+            /* Codes_SRS_THREADPOOL_LINUX_01_028: [ The work_function callback passed to threadpool_schedule_work shall be called, passing to it the work_function_context argument passed to threadpool_schedule_work. ]*/
+            work_item_context->work_function(work_item_context->work_function_context);
+
+            (void)threadpool_statistics_recorder_on_completed(threadpool->statistics_recorder, start_time_us);
+        }
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_029: [ on_work_callback shall free the context allocated in threadpool_schedule_work. ]*/
+        free(work_item_context);
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_030: [ on_work_callback shall decrement the count of pending work items and wake threadpool_close if it reached 0. ]*/
+        /*the wake only passes the address to the futex syscall, so it does no harm if threadpool_close saw the 0 first and the threadpool got freed*/
+        if (interlocked_decrement(&threadpool->pending_work_item_count) == 0)
+        {
+            wake_by_address_single(&threadpool->pending_work_item_count);
+        }
+    }
+}
+
+static void wait_for_zero(volatile_atomic int32_t* counter)
+{
+    do
+    {
+        int32_t current_value = interlocked_add(counter, 0);
+        if (current_value == 0)
+        {
+            break;
+        }
+
+        (void)wait_on_address(counter, current_value, UINT32_MAX);
+    } while (1);
+}
+
+static void internal_close(THREADPOOL_HANDLE threadpool)
+{
+    /* Codes_SRS_THREADPOOL_LINUX_01_018: [ threadpool_close shall wait for the API calls in progress to complete. ]*/
+    wait_for_zero(&threadpool->pending_api_calls);
+
+    /* Codes_SRS_THREADPOOL_LINUX_01_019: [ threadpool_close shall wait for all the scheduled work items to complete. ]*/
+    wait_for_zero(&threadpool->pending_work_item_count);
+
+    /* Codes_SRS_THREADPOOL_LINUX_01_020: [ threadpool_close shall set the state to CLOSED. ]*/
+    (void)interlocked_exchange(&threadpool->state, (int32_t)THREADPOOL_LINUX_STATE_CLOSED);
+    wake_by_address_single(&threadpool->state);
+}
+
+THREADPOOL_HANDLE threadpool_create(EXECUTION_ENGINE_HANDLE execution_engine)
+{
+    THREADPOOL_HANDLE result;
+
+    if (execution_engine == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_002: [ If execution_engine is NULL, threadpool_create shall fail and return NULL. ]*/
+        LogError("Invalid arguments: EXECUTION_ENGINE_HANDLE execution_engine=%p", execution_engine);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_001: [ threadpool_create shall allocate a new threadpool object and on success shall return a non-NULL handle. ]*/
+        result = malloc(sizeof(THREADPOOL));
+        if (result == NULL)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_004: [ If any error occurs, threadpool_create shall fail and return NULL. ]*/
+            LogError("malloc(%zu) failed", sizeof(THREADPOOL));
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_003: [ threadpool_create shall obtain the worker pool from the execution engine by calling execution_engine_linux_get_worker_pool. ]*/
+            result->worker_pool = execution_engine_linux_get_worker_pool(execution_engine);
+            if (result->worker_pool == NULL)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_01_004: [ If any error occurs, threadpool_create shall fail and return NULL. ]*/
+                LogError("execution_engine_linux_get_worker_pool failed");
+                free(result);
+                result = NULL;
+            }
+            else
+            {
+                result->execution_engine = execution_engine;
+                (void)interlocked_exchange(&result->pending_api_calls, 0);
+                (void)interlocked_exchange(&result->pending_work_item_count, 0);
+                (void)interlocked_exchange(&result->state, (int32_t)THREADPOOL_LINUX_STATE_CLOSED);
+                /* Codes_SRS_THREADPOOL_LINUX_01_165: [ threadpool_create shall create the threadpool with the statistics disabled. ]*/
+                result->statistics_recorder = NULL;
+
+                /* Codes_SRS_THREADPOOL_LINUX_01_102: [ threadpool_create shall initialize the queue wait statistics of all the priorities to 0. ]*/
+                queue_wait_init(&result->high_priority_queue_wait);
+                queue_wait_init(&result->normal_priority_queue_wait);
+                queue_wait_init(&result->low_priority_queue_wait);
+            }
+        }
+    }
+
+    return result;
+}
+
+void threadpool_destroy(THREADPOOL_HANDLE threadpool)
+{
+    if (threadpool == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_005: [ If threadpool is NULL, threadpool_destroy shall return. ]*/
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p", threadpool);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_007: [ While threadpool is OPENING or CLOSING, threadpool_destroy shall wait for the open or close to complete. ]*/
+        do
+        {
+            int32_t current_state = interlocked_compare_exchange(&threadpool->state, (int32_t)THREADPOOL_LINUX_STATE_CLOSING, (int32_t)THREADPOOL_LINUX_STATE_OPEN);
+
+            if (current_state == (int32_t)THREADPOOL_LINUX_STATE_OPEN)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_01_008: [ threadpool_destroy shall perform an implicit close if threadpool is OPEN. ]*/
+                internal_close(threadpool);
+                break;
+            }
+            else if (current_state == (int32_t)THREADPOOL_LINUX_STATE_CLOSED)
+            {
+                break;
+            }
+
+            (void)wait_on_address(&threadpool->state, current_state, UINT32_MAX);
+        } while (1);
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_006: [ Otherwise, threadpool_destroy shall free all resources associated with threadpool. ]*/
+        if (threadpool->statistics_recorder != NULL)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_164: [ If the statistics are enabled, threadpool_destroy shall destroy the statistics recorder by calling threadpool_statistics_recorder_destroy. ]*/
+            threadpool_statistics_recorder_destroy(threadpool->statistics_recorder);
+        }
+
+        free(threadpool);
+    }
+}
+
+int threadpool_open_async(THREADPOOL_HANDLE threadpool, ON_THREADPOOL_OPEN_COMPLETE on_open_complete, void* on_open_complete_context)
+{
+    int result;
+
+    /* Codes_SRS_THREADPOOL_LINUX_01_011: [ on_open_complete_context shall be allowed to be NULL. ]*/
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_01_009: [ If threadpool is NULL, threadpool_open_async shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_010: [ If on_open_complete is NULL, threadpool_open_async shall fail and return a non-zero value. ]*/
+        (on_open_complete == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, ON_THREADPOOL_OPEN_COMPLETE on_open_complete=%p, void* on_open_complete_context=%p",
+            threadpool, on_open_complete, on_open_complete_context);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_012: [ Otherwise, threadpool_open_async shall switch the state to OPENING. ]*/
+        int32_t current_state = interlocked_compare_exchange(&threadpool->state, (int32_t)THREADPOOL_LINUX_STATE_OPENING, (int32_t)THREADPOOL_LINUX_STATE_CLOSED);
+        if (current_state != (int32_t)THREADPOOL_LINUX_STATE_CLOSED)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_013: [ If threadpool is already OPEN or OPENING, threadpool_open_async shall fail and return a non-zero value. ]*/
+            LogError("Open called in state %" PRI_MU_ENUM "", MU_ENUM_VALUE(THREADPOOL_LINUX_STATE, current_state));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_014: [ threadpool_open_async shall set the state to OPEN. ]*/
+            (void)interlocked_exchange(&threadpool->state, (int32_t)THREADPOOL_LINUX_STATE_OPEN);
+            wake_by_address_single(&threadpool->state);
+
+            /* Codes_SRS_THREADPOOL_LINUX_01_015: [ On success, threadpool_open_async shall call on_open_complete with THREADPOOL_OPEN_OK. ]*/
+            on_open_complete(on_open_complete_context, THREADPOOL_OPEN_OK);
+
+            /* Codes_SRS_THREADPOOL_LINUX_01_016: [ On success, threadpool_open_async shall return 0. ]*/
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+void threadpool_close(THREADPOOL_HANDLE threadpool)
+{
+    if (threadpool == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_017: [ If threadpool is NULL, threadpool_close shall return. ]*/
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p", threadpool);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_021: [ Otherwise, threadpool_close shall switch the state to CLOSING. ]*/
+        if (interlocked_compare_exchange(&threadpool->state, (int32_t)THREADPOOL_LINUX_STATE_CLOSING, (int32_t)THREADPOOL_LINUX_STATE_OPEN) != (int32_t)THREADPOOL_LINUX_STATE_OPEN)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_022: [ If threadpool is not OPEN, threadpool_close shall return. ]*/
+            LogWarning("Not open");
+        }
+        else
+        {
+            internal_close(threadpool);
+        }
+    }
+}
+
+static int schedule_work(THREADPOOL_HANDLE threadpool, WORKER_POOL_LINUX_HANDLE worker_pool, THREADPOOL_PRIORITY priority, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+{
+    int result;
+
+    (void)interlocked_increment(&threadpool->pending_api_calls);
+
+    THREADPOOL_LINUX_STATE state = interlocked_add(&threadpool->state, 0);
+    if (state != THREADPOOL_LINUX_STATE_OPEN)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_031: [ If threadpool is not OPEN, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+        LogWarning("Bad state: %" PRI_MU_ENUM, MU_ENUM_VALUE(THREADPOOL_LINUX_STATE, state));
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_032: [ Otherwise threadpool_schedule_work shall allocate a context where work_function and work_function_context shall be saved. ]*/
+        WORK_ITEM_CONTEXT* work_item_context = malloc(sizeof(WORK_ITEM_CONTEXT));
+        if (work_item_context == NULL)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_035: [ If any error occurs, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+            LogError("malloc(%zu) failed", sizeof(WORK_ITEM_CONTEXT));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            work_item_context->worker_pool_work_item.work_function = on_work_callback;
+            work_item_context->worker_pool_work_item.work_function_context = work_item_context;
+            work_item_context->worker_pool_work_item.priority = get_worker_pool_priority(priority);
+            work_item_context->threadpool = threadpool;
+            work_item_context->work_function = work_function;
+            work_item_context->work_function_context = work_function_context;
+            work_item_context->queue_wait = get_queue_wait(threadpool, priority);
+
+            if (threadpool->statistics_recorder != NULL)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_01_103: [ If the statistics are enabled, threadpool_schedule_work shall save in the context the time the work item is scheduled, obtained by calling timer_global_get_elapsed_us. ]*/
+                work_item_context->schedule_time_us = timer_global_get_elapsed_us();
+            }
+
+            /* Codes_SRS_THREADPOOL_LINUX_01_033: [ threadpool_schedule_work shall increment the count of pending work items. ]*/
+            (void)interlocked_increment(&threadpool->pending_work_item_count);
+
+            /* Codes_SRS_THREADPOOL_LINUX_01_034: [ threadpool_schedule_work shall submit the work item to the worker pool by calling worker_pool_linux_submit with on_work_callback and the newly created context. ]*/
+            if (worker_pool_linux_submit(worker_pool, &work_item_context->worker_pool_work_item) != 0)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_01_035: [ If any error occurs, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+                LogError("worker_pool_linux_submit failed");
+                (void)interlocked_decrement(&threadpool->pending_work_item_count);
+                free(work_item_context);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                if (threadpool->statistics_recorder != NULL)
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_01_142: [ If the statistics are enabled, threadpool_schedule_work shall count the work item as queued by calling threadpool_statistics_recorder_on_queued. ]*/
+                    threadpool_statistics_recorder_on_queued(threadpool->statistics_recorder, 1);
+                }
+
+                /* Codes_SRS_THREADPOOL_LINUX_01_036: [ threadpool_schedule_work shall succeed and return 0. ]*/
+                result = 0;
+            }
+        }
+    }
+
+    (void)interlocked_decrement(&threadpool->pending_api_calls);
+    wake_by_address_single(&threadpool->pending_api_calls);
+
+    return result;
+}
+
+int threadpool_schedule_work(THREADPOOL_HANDLE threadpool, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+{
+    int result;
+
+    /* Codes_SRS_THREADPOOL_LINUX_01_025: [ work_function_context shall be allowed to be NULL. ]*/
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_01_023: [ If threadpool is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_024: [ If work_function is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+        (work_function == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_WORK_FUNCTION work_function=%p, void* work_function_context=%p",
+            threadpool, work_function, work_function_context);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_104: [ threadpool_schedule_work shall schedule the work item with THREADPOOL_PRIORITY_NORMAL, submitting it to the worker pool with WORKER_POOL_LINUX_PRIORITY_NORMAL. ]*/
+        result = schedule_work(threadpool, threadpool->worker_pool, THREADPOOL_PRIORITY_NORMAL, work_function, work_function_context);
+    }
+
+    return result;
+}
+
+int threadpool_schedule_work_with_priority(THREADPOOL_HANDLE threadpool, THREADPOOL_PRIORITY priority, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+{
+    int result;
+
+    /* Codes_SRS_THREADPOOL_LINUX_01_108: [ work_function_context shall be allowed to be NULL. ]*/
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_01_105: [ If threadpool is NULL, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_106: [ If priority is not THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL or THREADPOOL_PRIORITY_LOW, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+        !is_valid_priority(priority) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_107: [ If work_function is NULL, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+        (work_function == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_PRIORITY priority=%" PRI_MU_ENUM ", THREADPOOL_WORK_FUNCTION work_function=%p, void* work_function_context=%p",
+            threadpool, MU_ENUM_VALUE(THREADPOOL_PRIORITY, priority), work_function, work_function_context);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_110: [ Otherwise threadpool_schedule_work_with_priority shall schedule the work item like threadpool_schedule_work, submitting it to the worker pool with the WORKER_POOL_LINUX_PRIORITY matching priority. ]*/
+        /* Codes_SRS_THREADPOOL_LINUX_01_111: [ If any error occurs, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+        result = schedule_work(threadpool, threadpool->worker_pool, priority, work_function, work_function_context);
+    }
+
+    return result;
+}
+
+int threadpool_schedule_work_on_node(THREADPOOL_HANDLE threadpool, uint32_t numa_node, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+{
+    int result;
+
+    /* Codes_SRS_THREADPOOL_LINUX_01_127: [ work_function_context shall be allowed to be NULL. ]*/
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_01_125: [ If threadpool is NULL, threadpool_schedule_work_on_node shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_126: [ If work_function is NULL, threadpool_schedule_work_on_node shall fail and return a non-zero value. ]*/
+        (work_function == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, uint32_t numa_node=%" PRIu32 ", THREADPOOL_WORK_FUNCTION work_function=%p, void* work_function_context=%p",
+            threadpool, numa_node, work_function, work_function_context);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_128: [ threadpool_schedule_work_on_node shall obtain the worker pool of numa_node by calling execution_engine_linux_get_numa_node_worker_pool. ]*/
+        WORKER_POOL_LINUX_HANDLE worker_pool = execution_engine_linux_get_numa_node_worker_pool(threadpool->execution_engine, numa_node);
+        if (worker_pool == NULL)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_130: [ If any error occurs, threadpool_schedule_work_on_node shall fail and return a non-zero value. ]*/
+            LogError("execution_engine_linux_get_numa_node_worker_pool(%p, %" PRIu32 ") failed", threadpool->execution_engine, numa_node);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_129: [ threadpool_schedule_work_on_node shall schedule the work item like threadpool_schedule_work, submitting it to the worker pool of numa_node. ]*/
+            /* Codes_SRS_THREADPOOL_LINUX_01_130: [ If any error occurs, threadpool_schedule_work_on_node shall fail and return a non-zero value. ]*/
+            result = schedule_work(threadpool, worker_pool, THREADPOOL_PRIORITY_NORMAL, work_function, work_function_context);
+        }
+    }
+
+    return result;
+}
+
+static void on_work_batch_item_callback(void* context)
+{
+    if (context == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_096: [ If context is NULL, on_work_batch_item_callback shall return. ]*/
+        LogError("Invalid arguments: void* context=%p", context);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_097: [ Otherwise context shall be used as one of the work items of the batch created in threadpool_schedule_work_batch. ]*/
+        WORK_BATCH_ITEM_CONTEXT* work_batch_item = context;
+        WORK_BATCH_CONTEXT* work_batch = work_batch_item->work_batch;
+        THREADPOOL* threadpool = work_batch->threadpool;
+
+        if (threadpool->statistics_recorder == NULL)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_098: [ on_work_batch_item_callback shall call the work_function of the work item, passing to it the work_function_context of the work item. ]*/
+            work_batch_item->work_function(work_batch_item->work_function_context);
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_146: [ If the statistics are enabled, on_work_batch_item_callback shall call threadpool_statistics_recorder_on_started with the time the batch was scheduled before calling work_function and threadpool_statistics_recorder_on_completed after it. ]*/
+            double start_time_us = threadpool_statistics_recorder_on_started(threadpool->statistics_recorder, work_batch->schedule_time_us);
+
+            /* Codes_SRS_THREADPOOL_LINUX_01_098: [ on_work_batch_item_callback shall call the work_function of the work item, passing to it the work_function_context of the work item. ]*/
+            work_batch_item->work_function(work_batch_item->work_function_context);
+
+            (void)threadpool_statistics_recorder_on_completed(threadpool->statistics_recorder, start_time_us);
+        }
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_099: [ on_work_batch_item_callback shall decrement the count of work items of the batch not executed yet and free the batch if it reached 0. ]*/
+        if (interlocked_decrement(&work_batch->pending_work_item_count) == 0)
+        {
+            free(work_batch);
+        }
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_100: [ on_work_batch_item_callback shall decrement the count of pending work items of the threadpool and wake threadpool_close if it reached 0. ]*/
+        if (interlocked_decrement(&threadpool->pending_work_item_count) == 0)
+        {
+            wake_by_address_single(&threadpool->pending_work_item_count);
+        }
+    }
+}
+
+int threadpool_schedule_work_batch(THREADPOOL_HANDLE threadpool, const THREADPOOL_WORK_BATCH_ITEM* work_items, uint32_t work_item_count)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_01_086: [ If threadpool is NULL, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_087: [ If work_items is NULL, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+        (work_items == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_088: [ If work_item_count is 0 or greater than INT32_MAX, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+        (work_item_count == 0) ||
+        (work_item_count > INT32_MAX)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, const THREADPOOL_WORK_BATCH_ITEM* work_items=%p, uint32_t work_item_count=%" PRIu32 "",
+            threadpool, work_items, work_item_count);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        uint32_t i;
+
+        for (i = 0; i < work_item_count; i++)
+        {
+            if (work_items[i].work_function == NULL)
+            {
+                break;
+            }
+        }
+
+        if (i < work_item_count)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_089: [ If the work_function of any of the work items is NULL, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+            LogError("Invalid arguments: work_items[%" PRIu32 "].work_function is NULL", i);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            (void)interlocked_increment(&threadpool->pending_api_calls);
+
+            /* Codes_SRS_THREADPOOL_LINUX_01_090: [ threadpool_schedule_work_batch shall check the state of threadpool only once for all the work items. ]*/
+            THREADPOOL_LINUX_STATE state = interlocked_add(&threadpool->state, 0);
+            if (state != THREADPOOL_LINUX_STATE_OPEN)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_01_091: [ If threadpool is not OPEN, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+                LogWarning("Bad state: %" PRI_MU_ENUM, MU_ENUM_VALUE(THREADPOOL_LINUX_STATE, state));
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_01_092: [ Otherwise threadpool_schedule_work_batch shall allocate in a single allocation a batch holding a context for each of the work items, where the work_function and work_function_context of the work item shall be saved. ]*/
+                WORK_BATCH_CONTEXT* work_batch = malloc(sizeof(WORK_BATCH_CONTEXT) + work_item_count * sizeof(WORK_BATCH_ITEM_CONTEXT));
+                if (work_batch == NULL)
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_01_095: [ If any error occurs, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+                    LogError("malloc(%zu) failed", sizeof(WORK_BATCH_CONTEXT) + work_item_count * sizeof(WORK_BATCH_ITEM_CONTEXT));
+                    result = MU_FAILURE;
+                }
+                else
+                {
+                    work_batch->threadpool = threadpool;
+                    (void)interlocked_exchange(&work_batch->pending_work_item_count, (int32_t)work_item_count);
+
+                    for (i = 0; i < work_item_count; i++)
+                    {
+                        work_batch->work_items[i].worker_pool_work_item.work_function = on_work_batch_item_callback;
+                        work_batch->work_items[i].worker_pool_work_item.work_function_context = &work_batch->work_items[i];
+                        /* Codes_SRS_THREADPOOL_LINUX_01_119: [ threadpool_schedule_work_batch shall submit the work items with WORKER_POOL_LINUX_PRIORITY_NORMAL. ]*/
+                        work_batch->work_items[i].worker_pool_work_item.priority = WORKER_POOL_LINUX_PRIORITY_NORMAL;
+                        work_batch->work_items[i].worker_pool_work_item.next = (i + 1 < work_item_count) ? &work_batch->work_items[i + 1].worker_pool_work_item : NULL;
+                        work_batch->work_items[i].work_batch = work_batch;
+                        work_batch->work_items[i].work_function = work_items[i].work_function;
+                        work_batch->work_items[i].work_function_context = work_items[i].work_function_context;
+                    }
+
+                    if (threadpool->statistics_recorder != NULL)
+                    {
+                        /* Codes_SRS_THREADPOOL_LINUX_01_144: [ If the statistics are enabled, threadpool_schedule_work_batch shall save in the batch the time it is scheduled, obtained by calling timer_global_get_elapsed_us. ]*/
+                        work_batch->schedule_time_us = timer_global_get_elapsed_us();
+                    }
+
+                    /* Codes_SRS_THREADPOOL_LINUX_01_093: [ threadpool_schedule_work_batch shall add work_item_count to the count of pending work items. ]*/
+                    (void)interlocked_add(&threadpool->pending_work_item_count, (int32_t)work_item_count);
+
+                    /* Codes_SRS_THREADPOOL_LINUX_01_094: [ threadpool_schedule_work_batch shall submit all the work items to the worker pool at once by calling worker_pool_linux_submit_batch with the list of the worker pool work items of the batch. ]*/
+                    if (worker_pool_linux_submit_batch(threadpool->worker_pool, &work_batch->work_items[0].worker_pool_work_item) != 0)
+                    {
+                        /* Codes_SRS_THREADPOOL_LINUX_01_095: [ If any error occurs, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+                        LogError("worker_pool_linux_submit_batch failed");
+                        (void)interlocked_add(&threadpool->pending_work_item_count, -(int32_t)work_item_count);
+                        free(work_batch);
+                        result = MU_FAILURE;
+                    }
+                    else
+                    {
+                        if (threadpool->statistics_recorder != NULL)
+                        {
+                            /* Codes_SRS_THREADPOOL_LINUX_01_145: [ If the statistics are enabled, threadpool_schedule_work_batch shall count the work items as queued by calling threadpool_statistics_recorder_on_queued with work_item_count. ]*/
+                            threadpool_statistics_recorder_on_queued(threadpool->statistics_recorder, work_item_count);
+                        }
+
+                        /* Codes_SRS_THREADPOOL_LINUX_01_101: [ threadpool_schedule_work_batch shall succeed and return 0. ]*/
+                        result = 0;
+                    }
+                }
+            }
+
+            (void)interlocked_decrement(&threadpool->pending_api_calls);
+            wake_by_address_single(&threadpool->pending_api_calls);
+        }
+    }
+
+    return result;
+}
+
+static void on_work_item_callback(void* context)
+{
+    if (context == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_076: [ If context is NULL, on_work_item_callback shall return. ]*/
+        LogError("Invalid arguments: void* context=%p", context);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_077: [ Otherwise context shall be used as the work item created in threadpool_create_work_item. ]*/
+        THREADPOOL_WORK_ITEM* work_item = context;
+        THREADPOOL* threadpool = work_item->threadpool;
+        /*the schedules made while the work item executes are counted as queued since the call completed*/
+        double schedule_time_us = work_item->schedule_time_us;
+        int32_t remaining_schedule_count;
+        bool is_submitted_again = false;
+
+        do
+        {
+            if (threadpool->statistics_recorder == NULL)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_01_078: [ on_work_item_callback shall call the work_function passed to threadpool_create_work_item, passing to it the work_function_context argument passed to threadpool_create_work_item, once for each schedule of the work item. ]*/
+                work_item->work_function(work_item->work_function_context);
+            }
+            else
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_01_149: [ If the statistics are enabled, on_work_item_callback shall call threadpool_statistics_recorder_on_started before each call of work_function and threadpool_statistics_recorder_on_completed after it, with the time the work item was submitted for the first call and the time the previous call completed for the others. ]*/
+                double start_time_us = threadpool_statistics_recorder_on_started(threadpool->statistics_recorder, schedule_time_us);
+
+                /* Codes_SRS_THREADPOOL_LINUX_01_078: [ on_work_item_callback shall call the work_function passed to threadpool_create_work_item, passing to it the work_function_context argument passed to threadpool_create_work_item, once for each schedule of the work item. ]*/
+                work_item->work_function(work_item->work_function_context);
+
+                schedule_time_us = threadpool_statistics_recorder_on_completed(threadpool->statistics_recorder, start_time_us);
+            }
+
+            /* Codes_SRS_THREADPOOL_LINUX_01_079: [ After each call, on_work_item_callback shall decrement the count of pending schedules of the work item and wake threadpool_destroy_work_item if it reached 0. ]*/
+            /*once the count is 0 the work item can be scheduled again or destroyed, so it is not touched anymore*/
+            remaining_schedule_count = interlocked_decrement(&work_item->pending_schedule_count);
+            if (remaining_schedule_count == 0)
+            {
+                wake_by_address_single(&work_item->pending_schedule_count);
+            }
+
+            /* Codes_SRS_THREADPOOL_LINUX_01_080: [ After each call, on_work_item_callback shall decrement the count of pending work items of the threadpool and wake threadpool_close if it reached 0. ]*/
+            if (interlocked_decrement(&threadpool->pending_work_item_count) == 0)
+            {
+                wake_by_address_single(&threadpool->pending_work_item_count);
+            }
+
+            if (remaining_schedule_count != 0)
+            {
+                if (threadpool->statistics_recorder != NULL)
+                {
+                    work_item->schedule_time_us = schedule_time_us;
+                }
+
+                /* Codes_SRS_THREADPOOL_LINUX_01_175: [ If the work item has schedules left, on_work_item_callback shall submit the worker pool work item again by calling worker_pool_linux_submit and return, so that the work queued while it executed runs before its next call. ]*/
+                /*the pending schedules keep the count above 0, so nobody else submits the work item meanwhile*/
+                if (worker_pool_linux_submit(threadpool->worker_pool, &work_item->worker_pool_work_item) != 0)
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_01_176: [ If worker_pool_linux_submit fails, on_work_item_callback shall execute the schedules left on the current thread. ]*/
+                    LogError("worker_pool_linux_submit failed, executing the %" PRId32 " schedules left on the current thread", remaining_schedule_count);
+                }
+                else
+                {
+                    is_submitted_again = true;
+                }
+            }
+        } while ((remaining_schedule_count != 0) && !is_submitted_again);
+    }
+}
+
+THREADPOOL_WORK_ITEM_HANDLE threadpool_create_work_item(THREADPOOL_HANDLE threadpool, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+{
+    THREADPOOL_WORK_ITEM_HANDLE result;
+
+    /* Codes_SRS_THREADPOOL_LINUX_01_063: [ work_function_context shall be allowed to be NULL. ]*/
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_01_061: [ If threadpool is NULL, threadpool_create_work_item shall fail and return NULL. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_062: [ If work_function is NULL, threadpool_create_work_item shall fail and return NULL. ]*/
+        (work_function == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_WORK_FUNCTION work_function=%p, void* work_function_context=%p",
+            threadpool, work_function, work_function_context);
+        result = NULL;
+    }
+    else
+    {
+        (void)interlocked_increment(&threadpool->pending_api_calls);
+
+        THREADPOOL_LINUX_STATE state = interlocked_add(&threadpool->state, 0);
+        if (state != THREADPOOL_LINUX_STATE_OPEN)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_064: [ If threadpool is not OPEN, threadpool_create_work_item shall fail and return NULL. ]*/
+            LogWarning("Bad state: %" PRI_MU_ENUM, MU_ENUM_VALUE(THREADPOOL_LINUX_STATE, state));
+            result = NULL;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_065: [ threadpool_create_work_item shall allocate a work item where work_function and work_function_context shall be saved, together with the worker pool work item that is submitted when the work item is scheduled. ]*/
+            result = malloc(sizeof(THREADPOOL_WORK_ITEM));
+            if (result == NULL)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_01_066: [ If any error occurs, threadpool_create_work_item shall fail and return NULL. ]*/
+                LogError("malloc(%zu) failed", sizeof(THREADPOOL_WORK_ITEM));
+            }
+            else
+            {
+                result->worker_pool_work_item.work_function = on_work_item_callback;
+                result->worker_pool_work_item.work_function_context = result;
+                /* Codes_SRS_THREADPOOL_LINUX_01_120: [ threadpool_create_work_item shall set the priority of the worker pool work item to WORKER_POOL_LINUX_PRIORITY_NORMAL. ]*/
+                result->worker_pool_work_item.priority = WORKER_POOL_LINUX_PRIORITY_NORMAL;
+                result->threadpool = threadpool;
+                result->work_function = work_function;
+                result->work_function_context = work_function_context;
+                (void)interlocked_exchange(&result->pending_schedule_count, 0);
+            }
+        }
+
+        (void)interlocked_decrement(&threadpool->pending_api_calls);
+        wake_by_address_single(&threadpool->pending_api_calls);
+    }
+
+    return result;
+}
+
+int threadpool_schedule_work_item(THREADPOOL_HANDLE threadpool, THREADPOOL_WORK_ITEM_HANDLE work_item)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_01_067: [ If threadpool is NULL, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_068: [ If work_item is NULL, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
+        (work_item == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_WORK_ITEM_HANDLE work_item=%p",
+            threadpool, work_item);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        (void)interlocked_increment(&threadpool->pending_api_calls);
+
+        THREADPOOL_LINUX_STATE state = interlocked_add(&threadpool->state, 0);
+        if (state != THREADPOOL_LINUX_STATE_OPEN)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_069: [ If threadpool is not OPEN, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
+            LogWarning("Bad state: %" PRI_MU_ENUM, MU_ENUM_VALUE(THREADPOOL_LINUX_STATE, state));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_070: [ threadpool_schedule_work_item shall increment the count of pending work items of the threadpool. ]*/
+            (void)interlocked_increment(&threadpool->pending_work_item_count);
+
+            /* Codes_SRS_THREADPOOL_LINUX_01_071: [ threadpool_schedule_work_item shall increment the count of pending schedules of work_item. ]*/
+            if (interlocked_increment(&work_item->pending_schedule_count) != 1)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_01_072: [ If the work item was already queued or executing, threadpool_schedule_work_item shall succeed and return 0 without submitting it again, the work item is executed once more after the executions already pending. ]*/
+                if (threadpool->statistics_recorder != NULL)
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_01_148: [ If the statistics are enabled, threadpool_schedule_work_item shall count each successful schedule as queued by calling threadpool_statistics_recorder_on_queued. ]*/
+                    threadpool_statistics_recorder_on_queued(threadpool->statistics_recorder, 1);
+                }
+
+                result = 0;
+            }
+            else
+            {
+                if (threadpool->statistics_recorder != NULL)
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_01_147: [ If the statistics are enabled, threadpool_schedule_work_item shall save in work_item the time it is submitted, obtained by calling timer_global_get_elapsed_us. ]*/
+                    work_item->schedule_time_us = timer_global_get_elapsed_us();
+                }
+
+                /* Codes_SRS_THREADPOOL_LINUX_01_073: [ Otherwise threadpool_schedule_work_item shall submit the worker pool work item embedded in work_item by calling worker_pool_linux_submit. ]*/
+                if (worker_pool_linux_submit(threadpool->worker_pool, &work_item->worker_pool_work_item) != 0)
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_01_074: [ If worker_pool_linux_submit fails, threadpool_schedule_work_item shall decrement the counts it incremented, fail and return a non-zero value. ]*/
+                    LogError("worker_pool_linux_submit failed");
+                    (void)interlocked_decrement(&threadpool->pending_work_item_count);
+                    if (interlocked_decrement(&work_item->pending_schedule_count) != 0)
+                    {
+                        /* Codes_SRS_THREADPOOL_LINUX_01_075: [ If the work item was scheduled by other threads while it was being submitted, threadpool_schedule_work_item shall execute these schedules by calling on_work_item_callback, since they relied on this submission. ]*/
+                        on_work_item_callback(work_item);
+                    }
+                    result = MU_FAILURE;
+                }
+                else
+                {
+                    if (threadpool->statistics_recorder != NULL)
+                    {
+                        /* Codes_SRS_THREADPOOL_LINUX_01_148: [ If the statistics are enabled, threadpool_schedule_work_item shall count each successful schedule as queued by calling threadpool_statistics_recorder_on_queued. ]*/
+                        threadpool_statistics_recorder_on_queued(threadpool->statistics_recorder, 1);
+                    }
+
+                    /* Codes_SRS_THREADPOOL_LINUX_01_085: [ threadpool_schedule_work_item shall succeed and return 0. ]*/
+                    result = 0;
+                }
+            }
+        }
+
+        (void)interlocked_decrement(&threadpool->pending_api_calls);
+        wake_by_address_single(&threadpool->pending_api_calls);
+    }
+
+    return result;
+}
+
+void threadpool_destroy_work_item(THREADPOOL_HANDLE threadpool, THREADPOOL_WORK_ITEM_HANDLE work_item)
+{
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_01_081: [ If threadpool is NULL, threadpool_destroy_work_item shall return. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_082: [ If work_item is NULL, threadpool_destroy_work_item shall return. ]*/
+        (work_item == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_WORK_ITEM_HANDLE work_item=%p",
+            threadpool, work_item);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_083: [ threadpool_destroy_work_item shall wait for all the scheduled executions of work_item to complete. ]*/
+        wait_for_zero(&work_item->pending_schedule_count);
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_084: [ threadpool_destroy_work_item shall free the work item. ]*/
+        free(work_item);
+    }
+}
+
+static void on_timer_callback(void* context)
+{
+    if (context == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_157: [ If context is NULL, on_timer_callback shall return. ]*/
+        LogError("Invalid arguments: void* context=%p", context);
+    }
+    else
+    {
+        TIMER_INSTANCE* timer_instance = context;
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_158: [ on_timer_callback shall record the lateness of the timer by calling threadpool_timer_lateness_on_fired and then call the work_function of the timer, passing to it its work_function_context. ]*/
+        threadpool_timer_lateness_on_fired(&timer_instance->lateness);
+        timer_instance->work_function(timer_instance->work_function_context);
+    }
+}
+
+static int start_timer(THREADPOOL_HANDLE threadpool, THREADPOOL_PRIORITY priority, uint32_t start_delay_ms, uint32_t timer_period_ms, uint32_t tolerance_ms, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context, TIMER_INSTANCE_HANDLE* timer_handle)
+{
+    int result;
+
+    (void)interlocked_increment(&threadpool->pending_api_calls);
+
+    THREADPOOL_LINUX_STATE state = interlocked_add(&threadpool->state, 0);
+    if (state != THREADPOOL_LINUX_STATE_OPEN)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_045: [ If threadpool is not OPEN, threadpool_timer_start shall fail and return a non-zero value. ]*/
+        LogWarning("Bad state: %" PRI_MU_ENUM, MU_ENUM_VALUE(THREADPOOL_LINUX_STATE, state));
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_046: [ threadpool_timer_start shall obtain the timer wheel of the execution engine by calling execution_engine_linux_get_timer_wheel. ]*/
+        TIMER_WHEEL_LINUX_HANDLE timer_wheel = execution_engine_linux_get_timer_wheel(threadpool->execution_engine);
+        if (timer_wheel == NULL)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_051: [ If any error occurs, threadpool_timer_start shall fail and return a non-zero value. ]*/
+            LogError("execution_engine_linux_get_timer_wheel failed");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_047: [ threadpool_timer_start shall allocate a context for the timer. ]*/
+            TIMER_INSTANCE_HANDLE timer_instance = malloc(sizeof(TIMER_INSTANCE));
+            if (timer_instance == NULL)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_01_051: [ If any error occurs, threadpool_timer_start shall fail and return a non-zero value. ]*/
+                LogError("malloc(%zu) failed", sizeof(TIMER_INSTANCE));
+                result = MU_FAILURE;
+            }
+            else
+            {
+                TIMER_WHEEL_LINUX_ON_TIMER_EXPIRED on_timer_expired = work_function;
+                void* on_timer_expired_context = work_function_context;
+
+                timer_instance->timer_wheel = timer_wheel;
+                timer_instance->work_function = work_function;
+                timer_instance->work_function_context = work_function_context;
+                timer_instance->tolerance_ms = tolerance_ms;
+                timer_instance->is_lateness_recorded = (threadpool->statistics_recorder != NULL);
+                if (timer_instance->is_lateness_recorded)
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_01_154: [ If the statistics are enabled, threadpool_timer_start shall initialize the lateness of the timer by calling threadpool_timer_lateness_init and initialize the timer with on_timer_callback and the timer instance instead of work_function and work_function_context. ]*/
+                    threadpool_timer_lateness_init(&timer_instance->lateness);
+                    on_timer_expired = on_timer_callback;
+                    on_timer_expired_context = timer_instance;
+                }
+
+                /* Codes_SRS_THREADPOOL_LINUX_01_048: [ threadpool_timer_start shall initialize the timer by calling timer_wheel_linux_timer_init with WORKER_POOL_LINUX_PRIORITY_NORMAL, work_function and work_function_context. ]*/
+                if (timer_wheel_linux_timer_init(&timer_instance->timer, get_worker_pool_priority(priority), on_timer_expired, on_timer_expired_context) != 0)
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_01_051: [ If any error occurs, threadpool_timer_start shall fail and return a non-zero value. ]*/
+                    LogError("timer_wheel_linux_timer_init failed");
+                    free(timer_instance);
+                    result = MU_FAILURE;
+                }
+                else
+                {
+                    if (timer_instance->is_lateness_recorded)
+                    {
+                        /* Codes_SRS_THREADPOOL_LINUX_01_155: [ If the statistics are enabled, threadpool_timer_start shall compute when the timer is due by calling threadpool_timer_lateness_set_due_time with start_delay_ms and timer_period_ms before starting it. ]*/
+                        threadpool_timer_lateness_set_due_time(&timer_instance->lateness, start_delay_ms, timer_period_ms);
+                    }
+
+                    /* Codes_SRS_THREADPOOL_LINUX_01_049: [ threadpool_timer_start shall start the timer by calling timer_wheel_linux_timer_start with start_delay_ms, timer_period_ms and the tolerance of the timer, which is 0 unless the timer is started by threadpool_timer_start_with_tolerance. ]*/
+                    if (timer_wheel_linux_timer_start(timer_wheel, &timer_instance->timer, start_delay_ms, timer_period_ms, tolerance_ms) != 0)
+                    {
+                        /* Codes_SRS_THREADPOOL_LINUX_01_051: [ If any error occurs, threadpool_timer_start shall fail and return a non-zero value. ]*/
+                        LogError("timer_wheel_linux_timer_start(start_delay_ms=%" PRIu32 ", timer_period_ms=%" PRIu32 ", tolerance_ms=%" PRIu32 ") failed", start_delay_ms, timer_period_ms, tolerance_ms);
+                        free(timer_instance);
+                        result = MU_FAILURE;
+                    }
+                    else
+                    {
+                        /* Codes_SRS_THREADPOOL_LINUX_01_050: [ threadpool_timer_start shall return the allocated handle in timer_handle and succeed, returning 0. ]*/
+                        *timer_handle = timer_instance;
+                        result = 0;
+                    }
+                }
+            }
+        }
+    }
+
+    (void)interlocked_decrement(&threadpool->pending_api_calls);
+    wake_by_address_single(&threadpool->pending_api_calls);
+
+    return result;
+}
+
+int threadpool_timer_start(THREADPOOL_HANDLE threadpool, uint32_t start_delay_ms, uint32_t timer_period_ms, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context, TIMER_INSTANCE_HANDLE* timer_handle)
+{
+    int result;
+
+    /* Codes_SRS_THREADPOOL_LINUX_01_044: [ work_function_context shall be allowed to be NULL. ]*/
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_01_041: [ If threadpool is NULL, threadpool_timer_start shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_042: [ If work_function is NULL, threadpool_timer_start shall fail and return a non-zero value. ]*/
+        (work_function == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_043: [ If timer_handle is NULL, threadpool_timer_start shall fail and return a non-zero value. ]*/
+        (timer_handle == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, uint32_t start_delay_ms=%" PRIu32 ", uint32_t timer_period_ms=%" PRIu32 ", THREADPOOL_WORK_FUNCTION work_function=%p, void* work_function_context=%p, TIMER_INSTANCE_HANDLE* timer_handle=%p",
+            threadpool, start_delay_ms, timer_period_ms, work_function, work_function_context, timer_handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        result = start_timer(threadpool, THREADPOOL_PRIORITY_NORMAL, start_delay_ms, timer_period_ms, 0, work_function, work_function_context, timer_handle);
+    }
+
+    return result;
+}
+
+int threadpool_timer_start_with_priority(THREADPOOL_HANDLE threadpool, THREADPOOL_PRIORITY priority, uint32_t start_delay_ms, uint32_t timer_period_ms, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context, TIMER_INSTANCE_HANDLE* timer_handle)
+{
+    int result;
+
+    /* Codes_SRS_THREADPOOL_LINUX_01_116: [ work_function_context shall be allowed to be NULL. ]*/
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_01_112: [ If threadpool is NULL, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_113: [ If priority is not THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL or THREADPOOL_PRIORITY_LOW, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+        !is_valid_priority(priority) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_114: [ If work_function is NULL, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+        (work_function == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_115: [ If timer_handle is NULL, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+        (timer_handle == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_PRIORITY priority=%" PRI_MU_ENUM ", uint32_t start_delay_ms=%" PRIu32 ", uint32_t timer_period_ms=%" PRIu32 ", THREADPOOL_WORK_FUNCTION work_function=%p, void* work_function_context=%p, TIMER_INSTANCE_HANDLE* timer_handle=%p",
+            threadpool, MU_ENUM_VALUE(THREADPOOL_PRIORITY, priority), start_delay_ms, timer_period_ms, work_function, work_function_context, timer_handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_117: [ Otherwise threadpool_timer_start_with_priority shall start the timer like threadpool_timer_start, initializing it with the WORKER_POOL_LINUX_PRIORITY matching priority. ]*/
+        /* Codes_SRS_THREADPOOL_LINUX_01_118: [ If any error occurs, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+        result = start_timer(threadpool, priority, start_delay_ms, timer_period_ms, 0, work_function, work_function_context, timer_handle);
+    }
+
+    return result;
+}
+
+int threadpool_timer_start_with_tolerance(THREADPOOL_HANDLE threadpool, uint32_t start_delay_ms, uint32_t timer_period_ms, uint32_t tolerance_ms, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context, TIMER_INSTANCE_HANDLE* timer_handle)
+{
+    int result;
+
+    /* Codes_SRS_THREADPOOL_LINUX_01_169: [ work_function_context shall be allowed to be NULL. ]*/
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_01_166: [ If threadpool is NULL, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_167: [ If work_function is NULL, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+        (work_function == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_168: [ If timer_handle is NULL, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+        (timer_handle == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, uint32_t start_delay_ms=%" PRIu32 ", uint32_t timer_period_ms=%" PRIu32 ", uint32_t tolerance_ms=%" PRIu32 ", THREADPOOL_WORK_FUNCTION work_function=%p, void* work_function_context=%p, TIMER_INSTANCE_HANDLE* timer_handle=%p",
+            threadpool, start_delay_ms, timer_period_ms, tolerance_ms, work_function, work_function_context, timer_handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_170: [ Otherwise threadpool_timer_start_with_tolerance shall start the timer like threadpool_timer_start, passing tolerance_ms to timer_wheel_linux_timer_start. ]*/
+        /* Codes_SRS_THREADPOOL_LINUX_01_171: [ If any error occurs, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+        result = start_timer(threadpool, THREADPOOL_PRIORITY_NORMAL, start_delay_ms, timer_period_ms, tolerance_ms, work_function, work_function_context, timer_handle);
+    }
+
+    return result;
+}
+
+int threadpool_timer_restart(TIMER_INSTANCE_HANDLE timer, uint32_t start_delay_ms, uint32_t timer_period_ms)
+{
+    int result;
+
+    if (timer == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_052: [ If timer is NULL, threadpool_timer_restart shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: TIMER_INSTANCE_HANDLE timer=%p, uint32_t start_delay_ms=%" PRIu32 ", uint32_t timer_period_ms=%" PRIu32 "",
+            timer, start_delay_ms, timer_period_ms);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        if (timer->is_lateness_recorded)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_156: [ If the lateness of the timer is recorded, threadpool_timer_restart shall compute when the timer is due by calling threadpool_timer_lateness_set_due_time with start_delay_ms and timer_period_ms before restarting it. ]*/
+            threadpool_timer_lateness_set_due_time(&timer->lateness, start_delay_ms, timer_period_ms);
+        }
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_053: [ threadpool_timer_restart shall restart the timer by calling timer_wheel_linux_timer_start with start_delay_ms, timer_period_ms and the tolerance of the timer. ]*/
+        if (timer_wheel_linux_timer_start(timer->timer_wheel, &timer->timer, start_delay_ms, timer_period_ms, timer->tolerance_ms) != 0)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_055: [ If timer_wheel_linux_timer_start fails, threadpool_timer_restart shall fail and return a non-zero value. ]*/
+            LogError("timer_wheel_linux_timer_start(start_delay_ms=%" PRIu32 ", timer_period_ms=%" PRIu32 ", tolerance_ms=%" PRIu32 ") failed", start_delay_ms, timer_period_ms, timer->tolerance_ms);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_054: [ threadpool_timer_restart shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+int threadpool_timer_restart_with_tolerance(TIMER_INSTANCE_HANDLE timer, uint32_t start_delay_ms, uint32_t timer_period_ms, uint32_t tolerance_ms)
+{
+    int result;
+
+    if (timer == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_172: [ If timer is NULL, threadpool_timer_restart_with_tolerance shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: TIMER_INSTANCE_HANDLE timer=%p, uint32_t start_delay_ms=%" PRIu32 ", uint32_t timer_period_ms=%" PRIu32 ", uint32_t tolerance_ms=%" PRIu32 "",
+            timer, start_delay_ms, timer_period_ms, tolerance_ms);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_173: [ Otherwise threadpool_timer_restart_with_tolerance shall save tolerance_ms as the tolerance of the timer and restart the timer like threadpool_timer_restart. ]*/
+        timer->tolerance_ms = tolerance_ms;
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_174: [ If any error occurs, threadpool_timer_restart_with_tolerance shall fail and return a non-zero value. ]*/
+        result = threadpool_timer_restart(timer, start_delay_ms, timer_period_ms);
+    }
+
+    return result;
+}
+
+void threadpool_timer_cancel(TIMER_INSTANCE_HANDLE timer)
+{
+    if (timer == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_056: [ If timer is NULL, threadpool_timer_cancel shall return. ]*/
+        LogError("Invalid arguments: TIMER_INSTANCE_HANDLE timer=%p", timer);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_057: [ threadpool_timer_cancel shall stop the timer and wait for its callback to complete by calling timer_wheel_linux_timer_cancel. ]*/
+        timer_wheel_linux_timer_cancel(timer->timer_wheel, &timer->timer);
+    }
+}
+
+void threadpool_timer_destroy(TIMER_INSTANCE_HANDLE timer)
+{
+    if (timer == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_058: [ If timer is NULL, threadpool_timer_destroy shall return. ]*/
+        LogError("Invalid arguments: TIMER_INSTANCE_HANDLE timer=%p", timer);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_059: [ threadpool_timer_destroy shall stop the timer and wait for its callback to complete by calling timer_wheel_linux_timer_cancel. ]*/
+        timer_wheel_linux_timer_cancel(timer->timer_wheel, &timer->timer);
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_060: [ threadpool_timer_destroy shall free all resources in timer. ]*/
+        free(timer);
+    }
+}
+
+int threadpool_get_queue_wait_statistics(THREADPOOL_HANDLE threadpool, THREADPOOL_PRIORITY priority, THREADPOOL_QUEUE_WAIT_STATISTICS* statistics)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_01_121: [ If threadpool is NULL, threadpool_get_queue_wait_statistics shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_122: [ If priority is not THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL or THREADPOOL_PRIORITY_LOW, threadpool_get_queue_wait_statistics shall fail and return a non-zero value. ]*/
+        !is_valid_priority(priority) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_123: [ If statistics is NULL, threadpool_get_queue_wait_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_PRIORITY priority=%" PRI_MU_ENUM ", THREADPOOL_QUEUE_WAIT_STATISTICS* statistics=%p",
+            threadpool, MU_ENUM_VALUE(THREADPOOL_PRIORITY, priority), statistics);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        THREADPOOL_QUEUE_WAIT* queue_wait = get_queue_wait(threadpool, priority);
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_124: [ Otherwise threadpool_get_queue_wait_statistics shall fill statistics with the count of work items of priority that started executing and the total and maximum time in microseconds they waited, and return 0. ]*/
+        /*the counters are read one at a time, so they can be off by the work items starting meanwhile*/
+        statistics->work_item_count = (uint64_t)interlocked_add_64(&queue_wait->work_item_count, 0);
+        statistics->total_queue_wait_us = (uint64_t)interlocked_add_64(&queue_wait->total_queue_wait_us, 0);
+        statistics->max_queue_wait_us = (uint64_t)interlocked_add_64(&queue_wait->max_queue_wait_us, 0);
+        result = 0;
+    }
+
+    return result;
+}
+
+int threadpool_enable_statistics(THREADPOOL_HANDLE threadpool)
+{
+    int result;
+
+    if (threadpool == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_131: [ If threadpool is NULL, threadpool_enable_statistics shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p", threadpool);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_132: [ threadpool_enable_statistics shall switch the state from CLOSED to OPENING, so that the threadpool cannot be opened while the statistics are enabled. ]*/
+        int32_t current_state = interlocked_compare_exchange(&threadpool->state, (int32_t)THREADPOOL_LINUX_STATE_OPENING, (int32_t)THREADPOOL_LINUX_STATE_CLOSED);
+        if (current_state != (int32_t)THREADPOOL_LINUX_STATE_CLOSED)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_133: [ If threadpool is not CLOSED, threadpool_enable_statistics shall fail and return a non-zero value. ]*/
+            LogError("Cannot enable the statistics in state %" PRI_MU_ENUM "", MU_ENUM_VALUE(THREADPOOL_LINUX_STATE, current_state));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            if (threadpool->statistics_recorder != NULL)
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_01_134: [ If the statistics are already enabled, threadpool_enable_statistics shall succeed and return 0. ]*/
+                result = 0;
+            }
+            else
+            {
+                /* Codes_SRS_THREADPOOL_LINUX_01_135: [ Otherwise threadpool_enable_statistics shall create the statistics recorder by calling threadpool_statistics_recorder_create. ]*/
+                threadpool->statistics_recorder = threadpool_statistics_recorder_create();
+                if (threadpool->statistics_recorder == NULL)
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_01_138: [ If any error occurs, threadpool_enable_statistics shall fail and return a non-zero value. ]*/
+                    LogError("threadpool_statistics_recorder_create failed");
+                    result = MU_FAILURE;
+                }
+                else
+                {
+                    /* Codes_SRS_THREADPOOL_LINUX_01_137: [ threadpool_enable_statistics shall succeed and return 0. ]*/
+                    result = 0;
+                }
+            }
+
+            /* Codes_SRS_THREADPOOL_LINUX_01_136: [ threadpool_enable_statistics shall set the state back to CLOSED. ]*/
+            (void)interlocked_exchange(&threadpool->state, (int32_t)THREADPOOL_LINUX_STATE_CLOSED);
+            wake_by_address_single(&threadpool->state);
+        }
+    }
+
+    return result;
+}
+
+int threadpool_get_statistics(THREADPOOL_HANDLE threadpool, THREADPOOL_STATISTICS* statistics)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_01_139: [ If threadpool is NULL, threadpool_get_statistics shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_140: [ If statistics is NULL, threadpool_get_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_STATISTICS* statistics=%p", threadpool, statistics);
+        result = MU_FAILURE;
+    }
+    else if (threadpool->statistics_recorder == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_LINUX_01_141: [ If the statistics are not enabled, threadpool_get_statistics shall fail and return a non-zero value. ]*/
+        LogError("The statistics of threadpool=%p are not enabled", threadpool);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        uint32_t thread_count;
+        uint32_t idle_thread_count;
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_150: [ threadpool_get_statistics shall fill statistics by calling threadpool_statistics_recorder_get. ]*/
+        threadpool_statistics_recorder_get(threadpool->statistics_recorder, statistics);
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_151: [ threadpool_get_statistics shall obtain the number of idle worker threads of the worker pool of the execution engine by calling worker_pool_linux_get_thread_counts. ]*/
+        if (worker_pool_linux_get_thread_counts(threadpool->worker_pool, &thread_count, &idle_thread_count) != 0)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_153: [ If any error occurs, threadpool_get_statistics shall fail and return a non-zero value. ]*/
+            LogError("worker_pool_linux_get_thread_counts failed");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_152: [ threadpool_get_statistics shall set the idle worker count in statistics to the number of idle worker threads and return 0. ]*/
+            statistics->idle_worker_count = idle_thread_count;
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+int threadpool_timer_get_statistics(TIMER_INSTANCE_HANDLE timer, THREADPOOL_TIMER_STATISTICS* statistics)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_LINUX_01_159: [ If timer is NULL, threadpool_timer_get_statistics shall fail and return a non-zero value. ]*/
+        (timer == NULL) ||
+        /* Codes_SRS_THREADPOOL_LINUX_01_160: [ If statistics is NULL, threadpool_timer_get_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments: TIMER_INSTANCE_HANDLE timer=%p, THREADPOOL_TIMER_STATISTICS* statistics=%p", timer, statistics);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        if (timer->is_lateness_recorded)
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_161: [ If the lateness of timer is recorded, threadpool_timer_get_statistics shall fill statistics by calling threadpool_timer_lateness_get. ]*/
+            threadpool_timer_lateness_get(&timer->lateness, statistics);
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_LINUX_01_162: [ Otherwise threadpool_timer_get_statistics shall fill statistics with an empty histogram. ]*/
+            (void)memset(statistics, 0, sizeof(THREADPOOL_TIMER_STATISTICS));
+        }
+
+        /* Codes_SRS_THREADPOOL_LINUX_01_163: [ threadpool_timer_get_statistics shall succeed and return 0. ]*/
+        result = 0;
+    }
+
+    return result;
+}
@@ -0,0 +1,629 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#include <sys/timerfd.h>
+
+#include "macro_utils/macro_utils.h"
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sync.h"
+#include "c_pal/threadapi.h"
+#include "c_pal/worker_pool_linux.h"
+
+#include "c_pal/timer_wheel_linux.h"
+
+/*each level of the wheel has 64 slots, so that the non-empty slots of a level fit in one uint64_t*/
+#define TIMER_WHEEL_LINUX_LEVEL_BITS 6
+#define TIMER_WHEEL_LINUX_SLOTS_PER_LEVEL (1 << TIMER_WHEEL_LINUX_LEVEL_BITS)
+#define TIMER_WHEEL_LINUX_SLOT_MASK (TIMER_WHEEL_LINUX_SLOTS_PER_LEVEL - 1)
+/*6 levels of 64 slots of 1 ms cover 2^36 ms, more than the largest uint32_t delay*/
+#define TIMER_WHEEL_LINUX_LEVEL_COUNT 6
+
+#define TIMER_WHEEL_LINUX_NS_PER_MS 1000000ULL
+#define TIMER_WHEEL_LINUX_NS_PER_S 1000000000ULL
+
+#define TIMER_WHEEL_LINUX_NOT_ARMED UINT64_MAX
+
+#define TIMER_CALLBACK_STATE_VALUES \
+    TIMER_CALLBACK_STATE_IDLE, \
+    TIMER_CALLBACK_STATE_QUEUED, \
+    TIMER_CALLBACK_STATE_CANCELLED, \
+    TIMER_CALLBACK_STATE_RUNNING
+
+MU_DEFINE_ENUM(TIMER_CALLBACK_STATE, TIMER_CALLBACK_STATE_VALUES)
+
+typedef struct TIMER_WHEEL_LINUX_TAG
+{
+    WORKER_POOL_LINUX_HANDLE worker_pool;
+    int timer_fd;
+    /*protects everything below, held for O(1) work by start and cancel*/
+    pthread_mutex_t lock;
+    uint64_t start_time_ns; /*time of tick 0 on CLOCK_MONOTONIC*/
+    uint64_t current_tick; /*the next tick to process, all the ticks before it were processed*/
+    uint64_t armed_tick; /*tick the timer fd expires at, TIMER_WHEEL_LINUX_NOT_ARMED if it is disarmed*/
+    uint64_t occupied_slots[TIMER_WHEEL_LINUX_LEVEL_COUNT]; /*one bit per non-empty slot*/
+    TIMER_WHEEL_LINUX_TIMER* slots[TIMER_WHEEL_LINUX_LEVEL_COUNT * TIMER_WHEEL_LINUX_SLOTS_PER_LEVEL];
+    volatile_atomic int32_t stop_requested;
+    THREAD_HANDLE timer_thread;
+} TIMER_WHEEL_LINUX;
+
+static uint64_t get_time_ns(void)
+{
+    struct timespec now;
+    (void)clock_gettime(CLOCK_MONOTONIC, &now);
+    return ((uint64_t)now.tv_sec * TIMER_WHEEL_LINUX_NS_PER_S) + (uint64_t)now.tv_nsec;
+}
+
+static uint64_t rotate_right(uint64_t value, uint32_t count)
+{
+    return (count == 0) ? value : ((value >> count) | (value << (64 - count)));
+}
+
+/*returns the tick in [due_tick, due_tick + tolerance_ms] that is a multiple of the largest power of 2, so that timers with overlapping windows expire on the same tick*/
+static uint64_t get_coalesced_tick(uint64_t due_tick, uint32_t tolerance_ms)
+{
+    uint64_t result;
+
+    if (tolerance_ms == 0)
+    {
+        result = due_tick;
+    }
+    else
+    {
+        uint64_t last_tick = due_tick + tolerance_ms;
+        /*the highest bit that differs between the first and the last tick of the window, clearing the bits below it in last_tick gives a tick in the window*/
+        uint64_t low_bits_mask = (1ULL << (63 - __builtin_clzll(due_tick ^ last_tick))) - 1;
+        result = ((due_tick & ((low_bits_mask << 1) | 1)) == 0) ? due_tick : (last_tick & ~low_bits_mask);
+    }
+
+    return result;
+}
+
+/*shall be called with the lock held*/
+static void insert_timer(TIMER_WHEEL_LINUX* timer_wheel, TIMER_WHEEL_LINUX_TIMER* timer)
+{
+    uint32_t level = 0;
+    uint32_t slot_in_level;
+
+    if (timer->expire_tick < timer_wheel->current_tick)
+    {
+        /*already due, goes in the slot processed next*/
+        slot_in_level = (uint32_t)(timer_wheel->current_tick & TIMER_WHEEL_LINUX_SLOT_MASK);
+    }
+    else
+    {
+        /*level N holds the timers due in less than 64^(N+1) ticks, its slots are 64^N ticks wide*/
+        uint64_t delta = timer->expire_tick - timer_wheel->current_tick;
+        while ((level < TIMER_WHEEL_LINUX_LEVEL_COUNT - 1) && ((delta >> (TIMER_WHEEL_LINUX_LEVEL_BITS * (level + 1))) != 0))
+        {
+            level++;
+        }
+        slot_in_level = (uint32_t)((timer->expire_tick >> (TIMER_WHEEL_LINUX_LEVEL_BITS * level)) & TIMER_WHEEL_LINUX_SLOT_MASK);
+    }
+
+    uint32_t slot = (level * TIMER_WHEEL_LINUX_SLOTS_PER_LEVEL) + slot_in_level;
+    timer->slot = (uint16_t)slot;
+    timer->next = timer_wheel->slots[slot];
+    if (timer->next != NULL)
+    {
+        timer->next->pprev = &timer->next;
+    }
+    timer_wheel->slots[slot] = timer;
+    timer->pprev = &timer_wheel->slots[slot];
+    timer_wheel->occupied_slots[level] |= (1ULL << slot_in_level);
+}
+
+/*shall be called with the lock held*/
+static void remove_timer(TIMER_WHEEL_LINUX* timer_wheel, TIMER_WHEEL_LINUX_TIMER* timer)
+{
+    *timer->pprev = timer->next;
+    if (timer->next != NULL)
+    {
+        timer->next->pprev = timer->pprev;
+    }
+    timer->pprev = NULL;
+
+    if (timer_wheel->slots[timer->slot] == NULL)
+    {
+        timer_wheel->occupied_slots[timer->slot / TIMER_WHEEL_LINUX_SLOTS_PER_LEVEL] &= ~(1ULL << (timer->slot & TIMER_WHEEL_LINUX_SLOT_MASK));
+    }
+}
+
+/*shall be called with the lock held*/
+static TIMER_WHEEL_LINUX_TIMER* detach_slot(TIMER_WHEEL_LINUX* timer_wheel, uint32_t level, uint32_t slot_in_level)
+{
+    uint32_t slot = (level * TIMER_WHEEL_LINUX_SLOTS_PER_LEVEL) + slot_in_level;
+    TIMER_WHEEL_LINUX_TIMER* result = timer_wheel->slots[slot];
+    timer_wheel->slots[slot] = NULL;
+    timer_wheel->occupied_slots[level] &= ~(1ULL << slot_in_level);
+    return result;
+}
+
+/*shall be called with the lock held, returns the first tick at or after current_tick with a slot to cascade or to expire*/
+static uint64_t get_next_event_tick(TIMER_WHEEL_LINUX* timer_wheel)
+{
+    uint64_t result = TIMER_WHEEL_LINUX_NOT_ARMED;
+
+    for (uint32_t level = 0; level < TIMER_WHEEL_LINUX_LEVEL_COUNT; level++)
+    {
+        if (timer_wheel->occupied_slots[level] != 0)
+        {
+            /*a slot of level N is looked at when the tick crosses a multiple of 64^N, find the first non-empty one from the next crossing on*/
+            uint32_t shift = TIMER_WHEEL_LINUX_LEVEL_BITS * level;
+            uint64_t unit = (timer_wheel->current_tick + ((1ULL << shift) - 1)) >> shift;
+            uint64_t rotated = rotate_right(timer_wheel->occupied_slots[level], (uint32_t)(unit & TIMER_WHEEL_LINUX_SLOT_MASK));
+            uint64_t event_tick = (unit + (uint64_t)__builtin_ctzll(rotated)) << shift;
+            if (event_tick < result)
+            {
+                result = event_tick;
+            }
+        }
+    }
+
+    return result;
+}
+
+/*shall be called with the lock held*/
+static int arm_timer_fd(TIMER_WHEEL_LINUX* timer_wheel, uint64_t tick)
+{
+    int result;
+    struct itimerspec timer_spec;
+    (void)memset(&timer_spec, 0, sizeof(timer_spec));
+
+    if (tick != TIMER_WHEEL_LINUX_NOT_ARMED)
+    {
+        uint64_t expire_time_ns = timer_wheel->start_time_ns + (tick * TIMER_WHEEL_LINUX_NS_PER_MS);
+        timer_spec.it_value.tv_sec = (time_t)(expire_time_ns / TIMER_WHEEL_LINUX_NS_PER_S);
+        timer_spec.it_value.tv_nsec = (long)(expire_time_ns % TIMER_WHEEL_LINUX_NS_PER_S);
+    }
+
+    if (timerfd_settime(timer_wheel->timer_fd, TFD_TIMER_ABSTIME, &timer_spec, NULL) != 0)
+    {
+        LogError("timerfd_settime(%d, TFD_TIMER_ABSTIME, tick=%" PRIu64 ") failed, errno=%d", timer_wheel->timer_fd, tick, errno);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        timer_wheel->armed_tick = tick;
+        result = 0;
+    }
+
+    return result;
+}
+
+/*shall be called with the lock held, current_tick is the tick being processed*/
+static void process_tick(TIMER_WHEEL_LINUX* timer_wheel, WORKER_POOL_LINUX_WORK_ITEM** expired_work_items)
+{
+    uint64_t tick = timer_wheel->current_tick;
+
+    if ((tick & TIMER_WHEEL_LINUX_SLOT_MASK) == 0)
+    {
+        /*the tick crossed a multiple of 64, move the timers of the next slot of the upper levels down, they are now due soon enough*/
+        for (uint32_t level = 1; level < TIMER_WHEEL_LINUX_LEVEL_COUNT; level++)
+        {
+            uint32_t slot_in_level = (uint32_t)((tick >> (TIMER_WHEEL_LINUX_LEVEL_BITS * level)) & TIMER_WHEEL_LINUX_SLOT_MASK);
+            TIMER_WHEEL_LINUX_TIMER* timer = detach_slot(timer_wheel, level, slot_in_level);
+            while (timer != NULL)
+            {
+                TIMER_WHEEL_LINUX_TIMER* next = timer->next;
+                insert_timer(timer_wheel, timer);
+                timer = next;
+            }
+
+            if (slot_in_level != 0)
+            {
+                break;
+            }
+        }
+    }
+
+    TIMER_WHEEL_LINUX_TIMER* timer = detach_slot(timer_wheel, 0, (uint32_t)(tick & TIMER_WHEEL_LINUX_SLOT_MASK));
+    while (timer != NULL)
+    {
+        TIMER_WHEEL_LINUX_TIMER* next = timer->next;
+        timer->pprev = NULL;
+
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_032: [ If the period of the timer is not 0, the timer thread shall put the timer back in the wheel to expire period_ms after its previous expiration. ]*/
+        if (timer->period_ms != 0)
+        {
+            /*the period is counted from the tick the timer was due at, so that the tolerance does not make the timer drift*/
+            timer->due_tick += timer->period_ms;
+            if (timer->due_tick <= tick)
+            {
+                /*the wheel is late by more than a period, do not fire the missed expirations*/
+                timer->due_tick = tick + 1;
+            }
+            /* Codes_SRS_TIMER_WHEEL_LINUX_01_043: [ The timer thread shall delay the next expiration of a periodic timer by up to the tolerance of the timer, to the tick in the tolerance window that is a multiple of the largest power of 2. ]*/
+            timer->expire_tick = get_coalesced_tick(timer->due_tick, timer->tolerance_ms);
+            insert_timer(timer_wheel, timer);
+        }
+
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_033: [ If the previous callback of a periodic timer did not run yet or is still running, the timer thread shall skip the expiration. ]*/
+        if (interlocked_compare_exchange(&timer->callback_state, TIMER_CALLBACK_STATE_QUEUED, TIMER_CALLBACK_STATE_IDLE) == TIMER_CALLBACK_STATE_IDLE)
+        {
+            timer->work_item.next = *expired_work_items;
+            *expired_work_items = &timer->work_item;
+        }
+        else if (timer->period_ms == 0)
+        {
+            /* Codes_SRS_TIMER_WHEEL_LINUX_01_044: [ If the previous callback of a timer that expires only once did not run yet or is still running, the timer thread shall put the timer back in the wheel to expire on the next tick. ]*/
+            /*this is a timer restarted while its previous callback was queued or running (for example from the callback itself), its only expiration is not lost*/
+            timer->due_tick = tick + 1;
+            timer->expire_tick = tick + 1;
+            insert_timer(timer_wheel, timer);
+        }
+
+        timer = next;
+    }
+}
+
+static void expire_timers(TIMER_WHEEL_LINUX* timer_wheel)
+{
+    WORKER_POOL_LINUX_WORK_ITEM* expired_work_items = NULL;
+
+    (void)pthread_mutex_lock(&timer_wheel->lock);
+
+    /* Codes_SRS_TIMER_WHEEL_LINUX_01_030: [ The timer thread shall advance the wheel up to the current time obtained by calling clock_gettime with CLOCK_MONOTONIC. ]*/
+    uint64_t now_tick = (get_time_ns() - timer_wheel->start_time_ns) / TIMER_WHEEL_LINUX_NS_PER_MS;
+    while (timer_wheel->current_tick <= now_tick)
+    {
+        /*skip the ticks where there is nothing to do*/
+        uint64_t next_event_tick = get_next_event_tick(timer_wheel);
+        if (next_event_tick > now_tick)
+        {
+            timer_wheel->current_tick = now_tick + 1;
+        }
+        else
+        {
+            /* Codes_SRS_TIMER_WHEEL_LINUX_01_031: [ For each timer that expired, the timer thread shall submit the work item of the timer to the worker pool by calling worker_pool_linux_submit. ]*/
+            timer_wheel->current_tick = next_event_tick;
+            process_tick(timer_wheel, &expired_work_items);
+            timer_wheel->current_tick = next_event_tick + 1;
+        }
+    }
+
+    /* Codes_SRS_TIMER_WHEEL_LINUX_01_035: [ The timer thread shall arm the timer fd for the next tick where timers have to be expired or moved to a lower level of the wheel by calling timerfd_settime, or disarm it if there are no timers. ]*/
+    (void)arm_timer_fd(timer_wheel, get_next_event_tick(timer_wheel));
+
+    (void)pthread_mutex_unlock(&timer_wheel->lock);
+
+    /*submit outside of the lock, so that starting and cancelling timers is not blocked by the worker pool*/
+    while (expired_work_items != NULL)
+    {
+        WORKER_POOL_LINUX_WORK_ITEM* work_item = expired_work_items;
+        expired_work_items = work_item->next;
+
+        if (worker_pool_linux_submit(timer_wheel->worker_pool, work_item) != 0)
+        {
+            /* Codes_SRS_TIMER_WHEEL_LINUX_01_034: [ If worker_pool_linux_submit fails, the timer thread shall drop the expiration. ]*/
+            TIMER_WHEEL_LINUX_TIMER* timer = work_item->work_function_context;
+            LogError("worker_pool_linux_submit failed, dropping the expiration of timer %p", timer);
+            (void)interlocked_exchange(&timer->callback_state, TIMER_CALLBACK_STATE_IDLE);
+            wake_by_address_all(&timer->callback_state);
+        }
+    }
+}
+
+static int timer_wheel_linux_thread(void* arg)
+{
+    TIMER_WHEEL_LINUX* timer_wheel = arg;
+
+    /* Codes_SRS_TIMER_WHEEL_LINUX_01_036: [ When a stop was requested, the timer thread shall exit. ]*/
+    while (interlocked_add(&timer_wheel->stop_requested, 0) == 0)
+    {
+        uint64_t expiration_count;
+
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_029: [ The timer thread shall wait for the timer fd to expire by calling read. ]*/
+        if (read(timer_wheel->timer_fd, &expiration_count, sizeof(expiration_count)) < 0)
+        {
+            if (errno != EINTR)
+            {
+                LogError("read(%d) of the timer fd failed, errno=%d", timer_wheel->timer_fd, errno);
+            }
+        }
+
+        expire_timers(timer_wheel);
+    }
+
+    return 0;
+}
+
+static void on_timer_work(void* context)
+{
+    if (context == NULL)
+    {
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_037: [ If context is NULL, on_timer_work shall return. ]*/
+        LogError("Invalid arguments: void* context=%p", context);
+    }
+    else
+    {
+        TIMER_WHEEL_LINUX_TIMER* timer = context;
+
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_038: [ If the timer was not cancelled since it expired, on_timer_work shall call on_timer_expired with on_timer_expired_context. ]*/
+        if (interlocked_compare_exchange(&timer->callback_state, TIMER_CALLBACK_STATE_RUNNING, TIMER_CALLBACK_STATE_QUEUED) == TIMER_CALLBACK_STATE_QUEUED)
+        {
+            timer->on_timer_expired(timer->on_timer_expired_context);
+        }
+
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_039: [ on_timer_work shall mark the callback of the timer as done and wake the threads waiting for it by calling wake_by_address_all. ]*/
+        /*the wake only passes the address to the futex syscall, so it does no harm if the timer got freed after the cancel saw the callback done*/
+        (void)interlocked_exchange(&timer->callback_state, TIMER_CALLBACK_STATE_IDLE);
+        wake_by_address_all(&timer->callback_state);
+    }
+}
+
+static void internal_cancel(TIMER_WHEEL_LINUX* timer_wheel, TIMER_WHEEL_LINUX_TIMER* timer)
+{
+    (void)pthread_mutex_lock(&timer_wheel->lock);
+    if (timer->pprev != NULL)
+    {
+        remove_timer(timer_wheel, timer);
+    }
+    (void)pthread_mutex_unlock(&timer_wheel->lock);
+
+    /*a callback that is queued but did not start does not run*/
+    (void)interlocked_compare_exchange(&timer->callback_state, TIMER_CALLBACK_STATE_CANCELLED, TIMER_CALLBACK_STATE_QUEUED);
+
+    do
+    {
+        int32_t callback_state = interlocked_add(&timer->callback_state, 0);
+        if (callback_state == TIMER_CALLBACK_STATE_IDLE)
+        {
+            break;
+        }
+
+        (void)wait_on_address(&timer->callback_state, callback_state, UINT32_MAX);
+    } while (1);
+}
+
+TIMER_WHEEL_LINUX_HANDLE timer_wheel_linux_create(WORKER_POOL_LINUX_HANDLE worker_pool)
+{
+    TIMER_WHEEL_LINUX_HANDLE result;
+
+    if (worker_pool == NULL)
+    {
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_001: [ If worker_pool is NULL, timer_wheel_linux_create shall fail and return NULL. ]*/
+        LogError("Invalid arguments: WORKER_POOL_LINUX_HANDLE worker_pool=%p", worker_pool);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_002: [ timer_wheel_linux_create shall allocate a new timer wheel and on success return a non-NULL handle. ]*/
+        result = malloc(sizeof(TIMER_WHEEL_LINUX));
+        if (result == NULL)
+        {
+            /* Codes_SRS_TIMER_WHEEL_LINUX_01_007: [ If any error occurs, timer_wheel_linux_create shall fail and return NULL. ]*/
+            LogError("malloc(%zu) failed", sizeof(TIMER_WHEEL_LINUX));
+        }
+        else
+        {
+            /* Codes_SRS_TIMER_WHEEL_LINUX_01_003: [ timer_wheel_linux_create shall create the timer fd of the wheel by calling timerfd_create with CLOCK_MONOTONIC. ]*/
+            result->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+            if (result->timer_fd < 0)
+            {
+                /* Codes_SRS_TIMER_WHEEL_LINUX_01_007: [ If any error occurs, timer_wheel_linux_create shall fail and return NULL. ]*/
+                LogError("timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC) failed, errno=%d", errno);
+            }
+            else
+            {
+                /* Codes_SRS_TIMER_WHEEL_LINUX_01_004: [ timer_wheel_linux_create shall initialize the lock protecting the wheel by calling pthread_mutex_init. ]*/
+                int mutex_init_result = pthread_mutex_init(&result->lock, NULL);
+                if (mutex_init_result != 0)
+                {
+                    /* Codes_SRS_TIMER_WHEEL_LINUX_01_007: [ If any error occurs, timer_wheel_linux_create shall fail and return NULL. ]*/
+                    LogError("pthread_mutex_init failed with %d", mutex_init_result);
+                }
+                else
+                {
+                    result->worker_pool = worker_pool;
+
+                    /* Codes_SRS_TIMER_WHEEL_LINUX_01_005: [ timer_wheel_linux_create shall take the current time obtained by calling clock_gettime with CLOCK_MONOTONIC as tick 0 of the wheel. ]*/
+                    result->start_time_ns = get_time_ns();
+                    result->current_tick = 0;
+                    result->armed_tick = TIMER_WHEEL_LINUX_NOT_ARMED;
+                    (void)memset(result->occupied_slots, 0, sizeof(result->occupied_slots));
+                    (void)memset(result->slots, 0, sizeof(result->slots));
+                    (void)interlocked_exchange(&result->stop_requested, 0);
+
+                    /* Codes_SRS_TIMER_WHEEL_LINUX_01_006: [ timer_wheel_linux_create shall start the timer thread by calling ThreadAPI_Create. ]*/
+                    if (ThreadAPI_Create(&result->timer_thread, timer_wheel_linux_thread, result) != THREADAPI_OK)
+                    {
+                        /* Codes_SRS_TIMER_WHEEL_LINUX_01_007: [ If any error occurs, timer_wheel_linux_create shall fail and return NULL. ]*/
+                        LogError("ThreadAPI_Create failed");
+                    }
+                    else
+                    {
+                        goto all_ok;
+                    }
+
+                    (void)pthread_mutex_destroy(&result->lock);
+                }
+
+                (void)close(result->timer_fd);
+            }
+
+            free(result);
+            result = NULL;
+        }
+    }
+
+all_ok:
+    return result;
+}
+
+void timer_wheel_linux_destroy(TIMER_WHEEL_LINUX_HANDLE timer_wheel)
+{
+    if (timer_wheel == NULL)
+    {
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_008: [ If timer_wheel is NULL, timer_wheel_linux_destroy shall return. ]*/
+        LogError("Invalid arguments: TIMER_WHEEL_LINUX_HANDLE timer_wheel=%p", timer_wheel);
+    }
+    else
+    {
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_009: [ timer_wheel_linux_destroy shall request the timer thread to stop and wake it by arming the timer fd to expire right away. ]*/
+        (void)interlocked_exchange(&timer_wheel->stop_requested, 1);
+
+        struct itimerspec timer_spec;
+        (void)memset(&timer_spec, 0, sizeof(timer_spec));
+        /*an absolute time in the past expires right away, 0 would disarm*/
+        timer_spec.it_value.tv_nsec = 1;
+        if (timerfd_settime(timer_wheel->timer_fd, TFD_TIMER_ABSTIME, &timer_spec, NULL) != 0)
+        {
+            LogError("timerfd_settime(%d) failed, errno=%d", timer_wheel->timer_fd, errno);
+        }
+
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_010: [ timer_wheel_linux_destroy shall join the timer thread by calling ThreadAPI_Join. ]*/
+        int dont_care;
+        if (ThreadAPI_Join(timer_wheel->timer_thread, &dont_care) != THREADAPI_OK)
+        {
+            LogError("ThreadAPI_Join failed");
+        }
+
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_011: [ timer_wheel_linux_destroy shall destroy the lock, close the timer fd and free the timer wheel. ]*/
+        (void)pthread_mutex_destroy(&timer_wheel->lock);
+        (void)close(timer_wheel->timer_fd);
+        free(timer_wheel);
+    }
+}
+
+int timer_wheel_linux_timer_init(TIMER_WHEEL_LINUX_TIMER* timer, WORKER_POOL_LINUX_PRIORITY priority, TIMER_WHEEL_LINUX_ON_TIMER_EXPIRED on_timer_expired, void* on_timer_expired_context)
+{
+    int result;
+
+    /* Codes_SRS_TIMER_WHEEL_LINUX_01_014: [ on_timer_expired_context shall be allowed to be NULL. ]*/
+
+    if (
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_012: [ If timer is NULL, timer_wheel_linux_timer_init shall fail and return a non-zero value. ]*/
+        (timer == NULL) ||
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_013: [ If on_timer_expired is NULL, timer_wheel_linux_timer_init shall fail and return a non-zero value. ]*/
+        (on_timer_expired == NULL) ||
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_040: [ If priority is not WORKER_POOL_LINUX_PRIORITY_HIGH, WORKER_POOL_LINUX_PRIORITY_NORMAL or WORKER_POOL_LINUX_PRIORITY_LOW, timer_wheel_linux_timer_init shall fail and return a non-zero value. ]*/
+        (
+            (priority != WORKER_POOL_LINUX_PRIORITY_HIGH) &&
+            (priority != WORKER_POOL_LINUX_PRIORITY_NORMAL) &&
+            (priority != WORKER_POOL_LINUX_PRIORITY_LOW)
+        )
+        )
+    {
+        LogError("Invalid arguments: TIMER_WHEEL_LINUX_TIMER* timer=%p, WORKER_POOL_LINUX_PRIORITY priority=%" PRI_MU_ENUM ", TIMER_WHEEL_LINUX_ON_TIMER_EXPIRED on_timer_expired=%p, void* on_timer_expired_context=%p",
+            timer, MU_ENUM_VALUE(WORKER_POOL_LINUX_PRIORITY, priority), on_timer_expired, on_timer_expired_context);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_015: [ timer_wheel_linux_timer_init shall initialize timer as not started, with no callback running, and save on_timer_expired and on_timer_expired_context in it. ]*/
+        timer->next = NULL;
+        timer->pprev = NULL;
+        timer->expire_tick = 0;
+        timer->due_tick = 0;
+        timer->period_ms = 0;
+        timer->tolerance_ms = 0;
+        timer->slot = 0;
+        (void)interlocked_exchange(&timer->callback_state, TIMER_CALLBACK_STATE_IDLE);
+        timer->work_item.work_function = on_timer_work;
+        timer->work_item.work_function_context = timer;
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_041: [ timer_wheel_linux_timer_init shall set the priority of the work item of timer to priority, so that the callbacks of the timer are submitted to the worker pool with priority. ]*/
+        timer->work_item.priority = priority;
+        timer->work_item.next = NULL;
+        timer->on_timer_expired = on_timer_expired;
+        timer->on_timer_expired_context = on_timer_expired_context;
+
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_016: [ timer_wheel_linux_timer_init shall succeed and return 0. ]*/
+        result = 0;
+    }
+
+    return result;
+}
+
+int timer_wheel_linux_timer_start(TIMER_WHEEL_LINUX_HANDLE timer_wheel, TIMER_WHEEL_LINUX_TIMER* timer, uint32_t start_delay_ms, uint32_t period_ms, uint32_t tolerance_ms)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_017: [ If timer_wheel is NULL, timer_wheel_linux_timer_start shall fail and return a non-zero value. ]*/
+        (timer_wheel == NULL) ||
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_018: [ If timer is NULL, timer_wheel_linux_timer_start shall fail and return a non-zero value. ]*/
+        (timer == NULL)
+        )
+    {
+        LogError("Invalid arguments: TIMER_WHEEL_LINUX_HANDLE timer_wheel=%p, TIMER_WHEEL_LINUX_TIMER* timer=%p, uint32_t start_delay_ms=%" PRIu32 ", uint32_t period_ms=%" PRIu32 ", uint32_t tolerance_ms=%" PRIu32 "",
+            timer_wheel, timer, start_delay_ms, period_ms, tolerance_ms);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        (void)pthread_mutex_lock(&timer_wheel->lock);
+
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_019: [ timer_wheel_linux_timer_start shall remove the timer from the wheel if it is started, without waiting for a running callback of the timer to complete. ]*/
+        /*not waiting is what allows a timer to be started again from its own callback*/
+        if (timer->pprev != NULL)
+        {
+            remove_timer(timer_wheel, timer);
+        }
+
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_045: [ timer_wheel_linux_timer_start shall prevent a callback of the timer that did not start yet from running. ]*/
+        (void)interlocked_compare_exchange(&timer->callback_state, TIMER_CALLBACK_STATE_CANCELLED, TIMER_CALLBACK_STATE_QUEUED);
+
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_020: [ timer_wheel_linux_timer_start shall insert the timer in the slot of the wheel for the tick start_delay_ms after the current time obtained by calling clock_gettime with CLOCK_MONOTONIC. ]*/
+        /*the current tick is rounded up, so that the timer does not expire before start_delay_ms passed*/
+        uint64_t now_ns = get_time_ns() - timer_wheel->start_time_ns;
+        timer->due_tick = ((now_ns + TIMER_WHEEL_LINUX_NS_PER_MS - 1) / TIMER_WHEEL_LINUX_NS_PER_MS) + start_delay_ms;
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_042: [ timer_wheel_linux_timer_start shall delay the expiration of the timer by up to tolerance_ms, to the tick in the tolerance window that is a multiple of the largest power of 2, so that timers with overlapping tolerance windows expire on the same tick. ]*/
+        timer->expire_tick = get_coalesced_tick(timer->due_tick, tolerance_ms);
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_021: [ timer_wheel_linux_timer_start shall save period_ms in the timer, 0 meaning that the timer expires only once. ]*/
+        timer->period_ms = period_ms;
+        timer->tolerance_ms = tolerance_ms;
+        insert_timer(timer_wheel, timer);
+
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_022: [ If the timer expires before the tick the timer fd is armed for, timer_wheel_linux_timer_start shall arm the timer fd for the expiration of the timer by calling timerfd_settime. ]*/
+        if (
+            (timer->expire_tick < timer_wheel->armed_tick) &&
+            (arm_timer_fd(timer_wheel, timer->expire_tick) != 0)
+            )
+        {
+            /* Codes_SRS_TIMER_WHEEL_LINUX_01_024: [ If any error occurs, timer_wheel_linux_timer_start shall fail and return a non-zero value. ]*/
+            remove_timer(timer_wheel, timer);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_TIMER_WHEEL_LINUX_01_023: [ timer_wheel_linux_timer_start shall succeed and return 0. ]*/
+            result = 0;
+        }
+
+        (void)pthread_mutex_unlock(&timer_wheel->lock);
+    }
+
+    return result;
+}
+
+void timer_wheel_linux_timer_cancel(TIMER_WHEEL_LINUX_HANDLE timer_wheel, TIMER_WHEEL_LINUX_TIMER* timer)
+{
+    if (
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_025: [ If timer_wheel is NULL, timer_wheel_linux_timer_cancel shall return. ]*/
+        (timer_wheel == NULL) ||
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_026: [ If timer is NULL, timer_wheel_linux_timer_cancel shall return. ]*/
+        (timer == NULL)
+        )
+    {
+        LogError("Invalid arguments: TIMER_WHEEL_LINUX_HANDLE timer_wheel=%p, TIMER_WHEEL_LINUX_TIMER* timer=%p", timer_wheel, timer);
+    }
+    else
+    {
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_027: [ timer_wheel_linux_timer_cancel shall remove the timer from the wheel if it is started. ]*/
+        /* Codes_SRS_TIMER_WHEEL_LINUX_01_028: [ timer_wheel_linux_timer_cancel shall prevent a callback of the timer that did not start yet from running and wait for a running callback to complete. ]*/
+        internal_cancel(timer_wheel, timer);
+    }
+}
@@ -0,0 +1,1134 @@
+// Copyright (C) Microsoft Corporation. All rights reserved.
+
+#define _GNU_SOURCE
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "macro_utils/macro_utils.h"
+#include "c_logging/xlogging.h"
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sync.h"
+#include "c_pal/sysinfo.h"
+
+#include "c_pal/worker_pool_linux.h"
+
+/*size of the deque of each worker thread, has to be a power of 2*/
+#define WORKER_POOL_LINUX_DEQUE_SIZE 256
+/*how many work items in a row a worker thread runs from its LIFO slot before looking at the other queues*/
+#define WORKER_POOL_LINUX_MAX_LIFO_RUNS 3
+/*every that many work items a worker thread looks at the global queue first, so that the global queue is not starved by local work*/
+#define WORKER_POOL_LINUX_GLOBAL_QUEUE_INTERVAL 61
+/*every that many work items a worker thread looks at the low priority queue before the normal priority work, so that low priority work items are not starved*/
+#define WORKER_POOL_LINUX_LOW_PRIORITY_QUEUE_INTERVAL 31
+/*how often the controller thread looks for queued work items that make no progress*/
+#define WORKER_POOL_LINUX_CONTROLLER_INTERVAL_MS 500
+
+typedef struct WORKER_POOL_LINUX_WORKER_TAG
+{
+    struct WORKER_POOL_LINUX_TAG* worker_pool;
+    pthread_t thread;
+
+    /*only used by the worker thread itself*/
+    uint32_t run_count;
+    uint32_t lifo_run_count;
+    uint32_t steal_seed;
+
+    /*the thread exited after being idle and was not joined yet, protected by the lock*/
+    bool is_retired;
+
+    /*the work item most recently submitted from the worker thread, it runs next*/
+    void* volatile_atomic lifo_slot;
+
+    /*Chase-Lev deque: the worker thread pushes and pops at bottom, the other worker threads steal at top*/
+    volatile_atomic int64_t bottom;
+    void* volatile_atomic items[WORKER_POOL_LINUX_DEQUE_SIZE];
+    volatile_atomic int64_t top;
+} WORKER_POOL_LINUX_WORKER;
+
+typedef struct WORKER_POOL_LINUX_QUEUE_TAG
+{
+    WORKER_POOL_LINUX_WORK_ITEM* head;
+    WORKER_POOL_LINUX_WORK_ITEM* tail;
+    /*the number of work items in the queue, so that the worker threads do not take the lock when it is empty*/
+    volatile_atomic int32_t count;
+} WORKER_POOL_LINUX_QUEUE;
+
+typedef struct WORKER_POOL_LINUX_TAG
+{
+    uint32_t min_thread_count;
+    uint32_t max_thread_count;
+    /*max_thread_count plus the worker threads the controller can inject, the number of workers*/
+    uint32_t worker_count;
+    uint32_t idle_timeout_ms;
+    size_t stack_size;
+    bool has_cpu_set;
+    cpu_set_t cpu_set;
+
+    /*protects the global queues and the starting of worker threads*/
+    pthread_mutex_t lock;
+    WORKER_POOL_LINUX_QUEUE high_priority_queue;
+    WORKER_POOL_LINUX_QUEUE global_queue; /*normal priority*/
+    WORKER_POOL_LINUX_QUEUE low_priority_queue;
+    volatile_atomic int32_t thread_count;
+
+    volatile_atomic int32_t idle_thread_count;
+    /*bumped on every submit, the idle worker threads park on it*/
+    volatile_atomic int32_t work_signal;
+    volatile_atomic int32_t stop_requested;
+
+    bool has_controller;
+    pthread_t controller_thread;
+    /*the oldest queued work item the controller saw on its previous tick, protected by the lock*/
+    WORKER_POOL_LINUX_WORK_ITEM* controller_oldest_work_item;
+
+    /*statistics, protected by the lock*/
+    uint32_t peak_thread_count;
+    uint64_t started_thread_count;
+    uint64_t injected_thread_count;
+    uint64_t retired_thread_count;
+
+    WORKER_POOL_LINUX_WORKER workers[];
+} WORKER_POOL_LINUX;
+
+/*the worker running on the current thread, NULL for threads that are not worker threads*/
+static __thread WORKER_POOL_LINUX_WORKER* worker_pool_linux_current_worker;
+
+static WORKER_POOL_LINUX_WORK_ITEM* deque_read_item(void* volatile_atomic* item)
+{
+    /*a thief can race with the owner reusing the slot, so the slot is read atomically*/
+    return interlocked_compare_exchange_pointer(item, NULL, NULL);
+}
+
+static bool deque_push(WORKER_POOL_LINUX_WORKER* worker, WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    bool result;
+    int64_t bottom = interlocked_add_64(&worker->bottom, 0);
+    int64_t top = interlocked_add_64(&worker->top, 0);
+
+    if (bottom - top >= WORKER_POOL_LINUX_DEQUE_SIZE)
+    {
+        result = false;
+    }
+    else
+    {
+        (void)interlocked_exchange_pointer(&worker->items[bottom & (WORKER_POOL_LINUX_DEQUE_SIZE - 1)], work_item);
+        (void)interlocked_exchange_64(&worker->bottom, bottom + 1);
+        result = true;
+    }
+
+    return result;
+}
+
+static WORKER_POOL_LINUX_WORK_ITEM* deque_pop(WORKER_POOL_LINUX_WORKER* worker)
+{
+    WORKER_POOL_LINUX_WORK_ITEM* result;
+    int64_t bottom = interlocked_add_64(&worker->bottom, 0);
+    int64_t top = interlocked_add_64(&worker->top, 0);
+
+    if (top >= bottom)
+    {
+        /*empty, only the owner adds items so this cannot change under us*/
+        result = NULL;
+    }
+    else
+    {
+        bottom--;
+        (void)interlocked_exchange_64(&worker->bottom, bottom);
+        top = interlocked_add_64(&worker->top, 0);
+        if (top > bottom)
+        {
+            /*a thief took the last item*/
+            (void)interlocked_exchange_64(&worker->bottom, bottom + 1);
+            result = NULL;
+        }
+        else
+        {
+            result = deque_read_item(&worker->items[bottom & (WORKER_POOL_LINUX_DEQUE_SIZE - 1)]);
+            if (top == bottom)
+            {
+                /*last item, race the thieves for it*/
+                if (interlocked_compare_exchange_64(&worker->top, top + 1, top) != top)
+                {
+                    result = NULL;
+                }
+                (void)interlocked_exchange_64(&worker->bottom, bottom + 1);
+            }
+        }
+    }
+
+    return result;
+}
+
+static WORKER_POOL_LINUX_WORK_ITEM* deque_steal(WORKER_POOL_LINUX_WORKER* victim)
+{
+    WORKER_POOL_LINUX_WORK_ITEM* result;
+    int64_t top = interlocked_add_64(&victim->top, 0);
+    int64_t bottom = interlocked_add_64(&victim->bottom, 0);
+
+    if (top >= bottom)
+    {
+        result = NULL;
+    }
+    else
+    {
+        result = deque_read_item(&victim->items[top & (WORKER_POOL_LINUX_DEQUE_SIZE - 1)]);
+        if (interlocked_compare_exchange_64(&victim->top, top + 1, top) != top)
+        {
+            /*lost the race with the owner or with another thief*/
+            result = NULL;
+        }
+    }
+
+    return result;
+}
+
+static bool is_valid_priority(WORKER_POOL_LINUX_PRIORITY priority)
+{
+    return
+        (priority == WORKER_POOL_LINUX_PRIORITY_HIGH) ||
+        (priority == WORKER_POOL_LINUX_PRIORITY_NORMAL) ||
+        (priority == WORKER_POOL_LINUX_PRIORITY_LOW);
+}
+
+static WORKER_POOL_LINUX_QUEUE* get_global_queue(WORKER_POOL_LINUX* worker_pool, WORKER_POOL_LINUX_PRIORITY priority)
+{
+    WORKER_POOL_LINUX_QUEUE* result;
+
+    if (priority == WORKER_POOL_LINUX_PRIORITY_HIGH)
+    {
+        result = &worker_pool->high_priority_queue;
+    }
+    else if (priority == WORKER_POOL_LINUX_PRIORITY_LOW)
+    {
+        result = &worker_pool->low_priority_queue;
+    }
+    else
+    {
+        result = &worker_pool->global_queue;
+    }
+
+    return result;
+}
+
+static void global_queue_init(WORKER_POOL_LINUX_QUEUE* queue)
+{
+    queue->head = NULL;
+    queue->tail = NULL;
+    (void)interlocked_exchange(&queue->count, 0);
+}
+
+static void global_queue_push(WORKER_POOL_LINUX_QUEUE* queue, WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    /*the lock is held by the caller*/
+    work_item->next = NULL;
+    if (queue->tail == NULL)
+    {
+        queue->head = work_item;
+    }
+    else
+    {
+        queue->tail->next = work_item;
+    }
+    queue->tail = work_item;
+    (void)interlocked_increment(&queue->count);
+}
+
+static WORKER_POOL_LINUX_WORK_ITEM* global_queue_pop(WORKER_POOL_LINUX* worker_pool, WORKER_POOL_LINUX_QUEUE* queue)
+{
+    WORKER_POOL_LINUX_WORK_ITEM* result;
+
+    /*do not take the lock when there is nothing to take*/
+    if (interlocked_add(&queue->count, 0) == 0)
+    {
+        result = NULL;
+    }
+    else
+    {
+        (void)pthread_mutex_lock(&worker_pool->lock);
+        result = queue->head;
+        if (result != NULL)
+        {
+            queue->head = result->next;
+            if (queue->head == NULL)
+            {
+                queue->tail = NULL;
+            }
+            (void)interlocked_decrement(&queue->count);
+        }
+        (void)pthread_mutex_unlock(&worker_pool->lock);
+    }
+
+    return result;
+}
+
+static WORKER_POOL_LINUX_WORK_ITEM* steal_work(WORKER_POOL_LINUX_WORKER* worker)
+{
+    WORKER_POOL_LINUX_WORK_ITEM* result = NULL;
+    WORKER_POOL_LINUX* worker_pool = worker->worker_pool;
+    uint32_t thread_count = (uint32_t)interlocked_add(&worker_pool->thread_count, 0);
+
+    if (thread_count > 1)
+    {
+        /*xorshift, so that the thieves do not all go after the same victim*/
+        worker->steal_seed ^= worker->steal_seed << 13;
+        worker->steal_seed ^= worker->steal_seed >> 17;
+        worker->steal_seed ^= worker->steal_seed << 5;
+
+        uint32_t start = worker->steal_seed % thread_count;
+        for (uint32_t i = 0; i < thread_count; i++)
+        {
+            WORKER_POOL_LINUX_WORKER* victim = &worker_pool->workers[(start + i) % thread_count];
+            if (victim != worker)
+            {
+                result = deque_steal(victim);
+                if (result == NULL)
+                {
+                    /*the LIFO slot is stolen too, otherwise a work item submitted by a worker thread that then blocks would never run*/
+                    result = interlocked_exchange_pointer(&victim->lifo_slot, NULL);
+                }
+
+                if (result != NULL)
+                {
+                    break;
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+static WORKER_POOL_LINUX_WORK_ITEM* find_work(WORKER_POOL_LINUX_WORKER* worker)
+{
+    WORKER_POOL_LINUX_WORK_ITEM* result = NULL;
+    WORKER_POOL_LINUX* worker_pool = worker->worker_pool;
+
+    worker->run_count++;
+
+    /*Codes_SRS_WORKER_POOL_LINUX_01_052: [ The worker thread shall take the oldest work item in the high priority queue before any other work item. ]*/
+    result = global_queue_pop(worker_pool, &worker_pool->high_priority_queue);
+
+    if (
+        (result == NULL) &&
+        ((worker->run_count % WORKER_POOL_LINUX_GLOBAL_QUEUE_INTERVAL) == 0)
+        )
+    {
+        /*Codes_SRS_WORKER_POOL_LINUX_01_036: [ Every 61 work items, the worker thread shall look at the global queue first. ]*/
+        result = global_queue_pop(worker_pool, &worker_pool->global_queue);
+    }
+
+    if (
+        (result == NULL) &&
+        ((worker->run_count % WORKER_POOL_LINUX_LOW_PRIORITY_QUEUE_INTERVAL) == 0)
+        )
+    {
+        /*Codes_SRS_WORKER_POOL_LINUX_01_053: [ Every 31 work items, the worker thread shall look at the low priority queue before the normal priority work items. ]*/
+        result = global_queue_pop(worker_pool, &worker_pool->low_priority_queue);
+    }
+
+    if (
+        (result == NULL) &&
+        (worker->lifo_run_count < WORKER_POOL_LINUX_MAX_LIFO_RUNS)
+        )
+    {
+        /*Codes_SRS_WORKER_POOL_LINUX_01_024: [ The worker thread shall take the work item in its LIFO slot, unless it already ran 3 work items in a row from its LIFO slot. ]*/
+        result = interlocked_exchange_pointer(&worker->lifo_slot, NULL);
+        if (result != NULL)
+        {
+            worker->lifo_run_count++;
+        }
+    }
+
+    if (result == NULL)
+    {
+        worker->lifo_run_count = 0;
+
+        /*Codes_SRS_WORKER_POOL_LINUX_01_037: [ Otherwise the worker thread shall take the work item most recently pushed to its own deque. ]*/
+        result = deque_pop(worker);
+        if (result == NULL)
+        {
+            /*Codes_SRS_WORKER_POOL_LINUX_01_038: [ Otherwise the worker thread shall take the oldest work item in the global queue. ]*/
+            result = global_queue_pop(worker_pool, &worker_pool->global_queue);
+            if (result == NULL)
+            {
+                /*Codes_SRS_WORKER_POOL_LINUX_01_039: [ Otherwise the worker thread shall steal the oldest work item from the deque of another worker thread, or the work item in its LIFO slot, starting with a random worker thread. ]*/
+                result = steal_work(worker);
+                if (result == NULL)
+                {
+                    /*the LIFO slot could have been skipped above*/
+                    result = interlocked_exchange_pointer(&worker->lifo_slot, NULL);
+                    if (result == NULL)
+                    {
+                        /*Codes_SRS_WORKER_POOL_LINUX_01_054: [ Otherwise the worker thread shall take the oldest work item in the low priority queue. ]*/
+                        result = global_queue_pop(worker_pool, &worker_pool->low_priority_queue);
+                    }
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+static bool retire_worker_thread_if_idle(WORKER_POOL_LINUX_WORKER* worker, int32_t work_signal)
+{
+    bool result;
+    WORKER_POOL_LINUX* worker_pool = worker->worker_pool;
+    int32_t thread_count;
+
+    (void)pthread_mutex_lock(&worker_pool->lock);
+
+    thread_count = interlocked_add(&worker_pool->thread_count, 0);
+
+    if (
+        /*Codes_SRS_WORKER_POOL_LINUX_01_062: [ When the park times out, the worker thread shall exit if more than min_thread_count worker threads are started, it is the most recently started worker thread, no stop was requested, the work signal did not change and the high priority, global and low priority queues are empty. ]*/
+        ((uint32_t)thread_count > worker_pool->min_thread_count) &&
+        /*only the last worker exits, so that the started workers stay at the start of the array that the thieves walk*/
+        (worker == &worker_pool->workers[thread_count - 1]) &&
+        (interlocked_add(&worker_pool->stop_requested, 0) == 0) &&
+        (interlocked_add(&worker_pool->work_signal, 0) == work_signal) &&
+        (interlocked_add(&worker_pool->high_priority_queue.count, 0) == 0) &&
+        (interlocked_add(&worker_pool->global_queue.count, 0) == 0) &&
+        (interlocked_add(&worker_pool->low_priority_queue.count, 0) == 0)
+        )
+    {
+        /*Codes_SRS_WORKER_POOL_LINUX_01_063: [ When exiting after the park timed out, the worker thread shall count itself as retired and no longer as started. ]*/
+        worker->is_retired = true;
+        (void)interlocked_decrement(&worker_pool->thread_count);
+        worker_pool->retired_thread_count++;
+        result = true;
+    }
+    else
+    {
+        /*Codes_SRS_WORKER_POOL_LINUX_01_064: [ Otherwise the worker thread shall look for work again. ]*/
+        result = false;
+    }
+
+    (void)pthread_mutex_unlock(&worker_pool->lock);
+
+    return result;
+}
+
+static void* worker_pool_linux_worker_thread(void* arg)
+{
+    WORKER_POOL_LINUX_WORKER* worker = arg;
+    WORKER_POOL_LINUX* worker_pool = worker->worker_pool;
+
+    worker_pool_linux_current_worker = worker;
+
+    for (;;)
+    {
+        /*read the signal before looking at the queues, so that a submit that happens before the wait makes the wait return right away*/
+        int32_t work_signal = interlocked_add(&worker_pool->work_signal, 0);
+        WORKER_POOL_LINUX_WORK_ITEM* work_item = find_work(worker);
+
+        if (work_item != NULL)
+        {
+            WORKER_POOL_LINUX_WORK_FUNCTION work_function = work_item->work_function;
+
+            /*Codes_SRS_WORKER_POOL_LINUX_01_025: [ For each work item, the worker thread shall call work_function with work_function_context. ]*/
+            work_function(work_item->work_function_context);
+        }
+        else if (interlocked_add(&worker_pool->stop_requested, 0) != 0)
+        {
+            /*Codes_SRS_WORKER_POOL_LINUX_01_027: [ When a stop was requested and there is no work item to run, the worker thread shall exit. ]*/
+            break;
+        }
+        else
+        {
+            bool is_woken;
+
+            /*Codes_SRS_WORKER_POOL_LINUX_01_026: [ When there is no work item to run, the worker thread shall count itself as idle and park by calling wait_on_address on the work signal. ]*/
+            /*Codes_SRS_WORKER_POOL_LINUX_01_061: [ If idle_timeout_ms is not 0, the worker thread shall park for at most idle_timeout_ms, otherwise it shall park with no timeout. ]*/
+            (void)interlocked_increment(&worker_pool->idle_thread_count);
+            is_woken = wait_on_address(&worker_pool->work_signal, work_signal, (worker_pool->idle_timeout_ms == 0) ? UINT32_MAX : worker_pool->idle_timeout_ms);
+            (void)interlocked_decrement(&worker_pool->idle_thread_count);
+
+            if (
+                /*with no idle timeout the wait only returns false on errors, the worker thread does not retire then*/
+                (worker_pool->idle_timeout_ms != 0) &&
+                !is_woken &&
+                retire_worker_thread_if_idle(worker, work_signal)
+                )
+            {
+                break;
+            }
+        }
+    }
+
+    worker_pool_linux_current_worker = NULL;
+
+    return NULL;
+}
+
+static int start_worker_thread(WORKER_POOL_LINUX* worker_pool)
+{
+    int result;
+    pthread_attr_t attr;
+    WORKER_POOL_LINUX_WORKER* worker = &worker_pool->workers[interlocked_add(&worker_pool->thread_count, 0)];
+
+    if (worker->is_retired)
+    {
+        /*Codes_SRS_WORKER_POOL_LINUX_01_065: [ Before starting a worker thread in place of a worker thread that retired, the worker pool shall join the retired thread by calling pthread_join, so that its stack is released. ]*/
+        if (pthread_join(worker->thread, NULL) != 0)
+        {
+            LogError("pthread_join failed for a retired worker thread");
+        }
+        worker->is_retired = false;
+    }
+
+    /*Codes_SRS_WORKER_POOL_LINUX_01_009: [ To start a worker thread, worker_pool_linux_create shall initialize the thread attributes by calling pthread_attr_init. ]*/
+    if (pthread_attr_init(&attr) != 0)
+    {
+        LogError("pthread_attr_init failed");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        if (
+            /*Codes_SRS_WORKER_POOL_LINUX_01_010: [ If stack_size is not 0, worker_pool_linux_create shall set the stack size of the thread by calling pthread_attr_setstacksize. ]*/
+            (worker_pool->stack_size != 0) &&
+            (pthread_attr_setstacksize(&attr, worker_pool->stack_size) != 0)
+            )
+        {
+            LogError("pthread_attr_setstacksize(stack_size=%zu) failed", worker_pool->stack_size);
+            result = MU_FAILURE;
+        }
+        else if (
+            /*Codes_SRS_WORKER_POOL_LINUX_01_011: [ If cpu_count is not 0, worker_pool_linux_create shall restrict the thread to cpus by calling pthread_attr_setaffinity_np. ]*/
+            (worker_pool->has_cpu_set) &&
+            (pthread_attr_setaffinity_np(&attr, sizeof(worker_pool->cpu_set), &worker_pool->cpu_set) != 0)
+            )
+        {
+            LogError("pthread_attr_setaffinity_np failed");
+            result = MU_FAILURE;
+        }
+        /*Codes_SRS_WORKER_POOL_LINUX_01_012: [ worker_pool_linux_create shall start the thread by calling pthread_create. ]*/
+        else if (pthread_create(&worker->thread, &attr, worker_pool_linux_worker_thread, worker) != 0)
+        {
+            LogError("pthread_create failed");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            uint32_t thread_count = (uint32_t)interlocked_increment(&worker_pool->thread_count);
+            worker_pool->started_thread_count++;
+            if (thread_count > worker_pool->peak_thread_count)
+            {
+                worker_pool->peak_thread_count = thread_count;
+            }
+            result = 0;
+        }
+
+        /*Codes_SRS_WORKER_POOL_LINUX_01_013: [ worker_pool_linux_create shall destroy the thread attributes by calling pthread_attr_destroy. ]*/
+        (void)pthread_attr_destroy(&attr);
+    }
+
+    return result;
+}
+
+static void start_worker_thread_if_needed(WORKER_POOL_LINUX* worker_pool)
+{
+    /*the lock is held by the caller*/
+    if (
+        (interlocked_add(&worker_pool->idle_thread_count, 0) == 0) &&
+        ((uint32_t)interlocked_add(&worker_pool->thread_count, 0) < worker_pool->max_thread_count)
+        )
+    {
+        /*Codes_SRS_WORKER_POOL_LINUX_01_029: [ If no worker thread is idle and fewer than max_thread_count worker threads are started, worker_pool_linux_submit shall start a new worker thread. ]*/
+        if (start_worker_thread(worker_pool) != 0)
+        {
+            /*Codes_SRS_WORKER_POOL_LINUX_01_030: [ If starting the worker thread fails and no worker thread is started, worker_pool_linux_submit shall fail and return a non-zero value, otherwise the work item is left to the started worker threads. ]*/
+            LogWarning("could not start a new worker thread, %" PRId32 " worker threads running", interlocked_add(&worker_pool->thread_count, 0));
+        }
+    }
+}
+
+static void start_worker_threads_for_batch(WORKER_POOL_LINUX* worker_pool, int32_t work_item_count)
+{
+    /*the lock is held by the caller*/
+    int32_t threads_to_start = work_item_count - interlocked_add(&worker_pool->idle_thread_count, 0);
+
+    /*Codes_SRS_WORKER_POOL_LINUX_01_044: [ worker_pool_linux_submit_batch shall start new worker threads for the work items that the idle worker threads cannot take, as long as fewer than max_thread_count worker threads are started. ]*/
+    while (
+        (threads_to_start > 0) &&
+        ((uint32_t)interlocked_add(&worker_pool->thread_count, 0) < worker_pool->max_thread_count)
+        )
+    {
+        if (start_worker_thread(worker_pool) != 0)
+        {
+            /*Codes_SRS_WORKER_POOL_LINUX_01_045: [ If starting a worker thread fails and no worker thread is started, worker_pool_linux_submit_batch shall fail and return a non-zero value, otherwise the work items are left to the started worker threads. ]*/
+            LogWarning("could not start a new worker thread, %" PRId32 " worker threads running", interlocked_add(&worker_pool->thread_count, 0));
+            break;
+        }
+        threads_to_start--;
+    }
+}
+
+static void inject_worker_thread_if_starved(WORKER_POOL_LINUX* worker_pool)
+{
+    WORKER_POOL_LINUX_WORK_ITEM* oldest_work_item;
+
+    (void)pthread_mutex_lock(&worker_pool->lock);
+
+    /*low priority work items are expected to wait, they do not make the controller start worker threads*/
+    oldest_work_item = (worker_pool->high_priority_queue.head != NULL) ? worker_pool->high_priority_queue.head : worker_pool->global_queue.head;
+
+    if (
+        /*Codes_SRS_WORKER_POOL_LINUX_01_068: [ On every tick, if the oldest work item of the high priority queue, or of the global queue when the high priority queue is empty, is the same as on the previous tick, no stop was requested, no worker thread is idle and fewer than max_thread_count plus max_injected_thread_count worker threads are started, the controller thread shall start a new worker thread and count it as injected. ]*/
+        (oldest_work_item != NULL) &&
+        (oldest_work_item == worker_pool->controller_oldest_work_item) &&
+        (interlocked_add(&worker_pool->stop_requested, 0) == 0) &&
+        (interlocked_add(&worker_pool->idle_thread_count, 0) == 0) &&
+        ((uint32_t)interlocked_add(&worker_pool->thread_count, 0) < worker_pool->worker_count)
+        )
+    {
+        if (start_worker_thread(worker_pool) != 0)
+        {
+            /*Codes_SRS_WORKER_POOL_LINUX_01_069: [ If starting the worker thread fails, the controller thread shall try again on the next tick. ]*/
+            LogWarning("could not inject a worker thread, %" PRId32 " worker threads running", interlocked_add(&worker_pool->thread_count, 0));
+        }
+        else
+        {
+            worker_pool->injected_thread_count++;
+        }
+    }
+
+    worker_pool->controller_oldest_work_item = oldest_work_item;
+
+    (void)pthread_mutex_unlock(&worker_pool->lock);
+}
+
+static void* worker_pool_linux_controller_thread(void* arg)
+{
+    WORKER_POOL_LINUX* worker_pool = arg;
+
+    /*Codes_SRS_WORKER_POOL_LINUX_01_067: [ Until a stop is requested, the controller thread shall tick every 500 milliseconds by calling wait_on_address on the stop request. ]*/
+    while (interlocked_add(&worker_pool->stop_requested, 0) == 0)
+    {
+        if (!wait_on_address(&worker_pool->stop_requested, 0, WORKER_POOL_LINUX_CONTROLLER_INTERVAL_MS))
+        {
+            inject_worker_thread_if_starved(worker_pool);
+        }
+    }
+
+    return NULL;
+}
+
+static void stop_worker_threads(WORKER_POOL_LINUX* worker_pool)
+{
+    int32_t i;
+
+    (void)interlocked_exchange(&worker_pool->stop_requested, 1);
+    (void)interlocked_increment(&worker_pool->work_signal);
+    wake_by_address_all(&worker_pool->work_signal);
+
+    /*a worker thread that is retiring or the controller thread injecting a worker thread hold the lock, once it was taken here they see the stop request*/
+    (void)pthread_mutex_lock(&worker_pool->lock);
+    (void)pthread_mutex_unlock(&worker_pool->lock);
+
+    if (worker_pool->has_controller)
+    {
+        /*Codes_SRS_WORKER_POOL_LINUX_01_070: [ worker_pool_linux_destroy shall wake the controller thread by calling wake_by_address_all on the stop request and join it by calling pthread_join. ]*/
+        wake_by_address_all(&worker_pool->stop_requested);
+        if (pthread_join(worker_pool->controller_thread, NULL) != 0)
+        {
+            LogError("pthread_join failed for the controller thread");
+        }
+    }
+
+    /*the thread count is read on every iteration, work items that are still running can submit more work and start more worker threads*/
+    for (i = 0; i < interlocked_add(&worker_pool->thread_count, 0); i++)
+    {
+        if (pthread_join(worker_pool->workers[i].thread, NULL) != 0)
+        {
+            LogError("pthread_join failed for worker thread %" PRId32 "", i);
+        }
+    }
+
+    /*Codes_SRS_WORKER_POOL_LINUX_01_071: [ worker_pool_linux_destroy shall join the worker threads that retired and were not joined yet by calling pthread_join. ]*/
+    for (; (uint32_t)i < worker_pool->worker_count; i++)
+    {
+        if (worker_pool->workers[i].is_retired)
+        {
+            if (pthread_join(worker_pool->workers[i].thread, NULL) != 0)
+            {
+                LogError("pthread_join failed for retired worker thread %" PRId32 "", i);
+            }
+            worker_pool->workers[i].is_retired = false;
+        }
+    }
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, WORKER_POOL_LINUX_HANDLE, worker_pool_linux_create, const WORKER_POOL_LINUX_PARAMETERS*, parameters)
+{
+    WORKER_POOL_LINUX_HANDLE result;
+
+    if (
+        /*Codes_SRS_WORKER_POOL_LINUX_01_001: [ If parameters is NULL, worker_pool_linux_create shall fail and return NULL. ]*/
+        (parameters == NULL) ||
+        /*Codes_SRS_WORKER_POOL_LINUX_01_002: [ If max_thread_count is not 0 and min_thread_count is greater than max_thread_count, worker_pool_linux_create shall fail and return NULL. ]*/
+        ((parameters->max_thread_count != 0) && (parameters->min_thread_count > parameters->max_thread_count)) ||
+        /*Codes_SRS_WORKER_POOL_LINUX_01_003: [ If cpu_count is not 0 and cpus is NULL, worker_pool_linux_create shall fail and return NULL. ]*/
+        ((parameters->cpu_count != 0) && (parameters->cpus == NULL))
+        )
+    {
+        LogError("Invalid arguments: const WORKER_POOL_LINUX_PARAMETERS* parameters=%p, min_thread_count=%" PRIu32 ", max_thread_count=%" PRIu32 ", cpu_count=%" PRIu32 ", cpus=%p",
+            parameters,
+            (parameters == NULL) ? 0 : parameters->min_thread_count,
+            (parameters == NULL) ? 0 : parameters->max_thread_count,
+            (parameters == NULL) ? 0 : parameters->cpu_count,
+            (parameters == NULL) ? NULL : parameters->cpus);
+        result = NULL;
+    }
+    else
+    {
+        uint32_t i;
+        for (i = 0; i < parameters->cpu_count; i++)
+        {
+            if (parameters->cpus[i] >= CPU_SETSIZE)
+            {
+                break;
+            }
+        }
+
+        if (i < parameters->cpu_count)
+        {
+            /*Codes_SRS_WORKER_POOL_LINUX_01_004: [ If any of the cpus is greater than or equal to CPU_SETSIZE, worker_pool_linux_create shall fail and return NULL. ]*/
+            LogError("Invalid arguments: cpus[%" PRIu32 "]=%" PRIu32 " is out of range, CPU_SETSIZE=%d", i, parameters->cpus[i], CPU_SETSIZE);
+            result = NULL;
+        }
+        else
+        {
+            uint32_t max_thread_count = parameters->max_thread_count;
+            if (max_thread_count == 0)
+            {
+                /*Codes_SRS_WORKER_POOL_LINUX_01_005: [ If max_thread_count is 0, worker_pool_linux_create shall use as maximum the number of cpus, or the number of processors returned by sysinfo_get_processor_count if cpu_count is 0, but no less than min_thread_count and no less than 1. ]*/
+                max_thread_count = (parameters->cpu_count != 0) ? parameters->cpu_count : sysinfo_get_processor_count();
+                if (max_thread_count < parameters->min_thread_count)
+                {
+                    max_thread_count = parameters->min_thread_count;
+                }
+                if (max_thread_count == 0)
+                {
+                    max_thread_count = 1;
+                }
+            }
+
+            if (parameters->max_injected_thread_count > UINT32_MAX - max_thread_count)
+            {
+                /*Codes_SRS_WORKER_POOL_LINUX_01_059: [ If max_injected_thread_count added to the maximum number of worker threads overflows, worker_pool_linux_create shall fail and return NULL. ]*/
+                LogError("Invalid arguments: max_injected_thread_count=%" PRIu32 " is too large for max_thread_count=%" PRIu32 "", parameters->max_injected_thread_count, max_thread_count);
+                result = NULL;
+            }
+            else
+            {
+                uint32_t worker_count = max_thread_count + parameters->max_injected_thread_count;
+
+                /*Codes_SRS_WORKER_POOL_LINUX_01_006: [ worker_pool_linux_create shall allocate a new worker pool with room for max_thread_count plus max_injected_thread_count worker threads and their deques and on success return a non-NULL handle. ]*/
+                result = malloc(sizeof(WORKER_POOL_LINUX) + (size_t)worker_count * sizeof(WORKER_POOL_LINUX_WORKER));
+                if (result == NULL)
+                {
+                    /*Codes_SRS_WORKER_POOL_LINUX_01_014: [ If any error occurs, worker_pool_linux_create shall fail and return NULL. ]*/
+                    LogError("malloc(sizeof(WORKER_POOL_LINUX) + %" PRIu32 " * sizeof(WORKER_POOL_LINUX_WORKER)) failed", worker_count);
+                }
+                else
+                {
+                    result->min_thread_count = parameters->min_thread_count;
+                    result->max_thread_count = max_thread_count;
+                    result->worker_count = worker_count;
+                    result->idle_timeout_ms = parameters->idle_timeout_ms;
+                    result->stack_size = parameters->stack_size;
+                    result->has_cpu_set = (parameters->cpu_count != 0);
+                    CPU_ZERO(&result->cpu_set);
+                    for (i = 0; i < parameters->cpu_count; i++)
+                    {
+                        CPU_SET(parameters->cpus[i], &result->cpu_set);
+                    }
+
+                    global_queue_init(&result->high_priority_queue);
+                    global_queue_init(&result->global_queue);
+                    global_queue_init(&result->low_priority_queue);
+                    (void)interlocked_exchange(&result->thread_count, 0);
+                    (void)interlocked_exchange(&result->idle_thread_count, 0);
+                    (void)interlocked_exchange(&result->work_signal, 0);
+                    (void)interlocked_exchange(&result->stop_requested, 0);
+                    result->has_controller = false;
+                    result->controller_oldest_work_item = NULL;
+                    result->peak_thread_count = 0;
+                    result->started_thread_count = 0;
+                    result->injected_thread_count = 0;
+                    result->retired_thread_count = 0;
+
+                    /*all the workers are initialized upfront (no thread can see them yet), the thieves look at a worker as soon as the thread count says it is started*/
+                    for (i = 0; i < worker_count; i++)
+                    {
+                        WORKER_POOL_LINUX_WORKER* worker = &result->workers[i];
+                        worker->worker_pool = result;
+                        worker->run_count = 0;
+                        worker->lifo_run_count = 0;
+                        worker->steal_seed = i + 1;
+                        worker->is_retired = false;
+                        worker->lifo_slot = NULL;
+                        worker->bottom = 0;
+                        worker->top = 0;
+                    }
+
+                    /*Codes_SRS_WORKER_POOL_LINUX_01_007: [ worker_pool_linux_create shall initialize the lock protecting the work queue by calling pthread_mutex_init. ]*/
+                    if (pthread_mutex_init(&result->lock, NULL) != 0)
+                    {
+                        /*Codes_SRS_WORKER_POOL_LINUX_01_014: [ If any error occurs, worker_pool_linux_create shall fail and return NULL. ]*/
+                        LogError("pthread_mutex_init failed");
+                        free(result);
+                        result = NULL;
+                    }
+                    else
+                    {
+                        /*Codes_SRS_WORKER_POOL_LINUX_01_008: [ worker_pool_linux_create shall start min_thread_count worker threads. ]*/
+                        for (i = 0; i < parameters->min_thread_count; i++)
+                        {
+                            if (start_worker_thread(result) != 0)
+                            {
+                                break;
+                            }
+                        }
+
+                        if (i < parameters->min_thread_count)
+                        {
+                            /*Codes_SRS_WORKER_POOL_LINUX_01_015: [ If starting any of the worker threads fails, worker_pool_linux_create shall stop and join the worker threads already started. ]*/
+                            LogError("failed starting worker thread %" PRIu32 " out of %" PRIu32 "", i, parameters->min_thread_count);
+                            stop_worker_threads(result);
+                            (void)pthread_mutex_destroy(&result->lock);
+                            free(result);
+                            result = NULL;
+                        }
+                        else if (
+                            /*Codes_SRS_WORKER_POOL_LINUX_01_060: [ If max_injected_thread_count is not 0, worker_pool_linux_create shall start the controller thread by calling pthread_create. ]*/
+                            (parameters->max_injected_thread_count != 0) &&
+                            (pthread_create(&result->controller_thread, NULL, worker_pool_linux_controller_thread, result) != 0)
+                            )
+                        {
+                            /*Codes_SRS_WORKER_POOL_LINUX_01_066: [ If starting the controller thread fails, worker_pool_linux_create shall stop and join the worker threads already started. ]*/
+                            LogError("failed starting the controller thread");
+                            stop_worker_threads(result);
+                            (void)pthread_mutex_destroy(&result->lock);
+                            free(result);
+                            result = NULL;
+                        }
+                        else
+                        {
+                            result->has_controller = (parameters->max_injected_thread_count != 0);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, void, worker_pool_linux_destroy, WORKER_POOL_LINUX_HANDLE, worker_pool)
+{
+    if (worker_pool == NULL)
+    {
+        /*Codes_SRS_WORKER_POOL_LINUX_01_016: [ If worker_pool is NULL, worker_pool_linux_destroy shall return. ]*/
+        LogError("Invalid arguments: WORKER_POOL_LINUX_HANDLE worker_pool=%p", worker_pool);
+    }
+    else
+    {
+        /*Codes_SRS_WORKER_POOL_LINUX_01_017: [ worker_pool_linux_destroy shall request the worker threads to stop, bump the work signal and wake all of them by calling wake_by_address_all. ]*/
+        /*Codes_SRS_WORKER_POOL_LINUX_01_018: [ worker_pool_linux_destroy shall join all the worker threads by calling pthread_join, the worker threads run all the queued work items before exiting. ]*/
+        stop_worker_threads(worker_pool);
+
+        /*Codes_SRS_WORKER_POOL_LINUX_01_019: [ worker_pool_linux_destroy shall destroy the lock by calling pthread_mutex_destroy and free the worker pool. ]*/
+        (void)pthread_mutex_destroy(&worker_pool->lock);
+        free(worker_pool);
+    }
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, worker_pool_linux_submit, WORKER_POOL_LINUX_HANDLE, worker_pool, WORKER_POOL_LINUX_WORK_ITEM*, work_item)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_WORKER_POOL_LINUX_01_020: [ If worker_pool is NULL, worker_pool_linux_submit shall fail and return a non-zero value. ]*/
+        (worker_pool == NULL) ||
+        /*Codes_SRS_WORKER_POOL_LINUX_01_021: [ If work_item is NULL, worker_pool_linux_submit shall fail and return a non-zero value. ]*/
+        (work_item == NULL) ||
+        /*Codes_SRS_WORKER_POOL_LINUX_01_022: [ If the work_function of work_item is NULL, worker_pool_linux_submit shall fail and return a non-zero value. ]*/
+        (work_item->work_function == NULL) ||
+        /*Codes_SRS_WORKER_POOL_LINUX_01_049: [ If the priority of work_item is not WORKER_POOL_LINUX_PRIORITY_HIGH, WORKER_POOL_LINUX_PRIORITY_NORMAL or WORKER_POOL_LINUX_PRIORITY_LOW, worker_pool_linux_submit shall fail and return a non-zero value. ]*/
+        !is_valid_priority(work_item->priority)
+        )
+    {
+        LogError("Invalid arguments: WORKER_POOL_LINUX_HANDLE worker_pool=%p, WORKER_POOL_LINUX_WORK_ITEM* work_item=%p, work_function=%p, priority=%" PRI_MU_ENUM "",
+            worker_pool, work_item, (work_item == NULL) ? NULL : work_item->work_function,
+            MU_ENUM_VALUE(WORKER_POOL_LINUX_PRIORITY, (work_item == NULL) ? WORKER_POOL_LINUX_PRIORITY_NORMAL : work_item->priority));
+        result = MU_FAILURE;
+    }
+    else
+    {
+        WORKER_POOL_LINUX_WORKER* worker = worker_pool_linux_current_worker;
+
+        if (
+            /*high and low priority work items always go to their global queue, the local queues of the worker threads only hold normal priority work items*/
+            (work_item->priority == WORKER_POOL_LINUX_PRIORITY_NORMAL) &&
+            (worker != NULL) &&
+            (worker->worker_pool == worker_pool)
+            )
+        {
+            /*Codes_SRS_WORKER_POOL_LINUX_01_033: [ If the priority of work_item is WORKER_POOL_LINUX_PRIORITY_NORMAL and worker_pool_linux_submit is called from one of the worker threads of worker_pool, it shall place work_item in the LIFO slot of that worker thread. ]*/
+            WORKER_POOL_LINUX_WORK_ITEM* displaced_work_item = interlocked_exchange_pointer(&worker->lifo_slot, work_item);
+
+            if (
+                (displaced_work_item != NULL) &&
+                /*Codes_SRS_WORKER_POOL_LINUX_01_034: [ The work item previously in the LIFO slot shall be pushed to the deque of the worker thread. ]*/
+                !deque_push(worker, displaced_work_item)
+                )
+            {
+                /*Codes_SRS_WORKER_POOL_LINUX_01_035: [ If the deque of the worker thread is full, the work item previously in the LIFO slot shall be appended to the global queue. ]*/
+                (void)pthread_mutex_lock(&worker_pool->lock);
+                global_queue_push(&worker_pool->global_queue, displaced_work_item);
+                (void)pthread_mutex_unlock(&worker_pool->lock);
+            }
+
+            /*only take the lock when a worker thread could be started, so that submits from worker threads do not contend on it*/
+            if (
+                (interlocked_add(&worker_pool->idle_thread_count, 0) == 0) &&
+                ((uint32_t)interlocked_add(&worker_pool->thread_count, 0) < worker_pool->max_thread_count)
+                )
+            {
+                (void)pthread_mutex_lock(&worker_pool->lock);
+                start_worker_thread_if_needed(worker_pool);
+                (void)pthread_mutex_unlock(&worker_pool->lock);
+            }
+
+            result = 0;
+        }
+        else
+        {
+            (void)pthread_mutex_lock(&worker_pool->lock);
+
+            start_worker_thread_if_needed(worker_pool);
+
+            if (interlocked_add(&worker_pool->thread_count, 0) == 0)
+            {
+                /*Codes_SRS_WORKER_POOL_LINUX_01_028: [ If any error occurs, worker_pool_linux_submit shall fail and return a non-zero value. ]*/
+                (void)pthread_mutex_unlock(&worker_pool->lock);
+                LogError("no worker thread is running, cannot run work_function=%p", work_item->work_function);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /*Codes_SRS_WORKER_POOL_LINUX_01_023: [ Otherwise, worker_pool_linux_submit shall append work_item to the global queue of the worker pool. ]*/
+                /*Codes_SRS_WORKER_POOL_LINUX_01_050: [ worker_pool_linux_submit shall append WORKER_POOL_LINUX_PRIORITY_HIGH work items to the high priority queue and WORKER_POOL_LINUX_PRIORITY_LOW work items to the low priority queue of the worker pool, also when called from one of the worker threads. ]*/
+                global_queue_push(get_global_queue(worker_pool, work_item->priority), work_item);
+                (void)pthread_mutex_unlock(&worker_pool->lock);
+                result = 0;
+            }
+        }
+
+        if (result == 0)
+        {
+            /*Codes_SRS_WORKER_POOL_LINUX_01_031: [ worker_pool_linux_submit shall bump the work signal and, if any worker thread is idle, wake one of them by calling wake_by_address_single. ]*/
+            (void)interlocked_increment(&worker_pool->work_signal);
+            if (interlocked_add(&worker_pool->idle_thread_count, 0) != 0)
+            {
+                wake_by_address_single(&worker_pool->work_signal);
+            }
+
+            /*Codes_SRS_WORKER_POOL_LINUX_01_032: [ worker_pool_linux_submit shall succeed and return 0. ]*/
+        }
+    }
+
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, worker_pool_linux_submit_batch, WORKER_POOL_LINUX_HANDLE, worker_pool, WORKER_POOL_LINUX_WORK_ITEM*, work_items)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_WORKER_POOL_LINUX_01_040: [ If worker_pool is NULL, worker_pool_linux_submit_batch shall fail and return a non-zero value. ]*/
+        (worker_pool == NULL) ||
+        /*Codes_SRS_WORKER_POOL_LINUX_01_041: [ If work_items is NULL, worker_pool_linux_submit_batch shall fail and return a non-zero value. ]*/
+        (work_items == NULL)
+        )
+    {
+        LogError("Invalid arguments: WORKER_POOL_LINUX_HANDLE worker_pool=%p, WORKER_POOL_LINUX_WORK_ITEM* work_items=%p",
+            worker_pool, work_items);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*the work items are counted and checked before taking the lock, so that the lock is held only for splicing them*/
+        WORKER_POOL_LINUX_WORK_ITEM* last_work_item = work_items;
+        int32_t work_item_count = 1;
+
+        while (
+            (last_work_item->work_function != NULL) &&
+            (last_work_item->priority == work_items->priority) &&
+            (last_work_item->next != NULL)
+            )
+        {
+            last_work_item = last_work_item->next;
+            work_item_count++;
+        }
+
+        if (last_work_item->work_function == NULL)
+        {
+            /*Codes_SRS_WORKER_POOL_LINUX_01_042: [ If the work_function of any of the work items is NULL, worker_pool_linux_submit_batch shall fail and return a non-zero value. ]*/
+            LogError("work item %" PRId32 " of work_items=%p has a NULL work_function", work_item_count - 1, work_items);
+            result = MU_FAILURE;
+        }
+        else if (
+            /*Codes_SRS_WORKER_POOL_LINUX_01_051: [ If the priority of the first work item is not valid or the priority of any of the other work items is different, worker_pool_linux_submit_batch shall fail and return a non-zero value. ]*/
+            !is_valid_priority(work_items->priority) ||
+            (last_work_item->priority != work_items->priority)
+            )
+        {
+            LogError("work item %" PRId32 " of work_items=%p has priority %" PRI_MU_ENUM ", the batch has priority %" PRI_MU_ENUM "",
+                work_item_count - 1, work_items, MU_ENUM_VALUE(WORKER_POOL_LINUX_PRIORITY, last_work_item->priority), MU_ENUM_VALUE(WORKER_POOL_LINUX_PRIORITY, work_items->priority));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            (void)pthread_mutex_lock(&worker_pool->lock);
+
+            start_worker_threads_for_batch(worker_pool, work_item_count);
+
+            if (interlocked_add(&worker_pool->thread_count, 0) == 0)
+            {
+                /*Codes_SRS_WORKER_POOL_LINUX_01_048: [ If any error occurs, worker_pool_linux_submit_batch shall fail and return a non-zero value and none of the work items shall be queued. ]*/
+                (void)pthread_mutex_unlock(&worker_pool->lock);
+                LogError("no worker thread is running, cannot run the %" PRId32 " work items of work_items=%p", work_item_count, work_items);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                int32_t idle_thread_count;
+                WORKER_POOL_LINUX_QUEUE* queue = get_global_queue(worker_pool, work_items->priority);
+
+                /*Codes_SRS_WORKER_POOL_LINUX_01_043: [ Otherwise, worker_pool_linux_submit_batch shall append all the work items to the global queue of their priority at once, in order. ]*/
+                if (queue->tail == NULL)
+                {
+                    queue->head = work_items;
+                }
+                else
+                {
+                    queue->tail->next = work_items;
+                }
+                queue->tail = last_work_item;
+                (void)interlocked_add(&queue->count, work_item_count);
+
+                (void)pthread_mutex_unlock(&worker_pool->lock);
+
+                /*Codes_SRS_WORKER_POOL_LINUX_01_046: [ worker_pool_linux_submit_batch shall bump the work signal once and wake as many idle worker threads as there are work items: all of them by calling wake_by_address_all if there are at least as many work items as idle worker threads, otherwise one per work item by calling wake_by_address_single. ]*/
+                (void)interlocked_increment(&worker_pool->work_signal);
+                idle_thread_count = interlocked_add(&worker_pool->idle_thread_count, 0);
+                if (idle_thread_count != 0)
+                {
+                    if (work_item_count >= idle_thread_count)
+                    {
+                        wake_by_address_all(&worker_pool->work_signal);
+                    }
+                    else
+                    {
+                        for (int32_t i = 0; i < work_item_count; i++)
+                        {
+                            wake_by_address_single(&worker_pool->work_signal);
+                        }
+                    }
+                }
+
+                /*Codes_SRS_WORKER_POOL_LINUX_01_047: [ worker_pool_linux_submit_batch shall succeed and return 0. ]*/
+                result = 0;
+            }
+        }
+    }
+
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, worker_pool_linux_get_thread_counts, WORKER_POOL_LINUX_HANDLE, worker_pool, uint32_t*, thread_count, uint32_t*, idle_thread_count)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_WORKER_POOL_LINUX_01_055: [ If worker_pool is NULL, worker_pool_linux_get_thread_counts shall fail and return a non-zero value. ]*/
+        (worker_pool == NULL) ||
+        /*Codes_SRS_WORKER_POOL_LINUX_01_056: [ If thread_count is NULL, worker_pool_linux_get_thread_counts shall fail and return a non-zero value. ]*/
+        (thread_count == NULL) ||
+        /*Codes_SRS_WORKER_POOL_LINUX_01_057: [ If idle_thread_count is NULL, worker_pool_linux_get_thread_counts shall fail and return a non-zero value. ]*/
+        (idle_thread_count == NULL)
+        )
+    {
+        LogError("Invalid arguments: WORKER_POOL_LINUX_HANDLE worker_pool=%p, uint32_t* thread_count=%p, uint32_t* idle_thread_count=%p",
+            worker_pool, thread_count, idle_thread_count);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_WORKER_POOL_LINUX_01_058: [ worker_pool_linux_get_thread_counts shall set thread_count to the number of started worker threads and idle_thread_count to the number of idle worker threads, no larger than thread_count, and return 0. ]*/
+        int32_t started_thread_count = interlocked_add(&worker_pool->thread_count, 0);
+        int32_t idle_count = interlocked_add(&worker_pool->idle_thread_count, 0);
+
+        *thread_count = (started_thread_count < 0) ? 0 : (uint32_t)started_thread_count;
+        *idle_thread_count = (idle_count < 0) ? 0 : (((uint32_t)idle_count > *thread_count) ? *thread_count : (uint32_t)idle_count);
+
+        result = 0;
+    }
+
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, worker_pool_linux_get_statistics, WORKER_POOL_LINUX_HANDLE, worker_pool, WORKER_POOL_LINUX_STATISTICS*, statistics)
+{
+    int result;
+
+    if (
+        /*Codes_SRS_WORKER_POOL_LINUX_01_072: [ If worker_pool is NULL, worker_pool_linux_get_statistics shall fail and return a non-zero value. ]*/
+        (worker_pool == NULL) ||
+        /*Codes_SRS_WORKER_POOL_LINUX_01_073: [ If statistics is NULL, worker_pool_linux_get_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments: WORKER_POOL_LINUX_HANDLE worker_pool=%p, WORKER_POOL_LINUX_STATISTICS* statistics=%p",
+            worker_pool, statistics);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        int32_t started_thread_count;
+        int32_t idle_count;
+
+        /*Codes_SRS_WORKER_POOL_LINUX_01_074: [ worker_pool_linux_get_statistics shall take the lock, so that the statistics are consistent with each other. ]*/
+        (void)pthread_mutex_lock(&worker_pool->lock);
+
+        started_thread_count = interlocked_add(&worker_pool->thread_count, 0);
+        idle_count = interlocked_add(&worker_pool->idle_thread_count, 0);
+
+        /*Codes_SRS_WORKER_POOL_LINUX_01_075: [ worker_pool_linux_get_statistics shall set in statistics the number of started and idle worker threads like worker_pool_linux_get_thread_counts, the peak number of started worker threads and the number of worker threads started, injected by the controller thread and retired since the worker pool was created and return 0. ]*/
+        statistics->thread_count = (started_thread_count < 0) ? 0 : (uint32_t)started_thread_count;
+        statistics->idle_thread_count = (idle_count < 0) ? 0 : (((uint32_t)idle_count > statistics->thread_count) ? statistics->thread_count : (uint32_t)idle_count);
+        statistics->peak_thread_count = worker_pool->peak_thread_count;
+        statistics->started_thread_count = worker_pool->started_thread_count;
+        statistics->injected_thread_count = worker_pool->injected_thread_count;
+        statistics->retired_thread_count = worker_pool->retired_thread_count;
+
+        (void)pthread_mutex_unlock(&worker_pool->lock);
+
+        result = 0;
+    }
+
+    return result;
+}
@@ -0,0 +1,948 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cinttypes>
+#else
+#include <stdlib.h>
+#include <inttypes.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "real_gballoc_ll.h"
+static void* real_malloc(size_t size)
+{
+    return real_gballoc_ll_malloc(size);
+}
+
+static void real_free(void* ptr)
+{
+    real_gballoc_ll_free(ptr);
+}
+
+#include "testrunnerswitcher.h"
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umock_c_negative_tests.h"
+#include "c_pal/execution_engine.h"
+
+#define ENABLE_MOCKS
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/lazy_init.h"
+#include "c_pal/sysinfo.h"
+#include "c_pal/sysinfo_linux.h"
+#include "c_pal/io_ring_linux.h"
+#include "c_pal/io_admission.h"
+#include "c_pal/worker_pool_linux.h"
+#include "c_pal/timer_wheel_linux.h"
+
+#undef ENABLE_MOCKS
+
+#include "real_gballoc_hl.h"
+#include "real_interlocked.h"
+
+#include "c_pal/execution_engine_linux.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+
+static IO_RING_LINUX_HANDLE test_io_ring = (IO_RING_LINUX_HANDLE)0x4242;
+static IO_ADMISSION_HANDLE test_io_admission = (IO_ADMISSION_HANDLE)0x4244;
+static WORKER_POOL_LINUX_HANDLE test_worker_pool = (WORKER_POOL_LINUX_HANDLE)0x4246;
+static TIMER_WHEEL_LINUX_HANDLE test_timer_wheel = (TIMER_WHEEL_LINUX_HANDLE)0x4248;
+static WORKER_POOL_LINUX_HANDLE test_numa_node_worker_pool = (WORKER_POOL_LINUX_HANDLE)0x4250;
+static WORKER_POOL_LINUX_HANDLE test_created_worker_pool;
+static WORKER_POOL_LINUX_PARAMETERS captured_worker_pool_parameters;
+static uint32_t captured_worker_pool_cpus[8];
+
+#define TEST_PROCESSOR_COUNT 8
+static const uint32_t test_numa_node_cpus[] = { 4, 5, 6, 7 };
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+TEST_DEFINE_ENUM_TYPE(LAZY_INIT_RESULT, LAZY_INIT_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(LAZY_INIT_RESULT, LAZY_INIT_RESULT_VALUES);
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static LAZY_INIT_RESULT hook_lazy_init(call_once_t* lazy, LAZY_INIT_FUNCTION do_init, void* init_params)
+{
+    (void)lazy;
+    return (do_init(init_params) == 0) ? LAZY_INIT_OK : LAZY_INIT_ERROR;
+}
+
+static WORKER_POOL_LINUX_HANDLE hook_worker_pool_linux_create(const WORKER_POOL_LINUX_PARAMETERS* parameters)
+{
+    captured_worker_pool_parameters = *parameters;
+    for (uint32_t i = 0; (i < parameters->cpu_count) && (i < sizeof(captured_worker_pool_cpus) / sizeof(captured_worker_pool_cpus[0])); i++)
+    {
+        captured_worker_pool_cpus[i] = parameters->cpus[i];
+    }
+    return test_created_worker_pool;
+}
+
+static int hook_sysinfo_linux_get_numa_node_cpus(uint32_t numa_node, uint32_t* cpus, uint32_t cpu_capacity, uint32_t* cpu_count)
+{
+    (void)numa_node;
+    ASSERT_IS_TRUE(cpu_capacity >= sizeof(test_numa_node_cpus) / sizeof(test_numa_node_cpus[0]));
+    for (uint32_t i = 0; i < sizeof(test_numa_node_cpus) / sizeof(test_numa_node_cpus[0]); i++)
+    {
+        cpus[i] = test_numa_node_cpus[i];
+    }
+    *cpu_count = sizeof(test_numa_node_cpus) / sizeof(test_numa_node_cpus[0]);
+    return 0;
+}
+
+static EXECUTION_ENGINE_HANDLE create_execution_engine(void)
+{
+    EXECUTION_ENGINE_HANDLE execution_engine = execution_engine_create(NULL);
+    ASSERT_IS_NOT_NULL(execution_engine);
+    umock_c_reset_all_calls();
+    return execution_engine;
+}
+
+static EXECUTION_ENGINE_HANDLE create_execution_engine_with_numa_nodes(uint32_t numa_node_count, uint32_t min_thread_count, uint32_t max_thread_count)
+{
+    EXECUTION_ENGINE_PARAMETERS_LINUX parameters = { min_thread_count, max_thread_count, 0, DEFAULT_STACK_SIZE, 0, NULL, DEFAULT_IDLE_TIMEOUT_MS, 3 };
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count())
+        .SetReturn(numa_node_count);
+    EXECUTION_ENGINE_HANDLE execution_engine = execution_engine_create(&parameters);
+    ASSERT_IS_NOT_NULL(execution_engine);
+    test_created_worker_pool = test_numa_node_worker_pool;
+    umock_c_reset_all_calls();
+    return execution_engine;
+}
+
+static EXECUTION_ENGINE_HANDLE create_execution_engine_with_io_limit(void)
+{
+    EXECUTION_ENGINE_PARAMETERS_LINUX parameters = { DEFAULT_MIN_THREAD_COUNT, DEFAULT_MAX_THREAD_COUNT, 16, DEFAULT_STACK_SIZE, 0, NULL };
+    EXECUTION_ENGINE_HANDLE execution_engine = execution_engine_create(&parameters);
+    ASSERT_IS_NOT_NULL(execution_engine);
+    umock_c_reset_all_calls();
+    return execution_engine;
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    int result;
+
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+
+    result = umock_c_init(on_umock_c_error);
+    ASSERT_ARE_EQUAL(int, 0, result, "umock_c_init failed");
+
+    result = umocktypes_stdint_register_types();
+    ASSERT_ARE_EQUAL(int, 0, result, "umocktypes_stdint_register_types failed");
+
+    REGISTER_GLOBAL_MOCK_HOOK(malloc, real_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
+    REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_HOOK(lazy_init, hook_lazy_init);
+    REGISTER_GLOBAL_MOCK_HOOK(worker_pool_linux_create, hook_worker_pool_linux_create);
+    REGISTER_GLOBAL_MOCK_HOOK(sysinfo_linux_get_numa_node_cpus, hook_sysinfo_linux_get_numa_node_cpus);
+
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(io_ring_linux_create, test_io_ring, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(io_admission_create, test_io_admission, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(worker_pool_linux_create, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(timer_wheel_linux_create, test_timer_wheel, NULL);
+    REGISTER_GLOBAL_MOCK_RETURN(sysinfo_get_numa_node_count, 1);
+    REGISTER_GLOBAL_MOCK_RETURNS(sysinfo_get_processor_count, TEST_PROCESSOR_COUNT, 0);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(sysinfo_linux_get_numa_node_cpus, MU_FAILURE);
+
+    REGISTER_TYPE(LAZY_INIT_RESULT, LAZY_INIT_RESULT);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_RING_LINUX_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_ADMISSION_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(WORKER_POOL_LINUX_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TIMER_WHEEL_LINUX_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(LAZY_INIT_FUNCTION, void*);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+    umock_c_negative_tests_init();
+
+    test_created_worker_pool = test_worker_pool;
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    umock_c_negative_tests_deinit();
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+/* execution_engine_create */
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_001: [ If execution_engine_parameters is NULL, execution_engine_create shall use the defaults DEFAULT_MIN_THREAD_COUNT, DEFAULT_MAX_THREAD_COUNT, DEFAULT_MAX_OUTSTANDING_IO, DEFAULT_STACK_SIZE, DEFAULT_IDLE_TIMEOUT_MS and DEFAULT_MAX_INJECTED_THREAD_COUNT, with no CPU affinity, as parameters. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_030: [ execution_engine_create shall obtain the number of NUMA nodes of the host by calling sysinfo_get_numa_node_count. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_002: [ execution_engine_create shall allocate a new execution engine and on success shall return a non-NULL handle. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_019: [ execution_engine_create shall create the worker threads of the execution engine by calling worker_pool_linux_create with min_thread_count, max_thread_count, stack_size, cpu_count, cpus, idle_timeout_ms and max_injected_thread_count. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_004: [ execution_engine_create shall not create the I/O ring, it is created on first use. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_023: [ execution_engine_create shall not create the timer wheel, it is created on first use. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_015: [ If max_outstanding_io is 0, execution_engine_create shall not limit the number of outstanding file I/Os. ]*/
+TEST_FUNCTION(execution_engine_create_succeeds)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count());
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(worker_pool_linux_create(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, LAZY_INIT_NOT_DONE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, LAZY_INIT_NOT_DONE));
+
+    // act
+    execution_engine = execution_engine_create(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(execution_engine);
+    ASSERT_IS_NULL(execution_engine_linux_get_io_admission(execution_engine));
+    ASSERT_ARE_EQUAL(uint32_t, DEFAULT_MIN_THREAD_COUNT, captured_worker_pool_parameters.min_thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, DEFAULT_MAX_THREAD_COUNT, captured_worker_pool_parameters.max_thread_count);
+    ASSERT_ARE_EQUAL(size_t, DEFAULT_STACK_SIZE, captured_worker_pool_parameters.stack_size);
+    ASSERT_ARE_EQUAL(uint32_t, 0, captured_worker_pool_parameters.cpu_count);
+    ASSERT_IS_NULL(captured_worker_pool_parameters.cpus);
+    ASSERT_ARE_EQUAL(uint32_t, DEFAULT_IDLE_TIMEOUT_MS, captured_worker_pool_parameters.idle_timeout_ms);
+    ASSERT_ARE_EQUAL(uint32_t, DEFAULT_MAX_INJECTED_THREAD_COUNT, captured_worker_pool_parameters.max_injected_thread_count);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_013: [ execution_engine_parameters shall be interpreted as EXECUTION_ENGINE_PARAMETERS_LINUX. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_015: [ If max_outstanding_io is 0, execution_engine_create shall not limit the number of outstanding file I/Os. ]*/
+TEST_FUNCTION(execution_engine_create_with_0_max_outstanding_io_succeeds)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    EXECUTION_ENGINE_PARAMETERS_LINUX parameters = { DEFAULT_MIN_THREAD_COUNT, DEFAULT_MAX_THREAD_COUNT, 0, DEFAULT_STACK_SIZE, 0, NULL };
+
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count());
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(worker_pool_linux_create(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, LAZY_INIT_NOT_DONE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, LAZY_INIT_NOT_DONE));
+
+    // act
+    execution_engine = execution_engine_create(&parameters);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(execution_engine);
+    ASSERT_IS_NULL(execution_engine_linux_get_io_admission(execution_engine));
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_013: [ execution_engine_parameters shall be interpreted as EXECUTION_ENGINE_PARAMETERS_LINUX. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_014: [ If max_outstanding_io is not 0, execution_engine_create shall create an admission bounding the outstanding file I/Os of the execution engine by calling io_admission_create with max_outstanding_io. ]*/
+TEST_FUNCTION(execution_engine_create_with_max_outstanding_io_creates_the_admission)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    EXECUTION_ENGINE_PARAMETERS_LINUX parameters = { DEFAULT_MIN_THREAD_COUNT, DEFAULT_MAX_THREAD_COUNT, 16, DEFAULT_STACK_SIZE, 0, NULL };
+
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count());
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(worker_pool_linux_create(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_create(16));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, LAZY_INIT_NOT_DONE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, LAZY_INIT_NOT_DONE));
+
+    // act
+    execution_engine = execution_engine_create(&parameters);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(execution_engine);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_013: [ execution_engine_parameters shall be interpreted as EXECUTION_ENGINE_PARAMETERS_LINUX. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_019: [ execution_engine_create shall create the worker threads of the execution engine by calling worker_pool_linux_create with min_thread_count, max_thread_count, stack_size, cpu_count, cpus, idle_timeout_ms and max_injected_thread_count. ]*/
+TEST_FUNCTION(execution_engine_create_passes_the_thread_parameters_to_the_worker_pool)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    uint32_t cpus[] = { 2, 3 };
+    EXECUTION_ENGINE_PARAMETERS_LINUX parameters = { 1, 8, 0, 256 * 1024, 2, cpus, 5000, 3 };
+
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count());
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(worker_pool_linux_create(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, LAZY_INIT_NOT_DONE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, LAZY_INIT_NOT_DONE));
+
+    // act
+    execution_engine = execution_engine_create(&parameters);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(execution_engine);
+    ASSERT_ARE_EQUAL(uint32_t, 1, captured_worker_pool_parameters.min_thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, 8, captured_worker_pool_parameters.max_thread_count);
+    ASSERT_ARE_EQUAL(size_t, 256 * 1024, captured_worker_pool_parameters.stack_size);
+    ASSERT_ARE_EQUAL(uint32_t, 2, captured_worker_pool_parameters.cpu_count);
+    ASSERT_ARE_EQUAL(void_ptr, cpus, captured_worker_pool_parameters.cpus);
+    ASSERT_ARE_EQUAL(uint32_t, 5000, captured_worker_pool_parameters.idle_timeout_ms);
+    ASSERT_ARE_EQUAL(uint32_t, 3, captured_worker_pool_parameters.max_injected_thread_count);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_031: [ If there is more than one NUMA node, execution_engine_create shall allocate a NUMA node worker group for each node. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_032: [ execution_engine_create shall not create the worker threads of the NUMA nodes, they are created on first use. ]*/
+TEST_FUNCTION(execution_engine_create_on_a_NUMA_host_does_not_create_the_worker_threads_of_the_nodes)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count())
+        .SetReturn(2);
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(worker_pool_linux_create(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, LAZY_INIT_NOT_DONE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, LAZY_INIT_NOT_DONE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, LAZY_INIT_NOT_DONE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, LAZY_INIT_NOT_DONE));
+
+    // act
+    execution_engine = execution_engine_create(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(execution_engine);
+    ASSERT_ARE_EQUAL(uint32_t, DEFAULT_MIN_THREAD_COUNT, captured_worker_pool_parameters.min_thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, 0, captured_worker_pool_parameters.cpu_count);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_003: [ If any error occurs, execution_engine_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_worker_pool_linux_create_fails_execution_engine_create_fails)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count());
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(worker_pool_linux_create(IGNORED_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    execution_engine = execution_engine_create(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_003: [ If any error occurs, execution_engine_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_io_admission_create_fails_execution_engine_create_fails)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    EXECUTION_ENGINE_PARAMETERS_LINUX parameters = { DEFAULT_MIN_THREAD_COUNT, DEFAULT_MAX_THREAD_COUNT, 16, DEFAULT_STACK_SIZE, 0, NULL };
+
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count());
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(worker_pool_linux_create(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_create(16))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(worker_pool_linux_destroy(test_worker_pool));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    execution_engine = execution_engine_create(&parameters);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_003: [ If any error occurs, execution_engine_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_execution_engine_create_fails)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count());
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    // act
+    execution_engine = execution_engine_create(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(execution_engine);
+}
+
+/* execution_engine_dec_ref */
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_005: [ If execution_engine is NULL, execution_engine_dec_ref shall return. ]*/
+TEST_FUNCTION(execution_engine_dec_ref_with_NULL_execution_engine_returns)
+{
+    // arrange
+
+    // act
+    execution_engine_dec_ref(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_006: [ Otherwise execution_engine_dec_ref shall decrement the refcount. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_007: [ If the refcount is zero execution_engine_dec_ref shall destroy the I/O ring if it was created and free the execution engine. ]*/
+TEST_FUNCTION(execution_engine_dec_ref_frees_the_resources_when_the_ring_was_not_created)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_destroy(test_worker_pool));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    execution_engine_dec_ref(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_007: [ If the refcount is zero execution_engine_dec_ref shall destroy the I/O ring if it was created and free the execution engine. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_020: [ If the refcount is zero execution_engine_dec_ref shall destroy the worker threads by calling worker_pool_linux_destroy after destroying the I/O ring. ]*/
+TEST_FUNCTION(execution_engine_dec_ref_destroys_the_ring)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine();
+    ASSERT_ARE_EQUAL(void_ptr, test_io_ring, execution_engine_linux_get_io_ring(execution_engine));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_destroy(test_io_ring));
+    STRICT_EXPECTED_CALL(worker_pool_linux_destroy(test_worker_pool));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    execution_engine_dec_ref(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_024: [ If the refcount is zero execution_engine_dec_ref shall destroy the timer wheel if it was created, before destroying the worker threads. ]*/
+TEST_FUNCTION(execution_engine_dec_ref_destroys_the_timer_wheel)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine();
+    ASSERT_ARE_EQUAL(void_ptr, test_timer_wheel, execution_engine_linux_get_timer_wheel(execution_engine));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_destroy(test_timer_wheel));
+    STRICT_EXPECTED_CALL(worker_pool_linux_destroy(test_worker_pool));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    execution_engine_dec_ref(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_016: [ If the refcount is zero execution_engine_dec_ref shall destroy the admission if it was created. ]*/
+TEST_FUNCTION(execution_engine_dec_ref_destroys_the_admission)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_io_limit();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_destroy(test_worker_pool));
+    STRICT_EXPECTED_CALL(io_admission_destroy(test_io_admission));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    execution_engine_dec_ref(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_033: [ If the refcount is zero execution_engine_dec_ref shall destroy the worker threads of the NUMA nodes that were created by calling worker_pool_linux_destroy. ]*/
+TEST_FUNCTION(execution_engine_dec_ref_destroys_the_worker_threads_of_the_NUMA_nodes_that_were_created)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_numa_nodes(3, DEFAULT_MIN_THREAD_COUNT, DEFAULT_MAX_THREAD_COUNT);
+    ASSERT_ARE_EQUAL(void_ptr, test_numa_node_worker_pool, execution_engine_linux_get_numa_node_worker_pool(execution_engine, 1));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_destroy(test_numa_node_worker_pool));
+    STRICT_EXPECTED_CALL(worker_pool_linux_destroy(test_worker_pool));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    execution_engine_dec_ref(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_006: [ Otherwise execution_engine_dec_ref shall decrement the refcount. ]*/
+TEST_FUNCTION(execution_engine_dec_ref_does_not_free_when_refcount_is_not_zero)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine();
+    execution_engine_inc_ref(execution_engine);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+
+    // act
+    execution_engine_dec_ref(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* execution_engine_inc_ref */
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_03_001: [ If execution_engine is NULL then execution_engine_inc_ref shall return. ]*/
+TEST_FUNCTION(execution_engine_inc_ref_with_NULL_execution_engine_returns)
+{
+    // arrange
+
+    // act
+    execution_engine_inc_ref(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_03_002: [ Otherwise execution_engine_inc_ref shall increment the reference count for execution_engine. ]*/
+TEST_FUNCTION(execution_engine_inc_ref_increments_the_refcount)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+
+    // act
+    execution_engine_inc_ref(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* execution_engine_linux_get_io_ring */
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_009: [ If execution_engine is NULL, execution_engine_linux_get_io_ring shall fail and return NULL. ]*/
+TEST_FUNCTION(execution_engine_linux_get_io_ring_with_NULL_execution_engine_fails)
+{
+    // arrange
+
+    // act
+    IO_RING_LINUX_HANDLE io_ring = execution_engine_linux_get_io_ring(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(io_ring);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_010: [ execution_engine_linux_get_io_ring shall call lazy_init to create the I/O ring only once. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_008: [ The first call to execution_engine_linux_get_io_ring shall create the ring by calling io_ring_linux_create with IO_RING_LINUX_DEFAULT_ENTRIES. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_012: [ Otherwise execution_engine_linux_get_io_ring shall return the I/O ring handle. ]*/
+TEST_FUNCTION(execution_engine_linux_get_io_ring_creates_the_ring)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine();
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, execution_engine));
+    STRICT_EXPECTED_CALL(io_ring_linux_create(IO_RING_LINUX_DEFAULT_ENTRIES));
+
+    // act
+    IO_RING_LINUX_HANDLE io_ring = execution_engine_linux_get_io_ring(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, test_io_ring, io_ring);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_011: [ If lazy_init fails, execution_engine_linux_get_io_ring shall fail and return NULL. ]*/
+TEST_FUNCTION(when_io_ring_linux_create_fails_execution_engine_linux_get_io_ring_fails)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine();
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, execution_engine));
+    STRICT_EXPECTED_CALL(io_ring_linux_create(IO_RING_LINUX_DEFAULT_ENTRIES))
+        .SetReturn(NULL);
+
+    // act
+    IO_RING_LINUX_HANDLE io_ring = execution_engine_linux_get_io_ring(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(io_ring);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* execution_engine_linux_get_io_admission */
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_017: [ If execution_engine is NULL, execution_engine_linux_get_io_admission shall fail and return NULL. ]*/
+TEST_FUNCTION(execution_engine_linux_get_io_admission_with_NULL_execution_engine_fails)
+{
+    // arrange
+
+    // act
+    IO_ADMISSION_HANDLE io_admission = execution_engine_linux_get_io_admission(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(io_admission);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_018: [ Otherwise execution_engine_linux_get_io_admission shall return the admission created in execution_engine_create, or NULL if max_outstanding_io was 0. ]*/
+TEST_FUNCTION(execution_engine_linux_get_io_admission_returns_the_admission)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_io_limit();
+
+    // act
+    IO_ADMISSION_HANDLE io_admission = execution_engine_linux_get_io_admission(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, test_io_admission, io_admission);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_018: [ Otherwise execution_engine_linux_get_io_admission shall return the admission created in execution_engine_create, or NULL if max_outstanding_io was 0. ]*/
+TEST_FUNCTION(execution_engine_linux_get_io_admission_without_a_limit_returns_NULL)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine();
+
+    // act
+    IO_ADMISSION_HANDLE io_admission = execution_engine_linux_get_io_admission(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(io_admission);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* execution_engine_linux_get_worker_pool */
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_021: [ If execution_engine is NULL, execution_engine_linux_get_worker_pool shall fail and return NULL. ]*/
+TEST_FUNCTION(execution_engine_linux_get_worker_pool_with_NULL_execution_engine_fails)
+{
+    // arrange
+
+    // act
+    WORKER_POOL_LINUX_HANDLE worker_pool = execution_engine_linux_get_worker_pool(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(worker_pool);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_022: [ Otherwise execution_engine_linux_get_worker_pool shall return the worker pool created in execution_engine_create. ]*/
+TEST_FUNCTION(execution_engine_linux_get_worker_pool_returns_the_worker_pool)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine();
+
+    // act
+    WORKER_POOL_LINUX_HANDLE worker_pool = execution_engine_linux_get_worker_pool(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, test_worker_pool, worker_pool);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* execution_engine_linux_get_timer_wheel */
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_025: [ If execution_engine is NULL, execution_engine_linux_get_timer_wheel shall fail and return NULL. ]*/
+TEST_FUNCTION(execution_engine_linux_get_timer_wheel_with_NULL_execution_engine_fails)
+{
+    // arrange
+
+    // act
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = execution_engine_linux_get_timer_wheel(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(timer_wheel);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_027: [ execution_engine_linux_get_timer_wheel shall call lazy_init to create the timer wheel only once. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_026: [ The first call to execution_engine_linux_get_timer_wheel shall create the timer wheel by calling timer_wheel_linux_create with the worker pool of the execution engine. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_029: [ Otherwise execution_engine_linux_get_timer_wheel shall return the timer wheel handle. ]*/
+TEST_FUNCTION(execution_engine_linux_get_timer_wheel_creates_the_timer_wheel)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine();
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, execution_engine));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_create(test_worker_pool));
+
+    // act
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = execution_engine_linux_get_timer_wheel(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, test_timer_wheel, timer_wheel);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_028: [ If lazy_init fails, execution_engine_linux_get_timer_wheel shall fail and return NULL. ]*/
+TEST_FUNCTION(when_timer_wheel_linux_create_fails_execution_engine_linux_get_timer_wheel_fails)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine();
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, execution_engine));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_create(test_worker_pool))
+        .SetReturn(NULL);
+
+    // act
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = execution_engine_linux_get_timer_wheel(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(timer_wheel);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* execution_engine_linux_get_numa_node_worker_pool */
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_034: [ If execution_engine is NULL, execution_engine_linux_get_numa_node_worker_pool shall fail and return NULL. ]*/
+TEST_FUNCTION(execution_engine_linux_get_numa_node_worker_pool_with_NULL_execution_engine_fails)
+{
+    // arrange
+
+    // act
+    WORKER_POOL_LINUX_HANDLE worker_pool = execution_engine_linux_get_numa_node_worker_pool(NULL, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(worker_pool);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_035: [ If numa_node is greater than or equal to the number of NUMA nodes, execution_engine_linux_get_numa_node_worker_pool shall fail and return NULL. ]*/
+TEST_FUNCTION(execution_engine_linux_get_numa_node_worker_pool_with_node_1_on_a_non_NUMA_host_fails)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine();
+
+    // act
+    WORKER_POOL_LINUX_HANDLE worker_pool = execution_engine_linux_get_numa_node_worker_pool(execution_engine, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(worker_pool);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_035: [ If numa_node is greater than or equal to the number of NUMA nodes, execution_engine_linux_get_numa_node_worker_pool shall fail and return NULL. ]*/
+TEST_FUNCTION(execution_engine_linux_get_numa_node_worker_pool_with_node_equal_to_the_node_count_fails)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_numa_nodes(2, DEFAULT_MIN_THREAD_COUNT, DEFAULT_MAX_THREAD_COUNT);
+
+    // act
+    WORKER_POOL_LINUX_HANDLE worker_pool = execution_engine_linux_get_numa_node_worker_pool(execution_engine, 2);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(worker_pool);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_039: [ If there is only one NUMA node, execution_engine_linux_get_numa_node_worker_pool shall return the worker pool created in execution_engine_create. ]*/
+TEST_FUNCTION(execution_engine_linux_get_numa_node_worker_pool_on_a_non_NUMA_host_returns_the_worker_pool)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine();
+
+    // act
+    WORKER_POOL_LINUX_HANDLE worker_pool = execution_engine_linux_get_numa_node_worker_pool(execution_engine, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, test_worker_pool, worker_pool);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_040: [ Otherwise execution_engine_linux_get_numa_node_worker_pool shall call lazy_init to create the worker threads of the node only once. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_036: [ The first call for a node shall obtain the CPUs of the node by calling sysinfo_linux_get_numa_node_cpus with room for as many CPUs as returned by sysinfo_get_processor_count. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_037: [ The first call for a node shall create the worker threads of the node by calling worker_pool_linux_create with the CPUs of the node, stack_size, idle_timeout_ms and min_thread_count, max_thread_count and max_injected_thread_count divided by the number of nodes, rounded up. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_038: [ The CPUs of the node shall be freed once the worker threads of the node are created. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_042: [ Otherwise execution_engine_linux_get_numa_node_worker_pool shall return the worker pool of the node. ]*/
+TEST_FUNCTION(execution_engine_linux_get_numa_node_worker_pool_creates_the_worker_threads_of_the_node)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_numa_nodes(2, DEFAULT_MIN_THREAD_COUNT, DEFAULT_MAX_THREAD_COUNT);
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(sysinfo_get_processor_count());
+    STRICT_EXPECTED_CALL(malloc(TEST_PROCESSOR_COUNT * sizeof(uint32_t)));
+    STRICT_EXPECTED_CALL(sysinfo_linux_get_numa_node_cpus(1, IGNORED_ARG, TEST_PROCESSOR_COUNT, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_create(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    WORKER_POOL_LINUX_HANDLE worker_pool = execution_engine_linux_get_numa_node_worker_pool(execution_engine, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, test_numa_node_worker_pool, worker_pool);
+    ASSERT_ARE_EQUAL(uint32_t, DEFAULT_MIN_THREAD_COUNT / 2, captured_worker_pool_parameters.min_thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, 0, captured_worker_pool_parameters.max_thread_count);
+    ASSERT_ARE_EQUAL(size_t, DEFAULT_STACK_SIZE, captured_worker_pool_parameters.stack_size);
+    ASSERT_ARE_EQUAL(uint32_t, DEFAULT_IDLE_TIMEOUT_MS, captured_worker_pool_parameters.idle_timeout_ms);
+    ASSERT_ARE_EQUAL(uint32_t, 2, captured_worker_pool_parameters.max_injected_thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, 4, captured_worker_pool_parameters.cpu_count);
+    ASSERT_ARE_EQUAL(uint32_t, 4, captured_worker_pool_cpus[0]);
+    ASSERT_ARE_EQUAL(uint32_t, 5, captured_worker_pool_cpus[1]);
+    ASSERT_ARE_EQUAL(uint32_t, 6, captured_worker_pool_cpus[2]);
+    ASSERT_ARE_EQUAL(uint32_t, 7, captured_worker_pool_cpus[3]);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_037: [ The first call for a node shall create the worker threads of the node by calling worker_pool_linux_create with the CPUs of the node, stack_size, idle_timeout_ms and min_thread_count, max_thread_count and max_injected_thread_count divided by the number of nodes, rounded up. ]*/
+TEST_FUNCTION(execution_engine_linux_get_numa_node_worker_pool_rounds_up_the_thread_counts_of_the_node)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_numa_nodes(4, 5, 9);
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(sysinfo_get_processor_count());
+    STRICT_EXPECTED_CALL(malloc(TEST_PROCESSOR_COUNT * sizeof(uint32_t)));
+    STRICT_EXPECTED_CALL(sysinfo_linux_get_numa_node_cpus(3, IGNORED_ARG, TEST_PROCESSOR_COUNT, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_create(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    WORKER_POOL_LINUX_HANDLE worker_pool = execution_engine_linux_get_numa_node_worker_pool(execution_engine, 3);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, test_numa_node_worker_pool, worker_pool);
+    ASSERT_ARE_EQUAL(uint32_t, 2, captured_worker_pool_parameters.min_thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, 3, captured_worker_pool_parameters.max_thread_count);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_LINUX_01_041: [ If lazy_init fails, execution_engine_linux_get_numa_node_worker_pool shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_execution_engine_linux_get_numa_node_worker_pool_fails)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_numa_nodes(2, DEFAULT_MIN_THREAD_COUNT, DEFAULT_MAX_THREAD_COUNT);
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(sysinfo_get_processor_count());
+    STRICT_EXPECTED_CALL(malloc(TEST_PROCESSOR_COUNT * sizeof(uint32_t)));
+    STRICT_EXPECTED_CALL(sysinfo_linux_get_numa_node_cpus(1, IGNORED_ARG, TEST_PROCESSOR_COUNT, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_create(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG))
+        .CallCannotFail();
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            WORKER_POOL_LINUX_HANDLE worker_pool = execution_engine_linux_get_numa_node_worker_pool(execution_engine, 1);
+
+            // assert
+            ASSERT_IS_NULL(worker_pool, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
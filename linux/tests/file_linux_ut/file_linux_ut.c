@@ -0,0 +1,7618 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <linux/falloc.h>
+#include <linux/fs.h>
+#include <linux/io_uring.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "real_gballoc_ll.h"
+static void* real_malloc(size_t size)
+{
+    return real_gballoc_ll_malloc(size);
+}
+
+static void real_free(void* ptr)
+{
+    real_gballoc_ll_free(ptr);
+}
+
+#include "testrunnerswitcher.h"
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes_bool.h"
+#include "umock_c/umocktypes_charptr.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umock_c_negative_tests.h"
+
+#define ENABLE_MOCKS
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sync.h"
+#include "c_pal/execution_engine.h"
+#include "c_pal/execution_engine_linux.h"
+#include "c_pal/io_ring_linux.h"
+#include "c_pal/io_context_pool.h"
+#include "c_pal/write_aggregator.h"
+#include "c_pal/read_ahead.h"
+#include "c_pal/io_admission.h"
+#include "mock_file.h"
+
+MOCKABLE_FUNCTION(, void, mock_user_callback, void*, user_context, bool, is_successful);
+
+#undef ENABLE_MOCKS
+
+#include "real_gballoc_hl.h"
+#include "real_interlocked.h"
+#include "real_sync.h"
+
+#include "c_pal/file.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+TEST_DEFINE_ENUM_TYPE(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_RESULT)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_VALUES)
+
+TEST_DEFINE_ENUM_TYPE(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_RESULT)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_VALUES)
+
+IMPLEMENT_UMOCK_C_ENUM_TYPE(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_RESULT_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(READ_AHEAD_MODE, READ_AHEAD_MODE_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_RESULT_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(IO_ADMISSION_RESULT, IO_ADMISSION_RESULT_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+#define TEST_FILE_FLAGS (O_CREAT | O_RDWR | O_DIRECT | O_LARGEFILE)
+#define TEST_FILE_MODE (S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP)
+
+static int fake_fd = 42;
+static EXECUTION_ENGINE_HANDLE fake_execution_engine = (EXECUTION_ENGINE_HANDLE)0x4243;
+static IO_RING_LINUX_HANDLE fake_io_ring = (IO_RING_LINUX_HANDLE)0x4244;
+static IO_CONTEXT_POOL_HANDLE test_io_context_pool = (IO_CONTEXT_POOL_HANDLE)0x4246;
+
+static unsigned char test_mapping[16384];
+static off_t test_file_size = 1024 * 1024;
+
+#define TEST_PREALLOCATION_CHUNK_SIZE (1024 * 1024)
+
+#define TEST_MAX_AGGREGATED_SIZE (64 * 1024)
+#define TEST_MAX_DELAY_MS 10
+
+static WRITE_AGGREGATOR_HANDLE test_write_aggregator = (WRITE_AGGREGATOR_HANDLE)0x4247;
+static WRITE_AGGREGATOR_ISSUE_IO captured_issue_io;
+static WRITE_AGGREGATOR_START_TIMER captured_start_timer;
+static WRITE_AGGREGATOR_SET_FILE_SIZE captured_set_file_size;
+static void* captured_write_aggregator_context;
+
+#define TEST_READ_AHEAD_BLOCK_SIZE (64 * 1024)
+#define TEST_READ_AHEAD_BLOCK_COUNT 4
+
+static READ_AHEAD_HANDLE test_read_ahead = (READ_AHEAD_HANDLE)0x4248;
+static READ_AHEAD_ISSUE_IO captured_read_ahead_issue_io;
+static void* captured_read_ahead_context;
+
+#define TEST_MAX_OUTSTANDING_IO 16
+
+#define TEST_COPY_CHUNK_SIZE (1024 * 1024)
+#define TEST_COPY_SOURCE_POSITION (16 * 4096)
+#define TEST_COPY_DESTINATION_POSITION (32 * 4096)
+#define TEST_FIRST_PIPE_FD 100
+#define TEST_FD_PATH "/proc/self/fd/42"
+#define TEST_BUFFERED_SOURCE_FD 60
+#define TEST_BUFFERED_DESTINATION_FD 61
+
+static int next_fake_pipe_fd;
+static struct file_clone_range captured_clone_range;
+static ssize_t copy_file_range_result; /*bytes copied by each call of copy_file_range, or -1 to fail with copy_file_range_errno*/
+static int copy_file_range_errno;
+static loff_t captured_copy_file_range_source_offset; /*offsets passed to the last call of copy_file_range*/
+static loff_t captured_copy_file_range_destination_offset;
+
+static WORKER_POOL_LINUX_HANDLE test_worker_pool = (WORKER_POOL_LINUX_HANDLE)0x424B;
+static WORKER_POOL_LINUX_WORK_ITEM* captured_work_item;
+#define TEST_IOPRIO_LOW ((2 << 13) | 7) /*IOPRIO_PRIO_VALUE(IOPRIO_CLASS_BE, 7)*/
+
+static IO_ADMISSION_HANDLE test_io_admission = (IO_ADMISSION_HANDLE)0x4249;
+static IO_ADMISSION_HANDLE test_engine_io_admission = (IO_ADMISSION_HANDLE)0x424A;
+static IO_ADMISSION_WAITER* captured_admission_waiter;
+
+static IO_RING_LINUX_SQE captured_sqe;
+static IO_RING_LINUX_SQE previous_captured_sqe;
+static IO_RING_LINUX_SQE captured_sqes[4];
+
+static int hook_io_ring_linux_submit(IO_RING_LINUX_HANDLE io_ring, const IO_RING_LINUX_SQE* sqes, uint32_t sqe_count, uint32_t* submitted_count)
+{
+    (void)io_ring;
+    previous_captured_sqe = captured_sqe;
+    captured_sqe = sqes[0];
+    for (uint32_t i = 0; (i < sqe_count) && (i < sizeof(captured_sqes) / sizeof(captured_sqes[0])); i++)
+    {
+        captured_sqes[i] = sqes[i];
+    }
+    *submitted_count = sqe_count;
+    return 0;
+}
+
+static int hook_io_ring_linux_submit_only_first_entry(IO_RING_LINUX_HANDLE io_ring, const IO_RING_LINUX_SQE* sqes, uint32_t sqe_count, uint32_t* submitted_count)
+{
+    (void)hook_io_ring_linux_submit(io_ring, sqes, 1, submitted_count);
+    return (sqe_count == 1) ? 0 : MU_FAILURE;
+}
+
+static void* hook_io_context_pool_get(IO_CONTEXT_POOL_HANDLE pool, size_t size)
+{
+    (void)pool;
+    return real_malloc(size);
+}
+
+static void hook_io_context_pool_release(IO_CONTEXT_POOL_HANDLE pool, void* context)
+{
+    (void)pool;
+    real_free(context);
+}
+
+static WRITE_AGGREGATOR_HANDLE hook_write_aggregator_create(uint32_t alignment, uint32_t max_aggregated_size, uint32_t max_delay_ms, uint64_t file_size, WRITE_AGGREGATOR_ISSUE_IO issue_io, WRITE_AGGREGATOR_START_TIMER start_timer, WRITE_AGGREGATOR_SET_FILE_SIZE set_file_size, void* context)
+{
+    (void)alignment;
+    (void)max_aggregated_size;
+    (void)max_delay_ms;
+    (void)file_size;
+    captured_issue_io = issue_io;
+    captured_start_timer = start_timer;
+    captured_set_file_size = set_file_size;
+    captured_write_aggregator_context = context;
+    return test_write_aggregator;
+}
+
+static READ_AHEAD_HANDLE hook_read_ahead_create(uint32_t alignment, uint32_t block_size, uint32_t block_count, READ_AHEAD_ISSUE_IO issue_io, void* context)
+{
+    (void)alignment;
+    (void)block_size;
+    (void)block_count;
+    captured_read_ahead_issue_io = issue_io;
+    captured_read_ahead_context = context;
+    return test_read_ahead;
+}
+
+static int hook_mock_pipe2(int* pipefd, int flags)
+{
+    (void)flags;
+    pipefd[0] = next_fake_pipe_fd++;
+    pipefd[1] = next_fake_pipe_fd++;
+    return 0;
+}
+
+static int hook_mock_ioctl(int fd, unsigned long request, void* argp)
+{
+    (void)fd;
+    (void)request;
+    captured_clone_range = *(struct file_clone_range*)argp;
+    return 0;
+}
+
+static ssize_t hook_mock_copy_file_range(int fd_in, loff_t* off_in, int fd_out, loff_t* off_out, size_t len, unsigned int flags)
+{
+    ssize_t result;
+    (void)fd_in;
+    (void)fd_out;
+    (void)flags;
+    captured_copy_file_range_source_offset = *off_in;
+    captured_copy_file_range_destination_offset = *off_out;
+    if (copy_file_range_result < 0)
+    {
+        errno = copy_file_range_errno;
+        result = -1;
+    }
+    else
+    {
+        result = ((size_t)copy_file_range_result < len) ? copy_file_range_result : (ssize_t)len;
+        *off_in += result;
+        *off_out += result;
+    }
+    return result;
+}
+
+static int hook_worker_pool_linux_submit(WORKER_POOL_LINUX_HANDLE worker_pool, WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    (void)worker_pool;
+    captured_work_item = work_item;
+    return 0;
+}
+
+static int hook_mock_fstat(int fd, struct stat* statbuf)
+{
+    (void)fd;
+    (void)memset(statbuf, 0, sizeof(struct stat));
+    statbuf->st_size = test_file_size;
+    return 0;
+}
+
+static FILE_HANDLE get_file_handle_with_engine_io_admission(const char* filename, IO_ADMISSION_HANDLE engine_io_admission)
+{
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(execution_engine_inc_ref(fake_execution_engine));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_io_ring(fake_execution_engine));
+    STRICT_EXPECTED_CALL(io_context_pool_create(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_open(filename, TEST_FILE_FLAGS, TEST_FILE_MODE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_io_admission(fake_execution_engine))
+        .SetReturn(engine_io_admission);
+
+    FILE_HANDLE file_handle = file_create(fake_execution_engine, filename, NULL, NULL);
+
+    ASSERT_IS_NOT_NULL(file_handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+    return file_handle;
+}
+
+static FILE_HANDLE get_file_handle(const char* filename)
+{
+    return get_file_handle_with_engine_io_admission(filename, NULL);
+}
+
+static void destroy_file_handle(FILE_HANDLE file_handle)
+{
+    umock_c_reset_all_calls();
+    file_destroy(file_handle);
+    umock_c_reset_all_calls();
+}
+
+static FILE_HANDLE start_file_write_async(unsigned char* buffer, uint32_t size, uint64_t position, void* user_context)
+{
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, buffer, size, position, mock_user_callback, user_context));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+    return file_handle;
+}
+
+static void start_file_flush_async(FILE_HANDLE file_handle, void* user_context)
+{
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ASSERT_ARE_EQUAL(int, 0, file_flush_async(file_handle, mock_user_callback, user_context));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+}
+
+static FILE_HANDLE get_file_handle_with_preallocation(uint64_t chunk_size)
+{
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(mock_fstat(fake_fd, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, test_file_size));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+
+    ASSERT_ARE_EQUAL(int, 0, file_set_preallocation(file_handle, chunk_size));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+    return file_handle;
+}
+
+static void setup_preallocation_expected_calls(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+}
+
+static void assert_fallocate_sqe(uint64_t offset, uint64_t length)
+{
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_FALLOCATE, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(int32_t, fake_fd, captured_sqe.fd);
+    ASSERT_ARE_EQUAL(uint64_t, offset, captured_sqe.offset);
+    ASSERT_ARE_EQUAL(uint64_t, length, (uint64_t)(uintptr_t)captured_sqe.address);
+    ASSERT_ARE_EQUAL(uint32_t, FALLOC_FL_KEEP_SIZE, captured_sqe.length);
+    ASSERT_IS_NOT_NULL(captured_sqe.io);
+}
+
+static FILE_HANDLE get_file_handle_with_write_aggregation(void)
+{
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(mock_fstat(fake_fd, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_create(4096, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, test_file_size, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, file_handle));
+
+    ASSERT_ARE_EQUAL(int, 0, file_set_write_aggregation(file_handle, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+    return file_handle;
+}
+
+static void start_aggregated_write(WRITE_AGGREGATOR_IO* aggregated_io)
+{
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ASSERT_ARE_EQUAL(int, 0, captured_issue_io(captured_write_aggregator_context, aggregated_io));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+}
+
+static void start_aggregation_timer_on_ring(uint32_t delay_ms, uint64_t timer_id)
+{
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ASSERT_ARE_EQUAL(int, 0, captured_start_timer(captured_write_aggregator_context, delay_ms, timer_id));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+}
+
+static FILE_HANDLE get_file_handle_with_read_ahead(void)
+{
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(read_ahead_create(4096, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT, IGNORED_ARG, file_handle));
+
+    ASSERT_ARE_EQUAL(int, 0, file_set_read_ahead(file_handle, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+    return file_handle;
+}
+
+static void start_read_ahead(READ_AHEAD_IO* read_ahead_io)
+{
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ASSERT_ARE_EQUAL(int, 0, captured_read_ahead_issue_io(captured_read_ahead_context, read_ahead_io));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+}
+
+static FILE_HANDLE get_file_handle_with_io_limit(IO_ADMISSION_HANDLE engine_io_admission, uint32_t max_outstanding_io, FILE_IO_LIMIT_MODE mode)
+{
+    FILE_HANDLE file_handle = get_file_handle_with_engine_io_admission("test_file.txt", engine_io_admission);
+
+    if (max_outstanding_io != 0)
+    {
+        STRICT_EXPECTED_CALL(io_admission_create(max_outstanding_io));
+    }
+
+    ASSERT_ARE_EQUAL(int, 0, file_set_io_limit(file_handle, max_outstanding_io, mode));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+    return file_handle;
+}
+
+static FILE_BATCH_HANDLE get_batch(FILE_HANDLE file_handle, uint32_t max_io_count)
+{
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    FILE_BATCH_HANDLE batch = file_batch_begin(file_handle, max_io_count);
+
+    ASSERT_IS_NOT_NULL(batch);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+    return batch;
+}
+
+static void setup_copy_range_async_expected_calls(void)
+{
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_worker_pool(fake_execution_engine));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG));
+}
+
+/*starts a copy of size bytes, which only submits its work item to the worker pool*/
+static void start_copy(FILE_HANDLE source, uint64_t source_position, FILE_HANDLE destination, uint64_t destination_position, uint64_t size)
+{
+    setup_copy_range_async_expected_calls();
+
+    ASSERT_ARE_EQUAL(int, 0, file_copy_range_async(source, source_position, destination, destination_position, size, mock_user_callback, (void*)0x4245));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_work_item);
+    umock_c_reset_all_calls();
+}
+
+/*runs the work item of the copy, as a worker thread of the worker pool would*/
+static void run_copy_work_item(void)
+{
+    captured_work_item->work_function(captured_work_item->work_function_context);
+}
+
+static void setup_copy_through_pipes_expected_calls(uint32_t lane_count)
+{
+    STRICT_EXPECTED_CALL(mock_ioctl(fake_fd, FICLONERANGE, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_copy_file_range(fake_fd, IGNORED_ARG, fake_fd, IGNORED_ARG, IGNORED_ARG, 0));
+    for (uint32_t i = 0; i < lane_count; i++)
+    {
+        STRICT_EXPECTED_CALL(mock_pipe2(IGNORED_ARG, O_CLOEXEC));
+        STRICT_EXPECTED_CALL(mock_fcntl(TEST_FIRST_PIPE_FD + (int)(2 * i) + 1, F_SETPIPE_SZ, TEST_COPY_CHUNK_SIZE));
+    }
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, (int32_t)lane_count));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, lane_count, IGNORED_ARG));
+}
+
+/*starts a copy of size bytes that goes through lane_count pipes and returns the IO_RING_LINUX_IO of each lane*/
+static void start_copy_through_pipes(FILE_HANDLE source, FILE_HANDLE destination, uint64_t size, uint32_t lane_count, IO_RING_LINUX_IO** lane_ios)
+{
+    start_copy(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, size);
+    setup_copy_through_pipes_expected_calls(lane_count);
+
+    run_copy_work_item();
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    for (uint32_t i = 0; i < lane_count; i++)
+    {
+        lane_ios[i] = captured_sqes[i].io;
+    }
+    umock_c_reset_all_calls();
+}
+
+/*fails the splice in flight on each lane, which ends the copy*/
+static void end_copy_with_failure(IO_RING_LINUX_IO** lane_ios, uint32_t lane_count)
+{
+    for (uint32_t i = 0; i < lane_count; i++)
+    {
+        lane_ios[i]->on_io_complete(lane_ios[i]->on_io_complete_context, -EIO);
+    }
+}
+
+static void assert_splice_to_pipe_sqe(const IO_RING_LINUX_SQE* sqe, uint64_t source_offset, int pipe_write_fd, uint32_t length)
+{
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_SPLICE, sqe->opcode);
+    ASSERT_ARE_EQUAL(int32_t, fake_fd, sqe->splice_fd_in);
+    ASSERT_ARE_EQUAL(uint64_t, source_offset, sqe->splice_offset_in);
+    ASSERT_ARE_EQUAL(int32_t, pipe_write_fd, sqe->fd);
+    ASSERT_ARE_EQUAL(uint64_t, UINT64_MAX, sqe->offset);
+    ASSERT_ARE_EQUAL(uint32_t, length, sqe->length);
+    ASSERT_IS_NOT_NULL(sqe->io);
+}
+
+static void assert_splice_from_pipe_sqe(const IO_RING_LINUX_SQE* sqe, int pipe_read_fd, uint64_t destination_offset, uint32_t length)
+{
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_SPLICE, sqe->opcode);
+    ASSERT_ARE_EQUAL(int32_t, pipe_read_fd, sqe->splice_fd_in);
+    ASSERT_ARE_EQUAL(uint64_t, UINT64_MAX, sqe->splice_offset_in);
+    ASSERT_ARE_EQUAL(int32_t, fake_fd, sqe->fd);
+    ASSERT_ARE_EQUAL(uint64_t, destination_offset, sqe->offset);
+    ASSERT_ARE_EQUAL(uint32_t, length, sqe->length);
+    ASSERT_IS_NOT_NULL(sqe->io);
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error));
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_bool_register_types());
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_charptr_register_types());
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+
+    REGISTER_GLOBAL_MOCK_HOOK(malloc, real_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
+    REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
+    REGISTER_SYNC_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_HOOK(io_ring_linux_submit, hook_io_ring_linux_submit);
+    REGISTER_GLOBAL_MOCK_HOOK(io_context_pool_get, hook_io_context_pool_get);
+    REGISTER_GLOBAL_MOCK_HOOK(io_context_pool_release, hook_io_context_pool_release);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_fstat, hook_mock_fstat);
+    REGISTER_GLOBAL_MOCK_HOOK(write_aggregator_create, hook_write_aggregator_create);
+    REGISTER_GLOBAL_MOCK_HOOK(read_ahead_create, hook_read_ahead_create);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_pipe2, hook_mock_pipe2);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_ioctl, hook_mock_ioctl);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_copy_file_range, hook_mock_copy_file_range);
+    REGISTER_GLOBAL_MOCK_HOOK(worker_pool_linux_submit, hook_worker_pool_linux_submit);
+
+    REGISTER_UMOCK_ALIAS_TYPE(EXECUTION_ENGINE_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_RING_LINUX_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_CONTEXT_POOL_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_CONTEXT_POOL_STATISTICS*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(mode_t, unsigned int);
+    REGISTER_UMOCK_ALIAS_TYPE(off_t, int64_t);
+    REGISTER_UMOCK_ALIAS_TYPE(loff_t*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(ssize_t, int64_t);
+    REGISTER_UMOCK_ALIAS_TYPE(WORKER_POOL_LINUX_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(WORKER_POOL_LINUX_WORK_ITEM*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(WRITE_AGGREGATOR_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(WRITE_AGGREGATOR_IO*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(WRITE_AGGREGATOR_ISSUE_IO, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(WRITE_AGGREGATOR_START_TIMER, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(WRITE_AGGREGATOR_SET_FILE_SIZE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(WRITE_AGGREGATOR_WRITE_CB, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(READ_AHEAD_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(READ_AHEAD_IO*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(READ_AHEAD_ISSUE_IO, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(READ_AHEAD_READ_CB, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_ADMISSION_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_ADMISSION_WAITER*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_ADMISSION_STATISTICS*, void*);
+
+    REGISTER_TYPE(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_RESULT);
+    REGISTER_TYPE(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_RESULT);
+    REGISTER_TYPE(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_RESULT);
+    REGISTER_TYPE(READ_AHEAD_MODE, READ_AHEAD_MODE);
+    REGISTER_TYPE(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_RESULT);
+    REGISTER_TYPE(IO_ADMISSION_RESULT, IO_ADMISSION_RESULT);
+
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(execution_engine_linux_get_io_ring, fake_io_ring, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_open, fake_fd, -1);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_close, 0, -1);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(io_ring_linux_submit, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_RETURNS(io_context_pool_create, test_io_context_pool, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(io_context_pool_get, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(io_context_pool_get_statistics, 0, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mock_fstat, -1);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_mmap, test_mapping, MAP_FAILED);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_munmap, 0, -1);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_madvise, 0, -1);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(write_aggregator_create, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(read_ahead_create, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(io_admission_create, test_io_admission, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mock_pipe2, -1);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mock_ioctl, -1);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_fcntl, 0, -1);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mock_copy_file_range, -1);
+    REGISTER_GLOBAL_MOCK_RETURNS(execution_engine_linux_get_worker_pool, test_worker_pool, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(worker_pool_linux_submit, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_ftruncate, 0, -1);
+}
+
+TEST_SUITE_CLEANUP(TestClassCleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(f)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("our mutex is ABANDONED. Failure in test framework");
+    }
+    umock_c_reset_all_calls();
+    ASSERT_ARE_EQUAL(int, 0, umock_c_negative_tests_init());
+
+    next_fake_pipe_fd = TEST_FIRST_PIPE_FD;
+    copy_file_range_result = -1;
+    copy_file_range_errno = EXDEV;
+    captured_work_item = NULL;
+}
+
+TEST_FUNCTION_CLEANUP(cleans)
+{
+    umock_c_negative_tests_deinit();
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/*Tests_SRS_FILE_LINUX_43_037: [ If execution_engine is NULL, file_create shall fail and return NULL. ]*/
+TEST_FUNCTION(file_create_fails_on_null_execution_engine)
+{
+    ///act
+    FILE_HANDLE return_value = file_create(NULL, "file.txt", NULL, NULL);
+
+    ///assert
+    ASSERT_IS_NULL(return_value);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_LINUX_43_038: [ If full_file_name is NULL then file_create shall fail and return NULL. ]*/
+TEST_FUNCTION(file_create_fails_on_null_full_file_name)
+{
+    ///act
+    FILE_HANDLE return_value = file_create(fake_execution_engine, NULL, NULL, NULL);
+
+    ///assert
+    ASSERT_IS_NULL(return_value);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_LINUX_43_050: [ If full_file_name is an empty string, file_create shall fail and return NULL. ]*/
+TEST_FUNCTION(file_create_fails_on_empty_full_file_name)
+{
+    ///act
+    FILE_HANDLE return_value = file_create(fake_execution_engine, "", NULL, NULL);
+
+    ///assert
+    ASSERT_IS_NULL(return_value);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_LINUX_43_029: [ file_create shall allocate a FILE_HANDLE. ]*/
+/*Tests_SRS_FILE_LINUX_01_001: [ file_create shall increment the reference count of execution_engine in order to hold on to it. ]*/
+/*Tests_SRS_FILE_LINUX_01_002: [ file_create shall obtain the I/O ring of the execution engine by calling execution_engine_linux_get_io_ring. ]*/
+/*Tests_SRS_FILE_LINUX_01_043: [ file_create shall create a pool of I/O contexts by calling io_context_pool_create with a context size that fits an I/O with up to FILE_LINUX_POOLED_IOVEC_COUNT buffers and FILE_LINUX_IO_CONTEXT_POOL_SIZE as the maximum number of cached contexts. ]*/
+/*Tests_SRS_FILE_LINUX_43_001: [ file_create shall call open with full_file_name as pathname and flags O_CREAT, O_RDWR, O_DIRECT and O_LARGEFILE. ]*/
+/*Tests_SRS_FILE_LINUX_43_002: [ file_create shall return the file handle returned by the call to open.]*/
+/*Tests_SRS_FILE_LINUX_01_049: [ file_create shall initialize the list of flush requests as empty and mark the flush as not in progress. ]*/
+/*Tests_SRS_FILE_LINUX_01_182: [ file_create shall obtain the I/O limit of the execution engine by calling execution_engine_linux_get_io_admission and set no I/O limit on the file handle, with the mode FILE_IO_LIMIT_MODE_QUEUE. ]*/
+TEST_FUNCTION(file_create_succeeds)
+{
+    ///arrange
+    const char* filename = "test_file.txt";
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(execution_engine_inc_ref(fake_execution_engine));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_io_ring(fake_execution_engine));
+    STRICT_EXPECTED_CALL(io_context_pool_create(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_open(filename, TEST_FILE_FLAGS, TEST_FILE_MODE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_io_admission(fake_execution_engine));
+
+    ///act
+    FILE_HANDLE file_handle = file_create(fake_execution_engine, filename, NULL, NULL);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(file_handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_003: [ If there are any failures, file_create shall fail and return NULL. ]*/
+TEST_FUNCTION(file_create_fails_when_underlying_functions_fail)
+{
+    ///arrange
+    const char* filename = "test_file.txt";
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(execution_engine_inc_ref(fake_execution_engine))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_io_ring(fake_execution_engine));
+    STRICT_EXPECTED_CALL(io_context_pool_create(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_open(filename, TEST_FILE_FLAGS, TEST_FILE_MODE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_io_admission(fake_execution_engine))
+        .CallCannotFail();
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            FILE_HANDLE file_handle = file_create(fake_execution_engine, filename, NULL, NULL);
+
+            ///assert
+            ASSERT_IS_NULL(file_handle, "On failed call %zu", i);
+        }
+    }
+}
+
+/*Tests_SRS_FILE_LINUX_43_036: [ If handle is NULL, file_destroy shall return. ]*/
+TEST_FUNCTION(file_destroy_with_null_handle_returns)
+{
+    ///act
+    file_destroy(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_LINUX_01_004: [ file_destroy shall wait for the number of pending I/O operations to reach 0 by calling wait_on_address. ]*/
+/*Tests_SRS_FILE_LINUX_43_003: [ file_destroy shall call close with fd as handle.]*/
+/*Tests_SRS_FILE_LINUX_01_044: [ file_destroy shall destroy the I/O context pool. ]*/
+/*Tests_SRS_FILE_LINUX_01_005: [ file_destroy shall decrement the reference count for the execution engine. ]*/
+/*Tests_SRS_FILE_LINUX_43_030: [ file_destroy shall free the FILE_HANDLE. ]*/
+TEST_FUNCTION(file_destroy_succeeds)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_close(fake_fd));
+    STRICT_EXPECTED_CALL(io_context_pool_destroy(test_io_context_pool));
+    STRICT_EXPECTED_CALL(execution_engine_dec_ref(fake_execution_engine));
+    STRICT_EXPECTED_CALL(free(file_handle));
+
+    ///act
+    file_destroy(file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_LINUX_43_031: [ If handle is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_fails_with_null_handle)
+{
+    ///arrange
+    unsigned char source[4096];
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(NULL, source, sizeof(source), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_LINUX_43_032: [ If source is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_fails_with_null_source)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, NULL, 4096, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_43_033: [ If user_callback is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_fails_with_null_user_callback)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 0, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_43_051: [ If position + size is greater than INT64_MAX, then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_fails_if_position_plus_size_is_greater_than_INT64_MAX)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), INT64_MAX, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_43_048: [ If size is 0 then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_fails_if_size_is_zero)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, 0, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_43_019: [ file_write_async shall get a struct to hold handle, source, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_LINUX_01_006: [ file_write_async shall increment the number of pending I/O operations. ]*/
+/*Tests_SRS_FILE_LINUX_01_007: [ file_write_async shall call io_ring_linux_submit with a IORING_OP_WRITE entry for the file descriptor, source, size and position. ]*/
+/*Tests_SRS_FILE_LINUX_43_007: [ If io_ring_linux_submit succeeds, file_write_async shall return FILE_WRITE_ASYNC_OK. ]*/
+/*Tests_SRS_FILE_LINUX_01_083: [ file_create shall set no preallocation policy on the file handle. ]*/
+/*Tests_SRS_FILE_LINUX_01_084: [ If no preallocation policy is set on handle, preallocate_ahead_if_needed shall return. ]*/
+/*Tests_SRS_FILE_LINUX_01_101: [ file_create shall set no write aggregation policy on the file handle. ]*/
+/*Tests_SRS_FILE_LINUX_01_107: [ If no write aggregation policy is set or write_aggregator_add returns WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, file_write_async shall issue the write by itself. ]*/
+/*Tests_SRS_FILE_LINUX_01_190: [ file_create shall set the io_uring priority of the file handle to 0 and its admission priority to IO_ADMISSION_PRIORITY_NORMAL. ]*/
+TEST_FUNCTION(file_write_async_succeeds)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 8192, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITE, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(int32_t, fake_fd, captured_sqe.fd);
+    ASSERT_ARE_EQUAL(uint64_t, 8192, captured_sqe.offset);
+    ASSERT_ARE_EQUAL(void_ptr, source, captured_sqe.address);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(source), captured_sqe.length);
+    ASSERT_ARE_EQUAL(uint16_t, 0, captured_sqe.ioprio);
+    ASSERT_IS_NOT_NULL(captured_sqe.io);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_43_012: [ If io_ring_linux_submit fails, file_write_async shall decrement the number of pending I/O operations and return FILE_WRITE_ASYNC_WRITE_ERROR. ]*/
+TEST_FUNCTION(file_write_async_fails_when_io_ring_linux_submit_fails)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_WRITE_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_43_013: [ If there are any other failures, file_write_async shall return FILE_WRITE_ASYNC_ERROR. ]*/
+TEST_FUNCTION(file_write_async_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_43_034: [ If handle is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_read_async_fails_with_null_handle)
+{
+    ///arrange
+    unsigned char destination[4096];
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(NULL, destination, sizeof(destination), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_LINUX_43_043: [ If destination is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_read_async_fails_with_null_destination)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, NULL, 4096, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_43_035: [ If user_callback is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_read_async_fails_with_null_user_callback)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 0, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_43_052: [ If size is 0 then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_read_async_fails_if_size_is_zero)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, 0, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_43_045: [ file_read_async shall get a struct to hold handle, destination, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_LINUX_01_008: [ file_read_async shall increment the number of pending I/O operations. ]*/
+/*Tests_SRS_FILE_LINUX_01_009: [ file_read_async shall call io_ring_linux_submit with a IORING_OP_READ entry for the file descriptor, destination, size and position. ]*/
+/*Tests_SRS_FILE_LINUX_43_014: [ If io_ring_linux_submit succeeds, file_read_async shall return FILE_READ_ASYNC_OK. ]*/
+TEST_FUNCTION(file_read_async_succeeds)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 4096, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_READ, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(int32_t, fake_fd, captured_sqe.fd);
+    ASSERT_ARE_EQUAL(uint64_t, 4096, captured_sqe.offset);
+    ASSERT_ARE_EQUAL(void_ptr, destination, captured_sqe.address);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(destination), captured_sqe.length);
+    ASSERT_IS_NOT_NULL(captured_sqe.io);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(destination));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_43_011: [ If io_ring_linux_submit fails, file_read_async shall decrement the number of pending I/O operations and return FILE_READ_ASYNC_READ_ERROR. ]*/
+TEST_FUNCTION(file_read_async_fails_when_io_ring_linux_submit_fails)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_READ_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_43_015: [ If there are any failures, file_read_async shall return FILE_READ_ASYNC_ERROR. ]*/
+TEST_FUNCTION(file_read_async_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_010: [ on_file_io_complete_linux shall recover the file handle, the number of bytes requested by the user, user_callback and user_context from context. ]*/
+/*Tests_SRS_FILE_LINUX_01_045: [ on_file_io_complete_linux shall release context to the I/O context pool of the file handle. ]*/
+/*Tests_SRS_FILE_LINUX_01_011: [ on_file_io_complete_linux shall call user_callback with is_successful as true if and only if io_result is equal to the number of bytes requested by the user. ]*/
+/*Tests_SRS_FILE_LINUX_01_013: [ on_file_io_complete_linux shall decrement the number of pending I/O operations and wake up file_destroy if it reaches 0. ]*/
+TEST_FUNCTION(on_file_io_complete_linux_calls_callback_with_true_when_all_bytes_were_transferred)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = start_file_write_async(source, sizeof(source), 0, (void*)0x4245);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_012: [ If io_result is negative or not equal to the number of bytes requested by the user, on_file_io_complete_linux shall call user_callback with is_successful as false. ]*/
+TEST_FUNCTION(on_file_io_complete_linux_calls_callback_with_false_when_not_all_bytes_were_transferred)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = start_file_write_async(source, sizeof(source), 0, (void*)0x4245);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 512);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_012: [ If io_result is negative or not equal to the number of bytes requested by the user, on_file_io_complete_linux shall call user_callback with is_successful as false. ]*/
+TEST_FUNCTION(on_file_io_complete_linux_calls_callback_with_false_when_io_failed)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = start_file_write_async(source, sizeof(source), 0, (void*)0x4245);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, -EIO);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_write_async_v */
+
+/*Tests_SRS_FILE_01_001: [ If handle is NULL then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_v_fails_with_null_handle)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_BUFFER buffers[1] = { { source, sizeof(source) } };
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(NULL, buffers, 1, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_002: [ If buffers is NULL then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_v_fails_with_null_buffers)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, NULL, 1, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_003: [ If buffer_count is 0 then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_v_fails_with_zero_buffer_count)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_BUFFER buffers[1] = { { source, sizeof(source) } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 0, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_014: [ If buffer_count is greater than IOV_MAX then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_v_fails_when_buffer_count_is_greater_than_IOV_MAX)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_BUFFER buffers[1] = { { source, sizeof(source) } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, IOV_MAX + 1, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_004: [ If user_callback is NULL then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_v_fails_with_null_user_callback)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_BUFFER buffers[1] = { { source, sizeof(source) } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 1, 0, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_005: [ If any of the buffers has a NULL buffer or a length of 0 then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_v_fails_when_a_buffer_is_NULL)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_BUFFER buffers[2] = { { source, sizeof(source) }, { NULL, sizeof(source) } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_005: [ If any of the buffers has a NULL buffer or a length of 0 then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_v_fails_when_a_buffer_length_is_zero)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_BUFFER buffers[2] = { { source, sizeof(source) }, { source, 0 } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_006: [ If the sum of the buffer lengths is greater than UINT32_MAX then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_v_fails_when_the_sum_of_the_lengths_exceeds_UINT32_MAX)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_BUFFER buffers[2] = { { source, UINT32_MAX }, { source, 1 } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_007: [ If position + the sum of the buffer lengths is greater than INT64_MAX, then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_v_fails_if_position_plus_size_is_greater_than_INT64_MAX)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_BUFFER buffers[2] = { { source, 2048 }, { source + 2048, 2048 } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, INT64_MAX - 2048, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_015: [ file_write_async_v shall get a struct to hold handle, an iovec for each buffer, the sum of the buffer lengths, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_LINUX_01_016: [ file_write_async_v shall increment the number of pending I/O operations. ]*/
+/*Tests_SRS_FILE_LINUX_01_017: [ file_write_async_v shall prepare a IORING_OP_WRITEV entry for the file descriptor, the iovecs, buffer_count and position. ]*/
+/*Tests_SRS_FILE_LINUX_01_020: [ If start_io succeeds, file_write_async_v shall return FILE_WRITE_ASYNC_OK. ]*/
+TEST_FUNCTION(file_write_async_v_succeeds)
+{
+    ///arrange
+    unsigned char header[512];
+    unsigned char payload[4096];
+    unsigned char trailer[512];
+    FILE_BUFFER buffers[3] = { { header, sizeof(header) }, { payload, sizeof(payload) }, { trailer, sizeof(trailer) } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 3, 8192, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITEV, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(int32_t, fake_fd, captured_sqe.fd);
+    ASSERT_ARE_EQUAL(uint64_t, 8192, captured_sqe.offset);
+    ASSERT_ARE_EQUAL(uint32_t, 3, captured_sqe.length);
+    const struct iovec* iovecs = captured_sqe.address;
+    ASSERT_ARE_EQUAL(void_ptr, header, iovecs[0].iov_base);
+    ASSERT_ARE_EQUAL(size_t, sizeof(header), iovecs[0].iov_len);
+    ASSERT_ARE_EQUAL(void_ptr, payload, iovecs[1].iov_base);
+    ASSERT_ARE_EQUAL(size_t, sizeof(payload), iovecs[1].iov_len);
+    ASSERT_ARE_EQUAL(void_ptr, trailer, iovecs[2].iov_base);
+    ASSERT_ARE_EQUAL(size_t, sizeof(trailer), iovecs[2].iov_len);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(header) + sizeof(payload) + sizeof(trailer));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_010: [ file_write_async_v shall call user_callback passing user_context and is_successful as true if and only if all the bytes of all the buffers were written. ]*/
+TEST_FUNCTION(file_write_async_v_completion_with_all_bytes_calls_callback_with_true)
+{
+    ///arrange
+    unsigned char header[512];
+    unsigned char payload[4096];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(header) + sizeof(payload));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_010: [ file_write_async_v shall call user_callback passing user_context and is_successful as true if and only if all the bytes of all the buffers were written. ]*/
+TEST_FUNCTION(file_write_async_v_completion_with_partial_write_calls_callback_with_false)
+{
+    ///arrange
+    unsigned char header[512];
+    unsigned char payload[4096];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(header));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_018: [ If start_io returns FILE_LINUX_START_IO_SUBMIT_ERROR, file_write_async_v shall decrement the number of pending I/O operations, release the context and return FILE_WRITE_ASYNC_WRITE_ERROR. ]*/
+TEST_FUNCTION(file_write_async_v_fails_when_io_ring_linux_submit_fails)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_BUFFER buffers[2] = { { source, 2048 }, { source + 2048, 2048 } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_WRITE_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_019: [ If there are any other failures, file_write_async_v shall return FILE_WRITE_ASYNC_ERROR. ]*/
+TEST_FUNCTION(file_write_async_v_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_BUFFER buffers[2] = { { source, 2048 }, { source + 2048, 2048 } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_read_async_v */
+
+/*Tests_SRS_FILE_01_013: [ If handle is NULL then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_read_async_v_fails_with_null_handle)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_BUFFER buffers[1] = { { destination, sizeof(destination) } };
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async_v(NULL, buffers, 1, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_014: [ If buffers is NULL then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_read_async_v_fails_with_null_buffers)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async_v(file_handle, NULL, 1, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_015: [ If buffer_count is 0 then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_read_async_v_fails_with_zero_buffer_count)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_BUFFER buffers[1] = { { destination, sizeof(destination) } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async_v(file_handle, buffers, 0, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_021: [ If buffer_count is greater than IOV_MAX then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_read_async_v_fails_when_buffer_count_is_greater_than_IOV_MAX)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_BUFFER buffers[1] = { { destination, sizeof(destination) } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async_v(file_handle, buffers, IOV_MAX + 1, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_016: [ If user_callback is NULL then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_read_async_v_fails_with_null_user_callback)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_BUFFER buffers[1] = { { destination, sizeof(destination) } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async_v(file_handle, buffers, 1, 0, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_017: [ If any of the buffers has a NULL buffer or a length of 0 then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_read_async_v_fails_when_a_buffer_length_is_zero)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_BUFFER buffers[2] = { { destination, 0 }, { destination, sizeof(destination) } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_018: [ If the sum of the buffer lengths is greater than UINT32_MAX then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_read_async_v_fails_when_the_sum_of_the_lengths_exceeds_UINT32_MAX)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_BUFFER buffers[2] = { { destination, 1 }, { destination, UINT32_MAX } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_022: [ file_read_async_v shall get a struct to hold handle, an iovec for each buffer, the sum of the buffer lengths, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_LINUX_01_023: [ file_read_async_v shall increment the number of pending I/O operations. ]*/
+/*Tests_SRS_FILE_LINUX_01_024: [ file_read_async_v shall prepare a IORING_OP_READV entry for the file descriptor, the iovecs, buffer_count and position. ]*/
+/*Tests_SRS_FILE_LINUX_01_027: [ If start_io succeeds, file_read_async_v shall return FILE_READ_ASYNC_OK. ]*/
+TEST_FUNCTION(file_read_async_v_succeeds)
+{
+    ///arrange
+    unsigned char header[512];
+    unsigned char payload[4096];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async_v(file_handle, buffers, 2, 4096, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_READV, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(int32_t, fake_fd, captured_sqe.fd);
+    ASSERT_ARE_EQUAL(uint64_t, 4096, captured_sqe.offset);
+    ASSERT_ARE_EQUAL(uint32_t, 2, captured_sqe.length);
+    const struct iovec* iovecs = captured_sqe.address;
+    ASSERT_ARE_EQUAL(void_ptr, header, iovecs[0].iov_base);
+    ASSERT_ARE_EQUAL(size_t, sizeof(header), iovecs[0].iov_len);
+    ASSERT_ARE_EQUAL(void_ptr, payload, iovecs[1].iov_base);
+    ASSERT_ARE_EQUAL(size_t, sizeof(payload), iovecs[1].iov_len);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(header) + sizeof(payload));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_025: [ If start_io returns FILE_LINUX_START_IO_SUBMIT_ERROR, file_read_async_v shall decrement the number of pending I/O operations, release the context and return FILE_READ_ASYNC_READ_ERROR. ]*/
+TEST_FUNCTION(file_read_async_v_fails_when_io_ring_linux_submit_fails)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_BUFFER buffers[2] = { { destination, 2048 }, { destination + 2048, 2048 } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_READ_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_026: [ If there are any other failures, file_read_async_v shall return FILE_READ_ASYNC_ERROR. ]*/
+TEST_FUNCTION(file_read_async_v_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_BUFFER buffers[2] = { { destination, 2048 }, { destination + 2048, 2048 } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_batch_begin */
+
+/*Tests_SRS_FILE_01_024: [ If handle is NULL then file_batch_begin shall fail and return NULL. ]*/
+TEST_FUNCTION(file_batch_begin_fails_with_null_handle)
+{
+    ///act
+    FILE_BATCH_HANDLE batch = file_batch_begin(NULL, 4);
+
+    ///assert
+    ASSERT_IS_NULL(batch);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_025: [ If max_io_count is 0 then file_batch_begin shall fail and return NULL. ]*/
+TEST_FUNCTION(file_batch_begin_fails_with_zero_max_io_count)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_BATCH_HANDLE batch = file_batch_begin(file_handle, 0);
+
+    ///assert
+    ASSERT_IS_NULL(batch);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_026: [ file_batch_begin shall create a batch that can hold up to max_io_count I/Os and return it. ]*/
+/*Tests_SRS_FILE_LINUX_01_028: [ file_batch_begin shall allocate a batch with room for max_io_count submission queue entries. ]*/
+TEST_FUNCTION(file_batch_begin_succeeds)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    ///act
+    FILE_BATCH_HANDLE batch = file_batch_begin(file_handle, 4);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(batch);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_027: [ If there are any failures, file_batch_begin shall fail and return NULL. ]*/
+/*Tests_SRS_FILE_LINUX_01_029: [ If there are any failures, file_batch_begin shall fail and return NULL. ]*/
+TEST_FUNCTION(file_batch_begin_fails_when_malloc_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    FILE_BATCH_HANDLE batch = file_batch_begin(file_handle, 4);
+
+    ///assert
+    ASSERT_IS_NULL(batch);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_batch_add_write */
+
+/*Tests_SRS_FILE_01_028: [ If batch is NULL then file_batch_add_write shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_write_fails_with_null_batch)
+{
+    ///arrange
+    unsigned char source[4096];
+
+    ///act
+    int result = file_batch_add_write(NULL, source, sizeof(source), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_029: [ If source is NULL then file_batch_add_write shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_write_fails_with_null_source)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    ///act
+    int result = file_batch_add_write(batch, NULL, 4096, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_030: [ If size is 0 then file_batch_add_write shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_write_fails_with_zero_size)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    ///act
+    int result = file_batch_add_write(batch, source, 0, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_031: [ If user_callback is NULL then file_batch_add_write shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_write_fails_with_null_user_callback)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    ///act
+    int result = file_batch_add_write(batch, source, sizeof(source), 0, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_032: [ If position + size is greater than INT64_MAX then file_batch_add_write shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_write_fails_if_position_plus_size_is_greater_than_INT64_MAX)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    ///act
+    int result = file_batch_add_write(batch, source, sizeof(source), INT64_MAX, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_033: [ If batch already holds max_io_count I/Os then file_batch_add_write shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_write_fails_when_the_batch_is_full)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 1);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, NULL));
+    umock_c_reset_all_calls();
+
+    ///act
+    int result = file_batch_add_write(batch, source, sizeof(source), 4096, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_034: [ file_batch_add_write shall queue in batch a write request to write source's content to the position offset in the file. ]*/
+/*Tests_SRS_FILE_LINUX_01_030: [ file_batch_add_write shall get a struct to hold the file handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_01_036: [ file_batch_add_write shall succeed and return 0. ]*/
+TEST_FUNCTION(file_batch_add_write_succeeds)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    int result = file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_035: [ If there are any other failures, file_batch_add_write shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_032: [ If there are any failures, file_batch_add_write shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_write_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    int result = file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/* file_batch_add_read */
+
+/*Tests_SRS_FILE_01_037: [ If batch is NULL then file_batch_add_read shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_read_fails_with_null_batch)
+{
+    ///arrange
+    unsigned char destination[4096];
+
+    ///act
+    int result = file_batch_add_read(NULL, destination, sizeof(destination), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_038: [ If destination is NULL then file_batch_add_read shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_read_fails_with_null_destination)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    ///act
+    int result = file_batch_add_read(batch, NULL, 4096, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_039: [ If size is 0 then file_batch_add_read shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_read_fails_with_zero_size)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    ///act
+    int result = file_batch_add_read(batch, destination, 0, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_040: [ If user_callback is NULL then file_batch_add_read shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_read_fails_with_null_user_callback)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    ///act
+    int result = file_batch_add_read(batch, destination, sizeof(destination), 0, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_041: [ If batch already holds max_io_count I/Os then file_batch_add_read shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_read_fails_when_the_batch_is_full)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 1);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 0, mock_user_callback, NULL));
+    umock_c_reset_all_calls();
+
+    ///act
+    int result = file_batch_add_read(batch, destination, sizeof(destination), 4096, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_042: [ file_batch_add_read shall queue in batch a read request to read handle's content at the position offset into destination. ]*/
+/*Tests_SRS_FILE_LINUX_01_033: [ file_batch_add_read shall get a struct to hold the file handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_01_044: [ file_batch_add_read shall succeed and return 0. ]*/
+TEST_FUNCTION(file_batch_add_read_succeeds)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    int result = file_batch_add_read(batch, destination, sizeof(destination), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_043: [ If there are any other failures, file_batch_add_read shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_035: [ If there are any failures, file_batch_add_read shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_read_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    int result = file_batch_add_read(batch, destination, sizeof(destination), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/* file_batch_submit */
+
+/*Tests_SRS_FILE_01_045: [ If batch is NULL then file_batch_submit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_submit_fails_with_null_batch)
+{
+    ///arrange
+    uint32_t submitted_count;
+
+    ///act
+    int result = file_batch_submit(NULL, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_046: [ If submitted_count is NULL then file_batch_submit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_submit_fails_with_null_submitted_count)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    ///act
+    int result = file_batch_submit(batch, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_047: [ If batch holds no I/Os then file_batch_submit shall set submitted_count to 0, free batch and return 0. ]*/
+TEST_FUNCTION(file_batch_submit_with_an_empty_batch_succeeds)
+{
+    ///arrange
+    uint32_t submitted_count = 42;
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, submitted_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_048: [ file_batch_submit shall issue all the I/Os queued in batch, in the order in which they were added. ]*/
+/*Tests_SRS_FILE_LINUX_01_031: [ file_batch_add_write shall fill the next entry of the batch with IORING_OP_WRITE for the file descriptor, source, size and position. ]*/
+/*Tests_SRS_FILE_LINUX_01_034: [ file_batch_add_read shall fill the next entry of the batch with IORING_OP_READ for the file descriptor, destination, size and position. ]*/
+/*Tests_SRS_FILE_LINUX_01_036: [ file_batch_submit shall add the number of I/Os in the batch to the number of pending I/O operations. ]*/
+/*Tests_SRS_FILE_LINUX_01_037: [ file_batch_submit shall call io_ring_linux_submit once with the entries of all the I/Os of the batch that hold their slots. ]*/
+/*Tests_SRS_FILE_01_051: [ file_batch_submit shall free batch. ]*/
+/*Tests_SRS_FILE_LINUX_01_039: [ file_batch_submit shall free the batch. ]*/
+/*Tests_SRS_FILE_01_052: [ On success file_batch_submit shall set submitted_count to the number of I/Os in batch and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_040: [ If all the I/Os of the batch were submitted or queued, file_batch_submit shall set submitted_count to the number of I/Os in the batch and return 0. ]*/
+TEST_FUNCTION(file_batch_submit_submits_all_the_ios_at_once)
+{
+    ///arrange
+    unsigned char source[4096];
+    unsigned char destination[8192];
+    uint32_t submitted_count = 0;
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 4096, mock_user_callback, (void*)0x4245));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 16384, mock_user_callback, (void*)0x4246));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 2, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, submitted_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITE, captured_sqes[0].opcode);
+    ASSERT_ARE_EQUAL(int32_t, fake_fd, captured_sqes[0].fd);
+    ASSERT_ARE_EQUAL(uint64_t, 4096, captured_sqes[0].offset);
+    ASSERT_ARE_EQUAL(void_ptr, source, captured_sqes[0].address);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(source), captured_sqes[0].length);
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_READ, captured_sqes[1].opcode);
+    ASSERT_ARE_EQUAL(int32_t, fake_fd, captured_sqes[1].fd);
+    ASSERT_ARE_EQUAL(uint64_t, 16384, captured_sqes[1].offset);
+    ASSERT_ARE_EQUAL(void_ptr, destination, captured_sqes[1].address);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(destination), captured_sqes[1].length);
+
+    ///cleanup
+    captured_sqes[0].io->on_io_complete(captured_sqes[0].io->on_io_complete_context, sizeof(source));
+    captured_sqes[1].io->on_io_complete(captured_sqes[1].io->on_io_complete_context, sizeof(destination));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_049: [ file_batch_submit shall call the user_callback of each issued I/O passing its user_context and is_successful as true if and only if all its bytes were transferred. ]*/
+TEST_FUNCTION(file_batch_submit_calls_each_user_callback_when_its_io_completes)
+{
+    ///arrange
+    unsigned char source[4096];
+    unsigned char destination[8192];
+    uint32_t submitted_count = 0;
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 4096, mock_user_callback, (void*)0x4245));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 16384, mock_user_callback, (void*)0x4246));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_submit(batch, &submitted_count));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4246, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqes[1].io->on_io_complete(captured_sqes[1].io->on_io_complete_context, 4096);
+    captured_sqes[0].io->on_io_complete(captured_sqes[0].io->on_io_complete_context, sizeof(source));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_050: [ If issuing an I/O fails, file_batch_submit shall not issue the I/Os that follow it, discard all the I/Os that were not issued without calling their user_callback, set submitted_count to the number of issued I/Os and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_038: [ If io_ring_linux_submit fails, file_batch_submit shall release the slots and the structs of the I/Os that were not submitted to the I/O context pool, subtract their number from the number of pending I/O operations (waking up file_destroy if it reaches 0), set submitted_count to the number of submitted I/Os and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_submit_fails_when_io_ring_linux_submit_fails)
+{
+    ///arrange
+    unsigned char source[4096];
+    uint32_t submitted_count = 42;
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, NULL));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 4096, mock_user_callback, NULL));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 2, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, -2));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, submitted_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_038: [ If io_ring_linux_submit fails, file_batch_submit shall release the slots and the structs of the I/Os that were not submitted to the I/O context pool, subtract their number from the number of pending I/O operations (waking up file_destroy if it reaches 0), set submitted_count to the number of submitted I/Os and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_submit_frees_only_the_ios_that_were_not_submitted)
+{
+    ///arrange
+    unsigned char source[4096];
+    uint32_t submitted_count = 42;
+    uint32_t ring_submitted_count = 1;
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, (void*)0x4245));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 4096, mock_user_callback, NULL));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 8192, mock_user_callback, NULL));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 3));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 3, IGNORED_ARG))
+        .CopyOutArgumentBuffer_submitted_count(&ring_submitted_count, sizeof(ring_submitted_count))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, -2));
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///arrange
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqes[0].io->on_io_complete(captured_sqes[0].io->on_io_complete_context, sizeof(source));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_batch_cancel */
+
+/*Tests_SRS_FILE_01_053: [ If batch is NULL then file_batch_cancel shall return. ]*/
+/*Tests_SRS_FILE_LINUX_01_041: [ If batch is NULL then file_batch_cancel shall return. ]*/
+TEST_FUNCTION(file_batch_cancel_with_null_batch_returns)
+{
+    ///act
+    file_batch_cancel(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_054: [ file_batch_cancel shall discard all the I/Os queued in batch without calling their user_callback and free batch. ]*/
+/*Tests_SRS_FILE_LINUX_01_042: [ file_batch_cancel shall release the structs of all the I/Os in the batch to the I/O context pool and free the batch. ]*/
+TEST_FUNCTION(file_batch_cancel_frees_the_ios_and_the_batch)
+{
+    ///arrange
+    unsigned char source[4096];
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, NULL));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 0, mock_user_callback, NULL));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    file_batch_cancel(batch);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_flush_async */
+
+/*Tests_SRS_FILE_01_058: [ If handle is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_050: [ If handle is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_flush_async_fails_with_null_handle)
+{
+    ///act
+    int result = file_flush_async(NULL, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_059: [ If user_callback is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_051: [ If user_callback is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_flush_async_fails_with_null_user_callback)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_flush_async(file_handle, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_063: [ If there are any other failures, file_flush_async shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_053: [ If there are any failures, file_flush_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_flush_async_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    int result = file_flush_async(file_handle, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_052: [ file_flush_async shall get a flush request to hold user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_LINUX_01_054: [ file_flush_async shall increment the number of pending I/O operations. ]*/
+/*Tests_SRS_FILE_LINUX_01_055: [ file_flush_async shall add the request to the list of flush requests of handle by calling interlocked_compare_exchange_pointer. ]*/
+/*Tests_SRS_FILE_LINUX_01_056: [ file_flush_async shall start a flush. ]*/
+/*Tests_SRS_FILE_LINUX_01_058: [ To start a flush, file_flush_async shall mark the flush as in progress, and if another flush is already in progress it shall return, leaving the requests to be served by the next flush. ]*/
+/*Tests_SRS_FILE_LINUX_01_059: [ file_flush_async shall take all the requests from the list of flush requests. ]*/
+/*Tests_SRS_FILE_LINUX_01_061: [ file_flush_async shall increment the number of pending I/O operations for the flush and prepare an IORING_OP_FSYNC entry for the file descriptor with IORING_FSYNC_DATASYNC as flags. ]*/
+/*Tests_SRS_FILE_01_064: [ file_flush_async shall succeed and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_057: [ file_flush_async shall succeed and return 0. ]*/
+TEST_FUNCTION(file_flush_async_submits_an_fsync)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    int result = file_flush_async(file_handle, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_FSYNC, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(int32_t, fake_fd, captured_sqe.fd);
+    ASSERT_ARE_EQUAL(uint32_t, IORING_FSYNC_DATASYNC, captured_sqe.op_flags);
+    ASSERT_IS_NOT_NULL(captured_sqe.io);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 0);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_061: [ A flush of the file shall serve all the file_flush_async requests that were queued when the flush started. ]*/
+/*Tests_SRS_FILE_LINUX_01_058: [ To start a flush, file_flush_async shall mark the flush as in progress, and if another flush is already in progress it shall return, leaving the requests to be served by the next flush. ]*/
+TEST_FUNCTION(file_flush_async_while_a_flush_is_in_progress_only_queues_the_request)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    start_file_flush_async(file_handle, (void*)0x4245);
+    IO_RING_LINUX_IO* flush_io = captured_sqe.io;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+
+    ///act
+    int result = file_flush_async(file_handle, mock_user_callback, (void*)0x4246);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    flush_io->on_io_complete(flush_io->on_io_complete_context, 0);
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 0);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_062: [ If flushing the file fails, file_flush_async shall call user_callback with is_successful as false. ]*/
+/*Tests_SRS_FILE_LINUX_01_062: [ If start_io fails, file_flush_async shall call the user_callback of all the taken requests with is_successful as false, release them to the I/O context pool, decrement the number of pending I/O operations for each of them and for the flush and mark the flush as not in progress. ]*/
+/*Tests_SRS_FILE_LINUX_01_060: [ If there are no requests, file_flush_async shall mark the flush as not in progress and try again if a request was added in the meantime. ]*/
+TEST_FUNCTION(file_flush_async_when_io_ring_linux_submit_fails_calls_user_callback_with_false)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL));
+
+    ///act
+    int result = file_flush_async(file_handle, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* on_file_flush_complete_linux */
+
+/*Tests_SRS_FILE_01_060: [ file_flush_async shall call user_callback with is_successful as true once the data of all the writes that completed before file_flush_async was called is durable. ]*/
+/*Tests_SRS_FILE_LINUX_01_063: [ on_file_flush_complete_linux shall call the user_callback of all the requests served by the flush, in the order in which file_flush_async was called, with is_successful as true if and only if io_result is 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_064: [ on_file_flush_complete_linux shall release each request to the I/O context pool and decrement the number of pending I/O operations for it. ]*/
+/*Tests_SRS_FILE_LINUX_01_065: [ on_file_flush_complete_linux shall mark the flush as not in progress and start a new flush if requests were added while the flush was in progress. ]*/
+/*Tests_SRS_FILE_LINUX_01_066: [ on_file_flush_complete_linux shall decrement the number of pending I/O operations for the flush and wake up file_destroy if it reaches 0. ]*/
+TEST_FUNCTION(on_file_flush_complete_linux_calls_user_callback_with_true)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    start_file_flush_async(file_handle, (void*)0x4245);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_063: [ on_file_flush_complete_linux shall call the user_callback of all the requests served by the flush, in the order in which file_flush_async was called, with is_successful as true if and only if io_result is 0. ]*/
+TEST_FUNCTION(on_file_flush_complete_linux_with_error_calls_user_callback_with_false)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    start_file_flush_async(file_handle, (void*)0x4245);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, -EIO);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_061: [ A flush of the file shall serve all the file_flush_async requests that were queued when the flush started. ]*/
+/*Tests_SRS_FILE_LINUX_01_063: [ on_file_flush_complete_linux shall call the user_callback of all the requests served by the flush, in the order in which file_flush_async was called, with is_successful as true if and only if io_result is 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_065: [ on_file_flush_complete_linux shall mark the flush as not in progress and start a new flush if requests were added while the flush was in progress. ]*/
+TEST_FUNCTION(on_file_flush_complete_linux_serves_the_requests_queued_during_the_flush_with_one_fsync)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    start_file_flush_async(file_handle, (void*)0x4245);
+    IO_RING_LINUX_IO* flush_io = captured_sqe.io;
+    ASSERT_ARE_EQUAL(int, 0, file_flush_async(file_handle, mock_user_callback, (void*)0x4246));
+    ASSERT_ARE_EQUAL(int, 0, file_flush_async(file_handle, mock_user_callback, (void*)0x4247));
+    umock_c_reset_all_calls();
+
+    /*first flush completes and starts the second one*/
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+
+    /*second flush serves both queued requests*/
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4246, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4247, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    flush_io->on_io_complete(flush_io->on_io_complete_context, 0);
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_FSYNC, captured_sqe.opcode);
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_copy_range_async */
+
+/*Tests_SRS_FILE_01_131: [ If source is NULL then file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_with_NULL_source_fails)
+{
+    ///arrange
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+
+    ///act
+    int result = file_copy_range_async(NULL, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_01_132: [ If destination is NULL then file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_with_NULL_destination_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, NULL, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+}
+
+/*Tests_SRS_FILE_01_133: [ If size is 0 then file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_with_size_0_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_01_134: [ If source_position + size or destination_position + size is greater than INT64_MAX then file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_with_source_range_past_INT64_MAX_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+
+    ///act
+    int result = file_copy_range_async(source, INT64_MAX - 4095, destination, TEST_COPY_DESTINATION_POSITION, 4096 + 1, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_01_134: [ If source_position + size or destination_position + size is greater than INT64_MAX then file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_with_destination_range_past_INT64_MAX_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, INT64_MAX - 4095, 4096 + 1, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_01_140: [ If source and destination are the same file handle and the source and destination ranges overlap then file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_with_overlapping_ranges_of_the_same_file_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_copy_range_async(file_handle, 0, file_handle, 4096, 8192, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_135: [ If user_callback is NULL then file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_with_NULL_user_callback_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_01_136: [ file_copy_range_async shall start copying size bytes of source starting at source_position to destination starting at destination_position and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_194: [ file_copy_range_async shall allocate a copy context to hold the ranges, user_callback and user_context. ]*/
+/*Tests_SRS_FILE_LINUX_01_197: [ file_copy_range_async shall increment the number of pending I/O operations of source and of destination. ]*/
+/*Tests_SRS_FILE_LINUX_01_257: [ file_copy_range_async shall obtain the worker pool of the execution engine of destination by calling execution_engine_linux_get_worker_pool. ]*/
+/*Tests_SRS_FILE_LINUX_01_258: [ file_copy_range_async shall call worker_pool_linux_submit with a work item of priority WORKER_POOL_LINUX_PRIORITY_NORMAL that calls on_file_copy_work_linux, so that the calling thread does not wait for the kernel to copy the range. ]*/
+/*Tests_SRS_FILE_LINUX_01_221: [ file_copy_range_async shall succeed and return 0. ]*/
+TEST_FUNCTION(file_copy_range_async_submits_the_copy_to_the_worker_pool)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+
+    setup_copy_range_async_expected_calls();
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_work_item);
+    ASSERT_IS_NOT_NULL(captured_work_item->work_function);
+    ASSERT_ARE_EQUAL(int, WORKER_POOL_LINUX_PRIORITY_NORMAL, captured_work_item->priority);
+
+    ///cleanup
+    run_copy_work_item();
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_01_139: [ If there are any other failures, file_copy_range_async shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_195: [ If there are any failures, file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_fails_when_malloc_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_220: [ If execution_engine_linux_get_worker_pool or worker_pool_linux_submit fails, file_copy_range_async shall decrement the number of pending I/O operations of source and of destination, free the copy context and fail. ]*/
+TEST_FUNCTION(file_copy_range_async_fails_when_execution_engine_linux_get_worker_pool_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_worker_pool(fake_execution_engine))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_220: [ If execution_engine_linux_get_worker_pool or worker_pool_linux_submit fails, file_copy_range_async shall decrement the number of pending I/O operations of source and of destination, free the copy context and fail. ]*/
+TEST_FUNCTION(file_copy_range_async_fails_when_worker_pool_linux_submit_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_worker_pool(fake_execution_engine));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_01_138: [ When a read-ahead policy is set on destination, file_copy_range_async shall drop the blocks of destination that overlap the destination range. ]*/
+/*Tests_SRS_FILE_LINUX_01_196: [ If a read-ahead policy is set on destination, file_copy_range_async shall call read_ahead_invalidate with the destination range. ]*/
+TEST_FUNCTION(file_copy_range_async_drops_the_read_ahead_blocks_of_the_destination_range)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_worker_pool(fake_execution_engine));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG));
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    run_copy_work_item();
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_01_137: [ When the copy ends, user_callback shall be called with user_context and is_successful as true if and only if all size bytes were copied. ]*/
+/*Tests_SRS_FILE_LINUX_01_198: [ on_file_copy_work_linux shall call ioctl with FICLONERANGE on destination to share the extents of the source range with the destination range. ]*/
+/*Tests_SRS_FILE_LINUX_01_199: [ If ioctl succeeds, on_file_copy_work_linux shall call end_copy with is_successful as true. ]*/
+/*Tests_SRS_FILE_LINUX_01_206: [ end_copy shall close the pipes that were created for the lanes and free the copy context. ]*/
+/*Tests_SRS_FILE_LINUX_01_207: [ end_copy shall call user_callback with user_context and is_successful. ]*/
+/*Tests_SRS_FILE_LINUX_01_208: [ end_copy shall decrement the number of pending I/O operations of source and of destination and wake up file_destroy if they reach 0. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_clones_the_range)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE);
+    (void)memset(&captured_clone_range, 0, sizeof(captured_clone_range));
+
+    STRICT_EXPECTED_CALL(mock_ioctl(fake_fd, FICLONERANGE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, fake_fd, captured_clone_range.src_fd);
+    ASSERT_ARE_EQUAL(uint64_t, TEST_COPY_SOURCE_POSITION, captured_clone_range.src_offset);
+    ASSERT_ARE_EQUAL(uint64_t, 2 * TEST_COPY_CHUNK_SIZE, captured_clone_range.src_length);
+    ASSERT_ARE_EQUAL(uint64_t, TEST_COPY_DESTINATION_POSITION, captured_clone_range.dest_offset);
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_232: [ If a read-ahead policy is set on destination, end_copy shall call read_ahead_invalidate with the destination range. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_with_read_ahead_on_destination_invalidates_the_destination_range_when_the_copy_ends)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle_with_read_ahead();
+    ASSERT_ARE_EQUAL(int, 0, file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_ioctl(fake_fd, FICLONERANGE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_233: [ If source_position, destination_position and size are multiples of FILE_LINUX_WRITE_ALIGNMENT, the copy shall use the file descriptors of source and destination. ]*/
+/*Tests_SRS_FILE_LINUX_01_259: [ on_file_copy_work_linux shall call copy_file_range with the file descriptors of the copy until size bytes are copied. ]*/
+/*Tests_SRS_FILE_LINUX_01_261: [ If copy_file_range copies all size bytes, on_file_copy_work_linux shall call end_copy with is_successful as true. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_copies_the_range_with_copy_file_range_when_ioctl_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE);
+    copy_file_range_result = TEST_COPY_CHUNK_SIZE;
+
+    STRICT_EXPECTED_CALL(mock_ioctl(fake_fd, FICLONERANGE, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_copy_file_range(fake_fd, IGNORED_ARG, fake_fd, IGNORED_ARG, 2 * TEST_COPY_CHUNK_SIZE, 0));
+    STRICT_EXPECTED_CALL(mock_copy_file_range(fake_fd, IGNORED_ARG, fake_fd, IGNORED_ARG, TEST_COPY_CHUNK_SIZE, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, TEST_COPY_SOURCE_POSITION + TEST_COPY_CHUNK_SIZE, captured_copy_file_range_source_offset);
+    ASSERT_ARE_EQUAL(int64_t, TEST_COPY_DESTINATION_POSITION + TEST_COPY_CHUNK_SIZE, captured_copy_file_range_destination_offset);
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_262: [ If copy_file_range returns 0 or fails in any other way, on_file_copy_work_linux shall call end_copy with is_successful as false. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_fails_the_copy_when_copy_file_range_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE);
+    copy_file_range_errno = EIO;
+
+    STRICT_EXPECTED_CALL(mock_ioctl(fake_fd, FICLONERANGE, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_copy_file_range(fake_fd, IGNORED_ARG, fake_fd, IGNORED_ARG, 2 * TEST_COPY_CHUNK_SIZE, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_262: [ If copy_file_range returns 0 or fails in any other way, on_file_copy_work_linux shall call end_copy with is_successful as false. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_fails_the_copy_when_the_source_ends_before_the_range)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE);
+    copy_file_range_result = 0;
+
+    STRICT_EXPECTED_CALL(mock_ioctl(fake_fd, FICLONERANGE, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_copy_file_range(fake_fd, IGNORED_ARG, fake_fd, IGNORED_ARG, 2 * TEST_COPY_CHUNK_SIZE, 0));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_260: [ If copy_file_range fails with EXDEV, EOPNOTSUPP, EINVAL or ENOSYS before copying any byte, on_file_copy_work_linux shall copy the range through pipes. ]*/
+/*Tests_SRS_FILE_LINUX_01_200: [ on_file_copy_work_linux shall split the range in chunks of FILE_LINUX_COPY_CHUNK_SIZE bytes and use up to FILE_LINUX_COPY_LANE_COUNT lanes, lane i copying the chunks i, i + lane_count, i + 2 * lane_count etc. ]*/
+/*Tests_SRS_FILE_LINUX_01_201: [ on_file_copy_work_linux shall create a pipe for each lane by calling pipe2 with O_CLOEXEC. ]*/
+/*Tests_SRS_FILE_LINUX_01_202: [ on_file_copy_work_linux shall call fcntl with F_SETPIPE_SZ to make the pipe of each lane hold FILE_LINUX_COPY_CHUNK_SIZE bytes. ]*/
+/*Tests_SRS_FILE_LINUX_01_204: [ on_file_copy_work_linux shall call io_ring_linux_submit once with the first splice of every lane. ]*/
+/*Tests_SRS_FILE_LINUX_01_210: [ If the pipe of the lane is empty, the next splice of the lane shall be an IORING_OP_SPLICE entry that moves the rest of the chunk of the lane from the source file to the pipe. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_splices_the_range_through_pipes_when_copy_file_range_fails_with_EXDEV)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 3 * TEST_COPY_CHUNK_SIZE);
+
+    setup_copy_through_pipes_expected_calls(2);
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    assert_splice_to_pipe_sqe(&captured_sqes[0], TEST_COPY_SOURCE_POSITION, TEST_FIRST_PIPE_FD + 1, TEST_COPY_CHUNK_SIZE);
+    assert_splice_to_pipe_sqe(&captured_sqes[1], TEST_COPY_SOURCE_POSITION + TEST_COPY_CHUNK_SIZE, TEST_FIRST_PIPE_FD + 3, TEST_COPY_CHUNK_SIZE);
+
+    ///cleanup
+    captured_sqes[0].io->on_io_complete(captured_sqes[0].io->on_io_complete_context, -EIO);
+    captured_sqes[1].io->on_io_complete(captured_sqes[1].io->on_io_complete_context, -EIO);
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_260: [ If copy_file_range fails with EXDEV, EOPNOTSUPP, EINVAL or ENOSYS before copying any byte, on_file_copy_work_linux shall copy the range through pipes. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_splices_the_range_through_pipes_when_copy_file_range_fails_with_EOPNOTSUPP)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 4096);
+    copy_file_range_errno = EOPNOTSUPP;
+
+    setup_copy_through_pipes_expected_calls(1);
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    assert_splice_to_pipe_sqe(&captured_sqe, TEST_COPY_SOURCE_POSITION, TEST_FIRST_PIPE_FD + 1, 4096);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, -EIO);
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_200: [ on_file_copy_work_linux shall split the range in chunks of FILE_LINUX_COPY_CHUNK_SIZE bytes and use up to FILE_LINUX_COPY_LANE_COUNT lanes, lane i copying the chunks i, i + lane_count, i + 2 * lane_count etc. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_uses_one_lane_for_a_range_of_one_chunk)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 4096);
+
+    setup_copy_through_pipes_expected_calls(1);
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    assert_splice_to_pipe_sqe(&captured_sqe, TEST_COPY_SOURCE_POSITION, TEST_FIRST_PIPE_FD + 1, 4096);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, -EIO);
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_202: [ on_file_copy_work_linux shall call fcntl with F_SETPIPE_SZ to make the pipe of each lane hold FILE_LINUX_COPY_CHUNK_SIZE bytes. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_splices_when_fcntl_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 4096);
+
+    STRICT_EXPECTED_CALL(mock_ioctl(fake_fd, FICLONERANGE, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_copy_file_range(fake_fd, IGNORED_ARG, fake_fd, IGNORED_ARG, 4096, 0));
+    STRICT_EXPECTED_CALL(mock_pipe2(IGNORED_ARG, O_CLOEXEC));
+    STRICT_EXPECTED_CALL(mock_fcntl(TEST_FIRST_PIPE_FD + 1, F_SETPIPE_SZ, TEST_COPY_CHUNK_SIZE))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, -EIO);
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_203: [ If pipe2 fails, starting the splices shall fail. ]*/
+/*Tests_SRS_FILE_LINUX_01_237: [ If starting the splices fails, on_file_copy_work_linux shall call end_copy with is_successful as false. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_fails_the_copy_when_pipe2_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE);
+
+    STRICT_EXPECTED_CALL(mock_ioctl(fake_fd, FICLONERANGE, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_copy_file_range(fake_fd, IGNORED_ARG, fake_fd, IGNORED_ARG, 2 * TEST_COPY_CHUNK_SIZE, 0));
+    STRICT_EXPECTED_CALL(mock_pipe2(IGNORED_ARG, O_CLOEXEC));
+    STRICT_EXPECTED_CALL(mock_fcntl(TEST_FIRST_PIPE_FD + 1, F_SETPIPE_SZ, TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(mock_pipe2(IGNORED_ARG, O_CLOEXEC))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 1));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_205: [ If io_ring_linux_submit fails and no splice was submitted, starting the splices shall fail. ]*/
+/*Tests_SRS_FILE_LINUX_01_237: [ If starting the splices fails, on_file_copy_work_linux shall call end_copy with is_successful as false. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_fails_the_copy_when_submitting_the_splices_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE);
+
+    STRICT_EXPECTED_CALL(mock_ioctl(fake_fd, FICLONERANGE, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_copy_file_range(fake_fd, IGNORED_ARG, fake_fd, IGNORED_ARG, 2 * TEST_COPY_CHUNK_SIZE, 0));
+    STRICT_EXPECTED_CALL(mock_pipe2(IGNORED_ARG, O_CLOEXEC));
+    STRICT_EXPECTED_CALL(mock_fcntl(TEST_FIRST_PIPE_FD + 1, F_SETPIPE_SZ, TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(mock_pipe2(IGNORED_ARG, O_CLOEXEC));
+    STRICT_EXPECTED_CALL(mock_fcntl(TEST_FIRST_PIPE_FD + 3, F_SETPIPE_SZ, TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 2, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 1));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 2));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 3));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_219: [ If io_ring_linux_submit fails after submitting the splices of some lanes, on_file_copy_work_linux shall mark the copy as failed and end the other lanes, the copy ending when the submitted splices complete. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_fails_the_copy_when_only_some_splices_are_submitted)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE);
+    REGISTER_GLOBAL_MOCK_HOOK(io_ring_linux_submit, hook_io_ring_linux_submit_only_first_entry);
+
+    STRICT_EXPECTED_CALL(mock_ioctl(fake_fd, FICLONERANGE, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_copy_file_range(fake_fd, IGNORED_ARG, fake_fd, IGNORED_ARG, 2 * TEST_COPY_CHUNK_SIZE, 0));
+    STRICT_EXPECTED_CALL(mock_pipe2(IGNORED_ARG, O_CLOEXEC));
+    STRICT_EXPECTED_CALL(mock_fcntl(TEST_FIRST_PIPE_FD + 1, F_SETPIPE_SZ, TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(mock_pipe2(IGNORED_ARG, O_CLOEXEC));
+    STRICT_EXPECTED_CALL(mock_fcntl(TEST_FIRST_PIPE_FD + 3, F_SETPIPE_SZ, TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 2, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///arrange
+    REGISTER_GLOBAL_MOCK_HOOK(io_ring_linux_submit, hook_io_ring_linux_submit);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 1));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 2));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 3));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, TEST_COPY_CHUNK_SIZE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+static void setup_unaligned_copy_open_expected_calls(void)
+{
+    STRICT_EXPECTED_CALL(mock_ioctl(fake_fd, FICLONERANGE, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_open(TEST_FD_PATH, O_RDONLY | O_CLOEXEC | O_LARGEFILE, 0))
+        .SetReturn(TEST_BUFFERED_SOURCE_FD);
+}
+
+/*Tests_SRS_FILE_LINUX_01_234: [ Otherwise on_file_copy_work_linux shall open the source again without O_DIRECT by calling open with /proc/self/fd/ followed by the file descriptor of source and O_RDONLY, O_CLOEXEC and O_LARGEFILE, open the destination again in the same way with O_WRONLY, O_CLOEXEC and O_LARGEFILE and use these file descriptors for the copy. ]*/
+/*Tests_SRS_FILE_LINUX_01_259: [ on_file_copy_work_linux shall call copy_file_range with the file descriptors of the copy until size bytes are copied. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_copies_an_unaligned_range_through_descriptors_opened_without_O_DIRECT)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION + 100, destination, TEST_COPY_DESTINATION_POSITION, 4096);
+    copy_file_range_result = 4096;
+
+    setup_unaligned_copy_open_expected_calls();
+    STRICT_EXPECTED_CALL(mock_open(TEST_FD_PATH, O_WRONLY | O_CLOEXEC | O_LARGEFILE, 0))
+        .SetReturn(TEST_BUFFERED_DESTINATION_FD);
+    STRICT_EXPECTED_CALL(mock_copy_file_range(TEST_BUFFERED_SOURCE_FD, IGNORED_ARG, TEST_BUFFERED_DESTINATION_FD, IGNORED_ARG, 4096, 0));
+    STRICT_EXPECTED_CALL(mock_close(TEST_BUFFERED_SOURCE_FD));
+    STRICT_EXPECTED_CALL(mock_close(TEST_BUFFERED_DESTINATION_FD));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, TEST_COPY_SOURCE_POSITION + 100, captured_copy_file_range_source_offset);
+    ASSERT_ARE_EQUAL(int64_t, TEST_COPY_DESTINATION_POSITION, captured_copy_file_range_destination_offset);
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_234: [ Otherwise on_file_copy_work_linux shall open the source again without O_DIRECT by calling open with /proc/self/fd/ followed by the file descriptor of source and O_RDONLY, O_CLOEXEC and O_LARGEFILE, open the destination again in the same way with O_WRONLY, O_CLOEXEC and O_LARGEFILE and use these file descriptors for the copy. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_splices_an_unaligned_range_through_descriptors_opened_without_O_DIRECT)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION + 100, destination, TEST_COPY_DESTINATION_POSITION, 4096);
+
+    setup_unaligned_copy_open_expected_calls();
+    STRICT_EXPECTED_CALL(mock_open(TEST_FD_PATH, O_WRONLY | O_CLOEXEC | O_LARGEFILE, 0))
+        .SetReturn(TEST_BUFFERED_DESTINATION_FD);
+    STRICT_EXPECTED_CALL(mock_copy_file_range(TEST_BUFFERED_SOURCE_FD, IGNORED_ARG, TEST_BUFFERED_DESTINATION_FD, IGNORED_ARG, 4096, 0));
+    STRICT_EXPECTED_CALL(mock_pipe2(IGNORED_ARG, O_CLOEXEC));
+    STRICT_EXPECTED_CALL(mock_fcntl(TEST_FIRST_PIPE_FD + 1, F_SETPIPE_SZ, TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, TEST_BUFFERED_SOURCE_FD, captured_sqe.splice_fd_in);
+    ASSERT_ARE_EQUAL(uint64_t, TEST_COPY_SOURCE_POSITION + 100, captured_sqe.splice_offset_in);
+
+    ///arrange
+    IO_RING_LINUX_IO* lane_io = captured_sqe.io;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    lane_io->on_io_complete(lane_io->on_io_complete_context, 4096);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, TEST_FIRST_PIPE_FD, captured_sqe.splice_fd_in);
+    ASSERT_ARE_EQUAL(int32_t, TEST_BUFFERED_DESTINATION_FD, captured_sqe.fd);
+    ASSERT_ARE_EQUAL(uint64_t, TEST_COPY_DESTINATION_POSITION, captured_sqe.offset);
+
+    ///cleanup
+    lane_io->on_io_complete(lane_io->on_io_complete_context, -EIO);
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_234: [ Otherwise on_file_copy_work_linux shall open the source again without O_DIRECT by calling open with /proc/self/fd/ followed by the file descriptor of source and O_RDONLY, O_CLOEXEC and O_LARGEFILE, open the destination again in the same way with O_WRONLY, O_CLOEXEC and O_LARGEFILE and use these file descriptors for the copy. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_reopens_the_files_when_only_the_size_is_unaligned)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 4097);
+
+    setup_unaligned_copy_open_expected_calls();
+    STRICT_EXPECTED_CALL(mock_open(TEST_FD_PATH, O_WRONLY | O_CLOEXEC | O_LARGEFILE, 0))
+        .SetReturn(TEST_BUFFERED_DESTINATION_FD);
+    STRICT_EXPECTED_CALL(mock_copy_file_range(TEST_BUFFERED_SOURCE_FD, IGNORED_ARG, TEST_BUFFERED_DESTINATION_FD, IGNORED_ARG, 4097, 0));
+    STRICT_EXPECTED_CALL(mock_pipe2(IGNORED_ARG, O_CLOEXEC));
+    STRICT_EXPECTED_CALL(mock_fcntl(TEST_FIRST_PIPE_FD + 1, F_SETPIPE_SZ, TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int32_t, TEST_BUFFERED_SOURCE_FD, captured_sqe.splice_fd_in);
+    ASSERT_ARE_EQUAL(uint32_t, 4097, captured_sqe.length);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, -EIO);
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_236: [ end_copy shall close the file descriptors opened without O_DIRECT. ]*/
+TEST_FUNCTION(end_copy_closes_the_descriptors_opened_without_O_DIRECT)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION + 1, 4096);
+
+    setup_unaligned_copy_open_expected_calls();
+    STRICT_EXPECTED_CALL(mock_open(TEST_FD_PATH, O_WRONLY | O_CLOEXEC | O_LARGEFILE, 0))
+        .SetReturn(TEST_BUFFERED_DESTINATION_FD);
+    STRICT_EXPECTED_CALL(mock_copy_file_range(TEST_BUFFERED_SOURCE_FD, IGNORED_ARG, TEST_BUFFERED_DESTINATION_FD, IGNORED_ARG, 4096, 0));
+    STRICT_EXPECTED_CALL(mock_pipe2(IGNORED_ARG, O_CLOEXEC));
+    STRICT_EXPECTED_CALL(mock_fcntl(TEST_FIRST_PIPE_FD + 1, F_SETPIPE_SZ, TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+    run_copy_work_item();
+    IO_RING_LINUX_IO* lane_io = captured_sqe.io;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 1));
+    STRICT_EXPECTED_CALL(mock_close(TEST_BUFFERED_SOURCE_FD));
+    STRICT_EXPECTED_CALL(mock_close(TEST_BUFFERED_DESTINATION_FD));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    lane_io->on_io_complete(lane_io->on_io_complete_context, -EIO);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_235: [ If open fails, on_file_copy_work_linux shall close the file descriptor that was opened and call end_copy with is_successful as false. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_fails_the_copy_when_opening_the_source_without_O_DIRECT_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION + 1, destination, TEST_COPY_DESTINATION_POSITION, 4096);
+
+    STRICT_EXPECTED_CALL(mock_ioctl(fake_fd, FICLONERANGE, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_open(TEST_FD_PATH, O_RDONLY | O_CLOEXEC | O_LARGEFILE, 0))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_235: [ If open fails, on_file_copy_work_linux shall close the file descriptor that was opened and call end_copy with is_successful as false. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_fails_the_copy_when_opening_the_destination_without_O_DIRECT_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION + 1, destination, TEST_COPY_DESTINATION_POSITION, 4096);
+
+    setup_unaligned_copy_open_expected_calls();
+    STRICT_EXPECTED_CALL(mock_open(TEST_FD_PATH, O_WRONLY | O_CLOEXEC | O_LARGEFILE, 0))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_close(TEST_BUFFERED_SOURCE_FD));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_237: [ If starting the splices fails, on_file_copy_work_linux shall call end_copy with is_successful as false. ]*/
+TEST_FUNCTION(on_file_copy_work_linux_closes_the_descriptors_opened_without_O_DIRECT_when_pipe2_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    start_copy(source, TEST_COPY_SOURCE_POSITION + 1, destination, TEST_COPY_DESTINATION_POSITION, 4096);
+
+    setup_unaligned_copy_open_expected_calls();
+    STRICT_EXPECTED_CALL(mock_open(TEST_FD_PATH, O_WRONLY | O_CLOEXEC | O_LARGEFILE, 0))
+        .SetReturn(TEST_BUFFERED_DESTINATION_FD);
+    STRICT_EXPECTED_CALL(mock_copy_file_range(TEST_BUFFERED_SOURCE_FD, IGNORED_ARG, TEST_BUFFERED_DESTINATION_FD, IGNORED_ARG, 4096, 0));
+    STRICT_EXPECTED_CALL(mock_pipe2(IGNORED_ARG, O_CLOEXEC))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_close(TEST_BUFFERED_SOURCE_FD));
+    STRICT_EXPECTED_CALL(mock_close(TEST_BUFFERED_DESTINATION_FD));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    run_copy_work_item();
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_214: [ Otherwise on_file_copy_splice_complete_linux shall add io_result to the number of bytes moved to the pipe or to the destination file, depending on the direction of the splice. ]*/
+/*Tests_SRS_FILE_LINUX_01_211: [ Otherwise the next splice of the lane shall be an IORING_OP_SPLICE entry that moves all the bytes in the pipe of the lane to the destination file. ]*/
+/*Tests_SRS_FILE_LINUX_01_217: [ on_file_copy_splice_complete_linux shall call io_ring_linux_submit with the next splice of the lane. ]*/
+TEST_FUNCTION(on_file_copy_splice_complete_linux_drains_the_pipe_to_the_destination)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    IO_RING_LINUX_IO* lane_ios[2];
+    start_copy_through_pipes(source, destination, 3 * TEST_COPY_CHUNK_SIZE, 2, lane_ios);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    lane_ios[1]->on_io_complete(lane_ios[1]->on_io_complete_context, 65536);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    assert_splice_from_pipe_sqe(&captured_sqe, TEST_FIRST_PIPE_FD + 2, TEST_COPY_DESTINATION_POSITION + TEST_COPY_CHUNK_SIZE, 65536);
+    ASSERT_IS_TRUE(captured_sqe.io == lane_ios[1]);
+
+    ///cleanup
+    end_copy_with_failure(lane_ios, 2);
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_210: [ If the pipe of the lane is empty, the next splice of the lane shall be an IORING_OP_SPLICE entry that moves the rest of the chunk of the lane from the source file to the pipe. ]*/
+TEST_FUNCTION(on_file_copy_splice_complete_linux_fills_the_pipe_with_the_rest_of_the_chunk_once_it_is_drained)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    IO_RING_LINUX_IO* lane_ios[2];
+    start_copy_through_pipes(source, destination, 3 * TEST_COPY_CHUNK_SIZE, 2, lane_ios);
+    lane_ios[0]->on_io_complete(lane_ios[0]->on_io_complete_context, 65536);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    lane_ios[0]->on_io_complete(lane_ios[0]->on_io_complete_context, 65536);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    assert_splice_to_pipe_sqe(&captured_sqe, TEST_COPY_SOURCE_POSITION + 65536, TEST_FIRST_PIPE_FD + 1, TEST_COPY_CHUNK_SIZE - 65536);
+
+    ///cleanup
+    end_copy_with_failure(lane_ios, 2);
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_211: [ Otherwise the next splice of the lane shall be an IORING_OP_SPLICE entry that moves all the bytes in the pipe of the lane to the destination file. ]*/
+TEST_FUNCTION(on_file_copy_splice_complete_linux_drains_the_rest_of_the_pipe_after_a_short_splice)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    IO_RING_LINUX_IO* lane_ios[2];
+    start_copy_through_pipes(source, destination, 3 * TEST_COPY_CHUNK_SIZE, 2, lane_ios);
+    lane_ios[0]->on_io_complete(lane_ios[0]->on_io_complete_context, TEST_COPY_CHUNK_SIZE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    lane_ios[0]->on_io_complete(lane_ios[0]->on_io_complete_context, 4096);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    assert_splice_from_pipe_sqe(&captured_sqe, TEST_FIRST_PIPE_FD, TEST_COPY_DESTINATION_POSITION + 4096, TEST_COPY_CHUNK_SIZE - 4096);
+
+    ///cleanup
+    end_copy_with_failure(lane_ios, 2);
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_216: [ When the chunk of the lane is copied, on_file_copy_splice_complete_linux shall move the lane to its next chunk, lane_count chunks further, or end the lane if that chunk is past the end of the range. ]*/
+TEST_FUNCTION(on_file_copy_splice_complete_linux_moves_the_lane_to_its_next_chunk)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    IO_RING_LINUX_IO* lane_ios[2];
+    start_copy_through_pipes(source, destination, 3 * TEST_COPY_CHUNK_SIZE, 2, lane_ios);
+    lane_ios[0]->on_io_complete(lane_ios[0]->on_io_complete_context, TEST_COPY_CHUNK_SIZE);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    lane_ios[0]->on_io_complete(lane_ios[0]->on_io_complete_context, TEST_COPY_CHUNK_SIZE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    assert_splice_to_pipe_sqe(&captured_sqe, TEST_COPY_SOURCE_POSITION + 2 * TEST_COPY_CHUNK_SIZE, TEST_FIRST_PIPE_FD + 1, TEST_COPY_CHUNK_SIZE);
+
+    ///cleanup
+    end_copy_with_failure(lane_ios, 2);
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_01_137: [ When the copy ends, user_callback shall be called with user_context and is_successful as true if and only if all size bytes were copied. ]*/
+/*Tests_SRS_FILE_LINUX_01_216: [ When the chunk of the lane is copied, on_file_copy_splice_complete_linux shall move the lane to its next chunk, lane_count chunks further, or end the lane if that chunk is past the end of the range. ]*/
+/*Tests_SRS_FILE_LINUX_01_212: [ When the last lane ends, the copy shall call end_copy with is_successful as true if and only if no lane failed. ]*/
+/*Tests_SRS_FILE_LINUX_01_206: [ end_copy shall close the pipes that were created for the lanes and free the copy context. ]*/
+/*Tests_SRS_FILE_LINUX_01_207: [ end_copy shall call user_callback with user_context and is_successful. ]*/
+/*Tests_SRS_FILE_LINUX_01_208: [ end_copy shall decrement the number of pending I/O operations of source and of destination and wake up file_destroy if they reach 0. ]*/
+TEST_FUNCTION(on_file_copy_splice_complete_linux_calls_user_callback_with_true_when_the_last_lane_ends)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    IO_RING_LINUX_IO* lane_ios[2];
+    start_copy_through_pipes(source, destination, TEST_COPY_CHUNK_SIZE + 4096, 2, lane_ios);
+    lane_ios[0]->on_io_complete(lane_ios[0]->on_io_complete_context, TEST_COPY_CHUNK_SIZE);
+    lane_ios[0]->on_io_complete(lane_ios[0]->on_io_complete_context, TEST_COPY_CHUNK_SIZE);
+    lane_ios[1]->on_io_complete(lane_ios[1]->on_io_complete_context, 4096);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 1));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 2));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 3));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    lane_ios[1]->on_io_complete(lane_ios[1]->on_io_complete_context, 4096);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_213: [ If io_result is 0 or negative, on_file_copy_splice_complete_linux shall mark the copy as failed and end the lane. ]*/
+TEST_FUNCTION(on_file_copy_splice_complete_linux_fails_the_copy_when_io_result_is_negative)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    IO_RING_LINUX_IO* lane_ios[2];
+    start_copy_through_pipes(source, destination, 2 * TEST_COPY_CHUNK_SIZE, 2, lane_ios);
+
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+
+    ///act
+    lane_ios[0]->on_io_complete(lane_ios[0]->on_io_complete_context, -EIO);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///arrange
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 1));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 2));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 3));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    lane_ios[1]->on_io_complete(lane_ios[1]->on_io_complete_context, TEST_COPY_CHUNK_SIZE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_213: [ If io_result is 0 or negative, on_file_copy_splice_complete_linux shall mark the copy as failed and end the lane. ]*/
+TEST_FUNCTION(on_file_copy_splice_complete_linux_fails_the_copy_when_the_source_ends_before_the_range)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    IO_RING_LINUX_IO* lane_ios[1];
+    start_copy_through_pipes(source, destination, 4096, 1, lane_ios);
+
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 1));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    lane_ios[0]->on_io_complete(lane_ios[0]->on_io_complete_context, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_218: [ If io_ring_linux_submit fails, on_file_copy_splice_complete_linux shall mark the copy as failed and end the lane. ]*/
+TEST_FUNCTION(on_file_copy_splice_complete_linux_fails_the_copy_when_io_ring_linux_submit_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    IO_RING_LINUX_IO* lane_ios[1];
+    start_copy_through_pipes(source, destination, 4096, 1, lane_ios);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 1));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    lane_ios[0]->on_io_complete(lane_ios[0]->on_io_complete_context, 4096);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/*Tests_SRS_FILE_LINUX_01_215: [ If another lane failed, on_file_copy_splice_complete_linux shall end the lane. ]*/
+TEST_FUNCTION(on_file_copy_splice_complete_linux_ends_the_lane_when_another_lane_failed)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle("destination.txt");
+    IO_RING_LINUX_IO* lane_ios[2];
+    start_copy_through_pipes(source, destination, 3 * TEST_COPY_CHUNK_SIZE, 2, lane_ios);
+    lane_ios[1]->on_io_complete(lane_ios[1]->on_io_complete_context, -EIO);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 1));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 2));
+    STRICT_EXPECTED_CALL(mock_close(TEST_FIRST_PIPE_FD + 3));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    lane_ios[0]->on_io_complete(lane_ios[0]->on_io_complete_context, TEST_COPY_CHUNK_SIZE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/* file_map_region */
+
+/*Tests_SRS_FILE_01_065: [ If handle is NULL then file_map_region shall fail and return NULL. ]*/
+/*Tests_SRS_FILE_LINUX_01_067: [ If handle is NULL then file_map_region shall fail and return NULL. ]*/
+TEST_FUNCTION(file_map_region_fails_with_null_handle)
+{
+    ///act
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(NULL, 0, 4096, FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_IS_NULL(region);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_066: [ If size is 0 then file_map_region shall fail and return NULL. ]*/
+/*Tests_SRS_FILE_LINUX_01_068: [ If size is 0 then file_map_region shall fail and return NULL. ]*/
+TEST_FUNCTION(file_map_region_fails_with_zero_size)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, 0, 0, FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_IS_NULL(region);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_067: [ If position + size is greater than INT64_MAX then file_map_region shall fail and return NULL. ]*/
+/*Tests_SRS_FILE_LINUX_01_069: [ If position + size is greater than INT64_MAX then file_map_region shall fail and return NULL. ]*/
+TEST_FUNCTION(file_map_region_fails_if_position_plus_size_is_greater_than_INT64_MAX)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, INT64_MAX, 1, FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_IS_NULL(region);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_068: [ If position + size is greater than the size of the file then file_map_region shall fail and return NULL. ]*/
+/*Tests_SRS_FILE_LINUX_01_070: [ file_map_region shall call fstat to get the size of the file. ]*/
+/*Tests_SRS_FILE_LINUX_01_071: [ If position + size is greater than the size of the file, file_map_region shall fail and return NULL. ]*/
+TEST_FUNCTION(file_map_region_fails_when_the_region_goes_past_the_end_of_the_file)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(mock_fstat(fake_fd, IGNORED_ARG));
+
+    ///act
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, (uint64_t)test_file_size - 10, 11, FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_IS_NULL(region);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_069: [ file_map_region shall map size bytes of the file starting at position as a read-only view and return a handle to it. ]*/
+/*Tests_SRS_FILE_LINUX_01_070: [ file_map_region shall call fstat to get the size of the file. ]*/
+/*Tests_SRS_FILE_LINUX_01_072: [ file_map_region shall allocate a FILE_MAPPED_REGION. ]*/
+/*Tests_SRS_FILE_LINUX_01_073: [ file_map_region shall call mmap with PROT_READ, MAP_SHARED, the file descriptor, position rounded down to a multiple of the page size as offset and size plus the bytes between offset and position as length. ]*/
+/*Tests_SRS_FILE_LINUX_01_077: [ file_map_region shall succeed and return the allocated FILE_MAPPED_REGION. ]*/
+/*Tests_SRS_FILE_01_073: [ file_mapped_region_get_data shall return a pointer to the byte of the view that corresponds to position in the file. ]*/
+/*Tests_SRS_FILE_LINUX_01_079: [ file_mapped_region_get_data shall return the address in the mapping of the byte at position. ]*/
+TEST_FUNCTION(file_map_region_maps_the_pages_containing_the_region)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    off_t page_size = (off_t)sysconf(_SC_PAGESIZE);
+
+    STRICT_EXPECTED_CALL(mock_fstat(fake_fd, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_mmap(NULL, 100 + 4096, PROT_READ, MAP_SHARED, fake_fd, page_size));
+
+    ///act
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, (uint64_t)page_size + 100, 4096, FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(region);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, test_mapping + 100, file_mapped_region_get_data(region));
+
+    ///cleanup
+    file_unmap_region(region);
+    destroy_file_handle(file_handle);
+}
+
+static void file_map_region_with_access_hint_calls_madvise(FILE_ACCESS_HINT access_hint, int expected_advice)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(mock_fstat(fake_fd, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_mmap(NULL, 4096, PROT_READ, MAP_SHARED, fake_fd, 0));
+    STRICT_EXPECTED_CALL(mock_madvise(test_mapping, 4096, expected_advice));
+
+    ///act
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, 0, 4096, access_hint);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(region);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, test_mapping, file_mapped_region_get_data(region));
+
+    ///cleanup
+    file_unmap_region(region);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_074: [ If access_hint is FILE_ACCESS_HINT_SEQUENTIAL, FILE_ACCESS_HINT_RANDOM or FILE_ACCESS_HINT_WILL_NEED, file_map_region shall call madvise on the mapping with MADV_SEQUENTIAL, MADV_RANDOM or MADV_WILLNEED respectively. ]*/
+TEST_FUNCTION(file_map_region_with_FILE_ACCESS_HINT_SEQUENTIAL_calls_madvise_with_MADV_SEQUENTIAL)
+{
+    file_map_region_with_access_hint_calls_madvise(FILE_ACCESS_HINT_SEQUENTIAL, MADV_SEQUENTIAL);
+}
+
+/*Tests_SRS_FILE_LINUX_01_074: [ If access_hint is FILE_ACCESS_HINT_SEQUENTIAL, FILE_ACCESS_HINT_RANDOM or FILE_ACCESS_HINT_WILL_NEED, file_map_region shall call madvise on the mapping with MADV_SEQUENTIAL, MADV_RANDOM or MADV_WILLNEED respectively. ]*/
+TEST_FUNCTION(file_map_region_with_FILE_ACCESS_HINT_RANDOM_calls_madvise_with_MADV_RANDOM)
+{
+    file_map_region_with_access_hint_calls_madvise(FILE_ACCESS_HINT_RANDOM, MADV_RANDOM);
+}
+
+/*Tests_SRS_FILE_LINUX_01_074: [ If access_hint is FILE_ACCESS_HINT_SEQUENTIAL, FILE_ACCESS_HINT_RANDOM or FILE_ACCESS_HINT_WILL_NEED, file_map_region shall call madvise on the mapping with MADV_SEQUENTIAL, MADV_RANDOM or MADV_WILLNEED respectively. ]*/
+TEST_FUNCTION(file_map_region_with_FILE_ACCESS_HINT_WILL_NEED_calls_madvise_with_MADV_WILLNEED)
+{
+    file_map_region_with_access_hint_calls_madvise(FILE_ACCESS_HINT_WILL_NEED, MADV_WILLNEED);
+}
+
+/*Tests_SRS_FILE_01_070: [ Failing to apply access_hint shall not make file_map_region fail. ]*/
+/*Tests_SRS_FILE_LINUX_01_075: [ If madvise fails, file_map_region shall log the failure and continue. ]*/
+TEST_FUNCTION(file_map_region_succeeds_when_madvise_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(mock_fstat(fake_fd, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_mmap(NULL, 4096, PROT_READ, MAP_SHARED, fake_fd, 0));
+    STRICT_EXPECTED_CALL(mock_madvise(test_mapping, 4096, MADV_RANDOM))
+        .SetReturn(-1);
+
+    ///act
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, 0, 4096, FILE_ACCESS_HINT_RANDOM);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(region);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_unmap_region(region);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_071: [ If there are any other failures, file_map_region shall fail and return NULL. ]*/
+/*Tests_SRS_FILE_LINUX_01_076: [ If there are any failures, file_map_region shall fail and return NULL. ]*/
+TEST_FUNCTION(file_map_region_fails_when_underlying_functions_fail)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(mock_fstat(fake_fd, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_mmap(NULL, 4096, PROT_READ, MAP_SHARED, fake_fd, 0));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, 0, 4096, FILE_ACCESS_HINT_NORMAL);
+
+            ///assert
+            ASSERT_IS_NULL(region, "On failed call %zu", i);
+        }
+    }
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_mapped_region_get_data */
+
+/*Tests_SRS_FILE_01_072: [ If region is NULL then file_mapped_region_get_data shall return NULL. ]*/
+/*Tests_SRS_FILE_LINUX_01_078: [ If region is NULL then file_mapped_region_get_data shall return NULL. ]*/
+TEST_FUNCTION(file_mapped_region_get_data_with_null_region_returns_NULL)
+{
+    ///act
+    const unsigned char* data = file_mapped_region_get_data(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(data);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* file_unmap_region */
+
+/*Tests_SRS_FILE_01_074: [ If region is NULL then file_unmap_region shall return. ]*/
+/*Tests_SRS_FILE_LINUX_01_080: [ If region is NULL then file_unmap_region shall return. ]*/
+TEST_FUNCTION(file_unmap_region_with_null_region_returns)
+{
+    ///act
+    file_unmap_region(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_075: [ file_unmap_region shall unmap the view and free region. ]*/
+/*Tests_SRS_FILE_LINUX_01_081: [ file_unmap_region shall call munmap with the address and the length of the mapping. ]*/
+/*Tests_SRS_FILE_LINUX_01_082: [ file_unmap_region shall free region. ]*/
+TEST_FUNCTION(file_unmap_region_unmaps_the_mapping_and_frees_the_region)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    off_t page_size = (off_t)sysconf(_SC_PAGESIZE);
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, (uint64_t)page_size + 100, 4096, FILE_ACCESS_HINT_NORMAL);
+    ASSERT_IS_NOT_NULL(region);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_munmap(test_mapping, 100 + 4096));
+    STRICT_EXPECTED_CALL(free(region));
+
+    ///act
+    file_unmap_region(region);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_43_018: [ file_extend shall return 0. ]*/
+TEST_FUNCTION(file_extend_returns_zero)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int return_value = file_extend(file_handle, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, return_value);
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_set_preallocation */
+
+/*Tests_SRS_FILE_01_076: [ If handle is NULL then file_set_preallocation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_preallocation_fails_with_null_handle)
+{
+    ///arrange
+
+    ///act
+    int result = file_set_preallocation(NULL, TEST_PREALLOCATION_CHUNK_SIZE);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_077: [ If chunk_size is 0 then file_set_preallocation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_preallocation_fails_with_zero_chunk_size)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_set_preallocation(file_handle, 0);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_078: [ If chunk_size is greater than INT64_MAX then file_set_preallocation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_preallocation_fails_when_chunk_size_is_greater_than_INT64_MAX)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_set_preallocation(file_handle, (uint64_t)INT64_MAX + 1);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_079: [ If a preallocation policy was already set on handle then file_set_preallocation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_preallocation_fails_when_a_policy_was_already_set)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation(TEST_PREALLOCATION_CHUNK_SIZE);
+
+    ///act
+    int result = file_set_preallocation(file_handle, TEST_PREALLOCATION_CHUNK_SIZE);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_080: [ file_set_preallocation shall set chunk_size as the preallocation chunk size of handle and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_097: [ file_set_preallocation shall call fstat to get the size of the file. ]*/
+/*Tests_SRS_FILE_LINUX_01_099: [ file_set_preallocation shall set the preallocated end of the file to the size of the file and mark the preallocation as not in progress. ]*/
+/*Tests_SRS_FILE_LINUX_01_100: [ file_set_preallocation shall set chunk_size as the preallocation chunk size of handle and return 0. ]*/
+TEST_FUNCTION(file_set_preallocation_succeeds)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(mock_fstat(fake_fd, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, test_file_size));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+
+    ///act
+    int result = file_set_preallocation(file_handle, TEST_PREALLOCATION_CHUNK_SIZE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_083: [ If there are any other failures, file_set_preallocation shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_098: [ If fstat fails, file_set_preallocation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_preallocation_fails_when_fstat_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(mock_fstat(fake_fd, IGNORED_ARG))
+        .SetReturn(-1);
+
+    ///act
+    int result = file_set_preallocation(file_handle, TEST_PREALLOCATION_CHUNK_SIZE);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* preallocate_ahead_if_needed */
+
+/*Tests_SRS_FILE_LINUX_01_085: [ If write_end + chunk_size / 2 is not greater than the preallocated end of the file, preallocate_ahead_if_needed shall return. ]*/
+TEST_FUNCTION(file_write_async_far_from_the_preallocated_end_does_not_preallocate)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation(TEST_PREALLOCATION_CHUNK_SIZE);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITE, captured_sqe.opcode);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_081: [ When a write started by file_write_async, file_write_async_v or file_batch_submit ends less than chunk_size / 2 bytes before the end of the reserved storage and no reservation is in progress, storage shall be reserved in the background, without changing the size of the file, up to chunk_size bytes past the end of the write. ]*/
+/*Tests_SRS_FILE_LINUX_01_094: [ file_write_async shall set the write end of the I/O context to position + size, so that preallocate_ahead_if_needed is called with it once the write is submitted. ]*/
+/*Tests_SRS_FILE_LINUX_01_086: [ preallocate_ahead_if_needed shall mark the preallocation as in progress, and if a preallocation is already in progress it shall return. ]*/
+/*Tests_SRS_FILE_LINUX_01_087: [ preallocate_ahead_if_needed shall compute the preallocation target as write_end + chunk_size, capped at INT64_MAX. ]*/
+/*Tests_SRS_FILE_LINUX_01_088: [ preallocate_ahead_if_needed shall increment the number of pending I/O operations and call io_ring_linux_submit with an IORING_OP_FALLOCATE entry for the file descriptor that reserves the storage between the preallocated end and the preallocation target with FALLOC_FL_KEEP_SIZE as mode. ]*/
+TEST_FUNCTION(file_write_async_close_to_the_preallocated_end_submits_a_fallocate)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation(TEST_PREALLOCATION_CHUNK_SIZE);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+    setup_preallocation_expected_calls();
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), test_file_size - sizeof(source), mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITE, previous_captured_sqe.opcode);
+    assert_fallocate_sqe(test_file_size, TEST_PREALLOCATION_CHUNK_SIZE);
+
+    ///cleanup
+    previous_captured_sqe.io->on_io_complete(previous_captured_sqe.io->on_io_complete_context, sizeof(source));
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 0);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_087: [ preallocate_ahead_if_needed shall compute the preallocation target as write_end + chunk_size, capped at INT64_MAX. ]*/
+TEST_FUNCTION(file_write_async_caps_the_preallocation_target_at_INT64_MAX)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation(INT64_MAX);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+    setup_preallocation_expected_calls();
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    assert_fallocate_sqe(test_file_size, INT64_MAX - test_file_size);
+
+    ///cleanup
+    previous_captured_sqe.io->on_io_complete(previous_captured_sqe.io->on_io_complete_context, sizeof(source));
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 0);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_082: [ A failure to reserve storage shall not fail the write. ]*/
+/*Tests_SRS_FILE_LINUX_01_089: [ If io_ring_linux_submit fails, preallocate_ahead_if_needed shall mark the preallocation as not in progress and decrement the number of pending I/O operations. ]*/
+TEST_FUNCTION(file_write_async_succeeds_when_submitting_the_fallocate_fails)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation(TEST_PREALLOCATION_CHUNK_SIZE);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), test_file_size - sizeof(source), mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_086: [ preallocate_ahead_if_needed shall mark the preallocation as in progress, and if a preallocation is already in progress it shall return. ]*/
+TEST_FUNCTION(file_write_async_while_a_preallocation_is_in_progress_does_not_preallocate)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation(TEST_PREALLOCATION_CHUNK_SIZE);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), test_file_size - sizeof(source), mock_user_callback, (void*)0x4245));
+    IO_RING_LINUX_SQE first_write_sqe = previous_captured_sqe;
+    IO_RING_LINUX_SQE fallocate_sqe = captured_sqe;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), test_file_size, mock_user_callback, (void*)0x4246);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITE, captured_sqe.opcode);
+
+    ///cleanup
+    first_write_sqe.io->on_io_complete(first_write_sqe.io->on_io_complete_context, sizeof(source));
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    fallocate_sqe.io->on_io_complete(fallocate_sqe.io->on_io_complete_context, 0);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_095: [ file_write_async_v shall set the write end of the I/O context to position + the sum of the buffer lengths, so that preallocate_ahead_if_needed is called with it once the write is submitted. ]*/
+TEST_FUNCTION(file_write_async_v_close_to_the_preallocated_end_submits_a_fallocate)
+{
+    ///arrange
+    unsigned char header[512];
+    unsigned char payload[3584];
+    FILE_BUFFER buffers[] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation(TEST_PREALLOCATION_CHUNK_SIZE);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+    setup_preallocation_expected_calls();
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, test_file_size, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITEV, previous_captured_sqe.opcode);
+    assert_fallocate_sqe(test_file_size, sizeof(header) + sizeof(payload) + TEST_PREALLOCATION_CHUNK_SIZE);
+
+    ///cleanup
+    previous_captured_sqe.io->on_io_complete(previous_captured_sqe.io->on_io_complete_context, sizeof(header) + sizeof(payload));
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 0);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_096: [ If io_ring_linux_submit succeeds and the submitted entries hold writes, file_batch_submit shall call preallocate_ahead_if_needed with the highest end of these writes. ]*/
+TEST_FUNCTION(file_batch_submit_with_writes_close_to_the_preallocated_end_submits_a_fallocate)
+{
+    ///arrange
+    unsigned char source[4096];
+    unsigned char destination[4096];
+    uint32_t submitted_count = 0;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation(TEST_PREALLOCATION_CHUNK_SIZE);
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), test_file_size, mock_user_callback, (void*)0x4245));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, (void*)0x4246));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 2 * test_file_size, mock_user_callback, (void*)0x4247));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 3));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 3, IGNORED_ARG));
+    setup_preallocation_expected_calls();
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 3, submitted_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    assert_fallocate_sqe(test_file_size, sizeof(source) + TEST_PREALLOCATION_CHUNK_SIZE);
+
+    ///cleanup
+    /*the fallocate overwrote captured_sqes[0], the first entry of the batch is in previous_captured_sqe*/
+    previous_captured_sqe.io->on_io_complete(previous_captured_sqe.io->on_io_complete_context, sizeof(source));
+    captured_sqes[1].io->on_io_complete(captured_sqes[1].io->on_io_complete_context, sizeof(source));
+    captured_sqes[2].io->on_io_complete(captured_sqes[2].io->on_io_complete_context, sizeof(destination));
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 0);
+    destroy_file_handle(file_handle);
+}
+
+/* on_file_preallocate_complete_linux */
+
+/*Tests_SRS_FILE_LINUX_01_091: [ on_file_preallocate_complete_linux shall set the preallocated end of the file to the preallocation target, even if the preallocation failed, so that a failing file system is only asked again once the writes get past the target. ]*/
+/*Tests_SRS_FILE_LINUX_01_092: [ on_file_preallocate_complete_linux shall mark the preallocation as not in progress. ]*/
+/*Tests_SRS_FILE_LINUX_01_093: [ on_file_preallocate_complete_linux shall decrement the number of pending I/O operations and wake up file_destroy if it reaches 0. ]*/
+TEST_FUNCTION(on_file_preallocate_complete_linux_moves_the_preallocated_end_to_the_target)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation(TEST_PREALLOCATION_CHUNK_SIZE);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), test_file_size - sizeof(source), mock_user_callback, (void*)0x4245));
+    previous_captured_sqe.io->on_io_complete(previous_captured_sqe.io->on_io_complete_context, sizeof(source));
+    IO_RING_LINUX_SQE fallocate_sqe = captured_sqe;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, test_file_size + TEST_PREALLOCATION_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+
+    ///act
+    fallocate_sqe.io->on_io_complete(fallocate_sqe.io->on_io_complete_context, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_090: [ If io_result is negative, on_file_preallocate_complete_linux shall log the error. ]*/
+/*Tests_SRS_FILE_LINUX_01_091: [ on_file_preallocate_complete_linux shall set the preallocated end of the file to the preallocation target, even if the preallocation failed, so that a failing file system is only asked again once the writes get past the target. ]*/
+TEST_FUNCTION(on_file_preallocate_complete_linux_with_error_moves_the_preallocated_end_to_the_target)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation(TEST_PREALLOCATION_CHUNK_SIZE);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), test_file_size - sizeof(source), mock_user_callback, (void*)0x4245));
+    previous_captured_sqe.io->on_io_complete(previous_captured_sqe.io->on_io_complete_context, sizeof(source));
+    IO_RING_LINUX_SQE fallocate_sqe = captured_sqe;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, test_file_size + TEST_PREALLOCATION_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+
+    ///act
+    fallocate_sqe.io->on_io_complete(fallocate_sqe.io->on_io_complete_context, -EOPNOTSUPP);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_085: [ If write_end + chunk_size / 2 is not greater than the preallocated end of the file, preallocate_ahead_if_needed shall return. ]*/
+TEST_FUNCTION(file_write_async_within_the_completed_preallocation_does_not_preallocate)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation(TEST_PREALLOCATION_CHUNK_SIZE);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), test_file_size - sizeof(source), mock_user_callback, (void*)0x4245));
+    previous_captured_sqe.io->on_io_complete(previous_captured_sqe.io->on_io_complete_context, sizeof(source));
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 0);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), test_file_size, mock_user_callback, (void*)0x4246);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/* file_set_write_aggregation */
+
+/*Tests_SRS_FILE_01_084: [ If handle is NULL then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_write_aggregation_fails_with_null_handle)
+{
+    ///arrange
+
+    ///act
+    int result = file_set_write_aggregation(NULL, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_085: [ If max_aggregated_size is 0 then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_write_aggregation_fails_with_zero_max_aggregated_size)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_set_write_aggregation(file_handle, 0, TEST_MAX_DELAY_MS);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_108: [ If max_aggregated_size is not a multiple of FILE_LINUX_WRITE_ALIGNMENT then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_write_aggregation_fails_when_max_aggregated_size_is_not_a_multiple_of_FILE_LINUX_WRITE_ALIGNMENT)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_set_write_aggregation(file_handle, 4096 + 512, TEST_MAX_DELAY_MS);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_086: [ If max_delay_ms is 0 then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_write_aggregation_fails_with_zero_max_delay_ms)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_set_write_aggregation(file_handle, TEST_MAX_AGGREGATED_SIZE, 0);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_087: [ If a write aggregation policy was already set on handle then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_write_aggregation_fails_when_a_policy_was_already_set)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+
+    ///act
+    int result = file_set_write_aggregation(file_handle, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_088: [ file_set_write_aggregation shall set the write aggregation policy of handle and return 0. ]*/
+/*Tests_SRS_FILE_01_090: [ The aggregation buffer shall be written when it holds max_aggregated_size bytes, when max_delay_ms milliseconds elapsed since it was started, when a write does not continue it, or when the file is destroyed. ]*/
+/*Tests_SRS_FILE_LINUX_01_222: [ file_set_write_aggregation shall call fstat to get the size of the file. ]*/
+/*Tests_SRS_FILE_LINUX_01_109: [ file_set_write_aggregation shall call write_aggregator_create with FILE_LINUX_WRITE_ALIGNMENT, max_aggregated_size, max_delay_ms, the size of the file, issue_aggregated_write, start_aggregation_timer, set_aggregated_file_size and handle. ]*/
+/*Tests_SRS_FILE_LINUX_01_111: [ file_set_write_aggregation shall store the write aggregator in handle and return 0. ]*/
+TEST_FUNCTION(file_set_write_aggregation_succeeds)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(mock_fstat(fake_fd, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_create(4096, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, test_file_size, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, file_handle));
+
+    ///act
+    int result = file_set_write_aggregation(file_handle, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_issue_io);
+    ASSERT_IS_NOT_NULL(captured_start_timer);
+    ASSERT_IS_NOT_NULL(captured_set_file_size);
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_092: [ If there are any other failures, file_set_write_aggregation shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_223: [ If fstat fails, file_set_write_aggregation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_write_aggregation_fails_when_fstat_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(mock_fstat(fake_fd, IGNORED_ARG))
+        .SetReturn(-1);
+
+    ///act
+    int result = file_set_write_aggregation(file_handle, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_092: [ If there are any other failures, file_set_write_aggregation shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_110: [ If write_aggregator_create fails, file_set_write_aggregation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_write_aggregation_fails_when_write_aggregator_create_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(mock_fstat(fake_fd, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_create(4096, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, test_file_size, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, file_handle))
+        .SetReturn(NULL);
+
+    ///act
+    int result = file_set_write_aggregation(file_handle, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_write_async with write aggregation */
+
+/*Tests_SRS_FILE_01_089: [ When a write aggregation policy is set, file_write_async shall copy writes smaller than max_aggregated_size that continue the previous write or start at an aligned position into the aggregation buffer and return FILE_WRITE_ASYNC_OK. ]*/
+/*Tests_SRS_FILE_LINUX_01_104: [ If a write aggregation policy is set, file_write_async shall call write_aggregator_add with source, size, position, user_callback and user_context. ]*/
+/*Tests_SRS_FILE_LINUX_01_105: [ If write_aggregator_add returns WRITE_AGGREGATOR_ADD_OK, file_write_async shall call preallocate_ahead_if_needed with position + size and return FILE_WRITE_ASYNC_OK. ]*/
+TEST_FUNCTION(file_write_async_with_write_aggregation_hands_the_write_to_the_write_aggregator)
+{
+    ///arrange
+    unsigned char source[100];
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+
+    STRICT_EXPECTED_CALL(write_aggregator_add(test_write_aggregator, source, sizeof(source), 8192, mock_user_callback, (void*)0x4245));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 8192, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_105: [ If write_aggregator_add returns WRITE_AGGREGATOR_ADD_OK, file_write_async shall call preallocate_ahead_if_needed with position + size and return FILE_WRITE_ASYNC_OK. ]*/
+TEST_FUNCTION(file_write_async_with_write_aggregation_close_to_the_preallocated_end_submits_a_fallocate)
+{
+    ///arrange
+    unsigned char source[100];
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation(TEST_PREALLOCATION_CHUNK_SIZE);
+
+    STRICT_EXPECTED_CALL(mock_fstat(fake_fd, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_create(4096, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, test_file_size, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, file_handle));
+    ASSERT_ARE_EQUAL(int, 0, file_set_write_aggregation(file_handle, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(write_aggregator_add(test_write_aggregator, source, sizeof(source), test_file_size - sizeof(source), mock_user_callback, (void*)0x4245));
+    setup_preallocation_expected_calls();
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), test_file_size - sizeof(source), mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    assert_fallocate_sqe(test_file_size, TEST_PREALLOCATION_CHUNK_SIZE);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 0);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_106: [ If write_aggregator_add returns WRITE_AGGREGATOR_ADD_ERROR, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
+TEST_FUNCTION(file_write_async_with_write_aggregation_fails_when_write_aggregator_add_fails)
+{
+    ///arrange
+    unsigned char source[100];
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+
+    STRICT_EXPECTED_CALL(write_aggregator_add(test_write_aggregator, source, sizeof(source), 8192, mock_user_callback, (void*)0x4245))
+        .SetReturn(WRITE_AGGREGATOR_ADD_ERROR);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 8192, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_107: [ If no write aggregation policy is set or write_aggregator_add returns WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, file_write_async shall issue the write by itself. ]*/
+TEST_FUNCTION(file_write_async_with_write_aggregation_issues_the_writes_that_are_not_aggregated)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+
+    STRICT_EXPECTED_CALL(write_aggregator_add(test_write_aggregator, source, sizeof(source), 8192, mock_user_callback, (void*)0x4245))
+        .SetReturn(WRITE_AGGREGATOR_ADD_NOT_AGGREGATED);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 8192, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITE, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(uint64_t, 8192, captured_sqe.offset);
+    ASSERT_ARE_EQUAL(void_ptr, source, captured_sqe.address);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(source), captured_sqe.length);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/* file_destroy with write aggregation */
+
+/*Tests_SRS_FILE_LINUX_01_102: [ If a write aggregation policy is set, file_destroy shall call write_aggregator_flush to start writing the aggregated data that is not written yet. ]*/
+/*Tests_SRS_FILE_LINUX_01_103: [ If a write aggregation policy is set, file_destroy shall call write_aggregator_destroy once all pending I/O operations completed. ]*/
+TEST_FUNCTION(file_destroy_with_write_aggregation_flushes_and_destroys_the_write_aggregator)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+
+    STRICT_EXPECTED_CALL(write_aggregator_flush(test_write_aggregator));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(write_aggregator_destroy(test_write_aggregator));
+    STRICT_EXPECTED_CALL(mock_close(fake_fd));
+    STRICT_EXPECTED_CALL(io_context_pool_destroy(test_io_context_pool));
+    STRICT_EXPECTED_CALL(execution_engine_dec_ref(fake_execution_engine));
+    STRICT_EXPECTED_CALL(free(file_handle));
+
+    ///act
+    file_destroy(file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* issue_aggregated_write */
+
+/*Tests_SRS_FILE_LINUX_01_112: [ issue_aggregated_write shall get a context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_LINUX_01_114: [ issue_aggregated_write shall increment the number of pending I/O operations and prepare an IORING_OP_WRITE entry for the file descriptor and the buffer, size and position of the aggregated write. ]*/
+/*Tests_SRS_FILE_LINUX_01_116: [ Otherwise issue_aggregated_write shall succeed and return 0. ]*/
+TEST_FUNCTION(issue_aggregated_write_submits_a_write)
+{
+    ///arrange
+    unsigned char buffer[8192];
+    WRITE_AGGREGATOR_IO aggregated_io = { 4096, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    int result = captured_issue_io(captured_write_aggregator_context, &aggregated_io);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITE, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(int32_t, fake_fd, captured_sqe.fd);
+    ASSERT_ARE_EQUAL(uint64_t, 4096, captured_sqe.offset);
+    ASSERT_ARE_EQUAL(void_ptr, buffer, captured_sqe.address);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(buffer), captured_sqe.length);
+    ASSERT_IS_NOT_NULL(captured_sqe.io);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(buffer));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_113: [ If io_context_pool_get fails, issue_aggregated_write shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(issue_aggregated_write_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    unsigned char buffer[8192];
+    WRITE_AGGREGATOR_IO aggregated_io = { 4096, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    int result = captured_issue_io(captured_write_aggregator_context, &aggregated_io);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_115: [ If start_io fails, issue_aggregated_write shall decrement the number of pending I/O operations, release the context and return a non-zero value. ]*/
+TEST_FUNCTION(issue_aggregated_write_fails_when_io_ring_linux_submit_fails)
+{
+    ///arrange
+    unsigned char buffer[8192];
+    WRITE_AGGREGATOR_IO aggregated_io = { 4096, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    int result = captured_issue_io(captured_write_aggregator_context, &aggregated_io);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* on_file_aggregated_write_complete_linux */
+
+/*Tests_SRS_FILE_01_091: [ When the aggregated write completes, the user_callback of every write copied in it shall be called with user_context and the result of the aggregated write. ]*/
+/*Tests_SRS_FILE_LINUX_01_117: [ on_file_aggregated_write_complete_linux shall release context to the I/O context pool of the file handle. ]*/
+/*Tests_SRS_FILE_LINUX_01_118: [ on_file_aggregated_write_complete_linux shall call write_aggregator_io_complete with is_successful as true if and only if io_result is equal to the size of the aggregated write. ]*/
+/*Tests_SRS_FILE_LINUX_01_119: [ on_file_aggregated_write_complete_linux shall decrement the number of pending I/O operations and wake up file_destroy if it reaches 0. ]*/
+TEST_FUNCTION(on_file_aggregated_write_complete_linux_calls_write_aggregator_io_complete_with_true)
+{
+    ///arrange
+    unsigned char buffer[8192];
+    WRITE_AGGREGATOR_IO aggregated_io = { 4096, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+    start_aggregated_write(&aggregated_io);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_io_complete(test_write_aggregator, &aggregated_io, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(buffer));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_142: [ When a read-ahead policy is set, the blocks that overlap the written range shall be dropped again when the write completes, before its user_callback is called, so that a block read while the write was in flight is not served. ]*/
+/*Tests_SRS_FILE_LINUX_01_231: [ If a read-ahead policy is set, on_file_aggregated_write_complete_linux shall call read_ahead_invalidate with the position and size of the aggregated write. ]*/
+TEST_FUNCTION(on_file_aggregated_write_complete_linux_with_read_ahead_invalidates_the_aggregated_range)
+{
+    ///arrange
+    unsigned char buffer[8192];
+    WRITE_AGGREGATOR_IO aggregated_io = { 4096, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+    STRICT_EXPECTED_CALL(read_ahead_create(4096, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT, IGNORED_ARG, file_handle));
+    ASSERT_ARE_EQUAL(int, 0, file_set_read_ahead(file_handle, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT));
+    umock_c_reset_all_calls();
+    start_aggregated_write(&aggregated_io);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 4096, sizeof(buffer)));
+    STRICT_EXPECTED_CALL(write_aggregator_io_complete(test_write_aggregator, &aggregated_io, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(buffer));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_118: [ on_file_aggregated_write_complete_linux shall call write_aggregator_io_complete with is_successful as true if and only if io_result is equal to the size of the aggregated write. ]*/
+TEST_FUNCTION(on_file_aggregated_write_complete_linux_with_partial_write_calls_write_aggregator_io_complete_with_false)
+{
+    ///arrange
+    unsigned char buffer[8192];
+    WRITE_AGGREGATOR_IO aggregated_io = { 4096, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+    start_aggregated_write(&aggregated_io);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_io_complete(test_write_aggregator, &aggregated_io, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 4096);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_118: [ on_file_aggregated_write_complete_linux shall call write_aggregator_io_complete with is_successful as true if and only if io_result is equal to the size of the aggregated write. ]*/
+TEST_FUNCTION(on_file_aggregated_write_complete_linux_with_error_calls_write_aggregator_io_complete_with_false)
+{
+    ///arrange
+    unsigned char buffer[8192];
+    WRITE_AGGREGATOR_IO aggregated_io = { 4096, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+    start_aggregated_write(&aggregated_io);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_io_complete(test_write_aggregator, &aggregated_io, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, -EIO);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* start_aggregation_timer */
+
+/*Tests_SRS_FILE_LINUX_01_120: [ start_aggregation_timer shall get a context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_LINUX_01_122: [ start_aggregation_timer shall increment the number of pending I/O operations and call io_ring_linux_submit with an IORING_OP_TIMEOUT entry that expires after delay_ms milliseconds. ]*/
+/*Tests_SRS_FILE_LINUX_01_127: [ Otherwise start_aggregation_timer shall succeed and return 0. ]*/
+TEST_FUNCTION(start_aggregation_timer_submits_a_timeout)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    int result = captured_start_timer(captured_write_aggregator_context, 1500, 42);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_TIMEOUT, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(int32_t, -1, captured_sqe.fd);
+    ASSERT_ARE_EQUAL(uint64_t, 0, captured_sqe.offset);
+    ASSERT_ARE_EQUAL(uint32_t, 1, captured_sqe.length);
+    const struct __kernel_timespec* timeout = captured_sqe.address;
+    ASSERT_ARE_EQUAL(int64_t, 1, (int64_t)timeout->tv_sec);
+    ASSERT_ARE_EQUAL(int64_t, 500000000, (int64_t)timeout->tv_nsec);
+    ASSERT_IS_NOT_NULL(captured_sqe.io);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, -ETIME);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_121: [ If io_context_pool_get fails, start_aggregation_timer shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(start_aggregation_timer_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    int result = captured_start_timer(captured_write_aggregator_context, TEST_MAX_DELAY_MS, 42);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_123: [ If io_ring_linux_submit fails, start_aggregation_timer shall decrement the number of pending I/O operations, release the context and return a non-zero value. ]*/
+TEST_FUNCTION(start_aggregation_timer_fails_when_io_ring_linux_submit_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    int result = captured_start_timer(captured_write_aggregator_context, TEST_MAX_DELAY_MS, 42);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* on_file_aggregation_timer_linux */
+
+/*Tests_SRS_FILE_LINUX_01_125: [ on_file_aggregation_timer_linux shall release context to the I/O context pool and call write_aggregator_on_timer with the timer id. ]*/
+/*Tests_SRS_FILE_LINUX_01_126: [ on_file_aggregation_timer_linux shall decrement the number of pending I/O operations and wake up file_destroy if it reaches 0. ]*/
+TEST_FUNCTION(on_file_aggregation_timer_linux_calls_write_aggregator_on_timer)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+    start_aggregation_timer_on_ring(TEST_MAX_DELAY_MS, 42);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_on_timer(test_write_aggregator, 42));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, -ETIME);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_124: [ If io_result is neither -ETIME nor 0, on_file_aggregation_timer_linux shall log the error and still consider the timer expired. ]*/
+TEST_FUNCTION(on_file_aggregation_timer_linux_with_error_still_calls_write_aggregator_on_timer)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+    start_aggregation_timer_on_ring(TEST_MAX_DELAY_MS, 42);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_on_timer(test_write_aggregator, 42));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, -ECANCELED);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* set_aggregated_file_size */
+
+/*Tests_SRS_FILE_LINUX_01_224: [ set_aggregated_file_size shall call ftruncate with the file descriptor and file_size to drop the padding written after the aggregated data. ]*/
+/*Tests_SRS_FILE_LINUX_01_226: [ Otherwise set_aggregated_file_size shall succeed and return 0. ]*/
+TEST_FUNCTION(set_aggregated_file_size_truncates_the_file)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+
+    STRICT_EXPECTED_CALL(mock_ftruncate(fake_fd, 4100));
+
+    ///act
+    int result = captured_set_file_size(captured_write_aggregator_context, 4100);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_225: [ If ftruncate fails, set_aggregated_file_size shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(set_aggregated_file_size_fails_when_ftruncate_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+
+    STRICT_EXPECTED_CALL(mock_ftruncate(fake_fd, 4100))
+        .SetReturn(-1);
+
+    ///act
+    int result = captured_set_file_size(captured_write_aggregator_context, 4100);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* writes that bypass the write aggregator */
+
+/*Tests_SRS_FILE_LINUX_01_227: [ If a write aggregation policy is set, file_write_async_v shall call write_aggregator_note_write with position and the sum of the buffer lengths. ]*/
+TEST_FUNCTION(file_write_async_v_with_write_aggregation_notes_the_write)
+{
+    ///arrange
+    unsigned char buffer_1[4096];
+    unsigned char buffer_2[8192];
+    FILE_BUFFER buffers[2] = { { buffer_1, sizeof(buffer_1) }, { buffer_2, sizeof(buffer_2) } };
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+
+    STRICT_EXPECTED_CALL(write_aggregator_note_write(test_write_aggregator, 8192, sizeof(buffer_1) + sizeof(buffer_2)));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 8192, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(buffer_1) + sizeof(buffer_2));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_228: [ If a write aggregation policy is set, file_batch_add_write shall call write_aggregator_note_write with position and size. ]*/
+TEST_FUNCTION(file_batch_add_write_with_write_aggregation_notes_the_write)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    STRICT_EXPECTED_CALL(write_aggregator_note_write(test_write_aggregator, 8192, sizeof(source)));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    int result = file_batch_add_write(batch, source, sizeof(source), 8192, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_229: [ If a write aggregation policy is set on destination, file_copy_range_async shall call write_aggregator_note_write with the destination range. ]*/
+TEST_FUNCTION(file_copy_range_async_with_write_aggregation_on_the_destination_notes_the_write)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("source.txt");
+    FILE_HANDLE destination = get_file_handle_with_write_aggregation();
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(write_aggregator_note_write(test_write_aggregator, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_worker_pool(fake_execution_engine));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG));
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 2 * TEST_COPY_CHUNK_SIZE, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    run_copy_work_item();
+    destroy_file_handle(source);
+    destroy_file_handle(destination);
+}
+
+/* file_set_read_ahead */
+
+/*Tests_SRS_FILE_01_093: [ If handle is NULL then file_set_read_ahead shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_read_ahead_fails_with_null_handle)
+{
+    ///arrange
+
+    ///act
+    int result = file_set_read_ahead(NULL, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_094: [ If block_size is 0 then file_set_read_ahead shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_read_ahead_fails_with_zero_block_size)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_set_read_ahead(file_handle, 0, TEST_READ_AHEAD_BLOCK_COUNT);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_138: [ If block_size is not a multiple of FILE_LINUX_WRITE_ALIGNMENT then file_set_read_ahead shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_read_ahead_fails_when_block_size_is_not_a_multiple_of_FILE_LINUX_WRITE_ALIGNMENT)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_set_read_ahead(file_handle, 4096 + 512, TEST_READ_AHEAD_BLOCK_COUNT);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_095: [ If block_count is 0 then file_set_read_ahead shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_read_ahead_fails_with_zero_block_count)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_set_read_ahead(file_handle, TEST_READ_AHEAD_BLOCK_SIZE, 0);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_096: [ If a read-ahead policy was already set on handle then file_set_read_ahead shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_read_ahead_fails_when_a_policy_was_already_set)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    ///act
+    int result = file_set_read_ahead(file_handle, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_097: [ file_set_read_ahead shall set the read-ahead policy of handle and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_139: [ file_set_read_ahead shall call read_ahead_create with FILE_LINUX_WRITE_ALIGNMENT, block_size, block_count, issue_read_ahead and handle. ]*/
+/*Tests_SRS_FILE_LINUX_01_141: [ file_set_read_ahead shall store the read-ahead in handle and return 0. ]*/
+TEST_FUNCTION(file_set_read_ahead_succeeds)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(read_ahead_create(4096, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT, IGNORED_ARG, file_handle));
+
+    ///act
+    int result = file_set_read_ahead(file_handle, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_read_ahead_issue_io);
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_101: [ If there are any other failures, file_set_read_ahead shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_140: [ If read_ahead_create fails, file_set_read_ahead shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_read_ahead_fails_when_read_ahead_create_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(read_ahead_create(4096, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT, IGNORED_ARG, file_handle))
+        .SetReturn(NULL);
+
+    ///act
+    int result = file_set_read_ahead(file_handle, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_read_async with read-ahead */
+
+/*Tests_SRS_FILE_01_098: [ When a read-ahead policy is set, file_read_async shall serve reads that fit in one block from the blocks of handle and, when the reads are sequential, keep up to block_count blocks following the read in flight. ]*/
+/*Tests_SRS_FILE_LINUX_01_131: [ If a read-ahead policy is set, file_read_async shall call read_ahead_read with destination, size, position, user_callback and user_context. ]*/
+/*Tests_SRS_FILE_LINUX_01_132: [ If read_ahead_read returns READ_AHEAD_READ_OK, file_read_async shall return FILE_READ_ASYNC_OK. ]*/
+TEST_FUNCTION(file_read_async_with_read_ahead_hands_the_read_to_the_read_ahead)
+{
+    ///arrange
+    unsigned char destination[100];
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(read_ahead_read(test_read_ahead, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4245));
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_133: [ If read_ahead_read returns READ_AHEAD_READ_ERROR, file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+TEST_FUNCTION(file_read_async_with_read_ahead_fails_when_read_ahead_read_fails)
+{
+    ///arrange
+    unsigned char destination[100];
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(read_ahead_read(test_read_ahead, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4245))
+        .SetReturn(READ_AHEAD_READ_ERROR);
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_134: [ If read_ahead_read returns READ_AHEAD_READ_COPIED, file_read_async shall call io_ring_linux_submit with an IORING_OP_NOP entry for 0 bytes, so that user_callback is called with is_successful as true when it completes. ]*/
+TEST_FUNCTION(file_read_async_with_read_ahead_submits_a_nop_when_the_data_was_copied)
+{
+    ///arrange
+    unsigned char destination[100];
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(read_ahead_read(test_read_ahead, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4245))
+        .SetReturn(READ_AHEAD_READ_COPIED);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_NOP, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(int32_t, -1, captured_sqe.fd);
+    ASSERT_ARE_EQUAL(uint32_t, 0, captured_sqe.length);
+    ASSERT_IS_NOT_NULL(captured_sqe.io);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 0);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_099: [ A read served from a block shall call user_callback asynchronously, after file_read_async returned. ]*/
+/*Tests_SRS_FILE_LINUX_01_134: [ If read_ahead_read returns READ_AHEAD_READ_COPIED, file_read_async shall call io_ring_linux_submit with an IORING_OP_NOP entry for 0 bytes, so that user_callback is called with is_successful as true when it completes. ]*/
+TEST_FUNCTION(on_file_io_complete_linux_for_a_copied_read_calls_callback_with_true)
+{
+    ///arrange
+    unsigned char destination[100];
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(read_ahead_read(test_read_ahead, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4245))
+        .SetReturn(READ_AHEAD_READ_COPIED);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async(file_handle, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_135: [ If no read-ahead policy is set or read_ahead_read returns READ_AHEAD_READ_NOT_HANDLED, file_read_async shall issue the read by itself. ]*/
+TEST_FUNCTION(file_read_async_with_read_ahead_issues_the_reads_that_are_not_handled)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(read_ahead_read(test_read_ahead, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4245))
+        .SetReturn(READ_AHEAD_READ_NOT_HANDLED);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_READ, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(int32_t, fake_fd, captured_sqe.fd);
+    ASSERT_ARE_EQUAL(uint64_t, 8192, captured_sqe.offset);
+    ASSERT_ARE_EQUAL(void_ptr, destination, captured_sqe.address);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(destination), captured_sqe.length);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(destination));
+    destroy_file_handle(file_handle);
+}
+
+/* writes with read-ahead */
+
+/*Tests_SRS_FILE_01_100: [ When a read-ahead policy is set, file_write_async, file_write_async_v and file_batch_add_write shall drop the blocks that overlap the written range. ]*/
+/*Tests_SRS_FILE_LINUX_01_130: [ If a read-ahead policy is set, file_write_async shall call read_ahead_invalidate with position and size. ]*/
+TEST_FUNCTION(file_write_async_with_read_ahead_invalidates_the_written_range)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 8192, sizeof(source)));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 8192, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_136: [ If a read-ahead policy is set, file_write_async_v shall call read_ahead_invalidate with position and the sum of the buffer lengths. ]*/
+TEST_FUNCTION(file_write_async_v_with_read_ahead_invalidates_the_written_range)
+{
+    ///arrange
+    unsigned char buffer_1[4096];
+    unsigned char buffer_2[8192];
+    FILE_BUFFER buffers[2] = { { buffer_1, sizeof(buffer_1) }, { buffer_2, sizeof(buffer_2) } };
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 8192, sizeof(buffer_1) + sizeof(buffer_2)));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 8192, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(buffer_1) + sizeof(buffer_2));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_137: [ If a read-ahead policy is set, file_batch_add_write shall call read_ahead_invalidate with position and size. ]*/
+TEST_FUNCTION(file_batch_add_write_with_read_ahead_invalidates_the_written_range)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 8192, sizeof(source)));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    int result = file_batch_add_write(batch, source, sizeof(source), 8192, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_142: [ When a read-ahead policy is set, the blocks that overlap the written range shall be dropped again when the write completes, before its user_callback is called, so that a block read while the write was in flight is not served. ]*/
+/*Tests_SRS_FILE_LINUX_01_230: [ If the I/O is a write and a read-ahead policy is set, on_file_io_complete_linux shall call read_ahead_invalidate with the position and size of the write before calling user_callback. ]*/
+TEST_FUNCTION(on_file_io_complete_linux_for_a_write_invalidates_the_blocks_read_while_the_write_was_in_flight)
+{
+    ///arrange
+    unsigned char source[4096];
+    unsigned char destination[100];
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 8192, sizeof(source)));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 8192, mock_user_callback, (void*)0x4245));
+    IO_RING_LINUX_IO* write_io = captured_sqe.io;
+
+    /*the read starts the read of a block over the range of the write while the write is in flight*/
+    STRICT_EXPECTED_CALL(read_ahead_read(test_read_ahead, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4246));
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async(file_handle, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4246));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 8192, sizeof(source)));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    write_io->on_io_complete(write_io->on_io_complete_context, sizeof(source));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_230: [ If the I/O is a write and a read-ahead policy is set, on_file_io_complete_linux shall call read_ahead_invalidate with the position and size of the write before calling user_callback. ]*/
+TEST_FUNCTION(on_file_io_complete_linux_for_a_failed_write_invalidates_the_written_range)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 8192, sizeof(source)));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 8192, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 8192, sizeof(source)));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, -EIO);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_230: [ If the I/O is a write and a read-ahead policy is set, on_file_io_complete_linux shall call read_ahead_invalidate with the position and size of the write before calling user_callback. ]*/
+TEST_FUNCTION(on_file_io_complete_linux_for_a_batch_write_invalidates_the_written_range)
+{
+    ///arrange
+    unsigned char source[4096];
+    uint32_t submitted_count = 0;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 8192, mock_user_callback, (void*)0x4245));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_submit(batch, &submitted_count));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 8192, sizeof(source)));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqes[0].io->on_io_complete(captured_sqes[0].io->on_io_complete_context, sizeof(source));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_230: [ If the I/O is a write and a read-ahead policy is set, on_file_io_complete_linux shall call read_ahead_invalidate with the position and size of the write before calling user_callback. ]*/
+TEST_FUNCTION(on_file_io_complete_linux_for_a_batch_read_does_not_invalidate)
+{
+    ///arrange
+    unsigned char destination[4096];
+    uint32_t submitted_count = 0;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4245));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_submit(batch, &submitted_count));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqes[0].io->on_io_complete(captured_sqes[0].io->on_io_complete_context, sizeof(destination));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_destroy with read-ahead */
+
+/*Tests_SRS_FILE_LINUX_01_129: [ If a read-ahead policy is set, file_destroy shall call read_ahead_destroy once all pending I/O operations completed. ]*/
+TEST_FUNCTION(file_destroy_with_read_ahead_destroys_the_read_ahead)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(read_ahead_destroy(test_read_ahead));
+    STRICT_EXPECTED_CALL(mock_close(fake_fd));
+    STRICT_EXPECTED_CALL(io_context_pool_destroy(test_io_context_pool));
+    STRICT_EXPECTED_CALL(execution_engine_dec_ref(fake_execution_engine));
+    STRICT_EXPECTED_CALL(free(file_handle));
+
+    ///act
+    file_destroy(file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* issue_read_ahead */
+
+/*Tests_SRS_FILE_LINUX_01_142: [ issue_read_ahead shall get a context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_LINUX_01_144: [ issue_read_ahead shall increment the number of pending I/O operations and prepare an IORING_OP_READ entry for the file descriptor and the buffer, size and position of the block. ]*/
+/*Tests_SRS_FILE_LINUX_01_146: [ Otherwise issue_read_ahead shall succeed and return 0. ]*/
+TEST_FUNCTION(issue_read_ahead_submits_a_read)
+{
+    ///arrange
+    unsigned char buffer[TEST_READ_AHEAD_BLOCK_SIZE];
+    READ_AHEAD_IO read_ahead_io = { TEST_READ_AHEAD_BLOCK_SIZE, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    int result = captured_read_ahead_issue_io(captured_read_ahead_context, &read_ahead_io);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_READ, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(int32_t, fake_fd, captured_sqe.fd);
+    ASSERT_ARE_EQUAL(uint64_t, TEST_READ_AHEAD_BLOCK_SIZE, captured_sqe.offset);
+    ASSERT_ARE_EQUAL(void_ptr, buffer, captured_sqe.address);
+    ASSERT_ARE_EQUAL(uint32_t, sizeof(buffer), captured_sqe.length);
+    ASSERT_IS_NOT_NULL(captured_sqe.io);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(buffer));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_143: [ If io_context_pool_get fails, issue_read_ahead shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(issue_read_ahead_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    unsigned char buffer[TEST_READ_AHEAD_BLOCK_SIZE];
+    READ_AHEAD_IO read_ahead_io = { TEST_READ_AHEAD_BLOCK_SIZE, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    int result = captured_read_ahead_issue_io(captured_read_ahead_context, &read_ahead_io);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_145: [ If start_io fails, issue_read_ahead shall decrement the number of pending I/O operations, release the context and return a non-zero value. ]*/
+TEST_FUNCTION(issue_read_ahead_fails_when_io_ring_linux_submit_fails)
+{
+    ///arrange
+    unsigned char buffer[TEST_READ_AHEAD_BLOCK_SIZE];
+    READ_AHEAD_IO read_ahead_io = { TEST_READ_AHEAD_BLOCK_SIZE, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    int result = captured_read_ahead_issue_io(captured_read_ahead_context, &read_ahead_io);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* on_file_read_ahead_complete_linux */
+
+/*Tests_SRS_FILE_LINUX_01_147: [ on_file_read_ahead_complete_linux shall release context to the I/O context pool of the file handle. ]*/
+/*Tests_SRS_FILE_LINUX_01_148: [ on_file_read_ahead_complete_linux shall call read_ahead_io_complete with is_successful as true if and only if io_result is not negative and with io_result as the number of bytes read. ]*/
+/*Tests_SRS_FILE_LINUX_01_149: [ on_file_read_ahead_complete_linux shall decrement the number of pending I/O operations and wake up file_destroy if it reaches 0. ]*/
+TEST_FUNCTION(on_file_read_ahead_complete_linux_calls_read_ahead_io_complete_with_true)
+{
+    ///arrange
+    unsigned char buffer[TEST_READ_AHEAD_BLOCK_SIZE];
+    READ_AHEAD_IO read_ahead_io = { TEST_READ_AHEAD_BLOCK_SIZE, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+    start_read_ahead(&read_ahead_io);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_io_complete(test_read_ahead, &read_ahead_io, true, sizeof(buffer)));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(buffer));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_148: [ on_file_read_ahead_complete_linux shall call read_ahead_io_complete with is_successful as true if and only if io_result is not negative and with io_result as the number of bytes read. ]*/
+TEST_FUNCTION(on_file_read_ahead_complete_linux_at_the_end_of_the_file_passes_the_bytes_read)
+{
+    ///arrange
+    unsigned char buffer[TEST_READ_AHEAD_BLOCK_SIZE];
+    READ_AHEAD_IO read_ahead_io = { TEST_READ_AHEAD_BLOCK_SIZE, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+    start_read_ahead(&read_ahead_io);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_io_complete(test_read_ahead, &read_ahead_io, true, 4096));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 4096);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_148: [ on_file_read_ahead_complete_linux shall call read_ahead_io_complete with is_successful as true if and only if io_result is not negative and with io_result as the number of bytes read. ]*/
+TEST_FUNCTION(on_file_read_ahead_complete_linux_with_error_calls_read_ahead_io_complete_with_false)
+{
+    ///arrange
+    unsigned char buffer[TEST_READ_AHEAD_BLOCK_SIZE];
+    READ_AHEAD_IO read_ahead_io = { TEST_READ_AHEAD_BLOCK_SIZE, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+    start_read_ahead(&read_ahead_io);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_io_complete(test_read_ahead, &read_ahead_io, false, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, -EIO);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_set_access_hint */
+
+/*Tests_SRS_FILE_01_102: [ If handle is NULL then file_set_access_hint shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_access_hint_fails_with_null_handle)
+{
+    ///arrange
+
+    ///act
+    int result = file_set_access_hint(NULL, FILE_ACCESS_HINT_SEQUENTIAL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_103: [ If access_hint is not FILE_ACCESS_HINT_NORMAL, FILE_ACCESS_HINT_SEQUENTIAL or FILE_ACCESS_HINT_RANDOM then file_set_access_hint shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_access_hint_fails_with_FILE_ACCESS_HINT_WILL_NEED)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    ///act
+    int result = file_set_access_hint(file_handle, FILE_ACCESS_HINT_WILL_NEED);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_103: [ If access_hint is not FILE_ACCESS_HINT_NORMAL, FILE_ACCESS_HINT_SEQUENTIAL or FILE_ACCESS_HINT_RANDOM then file_set_access_hint shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_access_hint_fails_with_invalid_access_hint)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    ///act
+    int result = file_set_access_hint(file_handle, (FILE_ACCESS_HINT)0x42);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_104: [ If no read-ahead policy was set on handle then file_set_access_hint shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_access_hint_fails_when_no_read_ahead_policy_was_set)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_set_access_hint(file_handle, FILE_ACCESS_HINT_SEQUENTIAL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_105: [ file_set_access_hint shall apply access_hint to the read-ahead policy of handle and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_150: [ file_set_access_hint shall call read_ahead_set_mode with READ_AHEAD_MODE_AUTO for FILE_ACCESS_HINT_NORMAL, READ_AHEAD_MODE_SEQUENTIAL for FILE_ACCESS_HINT_SEQUENTIAL and READ_AHEAD_MODE_OFF for FILE_ACCESS_HINT_RANDOM. ]*/
+TEST_FUNCTION(file_set_access_hint_with_FILE_ACCESS_HINT_NORMAL_sets_READ_AHEAD_MODE_AUTO)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(read_ahead_set_mode(test_read_ahead, READ_AHEAD_MODE_AUTO));
+
+    ///act
+    int result = file_set_access_hint(file_handle, FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_105: [ file_set_access_hint shall apply access_hint to the read-ahead policy of handle and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_150: [ file_set_access_hint shall call read_ahead_set_mode with READ_AHEAD_MODE_AUTO for FILE_ACCESS_HINT_NORMAL, READ_AHEAD_MODE_SEQUENTIAL for FILE_ACCESS_HINT_SEQUENTIAL and READ_AHEAD_MODE_OFF for FILE_ACCESS_HINT_RANDOM. ]*/
+TEST_FUNCTION(file_set_access_hint_with_FILE_ACCESS_HINT_SEQUENTIAL_sets_READ_AHEAD_MODE_SEQUENTIAL)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(read_ahead_set_mode(test_read_ahead, READ_AHEAD_MODE_SEQUENTIAL));
+
+    ///act
+    int result = file_set_access_hint(file_handle, FILE_ACCESS_HINT_SEQUENTIAL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_105: [ file_set_access_hint shall apply access_hint to the read-ahead policy of handle and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_150: [ file_set_access_hint shall call read_ahead_set_mode with READ_AHEAD_MODE_AUTO for FILE_ACCESS_HINT_NORMAL, READ_AHEAD_MODE_SEQUENTIAL for FILE_ACCESS_HINT_SEQUENTIAL and READ_AHEAD_MODE_OFF for FILE_ACCESS_HINT_RANDOM. ]*/
+TEST_FUNCTION(file_set_access_hint_with_FILE_ACCESS_HINT_RANDOM_sets_READ_AHEAD_MODE_OFF)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(read_ahead_set_mode(test_read_ahead, READ_AHEAD_MODE_OFF));
+
+    ///act
+    int result = file_set_access_hint(file_handle, FILE_ACCESS_HINT_RANDOM);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_106: [ If there are any other failures, file_set_access_hint shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_151: [ If read_ahead_set_mode fails, file_set_access_hint shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_access_hint_fails_when_read_ahead_set_mode_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(read_ahead_set_mode(test_read_ahead, READ_AHEAD_MODE_SEQUENTIAL))
+        .SetReturn(MU_FAILURE);
+
+    ///act
+    int result = file_set_access_hint(file_handle, FILE_ACCESS_HINT_SEQUENTIAL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_will_need */
+
+/*Tests_SRS_FILE_01_107: [ If handle is NULL then file_will_need shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_will_need_fails_with_null_handle)
+{
+    ///arrange
+
+    ///act
+    int result = file_will_need(NULL, 0, TEST_READ_AHEAD_BLOCK_SIZE);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_108: [ If size is 0 then file_will_need shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_will_need_fails_with_zero_size)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    ///act
+    int result = file_will_need(file_handle, 0, 0);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_109: [ If position + size overflows then file_will_need shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_will_need_fails_when_position_plus_size_overflows)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    ///act
+    int result = file_will_need(file_handle, UINT64_MAX - 10, 11);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_110: [ If no read-ahead policy was set on handle then file_will_need shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_will_need_fails_when_no_read_ahead_policy_was_set)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_will_need(file_handle, 0, TEST_READ_AHEAD_BLOCK_SIZE);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_111: [ file_will_need shall start reading the blocks that hold size bytes starting at position, up to block_count blocks, and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_152: [ file_will_need shall call read_ahead_will_need with position and size. ]*/
+TEST_FUNCTION(file_will_need_succeeds)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(read_ahead_will_need(test_read_ahead, 4096, 2 * TEST_READ_AHEAD_BLOCK_SIZE));
+
+    ///act
+    int result = file_will_need(file_handle, 4096, 2 * TEST_READ_AHEAD_BLOCK_SIZE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_112: [ If there are any other failures, file_will_need shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_153: [ If read_ahead_will_need fails, file_will_need shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_will_need_fails_when_read_ahead_will_need_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+
+    STRICT_EXPECTED_CALL(read_ahead_will_need(test_read_ahead, 4096, 2 * TEST_READ_AHEAD_BLOCK_SIZE))
+        .SetReturn(MU_FAILURE);
+
+    ///act
+    int result = file_will_need(file_handle, 4096, 2 * TEST_READ_AHEAD_BLOCK_SIZE);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_set_io_limit */
+
+/*Tests_SRS_FILE_01_113: [ If handle is NULL then file_set_io_limit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_io_limit_fails_with_null_handle)
+{
+    ///act
+    int result = file_set_io_limit(NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_114: [ If mode is not FILE_IO_LIMIT_MODE_BUSY or FILE_IO_LIMIT_MODE_QUEUE then file_set_io_limit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_io_limit_fails_with_invalid_mode)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_set_io_limit(file_handle, TEST_MAX_OUTSTANDING_IO, (FILE_IO_LIMIT_MODE)0x42);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_115: [ If an I/O limit was already set on handle then file_set_io_limit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_io_limit_fails_when_an_io_limit_was_already_set)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+
+    ///act
+    int result = file_set_io_limit(file_handle, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_115: [ If an I/O limit was already set on handle then file_set_io_limit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_io_limit_fails_when_an_io_limit_of_0_was_already_set)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(NULL, 0, FILE_IO_LIMIT_MODE_BUSY);
+
+    ///act
+    int result = file_set_io_limit(file_handle, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_116: [ file_set_io_limit shall set the I/O limit of handle to max_outstanding_io (no limit if max_outstanding_io is 0) and the mode to mode and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_185: [ Otherwise file_set_io_limit shall call io_admission_create with max_outstanding_io. ]*/
+/*Tests_SRS_FILE_LINUX_01_187: [ file_set_io_limit shall store the admission and mode in handle, mark the I/O limit as set and return 0. ]*/
+TEST_FUNCTION(file_set_io_limit_succeeds)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_admission_create(TEST_MAX_OUTSTANDING_IO));
+
+    ///act
+    int result = file_set_io_limit(file_handle, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_184: [ If max_outstanding_io is 0, file_set_io_limit shall not create an admission for handle. ]*/
+TEST_FUNCTION(file_set_io_limit_with_0_max_outstanding_io_does_not_create_an_admission)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_set_io_limit(file_handle, 0, FILE_IO_LIMIT_MODE_BUSY);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_121: [ If there are any other failures, file_set_io_limit shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_186: [ If io_admission_create fails, file_set_io_limit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_io_limit_fails_when_io_admission_create_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    STRICT_EXPECTED_CALL(io_admission_create(TEST_MAX_OUTSTANDING_IO))
+        .SetReturn(NULL);
+
+    ///act
+    int result = file_set_io_limit(file_handle, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_183: [ If an I/O limit is set on the file handle, file_destroy shall call io_admission_destroy once all pending I/O operations completed. ]*/
+TEST_FUNCTION(file_destroy_destroys_the_io_limit)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(io_admission_destroy(test_io_admission));
+    STRICT_EXPECTED_CALL(mock_close(fake_fd));
+    STRICT_EXPECTED_CALL(io_context_pool_destroy(test_io_context_pool));
+    STRICT_EXPECTED_CALL(execution_engine_dec_ref(fake_execution_engine));
+    STRICT_EXPECTED_CALL(free(file_handle));
+
+    ///act
+    file_destroy(file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_117: [ An I/O issued by file_write_async or file_read_async shall hold a slot of the I/O limit of handle and of the I/O limit of the execution engine from the moment it is started until it completes. ]*/
+/*Tests_SRS_FILE_LINUX_01_178: [ file_write_async shall start the write by calling start_io with the mode of the file handle, which submits it once it holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+/*Tests_SRS_FILE_LINUX_01_169: [ If io_limit_mode is FILE_IO_LIMIT_MODE_BUSY, acquire_io_slots shall call io_admission_try_acquire on the admission of the file handle, if it exists. ]*/
+/*Tests_SRS_FILE_LINUX_01_172: [ If the file handle admission returns IO_ADMISSION_ADMITTED or the file handle has no I/O limit, acquire_io_slots shall call acquire_engine_io_slot, whatever the mode. ]*/
+/*Tests_SRS_FILE_LINUX_01_156: [ submit_io shall call io_ring_linux_submit with the entry stored in the I/O context. ]*/
+/*Tests_SRS_FILE_LINUX_01_158: [ Otherwise submit_io shall succeed and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_174: [ If the I/O holds its slots and submit_io succeeds, start_io shall return FILE_LINUX_START_IO_OK. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_busy_takes_the_slots_and_submits_the_write)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 8192, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITE, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(uint64_t, 8192, captured_sqe.offset);
+    ASSERT_ARE_EQUAL(void_ptr, source, captured_sqe.address);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_118: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and no slot of the I/O limit of handle is free, file_write_async shall fail and return FILE_WRITE_ASYNC_BUSY and file_read_async shall fail and return FILE_READ_ASYNC_BUSY, without calling user_callback. ]*/
+/*Tests_SRS_FILE_LINUX_01_176: [ If io_admission_try_acquire returns IO_ADMISSION_BUSY, start_io shall return FILE_LINUX_START_IO_BUSY. ]*/
+/*Tests_SRS_FILE_LINUX_01_179: [ If start_io returns FILE_LINUX_START_IO_BUSY, file_write_async shall decrement the number of pending I/O operations, release the context and return FILE_WRITE_ASYNC_BUSY. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_busy_returns_BUSY_when_the_file_handle_has_no_free_slot)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission))
+        .SetReturn(IO_ADMISSION_BUSY);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_BUSY, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_119: [ When the mode is FILE_IO_LIMIT_MODE_QUEUE and no slot of the I/O limit of handle is free, or when no slot of the I/O limit of the execution engine is free, file_write_async and file_read_async shall queue the I/O and return FILE_WRITE_ASYNC_OK and FILE_READ_ASYNC_OK, the queued I/Os are started in order as slots are freed. ]*/
+/*Tests_SRS_FILE_LINUX_01_172: [ If the file handle admission returns IO_ADMISSION_ADMITTED or the file handle has no I/O limit, acquire_io_slots shall call acquire_engine_io_slot, whatever the mode. ]*/
+/*Tests_SRS_FILE_LINUX_01_175: [ If the I/O was queued, start_io shall return FILE_LINUX_START_IO_OK. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_busy_queues_the_write_when_the_execution_engine_has_no_free_slot)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    umock_c_reset_all_calls();
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_160: [ on_file_io_admitted_by_engine shall call submit_io. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_busy_submits_the_write_when_the_execution_engine_admits_it)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 8192, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITE, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(uint64_t, 8192, captured_sqe.offset);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_177: [ If acquiring a slot fails, start_io shall return FILE_LINUX_START_IO_ERROR. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_fails_when_io_admission_try_acquire_fails)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission))
+        .SetReturn(IO_ADMISSION_ERROR);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_157: [ If io_ring_linux_submit fails, submit_io shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_173: [ If submit_io fails, start_io shall call release_io_slots if the I/O holds slots and return FILE_LINUX_START_IO_SUBMIT_ERROR. ]*/
+/*Tests_SRS_FILE_LINUX_01_155: [ release_io_slots shall call io_admission_release on the admission of the execution engine and then on the admission of the file handle, for the ones that exist. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_releases_the_slots_when_io_ring_linux_submit_fails)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(io_admission_release(test_engine_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_WRITE_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_154: [ If the I/O holds slots of the I/O limits, on_file_io_complete_linux shall call release_io_slots before calling user_callback. ]*/
+/*Tests_SRS_FILE_LINUX_01_155: [ release_io_slots shall call io_admission_release on the admission of the execution engine and then on the admission of the file handle, for the ones that exist. ]*/
+TEST_FUNCTION(on_file_io_complete_linux_releases_the_slots_before_calling_the_callback)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_release(test_engine_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_168: [ If neither the file handle nor the execution engine have an I/O limit, acquire_io_slots shall return IO_ADMISSION_ADMITTED. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_of_0_and_no_execution_engine_limit_submits_the_write)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(NULL, 0, FILE_IO_LIMIT_MODE_BUSY);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_171: [ If io_limit_mode is FILE_IO_LIMIT_MODE_QUEUE, acquire_io_slots shall call io_admission_acquire on the admission of the file handle with on_file_io_admitted_by_handle as on_admitted, if it exists. ]*/
+/*Tests_SRS_FILE_LINUX_01_172: [ If the file handle admission returns IO_ADMISSION_ADMITTED or the file handle has no I/O limit, acquire_io_slots shall call acquire_engine_io_slot, whatever the mode. ]*/
+/*Tests_SRS_FILE_LINUX_01_162: [ acquire_engine_io_slot shall call io_admission_acquire on the admission of the execution engine with on_file_io_admitted_by_engine as on_admitted. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_queue_takes_the_slots_and_submits_the_write)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_119: [ When the mode is FILE_IO_LIMIT_MODE_QUEUE and no slot of the I/O limit of handle is free, or when no slot of the I/O limit of the execution engine is free, file_write_async and file_read_async shall queue the I/O and return FILE_WRITE_ASYNC_OK and FILE_READ_ASYNC_OK, the queued I/Os are started in order as slots are freed. ]*/
+/*Tests_SRS_FILE_LINUX_01_175: [ If the I/O was queued, start_io shall return FILE_LINUX_START_IO_OK. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_queue_queues_the_write_when_the_file_handle_has_no_free_slot)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    umock_c_reset_all_calls();
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_164: [ on_file_io_admitted_by_handle shall call acquire_engine_io_slot. ]*/
+/*Tests_SRS_FILE_LINUX_01_165: [ If acquire_engine_io_slot returns IO_ADMISSION_ADMITTED, on_file_io_admitted_by_handle shall call on_file_io_admitted_by_engine. ]*/
+/*Tests_SRS_FILE_LINUX_01_160: [ on_file_io_admitted_by_engine shall call submit_io. ]*/
+TEST_FUNCTION(on_file_io_admitted_by_handle_takes_the_slot_of_the_execution_engine_and_submits_the_write)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 4096, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITE, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(uint64_t, 4096, captured_sqe.offset);
+    ASSERT_ARE_EQUAL(void_ptr, source, captured_sqe.address);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_166: [ If acquire_engine_io_slot returns IO_ADMISSION_QUEUED, on_file_io_admitted_by_handle shall return. ]*/
+TEST_FUNCTION(on_file_io_admitted_by_handle_queues_the_write_when_the_execution_engine_has_no_free_slot)
+{
+    ///arrange
+    unsigned char source[4096];
+    IO_ADMISSION_WAITER* handle_waiter;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&handle_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    handle_waiter->on_admitted(handle_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    umock_c_reset_all_calls();
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_120: [ If a queued I/O fails to start, its user_callback shall be called with user_context and is_successful as false. ]*/
+/*Tests_SRS_FILE_LINUX_01_163: [ If io_admission_acquire fails, acquire_engine_io_slot shall release the slot of the file handle admission. ]*/
+/*Tests_SRS_FILE_LINUX_01_167: [ If acquire_engine_io_slot fails, on_file_io_admitted_by_handle shall call fail_queued_io. ]*/
+/*Tests_SRS_FILE_LINUX_01_159: [ fail_queued_io shall mark the I/O as not holding slots and call the completion callback of the I/O with -ECANCELED as io_result. ]*/
+TEST_FUNCTION(on_file_io_admitted_by_handle_fails_the_write_when_acquiring_the_slot_of_the_execution_engine_fails)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .SetReturn(IO_ADMISSION_ERROR);
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_161: [ If submit_io fails, on_file_io_admitted_by_engine shall call release_io_slots and fail_queued_io. ]*/
+TEST_FUNCTION(on_file_io_admitted_by_engine_fails_the_write_when_io_ring_linux_submit_fails)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(io_admission_release(test_engine_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_180: [ file_read_async shall start the read by calling start_io with the mode of the file handle, which submits it once it holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+TEST_FUNCTION(file_read_async_with_io_limit_busy_takes_the_slots_and_submits_the_read)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_READ, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(uint64_t, 8192, captured_sqe.offset);
+    ASSERT_ARE_EQUAL(void_ptr, destination, captured_sqe.address);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(destination));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_118: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and no slot of the I/O limit of handle is free, file_write_async shall fail and return FILE_WRITE_ASYNC_BUSY and file_read_async shall fail and return FILE_READ_ASYNC_BUSY, without calling user_callback. ]*/
+/*Tests_SRS_FILE_LINUX_01_181: [ If start_io returns FILE_LINUX_START_IO_BUSY, file_read_async shall decrement the number of pending I/O operations, release the context and return FILE_READ_ASYNC_BUSY. ]*/
+TEST_FUNCTION(file_read_async_with_io_limit_busy_returns_BUSY_when_the_file_handle_has_no_free_slot)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission))
+        .SetReturn(IO_ADMISSION_BUSY);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 0, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_BUSY, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_119: [ When the mode is FILE_IO_LIMIT_MODE_QUEUE and no slot of the I/O limit of handle is free, or when no slot of the I/O limit of the execution engine is free, file_write_async and file_read_async shall queue the I/O and return FILE_WRITE_ASYNC_OK and FILE_READ_ASYNC_OK, the queued I/Os are started in order as slots are freed. ]*/
+TEST_FUNCTION(file_read_async_with_execution_engine_limit_queues_the_read_when_the_execution_engine_has_no_free_slot)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_engine_io_admission("test_file.txt", test_engine_io_admission);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 0, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    umock_c_reset_all_calls();
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(destination));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_119: [ When the mode is FILE_IO_LIMIT_MODE_QUEUE and no slot of the I/O limit of handle is free, or when no slot of the I/O limit of the execution engine is free, file_write_async and file_read_async shall queue the I/O and return FILE_WRITE_ASYNC_OK and FILE_READ_ASYNC_OK, the queued I/Os are started in order as slots are freed. ]*/
+/*Tests_SRS_FILE_LINUX_01_172: [ If the file handle admission returns IO_ADMISSION_ADMITTED or the file handle has no I/O limit, acquire_io_slots shall call acquire_engine_io_slot, whatever the mode. ]*/
+TEST_FUNCTION(file_read_async_with_io_limit_busy_and_no_limit_of_its_own_queues_the_read_when_the_execution_engine_has_no_free_slot)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, 0, FILE_IO_LIMIT_MODE_BUSY);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 0, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    umock_c_reset_all_calls();
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(destination));
+    destroy_file_handle(file_handle);
+}
+
+/* file_get_io_admission_statistics */
+
+/*Tests_SRS_FILE_01_144: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and no slot of the I/O limit of handle is free, file_write_async_v shall fail and return FILE_WRITE_ASYNC_BUSY and file_read_async_v shall fail and return FILE_READ_ASYNC_BUSY, without calling user_callback. ]*/
+/*Tests_SRS_FILE_LINUX_01_247: [ file_write_async_v shall start the write by calling start_io with the mode of the file handle. ]*/
+/*Tests_SRS_FILE_LINUX_01_248: [ If start_io returns FILE_LINUX_START_IO_BUSY, file_write_async_v shall decrement the number of pending I/O operations, release the context and return FILE_WRITE_ASYNC_BUSY. ]*/
+TEST_FUNCTION(file_write_async_v_with_io_limit_busy_returns_BUSY_when_the_file_handle_has_no_free_slot)
+{
+    ///arrange
+    unsigned char header[512];
+    unsigned char payload[4096];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission))
+        .SetReturn(IO_ADMISSION_BUSY);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_BUSY, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_143: [ The I/Os of file_write_async_v, file_read_async_v and of the batches, the aggregated writes, the reads of read-ahead blocks and the flushes of handle shall also hold a slot of the I/O limit of handle and of the I/O limit of the execution engine from the moment they are started until they complete. ]*/
+/*Tests_SRS_FILE_LINUX_01_249: [ file_read_async_v shall start the read by calling start_io with the mode of the file handle. ]*/
+TEST_FUNCTION(file_read_async_v_with_io_limit_queue_submits_the_read_once_it_holds_its_slots)
+{
+    ///arrange
+    unsigned char header[512];
+    unsigned char payload[4096];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async_v(file_handle, buffers, 2, 4096, mock_user_callback, (void*)0x4245));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+
+    ///act
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_READV, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(uint64_t, 4096, captured_sqe.offset);
+    ASSERT_ARE_EQUAL(uint32_t, 2, captured_sqe.length);
+
+    ///cleanup
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(io_admission_release(test_engine_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(header) + sizeof(payload));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_145: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and the I/O limit of handle does not have a free slot for each of the I/Os of batch, file_batch_submit shall discard all the I/Os of batch without calling their user_callback, set submitted_count to 0, free batch and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_251: [ If the file handle has an I/O limit in FILE_IO_LIMIT_MODE_BUSY, file_batch_submit shall call io_admission_try_acquire on the admission of the file handle once for each I/O in the batch. ]*/
+/*Tests_SRS_FILE_LINUX_01_252: [ If io_admission_try_acquire does not return IO_ADMISSION_ADMITTED for each I/O, file_batch_submit shall call io_admission_release for each acquired slot, release the structs of all the I/Os to the I/O context pool, subtract their number from the number of pending I/O operations (waking up file_destroy if it reaches 0), set submitted_count to 0 and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_submit_with_io_limit_busy_discards_the_batch_when_the_file_handle_does_not_have_a_slot_for_each_io)
+{
+    ///arrange
+    unsigned char source[4096];
+    uint32_t submitted_count = 42;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, NULL));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 4096, mock_user_callback, NULL));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission))
+        .SetReturn(IO_ADMISSION_BUSY);
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, -2));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, submitted_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_251: [ If the file handle has an I/O limit in FILE_IO_LIMIT_MODE_BUSY, file_batch_submit shall call io_admission_try_acquire on the admission of the file handle once for each I/O in the batch. ]*/
+/*Tests_SRS_FILE_LINUX_01_253: [ If the slots of the file handle were acquired for the batch, file_batch_submit shall call acquire_engine_io_slot for each I/O. ]*/
+/*Tests_SRS_FILE_LINUX_01_037: [ file_batch_submit shall call io_ring_linux_submit once with the entries of all the I/Os of the batch that hold their slots. ]*/
+TEST_FUNCTION(file_batch_submit_with_io_limit_busy_takes_the_slots_of_the_whole_batch_and_submits_it)
+{
+    ///arrange
+    unsigned char source[4096];
+    unsigned char destination[4096];
+    uint32_t submitted_count = 0;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, (void*)0x4245));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4246));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 2, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, submitted_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITE, captured_sqes[0].opcode);
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_READ, captured_sqes[1].opcode);
+
+    ///cleanup
+    captured_sqes[0].io->on_io_complete(captured_sqes[0].io->on_io_complete_context, sizeof(source));
+    captured_sqes[1].io->on_io_complete(captured_sqes[1].io->on_io_complete_context, sizeof(destination));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_146: [ An I/O of a batch that waits for a slot of the I/O limits shall be queued and counted as issued by file_batch_submit. ]*/
+/*Tests_SRS_FILE_LINUX_01_254: [ Otherwise file_batch_submit shall call acquire_io_slots with the mode of the file handle for each I/O. ]*/
+/*Tests_SRS_FILE_LINUX_01_255: [ An I/O queued for a slot shall count as submitted, it is submitted by on_file_io_admitted_by_handle or on_file_io_admitted_by_engine. ]*/
+/*Tests_SRS_FILE_LINUX_01_037: [ file_batch_submit shall call io_ring_linux_submit once with the entries of all the I/Os of the batch that hold their slots. ]*/
+TEST_FUNCTION(file_batch_submit_with_io_limit_queue_submits_the_admitted_ios_and_counts_the_queued_ones_as_submitted)
+{
+    ///arrange
+    unsigned char source[4096];
+    unsigned char destination[4096];
+    uint32_t submitted_count = 0;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, (void*)0x4245));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 8192, mock_user_callback, (void*)0x4246));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, submitted_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITE, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(uint64_t, 0, captured_sqe.offset);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    umock_c_reset_all_calls();
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(destination));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_050: [ If issuing an I/O fails, file_batch_submit shall not issue the I/Os that follow it, discard all the I/Os that were not issued without calling their user_callback, set submitted_count to the number of issued I/Os and return a non-zero value. ]*/
+/*Tests_SRS_FILE_LINUX_01_256: [ If acquiring the slots of an I/O fails, file_batch_submit shall release the slots of the file handle acquired for the I/Os that follow it, not start them and submit the I/Os that hold their slots. ]*/
+TEST_FUNCTION(file_batch_submit_with_io_limit_busy_does_not_start_the_ios_that_follow_an_io_whose_slots_cannot_be_acquired)
+{
+    ///arrange
+    unsigned char source[4096];
+    uint32_t submitted_count = 42;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, (void*)0x4245));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 4096, mock_user_callback, (void*)0x4246));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 8192, mock_user_callback, (void*)0x4247));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 3));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .SetReturn(IO_ADMISSION_ERROR);
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, -2));
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_count);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 0, captured_sqe.offset);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_147: [ The aggregated writes, the reads of read-ahead blocks and the flushes of handle shall be queued when no slot of the I/O limits is free, whatever the mode of handle. ]*/
+/*Tests_SRS_FILE_LINUX_01_241: [ file_flush_async shall start the flush by calling start_io with FILE_IO_LIMIT_MODE_QUEUE. ]*/
+TEST_FUNCTION(file_flush_async_with_io_limit_busy_queues_the_fsync_when_the_file_handle_has_no_free_slot)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    int result = file_flush_async(file_handle, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    umock_c_reset_all_calls();
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 0);
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_242: [ If the flush holds slots of the I/O limits, on_file_flush_complete_linux shall call release_io_slots. ]*/
+TEST_FUNCTION(on_file_flush_complete_linux_with_io_limit_releases_the_slot_of_the_flush)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG));
+    ASSERT_ARE_EQUAL(int, 0, file_flush_async(file_handle, mock_user_callback, (void*)0x4245));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_147: [ The aggregated writes, the reads of read-ahead blocks and the flushes of handle shall be queued when no slot of the I/O limits is free, whatever the mode of handle. ]*/
+/*Tests_SRS_FILE_LINUX_01_244: [ issue_aggregated_write shall start the write by calling start_io with FILE_IO_LIMIT_MODE_QUEUE. ]*/
+TEST_FUNCTION(issue_aggregated_write_with_io_limit_busy_queues_the_write_when_the_file_handle_has_no_free_slot)
+{
+    ///arrange
+    unsigned char buffer[8192];
+    WRITE_AGGREGATOR_IO aggregated_io = { 4096, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+    STRICT_EXPECTED_CALL(io_admission_create(TEST_MAX_OUTSTANDING_IO));
+    ASSERT_ARE_EQUAL(int, 0, file_set_io_limit(file_handle, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    int result = captured_issue_io(captured_write_aggregator_context, &aggregated_io);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    umock_c_reset_all_calls();
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(buffer));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_243: [ If the aggregated write holds slots of the I/O limits, on_file_aggregated_write_complete_linux shall call release_io_slots before calling write_aggregator_io_complete. ]*/
+TEST_FUNCTION(on_file_aggregated_write_complete_linux_with_io_limit_releases_the_slot_before_calling_write_aggregator_io_complete)
+{
+    ///arrange
+    unsigned char buffer[8192];
+    WRITE_AGGREGATOR_IO aggregated_io = { 4096, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+    STRICT_EXPECTED_CALL(io_admission_create(TEST_MAX_OUTSTANDING_IO));
+    ASSERT_ARE_EQUAL(int, 0, file_set_io_limit(file_handle, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE));
+    umock_c_reset_all_calls();
+    ASSERT_ARE_EQUAL(int, 0, captured_issue_io(captured_write_aggregator_context, &aggregated_io));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(write_aggregator_io_complete(test_write_aggregator, &aggregated_io, true));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(buffer));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_120: [ If a queued I/O fails to start, its user_callback shall be called with user_context and is_successful as false. ]*/
+/*Tests_SRS_FILE_LINUX_01_161: [ If submit_io fails, on_file_io_admitted_by_engine shall call release_io_slots and fail_queued_io. ]*/
+/*Tests_SRS_FILE_LINUX_01_159: [ fail_queued_io shall mark the I/O as not holding slots and call the completion callback of the I/O with -ECANCELED as io_result. ]*/
+TEST_FUNCTION(on_file_io_admitted_by_engine_fails_the_aggregated_write_when_io_ring_linux_submit_fails)
+{
+    ///arrange
+    unsigned char buffer[8192];
+    WRITE_AGGREGATOR_IO aggregated_io = { 4096, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation();
+    STRICT_EXPECTED_CALL(io_admission_create(TEST_MAX_OUTSTANDING_IO));
+    ASSERT_ARE_EQUAL(int, 0, file_set_io_limit(file_handle, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE));
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(int, 0, captured_issue_io(captured_write_aggregator_context, &aggregated_io));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_ring_linux_submit(fake_io_ring, IGNORED_ARG, 1, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_io_complete(test_write_aggregator, &aggregated_io, false));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_147: [ The aggregated writes, the reads of read-ahead blocks and the flushes of handle shall be queued when no slot of the I/O limits is free, whatever the mode of handle. ]*/
+/*Tests_SRS_FILE_LINUX_01_246: [ issue_read_ahead shall start the read by calling start_io with FILE_IO_LIMIT_MODE_QUEUE. ]*/
+TEST_FUNCTION(issue_read_ahead_with_io_limit_busy_queues_the_read_when_the_file_handle_has_no_free_slot)
+{
+    ///arrange
+    unsigned char buffer[TEST_READ_AHEAD_BLOCK_SIZE];
+    READ_AHEAD_IO read_ahead_io = { TEST_READ_AHEAD_BLOCK_SIZE, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+    STRICT_EXPECTED_CALL(io_admission_create(TEST_MAX_OUTSTANDING_IO));
+    ASSERT_ARE_EQUAL(int, 0, file_set_io_limit(file_handle, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    int result = captured_read_ahead_issue_io(captured_read_ahead_context, &read_ahead_io);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    umock_c_reset_all_calls();
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(buffer));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_245: [ If the block read holds slots of the I/O limits, on_file_read_ahead_complete_linux shall call release_io_slots before calling read_ahead_io_complete. ]*/
+TEST_FUNCTION(on_file_read_ahead_complete_linux_with_io_limit_releases_the_slot_before_calling_read_ahead_io_complete)
+{
+    ///arrange
+    unsigned char buffer[TEST_READ_AHEAD_BLOCK_SIZE];
+    READ_AHEAD_IO read_ahead_io = { TEST_READ_AHEAD_BLOCK_SIZE, buffer, sizeof(buffer) };
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead();
+    STRICT_EXPECTED_CALL(io_admission_create(TEST_MAX_OUTSTANDING_IO));
+    ASSERT_ARE_EQUAL(int, 0, file_set_io_limit(file_handle, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE));
+    umock_c_reset_all_calls();
+    ASSERT_ARE_EQUAL(int, 0, captured_read_ahead_issue_io(captured_read_ahead_context, &read_ahead_io));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(read_ahead_io_complete(test_read_ahead, &read_ahead_io, true, sizeof(buffer)));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(buffer));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_122: [ If handle is NULL then file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_get_io_admission_statistics_fails_with_null_handle)
+{
+    ///arrange
+    IO_ADMISSION_STATISTICS statistics;
+
+    ///act
+    int return_value = file_get_io_admission_statistics(NULL, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, return_value);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_123: [ If statistics is NULL then file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_get_io_admission_statistics_fails_with_null_statistics)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+
+    ///act
+    int return_value = file_get_io_admission_statistics(file_handle, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, return_value);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_124: [ If no I/O limit was set on handle or it was set with max_outstanding_io 0 then file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_get_io_admission_statistics_fails_when_no_io_limit_was_set)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    IO_ADMISSION_STATISTICS statistics;
+
+    ///act
+    int return_value = file_get_io_admission_statistics(file_handle, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, return_value);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_124: [ If no I/O limit was set on handle or it was set with max_outstanding_io 0 then file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_get_io_admission_statistics_fails_when_the_io_limit_is_0)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(NULL, 0, FILE_IO_LIMIT_MODE_QUEUE);
+    IO_ADMISSION_STATISTICS statistics;
+
+    ///act
+    int return_value = file_get_io_admission_statistics(file_handle, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, return_value);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_125: [ file_get_io_admission_statistics shall fill statistics with the counters of the I/O limit of handle and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_188: [ file_get_io_admission_statistics shall call io_admission_get_statistics on the admission of handle. ]*/
+TEST_FUNCTION(file_get_io_admission_statistics_succeeds)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    IO_ADMISSION_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(io_admission_get_statistics(test_io_admission, &statistics));
+
+    ///act
+    int return_value = file_get_io_admission_statistics(file_handle, &statistics);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, return_value);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_189: [ If io_admission_get_statistics fails, file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_get_io_admission_statistics_fails_when_io_admission_get_statistics_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    IO_ADMISSION_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(io_admission_get_statistics(test_io_admission, &statistics))
+        .SetReturn(MU_FAILURE);
+
+    ///act
+    int return_value = file_get_io_admission_statistics(file_handle, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, return_value);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/* file_set_io_priority */
+
+/*Tests_SRS_FILE_01_126: [ If handle is NULL then file_set_io_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_io_priority_with_NULL_handle_fails)
+{
+    ///arrange
+
+    ///act
+    int result = file_set_io_priority(NULL, FILE_IO_PRIORITY_LOW);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_127: [ If priority is not FILE_IO_PRIORITY_NORMAL or FILE_IO_PRIORITY_LOW then file_set_io_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_io_priority_with_invalid_priority_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_set_io_priority(file_handle, (FILE_IO_PRIORITY)0x42);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_128: [ file_set_io_priority shall set the priority class of the I/Os of handle to priority and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_191: [ file_set_io_priority shall set the io_uring priority of handle to 0 and its admission priority to IO_ADMISSION_PRIORITY_NORMAL for FILE_IO_PRIORITY_NORMAL, and to the lowest level of the best-effort class and IO_ADMISSION_PRIORITY_LOW for FILE_IO_PRIORITY_LOW, and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_192: [ The IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READV and IORING_OP_WRITEV entries prepared for handle shall have the io_uring priority of handle as ioprio. ]*/
+TEST_FUNCTION(file_set_io_priority_LOW_sets_the_ioprio_of_the_writes_to_the_lowest_best_effort_level)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int result = file_set_io_priority(file_handle, FILE_IO_PRIORITY_LOW);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 8192, mock_user_callback, (void*)0x4245));
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITE, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(uint16_t, TEST_IOPRIO_LOW, captured_sqe.ioprio);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_191: [ file_set_io_priority shall set the io_uring priority of handle to 0 and its admission priority to IO_ADMISSION_PRIORITY_NORMAL for FILE_IO_PRIORITY_NORMAL, and to the lowest level of the best-effort class and IO_ADMISSION_PRIORITY_LOW for FILE_IO_PRIORITY_LOW, and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_192: [ The IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READV and IORING_OP_WRITEV entries prepared for handle shall have the io_uring priority of handle as ioprio. ]*/
+TEST_FUNCTION(file_set_io_priority_NORMAL_sets_the_ioprio_of_the_reads_to_0)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    ASSERT_ARE_EQUAL(int, 0, file_set_io_priority(file_handle, FILE_IO_PRIORITY_LOW));
+
+    ///act
+    int result = file_set_io_priority(file_handle, FILE_IO_PRIORITY_NORMAL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async(file_handle, destination, sizeof(destination), 4096, mock_user_callback, NULL));
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_READ, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(uint16_t, 0, captured_sqe.ioprio);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(destination));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_192: [ The IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READV and IORING_OP_WRITEV entries prepared for handle shall have the io_uring priority of handle as ioprio. ]*/
+TEST_FUNCTION(file_write_async_v_of_a_low_priority_file_handle_has_the_low_ioprio)
+{
+    ///arrange
+    unsigned char buffer_1[4096];
+    unsigned char buffer_2[4096];
+    FILE_BUFFER buffers[2] = { { buffer_1, sizeof(buffer_1) }, { buffer_2, sizeof(buffer_2) } };
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    ASSERT_ARE_EQUAL(int, 0, file_set_io_priority(file_handle, FILE_IO_PRIORITY_LOW));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(uint8_t, IORING_OP_WRITEV, captured_sqe.opcode);
+    ASSERT_ARE_EQUAL(uint16_t, TEST_IOPRIO_LOW, captured_sqe.ioprio);
+
+    ///cleanup
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(buffer_1) + sizeof(buffer_2));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_129: [ An I/O of a FILE_IO_PRIORITY_LOW file handle that waits for a slot of an I/O limit shall only be started when no I/O of a FILE_IO_PRIORITY_NORMAL file handle waits for a slot of the same limit. ]*/
+/*Tests_SRS_FILE_LINUX_01_193: [ acquire_io_slots and acquire_engine_io_slot shall call io_admission_acquire with the admission priority of the file handle as priority of the waiter. ]*/
+TEST_FUNCTION(file_write_async_of_a_low_priority_file_handle_waits_for_the_slot_of_the_file_handle_with_low_priority)
+{
+    ///arrange
+    unsigned char source[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    ASSERT_ARE_EQUAL(int, 0, file_set_io_priority(file_handle, FILE_IO_PRIORITY_LOW));
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, IO_ADMISSION_PRIORITY_LOW, captured_admission_waiter->priority);
+
+    ///cleanup
+    umock_c_reset_all_calls();
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(source));
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_193: [ acquire_io_slots and acquire_engine_io_slot shall call io_admission_acquire with the admission priority of the file handle as priority of the waiter. ]*/
+TEST_FUNCTION(file_read_async_of_a_low_priority_file_handle_waits_for_the_slot_of_the_execution_engine_with_low_priority)
+{
+    ///arrange
+    unsigned char destination[4096];
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit(test_engine_io_admission, 0, FILE_IO_LIMIT_MODE_QUEUE);
+    ASSERT_ARE_EQUAL(int, 0, file_set_io_priority(file_handle, FILE_IO_PRIORITY_LOW));
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_admission_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, IO_ADMISSION_PRIORITY_LOW, captured_admission_waiter->priority);
+
+    ///cleanup
+    umock_c_reset_all_calls();
+    captured_admission_waiter->on_admitted(captured_admission_waiter->on_admitted_context);
+    captured_sqe.io->on_io_complete(captured_sqe.io->on_io_complete_context, sizeof(destination));
+    destroy_file_handle(file_handle);
+}
+
+/* file_get_io_context_pool_statistics */
+
+/*Tests_SRS_FILE_01_055: [ If handle is NULL then file_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_get_io_context_pool_statistics_fails_with_null_handle)
+{
+    ///arrange
+    IO_CONTEXT_POOL_STATISTICS statistics;
+
+    ///act
+    int return_value = file_get_io_context_pool_statistics(NULL, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, return_value);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_056: [ If statistics is NULL then file_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_get_io_context_pool_statistics_fails_with_null_statistics)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+
+    ///act
+    int return_value = file_get_io_context_pool_statistics(file_handle, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, return_value);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_01_057: [ file_get_io_context_pool_statistics shall fill statistics with the hit and miss counters of the I/O context pool of handle and return 0. ]*/
+/*Tests_SRS_FILE_LINUX_01_046: [ file_get_io_context_pool_statistics shall call io_context_pool_get_statistics on the I/O context pool of handle. ]*/
+/*Tests_SRS_FILE_LINUX_01_048: [ Otherwise file_get_io_context_pool_statistics shall succeed and return 0. ]*/
+TEST_FUNCTION(file_get_io_context_pool_statistics_succeeds)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    IO_CONTEXT_POOL_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get_statistics(test_io_context_pool, &statistics));
+
+    ///act
+    int return_value = file_get_io_context_pool_statistics(file_handle, &statistics);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, return_value);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+/*Tests_SRS_FILE_LINUX_01_047: [ If io_context_pool_get_statistics fails, file_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_get_io_context_pool_statistics_fails_when_io_context_pool_get_statistics_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("test_file.txt");
+    IO_CONTEXT_POOL_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get_statistics(test_io_context_pool, &statistics))
+        .SetReturn(MU_FAILURE);
+
+    ///act
+    int return_value = file_get_io_context_pool_statistics(file_handle, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, return_value);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    destroy_file_handle(file_handle);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
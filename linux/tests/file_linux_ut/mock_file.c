@@ -0,0 +1,26 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#define _GNU_SOURCE
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "mock_file.h"
+
+#define open mock_open
+#define close mock_close
+#define fstat mock_fstat
+#define ftruncate mock_ftruncate
+#define mmap mock_mmap
+#define munmap mock_munmap
+#define madvise mock_madvise
+#define ioctl mock_ioctl
+#define pipe2 mock_pipe2
+#define fcntl mock_fcntl
+#define copy_file_range mock_copy_file_range
+
+#include "../../src/file_linux.c"
@@ -0,0 +1,32 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef MOCK_FILE_H
+#define MOCK_FILE_H
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+MOCKABLE_FUNCTION(, int, mock_open, const char*, pathname, int, flags, mode_t, mode);
+MOCKABLE_FUNCTION(, int, mock_close, int, fd);
+MOCKABLE_FUNCTION(, int, mock_fstat, int, fd, struct stat*, statbuf);
+MOCKABLE_FUNCTION(, int, mock_ftruncate, int, fd, off_t, length);
+MOCKABLE_FUNCTION(, void*, mock_mmap, void*, addr, size_t, length, int, prot, int, flags, int, fd, off_t, offset);
+MOCKABLE_FUNCTION(, int, mock_munmap, void*, addr, size_t, length);
+MOCKABLE_FUNCTION(, int, mock_madvise, void*, addr, size_t, length, int, advice);
+MOCKABLE_FUNCTION(, int, mock_ioctl, int, fd, unsigned long, request, void*, argp);
+MOCKABLE_FUNCTION(, int, mock_pipe2, int*, pipefd, int, flags);
+MOCKABLE_FUNCTION(, int, mock_fcntl, int, fd, int, cmd, int, arg);
+MOCKABLE_FUNCTION(, ssize_t, mock_copy_file_range, int, fd_in, loff_t*, off_in, int, fd_out, loff_t*, off_out, size_t, len, unsigned int, flags);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MOCK_FILE_H
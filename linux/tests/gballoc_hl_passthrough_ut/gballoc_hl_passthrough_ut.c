@@ -31,6 +31,16 @@ static void stdlib_free(void* ptr)
     free(ptr);
 }
 
+static void* stdlib_aligned_malloc(size_t alignment, size_t size)
+{
+    void* result;
+    if (posix_memalign(&result, alignment, size) != 0)
+    {
+        result = NULL;
+    }
+    return result;
+}
+
 #include "macro_utils/macro_utils.h" // IWYU pragma: keep
 #include "testrunnerswitcher.h"
 
@@ -64,6 +74,8 @@ TEST_SUITE_INITIALIZE(init_suite)
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_ll_realloc, stdlib_realloc);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_ll_calloc, stdlib_calloc);
     REGISTER_GLOBAL_MOCK_HOOK(gballoc_ll_free, stdlib_free);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_ll_aligned_malloc, stdlib_aligned_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(gballoc_ll_aligned_free, stdlib_free);
 }
 
 TEST_SUITE_CLEANUP(TestClassCleanup)
@@ -295,6 +307,62 @@ TEST_FUNCTION(gballoc_hl_realloc_when_ll_fails)
     gballoc_hl_free(ptr);
 }
 
+/*Tests_SRS_GBALLOC_HL_PASSTHROUGH_01_003: [ gballoc_hl_aligned_malloc shall call gballoc_ll_aligned_malloc(alignment, size) and return what gballoc_ll_aligned_malloc returned. ]*/
+TEST_FUNCTION(gballoc_hl_aligned_malloc_succeeds)
+{
+    ///arrange
+    void* result;
+    STRICT_EXPECTED_CALL(gballoc_ll_aligned_malloc(4096, 3));
+
+    ///act
+    result = gballoc_hl_aligned_malloc(4096, 3);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 0, (uintptr_t)result % 4096);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    gballoc_hl_aligned_free(result);
+}
+
+/*Tests_SRS_GBALLOC_HL_PASSTHROUGH_01_003: [ gballoc_hl_aligned_malloc shall call gballoc_ll_aligned_malloc(alignment, size) and return what gballoc_ll_aligned_malloc returned. ]*/
+TEST_FUNCTION(gballoc_hl_aligned_malloc_unhappy_path)
+{
+    ///arrange
+    void* result;
+    STRICT_EXPECTED_CALL(gballoc_ll_aligned_malloc(4096, 3))
+        .SetReturn(NULL);
+
+    ///act
+    result = gballoc_hl_aligned_malloc(4096, 3);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+}
+
+/*Tests_SRS_GBALLOC_HL_PASSTHROUGH_01_004: [ gballoc_hl_aligned_free shall call gballoc_ll_aligned_free(ptr). ]*/
+TEST_FUNCTION(gballoc_hl_aligned_free_calls_gballoc_ll_aligned_free)
+{
+    ///arrange
+    void* ptr = gballoc_hl_aligned_malloc(4096, 3);
+    ASSERT_IS_NOT_NULL(ptr);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_ll_aligned_free(ptr));
+
+    ///act
+    gballoc_hl_aligned_free(ptr);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+}
+
 /* Tests_SRS_GBALLOC_HL_PASSTHROUGH_02_014: [ gballoc_hl_get_latency_bucket_metadata shall return an array of size LATENCY_BUCKET_COUNT that contains the metadata for each latency bucket. ]*/
 /* Tests_SRS_GBALLOC_HL_PASSTHROUGH_02_015: [ The first latency bucket shall be [0-511]. ]*/
 /* Tests_SRS_GBALLOC_HL_PASSTHROUGH_02_016: [ Each consecutive bucket shall be [1 << n, (1 << (n + 1)) - 1], where n starts at 9. ]*/
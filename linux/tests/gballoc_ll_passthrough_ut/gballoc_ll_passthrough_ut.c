@@ -3,8 +3,10 @@
 
 #ifdef __cplusplus
 #include <cstdlib>
+#include <cerrno>
 #else
 #include <stdlib.h>
+#include <errno.h>
 #endif
 
 
@@ -16,6 +18,7 @@ static TEST_MUTEX_HANDLE g_testByTest;
 static void* TEST_MALLOC_RESULT = (void*)0x1;
 static void* TEST_CALLOC_RESULT = (void*)0x2;
 static void* TEST_REALLOC_RESULT = (void*)0x3;
+static void* TEST_ALIGNED_MALLOC_RESULT = (void*)0x1000;
 
 #include "umock_c/umock_c.h"
 
@@ -30,6 +33,7 @@ extern "C" {
     MOCKABLE_FUNCTION(, void, mock_free, void*, ptr);
 
     MOCKABLE_FUNCTION(, size_t, mock_malloc_usable_size, void*, ptr);
+    MOCKABLE_FUNCTION(, int, mock_posix_memalign, void**, memptr, size_t, alignment, size_t, size);
 #ifdef __cplusplus
 }
 #endif
@@ -56,6 +60,8 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_GLOBAL_MOCK_RETURN(mock_malloc, TEST_MALLOC_RESULT);
     REGISTER_GLOBAL_MOCK_RETURN(mock_realloc, TEST_REALLOC_RESULT);
     REGISTER_GLOBAL_MOCK_RETURN(mock_calloc, TEST_CALLOC_RESULT);
+
+    REGISTER_UMOCK_ALIAS_TYPE(void**, void*);
 }
 
 TEST_SUITE_CLEANUP(TestClassCleanup)
@@ -213,4 +219,128 @@ TEST_FUNCTION(gballoc_ll_size_returns)
     ASSERT_ARE_EQUAL(size_t, 32, size);
 }
 
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_001: [ If alignment is 0 or is not a power of 2, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_alignment_0_fails)
+{
+    ///arrange
+    void* ptr;
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(0, 1);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_001: [ If alignment is 0 or is not a power of 2, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_alignment_not_power_of_2_fails)
+{
+    ///arrange
+    void* ptr;
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(4095, 1);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_002: [ If size is 0, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_size_0_fails)
+{
+    ///arrange
+    void* ptr;
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(4096, 0);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_003: [ On Linux, gballoc_ll_aligned_malloc shall call posix_memalign with the greater of alignment and sizeof(void*) and size. ]*/
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_005: [ gballoc_ll_aligned_malloc shall succeed and return the aligned memory block. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_calls_posix_memalign)
+{
+    ///arrange
+    void* ptr;
+
+    STRICT_EXPECTED_CALL(mock_posix_memalign(IGNORED_ARG, 4096, 10))
+        .CopyOutArgumentBuffer_memptr(&TEST_ALIGNED_MALLOC_RESULT, sizeof(TEST_ALIGNED_MALLOC_RESULT));
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(4096, 10);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_ALIGNED_MALLOC_RESULT, ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_003: [ On Linux, gballoc_ll_aligned_malloc shall call posix_memalign with the greater of alignment and sizeof(void*) and size. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_alignment_1_calls_posix_memalign_with_sizeof_void_ptr)
+{
+    ///arrange
+    void* ptr;
+
+    STRICT_EXPECTED_CALL(mock_posix_memalign(IGNORED_ARG, sizeof(void*), 10))
+        .CopyOutArgumentBuffer_memptr(&TEST_ALIGNED_MALLOC_RESULT, sizeof(TEST_ALIGNED_MALLOC_RESULT));
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(1, 10);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_ALIGNED_MALLOC_RESULT, ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_006: [ If any error occurs, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(when_posix_memalign_fails_gballoc_ll_aligned_malloc_fails)
+{
+    ///arrange
+    void* ptr;
+
+    STRICT_EXPECTED_CALL(mock_posix_memalign(IGNORED_ARG, 4096, 10))
+        .SetReturn(ENOMEM);
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(4096, 10);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_008: [ On Linux, gballoc_ll_aligned_free shall call free(ptr). ]*/
+TEST_FUNCTION(gballoc_ll_aligned_free_calls_free)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(mock_free(TEST_ALIGNED_MALLOC_RESULT));
+
+    ///act
+    gballoc_ll_aligned_free(TEST_ALIGNED_MALLOC_RESULT);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_010: [ On Linux, gballoc_ll_aligned_size shall return what malloc_usable_size returns. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_size_returns)
+{
+    ///arrange
+    size_t size;
+
+    STRICT_EXPECTED_CALL(mock_malloc_usable_size(TEST_ALIGNED_MALLOC_RESULT))
+        .SetReturn(4096);
+
+    ///act
+    size = gballoc_ll_aligned_size(TEST_ALIGNED_MALLOC_RESULT);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 4096, size);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
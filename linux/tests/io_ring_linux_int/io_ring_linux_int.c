@@ -0,0 +1,219 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <inttypes.h>
+
+#include <linux/io_uring.h>
+
+#include "testrunnerswitcher.h"
+
+#include "macro_utils/macro_utils.h"
+#include "c_logging/xlogging.h"
+#include "c_pal/timer.h"
+#include "c_pal/threadapi.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sync.h"
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+
+#include "c_pal/io_ring_linux.h"
+
+#define TEST_RING_ENTRIES 4
+/*the completion queue holds 2 * entries completions*/
+#define TEST_COMPLETION_QUEUE_SIZE (2 * TEST_RING_ENTRIES)
+#define TEST_TIMEOUT_MS 10000
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+
+static void wait_for_equal(volatile_atomic int32_t* value, int32_t expected, uint32_t timeout)
+{
+    double start_time = timer_global_get_elapsed_ms();
+    do
+    {
+        double current_time = timer_global_get_elapsed_ms();
+        if ((timeout != UINT32_MAX) && (current_time - start_time >= timeout))
+        {
+            ASSERT_FAIL("Timeout waiting for value");
+        }
+
+        int32_t current_value = interlocked_add(value, 0);
+        if (current_value == expected)
+        {
+            break;
+        }
+        (void)wait_on_address(value, current_value, (timeout == UINT32_MAX) ? UINT32_MAX : timeout - (uint32_t)(current_time - start_time));
+    } while (1);
+}
+
+typedef struct NOP_CONTEXT_TAG
+{
+    volatile_atomic int32_t completed_count;
+    volatile_atomic int32_t failed_count;
+} NOP_CONTEXT;
+
+static void on_nop_complete(void* context, int32_t result)
+{
+    NOP_CONTEXT* nop_context = context;
+    if (result != 0)
+    {
+        (void)interlocked_increment(&nop_context->failed_count);
+    }
+    (void)interlocked_increment(&nop_context->completed_count);
+    wake_by_address_single(&nop_context->completed_count);
+}
+
+static void submit_nops(IO_RING_LINUX_HANDLE io_ring, IO_RING_LINUX_IO* io, uint32_t count)
+{
+    IO_RING_LINUX_SQE sqes[TEST_COMPLETION_QUEUE_SIZE];
+    uint32_t submitted_count = 0;
+
+    ASSERT_IS_TRUE(count <= TEST_COMPLETION_QUEUE_SIZE);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        sqes[i] = (IO_RING_LINUX_SQE){ .opcode = IORING_OP_NOP, .fd = -1, .io = io };
+    }
+
+    ASSERT_ARE_EQUAL(int, 0, io_ring_linux_submit(io_ring, sqes, count, &submitted_count));
+    ASSERT_ARE_EQUAL(uint32_t, count, submitted_count);
+}
+
+typedef struct SUBMITTING_CALLBACK_CONTEXT_TAG
+{
+    IO_RING_LINUX_HANDLE io_ring;
+    IO_RING_LINUX_IO nop_io;
+    NOP_CONTEXT nop_context;
+    volatile_atomic int32_t is_completion_queue_full;
+    volatile_atomic int32_t callback_count;
+    volatile_atomic int32_t callback_submit_result;
+} SUBMITTING_CALLBACK_CONTEXT;
+
+static void on_submitting_io_complete(void* context, int32_t result)
+{
+    SUBMITTING_CALLBACK_CONTEXT* callback_context = context;
+    IO_RING_LINUX_SQE sqes[TEST_COMPLETION_QUEUE_SIZE];
+    uint32_t submitted_count = 0;
+    (void)result;
+
+    /*the reaper thread stays here until the completion queue is full*/
+    wait_for_equal(&callback_context->is_completion_queue_full, 1, TEST_TIMEOUT_MS);
+
+    for (uint32_t i = 0; i < TEST_COMPLETION_QUEUE_SIZE; i++)
+    {
+        sqes[i] = (IO_RING_LINUX_SQE){ .opcode = IORING_OP_NOP, .fd = -1, .io = &callback_context->nop_io };
+    }
+
+    (void)interlocked_exchange(&callback_context->callback_submit_result, io_ring_linux_submit(callback_context->io_ring, sqes, TEST_COMPLETION_QUEUE_SIZE, &submitted_count));
+    (void)interlocked_increment(&callback_context->callback_count);
+    wake_by_address_single(&callback_context->callback_count);
+}
+
+static int submit_nops_thread(void* arg)
+{
+    SUBMITTING_CALLBACK_CONTEXT* callback_context = arg;
+
+    /*the completion queue is full, this one has to wait for the reaper thread, which is about to submit from a callback*/
+    submit_nops(callback_context->io_ring, &callback_context->nop_io, TEST_COMPLETION_QUEUE_SIZE);
+    return 0;
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+TEST_FUNCTION(io_ring_linux_submit_completes_all_the_nops)
+{
+    // arrange
+    NOP_CONTEXT nop_context;
+    (void)interlocked_exchange(&nop_context.completed_count, 0);
+    (void)interlocked_exchange(&nop_context.failed_count, 0);
+    IO_RING_LINUX_IO nop_io = { .on_io_complete = on_nop_complete, .on_io_complete_context = &nop_context };
+    IO_RING_LINUX_HANDLE io_ring = io_ring_linux_create(TEST_RING_ENTRIES);
+    ASSERT_IS_NOT_NULL(io_ring);
+
+    // act
+    /*more than fit in the submission queue*/
+    submit_nops(io_ring, &nop_io, TEST_COMPLETION_QUEUE_SIZE);
+
+    // assert
+    wait_for_equal(&nop_context.completed_count, TEST_COMPLETION_QUEUE_SIZE, TEST_TIMEOUT_MS);
+    ASSERT_ARE_EQUAL(int32_t, 0, interlocked_add(&nop_context.failed_count, 0));
+
+    // cleanup
+    io_ring_linux_destroy(io_ring);
+}
+
+/*Tests_SRS_IO_RING_LINUX_01_023: [ If io_uring_enter fails with EAGAIN or EBUSY while io_ring_linux_submit is called from an on_io_complete callback, io_ring_linux_submit shall move the completion queue entries to a backlog whose callbacks are called later by the reaper thread and retry. ]*/
+/*Tests_SRS_IO_RING_LINUX_01_024: [ If io_uring_enter fails with EAGAIN or EBUSY or consumes no entry and the completion queue cannot be drained by the calling thread, io_ring_linux_submit shall discard the entries not consumed by the kernel, release the submission lock, wait IO_RING_LINUX_SUBMIT_WAIT_MS milliseconds, take the lock again and retry with the entries that were not submitted. ]*/
+TEST_FUNCTION(io_ring_linux_submit_from_a_callback_succeeds_while_another_thread_waits_for_a_full_completion_queue)
+{
+    // arrange
+    SUBMITTING_CALLBACK_CONTEXT callback_context;
+    IO_RING_LINUX_IO submitting_io = { .on_io_complete = on_submitting_io_complete, .on_io_complete_context = &callback_context };
+    IO_RING_LINUX_SQE submitting_sqe = { .opcode = IORING_OP_NOP, .fd = -1, .io = &submitting_io };
+    uint32_t submitted_count = 0;
+    THREAD_HANDLE submit_thread;
+    int thread_result;
+
+    callback_context.io_ring = io_ring_linux_create(TEST_RING_ENTRIES);
+    ASSERT_IS_NOT_NULL(callback_context.io_ring);
+    callback_context.nop_io.on_io_complete = on_nop_complete;
+    callback_context.nop_io.on_io_complete_context = &callback_context.nop_context;
+    (void)interlocked_exchange(&callback_context.nop_context.completed_count, 0);
+    (void)interlocked_exchange(&callback_context.nop_context.failed_count, 0);
+    (void)interlocked_exchange(&callback_context.is_completion_queue_full, 0);
+    (void)interlocked_exchange(&callback_context.callback_count, 0);
+    (void)interlocked_exchange(&callback_context.callback_submit_result, -1);
+
+    /*the reaper thread blocks in the callback of this one*/
+    ASSERT_ARE_EQUAL(int, 0, io_ring_linux_submit(callback_context.io_ring, &submitting_sqe, 1, &submitted_count));
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_count);
+
+    /*nobody drains the completion queue, this fills it*/
+    submit_nops(callback_context.io_ring, &callback_context.nop_io, TEST_COMPLETION_QUEUE_SIZE);
+
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Create(&submit_thread, submit_nops_thread, &callback_context));
+    /*give the thread time to find the completion queue full*/
+    ThreadAPI_Sleep(100);
+
+    // act
+    (void)interlocked_exchange(&callback_context.is_completion_queue_full, 1);
+    wake_by_address_single(&callback_context.is_completion_queue_full);
+
+    // assert
+    wait_for_equal(&callback_context.callback_count, 1, TEST_TIMEOUT_MS);
+    ASSERT_ARE_EQUAL(int32_t, 0, interlocked_add(&callback_context.callback_submit_result, 0));
+    ASSERT_ARE_EQUAL(THREADAPI_RESULT, THREADAPI_OK, ThreadAPI_Join(submit_thread, &thread_result));
+    wait_for_equal(&callback_context.nop_context.completed_count, 3 * TEST_COMPLETION_QUEUE_SIZE, TEST_TIMEOUT_MS);
+    ASSERT_ARE_EQUAL(int32_t, 0, interlocked_add(&callback_context.nop_context.failed_count, 0));
+
+    // cleanup
+    io_ring_linux_destroy(callback_context.io_ring);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -8,6 +8,7 @@
 
 #include "real_threadapi.h"
 #include "real_sync.h"
+#include "real_srw_lock.h"
 
 BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
@@ -20,6 +21,7 @@ TEST_FUNCTION(check_all_c_pal_reals)
     // act
     REGISTER_THREADAPI_GLOBAL_MOCK_HOOK();
     REGISTER_SYNC_GLOBAL_MOCK_HOOK();
+    REGISTER_SRW_LOCK_GLOBAL_MOCK_HOOK();
 
     // assert
     // no explicit assert, if it builds it works
@@ -0,0 +1,16 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <pthread.h>
+
+#include "mock_srw_lock.h"
+
+#define pthread_rwlock_init mock_pthread_rwlock_init
+#define pthread_rwlock_destroy mock_pthread_rwlock_destroy
+#define pthread_rwlock_wrlock mock_pthread_rwlock_wrlock
+#define pthread_rwlock_trywrlock mock_pthread_rwlock_trywrlock
+#define pthread_rwlock_rdlock mock_pthread_rwlock_rdlock
+#define pthread_rwlock_tryrdlock mock_pthread_rwlock_tryrdlock
+#define pthread_rwlock_unlock mock_pthread_rwlock_unlock
+
+#include "../../src/srw_lock_linux.c"
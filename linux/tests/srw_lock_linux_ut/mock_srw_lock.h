@@ -0,0 +1,27 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef MOCK_SRW_LOCK_H
+#define MOCK_SRW_LOCK_H
+
+#include <pthread.h>
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+MOCKABLE_FUNCTION(, int, mock_pthread_rwlock_init, pthread_rwlock_t*, rwlock, const pthread_rwlockattr_t*, attr);
+MOCKABLE_FUNCTION(, int, mock_pthread_rwlock_destroy, pthread_rwlock_t*, rwlock);
+MOCKABLE_FUNCTION(, int, mock_pthread_rwlock_wrlock, pthread_rwlock_t*, rwlock);
+MOCKABLE_FUNCTION(, int, mock_pthread_rwlock_trywrlock, pthread_rwlock_t*, rwlock);
+MOCKABLE_FUNCTION(, int, mock_pthread_rwlock_rdlock, pthread_rwlock_t*, rwlock);
+MOCKABLE_FUNCTION(, int, mock_pthread_rwlock_tryrdlock, pthread_rwlock_t*, rwlock);
+MOCKABLE_FUNCTION(, int, mock_pthread_rwlock_unlock, pthread_rwlock_t*, rwlock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MOCK_SRW_LOCK_H
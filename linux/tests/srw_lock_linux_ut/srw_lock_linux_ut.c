@@ -0,0 +1,448 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdbool.h>
+#endif
+
+#include <errno.h>
+#include <pthread.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "real_gballoc_ll.h"
+static void* real_malloc(size_t size)
+{
+    return real_gballoc_ll_malloc(size);
+}
+
+static void real_free(void* ptr)
+{
+    real_gballoc_ll_free(ptr);
+}
+
+#include "testrunnerswitcher.h"
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes_bool.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umock_c_negative_tests.h"
+
+#define ENABLE_MOCKS
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "mock_srw_lock.h"
+
+#undef ENABLE_MOCKS
+
+#include "real_gballoc_hl.h"
+
+#include "c_pal/srw_lock.h"
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+TEST_DEFINE_ENUM_TYPE(SRW_LOCK_TRY_ACQUIRE_RESULT, SRW_LOCK_TRY_ACQUIRE_RESULT_VALUES);
+
+static SRW_LOCK_HANDLE test_create_srw_lock(void)
+{
+    SRW_LOCK_HANDLE srw_lock = srw_lock_create(false, "test_lock");
+    ASSERT_IS_NOT_NULL(srw_lock);
+    umock_c_reset_all_calls();
+    return srw_lock;
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error));
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_bool_register_types());
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+
+    REGISTER_GLOBAL_MOCK_HOOK(malloc, real_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
+
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_pthread_rwlock_init, 0, EAGAIN);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_pthread_rwlock_trywrlock, 0, EBUSY);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_pthread_rwlock_tryrdlock, 0, EBUSY);
+
+    REGISTER_UMOCK_ALIAS_TYPE(pthread_rwlock_t*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(const pthread_rwlockattr_t*, void*);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    umock_c_reset_all_calls();
+    umock_c_negative_tests_init();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    umock_c_negative_tests_deinit();
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* srw_lock_create */
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_001: [ srw_lock_create shall allocate memory for SRW_LOCK_HANDLE. ]*/
+/*Tests_SRS_SRW_LOCK_LINUX_01_002: [ srw_lock_create shall initialize the lock by calling pthread_rwlock_init. ]*/
+/*Tests_SRS_SRW_LOCK_LINUX_01_003: [ srw_lock_create shall succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(srw_lock_create_succeeds)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_rwlock_init(IGNORED_ARG, NULL));
+
+    ///act
+    SRW_LOCK_HANDLE srw_lock = srw_lock_create(false, "test_lock");
+
+    ///assert
+    ASSERT_IS_NOT_NULL(srw_lock);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    srw_lock_destroy(srw_lock);
+}
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_003: [ srw_lock_create shall succeed and return a non-NULL value. ]*/
+TEST_FUNCTION(srw_lock_create_with_statistics_succeeds)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_rwlock_init(IGNORED_ARG, NULL));
+
+    ///act
+    SRW_LOCK_HANDLE srw_lock = srw_lock_create(true, NULL);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(srw_lock);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    srw_lock_destroy(srw_lock);
+}
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_004: [ If there are any failures then srw_lock_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_srw_lock_create_fails)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_rwlock_init(IGNORED_ARG, NULL));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        umock_c_negative_tests_reset();
+        umock_c_negative_tests_fail_call(i);
+
+        ///act
+        SRW_LOCK_HANDLE srw_lock = srw_lock_create(false, "test_lock");
+
+        ///assert
+        ASSERT_IS_NULL(srw_lock, "On failed call %zu", i);
+    }
+}
+
+/* srw_lock_acquire_exclusive */
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_005: [ If handle is NULL then srw_lock_acquire_exclusive shall return. ]*/
+TEST_FUNCTION(srw_lock_acquire_exclusive_with_NULL_handle_returns)
+{
+    ///arrange
+
+    ///act
+    srw_lock_acquire_exclusive(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_006: [ srw_lock_acquire_exclusive shall call pthread_rwlock_wrlock. ]*/
+TEST_FUNCTION(srw_lock_acquire_exclusive_calls_pthread_rwlock_wrlock)
+{
+    ///arrange
+    SRW_LOCK_HANDLE srw_lock = test_create_srw_lock();
+    STRICT_EXPECTED_CALL(mock_pthread_rwlock_wrlock(IGNORED_ARG));
+
+    ///act
+    srw_lock_acquire_exclusive(srw_lock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    srw_lock_release_exclusive(srw_lock);
+    srw_lock_destroy(srw_lock);
+}
+
+/* srw_lock_try_acquire_exclusive */
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_007: [ If handle is NULL then srw_lock_try_acquire_exclusive shall fail and return SRW_LOCK_TRY_ACQUIRE_INVALID_ARGS. ]*/
+TEST_FUNCTION(srw_lock_try_acquire_exclusive_with_NULL_handle_fails)
+{
+    ///arrange
+
+    ///act
+    SRW_LOCK_TRY_ACQUIRE_RESULT result = srw_lock_try_acquire_exclusive(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(SRW_LOCK_TRY_ACQUIRE_RESULT, SRW_LOCK_TRY_ACQUIRE_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_008: [ Otherwise srw_lock_try_acquire_exclusive shall call pthread_rwlock_trywrlock. ]*/
+/*Tests_SRS_SRW_LOCK_LINUX_01_010: [ If pthread_rwlock_trywrlock succeeds, srw_lock_try_acquire_exclusive shall return SRW_LOCK_TRY_ACQUIRE_OK. ]*/
+TEST_FUNCTION(srw_lock_try_acquire_exclusive_when_pthread_rwlock_trywrlock_succeeds_returns_OK)
+{
+    ///arrange
+    SRW_LOCK_HANDLE srw_lock = test_create_srw_lock();
+    STRICT_EXPECTED_CALL(mock_pthread_rwlock_trywrlock(IGNORED_ARG));
+
+    ///act
+    SRW_LOCK_TRY_ACQUIRE_RESULT result = srw_lock_try_acquire_exclusive(srw_lock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(SRW_LOCK_TRY_ACQUIRE_RESULT, SRW_LOCK_TRY_ACQUIRE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    srw_lock_release_exclusive(srw_lock);
+    srw_lock_destroy(srw_lock);
+}
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_009: [ If pthread_rwlock_trywrlock fails, srw_lock_try_acquire_exclusive shall return SRW_LOCK_TRY_ACQUIRE_COULD_NOT_ACQUIRE. ]*/
+TEST_FUNCTION(srw_lock_try_acquire_exclusive_when_pthread_rwlock_trywrlock_fails_returns_COULD_NOT_ACQUIRE)
+{
+    ///arrange
+    SRW_LOCK_HANDLE srw_lock = test_create_srw_lock();
+    STRICT_EXPECTED_CALL(mock_pthread_rwlock_trywrlock(IGNORED_ARG))
+        .SetReturn(EBUSY);
+
+    ///act
+    SRW_LOCK_TRY_ACQUIRE_RESULT result = srw_lock_try_acquire_exclusive(srw_lock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(SRW_LOCK_TRY_ACQUIRE_RESULT, SRW_LOCK_TRY_ACQUIRE_COULD_NOT_ACQUIRE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    srw_lock_destroy(srw_lock);
+}
+
+/* srw_lock_release_exclusive */
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_011: [ If handle is NULL then srw_lock_release_exclusive shall return. ]*/
+TEST_FUNCTION(srw_lock_release_exclusive_with_NULL_handle_returns)
+{
+    ///arrange
+
+    ///act
+    srw_lock_release_exclusive(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_012: [ srw_lock_release_exclusive shall call pthread_rwlock_unlock. ]*/
+TEST_FUNCTION(srw_lock_release_exclusive_calls_pthread_rwlock_unlock)
+{
+    ///arrange
+    SRW_LOCK_HANDLE srw_lock = test_create_srw_lock();
+    srw_lock_acquire_exclusive(srw_lock);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_pthread_rwlock_unlock(IGNORED_ARG));
+
+    ///act
+    srw_lock_release_exclusive(srw_lock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    srw_lock_destroy(srw_lock);
+}
+
+/* srw_lock_acquire_shared */
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_013: [ If handle is NULL then srw_lock_acquire_shared shall return. ]*/
+TEST_FUNCTION(srw_lock_acquire_shared_with_NULL_handle_returns)
+{
+    ///arrange
+
+    ///act
+    srw_lock_acquire_shared(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_014: [ srw_lock_acquire_shared shall call pthread_rwlock_rdlock. ]*/
+TEST_FUNCTION(srw_lock_acquire_shared_calls_pthread_rwlock_rdlock)
+{
+    ///arrange
+    SRW_LOCK_HANDLE srw_lock = test_create_srw_lock();
+    STRICT_EXPECTED_CALL(mock_pthread_rwlock_rdlock(IGNORED_ARG));
+
+    ///act
+    srw_lock_acquire_shared(srw_lock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    srw_lock_release_shared(srw_lock);
+    srw_lock_destroy(srw_lock);
+}
+
+/* srw_lock_try_acquire_shared */
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_015: [ If handle is NULL then srw_lock_try_acquire_shared shall fail and return SRW_LOCK_TRY_ACQUIRE_INVALID_ARGS. ]*/
+TEST_FUNCTION(srw_lock_try_acquire_shared_with_NULL_handle_fails)
+{
+    ///arrange
+
+    ///act
+    SRW_LOCK_TRY_ACQUIRE_RESULT result = srw_lock_try_acquire_shared(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(SRW_LOCK_TRY_ACQUIRE_RESULT, SRW_LOCK_TRY_ACQUIRE_INVALID_ARGS, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_016: [ Otherwise srw_lock_try_acquire_shared shall call pthread_rwlock_tryrdlock. ]*/
+/*Tests_SRS_SRW_LOCK_LINUX_01_018: [ If pthread_rwlock_tryrdlock succeeds, srw_lock_try_acquire_shared shall return SRW_LOCK_TRY_ACQUIRE_OK. ]*/
+TEST_FUNCTION(srw_lock_try_acquire_shared_when_pthread_rwlock_tryrdlock_succeeds_returns_OK)
+{
+    ///arrange
+    SRW_LOCK_HANDLE srw_lock = test_create_srw_lock();
+    STRICT_EXPECTED_CALL(mock_pthread_rwlock_tryrdlock(IGNORED_ARG));
+
+    ///act
+    SRW_LOCK_TRY_ACQUIRE_RESULT result = srw_lock_try_acquire_shared(srw_lock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(SRW_LOCK_TRY_ACQUIRE_RESULT, SRW_LOCK_TRY_ACQUIRE_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    srw_lock_release_shared(srw_lock);
+    srw_lock_destroy(srw_lock);
+}
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_017: [ If pthread_rwlock_tryrdlock fails, srw_lock_try_acquire_shared shall return SRW_LOCK_TRY_ACQUIRE_COULD_NOT_ACQUIRE. ]*/
+TEST_FUNCTION(srw_lock_try_acquire_shared_when_pthread_rwlock_tryrdlock_fails_returns_COULD_NOT_ACQUIRE)
+{
+    ///arrange
+    SRW_LOCK_HANDLE srw_lock = test_create_srw_lock();
+    STRICT_EXPECTED_CALL(mock_pthread_rwlock_tryrdlock(IGNORED_ARG))
+        .SetReturn(EBUSY);
+
+    ///act
+    SRW_LOCK_TRY_ACQUIRE_RESULT result = srw_lock_try_acquire_shared(srw_lock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(SRW_LOCK_TRY_ACQUIRE_RESULT, SRW_LOCK_TRY_ACQUIRE_COULD_NOT_ACQUIRE, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    srw_lock_destroy(srw_lock);
+}
+
+/* srw_lock_release_shared */
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_019: [ If handle is NULL then srw_lock_release_shared shall return. ]*/
+TEST_FUNCTION(srw_lock_release_shared_with_NULL_handle_returns)
+{
+    ///arrange
+
+    ///act
+    srw_lock_release_shared(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_020: [ srw_lock_release_shared shall call pthread_rwlock_unlock. ]*/
+TEST_FUNCTION(srw_lock_release_shared_calls_pthread_rwlock_unlock)
+{
+    ///arrange
+    SRW_LOCK_HANDLE srw_lock = test_create_srw_lock();
+    srw_lock_acquire_shared(srw_lock);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_pthread_rwlock_unlock(IGNORED_ARG));
+
+    ///act
+    srw_lock_release_shared(srw_lock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    srw_lock_destroy(srw_lock);
+}
+
+/* srw_lock_destroy */
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_021: [ If handle is NULL then srw_lock_destroy shall return. ]*/
+TEST_FUNCTION(srw_lock_destroy_with_NULL_handle_returns)
+{
+    ///arrange
+
+    ///act
+    srw_lock_destroy(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_SRW_LOCK_LINUX_01_022: [ srw_lock_destroy shall call pthread_rwlock_destroy and free the memory of the lock. ]*/
+TEST_FUNCTION(srw_lock_destroy_destroys_the_lock_and_frees_the_memory)
+{
+    ///arrange
+    SRW_LOCK_HANDLE srw_lock = test_create_srw_lock();
+    STRICT_EXPECTED_CALL(mock_pthread_rwlock_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(srw_lock));
+
+    ///act
+    srw_lock_destroy(srw_lock);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
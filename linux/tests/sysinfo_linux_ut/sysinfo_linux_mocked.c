@@ -1,7 +1,19 @@
 // Copyright (c) Microsoft. All rights reserved.
 
+#include <stddef.h>
+
+#include <sys/types.h>
+
 #define sysconf mocked_sysconf
+#define open mocked_open
+#define read mocked_read
+#define close mocked_close
+#define getcpu mocked_getcpu
 
 extern long mocked_sysconf(int name);
+extern int mocked_open(const char* pathname, int flags);
+extern ssize_t mocked_read(int fd, void* buf, size_t count);
+extern int mocked_close(int fd);
+extern int mocked_getcpu(unsigned int* cpu, unsigned int* node);
 
 #include "../../src/sysinfo_linux.c"
@@ -2,17 +2,22 @@
 
 #ifdef __cplusplus
 #include <cstdint>
+#include <cstring>
 #else
 #include <stdint.h>
+#include <string.h>
 #endif
 
+#include <fcntl.h>
 #include <unistd.h>
+#include <sys/types.h>
 
 #include "macro_utils/macro_utils.h" // IWYU pragma: keep
 
 #include "testrunnerswitcher.h"
 #include "umock_c/umock_c.h"
 #include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umocktypes_charptr.h"
 
 #define ENABLE_MOCKS
 
@@ -21,6 +26,10 @@
 extern "C" {
 #endif
     MOCKABLE_FUNCTION(, long, mocked_sysconf, int, name)
+    MOCKABLE_FUNCTION(, int, mocked_open, const char*, pathname, int, flags)
+    MOCKABLE_FUNCTION(, ssize_t, mocked_read, int, fd, void*, buf, size_t, count)
+    MOCKABLE_FUNCTION(, int, mocked_close, int, fd)
+    MOCKABLE_FUNCTION(, int, mocked_getcpu, unsigned int*, cpu, unsigned int*, node)
 #ifdef __cplusplus
 }
 #endif
@@ -28,10 +37,32 @@ extern "C" {
 #undef ENABLE_MOCKS
 
 #include "c_pal/sysinfo.h"
+#include "c_pal/sysinfo_linux.h"
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
 
 static const uint32_t TEST_PROC_COUNT = 4;
+#define TEST_FD 42
+
+static const char* test_sysfs_list;
+
+static ssize_t hook_mocked_read(int fd, void* buf, size_t count)
+{
+    (void)fd;
+    size_t length = strlen(test_sysfs_list);
+    ASSERT_IS_TRUE(length <= count);
+    (void)memcpy(buf, test_sysfs_list, length);
+    return (ssize_t)length;
+}
+
+static void setup_read_sysfs_list_expected_calls(const char* path, const char* list)
+{
+    test_sysfs_list = list;
+    STRICT_EXPECTED_CALL(mocked_open(path, O_RDONLY))
+        .SetReturn(TEST_FD);
+    STRICT_EXPECTED_CALL(mocked_read(TEST_FD, IGNORED_ARG, 4096));
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+}
 
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
@@ -49,6 +80,13 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error), "umock_c_init failed");
     ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types(), "umocktypes_stdint_register_types failed");
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_charptr_register_types(), "umocktypes_charptr_register_types failed");
+
+    REGISTER_UMOCK_ALIAS_TYPE(ssize_t, long);
+
+    REGISTER_GLOBAL_MOCK_HOOK(mocked_read, hook_mocked_read);
+    REGISTER_GLOBAL_MOCK_RETURN(mocked_close, 0);
+    REGISTER_GLOBAL_MOCK_RETURN(mocked_getcpu, 0);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -144,4 +182,340 @@ TEST_FUNCTION(when_sysconf_returns_more_than_UINT32_MAX_sysinfo_get_processor_co
     ASSERT_ARE_EQUAL(uint32_t, 0, proc_count);
 }
 
+/* sysinfo_get_numa_node_count */
+
+/* Tests_SRS_SYSINFO_LINUX_01_004: [ sysinfo_get_numa_node_count shall read the list of online NUMA nodes from /sys/devices/system/node/online. ]*/
+/* Tests_SRS_SYSINFO_LINUX_01_005: [ Otherwise sysinfo_get_numa_node_count shall return the highest online node plus 1. ]*/
+TEST_FUNCTION(sysinfo_get_numa_node_count_returns_the_highest_online_node_plus_1)
+{
+    //arrange
+    setup_read_sysfs_list_expected_calls("/sys/devices/system/node/online", "0-3\n");
+
+    //act
+    uint32_t numa_node_count = sysinfo_get_numa_node_count();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 4, numa_node_count);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_005: [ Otherwise sysinfo_get_numa_node_count shall return the highest online node plus 1. ]*/
+TEST_FUNCTION(sysinfo_get_numa_node_count_with_an_offline_node_returns_the_highest_online_node_plus_1)
+{
+    //arrange
+    setup_read_sysfs_list_expected_calls("/sys/devices/system/node/online", "0,2\n");
+
+    //act
+    uint32_t numa_node_count = sysinfo_get_numa_node_count();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 3, numa_node_count);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_005: [ Otherwise sysinfo_get_numa_node_count shall return the highest online node plus 1. ]*/
+TEST_FUNCTION(sysinfo_get_numa_node_count_with_a_single_node_returns_1)
+{
+    //arrange
+    setup_read_sysfs_list_expected_calls("/sys/devices/system/node/online", "0\n");
+
+    //act
+    uint32_t numa_node_count = sysinfo_get_numa_node_count();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, numa_node_count);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_006: [ If the list cannot be read, is malformed or is empty, sysinfo_get_numa_node_count shall return 1. ]*/
+TEST_FUNCTION(when_open_fails_sysinfo_get_numa_node_count_returns_1)
+{
+    //arrange
+    STRICT_EXPECTED_CALL(mocked_open("/sys/devices/system/node/online", O_RDONLY))
+        .SetReturn(-1);
+
+    //act
+    uint32_t numa_node_count = sysinfo_get_numa_node_count();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, numa_node_count);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_006: [ If the list cannot be read, is malformed or is empty, sysinfo_get_numa_node_count shall return 1. ]*/
+TEST_FUNCTION(when_read_fails_sysinfo_get_numa_node_count_returns_1)
+{
+    //arrange
+    STRICT_EXPECTED_CALL(mocked_open("/sys/devices/system/node/online", O_RDONLY))
+        .SetReturn(TEST_FD);
+    STRICT_EXPECTED_CALL(mocked_read(TEST_FD, IGNORED_ARG, 4096))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    //act
+    uint32_t numa_node_count = sysinfo_get_numa_node_count();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, numa_node_count);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_006: [ If the list cannot be read, is malformed or is empty, sysinfo_get_numa_node_count shall return 1. ]*/
+TEST_FUNCTION(when_the_list_is_malformed_sysinfo_get_numa_node_count_returns_1)
+{
+    //arrange
+    setup_read_sysfs_list_expected_calls("/sys/devices/system/node/online", "0-\n");
+
+    //act
+    uint32_t numa_node_count = sysinfo_get_numa_node_count();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, numa_node_count);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_006: [ If the list cannot be read, is malformed or is empty, sysinfo_get_numa_node_count shall return 1. ]*/
+TEST_FUNCTION(when_the_list_is_empty_sysinfo_get_numa_node_count_returns_1)
+{
+    //arrange
+    setup_read_sysfs_list_expected_calls("/sys/devices/system/node/online", "\n");
+
+    //act
+    uint32_t numa_node_count = sysinfo_get_numa_node_count();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, numa_node_count);
+}
+
+/* sysinfo_get_current_numa_node */
+
+/* Tests_SRS_SYSINFO_LINUX_01_007: [ sysinfo_get_current_numa_node shall call getcpu to obtain the NUMA node of the calling thread. ]*/
+/* Tests_SRS_SYSINFO_LINUX_01_009: [ Otherwise sysinfo_get_current_numa_node shall return the NUMA node returned by getcpu. ]*/
+TEST_FUNCTION(sysinfo_get_current_numa_node_returns_the_node_returned_by_getcpu)
+{
+    //arrange
+    unsigned int test_node = 3;
+    STRICT_EXPECTED_CALL(mocked_getcpu(IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_node(&test_node, sizeof(test_node));
+
+    //act
+    uint32_t numa_node = sysinfo_get_current_numa_node();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 3, numa_node);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_008: [ If getcpu fails, sysinfo_get_current_numa_node shall return 0. ]*/
+TEST_FUNCTION(when_getcpu_fails_sysinfo_get_current_numa_node_returns_0)
+{
+    //arrange
+    unsigned int test_node = 3;
+    STRICT_EXPECTED_CALL(mocked_getcpu(IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_node(&test_node, sizeof(test_node))
+        .SetReturn(-1);
+
+    //act
+    uint32_t numa_node = sysinfo_get_current_numa_node();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, numa_node);
+}
+
+/* sysinfo_get_current_processor */
+
+/* Tests_SRS_SYSINFO_LINUX_01_017: [ sysinfo_get_current_processor shall call getcpu to obtain the CPU of the calling thread. ]*/
+/* Tests_SRS_SYSINFO_LINUX_01_019: [ Otherwise sysinfo_get_current_processor shall return the CPU returned by getcpu. ]*/
+TEST_FUNCTION(sysinfo_get_current_processor_returns_the_cpu_returned_by_getcpu)
+{
+    //arrange
+    unsigned int test_cpu = 5;
+    STRICT_EXPECTED_CALL(mocked_getcpu(IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_cpu(&test_cpu, sizeof(test_cpu));
+
+    //act
+    uint32_t processor = sysinfo_get_current_processor();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 5, processor);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_018: [ If getcpu fails, sysinfo_get_current_processor shall return 0. ]*/
+TEST_FUNCTION(when_getcpu_fails_sysinfo_get_current_processor_returns_0)
+{
+    //arrange
+    unsigned int test_cpu = 5;
+    STRICT_EXPECTED_CALL(mocked_getcpu(IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_cpu(&test_cpu, sizeof(test_cpu))
+        .SetReturn(-1);
+
+    //act
+    uint32_t processor = sysinfo_get_current_processor();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, processor);
+}
+
+/* sysinfo_linux_get_numa_node_cpus */
+
+/* Tests_SRS_SYSINFO_LINUX_01_010: [ If cpus is NULL, sysinfo_linux_get_numa_node_cpus shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(sysinfo_linux_get_numa_node_cpus_with_NULL_cpus_fails)
+{
+    //arrange
+    uint32_t cpu_count;
+
+    //act
+    int result = sysinfo_linux_get_numa_node_cpus(1, NULL, 16, &cpu_count);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_011: [ If cpu_count is NULL, sysinfo_linux_get_numa_node_cpus shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(sysinfo_linux_get_numa_node_cpus_with_NULL_cpu_count_fails)
+{
+    //arrange
+    uint32_t cpus[16];
+
+    //act
+    int result = sysinfo_linux_get_numa_node_cpus(1, cpus, 16, NULL);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_012: [ sysinfo_linux_get_numa_node_cpus shall read the list of CPUs of the node from /sys/devices/system/node/node{numa_node}/cpulist. ]*/
+/* Tests_SRS_SYSINFO_LINUX_01_013: [ sysinfo_linux_get_numa_node_cpus shall store the CPUs of the node in cpus and their number in cpu_count. ]*/
+/* Tests_SRS_SYSINFO_LINUX_01_016: [ Otherwise sysinfo_linux_get_numa_node_cpus shall succeed and return 0. ]*/
+TEST_FUNCTION(sysinfo_linux_get_numa_node_cpus_returns_the_cpus_of_the_node)
+{
+    //arrange
+    uint32_t cpus[16];
+    uint32_t cpu_count;
+    setup_read_sysfs_list_expected_calls("/sys/devices/system/node/node1/cpulist", "4-6,12\n");
+
+    //act
+    int result = sysinfo_linux_get_numa_node_cpus(1, cpus, 16, &cpu_count);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 4, cpu_count);
+    ASSERT_ARE_EQUAL(uint32_t, 4, cpus[0]);
+    ASSERT_ARE_EQUAL(uint32_t, 5, cpus[1]);
+    ASSERT_ARE_EQUAL(uint32_t, 6, cpus[2]);
+    ASSERT_ARE_EQUAL(uint32_t, 12, cpus[3]);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_013: [ sysinfo_linux_get_numa_node_cpus shall store the CPUs of the node in cpus and their number in cpu_count. ]*/
+TEST_FUNCTION(sysinfo_linux_get_numa_node_cpus_with_exactly_cpu_capacity_cpus_succeeds)
+{
+    //arrange
+    uint32_t cpus[2];
+    uint32_t cpu_count;
+    setup_read_sysfs_list_expected_calls("/sys/devices/system/node/node0/cpulist", "0-1\n");
+
+    //act
+    int result = sysinfo_linux_get_numa_node_cpus(0, cpus, 2, &cpu_count);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, cpu_count);
+    ASSERT_ARE_EQUAL(uint32_t, 0, cpus[0]);
+    ASSERT_ARE_EQUAL(uint32_t, 1, cpus[1]);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_013: [ sysinfo_linux_get_numa_node_cpus shall store the CPUs of the node in cpus and their number in cpu_count. ]*/
+TEST_FUNCTION(sysinfo_linux_get_numa_node_cpus_for_a_node_without_cpus_returns_0_cpus)
+{
+    //arrange
+    uint32_t cpus[16];
+    uint32_t cpu_count;
+    setup_read_sysfs_list_expected_calls("/sys/devices/system/node/node2/cpulist", "\n");
+
+    //act
+    int result = sysinfo_linux_get_numa_node_cpus(2, cpus, 16, &cpu_count);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, cpu_count);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_014: [ If the node has more CPUs than cpu_capacity, sysinfo_linux_get_numa_node_cpus shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_the_node_has_more_cpus_than_cpu_capacity_sysinfo_linux_get_numa_node_cpus_fails)
+{
+    //arrange
+    uint32_t cpus[2];
+    uint32_t cpu_count;
+    setup_read_sysfs_list_expected_calls("/sys/devices/system/node/node0/cpulist", "0-2\n");
+
+    //act
+    int result = sysinfo_linux_get_numa_node_cpus(0, cpus, 2, &cpu_count);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_015: [ If the list cannot be read or is malformed, sysinfo_linux_get_numa_node_cpus shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_open_fails_sysinfo_linux_get_numa_node_cpus_fails)
+{
+    //arrange
+    uint32_t cpus[16];
+    uint32_t cpu_count;
+    STRICT_EXPECTED_CALL(mocked_open("/sys/devices/system/node/node1/cpulist", O_RDONLY))
+        .SetReturn(-1);
+
+    //act
+    int result = sysinfo_linux_get_numa_node_cpus(1, cpus, 16, &cpu_count);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_015: [ If the list cannot be read or is malformed, sysinfo_linux_get_numa_node_cpus shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_read_fails_sysinfo_linux_get_numa_node_cpus_fails)
+{
+    //arrange
+    uint32_t cpus[16];
+    uint32_t cpu_count;
+    STRICT_EXPECTED_CALL(mocked_open("/sys/devices/system/node/node1/cpulist", O_RDONLY))
+        .SetReturn(TEST_FD);
+    STRICT_EXPECTED_CALL(mocked_read(TEST_FD, IGNORED_ARG, 4096))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mocked_close(TEST_FD));
+
+    //act
+    int result = sysinfo_linux_get_numa_node_cpus(1, cpus, 16, &cpu_count);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_SYSINFO_LINUX_01_015: [ If the list cannot be read or is malformed, sysinfo_linux_get_numa_node_cpus shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_the_list_is_malformed_sysinfo_linux_get_numa_node_cpus_fails)
+{
+    //arrange
+    uint32_t cpus[16];
+    uint32_t cpu_count;
+    setup_read_sysfs_list_expected_calls("/sys/devices/system/node/node1/cpulist", "6-4\n");
+
+    //act
+    int result = sysinfo_linux_get_numa_node_cpus(1, cpus, 16, &cpu_count);
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
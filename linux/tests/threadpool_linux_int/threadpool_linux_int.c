@@ -0,0 +1,915 @@
+// Copyright (c) Microsoft. All rights reserved.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cinttypes>
+#else
+#include <stdlib.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#endif
+
+#include "testrunnerswitcher.h"
+
+#include "macro_utils/macro_utils.h"
+#include "c_logging/xlogging.h"
+#include "c_pal/timer.h"
+#include "c_pal/threadapi.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sync.h"
+#include "c_pal/threadpool.h"
+#include "c_pal/threadpool_serial_queue.h"
+#include "c_pal/execution_engine.h"
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+
+#include "c_pal/execution_engine_linux.h"
+
+static TEST_MUTEX_HANDLE test_serialize_mutex;
+
+static void on_open_complete(void* context, THREADPOOL_OPEN_RESULT open_result)
+{
+    volatile_atomic int32_t* open_complete_count = (volatile_atomic int32_t*)context;
+    ASSERT_ARE_EQUAL(int, THREADPOOL_OPEN_OK, open_result);
+    (void)interlocked_increment(open_complete_count);
+    wake_by_address_single(open_complete_count);
+}
+
+static void on_open_complete_do_nothing(void* context, THREADPOOL_OPEN_RESULT open_result)
+{
+    (void)context;
+    (void)open_result;
+}
+
+static void work_function(void* context)
+{
+    volatile_atomic int32_t* call_count = (volatile_atomic int32_t*)context;
+    (void)interlocked_increment(call_count);
+    wake_by_address_single(call_count);
+}
+
+typedef struct WAIT_WORK_CONTEXT_TAG
+{
+    volatile_atomic int32_t call_count;
+    volatile_atomic int32_t is_released;
+} WAIT_WORK_CONTEXT;
+
+static void wait_work_function(void* context)
+{
+    WAIT_WORK_CONTEXT* wait_work_context = (WAIT_WORK_CONTEXT*)context;
+    /*whoever waits for this work item to complete releases it once the wait returns, so it must not be released yet*/
+    ThreadAPI_Sleep(2000);
+    ASSERT_ARE_EQUAL(int32_t, 0, interlocked_add(&wait_work_context->is_released, 0));
+    (void)interlocked_increment(&wait_work_context->call_count);
+    wake_by_address_single(&wait_work_context->call_count);
+}
+
+typedef struct CLOSE_WORK_CONTEXT_TAG
+{
+    volatile_atomic int32_t call_count;
+    THREADPOOL_HANDLE threadpool;
+} CLOSE_WORK_CONTEXT;
+
+static void close_work_function(void* context)
+{
+    CLOSE_WORK_CONTEXT* close_work_context = (CLOSE_WORK_CONTEXT*)context;
+    threadpool_close(close_work_context->threadpool);
+    (void)interlocked_increment(&close_work_context->call_count);
+    wake_by_address_single(&close_work_context->call_count);
+}
+
+typedef struct OPEN_WORK_CONTEXT_TAG
+{
+    volatile_atomic int32_t call_count;
+    THREADPOOL_HANDLE threadpool;
+} OPEN_WORK_CONTEXT;
+
+static void open_work_function(void* context)
+{
+    OPEN_WORK_CONTEXT* open_work_context = (OPEN_WORK_CONTEXT*)context;
+    ASSERT_ARE_NOT_EQUAL(int, 0, threadpool_open_async(open_work_context->threadpool, on_open_complete_do_nothing, NULL));
+    (void)interlocked_increment(&open_work_context->call_count);
+    wake_by_address_single(&open_work_context->call_count);
+}
+
+typedef struct RESTART_TIMER_CONTEXT_TAG
+{
+    volatile_atomic int32_t call_count;
+    int32_t run_count;
+    TIMER_INSTANCE_HANDLE timer;
+} RESTART_TIMER_CONTEXT;
+
+static void restart_timer_work_function(void* context)
+{
+    RESTART_TIMER_CONTEXT* restart_timer_context = (RESTART_TIMER_CONTEXT*)context;
+    if (interlocked_increment(&restart_timer_context->call_count) < restart_timer_context->run_count)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_timer_restart(restart_timer_context->timer, 100, 0));
+    }
+    wake_by_address_single(&restart_timer_context->call_count);
+}
+
+typedef struct SERIAL_QUEUE_CONTEXT_TAG
+{
+    volatile_atomic int32_t executed_count;
+    volatile_atomic int32_t running_count;
+    volatile_atomic int32_t out_of_order_count;
+    volatile_atomic int32_t overlap_count;
+} SERIAL_QUEUE_CONTEXT;
+
+typedef struct SERIAL_QUEUE_ITEM_CONTEXT_TAG
+{
+    SERIAL_QUEUE_CONTEXT* serial_queue_context;
+    int32_t index;
+} SERIAL_QUEUE_ITEM_CONTEXT;
+
+static void serial_queue_work_function(void* context)
+{
+    SERIAL_QUEUE_ITEM_CONTEXT* item_context = (SERIAL_QUEUE_ITEM_CONTEXT*)context;
+    SERIAL_QUEUE_CONTEXT* serial_queue_context = item_context->serial_queue_context;
+
+    if (interlocked_increment(&serial_queue_context->running_count) != 1)
+    {
+        (void)interlocked_increment(&serial_queue_context->overlap_count);
+    }
+
+    if (interlocked_add(&serial_queue_context->executed_count, 0) != item_context->index)
+    {
+        (void)interlocked_increment(&serial_queue_context->out_of_order_count);
+    }
+
+    (void)interlocked_decrement(&serial_queue_context->running_count);
+    (void)interlocked_increment(&serial_queue_context->executed_count);
+    wake_by_address_single(&serial_queue_context->executed_count);
+}
+
+typedef struct SERIAL_QUEUE_YIELD_CONTEXT_TAG
+{
+    THREADPOOL_HANDLE threadpool;
+    volatile_atomic int32_t executed_count;
+    volatile_atomic int32_t executed_count_seen_by_other_work;
+} SERIAL_QUEUE_YIELD_CONTEXT;
+
+static void other_work_function(void* context)
+{
+    SERIAL_QUEUE_YIELD_CONTEXT* serial_queue_yield_context = (SERIAL_QUEUE_YIELD_CONTEXT*)context;
+
+    (void)interlocked_exchange(&serial_queue_yield_context->executed_count_seen_by_other_work, interlocked_add(&serial_queue_yield_context->executed_count, 0));
+    wake_by_address_single(&serial_queue_yield_context->executed_count_seen_by_other_work);
+}
+
+static void serial_queue_yield_work_function(void* context)
+{
+    SERIAL_QUEUE_YIELD_CONTEXT* serial_queue_yield_context = (SERIAL_QUEUE_YIELD_CONTEXT*)context;
+
+    if (interlocked_add(&serial_queue_yield_context->executed_count, 0) == 0)
+    {
+        // the first serial work item schedules ordinary work on the same threadpool
+        ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(serial_queue_yield_context->threadpool, other_work_function, serial_queue_yield_context));
+    }
+
+    (void)interlocked_increment(&serial_queue_yield_context->executed_count);
+    wake_by_address_single(&serial_queue_yield_context->executed_count);
+}
+
+static void wait_for_greater_or_equal(volatile_atomic int32_t* value, int32_t expected, uint32_t timeout)
+{
+    double start_time = timer_global_get_elapsed_ms();
+    do
+    {
+        double current_time = timer_global_get_elapsed_ms();
+        if ((timeout != UINT32_MAX) && (current_time - start_time >= timeout))
+        {
+            ASSERT_FAIL("Timeout waiting for value");
+        }
+
+        int32_t current_value = interlocked_add(value, 0);
+        if (current_value >= expected)
+        {
+            break;
+        }
+        (void)wait_on_address(value, current_value, (timeout == UINT32_MAX) ? UINT32_MAX : timeout - (uint32_t)(current_time - start_time));
+    } while (1);
+}
+
+static void wait_for_equal(volatile_atomic int32_t* value, int32_t expected, uint32_t timeout)
+{
+    double start_time = timer_global_get_elapsed_ms();
+    do
+    {
+        double current_time = timer_global_get_elapsed_ms();
+        if ((timeout != UINT32_MAX) && (current_time - start_time >= timeout))
+        {
+            ASSERT_FAIL("Timeout waiting for value");
+        }
+
+        int32_t current_value = interlocked_add(value, 0);
+        if (current_value == expected)
+        {
+            break;
+        }
+        (void)wait_on_address(value, current_value, (timeout == UINT32_MAX) ? UINT32_MAX : timeout - (uint32_t)(current_time - start_time));
+    } while (1);
+}
+
+static EXECUTION_ENGINE_HANDLE create_execution_engine(uint32_t min_thread_count, uint32_t max_thread_count)
+{
+    EXECUTION_ENGINE_PARAMETERS_LINUX execution_engine_parameters =
+    {
+        .min_thread_count = min_thread_count,
+        .max_thread_count = max_thread_count,
+        .max_outstanding_io = DEFAULT_MAX_OUTSTANDING_IO,
+        .stack_size = DEFAULT_STACK_SIZE,
+        .cpu_count = 0,
+        .cpus = NULL,
+        .idle_timeout_ms = DEFAULT_IDLE_TIMEOUT_MS,
+        .max_injected_thread_count = DEFAULT_MAX_INJECTED_THREAD_COUNT
+    };
+    EXECUTION_ENGINE_HANDLE execution_engine = execution_engine_create(&execution_engine_parameters);
+    ASSERT_IS_NOT_NULL(execution_engine);
+    return execution_engine;
+}
+
+static THREADPOOL_HANDLE create_and_open_threadpool(EXECUTION_ENGINE_HANDLE execution_engine)
+{
+    volatile_atomic int32_t open_complete_count;
+    (void)interlocked_exchange(&open_complete_count, 0);
+
+    // create the threadpool
+    THREADPOOL_HANDLE threadpool = threadpool_create(execution_engine);
+    ASSERT_IS_NOT_NULL(threadpool);
+
+    // open and wait for open to complete
+    ASSERT_ARE_EQUAL(int, 0, threadpool_open_async(threadpool, on_open_complete, (void*)&open_complete_count));
+    wait_for_equal(&open_complete_count, 1, UINT32_MAX);
+
+    return threadpool;
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, gballoc_hl_init(NULL, NULL));
+
+    test_serialize_mutex = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(test_serialize_mutex);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    TEST_MUTEX_DESTROY(test_serialize_mutex);
+    gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(test_serialize_mutex))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    TEST_MUTEX_RELEASE(test_serialize_mutex);
+}
+
+TEST_FUNCTION(open_close_open_works)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    volatile_atomic int32_t open_complete_count;
+    (void)interlocked_exchange(&open_complete_count, 0);
+
+    // act
+    ASSERT_ARE_NOT_EQUAL(int, 0, threadpool_open_async(threadpool, on_open_complete, (void*)&open_complete_count));
+    threadpool_close(threadpool);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_open_async(threadpool, on_open_complete, (void*)&open_complete_count));
+
+    // assert
+    wait_for_equal(&open_complete_count, 1, UINT32_MAX);
+
+    // cleanup
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(schedule_work_after_close_fails)
+{
+    // arrange
+    volatile_atomic int32_t call_count;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&call_count, 0);
+    threadpool_close(threadpool);
+
+    // act
+    int result = threadpool_schedule_work(threadpool, work_function, (void*)&call_count);
+
+    // assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ThreadAPI_Sleep(500);
+    ASSERT_ARE_EQUAL(int32_t, 0, interlocked_add(&call_count, 0));
+
+    // cleanup
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(one_work_item_schedule_works)
+{
+    // arrange
+    volatile_atomic int32_t call_count;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&call_count, 0);
+
+    // act (schedule one work item)
+    LogInfo("Scheduling work");
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, work_function, (void*)&call_count));
+
+    // assert
+    wait_for_equal(&call_count, 1, UINT32_MAX);
+    LogInfo("Work completed");
+
+    // cleanup
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+#define N_WORK_ITEMS 100
+
+TEST_FUNCTION(MU_C3(scheduling_, N_WORK_ITEMS, _work_items_works))
+{
+    // arrange
+    volatile_atomic int32_t call_count;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&call_count, 0);
+
+    // act (schedule work items)
+    LogInfo("Scheduling work " MU_TOSTRING(N_WORK_ITEMS) " times");
+    for (uint32_t i = 0; i < N_WORK_ITEMS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, work_function, (void*)&call_count));
+    }
+
+    // assert
+    wait_for_equal(&call_count, N_WORK_ITEMS, UINT32_MAX);
+    LogInfo("Work completed");
+
+    // cleanup
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(MU_C3(scheduling_a_batch_of_, N_WORK_ITEMS, _work_items_works))
+{
+    // arrange
+    volatile_atomic int32_t call_count;
+    THREADPOOL_WORK_BATCH_ITEM work_items[N_WORK_ITEMS];
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&call_count, 0);
+
+    for (uint32_t i = 0; i < N_WORK_ITEMS; i++)
+    {
+        work_items[i].work_function = work_function;
+        work_items[i].work_function_context = (void*)&call_count;
+    }
+
+    // act (schedule all the work items at once)
+    LogInfo("Scheduling a batch of " MU_TOSTRING(N_WORK_ITEMS) " work items");
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_batch(threadpool, work_items, N_WORK_ITEMS));
+
+    // assert
+    wait_for_equal(&call_count, N_WORK_ITEMS, UINT32_MAX);
+    LogInfo("Work completed");
+
+    // cleanup
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(MU_C3(scheduling_one_work_item_, N_WORK_ITEMS, _times_works))
+{
+    // arrange
+    volatile_atomic int32_t call_count;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&call_count, 0);
+
+    THREADPOOL_WORK_ITEM_HANDLE work_item = threadpool_create_work_item(threadpool, work_function, (void*)&call_count);
+    ASSERT_IS_NOT_NULL(work_item);
+
+    // act (schedule the work item repeatedly)
+    LogInfo("Scheduling the same work item " MU_TOSTRING(N_WORK_ITEMS) " times");
+    for (uint32_t i = 0; i < N_WORK_ITEMS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_item(threadpool, work_item));
+    }
+
+    // assert
+    wait_for_equal(&call_count, N_WORK_ITEMS, UINT32_MAX);
+    LogInfo("Work completed");
+
+    // cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(one_start_timer_works_runs_once)
+{
+    // arrange
+    volatile_atomic int32_t call_count;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+
+    // NOTE: this test runs with retries because there are possible timing issues with thread scheduling
+    // We are making sure the worker doesn't start before the delay time and does run once after the delay time
+    // First check could fail in theory
+
+    bool need_to_retry = true;
+    do
+    {
+        (void)interlocked_exchange(&call_count, 0);
+
+        // act (start a timer to start delayed and then execute once)
+        LogInfo("Starting timer");
+        TIMER_INSTANCE_HANDLE timer;
+        ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start(threadpool, 2000, 0, work_function, (void*)&call_count, &timer));
+
+        // assert
+
+        // Timer starts after 2 seconds, wait a bit and it should not yet have run
+        ThreadAPI_Sleep(500);
+        if (interlocked_add(&call_count, 0) != 0)
+        {
+            LogWarning("Timer ran after sleeping 500ms, we just got unlucky, try test again");
+        }
+        else
+        {
+            LogInfo("Waiting for timer to execute after short delay of no execution");
+
+            // Should eventually run once (wait up to 2.5 seconds, but it should run in 1.5 seconds)
+            wait_for_equal(&call_count, 1, 2500);
+            LogInfo("Timer completed, make sure it doesn't run again");
+
+            // And should not run again
+            ThreadAPI_Sleep(2000);
+            ASSERT_ARE_EQUAL(int32_t, 1, interlocked_add(&call_count, 0));
+            LogInfo("Done waiting for timer");
+
+            need_to_retry = false;
+        }
+
+        threadpool_timer_destroy(timer);
+    } while (need_to_retry);
+
+    // cleanup
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(restart_timer_works_runs_once)
+{
+    // arrange
+    volatile_atomic int32_t call_count;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&call_count, 0);
+
+    // start a timer to start delayed after 10 seconds (which would fail test)
+    LogInfo("Starting timer");
+    TIMER_INSTANCE_HANDLE timer;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start(threadpool, 10000, 0, work_function, (void*)&call_count, &timer));
+
+    // act (restart timer to start delayed instead after 500ms)
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_restart(timer, 500, 0));
+
+    // assert
+    wait_for_equal(&call_count, 1, 3000);
+    LogInfo("Timer completed, make sure it doesn't run again");
+
+    ThreadAPI_Sleep(2000);
+    ASSERT_ARE_EQUAL(int32_t, 1, interlocked_add(&call_count, 0));
+
+    // cleanup
+    threadpool_timer_destroy(timer);
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(one_start_timer_works_runs_periodically)
+{
+    // arrange
+    volatile_atomic int32_t call_count;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&call_count, 0);
+
+    // act (start a timer to start delayed and then execute every 500ms)
+    LogInfo("Starting timer");
+    TIMER_INSTANCE_HANDLE timer;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start(threadpool, 100, 500, work_function, (void*)&call_count, &timer));
+
+    // assert
+
+    // Timer should run 4 times in about 1.6 seconds
+    wait_for_equal(&call_count, 4, 3000);
+    LogInfo("Timer completed 4 times");
+
+    // cleanup
+    threadpool_timer_destroy(timer);
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(timer_cancel_restart_works_runs_periodically)
+{
+    // arrange
+    volatile_atomic int32_t call_count;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&call_count, 0);
+
+    // start a timer to start delayed and then execute every 500ms
+    LogInfo("Starting timer");
+    TIMER_INSTANCE_HANDLE timer;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start(threadpool, 100, 500, work_function, (void*)&call_count, &timer));
+
+    // Timer should run 4 times in about 1.6 seconds
+    wait_for_equal(&call_count, 4, 3000);
+    LogInfo("Timer completed 4 times");
+
+    // act
+    LogInfo("Cancel then restart timer");
+    threadpool_timer_cancel(timer);
+    (void)interlocked_exchange(&call_count, 0);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_restart(timer, 100, 1000));
+
+    // assert
+
+    // Timer should run 2 more times in about 1.1 seconds
+    wait_for_equal(&call_count, 2, 3000);
+    LogInfo("Timer completed 2 more times");
+
+    // cleanup
+    threadpool_timer_destroy(timer);
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(timer_restarted_from_its_callback_runs_again)
+{
+    // arrange
+    RESTART_TIMER_CONTEXT restart_timer_context;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&restart_timer_context.call_count, 0);
+    restart_timer_context.run_count = 5;
+
+    // act (start a timer that expires once, its callback restarts it until it ran 5 times)
+    LogInfo("Starting timer");
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start(threadpool, 500, 0, restart_timer_work_function, (void*)&restart_timer_context, &restart_timer_context.timer));
+
+    // assert
+    wait_for_equal(&restart_timer_context.call_count, restart_timer_context.run_count, 5000);
+    LogInfo("Timer completed 5 times, make sure it doesn't run again");
+
+    ThreadAPI_Sleep(1000);
+    ASSERT_ARE_EQUAL(int32_t, restart_timer_context.run_count, interlocked_add(&restart_timer_context.call_count, 0));
+
+    // cleanup
+    threadpool_timer_destroy(restart_timer_context.timer);
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(stop_timer_waits_for_ongoing_execution)
+{
+    // arrange
+    WAIT_WORK_CONTEXT wait_work_context;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&wait_work_context.call_count, 0);
+    (void)interlocked_exchange(&wait_work_context.is_released, 0);
+
+    // schedule one timer that waits
+    LogInfo("Starting timer");
+    TIMER_INSTANCE_HANDLE timer;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start(threadpool, 0, 5000, wait_work_function, (void*)&wait_work_context, &timer));
+
+    ThreadAPI_Sleep(500);
+
+    // act
+    LogInfo("Timer should be running and waiting, now stop timer");
+    threadpool_timer_destroy(timer);
+    LogInfo("Timer stopped");
+
+    // assert
+    ASSERT_ARE_EQUAL(int32_t, 1, interlocked_add(&wait_work_context.call_count, 0));
+
+    // release the callback, which it would see if the stop did not wait for it
+    (void)interlocked_exchange(&wait_work_context.is_released, 1);
+
+    // cleanup
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(cancel_timer_waits_for_ongoing_execution)
+{
+    // arrange
+    WAIT_WORK_CONTEXT wait_work_context;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&wait_work_context.call_count, 0);
+    (void)interlocked_exchange(&wait_work_context.is_released, 0);
+
+    // schedule one timer that waits
+    LogInfo("Starting timer");
+    TIMER_INSTANCE_HANDLE timer;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start(threadpool, 0, 5000, wait_work_function, (void*)&wait_work_context, &timer));
+
+    ThreadAPI_Sleep(500);
+
+    // act
+    LogInfo("Timer should be running and waiting, now cancel timer");
+    threadpool_timer_cancel(timer);
+    LogInfo("Timer canceled");
+
+    // assert
+    ASSERT_ARE_EQUAL(int32_t, 1, interlocked_add(&wait_work_context.call_count, 0));
+
+    // release the callback, which it would see if the cancel did not wait for it
+    (void)interlocked_exchange(&wait_work_context.is_released, 1);
+
+    // cleanup
+    threadpool_timer_destroy(timer);
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+#define N_TIMERS 100
+
+TEST_FUNCTION(MU_C3(starting_, N_TIMERS, _start_timers_work_and_run_periodically))
+{
+    // arrange
+    volatile_atomic int32_t call_count;
+    TIMER_INSTANCE_HANDLE timers[N_TIMERS];
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&call_count, 0);
+
+    // act (start timers to start delayed and then execute every 500ms)
+    LogInfo("Starting " MU_TOSTRING(N_TIMERS) " timers");
+    for (uint32_t i = 0; i < N_TIMERS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start(threadpool, 100, 500, work_function, (void*)&call_count, &timers[i]));
+    }
+
+    // assert
+
+    // Every timer should execute at least twice in less than 1 second
+    LogInfo("Waiting for " MU_TOSTRING(N_TIMERS) " timers to run at least 2 times each");
+    wait_for_greater_or_equal(&call_count, (2 * N_TIMERS), 2000);
+
+    LogInfo("Timers completed, stopping all timers");
+
+    // cleanup
+    for (uint32_t i = 0; i < N_TIMERS; i++)
+    {
+        threadpool_timer_destroy(timers[i]);
+    }
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(close_while_items_are_scheduled_still_executes_all_items)
+{
+    // arrange
+    WAIT_WORK_CONTEXT wait_work_context;
+    // force one thread
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(1, 1);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&wait_work_context.call_count, 0);
+    (void)interlocked_exchange(&wait_work_context.is_released, 0);
+
+    // schedule one item that waits and one that does not
+    LogInfo("Scheduling 2 work items");
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, wait_work_function, (void*)&wait_work_context));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, work_function, (void*)&wait_work_context.call_count));
+
+    // act
+    LogInfo("Closing threadpool");
+    threadpool_close(threadpool);
+
+    // assert
+    ASSERT_ARE_EQUAL(int32_t, 2, interlocked_add(&wait_work_context.call_count, 0));
+
+    // release the work item, which it would see if close did not wait for it
+    (void)interlocked_exchange(&wait_work_context.is_released, 1);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(close_while_closing_still_executes_the_items)
+{
+    // arrange
+    WAIT_WORK_CONTEXT wait_work_context;
+    CLOSE_WORK_CONTEXT close_work_context;
+    // force one thread
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(1, 1);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&wait_work_context.call_count, 0);
+    (void)interlocked_exchange(&wait_work_context.is_released, 0);
+    (void)interlocked_exchange(&close_work_context.call_count, 0);
+    close_work_context.threadpool = threadpool;
+
+    // schedule one item that waits, one that calls close and one that does nothing
+    LogInfo("Scheduling 3 work items");
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, wait_work_function, (void*)&wait_work_context));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, close_work_function, (void*)&close_work_context));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, work_function, (void*)&wait_work_context.call_count));
+
+    // act
+    LogInfo("Closing threadpool");
+    threadpool_close(threadpool);
+    (void)interlocked_exchange(&wait_work_context.is_released, 1);
+
+    // assert
+    wait_for_equal(&close_work_context.call_count, 1, UINT32_MAX);
+    wait_for_equal(&wait_work_context.call_count, 2, UINT32_MAX);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(open_while_closing_fails)
+{
+    // arrange
+    WAIT_WORK_CONTEXT wait_work_context;
+    OPEN_WORK_CONTEXT open_work_context;
+    // force one thread
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(1, 1);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&wait_work_context.call_count, 0);
+    (void)interlocked_exchange(&wait_work_context.is_released, 0);
+    (void)interlocked_exchange(&open_work_context.call_count, 0);
+    open_work_context.threadpool = threadpool;
+
+    // schedule one item that waits, one that calls open and one that does nothing
+    LogInfo("Scheduling 3 work items");
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, wait_work_function, (void*)&wait_work_context));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, open_work_function, (void*)&open_work_context));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, work_function, (void*)&wait_work_context.call_count));
+
+    // act
+    LogInfo("Closing threadpool");
+    threadpool_close(threadpool);
+    (void)interlocked_exchange(&wait_work_context.is_released, 1);
+
+    // assert
+    wait_for_equal(&open_work_context.call_count, 1, UINT32_MAX);
+    wait_for_equal(&wait_work_context.call_count, 2, UINT32_MAX);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+#define N_SERIAL_QUEUE_WORK_ITEMS 1000
+
+static void test_serial_queue_executes_work_items_in_order_one_at_a_time(uint32_t max_batch_size)
+{
+    // arrange
+    SERIAL_QUEUE_CONTEXT serial_queue_context;
+    SERIAL_QUEUE_ITEM_CONTEXT* item_contexts = malloc(N_SERIAL_QUEUE_WORK_ITEMS * sizeof(SERIAL_QUEUE_ITEM_CONTEXT));
+    ASSERT_IS_NOT_NULL(item_contexts);
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&serial_queue_context.executed_count, 0);
+    (void)interlocked_exchange(&serial_queue_context.running_count, 0);
+    (void)interlocked_exchange(&serial_queue_context.out_of_order_count, 0);
+    (void)interlocked_exchange(&serial_queue_context.overlap_count, 0);
+
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = threadpool_serial_queue_create(threadpool, max_batch_size);
+    ASSERT_IS_NOT_NULL(serial_queue);
+
+    // act
+    LogInfo("Scheduling " MU_TOSTRING(N_SERIAL_QUEUE_WORK_ITEMS) " work items on a serial queue with max_batch_size=%" PRIu32 "", max_batch_size);
+    for (int32_t i = 0; i < N_SERIAL_QUEUE_WORK_ITEMS; i++)
+    {
+        item_contexts[i].serial_queue_context = &serial_queue_context;
+        item_contexts[i].index = i;
+        ASSERT_ARE_EQUAL(int, 0, threadpool_serial_queue_schedule_work(serial_queue, serial_queue_work_function, &item_contexts[i]));
+    }
+
+    // assert
+    wait_for_equal(&serial_queue_context.executed_count, N_SERIAL_QUEUE_WORK_ITEMS, UINT32_MAX);
+    ASSERT_ARE_EQUAL(int32_t, 0, interlocked_add(&serial_queue_context.out_of_order_count, 0));
+    ASSERT_ARE_EQUAL(int32_t, 0, interlocked_add(&serial_queue_context.overlap_count, 0));
+
+    // cleanup
+    threadpool_serial_queue_destroy(serial_queue);
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+    free(item_contexts);
+}
+
+TEST_FUNCTION(serial_queue_executes_work_items_in_order_one_at_a_time)
+{
+    test_serial_queue_executes_work_items_in_order_one_at_a_time(0);
+}
+
+TEST_FUNCTION(serial_queue_with_a_max_batch_size_executes_work_items_in_order_one_at_a_time)
+{
+    test_serial_queue_executes_work_items_in_order_one_at_a_time(1);
+}
+
+TEST_FUNCTION(serial_queue_with_a_max_batch_size_lets_other_work_run_between_batches)
+{
+    // arrange
+    SERIAL_QUEUE_YIELD_CONTEXT serial_queue_yield_context;
+    // one thread, so that the other work can only run if the serial queue gives the thread back
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(1, 1);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    serial_queue_yield_context.threadpool = threadpool;
+    (void)interlocked_exchange(&serial_queue_yield_context.executed_count, 0);
+    (void)interlocked_exchange(&serial_queue_yield_context.executed_count_seen_by_other_work, -1);
+
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = threadpool_serial_queue_create(threadpool, 1);
+    ASSERT_IS_NOT_NULL(serial_queue);
+
+    // act
+    for (int32_t i = 0; i < N_SERIAL_QUEUE_WORK_ITEMS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_serial_queue_schedule_work(serial_queue, serial_queue_yield_work_function, &serial_queue_yield_context));
+    }
+
+    // assert
+    wait_for_equal(&serial_queue_yield_context.executed_count, N_SERIAL_QUEUE_WORK_ITEMS, UINT32_MAX);
+    wait_for_greater_or_equal(&serial_queue_yield_context.executed_count_seen_by_other_work, 0, UINT32_MAX);
+    // the other work ran between two batches, not after the serial queue was drained
+    ASSERT_IS_TRUE(interlocked_add(&serial_queue_yield_context.executed_count_seen_by_other_work, 0) < N_SERIAL_QUEUE_WORK_ITEMS);
+
+    // cleanup
+    threadpool_serial_queue_destroy(serial_queue);
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(serial_queue_destroy_waits_for_the_scheduled_work_items)
+{
+    // arrange
+    WAIT_WORK_CONTEXT wait_work_context;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine(4, 4);
+    THREADPOOL_HANDLE threadpool = create_and_open_threadpool(execution_engine);
+    (void)interlocked_exchange(&wait_work_context.call_count, 0);
+    (void)interlocked_exchange(&wait_work_context.is_released, 0);
+
+    THREADPOOL_SERIAL_QUEUE_HANDLE serial_queue = threadpool_serial_queue_create(threadpool, 0);
+    ASSERT_IS_NOT_NULL(serial_queue);
+
+    // schedule one item that waits and one that runs after it
+    ASSERT_ARE_EQUAL(int, 0, threadpool_serial_queue_schedule_work(serial_queue, wait_work_function, (void*)&wait_work_context));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_serial_queue_schedule_work(serial_queue, work_function, (void*)&wait_work_context.call_count));
+
+    // act
+    threadpool_serial_queue_destroy(serial_queue);
+
+    // assert
+    ASSERT_ARE_EQUAL(int32_t, 2, interlocked_add(&wait_work_context.call_count, 0));
+
+    // release the work item, which it would see if destroy did not wait for it
+    (void)interlocked_exchange(&wait_work_context.is_released, 1);
+
+    // cleanup
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,3595 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#endif
+
+#include "macro_utils/macro_utils.h"
+
+#include "real_gballoc_ll.h"
+static void* real_malloc(size_t size)
+{
+    return real_gballoc_ll_malloc(size);
+}
+
+static void real_free(void* ptr)
+{
+    real_gballoc_ll_free(ptr);
+}
+
+#include "testrunnerswitcher.h"
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes_bool.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umock_c_negative_tests.h"
+
+#define ENABLE_MOCKS
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sync.h"
+#include "c_pal/timer.h"
+#include "c_pal/execution_engine.h"
+#include "c_pal/execution_engine_linux.h"
+#include "c_pal/worker_pool_linux.h"
+#include "c_pal/timer_wheel_linux.h"
+
+MOCKABLE_FUNCTION(, void, test_on_open_complete, void*, context, THREADPOOL_OPEN_RESULT, open_result);
+MOCKABLE_FUNCTION(, void, test_work_function, void*, context);
+
+#undef ENABLE_MOCKS
+
+#include "real_gballoc_hl.h"
+#include "real_interlocked.h"
+#include "real_sync.h"
+
+#include "c_pal/threadpool.h"
+
+/*threadpool.h is already included, so only the statistics functions are mocked*/
+#define ENABLE_MOCKS
+#include "c_pal/threadpool_statistics.h"
+#undef ENABLE_MOCKS
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+static EXECUTION_ENGINE_HANDLE test_execution_engine = (EXECUTION_ENGINE_HANDLE)0x4243;
+static WORKER_POOL_LINUX_HANDLE test_worker_pool = (WORKER_POOL_LINUX_HANDLE)0x4244;
+static TIMER_WHEEL_LINUX_HANDLE test_timer_wheel = (TIMER_WHEEL_LINUX_HANDLE)0x4246;
+static WORKER_POOL_LINUX_HANDLE test_numa_node_worker_pool = (WORKER_POOL_LINUX_HANDLE)0x4247;
+static THREADPOOL_STATISTICS_RECORDER_HANDLE test_statistics_recorder = (THREADPOOL_STATISTICS_RECORDER_HANDLE)0x4248;
+
+static const THREADPOOL_WORK_BATCH_ITEM test_batch_work_items[] =
+{
+    { test_work_function, (void*)0x4245 },
+    { test_work_function, (void*)0x4246 },
+    { test_work_function, (void*)0x4247 }
+};
+#define TEST_BATCH_WORK_ITEM_COUNT 3
+
+static WORKER_POOL_LINUX_WORK_ITEM* captured_work_item;
+/*run from wait_on_address, simulates a worker thread completing the work item while threadpool_close waits*/
+static WORKER_POOL_LINUX_WORK_ITEM* work_item_to_run_on_wait;
+/*scheduled again from worker_pool_linux_submit, simulates another thread scheduling the work item while it is being submitted*/
+static THREADPOOL_HANDLE threadpool_to_schedule_on_submit;
+static THREADPOOL_WORK_ITEM_HANDLE work_item_to_schedule_on_submit;
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+TEST_DEFINE_ENUM_TYPE(THREADPOOL_OPEN_RESULT, THREADPOOL_OPEN_RESULT_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(THREADPOOL_OPEN_RESULT, THREADPOOL_OPEN_RESULT_VALUES)
+
+TEST_DEFINE_ENUM_TYPE(WORKER_POOL_LINUX_PRIORITY, WORKER_POOL_LINUX_PRIORITY_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(WORKER_POOL_LINUX_PRIORITY, WORKER_POOL_LINUX_PRIORITY_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static int hook_worker_pool_linux_submit(WORKER_POOL_LINUX_HANDLE worker_pool, WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    (void)worker_pool;
+    captured_work_item = work_item;
+    return 0;
+}
+
+static int hook_worker_pool_linux_submit_batch(WORKER_POOL_LINUX_HANDLE worker_pool, WORKER_POOL_LINUX_WORK_ITEM* work_items)
+{
+    (void)worker_pool;
+    captured_work_item = work_items;
+    return 0;
+}
+
+static int hook_worker_pool_linux_submit_schedules_again_and_fails(WORKER_POOL_LINUX_HANDLE worker_pool, WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    (void)worker_pool;
+    (void)work_item;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_item(threadpool_to_schedule_on_submit, work_item_to_schedule_on_submit));
+    return MU_FAILURE;
+}
+
+static bool hook_wait_on_address(volatile_atomic int32_t* address, int32_t compare_value, uint32_t timeout_ms)
+{
+    (void)address;
+    (void)compare_value;
+    (void)timeout_ms;
+    if (work_item_to_run_on_wait != NULL)
+    {
+        WORKER_POOL_LINUX_WORK_ITEM* work_item = work_item_to_run_on_wait;
+        work_item_to_run_on_wait = NULL;
+        work_item->work_function(work_item->work_function_context);
+    }
+    return true;
+}
+
+static THREADPOOL_HANDLE test_create_threadpool(void)
+{
+    THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(threadpool);
+    umock_c_reset_all_calls();
+    return threadpool;
+}
+
+static THREADPOOL_HANDLE test_create_and_open_threadpool(void)
+{
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+    ASSERT_ARE_EQUAL(int, 0, threadpool_open_async(threadpool, test_on_open_complete, (void*)0x4242));
+    umock_c_reset_all_calls();
+    return threadpool;
+}
+
+static WORKER_POOL_LINUX_WORK_ITEM* test_schedule_work(THREADPOOL_HANDLE threadpool, void* work_function_context)
+{
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, test_work_function, work_function_context));
+    ASSERT_IS_NOT_NULL(captured_work_item);
+    umock_c_reset_all_calls();
+    return captured_work_item;
+}
+
+static WORKER_POOL_LINUX_WORK_ITEM* test_schedule_work_batch(THREADPOOL_HANDLE threadpool)
+{
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_batch(threadpool, test_batch_work_items, TEST_BATCH_WORK_ITEM_COUNT));
+    ASSERT_IS_NOT_NULL(captured_work_item);
+    umock_c_reset_all_calls();
+    return captured_work_item;
+}
+
+/*runs the work items of a list submitted to the worker pool, like a worker thread would*/
+static void test_run_work_items(WORKER_POOL_LINUX_WORK_ITEM* work_items)
+{
+    while (work_items != NULL)
+    {
+        /*the work function can free the work item*/
+        WORKER_POOL_LINUX_WORK_ITEM* next = work_items->next;
+        work_items->work_function(work_items->work_function_context);
+        work_items = next;
+    }
+}
+
+static THREADPOOL_WORK_ITEM_HANDLE test_create_work_item(THREADPOOL_HANDLE threadpool, void* work_function_context)
+{
+    THREADPOOL_WORK_ITEM_HANDLE work_item = threadpool_create_work_item(threadpool, test_work_function, work_function_context);
+    ASSERT_IS_NOT_NULL(work_item);
+    umock_c_reset_all_calls();
+    return work_item;
+}
+
+static WORKER_POOL_LINUX_WORK_ITEM* test_schedule_work_item(THREADPOOL_HANDLE threadpool, THREADPOOL_WORK_ITEM_HANDLE work_item)
+{
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_item(threadpool, work_item));
+    ASSERT_IS_NOT_NULL(captured_work_item);
+    umock_c_reset_all_calls();
+    return captured_work_item;
+}
+
+static TIMER_INSTANCE_HANDLE test_start_timer(THREADPOOL_HANDLE threadpool)
+{
+    TIMER_INSTANCE_HANDLE timer_instance;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4245, &timer_instance));
+    umock_c_reset_all_calls();
+    return timer_instance;
+}
+
+static THREADPOOL_HANDLE test_create_and_open_threadpool_with_statistics(void)
+{
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+    ASSERT_ARE_EQUAL(int, 0, threadpool_enable_statistics(threadpool));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_open_async(threadpool, test_on_open_complete, (void*)0x4242));
+    umock_c_reset_all_calls();
+    return threadpool;
+}
+
+static void setup_queue_wait_init_expected_calls(void)
+{
+    for (uint32_t i = 0; i < 3 * 3; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0))
+            .CallCannotFail();
+    }
+}
+
+static void setup_close_expected_calls(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error));
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_bool_register_types());
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+
+    REGISTER_GLOBAL_MOCK_HOOK(malloc, real_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
+    REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
+    REGISTER_SYNC_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_HOOK(wait_on_address, hook_wait_on_address);
+    REGISTER_GLOBAL_MOCK_HOOK(worker_pool_linux_submit, hook_worker_pool_linux_submit);
+    REGISTER_GLOBAL_MOCK_HOOK(worker_pool_linux_submit_batch, hook_worker_pool_linux_submit_batch);
+
+    REGISTER_GLOBAL_MOCK_RETURN(execution_engine_linux_get_worker_pool, test_worker_pool);
+    REGISTER_GLOBAL_MOCK_RETURNS(execution_engine_linux_get_timer_wheel, test_timer_wheel, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(timer_wheel_linux_timer_init, 0, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_RETURNS(timer_wheel_linux_timer_start, 0, MU_FAILURE);
+
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(execution_engine_linux_get_worker_pool, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(execution_engine_linux_get_numa_node_worker_pool, test_numa_node_worker_pool, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(worker_pool_linux_submit, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(worker_pool_linux_submit_batch, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_RETURNS(threadpool_statistics_recorder_create, test_statistics_recorder, NULL);
+
+    REGISTER_UMOCK_ALIAS_TYPE(EXECUTION_ENGINE_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(WORKER_POOL_LINUX_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TIMER_WHEEL_LINUX_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TIMER_WHEEL_LINUX_ON_TIMER_EXPIRED, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(THREADPOOL_STATISTICS_RECORDER_HANDLE, void*);
+
+    REGISTER_TYPE(THREADPOOL_OPEN_RESULT, THREADPOOL_OPEN_RESULT);
+    REGISTER_TYPE(WORKER_POOL_LINUX_PRIORITY, WORKER_POOL_LINUX_PRIORITY);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    captured_work_item = NULL;
+    work_item_to_run_on_wait = NULL;
+
+    umock_c_reset_all_calls();
+    umock_c_negative_tests_init();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    umock_c_negative_tests_deinit();
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* threadpool_create */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_002: [ If execution_engine is NULL, threadpool_create shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_create_with_NULL_execution_engine_fails)
+{
+    ///arrange
+
+    ///act
+    THREADPOOL_HANDLE threadpool = threadpool_create(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(threadpool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_001: [ threadpool_create shall allocate a new threadpool object and on success shall return a non-NULL handle. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_003: [ threadpool_create shall obtain the worker pool from the execution engine by calling execution_engine_linux_get_worker_pool. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_102: [ threadpool_create shall initialize the queue wait statistics of all the priorities to 0. ]*/
+TEST_FUNCTION(threadpool_create_succeeds)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_worker_pool(test_execution_engine));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    setup_queue_wait_init_expected_calls();
+
+    ///act
+    THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(threadpool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_004: [ If any error occurs, threadpool_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_create_fails)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_worker_pool(test_execution_engine));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+    setup_queue_wait_init_expected_calls();
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
+
+            ///assert
+            ASSERT_IS_NULL(threadpool, "On failed call %zu", i);
+        }
+    }
+}
+
+/* threadpool_destroy */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_005: [ If threadpool is NULL, threadpool_destroy shall return. ]*/
+TEST_FUNCTION(threadpool_destroy_with_NULL_threadpool_returns)
+{
+    ///arrange
+
+    ///act
+    threadpool_destroy(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_006: [ Otherwise, threadpool_destroy shall free all resources associated with threadpool. ]*/
+TEST_FUNCTION(threadpool_destroy_frees_resources)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(threadpool));
+
+    ///act
+    threadpool_destroy(threadpool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_007: [ While threadpool is OPENING or CLOSING, threadpool_destroy shall wait for the open or close to complete. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_008: [ threadpool_destroy shall perform an implicit close if threadpool is OPEN. ]*/
+TEST_FUNCTION(threadpool_destroy_performs_an_implicit_close)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    setup_close_expected_calls();
+    STRICT_EXPECTED_CALL(free(threadpool));
+
+    ///act
+    threadpool_destroy(threadpool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* threadpool_open_async */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_009: [ If threadpool is NULL, threadpool_open_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_open_async_with_NULL_threadpool_fails)
+{
+    ///arrange
+
+    ///act
+    int result = threadpool_open_async(NULL, test_on_open_complete, (void*)0x4242);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_010: [ If on_open_complete is NULL, threadpool_open_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_open_async_with_NULL_on_open_complete_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+
+    ///act
+    int result = threadpool_open_async(threadpool, NULL, (void*)0x4242);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_012: [ Otherwise, threadpool_open_async shall switch the state to OPENING. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_014: [ threadpool_open_async shall set the state to OPEN. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_015: [ On success, threadpool_open_async shall call on_open_complete with THREADPOOL_OPEN_OK. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_016: [ On success, threadpool_open_async shall return 0. ]*/
+TEST_FUNCTION(threadpool_open_async_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_open_complete((void*)0x4242, THREADPOOL_OPEN_OK));
+
+    ///act
+    int result = threadpool_open_async(threadpool, test_on_open_complete, (void*)0x4242);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_011: [ on_open_complete_context shall be allowed to be NULL. ]*/
+TEST_FUNCTION(threadpool_open_async_with_NULL_on_open_complete_context_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_open_complete(NULL, THREADPOOL_OPEN_OK));
+
+    ///act
+    int result = threadpool_open_async(threadpool, test_on_open_complete, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_013: [ If threadpool is already OPEN or OPENING, threadpool_open_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_open_async_after_open_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    ///act
+    int result = threadpool_open_async(threadpool, test_on_open_complete, (void*)0x4242);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_close */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_017: [ If threadpool is NULL, threadpool_close shall return. ]*/
+TEST_FUNCTION(threadpool_close_with_NULL_threadpool_returns)
+{
+    ///arrange
+
+    ///act
+    threadpool_close(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_022: [ If threadpool is not OPEN, threadpool_close shall return. ]*/
+TEST_FUNCTION(threadpool_close_when_not_open_returns)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    ///act
+    threadpool_close(threadpool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_021: [ Otherwise, threadpool_close shall switch the state to CLOSING. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_018: [ threadpool_close shall wait for the API calls in progress to complete. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_019: [ threadpool_close shall wait for all the scheduled work items to complete. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_020: [ threadpool_close shall set the state to CLOSED. ]*/
+TEST_FUNCTION(threadpool_close_closes_the_threadpool)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    setup_close_expected_calls();
+
+    ///act
+    threadpool_close(threadpool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_019: [ threadpool_close shall wait for all the scheduled work items to complete. ]*/
+TEST_FUNCTION(threadpool_close_waits_for_the_scheduled_work_items)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    work_item_to_run_on_wait = test_schedule_work(threadpool, (void*)0x4245);
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 1, UINT32_MAX));
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    threadpool_close(threadpool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_020: [ threadpool_close shall set the state to CLOSED. ]*/
+TEST_FUNCTION(threadpool_open_async_after_close_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    threadpool_close(threadpool);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_on_open_complete((void*)0x4242, THREADPOOL_OPEN_OK));
+
+    ///act
+    int result = threadpool_open_async(threadpool, test_on_open_complete, (void*)0x4242);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_schedule_work */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_023: [ If threadpool is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_with_NULL_threadpool_fails)
+{
+    ///arrange
+
+    ///act
+    int result = threadpool_schedule_work(NULL, test_work_function, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_024: [ If work_function is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_with_NULL_work_function_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    ///act
+    int result = threadpool_schedule_work(threadpool, NULL, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_031: [ If threadpool is not OPEN, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_when_not_open_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work(threadpool, test_work_function, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_032: [ Otherwise threadpool_schedule_work shall allocate a context where work_function and work_function_context shall be saved. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_104: [ threadpool_schedule_work shall schedule the work item with THREADPOOL_PRIORITY_NORMAL, submitting it to the worker pool with WORKER_POOL_LINUX_PRIORITY_NORMAL. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_033: [ threadpool_schedule_work shall increment the count of pending work items. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_034: [ threadpool_schedule_work shall submit the work item to the worker pool by calling worker_pool_linux_submit with on_work_callback and the newly created context. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_036: [ threadpool_schedule_work shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_schedule_work_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work(threadpool, test_work_function, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_work_item);
+    ASSERT_IS_NOT_NULL(captured_work_item->work_function);
+    ASSERT_ARE_EQUAL(void_ptr, captured_work_item, captured_work_item->work_function_context);
+    ASSERT_ARE_EQUAL(WORKER_POOL_LINUX_PRIORITY, WORKER_POOL_LINUX_PRIORITY_NORMAL, captured_work_item->priority);
+
+    ///cleanup
+    captured_work_item->work_function(captured_work_item->work_function_context);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_025: [ work_function_context shall be allowed to be NULL. ]*/
+TEST_FUNCTION(threadpool_schedule_work_with_NULL_work_function_context_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work(threadpool, test_work_function, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_work_item->work_function(captured_work_item->work_function_context);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_035: [ If any error occurs, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_schedule_work_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            int result = threadpool_schedule_work(threadpool, test_work_function, (void*)0x4245);
+
+            ///assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+        }
+    }
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_035: [ If any error occurs, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_worker_pool_linux_submit_fails_threadpool_schedule_work_frees_the_context)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work(threadpool, test_work_function, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_schedule_work_with_priority */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_105: [ If threadpool is NULL, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_with_priority_with_NULL_threadpool_fails)
+{
+    ///arrange
+
+    ///act
+    int result = threadpool_schedule_work_with_priority(NULL, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_106: [ If priority is not THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL or THREADPOOL_PRIORITY_LOW, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_with_priority_with_an_invalid_priority_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    ///act
+    int result = threadpool_schedule_work_with_priority(threadpool, (THREADPOOL_PRIORITY)0x42, test_work_function, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_107: [ If work_function is NULL, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_with_priority_with_NULL_work_function_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    ///act
+    int result = threadpool_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, NULL, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_110: [ Otherwise threadpool_schedule_work_with_priority shall schedule the work item like threadpool_schedule_work, submitting it to the worker pool with the WORKER_POOL_LINUX_PRIORITY matching priority. ]*/
+TEST_FUNCTION(threadpool_schedule_work_with_priority_submits_with_the_matching_worker_pool_priority)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    const struct
+    {
+        THREADPOOL_PRIORITY priority;
+        WORKER_POOL_LINUX_PRIORITY worker_pool_priority;
+    } priorities[] =
+    {
+        { THREADPOOL_PRIORITY_HIGH, WORKER_POOL_LINUX_PRIORITY_HIGH },
+        { THREADPOOL_PRIORITY_NORMAL, WORKER_POOL_LINUX_PRIORITY_NORMAL },
+        { THREADPOOL_PRIORITY_LOW, WORKER_POOL_LINUX_PRIORITY_LOW }
+    };
+
+    for (size_t i = 0; i < MU_COUNT_ARRAY_ITEMS(priorities); i++)
+    {
+        captured_work_item = NULL;
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG));
+        STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+        ///act
+        int result = threadpool_schedule_work_with_priority(threadpool, priorities[i].priority, test_work_function, (void*)0x4245);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_IS_NOT_NULL(captured_work_item);
+        ASSERT_ARE_EQUAL(void_ptr, captured_work_item, captured_work_item->work_function_context);
+        ASSERT_ARE_EQUAL(WORKER_POOL_LINUX_PRIORITY, priorities[i].worker_pool_priority, captured_work_item->priority);
+
+        ///cleanup
+        captured_work_item->work_function(captured_work_item->work_function_context);
+    }
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_108: [ work_function_context shall be allowed to be NULL. ]*/
+TEST_FUNCTION(threadpool_schedule_work_with_priority_with_NULL_work_function_context_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_LOW, test_work_function, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_work_item->work_function(captured_work_item->work_function_context);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_111: [ If any error occurs, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_schedule_work_with_priority_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            int result = threadpool_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4245);
+
+            ///assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+        }
+    }
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_schedule_work_on_node */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_125: [ If threadpool is NULL, threadpool_schedule_work_on_node shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_on_node_with_NULL_threadpool_fails)
+{
+    ///arrange
+
+    ///act
+    int result = threadpool_schedule_work_on_node(NULL, 1, test_work_function, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_126: [ If work_function is NULL, threadpool_schedule_work_on_node shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_on_node_with_NULL_work_function_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    ///act
+    int result = threadpool_schedule_work_on_node(threadpool, 1, NULL, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_128: [ threadpool_schedule_work_on_node shall obtain the worker pool of numa_node by calling execution_engine_linux_get_numa_node_worker_pool. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_129: [ threadpool_schedule_work_on_node shall schedule the work item like threadpool_schedule_work, submitting it to the worker pool of numa_node. ]*/
+TEST_FUNCTION(threadpool_schedule_work_on_node_submits_to_the_worker_pool_of_the_node)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_numa_node_worker_pool(test_execution_engine, 1));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_numa_node_worker_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work_on_node(threadpool, 1, test_work_function, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_work_item);
+    ASSERT_ARE_EQUAL(void_ptr, captured_work_item, captured_work_item->work_function_context);
+    ASSERT_ARE_EQUAL(WORKER_POOL_LINUX_PRIORITY, WORKER_POOL_LINUX_PRIORITY_NORMAL, captured_work_item->priority);
+
+    ///cleanup
+    captured_work_item->work_function(captured_work_item->work_function_context);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_127: [ work_function_context shall be allowed to be NULL. ]*/
+TEST_FUNCTION(threadpool_schedule_work_on_node_with_NULL_work_function_context_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_numa_node_worker_pool(test_execution_engine, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_numa_node_worker_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work_on_node(threadpool, 0, test_work_function, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_work_item->work_function(captured_work_item->work_function_context);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_130: [ If any error occurs, threadpool_schedule_work_on_node shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_schedule_work_on_node_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_numa_node_worker_pool(test_execution_engine, 1));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_numa_node_worker_pool, IGNORED_ARG));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            int result = threadpool_schedule_work_on_node(threadpool, 1, test_work_function, (void*)0x4245);
+
+            ///assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+        }
+    }
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* on_work_callback */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_026: [ If context is NULL, on_work_callback shall return. ]*/
+TEST_FUNCTION(on_work_callback_with_NULL_context_returns)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    WORKER_POOL_LINUX_WORK_ITEM* work_item = test_schedule_work(threadpool, (void*)0x4245);
+
+    ///act
+    work_item->work_function(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    work_item->work_function(work_item->work_function_context);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_027: [ Otherwise context shall be used as the context created in threadpool_schedule_work. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_028: [ The work_function callback passed to threadpool_schedule_work shall be called, passing to it the work_function_context argument passed to threadpool_schedule_work. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_029: [ on_work_callback shall free the context allocated in threadpool_schedule_work. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_030: [ on_work_callback shall decrement the count of pending work items and wake threadpool_close if it reached 0. ]*/
+TEST_FUNCTION(on_work_callback_calls_the_work_function_and_frees_the_context)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    WORKER_POOL_LINUX_WORK_ITEM* work_item = test_schedule_work(threadpool, (void*)0x4245);
+    THREADPOOL_QUEUE_WAIT_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(free(work_item));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    work_item->work_function(work_item->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    /*the statistics are disabled, so the queue wait is not recorded*/
+    ASSERT_ARE_EQUAL(int, 0, threadpool_get_queue_wait_statistics(threadpool, THREADPOOL_PRIORITY_NORMAL, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.work_item_count);
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_030: [ on_work_callback shall decrement the count of pending work items and wake threadpool_close if it reached 0. ]*/
+TEST_FUNCTION(on_work_callback_does_not_wake_when_other_work_items_are_pending)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    WORKER_POOL_LINUX_WORK_ITEM* work_item_1 = test_schedule_work(threadpool, (void*)0x4245);
+    WORKER_POOL_LINUX_WORK_ITEM* work_item_2 = test_schedule_work(threadpool, (void*)0x4246);
+
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(free(work_item_1));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+
+    ///act
+    work_item_1->work_function(work_item_1->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    work_item_2->work_function(work_item_2->work_function_context);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_109: [ If the statistics are enabled, on_work_callback shall add the time the work item waited between being scheduled and the start time returned by threadpool_statistics_recorder_on_started to the queue wait statistics of its priority. ]*/
+TEST_FUNCTION(on_work_callback_records_the_queue_wait_for_the_priority_of_the_work_item)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+    THREADPOOL_QUEUE_WAIT_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1000);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4245));
+    WORKER_POOL_LINUX_WORK_ITEM* work_item = captured_work_item;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_started(test_statistics_recorder, 1000))
+        .SetReturn(1500);
+    STRICT_EXPECTED_CALL(interlocked_increment_64(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 500));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 500, 0));
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_completed(test_statistics_recorder, 1500));
+    STRICT_EXPECTED_CALL(free(work_item));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    work_item->work_function(work_item->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, threadpool_get_queue_wait_statistics(threadpool, THREADPOOL_PRIORITY_HIGH, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.work_item_count);
+    ASSERT_ARE_EQUAL(uint64_t, 500, statistics.total_queue_wait_us);
+    ASSERT_ARE_EQUAL(uint64_t, 500, statistics.max_queue_wait_us);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_get_queue_wait_statistics(threadpool, THREADPOOL_PRIORITY_NORMAL, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.work_item_count);
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_109: [ If the statistics are enabled, on_work_callback shall add the time the work item waited between being scheduled and the start time returned by threadpool_statistics_recorder_on_started to the queue wait statistics of its priority. ]*/
+TEST_FUNCTION(on_work_callback_keeps_the_maximum_queue_wait_when_the_work_item_waited_less)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+    THREADPOOL_QUEUE_WAIT_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1000);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_LOW, test_work_function, (void*)0x4245));
+    WORKER_POOL_LINUX_WORK_ITEM* work_item_1 = captured_work_item;
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1300);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_LOW, test_work_function, (void*)0x4246));
+    WORKER_POOL_LINUX_WORK_ITEM* work_item_2 = captured_work_item;
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_started(test_statistics_recorder, 1000))
+        .SetReturn(1500);
+    work_item_1->work_function(work_item_1->work_function_context);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_started(test_statistics_recorder, 1300))
+        .SetReturn(1500);
+    STRICT_EXPECTED_CALL(interlocked_increment_64(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 200));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4246));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_completed(test_statistics_recorder, 1500));
+    STRICT_EXPECTED_CALL(free(work_item_2));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    work_item_2->work_function(work_item_2->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, threadpool_get_queue_wait_statistics(threadpool, THREADPOOL_PRIORITY_LOW, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 2, statistics.work_item_count);
+    ASSERT_ARE_EQUAL(uint64_t, 700, statistics.total_queue_wait_us);
+    ASSERT_ARE_EQUAL(uint64_t, 500, statistics.max_queue_wait_us);
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_schedule_work_batch */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_086: [ If threadpool is NULL, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_with_NULL_threadpool_fails)
+{
+    ///arrange
+
+    ///act
+    int result = threadpool_schedule_work_batch(NULL, test_batch_work_items, TEST_BATCH_WORK_ITEM_COUNT);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_087: [ If work_items is NULL, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_with_NULL_work_items_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    ///act
+    int result = threadpool_schedule_work_batch(threadpool, NULL, TEST_BATCH_WORK_ITEM_COUNT);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_088: [ If work_item_count is 0 or greater than INT32_MAX, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_with_0_work_item_count_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    ///act
+    int result = threadpool_schedule_work_batch(threadpool, test_batch_work_items, 0);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_088: [ If work_item_count is 0 or greater than INT32_MAX, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_with_work_item_count_greater_than_INT32_MAX_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    ///act
+    int result = threadpool_schedule_work_batch(threadpool, test_batch_work_items, (uint32_t)INT32_MAX + 1);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_089: [ If the work_function of any of the work items is NULL, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_with_a_NULL_work_function_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_BATCH_ITEM work_items[] =
+    {
+        { test_work_function, (void*)0x4245 },
+        { NULL, (void*)0x4246 }
+    };
+
+    ///act
+    int result = threadpool_schedule_work_batch(threadpool, work_items, MU_COUNT_ARRAY_ITEMS(work_items));
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_091: [ If threadpool is not OPEN, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_when_not_open_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work_batch(threadpool, test_batch_work_items, TEST_BATCH_WORK_ITEM_COUNT);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_090: [ threadpool_schedule_work_batch shall check the state of threadpool only once for all the work items. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_092: [ Otherwise threadpool_schedule_work_batch shall allocate in a single allocation a batch holding a context for each of the work items, where the work_function and work_function_context of the work item shall be saved. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_119: [ threadpool_schedule_work_batch shall submit the work items with WORKER_POOL_LINUX_PRIORITY_NORMAL. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_093: [ threadpool_schedule_work_batch shall add work_item_count to the count of pending work items. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_094: [ threadpool_schedule_work_batch shall submit all the work items to the worker pool at once by calling worker_pool_linux_submit_batch with the list of the worker pool work items of the batch. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_101: [ threadpool_schedule_work_batch shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, TEST_BATCH_WORK_ITEM_COUNT));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, TEST_BATCH_WORK_ITEM_COUNT));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit_batch(test_worker_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work_batch(threadpool, test_batch_work_items, TEST_BATCH_WORK_ITEM_COUNT);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    WORKER_POOL_LINUX_WORK_ITEM* work_item = captured_work_item;
+    for (uint32_t i = 0; i < TEST_BATCH_WORK_ITEM_COUNT; i++)
+    {
+        ASSERT_IS_NOT_NULL(work_item);
+        ASSERT_IS_NOT_NULL(work_item->work_function);
+        ASSERT_ARE_EQUAL(void_ptr, work_item, work_item->work_function_context);
+        ASSERT_ARE_EQUAL(WORKER_POOL_LINUX_PRIORITY, WORKER_POOL_LINUX_PRIORITY_NORMAL, work_item->priority);
+        work_item = work_item->next;
+    }
+    ASSERT_IS_NULL(work_item);
+
+    ///cleanup
+    test_run_work_items(captured_work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_095: [ If any error occurs, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_schedule_work_batch_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, TEST_BATCH_WORK_ITEM_COUNT))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, TEST_BATCH_WORK_ITEM_COUNT))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit_batch(test_worker_pool, IGNORED_ARG));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            int result = threadpool_schedule_work_batch(threadpool, test_batch_work_items, TEST_BATCH_WORK_ITEM_COUNT);
+
+            ///assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+        }
+    }
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_095: [ If any error occurs, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_worker_pool_linux_submit_batch_fails_threadpool_schedule_work_batch_frees_the_batch)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, TEST_BATCH_WORK_ITEM_COUNT));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, TEST_BATCH_WORK_ITEM_COUNT));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit_batch(test_worker_pool, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, -TEST_BATCH_WORK_ITEM_COUNT));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work_batch(threadpool, test_batch_work_items, TEST_BATCH_WORK_ITEM_COUNT);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* on_work_batch_item_callback */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_096: [ If context is NULL, on_work_batch_item_callback shall return. ]*/
+TEST_FUNCTION(on_work_batch_item_callback_with_NULL_context_returns)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    WORKER_POOL_LINUX_WORK_ITEM* work_items = test_schedule_work_batch(threadpool);
+
+    ///act
+    work_items->work_function(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    test_run_work_items(work_items);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_097: [ Otherwise context shall be used as one of the work items of the batch created in threadpool_schedule_work_batch. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_098: [ on_work_batch_item_callback shall call the work_function of the work item, passing to it the work_function_context of the work item. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_099: [ on_work_batch_item_callback shall decrement the count of work items of the batch not executed yet and free the batch if it reached 0. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_100: [ on_work_batch_item_callback shall decrement the count of pending work items of the threadpool and wake threadpool_close if it reached 0. ]*/
+TEST_FUNCTION(on_work_batch_item_callback_calls_the_work_function_and_keeps_the_batch_while_work_items_are_pending)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    WORKER_POOL_LINUX_WORK_ITEM* work_items = test_schedule_work_batch(threadpool);
+    WORKER_POOL_LINUX_WORK_ITEM* second_work_item = work_items->next;
+
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4246));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+
+    ///act
+    second_work_item->work_function(second_work_item->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    work_items->work_function(work_items->work_function_context);
+    second_work_item->next->work_function(second_work_item->next->work_function_context);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_099: [ on_work_batch_item_callback shall decrement the count of work items of the batch not executed yet and free the batch if it reached 0. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_100: [ on_work_batch_item_callback shall decrement the count of pending work items of the threadpool and wake threadpool_close if it reached 0. ]*/
+TEST_FUNCTION(on_work_batch_item_callback_for_the_last_work_item_frees_the_batch)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    WORKER_POOL_LINUX_WORK_ITEM* work_items = test_schedule_work_batch(threadpool);
+    WORKER_POOL_LINUX_WORK_ITEM* last_work_item = work_items->next->next;
+    work_items->work_function(work_items->work_function_context);
+    work_items->next->work_function(work_items->next->work_function_context);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4247));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    last_work_item->work_function(last_work_item->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_create_work_item */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_061: [ If threadpool is NULL, threadpool_create_work_item shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_create_work_item_with_NULL_threadpool_fails)
+{
+    ///arrange
+
+    ///act
+    THREADPOOL_WORK_ITEM_HANDLE work_item = threadpool_create_work_item(NULL, test_work_function, (void*)0x4245);
+
+    ///assert
+    ASSERT_IS_NULL(work_item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_062: [ If work_function is NULL, threadpool_create_work_item shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_create_work_item_with_NULL_work_function_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    ///act
+    THREADPOOL_WORK_ITEM_HANDLE work_item = threadpool_create_work_item(threadpool, NULL, (void*)0x4245);
+
+    ///assert
+    ASSERT_IS_NULL(work_item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_064: [ If threadpool is not OPEN, threadpool_create_work_item shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_create_work_item_when_not_open_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    THREADPOOL_WORK_ITEM_HANDLE work_item = threadpool_create_work_item(threadpool, test_work_function, (void*)0x4245);
+
+    ///assert
+    ASSERT_IS_NULL(work_item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_065: [ threadpool_create_work_item shall allocate a work item where work_function and work_function_context shall be saved, together with the worker pool work item that is submitted when the work item is scheduled. ]*/
+TEST_FUNCTION(threadpool_create_work_item_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    THREADPOOL_WORK_ITEM_HANDLE work_item = threadpool_create_work_item(threadpool, test_work_function, (void*)0x4245);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(work_item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_063: [ work_function_context shall be allowed to be NULL. ]*/
+TEST_FUNCTION(threadpool_create_work_item_with_NULL_work_function_context_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    THREADPOOL_WORK_ITEM_HANDLE work_item = threadpool_create_work_item(threadpool, test_work_function, NULL);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(work_item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_066: [ If any error occurs, threadpool_create_work_item shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_threadpool_create_work_item_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    THREADPOOL_WORK_ITEM_HANDLE work_item = threadpool_create_work_item(threadpool, test_work_function, (void*)0x4245);
+
+    ///assert
+    ASSERT_IS_NULL(work_item);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_schedule_work_item */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_067: [ If threadpool is NULL, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_item_with_NULL_threadpool_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+
+    ///act
+    int result = threadpool_schedule_work_item(NULL, work_item);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_068: [ If work_item is NULL, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_item_with_NULL_work_item_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    ///act
+    int result = threadpool_schedule_work_item(threadpool, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_069: [ If threadpool is not OPEN, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_item_when_not_open_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+    threadpool_close(threadpool);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work_item(threadpool, work_item);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_070: [ threadpool_schedule_work_item shall increment the count of pending work items of the threadpool. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_071: [ threadpool_schedule_work_item shall increment the count of pending schedules of work_item. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_073: [ Otherwise threadpool_schedule_work_item shall submit the worker pool work item embedded in work_item by calling worker_pool_linux_submit. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_085: [ threadpool_schedule_work_item shall succeed and return 0. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_120: [ threadpool_create_work_item shall set the priority of the worker pool work item to WORKER_POOL_LINUX_PRIORITY_NORMAL. ]*/
+TEST_FUNCTION(threadpool_schedule_work_item_submits_without_allocating)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work_item(threadpool, work_item);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_work_item);
+    ASSERT_ARE_EQUAL(void_ptr, work_item, captured_work_item->work_function_context);
+    ASSERT_ARE_EQUAL(WORKER_POOL_LINUX_PRIORITY, WORKER_POOL_LINUX_PRIORITY_NORMAL, captured_work_item->priority);
+
+    ///cleanup
+    captured_work_item->work_function(captured_work_item->work_function_context);
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_072: [ If the work item was already queued or executing, threadpool_schedule_work_item shall succeed and return 0 without submitting it again, the work item is executed once more after the executions already pending. ]*/
+TEST_FUNCTION(threadpool_schedule_work_item_when_already_queued_does_not_submit_again)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+    WORKER_POOL_LINUX_WORK_ITEM* worker_pool_work_item = test_schedule_work_item(threadpool, work_item);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work_item(threadpool, work_item);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    /*the first execution submits the work item again for the second schedule*/
+    worker_pool_work_item->work_function(worker_pool_work_item->work_function_context);
+    worker_pool_work_item->work_function(worker_pool_work_item->work_function_context);
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_072: [ If the work item was already queued or executing, threadpool_schedule_work_item shall succeed and return 0 without submitting it again, the work item is executed once more after the executions already pending. ]*/
+TEST_FUNCTION(threadpool_schedule_work_item_after_the_work_item_executed_submits_again)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+    WORKER_POOL_LINUX_WORK_ITEM* worker_pool_work_item = test_schedule_work_item(threadpool, work_item);
+    worker_pool_work_item->work_function(worker_pool_work_item->work_function_context);
+    captured_work_item = NULL;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work_item(threadpool, work_item);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, worker_pool_work_item, captured_work_item);
+
+    ///cleanup
+    captured_work_item->work_function(captured_work_item->work_function_context);
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_074: [ If worker_pool_linux_submit fails, threadpool_schedule_work_item shall decrement the counts it incremented, fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_worker_pool_linux_submit_fails_threadpool_schedule_work_item_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work_item(threadpool, work_item);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_075: [ If the work item was scheduled by other threads while it was being submitted, threadpool_schedule_work_item shall execute these schedules by calling on_work_item_callback, since they relied on this submission. ]*/
+TEST_FUNCTION(when_worker_pool_linux_submit_fails_threadpool_schedule_work_item_runs_the_schedules_that_came_in_meanwhile)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+    threadpool_to_schedule_on_submit = threadpool;
+    work_item_to_schedule_on_submit = work_item;
+    REGISTER_GLOBAL_MOCK_HOOK(worker_pool_linux_submit, hook_worker_pool_linux_submit_schedules_again_and_fails);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG));
+    // the schedule from the "other thread"
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    // the failed submit is undone, the other schedule is executed
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work_item(threadpool, work_item);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    REGISTER_GLOBAL_MOCK_HOOK(worker_pool_linux_submit, hook_worker_pool_linux_submit);
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_destroy_work_item */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_081: [ If threadpool is NULL, threadpool_destroy_work_item shall return. ]*/
+TEST_FUNCTION(threadpool_destroy_work_item_with_NULL_threadpool_returns)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+
+    ///act
+    threadpool_destroy_work_item(NULL, work_item);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_082: [ If work_item is NULL, threadpool_destroy_work_item shall return. ]*/
+TEST_FUNCTION(threadpool_destroy_work_item_with_NULL_work_item_returns)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    ///act
+    threadpool_destroy_work_item(threadpool, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_083: [ threadpool_destroy_work_item shall wait for all the scheduled executions of work_item to complete. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_084: [ threadpool_destroy_work_item shall free the work item. ]*/
+TEST_FUNCTION(threadpool_destroy_work_item_frees_the_work_item)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(free(work_item));
+
+    ///act
+    threadpool_destroy_work_item(threadpool, work_item);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_083: [ threadpool_destroy_work_item shall wait for all the scheduled executions of work_item to complete. ]*/
+TEST_FUNCTION(threadpool_destroy_work_item_waits_for_the_scheduled_executions)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+    work_item_to_run_on_wait = test_schedule_work_item(threadpool, work_item);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 1, UINT32_MAX));
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(free(work_item));
+
+    ///act
+    threadpool_destroy_work_item(threadpool, work_item);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* on_work_item_callback */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_076: [ If context is NULL, on_work_item_callback shall return. ]*/
+TEST_FUNCTION(on_work_item_callback_with_NULL_context_returns)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+    WORKER_POOL_LINUX_WORK_ITEM* worker_pool_work_item = test_schedule_work_item(threadpool, work_item);
+
+    ///act
+    worker_pool_work_item->work_function(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_work_item->work_function(worker_pool_work_item->work_function_context);
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_077: [ Otherwise context shall be used as the work item created in threadpool_create_work_item. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_078: [ on_work_item_callback shall call the work_function passed to threadpool_create_work_item, passing to it the work_function_context argument passed to threadpool_create_work_item, once for each schedule of the work item. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_079: [ After each call, on_work_item_callback shall decrement the count of pending schedules of the work item and wake threadpool_destroy_work_item if it reached 0. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_080: [ After each call, on_work_item_callback shall decrement the count of pending work items of the threadpool and wake threadpool_close if it reached 0. ]*/
+TEST_FUNCTION(on_work_item_callback_calls_the_work_function_and_does_not_free_the_work_item)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+    WORKER_POOL_LINUX_WORK_ITEM* worker_pool_work_item = test_schedule_work_item(threadpool, work_item);
+
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    worker_pool_work_item->work_function(worker_pool_work_item->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_078: [ on_work_item_callback shall call the work_function passed to threadpool_create_work_item, passing to it the work_function_context argument passed to threadpool_create_work_item, once for each schedule of the work item. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_079: [ After each call, on_work_item_callback shall decrement the count of pending schedules of the work item and wake threadpool_destroy_work_item if it reached 0. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_080: [ After each call, on_work_item_callback shall decrement the count of pending work items of the threadpool and wake threadpool_close if it reached 0. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_175: [ If the work item has schedules left, on_work_item_callback shall submit the worker pool work item again by calling worker_pool_linux_submit and return, so that the work queued while it executed runs before its next call. ]*/
+TEST_FUNCTION(on_work_item_callback_submits_the_work_item_again_for_the_schedules_left)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+    WORKER_POOL_LINUX_WORK_ITEM* worker_pool_work_item = test_schedule_work_item(threadpool, work_item);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_item(threadpool, work_item));
+    captured_work_item = NULL;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, worker_pool_work_item));
+
+    ///act
+    worker_pool_work_item->work_function(worker_pool_work_item->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, worker_pool_work_item, captured_work_item);
+
+    ///cleanup
+    worker_pool_work_item->work_function(worker_pool_work_item->work_function_context);
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_078: [ on_work_item_callback shall call the work_function passed to threadpool_create_work_item, passing to it the work_function_context argument passed to threadpool_create_work_item, once for each schedule of the work item. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_175: [ If the work item has schedules left, on_work_item_callback shall submit the worker pool work item again by calling worker_pool_linux_submit and return, so that the work queued while it executed runs before its next call. ]*/
+TEST_FUNCTION(on_work_item_callback_submitted_again_executes_the_schedule_left)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+    WORKER_POOL_LINUX_WORK_ITEM* worker_pool_work_item = test_schedule_work_item(threadpool, work_item);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_item(threadpool, work_item));
+    worker_pool_work_item->work_function(worker_pool_work_item->work_function_context);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    worker_pool_work_item->work_function(worker_pool_work_item->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_176: [ If worker_pool_linux_submit fails, on_work_item_callback shall execute the schedules left on the current thread. ]*/
+TEST_FUNCTION(when_worker_pool_linux_submit_fails_on_work_item_callback_executes_the_schedules_left_on_the_current_thread)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+    WORKER_POOL_LINUX_WORK_ITEM* worker_pool_work_item = test_schedule_work_item(threadpool, work_item);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_item(threadpool, work_item));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, worker_pool_work_item))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    worker_pool_work_item->work_function(worker_pool_work_item->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_start */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_041: [ If threadpool is NULL, threadpool_timer_start shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_NULL_threadpool_fails)
+{
+    ///arrange
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    ///act
+    int result = threadpool_timer_start(NULL, 42, 2000, test_work_function, (void*)0x4245, &timer_instance);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(timer_instance);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_042: [ If work_function is NULL, threadpool_timer_start shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_NULL_work_function_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    ///act
+    int result = threadpool_timer_start(threadpool, 42, 2000, NULL, (void*)0x4245, &timer_instance);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(timer_instance);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_043: [ If timer_handle is NULL, threadpool_timer_start shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_NULL_timer_handle_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    ///act
+    int result = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4245, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_045: [ If threadpool is not OPEN, threadpool_timer_start shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_when_not_open_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4245, &timer_instance);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(timer_instance);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_046: [ threadpool_timer_start shall obtain the timer wheel of the execution engine by calling execution_engine_linux_get_timer_wheel. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_047: [ threadpool_timer_start shall allocate a context for the timer. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_048: [ threadpool_timer_start shall initialize the timer by calling timer_wheel_linux_timer_init with WORKER_POOL_LINUX_PRIORITY_NORMAL, work_function and work_function_context. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_049: [ threadpool_timer_start shall start the timer by calling timer_wheel_linux_timer_start with start_delay_ms, timer_period_ms and the tolerance of the timer, which is 0 unless the timer is started by threadpool_timer_start_with_tolerance. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_050: [ threadpool_timer_start shall return the allocated handle in timer_handle and succeed, returning 0. ]*/
+TEST_FUNCTION(threadpool_timer_start_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_timer_wheel(test_execution_engine));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_init(IGNORED_ARG, WORKER_POOL_LINUX_PRIORITY_NORMAL, test_work_function, (void*)0x4245));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 42, 2000, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4245, &timer_instance);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(timer_instance);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_044: [ work_function_context shall be allowed to be NULL. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_NULL_work_function_context_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_timer_wheel(test_execution_engine));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_init(IGNORED_ARG, WORKER_POOL_LINUX_PRIORITY_NORMAL, test_work_function, NULL));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 42, 0, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_timer_start(threadpool, 42, 0, test_work_function, NULL, &timer_instance);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(timer_instance);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_051: [ If any error occurs, threadpool_timer_start shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_timer_start_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_timer_wheel(test_execution_engine));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_init(IGNORED_ARG, WORKER_POOL_LINUX_PRIORITY_NORMAL, test_work_function, (void*)0x4245));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 42, 2000, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG))
+        .CallCannotFail();
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            int result = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4245, &timer_instance);
+
+            ///assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+            ASSERT_IS_NULL(timer_instance, "On failed call %zu", i);
+        }
+    }
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_start_with_priority */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_112: [ If threadpool is NULL, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_priority_with_NULL_threadpool_fails)
+{
+    ///arrange
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    ///act
+    int result = threadpool_timer_start_with_priority(NULL, THREADPOOL_PRIORITY_HIGH, 42, 2000, test_work_function, (void*)0x4245, &timer_instance);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(timer_instance);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_113: [ If priority is not THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL or THREADPOOL_PRIORITY_LOW, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_priority_with_an_invalid_priority_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    ///act
+    int result = threadpool_timer_start_with_priority(threadpool, (THREADPOOL_PRIORITY)0x42, 42, 2000, test_work_function, (void*)0x4245, &timer_instance);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(timer_instance);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_114: [ If work_function is NULL, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_priority_with_NULL_work_function_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    ///act
+    int result = threadpool_timer_start_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, 42, 2000, NULL, (void*)0x4245, &timer_instance);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(timer_instance);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_115: [ If timer_handle is NULL, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_priority_with_NULL_timer_handle_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    ///act
+    int result = threadpool_timer_start_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, 42, 2000, test_work_function, (void*)0x4245, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_117: [ Otherwise threadpool_timer_start_with_priority shall start the timer like threadpool_timer_start, initializing it with the WORKER_POOL_LINUX_PRIORITY matching priority. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_priority_initializes_the_timer_with_the_matching_worker_pool_priority)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    const struct
+    {
+        THREADPOOL_PRIORITY priority;
+        WORKER_POOL_LINUX_PRIORITY worker_pool_priority;
+    } priorities[] =
+    {
+        { THREADPOOL_PRIORITY_HIGH, WORKER_POOL_LINUX_PRIORITY_HIGH },
+        { THREADPOOL_PRIORITY_NORMAL, WORKER_POOL_LINUX_PRIORITY_NORMAL },
+        { THREADPOOL_PRIORITY_LOW, WORKER_POOL_LINUX_PRIORITY_LOW }
+    };
+
+    for (size_t i = 0; i < MU_COUNT_ARRAY_ITEMS(priorities); i++)
+    {
+        TIMER_INSTANCE_HANDLE timer_instance = NULL;
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(execution_engine_linux_get_timer_wheel(test_execution_engine));
+        STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(timer_wheel_linux_timer_init(IGNORED_ARG, priorities[i].worker_pool_priority, test_work_function, (void*)0x4245));
+        STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 42, 2000, 0));
+        STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+        ///act
+        int result = threadpool_timer_start_with_priority(threadpool, priorities[i].priority, 42, 2000, test_work_function, (void*)0x4245, &timer_instance);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_IS_NOT_NULL(timer_instance);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+        ///cleanup
+        threadpool_timer_destroy(timer_instance);
+    }
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_116: [ work_function_context shall be allowed to be NULL. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_priority_with_NULL_work_function_context_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_timer_wheel(test_execution_engine));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_init(IGNORED_ARG, WORKER_POOL_LINUX_PRIORITY_HIGH, test_work_function, NULL));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 42, 0, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_timer_start_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, 42, 0, test_work_function, NULL, &timer_instance);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(timer_instance);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_118: [ If any error occurs, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_timer_start_with_priority_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_timer_wheel(test_execution_engine));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_init(IGNORED_ARG, WORKER_POOL_LINUX_PRIORITY_HIGH, test_work_function, (void*)0x4245));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 42, 2000, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG))
+        .CallCannotFail();
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            int result = threadpool_timer_start_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, 42, 2000, test_work_function, (void*)0x4245, &timer_instance);
+
+            ///assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+            ASSERT_IS_NULL(timer_instance, "On failed call %zu", i);
+        }
+    }
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_start_with_tolerance */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_166: [ If threadpool is NULL, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_tolerance_with_NULL_threadpool_fails)
+{
+    ///arrange
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    ///act
+    int result = threadpool_timer_start_with_tolerance(NULL, 42, 2000, 50, test_work_function, (void*)0x4245, &timer_instance);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(timer_instance);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_167: [ If work_function is NULL, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_tolerance_with_NULL_work_function_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    ///act
+    int result = threadpool_timer_start_with_tolerance(threadpool, 42, 2000, 50, NULL, (void*)0x4245, &timer_instance);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_IS_NULL(timer_instance);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_168: [ If timer_handle is NULL, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_tolerance_with_NULL_timer_handle_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    ///act
+    int result = threadpool_timer_start_with_tolerance(threadpool, 42, 2000, 50, test_work_function, (void*)0x4245, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_170: [ Otherwise threadpool_timer_start_with_tolerance shall start the timer like threadpool_timer_start, passing tolerance_ms to timer_wheel_linux_timer_start. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_tolerance_starts_the_timer_with_the_tolerance)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_timer_wheel(test_execution_engine));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_init(IGNORED_ARG, WORKER_POOL_LINUX_PRIORITY_NORMAL, test_work_function, (void*)0x4245));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 42, 2000, 50));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_timer_start_with_tolerance(threadpool, 42, 2000, 50, test_work_function, (void*)0x4245, &timer_instance);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(timer_instance);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_169: [ work_function_context shall be allowed to be NULL. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_tolerance_with_NULL_work_function_context_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_timer_wheel(test_execution_engine));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_init(IGNORED_ARG, WORKER_POOL_LINUX_PRIORITY_NORMAL, test_work_function, NULL));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 42, 0, 50));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_timer_start_with_tolerance(threadpool, 42, 0, 50, test_work_function, NULL, &timer_instance);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(timer_instance);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_171: [ If any error occurs, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_timer_start_with_tolerance_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_timer_wheel(test_execution_engine));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_init(IGNORED_ARG, WORKER_POOL_LINUX_PRIORITY_NORMAL, test_work_function, (void*)0x4245));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 42, 2000, 50));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG))
+        .CallCannotFail();
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            int result = threadpool_timer_start_with_tolerance(threadpool, 42, 2000, 50, test_work_function, (void*)0x4245, &timer_instance);
+
+            ///assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+            ASSERT_IS_NULL(timer_instance, "On failed call %zu", i);
+        }
+    }
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_restart */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_052: [ If timer is NULL, threadpool_timer_restart shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_restart_with_NULL_timer_fails)
+{
+    ///arrange
+
+    ///act
+    int result = threadpool_timer_restart(NULL, 42, 2000);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_053: [ threadpool_timer_restart shall restart the timer by calling timer_wheel_linux_timer_start with start_delay_ms, timer_period_ms and the tolerance of the timer. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_054: [ threadpool_timer_restart shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_timer_restart_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = test_start_timer(threadpool);
+
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 43, 1000, 0));
+
+    ///act
+    int result = threadpool_timer_restart(timer_instance, 43, 1000);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_055: [ If timer_wheel_linux_timer_start fails, threadpool_timer_restart shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_timer_wheel_linux_timer_start_fails_threadpool_timer_restart_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = test_start_timer(threadpool);
+
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 43, 1000, 0))
+        .SetReturn(MU_FAILURE);
+
+    ///act
+    int result = threadpool_timer_restart(timer_instance, 43, 1000);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_053: [ threadpool_timer_restart shall restart the timer by calling timer_wheel_linux_timer_start with start_delay_ms, timer_period_ms and the tolerance of the timer. ]*/
+TEST_FUNCTION(threadpool_timer_restart_keeps_the_tolerance_of_the_timer)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start_with_tolerance(threadpool, 42, 2000, 50, test_work_function, (void*)0x4245, &timer_instance));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 43, 1000, 50));
+
+    ///act
+    int result = threadpool_timer_restart(timer_instance, 43, 1000);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_restart_with_tolerance */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_172: [ If timer is NULL, threadpool_timer_restart_with_tolerance shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_restart_with_tolerance_with_NULL_timer_fails)
+{
+    ///arrange
+
+    ///act
+    int result = threadpool_timer_restart_with_tolerance(NULL, 42, 2000, 50);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_173: [ Otherwise threadpool_timer_restart_with_tolerance shall save tolerance_ms as the tolerance of the timer and restart the timer like threadpool_timer_restart. ]*/
+TEST_FUNCTION(threadpool_timer_restart_with_tolerance_restarts_the_timer_with_the_new_tolerance)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = test_start_timer(threadpool);
+
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 43, 1000, 50));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 44, 1000, 50));
+
+    ///act
+    int result = threadpool_timer_restart_with_tolerance(timer_instance, 43, 1000, 50);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    /*a later restart keeps the new tolerance*/
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_restart(timer_instance, 44, 1000));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_174: [ If any error occurs, threadpool_timer_restart_with_tolerance shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_timer_wheel_linux_timer_start_fails_threadpool_timer_restart_with_tolerance_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = test_start_timer(threadpool);
+
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 43, 1000, 50))
+        .SetReturn(MU_FAILURE);
+
+    ///act
+    int result = threadpool_timer_restart_with_tolerance(timer_instance, 43, 1000, 50);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_cancel */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_056: [ If timer is NULL, threadpool_timer_cancel shall return. ]*/
+TEST_FUNCTION(threadpool_timer_cancel_with_NULL_timer_returns)
+{
+    ///arrange
+
+    ///act
+    threadpool_timer_cancel(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_057: [ threadpool_timer_cancel shall stop the timer and wait for its callback to complete by calling timer_wheel_linux_timer_cancel. ]*/
+TEST_FUNCTION(threadpool_timer_cancel_cancels_the_timer)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = test_start_timer(threadpool);
+
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_cancel(test_timer_wheel, IGNORED_ARG));
+
+    ///act
+    threadpool_timer_cancel(timer_instance);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_destroy */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_058: [ If timer is NULL, threadpool_timer_destroy shall return. ]*/
+TEST_FUNCTION(threadpool_timer_destroy_with_NULL_timer_returns)
+{
+    ///arrange
+
+    ///act
+    threadpool_timer_destroy(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_059: [ threadpool_timer_destroy shall stop the timer and wait for its callback to complete by calling timer_wheel_linux_timer_cancel. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_060: [ threadpool_timer_destroy shall free all resources in timer. ]*/
+TEST_FUNCTION(threadpool_timer_destroy_cancels_and_frees_the_timer)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = test_start_timer(threadpool);
+
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_cancel(test_timer_wheel, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(timer_instance));
+
+    ///act
+    threadpool_timer_destroy(timer_instance);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_get_queue_wait_statistics */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_121: [ If threadpool is NULL, threadpool_get_queue_wait_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_get_queue_wait_statistics_with_NULL_threadpool_fails)
+{
+    ///arrange
+    THREADPOOL_QUEUE_WAIT_STATISTICS statistics;
+
+    ///act
+    int result = threadpool_get_queue_wait_statistics(NULL, THREADPOOL_PRIORITY_HIGH, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_122: [ If priority is not THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL or THREADPOOL_PRIORITY_LOW, threadpool_get_queue_wait_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_get_queue_wait_statistics_with_an_invalid_priority_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+    THREADPOOL_QUEUE_WAIT_STATISTICS statistics;
+
+    ///act
+    int result = threadpool_get_queue_wait_statistics(threadpool, (THREADPOOL_PRIORITY)0x42, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_123: [ If statistics is NULL, threadpool_get_queue_wait_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_get_queue_wait_statistics_with_NULL_statistics_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+
+    ///act
+    int result = threadpool_get_queue_wait_statistics(threadpool, THREADPOOL_PRIORITY_HIGH, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_124: [ Otherwise threadpool_get_queue_wait_statistics shall fill statistics with the count of work items of priority that started executing and the total and maximum time in microseconds they waited, and return 0. ]*/
+TEST_FUNCTION(threadpool_get_queue_wait_statistics_of_a_new_threadpool_returns_0_for_all_the_priorities)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+    THREADPOOL_PRIORITY priorities[] = { THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL, THREADPOOL_PRIORITY_LOW };
+
+    for (size_t i = 0; i < MU_COUNT_ARRAY_ITEMS(priorities); i++)
+    {
+        THREADPOOL_QUEUE_WAIT_STATISTICS statistics = { 42, 42, 42 };
+        umock_c_reset_all_calls();
+
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+
+        ///act
+        int result = threadpool_get_queue_wait_statistics(threadpool, priorities[i], &statistics);
+
+        ///assert
+        ASSERT_ARE_EQUAL(int, 0, result);
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        ASSERT_ARE_EQUAL(uint64_t, 0, statistics.work_item_count);
+        ASSERT_ARE_EQUAL(uint64_t, 0, statistics.total_queue_wait_us);
+        ASSERT_ARE_EQUAL(uint64_t, 0, statistics.max_queue_wait_us);
+    }
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_enable_statistics */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_131: [ If threadpool is NULL, threadpool_enable_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_enable_statistics_with_NULL_threadpool_fails)
+{
+    ///arrange
+
+    ///act
+    int result = threadpool_enable_statistics(NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_133: [ If threadpool is not CLOSED, threadpool_enable_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_enable_statistics_when_open_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    ///act
+    int result = threadpool_enable_statistics(threadpool);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_165: [ threadpool_create shall create the threadpool with the statistics disabled. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_132: [ threadpool_enable_statistics shall switch the state from CLOSED to OPENING, so that the threadpool cannot be opened while the statistics are enabled. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_135: [ Otherwise threadpool_enable_statistics shall create the statistics recorder by calling threadpool_statistics_recorder_create. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_136: [ threadpool_enable_statistics shall set the state back to CLOSED. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_137: [ threadpool_enable_statistics shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_enable_statistics_creates_the_statistics_recorder)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_create());
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_enable_statistics(threadpool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, threadpool_open_async(threadpool, test_on_open_complete, (void*)0x4242));
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_134: [ If the statistics are already enabled, threadpool_enable_statistics shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_enable_statistics_when_already_enabled_succeeds)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+    ASSERT_ARE_EQUAL(int, 0, threadpool_enable_statistics(threadpool));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_enable_statistics(threadpool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_138: [ If any error occurs, threadpool_enable_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_threadpool_statistics_recorder_create_fails_threadpool_enable_statistics_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_create())
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_enable_statistics(threadpool);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, threadpool_open_async(threadpool, test_on_open_complete, (void*)0x4242));
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_164: [ If the statistics are enabled, threadpool_destroy shall destroy the statistics recorder by calling threadpool_statistics_recorder_destroy. ]*/
+TEST_FUNCTION(threadpool_destroy_destroys_the_statistics_recorder)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_threadpool();
+    ASSERT_ARE_EQUAL(int, 0, threadpool_enable_statistics(threadpool));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_destroy(test_statistics_recorder));
+    STRICT_EXPECTED_CALL(free(threadpool));
+
+    ///act
+    threadpool_destroy(threadpool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_103: [ If the statistics are enabled, threadpool_schedule_work shall save in the context the time the work item is scheduled, obtained by calling timer_global_get_elapsed_us. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_142: [ If the statistics are enabled, threadpool_schedule_work shall count the work item as queued by calling threadpool_statistics_recorder_on_queued. ]*/
+TEST_FUNCTION(threadpool_schedule_work_with_statistics_counts_the_work_item_as_queued)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_queued(test_statistics_recorder, 1));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work(threadpool, test_work_function, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_work_item->work_function(captured_work_item->work_function_context);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_143: [ If the statistics are enabled, on_work_callback shall call threadpool_statistics_recorder_on_started with the time the work item was scheduled before calling work_function and threadpool_statistics_recorder_on_completed after it. ]*/
+TEST_FUNCTION(on_work_callback_with_statistics_records_the_start_and_the_completion_of_the_work_item)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(100);
+    WORKER_POOL_LINUX_WORK_ITEM* work_item = test_schedule_work(threadpool, (void*)0x4245);
+
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_started(test_statistics_recorder, 100))
+        .SetReturn(150);
+    STRICT_EXPECTED_CALL(interlocked_increment_64(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 50));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 50, 0));
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_completed(test_statistics_recorder, 150));
+    STRICT_EXPECTED_CALL(free(work_item));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    work_item->work_function(work_item->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_144: [ If the statistics are enabled, threadpool_schedule_work_batch shall save in the batch the time it is scheduled, obtained by calling timer_global_get_elapsed_us. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_145: [ If the statistics are enabled, threadpool_schedule_work_batch shall count the work items as queued by calling threadpool_statistics_recorder_on_queued with work_item_count. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_with_statistics_counts_the_work_items_as_queued)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, TEST_BATCH_WORK_ITEM_COUNT));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, TEST_BATCH_WORK_ITEM_COUNT));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit_batch(test_worker_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_queued(test_statistics_recorder, TEST_BATCH_WORK_ITEM_COUNT));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work_batch(threadpool, test_batch_work_items, TEST_BATCH_WORK_ITEM_COUNT);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    test_run_work_items(captured_work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_146: [ If the statistics are enabled, on_work_batch_item_callback shall call threadpool_statistics_recorder_on_started with the time the batch was scheduled before calling work_function and threadpool_statistics_recorder_on_completed after it. ]*/
+TEST_FUNCTION(on_work_batch_item_callback_with_statistics_records_the_start_and_the_completion_of_the_work_item)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(100);
+    WORKER_POOL_LINUX_WORK_ITEM* work_items = test_schedule_work_batch(threadpool);
+    WORKER_POOL_LINUX_WORK_ITEM* second_work_item = work_items->next;
+
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_started(test_statistics_recorder, 100))
+        .SetReturn(150);
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4246));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_completed(test_statistics_recorder, 150));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+
+    ///act
+    second_work_item->work_function(second_work_item->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    work_items->work_function(work_items->work_function_context);
+    second_work_item->next->work_function(second_work_item->next->work_function_context);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_147: [ If the statistics are enabled, threadpool_schedule_work_item shall save in work_item the time it is submitted, obtained by calling timer_global_get_elapsed_us. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_148: [ If the statistics are enabled, threadpool_schedule_work_item shall count each successful schedule as queued by calling threadpool_statistics_recorder_on_queued. ]*/
+TEST_FUNCTION(threadpool_schedule_work_item_with_statistics_counts_the_work_item_as_queued)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_queued(test_statistics_recorder, 1));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work_item(threadpool, work_item);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_work_item->work_function(captured_work_item->work_function_context);
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_148: [ If the statistics are enabled, threadpool_schedule_work_item shall count each successful schedule as queued by calling threadpool_statistics_recorder_on_queued. ]*/
+TEST_FUNCTION(threadpool_schedule_work_item_with_statistics_when_already_queued_counts_the_schedule_as_queued)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+    WORKER_POOL_LINUX_WORK_ITEM* worker_pool_work_item = test_schedule_work_item(threadpool, work_item);
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_queued(test_statistics_recorder, 1));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_schedule_work_item(threadpool, work_item);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    /*the first execution submits the work item again for the second schedule*/
+    worker_pool_work_item->work_function(worker_pool_work_item->work_function_context);
+    worker_pool_work_item->work_function(worker_pool_work_item->work_function_context);
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_149: [ If the statistics are enabled, on_work_item_callback shall call threadpool_statistics_recorder_on_started before each call of work_function and threadpool_statistics_recorder_on_completed after it, with the time the work item was submitted for the first call and the time the previous call completed for the others. ]*/
+TEST_FUNCTION(on_work_item_callback_with_statistics_counts_the_schedules_made_while_executing_as_queued_since_the_previous_call_completed)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, (void*)0x4245);
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(100);
+    WORKER_POOL_LINUX_WORK_ITEM* worker_pool_work_item = test_schedule_work_item(threadpool, work_item);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_item(threadpool, work_item));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_started(test_statistics_recorder, 100))
+        .SetReturn(150);
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_completed(test_statistics_recorder, 150))
+        .SetReturn(200);
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, worker_pool_work_item));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_started(test_statistics_recorder, 200))
+        .SetReturn(210);
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_completed(test_statistics_recorder, 210));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    worker_pool_work_item->work_function(worker_pool_work_item->work_function_context);
+    /*the worker pool executes the work item submitted again*/
+    worker_pool_work_item->work_function(worker_pool_work_item->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_154: [ If the statistics are enabled, threadpool_timer_start shall initialize the lateness of the timer by calling threadpool_timer_lateness_init and initialize the timer with on_timer_callback and the timer instance instead of work_function and work_function_context. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_155: [ If the statistics are enabled, threadpool_timer_start shall compute when the timer is due by calling threadpool_timer_lateness_set_due_time with start_delay_ms and timer_period_ms before starting it. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_statistics_records_the_lateness_of_the_timer)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+    TIMER_WHEEL_LINUX_ON_TIMER_EXPIRED captured_on_timer_expired = NULL;
+    void* captured_on_timer_expired_context = NULL;
+
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(execution_engine_linux_get_timer_wheel(test_execution_engine));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(threadpool_timer_lateness_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_init(IGNORED_ARG, WORKER_POOL_LINUX_PRIORITY_NORMAL, IGNORED_ARG, IGNORED_ARG))
+        .CaptureArgumentValue_on_timer_expired(&captured_on_timer_expired)
+        .CaptureArgumentValue_on_timer_expired_context(&captured_on_timer_expired_context);
+    STRICT_EXPECTED_CALL(threadpool_timer_lateness_set_due_time(IGNORED_ARG, 42, 2000));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 42, 2000, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4245, &timer_instance);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_on_timer_expired);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, (void*)test_work_function, (void*)captured_on_timer_expired);
+    ASSERT_ARE_EQUAL(void_ptr, timer_instance, captured_on_timer_expired_context);
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_157: [ If context is NULL, on_timer_callback shall return. ]*/
+TEST_FUNCTION(on_timer_callback_with_NULL_context_returns)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+    TIMER_WHEEL_LINUX_ON_TIMER_EXPIRED captured_on_timer_expired = NULL;
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_init(IGNORED_ARG, WORKER_POOL_LINUX_PRIORITY_NORMAL, IGNORED_ARG, IGNORED_ARG))
+        .CaptureArgumentValue_on_timer_expired(&captured_on_timer_expired);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4245, &timer_instance));
+    umock_c_reset_all_calls();
+
+    ///act
+    captured_on_timer_expired(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_158: [ on_timer_callback shall record the lateness of the timer by calling threadpool_timer_lateness_on_fired and then call the work_function of the timer, passing to it its work_function_context. ]*/
+TEST_FUNCTION(on_timer_callback_records_the_lateness_and_calls_the_work_function)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+    TIMER_INSTANCE_HANDLE timer_instance = NULL;
+    TIMER_WHEEL_LINUX_ON_TIMER_EXPIRED captured_on_timer_expired = NULL;
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_init(IGNORED_ARG, WORKER_POOL_LINUX_PRIORITY_NORMAL, IGNORED_ARG, IGNORED_ARG))
+        .CaptureArgumentValue_on_timer_expired(&captured_on_timer_expired);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4245, &timer_instance));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(threadpool_timer_lateness_on_fired(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+
+    ///act
+    captured_on_timer_expired(timer_instance);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_156: [ If the lateness of the timer is recorded, threadpool_timer_restart shall compute when the timer is due by calling threadpool_timer_lateness_set_due_time with start_delay_ms and timer_period_ms before restarting it. ]*/
+TEST_FUNCTION(threadpool_timer_restart_with_statistics_computes_when_the_timer_is_due)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+    TIMER_INSTANCE_HANDLE timer_instance = test_start_timer(threadpool);
+
+    STRICT_EXPECTED_CALL(threadpool_timer_lateness_set_due_time(IGNORED_ARG, 43, 1000));
+    STRICT_EXPECTED_CALL(timer_wheel_linux_timer_start(test_timer_wheel, IGNORED_ARG, 43, 1000, 0));
+
+    ///act
+    int result = threadpool_timer_restart(timer_instance, 43, 1000);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_get_statistics */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_139: [ If threadpool is NULL, threadpool_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_get_statistics_with_NULL_threadpool_fails)
+{
+    ///arrange
+    THREADPOOL_STATISTICS statistics;
+
+    ///act
+    int result = threadpool_get_statistics(NULL, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_140: [ If statistics is NULL, threadpool_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_get_statistics_with_NULL_statistics_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+
+    ///act
+    int result = threadpool_get_statistics(threadpool, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_141: [ If the statistics are not enabled, threadpool_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_get_statistics_when_the_statistics_are_not_enabled_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    THREADPOOL_STATISTICS statistics;
+
+    ///act
+    int result = threadpool_get_statistics(threadpool, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_150: [ threadpool_get_statistics shall fill statistics by calling threadpool_statistics_recorder_get. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_151: [ threadpool_get_statistics shall obtain the number of idle worker threads of the worker pool of the execution engine by calling worker_pool_linux_get_thread_counts. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_152: [ threadpool_get_statistics shall set the idle worker count in statistics to the number of idle worker threads and return 0. ]*/
+TEST_FUNCTION(threadpool_get_statistics_fills_the_statistics_and_the_idle_worker_count)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+    THREADPOOL_STATISTICS statistics;
+    uint32_t thread_count = 4;
+    uint32_t idle_thread_count = 3;
+    (void)memset(&statistics, 0, sizeof(statistics));
+
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_get(test_statistics_recorder, &statistics));
+    STRICT_EXPECTED_CALL(worker_pool_linux_get_thread_counts(test_worker_pool, IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_thread_count(&thread_count, sizeof(thread_count))
+        .CopyOutArgumentBuffer_idle_thread_count(&idle_thread_count, sizeof(idle_thread_count));
+
+    ///act
+    int result = threadpool_get_statistics(threadpool, &statistics);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 3, statistics.idle_worker_count);
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_153: [ If any error occurs, threadpool_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_worker_pool_linux_get_thread_counts_fails_threadpool_get_statistics_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+    THREADPOOL_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_get(test_statistics_recorder, &statistics));
+    STRICT_EXPECTED_CALL(worker_pool_linux_get_thread_counts(test_worker_pool, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(MU_FAILURE);
+
+    ///act
+    int result = threadpool_get_statistics(threadpool, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_get_statistics */
+
+/* Tests_SRS_THREADPOOL_LINUX_01_159: [ If timer is NULL, threadpool_timer_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_get_statistics_with_NULL_timer_fails)
+{
+    ///arrange
+    THREADPOOL_TIMER_STATISTICS statistics;
+
+    ///act
+    int result = threadpool_timer_get_statistics(NULL, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_160: [ If statistics is NULL, threadpool_timer_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_get_statistics_with_NULL_statistics_fails)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+    TIMER_INSTANCE_HANDLE timer_instance = test_start_timer(threadpool);
+
+    ///act
+    int result = threadpool_timer_get_statistics(timer_instance, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_161: [ If the lateness of timer is recorded, threadpool_timer_get_statistics shall fill statistics by calling threadpool_timer_lateness_get. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_163: [ threadpool_timer_get_statistics shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_timer_get_statistics_fills_the_lateness_of_the_timer)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics();
+    TIMER_INSTANCE_HANDLE timer_instance = test_start_timer(threadpool);
+    THREADPOOL_TIMER_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(threadpool_timer_lateness_get(IGNORED_ARG, &statistics));
+
+    ///act
+    int result = threadpool_timer_get_statistics(timer_instance, &statistics);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_LINUX_01_162: [ Otherwise threadpool_timer_get_statistics shall fill statistics with an empty histogram. ]*/
+/* Tests_SRS_THREADPOOL_LINUX_01_163: [ threadpool_timer_get_statistics shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_timer_get_statistics_of_a_timer_started_without_statistics_returns_an_empty_histogram)
+{
+    ///arrange
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool();
+    TIMER_INSTANCE_HANDLE timer_instance = test_start_timer(threadpool);
+    THREADPOOL_TIMER_STATISTICS statistics;
+    (void)memset(&statistics, 0x42, sizeof(statistics));
+
+    ///act
+    int result = threadpool_timer_get_statistics(timer_instance, &statistics);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.lateness.sample_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.lateness.max_us);
+
+    ///cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -0,0 +1,16 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#include <time.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+#include "mock_timer_wheel.h"
+
+#define timerfd_create mock_timerfd_create
+#define timerfd_settime mock_timerfd_settime
+#define clock_gettime mock_clock_gettime
+#define read mock_read
+#define close mock_close
+
+#include "../../src/timer_wheel_linux.c"
@@ -0,0 +1,28 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef MOCK_TIMER_WHEEL_H
+#define MOCK_TIMER_WHEEL_H
+
+#include <stddef.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/timerfd.h>
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+MOCKABLE_FUNCTION(, int, mock_timerfd_create, int, clockid, int, flags);
+MOCKABLE_FUNCTION(, int, mock_timerfd_settime, int, fd, int, flags, const struct itimerspec*, new_value, struct itimerspec*, old_value);
+MOCKABLE_FUNCTION(, int, mock_clock_gettime, clockid_t, clockid, struct timespec*, tp);
+MOCKABLE_FUNCTION(, ssize_t, mock_read, int, fd, void*, buf, size_t, count);
+MOCKABLE_FUNCTION(, int, mock_close, int, fd);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MOCK_TIMER_WHEEL_H
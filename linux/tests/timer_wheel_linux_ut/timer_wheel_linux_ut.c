@@ -0,0 +1,1399 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#endif
+
+#include <time.h>
+#include <sys/timerfd.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "real_gballoc_ll.h"
+static void* real_malloc(size_t size)
+{
+    return real_gballoc_ll_malloc(size);
+}
+
+static void real_free(void* ptr)
+{
+    real_gballoc_ll_free(ptr);
+}
+
+#include "testrunnerswitcher.h"
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes_bool.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umock_c_negative_tests.h"
+
+#define ENABLE_MOCKS
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sync.h"
+#include "c_pal/threadapi.h"
+#include "c_pal/worker_pool_linux.h"
+#include "mock_timer_wheel.h"
+
+MOCKABLE_FUNCTION(, void, test_on_timer_expired, void*, context);
+
+#undef ENABLE_MOCKS
+
+#include "real_gballoc_hl.h"
+#include "real_interlocked.h"
+#include "real_sync.h"
+
+#include "c_pal/timer_wheel_linux.h"
+
+#define TEST_TIMER_FD 42
+#define TEST_START_TIME_NS 1000000000000ULL
+#define TEST_NS_PER_MS 1000000ULL
+#define TEST_MAX_SUBMITTED_WORK_ITEMS 16
+
+/*values of the callback state of the timers*/
+#define TEST_CALLBACK_STATE_IDLE 0
+#define TEST_CALLBACK_STATE_QUEUED 1
+#define TEST_CALLBACK_STATE_CANCELLED 2
+#define TEST_CALLBACK_STATE_RUNNING 3
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+static WORKER_POOL_LINUX_HANDLE test_worker_pool = (WORKER_POOL_LINUX_HANDLE)0x4242;
+static THREAD_HANDLE test_thread_handle = (THREAD_HANDLE)0x4243;
+
+static uint64_t test_time_ns;
+static uint64_t armed_time_ns;
+static THREAD_START_FUNC captured_thread_function;
+static void* captured_thread_arg;
+static WORKER_POOL_LINUX_WORK_ITEM* submitted_work_items[TEST_MAX_SUBMITTED_WORK_ITEMS];
+static uint32_t submitted_work_item_count;
+/*run from wait_on_address, simulates a worker thread running the work item while the timer is cancelled*/
+static WORKER_POOL_LINUX_WORK_ITEM* work_item_to_run_on_wait;
+/*when set, the timer callback starts this timer again, like a callback that reschedules its own timer*/
+static TIMER_WHEEL_LINUX_HANDLE timer_wheel_to_restart_in_callback;
+static TIMER_WHEEL_LINUX_TIMER* timer_to_restart_in_callback;
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+TEST_DEFINE_ENUM_TYPE(THREADAPI_RESULT, THREADAPI_RESULT_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(THREADAPI_RESULT, THREADAPI_RESULT_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static int hook_mock_clock_gettime(clockid_t clockid, struct timespec* tp)
+{
+    (void)clockid;
+    tp->tv_sec = (time_t)(test_time_ns / 1000000000ULL);
+    tp->tv_nsec = (long)(test_time_ns % 1000000000ULL);
+    return 0;
+}
+
+static int hook_mock_timerfd_settime(int fd, int flags, const struct itimerspec* new_value, struct itimerspec* old_value)
+{
+    (void)fd;
+    (void)flags;
+    (void)old_value;
+    armed_time_ns = ((uint64_t)new_value->it_value.tv_sec * 1000000000ULL) + (uint64_t)new_value->it_value.tv_nsec;
+    return 0;
+}
+
+static ssize_t hook_mock_read(int fd, void* buf, size_t count)
+{
+    (void)fd;
+    (void)count;
+    *(uint64_t*)buf = 1;
+    return sizeof(uint64_t);
+}
+
+static THREADAPI_RESULT hook_ThreadAPI_Create(THREAD_HANDLE* threadHandle, THREAD_START_FUNC func, void* arg)
+{
+    captured_thread_function = func;
+    captured_thread_arg = arg;
+    *threadHandle = test_thread_handle;
+    return THREADAPI_OK;
+}
+
+static THREADAPI_RESULT hook_ThreadAPI_Join(THREAD_HANDLE threadHandle, int* res)
+{
+    /*joining runs the timer thread, it exits since the stop was requested before joining*/
+    (void)threadHandle;
+    int thread_result = captured_thread_function(captured_thread_arg);
+    if (res != NULL)
+    {
+        *res = thread_result;
+    }
+    return THREADAPI_OK;
+}
+
+static int hook_worker_pool_linux_submit(WORKER_POOL_LINUX_HANDLE worker_pool, WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    (void)worker_pool;
+    ASSERT_IS_TRUE(submitted_work_item_count < TEST_MAX_SUBMITTED_WORK_ITEMS);
+    submitted_work_items[submitted_work_item_count++] = work_item;
+    return 0;
+}
+
+static bool hook_wait_on_address(volatile_atomic int32_t* address, int32_t compare_value, uint32_t timeout_ms)
+{
+    (void)address;
+    (void)compare_value;
+    (void)timeout_ms;
+    if (work_item_to_run_on_wait != NULL)
+    {
+        WORKER_POOL_LINUX_WORK_ITEM* work_item = work_item_to_run_on_wait;
+        work_item_to_run_on_wait = NULL;
+        work_item->work_function(work_item->work_function_context);
+    }
+    return true;
+}
+
+static void hook_test_on_timer_expired(void* context)
+{
+    (void)context;
+    if (timer_to_restart_in_callback != NULL)
+    {
+        ASSERT_ARE_EQUAL(int, 0, timer_wheel_linux_timer_start(timer_wheel_to_restart_in_callback, timer_to_restart_in_callback, 5, 0, 0));
+    }
+}
+
+static uint64_t test_tick_to_ns(uint64_t tick)
+{
+    return TEST_START_TIME_NS + (tick * TEST_NS_PER_MS);
+}
+
+static TIMER_WHEEL_LINUX_HANDLE test_create_timer_wheel(void)
+{
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = timer_wheel_linux_create(test_worker_pool);
+    ASSERT_IS_NOT_NULL(timer_wheel);
+    umock_c_reset_all_calls();
+    return timer_wheel;
+}
+
+static void test_init_timer(TIMER_WHEEL_LINUX_TIMER* timer, void* context)
+{
+    ASSERT_ARE_EQUAL(int, 0, timer_wheel_linux_timer_init(timer, WORKER_POOL_LINUX_PRIORITY_NORMAL, test_on_timer_expired, context));
+    umock_c_reset_all_calls();
+}
+
+static void test_start_timer(TIMER_WHEEL_LINUX_HANDLE timer_wheel, TIMER_WHEEL_LINUX_TIMER* timer, uint32_t start_delay_ms, uint32_t period_ms)
+{
+    ASSERT_ARE_EQUAL(int, 0, timer_wheel_linux_timer_start(timer_wheel, timer, start_delay_ms, period_ms, 0));
+    umock_c_reset_all_calls();
+}
+
+/*runs one iteration of the timer thread at the current test time*/
+static void test_run_timer_thread_once(void)
+{
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+    (void)captured_thread_function(captured_thread_arg);
+    umock_c_reset_all_calls();
+}
+
+static void setup_start_expected_calls(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TEST_CALLBACK_STATE_CANCELLED, TEST_CALLBACK_STATE_QUEUED));
+}
+
+static void setup_cancel_expected_calls(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(IGNORED_ARG, TEST_CALLBACK_STATE_CANCELLED, TEST_CALLBACK_STATE_QUEUED));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error));
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_bool_register_types());
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+
+    REGISTER_GLOBAL_MOCK_HOOK(malloc, real_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
+    REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
+    REGISTER_SYNC_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_HOOK(wait_on_address, hook_wait_on_address);
+    REGISTER_GLOBAL_MOCK_HOOK(test_on_timer_expired, hook_test_on_timer_expired);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_clock_gettime, hook_mock_clock_gettime);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_timerfd_settime, hook_mock_timerfd_settime);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_read, hook_mock_read);
+    REGISTER_GLOBAL_MOCK_HOOK(ThreadAPI_Create, hook_ThreadAPI_Create);
+    REGISTER_GLOBAL_MOCK_HOOK(ThreadAPI_Join, hook_ThreadAPI_Join);
+    REGISTER_GLOBAL_MOCK_HOOK(worker_pool_linux_submit, hook_worker_pool_linux_submit);
+
+    REGISTER_GLOBAL_MOCK_RETURN(mock_timerfd_create, TEST_TIMER_FD);
+    REGISTER_GLOBAL_MOCK_RETURN(mock_close, 0);
+
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mock_timerfd_create, -1);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mock_timerfd_settime, -1);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(ThreadAPI_Create, THREADAPI_ERROR);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(worker_pool_linux_submit, MU_FAILURE);
+
+    REGISTER_UMOCK_ALIAS_TYPE(WORKER_POOL_LINUX_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(THREAD_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(THREAD_START_FUNC, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(clockid_t, int);
+    REGISTER_UMOCK_ALIAS_TYPE(ssize_t, long);
+
+    REGISTER_TYPE(THREADAPI_RESULT, THREADAPI_RESULT);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    test_time_ns = TEST_START_TIME_NS;
+    armed_time_ns = 0;
+    captured_thread_function = NULL;
+    captured_thread_arg = NULL;
+    submitted_work_item_count = 0;
+    work_item_to_run_on_wait = NULL;
+    timer_wheel_to_restart_in_callback = NULL;
+    timer_to_restart_in_callback = NULL;
+
+    umock_c_reset_all_calls();
+    umock_c_negative_tests_init();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    umock_c_negative_tests_deinit();
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* timer_wheel_linux_create */
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_001: [ If worker_pool is NULL, timer_wheel_linux_create shall fail and return NULL. ]*/
+TEST_FUNCTION(timer_wheel_linux_create_with_NULL_worker_pool_fails)
+{
+    ///arrange
+
+    ///act
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = timer_wheel_linux_create(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(timer_wheel);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_002: [ timer_wheel_linux_create shall allocate a new timer wheel and on success return a non-NULL handle. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_003: [ timer_wheel_linux_create shall create the timer fd of the wheel by calling timerfd_create with CLOCK_MONOTONIC. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_004: [ timer_wheel_linux_create shall initialize the lock protecting the wheel by calling pthread_mutex_init. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_005: [ timer_wheel_linux_create shall take the current time obtained by calling clock_gettime with CLOCK_MONOTONIC as tick 0 of the wheel. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_006: [ timer_wheel_linux_create shall start the timer thread by calling ThreadAPI_Create. ]*/
+TEST_FUNCTION(timer_wheel_linux_create_succeeds)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC));
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(ThreadAPI_Create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    ///act
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = timer_wheel_linux_create(test_worker_pool);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(timer_wheel);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, timer_wheel, captured_thread_arg);
+
+    ///cleanup
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_007: [ If any error occurs, timer_wheel_linux_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_timer_wheel_linux_create_fails)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC));
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(ThreadAPI_Create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            TIMER_WHEEL_LINUX_HANDLE timer_wheel = timer_wheel_linux_create(test_worker_pool);
+
+            ///assert
+            ASSERT_IS_NULL(timer_wheel, "On failed call %zu", i);
+        }
+    }
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_007: [ If any error occurs, timer_wheel_linux_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_ThreadAPI_Create_fails_timer_wheel_linux_create_closes_the_timer_fd)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC));
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(ThreadAPI_Create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(THREADAPI_ERROR);
+    STRICT_EXPECTED_CALL(mock_close(TEST_TIMER_FD));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = timer_wheel_linux_create(test_worker_pool);
+
+    ///assert
+    ASSERT_IS_NULL(timer_wheel);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* timer_wheel_linux_destroy */
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_008: [ If timer_wheel is NULL, timer_wheel_linux_destroy shall return. ]*/
+TEST_FUNCTION(timer_wheel_linux_destroy_with_NULL_timer_wheel_returns)
+{
+    ///arrange
+
+    ///act
+    timer_wheel_linux_destroy(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_009: [ timer_wheel_linux_destroy shall request the timer thread to stop and wake it by arming the timer fd to expire right away. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_010: [ timer_wheel_linux_destroy shall join the timer thread by calling ThreadAPI_Join. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_011: [ timer_wheel_linux_destroy shall destroy the lock, close the timer fd and free the timer wheel. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_036: [ When a stop was requested, the timer thread shall exit. ]*/
+TEST_FUNCTION(timer_wheel_linux_destroy_stops_the_timer_thread_and_frees_resources)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(mock_timerfd_settime(TEST_TIMER_FD, TFD_TIMER_ABSTIME, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(ThreadAPI_Join(test_thread_handle, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_close(TEST_TIMER_FD));
+    STRICT_EXPECTED_CALL(free(timer_wheel));
+
+    ///act
+    timer_wheel_linux_destroy(timer_wheel);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 1, armed_time_ns);
+}
+
+/* timer_wheel_linux_timer_init */
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_012: [ If timer is NULL, timer_wheel_linux_timer_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_init_with_NULL_timer_fails)
+{
+    ///arrange
+
+    ///act
+    int result = timer_wheel_linux_timer_init(NULL, WORKER_POOL_LINUX_PRIORITY_NORMAL, test_on_timer_expired, (void*)0x4244);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_013: [ If on_timer_expired is NULL, timer_wheel_linux_timer_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_init_with_NULL_on_timer_expired_fails)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_TIMER timer;
+
+    ///act
+    int result = timer_wheel_linux_timer_init(&timer, WORKER_POOL_LINUX_PRIORITY_NORMAL, NULL, (void*)0x4244);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_040: [ If priority is not WORKER_POOL_LINUX_PRIORITY_HIGH, WORKER_POOL_LINUX_PRIORITY_NORMAL or WORKER_POOL_LINUX_PRIORITY_LOW, timer_wheel_linux_timer_init shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_init_with_an_invalid_priority_fails)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_TIMER timer;
+
+    ///act
+    int result = timer_wheel_linux_timer_init(&timer, (WORKER_POOL_LINUX_PRIORITY)0x42, test_on_timer_expired, (void*)0x4244);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_015: [ timer_wheel_linux_timer_init shall initialize timer as not started, with no callback running, and save on_timer_expired and on_timer_expired_context in it. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_016: [ timer_wheel_linux_timer_init shall succeed and return 0. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_init_succeeds)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_TIMER timer;
+
+    STRICT_EXPECTED_CALL(interlocked_exchange(&timer.callback_state, TEST_CALLBACK_STATE_IDLE));
+
+    ///act
+    int result = timer_wheel_linux_timer_init(&timer, WORKER_POOL_LINUX_PRIORITY_NORMAL, test_on_timer_expired, (void*)0x4244);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(timer.pprev);
+    ASSERT_IS_NOT_NULL(timer.work_item.work_function);
+    ASSERT_ARE_EQUAL(void_ptr, &timer, timer.work_item.work_function_context);
+    ASSERT_ARE_EQUAL(int, (int)WORKER_POOL_LINUX_PRIORITY_NORMAL, (int)timer.work_item.priority);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_041: [ timer_wheel_linux_timer_init shall set the priority of the work item of timer to priority, so that the callbacks of the timer are submitted to the worker pool with priority. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_init_sets_the_priority_of_the_work_item)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_TIMER timer;
+
+    STRICT_EXPECTED_CALL(interlocked_exchange(&timer.callback_state, TEST_CALLBACK_STATE_IDLE));
+
+    ///act
+    int result = timer_wheel_linux_timer_init(&timer, WORKER_POOL_LINUX_PRIORITY_HIGH, test_on_timer_expired, (void*)0x4244);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, (int)WORKER_POOL_LINUX_PRIORITY_HIGH, (int)timer.work_item.priority);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_014: [ on_timer_expired_context shall be allowed to be NULL. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_init_with_NULL_on_timer_expired_context_succeeds)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_TIMER timer;
+
+    STRICT_EXPECTED_CALL(interlocked_exchange(&timer.callback_state, TEST_CALLBACK_STATE_IDLE));
+
+    ///act
+    int result = timer_wheel_linux_timer_init(&timer, WORKER_POOL_LINUX_PRIORITY_NORMAL, test_on_timer_expired, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* timer_wheel_linux_timer_start */
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_017: [ If timer_wheel is NULL, timer_wheel_linux_timer_start shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_start_with_NULL_timer_wheel_fails)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+
+    ///act
+    int result = timer_wheel_linux_timer_start(NULL, &timer, 10, 0, 0);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_018: [ If timer is NULL, timer_wheel_linux_timer_start shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_start_with_NULL_timer_fails)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+
+    ///act
+    int result = timer_wheel_linux_timer_start(timer_wheel, NULL, 10, 0, 0);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_019: [ timer_wheel_linux_timer_start shall remove the timer from the wheel if it is started, without waiting for a running callback of the timer to complete. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_020: [ timer_wheel_linux_timer_start shall insert the timer in the slot of the wheel for the tick start_delay_ms after the current time obtained by calling clock_gettime with CLOCK_MONOTONIC. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_022: [ If the timer expires before the tick the timer fd is armed for, timer_wheel_linux_timer_start shall arm the timer fd for the expiration of the timer by calling timerfd_settime. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_023: [ timer_wheel_linux_timer_start shall succeed and return 0. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_start_arms_the_timer_fd)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_time_ns = test_tick_to_ns(5);
+
+    setup_start_expected_calls();
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_timerfd_settime(TEST_TIMER_FD, TFD_TIMER_ABSTIME, IGNORED_ARG, NULL));
+
+    ///act
+    int result = timer_wheel_linux_timer_start(timer_wheel, &timer, 10, 0, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(15), armed_time_ns);
+
+    ///cleanup
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_020: [ timer_wheel_linux_timer_start shall insert the timer in the slot of the wheel for the tick start_delay_ms after the current time obtained by calling clock_gettime with CLOCK_MONOTONIC. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_start_rounds_the_current_time_up)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_time_ns = test_tick_to_ns(5) + 1;
+
+    setup_start_expected_calls();
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_timerfd_settime(TEST_TIMER_FD, TFD_TIMER_ABSTIME, IGNORED_ARG, NULL));
+
+    ///act
+    int result = timer_wheel_linux_timer_start(timer_wheel, &timer, 10, 0, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(16), armed_time_ns);
+
+    ///cleanup
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_022: [ If the timer expires before the tick the timer fd is armed for, timer_wheel_linux_timer_start shall arm the timer fd for the expiration of the timer by calling timerfd_settime. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_start_of_a_later_timer_does_not_arm_the_timer_fd)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer_1;
+    TIMER_WHEEL_LINUX_TIMER timer_2;
+    test_init_timer(&timer_1, (void*)0x4244);
+    test_init_timer(&timer_2, (void*)0x4245);
+    test_start_timer(timer_wheel, &timer_1, 10, 0);
+
+    setup_start_expected_calls();
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+
+    ///act
+    int result = timer_wheel_linux_timer_start(timer_wheel, &timer_2, 20, 0, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(10), armed_time_ns);
+
+    ///cleanup
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer_1);
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer_2);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_022: [ If the timer expires before the tick the timer fd is armed for, timer_wheel_linux_timer_start shall arm the timer fd for the expiration of the timer by calling timerfd_settime. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_start_of_an_earlier_timer_arms_the_timer_fd)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer_1;
+    TIMER_WHEEL_LINUX_TIMER timer_2;
+    test_init_timer(&timer_1, (void*)0x4244);
+    test_init_timer(&timer_2, (void*)0x4245);
+    test_start_timer(timer_wheel, &timer_1, 100000, 0);
+
+    setup_start_expected_calls();
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_timerfd_settime(TEST_TIMER_FD, TFD_TIMER_ABSTIME, IGNORED_ARG, NULL));
+
+    ///act
+    int result = timer_wheel_linux_timer_start(timer_wheel, &timer_2, 20, 0, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(20), armed_time_ns);
+
+    ///cleanup
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer_1);
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer_2);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_024: [ If any error occurs, timer_wheel_linux_timer_start shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_timerfd_settime_fails_timer_wheel_linux_timer_start_fails)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+
+    setup_start_expected_calls();
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_timerfd_settime(TEST_TIMER_FD, TFD_TIMER_ABSTIME, IGNORED_ARG, NULL))
+        .SetReturn(-1);
+
+    ///act
+    int result = timer_wheel_linux_timer_start(timer_wheel, &timer, 10, 0, 0);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(timer.pprev);
+
+    ///cleanup
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_019: [ timer_wheel_linux_timer_start shall remove the timer from the wheel if it is started, without waiting for a running callback of the timer to complete. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_start_of_a_started_timer_restarts_it)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 10, 0);
+
+    ///act
+    int result = timer_wheel_linux_timer_start(timer_wheel, &timer, 30, 0, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    test_time_ns = test_tick_to_ns(10);
+    test_run_timer_thread_once();
+    ASSERT_ARE_EQUAL(uint32_t, 0, submitted_work_item_count);
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(30), armed_time_ns);
+    test_time_ns = test_tick_to_ns(30);
+    test_run_timer_thread_once();
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_work_item_count);
+    ASSERT_ARE_EQUAL(void_ptr, &timer.work_item, submitted_work_items[0]);
+
+    ///cleanup
+    submitted_work_items[0]->work_function(submitted_work_items[0]->work_function_context);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_045: [ timer_wheel_linux_timer_start shall prevent a callback of the timer that did not start yet from running. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_start_prevents_a_queued_callback_from_running)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 10, 0);
+    test_time_ns = test_tick_to_ns(10);
+    test_run_timer_thread_once();
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_work_item_count);
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(&timer.callback_state, TEST_CALLBACK_STATE_CANCELLED, TEST_CALLBACK_STATE_QUEUED));
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_timerfd_settime(TEST_TIMER_FD, TFD_TIMER_ABSTIME, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(&timer.callback_state, TEST_CALLBACK_STATE_RUNNING, TEST_CALLBACK_STATE_QUEUED));
+    STRICT_EXPECTED_CALL(interlocked_exchange(&timer.callback_state, TEST_CALLBACK_STATE_IDLE));
+    STRICT_EXPECTED_CALL(wake_by_address_all(&timer.callback_state));
+
+    ///act
+    int result = timer_wheel_linux_timer_start(timer_wheel, &timer, 5, 0, 0);
+    submitted_work_items[0]->work_function(submitted_work_items[0]->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(15), armed_time_ns);
+
+    ///cleanup
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_019: [ timer_wheel_linux_timer_start shall remove the timer from the wheel if it is started, without waiting for a running callback of the timer to complete. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_start_from_the_timer_callback_restarts_the_timer_without_waiting)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 10, 0);
+    test_time_ns = test_tick_to_ns(10);
+    test_run_timer_thread_once();
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_work_item_count);
+    timer_wheel_to_restart_in_callback = timer_wheel;
+    timer_to_restart_in_callback = &timer;
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(&timer.callback_state, TEST_CALLBACK_STATE_RUNNING, TEST_CALLBACK_STATE_QUEUED));
+    STRICT_EXPECTED_CALL(test_on_timer_expired((void*)0x4244));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(&timer.callback_state, TEST_CALLBACK_STATE_CANCELLED, TEST_CALLBACK_STATE_QUEUED));
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_timerfd_settime(TEST_TIMER_FD, TFD_TIMER_ABSTIME, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_exchange(&timer.callback_state, TEST_CALLBACK_STATE_IDLE));
+    STRICT_EXPECTED_CALL(wake_by_address_all(&timer.callback_state));
+
+    ///act
+    submitted_work_items[0]->work_function(submitted_work_items[0]->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(15), armed_time_ns);
+    timer_to_restart_in_callback = NULL;
+    test_time_ns = test_tick_to_ns(15);
+    test_run_timer_thread_once();
+    ASSERT_ARE_EQUAL(uint32_t, 2, submitted_work_item_count);
+
+    ///cleanup
+    submitted_work_items[1]->work_function(submitted_work_items[1]->work_function_context);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_021: [ timer_wheel_linux_timer_start shall save period_ms in the timer, 0 meaning that the timer expires only once. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_start_with_0_period_expires_once)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 10, 0);
+    test_time_ns = test_tick_to_ns(10);
+
+    ///act
+    test_run_timer_thread_once();
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_work_item_count);
+    ASSERT_IS_NULL(timer.pprev);
+    /*no timers left, the timer fd is disarmed*/
+    ASSERT_ARE_EQUAL(uint64_t, 0, armed_time_ns);
+
+    ///cleanup
+    submitted_work_items[0]->work_function(submitted_work_items[0]->work_function_context);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_042: [ timer_wheel_linux_timer_start shall delay the expiration of the timer by up to tolerance_ms, to the tick in the tolerance window that is a multiple of the largest power of 2, so that timers with overlapping tolerance windows expire on the same tick. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_start_with_tolerance_arms_the_timer_fd_for_the_aligned_tick)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+
+    setup_start_expected_calls();
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_timerfd_settime(TEST_TIMER_FD, TFD_TIMER_ABSTIME, IGNORED_ARG, NULL));
+
+    ///act
+    int result = timer_wheel_linux_timer_start(timer_wheel, &timer, 1000, 0, 50);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    /*1024 is the multiple of the largest power of 2 in [1000, 1050]*/
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(1024), armed_time_ns);
+
+    ///cleanup
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_042: [ timer_wheel_linux_timer_start shall delay the expiration of the timer by up to tolerance_ms, to the tick in the tolerance window that is a multiple of the largest power of 2, so that timers with overlapping tolerance windows expire on the same tick. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_start_with_tolerance_does_not_delay_a_timer_due_at_an_aligned_tick)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+
+    setup_start_expected_calls();
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_timerfd_settime(TEST_TIMER_FD, TFD_TIMER_ABSTIME, IGNORED_ARG, NULL));
+
+    ///act
+    int result = timer_wheel_linux_timer_start(timer_wheel, &timer, 1024, 0, 50);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(1024), armed_time_ns);
+
+    ///cleanup
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_042: [ timer_wheel_linux_timer_start shall delay the expiration of the timer by up to tolerance_ms, to the tick in the tolerance window that is a multiple of the largest power of 2, so that timers with overlapping tolerance windows expire on the same tick. ]*/
+TEST_FUNCTION(timers_with_overlapping_tolerance_windows_expire_on_the_same_tick)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer_1;
+    TIMER_WHEEL_LINUX_TIMER timer_2;
+    test_init_timer(&timer_1, (void*)0x4244);
+    test_init_timer(&timer_2, (void*)0x4245);
+    ASSERT_ARE_EQUAL(int, 0, timer_wheel_linux_timer_start(timer_wheel, &timer_1, 1000, 0, 50));
+    ASSERT_ARE_EQUAL(int, 0, timer_wheel_linux_timer_start(timer_wheel, &timer_2, 1010, 0, 30));
+    test_time_ns = test_tick_to_ns(1024);
+
+    ///act
+    test_run_timer_thread_once();
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 2, submitted_work_item_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, armed_time_ns);
+
+    ///cleanup
+    submitted_work_items[0]->work_function(submitted_work_items[0]->work_function_context);
+    submitted_work_items[1]->work_function(submitted_work_items[1]->work_function_context);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* timer_wheel_linux_timer_cancel */
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_025: [ If timer_wheel is NULL, timer_wheel_linux_timer_cancel shall return. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_cancel_with_NULL_timer_wheel_returns)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+
+    ///act
+    timer_wheel_linux_timer_cancel(NULL, &timer);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_026: [ If timer is NULL, timer_wheel_linux_timer_cancel shall return. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_cancel_with_NULL_timer_returns)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+
+    ///act
+    timer_wheel_linux_timer_cancel(timer_wheel, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_027: [ timer_wheel_linux_timer_cancel shall remove the timer from the wheel if it is started. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_cancel_removes_the_timer)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 10, 0);
+
+    setup_cancel_expected_calls();
+
+    ///act
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(timer.pprev);
+    test_time_ns = test_tick_to_ns(10);
+    test_run_timer_thread_once();
+    ASSERT_ARE_EQUAL(uint32_t, 0, submitted_work_item_count);
+
+    ///cleanup
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_027: [ timer_wheel_linux_timer_cancel shall remove the timer from the wheel if it is started. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_cancel_of_a_timer_that_is_not_started_returns)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+
+    setup_cancel_expected_calls();
+
+    ///act
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_028: [ timer_wheel_linux_timer_cancel shall prevent a callback of the timer that did not start yet from running and wait for a running callback to complete. ]*/
+TEST_FUNCTION(timer_wheel_linux_timer_cancel_prevents_a_queued_callback_from_running_and_waits_for_it)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 10, 0);
+    test_time_ns = test_tick_to_ns(10);
+    test_run_timer_thread_once();
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_work_item_count);
+    work_item_to_run_on_wait = submitted_work_items[0];
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(&timer.callback_state, TEST_CALLBACK_STATE_CANCELLED, TEST_CALLBACK_STATE_QUEUED));
+    STRICT_EXPECTED_CALL(interlocked_add(&timer.callback_state, 0));
+    STRICT_EXPECTED_CALL(wait_on_address(&timer.callback_state, TEST_CALLBACK_STATE_CANCELLED, UINT32_MAX));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(&timer.callback_state, TEST_CALLBACK_STATE_RUNNING, TEST_CALLBACK_STATE_QUEUED));
+    STRICT_EXPECTED_CALL(interlocked_exchange(&timer.callback_state, TEST_CALLBACK_STATE_IDLE));
+    STRICT_EXPECTED_CALL(wake_by_address_all(&timer.callback_state));
+    STRICT_EXPECTED_CALL(interlocked_add(&timer.callback_state, 0));
+
+    ///act
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* timer_wheel_linux_thread */
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_029: [ The timer thread shall wait for the timer fd to expire by calling read. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_030: [ The timer thread shall advance the wheel up to the current time obtained by calling clock_gettime with CLOCK_MONOTONIC. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_031: [ For each timer that expired, the timer thread shall submit the work item of the timer to the worker pool by calling worker_pool_linux_submit. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_035: [ The timer thread shall arm the timer fd for the next tick where timers have to be expired or moved to a lower level of the wheel by calling timerfd_settime, or disarm it if there are no timers. ]*/
+TEST_FUNCTION(timer_thread_submits_the_expired_timer)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 10, 0);
+    test_time_ns = test_tick_to_ns(10);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_read(TEST_TIMER_FD, IGNORED_ARG, sizeof(uint64_t)));
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(&timer.callback_state, TEST_CALLBACK_STATE_QUEUED, TEST_CALLBACK_STATE_IDLE));
+    STRICT_EXPECTED_CALL(mock_timerfd_settime(TEST_TIMER_FD, TFD_TIMER_ABSTIME, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, &timer.work_item));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    ///act
+    int thread_result = captured_thread_function(captured_thread_arg);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, thread_result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, 0, armed_time_ns);
+
+    ///cleanup
+    submitted_work_items[0]->work_function(submitted_work_items[0]->work_function_context);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_030: [ The timer thread shall advance the wheel up to the current time obtained by calling clock_gettime with CLOCK_MONOTONIC. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_035: [ The timer thread shall arm the timer fd for the next tick where timers have to be expired or moved to a lower level of the wheel by calling timerfd_settime, or disarm it if there are no timers. ]*/
+TEST_FUNCTION(timer_thread_does_not_submit_a_timer_before_it_expires)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 10, 0);
+    test_time_ns = test_tick_to_ns(9) + TEST_NS_PER_MS - 1;
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_read(TEST_TIMER_FD, IGNORED_ARG, sizeof(uint64_t)));
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_timerfd_settime(TEST_TIMER_FD, TFD_TIMER_ABSTIME, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    ///act
+    (void)captured_thread_function(captured_thread_arg);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(10), armed_time_ns);
+
+    ///cleanup
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_029: [ The timer thread shall wait for the timer fd to expire by calling read. ]*/
+TEST_FUNCTION(when_read_fails_timer_thread_still_expires_timers)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 10, 0);
+    test_time_ns = test_tick_to_ns(10);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_read(TEST_TIMER_FD, IGNORED_ARG, sizeof(uint64_t)))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(&timer.callback_state, TEST_CALLBACK_STATE_QUEUED, TEST_CALLBACK_STATE_IDLE));
+    STRICT_EXPECTED_CALL(mock_timerfd_settime(TEST_TIMER_FD, TFD_TIMER_ABSTIME, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, &timer.work_item));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    ///act
+    (void)captured_thread_function(captured_thread_arg);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    submitted_work_items[0]->work_function(submitted_work_items[0]->work_function_context);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_035: [ The timer thread shall arm the timer fd for the next tick where timers have to be expired or moved to a lower level of the wheel by calling timerfd_settime, or disarm it if there are no timers. ]*/
+TEST_FUNCTION(timer_thread_moves_a_long_timer_down_the_wheel_and_submits_it_when_it_expires)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 1000000, 0);
+    /*the timer was armed for its expiration, the thread wakes up early (for example a timer that was cancelled)*/
+    test_time_ns = test_tick_to_ns(1);
+    test_run_timer_thread_once();
+    uint32_t wake_up_count = 0;
+
+    ///act
+    while ((submitted_work_item_count == 0) && (wake_up_count < 100))
+    {
+        /*the timer thread never wakes up after the expiration*/
+        ASSERT_IS_TRUE(armed_time_ns <= test_tick_to_ns(1000000));
+        test_time_ns = armed_time_ns;
+        test_run_timer_thread_once();
+        wake_up_count++;
+    }
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_work_item_count);
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(1000000), test_time_ns);
+    /*one wake up per level at most*/
+    ASSERT_IS_TRUE(wake_up_count <= 6);
+
+    ///cleanup
+    submitted_work_items[0]->work_function(submitted_work_items[0]->work_function_context);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_030: [ The timer thread shall advance the wheel up to the current time obtained by calling clock_gettime with CLOCK_MONOTONIC. ]*/
+TEST_FUNCTION(timer_thread_submits_all_the_timers_expired_while_it_was_late)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timers[4];
+    static const uint32_t delays[4] = { 1, 63, 64, 5000 };
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        test_init_timer(&timers[i], (void*)0x4244);
+        test_start_timer(timer_wheel, &timers[i], delays[i], 0);
+    }
+    test_time_ns = test_tick_to_ns(10000);
+
+    ///act
+    test_run_timer_thread_once();
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 4, submitted_work_item_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, armed_time_ns);
+
+    ///cleanup
+    for (uint32_t i = 0; i < submitted_work_item_count; i++)
+    {
+        submitted_work_items[i]->work_function(submitted_work_items[i]->work_function_context);
+    }
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_032: [ If the period of the timer is not 0, the timer thread shall put the timer back in the wheel to expire period_ms after its previous expiration. ]*/
+TEST_FUNCTION(timer_thread_puts_a_periodic_timer_back_in_the_wheel)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 10, 20);
+    /*the thread is 5 ms late, the next expiration keeps the period*/
+    test_time_ns = test_tick_to_ns(15);
+
+    ///act
+    test_run_timer_thread_once();
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_work_item_count);
+    ASSERT_IS_NOT_NULL(timer.pprev);
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(30), armed_time_ns);
+
+    submitted_work_items[0]->work_function(submitted_work_items[0]->work_function_context);
+    test_time_ns = test_tick_to_ns(30);
+    test_run_timer_thread_once();
+    ASSERT_ARE_EQUAL(uint32_t, 2, submitted_work_item_count);
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(50), armed_time_ns);
+
+    ///cleanup
+    submitted_work_items[1]->work_function(submitted_work_items[1]->work_function_context);
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_032: [ If the period of the timer is not 0, the timer thread shall put the timer back in the wheel to expire period_ms after its previous expiration. ]*/
+TEST_FUNCTION(timer_thread_does_not_fire_the_missed_expirations_of_a_periodic_timer)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 10, 20);
+    test_time_ns = test_tick_to_ns(100);
+
+    ///act
+    test_run_timer_thread_once();
+
+    ///assert
+    /*the expirations at 30, 50, 70 and 90 are skipped since the callback did not run yet, the timer keeps its phase*/
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_work_item_count);
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(110), armed_time_ns);
+
+    ///cleanup
+    submitted_work_items[0]->work_function(submitted_work_items[0]->work_function_context);
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_043: [ The timer thread shall delay the next expiration of a periodic timer by up to the tolerance of the timer, to the tick in the tolerance window that is a multiple of the largest power of 2. ]*/
+TEST_FUNCTION(timer_thread_coalesces_the_expirations_of_a_periodic_timer_with_tolerance_without_drifting)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    ASSERT_ARE_EQUAL(int, 0, timer_wheel_linux_timer_start(timer_wheel, &timer, 1000, 1000, 50));
+    test_time_ns = test_tick_to_ns(1024);
+
+    ///act
+    test_run_timer_thread_once();
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_work_item_count);
+    /*due at 2000, 2048 is the multiple of the largest power of 2 in [2000, 2050]*/
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(2048), armed_time_ns);
+
+    submitted_work_items[0]->work_function(submitted_work_items[0]->work_function_context);
+    test_time_ns = test_tick_to_ns(2048);
+    test_run_timer_thread_once();
+    ASSERT_ARE_EQUAL(uint32_t, 2, submitted_work_item_count);
+    /*due at 3000 (not 3048), the tolerance does not accumulate*/
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(3008), armed_time_ns);
+
+    ///cleanup
+    submitted_work_items[1]->work_function(submitted_work_items[1]->work_function_context);
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_033: [ If the previous callback of a periodic timer did not run yet or is still running, the timer thread shall skip the expiration. ]*/
+TEST_FUNCTION(timer_thread_skips_the_expiration_of_a_timer_whose_callback_did_not_run_yet)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 10, 20);
+    test_time_ns = test_tick_to_ns(10);
+    test_run_timer_thread_once();
+    test_time_ns = test_tick_to_ns(30);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_read(TEST_TIMER_FD, IGNORED_ARG, sizeof(uint64_t)));
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(&timer.callback_state, TEST_CALLBACK_STATE_QUEUED, TEST_CALLBACK_STATE_IDLE));
+    STRICT_EXPECTED_CALL(mock_timerfd_settime(TEST_TIMER_FD, TFD_TIMER_ABSTIME, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    ///act
+    (void)captured_thread_function(captured_thread_arg);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_work_item_count);
+
+    ///cleanup
+    submitted_work_items[0]->work_function(submitted_work_items[0]->work_function_context);
+    timer_wheel_linux_timer_cancel(timer_wheel, &timer);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_044: [ If the previous callback of a timer that expires only once did not run yet or is still running, the timer thread shall put the timer back in the wheel to expire on the next tick. ]*/
+TEST_FUNCTION(timer_thread_puts_back_a_timer_that_expires_once_when_its_previous_callback_did_not_complete)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 10, 0);
+    test_time_ns = test_tick_to_ns(10);
+    test_run_timer_thread_once();
+    /*restarted while the previous callback is still queued*/
+    test_start_timer(timer_wheel, &timer, 5, 0);
+    test_time_ns = test_tick_to_ns(15);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_read(TEST_TIMER_FD, IGNORED_ARG, sizeof(uint64_t)));
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(&timer.callback_state, TEST_CALLBACK_STATE_QUEUED, TEST_CALLBACK_STATE_IDLE));
+    STRICT_EXPECTED_CALL(mock_timerfd_settime(TEST_TIMER_FD, TFD_TIMER_ABSTIME, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    ///act
+    (void)captured_thread_function(captured_thread_arg);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_work_item_count);
+    ASSERT_ARE_EQUAL(uint64_t, test_tick_to_ns(16), armed_time_ns);
+    /*once the previous callback is done, the timer expires*/
+    submitted_work_items[0]->work_function(submitted_work_items[0]->work_function_context);
+    test_time_ns = test_tick_to_ns(16);
+    test_run_timer_thread_once();
+    ASSERT_ARE_EQUAL(uint32_t, 2, submitted_work_item_count);
+    ASSERT_ARE_EQUAL(void_ptr, &timer.work_item, submitted_work_items[1]);
+
+    ///cleanup
+    submitted_work_items[1]->work_function(submitted_work_items[1]->work_function_context);
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_034: [ If worker_pool_linux_submit fails, the timer thread shall drop the expiration. ]*/
+TEST_FUNCTION(when_worker_pool_linux_submit_fails_timer_thread_drops_the_expiration)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 10, 0);
+    test_time_ns = test_tick_to_ns(10);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_read(TEST_TIMER_FD, IGNORED_ARG, sizeof(uint64_t)));
+    STRICT_EXPECTED_CALL(mock_clock_gettime(CLOCK_MONOTONIC, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(&timer.callback_state, TEST_CALLBACK_STATE_QUEUED, TEST_CALLBACK_STATE_IDLE));
+    STRICT_EXPECTED_CALL(mock_timerfd_settime(TEST_TIMER_FD, TFD_TIMER_ABSTIME, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(worker_pool_linux_submit(test_worker_pool, &timer.work_item))
+        .SetReturn(MU_FAILURE);
+    STRICT_EXPECTED_CALL(interlocked_exchange(&timer.callback_state, TEST_CALLBACK_STATE_IDLE));
+    STRICT_EXPECTED_CALL(wake_by_address_all(&timer.callback_state));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    ///act
+    (void)captured_thread_function(captured_thread_arg);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+/* on_timer_work */
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_037: [ If context is NULL, on_timer_work shall return. ]*/
+TEST_FUNCTION(on_timer_work_with_NULL_context_returns)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+
+    ///act
+    timer.work_item.work_function(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_038: [ If the timer was not cancelled since it expired, on_timer_work shall call on_timer_expired with on_timer_expired_context. ]*/
+/* Tests_SRS_TIMER_WHEEL_LINUX_01_039: [ on_timer_work shall mark the callback of the timer as done and wake the threads waiting for it by calling wake_by_address_all. ]*/
+TEST_FUNCTION(on_timer_work_calls_on_timer_expired)
+{
+    ///arrange
+    TIMER_WHEEL_LINUX_HANDLE timer_wheel = test_create_timer_wheel();
+    TIMER_WHEEL_LINUX_TIMER timer;
+    test_init_timer(&timer, (void*)0x4244);
+    test_start_timer(timer_wheel, &timer, 10, 0);
+    test_time_ns = test_tick_to_ns(10);
+    test_run_timer_thread_once();
+
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange(&timer.callback_state, TEST_CALLBACK_STATE_RUNNING, TEST_CALLBACK_STATE_QUEUED));
+    STRICT_EXPECTED_CALL(test_on_timer_expired((void*)0x4244));
+    STRICT_EXPECTED_CALL(interlocked_exchange(&timer.callback_state, TEST_CALLBACK_STATE_IDLE));
+    STRICT_EXPECTED_CALL(wake_by_address_all(&timer.callback_state));
+
+    ///act
+    submitted_work_items[0]->work_function(submitted_work_items[0]->work_function_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    timer_wheel_linux_destroy(timer_wheel);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
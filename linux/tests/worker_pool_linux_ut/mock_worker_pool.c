@@ -0,0 +1,18 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#define _GNU_SOURCE
+
+#include <sched.h>
+#include <pthread.h>
+
+#include "mock_worker_pool.h"
+
+#define pthread_attr_init mock_pthread_attr_init
+#define pthread_attr_destroy mock_pthread_attr_destroy
+#define pthread_attr_setstacksize mock_pthread_attr_setstacksize
+#define pthread_attr_setaffinity_np mock_pthread_attr_setaffinity_np
+#define pthread_create mock_pthread_create
+#define pthread_join mock_pthread_join
+
+#include "../../src/worker_pool_linux.c"
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#ifndef MOCK_WORKER_POOL_H
+#define MOCK_WORKER_POOL_H
+
+#include <stddef.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "umock_c/umock_c_prod.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void*(*MOCK_PTHREAD_START_ROUTINE)(void* arg);
+
+MOCKABLE_FUNCTION(, int, mock_pthread_attr_init, pthread_attr_t*, attr);
+MOCKABLE_FUNCTION(, int, mock_pthread_attr_destroy, pthread_attr_t*, attr);
+MOCKABLE_FUNCTION(, int, mock_pthread_attr_setstacksize, pthread_attr_t*, attr, size_t, stacksize);
+MOCKABLE_FUNCTION(, int, mock_pthread_attr_setaffinity_np, pthread_attr_t*, attr, size_t, cpusetsize, const cpu_set_t*, cpuset);
+MOCKABLE_FUNCTION(, int, mock_pthread_create, pthread_t*, thread, const pthread_attr_t*, attr, MOCK_PTHREAD_START_ROUTINE, start_routine, void*, arg);
+MOCKABLE_FUNCTION(, int, mock_pthread_join, pthread_t, thread, void**, retval);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MOCK_WORKER_POOL_H
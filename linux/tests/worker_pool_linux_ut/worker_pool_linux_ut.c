@@ -0,0 +1,2338 @@
+// Copyright (c) Microsoft. All rights reserved.
+// Licensed under the MIT license. See LICENSE file in the project root for full license information.
+
+#define _GNU_SOURCE
+
+#ifdef __cplusplus
+#include <cstdlib>
+#include <cstddef>
+#include <cstdint>
+#else
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#endif
+
+#include <sched.h>
+#include <pthread.h>
+
+#include "macro_utils/macro_utils.h"
+
+#include "real_gballoc_ll.h"
+static void* real_malloc(size_t size)
+{
+    return real_gballoc_ll_malloc(size);
+}
+
+static void real_free(void* ptr)
+{
+    real_gballoc_ll_free(ptr);
+}
+
+#include "testrunnerswitcher.h"
+#include "umock_c/umock_c.h"
+#include "umock_c/umocktypes_bool.h"
+#include "umock_c/umocktypes_stdint.h"
+#include "umock_c/umock_c_negative_tests.h"
+
+#define ENABLE_MOCKS
+
+#include "c_pal/gballoc_hl.h"
+#include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sync.h"
+#include "c_pal/sysinfo.h"
+#include "mock_worker_pool.h"
+
+MOCKABLE_FUNCTION(, void, mock_work_function, void*, context);
+
+#undef ENABLE_MOCKS
+
+#include "real_gballoc_hl.h"
+#include "real_interlocked.h"
+#include "real_sync.h"
+
+#include "c_pal/worker_pool_linux.h"
+
+#define TEST_MAX_THREAD_COUNT 8
+#define TEST_DEQUE_SIZE 256
+#define TEST_WORK_ITEM_COUNT (TEST_DEQUE_SIZE + 8)
+
+static TEST_MUTEX_HANDLE g_testByTest;
+
+static MOCK_PTHREAD_START_ROUTINE captured_start_routines[TEST_MAX_THREAD_COUNT];
+static void* captured_start_routine_args[TEST_MAX_THREAD_COUNT];
+/*set for the threads that a test ran to their end, joining them does not run them again*/
+static bool captured_thread_exited[TEST_MAX_THREAD_COUNT];
+static uint32_t started_thread_count;
+static cpu_set_t captured_cpu_set;
+
+static WORKER_POOL_LINUX_HANDLE test_worker_pool;
+static WORKER_POOL_LINUX_WORK_ITEM test_work_items[TEST_WORK_ITEM_COUNT];
+static uint32_t test_work_item_run_count;
+/*called by the work function of the test work items, so that tests can submit from a worker thread*/
+static void(*test_on_work)(WORKER_POOL_LINUX_WORK_ITEM* work_item);
+static WORKER_POOL_LINUX_WORK_ITEM* work_item_to_submit_on_wait;
+/*the number of waits that time out before a wait returns as woken*/
+static uint32_t wait_on_address_timeout_count;
+/*when set, the wait that follows the timed out waits sets the address to 1, which is how the tests stop the controller thread*/
+static bool wait_on_address_sets_address_after_timeouts;
+
+MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
+
+static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
+{
+    ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
+}
+
+static int hook_mock_pthread_create(pthread_t* thread, const pthread_attr_t* attr, MOCK_PTHREAD_START_ROUTINE start_routine, void* arg)
+{
+    (void)attr;
+    ASSERT_IS_TRUE(started_thread_count < TEST_MAX_THREAD_COUNT);
+    captured_start_routines[started_thread_count] = start_routine;
+    captured_start_routine_args[started_thread_count] = arg;
+    captured_thread_exited[started_thread_count] = false;
+    started_thread_count++;
+    *thread = (pthread_t)started_thread_count;
+    return 0;
+}
+
+static int hook_mock_pthread_join(pthread_t thread, void** retval)
+{
+    /*joining runs the worker thread, it exits since the stop was requested before joining*/
+    uint32_t index = (uint32_t)thread - 1;
+    void* thread_result = NULL;
+    if (!captured_thread_exited[index])
+    {
+        thread_result = captured_start_routines[index](captured_start_routine_args[index]);
+        captured_thread_exited[index] = true;
+    }
+    if (retval != NULL)
+    {
+        *retval = thread_result;
+    }
+    return 0;
+}
+
+static int hook_mock_pthread_attr_setaffinity_np(pthread_attr_t* attr, size_t cpusetsize, const cpu_set_t* cpuset)
+{
+    (void)attr;
+    (void)cpusetsize;
+    captured_cpu_set = *cpuset;
+    return 0;
+}
+
+static bool hook_wait_on_address(volatile_atomic int32_t* address, int32_t compare_value, uint32_t timeout_ms)
+{
+    bool result;
+    (void)compare_value;
+    (void)timeout_ms;
+    if (wait_on_address_timeout_count > 0)
+    {
+        wait_on_address_timeout_count--;
+        result = false;
+    }
+    else
+    {
+        if (wait_on_address_sets_address_after_timeouts)
+        {
+            wait_on_address_sets_address_after_timeouts = false;
+            (void)real_interlocked_exchange(address, 1);
+        }
+        if (work_item_to_submit_on_wait != NULL)
+        {
+            /*simulates a submit happening while the worker thread is parked*/
+            WORKER_POOL_LINUX_WORK_ITEM* work_item = work_item_to_submit_on_wait;
+            work_item_to_submit_on_wait = NULL;
+            ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(test_worker_pool, work_item));
+        }
+        result = true;
+    }
+    return result;
+}
+
+static void hook_mock_work_function(void* context)
+{
+    test_work_item_run_count++;
+    if (test_on_work != NULL)
+    {
+        test_on_work(context);
+    }
+}
+
+static WORKER_POOL_LINUX_HANDLE create_worker_pool(uint32_t min_thread_count, uint32_t max_thread_count)
+{
+    WORKER_POOL_LINUX_PARAMETERS parameters = { min_thread_count, max_thread_count, 0, 0, NULL };
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+    ASSERT_IS_NOT_NULL(worker_pool);
+    test_worker_pool = worker_pool;
+    umock_c_reset_all_calls();
+    return worker_pool;
+}
+
+static WORKER_POOL_LINUX_HANDLE create_adaptive_worker_pool(uint32_t min_thread_count, uint32_t max_thread_count, uint32_t idle_timeout_ms, uint32_t max_injected_thread_count)
+{
+    WORKER_POOL_LINUX_PARAMETERS parameters = { min_thread_count, max_thread_count, 0, 0, NULL, idle_timeout_ms, max_injected_thread_count };
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+    ASSERT_IS_NOT_NULL(worker_pool);
+    test_worker_pool = worker_pool;
+    umock_c_reset_all_calls();
+    return worker_pool;
+}
+
+/*runs a captured thread to its end on the test thread, joining it later does not run it again*/
+static void* run_captured_thread(uint32_t index)
+{
+    void* thread_result = captured_start_routines[index](captured_start_routine_args[index]);
+    captured_thread_exited[index] = true;
+    return thread_result;
+}
+
+static void setup_start_thread_expected_calls(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_destroy(IGNORED_ARG));
+}
+
+static void setup_create_expected_calls(uint32_t thread_count)
+{
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 0));
+    for (uint32_t i = 0; i < thread_count; i++)
+    {
+        setup_start_thread_expected_calls();
+    }
+}
+
+/*the worker thread looks at the high priority queue, its LIFO slot, its deque, the global queue, the other worker threads and the low priority queue and finds nothing*/
+static void setup_find_no_work_expected_calls(uint32_t other_thread_count)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    for (uint32_t i = 0; i < other_thread_count; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    }
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+}
+
+static void setup_worker_thread_exit_expected_calls(uint32_t other_thread_count)
+{
+    setup_find_no_work_expected_calls(other_thread_count);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+}
+
+static void setup_run_from_global_queue_expected_calls(WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_work_function(work_item));
+}
+
+static void setup_run_from_lifo_slot_expected_calls(WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(mock_work_function(work_item));
+}
+
+static void setup_run_from_high_priority_queue_expected_calls(WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_work_function(work_item));
+}
+
+/*the low priority queue is the last place a worker thread with no other worker thread looks at*/
+static void setup_run_from_low_priority_queue_expected_calls(WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_work_function(work_item));
+}
+
+/*the worker thread finds no work, parks and the park times out*/
+static void setup_park_times_out_expected_calls(uint32_t other_thread_count, uint32_t idle_timeout_ms)
+{
+    setup_find_no_work_expected_calls(other_thread_count);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, IGNORED_ARG, idle_timeout_ms));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+}
+
+static void setup_retire_expected_calls(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+}
+
+/*one tick of the controller thread on which the wait on the stop request times out*/
+static void setup_controller_tick_expected_calls(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, 500));
+}
+
+/*the oldest queued work item did not move since the previous tick, the controller looks at the stop request, the idle and the started worker threads*/
+static void setup_controller_starvation_check_expected_calls(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+}
+
+/*the last wait of the controller thread returns because a stop was requested*/
+static void setup_controller_exit_expected_calls(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, 500));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+}
+
+static void setup_stop_begin_expected_calls(void)
+{
+    STRICT_EXPECTED_CALL(interlocked_exchange(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+}
+
+static void setup_stop_expected_calls(uint32_t thread_count)
+{
+    setup_stop_begin_expected_calls();
+    for (uint32_t i = 0; i < thread_count; i++)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)(i + 1), NULL));
+        setup_worker_thread_exit_expected_calls(thread_count - 1);
+    }
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+}
+
+/*links work_item_count test work items starting at first in a list for worker_pool_linux_submit_batch*/
+static void link_test_work_items(uint32_t first, uint32_t work_item_count)
+{
+    for (uint32_t i = first; i + 1 < first + work_item_count; i++)
+    {
+        test_work_items[i].next = &test_work_items[i + 1];
+    }
+    test_work_items[first + work_item_count - 1].next = NULL;
+}
+
+/*submit from a thread that is not a worker thread while no worker thread is idle*/
+static void setup_submit_expected_calls(bool starts_thread)
+{
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    if (starts_thread)
+    {
+        setup_start_thread_expected_calls();
+    }
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+}
+
+/*submit from a worker thread while no worker thread is idle and all the worker threads are started*/
+static void setup_submit_from_worker_thread_expected_calls(bool lifo_slot_is_empty)
+{
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, IGNORED_ARG));
+    if (!lifo_slot_is_empty)
+    {
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, IGNORED_ARG));
+        STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, IGNORED_ARG));
+    }
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+}
+
+BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
+
+TEST_SUITE_INITIALIZE(suite_init)
+{
+    ASSERT_ARE_EQUAL(int, 0, real_gballoc_hl_init(NULL, NULL));
+
+    g_testByTest = TEST_MUTEX_CREATE();
+    ASSERT_IS_NOT_NULL(g_testByTest);
+
+    ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error));
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_bool_register_types());
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
+
+    REGISTER_GLOBAL_MOCK_HOOK(malloc, real_malloc);
+    REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
+    REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
+    REGISTER_SYNC_GLOBAL_MOCK_HOOK();
+    REGISTER_GLOBAL_MOCK_HOOK(wait_on_address, hook_wait_on_address);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_pthread_create, hook_mock_pthread_create);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_pthread_join, hook_mock_pthread_join);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_pthread_attr_setaffinity_np, hook_mock_pthread_attr_setaffinity_np);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_work_function, hook_mock_work_function);
+
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_pthread_attr_init, 0, -1);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_pthread_attr_destroy, 0, -1);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_pthread_attr_setstacksize, 0, -1);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mock_pthread_attr_setaffinity_np, -1);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mock_pthread_create, -1);
+    REGISTER_GLOBAL_MOCK_RETURNS(sysinfo_get_processor_count, 4, 0);
+
+    REGISTER_UMOCK_ALIAS_TYPE(pthread_t, unsigned long);
+    REGISTER_UMOCK_ALIAS_TYPE(MOCK_PTHREAD_START_ROUTINE, void*);
+}
+
+TEST_SUITE_CLEANUP(suite_cleanup)
+{
+    umock_c_deinit();
+
+    TEST_MUTEX_DESTROY(g_testByTest);
+
+    real_gballoc_hl_deinit();
+}
+
+TEST_FUNCTION_INITIALIZE(method_init)
+{
+    if (TEST_MUTEX_ACQUIRE(g_testByTest))
+    {
+        ASSERT_FAIL("Could not acquire test serialization mutex.");
+    }
+
+    started_thread_count = 0;
+    CPU_ZERO(&captured_cpu_set);
+
+    test_worker_pool = NULL;
+    for (uint32_t i = 0; i < TEST_WORK_ITEM_COUNT; i++)
+    {
+        test_work_items[i].work_function = mock_work_function;
+        test_work_items[i].work_function_context = &test_work_items[i];
+        test_work_items[i].priority = WORKER_POOL_LINUX_PRIORITY_NORMAL;
+        test_work_items[i].next = NULL;
+    }
+    test_work_item_run_count = 0;
+    test_on_work = NULL;
+    work_item_to_submit_on_wait = NULL;
+    wait_on_address_timeout_count = 0;
+    wait_on_address_sets_address_after_timeouts = false;
+
+    umock_c_reset_all_calls();
+    umock_c_negative_tests_init();
+}
+
+TEST_FUNCTION_CLEANUP(method_cleanup)
+{
+    umock_c_negative_tests_deinit();
+    TEST_MUTEX_RELEASE(g_testByTest);
+}
+
+/* worker_pool_linux_create */
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_001: [ If parameters is NULL, worker_pool_linux_create shall fail and return NULL. ]*/
+TEST_FUNCTION(worker_pool_linux_create_with_NULL_parameters_fails)
+{
+    ///arrange
+
+    ///act
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(worker_pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_002: [ If max_thread_count is not 0 and min_thread_count is greater than max_thread_count, worker_pool_linux_create shall fail and return NULL. ]*/
+TEST_FUNCTION(worker_pool_linux_create_with_min_thread_count_greater_than_max_thread_count_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 3, 2, 0, 0, NULL };
+
+    ///act
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+
+    ///assert
+    ASSERT_IS_NULL(worker_pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_003: [ If cpu_count is not 0 and cpus is NULL, worker_pool_linux_create shall fail and return NULL. ]*/
+TEST_FUNCTION(worker_pool_linux_create_with_cpu_count_and_NULL_cpus_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 1, 2, 0, 2, NULL };
+
+    ///act
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+
+    ///assert
+    ASSERT_IS_NULL(worker_pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_004: [ If any of the cpus is greater than or equal to CPU_SETSIZE, worker_pool_linux_create shall fail and return NULL. ]*/
+TEST_FUNCTION(worker_pool_linux_create_with_a_cpu_out_of_range_fails)
+{
+    ///arrange
+    uint32_t cpus[] = { 1, CPU_SETSIZE };
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 1, 2, 0, 2, cpus };
+
+    ///act
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+
+    ///assert
+    ASSERT_IS_NULL(worker_pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_006: [ worker_pool_linux_create shall allocate a new worker pool with room for max_thread_count plus max_injected_thread_count worker threads and their deques and on success return a non-NULL handle. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_007: [ worker_pool_linux_create shall initialize the lock protecting the work queue by calling pthread_mutex_init. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_008: [ worker_pool_linux_create shall start min_thread_count worker threads. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_009: [ To start a worker thread, worker_pool_linux_create shall initialize the thread attributes by calling pthread_attr_init. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_012: [ worker_pool_linux_create shall start the thread by calling pthread_create. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_013: [ worker_pool_linux_create shall destroy the thread attributes by calling pthread_attr_destroy. ]*/
+TEST_FUNCTION(worker_pool_linux_create_starts_min_thread_count_threads)
+{
+    ///arrange
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 2, 4, 0, 0, NULL };
+
+    setup_create_expected_calls(2);
+
+    ///act
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(worker_pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, started_thread_count);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, captured_start_routine_args[0], captured_start_routine_args[1]);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_010: [ If stack_size is not 0, worker_pool_linux_create shall set the stack size of the thread by calling pthread_attr_setstacksize. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_011: [ If cpu_count is not 0, worker_pool_linux_create shall restrict the thread to cpus by calling pthread_attr_setaffinity_np. ]*/
+TEST_FUNCTION(worker_pool_linux_create_sets_the_stack_size_and_the_affinity_of_the_threads)
+{
+    ///arrange
+    uint32_t cpus[] = { 1, 3 };
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 1, 2, 256 * 1024, 2, cpus };
+
+    setup_create_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_setstacksize(IGNORED_ARG, 256 * 1024));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_setaffinity_np(IGNORED_ARG, sizeof(cpu_set_t), IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_destroy(IGNORED_ARG));
+
+    ///act
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(worker_pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 2, CPU_COUNT(&captured_cpu_set));
+    ASSERT_IS_TRUE(CPU_ISSET(1, &captured_cpu_set));
+    ASSERT_IS_TRUE(CPU_ISSET(3, &captured_cpu_set));
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_005: [ If max_thread_count is 0, worker_pool_linux_create shall use as maximum the number of cpus, or the number of processors returned by sysinfo_get_processor_count if cpu_count is 0, but no less than min_thread_count and no less than 1. ]*/
+TEST_FUNCTION(worker_pool_linux_create_with_max_thread_count_0_uses_the_processor_count)
+{
+    ///arrange
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 0, 0, 0, 0, NULL };
+
+    STRICT_EXPECTED_CALL(sysinfo_get_processor_count())
+        .SetReturn(1);
+    setup_create_expected_calls(0);
+
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+    ASSERT_IS_NOT_NULL(worker_pool);
+
+    setup_submit_expected_calls(true);
+    setup_submit_expected_calls(false);
+
+    ///act
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[1]));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, started_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_005: [ If max_thread_count is 0, worker_pool_linux_create shall use as maximum the number of cpus, or the number of processors returned by sysinfo_get_processor_count if cpu_count is 0, but no less than min_thread_count and no less than 1. ]*/
+TEST_FUNCTION(worker_pool_linux_create_with_max_thread_count_0_uses_the_cpu_count)
+{
+    ///arrange
+    uint32_t cpus[] = { 5 };
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 0, 0, 0, 1, cpus };
+
+    setup_create_expected_calls(0);
+
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+    ASSERT_IS_NOT_NULL(worker_pool);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_setaffinity_np(IGNORED_ARG, sizeof(cpu_set_t), IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_submit_expected_calls(false);
+
+    ///act
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[1]));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, started_thread_count);
+    ASSERT_IS_TRUE(CPU_ISSET(5, &captured_cpu_set));
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_005: [ If max_thread_count is 0, worker_pool_linux_create shall use as maximum the number of cpus, or the number of processors returned by sysinfo_get_processor_count if cpu_count is 0, but no less than min_thread_count and no less than 1. ]*/
+TEST_FUNCTION(worker_pool_linux_create_with_max_thread_count_0_uses_at_least_min_thread_count)
+{
+    ///arrange
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 2, 0, 0, 0, NULL };
+
+    STRICT_EXPECTED_CALL(sysinfo_get_processor_count())
+        .SetReturn(1);
+    setup_create_expected_calls(2);
+
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+    ASSERT_IS_NOT_NULL(worker_pool);
+
+    setup_submit_expected_calls(false);
+
+    ///act
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, started_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_005: [ If max_thread_count is 0, worker_pool_linux_create shall use as maximum the number of cpus, or the number of processors returned by sysinfo_get_processor_count if cpu_count is 0, but no less than min_thread_count and no less than 1. ]*/
+TEST_FUNCTION(worker_pool_linux_create_with_max_thread_count_0_uses_at_least_1_thread)
+{
+    ///arrange
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 0, 0, 0, 0, NULL };
+
+    STRICT_EXPECTED_CALL(sysinfo_get_processor_count())
+        .SetReturn(0);
+    setup_create_expected_calls(0);
+
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+    ASSERT_IS_NOT_NULL(worker_pool);
+
+    setup_submit_expected_calls(true);
+    setup_submit_expected_calls(false);
+
+    ///act
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[1]));
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, started_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_014: [ If any error occurs, worker_pool_linux_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_worker_pool_linux_create_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 2, 4, 0, 0, NULL };
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+
+    ///assert
+    ASSERT_IS_NULL(worker_pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_014: [ If any error occurs, worker_pool_linux_create shall fail and return NULL. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_015: [ If starting any of the worker threads fails, worker_pool_linux_create shall stop and join the worker threads already started. ]*/
+TEST_FUNCTION(when_pthread_create_fails_worker_pool_linux_create_joins_the_started_threads_and_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 2, 4, 0, 0, NULL };
+
+    setup_create_expected_calls(1);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_pthread_attr_destroy(IGNORED_ARG));
+    setup_stop_expected_calls(1);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+
+    ///assert
+    ASSERT_IS_NULL(worker_pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_014: [ If any error occurs, worker_pool_linux_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_pthread_attr_init_fails_worker_pool_linux_create_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 1, 4, 0, 0, NULL };
+
+    setup_create_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_init(IGNORED_ARG))
+        .SetReturn(-1);
+    setup_stop_expected_calls(0);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+
+    ///assert
+    ASSERT_IS_NULL(worker_pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_014: [ If any error occurs, worker_pool_linux_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_pthread_attr_setstacksize_fails_worker_pool_linux_create_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 1, 4, 1024 * 1024, 0, NULL };
+
+    setup_create_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_setstacksize(IGNORED_ARG, 1024 * 1024))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_pthread_attr_destroy(IGNORED_ARG));
+    setup_stop_expected_calls(0);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+
+    ///assert
+    ASSERT_IS_NULL(worker_pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_014: [ If any error occurs, worker_pool_linux_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_pthread_attr_setaffinity_np_fails_worker_pool_linux_create_fails)
+{
+    ///arrange
+    uint32_t cpus[] = { 0 };
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 1, 4, 0, 1, cpus };
+
+    setup_create_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_setaffinity_np(IGNORED_ARG, sizeof(cpu_set_t), IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_pthread_attr_destroy(IGNORED_ARG));
+    setup_stop_expected_calls(0);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+
+    ///assert
+    ASSERT_IS_NULL(worker_pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_059: [ If max_injected_thread_count added to the maximum number of worker threads overflows, worker_pool_linux_create shall fail and return NULL. ]*/
+TEST_FUNCTION(worker_pool_linux_create_with_max_injected_thread_count_too_large_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 1, UINT32_MAX, 0, 0, NULL, 0, 1 };
+
+    ///act
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+
+    ///assert
+    ASSERT_IS_NULL(worker_pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_006: [ worker_pool_linux_create shall allocate a new worker pool with room for max_thread_count plus max_injected_thread_count worker threads and their deques and on success return a non-NULL handle. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_060: [ If max_injected_thread_count is not 0, worker_pool_linux_create shall start the controller thread by calling pthread_create. ]*/
+TEST_FUNCTION(worker_pool_linux_create_with_max_injected_thread_count_starts_the_controller_thread)
+{
+    ///arrange
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 1, 2, 0, 0, NULL, 0, 2 };
+
+    setup_create_expected_calls(1);
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    ///act
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(worker_pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, started_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_066: [ If starting the controller thread fails, worker_pool_linux_create shall stop and join the worker threads already started. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_014: [ If any error occurs, worker_pool_linux_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_starting_the_controller_thread_fails_worker_pool_linux_create_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_PARAMETERS parameters = { 1, 2, 0, 0, NULL, 0, 2 };
+
+    setup_create_expected_calls(1);
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(-1);
+    setup_stop_expected_calls(1);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    WORKER_POOL_LINUX_HANDLE worker_pool = worker_pool_linux_create(&parameters);
+
+    ///assert
+    ASSERT_IS_NULL(worker_pool);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* worker_pool_linux_destroy */
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_016: [ If worker_pool is NULL, worker_pool_linux_destroy shall return. ]*/
+TEST_FUNCTION(worker_pool_linux_destroy_with_NULL_worker_pool_returns)
+{
+    ///arrange
+
+    ///act
+    worker_pool_linux_destroy(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_017: [ worker_pool_linux_destroy shall request the worker threads to stop, bump the work signal and wake all of them by calling wake_by_address_all. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_018: [ worker_pool_linux_destroy shall join all the worker threads by calling pthread_join, the worker threads run all the queued work items before exiting. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_019: [ worker_pool_linux_destroy shall destroy the lock by calling pthread_mutex_destroy and free the worker pool. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_027: [ When a stop was requested and there is no work item to run, the worker thread shall exit. ]*/
+TEST_FUNCTION(worker_pool_linux_destroy_stops_and_joins_the_worker_threads)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(2, 4);
+
+    setup_stop_expected_calls(2);
+    STRICT_EXPECTED_CALL(free(worker_pool));
+
+    ///act
+    worker_pool_linux_destroy(worker_pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_018: [ worker_pool_linux_destroy shall join all the worker threads by calling pthread_join, the worker threads run all the queued work items before exiting. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_038: [ Otherwise the worker thread shall take the oldest work item in the global queue. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_025: [ For each work item, the worker thread shall call work_function with work_function_context. ]*/
+TEST_FUNCTION(worker_pool_linux_destroy_runs_the_queued_work_items)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[1]));
+    umock_c_reset_all_calls();
+
+    setup_stop_begin_expected_calls();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)1, NULL));
+    setup_run_from_global_queue_expected_calls(&test_work_items[0]);
+    setup_run_from_global_queue_expected_calls(&test_work_items[1]);
+    setup_worker_thread_exit_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(free(worker_pool));
+
+    ///act
+    worker_pool_linux_destroy(worker_pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, test_work_item_run_count);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_070: [ worker_pool_linux_destroy shall wake the controller thread by calling wake_by_address_all on the stop request and join it by calling pthread_join. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_067: [ Until a stop is requested, the controller thread shall tick every 500 milliseconds by calling wait_on_address on the stop request. ]*/
+TEST_FUNCTION(worker_pool_linux_destroy_stops_and_joins_the_controller_thread)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_adaptive_worker_pool(1, 1, 0, 1);
+
+    setup_stop_begin_expected_calls();
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)2, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)1, NULL));
+    setup_worker_thread_exit_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(free(worker_pool));
+
+    ///act
+    worker_pool_linux_destroy(worker_pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* worker_pool_linux_submit */
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_020: [ If worker_pool is NULL, worker_pool_linux_submit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_with_NULL_worker_pool_fails)
+{
+    ///arrange
+
+    ///act
+    int result = worker_pool_linux_submit(NULL, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_021: [ If work_item is NULL, worker_pool_linux_submit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_with_NULL_work_item_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+
+    ///act
+    int result = worker_pool_linux_submit(worker_pool, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_022: [ If the work_function of work_item is NULL, worker_pool_linux_submit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_with_NULL_work_function_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+    test_work_items[0].work_function = NULL;
+
+    ///act
+    int result = worker_pool_linux_submit(worker_pool, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_023: [ Otherwise, worker_pool_linux_submit shall append work_item to the global queue of the worker pool. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_031: [ worker_pool_linux_submit shall bump the work signal and, if any worker thread is idle, wake one of them by calling wake_by_address_single. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_032: [ worker_pool_linux_submit shall succeed and return 0. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_queues_the_work_item)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+
+    setup_submit_expected_calls(false);
+
+    ///act
+    int result = worker_pool_linux_submit(worker_pool, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_029: [ If no worker thread is idle and fewer than max_thread_count worker threads are started, worker_pool_linux_submit shall start a new worker thread. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_starts_a_worker_thread_when_none_is_idle)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 2);
+
+    setup_submit_expected_calls(true);
+    setup_submit_expected_calls(false);
+
+    ///act
+    int result_1 = worker_pool_linux_submit(worker_pool, &test_work_items[0]);
+    int result_2 = worker_pool_linux_submit(worker_pool, &test_work_items[1]);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result_1);
+    ASSERT_ARE_EQUAL(int, 0, result_2);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, started_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_030: [ If starting the worker thread fails and no worker thread is started, worker_pool_linux_submit shall fail and return a non-zero value, otherwise the work item is left to the started worker threads. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_queues_the_work_item_when_starting_a_worker_thread_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 2);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_pthread_attr_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+
+    ///act
+    int result = worker_pool_linux_submit(worker_pool, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, started_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_030: [ If starting the worker thread fails and no worker thread is started, worker_pool_linux_submit shall fail and return a non-zero value, otherwise the work item is left to the started worker threads. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_028: [ If any error occurs, worker_pool_linux_submit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_fails_when_no_worker_thread_can_be_started)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(0, 2);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_pthread_attr_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+
+    ///act
+    int result = worker_pool_linux_submit(worker_pool, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_049: [ If the priority of work_item is not WORKER_POOL_LINUX_PRIORITY_HIGH, WORKER_POOL_LINUX_PRIORITY_NORMAL or WORKER_POOL_LINUX_PRIORITY_LOW, worker_pool_linux_submit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_with_an_invalid_priority_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+    test_work_items[0].priority = (WORKER_POOL_LINUX_PRIORITY)0x42;
+
+    ///act
+    int result = worker_pool_linux_submit(worker_pool, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+    ASSERT_ARE_EQUAL(uint32_t, 0, test_work_item_run_count);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_050: [ worker_pool_linux_submit shall append WORKER_POOL_LINUX_PRIORITY_HIGH work items to the high priority queue and WORKER_POOL_LINUX_PRIORITY_LOW work items to the low priority queue of the worker pool, also when called from one of the worker threads. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_052: [ The worker thread shall take the oldest work item in the high priority queue before any other work item. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_054: [ Otherwise the worker thread shall take the oldest work item in the low priority queue. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_queues_the_work_items_by_priority)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+    test_work_items[0].priority = WORKER_POOL_LINUX_PRIORITY_LOW;
+    test_work_items[2].priority = WORKER_POOL_LINUX_PRIORITY_HIGH;
+
+    setup_submit_expected_calls(false);
+    setup_submit_expected_calls(false);
+    setup_submit_expected_calls(false);
+
+    ///act
+    int result_1 = worker_pool_linux_submit(worker_pool, &test_work_items[0]);
+    int result_2 = worker_pool_linux_submit(worker_pool, &test_work_items[1]);
+    int result_3 = worker_pool_linux_submit(worker_pool, &test_work_items[2]);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result_1);
+    ASSERT_ARE_EQUAL(int, 0, result_2);
+    ASSERT_ARE_EQUAL(int, 0, result_3);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*the high priority work item runs first and the low priority one last*/
+    umock_c_reset_all_calls();
+    setup_stop_begin_expected_calls();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)1, NULL));
+    setup_run_from_high_priority_queue_expected_calls(&test_work_items[2]);
+    setup_run_from_global_queue_expected_calls(&test_work_items[1]);
+    setup_run_from_low_priority_queue_expected_calls(&test_work_items[0]);
+    setup_worker_thread_exit_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(free(worker_pool));
+
+    worker_pool_linux_destroy(worker_pool);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 3, test_work_item_run_count);
+}
+
+static void submit_work_item_2_from_work_item_0(WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    if (work_item == &test_work_items[0])
+    {
+        ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(test_worker_pool, &test_work_items[2]));
+    }
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_033: [ If the priority of work_item is WORKER_POOL_LINUX_PRIORITY_NORMAL and worker_pool_linux_submit is called from one of the worker threads of worker_pool, it shall place work_item in the LIFO slot of that worker thread. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_024: [ The worker thread shall take the work item in its LIFO slot, unless it already ran 3 work items in a row from its LIFO slot. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_from_a_worker_thread_runs_the_work_item_next)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[1]));
+    test_on_work = submit_work_item_2_from_work_item_0;
+    umock_c_reset_all_calls();
+
+    setup_stop_begin_expected_calls();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)1, NULL));
+    setup_run_from_global_queue_expected_calls(&test_work_items[0]);
+    setup_submit_from_worker_thread_expected_calls(true);
+    setup_run_from_lifo_slot_expected_calls(&test_work_items[2]);
+    setup_run_from_global_queue_expected_calls(&test_work_items[1]);
+    setup_worker_thread_exit_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(free(worker_pool));
+
+    ///act
+    worker_pool_linux_destroy(worker_pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+static void submit_work_items_1_and_2_from_work_item_0(WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    if (work_item == &test_work_items[0])
+    {
+        ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(test_worker_pool, &test_work_items[1]));
+        ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(test_worker_pool, &test_work_items[2]));
+    }
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_034: [ The work item previously in the LIFO slot shall be pushed to the deque of the worker thread. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_037: [ Otherwise the worker thread shall take the work item most recently pushed to its own deque. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_from_a_worker_thread_pushes_the_work_item_in_the_LIFO_slot_to_the_deque)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+    test_on_work = submit_work_items_1_and_2_from_work_item_0;
+    umock_c_reset_all_calls();
+
+    setup_stop_begin_expected_calls();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)1, NULL));
+    setup_run_from_global_queue_expected_calls(&test_work_items[0]);
+    setup_submit_from_worker_thread_expected_calls(true);
+    setup_submit_from_worker_thread_expected_calls(false);
+    setup_run_from_lifo_slot_expected_calls(&test_work_items[2]);
+    /*pops the last work item of the deque*/
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_64(IGNORED_ARG, 1));
+    STRICT_EXPECTED_CALL(mock_work_function(&test_work_items[1]));
+    setup_worker_thread_exit_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(free(worker_pool));
+
+    ///act
+    worker_pool_linux_destroy(worker_pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+static void submit_a_chain_of_work_items(WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    /*0 submits 2, 2 submits 3, 3 submits 4 and 4 submits 5*/
+    if (work_item == &test_work_items[0])
+    {
+        ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(test_worker_pool, &test_work_items[2]));
+    }
+    else if (
+        (work_item >= &test_work_items[2]) &&
+        (work_item <= &test_work_items[4])
+        )
+    {
+        ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(test_worker_pool, work_item + 1));
+    }
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_024: [ The worker thread shall take the work item in its LIFO slot, unless it already ran 3 work items in a row from its LIFO slot. ]*/
+TEST_FUNCTION(worker_thread_looks_at_the_other_queues_after_3_work_items_from_the_LIFO_slot)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[1]));
+    test_on_work = submit_a_chain_of_work_items;
+    umock_c_reset_all_calls();
+
+    setup_stop_begin_expected_calls();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)1, NULL));
+    setup_run_from_global_queue_expected_calls(&test_work_items[0]);
+    setup_submit_from_worker_thread_expected_calls(true);
+    setup_run_from_lifo_slot_expected_calls(&test_work_items[2]);
+    setup_submit_from_worker_thread_expected_calls(true);
+    setup_run_from_lifo_slot_expected_calls(&test_work_items[3]);
+    setup_submit_from_worker_thread_expected_calls(true);
+    setup_run_from_lifo_slot_expected_calls(&test_work_items[4]);
+    setup_submit_from_worker_thread_expected_calls(true);
+    /*the LIFO slot is skipped, the work item in the global queue runs first*/
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_work_function(&test_work_items[1]));
+    setup_run_from_lifo_slot_expected_calls(&test_work_items[5]);
+    setup_worker_thread_exit_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(free(worker_pool));
+
+    ///act
+    worker_pool_linux_destroy(worker_pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+static void submit_more_work_items_than_the_deque_holds(WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    if (work_item == &test_work_items[0])
+    {
+        umock_c_reset_all_calls();
+
+        /*the first one goes to the LIFO slot, the next TEST_DEQUE_SIZE ones push the one they displace to the deque*/
+        setup_submit_from_worker_thread_expected_calls(true);
+        for (uint32_t i = 0; i < TEST_DEQUE_SIZE; i++)
+        {
+            setup_submit_from_worker_thread_expected_calls(false);
+        }
+        /*the deque is full, the displaced one goes to the global queue*/
+        STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, IGNORED_ARG));
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+        STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+        STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+
+        for (uint32_t i = 1; i <= TEST_DEQUE_SIZE + 2; i++)
+        {
+            ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(test_worker_pool, &test_work_items[i]));
+        }
+
+        ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+        umock_c_reset_all_calls();
+    }
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_035: [ If the deque of the worker thread is full, the work item previously in the LIFO slot shall be appended to the global queue. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_036: [ Every 61 work items, the worker thread shall look at the global queue first. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_from_a_worker_thread_with_a_full_deque_uses_the_global_queue)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+    test_on_work = submit_more_work_items_than_the_deque_holds;
+    umock_c_reset_all_calls();
+
+    ///act
+    worker_pool_linux_destroy(worker_pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, TEST_DEQUE_SIZE + 3, test_work_item_run_count);
+}
+
+static void submit_work_items_1_and_2_and_run_the_other_worker_thread(WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    if (work_item == &test_work_items[0])
+    {
+        ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(test_worker_pool, &test_work_items[1]));
+        ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(test_worker_pool, &test_work_items[2]));
+
+        /*the other worker thread runs while this one is busy*/
+        (void)captured_start_routines[1](captured_start_routine_args[1]);
+    }
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_039: [ Otherwise the worker thread shall steal the oldest work item from the deque of another worker thread, or the work item in its LIFO slot, starting with a random worker thread. ]*/
+TEST_FUNCTION(worker_thread_steals_from_the_deque_and_the_LIFO_slot_of_a_busy_worker_thread)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(2, 2);
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+    test_on_work = submit_work_items_1_and_2_and_run_the_other_worker_thread;
+    umock_c_reset_all_calls();
+
+    setup_stop_begin_expected_calls();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)1, NULL));
+    setup_run_from_global_queue_expected_calls(&test_work_items[0]);
+    setup_submit_from_worker_thread_expected_calls(true);
+    setup_submit_from_worker_thread_expected_calls(false);
+    /*the other worker thread steals the work item in the deque*/
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_pointer(IGNORED_ARG, NULL, NULL));
+    STRICT_EXPECTED_CALL(interlocked_compare_exchange_64(IGNORED_ARG, 1, 0));
+    STRICT_EXPECTED_CALL(mock_work_function(&test_work_items[1]));
+    /*and then the work item in the LIFO slot*/
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add_64(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(mock_work_function(&test_work_items[2]));
+    setup_worker_thread_exit_expected_calls(1);
+    /*back on the first worker thread*/
+    setup_worker_thread_exit_expected_calls(1);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)2, NULL));
+    setup_worker_thread_exit_expected_calls(1);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(free(worker_pool));
+
+    ///act
+    worker_pool_linux_destroy(worker_pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 3, test_work_item_run_count);
+}
+
+static void submit_work_item_1_from_work_item_0(WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    if (work_item == &test_work_items[0])
+    {
+        ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(test_worker_pool, &test_work_items[1]));
+    }
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_050: [ worker_pool_linux_submit shall append WORKER_POOL_LINUX_PRIORITY_HIGH work items to the high priority queue and WORKER_POOL_LINUX_PRIORITY_LOW work items to the low priority queue of the worker pool, also when called from one of the worker threads. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_052: [ The worker thread shall take the oldest work item in the high priority queue before any other work item. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_of_a_high_priority_work_item_from_a_worker_thread_does_not_use_the_LIFO_slot)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[1]));
+    test_work_items[2].priority = WORKER_POOL_LINUX_PRIORITY_HIGH;
+    test_on_work = submit_work_item_2_from_work_item_0;
+    umock_c_reset_all_calls();
+
+    setup_stop_begin_expected_calls();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)1, NULL));
+    setup_run_from_global_queue_expected_calls(&test_work_items[0]);
+    setup_submit_expected_calls(false);
+    setup_run_from_high_priority_queue_expected_calls(&test_work_items[2]);
+    setup_run_from_global_queue_expected_calls(&test_work_items[1]);
+    setup_worker_thread_exit_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(free(worker_pool));
+
+    ///act
+    worker_pool_linux_destroy(worker_pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 3, test_work_item_run_count);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_029: [ If no worker thread is idle and fewer than max_thread_count worker threads are started, worker_pool_linux_submit shall start a new worker thread. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_018: [ worker_pool_linux_destroy shall join all the worker threads by calling pthread_join, the worker threads run all the queued work items before exiting. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_from_a_worker_thread_starts_a_worker_thread_when_none_is_idle)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 2);
+
+    /*no worker thread is started by this submit*/
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(2);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+    test_on_work = submit_work_item_1_from_work_item_0;
+    umock_c_reset_all_calls();
+
+    setup_stop_begin_expected_calls();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)1, NULL));
+    setup_run_from_global_queue_expected_calls(&test_work_items[0]);
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_start_thread_expected_calls();
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_run_from_lifo_slot_expected_calls(&test_work_items[1]);
+    setup_worker_thread_exit_expected_calls(1);
+    /*the worker thread started while stopping is joined too*/
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)2, NULL));
+    setup_worker_thread_exit_expected_calls(1);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(free(worker_pool));
+
+    ///act
+    worker_pool_linux_destroy(worker_pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, started_thread_count);
+}
+
+/* worker_pool_linux_submit_batch */
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_040: [ If worker_pool is NULL, worker_pool_linux_submit_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_batch_with_NULL_worker_pool_fails)
+{
+    ///arrange
+    link_test_work_items(0, 2);
+
+    ///act
+    int result = worker_pool_linux_submit_batch(NULL, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_041: [ If work_items is NULL, worker_pool_linux_submit_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_batch_with_NULL_work_items_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+
+    ///act
+    int result = worker_pool_linux_submit_batch(worker_pool, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_042: [ If the work_function of any of the work items is NULL, worker_pool_linux_submit_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_batch_with_a_NULL_work_function_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+    link_test_work_items(0, 3);
+    test_work_items[1].work_function = NULL;
+
+    ///act
+    int result = worker_pool_linux_submit_batch(worker_pool, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+    ASSERT_ARE_EQUAL(uint32_t, 0, test_work_item_run_count);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_051: [ If the priority of the first work item is not valid or the priority of any of the other work items is different, worker_pool_linux_submit_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_batch_with_an_invalid_priority_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+    link_test_work_items(0, 2);
+    test_work_items[0].priority = (WORKER_POOL_LINUX_PRIORITY)0x42;
+    test_work_items[1].priority = (WORKER_POOL_LINUX_PRIORITY)0x42;
+
+    ///act
+    int result = worker_pool_linux_submit_batch(worker_pool, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+    ASSERT_ARE_EQUAL(uint32_t, 0, test_work_item_run_count);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_051: [ If the priority of the first work item is not valid or the priority of any of the other work items is different, worker_pool_linux_submit_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_batch_with_work_items_of_different_priorities_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+    link_test_work_items(0, 3);
+    test_work_items[2].priority = WORKER_POOL_LINUX_PRIORITY_HIGH;
+
+    ///act
+    int result = worker_pool_linux_submit_batch(worker_pool, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+    ASSERT_ARE_EQUAL(uint32_t, 0, test_work_item_run_count);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_043: [ Otherwise, worker_pool_linux_submit_batch shall append all the work items to the global queue of their priority at once, in order. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_047: [ worker_pool_linux_submit_batch shall succeed and return 0. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_batch_queues_the_work_items_in_order)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+    link_test_work_items(1, 3);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 3));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+
+    ///act
+    int result = worker_pool_linux_submit_batch(worker_pool, &test_work_items[1]);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    /*the work items run after the work item already queued, in the order of the batch*/
+    umock_c_reset_all_calls();
+    setup_stop_begin_expected_calls();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)1, NULL));
+    setup_run_from_global_queue_expected_calls(&test_work_items[0]);
+    setup_run_from_global_queue_expected_calls(&test_work_items[1]);
+    setup_run_from_global_queue_expected_calls(&test_work_items[2]);
+    setup_run_from_global_queue_expected_calls(&test_work_items[3]);
+    setup_worker_thread_exit_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(free(worker_pool));
+
+    worker_pool_linux_destroy(worker_pool);
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 4, test_work_item_run_count);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_046: [ worker_pool_linux_submit_batch shall bump the work signal once and wake as many idle worker threads as there are work items: all of them by calling wake_by_address_all if there are at least as many work items as idle worker threads, otherwise one per work item by calling wake_by_address_single. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_batch_wakes_all_the_idle_worker_threads_when_there_are_enough_work_items)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(2, 2);
+    link_test_work_items(0, 3);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(2);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 3));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(2);
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+
+    ///act
+    int result = worker_pool_linux_submit_batch(worker_pool, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+    ASSERT_ARE_EQUAL(uint32_t, 3, test_work_item_run_count);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_046: [ worker_pool_linux_submit_batch shall bump the work signal once and wake as many idle worker threads as there are work items: all of them by calling wake_by_address_all if there are at least as many work items as idle worker threads, otherwise one per work item by calling wake_by_address_single. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_batch_wakes_one_idle_worker_thread_per_work_item)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(4, 4);
+    link_test_work_items(0, 2);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(4);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(4);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = worker_pool_linux_submit_batch(worker_pool, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+    ASSERT_ARE_EQUAL(uint32_t, 2, test_work_item_run_count);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_044: [ worker_pool_linux_submit_batch shall start new worker threads for the work items that the idle worker threads cannot take, as long as fewer than max_thread_count worker threads are started. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_batch_starts_a_worker_thread_per_work_item_that_no_idle_worker_thread_takes)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 8);
+    link_test_work_items(0, 3);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_start_thread_expected_calls();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_start_thread_expected_calls();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 3));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+
+    ///act
+    int result = worker_pool_linux_submit_batch(worker_pool, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 3, started_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+    ASSERT_ARE_EQUAL(uint32_t, 3, test_work_item_run_count);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_044: [ worker_pool_linux_submit_batch shall start new worker threads for the work items that the idle worker threads cannot take, as long as fewer than max_thread_count worker threads are started. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_batch_starts_no_more_than_max_thread_count_worker_threads)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 2);
+    link_test_work_items(0, 4);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_start_thread_expected_calls();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 4));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+
+    ///act
+    int result = worker_pool_linux_submit_batch(worker_pool, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, started_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+    ASSERT_ARE_EQUAL(uint32_t, 4, test_work_item_run_count);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_045: [ If starting a worker thread fails and no worker thread is started, worker_pool_linux_submit_batch shall fail and return a non-zero value, otherwise the work items are left to the started worker threads. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_batch_queues_the_work_items_when_starting_a_worker_thread_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 4);
+    link_test_work_items(0, 3);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_pthread_attr_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 3));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+
+    ///act
+    int result = worker_pool_linux_submit_batch(worker_pool, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, started_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+    ASSERT_ARE_EQUAL(uint32_t, 3, test_work_item_run_count);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_045: [ If starting a worker thread fails and no worker thread is started, worker_pool_linux_submit_batch shall fail and return a non-zero value, otherwise the work items are left to the started worker threads. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_048: [ If any error occurs, worker_pool_linux_submit_batch shall fail and return a non-zero value and none of the work items shall be queued. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_batch_fails_when_no_worker_thread_can_be_started)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(0, 2);
+    link_test_work_items(0, 2);
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_pthread_attr_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+
+    ///act
+    int result = worker_pool_linux_submit_batch(worker_pool, &test_work_items[0]);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+    ASSERT_ARE_EQUAL(uint32_t, 0, test_work_item_run_count);
+}
+
+/* worker_pool_linux_get_thread_counts */
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_055: [ If worker_pool is NULL, worker_pool_linux_get_thread_counts shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(worker_pool_linux_get_thread_counts_with_NULL_worker_pool_fails)
+{
+    ///arrange
+    uint32_t thread_count;
+    uint32_t idle_thread_count;
+
+    ///act
+    int result = worker_pool_linux_get_thread_counts(NULL, &thread_count, &idle_thread_count);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_056: [ If thread_count is NULL, worker_pool_linux_get_thread_counts shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(worker_pool_linux_get_thread_counts_with_NULL_thread_count_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(2, 4);
+    uint32_t idle_thread_count;
+
+    ///act
+    int result = worker_pool_linux_get_thread_counts(worker_pool, NULL, &idle_thread_count);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_057: [ If idle_thread_count is NULL, worker_pool_linux_get_thread_counts shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(worker_pool_linux_get_thread_counts_with_NULL_idle_thread_count_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(2, 4);
+    uint32_t thread_count;
+
+    ///act
+    int result = worker_pool_linux_get_thread_counts(worker_pool, &thread_count, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_058: [ worker_pool_linux_get_thread_counts shall set thread_count to the number of started worker threads and idle_thread_count to the number of idle worker threads, no larger than thread_count, and return 0. ]*/
+TEST_FUNCTION(worker_pool_linux_get_thread_counts_returns_the_started_and_idle_worker_threads)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(2, 4);
+    uint32_t thread_count;
+    uint32_t idle_thread_count;
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    ///act
+    int result = worker_pool_linux_get_thread_counts(worker_pool, &thread_count, &idle_thread_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, 1, idle_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_058: [ worker_pool_linux_get_thread_counts shall set thread_count to the number of started worker threads and idle_thread_count to the number of idle worker threads, no larger than thread_count, and return 0. ]*/
+TEST_FUNCTION(worker_pool_linux_get_thread_counts_caps_the_idle_count_to_the_thread_count)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(2, 4);
+    uint32_t thread_count;
+    uint32_t idle_thread_count;
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(3);
+
+    ///act
+    int result = worker_pool_linux_get_thread_counts(worker_pool, &thread_count, &idle_thread_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, 2, idle_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/* worker_pool_linux_get_statistics */
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_072: [ If worker_pool is NULL, worker_pool_linux_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(worker_pool_linux_get_statistics_with_NULL_worker_pool_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_STATISTICS statistics;
+
+    ///act
+    int result = worker_pool_linux_get_statistics(NULL, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_073: [ If statistics is NULL, worker_pool_linux_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(worker_pool_linux_get_statistics_with_NULL_statistics_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(2, 4);
+
+    ///act
+    int result = worker_pool_linux_get_statistics(worker_pool, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_074: [ worker_pool_linux_get_statistics shall take the lock, so that the statistics are consistent with each other. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_075: [ worker_pool_linux_get_statistics shall set in statistics the number of started and idle worker threads like worker_pool_linux_get_thread_counts, the peak number of started worker threads and the number of worker threads started, injected by the controller thread and retired since the worker pool was created and return 0. ]*/
+TEST_FUNCTION(worker_pool_linux_get_statistics_returns_the_thread_counts)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(2, 4);
+    WORKER_POOL_LINUX_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(3);
+
+    ///act
+    int result = worker_pool_linux_get_statistics(worker_pool, &statistics);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, statistics.thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, 2, statistics.idle_thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, 2, statistics.peak_thread_count);
+    ASSERT_ARE_EQUAL(uint64_t, 2, statistics.started_thread_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.injected_thread_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.retired_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/* worker_pool_linux_worker_thread */
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_026: [ When there is no work item to run, the worker thread shall count itself as idle and park by calling wait_on_address on the work signal. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_061: [ If idle_timeout_ms is not 0, the worker thread shall park for at most idle_timeout_ms, otherwise it shall park with no timeout. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_031: [ worker_pool_linux_submit shall bump the work signal and, if any worker thread is idle, wake one of them by calling wake_by_address_single. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_025: [ For each work item, the worker thread shall call work_function with work_function_context. ]*/
+TEST_FUNCTION(worker_thread_parks_when_there_is_no_work_and_runs_the_work_item_submitted_while_parked)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 2);
+    work_item_to_submit_on_wait = &test_work_items[0];
+
+    setup_find_no_work_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 0, UINT32_MAX));
+    /*the submit is made from the parked worker thread itself, it finds the worker thread idle and wakes it*/
+    STRICT_EXPECTED_CALL(interlocked_exchange_pointer(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_decrement(IGNORED_ARG));
+    setup_run_from_lifo_slot_expected_calls(&test_work_items[0]);
+    setup_find_no_work_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    ///act
+    void* thread_result = captured_start_routines[0](captured_start_routine_args[0]);
+
+    ///assert
+    ASSERT_IS_NULL(thread_result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, test_work_item_run_count);
+    ASSERT_ARE_EQUAL(uint32_t, 1, started_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+static uint32_t low_priority_work_item_run_index;
+
+static void record_when_work_item_0_runs(WORKER_POOL_LINUX_WORK_ITEM* work_item)
+{
+    if (work_item == &test_work_items[0])
+    {
+        low_priority_work_item_run_index = test_work_item_run_count;
+    }
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_053: [ Every 31 work items, the worker thread shall look at the low priority queue before the normal priority work items. ]*/
+TEST_FUNCTION(worker_thread_runs_a_low_priority_work_item_every_31_work_items)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_worker_pool(1, 1);
+    test_work_items[0].priority = WORKER_POOL_LINUX_PRIORITY_LOW;
+    for (uint32_t i = 0; i <= 40; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[i]));
+    }
+    low_priority_work_item_run_index = 0;
+    test_on_work = record_when_work_item_0_runs;
+    umock_c_reset_all_calls();
+
+    ///act
+    worker_pool_linux_destroy(worker_pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(uint32_t, 41, test_work_item_run_count);
+    /*30 normal priority work items run before it, instead of all the 40 queued*/
+    ASSERT_ARE_EQUAL(uint32_t, 31, low_priority_work_item_run_index);
+}
+
+/*starts a second worker thread by submitting test_work_items[0], the worker threads are not run so the work item stays queued*/
+static void start_second_worker_thread(WORKER_POOL_LINUX_HANDLE worker_pool)
+{
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+    ASSERT_ARE_EQUAL(uint32_t, 2, started_thread_count);
+    umock_c_reset_all_calls();
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_061: [ If idle_timeout_ms is not 0, the worker thread shall park for at most idle_timeout_ms, otherwise it shall park with no timeout. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_062: [ When the park times out, the worker thread shall exit if more than min_thread_count worker threads are started, it is the most recently started worker thread, no stop was requested, the work signal did not change and the high priority, global and low priority queues are empty. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_063: [ When exiting after the park timed out, the worker thread shall count itself as retired and no longer as started. ]*/
+TEST_FUNCTION(worker_thread_retires_when_its_park_times_out)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_adaptive_worker_pool(1, 2, 1000, 0);
+    WORKER_POOL_LINUX_STATISTICS statistics;
+    start_second_worker_thread(worker_pool);
+    wait_on_address_timeout_count = 1;
+
+    setup_run_from_global_queue_expected_calls(&test_work_items[0]);
+    setup_park_times_out_expected_calls(1, 1000);
+    setup_retire_expected_calls();
+
+    ///act
+    void* thread_result = run_captured_thread(1);
+
+    ///assert
+    ASSERT_IS_NULL(thread_result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, test_work_item_run_count);
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_get_statistics(worker_pool, &statistics));
+    ASSERT_ARE_EQUAL(uint32_t, 1, statistics.thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, 2, statistics.peak_thread_count);
+    ASSERT_ARE_EQUAL(uint64_t, 2, statistics.started_thread_count);
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.retired_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_062: [ When the park times out, the worker thread shall exit if more than min_thread_count worker threads are started, it is the most recently started worker thread, no stop was requested, the work signal did not change and the high priority, global and low priority queues are empty. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_064: [ Otherwise the worker thread shall look for work again. ]*/
+TEST_FUNCTION(worker_thread_does_not_retire_when_only_min_thread_count_worker_threads_are_started)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_adaptive_worker_pool(1, 2, 1000, 0);
+    wait_on_address_timeout_count = 1;
+
+    setup_park_times_out_expected_calls(0, 1000);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_find_no_work_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    ///act
+    void* thread_result = run_captured_thread(0);
+
+    ///assert
+    ASSERT_IS_NULL(thread_result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_062: [ When the park times out, the worker thread shall exit if more than min_thread_count worker threads are started, it is the most recently started worker thread, no stop was requested, the work signal did not change and the high priority, global and low priority queues are empty. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_064: [ Otherwise the worker thread shall look for work again. ]*/
+TEST_FUNCTION(worker_thread_that_is_not_the_most_recently_started_does_not_retire)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_adaptive_worker_pool(1, 2, 1000, 0);
+    start_second_worker_thread(worker_pool);
+    wait_on_address_timeout_count = 1;
+
+    setup_run_from_global_queue_expected_calls(&test_work_items[0]);
+    setup_park_times_out_expected_calls(1, 1000);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_find_no_work_expected_calls(1);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0))
+        .SetReturn(1);
+
+    ///act
+    void* thread_result = run_captured_thread(0);
+
+    ///assert
+    ASSERT_IS_NULL(thread_result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, test_work_item_run_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_065: [ Before starting a worker thread in place of a worker thread that retired, the worker pool shall join the retired thread by calling pthread_join, so that its stack is released. ]*/
+TEST_FUNCTION(worker_pool_linux_submit_joins_the_retired_worker_thread_before_starting_a_new_one)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_adaptive_worker_pool(1, 2, 1000, 0);
+    start_second_worker_thread(worker_pool);
+    wait_on_address_timeout_count = 1;
+    (void)run_captured_thread(1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)2, NULL));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_increment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+
+    ///act
+    int result = worker_pool_linux_submit(worker_pool, &test_work_items[1]);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 3, started_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_071: [ worker_pool_linux_destroy shall join the worker threads that retired and were not joined yet by calling pthread_join. ]*/
+TEST_FUNCTION(worker_pool_linux_destroy_joins_the_retired_worker_threads)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_adaptive_worker_pool(1, 2, 1000, 0);
+    start_second_worker_thread(worker_pool);
+    wait_on_address_timeout_count = 1;
+    (void)run_captured_thread(1);
+    umock_c_reset_all_calls();
+
+    setup_stop_begin_expected_calls();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)1, NULL));
+    setup_worker_thread_exit_expected_calls(0);
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_join((pthread_t)2, NULL));
+    STRICT_EXPECTED_CALL(free(worker_pool));
+
+    ///act
+    worker_pool_linux_destroy(worker_pool);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* worker_pool_linux_controller_thread */
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_067: [ Until a stop is requested, the controller thread shall tick every 500 milliseconds by calling wait_on_address on the stop request. ]*/
+/*Tests_SRS_WORKER_POOL_LINUX_01_068: [ On every tick, if the oldest work item of the high priority queue, or of the global queue when the high priority queue is empty, is the same as on the previous tick, no stop was requested, no worker thread is idle and fewer than max_thread_count plus max_injected_thread_count worker threads are started, the controller thread shall start a new worker thread and count it as injected. ]*/
+TEST_FUNCTION(controller_thread_does_not_inject_a_worker_thread_when_no_work_item_is_queued)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_adaptive_worker_pool(1, 1, 0, 1);
+    WORKER_POOL_LINUX_STATISTICS statistics;
+    wait_on_address_timeout_count = 2;
+    wait_on_address_sets_address_after_timeouts = true;
+
+    setup_controller_tick_expected_calls();
+    setup_controller_tick_expected_calls();
+    setup_controller_exit_expected_calls();
+
+    ///act
+    void* thread_result = run_captured_thread(1);
+
+    ///assert
+    ASSERT_IS_NULL(thread_result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, started_thread_count);
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_get_statistics(worker_pool, &statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.injected_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_068: [ On every tick, if the oldest work item of the high priority queue, or of the global queue when the high priority queue is empty, is the same as on the previous tick, no stop was requested, no worker thread is idle and fewer than max_thread_count plus max_injected_thread_count worker threads are started, the controller thread shall start a new worker thread and count it as injected. ]*/
+TEST_FUNCTION(controller_thread_injects_worker_threads_up_to_max_injected_thread_count_while_the_oldest_work_item_does_not_move)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_adaptive_worker_pool(1, 1, 0, 1);
+    WORKER_POOL_LINUX_STATISTICS statistics;
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[1]));
+    umock_c_reset_all_calls();
+    wait_on_address_timeout_count = 3;
+    wait_on_address_sets_address_after_timeouts = true;
+
+    /*the first tick only records the oldest work item*/
+    setup_controller_tick_expected_calls();
+    setup_controller_tick_expected_calls();
+    setup_controller_starvation_check_expected_calls();
+    setup_start_thread_expected_calls();
+    /*max_thread_count plus max_injected_thread_count worker threads are started*/
+    setup_controller_tick_expected_calls();
+    setup_controller_starvation_check_expected_calls();
+    setup_controller_exit_expected_calls();
+
+    ///act
+    void* thread_result = run_captured_thread(1);
+
+    ///assert
+    ASSERT_IS_NULL(thread_result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 3, started_thread_count);
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_get_statistics(worker_pool, &statistics));
+    ASSERT_ARE_EQUAL(uint32_t, 2, statistics.thread_count);
+    ASSERT_ARE_EQUAL(uint32_t, 2, statistics.peak_thread_count);
+    ASSERT_ARE_EQUAL(uint64_t, 2, statistics.started_thread_count);
+    ASSERT_ARE_EQUAL(uint64_t, 1, statistics.injected_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+    ASSERT_ARE_EQUAL(uint32_t, 2, test_work_item_run_count);
+}
+
+/*Tests_SRS_WORKER_POOL_LINUX_01_069: [ If starting the worker thread fails, the controller thread shall try again on the next tick. ]*/
+TEST_FUNCTION(controller_thread_injects_the_worker_thread_on_the_next_tick_when_starting_it_fails)
+{
+    ///arrange
+    WORKER_POOL_LINUX_HANDLE worker_pool = create_adaptive_worker_pool(1, 1, 0, 1);
+    ASSERT_ARE_EQUAL(int, 0, worker_pool_linux_submit(worker_pool, &test_work_items[0]));
+    umock_c_reset_all_calls();
+    wait_on_address_timeout_count = 3;
+    wait_on_address_sets_address_after_timeouts = true;
+
+    setup_controller_tick_expected_calls();
+    setup_controller_tick_expected_calls();
+    setup_controller_starvation_check_expected_calls();
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(mock_pthread_attr_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_pthread_create(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(-1);
+    STRICT_EXPECTED_CALL(mock_pthread_attr_destroy(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    setup_controller_tick_expected_calls();
+    setup_controller_starvation_check_expected_calls();
+    setup_start_thread_expected_calls();
+    setup_controller_exit_expected_calls();
+
+    ///act
+    void* thread_result = run_captured_thread(1);
+
+    ///assert
+    ASSERT_IS_NULL(thread_result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 3, started_thread_count);
+
+    ///cleanup
+    worker_pool_linux_destroy(worker_pool);
+}
+
+END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -11,6 +11,7 @@
 
 #include "windows.h"
 #include "c_pal/execution_engine.h"
+#include "c_pal/io_admission.h"
 
 #include "umock_c/umock_c_prod.h"
 
@@ -22,12 +23,17 @@ extern "C" {
     {
         uint32_t min_thread_count;
         uint32_t max_thread_count;
+        uint32_t max_outstanding_io;
     } EXECUTION_ENGINE_PARAMETERS_WIN32;
 
 #define DEFAULT_MIN_THREAD_COUNT 4
 #define DEFAULT_MAX_THREAD_COUNT 0 // no max thread count
+#define DEFAULT_MAX_OUTSTANDING_IO 0 // no limit on the outstanding file I/Os
 
 MOCKABLE_FUNCTION(, PTP_POOL, execution_engine_win32_get_threadpool, EXECUTION_ENGINE_HANDLE, execution_engine);
+MOCKABLE_FUNCTION(, IO_ADMISSION_HANDLE, execution_engine_win32_get_io_admission, EXECUTION_ENGINE_HANDLE, execution_engine);
+MOCKABLE_FUNCTION(, PTP_POOL, execution_engine_win32_get_numa_node_threadpool, EXECUTION_ENGINE_HANDLE, execution_engine, uint32_t, numa_node);
+MOCKABLE_FUNCTION(, uint32_t, execution_engine_win32_get_min_thread_count, EXECUTION_ENGINE_HANDLE, execution_engine);
 
 #ifdef __cplusplus
 }
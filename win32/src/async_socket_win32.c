@@ -12,6 +12,8 @@
 #include "c_pal/async_socket.h"
 #include "c_pal/execution_engine.h"
 #include "c_pal/execution_engine_win32.h"
+#include "c_pal/io_context_pool.h"
+#include "c_pal/sysinfo.h"
 #include "c_pal/timer.h"
 
 #define ASYNC_SOCKET_WIN32_STATE_VALUES \
@@ -41,6 +43,7 @@ typedef struct ASYNC_SOCKET_TAG
     PTP_CLEANUP_GROUP tp_cleanup_group;
     PTP_IO tp_io;
     volatile LONG pending_api_calls;
+    IO_CONTEXT_POOL_HANDLE io_context_pool;
 } ASYNC_SOCKET;
 
 // send context
@@ -66,12 +69,18 @@ typedef union ASYNC_SOCKET_IO_CONTEXT_UNION_TAG
 typedef struct ASYNC_SOCKET_IO_CONTEXT_TAG
 {
     OVERLAPPED overlapped;
+    ASYNC_SOCKET_HANDLE async_socket; /*needed to return the context to the pool of the socket*/
     ASYNC_SOCKET_IO_TYPE io_type;
     uint32_t total_buffer_bytes;
     ASYNC_SOCKET_IO_CONTEXT_UNION io;
     WSABUF wsa_buffers[];
 } ASYNC_SOCKET_IO_CONTEXT;
 
+/*pooled contexts have room for this many WSABUF items, sends/receives with more buffers get a non-pooled context*/
+#define ASYNC_SOCKET_WIN32_POOLED_BUFFER_COUNT 4
+#define ASYNC_SOCKET_WIN32_IO_CONTEXT_SIZE (sizeof(ASYNC_SOCKET_IO_CONTEXT) + (sizeof(WSABUF) * ASYNC_SOCKET_WIN32_POOLED_BUFFER_COUNT))
+#define ASYNC_SOCKET_WIN32_IO_CONTEXT_POOL_SIZE 64
+
 static VOID WINAPI on_io_complete(PTP_CALLBACK_INSTANCE instance, PVOID context, PVOID overlapped, ULONG io_result, ULONG_PTR number_of_bytes_transferred, PTP_IO io)
 {
     if (overlapped == NULL)
@@ -192,8 +201,8 @@ static VOID WINAPI on_io_complete(PTP_CALLBACK_INSTANCE instance, PVOID context,
             LogLastError("CloseHandle failed");
         }
 
-        /* Codes_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall free the IO context. ]*/
-        free(io_context);
+        /* Codes_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall release the IO context to the I/O context pool of the socket by calling io_context_pool_release. ]*/
+        io_context_pool_release(io_context->async_socket->io_context_pool, io_context);
     }
 }
 
@@ -253,14 +262,32 @@ ASYNC_SOCKET_HANDLE async_socket_create(EXECUTION_ENGINE_HANDLE execution_engine
         }
         else
         {
-            /* Codes_SRS_ASYNC_SOCKET_WIN32_01_035: [ Otherwise, async_socket_open_async shall obtain the PTP_POOL from the execution engine passed to async_socket_create by calling execution_engine_win32_get_threadpool. ]*/
-            result->pool = execution_engine_win32_get_threadpool(execution_engine);
-            result->socket_handle = socket_handle;
+            /* Codes_SRS_ASYNC_SOCKET_WIN32_01_107: [ async_socket_create shall create a pool for the send and receive contexts by calling io_context_pool_create. ]*/
+            result->io_context_pool = io_context_pool_create(ASYNC_SOCKET_WIN32_IO_CONTEXT_SIZE, ASYNC_SOCKET_WIN32_IO_CONTEXT_POOL_SIZE);
+            if (result->io_context_pool == NULL)
+            {
+                /* Codes_SRS_ASYNC_SOCKET_WIN32_01_003: [ If any error occurs, async_socket_create shall fail and return NULL. ]*/
+                LogError("io_context_pool_create failed");
+            }
+            else
+            {
+                /* Codes_SRS_ASYNC_SOCKET_WIN32_01_035: [ Otherwise, async_socket_create shall obtain the PTP_POOL of the NUMA node of the calling thread by calling sysinfo_get_current_numa_node and execution_engine_win32_get_numa_node_threadpool with the execution engine passed to async_socket_create. ]*/
+                result->pool = execution_engine_win32_get_numa_node_threadpool(execution_engine, sysinfo_get_current_numa_node());
+                if (result->pool == NULL)
+                {
+                    /* Codes_SRS_ASYNC_SOCKET_WIN32_01_112: [ If execution_engine_win32_get_numa_node_threadpool fails, async_socket_create shall obtain the PTP_POOL by calling execution_engine_win32_get_threadpool. ]*/
+                    LogWarning("execution_engine_win32_get_numa_node_threadpool failed, using the execution engine threadpool");
+                    result->pool = execution_engine_win32_get_threadpool(execution_engine);
+                }
+                result->socket_handle = socket_handle;
+
+                (void)InterlockedExchange(&result->pending_api_calls, 0);
+                (void)InterlockedExchange(&result->state, (LONG)ASYNC_SOCKET_WIN32_STATE_CLOSED);
 
-            (void)InterlockedExchange(&result->pending_api_calls, 0);
-            (void)InterlockedExchange(&result->state, (LONG)ASYNC_SOCKET_WIN32_STATE_CLOSED);
+                goto all_ok;
+            }
 
-            goto all_ok;
+            free(result);
         }
     }
 
@@ -299,6 +326,9 @@ void async_socket_destroy(ASYNC_SOCKET_HANDLE async_socket)
         }
         while (1);
 
+        /* Codes_SRS_ASYNC_SOCKET_WIN32_01_108: [ async_socket_destroy shall destroy the I/O context pool by calling io_context_pool_destroy. ]*/
+        io_context_pool_destroy(async_socket->io_context_pool);
+
         /* Codes_SRS_ASYNC_SOCKET_WIN32_01_005: [ Otherwise, async_socket_destroy shall free all resources associated with async_socket. ]*/
         free(async_socket);
     }
@@ -485,17 +515,18 @@ ASYNC_SOCKET_SEND_SYNC_RESULT async_socket_send_async(ASYNC_SOCKET_HANDLE async_
                 }
                 else
                 {
-                    /* Codes_SRS_ASYNC_SOCKET_WIN32_01_028: [ Otherwise async_socket_send_async shall create a context for the send where the payload, on_send_complete and on_send_complete_context shall be stored. ]*/
+                    /* Codes_SRS_ASYNC_SOCKET_WIN32_01_028: [ Otherwise async_socket_send_async shall get a context for the send from the I/O context pool by calling io_context_pool_get, where the payload, on_send_complete and on_send_complete_context shall be stored. ]*/
                     /* Codes_SRS_ASYNC_SOCKET_WIN32_01_050: [ The context shall also allocate enough memory to keep an array of buffer_count WSABUF items. ]*/
-                    ASYNC_SOCKET_IO_CONTEXT* send_context = malloc(sizeof(ASYNC_SOCKET_IO_CONTEXT) + (sizeof(WSABUF) * buffer_count));
+                    ASYNC_SOCKET_IO_CONTEXT* send_context = io_context_pool_get(async_socket->io_context_pool, sizeof(ASYNC_SOCKET_IO_CONTEXT) + (sizeof(WSABUF) * buffer_count));
                     if (send_context == NULL)
                     {
                         /* Codes_SRS_ASYNC_SOCKET_WIN32_01_029: [ If any error occurs, async_socket_send_async shall fail and return ASYNC_SOCKET_SEND_SYNC_ERROR. ]*/
-                        LogError("malloc failed");
+                        LogError("io_context_pool_get failed");
                         result = ASYNC_SOCKET_SEND_SYNC_ERROR;
                     }
                     else
                     {
+                        send_context->async_socket = async_socket;
                         send_context->total_buffer_bytes = total_buffer_bytes;
 
                         /* Codes_SRS_ASYNC_SOCKET_WIN32_01_056: [ async_socket_send_async shall set the WSABUF items to point to the memory/length of the buffers in payload. ]*/
@@ -608,7 +639,7 @@ ASYNC_SOCKET_SEND_SYNC_RESULT async_socket_send_async(ASYNC_SOCKET_HANDLE async_
                             }
                         }
 
-                        free(send_context);
+                        io_context_pool_release(async_socket->io_context_pool, send_context);
                     }
                 }
 
@@ -699,17 +730,18 @@ int async_socket_receive_async(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_BU
                 }
                 else
                 {
-                    /* Codes_SRS_ASYNC_SOCKET_WIN32_01_077: [ Otherwise async_socket_receive_async shall create a context for the send where the payload, on_receive_complete and on_receive_complete_context shall be stored. ]*/
+                    /* Codes_SRS_ASYNC_SOCKET_WIN32_01_077: [ Otherwise async_socket_receive_async shall get a context for the receive from the I/O context pool by calling io_context_pool_get, where the payload, on_receive_complete and on_receive_complete_context shall be stored. ]*/
                     /* Codes_SRS_ASYNC_SOCKET_WIN32_01_078: [ The context shall also allocate enough memory to keep an array of buffer_count WSABUF items. ]*/
-                    ASYNC_SOCKET_IO_CONTEXT* receive_context = malloc(sizeof(ASYNC_SOCKET_IO_CONTEXT) + (sizeof(WSABUF) * buffer_count));
+                    ASYNC_SOCKET_IO_CONTEXT* receive_context = io_context_pool_get(async_socket->io_context_pool, sizeof(ASYNC_SOCKET_IO_CONTEXT) + (sizeof(WSABUF) * buffer_count));
                     if (receive_context == NULL)
                     {
                         /* Codes_SRS_ASYNC_SOCKET_WIN32_01_084: [ If any error occurs, async_socket_receive_async shall fail and return a non-zero value. ]*/
-                        LogError("malloc failed");
+                        LogError("io_context_pool_get failed");
                         result = MU_FAILURE;
                     }
                     else
                     {
+                        receive_context->async_socket = async_socket;
                         receive_context->total_buffer_bytes = total_buffer_bytes;
 
                         /* Codes_SRS_ASYNC_SOCKET_WIN32_01_079: [ async_socket_receive_async shall set the WSABUF items to point to the memory/length of the buffers in payload. ]*/
@@ -785,7 +817,7 @@ int async_socket_receive_async(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_BU
                             }
                         }
 
-                        free(receive_context);
+                        io_context_pool_release(async_socket->io_context_pool, receive_context);
                     }
                 }
 
@@ -798,3 +830,36 @@ int async_socket_receive_async(ASYNC_SOCKET_HANDLE async_socket, ASYNC_SOCKET_BU
 all_ok:
     return result;
 }
+
+int async_socket_get_io_context_pool_statistics(ASYNC_SOCKET_HANDLE async_socket, IO_CONTEXT_POOL_STATISTICS* statistics)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_ASYNC_SOCKET_01_051: [ If async_socket is NULL, async_socket_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+        (async_socket == NULL) ||
+        /* Codes_SRS_ASYNC_SOCKET_01_052: [ If statistics is NULL, async_socket_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments: ASYNC_SOCKET_HANDLE async_socket=%p, IO_CONTEXT_POOL_STATISTICS* statistics=%p", async_socket, statistics);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_ASYNC_SOCKET_WIN32_01_109: [ async_socket_get_io_context_pool_statistics shall obtain the counters of the I/O context pool by calling io_context_pool_get_statistics. ]*/
+        if (io_context_pool_get_statistics(async_socket->io_context_pool, statistics) != 0)
+        {
+            /* Codes_SRS_ASYNC_SOCKET_WIN32_01_110: [ If io_context_pool_get_statistics fails, async_socket_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+            LogError("io_context_pool_get_statistics failed");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_ASYNC_SOCKET_WIN32_01_111: [ Otherwise async_socket_get_io_context_pool_statistics shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+
+    return result;
+}
@@ -5,17 +5,194 @@
 #include "macro_utils/macro_utils.h"
 #include "c_pal/refcount.h"
 #include "c_logging/xlogging.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/sync.h"
+#include "c_pal/call_once.h"
+#include "c_pal/lazy_init.h"
+#include "c_pal/sysinfo.h"
+#include "c_pal/io_admission.h"
 #include "c_pal/execution_engine.h"
 #include "c_pal/execution_engine_win32.h"
 
+typedef struct NUMA_NODE_THREADPOOL_TAG
+{
+    struct EXECUTION_ENGINE_TAG* execution_engine;
+    uint32_t numa_node;
+    call_once_t ptp_pool_init;
+    PTP_POOL ptp_pool;
+} NUMA_NODE_THREADPOOL;
 
 typedef struct EXECUTION_ENGINE_TAG
 {
     PTP_POOL ptp_pool;
+    IO_ADMISSION_HANDLE io_admission;
+    uint32_t min_thread_count;
+    uint32_t max_thread_count;
+    uint32_t numa_node_count;
+    NUMA_NODE_THREADPOOL numa_node_threadpools[]; /*numa_node_count entries, none on hosts with a single NUMA node*/
 }EXECUTION_ENGINE;
 
+typedef struct PIN_THREADS_CONTEXT_TAG
+{
+    GROUP_AFFINITY group_affinity;
+    volatile_atomic int32_t threads_to_pin;
+} PIN_THREADS_CONTEXT;
+
 DEFINE_REFCOUNT_TYPE(EXECUTION_ENGINE);
 
+static uint32_t divide_round_up(uint32_t value, uint32_t divisor)
+{
+    return (value / divisor) + (((value % divisor) == 0) ? 0 : 1);
+}
+
+static uint32_t count_processors(KAFFINITY mask)
+{
+    uint32_t result = 0;
+    while (mask != 0)
+    {
+        mask &= mask - 1;
+        result++;
+    }
+    return result;
+}
+
+static VOID NTAPI on_pin_thread_to_numa_node(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WORK work)
+{
+    (void)instance;
+    (void)work;
+
+    PIN_THREADS_CONTEXT* pin_threads_context = context;
+
+    /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_032: [ on_pin_thread_to_numa_node shall restrict the calling thread to the processors of the node by calling SetThreadGroupAffinity. ]*/
+    if (!SetThreadGroupAffinity(GetCurrentThread(), &pin_threads_context->group_affinity, NULL))
+    {
+        LogLastError("SetThreadGroupAffinity(Group=%" PRIu16 ", Mask=%" PRIx64 ") failed", (uint16_t)pin_threads_context->group_affinity.Group, (uint64_t)pin_threads_context->group_affinity.Mask);
+    }
+
+    /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_033: [ on_pin_thread_to_numa_node shall decrement the number of threads left to pin and, if it reaches 0, wake the other threads by calling wake_by_address_all. ]*/
+    int32_t threads_to_pin = interlocked_decrement(&pin_threads_context->threads_to_pin);
+    if (threads_to_pin == 0)
+    {
+        wake_by_address_all(&pin_threads_context->threads_to_pin);
+    }
+    else
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_034: [ Otherwise on_pin_thread_to_numa_node shall wait by calling wait_on_address until all the threads of the pool are pinned, so that each callback pins a different thread. ]*/
+        do
+        {
+            (void)wait_on_address(&pin_threads_context->threads_to_pin, threads_to_pin, UINT32_MAX);
+            threads_to_pin = interlocked_add(&pin_threads_context->threads_to_pin, 0);
+        } while (threads_to_pin != 0);
+    }
+}
+
+static int pin_threads_to_numa_node(PTP_POOL ptp_pool, const GROUP_AFFINITY* group_affinity, uint32_t thread_count)
+{
+    int result;
+    TP_CALLBACK_ENVIRON tp_environment;
+    PIN_THREADS_CONTEXT pin_threads_context;
+
+    pin_threads_context.group_affinity = *group_affinity;
+    (void)interlocked_exchange(&pin_threads_context.threads_to_pin, (int32_t)thread_count);
+
+    InitializeThreadpoolEnvironment(&tp_environment);
+    SetThreadpoolCallbackPool(&tp_environment, ptp_pool);
+
+    /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_031: [ The first call for a node shall pin every thread of the pool to the processors of the node by calling CreateThreadpoolWork with on_pin_thread_to_numa_node, submitting the work item once per thread with SubmitThreadpoolWork and waiting for all the callbacks with WaitForThreadpoolWorkCallbacks. ]*/
+    PTP_WORK work = CreateThreadpoolWork(on_pin_thread_to_numa_node, &pin_threads_context, &tp_environment);
+    if (work == NULL)
+    {
+        LogLastError("CreateThreadpoolWork failed");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        for (uint32_t i = 0; i < thread_count; i++)
+        {
+            SubmitThreadpoolWork(work);
+        }
+
+        WaitForThreadpoolWorkCallbacks(work, FALSE);
+        CloseThreadpoolWork(work);
+
+        result = 0;
+    }
+
+    DestroyThreadpoolEnvironment(&tp_environment);
+
+    return result;
+}
+
+static int create_numa_node_threadpool(void* params)
+{
+    int result;
+    NUMA_NODE_THREADPOOL* numa_node_threadpool = params;
+    EXECUTION_ENGINE* execution_engine = numa_node_threadpool->execution_engine;
+    GROUP_AFFINITY group_affinity;
+
+    /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_027: [ The first call for a node shall obtain the processors of the node by calling GetNumaNodeProcessorMaskEx. ]*/
+    if (!GetNumaNodeProcessorMaskEx((USHORT)numa_node_threadpool->numa_node, &group_affinity))
+    {
+        LogLastError("GetNumaNodeProcessorMaskEx(%" PRIu32 ") failed", numa_node_threadpool->numa_node);
+        result = MU_FAILURE;
+    }
+    else if (group_affinity.Mask == 0)
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_028: [ If the node has no processors, the threadpool created in execution_engine_create shall be used for the node. ]*/
+        LogWarning("NUMA node %" PRIu32 " has no processors, using the threadpool of the execution engine", numa_node_threadpool->numa_node);
+        numa_node_threadpool->ptp_pool = execution_engine->ptp_pool;
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_029: [ The number of threads of the node shall be max_thread_count divided by the number of nodes, rounded up, or if max_thread_count is 0 the greater of min_thread_count divided by the number of nodes, rounded up, and the number of processors of the node. ]*/
+        uint32_t thread_count;
+        if (execution_engine->max_thread_count != 0)
+        {
+            thread_count = divide_round_up(execution_engine->max_thread_count, execution_engine->numa_node_count);
+        }
+        else
+        {
+            uint32_t min_thread_count = divide_round_up(execution_engine->min_thread_count, execution_engine->numa_node_count);
+            uint32_t processor_count = count_processors(group_affinity.Mask);
+            thread_count = (min_thread_count > processor_count) ? min_thread_count : processor_count;
+        }
+
+        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_030: [ The first call for a node shall create the threadpool of the node by calling CreateThreadpool and set both its maximum and its minimum number of threads to the number of threads of the node. ]*/
+        numa_node_threadpool->ptp_pool = CreateThreadpool(NULL);
+        if (numa_node_threadpool->ptp_pool == NULL)
+        {
+            LogLastError("CreateThreadpool failed for NUMA node %" PRIu32, numa_node_threadpool->numa_node);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            SetThreadpoolThreadMaximum(numa_node_threadpool->ptp_pool, thread_count);
+            if (!SetThreadpoolThreadMinimum(numa_node_threadpool->ptp_pool, thread_count))
+            {
+                LogLastError("SetThreadpoolThreadMinimum(%" PRIu32 ") failed for NUMA node %" PRIu32, thread_count, numa_node_threadpool->numa_node);
+                result = MU_FAILURE;
+            }
+            else if (pin_threads_to_numa_node(numa_node_threadpool->ptp_pool, &group_affinity, thread_count) != 0)
+            {
+                LogError("pin_threads_to_numa_node failed for NUMA node %" PRIu32, numa_node_threadpool->numa_node);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                result = 0;
+                goto all_ok;
+            }
+
+            CloseThreadpool(numa_node_threadpool->ptp_pool);
+            numa_node_threadpool->ptp_pool = NULL;
+        }
+    }
+
+all_ok:
+    return result;
+}
+
 EXECUTION_ENGINE_HANDLE execution_engine_create(void* execution_engine_parameters)
 {
     EXECUTION_ENGINE_HANDLE result;
@@ -23,9 +200,10 @@ EXECUTION_ENGINE_HANDLE execution_engine_create(void* execution_engine_parameter
 
     if (execution_engine_parameters == NULL)
     {
-        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_011: [ If execution_engine_parameters is NULL, execution_engine_create shall use the defaults DEFAULT_MIN_THREAD_COUNT and DEFAULT_MAX_THREAD_COUNT as parameters. ]*/
+        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_011: [ If execution_engine_parameters is NULL, execution_engine_create shall use the defaults DEFAULT_MIN_THREAD_COUNT, DEFAULT_MAX_THREAD_COUNT and DEFAULT_MAX_OUTSTANDING_IO as parameters. ]*/
         parameters_to_use.min_thread_count = DEFAULT_MIN_THREAD_COUNT;
         parameters_to_use.max_thread_count = DEFAULT_MAX_THREAD_COUNT;
+        parameters_to_use.max_outstanding_io = DEFAULT_MAX_OUTSTANDING_IO;
     }
     else
     {
@@ -34,11 +212,13 @@ EXECUTION_ENGINE_HANDLE execution_engine_create(void* execution_engine_parameter
 
         parameters_to_use.min_thread_count = execution_engine_parameters_win32->min_thread_count;
         parameters_to_use.max_thread_count = execution_engine_parameters_win32->max_thread_count;
+        parameters_to_use.max_outstanding_io = execution_engine_parameters_win32->max_outstanding_io;
     }
 
     PTP_POOL ptp_pool;
 
-    LogInfo("Creating execution engine with min thread count=%" PRIu32 ", max thread count=%" PRIu32 "", parameters_to_use.min_thread_count, parameters_to_use.max_thread_count);
+    LogInfo("Creating execution engine with min thread count=%" PRIu32 ", max thread count=%" PRIu32 ", max outstanding io=%" PRIu32 "",
+        parameters_to_use.min_thread_count, parameters_to_use.max_thread_count, parameters_to_use.max_outstanding_io);
 
     /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_013: [ If max_thread_count is non-zero, but less than min_thread_count, execution_engine_create shall fail and return NULL. ]*/
     if ((parameters_to_use.max_thread_count != 0) &&
@@ -75,8 +255,12 @@ EXECUTION_ENGINE_HANDLE execution_engine_create(void* execution_engine_parameter
 
 
 
+                /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_019: [ execution_engine_create shall obtain the number of NUMA nodes of the host by calling sysinfo_get_numa_node_count. ]*/
+                uint32_t numa_node_count = sysinfo_get_numa_node_count();
+
                 /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_001: [ execution_engine_create shall allocate a new execution engine and on success shall return a non-NULL handle. ]*/
-                result = REFCOUNT_TYPE_CREATE(EXECUTION_ENGINE);
+                /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_020: [ If there is more than one NUMA node, execution_engine_create shall allocate a NUMA node threadpool for each node. ]*/
+                result = REFCOUNT_TYPE_CREATE_WITH_EXTRA_SIZE(EXECUTION_ENGINE, (numa_node_count > 1) ? (size_t)numa_node_count * sizeof(NUMA_NODE_THREADPOOL) : 0);
                 if (result == NULL)
                 {
                     /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_006: [ If any error occurs, execution_engine_create shall fail and return NULL. ]*/
@@ -84,9 +268,48 @@ EXECUTION_ENGINE_HANDLE execution_engine_create(void* execution_engine_parameter
                 }
                 else
                 {
-                    /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_001: [ execution_engine_create shall allocate a new execution engine and on success shall return a non-NULL handle. ]*/
                     result->ptp_pool = ptp_pool;
-                    goto all_ok;
+                    result->min_thread_count = parameters_to_use.min_thread_count;
+                    result->max_thread_count = parameters_to_use.max_thread_count;
+                    result->numa_node_count = numa_node_count;
+
+                    if (numa_node_count > 1)
+                    {
+                        for (uint32_t i = 0; i < numa_node_count; i++)
+                        {
+                            /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_021: [ execution_engine_create shall not create the threadpools of the NUMA nodes, they are created on first use. ]*/
+                            result->numa_node_threadpools[i].execution_engine = result;
+                            result->numa_node_threadpools[i].numa_node = i;
+                            (void)interlocked_exchange(&result->numa_node_threadpools[i].ptp_pool_init, LAZY_INIT_NOT_DONE);
+                            result->numa_node_threadpools[i].ptp_pool = NULL;
+                        }
+                    }
+
+                    if (parameters_to_use.max_outstanding_io == 0)
+                    {
+                        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_015: [ If max_outstanding_io is 0, execution_engine_create shall not limit the number of outstanding file I/Os. ]*/
+                        result->io_admission = NULL;
+
+                        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_001: [ execution_engine_create shall allocate a new execution engine and on success shall return a non-NULL handle. ]*/
+                        goto all_ok;
+                    }
+                    else
+                    {
+                        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_014: [ If max_outstanding_io is not 0, execution_engine_create shall create an admission bounding the outstanding file I/Os of the execution engine by calling io_admission_create with max_outstanding_io. ]*/
+                        result->io_admission = io_admission_create(parameters_to_use.max_outstanding_io);
+                        if (result->io_admission == NULL)
+                        {
+                            /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_006: [ If any error occurs, execution_engine_create shall fail and return NULL. ]*/
+                            LogError("io_admission_create(max_outstanding_io=%" PRIu32 ") failed", parameters_to_use.max_outstanding_io);
+                        }
+                        else
+                        {
+                            /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_001: [ execution_engine_create shall allocate a new execution engine and on success shall return a non-NULL handle. ]*/
+                            goto all_ok;
+                        }
+                    }
+
+                    REFCOUNT_TYPE_DESTROY(EXECUTION_ENGINE, result);
                 }
                 
             }
@@ -113,8 +336,25 @@ void execution_engine_dec_ref(EXECUTION_ENGINE_HANDLE execution_engine)
         /* Codes_SRS_EXECUTION_ENGINE_WIN32_03_001: [ Otherwise execution_engine_dec_ref shall decrement the refcount.]*/
         if (DEC_REF(EXECUTION_ENGINE, execution_engine) == 0)
         {
+            if (execution_engine->numa_node_count > 1)
+            {
+                for (uint32_t i = 0; i < execution_engine->numa_node_count; i++)
+                {
+                    /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_022: [ If the refcount is zero execution_engine_dec_ref shall close the threadpools of the NUMA nodes that were created. ]*/
+                    if ((execution_engine->numa_node_threadpools[i].ptp_pool != NULL) &&
+                        (execution_engine->numa_node_threadpools[i].ptp_pool != execution_engine->ptp_pool))
+                    {
+                        CloseThreadpool(execution_engine->numa_node_threadpools[i].ptp_pool);
+                    }
+                }
+            }
             /* Codes_SRS_EXECUTION_ENGINE_WIN32_03_002: [ If the refcount is zero execution_engine_dec_ref shall close the threadpool. ]*/
             CloseThreadpool(execution_engine->ptp_pool);
+            /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_016: [ If the refcount is zero execution_engine_dec_ref shall destroy the admission if it was created. ]*/
+            if (execution_engine->io_admission != NULL)
+            {
+                io_admission_destroy(execution_engine->io_admission);
+            }
             REFCOUNT_TYPE_DESTROY(EXECUTION_ENGINE, execution_engine);
         }
     }
@@ -152,3 +392,82 @@ PTP_POOL execution_engine_win32_get_threadpool(EXECUTION_ENGINE_HANDLE execution
 
     return result;
 }
+
+IO_ADMISSION_HANDLE execution_engine_win32_get_io_admission(EXECUTION_ENGINE_HANDLE execution_engine)
+{
+    IO_ADMISSION_HANDLE result;
+
+    if (execution_engine == NULL)
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_017: [ If execution_engine is NULL, execution_engine_win32_get_io_admission shall fail and return NULL. ]*/
+        LogError("Invalid arguments: EXECUTION_ENGINE_HANDLE execution_engine=%p", execution_engine);
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_018: [ Otherwise, execution_engine_win32_get_io_admission shall return the admission created in execution_engine_create, or NULL if max_outstanding_io was 0. ]*/
+        result = execution_engine->io_admission;
+    }
+
+    return result;
+}
+
+PTP_POOL execution_engine_win32_get_numa_node_threadpool(EXECUTION_ENGINE_HANDLE execution_engine, uint32_t numa_node)
+{
+    PTP_POOL result;
+
+    if (
+        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_023: [ If execution_engine is NULL, execution_engine_win32_get_numa_node_threadpool shall fail and return NULL. ]*/
+        (execution_engine == NULL) ||
+        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_024: [ If numa_node is greater than or equal to the number of NUMA nodes, execution_engine_win32_get_numa_node_threadpool shall fail and return NULL. ]*/
+        (numa_node >= execution_engine->numa_node_count)
+        )
+    {
+        LogError("Invalid arguments: EXECUTION_ENGINE_HANDLE execution_engine=%p, uint32_t numa_node=%" PRIu32 ", numa_node_count=%" PRIu32,
+            execution_engine, numa_node, (execution_engine == NULL) ? 0 : execution_engine->numa_node_count);
+        result = NULL;
+    }
+    else if (execution_engine->numa_node_count == 1)
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_025: [ If there is only one NUMA node, execution_engine_win32_get_numa_node_threadpool shall return the threadpool created in execution_engine_create. ]*/
+        result = execution_engine->ptp_pool;
+    }
+    else
+    {
+        NUMA_NODE_THREADPOOL* numa_node_threadpool = &execution_engine->numa_node_threadpools[numa_node];
+
+        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_026: [ Otherwise execution_engine_win32_get_numa_node_threadpool shall call lazy_init to create the threadpool of the node only once. ]*/
+        if (lazy_init(&numa_node_threadpool->ptp_pool_init, create_numa_node_threadpool, numa_node_threadpool) != LAZY_INIT_OK)
+        {
+            /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_035: [ If lazy_init fails, execution_engine_win32_get_numa_node_threadpool shall fail and return NULL. ]*/
+            LogError("lazy_init failed for NUMA node %" PRIu32, numa_node);
+            result = NULL;
+        }
+        else
+        {
+            /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_036: [ Otherwise execution_engine_win32_get_numa_node_threadpool shall return the threadpool of the node. ]*/
+            result = numa_node_threadpool->ptp_pool;
+        }
+    }
+
+    return result;
+}
+
+uint32_t execution_engine_win32_get_min_thread_count(EXECUTION_ENGINE_HANDLE execution_engine)
+{
+    uint32_t result;
+
+    if (execution_engine == NULL)
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_037: [ If execution_engine is NULL, execution_engine_win32_get_min_thread_count shall return 0. ]*/
+        LogError("Invalid arguments: EXECUTION_ENGINE_HANDLE execution_engine=%p", execution_engine);
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_EXECUTION_ENGINE_WIN32_01_038: [ Otherwise, execution_engine_win32_get_min_thread_count shall return the min_thread_count used in execution_engine_create. ]*/
+        result = execution_engine->min_thread_count;
+    }
+
+    return result;
+}
@@ -6,13 +6,44 @@
 #include <string.h>
 
 #include "windows.h"
+#include "winioctl.h"
 
 #include "c_logging/xlogging.h"
 #include "c_pal/execution_engine_win32.h"
 #include "c_pal/gballoc_hl.h"
 #include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/interlocked.h"
+#include "c_pal/io_context_pool.h"
+#include "c_pal/sync.h"
+#include "c_pal/sysinfo.h"
+#include "c_pal/write_aggregator.h"
+#include "c_pal/read_ahead.h"
+#include "c_pal/io_admission.h"
 #include "c_pal/file.h"
 
+MU_DEFINE_ENUM_STRINGS(FILE_ACCESS_HINT, FILE_ACCESS_HINT_VALUES)
+MU_DEFINE_ENUM_STRINGS(FILE_IO_LIMIT_MODE, FILE_IO_LIMIT_MODE_VALUES)
+MU_DEFINE_ENUM_STRINGS(FILE_IO_PRIORITY, FILE_IO_PRIORITY_VALUES)
+
+typedef struct FILE_WIN32_VECTORED_IO_TAG FILE_WIN32_VECTORED_IO;
+
+typedef struct FILE_WIN32_IO_TAG
+{
+    OVERLAPPED ov;
+    FILE_HANDLE handle;
+    FILE_CB user_callback;
+    void* user_context;
+    uint32_t size;
+    FILE_WIN32_VECTORED_IO* vectored_io; /*NULL for file_write_async/file_read_async*/
+    WRITE_AGGREGATOR_IO* aggregated_io; /*NULL unless the operation is an aggregated write*/
+    READ_AHEAD_IO* read_ahead_io; /*NULL unless the operation is a read-ahead block read*/
+    /*file_write_async/file_read_async and batched I/Os only: an I/O queued for a slot is issued later, from the completion of another I/O*/
+    void* buffer;
+    bool is_write; /*also set for vectored parts and batched I/Os, the read-ahead blocks of a written range are dropped again when the write completes*/
+    bool is_admitted; /*the I/O holds a slot of the I/O limits of the file handle and of the execution engine*/
+    IO_ADMISSION_WAITER admission_waiter; /*used while the I/O is queued for a slot*/
+}FILE_WIN32_IO;
+
 typedef struct FILE_HANDLE_DATA_TAG
 {
     EXECUTION_ENGINE_HANDLE execution_engine;
@@ -21,19 +52,156 @@ typedef struct FILE_HANDLE_DATA_TAG
     TP_CALLBACK_ENVIRON cbe;
     PTP_CLEANUP_GROUP ptp_cleanup_group; /*the cleanup group of IO operations*/
     PTP_IO ptp_io;
+    IO_CONTEXT_POOL_HANDLE io_context_pool;
     FILE_REPORT_FAULT user_report_fault_callback;
     void* user_report_fault_context;
-    
+    void* volatile_atomic flush_requests; /*FILE_WIN32_FLUSH_REQUEST list waiting for the next flush, most recent first*/
+    volatile_atomic int32_t flush_in_progress;
+    volatile_atomic int32_t pending_flush_count;
+    struct FILE_WIN32_FLUSH_REQUEST_TAG* flushing_requests; /*requests served by the flush in progress*/
+    FILE_WIN32_IO flush_io; /*holds the slots of the I/O limits of the flush in progress*/
+    /*preallocation: storage is reserved with FileAllocationInfo ahead of the writes, one reservation at a time*/
+    uint64_t preallocation_chunk_size; /*0 if no policy was set, only written by file_set_preallocation before any write*/
+    volatile_atomic int64_t highest_write_end; /*end of the furthest write started*/
+    volatile_atomic int64_t preallocated_end; /*storage is reserved up to this offset*/
+    volatile_atomic int64_t preallocation_target; /*equal to preallocated_end unless a reservation is in progress*/
+    volatile_atomic int32_t preallocation_in_progress;
+    /*write aggregation: small sequential writes are merged by a write_aggregator and written with one WriteFile*/
+    WRITE_AGGREGATOR_HANDLE write_aggregator; /*NULL if no policy was set, only written by file_set_write_aggregation before any write*/
+    PTP_TIMER aggregation_timer; /*re-armed for every block opened by the write aggregator*/
+    volatile_atomic int64_t aggregation_timer_id; /*timer id of the block the timer was last armed for*/
+    /*read-ahead: blocks following sequential reads are read with ReadFile before the user asks for them*/
+    READ_AHEAD_HANDLE read_ahead; /*NULL if no policy was set, only written by file_set_read_ahead before any I/O*/
+    volatile_atomic int32_t pending_copied_read_count; /*reads served from a block whose user callback was not called yet*/
+    /*I/O limit: every I/O sent to the device holds a slot of the admission of the file handle and of the execution engine until it completes*/
+    IO_ADMISSION_HANDLE io_admission; /*NULL if the file handle has no limit, only written by file_set_io_limit before any I/O*/
+    IO_ADMISSION_HANDLE engine_io_admission; /*NULL if the execution engine has no limit*/
+    FILE_IO_LIMIT_MODE io_limit_mode;
+    bool is_io_limit_set;
+    volatile_atomic int32_t pending_queued_io_count; /*I/Os waiting for a slot, they are not known to the threadpool I/O yet*/
+    IO_ADMISSION_PRIORITY admission_priority; /*priority of the I/Os of the handle that wait for a slot, only written by file_set_io_priority before any I/O*/
+    volatile_atomic int32_t pending_copy_count; /*file_copy_range_async copies from or to the file handle whose user callback was not called yet*/
 }FILE_HANDLE_DATA;
 
-typedef struct FILE_WIN32_IO_TAG
+/*file_flush_async requests are queued and all the requests queued when a flush starts are served by that one FlushFileBuffers call*/
+typedef struct FILE_WIN32_FLUSH_REQUEST_TAG
+{
+    struct FILE_WIN32_FLUSH_REQUEST_TAG* next;
+    FILE_CB user_callback;
+    void* user_context;
+}FILE_WIN32_FLUSH_REQUEST;
+
+/*a vectored operation is issued as one WriteFile/ReadFile per buffer at consecutive offsets, the user callback is called when the last one completes*/
+/*the first part holds the slots of the I/O limits for the whole operation*/
+struct FILE_WIN32_VECTORED_IO_TAG
 {
-    OVERLAPPED ov;
     FILE_HANDLE handle;
+    uint32_t part_count;
+    volatile_atomic int32_t pending_count;
+    volatile_atomic int32_t failed;
     FILE_CB user_callback;
     void* user_context;
-    uint32_t size;
-}FILE_WIN32_IO;
+    FILE_WIN32_IO parts[];
+};
+
+/*contexts of I/Os with up to FILE_WIN32_POOLED_BUFFER_COUNT buffers come from the pool of the file handle, bigger ones are allocated*/
+#define FILE_WIN32_POOLED_BUFFER_COUNT 4
+#define FILE_WIN32_IO_CONTEXT_SIZE (sizeof(FILE_WIN32_VECTORED_IO) + FILE_WIN32_POOLED_BUFFER_COUNT * sizeof(FILE_WIN32_IO))
+#define FILE_WIN32_IO_CONTEXT_POOL_SIZE 64
+
+/*file_copy_range_async runs on the threadpool of the destination: the extents are shared with FSCTL_DUPLICATE_EXTENTS_TO_FILE when the file system
+supports it, otherwise the data is read and written chunk by chunk through a buffer of the copy*/
+#define FILE_WIN32_COPY_CHUNK_SIZE (1024 * 1024)
+
+typedef struct FILE_WIN32_COPY_TAG
+{
+    FILE_HANDLE source;
+    FILE_HANDLE destination;
+    uint64_t source_position;
+    uint64_t destination_position;
+    uint64_t size;
+    FILE_CB user_callback;
+    void* user_context;
+}FILE_WIN32_COPY;
+
+typedef struct FILE_WIN32_BATCH_ENTRY_TAG
+{
+    FILE_WIN32_IO* io;
+}FILE_WIN32_BATCH_ENTRY;
+
+typedef struct FILE_MAPPED_REGION_TAG
+{
+    HANDLE h_mapping;
+    void* view; /*as returned by MapViewOfFile, aligned to the allocation granularity*/
+    const unsigned char* data; /*the byte at the position requested by the user*/
+}FILE_MAPPED_REGION;
+
+typedef struct FILE_BATCH_TAG
+{
+    FILE_HANDLE handle;
+    uint32_t max_io_count;
+    uint32_t io_count;
+    FILE_WIN32_BATCH_ENTRY entries[];
+}FILE_BATCH;
+
+#define FILE_WIN32_START_IO_RESULT_VALUES \
+    FILE_WIN32_START_IO_OK, \
+    FILE_WIN32_START_IO_BUSY, \
+    FILE_WIN32_START_IO_ISSUE_ERROR, \
+    FILE_WIN32_START_IO_ERROR
+MU_DEFINE_ENUM(FILE_WIN32_START_IO_RESULT, FILE_WIN32_START_IO_RESULT_VALUES);
+
+static FILE_WIN32_START_IO_RESULT start_io(FILE_HANDLE handle, FILE_WIN32_IO* io_context, FILE_IO_LIMIT_MODE io_limit_mode);
+
+static void release_io_slots(FILE_HANDLE handle)
+{
+    /*Codes_SRS_FILE_WIN32_01_153: [ release_io_slots shall call io_admission_release on the admission of the execution engine and then on the admission of the file handle, for the ones that exist. ]*/
+    if (handle->engine_io_admission != NULL)
+    {
+        io_admission_release(handle->engine_io_admission);
+    }
+    if (handle->io_admission != NULL)
+    {
+        io_admission_release(handle->io_admission);
+    }
+}
+
+/*a block read ahead while a write was in flight can hold the data from before the write, so the written range is dropped again once the write completed*/
+static void invalidate_read_ahead_of_write(FILE_HANDLE handle, uint64_t position, uint32_t size)
+{
+    if (handle->read_ahead != NULL)
+    {
+        read_ahead_invalidate(handle->read_ahead, position, size);
+    }
+}
+
+static void on_vectored_io_part_complete(FILE_WIN32_VECTORED_IO* vectored_io, bool is_successful)
+{
+    if (!is_successful)
+    {
+        (void)interlocked_exchange(&vectored_io->failed, 1);
+    }
+
+    /*Codes_SRS_FILE_WIN32_01_013: [ When the last part of a vectored operation completes, on_file_io_complete_win32 shall release the vectored operation context to the I/O context pool and call user_callback with is_successful as true if and only if all the parts were successful. ]*/
+    if (interlocked_decrement(&vectored_io->pending_count) == 0)
+    {
+        FILE_HANDLE handle = vectored_io->handle;
+        FILE_CB user_callback = vectored_io->user_callback;
+        void* user_context = vectored_io->user_context;
+        bool is_admitted = vectored_io->parts[0].is_admitted;
+        bool all_parts_succeeded = (interlocked_add(&vectored_io->failed, 0) == 0);
+
+        io_context_pool_release(handle->io_context_pool, vectored_io);
+
+        if (is_admitted)
+        {
+            /*Codes_SRS_FILE_WIN32_01_221: [ If the vectored operation holds slots of the I/O limits, on_file_io_complete_win32 shall call release_io_slots when its last part completes, before calling user_callback. ]*/
+            release_io_slots(handle);
+        }
+
+        user_callback(user_context, all_parts_succeeded);
+    }
+}
 
 static VOID CALLBACK on_file_io_complete_win32(PTP_CALLBACK_INSTANCE instance, PVOID context, PVOID overlapped, ULONG io_result, ULONG_PTR number_of_bytes_transferred, PTP_IO io)
 {
@@ -45,14 +213,8 @@ static VOID CALLBACK on_file_io_complete_win32(PTP_CALLBACK_INSTANCE instance, P
     /*Codes_SRS_FILE_WIN32_43_034: [ on_file_io_complete_win32 shall recover the file handle, the number of bytes requested by the user, user_callback and user_context from the context containing overlapped. ]*/
     FILE_WIN32_IO* io_context = CONTAINING_RECORD(overlapped, FILE_WIN32_IO, ov);
 
-    FILE_CB user_callback = io_context->user_callback;
-    void* user_callback_context = io_context->user_context;
-
     bool all_bytes_were_transferred = (uint32_t)number_of_bytes_transferred == io_context->size;
 
-    CloseHandle(io_context->ov.hEvent);
-    free(io_context);
-
     if (io_result != NO_ERROR)
     {
         LogLastError("Error in asynchronous operation.");
@@ -62,422 +224,3132 @@ static VOID CALLBACK on_file_io_complete_win32(PTP_CALLBACK_INSTANCE instance, P
         LogLastError("All bytes were not transferred.");
     }
 
-    /*Codes_SRS_FILE_WIN32_43_066: [ on_file_io_complete_win32 shall call user_callback with is_successful as true if and only if GetOverlappedResult returns true and number_of_bytes_transferred is equal to the number of bytes requested by the user. ]*/
-    /*Codes_SRS_FILE_WIN32_43_068: [ If either GetOverlappedResult returns false or number_of_bytes_transferred is not equal to the bytes requested by the user, on_file_io_complete_win32 shall return false. ]*/
-    user_callback(user_callback_context, io_result == NO_ERROR && all_bytes_were_transferred);
+    if (io_context->aggregated_io != NULL)
+    {
+        FILE_HANDLE handle = io_context->handle;
+        WRITE_AGGREGATOR_IO* aggregated_io = io_context->aggregated_io;
+        bool is_admitted = io_context->is_admitted;
+
+        /*Codes_SRS_FILE_WIN32_01_117: [ If the completed operation is an aggregated write, on_file_io_complete_win32 shall release the context to the I/O context pool and call write_aggregator_io_complete with is_successful as true if and only if io_result is NO_ERROR and number_of_bytes_transferred is equal to the size of the aggregated write. ]*/
+        io_context_pool_release(handle->io_context_pool, io_context);
+
+        /*Codes_SRS_FILE_WIN32_01_215: [ If the completed operation is an aggregated write and a read-ahead policy is set, on_file_io_complete_win32 shall call read_ahead_invalidate with the position and size of the aggregated write before calling write_aggregator_io_complete. ]*/
+        invalidate_read_ahead_of_write(handle, aggregated_io->position, aggregated_io->size);
+
+        if (is_admitted)
+        {
+            /*Codes_SRS_FILE_WIN32_01_222: [ If the completed operation is an aggregated write or a read-ahead block read that holds slots of the I/O limits, on_file_io_complete_win32 shall call release_io_slots before calling write_aggregator_io_complete or read_ahead_io_complete. ]*/
+            release_io_slots(handle);
+        }
+
+        /*Codes_SRS_FILE_01_091: [ When the aggregated write completes, the user_callback of every write copied in it shall be called with user_context and the result of the aggregated write. ]*/
+        write_aggregator_io_complete(handle->write_aggregator, aggregated_io, io_result == NO_ERROR && all_bytes_were_transferred);
+    }
+    else if (io_context->read_ahead_io != NULL)
+    {
+        FILE_HANDLE handle = io_context->handle;
+        READ_AHEAD_IO* read_ahead_io = io_context->read_ahead_io;
+        bool is_admitted = io_context->is_admitted;
+
+        /*Codes_SRS_FILE_WIN32_01_150: [ If the completed operation is a read-ahead block read, on_file_io_complete_win32 shall release the context to the I/O context pool and call read_ahead_io_complete with is_successful as true if and only if io_result is NO_ERROR or ERROR_HANDLE_EOF and with number_of_bytes_transferred as the number of bytes read. ]*/
+        /*a block read can be short or fail with ERROR_HANDLE_EOF at the end of the file, the read-ahead only fails the reads that go past the data*/
+        io_context_pool_release(handle->io_context_pool, io_context);
 
-}
+        if (is_admitted)
+        {
+            /*Codes_SRS_FILE_WIN32_01_222: [ If the completed operation is an aggregated write or a read-ahead block read that holds slots of the I/O limits, on_file_io_complete_win32 shall call release_io_slots before calling write_aggregator_io_complete or read_ahead_io_complete. ]*/
+            release_io_slots(handle);
+        }
+
+        read_ahead_io_complete(handle->read_ahead, read_ahead_io, (io_result == NO_ERROR) || (io_result == ERROR_HANDLE_EOF), (uint32_t)number_of_bytes_transferred);
+    }
+    else if (io_context->vectored_io != NULL)
+    {
+        if (io_context->is_write)
+        {
+            /*Codes_SRS_FILE_WIN32_01_214: [ If the completed operation is a write and a read-ahead policy is set, on_file_io_complete_win32 shall call read_ahead_invalidate with the position and size of the write before calling user_callback. ]*/
+            invalidate_read_ahead_of_write(io_context->handle, ((uint64_t)io_context->ov.OffsetHigh << 32) | io_context->ov.Offset, io_context->size);
+        }
 
+        /*Codes_SRS_FILE_WIN32_01_012: [ If the completed operation is a part of a vectored operation, on_file_io_complete_win32 shall record whether io_result is NO_ERROR and number_of_bytes_transferred is equal to the size of the part. ]*/
+        on_vectored_io_part_complete(io_context->vectored_io, io_result == NO_ERROR && all_bytes_were_transferred);
+    }
+    else
+    {
+        FILE_HANDLE handle = io_context->handle;
+        FILE_CB user_callback = io_context->user_callback;
+        void* user_callback_context = io_context->user_context;
+        bool is_admitted = io_context->is_admitted;
+        bool is_write = io_context->is_write;
+        uint64_t position = ((uint64_t)io_context->ov.OffsetHigh << 32) | io_context->ov.Offset;
+        uint32_t size = io_context->size;
 
-static VOID NTAPI on_close_threadpool_group_member(
-    PVOID object_context,
-    PVOID cleanup_context
-)
+        /*Codes_SRS_FILE_WIN32_01_030: [ on_file_io_complete_win32 shall close the event of the OVERLAPPED struct only if the operation created one. ]*/
+        if (io_context->ov.hEvent != NULL)
+        {
+            CloseHandle(io_context->ov.hEvent);
+        }
+
+        /*Codes_SRS_FILE_WIN32_01_033: [ on_file_io_complete_win32 shall release the context of the operation to the I/O context pool of the file handle. ]*/
+        io_context_pool_release(handle->io_context_pool, io_context);
+
+        if (is_write)
+        {
+            /*Codes_SRS_FILE_WIN32_01_214: [ If the completed operation is a write and a read-ahead policy is set, on_file_io_complete_win32 shall call read_ahead_invalidate with the position and size of the write before calling user_callback. ]*/
+            /*Codes_SRS_FILE_01_142: [ When a read-ahead policy is set, the blocks that overlap the written range shall be dropped again when the write completes, before its user_callback is called, so that a block read while the write was in flight is not served. ]*/
+            invalidate_read_ahead_of_write(handle, position, size);
+        }
+
+        if (is_admitted)
+        {
+            /*Codes_SRS_FILE_WIN32_01_154: [ If the operation holds slots of the I/O limits, on_file_io_complete_win32 shall call release_io_slots before calling user_callback. ]*/
+            release_io_slots(handle);
+        }
+
+        /*Codes_SRS_FILE_WIN32_43_066: [ on_file_io_complete_win32 shall call user_callback with is_successful as true if and only if GetOverlappedResult returns true and number_of_bytes_transferred is equal to the number of bytes requested by the user. ]*/
+        /*Codes_SRS_FILE_WIN32_43_068: [ If either GetOverlappedResult returns false or number_of_bytes_transferred is not equal to the bytes requested by the user, on_file_io_complete_win32 shall return false. ]*/
+        user_callback(user_callback_context, io_result == NO_ERROR && all_bytes_were_transferred);
+    }
+
+}
+
+static void complete_flush_requests(FILE_HANDLE handle, FILE_WIN32_FLUSH_REQUEST* requests, bool is_successful)
 {
-    (void)object_context;
-    (void)cleanup_context;
+    /*requests are pushed most recent first, reverse them so that callbacks are called in the order of the file_flush_async calls*/
+    FILE_WIN32_FLUSH_REQUEST* ordered_requests = NULL;
+    while (requests != NULL)
+    {
+        FILE_WIN32_FLUSH_REQUEST* next = requests->next;
+        requests->next = ordered_requests;
+        ordered_requests = requests;
+        requests = next;
+    }
+
+    while (ordered_requests != NULL)
+    {
+        FILE_WIN32_FLUSH_REQUEST* next = ordered_requests->next;
+        FILE_CB user_callback = ordered_requests->user_callback;
+        void* user_context = ordered_requests->user_context;
+
+        io_context_pool_release(handle->io_context_pool, ordered_requests);
+
+        user_callback(user_context, is_successful);
+
+        ordered_requests = next;
+    }
 }
 
-IMPLEMENT_MOCKABLE_FUNCTION(, FILE_HANDLE, file_create, EXECUTION_ENGINE_HANDLE, execution_engine, const char*, full_file_name, FILE_REPORT_FAULT, user_report_fault_callback, void*, user_report_fault_context)
+static void start_flush_if_idle(FILE_HANDLE handle);
+
+/*ends the flush in progress, from on_file_flush_win32 or fail_queued_io when the flush could not be started once queued*/
+static void end_flush(FILE_HANDLE handle, bool is_successful)
 {
-    FILE_HANDLE result;
-    if (
-        /*Codes_SRS_FILE_43_033: [ If execution_engine is NULL, file_create shall fail and return NULL. ]*/
-        /*Codes_SRS_FILE_WIN32_43_040: [ If execution_engine is NULL, file_create shall fail and return NULL. ]*/
-        (execution_engine == NULL) ||
-        /*Codes_SRS_FILE_43_002: [ If full_file_name is NULL then file_create shall fail and return NULL. ]*/
-        /*Codes_SRS_FILE_WIN32_43_048: [ If full_file_name is NULL then file_create shall fail and return NULL. ]*/
-        (full_file_name == NULL) ||
-        /*Codes_SRS_FILE_43_037: [ If full_file_name is an empty string, file_create shall fail and return NULL. ]*/
-        /*Codes_SRS_FILE_WIN32_43_059: [ If full_file_name is an empty string, file_create shall fail and return NULL. ]*/
-        (full_file_name[0] == '\0')
-        )
+    /*Codes_SRS_FILE_WIN32_01_052: [ on_file_flush_win32 shall release all the requests served by the flush to the I/O context pool and call their user_callback, in the order in which file_flush_async was called, with is_successful as true if and only if FlushFileBuffers succeeded. ]*/
+    complete_flush_requests(handle, handle->flushing_requests, is_successful);
+
+    /*Codes_SRS_FILE_WIN32_01_053: [ on_file_flush_win32 shall mark the flush as not in progress and start a new flush if requests were added while the flush was in progress. ]*/
+    (void)interlocked_exchange(&handle->flush_in_progress, 0);
+    start_flush_if_idle(handle);
+
+    /*Codes_SRS_FILE_WIN32_01_054: [ on_file_flush_win32 shall decrement the number of pending flushes and wake up file_destroy by calling wake_by_address_single if it reaches 0. ]*/
+    if (interlocked_decrement(&handle->pending_flush_count) == 0)
     {
-        LogError("Invalid arguments to file_create: EXECUTION_ENGINE_HANDLE execution_engine=%p, const char* full_file_name=%s, FILE_REPORT_FAULT user_report_callback=%p, void* user_report_faul_context=%p",
-            execution_engine, MU_P_OR_NULL(full_file_name), user_report_fault_callback, user_report_fault_context);
-        result = NULL;
+        wake_by_address_single(&handle->pending_flush_count);
     }
-    else
+}
+
+static void start_flush_if_idle(FILE_HANDLE handle)
+{
+    /*Codes_SRS_FILE_WIN32_01_045: [ To start a flush, file_flush_async shall mark the flush as in progress, and if another flush is already in progress it shall return, leaving the requests to be served by the next flush. ]*/
+    while (interlocked_compare_exchange(&handle->flush_in_progress, 1, 0) == 0)
     {
-        /*Codes_SRS_FILE_WIN32_43_041: [ file_create shall allocate a FILE_HANDLE. ]*/
-        result = malloc(sizeof(FILE_HANDLE_DATA));
-        if (result == NULL)
+        /*Codes_SRS_FILE_WIN32_01_046: [ file_flush_async shall take all the requests from the list of flush requests. ]*/
+        FILE_WIN32_FLUSH_REQUEST* requests = interlocked_exchange_pointer(&handle->flush_requests, NULL);
+        if (requests == NULL)
         {
-            /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
-            /*Codes_SRS_FILE_WIN32_43_008: [ If there are any failures, file_create shall return NULL. ]*/
-            LogError("Failure in malloc");
+            /*Codes_SRS_FILE_WIN32_01_047: [ If there are no requests, file_flush_async shall mark the flush as not in progress and try again if a request was added in the meantime. ]*/
+            (void)interlocked_exchange(&handle->flush_in_progress, 0);
+            if (interlocked_compare_exchange_pointer(&handle->flush_requests, NULL, NULL) == NULL)
+            {
+                break;
+            }
         }
         else
         {
-            bool succeeded;
-            /* Codes_SRS_FILE_WIN32_01_001: [ file_create shall increment the reference count of execution_engine in order to hold on to it. ]*/
-            execution_engine_inc_ref(execution_engine);
-            result->execution_engine = execution_engine;
+            handle->flushing_requests = requests;
 
-            /*Codes_SRS_FILE_43_003: [ If a file with name full_file_name does not exist, file_create shall create a file with that name.]*/
-            /*Codes_SRS_FILE_43_001: [ file_create shall open the file named full_file_name for asynchronous operations and return its handle. ]*/
-            /*Codes_SRS_FILE_WIN32_43_001: [ file_create shall call CreateFileA with full_file_name as lpFileName, GENERIC_READ|GENERIC_WRITE as dwDesiredAccess, FILE_SHARED_READ as dwShareMode, NULL as lpSecurityAttributes, OPEN_ALWAYS as dwCreationDisposition, FILE_FLAG_OVERLAPPED|FILE_FLAG_WRITE_THROUGH as dwFlagsAndAttributes and NULL as hTemplateFile. ]*/
-            result->h_file = CreateFileA(
-                full_file_name,                                     /* LPCTSTR               lpFileName*/
-                GENERIC_READ | GENERIC_WRITE,                       /* DWORD                 dwDesiredAccess*/
-                FILE_SHARE_READ,                                    /* DWORD                 dwShareMode*/
-                NULL,                                               /* LPSECURITY_ATTRIBUTES lpSecurityAttributes*/
-                OPEN_ALWAYS,                                        /* DWORD                 dwCreationDisposition*/
-                FILE_FLAG_OVERLAPPED | FILE_FLAG_WRITE_THROUGH,     /* DWORD                 dwFlagsAndAttributes*/
-                NULL                                                /* HANDLE                hTemplateFile*/
-                );
-            if ( result->h_file == INVALID_HANDLE_VALUE)
+            /*Codes_SRS_FILE_01_147: [ The aggregated writes, the reads of read-ahead blocks and the flushes of handle shall be queued when no slot of the I/O limits is free, whatever the mode of handle. ]*/
+            /*Codes_SRS_FILE_WIN32_01_048: [ file_flush_async shall increment the number of pending flushes and call start_io with the flush context of handle and FILE_IO_LIMIT_MODE_QUEUE, which calls TrySubmitThreadpoolCallback with on_file_flush_win32 and the threadpool environment of handle once the flush holds a slot of the I/O limits. ]*/
+            (void)interlocked_increment(&handle->pending_flush_count);
+            if (start_io(handle, &handle->flush_io, FILE_IO_LIMIT_MODE_QUEUE) == FILE_WIN32_START_IO_OK)
             {
-                /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
-                /*Codes_SRS_FILE_WIN32_43_008: [ If there are any failures, file_create shall return NULL. ]*/
-                LogLastError("Failure in CreateFileA, full_file_name=%s", full_file_name);
-                succeeded = false;
+                break;
             }
-            else
+
+            /*Codes_SRS_FILE_WIN32_01_049: [ If start_io fails, file_flush_async shall call the user_callback of all the taken requests with is_successful as false, release them to the I/O context pool, mark the flush as not in progress and decrement the number of pending flushes. ]*/
+            LogError("failure in start_io for the flush");
+            complete_flush_requests(handle, requests, false);
+            (void)interlocked_exchange(&handle->flush_in_progress, 0);
+            if (interlocked_decrement(&handle->pending_flush_count) == 0)
             {
-                /*Codes_SRS_FILE_WIN32_43_002: [ file_create shall call SetFileCompletionNotificationModes to disable calling the completion port when an async operations finishes synchrounously.]*/
-                if (!SetFileCompletionNotificationModes(result->h_file, FILE_SKIP_COMPLETION_PORT_ON_SUCCESS))
-                {
-                    /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
-                    /*Codes_SRS_FILE_WIN32_43_008: [ If there are any failures, file_create shall return NULL. ]*/
-                    LogLastError("Failure in SetFileCompletionNotificationModes, full_file_name=%s", full_file_name);
-                    succeeded = false;
-                }
-                else
-                {
-                    /*Codes_SRS_FILE_WIN32_43_003: [ file_create shall initialize a threadpool environment by calling InitializeThreadpolEnvironment.]*/
-                    InitializeThreadpoolEnvironment(&result->cbe);
+                wake_by_address_single(&handle->pending_flush_count);
+            }
+        }
+    }
+}
 
-                    /*Codes_SRS_FILE_WIN32_43_004: [ file_create shall obtain a PTP_POOL struct by calling execution_engine_win32_get_threadpool on execution_engine.]*/
-                    result->ptp_pool = execution_engine_win32_get_threadpool(execution_engine);
+static VOID NTAPI on_file_flush_win32(PTP_CALLBACK_INSTANCE instance, PVOID context)
+{
+    (void)instance;
+    FILE_HANDLE handle = context;
 
-                    /*Codes_SRS_FILE_WIN32_43_005: [ file_create shall register the threadpool environment by calling SetThreadpoolCallbackPool on the initialized threadpool environment and the obtained ptp_pool ]*/
-                    SetThreadpoolCallbackPool(&result->cbe, result->ptp_pool);
+    /*Codes_SRS_FILE_WIN32_01_051: [ on_file_flush_win32 shall call FlushFileBuffers on the file. ]*/
+    BOOL flush_succeeded = FlushFileBuffers(handle->h_file);
+    if (!flush_succeeded)
+    {
+        LogLastError("failure in FlushFileBuffers");
+    }
 
-                    /*Codes_SRS_FILE_WIN32_43_006: [ file_create shall create a cleanup group by calling CreateThreadpoolCleanupGroup.]*/
-                    result->ptp_cleanup_group = CreateThreadpoolCleanupGroup();
+    if (handle->flush_io.is_admitted)
+    {
+        /*Codes_SRS_FILE_WIN32_01_223: [ If the flush holds slots of the I/O limits, on_file_flush_win32 shall call release_io_slots before calling the user_callback of the requests. ]*/
+        release_io_slots(handle);
+    }
 
-                    if (result->ptp_cleanup_group == NULL)
-                    {
-                        /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
-                        LogLastError("Failure in CreateThreadpoolCleanupGroup, full_file_name=%s", full_file_name);
-                        succeeded = false;
-                    }
-                    else
-                    {
-                        /*Codes_SRS_FILE_WIN32_43_007: [ file_create shall register the cleanup group with the threadpool environment by calling SetThreadpoolCallbackCleanupGroup.]*/
-                        SetThreadpoolCallbackCleanupGroup(&result->cbe, result->ptp_cleanup_group, on_close_threadpool_group_member);
+    end_flush(handle, flush_succeeded != FALSE);
+}
 
-                        /*Codes_SRS_FILE_WIN32_43_033: [ file_create shall create a threadpool io with the allocated FILE_HANDLE and on_file_io_complete_win32 as a callback by calling CreateThreadpoolIo]*/
-                        result->ptp_io = CreateThreadpoolIo(result->h_file, on_file_io_complete_win32, NULL, &result->cbe);
-                        
-                        if (result->ptp_io == NULL)
-                        {
-                            /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
-                            /*Codes_SRS_FILE_WIN32_43_008: [ If there are any failures, file_create shall return NULL. ]*/
-                            LogLastError("Failure in CreateThreadpoolIo, full_file_name=%s", full_file_name);
-                            succeeded = false;
-                        }
-                        else
-                        {
-                            /*Codes_SRS_FILE_WIN32_43_009: [ file_create shall succeed and return a non - NULL value.]*/
-                            succeeded = true;
-                            result->user_report_fault_callback = user_report_fault_callback;
-                            result->user_report_fault_context = user_report_fault_context;
-                        }
-                        
-                        if (!succeeded)
-                        {
-                            CloseThreadpoolCleanupGroup(result->ptp_cleanup_group);
-                        }
-                    }
-                    if (!succeeded)
-                    {
-                        DestroyThreadpoolEnvironment(&result->cbe);
-                    }
-                }
-                if (!succeeded)
-                {
-                    if (!CloseHandle(result->h_file))
-                    {
-                        LogLastError("Failure in CloseHandle, full_file_name=%s", full_file_name);
-                    }
-                }
-            }
-            /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
-            if (!succeeded)
+/*setting an allocation size below the end of file truncates the file, the reservation checks the furthest write started before setting it*/
+static void record_write_end(FILE_HANDLE handle, uint64_t write_end)
+{
+    /*Codes_SRS_FILE_WIN32_01_075: [ If no preallocation policy is set on handle, record_write_end shall return. ]*/
+    if (handle->preallocation_chunk_size != 0)
+    {
+        /*Codes_SRS_FILE_WIN32_01_076: [ record_write_end shall record write_end as the end of the furthest write started if it is greater than it. ]*/
+        int64_t highest_write_end = interlocked_add_64(&handle->highest_write_end, 0);
+        while ((int64_t)write_end > highest_write_end)
+        {
+            int64_t observed_highest_write_end = interlocked_compare_exchange_64(&handle->highest_write_end, (int64_t)write_end, highest_write_end);
+            if (observed_highest_write_end == highest_write_end)
             {
-                execution_engine_dec_ref(result->execution_engine);
-                free(result);
-                result = NULL;
+                break;
             }
+            highest_write_end = observed_highest_write_end;
         }
     }
-    return result;
 }
 
+static VOID NTAPI on_file_preallocate_win32(PTP_CALLBACK_INSTANCE instance, PVOID context);
 
-IMPLEMENT_MOCKABLE_FUNCTION(, void, file_destroy, FILE_HANDLE, handle)
+static void preallocate_ahead_if_needed(FILE_HANDLE handle, uint64_t write_end)
 {
-    
-    if (handle == NULL)
+    uint64_t chunk_size = handle->preallocation_chunk_size;
+    if (
+        /*Codes_SRS_FILE_WIN32_01_078: [ If no preallocation policy is set on handle, preallocate_ahead_if_needed shall return. ]*/
+        (chunk_size != 0) &&
+        /*Codes_SRS_FILE_01_081: [ When a write started by file_write_async, file_write_async_v or file_batch_submit ends less than chunk_size / 2 bytes before the end of the reserved storage and no reservation is in progress, storage shall be reserved in the background, without changing the size of the file, up to chunk_size bytes past the end of the write. ]*/
+        /*Codes_SRS_FILE_WIN32_01_079: [ If write_end + chunk_size / 2 is not greater than the preallocated end of the file, preallocate_ahead_if_needed shall return. ]*/
+        (write_end + chunk_size / 2 > (uint64_t)interlocked_add_64(&handle->preallocated_end, 0)) &&
+        /*Codes_SRS_FILE_WIN32_01_080: [ preallocate_ahead_if_needed shall mark the preallocation as in progress, and if a preallocation is already in progress it shall return. ]*/
+        (interlocked_compare_exchange(&handle->preallocation_in_progress, 1, 0) == 0)
+        )
     {
-        /*Codes_SRS_FILE_43_005: [ If handle is NULL, file_destroy shall return. ]*/
-        /*Codes_SRS_FILE_WIN32_43_049: [ If handle is NULL, file_destroy shall return.]*/
-        LogError("Invalid argument to file_destroy: FILE_HANDLE=%p", handle);
+        /*Codes_SRS_FILE_WIN32_01_081: [ preallocate_ahead_if_needed shall set the preallocation target to the end of the furthest write started + chunk_size, capped at INT64_MAX. ]*/
+        int64_t highest_write_end = interlocked_add_64(&handle->highest_write_end, 0);
+        (void)interlocked_exchange_64(&handle->preallocation_target, (highest_write_end > (int64_t)(INT64_MAX - chunk_size)) ? INT64_MAX : highest_write_end + (int64_t)chunk_size);
+
+        /*Codes_SRS_FILE_WIN32_01_082: [ preallocate_ahead_if_needed shall call TrySubmitThreadpoolCallback with on_file_preallocate_win32 and the threadpool environment of handle. ]*/
+        if (!TrySubmitThreadpoolCallback(on_file_preallocate_win32, handle, &handle->cbe))
+        {
+            /*Codes_SRS_FILE_01_082: [ A failure to reserve storage shall not fail the write. ]*/
+            /*Codes_SRS_FILE_WIN32_01_083: [ If TrySubmitThreadpoolCallback fails, preallocate_ahead_if_needed shall set the preallocation target back to the preallocated end, mark the preallocation as not in progress and wake up file_destroy by calling wake_by_address_all. ]*/
+            LogLastError("failure in TrySubmitThreadpoolCallback");
+            (void)interlocked_exchange_64(&handle->preallocation_target, interlocked_add_64(&handle->preallocated_end, 0));
+            (void)interlocked_exchange(&handle->preallocation_in_progress, 0);
+            wake_by_address_all(&handle->preallocation_in_progress);
+        }
+    }
+}
+
+static VOID NTAPI on_file_preallocate_win32(PTP_CALLBACK_INSTANCE instance, PVOID context)
+{
+    (void)instance;
+    FILE_HANDLE handle = context;
+    FILE_ALLOCATION_INFO allocation_info;
+    LARGE_INTEGER file_size;
+
+    allocation_info.AllocationSize.QuadPart = interlocked_add_64(&handle->preallocation_target, 0);
+
+    /*the writes are not held back while the storage is reserved, so the allocation size is only ever grown: a target that does not go past the end of the file or past the furthest write started would cut it*/
+    /*Codes_SRS_FILE_WIN32_01_218: [ on_file_preallocate_win32 shall call GetFileSizeEx to get the size of the file. ]*/
+    if (!GetFileSizeEx(handle->h_file, &file_size))
+    {
+        /*Codes_SRS_FILE_WIN32_01_219: [ If GetFileSizeEx fails, on_file_preallocate_win32 shall not call SetFileInformationByHandle. ]*/
+        LogLastError("failure in GetFileSizeEx, not reserving storage up to %" PRId64 "", (int64_t)allocation_info.AllocationSize.QuadPart);
+    }
+    else if (
+        (allocation_info.AllocationSize.QuadPart <= file_size.QuadPart) ||
+        (allocation_info.AllocationSize.QuadPart <= interlocked_add_64(&handle->highest_write_end, 0))
+        )
+    {
+        /*Codes_SRS_FILE_WIN32_01_220: [ If the preallocation target is not greater than the size of the file or than the end of the furthest write started, on_file_preallocate_win32 shall not call SetFileInformationByHandle. ]*/
+        LogVerbose("the writes already went past the preallocation target %" PRId64 ", not reserving storage", (int64_t)allocation_info.AllocationSize.QuadPart);
     }
     else
     {
-        /*Codes_SRS_FILE_43_006: [ file_destroy shall wait for all pending I/O operations to complete. ]*/
-        /*Codes_SRS_FILE_WIN32_43_011: [ file_destroy shall wait for all I/O to complete by calling WaitForThreadpoolIoCallbacks. ]*/
-        WaitForThreadpoolIoCallbacks(handle->ptp_io, FALSE);
-        /*Codes_SRS_FILE_WIN32_43_012: [ file_destroy shall close the cleanup group by calling CloseThreadpoolCleanupGroup. ]*/
-        CloseThreadpoolCleanupGroup(handle->ptp_cleanup_group);
-        /*Codes_SRS_FILE_WIN32_43_013: [ file_destroy shall destroy the environment by calling DestroyThreadpoolEnvironment. ]*/
-        DestroyThreadpoolEnvironment(&(handle->cbe));
-        /*Codes_SRS_FILE_43_007: [ file_destroy shall close the file handle handle. ]*/
-        /*Codes_SRS_FILE_WIN32_43_016: [ file_destroy shall call CloseHandle on the handle returned by CreateFileA. ]*/
-        if (!CloseHandle(handle->h_file))
+        /*Codes_SRS_FILE_WIN32_01_084: [ Otherwise, on_file_preallocate_win32 shall call SetFileInformationByHandle with FileAllocationInfo and the preallocation target as allocation size. ]*/
+        if (!SetFileInformationByHandle(handle->h_file, FileAllocationInfo, &allocation_info, sizeof(allocation_info)))
         {
-            LogLastError("failure in CloseHandle");
+            /*Codes_SRS_FILE_01_082: [ A failure to reserve storage shall not fail the write. ]*/
+            LogLastError("failure in SetFileInformationByHandle, allocation size=%" PRId64 "", (int64_t)allocation_info.AllocationSize.QuadPart);
         }
-        /*Codes_SRS_FILE_WIN32_43_015: [ file_destroy shall close the threadpool IO by calling CloseThreadPoolIo. ]*/
-        CloseThreadpoolIo(handle->ptp_io);
-        /*Codes_SRS_FILE_WIN32_01_002: [ file_destroy shall decrement the reference count for the execution engine. ]*/
-        execution_engine_dec_ref(handle->execution_engine);
-        /*Codes_SRS_FILE_WIN32_43_042: [ file_destroy shall free the handle.]*/
-        free(handle);
     }
+
+    /*Codes_SRS_FILE_WIN32_01_085: [ on_file_preallocate_win32 shall set the preallocated end of the file to the preallocation target, even if SetFileInformationByHandle failed, so that a failing file system is only asked again once the writes get past the target. ]*/
+    (void)interlocked_exchange_64(&handle->preallocated_end, allocation_info.AllocationSize.QuadPart);
+
+    /*Codes_SRS_FILE_WIN32_01_086: [ on_file_preallocate_win32 shall mark the preallocation as not in progress and wake up file_destroy by calling wake_by_address_all. ]*/
+    (void)interlocked_exchange(&handle->preallocation_in_progress, 0);
+    wake_by_address_all(&handle->preallocation_in_progress);
 }
 
-IMPLEMENT_MOCKABLE_FUNCTION(, FILE_WRITE_ASYNC_RESULT, file_write_async, FILE_HANDLE, handle, const unsigned char*, source, uint32_t, size, uint64_t, position, FILE_CB, user_callback, void*, user_context
-)
+/*issues the WriteFile of an aggregated write, returns 0 if the write is pending or completed synchronously, non-zero if it failed (the context is left to the caller)*/
+static int issue_aggregated_write_io(FILE_HANDLE handle, FILE_WIN32_IO* io_context)
 {
-    FILE_WRITE_ASYNC_RESULT result;
-    if
-    (
-        /*Codes_SRS_FILE_43_009: [ If handle is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
-        /*Codes_SRS_FILE_WIN32_43_043: [ If handle is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS.]*/
+    int result;
+    WRITE_AGGREGATOR_IO* aggregated_io = io_context->aggregated_io;
+    bool is_complete;
+
+    /*Codes_SRS_FILE_WIN32_01_112: [ issue_aggregated_write_io shall call record_write_end with the position + size of the aggregated write. ]*/
+    record_write_end(handle, aggregated_io->position + aggregated_io->size);
+
+    /*Codes_SRS_FILE_WIN32_01_113: [ issue_aggregated_write_io shall call StartThreadpoolIo and WriteFile with the buffer and size of the aggregated write and the OVERLAPPED struct. ]*/
+    StartThreadpoolIo(handle->ptp_io);
+    if (WriteFile(handle->h_file, aggregated_io->buffer, aggregated_io->size, NULL, &io_context->ov) == FALSE)
+    {
+        if (GetLastError() == ERROR_IO_PENDING)
+        {
+            /*Codes_SRS_FILE_WIN32_01_114: [ If WriteFile fails synchronously and GetLastError indicates ERROR_IO_PENDING, issue_aggregated_write_io shall call preallocate_ahead_if_needed with the position + size of the aggregated write and return 0. ]*/
+            is_complete = false;
+            result = 0;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_WIN32_01_115: [ If WriteFile fails synchronously and GetLastError does not indicate ERROR_IO_PENDING, issue_aggregated_write_io shall call CancelThreadpoolIo and return a non-zero value. ]*/
+            LogLastError("failure in WriteFile, position=%" PRIu64 ", size=%" PRIu32 "", aggregated_io->position, aggregated_io->size);
+            CancelThreadpoolIo(handle->ptp_io);
+            is_complete = false;
+            result = MU_FAILURE;
+        }
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_116: [ If WriteFile succeeds synchronously, issue_aggregated_write_io shall call CancelThreadpoolIo, release the context, call release_io_slots if the write holds slots of the I/O limits, call preallocate_ahead_if_needed with the position + size of the aggregated write, call write_aggregator_io_complete with is_successful as true and return 0. ]*/
+        bool is_admitted = io_context->is_admitted;
+
+        CancelThreadpoolIo(handle->ptp_io);
+        io_context_pool_release(handle->io_context_pool, io_context);
+        /*Codes_SRS_FILE_WIN32_01_217: [ If a write succeeds synchronously and a read-ahead policy is set, read_ahead_invalidate shall be called with the position and size of the write before its user_callback or write_aggregator_io_complete is called. ]*/
+        invalidate_read_ahead_of_write(handle, aggregated_io->position, aggregated_io->size);
+        if (is_admitted)
+        {
+            release_io_slots(handle);
+        }
+        is_complete = true;
+        result = 0;
+    }
+
+    if (result == 0)
+    {
+        preallocate_ahead_if_needed(handle, aggregated_io->position + aggregated_io->size);
+
+        if (is_complete)
+        {
+            /*the write aggregator does not touch the block once issue_io returned 0, so completing it here is fine*/
+            write_aggregator_io_complete(handle->write_aggregator, aggregated_io, true);
+        }
+    }
+
+    return result;
+}
+
+static int issue_aggregated_write(void* context, WRITE_AGGREGATOR_IO* aggregated_io)
+{
+    int result;
+    FILE_HANDLE handle = context;
+
+    /*Codes_SRS_FILE_WIN32_01_110: [ issue_aggregated_write shall get a context from the I/O context pool by calling io_context_pool_get. ]*/
+    FILE_WIN32_IO* io_context = io_context_pool_get(handle->io_context_pool, sizeof(FILE_WIN32_IO));
+    if (io_context == NULL)
+    {
+        /*Codes_SRS_FILE_WIN32_01_111: [ If io_context_pool_get fails, issue_aggregated_write shall fail and return a non-zero value. ]*/
+        LogError("failure in io_context_pool_get");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_224: [ issue_aggregated_write shall populate an OVERLAPPED struct with the position of the aggregated write. ]*/
+        (void)memset(&io_context->ov, 0, sizeof(OVERLAPPED));
+        io_context->ov.Offset = aggregated_io->position & 0xFFFFFFFFULL;
+        io_context->ov.OffsetHigh = aggregated_io->position >> 32;
+        io_context->handle = handle;
+        io_context->user_callback = NULL;
+        io_context->user_context = NULL;
+        io_context->size = aggregated_io->size;
+        io_context->vectored_io = NULL;
+        io_context->aggregated_io = aggregated_io;
+        io_context->read_ahead_io = NULL;
+        io_context->is_write = true;
+
+        /*Codes_SRS_FILE_01_143: [ The I/Os of file_write_async_v, file_read_async_v and of the batches, the aggregated writes, the reads of read-ahead blocks and the flushes of handle shall also hold a slot of the I/O limit of handle and of the I/O limit of the execution engine from the moment they are started until they complete. ]*/
+        /*Codes_SRS_FILE_01_147: [ The aggregated writes, the reads of read-ahead blocks and the flushes of handle shall be queued when no slot of the I/O limits is free, whatever the mode of handle. ]*/
+        /*Codes_SRS_FILE_WIN32_01_225: [ issue_aggregated_write shall start the write by calling start_io with FILE_IO_LIMIT_MODE_QUEUE, which calls issue_aggregated_write_io once the write holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+        if (start_io(handle, io_context, FILE_IO_LIMIT_MODE_QUEUE) != FILE_WIN32_START_IO_OK)
+        {
+            /*Codes_SRS_FILE_WIN32_01_226: [ If start_io fails, issue_aggregated_write shall release the context and return a non-zero value. ]*/
+            LogError("failure in start_io, position=%" PRIu64 ", size=%" PRIu32 "", aggregated_io->position, aggregated_io->size);
+            io_context_pool_release(handle->io_context_pool, io_context);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_WIN32_01_227: [ issue_aggregated_write shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static VOID NTAPI on_aggregation_timer_win32(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_TIMER timer)
+{
+    (void)instance;
+    (void)timer;
+    FILE_HANDLE handle = context;
+
+    /*Codes_SRS_FILE_WIN32_01_120: [ on_aggregation_timer_win32 shall call write_aggregator_on_timer with the timer id the timer was last armed for. ]*/
+    /*an older timer id is ignored by the write aggregator, a newer one only closes the block it is for a bit early*/
+    write_aggregator_on_timer(handle->write_aggregator, (uint64_t)interlocked_add_64(&handle->aggregation_timer_id, 0));
+}
+
+static int start_aggregation_timer(void* context, uint32_t delay_ms, uint64_t timer_id)
+{
+    FILE_HANDLE handle = context;
+    ULARGE_INTEGER due_time_as_integer;
+    FILETIME due_time;
+
+    /*Codes_SRS_FILE_WIN32_01_118: [ start_aggregation_timer shall store timer_id and call SetThreadpoolTimer on the aggregation timer with a due time of delay_ms milliseconds from now, no period and no window. ]*/
+    (void)interlocked_exchange_64(&handle->aggregation_timer_id, (int64_t)timer_id);
+
+    /*a negative due time is relative to the current time, in 100 nanoseconds units*/
+    due_time_as_integer.QuadPart = (ULONGLONG)(-((int64_t)delay_ms * 10000));
+    due_time.dwLowDateTime = due_time_as_integer.LowPart;
+    due_time.dwHighDateTime = due_time_as_integer.HighPart;
+    SetThreadpoolTimer(handle->aggregation_timer, &due_time, 0, 0);
+
+    /*Codes_SRS_FILE_WIN32_01_119: [ start_aggregation_timer shall succeed and return 0. ]*/
+    return 0;
+}
+
+/*issues the ReadFile of a read-ahead block, returns 0 if the read is pending or completed synchronously, non-zero if it failed (the context is left to the caller)*/
+static int issue_read_ahead_io(FILE_HANDLE handle, FILE_WIN32_IO* io_context)
+{
+    int result;
+    READ_AHEAD_IO* read_ahead_io = io_context->read_ahead_io;
+    DWORD bytes_read;
+
+    /*Codes_SRS_FILE_WIN32_01_145: [ issue_read_ahead_io shall call StartThreadpoolIo and ReadFile with the buffer and size of the block and the OVERLAPPED struct. ]*/
+    StartThreadpoolIo(handle->ptp_io);
+    if (ReadFile(handle->h_file, read_ahead_io->buffer, read_ahead_io->size, &bytes_read, &io_context->ov) == FALSE)
+    {
+        DWORD last_error = GetLastError();
+        if (last_error == ERROR_IO_PENDING)
+        {
+            /*Codes_SRS_FILE_WIN32_01_146: [ If ReadFile fails synchronously and GetLastError indicates ERROR_IO_PENDING, issue_read_ahead_io shall succeed and return 0. ]*/
+            result = 0;
+        }
+        else if (last_error == ERROR_HANDLE_EOF)
+        {
+            /*Codes_SRS_FILE_WIN32_01_147: [ If ReadFile fails synchronously and GetLastError indicates ERROR_HANDLE_EOF, issue_read_ahead_io shall call CancelThreadpoolIo, release the context, call release_io_slots if the read holds slots of the I/O limits, call read_ahead_io_complete with is_successful as true and 0 bytes read and return 0. ]*/
+            bool is_admitted = io_context->is_admitted;
+
+            CancelThreadpoolIo(handle->ptp_io);
+            io_context_pool_release(handle->io_context_pool, io_context);
+            if (is_admitted)
+            {
+                release_io_slots(handle);
+            }
+            read_ahead_io_complete(handle->read_ahead, read_ahead_io, true, 0);
+            result = 0;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_WIN32_01_148: [ If ReadFile fails synchronously and GetLastError indicates any other error, issue_read_ahead_io shall call CancelThreadpoolIo and return a non-zero value. ]*/
+            LogError("failure in ReadFile, position=%" PRIu64 ", size=%" PRIu32 ", last_error=%" PRIu32 "", read_ahead_io->position, read_ahead_io->size, (uint32_t)last_error);
+            CancelThreadpoolIo(handle->ptp_io);
+            result = MU_FAILURE;
+        }
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_149: [ If ReadFile succeeds synchronously, issue_read_ahead_io shall call CancelThreadpoolIo, release the context, call release_io_slots if the read holds slots of the I/O limits, call read_ahead_io_complete with is_successful as true and the number of bytes read and return 0. ]*/
+        /*the read-ahead does not hold its lock while calling issue_io, so completing the block here is fine*/
+        bool is_admitted = io_context->is_admitted;
+
+        CancelThreadpoolIo(handle->ptp_io);
+        io_context_pool_release(handle->io_context_pool, io_context);
+        if (is_admitted)
+        {
+            release_io_slots(handle);
+        }
+        read_ahead_io_complete(handle->read_ahead, read_ahead_io, true, (uint32_t)bytes_read);
+        result = 0;
+    }
+
+    return result;
+}
+
+static int issue_read_ahead(void* context, READ_AHEAD_IO* read_ahead_io)
+{
+    int result;
+    FILE_HANDLE handle = context;
+
+    /*Codes_SRS_FILE_WIN32_01_143: [ issue_read_ahead shall get a context from the I/O context pool by calling io_context_pool_get. ]*/
+    FILE_WIN32_IO* io_context = io_context_pool_get(handle->io_context_pool, sizeof(FILE_WIN32_IO));
+    if (io_context == NULL)
+    {
+        /*Codes_SRS_FILE_WIN32_01_144: [ If io_context_pool_get fails, issue_read_ahead shall fail and return a non-zero value. ]*/
+        LogError("failure in io_context_pool_get");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_228: [ issue_read_ahead shall populate an OVERLAPPED struct with the position of the block. ]*/
+        (void)memset(&io_context->ov, 0, sizeof(OVERLAPPED));
+        io_context->ov.Offset = read_ahead_io->position & 0xFFFFFFFFULL;
+        io_context->ov.OffsetHigh = read_ahead_io->position >> 32;
+        io_context->handle = handle;
+        io_context->user_callback = NULL;
+        io_context->user_context = NULL;
+        io_context->size = read_ahead_io->size;
+        io_context->vectored_io = NULL;
+        io_context->aggregated_io = NULL;
+        io_context->read_ahead_io = read_ahead_io;
+        io_context->is_write = false;
+
+        /*Codes_SRS_FILE_01_143: [ The I/Os of file_write_async_v, file_read_async_v and of the batches, the aggregated writes, the reads of read-ahead blocks and the flushes of handle shall also hold a slot of the I/O limit of handle and of the I/O limit of the execution engine from the moment they are started until they complete. ]*/
+        /*Codes_SRS_FILE_01_147: [ The aggregated writes, the reads of read-ahead blocks and the flushes of handle shall be queued when no slot of the I/O limits is free, whatever the mode of handle. ]*/
+        /*Codes_SRS_FILE_WIN32_01_229: [ issue_read_ahead shall start the read by calling start_io with FILE_IO_LIMIT_MODE_QUEUE, which calls issue_read_ahead_io once the read holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+        if (start_io(handle, io_context, FILE_IO_LIMIT_MODE_QUEUE) != FILE_WIN32_START_IO_OK)
+        {
+            /*Codes_SRS_FILE_WIN32_01_230: [ If start_io fails, issue_read_ahead shall release the context and return a non-zero value. ]*/
+            LogError("failure in start_io, position=%" PRIu64 ", size=%" PRIu32 "", read_ahead_io->position, read_ahead_io->size);
+            io_context_pool_release(handle->io_context_pool, io_context);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_WIN32_01_231: [ issue_read_ahead shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+
+    return result;
+}
+
+static VOID NTAPI on_read_ahead_copied_win32(PTP_CALLBACK_INSTANCE instance, PVOID context)
+{
+    (void)instance;
+    FILE_WIN32_IO* io_context = context;
+    FILE_HANDLE handle = io_context->handle;
+    FILE_CB user_callback = io_context->user_callback;
+    void* user_context = io_context->user_context;
+
+    /*Codes_SRS_FILE_WIN32_01_151: [ on_read_ahead_copied_win32 shall release the context to the I/O context pool and call user_callback with is_successful as true. ]*/
+    io_context_pool_release(handle->io_context_pool, io_context);
+    user_callback(user_context, true);
+
+    /*Codes_SRS_FILE_WIN32_01_152: [ on_read_ahead_copied_win32 shall decrement the number of pending copied reads and wake up file_destroy by calling wake_by_address_single if it reaches 0. ]*/
+    if (interlocked_decrement(&handle->pending_copied_read_count) == 0)
+    {
+        wake_by_address_single(&handle->pending_copied_read_count);
+    }
+}
+
+static int start_vectored_io(FILE_HANDLE handle, FILE_WIN32_VECTORED_IO* vectored_io);
+
+/*issues the WriteFile/ReadFile of file_write_async/file_read_async and of the batched I/Os, returns 0 if the I/O is pending or completed synchronously (the context is then owned by the I/O), non-zero if it failed (the context is left to the caller)*/
+static int issue_single_io(FILE_HANDLE handle, FILE_WIN32_IO* io_context)
+{
+    int result;
+    uint64_t position = ((uint64_t)io_context->ov.OffsetHigh << 32) | io_context->ov.Offset;
+    uint32_t size = io_context->size;
+    bool is_write = io_context->is_write;
+    BOOL issued;
+
+    if (is_write)
+    {
+        /*Codes_SRS_FILE_WIN32_01_087: [ file_write_async shall call record_write_end with position + size. ]*/
+        record_write_end(handle, position + size);
+
+        /*Codes_SRS_FILE_WIN32_43_017: [ file_write_async shall call StartThreadpoolIo.]*/
+        StartThreadpoolIo(handle->ptp_io);
+
+        /*Codes_SRS_FILE_WIN32_43_021: [ file_write_async shall call WriteFile with handle, source, size and the allocated OVERLAPPED struct.]*/
+        issued = WriteFile(handle->h_file, io_context->buffer, size, NULL, &io_context->ov);
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_43_025: [ file_read_async shall call StartThreadpoolIo. ]*/
+        StartThreadpoolIo(handle->ptp_io);
+
+        /*Codes_SRS_FILE_WIN32_43_029: [ file_read_async shall call ReadFile with handle, destination, size and the allocated OVERLAPPED struct.]*/
+        issued = ReadFile(handle->h_file, io_context->buffer, size, NULL, &io_context->ov);
+    }
+
+    if (issued == FALSE)
+    {
+        if (GetLastError() == ERROR_IO_PENDING)
+        {
+            /*Codes_SRS_FILE_WIN32_43_022: [ If WriteFile fails synchronously and GetLastError indicates ERROR_IO_PENDING then file_write_async shall succeed and return FILE_WRITE_ASYNC_OK.]*/
+            /*Codes_SRS_FILE_WIN32_43_030: [ If ReadFile fails synchronously and GetLastError indicates ERROR_IO_PENDING then file_read_async shall succeed and return FILE_READ_ASYNC_OK. ]*/
+            result = 0;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_WIN32_43_023: [ If WriteFile fails synchronously and GetLastError does not indicate ERROR_IO_PENDING then file_write_async shall fail, call CancelThreadpoolIo and return FILE_WRITE_ASYNC_WRITE_ERROR.]*/
+            /*Codes_SRS_FILE_WIN32_43_031: [ If ReadFile fails synchronously and GetLastError does not indicate ERROR_IO_PENDING then file_read_async shall fail, call CancelThreadpoolIo and return FILE_READ_ASYNC_WRITE_ERROR. ]*/
+            LogLastError("failure in %s", is_write ? "WriteFile" : "ReadFile");
+            CancelThreadpoolIo(handle->ptp_io);
+            result = MU_FAILURE;
+        }
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_43_024: [ If WriteFile succeeds synchronously then file_write_async shall succeed, call CancelThreadpoolIo, call user_callback and return FILE_WRITE_ASYNC_OK.]*/
+        /*Codes_SRS_FILE_WIN32_43_032: [ If ReadFile succeeds synchronously then file_read_async shall succeed, call CancelThreadpoolIo, call user_callback and return FILE_READ_ASYNC_OK. ]*/
+        CancelThreadpoolIo(handle->ptp_io);
+
+        if (is_write)
+        {
+            /*Codes_SRS_FILE_WIN32_01_217: [ If a write succeeds synchronously and a read-ahead policy is set, read_ahead_invalidate shall be called with the position and size of the write before its user_callback or write_aggregator_io_complete is called. ]*/
+            invalidate_read_ahead_of_write(handle, position, size);
+        }
+
+        if (io_context->is_admitted)
+        {
+            /*Codes_SRS_FILE_WIN32_01_155: [ If the I/O completes synchronously and holds slots of the I/O limits, issue_io shall call release_io_slots before calling user_callback. ]*/
+            release_io_slots(handle);
+        }
+
+        io_context->user_callback(io_context->user_context, true);
+
+        /*the batched I/Os have no event*/
+        if (
+            (io_context->ov.hEvent != NULL) &&
+            !CloseHandle(io_context->ov.hEvent)
+            )
+        {
+            LogLastError("Failure in CloseHandle");
+        }
+        result = 0;
+    }
+
+    if (
+        (result == 0) &&
+        is_write
+        )
+    {
+        /*Codes_SRS_FILE_WIN32_01_088: [ If the write was issued, file_write_async shall call preallocate_ahead_if_needed with position + size. ]*/
+        preallocate_ahead_if_needed(handle, position + size);
+    }
+
+    if (
+        (result == 0) &&
+        (issued != FALSE)
+        )
+    {
+        io_context_pool_release(handle->io_context_pool, io_context);
+    }
+
+    return result;
+}
+
+/*issues an I/O that holds its slots of the I/O limits (or when there are no limits), returns 0 if the I/O is pending or completed synchronously, non-zero if it failed (the context is left to the caller)*/
+static int issue_io(FILE_HANDLE handle, FILE_WIN32_IO* io_context)
+{
+    int result;
+
+    if (io_context == &handle->flush_io)
+    {
+        /*Codes_SRS_FILE_WIN32_01_232: [ If the I/O is the flush of the file handle, issue_io shall call TrySubmitThreadpoolCallback with on_file_flush_win32 and the threadpool environment of the file handle. ]*/
+        if (!TrySubmitThreadpoolCallback(on_file_flush_win32, handle, &handle->cbe))
+        {
+            LogLastError("failure in TrySubmitThreadpoolCallback");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            result = 0;
+        }
+    }
+    else if (io_context->aggregated_io != NULL)
+    {
+        /*Codes_SRS_FILE_WIN32_01_233: [ If the I/O is an aggregated write, issue_io shall call issue_aggregated_write_io. ]*/
+        result = issue_aggregated_write_io(handle, io_context);
+    }
+    else if (io_context->read_ahead_io != NULL)
+    {
+        /*Codes_SRS_FILE_WIN32_01_234: [ If the I/O is a read-ahead block read, issue_io shall call issue_read_ahead_io. ]*/
+        result = issue_read_ahead_io(handle, io_context);
+    }
+    else if (io_context->vectored_io != NULL)
+    {
+        /*Codes_SRS_FILE_WIN32_01_235: [ If the I/O is a vectored operation, issue_io shall call start_vectored_io. ]*/
+        result = start_vectored_io(handle, io_context->vectored_io);
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_236: [ Otherwise issue_io shall call WriteFile or ReadFile for the I/O stored in the context by file_write_async, file_read_async or file_batch_submit. ]*/
+        result = issue_single_io(handle, io_context);
+    }
+
+    return result;
+}
+
+static void end_queued_io(FILE_HANDLE handle)
+{
+    /*Codes_SRS_FILE_WIN32_01_156: [ end_queued_io shall decrement the number of queued I/Os and wake up file_destroy by calling wake_by_address_single if it reaches 0. ]*/
+    if (interlocked_decrement(&handle->pending_queued_io_count) == 0)
+    {
+        wake_by_address_single(&handle->pending_queued_io_count);
+    }
+}
+
+static void fail_queued_io(FILE_WIN32_IO* io_context)
+{
+    FILE_HANDLE handle = io_context->handle;
+
+    /*Codes_SRS_FILE_01_120: [ If a queued I/O fails to start, its user_callback shall be called with user_context and is_successful as false. ]*/
+    /*Codes_SRS_FILE_WIN32_01_237: [ fail_queued_io shall mark the I/O as not holding slots of the I/O limits. ]*/
+    io_context->is_admitted = false;
+
+    if (io_context == &handle->flush_io)
+    {
+        /*Codes_SRS_FILE_WIN32_01_238: [ If the I/O is the flush of the file handle, fail_queued_io shall call the user_callback of all the requests served by the flush with is_successful as false, release them to the I/O context pool, mark the flush as not in progress, start a new flush if requests were added and decrement the number of pending flushes. ]*/
+        end_flush(handle, false);
+    }
+    else if (io_context->aggregated_io != NULL)
+    {
+        WRITE_AGGREGATOR_IO* aggregated_io = io_context->aggregated_io;
+
+        /*Codes_SRS_FILE_WIN32_01_239: [ If the I/O is an aggregated write, fail_queued_io shall release the context and call write_aggregator_io_complete with is_successful as false. ]*/
+        io_context_pool_release(handle->io_context_pool, io_context);
+        write_aggregator_io_complete(handle->write_aggregator, aggregated_io, false);
+    }
+    else if (io_context->read_ahead_io != NULL)
+    {
+        READ_AHEAD_IO* read_ahead_io = io_context->read_ahead_io;
+
+        /*Codes_SRS_FILE_WIN32_01_240: [ If the I/O is a read-ahead block read, fail_queued_io shall release the context and call read_ahead_io_complete with is_successful as false and 0 bytes read. ]*/
+        io_context_pool_release(handle->io_context_pool, io_context);
+        read_ahead_io_complete(handle->read_ahead, read_ahead_io, false, 0);
+    }
+    else if (io_context->vectored_io != NULL)
+    {
+        FILE_WIN32_VECTORED_IO* vectored_io = io_context->vectored_io;
+        FILE_CB user_callback = vectored_io->user_callback;
+        void* user_context = vectored_io->user_context;
+
+        /*Codes_SRS_FILE_WIN32_01_241: [ If the I/O is a vectored operation, fail_queued_io shall release the vectored operation context and call user_callback with is_successful as false. ]*/
+        io_context_pool_release(handle->io_context_pool, vectored_io);
+        user_callback(user_context, false);
+    }
+    else
+    {
+        FILE_CB user_callback = io_context->user_callback;
+        void* user_context = io_context->user_context;
+
+        /*Codes_SRS_FILE_WIN32_01_157: [ Otherwise fail_queued_io shall close the event of the OVERLAPPED struct if the I/O has one, release the context and call user_callback with is_successful as false. ]*/
+        if (
+            (io_context->ov.hEvent != NULL) &&
+            !CloseHandle(io_context->ov.hEvent)
+            )
+        {
+            LogLastError("Failure in CloseHandle");
+        }
+        io_context_pool_release(handle->io_context_pool, io_context);
+
+        user_callback(user_context, false);
+    }
+}
+
+static void on_file_io_admitted_by_engine(void* context)
+{
+    FILE_WIN32_IO* io_context = context;
+    FILE_HANDLE handle = io_context->handle;
+
+    /*Codes_SRS_FILE_WIN32_01_158: [ on_file_io_admitted_by_engine shall call issue_io. ]*/
+    if (issue_io(handle, io_context) != 0)
+    {
+        /*Codes_SRS_FILE_WIN32_01_159: [ If issue_io fails, on_file_io_admitted_by_engine shall call release_io_slots and fail_queued_io. ]*/
+        release_io_slots(handle);
+        fail_queued_io(io_context);
+    }
+
+    /*Codes_SRS_FILE_WIN32_01_160: [ on_file_io_admitted_by_engine shall call end_queued_io. ]*/
+    end_queued_io(handle);
+}
+
+/*returns IO_ADMISSION_ADMITTED, IO_ADMISSION_QUEUED (on_file_io_admitted_by_engine is called later) or IO_ADMISSION_ERROR*/
+static IO_ADMISSION_RESULT acquire_engine_io_slot(FILE_WIN32_IO* io_context)
+{
+    IO_ADMISSION_RESULT result;
+    FILE_HANDLE handle = io_context->handle;
+
+    if (handle->engine_io_admission == NULL)
+    {
+        result = IO_ADMISSION_ADMITTED;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_161: [ acquire_engine_io_slot shall call io_admission_acquire on the admission of the execution engine with on_file_io_admitted_by_engine as on_admitted. ]*/
+        io_context->admission_waiter.on_admitted = on_file_io_admitted_by_engine;
+        io_context->admission_waiter.on_admitted_context = io_context;
+        /*Codes_SRS_FILE_WIN32_01_195: [ acquire_io_slots and acquire_engine_io_slot shall call io_admission_acquire with the admission priority of the file handle as priority of the waiter. ]*/
+        io_context->admission_waiter.priority = handle->admission_priority;
+        result = io_admission_acquire(handle->engine_io_admission, &io_context->admission_waiter);
+        if (result == IO_ADMISSION_ERROR)
+        {
+            /*Codes_SRS_FILE_WIN32_01_162: [ If io_admission_acquire fails, acquire_engine_io_slot shall release the slot of the file handle admission. ]*/
+            LogError("failure in io_admission_acquire");
+            if (handle->io_admission != NULL)
+            {
+                io_admission_release(handle->io_admission);
+            }
+        }
+    }
+
+    return result;
+}
+
+static void on_file_io_admitted_by_handle(void* context)
+{
+    FILE_WIN32_IO* io_context = context;
+    FILE_HANDLE handle = io_context->handle;
+
+    /*Codes_SRS_FILE_WIN32_01_163: [ on_file_io_admitted_by_handle shall call acquire_engine_io_slot. ]*/
+    IO_ADMISSION_RESULT admission_result = acquire_engine_io_slot(io_context);
+    if (admission_result == IO_ADMISSION_ADMITTED)
+    {
+        /*Codes_SRS_FILE_WIN32_01_164: [ If acquire_engine_io_slot returns IO_ADMISSION_ADMITTED, on_file_io_admitted_by_handle shall call on_file_io_admitted_by_engine. ]*/
+        on_file_io_admitted_by_engine(io_context);
+    }
+    else if (admission_result == IO_ADMISSION_QUEUED)
+    {
+        /*Codes_SRS_FILE_WIN32_01_165: [ If acquire_engine_io_slot returns IO_ADMISSION_QUEUED, on_file_io_admitted_by_handle shall return. ]*/
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_166: [ If acquire_engine_io_slot fails, on_file_io_admitted_by_handle shall call fail_queued_io and end_queued_io. ]*/
+        fail_queued_io(io_context);
+        end_queued_io(handle);
+    }
+}
+
+/*returns IO_ADMISSION_ADMITTED (the I/O holds its slots or there is no limit), IO_ADMISSION_QUEUED (the I/O is issued by on_file_io_admitted_by_handle or on_file_io_admitted_by_engine), IO_ADMISSION_BUSY or IO_ADMISSION_ERROR*/
+static IO_ADMISSION_RESULT acquire_io_slots(FILE_WIN32_IO* io_context, FILE_IO_LIMIT_MODE io_limit_mode)
+{
+    IO_ADMISSION_RESULT result;
+    FILE_HANDLE handle = io_context->handle;
+
+    /*Codes_SRS_FILE_01_117: [ An I/O issued by file_write_async or file_read_async shall hold a slot of the I/O limit of handle and of the I/O limit of the execution engine from the moment it is started until it completes. ]*/
+    /*Codes_SRS_FILE_01_143: [ The I/Os of file_write_async_v, file_read_async_v and of the batches, the aggregated writes, the reads of read-ahead blocks and the flushes of handle shall also hold a slot of the I/O limit of handle and of the I/O limit of the execution engine from the moment they are started until they complete. ]*/
+    io_context->is_admitted = (handle->io_admission != NULL) || (handle->engine_io_admission != NULL);
+    if (!io_context->is_admitted)
+    {
+        /*Codes_SRS_FILE_WIN32_01_167: [ If neither the file handle nor the execution engine have an I/O limit, acquire_io_slots shall return IO_ADMISSION_ADMITTED. ]*/
+        result = IO_ADMISSION_ADMITTED;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_169: [ If the file handle or the execution engine has an I/O limit, acquire_io_slots shall increment the number of queued I/Os before acquiring the slots. ]*/
+        (void)interlocked_increment(&handle->pending_queued_io_count);
+
+        if (handle->io_admission == NULL)
+        {
+            result = IO_ADMISSION_ADMITTED;
+        }
+        else if (io_limit_mode == FILE_IO_LIMIT_MODE_BUSY)
+        {
+            /*Codes_SRS_FILE_WIN32_01_168: [ If io_limit_mode is FILE_IO_LIMIT_MODE_BUSY, acquire_io_slots shall call io_admission_try_acquire on the admission of the file handle, if it exists. ]*/
+            result = io_admission_try_acquire(handle->io_admission);
+        }
+        else
+        {
+            /*Codes_SRS_FILE_WIN32_01_170: [ If io_limit_mode is FILE_IO_LIMIT_MODE_QUEUE, acquire_io_slots shall call io_admission_acquire on the admission of the file handle with on_file_io_admitted_by_handle as on_admitted, if it exists. ]*/
+            io_context->admission_waiter.on_admitted = on_file_io_admitted_by_handle;
+            io_context->admission_waiter.on_admitted_context = io_context;
+            /*Codes_SRS_FILE_WIN32_01_195: [ acquire_io_slots and acquire_engine_io_slot shall call io_admission_acquire with the admission priority of the file handle as priority of the waiter. ]*/
+            io_context->admission_waiter.priority = handle->admission_priority;
+            result = io_admission_acquire(handle->io_admission, &io_context->admission_waiter);
+        }
+
+        if (result == IO_ADMISSION_ADMITTED)
+        {
+            /*the I/O limit of the execution engine is shared by all the files, its waiters are always queued so that they are started in priority order, whatever the mode of handle*/
+            /*Codes_SRS_FILE_WIN32_01_171: [ If the file handle admission returns IO_ADMISSION_ADMITTED or the file handle has no I/O limit, acquire_io_slots shall call acquire_engine_io_slot, whatever the mode. ]*/
+            result = acquire_engine_io_slot(io_context);
+        }
+
+        if (result != IO_ADMISSION_QUEUED)
+        {
+            /*Codes_SRS_FILE_WIN32_01_172: [ If the I/O was not queued, acquire_io_slots shall call end_queued_io. ]*/
+            end_queued_io(handle);
+        }
+    }
+
+    return result;
+}
+
+static FILE_WIN32_START_IO_RESULT start_io(FILE_HANDLE handle, FILE_WIN32_IO* io_context, FILE_IO_LIMIT_MODE io_limit_mode)
+{
+    FILE_WIN32_START_IO_RESULT result;
+
+    /*Codes_SRS_FILE_WIN32_01_242: [ start_io shall call acquire_io_slots with io_limit_mode. ]*/
+    IO_ADMISSION_RESULT admission_result = acquire_io_slots(io_context, io_limit_mode);
+    if (admission_result == IO_ADMISSION_ADMITTED)
+    {
+        /*Codes_SRS_FILE_WIN32_01_243: [ If acquire_io_slots returns IO_ADMISSION_ADMITTED, start_io shall call issue_io. ]*/
+        if (issue_io(handle, io_context) != 0)
+        {
+            /*Codes_SRS_FILE_WIN32_01_173: [ If issue_io fails, start_io shall call release_io_slots if the I/O holds slots and return FILE_WIN32_START_IO_ISSUE_ERROR. ]*/
+            if (io_context->is_admitted)
+            {
+                release_io_slots(handle);
+            }
+            result = FILE_WIN32_START_IO_ISSUE_ERROR;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_WIN32_01_174: [ If the I/O holds its slots and issue_io succeeds, start_io shall return FILE_WIN32_START_IO_OK. ]*/
+            result = FILE_WIN32_START_IO_OK;
+        }
+    }
+    else if (admission_result == IO_ADMISSION_QUEUED)
+    {
+        /*Codes_SRS_FILE_01_119: [ When the mode is FILE_IO_LIMIT_MODE_QUEUE and no slot of the I/O limit of handle is free, or when no slot of the I/O limit of the execution engine is free, file_write_async and file_read_async shall queue the I/O and return FILE_WRITE_ASYNC_OK and FILE_READ_ASYNC_OK, the queued I/Os are started in order as slots are freed. ]*/
+        /*Codes_SRS_FILE_WIN32_01_175: [ If the I/O was queued, start_io shall return FILE_WIN32_START_IO_OK. ]*/
+        result = FILE_WIN32_START_IO_OK;
+    }
+    else if (admission_result == IO_ADMISSION_BUSY)
+    {
+        /*Codes_SRS_FILE_WIN32_01_176: [ If io_admission_try_acquire returns IO_ADMISSION_BUSY, start_io shall return FILE_WIN32_START_IO_BUSY. ]*/
+        result = FILE_WIN32_START_IO_BUSY;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_177: [ If acquiring a slot fails, start_io shall return FILE_WIN32_START_IO_ERROR. ]*/
+        LogError("failure acquiring a slot for the I/O");
+        result = FILE_WIN32_START_IO_ERROR;
+    }
+
+    return result;
+}
+
+static VOID NTAPI on_close_threadpool_group_member(
+    PVOID object_context,
+    PVOID cleanup_context
+)
+{
+    (void)object_context;
+    (void)cleanup_context;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, FILE_HANDLE, file_create, EXECUTION_ENGINE_HANDLE, execution_engine, const char*, full_file_name, FILE_REPORT_FAULT, user_report_fault_callback, void*, user_report_fault_context)
+{
+    FILE_HANDLE result;
+    if (
+        /*Codes_SRS_FILE_43_033: [ If execution_engine is NULL, file_create shall fail and return NULL. ]*/
+        /*Codes_SRS_FILE_WIN32_43_040: [ If execution_engine is NULL, file_create shall fail and return NULL. ]*/
+        (execution_engine == NULL) ||
+        /*Codes_SRS_FILE_43_002: [ If full_file_name is NULL then file_create shall fail and return NULL. ]*/
+        /*Codes_SRS_FILE_WIN32_43_048: [ If full_file_name is NULL then file_create shall fail and return NULL. ]*/
+        (full_file_name == NULL) ||
+        /*Codes_SRS_FILE_43_037: [ If full_file_name is an empty string, file_create shall fail and return NULL. ]*/
+        /*Codes_SRS_FILE_WIN32_43_059: [ If full_file_name is an empty string, file_create shall fail and return NULL. ]*/
+        (full_file_name[0] == '\0')
+        )
+    {
+        LogError("Invalid arguments to file_create: EXECUTION_ENGINE_HANDLE execution_engine=%p, const char* full_file_name=%s, FILE_REPORT_FAULT user_report_callback=%p, void* user_report_faul_context=%p",
+            execution_engine, MU_P_OR_NULL(full_file_name), user_report_fault_callback, user_report_fault_context);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_43_041: [ file_create shall allocate a FILE_HANDLE. ]*/
+        result = malloc(sizeof(FILE_HANDLE_DATA));
+        if (result == NULL)
+        {
+            /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
+            /*Codes_SRS_FILE_WIN32_43_008: [ If there are any failures, file_create shall return NULL. ]*/
+            LogError("Failure in malloc");
+        }
+        else
+        {
+            bool succeeded;
+            /* Codes_SRS_FILE_WIN32_01_001: [ file_create shall increment the reference count of execution_engine in order to hold on to it. ]*/
+            execution_engine_inc_ref(execution_engine);
+            result->execution_engine = execution_engine;
+
+            /*Codes_SRS_FILE_WIN32_01_031: [ file_create shall create a pool of I/O contexts by calling io_context_pool_create with a context size that fits a vectored operation with up to FILE_WIN32_POOLED_BUFFER_COUNT buffers and FILE_WIN32_IO_CONTEXT_POOL_SIZE as the maximum number of cached contexts. ]*/
+            result->io_context_pool = io_context_pool_create(FILE_WIN32_IO_CONTEXT_SIZE, FILE_WIN32_IO_CONTEXT_POOL_SIZE);
+            if (result->io_context_pool == NULL)
+            {
+                /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
+                /*Codes_SRS_FILE_WIN32_43_008: [ If there are any failures, file_create shall return NULL. ]*/
+                LogError("Failure in io_context_pool_create, full_file_name=%s", full_file_name);
+                succeeded = false;
+            }
+            else
+            {
+                /*Codes_SRS_FILE_43_003: [ If a file with name full_file_name does not exist, file_create shall create a file with that name.]*/
+                /*Codes_SRS_FILE_43_001: [ file_create shall open the file named full_file_name for asynchronous operations and return its handle. ]*/
+                /*Codes_SRS_FILE_WIN32_43_001: [ file_create shall call CreateFileA with full_file_name as lpFileName, GENERIC_READ|GENERIC_WRITE as dwDesiredAccess, FILE_SHARED_READ as dwShareMode, NULL as lpSecurityAttributes, OPEN_ALWAYS as dwCreationDisposition, FILE_FLAG_OVERLAPPED|FILE_FLAG_WRITE_THROUGH as dwFlagsAndAttributes and NULL as hTemplateFile. ]*/
+                result->h_file = CreateFileA(
+                    full_file_name,                                     /* LPCTSTR               lpFileName*/
+                    GENERIC_READ | GENERIC_WRITE,                       /* DWORD                 dwDesiredAccess*/
+                    FILE_SHARE_READ,                                    /* DWORD                 dwShareMode*/
+                    NULL,                                               /* LPSECURITY_ATTRIBUTES lpSecurityAttributes*/
+                    OPEN_ALWAYS,                                        /* DWORD                 dwCreationDisposition*/
+                    FILE_FLAG_OVERLAPPED | FILE_FLAG_WRITE_THROUGH,     /* DWORD                 dwFlagsAndAttributes*/
+                    NULL                                                /* HANDLE                hTemplateFile*/
+                    );
+                if ( result->h_file == INVALID_HANDLE_VALUE)
+                {
+                    /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
+                    /*Codes_SRS_FILE_WIN32_43_008: [ If there are any failures, file_create shall return NULL. ]*/
+                    LogLastError("Failure in CreateFileA, full_file_name=%s", full_file_name);
+                    succeeded = false;
+                }
+                else
+                {
+                    /*Codes_SRS_FILE_WIN32_43_002: [ file_create shall call SetFileCompletionNotificationModes to disable calling the completion port when an async operations finishes synchrounously.]*/
+                    if (!SetFileCompletionNotificationModes(result->h_file, FILE_SKIP_COMPLETION_PORT_ON_SUCCESS))
+                    {
+                        /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
+                        /*Codes_SRS_FILE_WIN32_43_008: [ If there are any failures, file_create shall return NULL. ]*/
+                        LogLastError("Failure in SetFileCompletionNotificationModes, full_file_name=%s", full_file_name);
+                        succeeded = false;
+                    }
+                    else
+                    {
+                        /*Codes_SRS_FILE_WIN32_43_003: [ file_create shall initialize a threadpool environment by calling InitializeThreadpolEnvironment.]*/
+                        InitializeThreadpoolEnvironment(&result->cbe);
+
+                        /*Codes_SRS_FILE_WIN32_43_004: [ file_create shall obtain the PTP_POOL of the NUMA node of the calling thread by calling sysinfo_get_current_numa_node and execution_engine_win32_get_numa_node_threadpool on execution_engine.]*/
+                        result->ptp_pool = execution_engine_win32_get_numa_node_threadpool(execution_engine, sysinfo_get_current_numa_node());
+                        if (result->ptp_pool == NULL)
+                        {
+                            /*Codes_SRS_FILE_WIN32_43_069: [ If execution_engine_win32_get_numa_node_threadpool fails, file_create shall obtain the PTP_POOL by calling execution_engine_win32_get_threadpool on execution_engine.]*/
+                            LogWarning("execution_engine_win32_get_numa_node_threadpool failed, using the execution engine threadpool, full_file_name=%s", full_file_name);
+                            result->ptp_pool = execution_engine_win32_get_threadpool(execution_engine);
+                        }
+
+                        /*Codes_SRS_FILE_WIN32_43_005: [ file_create shall register the threadpool environment by calling SetThreadpoolCallbackPool on the initialized threadpool environment and the obtained ptp_pool ]*/
+                        SetThreadpoolCallbackPool(&result->cbe, result->ptp_pool);
+
+                        /*Codes_SRS_FILE_WIN32_43_006: [ file_create shall create a cleanup group by calling CreateThreadpoolCleanupGroup.]*/
+                        result->ptp_cleanup_group = CreateThreadpoolCleanupGroup();
+
+                        if (result->ptp_cleanup_group == NULL)
+                        {
+                            /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
+                            LogLastError("Failure in CreateThreadpoolCleanupGroup, full_file_name=%s", full_file_name);
+                            succeeded = false;
+                        }
+                        else
+                        {
+                            /*Codes_SRS_FILE_WIN32_43_007: [ file_create shall register the cleanup group with the threadpool environment by calling SetThreadpoolCallbackCleanupGroup.]*/
+                            SetThreadpoolCallbackCleanupGroup(&result->cbe, result->ptp_cleanup_group, on_close_threadpool_group_member);
+
+                            /*Codes_SRS_FILE_WIN32_43_033: [ file_create shall create a threadpool io with the allocated FILE_HANDLE and on_file_io_complete_win32 as a callback by calling CreateThreadpoolIo]*/
+                            result->ptp_io = CreateThreadpoolIo(result->h_file, on_file_io_complete_win32, NULL, &result->cbe);
+                        
+                            if (result->ptp_io == NULL)
+                            {
+                                /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
+                                /*Codes_SRS_FILE_WIN32_43_008: [ If there are any failures, file_create shall return NULL. ]*/
+                                LogLastError("Failure in CreateThreadpoolIo, full_file_name=%s", full_file_name);
+                                succeeded = false;
+                            }
+                            else
+                            {
+                                /*Codes_SRS_FILE_WIN32_43_009: [ file_create shall succeed and return a non - NULL value.]*/
+                                succeeded = true;
+                                result->user_report_fault_callback = user_report_fault_callback;
+                                result->user_report_fault_context = user_report_fault_context;
+
+                                /*Codes_SRS_FILE_WIN32_01_037: [ file_create shall initialize the list of flush requests as empty, mark the flush as not in progress, set the number of pending flushes to 0 and initialize the flush context with the file handle. ]*/
+                                (void)interlocked_exchange_pointer(&result->flush_requests, NULL);
+                                (void)interlocked_exchange(&result->flush_in_progress, 0);
+                                (void)interlocked_exchange(&result->pending_flush_count, 0);
+                                result->flushing_requests = NULL;
+                                (void)memset(&result->flush_io, 0, sizeof(FILE_WIN32_IO));
+                                result->flush_io.handle = result;
+
+                                /*Codes_SRS_FILE_WIN32_01_073: [ file_create shall set no preallocation policy on the file handle and mark the preallocation as not in progress. ]*/
+                                result->preallocation_chunk_size = 0;
+                                (void)interlocked_exchange(&result->preallocation_in_progress, 0);
+
+                                /*Codes_SRS_FILE_WIN32_01_097: [ file_create shall set no write aggregation policy on the file handle. ]*/
+                                result->write_aggregator = NULL;
+                                result->aggregation_timer = NULL;
+
+                                /*Codes_SRS_FILE_WIN32_01_121: [ file_create shall set no read-ahead policy on the file handle and set the number of pending copied reads to 0. ]*/
+                                result->read_ahead = NULL;
+                                (void)interlocked_exchange(&result->pending_copied_read_count, 0);
+
+                                /*Codes_SRS_FILE_WIN32_01_182: [ file_create shall obtain the I/O limit of the execution engine by calling execution_engine_win32_get_io_admission, set no I/O limit on the file handle, with the mode FILE_IO_LIMIT_MODE_QUEUE, and set the number of queued I/Os to 0. ]*/
+                                result->engine_io_admission = execution_engine_win32_get_io_admission(execution_engine);
+                                result->io_admission = NULL;
+                                result->io_limit_mode = FILE_IO_LIMIT_MODE_QUEUE;
+                                result->is_io_limit_set = false;
+                                (void)interlocked_exchange(&result->pending_queued_io_count, 0);
+
+                                /*Codes_SRS_FILE_WIN32_01_191: [ file_create shall set the admission priority of the file handle to IO_ADMISSION_PRIORITY_NORMAL. ]*/
+                                result->admission_priority = IO_ADMISSION_PRIORITY_NORMAL;
+
+                                /*Codes_SRS_FILE_WIN32_01_196: [ file_create shall set the number of pending copies to 0. ]*/
+                                (void)interlocked_exchange(&result->pending_copy_count, 0);
+                            }
+                        
+                            if (!succeeded)
+                            {
+                                CloseThreadpoolCleanupGroup(result->ptp_cleanup_group);
+                            }
+                        }
+                        if (!succeeded)
+                        {
+                            DestroyThreadpoolEnvironment(&result->cbe);
+                        }
+                    }
+                    if (!succeeded)
+                    {
+                        if (!CloseHandle(result->h_file))
+                        {
+                            LogLastError("Failure in CloseHandle, full_file_name=%s", full_file_name);
+                        }
+                    }
+                }
+                if (!succeeded)
+                {
+                    io_context_pool_destroy(result->io_context_pool);
+                }
+            }
+            /*Codes_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
+            if (!succeeded)
+            {
+                execution_engine_dec_ref(result->execution_engine);
+                free(result);
+                result = NULL;
+            }
+        }
+    }
+    return result;
+}
+
+
+IMPLEMENT_MOCKABLE_FUNCTION(, void, file_destroy, FILE_HANDLE, handle)
+{
+    
+    if (handle == NULL)
+    {
+        /*Codes_SRS_FILE_43_005: [ If handle is NULL, file_destroy shall return. ]*/
+        /*Codes_SRS_FILE_WIN32_43_049: [ If handle is NULL, file_destroy shall return.]*/
+        LogError("Invalid argument to file_destroy: FILE_HANDLE=%p", handle);
+    }
+    else
+    {
+        if (handle->write_aggregator != NULL)
+        {
+            /*Codes_SRS_FILE_WIN32_01_098: [ If a write aggregation policy is set, file_destroy shall call write_aggregator_flush to start writing the aggregated data that is not written yet. ]*/
+            write_aggregator_flush(handle->write_aggregator);
+        }
+
+        /*Codes_SRS_FILE_43_006: [ file_destroy shall wait for all pending I/O operations to complete. ]*/
+        /*Codes_SRS_FILE_WIN32_01_038: [ file_destroy shall wait for the number of pending flushes to reach 0 by calling wait_on_address. ]*/
+        int32_t pending_flush_count;
+        while ((pending_flush_count = interlocked_add(&handle->pending_flush_count, 0)) != 0)
+        {
+            (void)wait_on_address(&handle->pending_flush_count, pending_flush_count, UINT32_MAX);
+        }
+
+        /*Codes_SRS_FILE_WIN32_01_122: [ file_destroy shall wait for the number of pending copied reads to reach 0 by calling wait_on_address. ]*/
+        int32_t pending_copied_read_count;
+        while ((pending_copied_read_count = interlocked_add(&handle->pending_copied_read_count, 0)) != 0)
+        {
+            (void)wait_on_address(&handle->pending_copied_read_count, pending_copied_read_count, UINT32_MAX);
+        }
+
+        /*Codes_SRS_FILE_WIN32_01_183: [ file_destroy shall wait for the number of queued I/Os to reach 0 by calling wait_on_address. ]*/
+        int32_t pending_queued_io_count;
+        while ((pending_queued_io_count = interlocked_add(&handle->pending_queued_io_count, 0)) != 0)
+        {
+            (void)wait_on_address(&handle->pending_queued_io_count, pending_queued_io_count, UINT32_MAX);
+        }
+
+        /*Codes_SRS_FILE_WIN32_01_197: [ file_destroy shall wait for the number of pending copies to reach 0 by calling wait_on_address. ]*/
+        int32_t pending_copy_count;
+        while ((pending_copy_count = interlocked_add(&handle->pending_copy_count, 0)) != 0)
+        {
+            (void)wait_on_address(&handle->pending_copy_count, pending_copy_count, UINT32_MAX);
+        }
+
+        /*Codes_SRS_FILE_WIN32_01_074: [ file_destroy shall wait for the preallocation in progress, if any, to complete by calling wait_on_address. ]*/
+        while (interlocked_add(&handle->preallocation_in_progress, 0) != 0)
+        {
+            (void)wait_on_address(&handle->preallocation_in_progress, 1, UINT32_MAX);
+        }
+
+        if (handle->write_aggregator != NULL)
+        {
+            /*Codes_SRS_FILE_WIN32_01_099: [ If a write aggregation policy is set, file_destroy shall cancel the aggregation timer by calling SetThreadpoolTimer with NULL as due time and wait for its callbacks by calling WaitForThreadpoolTimerCallbacks. ]*/
+            SetThreadpoolTimer(handle->aggregation_timer, NULL, 0, 0);
+            WaitForThreadpoolTimerCallbacks(handle->aggregation_timer, TRUE);
+        }
+
+        /*Codes_SRS_FILE_WIN32_43_011: [ file_destroy shall wait for all I/O to complete by calling WaitForThreadpoolIoCallbacks. ]*/
+        WaitForThreadpoolIoCallbacks(handle->ptp_io, FALSE);
+
+        if (handle->write_aggregator != NULL)
+        {
+            /*Codes_SRS_FILE_WIN32_01_100: [ If a write aggregation policy is set, file_destroy shall call write_aggregator_destroy and CloseThreadpoolTimer once all I/O completed. ]*/
+            write_aggregator_destroy(handle->write_aggregator);
+            CloseThreadpoolTimer(handle->aggregation_timer);
+        }
+        if (handle->read_ahead != NULL)
+        {
+            /*Codes_SRS_FILE_WIN32_01_123: [ If a read-ahead policy is set, file_destroy shall call read_ahead_destroy once all I/O completed. ]*/
+            read_ahead_destroy(handle->read_ahead);
+        }
+        if (handle->io_admission != NULL)
+        {
+            /*Codes_SRS_FILE_WIN32_01_184: [ If an I/O limit is set on the file handle, file_destroy shall call io_admission_destroy once all I/O completed. ]*/
+            io_admission_destroy(handle->io_admission);
+        }
+        /*Codes_SRS_FILE_WIN32_43_012: [ file_destroy shall close the cleanup group by calling CloseThreadpoolCleanupGroup. ]*/
+        CloseThreadpoolCleanupGroup(handle->ptp_cleanup_group);
+        /*Codes_SRS_FILE_WIN32_43_013: [ file_destroy shall destroy the environment by calling DestroyThreadpoolEnvironment. ]*/
+        DestroyThreadpoolEnvironment(&(handle->cbe));
+        /*Codes_SRS_FILE_43_007: [ file_destroy shall close the file handle handle. ]*/
+        /*Codes_SRS_FILE_WIN32_43_016: [ file_destroy shall call CloseHandle on the handle returned by CreateFileA. ]*/
+        if (!CloseHandle(handle->h_file))
+        {
+            LogLastError("failure in CloseHandle");
+        }
+        /*Codes_SRS_FILE_WIN32_43_015: [ file_destroy shall close the threadpool IO by calling CloseThreadPoolIo. ]*/
+        CloseThreadpoolIo(handle->ptp_io);
+        /*Codes_SRS_FILE_WIN32_01_032: [ file_destroy shall destroy the I/O context pool. ]*/
+        io_context_pool_destroy(handle->io_context_pool);
+        /*Codes_SRS_FILE_WIN32_01_002: [ file_destroy shall decrement the reference count for the execution engine. ]*/
+        execution_engine_dec_ref(handle->execution_engine);
+        /*Codes_SRS_FILE_WIN32_43_042: [ file_destroy shall free the handle.]*/
+        free(handle);
+    }
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, FILE_WRITE_ASYNC_RESULT, file_write_async, FILE_HANDLE, handle, const unsigned char*, source, uint32_t, size, uint64_t, position, FILE_CB, user_callback, void*, user_context
+)
+{
+    FILE_WRITE_ASYNC_RESULT result;
+    if
+    (
+        /*Codes_SRS_FILE_43_009: [ If handle is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_WIN32_43_043: [ If handle is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS.]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_43_010: [ If source is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_WIN32_43_044: [ If source is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS.]*/
+        (source == NULL) ||
+        /*Codes_SRS_FILE_43_012: [ If user_callback is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_WIN32_43_045: [ If user_callback is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS.]*/
+        (user_callback == NULL)||
+        /*Codes_SRS_FILE_43_040: [ If position + size is greater than INT64_MAX, then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_WIN32_43_060: [ If position + size is greater than INT64_MAX, then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        ((position + size) > INT64_MAX)||
+        /*Codes_SRS_FILE_43_042: [ If size is 0 then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_WIN32_43_061: [ If size is 0 then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        (size == 0)
+    )
+    {
+        LogError("Invalid arguments to file_write_async: FILE_HANDLE file_handle=%p, const unsigned char* source=%p, uin32_t size=%" PRIu32 ", uint64_t position=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
+            handle, source, size, position, user_callback, user_context);
+        result = FILE_WRITE_ASYNC_INVALID_ARGS;
+    }
+    else
+    {
+        if (handle->read_ahead != NULL)
+        {
+            /*Codes_SRS_FILE_01_100: [ When a read-ahead policy is set, file_write_async, file_write_async_v and file_batch_add_write shall drop the blocks that overlap the written range. ]*/
+            /*Codes_SRS_FILE_WIN32_01_124: [ If a read-ahead policy is set, file_write_async shall call read_ahead_invalidate with position and size. ]*/
+            read_ahead_invalidate(handle->read_ahead, position, size);
+        }
+
+        /*Codes_SRS_FILE_WIN32_01_101: [ If a write aggregation policy is set, file_write_async shall call write_aggregator_add with source, size, position, user_callback and user_context. ]*/
+        WRITE_AGGREGATOR_ADD_RESULT add_result = (handle->write_aggregator == NULL) ?
+            WRITE_AGGREGATOR_ADD_NOT_AGGREGATED :
+            write_aggregator_add(handle->write_aggregator, source, size, position, user_callback, user_context);
+
+        if (add_result == WRITE_AGGREGATOR_ADD_OK)
+        {
+            /*Codes_SRS_FILE_01_089: [ When a write aggregation policy is set, file_write_async shall copy writes smaller than max_aggregated_size that continue the previous write or start at an aligned position into the aggregation buffer and return FILE_WRITE_ASYNC_OK. ]*/
+            /*Codes_SRS_FILE_WIN32_01_102: [ If write_aggregator_add returns WRITE_AGGREGATOR_ADD_OK, file_write_async shall return FILE_WRITE_ASYNC_OK. ]*/
+            result = FILE_WRITE_ASYNC_OK;
+        }
+        else if (add_result == WRITE_AGGREGATOR_ADD_ERROR)
+        {
+            /*Codes_SRS_FILE_WIN32_01_103: [ If write_aggregator_add returns WRITE_AGGREGATOR_ADD_ERROR, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
+            LogError("failure in write_aggregator_add, size=%" PRIu32 ", position=%" PRIu64 "", size, position);
+            result = FILE_WRITE_ASYNC_ERROR;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_WIN32_01_104: [ If no write aggregation policy is set or write_aggregator_add returns WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, file_write_async shall issue the write by itself. ]*/
+            /*Codes_SRS_FILE_WIN32_43_018: [ file_write_async shall get a context to store the allocated OVERLAPPED struct, handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+            FILE_WIN32_IO* io_context = io_context_pool_get(handle->io_context_pool, sizeof(FILE_WIN32_IO));
+            if (io_context == NULL)
+            {
+                /*Codes_SRS_FILE_43_015: [ If there are any failures, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
+                /*Codes_SRS_FILE_WIN32_43_057: [ If there are any other failures, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR.]*/
+                LogError("failure in io_context_pool_get");
+                result = FILE_WRITE_ASYNC_ERROR;
+            }
+            else
+            {
+                io_context->handle = handle;
+                /*Codes_SRS_FILE_WIN32_43_020: [ file_write_async shall allocate an OVERLAPPED struct and populate it with the created event and position. ]*/
+                (void)memset(&io_context->ov, 0, sizeof(OVERLAPPED));
+                /*Codes_SRS_FILE_WIN32_43_054: [ file_write_async shall create an event by calling CreateEvent.]*/
+                io_context->ov.hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+                if (io_context->ov.hEvent == NULL)
+                {
+                    /*Codes_SRS_FILE_43_015: [ If there are any failures, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
+                    /*Codes_SRS_FILE_WIN32_43_057: [ If there are any other failures, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR.]*/
+                    LogLastError("failure in CreateEvent");
+                    result = FILE_WRITE_ASYNC_ERROR;
+                }
+                else
+                {
+                    io_context->ov.Offset = position & 0xFFFFFFFFULL;
+                    io_context->ov.OffsetHigh = position >> 32;
+
+                    io_context->user_callback = user_callback;
+                    io_context->user_context = user_context;
+
+                    io_context->size = size;
+                    io_context->vectored_io = NULL;
+                    io_context->aggregated_io = NULL;
+                    io_context->read_ahead_io = NULL;
+
+                    io_context->buffer = (void*)source;
+                    io_context->is_write = true;
+
+                    /*Codes_SRS_FILE_43_014: [ file_write_async shall enqueue a write request to write source's content to the position offset in the file. ]*/
+                    /*Codes_SRS_FILE_43_041: [ If position + size is greater than the size of the file and the call to write is successfull, file_write_async shall grow the file to accomodate the write. ]*/
+                    /*Codes_SRS_FILE_WIN32_01_178: [ file_write_async shall call start_io with the mode of the file handle, which calls WriteFile as described above once the write holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+                    FILE_WIN32_START_IO_RESULT start_result = start_io(handle, io_context, handle->io_limit_mode);
+                    if (start_result == FILE_WIN32_START_IO_OK)
+                    {
+                        /*Codes_SRS_FILE_43_008: [ file_write_async shall call user_call_back passing user_context and success depending on the success of the asynchronous write operation.]*/
+                        /*Codes_SRS_FILE_43_030: [ file_write_async shall succeed and return FILE_WRITE_ASYNC_OK. ]*/
+                        result = FILE_WRITE_ASYNC_OK;
+                    }
+                    else
+                    {
+                        if (start_result == FILE_WIN32_START_IO_ISSUE_ERROR)
+                        {
+                            /*Codes_SRS_FILE_43_035: [ If the call to write the file fails, file_write_async shall fail and return FILE_WRITE_ASYNC_WRITE_ERROR. ]*/
+                            result = FILE_WRITE_ASYNC_WRITE_ERROR;
+                        }
+                        else if (start_result == FILE_WIN32_START_IO_BUSY)
+                        {
+                            /*Codes_SRS_FILE_01_118: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and no slot of the I/O limit of handle is free, file_write_async shall fail and return FILE_WRITE_ASYNC_BUSY and file_read_async shall fail and return FILE_READ_ASYNC_BUSY, without calling user_callback. ]*/
+                            /*Codes_SRS_FILE_WIN32_01_179: [ If start_io returns FILE_WIN32_START_IO_BUSY, file_write_async shall close the event, release the context and return FILE_WRITE_ASYNC_BUSY. ]*/
+                            result = FILE_WRITE_ASYNC_BUSY;
+                        }
+                        else
+                        {
+                            /*Codes_SRS_FILE_43_015: [ If there are any failures, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
+                            /*Codes_SRS_FILE_WIN32_43_057: [ If there are any other failures, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR.]*/
+                            LogError("failure in start_io");
+                            result = FILE_WRITE_ASYNC_ERROR;
+                        }
+
+                        if (!CloseHandle(io_context->ov.hEvent))
+                        {
+                            LogLastError("Failure in CloseHandle");
+                        }
+                    }
+                }
+                if (result != FILE_WRITE_ASYNC_OK)
+                {
+                    io_context_pool_release(handle->io_context_pool, io_context);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, FILE_READ_ASYNC_RESULT, file_read_async, FILE_HANDLE, handle, unsigned char*, destination, uint32_t, size, uint64_t,position, FILE_CB, user_callback, void*, user_context)
+{
+    FILE_READ_ASYNC_RESULT result;
+    if
+    (
+        /*Codes_SRS_FILE_43_017: [ If handle is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_WIN32_43_046: [ If handle is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_43_032: [ If destination is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_WIN32_43_051: [ If destination is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (destination == NULL) ||
+        /*Codes_SRS_FILE_43_020: [ If user_callback is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_WIN32_43_047: [ If user_callback is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (user_callback == NULL) ||
+        /*Codes_SRS_FILE_43_043: [ If size is 0 then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_WIN32_43_062: [ If size is 0 then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (size == 0)
+    )
+    {
+        LogError("Invalid arguments to file_read_async: FILE_HANDLE file_handle=%p, unsigned char* destination=%p, uin32_t size=%" PRIu32 ", uint64_t position=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
+            handle, destination, size, position, user_callback, user_context);
+        result = FILE_READ_ASYNC_INVALID_ARGS;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_125: [ If a read-ahead policy is set, file_read_async shall call read_ahead_read with destination, size, position, user_callback and user_context. ]*/
+        READ_AHEAD_READ_RESULT read_ahead_result = (handle->read_ahead == NULL) ?
+            READ_AHEAD_READ_NOT_HANDLED :
+            read_ahead_read(handle->read_ahead, destination, size, position, user_callback, user_context);
+
+        if (read_ahead_result == READ_AHEAD_READ_OK)
+        {
+            /*Codes_SRS_FILE_01_098: [ When a read-ahead policy is set, file_read_async shall serve reads that fit in one block from the blocks of handle and, when the reads are sequential, keep up to block_count blocks following the read in flight. ]*/
+            /*Codes_SRS_FILE_WIN32_01_126: [ If read_ahead_read returns READ_AHEAD_READ_OK, file_read_async shall return FILE_READ_ASYNC_OK. ]*/
+            result = FILE_READ_ASYNC_OK;
+        }
+        else if (read_ahead_result == READ_AHEAD_READ_ERROR)
+        {
+            /*Codes_SRS_FILE_WIN32_01_127: [ If read_ahead_read returns READ_AHEAD_READ_ERROR, file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+            LogError("failure in read_ahead_read, size=%" PRIu32 ", position=%" PRIu64 "", size, position);
+            result = FILE_READ_ASYNC_ERROR;
+        }
+        else if (read_ahead_result == READ_AHEAD_READ_COPIED)
+        {
+            /*Codes_SRS_FILE_01_099: [ A read served from a block shall call user_callback asynchronously, after file_read_async returned. ]*/
+            /*Codes_SRS_FILE_WIN32_01_128: [ If read_ahead_read returns READ_AHEAD_READ_COPIED, file_read_async shall get a context from the I/O context pool by calling io_context_pool_get. ]*/
+            FILE_WIN32_IO* io_context = io_context_pool_get(handle->io_context_pool, sizeof(FILE_WIN32_IO));
+            if (io_context == NULL)
+            {
+                /*Codes_SRS_FILE_WIN32_01_129: [ If io_context_pool_get fails, file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+                LogError("failure in io_context_pool_get");
+                result = FILE_READ_ASYNC_ERROR;
+            }
+            else
+            {
+                io_context->handle = handle;
+                io_context->user_callback = user_callback;
+                io_context->user_context = user_context;
+
+                /*Codes_SRS_FILE_WIN32_01_130: [ file_read_async shall increment the number of pending copied reads and call TrySubmitThreadpoolCallback with on_read_ahead_copied_win32, the context and the threadpool environment of handle. ]*/
+                (void)interlocked_increment(&handle->pending_copied_read_count);
+                if (!TrySubmitThreadpoolCallback(on_read_ahead_copied_win32, io_context, &handle->cbe))
+                {
+                    /*Codes_SRS_FILE_WIN32_01_131: [ If TrySubmitThreadpoolCallback fails, file_read_async shall decrement the number of pending copied reads, release the context and return FILE_READ_ASYNC_ERROR. ]*/
+                    LogLastError("failure in TrySubmitThreadpoolCallback");
+                    if (interlocked_decrement(&handle->pending_copied_read_count) == 0)
+                    {
+                        wake_by_address_single(&handle->pending_copied_read_count);
+                    }
+                    io_context_pool_release(handle->io_context_pool, io_context);
+                    result = FILE_READ_ASYNC_ERROR;
+                }
+                else
+                {
+                    /*Codes_SRS_FILE_WIN32_01_132: [ file_read_async shall succeed and return FILE_READ_ASYNC_OK. ]*/
+                    result = FILE_READ_ASYNC_OK;
+                }
+            }
+        }
+        else
+        {
+            /*Codes_SRS_FILE_WIN32_01_133: [ If no read-ahead policy is set or read_ahead_read returns READ_AHEAD_READ_NOT_HANDLED, file_read_async shall issue the read by itself. ]*/
+            /*Codes_SRS_FILE_WIN32_43_026: [ file_read_async shall get a context to store the allocated OVERLAPPED struct, destination, handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+            FILE_WIN32_IO* io_context = io_context_pool_get(handle->io_context_pool, sizeof(FILE_WIN32_IO));
+            if (io_context == NULL)
+            {
+                /*Codes_SRS_FILE_43_022: [ If there are any failures then file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+                /*Codes_SRS_FILE_WIN32_43_058: [ If there are any other failures, file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+                LogError("Failure in io_context_pool_get");
+                result = FILE_READ_ASYNC_ERROR;
+            }
+            else
+            {
+                io_context->handle = handle;
+                /*Codes_SRS_FILE_WIN32_43_028: [ file_read_async shall allocate an OVERLAPPED struct and populate it with the created event and position. ]*/
+                (void)memset(&io_context->ov, 0, sizeof(OVERLAPPED));
+                /*Codes_SRS_FILE_WIN32_43_055: [ file_read_async shall create an event by calling CreateEvent. ]*/
+                io_context->ov.hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+                if (io_context->ov.hEvent == NULL)
+                {
+                    /*Codes_SRS_FILE_43_022: [ If there are any failures then file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+                    /*Codes_SRS_FILE_WIN32_43_058: [ If there are any other failures, file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+                    LogLastError("Failure in CreateEvent");
+                    result = FILE_READ_ASYNC_ERROR;
+                }
+                else
+                {
+                    io_context->ov.Offset = position & 0xFFFFFFFFULL;
+                    io_context->ov.OffsetHigh = position >> 32;
+
+                    io_context->user_callback = user_callback;
+                    io_context->user_context = user_context;
+
+                    io_context->size = size;
+                    io_context->vectored_io = NULL;
+                    io_context->aggregated_io = NULL;
+                    io_context->read_ahead_io = NULL;
+
+                    io_context->buffer = destination;
+                    io_context->is_write = false;
+
+                    /*Codes_SRS_FILE_43_021: [ file_read_async shall enqueue a read request to read handle's content at position offset and write it to destination. ]*/
+                    /*Codes_SRS_FILE_43_039: [ If position + size exceeds the size of the file, user_callback shall be called with success as false. ]*/
+                    /*Codes_SRS_FILE_WIN32_01_180: [ file_read_async shall call start_io with the mode of the file handle, which calls ReadFile as described above once the read holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+                    FILE_WIN32_START_IO_RESULT start_result = start_io(handle, io_context, handle->io_limit_mode);
+                    if (start_result == FILE_WIN32_START_IO_OK)
+                    {
+                        /*Codes_SRS_FILE_43_016: [ file_read_async shall call user_callback passing user_context and success depending on the success of the asynchronous read operation.]*/
+                        /*Codes_SRS_FILE_43_031: [ file_read_async shall succeed and return FILE_READ_ASYNC_OK. ]*/
+                        result = FILE_READ_ASYNC_OK;
+                    }
+                    else
+                    {
+                        if (start_result == FILE_WIN32_START_IO_ISSUE_ERROR)
+                        {
+                            /*Codes_SRS_FILE_43_036: [ If the call to read the file fails, file_read_async shall fail and return FILE_READ_ASYNC_READ_ERROR. ]*/
+                            result = FILE_READ_ASYNC_READ_ERROR;
+                        }
+                        else if (start_result == FILE_WIN32_START_IO_BUSY)
+                        {
+                            /*Codes_SRS_FILE_01_118: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and no slot of the I/O limit of handle is free, file_write_async shall fail and return FILE_WRITE_ASYNC_BUSY and file_read_async shall fail and return FILE_READ_ASYNC_BUSY, without calling user_callback. ]*/
+                            /*Codes_SRS_FILE_WIN32_01_181: [ If start_io returns FILE_WIN32_START_IO_BUSY, file_read_async shall close the event, release the context and return FILE_READ_ASYNC_BUSY. ]*/
+                            result = FILE_READ_ASYNC_BUSY;
+                        }
+                        else
+                        {
+                            /*Codes_SRS_FILE_43_022: [ If there are any failures then file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+                            /*Codes_SRS_FILE_WIN32_43_058: [ If there are any other failures, file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+                            LogError("failure in start_io");
+                            result = FILE_READ_ASYNC_ERROR;
+                        }
+
+                        if (!CloseHandle(io_context->ov.hEvent))
+                        {
+                            LogLastError("Failure in CloseHandle");
+                        }
+                    }
+                }
+                if (result != FILE_READ_ASYNC_OK)
+                {
+                    io_context_pool_release(handle->io_context_pool, io_context);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+static bool get_file_buffers_total_size(const FILE_BUFFER* buffers, uint32_t buffer_count, uint32_t* total_size)
+{
+    bool result = true;
+    uint64_t size = 0;
+
+    for (uint32_t i = 0; i < buffer_count; i++)
+    {
+        if (
+            (buffers[i].buffer == NULL) ||
+            (buffers[i].length == 0)
+            )
+        {
+            LogError("Invalid buffer at index %" PRIu32 ": void* buffer=%p, uint32_t length=%" PRIu32 "",
+                i, buffers[i].buffer, buffers[i].length);
+            result = false;
+            break;
+        }
+
+        size += buffers[i].length;
+        if (size > UINT32_MAX)
+        {
+            LogError("Sum of buffer lengths exceeds UINT32_MAX at index %" PRIu32 "", i);
+            result = false;
+            break;
+        }
+    }
+
+    if (result)
+    {
+        *total_size = (uint32_t)size;
+    }
+
+    return result;
+}
+
+/*fills one part per buffer, at consecutive offsets, so that the parts can be issued later when the operation waits for a slot of the I/O limits*/
+static void prepare_vectored_io(FILE_HANDLE handle, FILE_WIN32_VECTORED_IO* vectored_io, const FILE_BUFFER* buffers, uint32_t buffer_count, uint64_t position, bool is_write)
+{
+    vectored_io->part_count = buffer_count;
+
+    for (uint32_t i = 0; i < buffer_count; i++)
+    {
+        FILE_WIN32_IO* part = &vectored_io->parts[i];
+
+        /*Codes_SRS_FILE_WIN32_01_006: [ For each buffer, an OVERLAPPED struct shall be populated with the position of the buffer, which is position plus the sum of the lengths of the buffers before it. ]*/
+        (void)memset(&part->ov, 0, sizeof(OVERLAPPED));
+        part->ov.Offset = position & 0xFFFFFFFFULL;
+        part->ov.OffsetHigh = position >> 32;
+        part->handle = handle;
+        part->user_callback = NULL;
+        part->user_context = NULL;
+        part->size = buffers[i].length;
+        part->vectored_io = vectored_io;
+        part->aggregated_io = NULL;
+        part->read_ahead_io = NULL;
+        part->buffer = buffers[i].buffer;
+        part->is_write = is_write;
+        part->is_admitted = false;
+
+        position += buffers[i].length;
+    }
+}
+
+/*issues one WriteFile/ReadFile per part, returns 0 if at least the first part was issued, non-zero if not even the first part could be issued (in which case vectored_io is left to the caller and the callback will not be called)*/
+static int start_vectored_io(FILE_HANDLE handle, FILE_WIN32_VECTORED_IO* vectored_io)
+{
+    int result;
+    uint32_t part_count = vectored_io->part_count;
+    bool is_write = vectored_io->parts[0].is_write;
+    const FILE_WIN32_IO* last_part = &vectored_io->parts[part_count - 1];
+    uint64_t write_end = (((uint64_t)last_part->ov.OffsetHigh << 32) | last_part->ov.Offset) + last_part->size;
+    uint32_t i;
+
+    if (is_write)
+    {
+        /*Codes_SRS_FILE_WIN32_01_089: [ file_write_async_v shall call record_write_end with position + the sum of the buffer lengths. ]*/
+        record_write_end(handle, write_end);
+    }
+
+    /*Codes_SRS_FILE_WIN32_01_005: [ The number of pending parts shall be initialized to buffer_count + 1, the extra part being released once all the parts were issued. ]*/
+    (void)interlocked_exchange(&vectored_io->pending_count, (int32_t)part_count + 1);
+    (void)interlocked_exchange(&vectored_io->failed, 0);
+
+    for (i = 0; i < part_count; i++)
+    {
+        FILE_WIN32_IO* part = &vectored_io->parts[i];
+        BOOL io_result;
+
+        /*Codes_SRS_FILE_WIN32_01_007: [ For each buffer, StartThreadpoolIo shall be called and then WriteFile (for file_write_async_v) or ReadFile (for file_read_async_v) with the buffer, its length and the OVERLAPPED struct. ]*/
+        StartThreadpoolIo(handle->ptp_io);
+        io_result = is_write ?
+            WriteFile(handle->h_file, part->buffer, part->size, NULL, &part->ov) :
+            ReadFile(handle->h_file, part->buffer, part->size, NULL, &part->ov);
+        if (io_result == FALSE)
+        {
+            if (GetLastError() != ERROR_IO_PENDING)
+            {
+                /*Codes_SRS_FILE_WIN32_01_009: [ If WriteFile or ReadFile fails synchronously and GetLastError does not indicate ERROR_IO_PENDING, CancelThreadpoolIo shall be called and no further parts shall be issued. ]*/
+                LogLastError("failure in %s for part %" PRIu32 " of %" PRIu32 "", is_write ? "WriteFile" : "ReadFile", i, part_count);
+                CancelThreadpoolIo(handle->ptp_io);
+                break;
+            }
+            else
+            {
+                /*the part completes in on_file_io_complete_win32*/
+            }
+        }
+        else
+        {
+            /*Codes_SRS_FILE_WIN32_01_008: [ If WriteFile or ReadFile succeeds synchronously, CancelThreadpoolIo shall be called and the part shall be considered successfully completed. ]*/
+            CancelThreadpoolIo(handle->ptp_io);
+            if (is_write)
+            {
+                /*Codes_SRS_FILE_WIN32_01_217: [ If a write succeeds synchronously and a read-ahead policy is set, read_ahead_invalidate shall be called with the position and size of the write before its user_callback or write_aggregator_io_complete is called. ]*/
+                invalidate_read_ahead_of_write(handle, ((uint64_t)part->ov.OffsetHigh << 32) | part->ov.Offset, part->size);
+            }
+            on_vectored_io_part_complete(vectored_io, true);
+        }
+    }
+
+    if (i == 0)
+    {
+        /*Codes_SRS_FILE_WIN32_01_010: [ If the first part fails synchronously, the vectored operation context shall be released to the I/O context pool and the call shall fail. ]*/
+        result = MU_FAILURE;
+    }
+    else
+    {
+        if (i < part_count)
+        {
+            /*Codes_SRS_FILE_WIN32_01_011: [ If a part other than the first fails synchronously, the parts that were not issued shall be accounted as failed, and user_callback shall be called with is_successful as false once the issued parts complete. ]*/
+            (void)interlocked_exchange(&vectored_io->failed, 1);
+            (void)interlocked_add(&vectored_io->pending_count, -(int32_t)(part_count - i));
+        }
+
+        /*release the extra part, this calls the user callback if all the parts already completed*/
+        on_vectored_io_part_complete(vectored_io, true);
+
+        if (is_write)
+        {
+            /*Codes_SRS_FILE_WIN32_01_090: [ If the write was issued, file_write_async_v shall call preallocate_ahead_if_needed with position + the sum of the buffer lengths. ]*/
+            preallocate_ahead_if_needed(handle, write_end);
+        }
+        result = 0;
+    }
+
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, FILE_WRITE_ASYNC_RESULT, file_write_async_v, FILE_HANDLE, handle, const FILE_BUFFER*, buffers, uint32_t, buffer_count, uint64_t, position, FILE_CB, user_callback, void*, user_context)
+{
+    FILE_WRITE_ASYNC_RESULT result;
+    uint32_t total_size = 0;
+    if
+    (
+        /*Codes_SRS_FILE_01_001: [ If handle is NULL then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_002: [ If buffers is NULL then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        (buffers == NULL) ||
+        /*Codes_SRS_FILE_01_003: [ If buffer_count is 0 then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        (buffer_count == 0) ||
+        /*Codes_SRS_FILE_WIN32_01_003: [ If buffer_count is greater than or equal to INT32_MAX then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        (buffer_count >= INT32_MAX) ||
+        /*Codes_SRS_FILE_01_004: [ If user_callback is NULL then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        (user_callback == NULL) ||
+        /*Codes_SRS_FILE_01_005: [ If any of the buffers has a NULL buffer or a length of 0 then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_01_006: [ If the sum of the buffer lengths is greater than UINT32_MAX then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        !get_file_buffers_total_size(buffers, buffer_count, &total_size) ||
+        /*Codes_SRS_FILE_01_007: [ If position + the sum of the buffer lengths is greater than INT64_MAX, then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+        ((position + total_size) > INT64_MAX)
+    )
+    {
+        LogError("Invalid arguments to file_write_async_v: FILE_HANDLE file_handle=%p, const FILE_BUFFER* buffers=%p, uint32_t buffer_count=%" PRIu32 ", uint64_t position=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
+            handle, buffers, buffer_count, position, user_callback, user_context);
+        result = FILE_WRITE_ASYNC_INVALID_ARGS;
+    }
+    else
+    {
+        if (handle->read_ahead != NULL)
+        {
+            /*Codes_SRS_FILE_WIN32_01_134: [ If a read-ahead policy is set, file_write_async_v shall call read_ahead_invalidate with position and the sum of the buffer lengths. ]*/
+            read_ahead_invalidate(handle->read_ahead, position, total_size);
+        }
+
+        /*Codes_SRS_FILE_WIN32_01_004: [ file_write_async_v shall get a context to store user_callback, user_context, the number of pending parts and an OVERLAPPED struct for each buffer from the I/O context pool by calling io_context_pool_get. ]*/
+        FILE_WIN32_VECTORED_IO* vectored_io = io_context_pool_get(handle->io_context_pool, sizeof(FILE_WIN32_VECTORED_IO) + buffer_count * sizeof(FILE_WIN32_IO));
+        if (vectored_io == NULL)
+        {
+            /*Codes_SRS_FILE_01_011: [ If there are any other failures, file_write_async_v shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
+            LogError("failure in io_context_pool_get, buffer_count=%" PRIu32 "", buffer_count);
+            result = FILE_WRITE_ASYNC_ERROR;
+        }
+        else
+        {
+            vectored_io->handle = handle;
+            vectored_io->user_callback = user_callback;
+            vectored_io->user_context = user_context;
+            prepare_vectored_io(handle, vectored_io, buffers, buffer_count, position, true);
+
+            /*Codes_SRS_FILE_01_008: [ file_write_async_v shall enqueue a write request to write the contents of all the buffers, in order, starting at the position offset in the file. ]*/
+            /*Codes_SRS_FILE_01_143: [ The I/Os of file_write_async_v, file_read_async_v and of the batches, the aggregated writes, the reads of read-ahead blocks and the flushes of handle shall also hold a slot of the I/O limit of handle and of the I/O limit of the execution engine from the moment they are started until they complete. ]*/
+            /*Codes_SRS_FILE_WIN32_01_244: [ file_write_async_v shall call start_io with the first part and the mode of the file handle, which calls start_vectored_io once the write holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+            FILE_WIN32_START_IO_RESULT start_result = start_io(handle, &vectored_io->parts[0], handle->io_limit_mode);
+            if (start_result == FILE_WIN32_START_IO_OK)
+            {
+                /*Codes_SRS_FILE_01_010: [ file_write_async_v shall call user_callback passing user_context and is_successful as true if and only if all the bytes of all the buffers were written. ]*/
+                /*Codes_SRS_FILE_01_012: [ file_write_async_v shall succeed and return FILE_WRITE_ASYNC_OK. ]*/
+                result = FILE_WRITE_ASYNC_OK;
+            }
+            else
+            {
+                if (start_result == FILE_WIN32_START_IO_ISSUE_ERROR)
+                {
+                    /*Codes_SRS_FILE_01_009: [ If the call to write the file fails, file_write_async_v shall fail and return FILE_WRITE_ASYNC_WRITE_ERROR. ]*/
+                    result = FILE_WRITE_ASYNC_WRITE_ERROR;
+                }
+                else if (start_result == FILE_WIN32_START_IO_BUSY)
+                {
+                    /*Codes_SRS_FILE_01_144: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and no slot of the I/O limit of handle is free, file_write_async_v shall fail and return FILE_WRITE_ASYNC_BUSY and file_read_async_v shall fail and return FILE_READ_ASYNC_BUSY, without calling user_callback. ]*/
+                    /*Codes_SRS_FILE_WIN32_01_245: [ If start_io returns FILE_WIN32_START_IO_BUSY, file_write_async_v shall release the context and return FILE_WRITE_ASYNC_BUSY. ]*/
+                    result = FILE_WRITE_ASYNC_BUSY;
+                }
+                else
+                {
+                    /*Codes_SRS_FILE_01_011: [ If there are any other failures, file_write_async_v shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
+                    LogError("failure in start_io, buffer_count=%" PRIu32 "", buffer_count);
+                    result = FILE_WRITE_ASYNC_ERROR;
+                }
+
+                io_context_pool_release(handle->io_context_pool, vectored_io);
+            }
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, FILE_READ_ASYNC_RESULT, file_read_async_v, FILE_HANDLE, handle, const FILE_BUFFER*, buffers, uint32_t, buffer_count, uint64_t, position, FILE_CB, user_callback, void*, user_context)
+{
+    FILE_READ_ASYNC_RESULT result;
+    uint32_t total_size = 0;
+    if
+    (
+        /*Codes_SRS_FILE_01_013: [ If handle is NULL then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_014: [ If buffers is NULL then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (buffers == NULL) ||
+        /*Codes_SRS_FILE_01_015: [ If buffer_count is 0 then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (buffer_count == 0) ||
+        /*Codes_SRS_FILE_WIN32_01_014: [ If buffer_count is greater than or equal to INT32_MAX then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (buffer_count >= INT32_MAX) ||
+        /*Codes_SRS_FILE_01_016: [ If user_callback is NULL then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        (user_callback == NULL) ||
+        /*Codes_SRS_FILE_01_017: [ If any of the buffers has a NULL buffer or a length of 0 then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        /*Codes_SRS_FILE_01_018: [ If the sum of the buffer lengths is greater than UINT32_MAX then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+        !get_file_buffers_total_size(buffers, buffer_count, &total_size)
+    )
+    {
+        LogError("Invalid arguments to file_read_async_v: FILE_HANDLE file_handle=%p, const FILE_BUFFER* buffers=%p, uint32_t buffer_count=%" PRIu32 ", uint64_t position=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
+            handle, buffers, buffer_count, position, user_callback, user_context);
+        result = FILE_READ_ASYNC_INVALID_ARGS;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_015: [ file_read_async_v shall get a context to store user_callback, user_context, the number of pending parts and an OVERLAPPED struct for each buffer from the I/O context pool by calling io_context_pool_get. ]*/
+        FILE_WIN32_VECTORED_IO* vectored_io = io_context_pool_get(handle->io_context_pool, sizeof(FILE_WIN32_VECTORED_IO) + buffer_count * sizeof(FILE_WIN32_IO));
+        if (vectored_io == NULL)
+        {
+            /*Codes_SRS_FILE_01_022: [ If there are any other failures, file_read_async_v shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+            LogError("failure in io_context_pool_get, buffer_count=%" PRIu32 "", buffer_count);
+            result = FILE_READ_ASYNC_ERROR;
+        }
+        else
+        {
+            vectored_io->handle = handle;
+            vectored_io->user_callback = user_callback;
+            vectored_io->user_context = user_context;
+            prepare_vectored_io(handle, vectored_io, buffers, buffer_count, position, false);
+
+            /*Codes_SRS_FILE_01_019: [ file_read_async_v shall enqueue a read request to read handle's content starting at the position offset into all the buffers, in order. ]*/
+            /*Codes_SRS_FILE_WIN32_01_246: [ file_read_async_v shall call start_io with the first part and the mode of the file handle, which calls start_vectored_io once the read holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+            FILE_WIN32_START_IO_RESULT start_result = start_io(handle, &vectored_io->parts[0], handle->io_limit_mode);
+            if (start_result == FILE_WIN32_START_IO_OK)
+            {
+                /*Codes_SRS_FILE_01_021: [ file_read_async_v shall call user_callback passing user_context and is_successful as true if and only if all the buffers were filled. If position + the sum of the buffer lengths exceeds the size of the file, user_callback shall be called with is_successful as false. ]*/
+                /*Codes_SRS_FILE_01_023: [ file_read_async_v shall succeed and return FILE_READ_ASYNC_OK. ]*/
+                result = FILE_READ_ASYNC_OK;
+            }
+            else
+            {
+                if (start_result == FILE_WIN32_START_IO_ISSUE_ERROR)
+                {
+                    /*Codes_SRS_FILE_01_020: [ If the call to read the file fails, file_read_async_v shall fail and return FILE_READ_ASYNC_READ_ERROR. ]*/
+                    result = FILE_READ_ASYNC_READ_ERROR;
+                }
+                else if (start_result == FILE_WIN32_START_IO_BUSY)
+                {
+                    /*Codes_SRS_FILE_01_144: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and no slot of the I/O limit of handle is free, file_write_async_v shall fail and return FILE_WRITE_ASYNC_BUSY and file_read_async_v shall fail and return FILE_READ_ASYNC_BUSY, without calling user_callback. ]*/
+                    /*Codes_SRS_FILE_WIN32_01_247: [ If start_io returns FILE_WIN32_START_IO_BUSY, file_read_async_v shall release the context and return FILE_READ_ASYNC_BUSY. ]*/
+                    result = FILE_READ_ASYNC_BUSY;
+                }
+                else
+                {
+                    /*Codes_SRS_FILE_01_022: [ If there are any other failures, file_read_async_v shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+                    LogError("failure in start_io, buffer_count=%" PRIu32 "", buffer_count);
+                    result = FILE_READ_ASYNC_ERROR;
+                }
+
+                io_context_pool_release(handle->io_context_pool, vectored_io);
+            }
+        }
+    }
+    return result;
+}
+
+static int file_batch_add(FILE_BATCH_HANDLE batch, bool is_write, void* buffer, uint32_t size, uint64_t position, FILE_CB user_callback, void* user_context)
+{
+    int result;
+    FILE_WIN32_IO* io_context = io_context_pool_get(batch->handle->io_context_pool, sizeof(FILE_WIN32_IO));
+    if (io_context == NULL)
+    {
+        LogError("failure in io_context_pool_get");
+        result = MU_FAILURE;
+    }
+    else
+    {
+        FILE_WIN32_BATCH_ENTRY* entry = &batch->entries[batch->io_count];
+
+        /*the threadpool does not need an event, so none is created for batched I/Os*/
+        (void)memset(&io_context->ov, 0, sizeof(OVERLAPPED));
+        io_context->ov.Offset = position & 0xFFFFFFFFULL;
+        io_context->ov.OffsetHigh = position >> 32;
+        io_context->handle = batch->handle;
+        io_context->user_callback = user_callback;
+        io_context->user_context = user_context;
+        io_context->size = size;
+        io_context->vectored_io = NULL;
+        io_context->aggregated_io = NULL;
+        io_context->read_ahead_io = NULL;
+        io_context->buffer = buffer;
+        io_context->is_write = is_write;
+        io_context->is_admitted = false;
+
+        entry->io = io_context;
+
+        batch->io_count++;
+        result = 0;
+    }
+    return result;
+}
+
+static void file_batch_free_ios(FILE_BATCH_HANDLE batch, uint32_t first_io)
+{
+    for (uint32_t i = first_io; i < batch->io_count; i++)
+    {
+        io_context_pool_release(batch->handle->io_context_pool, batch->entries[i].io);
+    }
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, FILE_BATCH_HANDLE, file_batch_begin, FILE_HANDLE, handle, uint32_t, max_io_count)
+{
+    FILE_BATCH_HANDLE result;
+    if (
+        /*Codes_SRS_FILE_01_024: [ If handle is NULL then file_batch_begin shall fail and return NULL. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_025: [ If max_io_count is 0 then file_batch_begin shall fail and return NULL. ]*/
+        (max_io_count == 0)
+        )
+    {
+        LogError("Invalid arguments to file_batch_begin: FILE_HANDLE handle=%p, uint32_t max_io_count=%" PRIu32 "",
+            handle, max_io_count);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_026: [ file_batch_begin shall create a batch that can hold up to max_io_count I/Os and return it. ]*/
+        /*Codes_SRS_FILE_WIN32_01_016: [ file_batch_begin shall allocate a batch with room for max_io_count I/Os. ]*/
+        result = malloc(sizeof(FILE_BATCH) + (size_t)max_io_count * sizeof(FILE_WIN32_BATCH_ENTRY));
+        if (result == NULL)
+        {
+            /*Codes_SRS_FILE_01_027: [ If there are any failures, file_batch_begin shall fail and return NULL. ]*/
+            /*Codes_SRS_FILE_WIN32_01_017: [ If there are any failures, file_batch_begin shall fail and return NULL. ]*/
+            LogError("failure in malloc, max_io_count=%" PRIu32 "", max_io_count);
+        }
+        else
+        {
+            result->handle = handle;
+            result->max_io_count = max_io_count;
+            result->io_count = 0;
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_batch_add_write, FILE_BATCH_HANDLE, batch, const unsigned char*, source, uint32_t, size, uint64_t, position, FILE_CB, user_callback, void*, user_context)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_028: [ If batch is NULL then file_batch_add_write shall fail and return a non-zero value. ]*/
+        (batch == NULL) ||
+        /*Codes_SRS_FILE_01_029: [ If source is NULL then file_batch_add_write shall fail and return a non-zero value. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_FILE_01_030: [ If size is 0 then file_batch_add_write shall fail and return a non-zero value. ]*/
+        (size == 0) ||
+        /*Codes_SRS_FILE_01_031: [ If user_callback is NULL then file_batch_add_write shall fail and return a non-zero value. ]*/
+        (user_callback == NULL) ||
+        /*Codes_SRS_FILE_01_032: [ If position + size is greater than INT64_MAX then file_batch_add_write shall fail and return a non-zero value. ]*/
+        ((position + size) > INT64_MAX)
+        )
+    {
+        LogError("Invalid arguments to file_batch_add_write: FILE_BATCH_HANDLE batch=%p, const unsigned char* source=%p, uint32_t size=%" PRIu32 ", uint64_t position=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
+            batch, source, size, position, user_callback, user_context);
+        result = MU_FAILURE;
+    }
+    /*Codes_SRS_FILE_01_033: [ If batch already holds max_io_count I/Os then file_batch_add_write shall fail and return a non-zero value. ]*/
+    else if (batch->io_count == batch->max_io_count)
+    {
+        LogError("batch=%p is full, it already holds %" PRIu32 " I/Os", batch, batch->io_count);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        if (batch->handle->read_ahead != NULL)
+        {
+            /*Codes_SRS_FILE_WIN32_01_135: [ If a read-ahead policy is set, file_batch_add_write shall call read_ahead_invalidate with position and size. ]*/
+            read_ahead_invalidate(batch->handle->read_ahead, position, size);
+        }
+
+        /*Codes_SRS_FILE_01_034: [ file_batch_add_write shall queue in batch a write request to write source's content to the position offset in the file. ]*/
+        /*Codes_SRS_FILE_WIN32_01_018: [ file_batch_add_write shall get a context to store an OVERLAPPED struct populated with position and no event, the file handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+        if (file_batch_add(batch, true, (void*)source, size, position, user_callback, user_context) != 0)
+        {
+            /*Codes_SRS_FILE_01_035: [ If there are any other failures, file_batch_add_write shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_WIN32_01_019: [ If there are any failures, file_batch_add_write shall fail and return a non-zero value. ]*/
+            LogError("file_batch_add failed");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_01_036: [ file_batch_add_write shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_batch_add_read, FILE_BATCH_HANDLE, batch, unsigned char*, destination, uint32_t, size, uint64_t, position, FILE_CB, user_callback, void*, user_context)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_037: [ If batch is NULL then file_batch_add_read shall fail and return a non-zero value. ]*/
+        (batch == NULL) ||
+        /*Codes_SRS_FILE_01_038: [ If destination is NULL then file_batch_add_read shall fail and return a non-zero value. ]*/
+        (destination == NULL) ||
+        /*Codes_SRS_FILE_01_039: [ If size is 0 then file_batch_add_read shall fail and return a non-zero value. ]*/
+        (size == 0) ||
+        /*Codes_SRS_FILE_01_040: [ If user_callback is NULL then file_batch_add_read shall fail and return a non-zero value. ]*/
+        (user_callback == NULL)
+        )
+    {
+        LogError("Invalid arguments to file_batch_add_read: FILE_BATCH_HANDLE batch=%p, unsigned char* destination=%p, uint32_t size=%" PRIu32 ", uint64_t position=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
+            batch, destination, size, position, user_callback, user_context);
+        result = MU_FAILURE;
+    }
+    /*Codes_SRS_FILE_01_041: [ If batch already holds max_io_count I/Os then file_batch_add_read shall fail and return a non-zero value. ]*/
+    else if (batch->io_count == batch->max_io_count)
+    {
+        LogError("batch=%p is full, it already holds %" PRIu32 " I/Os", batch, batch->io_count);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_042: [ file_batch_add_read shall queue in batch a read request to read handle's content at the position offset into destination. ]*/
+        /*Codes_SRS_FILE_WIN32_01_020: [ file_batch_add_read shall get a context to store an OVERLAPPED struct populated with position and no event, the file handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+        if (file_batch_add(batch, false, destination, size, position, user_callback, user_context) != 0)
+        {
+            /*Codes_SRS_FILE_01_043: [ If there are any other failures, file_batch_add_read shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_WIN32_01_021: [ If there are any failures, file_batch_add_read shall fail and return a non-zero value. ]*/
+            LogError("file_batch_add failed");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_01_044: [ file_batch_add_read shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_batch_submit, FILE_BATCH_HANDLE, batch, uint32_t*, submitted_count)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_045: [ If batch is NULL then file_batch_submit shall fail and return a non-zero value. ]*/
+        (batch == NULL) ||
+        /*Codes_SRS_FILE_01_046: [ If submitted_count is NULL then file_batch_submit shall fail and return a non-zero value. ]*/
+        (submitted_count == NULL)
+        )
+    {
+        LogError("Invalid arguments to file_batch_submit: FILE_BATCH_HANDLE batch=%p, uint32_t* submitted_count=%p",
+            batch, submitted_count);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        FILE_HANDLE handle = batch->handle;
+        /*in FILE_IO_LIMIT_MODE_BUSY mode the slots of the file handle are taken for the whole batch first, so that a batch is either refused or fully started*/
+        bool reserve_slots = (handle->io_admission != NULL) && (handle->io_limit_mode == FILE_IO_LIMIT_MODE_BUSY);
+        uint32_t reserved_count = 0;
+
+        if (reserve_slots)
+        {
+            /*Codes_SRS_FILE_WIN32_01_248: [ If the file handle has an I/O limit in FILE_IO_LIMIT_MODE_BUSY, file_batch_submit shall call io_admission_try_acquire on the admission of the file handle once for each I/O in the batch. ]*/
+            while (
+                (reserved_count < batch->io_count) &&
+                (io_admission_try_acquire(handle->io_admission) == IO_ADMISSION_ADMITTED)
+                )
+            {
+                reserved_count++;
+            }
+        }
+
+        if (
+            reserve_slots &&
+            (reserved_count < batch->io_count)
+            )
+        {
+            /*Codes_SRS_FILE_01_145: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and the I/O limit of handle does not have a free slot for each of the I/Os of batch, file_batch_submit shall discard all the I/Os of batch without calling their user_callback, set submitted_count to 0, free batch and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_WIN32_01_249: [ If io_admission_try_acquire does not return IO_ADMISSION_ADMITTED for each I/O, file_batch_submit shall call io_admission_release for each acquired slot, release the contexts of all the I/Os to the I/O context pool, set submitted_count to 0 and return a non-zero value. ]*/
+            LogError("the I/O limit of the file handle has no free slot for each of the %" PRIu32 " I/Os of batch=%p", batch->io_count, batch);
+            for (uint32_t j = 0; j < reserved_count; j++)
+            {
+                io_admission_release(handle->io_admission);
+            }
+            file_batch_free_ios(batch, 0);
+            *submitted_count = 0;
+            result = MU_FAILURE;
+        }
+        else
+        {
+            uint64_t write_end = 0;
+            uint32_t i;
+
+            /*Codes_SRS_FILE_01_047: [ If batch holds no I/Os then file_batch_submit shall set submitted_count to 0, free batch and return 0. ]*/
+            /*Codes_SRS_FILE_01_048: [ file_batch_submit shall issue all the I/Os queued in batch, in the order in which they were added. ]*/
+            /*Codes_SRS_FILE_01_049: [ file_batch_submit shall call the user_callback of each issued I/O passing its user_context and is_successful as true if and only if all its bytes were transferred. ]*/
+            for (i = 0; i < batch->io_count; i++)
+            {
+                FILE_WIN32_IO* io_context = batch->entries[i].io;
+                IO_ADMISSION_RESULT admission_result;
+
+                /*Codes_SRS_FILE_01_143: [ The I/Os of file_write_async_v, file_read_async_v and of the batches, the aggregated writes, the reads of read-ahead blocks and the flushes of handle shall also hold a slot of the I/O limit of handle and of the I/O limit of the execution engine from the moment they are started until they complete. ]*/
+                if (reserve_slots)
+                {
+                    /*Codes_SRS_FILE_WIN32_01_250: [ If the slots of the file handle were acquired for the batch, file_batch_submit shall increment the number of queued I/Os, call acquire_engine_io_slot for each I/O and call end_queued_io if the I/O was not queued. ]*/
+                    io_context->is_admitted = true;
+                    (void)interlocked_increment(&handle->pending_queued_io_count);
+                    admission_result = acquire_engine_io_slot(io_context);
+                    if (admission_result != IO_ADMISSION_QUEUED)
+                    {
+                        end_queued_io(handle);
+                    }
+                }
+                else
+                {
+                    /*Codes_SRS_FILE_WIN32_01_251: [ Otherwise file_batch_submit shall call acquire_io_slots with the mode of the file handle for each I/O. ]*/
+                    admission_result = acquire_io_slots(io_context, handle->io_limit_mode);
+                }
+
+                if (admission_result == IO_ADMISSION_QUEUED)
+                {
+                    /*Codes_SRS_FILE_01_146: [ An I/O of a batch that waits for a slot of the I/O limits shall be queued and counted as issued by file_batch_submit. ]*/
+                    /*Codes_SRS_FILE_WIN32_01_252: [ An I/O queued for a slot shall count as issued, it is issued by issue_io once it holds its slots. ]*/
+                }
+                else if (admission_result != IO_ADMISSION_ADMITTED)
+                {
+                    /*Codes_SRS_FILE_WIN32_01_253: [ If acquiring the slots of an I/O fails, file_batch_submit shall not issue it, release the slots of the file handle acquired for the I/Os that follow it, release the contexts of this I/O and of all the I/Os that follow it to the I/O context pool, set submitted_count to the number of issued I/Os and return a non-zero value. ]*/
+                    LogError("failure acquiring a slot for I/O %" PRIu32 " of %" PRIu32 "", i, batch->io_count);
+                    break;
+                }
+                else
+                {
+                    uint64_t io_end = 0;
+                    BOOL io_result;
+
+                    if (io_context->is_write)
+                    {
+                        io_end = (((uint64_t)io_context->ov.OffsetHigh << 32) | io_context->ov.Offset) + io_context->size;
+
+                        /*Codes_SRS_FILE_WIN32_01_091: [ Before issuing a write, file_batch_submit shall call record_write_end with the end of the write. ]*/
+                        record_write_end(handle, io_end);
+                    }
+
+                    /*Codes_SRS_FILE_WIN32_01_022: [ For each I/O in the batch, in order, file_batch_submit shall call StartThreadpoolIo and then WriteFile or ReadFile with the buffer, the size and the OVERLAPPED struct of the I/O. ]*/
+                    StartThreadpoolIo(handle->ptp_io);
+                    io_result = io_context->is_write ?
+                        WriteFile(handle->h_file, io_context->buffer, io_context->size, NULL, &io_context->ov) :
+                        ReadFile(handle->h_file, io_context->buffer, io_context->size, NULL, &io_context->ov);
+                    if (io_result == FALSE)
+                    {
+                        if (GetLastError() != ERROR_IO_PENDING)
+                        {
+                            /*Codes_SRS_FILE_WIN32_01_025: [ If WriteFile or ReadFile fails synchronously and GetLastError does not indicate ERROR_IO_PENDING, file_batch_submit shall call CancelThreadpoolIo, release the contexts of this I/O and of all the I/Os that follow it to the I/O context pool, set submitted_count to the number of issued I/Os and return a non-zero value. ]*/
+                            LogLastError("failure in %s for I/O %" PRIu32 " of %" PRIu32 "", io_context->is_write ? "WriteFile" : "ReadFile", i, batch->io_count);
+                            CancelThreadpoolIo(handle->ptp_io);
+                            if (io_context->is_admitted)
+                            {
+                                /*Codes_SRS_FILE_WIN32_01_254: [ If WriteFile or ReadFile fails synchronously for an I/O that holds slots of the I/O limits, file_batch_submit shall call release_io_slots and release the slots of the file handle acquired for the I/Os that follow it. ]*/
+                                release_io_slots(handle);
+                            }
+                            break;
+                        }
+                        else
+                        {
+                            /*Codes_SRS_FILE_WIN32_01_023: [ If WriteFile or ReadFile fails synchronously and GetLastError indicates ERROR_IO_PENDING, the I/O shall be considered issued and shall complete in on_file_io_complete_win32. ]*/
+                        }
+                    }
+                    else
+                    {
+                        /*Codes_SRS_FILE_WIN32_01_024: [ If WriteFile or ReadFile succeeds synchronously, file_batch_submit shall call CancelThreadpoolIo, call the user_callback of the I/O with is_successful as true and release its context to the I/O context pool. ]*/
+                        CancelThreadpoolIo(handle->ptp_io);
+                        if (io_context->is_write)
+                        {
+                            /*Codes_SRS_FILE_WIN32_01_217: [ If a write succeeds synchronously and a read-ahead policy is set, read_ahead_invalidate shall be called with the position and size of the write before its user_callback or write_aggregator_io_complete is called. ]*/
+                            invalidate_read_ahead_of_write(handle, ((uint64_t)io_context->ov.OffsetHigh << 32) | io_context->ov.Offset, io_context->size);
+                        }
+                        if (io_context->is_admitted)
+                        {
+                            /*Codes_SRS_FILE_WIN32_01_255: [ If an I/O that holds slots of the I/O limits succeeds synchronously, file_batch_submit shall call release_io_slots before calling its user_callback. ]*/
+                            release_io_slots(handle);
+                        }
+                        io_context->user_callback(io_context->user_context, true);
+                        io_context_pool_release(handle->io_context_pool, io_context);
+                    }
+
+                    if (io_end > write_end)
+                    {
+                        write_end = io_end;
+                    }
+                }
+            }
+
+            /*Codes_SRS_FILE_WIN32_01_092: [ If writes were issued, file_batch_submit shall call preallocate_ahead_if_needed with the highest end of the issued writes. ]*/
+            if (write_end != 0)
+            {
+                preallocate_ahead_if_needed(handle, write_end);
+            }
+
+            if (i < batch->io_count)
+            {
+                if (reserve_slots)
+                {
+                    for (uint32_t j = i + 1; j < batch->io_count; j++)
+                    {
+                        io_admission_release(handle->io_admission);
+                    }
+                }
+
+                /*Codes_SRS_FILE_01_050: [ If issuing an I/O fails, file_batch_submit shall not issue the I/Os that follow it, discard all the I/Os that were not issued without calling their user_callback, set submitted_count to the number of issued I/Os and return a non-zero value. ]*/
+                file_batch_free_ios(batch, i);
+                *submitted_count = i;
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /*Codes_SRS_FILE_01_052: [ On success file_batch_submit shall set submitted_count to the number of I/Os in batch and return 0. ]*/
+                /*Codes_SRS_FILE_WIN32_01_027: [ If all the I/Os were issued, file_batch_submit shall set submitted_count to the number of I/Os in the batch and return 0. ]*/
+                *submitted_count = batch->io_count;
+                result = 0;
+            }
+        }
+
+        /*Codes_SRS_FILE_01_051: [ file_batch_submit shall free batch. ]*/
+        /*Codes_SRS_FILE_WIN32_01_026: [ file_batch_submit shall free the batch. ]*/
+        free(batch);
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, void, file_batch_cancel, FILE_BATCH_HANDLE, batch)
+{
+    if (batch == NULL)
+    {
+        /*Codes_SRS_FILE_01_053: [ If batch is NULL then file_batch_cancel shall return. ]*/
+        /*Codes_SRS_FILE_WIN32_01_028: [ If batch is NULL then file_batch_cancel shall return. ]*/
+        LogError("Invalid arguments to file_batch_cancel: FILE_BATCH_HANDLE batch=%p", batch);
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_054: [ file_batch_cancel shall discard all the I/Os queued in batch without calling their user_callback and free batch. ]*/
+        /*Codes_SRS_FILE_WIN32_01_029: [ file_batch_cancel shall release the contexts of all the I/Os in the batch to the I/O context pool and free the batch. ]*/
+        file_batch_free_ios(batch, 0);
+        free(batch);
+    }
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_flush_async, FILE_HANDLE, handle, FILE_CB, user_callback, void*, user_context)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_058: [ If handle is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+        /*Codes_SRS_FILE_WIN32_01_039: [ If handle is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_059: [ If user_callback is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+        /*Codes_SRS_FILE_WIN32_01_040: [ If user_callback is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+        (user_callback == NULL)
+        )
+    {
+        LogError("Invalid arguments to file_flush_async: FILE_HANDLE handle=%p, FILE_CB user_callback=%p, void* user_context=%p",
+            handle, user_callback, user_context);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_041: [ file_flush_async shall get a flush request to hold user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+        FILE_WIN32_FLUSH_REQUEST* request = io_context_pool_get(handle->io_context_pool, sizeof(FILE_WIN32_FLUSH_REQUEST));
+        if (request == NULL)
+        {
+            /*Codes_SRS_FILE_01_063: [ If there are any other failures, file_flush_async shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_WIN32_01_042: [ If there are any failures, file_flush_async shall fail and return a non-zero value. ]*/
+            LogError("failure in io_context_pool_get");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            void* current_requests = NULL;
+            void* previous_requests;
+
+            request->user_callback = user_callback;
+            request->user_context = user_context;
+
+            /*Codes_SRS_FILE_WIN32_01_043: [ file_flush_async shall add the request to the list of flush requests of handle by calling interlocked_compare_exchange_pointer. ]*/
+            do
+            {
+                request->next = current_requests;
+                previous_requests = interlocked_compare_exchange_pointer(&handle->flush_requests, request, current_requests);
+                if (previous_requests == current_requests)
+                {
+                    break;
+                }
+                current_requests = previous_requests;
+            } while (1);
+
+            /*Codes_SRS_FILE_01_060: [ file_flush_async shall call user_callback with is_successful as true once the data of all the writes that completed before file_flush_async was called is durable. ]*/
+            /*Codes_SRS_FILE_01_061: [ A flush of the file shall serve all the file_flush_async requests that were queued when the flush started. ]*/
+            /*Codes_SRS_FILE_01_062: [ If flushing the file fails, file_flush_async shall call user_callback with is_successful as false. ]*/
+            /*Codes_SRS_FILE_WIN32_01_044: [ file_flush_async shall start a flush. ]*/
+            start_flush_if_idle(handle);
+
+            /*Codes_SRS_FILE_01_064: [ file_flush_async shall succeed and return 0. ]*/
+            /*Codes_SRS_FILE_WIN32_01_050: [ file_flush_async shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+    return result;
+}
+
+static void end_copy_on_file(FILE_HANDLE handle)
+{
+    if (interlocked_decrement(&handle->pending_copy_count) == 0)
+    {
+        wake_by_address_single(&handle->pending_copy_count);
+    }
+}
+
+static void prepare_copy_overlapped(OVERLAPPED* ov, HANDLE h_event, uint64_t offset)
+{
+    (void)memset(ov, 0, sizeof(OVERLAPPED));
+    ov->Offset = (DWORD)offset;
+    ov->OffsetHigh = (DWORD)(offset >> 32);
+    /*the low-order bit keeps the completion from being queued to the threadpool I/O of the file, the copy waits for it instead*/
+    ov->hEvent = (HANDLE)((ULONG_PTR)h_event | 1);
+}
+
+static bool wait_for_copy_io(HANDLE h_file, OVERLAPPED* ov, BOOL is_completed, DWORD* number_of_bytes_transferred)
+{
+    bool result;
+    if (
+        (!is_completed) &&
+        (GetLastError() != ERROR_IO_PENDING)
+        )
+    {
+        result = false;
+    }
+    else if (!GetOverlappedResult(h_file, ov, number_of_bytes_transferred, TRUE))
+    {
+        LogLastError("failure in GetOverlappedResult");
+        result = false;
+    }
+    else
+    {
+        result = true;
+    }
+    return result;
+}
+
+static bool copy_through_buffer(FILE_WIN32_COPY* copy, HANDLE h_event)
+{
+    bool result;
+
+    /*Codes_SRS_FILE_WIN32_01_209: [ Otherwise on_file_copy_range_win32 shall allocate a buffer of FILE_WIN32_COPY_CHUNK_SIZE bytes and, chunk by chunk, read the source range with ReadFile and write what was read to the destination range with WriteFile, waiting for each of them by calling GetOverlappedResult. ]*/
+    unsigned char* buffer = malloc(FILE_WIN32_COPY_CHUNK_SIZE);
+    if (buffer == NULL)
+    {
+        /*Codes_SRS_FILE_WIN32_01_210: [ If malloc fails, ReadFile or WriteFile fail, GetOverlappedResult fails, ReadFile reads 0 bytes or WriteFile writes fewer bytes than were read, the copy shall fail. ]*/
+        LogError("failure in malloc(FILE_WIN32_COPY_CHUNK_SIZE=%d)", FILE_WIN32_COPY_CHUNK_SIZE);
+        result = false;
+    }
+    else
+    {
+        uint64_t copied = 0;
+
+        result = true;
+        while (copied < copy->size)
+        {
+            OVERLAPPED ov;
+            DWORD bytes_to_read = (copy->size - copied > FILE_WIN32_COPY_CHUNK_SIZE) ? FILE_WIN32_COPY_CHUNK_SIZE : (DWORD)(copy->size - copied);
+            DWORD bytes_read;
+            DWORD bytes_written;
+            BOOL is_completed;
+
+            prepare_copy_overlapped(&ov, h_event, copy->source_position + copied);
+            is_completed = ReadFile(copy->source->h_file, buffer, bytes_to_read, NULL, &ov);
+            if (!wait_for_copy_io(copy->source->h_file, &ov, is_completed, &bytes_read))
+            {
+                /*Codes_SRS_FILE_WIN32_01_210: [ If malloc fails, ReadFile or WriteFile fail, GetOverlappedResult fails, ReadFile reads 0 bytes or WriteFile writes fewer bytes than were read, the copy shall fail. ]*/
+                LogError("failure reading the source of the copy at position=%" PRIu64 "", copy->source_position + copied);
+                result = false;
+                break;
+            }
+
+            if (bytes_read == 0)
+            {
+                /*the source file ends before the end of the range*/
+                LogError("the source of the copy ends at position=%" PRIu64 ", before the end of the range", copy->source_position + copied);
+                result = false;
+                break;
+            }
+
+            prepare_copy_overlapped(&ov, h_event, copy->destination_position + copied);
+            is_completed = WriteFile(copy->destination->h_file, buffer, bytes_read, NULL, &ov);
+            if (!wait_for_copy_io(copy->destination->h_file, &ov, is_completed, &bytes_written))
+            {
+                LogError("failure writing the destination of the copy at position=%" PRIu64 "", copy->destination_position + copied);
+                result = false;
+                break;
+            }
+
+            if (bytes_written != bytes_read)
+            {
+                LogError("short write to the destination of the copy, written %" PRIu32 " out of %" PRIu32 " bytes", (uint32_t)bytes_written, (uint32_t)bytes_read);
+                result = false;
+                break;
+            }
+
+            copied += bytes_written;
+        }
+
+        free(buffer);
+    }
+
+    return result;
+}
+
+static VOID NTAPI on_file_copy_range_win32(PTP_CALLBACK_INSTANCE instance, PVOID context)
+{
+    (void)instance;
+    FILE_WIN32_COPY* copy = context;
+    FILE_HANDLE source = copy->source;
+    FILE_HANDLE destination = copy->destination;
+    FILE_CB user_callback = copy->user_callback;
+    void* user_context = copy->user_context;
+    bool is_successful;
+
+    /*Codes_SRS_FILE_WIN32_01_204: [ on_file_copy_range_win32 shall create an event by calling CreateEvent and use it, with its low-order bit set, in the OVERLAPPED structs of the copy, so that their completion is not queued to the threadpool I/O of the file. ]*/
+    HANDLE h_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+    if (h_event == NULL)
+    {
+        /*Codes_SRS_FILE_WIN32_01_205: [ If CreateEvent fails, the copy shall fail. ]*/
+        LogLastError("failure in CreateEvent");
+        is_successful = false;
+    }
+    else
+    {
+        OVERLAPPED ov;
+        DUPLICATE_EXTENTS_DATA duplicate_extents_data;
+        DWORD bytes_returned;
+        BOOL is_completed;
+
+        duplicate_extents_data.FileHandle = source->h_file;
+        duplicate_extents_data.SourceFileOffset.QuadPart = (LONGLONG)copy->source_position;
+        duplicate_extents_data.TargetFileOffset.QuadPart = (LONGLONG)copy->destination_position;
+        duplicate_extents_data.ByteCount.QuadPart = (LONGLONG)copy->size;
+
+        /*Codes_SRS_FILE_WIN32_01_206: [ on_file_copy_range_win32 shall call DeviceIoControl on the destination with FSCTL_DUPLICATE_EXTENTS_TO_FILE and a DUPLICATE_EXTENTS_DATA describing the source file and the source and destination ranges, and wait for it by calling GetOverlappedResult. ]*/
+        prepare_copy_overlapped(&ov, h_event, 0);
+        is_completed = DeviceIoControl(destination->h_file, FSCTL_DUPLICATE_EXTENTS_TO_FILE, &duplicate_extents_data, sizeof(duplicate_extents_data), NULL, 0, NULL, &ov);
+        if (wait_for_copy_io(destination->h_file, &ov, is_completed, &bytes_returned))
+        {
+            /*Codes_SRS_FILE_WIN32_01_207: [ If duplicating the extents succeeds, the copy shall succeed. ]*/
+            is_successful = true;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_WIN32_01_208: [ If duplicating the extents fails, on_file_copy_range_win32 shall copy the data through a buffer. ]*/
+            /*only ReFS supports block cloning, and only for ranges aligned to its clusters*/
+            LogInfo("FSCTL_DUPLICATE_EXTENTS_TO_FILE failed, copying %" PRIu64 " bytes through a buffer", copy->size);
+            is_successful = copy_through_buffer(copy, h_event);
+        }
+
+        /*Codes_SRS_FILE_WIN32_01_211: [ on_file_copy_range_win32 shall close the event by calling CloseHandle. ]*/
+        if (!CloseHandle(h_event))
+        {
+            LogLastError("failure in CloseHandle");
+        }
+    }
+
+    if (destination->read_ahead != NULL)
+    {
+        /*Codes_SRS_FILE_WIN32_01_216: [ If a read-ahead policy is set on destination, on_file_copy_range_win32 shall call read_ahead_invalidate with the destination range before calling user_callback. ]*/
+        read_ahead_invalidate(destination->read_ahead, copy->destination_position, copy->size);
+    }
+
+    /*Codes_SRS_FILE_WIN32_01_212: [ on_file_copy_range_win32 shall free the copy context and call user_callback with user_context and is_successful. ]*/
+    free(copy);
+    user_callback(user_context, is_successful);
+
+    /*Codes_SRS_FILE_WIN32_01_213: [ on_file_copy_range_win32 shall decrement the number of pending copies of source and of destination and wake up file_destroy by calling wake_by_address_single if they reach 0. ]*/
+    end_copy_on_file(source);
+    end_copy_on_file(destination);
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_copy_range_async, FILE_HANDLE, source, uint64_t, source_position, FILE_HANDLE, destination, uint64_t, destination_position, uint64_t, size, FILE_CB, user_callback, void*, user_context)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_131: [ If source is NULL then file_copy_range_async shall fail and return a non-zero value. ]*/
+        (source == NULL) ||
+        /*Codes_SRS_FILE_01_132: [ If destination is NULL then file_copy_range_async shall fail and return a non-zero value. ]*/
+        (destination == NULL) ||
+        /*Codes_SRS_FILE_01_133: [ If size is 0 then file_copy_range_async shall fail and return a non-zero value. ]*/
+        (size == 0) ||
+        /*Codes_SRS_FILE_01_134: [ If source_position + size or destination_position + size is greater than INT64_MAX then file_copy_range_async shall fail and return a non-zero value. ]*/
+        (size > INT64_MAX) ||
+        (source_position > INT64_MAX - size) ||
+        (destination_position > INT64_MAX - size) ||
+        /*Codes_SRS_FILE_01_140: [ If source and destination are the same file handle and the source and destination ranges overlap then file_copy_range_async shall fail and return a non-zero value. ]*/
+        (
+            (source == destination) &&
+            (source_position < destination_position + size) &&
+            (destination_position < source_position + size)
+        ) ||
+        /*Codes_SRS_FILE_01_135: [ If user_callback is NULL then file_copy_range_async shall fail and return a non-zero value. ]*/
+        (user_callback == NULL)
+        )
+    {
+        LogError("Invalid arguments to file_copy_range_async: FILE_HANDLE source=%p, uint64_t source_position=%" PRIu64 ", FILE_HANDLE destination=%p, uint64_t destination_position=%" PRIu64 ", uint64_t size=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
+            source, source_position, destination, destination_position, size, user_callback, user_context);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_198: [ file_copy_range_async shall allocate a copy context to hold the ranges, user_callback and user_context. ]*/
+        FILE_WIN32_COPY* copy = malloc(sizeof(FILE_WIN32_COPY));
+        if (copy == NULL)
+        {
+            /*Codes_SRS_FILE_01_139: [ If there are any other failures, file_copy_range_async shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_WIN32_01_199: [ If there are any failures, file_copy_range_async shall fail and return a non-zero value. ]*/
+            LogError("failure in malloc(sizeof(FILE_WIN32_COPY)=%zu)", sizeof(FILE_WIN32_COPY));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            copy->source = source;
+            copy->destination = destination;
+            copy->source_position = source_position;
+            copy->destination_position = destination_position;
+            copy->size = size;
+            copy->user_callback = user_callback;
+            copy->user_context = user_context;
+
+            if (destination->read_ahead != NULL)
+            {
+                /*Codes_SRS_FILE_01_138: [ When a read-ahead policy is set on destination, file_copy_range_async shall drop the blocks of destination that overlap the destination range. ]*/
+                /*Codes_SRS_FILE_WIN32_01_200: [ If a read-ahead policy is set on destination, file_copy_range_async shall call read_ahead_invalidate with the destination range. ]*/
+                read_ahead_invalidate(destination->read_ahead, destination_position, size);
+            }
+
+            /*Codes_SRS_FILE_01_136: [ file_copy_range_async shall start copying size bytes of source starting at source_position to destination starting at destination_position and return 0. ]*/
+            /*Codes_SRS_FILE_01_137: [ When the copy ends, user_callback shall be called with user_context and is_successful as true if and only if all size bytes were copied. ]*/
+            /*Codes_SRS_FILE_WIN32_01_201: [ file_copy_range_async shall increment the number of pending copies of source and of destination and call TrySubmitThreadpoolCallback with on_file_copy_range_win32, the copy context and the threadpool environment of destination. ]*/
+            (void)interlocked_increment(&source->pending_copy_count);
+            (void)interlocked_increment(&destination->pending_copy_count);
+            if (!TrySubmitThreadpoolCallback(on_file_copy_range_win32, copy, &destination->cbe))
+            {
+                /*Codes_SRS_FILE_WIN32_01_202: [ If TrySubmitThreadpoolCallback fails, file_copy_range_async shall decrement the number of pending copies of source and of destination, free the copy context and fail. ]*/
+                LogLastError("failure in TrySubmitThreadpoolCallback");
+                end_copy_on_file(source);
+                end_copy_on_file(destination);
+                free(copy);
+                result = MU_FAILURE;
+            }
+            else
+            {
+                /*Codes_SRS_FILE_WIN32_01_203: [ file_copy_range_async shall succeed and return 0. ]*/
+                result = 0;
+            }
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, FILE_MAPPED_REGION_HANDLE, file_map_region, FILE_HANDLE, handle, uint64_t, position, uint32_t, size, FILE_ACCESS_HINT, access_hint)
+{
+    FILE_MAPPED_REGION_HANDLE result;
+    if (
+        /*Codes_SRS_FILE_01_065: [ If handle is NULL then file_map_region shall fail and return NULL. ]*/
+        /*Codes_SRS_FILE_WIN32_01_055: [ If handle is NULL then file_map_region shall fail and return NULL. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_066: [ If size is 0 then file_map_region shall fail and return NULL. ]*/
+        /*Codes_SRS_FILE_WIN32_01_056: [ If size is 0 then file_map_region shall fail and return NULL. ]*/
+        (size == 0) ||
+        /*Codes_SRS_FILE_01_067: [ If position + size is greater than INT64_MAX then file_map_region shall fail and return NULL. ]*/
+        /*Codes_SRS_FILE_WIN32_01_057: [ If position + size is greater than INT64_MAX then file_map_region shall fail and return NULL. ]*/
+        ((position + size) > INT64_MAX)
+        )
+    {
+        LogError("Invalid arguments to file_map_region: FILE_HANDLE handle=%p, uint64_t position=%" PRIu64 ", uint32_t size=%" PRIu32 ", FILE_ACCESS_HINT access_hint=%" PRI_MU_ENUM "",
+            handle, position, size, MU_ENUM_VALUE(FILE_ACCESS_HINT, access_hint));
+        result = NULL;
+    }
+    else
+    {
+        LARGE_INTEGER file_size;
+        /*Codes_SRS_FILE_WIN32_01_058: [ file_map_region shall call GetFileSizeEx to get the size of the file. ]*/
+        if (!GetFileSizeEx(handle->h_file, &file_size))
+        {
+            /*Codes_SRS_FILE_01_071: [ If there are any other failures, file_map_region shall fail and return NULL. ]*/
+            /*Codes_SRS_FILE_WIN32_01_065: [ If there are any failures, file_map_region shall fail and return NULL. ]*/
+            LogLastError("failure in GetFileSizeEx");
+            result = NULL;
+        }
+        /*Codes_SRS_FILE_01_068: [ If position + size is greater than the size of the file then file_map_region shall fail and return NULL. ]*/
+        /*Codes_SRS_FILE_WIN32_01_059: [ If position + size is greater than the size of the file, file_map_region shall fail and return NULL. ]*/
+        else if (position + size > (uint64_t)file_size.QuadPart)
+        {
+            LogError("Cannot map a region past the end of the file: uint64_t position=%" PRIu64 ", uint32_t size=%" PRIu32 ", file size=%" PRId64 "",
+                position, size, (int64_t)file_size.QuadPart);
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_WIN32_01_060: [ file_map_region shall allocate a FILE_MAPPED_REGION. ]*/
+            result = malloc(sizeof(FILE_MAPPED_REGION));
+            if (result == NULL)
+            {
+                /*Codes_SRS_FILE_01_071: [ If there are any other failures, file_map_region shall fail and return NULL. ]*/
+                /*Codes_SRS_FILE_WIN32_01_065: [ If there are any failures, file_map_region shall fail and return NULL. ]*/
+                LogError("failure in malloc(sizeof(FILE_MAPPED_REGION)=%zu)", sizeof(FILE_MAPPED_REGION));
+            }
+            else
+            {
+                /*Codes_SRS_FILE_WIN32_01_061: [ file_map_region shall call CreateFileMappingA with the file handle, NULL, PAGE_READONLY, 0, 0 and NULL to create a read-only mapping object of the whole file. ]*/
+                result->h_mapping = CreateFileMappingA(handle->h_file, NULL, PAGE_READONLY, 0, 0, NULL);
+                if (result->h_mapping == NULL)
+                {
+                    /*Codes_SRS_FILE_01_071: [ If there are any other failures, file_map_region shall fail and return NULL. ]*/
+                    /*Codes_SRS_FILE_WIN32_01_065: [ If there are any failures, file_map_region shall fail and return NULL. ]*/
+                    LogLastError("failure in CreateFileMappingA");
+                }
+                else
+                {
+                    SYSTEM_INFO system_info;
+                    uint64_t map_offset;
+                    SIZE_T map_length;
+
+                    /*the offset of a view has to be a multiple of the allocation granularity*/
+                    GetSystemInfo(&system_info);
+                    map_offset = position - (position % system_info.dwAllocationGranularity);
+                    map_length = (SIZE_T)(position - map_offset) + size;
+
+                    /*Codes_SRS_FILE_01_069: [ file_map_region shall map size bytes of the file starting at position as a read-only view and return a handle to it. ]*/
+                    /*Codes_SRS_FILE_WIN32_01_062: [ file_map_region shall call MapViewOfFile with FILE_MAP_READ, position rounded down to a multiple of the allocation granularity returned by GetSystemInfo as offset and size plus the bytes between offset and position as the number of bytes to map. ]*/
+                    result->view = MapViewOfFile(result->h_mapping, FILE_MAP_READ, (DWORD)(map_offset >> 32), (DWORD)(map_offset & 0xFFFFFFFF), map_length);
+                    if (result->view == NULL)
+                    {
+                        /*Codes_SRS_FILE_01_071: [ If there are any other failures, file_map_region shall fail and return NULL. ]*/
+                        /*Codes_SRS_FILE_WIN32_01_065: [ If there are any failures, file_map_region shall fail and return NULL. ]*/
+                        LogLastError("failure in MapViewOfFile(offset=%" PRIu64 ", length=%zu)", map_offset, (size_t)map_length);
+                    }
+                    else
+                    {
+                        /*Codes_SRS_FILE_WIN32_01_063: [ If access_hint is FILE_ACCESS_HINT_WILL_NEED, file_map_region shall call PrefetchVirtualMemory on the view. Other hints have no equivalent for views and shall be ignored. ]*/
+                        if (access_hint == FILE_ACCESS_HINT_WILL_NEED)
+                        {
+                            WIN32_MEMORY_RANGE_ENTRY range;
+                            range.VirtualAddress = result->view;
+                            range.NumberOfBytes = map_length;
+                            if (!PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0))
+                            {
+                                /*Codes_SRS_FILE_01_070: [ Failing to apply access_hint shall not make file_map_region fail. ]*/
+                                /*Codes_SRS_FILE_WIN32_01_064: [ If PrefetchVirtualMemory fails, file_map_region shall log the failure and continue. ]*/
+                                LogLastError("failure in PrefetchVirtualMemory, continuing");
+                            }
+                        }
+
+                        result->data = (const unsigned char*)result->view + (position - map_offset);
+
+                        /*Codes_SRS_FILE_WIN32_01_066: [ file_map_region shall succeed and return the allocated FILE_MAPPED_REGION. ]*/
+                        goto all_ok;
+                    }
+                    if (!CloseHandle(result->h_mapping))
+                    {
+                        LogLastError("failure in CloseHandle");
+                    }
+                }
+                free(result);
+                result = NULL;
+            }
+        }
+    }
+all_ok:
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, const unsigned char*, file_mapped_region_get_data, FILE_MAPPED_REGION_HANDLE, region)
+{
+    const unsigned char* result;
+    if (region == NULL)
+    {
+        /*Codes_SRS_FILE_01_072: [ If region is NULL then file_mapped_region_get_data shall return NULL. ]*/
+        /*Codes_SRS_FILE_WIN32_01_067: [ If region is NULL then file_mapped_region_get_data shall return NULL. ]*/
+        LogError("Invalid arguments to file_mapped_region_get_data: FILE_MAPPED_REGION_HANDLE region=%p", region);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_073: [ file_mapped_region_get_data shall return a pointer to the byte of the view that corresponds to position in the file. ]*/
+        /*Codes_SRS_FILE_WIN32_01_068: [ file_mapped_region_get_data shall return the address in the view of the byte at position. ]*/
+        result = region->data;
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, void, file_unmap_region, FILE_MAPPED_REGION_HANDLE, region)
+{
+    if (region == NULL)
+    {
+        /*Codes_SRS_FILE_01_074: [ If region is NULL then file_unmap_region shall return. ]*/
+        /*Codes_SRS_FILE_WIN32_01_069: [ If region is NULL then file_unmap_region shall return. ]*/
+        LogError("Invalid arguments to file_unmap_region: FILE_MAPPED_REGION_HANDLE region=%p", region);
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_075: [ file_unmap_region shall unmap the view and free region. ]*/
+        /*Codes_SRS_FILE_WIN32_01_070: [ file_unmap_region shall call UnmapViewOfFile on the view. ]*/
+        if (!UnmapViewOfFile(region->view))
+        {
+            LogLastError("failure in UnmapViewOfFile");
+        }
+
+        /*Codes_SRS_FILE_WIN32_01_071: [ file_unmap_region shall call CloseHandle on the mapping object. ]*/
+        if (!CloseHandle(region->h_mapping))
+        {
+            LogLastError("failure in CloseHandle");
+        }
+
+        /*Codes_SRS_FILE_WIN32_01_072: [ file_unmap_region shall free region. ]*/
+        free(region);
+    }
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_extend, FILE_HANDLE, handle, uint64_t, desired_size)
+{
+    (void)handle;
+    (void)desired_size;
+    /*Codes_SRS_FILE_WIN32_43_050: [ file_extend shall return 0. ]*/
+    /*TODO: Task number 7732885*/
+    return 0;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_set_preallocation, FILE_HANDLE, handle, uint64_t, chunk_size)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_076: [ If handle is NULL then file_set_preallocation shall fail and return a non-zero value. ]*/
         (handle == NULL) ||
-        /*Codes_SRS_FILE_43_010: [ If source is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
-        /*Codes_SRS_FILE_WIN32_43_044: [ If source is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS.]*/
-        (source == NULL) ||
-        /*Codes_SRS_FILE_43_012: [ If user_callback is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
-        /*Codes_SRS_FILE_WIN32_43_045: [ If user_callback is NULL then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS.]*/
-        (user_callback == NULL)||
-        /*Codes_SRS_FILE_43_040: [ If position + size is greater than INT64_MAX, then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
-        /*Codes_SRS_FILE_WIN32_43_060: [ If position + size is greater than INT64_MAX, then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
-        ((position + size) > INT64_MAX)||
-        /*Codes_SRS_FILE_43_042: [ If size is 0 then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
-        /*Codes_SRS_FILE_WIN32_43_061: [ If size is 0 then file_write_async shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
-        (size == 0)
-    )
+        /*Codes_SRS_FILE_01_077: [ If chunk_size is 0 then file_set_preallocation shall fail and return a non-zero value. ]*/
+        (chunk_size == 0) ||
+        /*Codes_SRS_FILE_01_078: [ If chunk_size is greater than INT64_MAX then file_set_preallocation shall fail and return a non-zero value. ]*/
+        (chunk_size > INT64_MAX)
+        )
     {
-        LogError("Invalid arguments to file_write_async: FILE_HANDLE file_handle=%p, const unsigned char* source=%p, uin32_t size=%" PRIu32 ", uint64_t position=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
-            handle, source, size, position, user_callback, user_context);
-        result = FILE_WRITE_ASYNC_INVALID_ARGS;
+        LogError("Invalid arguments to file_set_preallocation: FILE_HANDLE handle=%p, uint64_t chunk_size=%" PRIu64 "",
+            handle, chunk_size);
+        result = MU_FAILURE;
+    }
+    else if (handle->preallocation_chunk_size != 0)
+    {
+        /*Codes_SRS_FILE_01_079: [ If a preallocation policy was already set on handle then file_set_preallocation shall fail and return a non-zero value. ]*/
+        LogError("A preallocation policy was already set on handle=%p, chunk_size=%" PRIu64 "", handle, handle->preallocation_chunk_size);
+        result = MU_FAILURE;
     }
     else
     {
-        bool callback_will_be_called = false;
-        /*Codes_SRS_FILE_WIN32_43_018: [ file_write_async shall allocate a context to store the allocated OVERLAPPED struct, handle, size, user_callback and user_context. ]*/
-        FILE_WIN32_IO* io_context = malloc(sizeof(FILE_WIN32_IO));
-        if (io_context == NULL)
+        LARGE_INTEGER file_size;
+        /*Codes_SRS_FILE_WIN32_01_093: [ file_set_preallocation shall call GetFileSizeEx to get the size of the file. ]*/
+        if (!GetFileSizeEx(handle->h_file, &file_size))
         {
-            /*Codes_SRS_FILE_43_015: [ If there are any failures, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
-            /*Codes_SRS_FILE_WIN32_43_057: [ If there are any other failures, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR.]*/
-            LogError("failure in malloc");
-            result = FILE_WRITE_ASYNC_ERROR;
+            /*Codes_SRS_FILE_01_083: [ If there are any other failures, file_set_preallocation shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_WIN32_01_094: [ If GetFileSizeEx fails, file_set_preallocation shall fail and return a non-zero value. ]*/
+            LogLastError("failure in GetFileSizeEx");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_WIN32_01_095: [ file_set_preallocation shall set the end of the furthest write started, the preallocated end of the file and the preallocation target to the size of the file. ]*/
+            (void)interlocked_exchange_64(&handle->highest_write_end, file_size.QuadPart);
+            (void)interlocked_exchange_64(&handle->preallocated_end, file_size.QuadPart);
+            (void)interlocked_exchange_64(&handle->preallocation_target, file_size.QuadPart);
+
+            /*Codes_SRS_FILE_01_080: [ file_set_preallocation shall set chunk_size as the preallocation chunk size of handle and return 0. ]*/
+            /*Codes_SRS_FILE_WIN32_01_096: [ file_set_preallocation shall set chunk_size as the preallocation chunk size of handle and return 0. ]*/
+            handle->preallocation_chunk_size = chunk_size;
+            result = 0;
+        }
+    }
+    return result;
+}
+
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_set_write_aggregation, FILE_HANDLE, handle, uint32_t, max_aggregated_size, uint32_t, max_delay_ms)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_084: [ If handle is NULL then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_085: [ If max_aggregated_size is 0 then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+        (max_aggregated_size == 0) ||
+        /*Codes_SRS_FILE_01_086: [ If max_delay_ms is 0 then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+        (max_delay_ms == 0)
+        )
+    {
+        LogError("Invalid arguments to file_set_write_aggregation: FILE_HANDLE handle=%p, uint32_t max_aggregated_size=%" PRIu32 ", uint32_t max_delay_ms=%" PRIu32 "",
+            handle, max_aggregated_size, max_delay_ms);
+        result = MU_FAILURE;
+    }
+    else if (handle->write_aggregator != NULL)
+    {
+        /*Codes_SRS_FILE_01_087: [ If a write aggregation policy was already set on handle then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+        LogError("A write aggregation policy was already set on handle=%p", handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_105: [ file_set_write_aggregation shall create the aggregation timer by calling CreateThreadpoolTimer with on_aggregation_timer_win32, handle and the threadpool environment of handle. ]*/
+        PTP_TIMER aggregation_timer = CreateThreadpoolTimer(on_aggregation_timer_win32, handle, &handle->cbe);
+        if (aggregation_timer == NULL)
+        {
+            /*Codes_SRS_FILE_01_092: [ If there are any other failures, file_set_write_aggregation shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_WIN32_01_106: [ If CreateThreadpoolTimer fails, file_set_write_aggregation shall fail and return a non-zero value. ]*/
+            LogLastError("failure in CreateThreadpoolTimer");
+            result = MU_FAILURE;
         }
         else
         {
-            io_context->handle = handle;
-            /*Codes_SRS_FILE_WIN32_43_020: [ file_write_async shall allocate an OVERLAPPED struct and populate it with the created event and position. ]*/
-            (void)memset(&io_context->ov, 0, sizeof(OVERLAPPED));
-            /*Codes_SRS_FILE_WIN32_43_054: [ file_write_async shall create an event by calling CreateEvent.]*/
-            io_context->ov.hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
-            if (io_context->ov.hEvent == NULL)
+            /*Codes_SRS_FILE_01_090: [ The aggregation buffer shall be written when it holds max_aggregated_size bytes, when max_delay_ms milliseconds elapsed since it was started, when a write does not continue it, or when the file is destroyed. ]*/
+            /*Codes_SRS_FILE_WIN32_01_107: [ file_set_write_aggregation shall call write_aggregator_create with 1 as alignment, max_aggregated_size, max_delay_ms, 0 as file size, issue_aggregated_write, start_aggregation_timer, NULL as set_file_size and handle. ]*/
+            /*the file is not opened with FILE_FLAG_NO_BUFFERING, so the aggregated writes do not need to be aligned*/
+            WRITE_AGGREGATOR_HANDLE write_aggregator = write_aggregator_create(1, max_aggregated_size, max_delay_ms, 0, issue_aggregated_write, start_aggregation_timer, NULL, handle);
+            if (write_aggregator == NULL)
             {
-                /*Codes_SRS_FILE_43_015: [ If there are any failures, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
-                /*Codes_SRS_FILE_WIN32_43_057: [ If there are any other failures, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR.]*/
-                LogLastError("failure in CreateEvent");
-                result = FILE_WRITE_ASYNC_ERROR;
+                /*Codes_SRS_FILE_01_092: [ If there are any other failures, file_set_write_aggregation shall fail and return a non-zero value. ]*/
+                /*Codes_SRS_FILE_WIN32_01_108: [ If write_aggregator_create fails, file_set_write_aggregation shall call CloseThreadpoolTimer and return a non-zero value. ]*/
+                LogError("failure in write_aggregator_create, max_aggregated_size=%" PRIu32 ", max_delay_ms=%" PRIu32 "", max_aggregated_size, max_delay_ms);
+                CloseThreadpoolTimer(aggregation_timer);
+                result = MU_FAILURE;
             }
             else
             {
-                io_context->ov.Offset = position & 0xFFFFFFFFULL;
-                io_context->ov.OffsetHigh = position >> 32;
-
-                io_context->user_callback = user_callback;
-                io_context->user_context = user_context;
+                /*Codes_SRS_FILE_01_088: [ file_set_write_aggregation shall set the write aggregation policy of handle and return 0. ]*/
+                /*Codes_SRS_FILE_WIN32_01_109: [ file_set_write_aggregation shall store the aggregation timer and the write aggregator in handle and return 0. ]*/
+                handle->aggregation_timer = aggregation_timer;
+                handle->write_aggregator = write_aggregator;
+                result = 0;
+            }
+        }
+    }
+    return result;
+}
 
-                io_context->size = size;
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_set_read_ahead, FILE_HANDLE, handle, uint32_t, block_size, uint32_t, block_count)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_093: [ If handle is NULL then file_set_read_ahead shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_094: [ If block_size is 0 then file_set_read_ahead shall fail and return a non-zero value. ]*/
+        (block_size == 0) ||
+        /*Codes_SRS_FILE_01_095: [ If block_count is 0 then file_set_read_ahead shall fail and return a non-zero value. ]*/
+        (block_count == 0)
+        )
+    {
+        LogError("Invalid arguments to file_set_read_ahead: FILE_HANDLE handle=%p, uint32_t block_size=%" PRIu32 ", uint32_t block_count=%" PRIu32 "",
+            handle, block_size, block_count);
+        result = MU_FAILURE;
+    }
+    else if (handle->read_ahead != NULL)
+    {
+        /*Codes_SRS_FILE_01_096: [ If a read-ahead policy was already set on handle then file_set_read_ahead shall fail and return a non-zero value. ]*/
+        LogError("A read-ahead policy was already set on handle=%p", handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_136: [ file_set_read_ahead shall call read_ahead_create with 1 as alignment, block_size, block_count, issue_read_ahead and handle. ]*/
+        READ_AHEAD_HANDLE read_ahead = read_ahead_create(1, block_size, block_count, issue_read_ahead, handle);
+        if (read_ahead == NULL)
+        {
+            /*Codes_SRS_FILE_01_101: [ If there are any other failures, file_set_read_ahead shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_WIN32_01_137: [ If read_ahead_create fails, file_set_read_ahead shall fail and return a non-zero value. ]*/
+            LogError("failure in read_ahead_create, block_size=%" PRIu32 ", block_count=%" PRIu32 "", block_size, block_count);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_01_097: [ file_set_read_ahead shall set the read-ahead policy of handle and return 0. ]*/
+            /*Codes_SRS_FILE_WIN32_01_138: [ file_set_read_ahead shall store the read-ahead in handle and return 0. ]*/
+            handle->read_ahead = read_ahead;
+            result = 0;
+        }
+    }
+    return result;
+}
 
-                /*Codes_SRS_FILE_WIN32_43_017: [ file_write_async shall call StartThreadpoolIo.]*/
-                StartThreadpoolIo(handle->ptp_io);
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_set_access_hint, FILE_HANDLE, handle, FILE_ACCESS_HINT, access_hint)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_102: [ If handle is NULL then file_set_access_hint shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_103: [ If access_hint is not FILE_ACCESS_HINT_NORMAL, FILE_ACCESS_HINT_SEQUENTIAL or FILE_ACCESS_HINT_RANDOM then file_set_access_hint shall fail and return a non-zero value. ]*/
+        (
+            (access_hint != FILE_ACCESS_HINT_NORMAL) &&
+            (access_hint != FILE_ACCESS_HINT_SEQUENTIAL) &&
+            (access_hint != FILE_ACCESS_HINT_RANDOM)
+        )
+        )
+    {
+        LogError("Invalid arguments to file_set_access_hint: FILE_HANDLE handle=%p, FILE_ACCESS_HINT access_hint=%" PRI_MU_ENUM "",
+            handle, MU_ENUM_VALUE(FILE_ACCESS_HINT, access_hint));
+        result = MU_FAILURE;
+    }
+    else if (handle->read_ahead == NULL)
+    {
+        /*Codes_SRS_FILE_01_104: [ If no read-ahead policy was set on handle then file_set_access_hint shall fail and return a non-zero value. ]*/
+        LogError("No read-ahead policy was set on handle=%p", handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_139: [ file_set_access_hint shall call read_ahead_set_mode with READ_AHEAD_MODE_AUTO for FILE_ACCESS_HINT_NORMAL, READ_AHEAD_MODE_SEQUENTIAL for FILE_ACCESS_HINT_SEQUENTIAL and READ_AHEAD_MODE_OFF for FILE_ACCESS_HINT_RANDOM. ]*/
+        READ_AHEAD_MODE mode =
+            (access_hint == FILE_ACCESS_HINT_SEQUENTIAL) ? READ_AHEAD_MODE_SEQUENTIAL :
+            (access_hint == FILE_ACCESS_HINT_RANDOM) ? READ_AHEAD_MODE_OFF :
+            READ_AHEAD_MODE_AUTO;
 
-                /*Codes_SRS_FILE_43_014: [ file_write_async shall enqueue a write request to write source's content to the position offset in the file. ]*/
-                /*Codes_SRS_FILE_43_041: [ If position + size is greater than the size of the file and the call to write is successfull, file_write_async shall grow the file to accomodate the write. ]*/
-                /*Codes_SRS_FILE_WIN32_43_021: [ file_write_async shall call WriteFile with handle, source, size and the allocated OVERLAPPED struct.]*/
-                if (WriteFile(handle->h_file, source, size, NULL, &io_context->ov) == FALSE)
-                {
-                    if (GetLastError() == ERROR_IO_PENDING)
-                    {
-                        /*Codes_SRS_FILE_43_008: [ file_write_async shall call user_call_back passing user_context and success depending on the success of the asynchronous write operation.]*/
-                        /*Codes_SRS_FILE_43_030: [ file_write_async shall succeed and return FILE_WRITE_ASYNC_OK. ]*/
-                        /*Codes_SRS_FILE_WIN32_43_022: [ If WriteFile fails synchronously and GetLastError indicates ERROR_IO_PENDING then file_write_async shall succeed and return FILE_WRITE_ASYNC_OK.]*/
-                        callback_will_be_called = true;
-                        result = FILE_WRITE_ASYNC_OK;
-                    }
-                    else
-                    {
-                        /*Codes_SRS_FILE_43_035: [ If the call to write the file fails, file_write_async shall fail and return FILE_WRITE_ASYNC_WRITE_ERROR. ]*/
-                        /*Codes_SRS_FILE_WIN32_43_023: [ If WriteFile fails synchronously and GetLastError does not indicate ERROR_IO_PENDING then file_write_async shall fail, call CancelThreadpoolIo and return FILE_WRITE_ASYNC_WRITE_ERROR.]*/
-                        LogLastError("failure in WriteFile");
-                        CancelThreadpoolIo(handle->ptp_io);
-                        result = FILE_WRITE_ASYNC_WRITE_ERROR;
-                    }
-                }
-                else
-                {
-                    /*Codes_SRS_FILE_43_008: [ file_write_async shall call user_call_back passing user_context and success depending on the success of the asynchronous write operation.]*/
-                    /*Codes_SRS_FILE_43_030: [ file_write_async shall succeed and return FILE_WRITE_ASYNC_OK. ]*/
-                    /*Codes_SRS_FILE_WIN32_43_024: [ If WriteFile succeeds synchronously then file_write_async shall succeed, call CancelThreadpoolIo, call user_callback and return FILE_WRITE_ASYNC_OK.]*/
-                    CancelThreadpoolIo(handle->ptp_io);
-                    user_callback(user_context, true);
-                    result = FILE_WRITE_ASYNC_OK;
-                }
-                if (!callback_will_be_called)
-                {
-                    if (!CloseHandle(io_context->ov.hEvent))
-                    {
-                        LogLastError("Failure in CloseHandle");
-                    }
-                }
-            }
-            if (!callback_will_be_called)
-            {
-                free(io_context);
-            }
+        if (read_ahead_set_mode(handle->read_ahead, mode) != 0)
+        {
+            /*Codes_SRS_FILE_01_106: [ If there are any other failures, file_set_access_hint shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_WIN32_01_140: [ If read_ahead_set_mode fails, file_set_access_hint shall fail and return a non-zero value. ]*/
+            LogError("failure in read_ahead_set_mode, mode=%" PRI_MU_ENUM "", MU_ENUM_VALUE(READ_AHEAD_MODE, mode));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_01_105: [ file_set_access_hint shall apply access_hint to the read-ahead policy of handle and return 0. ]*/
+            result = 0;
         }
     }
     return result;
 }
 
-IMPLEMENT_MOCKABLE_FUNCTION(, FILE_READ_ASYNC_RESULT, file_read_async, FILE_HANDLE, handle, unsigned char*, destination, uint32_t, size, uint64_t,position, FILE_CB, user_callback, void*, user_context)
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_will_need, FILE_HANDLE, handle, uint64_t, position, uint64_t, size)
 {
-    FILE_READ_ASYNC_RESULT result;
-    if
-    (
-        /*Codes_SRS_FILE_43_017: [ If handle is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
-        /*Codes_SRS_FILE_WIN32_43_046: [ If handle is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_107: [ If handle is NULL then file_will_need shall fail and return a non-zero value. ]*/
         (handle == NULL) ||
-        /*Codes_SRS_FILE_43_032: [ If destination is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
-        /*Codes_SRS_FILE_WIN32_43_051: [ If destination is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
-        (destination == NULL) ||
-        /*Codes_SRS_FILE_43_020: [ If user_callback is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
-        /*Codes_SRS_FILE_WIN32_43_047: [ If user_callback is NULL then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
-        (user_callback == NULL) ||
-        /*Codes_SRS_FILE_43_043: [ If size is 0 then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
-        /*Codes_SRS_FILE_WIN32_43_062: [ If size is 0 then file_read_async shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
-        (size == 0)
-    )
+        /*Codes_SRS_FILE_01_108: [ If size is 0 then file_will_need shall fail and return a non-zero value. ]*/
+        (size == 0) ||
+        /*Codes_SRS_FILE_01_109: [ If position + size overflows then file_will_need shall fail and return a non-zero value. ]*/
+        (position > UINT64_MAX - size)
+        )
     {
-        LogError("Invalid arguments to file_read_async: FILE_HANDLE file_handle=%p, unsigned char* destination=%p, uin32_t size=%" PRIu32 ", uint64_t position=%" PRIu64 ", FILE_CB user_callback=%p, void* user_context=%p",
-            handle, destination, size, position, user_callback, user_context);
-        result = FILE_READ_ASYNC_INVALID_ARGS;
+        LogError("Invalid arguments to file_will_need: FILE_HANDLE handle=%p, uint64_t position=%" PRIu64 ", uint64_t size=%" PRIu64 "",
+            handle, position, size);
+        result = MU_FAILURE;
+    }
+    else if (handle->read_ahead == NULL)
+    {
+        /*Codes_SRS_FILE_01_110: [ If no read-ahead policy was set on handle then file_will_need shall fail and return a non-zero value. ]*/
+        LogError("No read-ahead policy was set on handle=%p", handle);
+        result = MU_FAILURE;
     }
     else
     {
-        bool callback_will_be_called = false;
-        /*Codes_SRS_FILE_WIN32_43_026: [ file_read_async shall allocate a context to store the allocated OVERLAPPED struct, destination, handle, size, user_callback and user_context ]*/
-        FILE_WIN32_IO* io_context = malloc(sizeof(FILE_WIN32_IO));
-        if (io_context == NULL)
+        /*Codes_SRS_FILE_01_111: [ file_will_need shall start reading the blocks that hold size bytes starting at position, up to block_count blocks, and return 0. ]*/
+        /*Codes_SRS_FILE_WIN32_01_141: [ file_will_need shall call read_ahead_will_need with position and size. ]*/
+        if (read_ahead_will_need(handle->read_ahead, position, size) != 0)
         {
-            /*Codes_SRS_FILE_43_022: [ If there are any failures then file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
-            /*Codes_SRS_FILE_WIN32_43_058: [ If there are any other failures, file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
-            LogError("Failure in malloc");
-            result = FILE_READ_ASYNC_ERROR;
+            /*Codes_SRS_FILE_01_112: [ If there are any other failures, file_will_need shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_WIN32_01_142: [ If read_ahead_will_need fails, file_will_need shall fail and return a non-zero value. ]*/
+            LogError("failure in read_ahead_will_need, position=%" PRIu64 ", size=%" PRIu64 "", position, size);
+            result = MU_FAILURE;
         }
         else
         {
-            io_context->handle = handle;
-            /*Codes_SRS_FILE_WIN32_43_028: [ file_read_async shall allocate an OVERLAPPED struct and populate it with the created event and position. ]*/
-            (void)memset(&io_context->ov, 0, sizeof(OVERLAPPED));
-            /*Codes_SRS_FILE_WIN32_43_055: [ file_read_async shall create an event by calling CreateEvent. ]*/
-            io_context->ov.hEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
-            if (io_context->ov.hEvent == NULL)
-            {
-                /*Codes_SRS_FILE_43_022: [ If there are any failures then file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
-                /*Codes_SRS_FILE_WIN32_43_058: [ If there are any other failures, file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
-                LogLastError("Failure in CreateEvent");
-                result = FILE_READ_ASYNC_ERROR;
-            }
-            else
-            {
-                io_context->ov.Offset = position & 0xFFFFFFFFULL;
-                io_context->ov.OffsetHigh = position >> 32;
+            result = 0;
+        }
+    }
+    return result;
+}
 
-                io_context->user_callback = user_callback;
-                io_context->user_context = user_context;
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_set_io_limit, FILE_HANDLE, handle, uint32_t, max_outstanding_io, FILE_IO_LIMIT_MODE, mode)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_113: [ If handle is NULL then file_set_io_limit shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_114: [ If mode is not FILE_IO_LIMIT_MODE_BUSY or FILE_IO_LIMIT_MODE_QUEUE then file_set_io_limit shall fail and return a non-zero value. ]*/
+        (
+            (mode != FILE_IO_LIMIT_MODE_BUSY) &&
+            (mode != FILE_IO_LIMIT_MODE_QUEUE)
+        )
+        )
+    {
+        LogError("Invalid arguments to file_set_io_limit: FILE_HANDLE handle=%p, uint32_t max_outstanding_io=%" PRIu32 ", FILE_IO_LIMIT_MODE mode=%" PRI_MU_ENUM "",
+            handle, max_outstanding_io, MU_ENUM_VALUE(FILE_IO_LIMIT_MODE, mode));
+        result = MU_FAILURE;
+    }
+    else if (handle->is_io_limit_set)
+    {
+        /*Codes_SRS_FILE_01_115: [ If an I/O limit was already set on handle then file_set_io_limit shall fail and return a non-zero value. ]*/
+        LogError("An I/O limit was already set on handle=%p", handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_185: [ If max_outstanding_io is 0, file_set_io_limit shall not create an admission for handle. ]*/
+        /*Codes_SRS_FILE_WIN32_01_186: [ Otherwise file_set_io_limit shall call io_admission_create with max_outstanding_io. ]*/
+        IO_ADMISSION_HANDLE io_admission = (max_outstanding_io == 0) ? NULL : io_admission_create(max_outstanding_io);
+        if (
+            (max_outstanding_io != 0) &&
+            (io_admission == NULL)
+            )
+        {
+            /*Codes_SRS_FILE_01_121: [ If there are any other failures, file_set_io_limit shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_WIN32_01_187: [ If io_admission_create fails, file_set_io_limit shall fail and return a non-zero value. ]*/
+            LogError("failure in io_admission_create, max_outstanding_io=%" PRIu32 "", max_outstanding_io);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_01_116: [ file_set_io_limit shall set the I/O limit of handle to max_outstanding_io (no limit if max_outstanding_io is 0) and the mode to mode and return 0. ]*/
+            /*Codes_SRS_FILE_WIN32_01_188: [ file_set_io_limit shall store the admission and mode in handle, mark the I/O limit as set and return 0. ]*/
+            handle->io_admission = io_admission;
+            handle->io_limit_mode = mode;
+            handle->is_io_limit_set = true;
+            result = 0;
+        }
+    }
+    return result;
+}
 
-                io_context->size = size;
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_get_io_admission_statistics, FILE_HANDLE, handle, IO_ADMISSION_STATISTICS*, statistics)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_122: [ If handle is NULL then file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_123: [ If statistics is NULL then file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments to file_get_io_admission_statistics: FILE_HANDLE handle=%p, IO_ADMISSION_STATISTICS* statistics=%p",
+            handle, statistics);
+        result = MU_FAILURE;
+    }
+    else if (handle->io_admission == NULL)
+    {
+        /*Codes_SRS_FILE_01_124: [ If no I/O limit was set on handle or it was set with max_outstanding_io 0 then file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+        LogError("No I/O limit was set on handle=%p", handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_125: [ file_get_io_admission_statistics shall fill statistics with the counters of the I/O limit of handle and return 0. ]*/
+        /*Codes_SRS_FILE_WIN32_01_189: [ file_get_io_admission_statistics shall call io_admission_get_statistics on the admission of handle. ]*/
+        if (io_admission_get_statistics(handle->io_admission, statistics) != 0)
+        {
+            /*Codes_SRS_FILE_WIN32_01_190: [ If io_admission_get_statistics fails, file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+            LogError("failure in io_admission_get_statistics");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            result = 0;
+        }
+    }
+    return result;
+}
 
-                /*Codes_SRS_FILE_43_021: [ file_read_async shall enqueue a read request to read handle's content at position offset and write it to destination. ]*/
-                /*Codes_SRS_FILE_43_039: [ If position + size exceeds the size of the file, user_callback shall be called with success as false. ]*/
-                /*Codes_SRS_FILE_WIN32_43_025: [ file_read_async shall call StartThreadpoolIo. ]*/
-                StartThreadpoolIo(handle->ptp_io);
-                /*Codes_SRS_FILE_WIN32_43_029: [ file_read_async shall call ReadFile with handle, destination, size and the allocated OVERLAPPED struct.]*/
-                if (ReadFile(handle->h_file, destination, size, NULL, &io_context->ov) == FALSE)
-                {
-                    if (GetLastError() == ERROR_IO_PENDING)
-                    {
-                        /*Codes_SRS_FILE_43_016: [ file_read_async shall call user_callback passing user_context and success depending on the success of the asynchronous read operation.]*/
-                        /*Codes_SRS_FILE_43_031: [ file_read_async shall succeed and return FILE_READ_ASYNC_OK. ]*/
-                        /*Codes_SRS_FILE_WIN32_43_030: [ If ReadFile fails synchronously and GetLastError indicates ERROR_IO_PENDING then file_read_async shall succeed and return FILE_READ_ASYNC_OK. ]*/
-                        callback_will_be_called = true;
-                        result = FILE_READ_ASYNC_OK;
-                    }
-                    else
-                    {
-                        /*Codes_SRS_FILE_43_036: [ If the call to read the file fails, file_read_async shall fail and return FILE_READ_ASYNC_READ_ERROR. ]*/
-                        /*Codes_SRS_FILE_WIN32_43_031: [ If ReadFile fails synchronously and GetLastError does not indicate ERROR_IO_PENDING then file_read_async shall fail, call CancelThreadpoolIo and return FILE_READ_ASYNC_WRITE_ERROR. ]*/
-                        LogLastError("Failure in ReadFile");
-                        CancelThreadpoolIo(handle->ptp_io);
-                        result = FILE_READ_ASYNC_READ_ERROR;
-                    }
-                }
-                else
-                {
-                    /*Codes_SRS_FILE_43_016: [ file_read_async shall call user_callback passing user_context and success depending on the success of the asynchronous read operation.]*/
-                    /*Codes_SRS_FILE_43_031: [ file_read_async shall succeed and return FILE_READ_ASYNC_OK. ]*/
-                    /*Codes_SRS_FILE_WIN32_43_032: [ If ReadFile succeeds synchronously then file_read_async shall succeed, call CancelThreadpoolIo, call user_callback and return FILE_READ_ASYNC_OK. ]*/
-                    CancelThreadpoolIo(handle->ptp_io);
-                    user_callback(user_context, true);
-                    result = FILE_READ_ASYNC_OK;
-                }
-                if (!callback_will_be_called)
-                {
-                    if (!CloseHandle(io_context->ov.hEvent))
-                    {
-                        LogLastError("Failure in CloseHandle");
-                    }
-                }
-            }
-            if (!callback_will_be_called)
-            {
-                free(io_context);
-            }
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_set_io_priority, FILE_HANDLE, handle, FILE_IO_PRIORITY, priority)
+{
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_126: [ If handle is NULL then file_set_io_priority shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_127: [ If priority is not FILE_IO_PRIORITY_NORMAL or FILE_IO_PRIORITY_LOW then file_set_io_priority shall fail and return a non-zero value. ]*/
+        (
+            (priority != FILE_IO_PRIORITY_NORMAL) &&
+            (priority != FILE_IO_PRIORITY_LOW)
+        )
+        )
+    {
+        LogError("Invalid arguments to file_set_io_priority: FILE_HANDLE handle=%p, FILE_IO_PRIORITY priority=%" PRI_MU_ENUM "",
+            handle, MU_ENUM_VALUE(FILE_IO_PRIORITY, priority));
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_WIN32_01_192: [ file_set_io_priority shall call SetFileInformationByHandle with FileIoPriorityHintInfo and IoPriorityHintNormal for FILE_IO_PRIORITY_NORMAL or IoPriorityHintLow for FILE_IO_PRIORITY_LOW. ]*/
+        FILE_IO_PRIORITY_HINT_INFO priority_hint_info;
+        priority_hint_info.PriorityHint = (priority == FILE_IO_PRIORITY_LOW) ? IoPriorityHintLow : IoPriorityHintNormal;
+        if (!SetFileInformationByHandle(handle->h_file, FileIoPriorityHintInfo, &priority_hint_info, sizeof(priority_hint_info)))
+        {
+            /*Codes_SRS_FILE_01_130: [ If there are any other failures, file_set_io_priority shall fail and return a non-zero value. ]*/
+            /*Codes_SRS_FILE_WIN32_01_193: [ If SetFileInformationByHandle fails, file_set_io_priority shall fail and return a non-zero value. ]*/
+            LogLastError("failure in SetFileInformationByHandle, priority=%" PRI_MU_ENUM "", MU_ENUM_VALUE(FILE_IO_PRIORITY, priority));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_01_128: [ file_set_io_priority shall set the priority class of the I/Os of handle to priority and return 0. ]*/
+            /*Codes_SRS_FILE_01_129: [ An I/O of a FILE_IO_PRIORITY_LOW file handle that waits for a slot of an I/O limit shall only be started when no I/O of a FILE_IO_PRIORITY_NORMAL file handle waits for a slot of the same limit. ]*/
+            /*Codes_SRS_FILE_WIN32_01_194: [ file_set_io_priority shall set the admission priority of handle to IO_ADMISSION_PRIORITY_NORMAL for FILE_IO_PRIORITY_NORMAL or IO_ADMISSION_PRIORITY_LOW for FILE_IO_PRIORITY_LOW and return 0. ]*/
+            handle->admission_priority = (priority == FILE_IO_PRIORITY_LOW) ? IO_ADMISSION_PRIORITY_LOW : IO_ADMISSION_PRIORITY_NORMAL;
+            result = 0;
         }
     }
     return result;
 }
 
-IMPLEMENT_MOCKABLE_FUNCTION(, int, file_extend, FILE_HANDLE, handle, uint64_t, desired_size)
+IMPLEMENT_MOCKABLE_FUNCTION(, int, file_get_io_context_pool_statistics, FILE_HANDLE, handle, IO_CONTEXT_POOL_STATISTICS*, statistics)
 {
-    (void)handle;
-    (void)desired_size;
-    /*Codes_SRS_FILE_WIN32_43_050: [ file_extend shall return 0. ]*/
-    /*TODO: Task number 7732885*/
-    return 0;
+    int result;
+    if (
+        /*Codes_SRS_FILE_01_055: [ If handle is NULL then file_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+        (handle == NULL) ||
+        /*Codes_SRS_FILE_01_056: [ If statistics is NULL then file_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments to file_get_io_context_pool_statistics: FILE_HANDLE handle=%p, IO_CONTEXT_POOL_STATISTICS* statistics=%p",
+            handle, statistics);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /*Codes_SRS_FILE_01_057: [ file_get_io_context_pool_statistics shall fill statistics with the hit and miss counters of the I/O context pool of handle and return 0. ]*/
+        /*Codes_SRS_FILE_WIN32_01_034: [ file_get_io_context_pool_statistics shall call io_context_pool_get_statistics on the I/O context pool of handle. ]*/
+        if (io_context_pool_get_statistics(handle->io_context_pool, statistics) != 0)
+        {
+            /*Codes_SRS_FILE_WIN32_01_035: [ If io_context_pool_get_statistics fails, file_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+            LogError("failure in io_context_pool_get_statistics");
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /*Codes_SRS_FILE_WIN32_01_036: [ Otherwise file_get_io_context_pool_statistics shall succeed and return 0. ]*/
+            result = 0;
+        }
+    }
+    return result;
 }
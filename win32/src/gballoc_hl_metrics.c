@@ -443,3 +443,69 @@ void gballoc_hl_free(void* ptr)
         }
     }
 }
+
+void* gballoc_hl_aligned_malloc(size_t alignment, size_t size)
+{
+    void* result;
+
+    /*Codes_SRS_GBALLOC_HL_METRICS_01_040: [ gballoc_hl_aligned_malloc shall call lazy_init to initialize. ]*/
+    if (lazy_init(&g_lazy, do_init, NULL) != LAZY_INIT_OK)
+    {
+        /* Codes_SRS_GBALLOC_HL_METRICS_01_041: [ If the module was not initialized, gballoc_hl_aligned_malloc shall return NULL. ]*/
+        LogError("Not initialized");
+        result = NULL;
+    }
+    else
+    {
+        /* Codes_SRS_GBALLOC_HL_METRICS_01_042: [ gballoc_hl_aligned_malloc shall call timer_global_get_elapsed_us to obtain the start time of the allocate. ]*/
+        double start_time = timer_global_get_elapsed_us();
+
+        /* Codes_SRS_GBALLOC_HL_METRICS_01_043: [ gballoc_hl_aligned_malloc shall call gballoc_ll_aligned_malloc(alignment, size) and return the result of gballoc_ll_aligned_malloc. ]*/
+        result = gballoc_ll_aligned_malloc(alignment, size);
+
+        if (result == NULL)
+        {
+            LogError("failure in gballoc_ll_aligned_malloc(alignment=%zu, size=%zu)", alignment, size);
+        }
+
+        /* Codes_SRS_GBALLOC_HL_METRICS_01_044: [ gballoc_hl_aligned_malloc shall call timer_global_get_elapsed_us to obtain the end time of the allocate. ]*/
+        double end_time = timer_global_get_elapsed_us();
+
+        /* Codes_SRS_GBALLOC_HL_METRICS_01_045: [ gballoc_hl_aligned_malloc shall record the latency in the latency buckets of the malloc API. ]*/
+        LONG latency = (LONG)(end_time - start_time);
+        internal_add_call_latency(malloc_latency_buckets, size, latency);
+    }
+
+    return result;
+}
+
+void gballoc_hl_aligned_free(void* ptr)
+{
+    if (interlocked_add(&g_lazy, 0) == LAZY_INIT_NOT_DONE)
+    {
+        /* Codes_SRS_GBALLOC_HL_METRICS_01_046: [ If the module was not initialized, gballoc_hl_aligned_free shall return. ]*/
+        LogError("Not initialized");
+    }
+    else
+    {
+        if (ptr != NULL)
+        {
+            /* Codes_SRS_GBALLOC_HL_METRICS_01_047: [ gballoc_hl_aligned_free shall call timer_global_get_elapsed_us to obtain the start time of the free. ]*/
+            double start_time = timer_global_get_elapsed_us();
+            size_t size;
+
+            /* Codes_SRS_GBALLOC_HL_METRICS_01_048: [ gballoc_hl_aligned_free shall call gballoc_ll_aligned_size to obtain the size of the allocation (used for latency counters). ]*/
+            size = gballoc_ll_aligned_size(ptr);
+
+            /* Codes_SRS_GBALLOC_HL_METRICS_01_049: [ gballoc_hl_aligned_free shall call gballoc_ll_aligned_free(ptr). ]*/
+            gballoc_ll_aligned_free(ptr);
+
+            /* Codes_SRS_GBALLOC_HL_METRICS_01_050: [ gballoc_hl_aligned_free shall call timer_global_get_elapsed_us to obtain the end time of the free. ]*/
+            double end_time = timer_global_get_elapsed_us();
+
+            /* Codes_SRS_GBALLOC_HL_METRICS_01_051: [ gballoc_hl_aligned_free shall record the latency in the latency buckets of the free API. ]*/
+            LONG latency = (LONG)(end_time - start_time);
+            internal_add_call_latency(free_latency_buckets, size, latency);
+        }
+    }
+}
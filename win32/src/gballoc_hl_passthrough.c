@@ -146,6 +146,36 @@ void* gballoc_hl_realloc(void* ptr, size_t size)
     return result;
 }
 
+void* gballoc_hl_aligned_malloc(size_t alignment, size_t size)
+{
+    void* result;
+    /*Codes_SRS_GBALLOC_HL_PASSTHROUGH_01_001: [ gballoc_hl_aligned_malloc shall call lazy_init passing as execution function do_init and NULL for argument. ]*/
+    if (lazy_init(&g_lazy, do_init, NULL) != LAZY_INIT_OK)
+    {
+        /*Codes_SRS_GBALLOC_HL_PASSTHROUGH_01_002: [ If lazy_init fail then gballoc_hl_aligned_malloc shall fail and return NULL. ]*/
+        LogError("failure in lazy_init(&g_lazy=%p, do_init=%p, gballoc_ll_init_params=%p)",
+            &g_lazy, do_init, NULL);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_GBALLOC_HL_PASSTHROUGH_01_003: [ gballoc_hl_aligned_malloc shall call gballoc_ll_aligned_malloc(alignment, size) and return what gballoc_ll_aligned_malloc returned. ]*/
+        result = gballoc_ll_aligned_malloc(alignment, size);
+
+        if (result == NULL)
+        {
+            LogError("failure in gballoc_ll_aligned_malloc(alignment=%zu, size=%zu)", alignment, size);
+        }
+    }
+    return result;
+}
+
+void gballoc_hl_aligned_free(void* ptr)
+{
+    /*Codes_SRS_GBALLOC_HL_PASSTHROUGH_01_004: [ gballoc_hl_aligned_free shall call gballoc_ll_aligned_free(ptr). ]*/
+    gballoc_ll_aligned_free(ptr);
+}
+
 void gballoc_hl_reset_counters(void)
 {
     /*Codes_SRS_GBALLOC_HL_PASSTHROUGH_02_009: [ gballoc_hl_reset_counters shall return. ]*/
@@ -64,6 +64,39 @@ void* gballoc_ll_realloc(void* ptr, size_t size)
     return result;
 }
 
+void* gballoc_ll_aligned_malloc(size_t alignment, size_t size)
+{
+    void* result;
+
+    if (
+        /*Codes_SRS_GBALLOC_LL_JEMALLOC_01_008: [ If alignment is 0 or is not a power of 2, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+        (alignment == 0) ||
+        ((alignment & (alignment - 1)) != 0) ||
+        /*Codes_SRS_GBALLOC_LL_JEMALLOC_01_009: [ If size is 0, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+        (size == 0)
+        )
+    {
+        LogError("Invalid arguments: size_t alignment=%zu, size_t size=%zu", alignment, size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_GBALLOC_LL_JEMALLOC_01_010: [ gballoc_ll_aligned_malloc shall call je_mallocx(size, MALLOCX_ALIGN(alignment)) and return what je_mallocx returned. ]*/
+        if ((result = je_mallocx(size, MALLOCX_ALIGN(alignment))) == NULL)
+        {
+            LogError("failure in je_mallocx(size=%zu, MALLOCX_ALIGN(alignment=%zu))", size, alignment);
+        }
+    }
+
+    return result;
+}
+
+void gballoc_ll_aligned_free(void* ptr)
+{
+    /*Codes_SRS_GBALLOC_LL_JEMALLOC_01_011: [ gballoc_ll_aligned_free shall call je_free(ptr). ]*/
+    je_free(ptr);
+}
+
 size_t gballoc_ll_size(void* ptr)
 {
     size_t result;
@@ -74,3 +107,13 @@ size_t gballoc_ll_size(void* ptr)
     return result;
 }
 
+size_t gballoc_ll_aligned_size(void* ptr)
+{
+    size_t result;
+
+    /*Codes_SRS_GBALLOC_LL_JEMALLOC_01_012: [ gballoc_ll_aligned_size shall call je_malloc_usable_size and return what je_malloc_usable_size returned. ]*/
+    result = je_malloc_usable_size(ptr);
+
+    return result;
+}
+
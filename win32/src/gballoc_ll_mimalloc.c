@@ -64,6 +64,39 @@ void* gballoc_ll_realloc(void* ptr, size_t size)
     return result;
 }
 
+void* gballoc_ll_aligned_malloc(size_t alignment, size_t size)
+{
+    void* result;
+
+    if (
+        /*Codes_SRS_GBALLOC_LL_MIMALLOC_01_001: [ If alignment is 0 or is not a power of 2, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+        (alignment == 0) ||
+        ((alignment & (alignment - 1)) != 0) ||
+        /*Codes_SRS_GBALLOC_LL_MIMALLOC_01_002: [ If size is 0, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+        (size == 0)
+        )
+    {
+        LogError("Invalid arguments: size_t alignment=%zu, size_t size=%zu", alignment, size);
+        result = NULL;
+    }
+    else
+    {
+        /*Codes_SRS_GBALLOC_LL_MIMALLOC_01_003: [ gballoc_ll_aligned_malloc shall call mi_malloc_aligned(size, alignment) and return what mi_malloc_aligned returned. ]*/
+        if ((result = mi_malloc_aligned(size, alignment)) == NULL)
+        {
+            LogError("failure in mi_malloc_aligned(size=%zu, alignment=%zu)", size, alignment);
+        }
+    }
+
+    return result;
+}
+
+void gballoc_ll_aligned_free(void* ptr)
+{
+    /*Codes_SRS_GBALLOC_LL_MIMALLOC_01_004: [ gballoc_ll_aligned_free shall call mi_free(ptr). ]*/
+    mi_free(ptr);
+}
+
 size_t gballoc_ll_size(void* ptr)
 {
     size_t result;
@@ -74,3 +107,12 @@ size_t gballoc_ll_size(void* ptr)
     return result;
 }
 
+size_t gballoc_ll_aligned_size(void* ptr)
+{
+    size_t result;
+
+    /*Codes_SRS_GBALLOC_LL_MIMALLOC_01_005: [ gballoc_ll_aligned_size shall call mi_usable_size and return what mi_usable_size returned. ]*/
+    result = mi_usable_size(ptr);
+
+    return result;
+}
@@ -2,6 +2,7 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #include "c_logging/xlogging.h"
@@ -68,6 +69,67 @@ void* gballoc_ll_realloc(void* ptr, size_t size)
     return result;
 }
 
+void* gballoc_ll_aligned_malloc(size_t alignment, size_t size)
+{
+    void* result;
+
+    if (
+        /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_001: [ If alignment is 0 or is not a power of 2, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+        (alignment == 0) ||
+        ((alignment & (alignment - 1)) != 0) ||
+        /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_002: [ If size is 0, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+        (size == 0)
+        )
+    {
+        LogError("Invalid arguments: size_t alignment=%zu, size_t size=%zu", alignment, size);
+        result = NULL;
+    }
+    else
+    {
+        /*the pointer returned by malloc is stored right before the aligned block, so the alignment has to at least fit a pointer*/
+        if (alignment < sizeof(void*))
+        {
+            alignment = sizeof(void*);
+        }
+
+        if (size > SIZE_MAX - sizeof(void*) - (alignment - 1))
+        {
+            /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_006: [ If any error occurs, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+            LogError("size=%zu is too big to be allocated with alignment=%zu", size, alignment);
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_004: [ On Windows, gballoc_ll_aligned_malloc shall call malloc for size + alignment - 1 + sizeof(void*) bytes (with alignment rounded up to sizeof(void*)) and store the pointer returned by malloc immediately before the first aligned address that leaves room for it. ]*/
+            void* block = malloc(size + sizeof(void*) + (alignment - 1));
+            if (block == NULL)
+            {
+                /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_006: [ If any error occurs, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+                LogError("failure in malloc(size=%zu + sizeof(void*) + alignment=%zu - 1)", size, alignment);
+                result = NULL;
+            }
+            else
+            {
+                /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_005: [ gballoc_ll_aligned_malloc shall succeed and return the aligned memory block. ]*/
+                result = (void*)(((uintptr_t)block + sizeof(void*) + (alignment - 1)) & ~(uintptr_t)(alignment - 1));
+                ((void**)result)[-1] = block;
+            }
+        }
+    }
+
+    return result;
+}
+
+void gballoc_ll_aligned_free(void* ptr)
+{
+    /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_007: [ If ptr is NULL, gballoc_ll_aligned_free shall return. ]*/
+    if (ptr != NULL)
+    {
+        /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_009: [ On Windows, gballoc_ll_aligned_free shall call free on the pointer stored immediately before ptr. ]*/
+        free(((void**)ptr)[-1]);
+    }
+}
+
 size_t gballoc_ll_size(void* ptr)
 {
     size_t result;
@@ -77,3 +139,14 @@ size_t gballoc_ll_size(void* ptr)
 
     return result;
 }
+
+size_t gballoc_ll_aligned_size(void* ptr)
+{
+    size_t result;
+    void* block = ((void**)ptr)[-1];
+
+    /*Codes_SRS_GBALLOC_LL_PASSTHROUGH_01_011: [ On Windows, gballoc_ll_aligned_size shall return what _msize returns for the pointer stored immediately before ptr, minus the offset of ptr in that block. ]*/
+    result = _msize(block) - (size_t)((uintptr_t)ptr - (uintptr_t)block);
+
+    return result;
+}
@@ -2,6 +2,7 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #include <stddef.h>
+#include <stdint.h>
 
 #include "windows.h"
 
@@ -177,6 +178,79 @@ void* gballoc_ll_realloc(void* ptr, size_t size)
     return result;
 }
 
+void* gballoc_ll_aligned_malloc(size_t alignment, size_t size)
+{
+    void* result;
+
+    if (
+        /*Codes_SRS_GBALLOC_LL_WIN32HEAP_01_001: [ If alignment is 0 or is not a power of 2, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+        (alignment == 0) ||
+        ((alignment & (alignment - 1)) != 0) ||
+        /*Codes_SRS_GBALLOC_LL_WIN32HEAP_01_002: [ If size is 0, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+        (size == 0)
+        )
+    {
+        LogError("Invalid arguments: size_t alignment=%zu, size_t size=%zu", alignment, size);
+        result = NULL;
+    }
+    /*Codes_SRS_GBALLOC_LL_WIN32HEAP_01_003: [ gballoc_ll_aligned_malloc shall call lazy_init with parameter do_init set to heap_init. ]*/
+    else if (lazy_init(&g_lazy, heap_init, &the_heap) != LAZY_INIT_OK)
+    {
+        /*Codes_SRS_GBALLOC_LL_WIN32HEAP_01_004: [ If lazy_init fails then gballoc_ll_aligned_malloc shall return NULL. ]*/
+        LogError("failure in lazy_init(&g_lazy=%p, heap_init=%p, &the_heap=%p)",
+            &g_lazy, heap_init, &the_heap);
+        result = NULL;
+    }
+    else
+    {
+        /*the pointer returned by HeapAlloc is stored right before the aligned block, so the alignment has to at least fit a pointer*/
+        if (alignment < sizeof(void*))
+        {
+            alignment = sizeof(void*);
+        }
+
+        if (size > SIZE_MAX - sizeof(void*) - (alignment - 1))
+        {
+            /*Codes_SRS_GBALLOC_LL_WIN32HEAP_01_007: [ If any error occurs, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+            LogError("size=%zu is too big to be allocated with alignment=%zu", size, alignment);
+            result = NULL;
+        }
+        else
+        {
+            /*Codes_SRS_GBALLOC_LL_WIN32HEAP_01_005: [ gballoc_ll_aligned_malloc shall call HeapAlloc for size + alignment - 1 + sizeof(void*) bytes (with alignment rounded up to sizeof(void*)) and store the pointer returned by HeapAlloc immediately before the first aligned address that leaves room for it. ]*/
+            void* block = HeapAlloc(the_heap, 0, size + sizeof(void*) + (alignment - 1));
+            if (block == NULL)
+            {
+                /*Codes_SRS_GBALLOC_LL_WIN32HEAP_01_007: [ If any error occurs, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+                LogError("failure in HeapAlloc(the_heap=%p, 0, size=%zu + sizeof(void*) + alignment=%zu - 1)", the_heap, size, alignment);
+                result = NULL;
+            }
+            else
+            {
+                /*Codes_SRS_GBALLOC_LL_WIN32HEAP_01_006: [ gballoc_ll_aligned_malloc shall succeed and return the aligned memory block. ]*/
+                result = (void*)(((uintptr_t)block + sizeof(void*) + (alignment - 1)) & ~(uintptr_t)(alignment - 1));
+                ((void**)result)[-1] = block;
+            }
+        }
+    }
+    return result;
+}
+
+void gballoc_ll_aligned_free(void* ptr)
+{
+    /*Codes_SRS_GBALLOC_LL_WIN32HEAP_01_008: [ If ptr is NULL, gballoc_ll_aligned_free shall return. ]*/
+    if (ptr != NULL)
+    {
+        void* block = ((void**)ptr)[-1];
+
+        /*Codes_SRS_GBALLOC_LL_WIN32HEAP_01_009: [ gballoc_ll_aligned_free shall call HeapFree on the pointer stored immediately before ptr. ]*/
+        if (!HeapFree(the_heap, 0, block))
+        {
+            LogLastError("failure in HeapFree(the_heap=%p, 0, block=%p), ptr=%p", the_heap, block, ptr);
+        }
+    }
+}
+
 size_t gballoc_ll_size(void* ptr)
 {
     size_t result;
@@ -191,3 +265,23 @@ size_t gballoc_ll_size(void* ptr)
 
     return result;
 }
+
+size_t gballoc_ll_aligned_size(void* ptr)
+{
+    size_t result;
+    void* block = ((void**)ptr)[-1];
+
+    /*Codes_SRS_GBALLOC_LL_WIN32HEAP_01_010: [ gballoc_ll_aligned_size shall call HeapSize on the pointer stored immediately before ptr and return that size minus the offset of ptr in the block. ]*/
+    result = HeapSize(the_heap, 0, block);
+
+    if (result == (size_t)(-1))
+    {
+        LogError("failure in HeapSize(the_heap=%p, 0, block=%p), ptr=%p;", the_heap, block, ptr);
+    }
+    else
+    {
+        result -= (size_t)((uintptr_t)ptr - (uintptr_t)block);
+    }
+
+    return result;
+}
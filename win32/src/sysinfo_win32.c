@@ -26,3 +26,66 @@ uint32_t sysinfo_get_processor_count(void)
 
     return result;
 }
+
+uint32_t sysinfo_get_numa_node_count(void)
+{
+    uint32_t result;
+    ULONG highest_node_number;
+
+    /* Codes_SRS_SYSINFO_01_003: [ sysinfo_get_numa_node_count shall obtain the number of NUMA nodes as reported by the operating system. ]*/
+    /* Codes_SRS_SYSINFO_WIN32_01_003: [ sysinfo_get_numa_node_count shall call GetNumaHighestNodeNumber to obtain the highest NUMA node number. ]*/
+    if (!GetNumaHighestNodeNumber(&highest_node_number))
+    {
+        /* Codes_SRS_SYSINFO_01_004: [ If the host is not NUMA or any error occurs, sysinfo_get_numa_node_count shall return 1. ]*/
+        /* Codes_SRS_SYSINFO_WIN32_01_004: [ If GetNumaHighestNodeNumber fails, sysinfo_get_numa_node_count shall return 1. ]*/
+        LogLastError("GetNumaHighestNodeNumber failed, assuming a single NUMA node");
+        result = 1;
+    }
+    else
+    {
+        /* Codes_SRS_SYSINFO_WIN32_01_005: [ Otherwise sysinfo_get_numa_node_count shall return the highest NUMA node number plus 1. ]*/
+        result = (uint32_t)highest_node_number + 1;
+        LogInfo("Detected %" PRIu32 " NUMA nodes", result);
+    }
+
+    return result;
+}
+
+uint32_t sysinfo_get_current_numa_node(void)
+{
+    uint32_t result;
+    PROCESSOR_NUMBER processor_number;
+    USHORT node_number;
+
+    /* Codes_SRS_SYSINFO_01_005: [ sysinfo_get_current_numa_node shall obtain the NUMA node of the processor the calling thread is running on as reported by the operating system. ]*/
+    /* Codes_SRS_SYSINFO_WIN32_01_006: [ sysinfo_get_current_numa_node shall call GetCurrentProcessorNumberEx to obtain the processor the calling thread is running on. ]*/
+    GetCurrentProcessorNumberEx(&processor_number);
+
+    /* Codes_SRS_SYSINFO_WIN32_01_007: [ sysinfo_get_current_numa_node shall call GetNumaProcessorNodeEx to obtain the NUMA node of the processor. ]*/
+    if (!GetNumaProcessorNodeEx(&processor_number, &node_number))
+    {
+        /* Codes_SRS_SYSINFO_01_006: [ If any error occurs, sysinfo_get_current_numa_node shall return 0. ]*/
+        /* Codes_SRS_SYSINFO_WIN32_01_008: [ If GetNumaProcessorNodeEx fails, sysinfo_get_current_numa_node shall return 0. ]*/
+        LogLastError("GetNumaProcessorNodeEx(Group=%" PRIu16 ", Number=%" PRIu8 ") failed", (uint16_t)processor_number.Group, (uint8_t)processor_number.Number);
+        result = 0;
+    }
+    else
+    {
+        /* Codes_SRS_SYSINFO_WIN32_01_009: [ Otherwise sysinfo_get_current_numa_node shall return the NUMA node returned by GetNumaProcessorNodeEx. ]*/
+        result = node_number;
+    }
+
+    return result;
+}
+
+uint32_t sysinfo_get_current_processor(void)
+{
+    PROCESSOR_NUMBER processor_number;
+
+    /* Codes_SRS_SYSINFO_01_007: [ sysinfo_get_current_processor shall obtain the processor the calling thread is running on as reported by the operating system. ]*/
+    /* Codes_SRS_SYSINFO_WIN32_01_010: [ sysinfo_get_current_processor shall call GetCurrentProcessorNumberEx to obtain the processor the calling thread is running on. ]*/
+    GetCurrentProcessorNumberEx(&processor_number);
+
+    /* Codes_SRS_SYSINFO_WIN32_01_011: [ sysinfo_get_current_processor shall return the group of the processor multiplied by 64 plus the number of the processor in its group. ]*/
+    return ((uint32_t)processor_number.Group * 64) + processor_number.Number;
+}
@@ -1,7 +1,10 @@
 // Copyright (C) Microsoft Corporation. All rights reserved.
 
 #include <inttypes.h>
+#include <limits.h>
+#include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "windows.h"
 #include "c_pal/gballoc_hl.h"
@@ -10,6 +13,8 @@
 #include "c_pal/threadpool.h"
 #include "c_pal/execution_engine.h"
 #include "c_pal/execution_engine_win32.h"
+#include "c_pal/timer.h"
+#include "c_pal/threadpool_statistics.h"
 
 #define THREADPOOL_WIN32_STATE_VALUES \
     THREADPOOL_WIN32_STATE_CLOSED, \
@@ -21,29 +26,167 @@ MU_DEFINE_ENUM(THREADPOOL_WIN32_STATE, THREADPOOL_WIN32_STATE_VALUES)
 MU_DEFINE_ENUM_STRINGS(THREADPOOL_WIN32_STATE, THREADPOOL_WIN32_STATE_VALUES)
 
 MU_DEFINE_ENUM_STRINGS(THREADPOOL_OPEN_RESULT, THREADPOOL_OPEN_RESULT_VALUES)
+MU_DEFINE_ENUM_STRINGS(THREADPOOL_PRIORITY, THREADPOOL_PRIORITY_VALUES)
+
+typedef struct THREADPOOL_QUEUE_WAIT_TAG
+{
+    volatile LONG64 work_item_count;
+    volatile LONG64 total_queue_wait_us;
+    volatile LONG64 max_queue_wait_us;
+} THREADPOOL_QUEUE_WAIT;
 
 typedef struct WORK_ITEM_CONTEXT_TAG
 {
     THREADPOOL_WORK_FUNCTION work_function;
     void* work_function_context;
+    THREADPOOL_QUEUE_WAIT* queue_wait;
+    double schedule_time_us;
+    THREADPOOL_STATISTICS_RECORDER_HANDLE statistics_recorder;
 } WORK_ITEM_CONTEXT;
 
+typedef struct WORK_BATCH_CONTEXT_TAG
+{
+    /*each execution of the PTP_WORK takes the next work item*/
+    volatile LONG next_work_item_index;
+    /*work items not executed yet, the last one to execute closes the PTP_WORK and frees the batch*/
+    volatile LONG pending_work_item_count;
+    THREADPOOL_STATISTICS_RECORDER_HANDLE statistics_recorder;
+    /*only set when the statistics are enabled*/
+    double schedule_time_us;
+    THREADPOOL_WORK_BATCH_ITEM work_items[];
+} WORK_BATCH_CONTEXT;
+
+typedef struct THREADPOOL_WORK_ITEM_TAG
+{
+    PTP_WORK ptp_work;
+    THREADPOOL_WORK_FUNCTION work_function;
+    void* work_function_context;
+    THREADPOOL_STATISTICS_RECORDER_HANDLE statistics_recorder;
+    /*when the work item was last submitted in microseconds, only set when the statistics are enabled*/
+    volatile LONG64 schedule_time_us;
+} THREADPOOL_WORK_ITEM;
+
 typedef struct TIMER_INSTANCE_TAG
 {
     PTP_TIMER timer;
     THREADPOOL_WORK_FUNCTION work_function;
     void* work_function_context;
+    uint32_t tolerance_ms; /*passed as msWindowLength, so that the timer can expire together with other timers*/
+    bool is_lateness_recorded;
+    THREADPOOL_TIMER_LATENESS lateness;
 } TIMER_INSTANCE;
 
 typedef struct THREADPOOL_TAG
 {
     volatile LONG state;
+    EXECUTION_ENGINE_HANDLE execution_engine;
     PTP_POOL pool;
+    /*one environment per priority, tp_environment is the normal priority one*/
     TP_CALLBACK_ENVIRON tp_environment;
+    TP_CALLBACK_ENVIRON tp_environment_high_priority;
+    TP_CALLBACK_ENVIRON tp_environment_low_priority;
     PTP_CLEANUP_GROUP tp_cleanup_group;
     volatile LONG pending_api_calls;
+    THREADPOOL_QUEUE_WAIT high_priority_queue_wait;
+    THREADPOOL_QUEUE_WAIT normal_priority_queue_wait;
+    THREADPOOL_QUEUE_WAIT low_priority_queue_wait;
+    /*NULL unless threadpool_enable_statistics was called, it is only set while the threadpool is closed*/
+    THREADPOOL_STATISTICS_RECORDER_HANDLE statistics_recorder;
 } THREADPOOL;
 
+static bool is_valid_priority(THREADPOOL_PRIORITY priority)
+{
+    return (priority == THREADPOOL_PRIORITY_HIGH) || (priority == THREADPOOL_PRIORITY_NORMAL) || (priority == THREADPOOL_PRIORITY_LOW);
+}
+
+static PTP_CALLBACK_ENVIRON get_environment(THREADPOOL* threadpool, THREADPOOL_PRIORITY priority)
+{
+    PTP_CALLBACK_ENVIRON result;
+
+    if (priority == THREADPOOL_PRIORITY_HIGH)
+    {
+        result = &threadpool->tp_environment_high_priority;
+    }
+    else if (priority == THREADPOOL_PRIORITY_LOW)
+    {
+        result = &threadpool->tp_environment_low_priority;
+    }
+    else
+    {
+        result = &threadpool->tp_environment;
+    }
+
+    return result;
+}
+
+static THREADPOOL_QUEUE_WAIT* get_queue_wait(THREADPOOL* threadpool, THREADPOOL_PRIORITY priority)
+{
+    THREADPOOL_QUEUE_WAIT* result;
+
+    if (priority == THREADPOOL_PRIORITY_HIGH)
+    {
+        result = &threadpool->high_priority_queue_wait;
+    }
+    else if (priority == THREADPOOL_PRIORITY_LOW)
+    {
+        result = &threadpool->low_priority_queue_wait;
+    }
+    else
+    {
+        result = &threadpool->normal_priority_queue_wait;
+    }
+
+    return result;
+}
+
+static void queue_wait_init(THREADPOOL_QUEUE_WAIT* queue_wait)
+{
+    (void)InterlockedExchange64(&queue_wait->work_item_count, 0);
+    (void)InterlockedExchange64(&queue_wait->total_queue_wait_us, 0);
+    (void)InterlockedExchange64(&queue_wait->max_queue_wait_us, 0);
+}
+
+static void queue_wait_record(THREADPOOL_QUEUE_WAIT* queue_wait, double schedule_time_us)
+{
+    double queue_wait_us = timer_global_get_elapsed_us() - schedule_time_us;
+    /*the timer returns -1 on failure, which must not make the wait negative*/
+    LONG64 wait_us = (queue_wait_us > 0) ? (LONG64)queue_wait_us : 0;
+
+    (void)InterlockedIncrement64(&queue_wait->work_item_count);
+    (void)InterlockedAdd64(&queue_wait->total_queue_wait_us, wait_us);
+
+    LONG64 max_wait_us = InterlockedAdd64(&queue_wait->max_queue_wait_us, 0);
+    while (wait_us > max_wait_us)
+    {
+        LONG64 current_max_wait_us = InterlockedCompareExchange64(&queue_wait->max_queue_wait_us, wait_us, max_wait_us);
+        if (current_max_wait_us == max_wait_us)
+        {
+            break;
+        }
+
+        max_wait_us = current_max_wait_us;
+    }
+}
+
+static void initialize_environment(THREADPOOL* threadpool, PTP_CALLBACK_ENVIRON tp_environment, TP_CALLBACK_PRIORITY tp_callback_priority)
+{
+    /* Codes_SRS_THREADPOOL_WIN32_01_026: [ threadpool_open_async shall initialize a thread pool environment by calling InitializeThreadpoolEnvironment. ]*/
+    InitializeThreadpoolEnvironment(tp_environment);
+
+    /* Codes_SRS_THREADPOOL_WIN32_01_027: [ threadpool_open_async shall set the thread pool for the environment to the pool obtained from the execution engine by calling SetThreadpoolCallbackPool. ]*/
+    SetThreadpoolCallbackPool(tp_environment, threadpool->pool);
+
+    /* Codes_SRS_THREADPOOL_WIN32_01_079: [ threadpool_open_async shall set the callback priority of each environment by calling SetThreadpoolCallbackPriority with TP_CALLBACK_PRIORITY_NORMAL, TP_CALLBACK_PRIORITY_HIGH and TP_CALLBACK_PRIORITY_LOW respectively. ]*/
+    SetThreadpoolCallbackPriority(tp_environment, tp_callback_priority);
+}
+
+static void destroy_environments(THREADPOOL* threadpool)
+{
+    DestroyThreadpoolEnvironment(&threadpool->tp_environment);
+    DestroyThreadpoolEnvironment(&threadpool->tp_environment_high_priority);
+    DestroyThreadpoolEnvironment(&threadpool->tp_environment_low_priority);
+}
+
 static VOID NTAPI on_io_cancelled(PVOID ObjectContext, PVOID CleanupContext)
 {
     (void)ObjectContext;
@@ -63,8 +206,24 @@ static VOID CALLBACK on_work_callback(PTP_CALLBACK_INSTANCE instance, PVOID cont
         /* Codes_SRS_THREADPOOL_WIN32_01_036: [ Otherwise context shall be used as the context created in threadpool_schedule_work. ]*/
         WORK_ITEM_CONTEXT* work_item_context = (WORK_ITEM_CONTEXT*)context;
 
-        /* Codes_SRS_THREADPOOL_WIN32_01_037: [ The work_function callback passed to threadpool_schedule_work shall be called, passing to it the work_function_context argument passed to threadpool_schedule_work. ]*/
-        work_item_context->work_function(work_item_context->work_function_context);
+        /* Codes_SRS_THREADPOOL_WIN32_01_082: [ on_work_callback shall add the time the work item waited between being scheduled and starting to execute, obtained by calling timer_global_get_elapsed_us, to the queue wait statistics of its priority. ]*/
+        queue_wait_record(work_item_context->queue_wait, work_item_context->schedule_time_us);
+
+        if (work_item_context->statistics_recorder == NULL)
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_037: [ The work_function callback passed to threadpool_schedule_work shall be called, passing to it the work_function_context argument passed to threadpool_schedule_work. ]*/
+            work_item_context->work_function(work_item_context->work_function_context);
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_112: [ If the statistics are enabled, on_work_callback shall call threadpool_statistics_recorder_on_started with the time the work item was scheduled before calling work_function and threadpool_statistics_recorder_on_completed after it. ]*/
+            double start_time_us = threadpool_statistics_recorder_on_started(work_item_context->statistics_recorder, work_item_context->schedule_time_us);
+
+            /* Codes_SRS_THREADPOOL_WIN32_01_037: [ The work_function callback passed to threadpool_schedule_work shall be called, passing to it the work_function_context argument passed to threadpool_schedule_work. ]*/
+            work_item_context->work_function(work_item_context->work_function_context);
+
+            (void)threadpool_statistics_recorder_on_completed(work_item_context->statistics_recorder, start_time_us);
+        }
 
         /* Codes_SRS_THREADPOOL_WIN32_01_038: [ on_work_callback shall call CloseThreadpoolWork. ]*/
         CloseThreadpoolWork(work);
@@ -93,8 +252,8 @@ static void internal_close(THREADPOOL_HANDLE threadpool)
     /* Codes_SRS_THREADPOOL_WIN32_01_032: [ threadpool_close shall close the threadpool cleanup group by calling CloseThreadpoolCleanupGroup. ]*/
     CloseThreadpoolCleanupGroup(threadpool->tp_cleanup_group);
 
-    /* Codes_SRS_THREADPOOL_WIN32_01_033: [ threadpool_close shall destroy the thread pool environment created in threadpool_open_async. ]*/
-    DestroyThreadpoolEnvironment(&threadpool->tp_environment);
+    /* Codes_SRS_THREADPOOL_WIN32_01_033: [ threadpool_close shall destroy the thread pool environments created in threadpool_open_async. ]*/
+    destroy_environments(threadpool);
 
     (void)InterlockedExchange(&threadpool->state, (LONG)THREADPOOL_WIN32_STATE_CLOSED);
     WakeByAddressSingle((PVOID)&threadpool->state);
@@ -129,9 +288,18 @@ THREADPOOL_HANDLE threadpool_create(EXECUTION_ENGINE_HANDLE execution_engine)
             }
             else
             {
+                result->execution_engine = execution_engine;
                 (void)InterlockedExchange(&result->pending_api_calls, 0);
                 (void)InterlockedExchange(&result->state, (LONG)THREADPOOL_WIN32_STATE_CLOSED);
 
+                /* Codes_SRS_THREADPOOL_WIN32_01_081: [ threadpool_create shall initialize the queue wait statistics of all the priorities to 0. ]*/
+                queue_wait_init(&result->high_priority_queue_wait);
+                queue_wait_init(&result->normal_priority_queue_wait);
+                queue_wait_init(&result->low_priority_queue_wait);
+
+                /* Codes_SRS_THREADPOOL_WIN32_01_109: [ threadpool_create shall create the threadpool with the statistics disabled. ]*/
+                result->statistics_recorder = NULL;
+
                 goto all_ok;
             }
 
@@ -173,6 +341,12 @@ void threadpool_destroy(THREADPOOL_HANDLE threadpool)
             (void)WaitOnAddress(&threadpool->state, &current_state, sizeof(current_state), INFINITE);
         } while (1);
 
+        if (threadpool->statistics_recorder != NULL)
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_110: [ If the statistics are enabled, threadpool_destroy shall destroy the statistics recorder by calling threadpool_statistics_recorder_destroy. ]*/
+            threadpool_statistics_recorder_destroy(threadpool->statistics_recorder);
+        }
+
         /* Codes_SRS_THREADPOOL_WIN32_01_005: [ Otherwise, threadpool_destroy shall free all resources associated with threadpool. ]*/
         free(threadpool);
     }
@@ -206,11 +380,10 @@ int threadpool_open_async(THREADPOOL_HANDLE threadpool, ON_THREADPOOL_OPEN_COMPL
         }
         else
         {
-            /* Codes_SRS_THREADPOOL_WIN32_01_026: [ threadpool_open_async shall initialize a thread pool environment by calling InitializeThreadpoolEnvironment. ]*/
-            InitializeThreadpoolEnvironment(&threadpool->tp_environment);
-
-            /* Codes_SRS_THREADPOOL_WIN32_01_027: [ threadpool_open_async shall set the thread pool for the environment to the pool obtained from the execution engine by calling SetThreadpoolCallbackPool. ]*/
-            SetThreadpoolCallbackPool(&threadpool->tp_environment, threadpool->pool);
+            /* Codes_SRS_THREADPOOL_WIN32_01_078: [ threadpool_open_async shall initialize one thread pool environment for each of the normal, high and low priorities. ]*/
+            initialize_environment(threadpool, &threadpool->tp_environment, TP_CALLBACK_PRIORITY_NORMAL);
+            initialize_environment(threadpool, &threadpool->tp_environment_high_priority, TP_CALLBACK_PRIORITY_HIGH);
+            initialize_environment(threadpool, &threadpool->tp_environment_low_priority, TP_CALLBACK_PRIORITY_LOW);
 
             /* Codes_SRS_THREADPOOL_WIN32_01_028: [ threadpool_open_async shall create a threadpool cleanup group by calling CreateThreadpoolCleanupGroup. ]*/
             threadpool->tp_cleanup_group = CreateThreadpoolCleanupGroup();
@@ -222,8 +395,10 @@ int threadpool_open_async(THREADPOOL_HANDLE threadpool, ON_THREADPOOL_OPEN_COMPL
             }
             else
             {
-                /* Codes_SRS_THREADPOOL_WIN32_01_029: [ threadpool_open_async shall associate the cleanup group with the just created environment by calling SetThreadpoolCallbackCleanupGroup. ]*/
+                /* Codes_SRS_THREADPOOL_WIN32_01_029: [ threadpool_open_async shall associate the cleanup group with each of the just created environments by calling SetThreadpoolCallbackCleanupGroup. ]*/
                 SetThreadpoolCallbackCleanupGroup(&threadpool->tp_environment, threadpool->tp_cleanup_group, on_io_cancelled);
+                SetThreadpoolCallbackCleanupGroup(&threadpool->tp_environment_high_priority, threadpool->tp_cleanup_group, on_io_cancelled);
+                SetThreadpoolCallbackCleanupGroup(&threadpool->tp_environment_low_priority, threadpool->tp_cleanup_group, on_io_cancelled);
 
                 /* Codes_SRS_THREADPOOL_WIN32_01_015: [ threadpool_open_async shall set the state to OPEN. ]*/
                 (void)InterlockedExchange(&threadpool->state, (LONG)THREADPOOL_WIN32_STATE_OPEN);
@@ -238,7 +413,7 @@ int threadpool_open_async(THREADPOOL_HANDLE threadpool, ON_THREADPOOL_OPEN_COMPL
                 goto all_ok;
             }
 
-            DestroyThreadpoolEnvironment(&threadpool->tp_environment);
+            destroy_environments(threadpool);
 
             (void)InterlockedExchange(&threadpool->state, (LONG)THREADPOOL_WIN32_STATE_CLOSED);
             WakeByAddressSingle((PVOID)&threadpool->state);
@@ -271,216 +446,767 @@ void threadpool_close(THREADPOOL_HANDLE threadpool)
     }
 }
 
-int threadpool_schedule_work(THREADPOOL_HANDLE threadpool, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+static int schedule_work(THREADPOOL_HANDLE threadpool, PTP_POOL pool, THREADPOOL_PRIORITY priority, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
 {
     int result;
+    TP_CALLBACK_ENVIRON pool_tp_environment;
+    PTP_CALLBACK_ENVIRON tp_environment;
 
-    /* Codes_SRS_THREADPOOL_WIN32_01_022: [ work_function_context shall be allowed to be NULL. ]*/
+    (void)InterlockedIncrement(&threadpool->pending_api_calls);
 
-    if (
-        /* Codes_SRS_THREADPOOL_WIN32_01_020: [ If threadpool is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
-        (threadpool == NULL) ||
-        /* Codes_SRS_THREADPOOL_WIN32_01_021: [ If work_function is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
-        (work_function == NULL)
-        )
+    THREADPOOL_WIN32_STATE state = InterlockedAdd(&threadpool->state, 0);
+    if (state != (LONG)THREADPOOL_WIN32_STATE_OPEN)
     {
-        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_WORK_FUNCTION work_function=%p, void* work_function_context=%p",
-            threadpool, work_function, work_function_context);
+        LogWarning("Bad state: %" PRI_MU_ENUM, MU_ENUM_VALUE(THREADPOOL_WIN32_STATE, state));
         result = MU_FAILURE;
     }
     else
     {
-        (void)InterlockedIncrement(&threadpool->pending_api_calls);
-
-        THREADPOOL_WIN32_STATE state = InterlockedAdd(&threadpool->state, 0);
-        if (state != (LONG)THREADPOOL_WIN32_STATE_OPEN)
+        /* Codes_SRS_THREADPOOL_WIN32_01_023: [ Otherwise threadpool_schedule_work shall allocate a context where work_function and context shall be saved. ]*/
+        WORK_ITEM_CONTEXT* work_item_context = (WORK_ITEM_CONTEXT*)malloc(sizeof(WORK_ITEM_CONTEXT));
+        if (work_item_context == NULL)
         {
-            LogWarning("Bad state: %" PRI_MU_ENUM, MU_ENUM_VALUE(THREADPOOL_WIN32_STATE, state));
+            /* Codes_SRS_THREADPOOL_WIN32_01_024: [ If any error occurs, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+            LogError("malloc failed");
             result = MU_FAILURE;
         }
         else
         {
-            /* Codes_SRS_THREADPOOL_WIN32_01_023: [ Otherwise threadpool_schedule_work shall allocate a context where work_function and context shall be saved. ]*/
-            WORK_ITEM_CONTEXT* work_item_context = (WORK_ITEM_CONTEXT*)malloc(sizeof(WORK_ITEM_CONTEXT));
-            if (work_item_context == NULL)
+            work_item_context->work_function = work_function;
+            work_item_context->work_function_context = work_function_context;
+            work_item_context->queue_wait = get_queue_wait(threadpool, priority);
+            work_item_context->statistics_recorder = threadpool->statistics_recorder;
+
+            /* Codes_SRS_THREADPOOL_WIN32_01_080: [ threadpool_schedule_work shall save in the context the time the work item is scheduled, obtained by calling timer_global_get_elapsed_us. ]*/
+            work_item_context->schedule_time_us = timer_global_get_elapsed_us();
+
+            if (pool == threadpool->pool)
+            {
+                tp_environment = get_environment(threadpool, priority);
+            }
+            else
+            {
+                /* Codes_SRS_THREADPOOL_WIN32_01_106: [ If the threadpool of numa_node is not the threadpool of the execution engine, threadpool_schedule_work_on_node shall initialize a thread pool environment for it by calling InitializeThreadpoolEnvironment, SetThreadpoolCallbackPool and SetThreadpoolCallbackCleanupGroup with the cleanup group of the threadpool. ]*/
+                InitializeThreadpoolEnvironment(&pool_tp_environment);
+                SetThreadpoolCallbackPool(&pool_tp_environment, pool);
+                SetThreadpoolCallbackCleanupGroup(&pool_tp_environment, threadpool->tp_cleanup_group, on_io_cancelled);
+                tp_environment = &pool_tp_environment;
+            }
+
+            /* Codes_SRS_THREADPOOL_WIN32_01_034: [ threadpool_schedule_work shall call CreateThreadpoolWork to schedule execution the callback while passing to it the on_work_callback function and the newly created context. ]*/
+            PTP_WORK ptp_work = CreateThreadpoolWork(on_work_callback, work_item_context, tp_environment);
+
+            if (tp_environment == &pool_tp_environment)
+            {
+                /* Codes_SRS_THREADPOOL_WIN32_01_107: [ threadpool_schedule_work_on_node shall destroy the thread pool environment by calling DestroyThreadpoolEnvironment once the PTP_WORK is created. ]*/
+                DestroyThreadpoolEnvironment(&pool_tp_environment);
+            }
+
+            if (ptp_work == NULL)
             {
                 /* Codes_SRS_THREADPOOL_WIN32_01_024: [ If any error occurs, threadpool_schedule_work shall fail and return a non-zero value. ]*/
-                LogError("malloc failed");
+                LogError("CreateThreadpoolWork failed");
                 result = MU_FAILURE;
             }
             else
             {
-                work_item_context->work_function = work_function;
-                work_item_context->work_function_context = work_function_context;
+                /* Codes_SRS_THREADPOOL_WIN32_01_041: [ threadpool_schedule_work shall call SubmitThreadpoolWork to submit the work item for execution. ]*/
+                SubmitThreadpoolWork(ptp_work);
 
-                /* Codes_SRS_THREADPOOL_WIN32_01_034: [ threadpool_schedule_work shall call CreateThreadpoolWork to schedule execution the callback while passing to it the on_work_callback function and the newly created context. ]*/
-                PTP_WORK ptp_work = CreateThreadpoolWork(on_work_callback, work_item_context, &threadpool->tp_environment);
-                if (ptp_work == NULL)
+                if (threadpool->statistics_recorder != NULL)
                 {
-                    /* Codes_SRS_THREADPOOL_WIN32_01_024: [ If any error occurs, threadpool_schedule_work shall fail and return a non-zero value. ]*/
-                    LogError("CreateThreadpoolWork failed");
-                    result = MU_FAILURE;
+                    /* Codes_SRS_THREADPOOL_WIN32_01_111: [ If the statistics are enabled, threadpool_schedule_work shall count the work item as queued by calling threadpool_statistics_recorder_on_queued. ]*/
+                    threadpool_statistics_recorder_on_queued(threadpool->statistics_recorder, 1);
                 }
-                else
-                {
-                    /* Codes_SRS_THREADPOOL_WIN32_01_041: [ threadpool_schedule_work shall call SubmitThreadpoolWork to submit the work item for execution. ]*/
-                    SubmitThreadpoolWork(ptp_work);
 
-                    (void)InterlockedDecrement(&threadpool->pending_api_calls);
-                    WakeByAddressSingle((PVOID)&threadpool->pending_api_calls);
-
-                    result = 0;
+                (void)InterlockedDecrement(&threadpool->pending_api_calls);
+                WakeByAddressSingle((PVOID)&threadpool->pending_api_calls);
 
-                    goto all_ok;
-                }
+                result = 0;
 
-                free(work_item_context);
+                goto all_ok;
             }
-        }
 
-        (void)InterlockedDecrement(&threadpool->pending_api_calls);
-        WakeByAddressSingle((PVOID)&threadpool->pending_api_calls);
+            free(work_item_context);
+        }
     }
 
+    (void)InterlockedDecrement(&threadpool->pending_api_calls);
+    WakeByAddressSingle((PVOID)&threadpool->pending_api_calls);
+
 all_ok:
     return result;
 }
 
-static VOID CALLBACK on_timer_callback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_TIMER timer)
+int threadpool_schedule_work(THREADPOOL_HANDLE threadpool, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
 {
-    if (context == NULL)
+    int result;
+
+    /* Codes_SRS_THREADPOOL_WIN32_01_022: [ work_function_context shall be allowed to be NULL. ]*/
+
+    if (
+        /* Codes_SRS_THREADPOOL_WIN32_01_020: [ If threadpool is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_021: [ If work_function is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+        (work_function == NULL)
+        )
     {
-        /* Codes_SRS_THREADPOOL_WIN32_42_016: [ If context is NULL, on_work_callback shall return. ]*/
-        LogError("Invalid args: PTP_CALLBACK_INSTANCE instance = %p, PVOID context = %p, PTP_TIMER timer = %p",
-            instance, context, timer);
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_WORK_FUNCTION work_function=%p, void* work_function_context=%p",
+            threadpool, work_function, work_function_context);
+        result = MU_FAILURE;
     }
     else
     {
-        /* Codes_SRS_THREADPOOL_WIN32_42_017: [ Otherwise context shall be used as the context created in threadpool_schedule_work. ]*/
-        TIMER_INSTANCE_HANDLE timer_instance = context;
+        /* Codes_SRS_THREADPOOL_WIN32_01_083: [ threadpool_schedule_work shall schedule the work item with THREADPOOL_PRIORITY_NORMAL, creating the PTP_WORK in the normal priority environment. ]*/
+        result = schedule_work(threadpool, threadpool->pool, THREADPOOL_PRIORITY_NORMAL, work_function, work_function_context);
+    }
 
-        /* Codes_SRS_THREADPOOL_WIN32_42_018: [ The work_function callback passed to threadpool_schedule_work shall be called, passing to it the work_function_context argument passed to threadpool_schedule_work. ]*/
-        timer_instance->work_function(timer_instance->work_function_context);
+    return result;
+}
+
+int threadpool_schedule_work_with_priority(THREADPOOL_HANDLE threadpool, THREADPOOL_PRIORITY priority, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+{
+    int result;
+
+    /* Codes_SRS_THREADPOOL_WIN32_01_087: [ work_function_context shall be allowed to be NULL. ]*/
+
+    if (
+        /* Codes_SRS_THREADPOOL_WIN32_01_084: [ If threadpool is NULL, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_085: [ If priority is not THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL or THREADPOOL_PRIORITY_LOW, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+        !is_valid_priority(priority) ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_086: [ If work_function is NULL, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+        (work_function == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_PRIORITY priority=%" PRI_MU_ENUM ", THREADPOOL_WORK_FUNCTION work_function=%p, void* work_function_context=%p",
+            threadpool, MU_ENUM_VALUE(THREADPOOL_PRIORITY, priority), work_function, work_function_context);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_WIN32_01_088: [ Otherwise threadpool_schedule_work_with_priority shall schedule the work item like threadpool_schedule_work, creating the PTP_WORK in the environment of priority. ]*/
+        /* Codes_SRS_THREADPOOL_WIN32_01_089: [ If any error occurs, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+        result = schedule_work(threadpool, threadpool->pool, priority, work_function, work_function_context);
     }
+
+    return result;
 }
 
-static void threadpool_internal_set_timer(PTP_TIMER tp_timer, uint32_t start_delay_ms, uint32_t timer_period_ms)
+int threadpool_schedule_work_on_node(THREADPOOL_HANDLE threadpool, uint32_t numa_node, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
 {
-    ULARGE_INTEGER ularge_due_time;
-    ularge_due_time.QuadPart = (ULONGLONG)-((int64_t)start_delay_ms * 10000);
-    FILETIME filetime_due_time;
-    filetime_due_time.dwHighDateTime = ularge_due_time.HighPart;
-    filetime_due_time.dwLowDateTime = ularge_due_time.LowPart;
-    SetThreadpoolTimer(tp_timer, &filetime_due_time, timer_period_ms, 0);
+    int result;
+
+    /* Codes_SRS_THREADPOOL_WIN32_01_103: [ work_function_context shall be allowed to be NULL. ]*/
+
+    if (
+        /* Codes_SRS_THREADPOOL_WIN32_01_101: [ If threadpool is NULL, threadpool_schedule_work_on_node shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_102: [ If work_function is NULL, threadpool_schedule_work_on_node shall fail and return a non-zero value. ]*/
+        (work_function == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, uint32_t numa_node=%" PRIu32 ", THREADPOOL_WORK_FUNCTION work_function=%p, void* work_function_context=%p",
+            threadpool, numa_node, work_function, work_function_context);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_WIN32_01_104: [ threadpool_schedule_work_on_node shall obtain the PTP_POOL of numa_node by calling execution_engine_win32_get_numa_node_threadpool. ]*/
+        PTP_POOL pool = execution_engine_win32_get_numa_node_threadpool(threadpool->execution_engine, numa_node);
+        if (pool == NULL)
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_108: [ If any error occurs, threadpool_schedule_work_on_node shall fail and return a non-zero value. ]*/
+            LogError("execution_engine_win32_get_numa_node_threadpool(%p, %" PRIu32 ") failed", threadpool->execution_engine, numa_node);
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_105: [ threadpool_schedule_work_on_node shall schedule the work item like threadpool_schedule_work, creating the PTP_WORK in an environment using the PTP_POOL of numa_node. ]*/
+            /* Codes_SRS_THREADPOOL_WIN32_01_108: [ If any error occurs, threadpool_schedule_work_on_node shall fail and return a non-zero value. ]*/
+            result = schedule_work(threadpool, pool, THREADPOOL_PRIORITY_NORMAL, work_function, work_function_context);
+        }
+    }
+
+    return result;
 }
 
-static void threadpool_internal_cancel_timer_and_wait(PTP_TIMER tp_timer)
+static VOID CALLBACK on_work_batch_callback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WORK work)
 {
-    SetThreadpoolTimer(tp_timer, NULL, 0, 0);
-    WaitForThreadpoolTimerCallbacks(tp_timer, TRUE);
+    if (context == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_WIN32_01_070: [ If context is NULL, on_work_batch_callback shall return. ]*/
+        LogError("Invalid arguments: PTP_CALLBACK_INSTANCE instance=%p, PVOID context=%p, PTP_WORK work=%p",
+            instance, context, work);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_WIN32_01_071: [ Otherwise context shall be used as the batch created in threadpool_schedule_work_batch. ]*/
+        WORK_BATCH_CONTEXT* work_batch = (WORK_BATCH_CONTEXT*)context;
+
+        /* Codes_SRS_THREADPOOL_WIN32_01_072: [ on_work_batch_callback shall take the next work item of the batch by calling InterlockedIncrement on the index of the next work item. ]*/
+        THREADPOOL_WORK_BATCH_ITEM* work_item = &work_batch->work_items[InterlockedIncrement(&work_batch->next_work_item_index) - 1];
+
+        if (work_batch->statistics_recorder == NULL)
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_073: [ on_work_batch_callback shall call the work_function of the work item, passing to it the work_function_context of the work item. ]*/
+            work_item->work_function(work_item->work_function_context);
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_115: [ If the statistics are enabled, on_work_batch_callback shall call threadpool_statistics_recorder_on_started with the time the batch was scheduled before calling work_function and threadpool_statistics_recorder_on_completed after it. ]*/
+            double start_time_us = threadpool_statistics_recorder_on_started(work_batch->statistics_recorder, work_batch->schedule_time_us);
+
+            /* Codes_SRS_THREADPOOL_WIN32_01_073: [ on_work_batch_callback shall call the work_function of the work item, passing to it the work_function_context of the work item. ]*/
+            work_item->work_function(work_item->work_function_context);
+
+            (void)threadpool_statistics_recorder_on_completed(work_batch->statistics_recorder, start_time_us);
+        }
+
+        /* Codes_SRS_THREADPOOL_WIN32_01_074: [ on_work_batch_callback shall decrement the count of work items of the batch not executed yet. ]*/
+        if (InterlockedDecrement(&work_batch->pending_work_item_count) == 0)
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_075: [ If the count reached 0, on_work_batch_callback shall call CloseThreadpoolWork and free the batch. ]*/
+            CloseThreadpoolWork(work);
+            free(work_batch);
+        }
+    }
 }
 
-int threadpool_timer_start(THREADPOOL_HANDLE threadpool, uint32_t start_delay_ms, uint32_t timer_period_ms, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context, TIMER_INSTANCE_HANDLE* timer_handle)
+int threadpool_schedule_work_batch(THREADPOOL_HANDLE threadpool, const THREADPOOL_WORK_BATCH_ITEM* work_items, uint32_t work_item_count)
 {
     int result;
 
-    /* Codes_SRS_THREADPOOL_WIN32_42_004: [ work_function_context shall be allowed to be NULL. ]*/
     if (
-        /* Codes_SRS_THREADPOOL_WIN32_42_001: [ If threadpool is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
-        threadpool == NULL ||
-        /* Codes_SRS_THREADPOOL_WIN32_42_002: [ If work_function is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
-        work_function == NULL ||
-        /* Codes_SRS_THREADPOOL_WIN32_42_003: [ If timer_handle is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
-        timer_handle == NULL
+        /* Codes_SRS_THREADPOOL_WIN32_01_062: [ If threadpool is NULL, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_063: [ If work_items is NULL, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+        (work_items == NULL) ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_064: [ If work_item_count is 0 or greater than LONG_MAX, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+        (work_item_count == 0) ||
+        (work_item_count > LONG_MAX)
         )
     {
-        LogError("Invalid args: THREADPOOL_HANDLE threadpool = %p, uint32_t start_delay_ms = %" PRIu32 ", uint32_t timer_period_ms = %" PRIu32 ", THREADPOOL_WORK_FUNCTION work_function = %p, void* work_function_context = %p, TIMER_INSTANCE_HANDLE* timer_handle = %p",
-            threadpool, start_delay_ms, timer_period_ms, work_function, work_function_context, timer_handle);
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, const THREADPOOL_WORK_BATCH_ITEM* work_items=%p, uint32_t work_item_count=%" PRIu32 "",
+            threadpool, work_items, work_item_count);
         result = MU_FAILURE;
     }
     else
     {
-        (void)InterlockedIncrement(&threadpool->pending_api_calls);
+        uint32_t i;
 
-        THREADPOOL_WIN32_STATE state = InterlockedAdd(&threadpool->state, 0);
-        if (state != (LONG)THREADPOOL_WIN32_STATE_OPEN)
+        for (i = 0; i < work_item_count; i++)
         {
-            LogWarning("Bad state: %" PRI_MU_ENUM, MU_ENUM_VALUE(THREADPOOL_WIN32_STATE, state));
+            if (work_items[i].work_function == NULL)
+            {
+                break;
+            }
+        }
+
+        if (i < work_item_count)
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_065: [ If the work_function of any of the work items is NULL, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+            LogError("Invalid arguments: work_items[%" PRIu32 "].work_function is NULL", i);
             result = MU_FAILURE;
         }
         else
         {
-            /* Codes_SRS_THREADPOOL_WIN32_42_005: [ threadpool_timer_start shall allocate a context for the timer being started and store work_function and work_function_context in it. ]*/
-            TIMER_INSTANCE_HANDLE timer_temp = malloc(sizeof(TIMER_INSTANCE));
+            (void)InterlockedIncrement(&threadpool->pending_api_calls);
 
-            if (timer_temp == NULL)
+            THREADPOOL_WIN32_STATE state = InterlockedAdd(&threadpool->state, 0);
+            if (state != (LONG)THREADPOOL_WIN32_STATE_OPEN)
             {
-                /* Codes_SRS_THREADPOOL_WIN32_42_008: [ If any error occurs, threadpool_timer_start shall fail and return a non-zero value. ]*/
-                LogError("malloc(%zu) failed for TIMER_INSTANCE_HANDLE", sizeof(TIMER_INSTANCE));
+                /* Codes_SRS_THREADPOOL_WIN32_01_076: [ If threadpool is not OPEN, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+                LogWarning("Bad state: %" PRI_MU_ENUM, MU_ENUM_VALUE(THREADPOOL_WIN32_STATE, state));
                 result = MU_FAILURE;
             }
             else
             {
-                /* Codes_SRS_THREADPOOL_WIN32_42_006: [ threadpool_timer_start shall call CreateThreadpoolTimer to schedule execution the callback while passing to it the on_timer_callback function and the newly created context. ]*/
-                PTP_TIMER tp_timer = CreateThreadpoolTimer(on_timer_callback, timer_temp, &threadpool->tp_environment);
-
-                if (tp_timer == NULL)
+                /* Codes_SRS_THREADPOOL_WIN32_01_066: [ Otherwise threadpool_schedule_work_batch shall allocate in a single allocation a batch where the work_function and work_function_context of all the work items shall be saved. ]*/
+                WORK_BATCH_CONTEXT* work_batch = (WORK_BATCH_CONTEXT*)malloc(sizeof(WORK_BATCH_CONTEXT) + work_item_count * sizeof(THREADPOOL_WORK_BATCH_ITEM));
+                if (work_batch == NULL)
                 {
-                    /* Codes_SRS_THREADPOOL_WIN32_42_008: [ If any error occurs, threadpool_timer_start shall fail and return a non-zero value. ]*/
-                    LogError("CreateThreadpoolTimer failed");
+                    /* Codes_SRS_THREADPOOL_WIN32_01_069: [ If any error occurs, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+                    LogError("malloc failed");
                     result = MU_FAILURE;
                 }
                 else
                 {
-                    timer_temp->timer = tp_timer;
-                    timer_temp->work_function = work_function;
-                    timer_temp->work_function_context = work_function_context;
-
-                    /* Codes_SRS_THREADPOOL_WIN32_42_007: [ threadpool_timer_start shall call SetThreadpoolTimer, passing negative start_delay_ms as pftDueTime, timer_period_ms as msPeriod, and 0 as msWindowLength. ]*/
-                    threadpool_internal_set_timer(tp_timer, start_delay_ms, timer_period_ms);
-
-                    /* Codes_SRS_THREADPOOL_WIN32_42_009: [ threadpool_timer_start shall return the allocated handle in timer_handle. ]*/
-                    *timer_handle = timer_temp;
-                    timer_temp = NULL;
-
-                    /* Codes_SRS_THREADPOOL_WIN32_42_010: [ threadpool_timer_start shall succeed and return 0. ]*/
-                    result = 0;
-                }
-
-                if (timer_temp != NULL)
-                {
-                    free(timer_temp);
+                    (void)InterlockedExchange(&work_batch->next_work_item_index, 0);
+                    (void)InterlockedExchange(&work_batch->pending_work_item_count, (LONG)work_item_count);
+                    for (i = 0; i < work_item_count; i++)
+                    {
+                        work_batch->work_items[i].work_function = work_items[i].work_function;
+                        work_batch->work_items[i].work_function_context = work_items[i].work_function_context;
+                    }
+
+                    work_batch->statistics_recorder = threadpool->statistics_recorder;
+                    if (work_batch->statistics_recorder != NULL)
+                    {
+                        /* Codes_SRS_THREADPOOL_WIN32_01_113: [ If the statistics are enabled, threadpool_schedule_work_batch shall save in the batch the time it is scheduled, obtained by calling timer_global_get_elapsed_us. ]*/
+                        work_batch->schedule_time_us = timer_global_get_elapsed_us();
+                    }
+
+                    /* Codes_SRS_THREADPOOL_WIN32_01_067: [ threadpool_schedule_work_batch shall call CreateThreadpoolWork once for the whole batch, passing to it the on_work_batch_callback function and the batch. ]*/
+                    PTP_WORK ptp_work = CreateThreadpoolWork(on_work_batch_callback, work_batch, &threadpool->tp_environment);
+                    if (ptp_work == NULL)
+                    {
+                        /* Codes_SRS_THREADPOOL_WIN32_01_069: [ If any error occurs, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+                        LogError("CreateThreadpoolWork failed");
+                        free(work_batch);
+                        result = MU_FAILURE;
+                    }
+                    else
+                    {
+                        /* Codes_SRS_THREADPOOL_WIN32_01_068: [ threadpool_schedule_work_batch shall call SubmitThreadpoolWork work_item_count times, so that the PTP_WORK executes once for each work item. ]*/
+                        for (i = 0; i < work_item_count; i++)
+                        {
+                            SubmitThreadpoolWork(ptp_work);
+                        }
+
+                        if (threadpool->statistics_recorder != NULL)
+                        {
+                            /* Codes_SRS_THREADPOOL_WIN32_01_114: [ If the statistics are enabled, threadpool_schedule_work_batch shall count the work items as queued by calling threadpool_statistics_recorder_on_queued with work_item_count. ]*/
+                            threadpool_statistics_recorder_on_queued(threadpool->statistics_recorder, work_item_count);
+                        }
+
+                        /* Codes_SRS_THREADPOOL_WIN32_01_077: [ threadpool_schedule_work_batch shall succeed and return 0. ]*/
+                        result = 0;
+                    }
                 }
             }
-        }
 
-        (void)InterlockedDecrement(&threadpool->pending_api_calls);
-        WakeByAddressSingle((PVOID)&threadpool->pending_api_calls);
+            (void)InterlockedDecrement(&threadpool->pending_api_calls);
+            WakeByAddressSingle((PVOID)&threadpool->pending_api_calls);
+        }
     }
 
     return result;
 }
 
-int threadpool_timer_restart(TIMER_INSTANCE_HANDLE timer, uint32_t start_delay_ms, uint32_t timer_period_ms)
+static VOID CALLBACK on_work_item_callback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_WORK work)
 {
-    int result;
-
-    if (
-        /* Codes_SRS_THREADPOOL_WIN32_42_019: [ If timer is NULL, threadpool_timer_restart shall fail and return a non-zero value. ]*/
-        timer == NULL
-        )
+    if (context == NULL)
     {
-        LogError("Invalid args: TIMER_INSTANCE_HANDLE timer = %p, uint32_t start_delay_ms = %" PRIu32 ", uint32_t timer_period_ms = %" PRIu32 "",
-            timer, start_delay_ms, timer_period_ms);
-        result = MU_FAILURE;
+        /* Codes_SRS_THREADPOOL_WIN32_01_052: [ If context is NULL, on_work_item_callback shall return. ]*/
+        LogError("Invalid arguments: PTP_CALLBACK_INSTANCE instance=%p, PVOID context=%p, PTP_WORK work=%p",
+            instance, context, work);
     }
     else
     {
-        /* Codes_SRS_THREADPOOL_WIN32_42_022: [ threadpool_timer_restart shall call SetThreadpoolTimer, passing negative start_delay_ms as pftDueTime, timer_period_ms as msPeriod, and 0 as msWindowLength. ]*/
-        threadpool_internal_set_timer(timer->timer, start_delay_ms, timer_period_ms);
+        /* Codes_SRS_THREADPOOL_WIN32_01_053: [ Otherwise context shall be used as the work item created in threadpool_create_work_item. ]*/
+        THREADPOOL_WORK_ITEM* work_item = (THREADPOOL_WORK_ITEM*)context;
 
-        /* Codes_SRS_THREADPOOL_WIN32_42_023: [ threadpool_timer_restart shall succeed and return 0. ]*/
-        result = 0;
+        if (work_item->statistics_recorder == NULL)
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_054: [ The work_function callback passed to threadpool_create_work_item shall be called, passing to it the work_function_context argument passed to threadpool_create_work_item. ]*/
+            /* Codes_SRS_THREADPOOL_WIN32_01_055: [ on_work_item_callback shall not close the PTP_WORK and shall not free the work item. ]*/
+            work_item->work_function(work_item->work_function_context);
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_118: [ If the statistics are enabled, on_work_item_callback shall call threadpool_statistics_recorder_on_started with the time the work item was last submitted before calling work_function and threadpool_statistics_recorder_on_completed after it. ]*/
+            double start_time_us = threadpool_statistics_recorder_on_started(work_item->statistics_recorder, (double)InterlockedAdd64(&work_item->schedule_time_us, 0));
+
+            /* Codes_SRS_THREADPOOL_WIN32_01_054: [ The work_function callback passed to threadpool_create_work_item shall be called, passing to it the work_function_context argument passed to threadpool_create_work_item. ]*/
+            /* Codes_SRS_THREADPOOL_WIN32_01_055: [ on_work_item_callback shall not close the PTP_WORK and shall not free the work item. ]*/
+            work_item->work_function(work_item->work_function_context);
+
+            (void)threadpool_statistics_recorder_on_completed(work_item->statistics_recorder, start_time_us);
+        }
+    }
+}
+
+THREADPOOL_WORK_ITEM_HANDLE threadpool_create_work_item(THREADPOOL_HANDLE threadpool, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context)
+{
+    THREADPOOL_WORK_ITEM_HANDLE result;
+
+    /* Codes_SRS_THREADPOOL_WIN32_01_044: [ work_function_context shall be allowed to be NULL. ]*/
+    if (
+        /* Codes_SRS_THREADPOOL_WIN32_01_042: [ If threadpool is NULL, threadpool_create_work_item shall fail and return NULL. ]*/
+        threadpool == NULL ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_043: [ If work_function is NULL, threadpool_create_work_item shall fail and return NULL. ]*/
+        work_function == NULL
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_WORK_FUNCTION work_function=%p, void* work_function_context=%p",
+            threadpool, work_function, work_function_context);
+        result = NULL;
+    }
+    else
+    {
+        (void)InterlockedIncrement(&threadpool->pending_api_calls);
+
+        THREADPOOL_WIN32_STATE state = InterlockedAdd(&threadpool->state, 0);
+        if (state != (LONG)THREADPOOL_WIN32_STATE_OPEN)
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_045: [ If threadpool is not OPEN, threadpool_create_work_item shall fail and return NULL. ]*/
+            LogWarning("Bad state: %" PRI_MU_ENUM, MU_ENUM_VALUE(THREADPOOL_WIN32_STATE, state));
+            result = NULL;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_046: [ threadpool_create_work_item shall allocate a work item where work_function and work_function_context shall be saved. ]*/
+            result = malloc(sizeof(THREADPOOL_WORK_ITEM));
+            if (result == NULL)
+            {
+                /* Codes_SRS_THREADPOOL_WIN32_01_048: [ If any error occurs, threadpool_create_work_item shall fail and return NULL. ]*/
+                LogError("malloc(%zu) failed", sizeof(THREADPOOL_WORK_ITEM));
+            }
+            else
+            {
+                result->work_function = work_function;
+                result->work_function_context = work_function_context;
+                result->statistics_recorder = threadpool->statistics_recorder;
+                (void)InterlockedExchange64(&result->schedule_time_us, 0);
+
+                /* Codes_SRS_THREADPOOL_WIN32_01_047: [ threadpool_create_work_item shall call CreateThreadpoolWork, passing to it the on_work_item_callback function and the newly created work item, so that the PTP_WORK is created only once for all the schedules of the work item. ]*/
+                result->ptp_work = CreateThreadpoolWork(on_work_item_callback, result, &threadpool->tp_environment);
+                if (result->ptp_work == NULL)
+                {
+                    /* Codes_SRS_THREADPOOL_WIN32_01_048: [ If any error occurs, threadpool_create_work_item shall fail and return NULL. ]*/
+                    LogError("CreateThreadpoolWork failed");
+                    free(result);
+                    result = NULL;
+                }
+            }
+        }
+
+        (void)InterlockedDecrement(&threadpool->pending_api_calls);
+        WakeByAddressSingle((PVOID)&threadpool->pending_api_calls);
+    }
+
+    return result;
+}
+
+int threadpool_schedule_work_item(THREADPOOL_HANDLE threadpool, THREADPOOL_WORK_ITEM_HANDLE work_item)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_WIN32_01_049: [ If threadpool is NULL, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
+        threadpool == NULL ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_050: [ If work_item is NULL, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
+        work_item == NULL
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_WORK_ITEM_HANDLE work_item=%p",
+            threadpool, work_item);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        (void)InterlockedIncrement(&threadpool->pending_api_calls);
+
+        THREADPOOL_WIN32_STATE state = InterlockedAdd(&threadpool->state, 0);
+        if (state != (LONG)THREADPOOL_WIN32_STATE_OPEN)
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_056: [ If threadpool is not OPEN, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
+            LogWarning("Bad state: %" PRI_MU_ENUM, MU_ENUM_VALUE(THREADPOOL_WIN32_STATE, state));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            if (threadpool->statistics_recorder != NULL)
+            {
+                /* Codes_SRS_THREADPOOL_WIN32_01_116: [ If the statistics are enabled, threadpool_schedule_work_item shall save in work_item the time it is submitted, obtained by calling timer_global_get_elapsed_us. ]*/
+                (void)InterlockedExchange64(&work_item->schedule_time_us, (LONG64)timer_global_get_elapsed_us());
+            }
+
+            /* Codes_SRS_THREADPOOL_WIN32_01_051: [ threadpool_schedule_work_item shall call SubmitThreadpoolWork with the PTP_WORK of work_item and succeed, without allocating memory. ]*/
+            SubmitThreadpoolWork(work_item->ptp_work);
+
+            if (threadpool->statistics_recorder != NULL)
+            {
+                /* Codes_SRS_THREADPOOL_WIN32_01_117: [ If the statistics are enabled, threadpool_schedule_work_item shall count the work item as queued by calling threadpool_statistics_recorder_on_queued. ]*/
+                threadpool_statistics_recorder_on_queued(threadpool->statistics_recorder, 1);
+            }
+
+            result = 0;
+        }
+
+        (void)InterlockedDecrement(&threadpool->pending_api_calls);
+        WakeByAddressSingle((PVOID)&threadpool->pending_api_calls);
+    }
+
+    return result;
+}
+
+void threadpool_destroy_work_item(THREADPOOL_HANDLE threadpool, THREADPOOL_WORK_ITEM_HANDLE work_item)
+{
+    if (
+        /* Codes_SRS_THREADPOOL_WIN32_01_057: [ If threadpool is NULL, threadpool_destroy_work_item shall return. ]*/
+        threadpool == NULL ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_058: [ If work_item is NULL, threadpool_destroy_work_item shall return. ]*/
+        work_item == NULL
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_WORK_ITEM_HANDLE work_item=%p",
+            threadpool, work_item);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_WIN32_01_059: [ threadpool_destroy_work_item shall wait for all the scheduled executions of work_item to complete by calling WaitForThreadpoolWorkCallbacks, passing FALSE as fCancelPendingCallbacks. ]*/
+        WaitForThreadpoolWorkCallbacks(work_item->ptp_work, FALSE);
+
+        /* Codes_SRS_THREADPOOL_WIN32_01_060: [ threadpool_destroy_work_item shall call CloseThreadpoolWork. ]*/
+        CloseThreadpoolWork(work_item->ptp_work);
+
+        /* Codes_SRS_THREADPOOL_WIN32_01_061: [ threadpool_destroy_work_item shall free the work item. ]*/
+        free(work_item);
+    }
+}
+
+static VOID CALLBACK on_timer_callback(PTP_CALLBACK_INSTANCE instance, PVOID context, PTP_TIMER timer)
+{
+    if (context == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_WIN32_42_016: [ If context is NULL, on_work_callback shall return. ]*/
+        LogError("Invalid args: PTP_CALLBACK_INSTANCE instance = %p, PVOID context = %p, PTP_TIMER timer = %p",
+            instance, context, timer);
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_WIN32_42_017: [ Otherwise context shall be used as the context created in threadpool_schedule_work. ]*/
+        TIMER_INSTANCE_HANDLE timer_instance = context;
+
+        if (timer_instance->is_lateness_recorded)
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_122: [ If the lateness of the timer is recorded, on_timer_callback shall record it by calling threadpool_timer_lateness_on_fired before calling work_function. ]*/
+            threadpool_timer_lateness_on_fired(&timer_instance->lateness);
+        }
+
+        /* Codes_SRS_THREADPOOL_WIN32_42_018: [ The work_function callback passed to threadpool_schedule_work shall be called, passing to it the work_function_context argument passed to threadpool_schedule_work. ]*/
+        timer_instance->work_function(timer_instance->work_function_context);
+    }
+}
+
+static void threadpool_internal_set_timer(PTP_TIMER tp_timer, uint32_t start_delay_ms, uint32_t timer_period_ms, uint32_t tolerance_ms)
+{
+    ULARGE_INTEGER ularge_due_time;
+    ularge_due_time.QuadPart = (ULONGLONG)-((int64_t)start_delay_ms * 10000);
+    FILETIME filetime_due_time;
+    filetime_due_time.dwHighDateTime = ularge_due_time.HighPart;
+    filetime_due_time.dwLowDateTime = ularge_due_time.LowPart;
+    SetThreadpoolTimer(tp_timer, &filetime_due_time, timer_period_ms, tolerance_ms);
+}
+
+static void threadpool_internal_cancel_timer_and_wait(PTP_TIMER tp_timer)
+{
+    SetThreadpoolTimer(tp_timer, NULL, 0, 0);
+    WaitForThreadpoolTimerCallbacks(tp_timer, TRUE);
+}
+
+static int start_timer(THREADPOOL_HANDLE threadpool, THREADPOOL_PRIORITY priority, uint32_t start_delay_ms, uint32_t timer_period_ms, uint32_t tolerance_ms, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context, TIMER_INSTANCE_HANDLE* timer_handle)
+{
+    int result;
+
+    (void)InterlockedIncrement(&threadpool->pending_api_calls);
+
+    THREADPOOL_WIN32_STATE state = InterlockedAdd(&threadpool->state, 0);
+    if (state != (LONG)THREADPOOL_WIN32_STATE_OPEN)
+    {
+        LogWarning("Bad state: %" PRI_MU_ENUM, MU_ENUM_VALUE(THREADPOOL_WIN32_STATE, state));
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_WIN32_42_005: [ threadpool_timer_start shall allocate a context for the timer being started and store work_function and work_function_context in it. ]*/
+        TIMER_INSTANCE_HANDLE timer_temp = malloc(sizeof(TIMER_INSTANCE));
+
+        if (timer_temp == NULL)
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_42_008: [ If any error occurs, threadpool_timer_start shall fail and return a non-zero value. ]*/
+            LogError("malloc(%zu) failed for TIMER_INSTANCE_HANDLE", sizeof(TIMER_INSTANCE));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_42_006: [ threadpool_timer_start shall call CreateThreadpoolTimer to schedule execution the callback while passing to it the on_timer_callback function and the newly created context. ]*/
+            PTP_TIMER tp_timer = CreateThreadpoolTimer(on_timer_callback, timer_temp, get_environment(threadpool, priority));
+
+            if (tp_timer == NULL)
+            {
+                /* Codes_SRS_THREADPOOL_WIN32_42_008: [ If any error occurs, threadpool_timer_start shall fail and return a non-zero value. ]*/
+                LogError("CreateThreadpoolTimer failed");
+                result = MU_FAILURE;
+            }
+            else
+            {
+                timer_temp->timer = tp_timer;
+                timer_temp->work_function = work_function;
+                timer_temp->work_function_context = work_function_context;
+                timer_temp->tolerance_ms = tolerance_ms;
+                timer_temp->is_lateness_recorded = (threadpool->statistics_recorder != NULL);
+                if (timer_temp->is_lateness_recorded)
+                {
+                    /* Codes_SRS_THREADPOOL_WIN32_01_119: [ If the statistics are enabled, threadpool_timer_start shall initialize the lateness of the timer by calling threadpool_timer_lateness_init. ]*/
+                    threadpool_timer_lateness_init(&timer_temp->lateness);
+
+                    /* Codes_SRS_THREADPOOL_WIN32_01_120: [ If the statistics are enabled, threadpool_timer_start shall compute when the timer is due by calling threadpool_timer_lateness_set_due_time with start_delay_ms and timer_period_ms before calling SetThreadpoolTimer. ]*/
+                    threadpool_timer_lateness_set_due_time(&timer_temp->lateness, start_delay_ms, timer_period_ms);
+                }
+
+                /* Codes_SRS_THREADPOOL_WIN32_42_007: [ threadpool_timer_start shall call SetThreadpoolTimer, passing negative start_delay_ms as pftDueTime, timer_period_ms as msPeriod, and 0 as msWindowLength. ]*/
+                /* Codes_SRS_THREADPOOL_WIN32_01_146: [ Otherwise threadpool_timer_start_with_tolerance shall start the timer like threadpool_timer_start, passing tolerance_ms as msWindowLength to SetThreadpoolTimer. ]*/
+                threadpool_internal_set_timer(tp_timer, start_delay_ms, timer_period_ms, tolerance_ms);
+
+                /* Codes_SRS_THREADPOOL_WIN32_42_009: [ threadpool_timer_start shall return the allocated handle in timer_handle. ]*/
+                *timer_handle = timer_temp;
+                timer_temp = NULL;
+
+                /* Codes_SRS_THREADPOOL_WIN32_42_010: [ threadpool_timer_start shall succeed and return 0. ]*/
+                result = 0;
+            }
+
+            if (timer_temp != NULL)
+            {
+                free(timer_temp);
+            }
+        }
+    }
+
+    (void)InterlockedDecrement(&threadpool->pending_api_calls);
+    WakeByAddressSingle((PVOID)&threadpool->pending_api_calls);
+
+    return result;
+}
+
+int threadpool_timer_start(THREADPOOL_HANDLE threadpool, uint32_t start_delay_ms, uint32_t timer_period_ms, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context, TIMER_INSTANCE_HANDLE* timer_handle)
+{
+    int result;
+
+    /* Codes_SRS_THREADPOOL_WIN32_42_004: [ work_function_context shall be allowed to be NULL. ]*/
+    if (
+        /* Codes_SRS_THREADPOOL_WIN32_42_001: [ If threadpool is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+        threadpool == NULL ||
+        /* Codes_SRS_THREADPOOL_WIN32_42_002: [ If work_function is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+        work_function == NULL ||
+        /* Codes_SRS_THREADPOOL_WIN32_42_003: [ If timer_handle is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+        timer_handle == NULL
+        )
+    {
+        LogError("Invalid args: THREADPOOL_HANDLE threadpool = %p, uint32_t start_delay_ms = %" PRIu32 ", uint32_t timer_period_ms = %" PRIu32 ", THREADPOOL_WORK_FUNCTION work_function = %p, void* work_function_context = %p, TIMER_INSTANCE_HANDLE* timer_handle = %p",
+            threadpool, start_delay_ms, timer_period_ms, work_function, work_function_context, timer_handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        result = start_timer(threadpool, THREADPOOL_PRIORITY_NORMAL, start_delay_ms, timer_period_ms, 0, work_function, work_function_context, timer_handle);
+    }
+
+    return result;
+}
+
+int threadpool_timer_start_with_priority(THREADPOOL_HANDLE threadpool, THREADPOOL_PRIORITY priority, uint32_t start_delay_ms, uint32_t timer_period_ms, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context, TIMER_INSTANCE_HANDLE* timer_handle)
+{
+    int result;
+
+    /* Codes_SRS_THREADPOOL_WIN32_01_094: [ work_function_context shall be allowed to be NULL. ]*/
+    if (
+        /* Codes_SRS_THREADPOOL_WIN32_01_090: [ If threadpool is NULL, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+        threadpool == NULL ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_091: [ If priority is not THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL or THREADPOOL_PRIORITY_LOW, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+        !is_valid_priority(priority) ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_092: [ If work_function is NULL, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+        work_function == NULL ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_093: [ If timer_handle is NULL, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+        timer_handle == NULL
+        )
+    {
+        LogError("Invalid args: THREADPOOL_HANDLE threadpool = %p, THREADPOOL_PRIORITY priority = %" PRI_MU_ENUM ", uint32_t start_delay_ms = %" PRIu32 ", uint32_t timer_period_ms = %" PRIu32 ", THREADPOOL_WORK_FUNCTION work_function = %p, void* work_function_context = %p, TIMER_INSTANCE_HANDLE* timer_handle = %p",
+            threadpool, MU_ENUM_VALUE(THREADPOOL_PRIORITY, priority), start_delay_ms, timer_period_ms, work_function, work_function_context, timer_handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_WIN32_01_095: [ Otherwise threadpool_timer_start_with_priority shall start the timer like threadpool_timer_start, creating the PTP_TIMER in the environment of priority. ]*/
+        /* Codes_SRS_THREADPOOL_WIN32_01_096: [ If any error occurs, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+        result = start_timer(threadpool, priority, start_delay_ms, timer_period_ms, 0, work_function, work_function_context, timer_handle);
+    }
+
+    return result;
+}
+
+int threadpool_timer_start_with_tolerance(THREADPOOL_HANDLE threadpool, uint32_t start_delay_ms, uint32_t timer_period_ms, uint32_t tolerance_ms, THREADPOOL_WORK_FUNCTION work_function, void* work_function_context, TIMER_INSTANCE_HANDLE* timer_handle)
+{
+    int result;
+
+    /* Codes_SRS_THREADPOOL_WIN32_01_145: [ work_function_context shall be allowed to be NULL. ]*/
+    if (
+        /* Codes_SRS_THREADPOOL_WIN32_01_142: [ If threadpool is NULL, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+        threadpool == NULL ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_143: [ If work_function is NULL, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+        work_function == NULL ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_144: [ If timer_handle is NULL, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+        timer_handle == NULL
+        )
+    {
+        LogError("Invalid args: THREADPOOL_HANDLE threadpool = %p, uint32_t start_delay_ms = %" PRIu32 ", uint32_t timer_period_ms = %" PRIu32 ", uint32_t tolerance_ms = %" PRIu32 ", THREADPOOL_WORK_FUNCTION work_function = %p, void* work_function_context = %p, TIMER_INSTANCE_HANDLE* timer_handle = %p",
+            threadpool, start_delay_ms, timer_period_ms, tolerance_ms, work_function, work_function_context, timer_handle);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_WIN32_01_146: [ Otherwise threadpool_timer_start_with_tolerance shall start the timer like threadpool_timer_start, passing tolerance_ms as msWindowLength to SetThreadpoolTimer. ]*/
+        /* Codes_SRS_THREADPOOL_WIN32_01_147: [ If any error occurs, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+        result = start_timer(threadpool, THREADPOOL_PRIORITY_NORMAL, start_delay_ms, timer_period_ms, tolerance_ms, work_function, work_function_context, timer_handle);
+    }
+
+    return result;
+}
+
+int threadpool_timer_restart(TIMER_INSTANCE_HANDLE timer, uint32_t start_delay_ms, uint32_t timer_period_ms)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_WIN32_42_019: [ If timer is NULL, threadpool_timer_restart shall fail and return a non-zero value. ]*/
+        timer == NULL
+        )
+    {
+        LogError("Invalid args: TIMER_INSTANCE_HANDLE timer = %p, uint32_t start_delay_ms = %" PRIu32 ", uint32_t timer_period_ms = %" PRIu32 "",
+            timer, start_delay_ms, timer_period_ms);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        if (timer->is_lateness_recorded)
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_121: [ If the lateness of the timer is recorded, threadpool_timer_restart shall compute when the timer is due by calling threadpool_timer_lateness_set_due_time with start_delay_ms and timer_period_ms before calling SetThreadpoolTimer. ]*/
+            threadpool_timer_lateness_set_due_time(&timer->lateness, start_delay_ms, timer_period_ms);
+        }
+
+        /* Codes_SRS_THREADPOOL_WIN32_42_022: [ threadpool_timer_restart shall call SetThreadpoolTimer, passing negative start_delay_ms as pftDueTime, timer_period_ms as msPeriod, and the tolerance of the timer as msWindowLength. ]*/
+        threadpool_internal_set_timer(timer->timer, start_delay_ms, timer_period_ms, timer->tolerance_ms);
+
+        /* Codes_SRS_THREADPOOL_WIN32_42_023: [ threadpool_timer_restart shall succeed and return 0. ]*/
+        result = 0;
+    }
+
+    return result;
+}
+
+int threadpool_timer_restart_with_tolerance(TIMER_INSTANCE_HANDLE timer, uint32_t start_delay_ms, uint32_t timer_period_ms, uint32_t tolerance_ms)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_WIN32_01_148: [ If timer is NULL, threadpool_timer_restart_with_tolerance shall fail and return a non-zero value. ]*/
+        timer == NULL
+        )
+    {
+        LogError("Invalid args: TIMER_INSTANCE_HANDLE timer = %p, uint32_t start_delay_ms = %" PRIu32 ", uint32_t timer_period_ms = %" PRIu32 ", uint32_t tolerance_ms = %" PRIu32 "",
+            timer, start_delay_ms, timer_period_ms, tolerance_ms);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_WIN32_01_149: [ Otherwise threadpool_timer_restart_with_tolerance shall save tolerance_ms as the tolerance of the timer and restart the timer like threadpool_timer_restart. ]*/
+        timer->tolerance_ms = tolerance_ms;
+
+        /* Codes_SRS_THREADPOOL_WIN32_01_150: [ If any error occurs, threadpool_timer_restart_with_tolerance shall fail and return a non-zero value. ]*/
+        result = threadpool_timer_restart(timer, start_delay_ms, timer_period_ms);
     }
 
     return result;
@@ -521,3 +1247,157 @@ void threadpool_timer_destroy(TIMER_INSTANCE_HANDLE timer)
         free(timer);
     }
 }
+
+int threadpool_get_queue_wait_statistics(THREADPOOL_HANDLE threadpool, THREADPOOL_PRIORITY priority, THREADPOOL_QUEUE_WAIT_STATISTICS* statistics)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_WIN32_01_097: [ If threadpool is NULL, threadpool_get_queue_wait_statistics shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_098: [ If priority is not THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL or THREADPOOL_PRIORITY_LOW, threadpool_get_queue_wait_statistics shall fail and return a non-zero value. ]*/
+        !is_valid_priority(priority) ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_099: [ If statistics is NULL, threadpool_get_queue_wait_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_PRIORITY priority=%" PRI_MU_ENUM ", THREADPOOL_QUEUE_WAIT_STATISTICS* statistics=%p",
+            threadpool, MU_ENUM_VALUE(THREADPOOL_PRIORITY, priority), statistics);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        THREADPOOL_QUEUE_WAIT* queue_wait = get_queue_wait(threadpool, priority);
+
+        /* Codes_SRS_THREADPOOL_WIN32_01_100: [ Otherwise threadpool_get_queue_wait_statistics shall fill statistics with the count of work items of priority that started executing and the total and maximum time in microseconds they waited, and return 0. ]*/
+        statistics->work_item_count = (uint64_t)InterlockedAdd64(&queue_wait->work_item_count, 0);
+        statistics->total_queue_wait_us = (uint64_t)InterlockedAdd64(&queue_wait->total_queue_wait_us, 0);
+        statistics->max_queue_wait_us = (uint64_t)InterlockedAdd64(&queue_wait->max_queue_wait_us, 0);
+        result = 0;
+    }
+
+    return result;
+}
+
+int threadpool_enable_statistics(THREADPOOL_HANDLE threadpool)
+{
+    int result;
+
+    if (threadpool == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_WIN32_01_123: [ If threadpool is NULL, threadpool_enable_statistics shall fail and return a non-zero value. ]*/
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p", threadpool);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_WIN32_01_124: [ threadpool_enable_statistics shall switch the state from CLOSED to OPENING, so that the threadpool cannot be opened while the statistics are enabled. ]*/
+        LONG current_state = InterlockedCompareExchange(&threadpool->state, (LONG)THREADPOOL_WIN32_STATE_OPENING, (LONG)THREADPOOL_WIN32_STATE_CLOSED);
+        if (current_state != (LONG)THREADPOOL_WIN32_STATE_CLOSED)
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_125: [ If threadpool is not CLOSED, threadpool_enable_statistics shall fail and return a non-zero value. ]*/
+            LogError("Cannot enable the statistics in state %" PRI_MU_ENUM "", MU_ENUM_VALUE(THREADPOOL_WIN32_STATE, current_state));
+            result = MU_FAILURE;
+        }
+        else
+        {
+            if (threadpool->statistics_recorder != NULL)
+            {
+                /* Codes_SRS_THREADPOOL_WIN32_01_126: [ If the statistics are already enabled, threadpool_enable_statistics shall succeed and return 0. ]*/
+                result = 0;
+            }
+            else
+            {
+                /* Codes_SRS_THREADPOOL_WIN32_01_127: [ Otherwise threadpool_enable_statistics shall create the statistics recorder by calling threadpool_statistics_recorder_create. ]*/
+                threadpool->statistics_recorder = threadpool_statistics_recorder_create();
+                if (threadpool->statistics_recorder == NULL)
+                {
+                    /* Codes_SRS_THREADPOOL_WIN32_01_130: [ If any error occurs, threadpool_enable_statistics shall fail and return a non-zero value. ]*/
+                    LogError("threadpool_statistics_recorder_create failed");
+                    result = MU_FAILURE;
+                }
+                else
+                {
+                    /* Codes_SRS_THREADPOOL_WIN32_01_129: [ threadpool_enable_statistics shall succeed and return 0. ]*/
+                    result = 0;
+                }
+            }
+
+            /* Codes_SRS_THREADPOOL_WIN32_01_128: [ threadpool_enable_statistics shall set the state back to CLOSED. ]*/
+            (void)InterlockedExchange(&threadpool->state, (LONG)THREADPOOL_WIN32_STATE_CLOSED);
+            WakeByAddressSingle((PVOID)&threadpool->state);
+        }
+    }
+
+    return result;
+}
+
+int threadpool_get_statistics(THREADPOOL_HANDLE threadpool, THREADPOOL_STATISTICS* statistics)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_WIN32_01_131: [ If threadpool is NULL, threadpool_get_statistics shall fail and return a non-zero value. ]*/
+        (threadpool == NULL) ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_132: [ If statistics is NULL, threadpool_get_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments: THREADPOOL_HANDLE threadpool=%p, THREADPOOL_STATISTICS* statistics=%p", threadpool, statistics);
+        result = MU_FAILURE;
+    }
+    else if (threadpool->statistics_recorder == NULL)
+    {
+        /* Codes_SRS_THREADPOOL_WIN32_01_133: [ If the statistics are not enabled, threadpool_get_statistics shall fail and return a non-zero value. ]*/
+        LogError("The statistics of threadpool=%p are not enabled", threadpool);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        /* Codes_SRS_THREADPOOL_WIN32_01_134: [ threadpool_get_statistics shall fill statistics by calling threadpool_statistics_recorder_get. ]*/
+        threadpool_statistics_recorder_get(threadpool->statistics_recorder, statistics);
+
+        /* Codes_SRS_THREADPOOL_WIN32_01_135: [ threadpool_get_statistics shall obtain the minimum number of threads of the execution engine by calling execution_engine_win32_get_min_thread_count. ]*/
+        uint32_t min_thread_count = execution_engine_win32_get_min_thread_count(threadpool->execution_engine);
+
+        /* Codes_SRS_THREADPOOL_WIN32_01_136: [ threadpool_get_statistics shall set the idle worker count in statistics to the minimum number of threads minus the number of threads executing work items, or 0 if more threads are executing work items, and return 0. ]*/
+        statistics->idle_worker_count = (min_thread_count > statistics->active_worker_count) ? (min_thread_count - statistics->active_worker_count) : 0;
+        result = 0;
+    }
+
+    return result;
+}
+
+int threadpool_timer_get_statistics(TIMER_INSTANCE_HANDLE timer, THREADPOOL_TIMER_STATISTICS* statistics)
+{
+    int result;
+
+    if (
+        /* Codes_SRS_THREADPOOL_WIN32_01_137: [ If timer is NULL, threadpool_timer_get_statistics shall fail and return a non-zero value. ]*/
+        (timer == NULL) ||
+        /* Codes_SRS_THREADPOOL_WIN32_01_138: [ If statistics is NULL, threadpool_timer_get_statistics shall fail and return a non-zero value. ]*/
+        (statistics == NULL)
+        )
+    {
+        LogError("Invalid arguments: TIMER_INSTANCE_HANDLE timer=%p, THREADPOOL_TIMER_STATISTICS* statistics=%p", timer, statistics);
+        result = MU_FAILURE;
+    }
+    else
+    {
+        if (timer->is_lateness_recorded)
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_139: [ If the lateness of timer is recorded, threadpool_timer_get_statistics shall fill statistics by calling threadpool_timer_lateness_get. ]*/
+            threadpool_timer_lateness_get(&timer->lateness, statistics);
+        }
+        else
+        {
+            /* Codes_SRS_THREADPOOL_WIN32_01_140: [ Otherwise threadpool_timer_get_statistics shall fill statistics with an empty histogram. ]*/
+            (void)memset(statistics, 0, sizeof(THREADPOOL_TIMER_STATISTICS));
+        }
+
+        /* Codes_SRS_THREADPOOL_WIN32_01_141: [ threadpool_timer_get_statistics shall succeed and return 0. ]*/
+        result = 0;
+    }
+
+    return result;
+}
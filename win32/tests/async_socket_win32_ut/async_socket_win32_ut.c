@@ -36,6 +36,8 @@ void real_free(void* ptr)
 #include "c_pal/gballoc_hl_redirect.h"
 #include "c_pal/execution_engine.h"
 #include "c_pal/execution_engine_win32.h"
+#include "c_pal/io_context_pool.h"
+#include "c_pal/sysinfo.h"
 
 #undef ENABLE_MOCKS
 
@@ -47,9 +49,22 @@ static TEST_MUTEX_HANDLE test_serialize_mutex;
 static SOCKET_HANDLE test_socket = (SOCKET_HANDLE)0x4242;
 static EXECUTION_ENGINE_HANDLE test_execution_engine = (EXECUTION_ENGINE_HANDLE)0x4243;
 static PTP_POOL test_pool = (PTP_POOL)0x4244;
+static IO_CONTEXT_POOL_HANDLE test_io_context_pool = (IO_CONTEXT_POOL_HANDLE)0x4245;
 
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
+static void* hook_io_context_pool_get(IO_CONTEXT_POOL_HANDLE pool, size_t size)
+{
+    (void)pool;
+    return real_malloc(size);
+}
+
+static void hook_io_context_pool_release(IO_CONTEXT_POOL_HANDLE pool, void* context)
+{
+    (void)pool;
+    real_free(context);
+}
+
 TEST_DEFINE_ENUM_TYPE(ASYNC_SOCKET_OPEN_RESULT, ASYNC_SOCKET_OPEN_RESULT_VALUES)
 IMPLEMENT_UMOCK_C_ENUM_TYPE(ASYNC_SOCKET_OPEN_RESULT, ASYNC_SOCKET_OPEN_RESULT_VALUES)
 
@@ -143,10 +158,17 @@ TEST_SUITE_INITIALIZE(suite_init)
 
     REGISTER_GLOBAL_MOCK_HOOK(malloc, real_malloc);
     REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
+    REGISTER_GLOBAL_MOCK_HOOK(io_context_pool_get, hook_io_context_pool_get);
+    REGISTER_GLOBAL_MOCK_HOOK(io_context_pool_release, hook_io_context_pool_release);
 
     REGISTER_GLOBAL_MOCK_RETURN(execution_engine_win32_get_threadpool, test_pool);
+    REGISTER_GLOBAL_MOCK_RETURN(execution_engine_win32_get_numa_node_threadpool, test_pool);
+    REGISTER_GLOBAL_MOCK_RETURN(sysinfo_get_current_numa_node, 0);
+    REGISTER_GLOBAL_MOCK_RETURNS(io_context_pool_create, test_io_context_pool, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(io_context_pool_get_statistics, 0, MU_FAILURE);
 
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(io_context_pool_get, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(mocked_CreateThreadpoolCleanupGroup, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(mocked_CreateThreadpoolIo, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(mocked_CreateEventA, NULL);
@@ -171,6 +193,8 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_UMOCK_ALIAS_TYPE(LPDWORD, void*);
     REGISTER_UMOCK_ALIAS_TYPE(LPWSAOVERLAPPED, void*);
     REGISTER_UMOCK_ALIAS_TYPE(LPWSAOVERLAPPED_COMPLETION_ROUTINE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_CONTEXT_POOL_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_CONTEXT_POOL_STATISTICS*, void*);
 
     REGISTER_TYPE(ASYNC_SOCKET_OPEN_RESULT, ASYNC_SOCKET_OPEN_RESULT);
     REGISTER_TYPE(ASYNC_SOCKET_SEND_RESULT, ASYNC_SOCKET_SEND_RESULT);
@@ -234,13 +258,41 @@ TEST_FUNCTION(async_socket_create_with_INVALID_SOCKET_fails)
 }
 
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_001: [ async_socket_create shall allocate a new async socket and on success shall return a non-NULL handle. ]*/
-/* Tests_SRS_ASYNC_SOCKET_WIN32_01_035: [ Otherwise, async_socket_open_async shall obtain the PTP_POOL from the execution engine passed to async_socket_create by calling execution_engine_win32_get_threadpool. ]*/
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_107: [ async_socket_create shall create a pool for the send and receive contexts by calling io_context_pool_create. ]*/
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_035: [ Otherwise, async_socket_create shall obtain the PTP_POOL of the NUMA node of the calling thread by calling sysinfo_get_current_numa_node and execution_engine_win32_get_numa_node_threadpool with the execution engine passed to async_socket_create. ]*/
 TEST_FUNCTION(async_socket_create_succeeds)
 {
     // arrange
     ASYNC_SOCKET_HANDLE async_socket;
 
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_create(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(sysinfo_get_current_numa_node())
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(execution_engine_win32_get_numa_node_threadpool(test_execution_engine, 1));
+
+    // act
+    async_socket = async_socket_create(test_execution_engine, test_socket);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(async_socket);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_112: [ If execution_engine_win32_get_numa_node_threadpool fails, async_socket_create shall obtain the PTP_POOL by calling execution_engine_win32_get_threadpool. ]*/
+TEST_FUNCTION(when_getting_the_numa_node_threadpool_fails_async_socket_create_uses_the_execution_engine_threadpool)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_create(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(sysinfo_get_current_numa_node());
+    STRICT_EXPECTED_CALL(execution_engine_win32_get_numa_node_threadpool(test_execution_engine, 0))
+        .SetReturn(NULL);
     STRICT_EXPECTED_CALL(execution_engine_win32_get_threadpool(test_execution_engine));
 
     // act
@@ -262,6 +314,7 @@ TEST_FUNCTION(when_underlying_calls_fails_async_socket_create_also_fails)
     size_t i;
 
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_create(IGNORED_ARG, IGNORED_ARG));
 
     umock_c_negative_tests_snapshot();
 
@@ -273,7 +326,7 @@ TEST_FUNCTION(when_underlying_calls_fails_async_socket_create_also_fails)
             umock_c_negative_tests_fail_call(i);
 
             // act
-            async_socket = async_socket_create(NULL, test_socket);
+            async_socket = async_socket_create(test_execution_engine, test_socket);
 
             // assert
             ASSERT_IS_NULL(async_socket, "On failed call %zu", i);
@@ -295,6 +348,7 @@ TEST_FUNCTION(async_socket_destroy_with_NULL_returns)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_108: [ async_socket_destroy shall destroy the I/O context pool by calling io_context_pool_destroy. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_005: [ Otherwise, async_socket_destroy shall free all resources associated with async_socket. ]*/
 TEST_FUNCTION(async_socket_destroy_frees_resources)
 {
@@ -302,6 +356,7 @@ TEST_FUNCTION(async_socket_destroy_frees_resources)
     ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine, test_socket);
     umock_c_reset_all_calls();
 
+    STRICT_EXPECTED_CALL(io_context_pool_destroy(test_io_context_pool));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
     // act
@@ -337,6 +392,7 @@ TEST_FUNCTION(async_socket_destroy_closes_first_if_open)
     STRICT_EXPECTED_CALL(mocked_CloseThreadpoolCleanupGroup(test_cleanup_group));
     STRICT_EXPECTED_CALL(mocked_DestroyThreadpoolEnvironment(cbe));
 
+    STRICT_EXPECTED_CALL(io_context_pool_destroy(test_io_context_pool));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
     // act
@@ -384,7 +440,6 @@ TEST_FUNCTION(async_socket_open_async_with_NULL_on_open_complete_fails)
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_023: [ Otherwise, async_socket_open_async shall switch the state to OPENING. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_014: [ On success, async_socket_open_async shall return 0. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_016: [ Otherwise async_socket_open_async shall initialize a thread pool environment by calling InitializeThreadpoolEnvironment. ]*/
-/* Tests_SRS_ASYNC_SOCKET_WIN32_01_035: [ async_socket_open_async shall obtain the PTP_POOL from the execution engine passed to async_socket_create by calling execution_engine_win32_get_threadpool. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_036: [ async_socket_open_async shall set the thread pool for the environment to the pool obtained from the execution engine by calling SetThreadpoolCallbackPool. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_037: [ async_socket_open_async shall create a threadpool cleanup group by calling CreateThreadpoolCleanupGroup. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_058: [ async_socket_open_async shall create a threadpool IO by calling CreateThreadpoolIo and passing socket_handle, the callback environment to it and on_io_complete as callback. ]*/
@@ -904,7 +959,7 @@ TEST_FUNCTION(async_socket_send_async_after_close_fails)
     async_socket_destroy(async_socket);
 }
 
-/* Tests_SRS_ASYNC_SOCKET_WIN32_01_028: [ Otherwise async_socket_send_async shall create a context for the send where the payload, on_send_complete and on_send_complete_context shall be stored. ]*/
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_028: [ Otherwise async_socket_send_async shall get a context for the send from the I/O context pool by calling io_context_pool_get, where the payload, on_send_complete and on_send_complete_context shall be stored. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_050: [ The context shall also allocate enough memory to keep an array of buffer_count WSABUF items. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_056: [ async_socket_send_async shall set the WSABUF items to point to the memory/length of the buffers in payload. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_057: [ An event to be used for the OVERLAPPED structure passed to WSASend shall be created and stored in the context. ]*/
@@ -935,7 +990,7 @@ TEST_FUNCTION(async_socket_send_async_succeeds)
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSASend((SOCKET)test_socket, IGNORED_ARG, 1, NULL, 0, IGNORED_ARG, NULL))
@@ -978,7 +1033,7 @@ TEST_FUNCTION(async_socket_send_async_with_NULL_on_send_complete_context_succeed
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSASend((SOCKET)test_socket, IGNORED_ARG, 1, NULL, 0, IGNORED_ARG, NULL))
@@ -1018,7 +1073,7 @@ TEST_FUNCTION(when_underlying_calls_fail_async_socket_send_async_fails)
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSASend((SOCKET)test_socket, IGNORED_ARG, 1, NULL, 0, IGNORED_ARG, NULL));
@@ -1074,7 +1129,7 @@ TEST_FUNCTION(when_get_last_error_for_send_returns_WSA_IO_PENDING_it_is_treated_
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSASend((SOCKET)test_socket, IGNORED_ARG, 1, NULL, 0, IGNORED_ARG, NULL))
@@ -1122,7 +1177,7 @@ TEST_FUNCTION(when_get_last_error_for_send_returns_an_error_then_async_socket_se
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL))
         .CaptureReturn(&overlapped_event);
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
@@ -1134,7 +1189,7 @@ TEST_FUNCTION(when_get_last_error_for_send_returns_an_error_then_async_socket_se
     STRICT_EXPECTED_CALL(mocked_CancelThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_CloseHandle(IGNORED_ARG))
         .ValidateArgumentValue_hObject(&overlapped_event);
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
 
     // act
     result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, NULL);
@@ -1174,7 +1229,7 @@ TEST_FUNCTION(when_get_last_error_for_send_returns_WSAGetLastError_then_async_so
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL))
         .CaptureReturn(&overlapped_event);
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
@@ -1186,7 +1241,7 @@ TEST_FUNCTION(when_get_last_error_for_send_returns_WSAGetLastError_then_async_so
     STRICT_EXPECTED_CALL(mocked_CancelThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_CloseHandle(IGNORED_ARG))
         .ValidateArgumentValue_hObject(&overlapped_event);
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
 
     // act
     result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, NULL);
@@ -1225,7 +1280,7 @@ TEST_FUNCTION(when_WSASend_returns_an_error_different_than_SOCKET_ERROR_async_so
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL))
         .CaptureReturn(&overlapped_event);
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
@@ -1235,7 +1290,7 @@ TEST_FUNCTION(when_WSASend_returns_an_error_different_than_SOCKET_ERROR_async_so
     STRICT_EXPECTED_CALL(mocked_CancelThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_CloseHandle(IGNORED_ARG))
         .ValidateArgumentValue_hObject(&overlapped_event);
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
 
     // act
     result = async_socket_send_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_send_complete, NULL);
@@ -1573,7 +1628,7 @@ TEST_FUNCTION(async_socket_receive_async_after_close_fails)
     async_socket_destroy(async_socket);
 }
 
-/* Tests_SRS_ASYNC_SOCKET_WIN32_01_077: [ Otherwise async_socket_receive_async shall create a context for the send where the payload, on_receive_complete and on_receive_complete_context shall be stored. ]*/
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_077: [ Otherwise async_socket_receive_async shall get a context for the receive from the I/O context pool by calling io_context_pool_get, where the payload, on_receive_complete and on_receive_complete_context shall be stored. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_078: [ The context shall also allocate enough memory to keep an array of buffer_count WSABUF items. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_079: [ async_socket_receive_async shall set the WSABUF items to point to the memory/length of the buffers in payload. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_080: [ An event to be used for the OVERLAPPED structure passed to WSARecv shall be created and stored in the context. ]*/
@@ -1605,7 +1660,7 @@ TEST_FUNCTION(async_socket_receive_async_succeeds)
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSARecv((SOCKET)test_socket, IGNORED_ARG, 1, NULL, IGNORED_ARG, IGNORED_ARG, NULL))
@@ -1649,7 +1704,7 @@ TEST_FUNCTION(async_socket_receive_async_with_NULL_on_send_complete_context_succ
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSARecv((SOCKET)test_socket, IGNORED_ARG, 1, NULL, IGNORED_ARG, IGNORED_ARG, NULL))
@@ -1690,7 +1745,7 @@ TEST_FUNCTION(when_underlying_calls_fail_async_socket_receive_async_fails)
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSARecv((SOCKET)test_socket, IGNORED_ARG, 1, NULL, IGNORED_ARG, IGNORED_ARG, NULL));
@@ -1746,7 +1801,7 @@ TEST_FUNCTION(when_get_last_error_for_receive_returns_WSA_IO_PENDING_it_is_treat
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSARecv((SOCKET)test_socket, IGNORED_ARG, 1, NULL, IGNORED_ARG, IGNORED_ARG, NULL))
@@ -1795,7 +1850,7 @@ TEST_FUNCTION(when_WSARecv_returns_an_error_different_than_SOCKET_ERROR_async_so
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL))
         .CaptureReturn(&overlapped_event);
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
@@ -1806,7 +1861,7 @@ TEST_FUNCTION(when_WSARecv_returns_an_error_different_than_SOCKET_ERROR_async_so
     STRICT_EXPECTED_CALL(mocked_CancelThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_CloseHandle(IGNORED_ARG))
         .ValidateArgumentValue_hObject(&overlapped_event);
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
 
     // act
     result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, NULL);
@@ -1846,7 +1901,7 @@ TEST_FUNCTION(when_get_last_error_for_receive_returns_an_error_then_async_socket
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL))
         .CaptureReturn(&overlapped_event);
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
@@ -1859,7 +1914,7 @@ TEST_FUNCTION(when_get_last_error_for_receive_returns_an_error_then_async_socket
     STRICT_EXPECTED_CALL(mocked_CancelThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_CloseHandle(IGNORED_ARG))
         .ValidateArgumentValue_hObject(&overlapped_event);
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
 
     // act
     result = async_socket_receive_async(async_socket, payload_buffers, sizeof(payload_buffers) / sizeof(payload_buffers[0]), test_on_receive_complete, NULL);
@@ -1897,7 +1952,7 @@ TEST_FUNCTION(on_io_complete_with_NULL_overlapped_for_send_returns)
         .CaptureArgumentValue_pfnio(&test_on_io_complete);
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSASend((SOCKET)test_socket, IGNORED_ARG, 1, NULL, 0, IGNORED_ARG, NULL))
@@ -1921,7 +1976,7 @@ TEST_FUNCTION(on_io_complete_with_NULL_overlapped_for_send_returns)
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_065: [ If the context of the IO indicates that a send has completed: ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_066: [ If io_result is NO_ERROR, the on_send_complete callback passed to async_socket_send_async shall be called with on_send_complete_context as argument and ASYNC_SOCKET_SEND_OK. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_068: [ on_io_complete shall close the event handle created in async_socket_send_async/async_socket_receive_async. ]*/
-/* Tests_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall free the IO context. ]*/
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall release the IO context to the I/O context pool of the socket by calling io_context_pool_release. ]*/
 TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_send_as_complete_with_OK)
 {
     // arrange
@@ -1945,7 +2000,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_send_as_complete_with_O
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSASend((SOCKET)test_socket, IGNORED_ARG, 1, NULL, 0, IGNORED_ARG, NULL))
@@ -1958,7 +2013,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_send_as_complete_with_O
 
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4244, ASYNC_SOCKET_SEND_OK));
     STRICT_EXPECTED_CALL(mocked_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
 
     // act
     test_on_io_complete(NULL, test_ptp_io_context, overlapped, NO_ERROR, (ULONG_PTR)1, test_ptp_io);
@@ -1974,7 +2029,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_send_as_complete_with_O
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_065: [ If the context of the IO indicates that a send has completed: ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_067: [ If io_result is not NO_ERROR, the on_send_complete callback passed to async_socket_send_async shall be called with on_send_complete_context as argument and ASYNC_SOCKET_SEND_ERROR. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_068: [ on_io_complete shall close the event handle created in async_socket_send_async/async_socket_receive_async. ]*/
-/* Tests_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall free the IO context. ]*/
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall release the IO context to the I/O context pool of the socket by calling io_context_pool_release. ]*/
 TEST_FUNCTION(on_io_complete_with_error_indicates_the_send_as_complete_with_ERROR)
 {
     // arrange
@@ -1998,7 +2053,7 @@ TEST_FUNCTION(on_io_complete_with_error_indicates_the_send_as_complete_with_ERRO
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSASend((SOCKET)test_socket, IGNORED_ARG, 1, NULL, 0, IGNORED_ARG, NULL))
@@ -2011,7 +2066,7 @@ TEST_FUNCTION(on_io_complete_with_error_indicates_the_send_as_complete_with_ERRO
 
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4244, ASYNC_SOCKET_SEND_ERROR));
     STRICT_EXPECTED_CALL(mocked_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
 
     // act
     test_on_io_complete(NULL, test_ptp_io_context, overlapped, WSAECANCELLED, (ULONG_PTR)1, test_ptp_io);
@@ -2047,7 +2102,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_and_number_of_bytes_sent_less_than_ex
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSASend((SOCKET)test_socket, IGNORED_ARG, 1, NULL, 0, IGNORED_ARG, NULL))
@@ -2060,7 +2115,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_and_number_of_bytes_sent_less_than_ex
 
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4244, ASYNC_SOCKET_SEND_ERROR));
     STRICT_EXPECTED_CALL(mocked_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
 
     // act
     test_on_io_complete(NULL, test_ptp_io_context, overlapped, NO_ERROR, (ULONG_PTR)2, test_ptp_io);
@@ -2096,7 +2151,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_and_number_of_bytes_sent_more_than_ex
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSASend((SOCKET)test_socket, IGNORED_ARG, 1, NULL, 0, IGNORED_ARG, NULL))
@@ -2109,7 +2164,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_and_number_of_bytes_sent_more_than_ex
 
     STRICT_EXPECTED_CALL(test_on_send_complete((void*)0x4244, ASYNC_SOCKET_SEND_ERROR));
     STRICT_EXPECTED_CALL(mocked_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
 
     // act
     test_on_io_complete(NULL, test_ptp_io_context, overlapped, NO_ERROR, (ULONG_PTR)4, test_ptp_io);
@@ -2144,7 +2199,7 @@ TEST_FUNCTION(on_io_complete_with_NULL_overlapped_for_receive_returns)
         .CaptureArgumentValue_pfnio(&test_on_io_complete);
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSARecv((SOCKET)test_socket, IGNORED_ARG, 1, NULL, IGNORED_ARG, IGNORED_ARG, NULL))
@@ -2167,7 +2222,7 @@ TEST_FUNCTION(on_io_complete_with_NULL_overlapped_for_receive_returns)
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_071: [ If the context of the IO indicates that a receive has completed: ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_069: [ If io_result is NO_ERROR, the on_receive_complete callback passed to async_socket_receive_async shall be called with on_receive_complete_context as context, ASYNC_SOCKET_RECEIVE_OK as result and number_of_bytes_transferred as bytes_received. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_068: [ on_io_complete shall close the event handle created in async_socket_send_async/async_socket_receive_async. ]*/
-/* Tests_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall free the IO context. ]*/
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall release the IO context to the I/O context pool of the socket by calling io_context_pool_release. ]*/
 TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_receive_as_complete_with_OK)
 {
     // arrange
@@ -2191,7 +2246,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_receive_as_complete_wit
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSARecv((SOCKET)test_socket, IGNORED_ARG, 1, NULL, IGNORED_ARG, IGNORED_ARG, NULL))
@@ -2204,7 +2259,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_receive_as_complete_wit
 
     STRICT_EXPECTED_CALL(test_on_receive_complete((void*)0x4244, ASYNC_SOCKET_RECEIVE_OK, 1));
     STRICT_EXPECTED_CALL(mocked_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
 
     // act
     test_on_io_complete(NULL, test_ptp_io_context, overlapped, NO_ERROR, (ULONG_PTR)1, test_ptp_io);
@@ -2220,7 +2275,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_receive_as_complete_wit
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_071: [ If the context of the IO indicates that a receive has completed: ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_069: [ If io_result is NO_ERROR, the on_receive_complete callback passed to async_socket_receive_async shall be called with on_receive_complete_context as context, ASYNC_SOCKET_RECEIVE_OK as result and number_of_bytes_transferred as bytes_received. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_068: [ on_io_complete shall close the event handle created in async_socket_send_async/async_socket_receive_async. ]*/
-/* Tests_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall free the IO context. ]*/
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall release the IO context to the I/O context pool of the socket by calling io_context_pool_release. ]*/
 TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_receive_as_complete_with_OK_with_2_bytes_received)
 {
     // arrange
@@ -2244,7 +2299,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_receive_as_complete_wit
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSARecv((SOCKET)test_socket, IGNORED_ARG, 1, NULL, IGNORED_ARG, IGNORED_ARG, NULL))
@@ -2257,7 +2312,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_receive_as_complete_wit
 
     STRICT_EXPECTED_CALL(test_on_receive_complete((void*)0x4244, ASYNC_SOCKET_RECEIVE_OK, 2));
     STRICT_EXPECTED_CALL(mocked_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
 
     // act
     test_on_io_complete(NULL, test_ptp_io_context, overlapped, NO_ERROR, (ULONG_PTR)2, test_ptp_io);
@@ -2293,7 +2348,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_receive_as_complete_wit
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSARecv((SOCKET)test_socket, IGNORED_ARG, 1, NULL, IGNORED_ARG, IGNORED_ARG, NULL))
@@ -2306,7 +2361,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_receive_as_complete_wit
 
     STRICT_EXPECTED_CALL(test_on_receive_complete((void*)0x4244, ASYNC_SOCKET_RECEIVE_ERROR, 2));
     STRICT_EXPECTED_CALL(mocked_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
 
     // act
     test_on_io_complete(NULL, test_ptp_io_context, overlapped, NO_ERROR, (ULONG_PTR)2, test_ptp_io);
@@ -2322,7 +2377,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_receive_as_complete_wit
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_071: [ If the context of the IO indicates that a receive has completed: ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_070: [ If io_result is not NO_ERROR, the on_receive_complete callback passed to async_socket_receive_async shall be called with on_receive_complete_context as context, ASYNC_SOCKET_RECEIVE_ERROR as result and 0 for bytes_received. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_068: [ on_io_complete shall close the event handle created in async_socket_send_async/async_socket_receive_async. ]*/
-/* Tests_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall free the IO context. ]*/
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall release the IO context to the I/O context pool of the socket by calling io_context_pool_release. ]*/
 TEST_FUNCTION(on_io_complete_with_error_indicates_the_receive_as_complete_with_ERROR)
 {
     // arrange
@@ -2346,7 +2401,7 @@ TEST_FUNCTION(on_io_complete_with_error_indicates_the_receive_as_complete_with_E
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSARecv((SOCKET)test_socket, IGNORED_ARG, 1, NULL, IGNORED_ARG, IGNORED_ARG, NULL))
@@ -2359,7 +2414,7 @@ TEST_FUNCTION(on_io_complete_with_error_indicates_the_receive_as_complete_with_E
 
     STRICT_EXPECTED_CALL(test_on_receive_complete((void*)0x4244, ASYNC_SOCKET_RECEIVE_ERROR, 0));
     STRICT_EXPECTED_CALL(mocked_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
 
     // act
     test_on_io_complete(NULL, test_ptp_io_context, overlapped, WSAECANCELLED, (ULONG_PTR)1, test_ptp_io);
@@ -2395,7 +2450,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_receive_as_complete_wit
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSARecv((SOCKET)test_socket, IGNORED_ARG, 1, NULL, IGNORED_ARG, IGNORED_ARG, NULL))
@@ -2408,7 +2463,7 @@ TEST_FUNCTION(on_io_complete_with_NO_ERROR_indicates_the_receive_as_complete_wit
 
     STRICT_EXPECTED_CALL(test_on_receive_complete((void*)0x4244, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
     STRICT_EXPECTED_CALL(mocked_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
 
     // act
     test_on_io_complete(NULL, test_ptp_io_context, overlapped, NO_ERROR, (ULONG_PTR)0, test_ptp_io);
@@ -2443,7 +2498,7 @@ static void on_io_complete_with_error_indicates_the_receive_as_complete_with_ABA
     (void)async_socket_open_async(async_socket, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateEventA(NULL, FALSE, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_StartThreadpoolIo(test_ptp_io));
     STRICT_EXPECTED_CALL(mocked_WSARecv((SOCKET)test_socket, IGNORED_ARG, 1, NULL, IGNORED_ARG, IGNORED_ARG, NULL))
@@ -2456,7 +2511,7 @@ static void on_io_complete_with_error_indicates_the_receive_as_complete_with_ABA
 
     STRICT_EXPECTED_CALL(test_on_receive_complete((void*)0x4244, ASYNC_SOCKET_RECEIVE_ABANDONED, 0));
     STRICT_EXPECTED_CALL(mocked_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
 
     // act
     test_on_io_complete(NULL, test_ptp_io_context, overlapped, error_code, (ULONG_PTR)1, test_ptp_io);
@@ -2472,7 +2527,7 @@ static void on_io_complete_with_error_indicates_the_receive_as_complete_with_ABA
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_071: [ If the context of the IO indicates that a receive has completed: ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_42_001: [ If io_result is ERROR_NETNAME_DELETED or ERROR_CONNECTION_ABORTED, the on_receive_complete callback passed to async_socket_receive_async shall be called with on_receive_complete_context as context, ASYNC_SOCKET_RECEIVE_ABANDONED as result and 0 for bytes_received. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_068: [ on_io_complete shall close the event handle created in async_socket_send_async/async_socket_receive_async. ]*/
-/* Tests_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall free the IO context. ]*/
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall release the IO context to the I/O context pool of the socket by calling io_context_pool_release. ]*/
 TEST_FUNCTION(on_io_complete_with_ERROR_NETNAME_DELETED_indicates_the_receive_as_complete_with_ABANDONED)
 {
     on_io_complete_with_error_indicates_the_receive_as_complete_with_ABANDONED(ERROR_NETNAME_DELETED);
@@ -2482,10 +2537,88 @@ TEST_FUNCTION(on_io_complete_with_ERROR_NETNAME_DELETED_indicates_the_receive_as
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_071: [ If the context of the IO indicates that a receive has completed: ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_42_001: [ If io_result is ERROR_NETNAME_DELETED or ERROR_CONNECTION_ABORTED, the on_receive_complete callback passed to async_socket_receive_async shall be called with on_receive_complete_context as context, ASYNC_SOCKET_RECEIVE_ABANDONED as result and 0 for bytes_received. ]*/
 /* Tests_SRS_ASYNC_SOCKET_WIN32_01_068: [ on_io_complete shall close the event handle created in async_socket_send_async/async_socket_receive_async. ]*/
-/* Tests_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall free the IO context. ]*/
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_072: [ on_io_complete shall release the IO context to the I/O context pool of the socket by calling io_context_pool_release. ]*/
 TEST_FUNCTION(on_io_complete_with_ERROR_CONNECTION_ABORTED_indicates_the_receive_as_complete_with_ABANDONED)
 {
     on_io_complete_with_error_indicates_the_receive_as_complete_with_ABANDONED(ERROR_CONNECTION_ABORTED);
 }
 
+/* async_socket_get_io_context_pool_statistics */
+
+/* Tests_SRS_ASYNC_SOCKET_01_051: [ If async_socket is NULL, async_socket_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(async_socket_get_io_context_pool_statistics_with_NULL_async_socket_fails)
+{
+    // arrange
+    IO_CONTEXT_POOL_STATISTICS statistics;
+
+    // act
+    int result = async_socket_get_io_context_pool_statistics(NULL, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_ASYNC_SOCKET_01_052: [ If statistics is NULL, async_socket_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(async_socket_get_io_context_pool_statistics_with_NULL_statistics_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine, test_socket);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = async_socket_get_io_context_pool_statistics(async_socket, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_109: [ async_socket_get_io_context_pool_statistics shall obtain the counters of the I/O context pool by calling io_context_pool_get_statistics. ]*/
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_111: [ Otherwise async_socket_get_io_context_pool_statistics shall succeed and return 0. ]*/
+TEST_FUNCTION(async_socket_get_io_context_pool_statistics_succeeds)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine, test_socket);
+    IO_CONTEXT_POOL_STATISTICS statistics;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get_statistics(test_io_context_pool, &statistics));
+
+    // act
+    int result = async_socket_get_io_context_pool_statistics(async_socket, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
+/* Tests_SRS_ASYNC_SOCKET_WIN32_01_110: [ If io_context_pool_get_statistics fails, async_socket_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_io_context_pool_get_statistics_fails_async_socket_get_io_context_pool_statistics_fails)
+{
+    // arrange
+    ASYNC_SOCKET_HANDLE async_socket = async_socket_create(test_execution_engine, test_socket);
+    IO_CONTEXT_POOL_STATISTICS statistics;
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get_statistics(test_io_context_pool, &statistics))
+        .SetReturn(MU_FAILURE);
+
+    // act
+    int result = async_socket_get_io_context_pool_statistics(async_socket, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    async_socket_destroy(async_socket);
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -11,4 +11,24 @@
 
 extern PTP_POOL WINAPI mocked_CreateThreadpool(LPVOID reserved);
 
+#define GetNumaNodeProcessorMaskEx mocked_GetNumaNodeProcessorMaskEx
+#define SetThreadGroupAffinity mocked_SetThreadGroupAffinity
+#define InitializeThreadpoolEnvironment mocked_InitializeThreadpoolEnvironment
+#define SetThreadpoolCallbackPool mocked_SetThreadpoolCallbackPool
+#define DestroyThreadpoolEnvironment mocked_DestroyThreadpoolEnvironment
+#define CreateThreadpoolWork mocked_CreateThreadpoolWork
+#define SubmitThreadpoolWork mocked_SubmitThreadpoolWork
+#define WaitForThreadpoolWorkCallbacks mocked_WaitForThreadpoolWorkCallbacks
+#define CloseThreadpoolWork mocked_CloseThreadpoolWork
+
+BOOL WINAPI mocked_GetNumaNodeProcessorMaskEx(USHORT Node, PGROUP_AFFINITY ProcessorMask);
+BOOL WINAPI mocked_SetThreadGroupAffinity(HANDLE hThread, const GROUP_AFFINITY* GroupAffinity, PGROUP_AFFINITY PreviousGroupAffinity);
+void mocked_InitializeThreadpoolEnvironment(PTP_CALLBACK_ENVIRON pcbe);
+void mocked_SetThreadpoolCallbackPool(PTP_CALLBACK_ENVIRON pcbe, PTP_POOL ptpp);
+void mocked_DestroyThreadpoolEnvironment(PTP_CALLBACK_ENVIRON pcbe);
+PTP_WORK mocked_CreateThreadpoolWork(PTP_WORK_CALLBACK pfnwk, PVOID pv, PTP_CALLBACK_ENVIRON pcbe);
+void mocked_SubmitThreadpoolWork(PTP_WORK pwk);
+void mocked_WaitForThreadpoolWorkCallbacks(PTP_WORK pwk, BOOL fCancelPendingCallbacks);
+void mocked_CloseThreadpoolWork(PTP_WORK pwk);
+
 #include "../../src/execution_engine_win32.c"
@@ -3,9 +3,12 @@
 #ifdef __cplusplus
 #include <cstdlib>
 #include <cinttypes>
+#include <cstring>
 #else
 #include <stdlib.h>
 #include <inttypes.h>
+#include <stdbool.h>
+#include <string.h>
 #endif
 
 #include "windows.h"
@@ -32,6 +35,10 @@ void real_free(void* ptr)
 
 #include "c_pal/gballoc_hl.h"
 #include "c_pal/gballoc_hl_redirect.h"
+#include "c_pal/io_admission.h"
+#include "c_pal/lazy_init.h"
+#include "c_pal/sync.h"
+#include "c_pal/sysinfo.h"
 
 #undef ENABLE_MOCKS
 
@@ -41,8 +48,20 @@ void real_free(void* ptr)
 
 static TEST_MUTEX_HANDLE test_serialize_mutex;
 
+static IO_ADMISSION_HANDLE test_io_admission = (IO_ADMISSION_HANDLE)0x4244;
+static PTP_WORK test_work = (PTP_WORK)0x4245;
+
+static KAFFINITY test_numa_node_processor_mask = 0xF0;
+static PTP_WORK_CALLBACK captured_work_callback;
+static PVOID captured_work_context;
+static uint32_t test_pending_work_callbacks;
+static KAFFINITY captured_thread_affinity_mask;
+
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
+TEST_DEFINE_ENUM_TYPE(LAZY_INIT_RESULT, LAZY_INIT_RESULT_VALUES);
+IMPLEMENT_UMOCK_C_ENUM_TYPE(LAZY_INIT_RESULT, LAZY_INIT_RESULT_VALUES);
+
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 {
     ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
@@ -62,11 +81,103 @@ MOCK_FUNCTION_WITH_CODE(WINAPI, BOOL, mocked_SetThreadpoolThreadMinimum, PTP_POO
 MOCK_FUNCTION_END(TRUE)
 MOCK_FUNCTION_WITH_CODE(WINAPI, void, mocked_SetThreadpoolThreadMaximum, PTP_POOL, ptpp, DWORD, cthrdMost)
 MOCK_FUNCTION_END()
+MOCK_FUNCTION_WITH_CODE(WINAPI, BOOL, mocked_GetNumaNodeProcessorMaskEx, USHORT, Node, PGROUP_AFFINITY, ProcessorMask)
+    (void)memset(ProcessorMask, 0, sizeof(GROUP_AFFINITY));
+    ProcessorMask->Mask = test_numa_node_processor_mask;
+MOCK_FUNCTION_END(TRUE)
+MOCK_FUNCTION_WITH_CODE(WINAPI, BOOL, mocked_SetThreadGroupAffinity, HANDLE, hThread, const GROUP_AFFINITY*, GroupAffinity, PGROUP_AFFINITY, PreviousGroupAffinity)
+    captured_thread_affinity_mask = GroupAffinity->Mask;
+MOCK_FUNCTION_END(TRUE)
+MOCK_FUNCTION_WITH_CODE(, void, mocked_InitializeThreadpoolEnvironment, PTP_CALLBACK_ENVIRON, pcbe)
+MOCK_FUNCTION_END()
+MOCK_FUNCTION_WITH_CODE(, void, mocked_SetThreadpoolCallbackPool, PTP_CALLBACK_ENVIRON, pcbe, PTP_POOL, ptpp)
+MOCK_FUNCTION_END()
+MOCK_FUNCTION_WITH_CODE(, void, mocked_DestroyThreadpoolEnvironment, PTP_CALLBACK_ENVIRON, pcbe)
+MOCK_FUNCTION_END()
+MOCK_FUNCTION_WITH_CODE(, PTP_WORK, mocked_CreateThreadpoolWork, PTP_WORK_CALLBACK, pfnwk, PVOID, pv, PTP_CALLBACK_ENVIRON, pcbe)
+    captured_work_callback = pfnwk;
+    captured_work_context = pv;
+MOCK_FUNCTION_END(test_work)
+MOCK_FUNCTION_WITH_CODE(, void, mocked_SubmitThreadpoolWork, PTP_WORK, pwk)
+    test_pending_work_callbacks++;
+MOCK_FUNCTION_END()
+MOCK_FUNCTION_WITH_CODE(, void, mocked_WaitForThreadpoolWorkCallbacks, PTP_WORK, pwk, BOOL, fCancelPendingCallbacks)
+    while (test_pending_work_callbacks > 0)
+    {
+        test_pending_work_callbacks--;
+        captured_work_callback(NULL, captured_work_context, pwk);
+    }
+MOCK_FUNCTION_END()
+MOCK_FUNCTION_WITH_CODE(, void, mocked_CloseThreadpoolWork, PTP_WORK, pwk)
+MOCK_FUNCTION_END()
 
 #ifdef __cplusplus
 }
 #endif
 
+static LAZY_INIT_RESULT hook_lazy_init(call_once_t* lazy, LAZY_INIT_FUNCTION do_init, void* init_params)
+{
+    (void)lazy;
+    return (do_init(init_params) == 0) ? LAZY_INIT_OK : LAZY_INIT_ERROR;
+}
+
+/*the pinning callbacks of a node wait for each other, so a waiting callback runs the next submitted one*/
+static bool hook_wait_on_address(volatile_atomic int32_t* address, int32_t compare_value, uint32_t timeout_ms)
+{
+    (void)address;
+    (void)compare_value;
+    (void)timeout_ms;
+    if (test_pending_work_callbacks > 0)
+    {
+        test_pending_work_callbacks--;
+        captured_work_callback(NULL, captured_work_context, test_work);
+    }
+    return true;
+}
+
+static EXECUTION_ENGINE_HANDLE create_execution_engine_with_numa_nodes(uint32_t numa_node_count, uint32_t min_thread_count, uint32_t max_thread_count, PTP_POOL* ptp_pool)
+{
+    EXECUTION_ENGINE_PARAMETERS_WIN32 execution_engine_params_win32 = { min_thread_count, max_thread_count, 0 };
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpool(NULL))
+        .CaptureReturn(ptp_pool);
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count())
+        .SetReturn(numa_node_count);
+    EXECUTION_ENGINE_HANDLE execution_engine = execution_engine_create(&execution_engine_params_win32);
+    ASSERT_IS_NOT_NULL(execution_engine);
+    umock_c_reset_all_calls();
+    return execution_engine;
+}
+
+static void setup_create_numa_node_threadpool_expected_calls(uint32_t numa_node, uint32_t thread_count, PTP_POOL* numa_node_ptp_pool)
+{
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_GetNumaNodeProcessorMaskEx((USHORT)numa_node, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpool(NULL))
+        .CaptureReturn(numa_node_ptp_pool);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolThreadMaximum(IGNORED_ARG, thread_count))
+        .ValidateArgumentValue_ptpp(numa_node_ptp_pool);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolThreadMinimum(IGNORED_ARG, thread_count))
+        .ValidateArgumentValue_ptpp(numa_node_ptp_pool);
+    STRICT_EXPECTED_CALL(mocked_InitializeThreadpoolEnvironment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackPool(IGNORED_ARG, IGNORED_ARG))
+        .ValidateArgumentValue_ptpp(numa_node_ptp_pool);
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    for (uint32_t i = 0; i < thread_count; i++)
+    {
+        STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(test_work));
+    }
+    STRICT_EXPECTED_CALL(mocked_WaitForThreadpoolWorkCallbacks(test_work, FALSE));
+    for (uint32_t i = 0; i < thread_count - 1; i++)
+    {
+        STRICT_EXPECTED_CALL(mocked_SetThreadGroupAffinity(IGNORED_ARG, IGNORED_ARG, NULL));
+        STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, IGNORED_ARG, UINT32_MAX));
+    }
+    STRICT_EXPECTED_CALL(mocked_SetThreadGroupAffinity(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CloseThreadpoolWork(test_work));
+    STRICT_EXPECTED_CALL(mocked_DestroyThreadpoolEnvironment(IGNORED_ARG));
+}
+
 BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -88,11 +199,28 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
 
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(io_admission_create, test_io_admission, NULL);
+    REGISTER_GLOBAL_MOCK_RETURN(sysinfo_get_numa_node_count, 1);
+    REGISTER_GLOBAL_MOCK_HOOK(lazy_init, hook_lazy_init);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(lazy_init, LAZY_INIT_ERROR);
+    REGISTER_GLOBAL_MOCK_HOOK(wait_on_address, hook_wait_on_address);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mocked_GetNumaNodeProcessorMaskEx, FALSE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mocked_CreateThreadpoolWork, NULL);
+
+    REGISTER_TYPE(LAZY_INIT_RESULT, LAZY_INIT_RESULT);
 
     REGISTER_UMOCK_ALIAS_TYPE(PTP_POOL, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_ADMISSION_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(PVOID, void*);
     REGISTER_UMOCK_ALIAS_TYPE(DWORD, unsigned long);
     REGISTER_UMOCK_ALIAS_TYPE(BOOL, int);
+    REGISTER_UMOCK_ALIAS_TYPE(USHORT, unsigned short);
+    REGISTER_UMOCK_ALIAS_TYPE(HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PGROUP_AFFINITY, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PTP_WORK, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PTP_WORK_CALLBACK, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PTP_CALLBACK_ENVIRON, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(LAZY_INIT_FUNCTION, void*);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -113,6 +241,10 @@ TEST_FUNCTION_INITIALIZE(method_init)
 
     umock_c_reset_all_calls();
     umock_c_negative_tests_init();
+
+    test_numa_node_processor_mask = 0xF0;
+    test_pending_work_callbacks = 0;
+    captured_thread_affinity_mask = 0;
 }
 
 TEST_FUNCTION_CLEANUP(method_cleanup)
@@ -123,7 +255,7 @@ TEST_FUNCTION_CLEANUP(method_cleanup)
 
 /* execution_engine_create */
 
-/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_011: [ If execution_engine_parameters is NULL, execution_engine_create shall use the defaults DEFAULT_MIN_THREAD_COUNT and DEFAULT_MAX_THREAD_COUNT as parameters. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_011: [ If execution_engine_parameters is NULL, execution_engine_create shall use the defaults DEFAULT_MIN_THREAD_COUNT, DEFAULT_MAX_THREAD_COUNT and DEFAULT_MAX_OUTSTANDING_IO as parameters. ]*/
 TEST_FUNCTION(execution_engine_create_with_NULL_arguments_uses_Defaults)
 {
     // arrange
@@ -134,6 +266,7 @@ TEST_FUNCTION(execution_engine_create_with_NULL_arguments_uses_Defaults)
         .CaptureReturn(&ptp_pool);
     STRICT_EXPECTED_CALL(mocked_SetThreadpoolThreadMinimum(IGNORED_ARG, DEFAULT_MIN_THREAD_COUNT))
         .ValidateArgumentValue_ptpp(&ptp_pool);
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count());
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
 
     // act
@@ -152,6 +285,7 @@ TEST_FUNCTION(execution_engine_create_with_NULL_arguments_uses_Defaults)
 /* Tests_SRS_EXECUTION_ENGINE_WIN32_01_003: [ execution_engine_create shall call CreateThreadpool to create the Win32 threadpool. ]*/
 /* Tests_SRS_EXECUTION_ENGINE_WIN32_01_004: [ execution_engine_create shall set the minimum number of threads to the min_thread_count field of execution_engine_parameters. ]*/
 /* Tests_SRS_EXECUTION_ENGINE_WIN32_01_012: [ If max_thread_count is 0, execution_engine_create shall not set the maximum thread count. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_019: [ execution_engine_create shall obtain the number of NUMA nodes of the host by calling sysinfo_get_numa_node_count. ]*/
 TEST_FUNCTION(execution_engine_create_succeeds)
 {
     // arrange
@@ -163,6 +297,7 @@ TEST_FUNCTION(execution_engine_create_succeeds)
         .CaptureReturn(&ptp_pool);
     STRICT_EXPECTED_CALL(mocked_SetThreadpoolThreadMinimum(IGNORED_ARG, 1))
         .ValidateArgumentValue_ptpp(&ptp_pool);
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count());
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
 
     // act
@@ -190,7 +325,63 @@ TEST_FUNCTION(execution_engine_create_with_max_thread_count_succeeds)
         .ValidateArgumentValue_ptpp(&ptp_pool);
     STRICT_EXPECTED_CALL(mocked_SetThreadpoolThreadMaximum(IGNORED_ARG, 42))
         .ValidateArgumentValue_ptpp(&ptp_pool);
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count());
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    // act
+    execution_engine = execution_engine_create(&execution_engine_params_win32);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(execution_engine);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_020: [ If there is more than one NUMA node, execution_engine_create shall allocate a NUMA node threadpool for each node. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_021: [ execution_engine_create shall not create the threadpools of the NUMA nodes, they are created on first use. ]*/
+TEST_FUNCTION(execution_engine_create_on_a_NUMA_host_does_not_create_the_threadpools_of_the_nodes)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    EXECUTION_ENGINE_PARAMETERS_WIN32 execution_engine_params_win32 = { 1, 0 };
+    PTP_POOL ptp_pool;
+
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpool(NULL))
+        .CaptureReturn(&ptp_pool);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolThreadMinimum(IGNORED_ARG, 1))
+        .ValidateArgumentValue_ptpp(&ptp_pool);
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count())
+        .SetReturn(2);
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    // act
+    execution_engine = execution_engine_create(&execution_engine_params_win32);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(execution_engine);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_014: [ If max_outstanding_io is not 0, execution_engine_create shall create an admission bounding the outstanding file I/Os of the execution engine by calling io_admission_create with max_outstanding_io. ]*/
+TEST_FUNCTION(execution_engine_create_with_max_outstanding_io_creates_the_admission)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    EXECUTION_ENGINE_PARAMETERS_WIN32 execution_engine_params_win32 = { 1, 0, 16 };
+    PTP_POOL ptp_pool;
+
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpool(NULL))
+        .CaptureReturn(&ptp_pool);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolThreadMinimum(IGNORED_ARG, 1))
+        .ValidateArgumentValue_ptpp(&ptp_pool);
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count());
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_create(16));
 
     // act
     execution_engine = execution_engine_create(&execution_engine_params_win32);
@@ -203,6 +394,34 @@ TEST_FUNCTION(execution_engine_create_with_max_thread_count_succeeds)
     execution_engine_dec_ref(execution_engine);
 }
 
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_006: [ If any error occurs, execution_engine_create shall fail and return NULL. ]*/
+TEST_FUNCTION(when_io_admission_create_fails_execution_engine_create_fails)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    EXECUTION_ENGINE_PARAMETERS_WIN32 execution_engine_params_win32 = { 1, 0, 16 };
+    PTP_POOL ptp_pool;
+
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpool(NULL))
+        .CaptureReturn(&ptp_pool);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolThreadMinimum(IGNORED_ARG, 1))
+        .ValidateArgumentValue_ptpp(&ptp_pool);
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count());
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_create(16))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CloseThreadpool(IGNORED_ARG))
+        .ValidateArgumentValue_ptpp(&ptp_pool);
+
+    // act
+    execution_engine = execution_engine_create(&execution_engine_params_win32);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(execution_engine);
+}
+
 /* Tests_SRS_EXECUTION_ENGINE_WIN32_01_013: [ If max_thread_count is non-zero, but less than min_thread_count, execution_engine_create shall fail and return NULL. ]*/
 TEST_FUNCTION(execution_engine_create_with_max_thread_count_less_than_min_thread_count_fails)
 {
@@ -231,6 +450,9 @@ TEST_FUNCTION(when_underlying_calls_fail_execution_engine_create_fails)
     STRICT_EXPECTED_CALL(mocked_SetThreadpoolThreadMinimum(IGNORED_ARG, 2))
         .SetFailReturn(FALSE);
     STRICT_EXPECTED_CALL(mocked_SetThreadpoolThreadMaximum(IGNORED_ARG, 42));
+    STRICT_EXPECTED_CALL(sysinfo_get_numa_node_count())
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
 
     umock_c_negative_tests_snapshot();
 
@@ -320,6 +542,53 @@ TEST_FUNCTION(execution_engine_dec_ref_frees_resources)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_016: [ If the refcount is zero execution_engine_dec_ref shall destroy the admission if it was created. ]*/
+TEST_FUNCTION(execution_engine_dec_ref_destroys_the_admission)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    EXECUTION_ENGINE_PARAMETERS_WIN32 execution_engine_params_win32 = { 1, 0, 16 };
+    PTP_POOL ptp_pool;
+
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpool(NULL))
+        .CaptureReturn(&ptp_pool);
+    execution_engine = execution_engine_create(&execution_engine_params_win32);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mocked_CloseThreadpool(ptp_pool));
+    STRICT_EXPECTED_CALL(io_admission_destroy(test_io_admission));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    execution_engine_dec_ref(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_022: [ If the refcount is zero execution_engine_dec_ref shall close the threadpools of the NUMA nodes that were created. ]*/
+TEST_FUNCTION(execution_engine_dec_ref_closes_the_threadpools_of_the_NUMA_nodes_that_were_created)
+{
+    // arrange
+    PTP_POOL ptp_pool;
+    PTP_POOL numa_node_ptp_pool;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_numa_nodes(3, 1, 0, &ptp_pool);
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpool(NULL))
+        .CaptureReturn(&numa_node_ptp_pool);
+    ASSERT_IS_NOT_NULL(execution_engine_win32_get_numa_node_threadpool(execution_engine, 1));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mocked_CloseThreadpool(numa_node_ptp_pool));
+    STRICT_EXPECTED_CALL(mocked_CloseThreadpool(ptp_pool));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    execution_engine_dec_ref(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 /* Tests_SRS_EXECUTION_ENGINE_WIN32_03_001: [ Otherwise execution_engine_dec_ref shall decrement the refcount.]*/
 TEST_FUNCTION(execution_engine_dec_ref_decrements_ref_count)
 {
@@ -386,4 +655,328 @@ TEST_FUNCTION(execution_engine_win32_get_threadpool_returns_the_underlying_PTP_P
     execution_engine_dec_ref(execution_engine);
 }
 
+/* execution_engine_win32_get_io_admission */
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_017: [ If execution_engine is NULL, execution_engine_win32_get_io_admission shall fail and return NULL. ]*/
+TEST_FUNCTION(execution_engine_win32_get_io_admission_with_NULL_execution_engine_fails)
+{
+    // arrange
+    IO_ADMISSION_HANDLE result;
+
+    // act
+    result = execution_engine_win32_get_io_admission(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_018: [ Otherwise, execution_engine_win32_get_io_admission shall return the admission created in execution_engine_create, or NULL if max_outstanding_io was 0. ]*/
+TEST_FUNCTION(execution_engine_win32_get_io_admission_returns_the_admission)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    EXECUTION_ENGINE_PARAMETERS_WIN32 execution_engine_params_win32 = { 1, 0, 16 };
+    IO_ADMISSION_HANDLE result;
+
+    execution_engine = execution_engine_create(&execution_engine_params_win32);
+    umock_c_reset_all_calls();
+
+    // act
+    result = execution_engine_win32_get_io_admission(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, test_io_admission, result);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_015: [ If max_outstanding_io is 0, execution_engine_create shall not limit the number of outstanding file I/Os. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_018: [ Otherwise, execution_engine_win32_get_io_admission shall return the admission created in execution_engine_create, or NULL if max_outstanding_io was 0. ]*/
+TEST_FUNCTION(execution_engine_win32_get_io_admission_without_a_limit_returns_NULL)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    EXECUTION_ENGINE_PARAMETERS_WIN32 execution_engine_params_win32 = { 1, 0, 0 };
+    IO_ADMISSION_HANDLE result;
+
+    execution_engine = execution_engine_create(&execution_engine_params_win32);
+    umock_c_reset_all_calls();
+
+    // act
+    result = execution_engine_win32_get_io_admission(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* execution_engine_win32_get_numa_node_threadpool */
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_023: [ If execution_engine is NULL, execution_engine_win32_get_numa_node_threadpool shall fail and return NULL. ]*/
+TEST_FUNCTION(execution_engine_win32_get_numa_node_threadpool_with_NULL_execution_engine_fails)
+{
+    // arrange
+
+    // act
+    PTP_POOL result = execution_engine_win32_get_numa_node_threadpool(NULL, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_024: [ If numa_node is greater than or equal to the number of NUMA nodes, execution_engine_win32_get_numa_node_threadpool shall fail and return NULL. ]*/
+TEST_FUNCTION(execution_engine_win32_get_numa_node_threadpool_with_node_1_on_a_non_NUMA_host_fails)
+{
+    // arrange
+    PTP_POOL ptp_pool;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_numa_nodes(1, 1, 0, &ptp_pool);
+
+    // act
+    PTP_POOL result = execution_engine_win32_get_numa_node_threadpool(execution_engine, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_024: [ If numa_node is greater than or equal to the number of NUMA nodes, execution_engine_win32_get_numa_node_threadpool shall fail and return NULL. ]*/
+TEST_FUNCTION(execution_engine_win32_get_numa_node_threadpool_with_node_equal_to_the_node_count_fails)
+{
+    // arrange
+    PTP_POOL ptp_pool;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_numa_nodes(2, 1, 0, &ptp_pool);
+
+    // act
+    PTP_POOL result = execution_engine_win32_get_numa_node_threadpool(execution_engine, 2);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(result);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_025: [ If there is only one NUMA node, execution_engine_win32_get_numa_node_threadpool shall return the threadpool created in execution_engine_create. ]*/
+TEST_FUNCTION(execution_engine_win32_get_numa_node_threadpool_on_a_non_NUMA_host_returns_the_threadpool)
+{
+    // arrange
+    PTP_POOL ptp_pool;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_numa_nodes(1, 1, 0, &ptp_pool);
+
+    // act
+    PTP_POOL result = execution_engine_win32_get_numa_node_threadpool(execution_engine, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, ptp_pool, result);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_026: [ Otherwise execution_engine_win32_get_numa_node_threadpool shall call lazy_init to create the threadpool of the node only once. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_027: [ The first call for a node shall obtain the processors of the node by calling GetNumaNodeProcessorMaskEx. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_029: [ The number of threads of the node shall be max_thread_count divided by the number of nodes, rounded up, or if max_thread_count is 0 the greater of min_thread_count divided by the number of nodes, rounded up, and the number of processors of the node. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_030: [ The first call for a node shall create the threadpool of the node by calling CreateThreadpool and set both its maximum and its minimum number of threads to the number of threads of the node. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_031: [ The first call for a node shall pin every thread of the pool to the processors of the node by calling CreateThreadpoolWork with on_pin_thread_to_numa_node, submitting the work item once per thread with SubmitThreadpoolWork and waiting for all the callbacks with WaitForThreadpoolWorkCallbacks. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_032: [ on_pin_thread_to_numa_node shall restrict the calling thread to the processors of the node by calling SetThreadGroupAffinity. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_033: [ on_pin_thread_to_numa_node shall decrement the number of threads left to pin and, if it reaches 0, wake the other threads by calling wake_by_address_all. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_034: [ Otherwise on_pin_thread_to_numa_node shall wait by calling wait_on_address until all the threads of the pool are pinned, so that each callback pins a different thread. ]*/
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_036: [ Otherwise execution_engine_win32_get_numa_node_threadpool shall return the threadpool of the node. ]*/
+TEST_FUNCTION(execution_engine_win32_get_numa_node_threadpool_creates_the_threadpool_of_the_node_with_max_thread_count)
+{
+    // arrange
+    PTP_POOL ptp_pool;
+    PTP_POOL numa_node_ptp_pool;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_numa_nodes(2, 1, 5, &ptp_pool);
+
+    setup_create_numa_node_threadpool_expected_calls(1, 3, &numa_node_ptp_pool);
+
+    // act
+    PTP_POOL result = execution_engine_win32_get_numa_node_threadpool(execution_engine, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(void_ptr, numa_node_ptp_pool, result);
+    ASSERT_ARE_NOT_EQUAL(void_ptr, ptp_pool, result);
+    ASSERT_ARE_EQUAL(uint64_t, 0xF0, (uint64_t)captured_thread_affinity_mask);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_029: [ The number of threads of the node shall be max_thread_count divided by the number of nodes, rounded up, or if max_thread_count is 0 the greater of min_thread_count divided by the number of nodes, rounded up, and the number of processors of the node. ]*/
+TEST_FUNCTION(execution_engine_win32_get_numa_node_threadpool_without_max_thread_count_uses_the_processors_of_the_node)
+{
+    // arrange
+    PTP_POOL ptp_pool;
+    PTP_POOL numa_node_ptp_pool;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_numa_nodes(2, 4, 0, &ptp_pool);
+
+    setup_create_numa_node_threadpool_expected_calls(0, 4, &numa_node_ptp_pool);
+
+    // act
+    PTP_POOL result = execution_engine_win32_get_numa_node_threadpool(execution_engine, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, numa_node_ptp_pool, result);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_029: [ The number of threads of the node shall be max_thread_count divided by the number of nodes, rounded up, or if max_thread_count is 0 the greater of min_thread_count divided by the number of nodes, rounded up, and the number of processors of the node. ]*/
+TEST_FUNCTION(execution_engine_win32_get_numa_node_threadpool_without_max_thread_count_uses_min_thread_count_when_greater)
+{
+    // arrange
+    PTP_POOL ptp_pool;
+    PTP_POOL numa_node_ptp_pool;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_numa_nodes(2, 11, 0, &ptp_pool);
+    test_numa_node_processor_mask = 0x3;
+
+    setup_create_numa_node_threadpool_expected_calls(1, 6, &numa_node_ptp_pool);
+
+    // act
+    PTP_POOL result = execution_engine_win32_get_numa_node_threadpool(execution_engine, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, numa_node_ptp_pool, result);
+    ASSERT_ARE_EQUAL(uint64_t, 0x3, (uint64_t)captured_thread_affinity_mask);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_028: [ If the node has no processors, the threadpool created in execution_engine_create shall be used for the node. ]*/
+TEST_FUNCTION(execution_engine_win32_get_numa_node_threadpool_for_a_node_without_processors_returns_the_threadpool)
+{
+    // arrange
+    PTP_POOL ptp_pool;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_numa_nodes(2, 1, 0, &ptp_pool);
+    test_numa_node_processor_mask = 0;
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_GetNumaNodeProcessorMaskEx(1, IGNORED_ARG));
+
+    // act
+    PTP_POOL result = execution_engine_win32_get_numa_node_threadpool(execution_engine, 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, ptp_pool, result);
+
+    // cleanup
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(mocked_CloseThreadpool(ptp_pool));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    execution_engine_dec_ref(execution_engine);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_035: [ If lazy_init fails, execution_engine_win32_get_numa_node_threadpool shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_execution_engine_win32_get_numa_node_threadpool_fails)
+{
+    // arrange
+    PTP_POOL ptp_pool;
+    PTP_POOL numa_node_ptp_pool;
+    EXECUTION_ENGINE_HANDLE execution_engine = create_execution_engine_with_numa_nodes(2, 1, 4, &ptp_pool);
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(mocked_GetNumaNodeProcessorMaskEx(1, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpool(NULL))
+        .CaptureReturn(&numa_node_ptp_pool)
+        .SetFailReturn(NULL);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolThreadMaximum(IGNORED_ARG, 2));
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolThreadMinimum(IGNORED_ARG, 2))
+        .SetFailReturn(FALSE);
+    STRICT_EXPECTED_CALL(mocked_InitializeThreadpoolEnvironment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackPool(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(test_work));
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(test_work));
+    STRICT_EXPECTED_CALL(mocked_WaitForThreadpoolWorkCallbacks(test_work, FALSE));
+    STRICT_EXPECTED_CALL(mocked_SetThreadGroupAffinity(IGNORED_ARG, IGNORED_ARG, NULL))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, IGNORED_ARG, UINT32_MAX))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(mocked_SetThreadGroupAffinity(IGNORED_ARG, IGNORED_ARG, NULL))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CloseThreadpoolWork(test_work));
+    STRICT_EXPECTED_CALL(mocked_DestroyThreadpoolEnvironment(IGNORED_ARG));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            PTP_POOL result = execution_engine_win32_get_numa_node_threadpool(execution_engine, 1);
+
+            // assert
+            ASSERT_IS_NULL(result, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
+/* execution_engine_win32_get_min_thread_count */
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_037: [ If execution_engine is NULL, execution_engine_win32_get_min_thread_count shall return 0. ]*/
+TEST_FUNCTION(execution_engine_win32_get_min_thread_count_with_NULL_execution_engine_returns_0)
+{
+    // arrange
+    uint32_t result;
+
+    // act
+    result = execution_engine_win32_get_min_thread_count(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, result);
+}
+
+/* Tests_SRS_EXECUTION_ENGINE_WIN32_01_038: [ Otherwise, execution_engine_win32_get_min_thread_count shall return the min_thread_count used in execution_engine_create. ]*/
+TEST_FUNCTION(execution_engine_win32_get_min_thread_count_returns_the_min_thread_count)
+{
+    // arrange
+    EXECUTION_ENGINE_HANDLE execution_engine;
+    EXECUTION_ENGINE_PARAMETERS_WIN32 execution_engine_params_win32 = { 3, 42, 0 };
+    uint32_t result;
+
+    execution_engine = execution_engine_create(&execution_engine_params_win32);
+    umock_c_reset_all_calls();
+
+    // act
+    result = execution_engine_win32_get_min_thread_count(execution_engine);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 3, result);
+
+    // cleanup
+    execution_engine_dec_ref(execution_engine);
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -4,12 +4,15 @@
 #ifdef __cplusplus
 #include <cstdlib>
 #include <cstddef>
+#include <cstring>
 #else
 #include <stdlib.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include <string.h>
 #endif
 #include "windows.h"
+#include "winioctl.h"
 #include "macro_utils/macro_utils.h"
 
 #include "real_gballoc_ll.h"
@@ -27,6 +30,7 @@ void real_free(void* ptr)
 #include "umock_c/umock_c.h"
 #include "umock_c/umocktypes_windows.h"
 #include "umock_c/umocktypes_bool.h"
+#include "umock_c/umocktypes_stdint.h"
 #include "umock_c/umock_c_negative_tests.h"
 
 
@@ -36,6 +40,12 @@ void real_free(void* ptr)
 #include "c_pal/gballoc_hl.h"
 #include "c_pal/gballoc_hl_redirect.h"
 #include "c_pal/execution_engine_win32.h"
+#include "c_pal/io_context_pool.h"
+#include "c_pal/sync.h"
+#include "c_pal/sysinfo.h"
+#include "c_pal/write_aggregator.h"
+#include "c_pal/read_ahead.h"
+#include "c_pal/io_admission.h"
 #include "mock_file.h"
 
 MOCKABLE_FUNCTION(, void, mock_user_callback, void*, user_context, bool, is_successful);
@@ -56,6 +66,11 @@ IMPLEMENT_UMOCK_C_ENUM_TYPE(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_VALUES)
 TEST_DEFINE_ENUM_TYPE(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_RESULT)
 IMPLEMENT_UMOCK_C_ENUM_TYPE(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_VALUES)
 
+IMPLEMENT_UMOCK_C_ENUM_TYPE(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_RESULT_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(READ_AHEAD_MODE, READ_AHEAD_MODE_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_RESULT_VALUES)
+IMPLEMENT_UMOCK_C_ENUM_TYPE(IO_ADMISSION_RESULT, IO_ADMISSION_RESULT_VALUES)
+
 #define FILE_IO_ASYNC_VALUES \
     FILE_WRITE_ASYNC, \
     FILE_READ_ASYNC
@@ -72,16 +87,183 @@ static PTP_CLEANUP_GROUP fake_ptp_cleanup_group = (PTP_CLEANUP_GROUP)44;
 static PTP_IO fake_ptp_io = (PTP_IO)45;
 static HANDLE fake_h_event = (HANDLE)46;
 static EXECUTION_ENGINE_HANDLE fake_execution_engine = (EXECUTION_ENGINE_HANDLE)47;
+static IO_CONTEXT_POOL_HANDLE test_io_context_pool = (IO_CONTEXT_POOL_HANDLE)48;
+static HANDLE fake_h_mapping = (HANDLE)49;
+static PTP_TIMER fake_ptp_timer = (PTP_TIMER)50;
+static WRITE_AGGREGATOR_HANDLE test_write_aggregator = (WRITE_AGGREGATOR_HANDLE)51;
+static READ_AHEAD_HANDLE test_read_ahead = (READ_AHEAD_HANDLE)52;
+static IO_ADMISSION_HANDLE test_io_admission = (IO_ADMISSION_HANDLE)53;
+static IO_ADMISSION_HANDLE test_engine_io_admission = (IO_ADMISSION_HANDLE)54;
+static unsigned char test_view[4096];
+static LONGLONG test_file_size = 1024 * 1024;
+
+#define TEST_ALLOCATION_GRANULARITY 65536
+#define TEST_PREALLOCATION_CHUNK_SIZE (1024 * 1024)
+
+#define TEST_MAX_OUTSTANDING_IO 16
+
+#define TEST_COPY_CHUNK_SIZE (1024 * 1024)
+#define TEST_COPY_SOURCE_POSITION (16 * 4096)
+#define TEST_COPY_DESTINATION_POSITION (32 * 4096)
+
+#define TEST_MAX_AGGREGATED_SIZE (64 * 1024)
+#define TEST_MAX_DELAY_MS 10
+
+static WRITE_AGGREGATOR_ISSUE_IO captured_issue_io;
+static WRITE_AGGREGATOR_START_TIMER captured_start_timer;
+static void* captured_write_aggregator_context;
+
+static WRITE_AGGREGATOR_HANDLE hook_write_aggregator_create(uint32_t alignment, uint32_t max_aggregated_size, uint32_t max_delay_ms, uint64_t file_size, WRITE_AGGREGATOR_ISSUE_IO issue_io, WRITE_AGGREGATOR_START_TIMER start_timer, WRITE_AGGREGATOR_SET_FILE_SIZE set_file_size, void* context)
+{
+    (void)alignment;
+    (void)max_aggregated_size;
+    (void)max_delay_ms;
+    (void)file_size;
+    (void)set_file_size;
+    captured_issue_io = issue_io;
+    captured_start_timer = start_timer;
+    captured_write_aggregator_context = context;
+    return test_write_aggregator;
+}
+
+#define TEST_READ_AHEAD_BLOCK_SIZE (64 * 1024)
+#define TEST_READ_AHEAD_BLOCK_COUNT 4
+
+static READ_AHEAD_ISSUE_IO captured_read_ahead_issue_io;
+static void* captured_read_ahead_context;
+
+static READ_AHEAD_HANDLE hook_read_ahead_create(uint32_t alignment, uint32_t block_size, uint32_t block_count, READ_AHEAD_ISSUE_IO issue_io, void* context)
+{
+    (void)alignment;
+    (void)block_size;
+    (void)block_count;
+    captured_read_ahead_issue_io = issue_io;
+    captured_read_ahead_context = context;
+    return test_read_ahead;
+}
+
+static int64_t captured_timer_due_time;
+static void hook_mock_SetThreadpoolTimer(PTP_TIMER pti, PFILETIME pftDueTime, DWORD msPeriod, DWORD msWindowLength)
+{
+    (void)pti;
+    (void)msPeriod;
+    (void)msWindowLength;
+    if (pftDueTime != NULL)
+    {
+        ULARGE_INTEGER due_time;
+        due_time.LowPart = pftDueTime->dwLowDateTime;
+        due_time.HighPart = pftDueTime->dwHighDateTime;
+        captured_timer_due_time = (int64_t)due_time.QuadPart;
+    }
+}
+
+/*how much the file grew since file_set_preallocation read its size*/
+static LONGLONG test_file_growth;
+static BOOL hook_mock_GetFileSizeEx(HANDLE hFile, PLARGE_INTEGER lpFileSize)
+{
+    (void)hFile;
+    lpFileSize->QuadPart = test_file_size + test_file_growth;
+    return TRUE;
+}
+
+static LONGLONG captured_allocation_size;
+static PRIORITY_HINT captured_priority_hint;
+static BOOL hook_mock_SetFileInformationByHandle(HANDLE hFile, FILE_INFO_BY_HANDLE_CLASS FileInformationClass, LPVOID lpFileInformation, DWORD dwBufferSize)
+{
+    (void)hFile;
+    (void)dwBufferSize;
+    if (FileInformationClass == FileAllocationInfo)
+    {
+        captured_allocation_size = ((FILE_ALLOCATION_INFO*)lpFileInformation)->AllocationSize.QuadPart;
+    }
+    else if (FileInformationClass == FileIoPriorityHintInfo)
+    {
+        captured_priority_hint = ((FILE_IO_PRIORITY_HINT_INFO*)lpFileInformation)->PriorityHint;
+    }
+    return TRUE;
+}
+
+static DUPLICATE_EXTENTS_DATA captured_duplicate_extents_data;
+static HANDLE captured_duplicate_extents_event;
+static BOOL hook_mock_DeviceIoControl(HANDLE hDevice, DWORD dwIoControlCode, LPVOID lpInBuffer, DWORD nInBufferSize, LPVOID lpOutBuffer, DWORD nOutBufferSize, LPDWORD lpBytesReturned, LPOVERLAPPED lpOverlapped)
+{
+    (void)hDevice;
+    (void)dwIoControlCode;
+    (void)nInBufferSize;
+    (void)lpOutBuffer;
+    (void)nOutBufferSize;
+    (void)lpBytesReturned;
+    captured_duplicate_extents_data = *(DUPLICATE_EXTENTS_DATA*)lpInBuffer;
+    captured_duplicate_extents_event = lpOverlapped->hEvent;
+    return TRUE;
+}
 
-static void setup_file_create_expectations(const char* filename, PTP_CALLBACK_ENVIRON* captured_ptpcbe,  PTP_WIN32_IO_CALLBACK* captured_callback)
+/*the reads and writes of a copy through a buffer: their offsets as waited for, and the number of bytes each of them transfers*/
+#define TEST_MAX_COPY_IO_COUNT 8
+static uint64_t captured_copy_io_offsets[TEST_MAX_COPY_IO_COUNT];
+static HANDLE captured_copy_io_events[TEST_MAX_COPY_IO_COUNT];
+static DWORD test_copy_io_bytes_transferred[TEST_MAX_COPY_IO_COUNT];
+static uint32_t copy_io_count;
+static BOOL hook_mock_GetOverlappedResult(HANDLE hFile, LPOVERLAPPED lpOverlapped, LPDWORD lpNumberOfBytesTransferred, BOOL bWait)
+{
+    (void)hFile;
+    (void)bWait;
+    if (copy_io_count < TEST_MAX_COPY_IO_COUNT)
+    {
+        captured_copy_io_offsets[copy_io_count] = ((uint64_t)lpOverlapped->OffsetHigh << 32) | lpOverlapped->Offset;
+        captured_copy_io_events[copy_io_count] = lpOverlapped->hEvent;
+        *lpNumberOfBytesTransferred = test_copy_io_bytes_transferred[copy_io_count];
+        copy_io_count++;
+    }
+    return TRUE;
+}
+
+/*runs the preallocation "on the threadpool" while the code under test waits for it*/
+static PTP_SIMPLE_CALLBACK preallocate_callback_to_run_on_wait;
+static PVOID preallocate_context_to_run_on_wait;
+static bool hook_wait_on_address(volatile_atomic int32_t* address, int32_t compare_value, uint32_t timeout_ms)
+{
+    (void)address;
+    (void)compare_value;
+    (void)timeout_ms;
+    if (preallocate_callback_to_run_on_wait != NULL)
+    {
+        PTP_SIMPLE_CALLBACK callback = preallocate_callback_to_run_on_wait;
+        preallocate_callback_to_run_on_wait = NULL;
+        callback(NULL, preallocate_context_to_run_on_wait);
+    }
+    return true;
+}
+
+static void hook_mock_GetSystemInfo(LPSYSTEM_INFO lpSystemInfo)
+{
+    (void)memset(lpSystemInfo, 0, sizeof(SYSTEM_INFO));
+    lpSystemInfo->dwAllocationGranularity = TEST_ALLOCATION_GRANULARITY;
+}
+
+static void* hook_io_context_pool_get(IO_CONTEXT_POOL_HANDLE pool, size_t size)
+{
+    (void)pool;
+    return real_malloc(size);
+}
+
+static void hook_io_context_pool_release(IO_CONTEXT_POOL_HANDLE pool, void* context)
+{
+    (void)pool;
+    real_free(context);
+}
+
+static void setup_file_create_expectations_with_engine_io_admission(const char* filename, PTP_CALLBACK_ENVIRON* captured_ptpcbe, PTP_WIN32_IO_CALLBACK* captured_callback, IO_ADMISSION_HANDLE engine_io_admission)
 {
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
     STRICT_EXPECTED_CALL(execution_engine_inc_ref(fake_execution_engine));
+    STRICT_EXPECTED_CALL(io_context_pool_create(IGNORED_ARG, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mock_CreateFileA(filename, GENERIC_READ|GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_FLAG_OVERLAPPED|FILE_FLAG_WRITE_THROUGH, NULL));
     STRICT_EXPECTED_CALL(mock_SetFileCompletionNotificationModes(fake_handle, FILE_SKIP_COMPLETION_PORT_ON_SUCCESS));
     STRICT_EXPECTED_CALL(mock_InitializeThreadpoolEnvironment(IGNORED_ARG))
         .CaptureArgumentValue_pcbe(captured_ptpcbe);
-    STRICT_EXPECTED_CALL(execution_engine_win32_get_threadpool(fake_execution_engine))
+    STRICT_EXPECTED_CALL(sysinfo_get_current_numa_node());
+    STRICT_EXPECTED_CALL(execution_engine_win32_get_numa_node_threadpool(fake_execution_engine, 0))
         .CallCannotFail();
     STRICT_EXPECTED_CALL(mock_SetThreadpoolCallbackPool(IGNORED_ARG, fake_ptp_pool))
         .ValidateArgumentValue_pcbe(captured_ptpcbe);
@@ -91,12 +273,20 @@ static void setup_file_create_expectations(const char* filename, PTP_CALLBACK_EN
     STRICT_EXPECTED_CALL(mock_CreateThreadpoolIo(fake_handle, IGNORED_ARG, NULL, IGNORED_ARG))
         .ValidateArgumentValue_pcbe(captured_ptpcbe)
         .CaptureArgumentValue_pfnio(captured_callback);
+    STRICT_EXPECTED_CALL(execution_engine_win32_get_io_admission(fake_execution_engine))
+        .SetReturn(engine_io_admission)
+        .CallCannotFail();
 }
 
-static FILE_HANDLE get_file_handle_and_callback(const char* filename, PTP_WIN32_IO_CALLBACK* captured_callback)
+static void setup_file_create_expectations(const char* filename, PTP_CALLBACK_ENVIRON* captured_ptpcbe, PTP_WIN32_IO_CALLBACK* captured_callback)
+{
+    setup_file_create_expectations_with_engine_io_admission(filename, captured_ptpcbe, captured_callback, NULL);
+}
+
+static FILE_HANDLE get_file_handle_with_engine_io_admission(const char* filename, PTP_WIN32_IO_CALLBACK* captured_callback, IO_ADMISSION_HANDLE engine_io_admission)
 {
     PTP_CALLBACK_ENVIRON captured_ptpcbe;
-    setup_file_create_expectations(filename, &captured_ptpcbe, captured_callback);
+    setup_file_create_expectations_with_engine_io_admission(filename, &captured_ptpcbe, captured_callback, engine_io_admission);
 
     FILE_HANDLE file_handle = file_create(fake_execution_engine, filename, NULL, NULL);
 
@@ -106,19 +296,193 @@ static FILE_HANDLE get_file_handle_and_callback(const char* filename, PTP_WIN32_
     umock_c_reset_all_calls();
     return file_handle;
 }
+
+static FILE_HANDLE get_file_handle_and_callback(const char* filename, PTP_WIN32_IO_CALLBACK* captured_callback)
+{
+    return get_file_handle_with_engine_io_admission(filename, captured_callback, NULL);
+}
+
 static FILE_HANDLE get_file_handle(const char* filename)
 {
     PTP_WIN32_IO_CALLBACK captured_callback = NULL;
     return get_file_handle_and_callback(filename, &captured_callback);
 }
 
+static PTP_SIMPLE_CALLBACK start_file_flush_async(FILE_HANDLE file_handle, void* user_context)
+{
+    PTP_SIMPLE_CALLBACK captured_flush_callback = NULL;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, file_handle, IGNORED_ARG))
+        .CaptureArgumentValue_pfns(&captured_flush_callback);
+
+    ASSERT_ARE_EQUAL(int, 0, file_flush_async(file_handle, mock_user_callback, user_context));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_flush_callback);
+
+    umock_c_reset_all_calls();
+    return captured_flush_callback;
+}
+
+static PTP_SIMPLE_CALLBACK start_file_copy_range_async(FILE_HANDLE source, FILE_HANDLE destination, uint64_t size, PVOID* captured_copy_context)
+{
+    PTP_SIMPLE_CALLBACK captured_copy_callback = NULL;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CaptureArgumentValue_pfns(&captured_copy_callback)
+        .CaptureArgumentValue_pv(captured_copy_context);
+
+    ASSERT_ARE_EQUAL(int, 0, file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, size, mock_user_callback, (void*)0x4245));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_copy_callback);
+
+    umock_c_reset_all_calls();
+    return captured_copy_callback;
+}
+
+static FILE_HANDLE get_file_handle_with_preallocation(const char* filename, PTP_WIN32_IO_CALLBACK* captured_callback)
+{
+    FILE_HANDLE file_handle = get_file_handle_and_callback(filename, captured_callback);
+
+    STRICT_EXPECTED_CALL(mock_GetFileSizeEx(fake_handle, IGNORED_ARG));
+
+    ASSERT_ARE_EQUAL(int, 0, file_set_preallocation(file_handle, TEST_PREALLOCATION_CHUNK_SIZE));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+    return file_handle;
+}
+
+static PTP_SIMPLE_CALLBACK start_write_that_preallocates(FILE_HANDLE file_handle, unsigned char* source, uint32_t size, uint64_t position, LPOVERLAPPED* captured_ov)
+{
+    PTP_SIMPLE_CALLBACK captured_preallocate_callback = NULL;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, size, NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, file_handle, IGNORED_ARG))
+        .CaptureArgumentValue_pfns(&captured_preallocate_callback);
+
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, size, position, mock_user_callback, NULL));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_preallocate_callback);
+
+    umock_c_reset_all_calls();
+    return captured_preallocate_callback;
+}
+
+static FILE_HANDLE get_file_handle_with_write_aggregation(const char* filename, PTP_WIN32_IO_CALLBACK* captured_callback, PTP_TIMER_CALLBACK* captured_timer_callback)
+{
+    FILE_HANDLE file_handle = get_file_handle_and_callback(filename, captured_callback);
+
+    STRICT_EXPECTED_CALL(mock_CreateThreadpoolTimer(IGNORED_ARG, file_handle, IGNORED_ARG))
+        .CaptureArgumentValue_pfnti(captured_timer_callback);
+    STRICT_EXPECTED_CALL(write_aggregator_create(1, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, 0, IGNORED_ARG, IGNORED_ARG, NULL, file_handle));
+
+    ASSERT_ARE_EQUAL(int, 0, file_set_write_aggregation(file_handle, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+    return file_handle;
+}
+
+static void start_aggregated_write(WRITE_AGGREGATOR_IO* aggregated_io, LPOVERLAPPED* captured_ov)
+{
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, aggregated_io->buffer, aggregated_io->size, NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ASSERT_ARE_EQUAL(int, 0, captured_issue_io(captured_write_aggregator_context, aggregated_io));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+}
+
+static FILE_HANDLE get_file_handle_with_io_limit(const char* filename, PTP_WIN32_IO_CALLBACK* captured_callback, IO_ADMISSION_HANDLE engine_io_admission, uint32_t max_outstanding_io, FILE_IO_LIMIT_MODE mode)
+{
+    FILE_HANDLE file_handle = get_file_handle_with_engine_io_admission(filename, captured_callback, engine_io_admission);
+
+    if (max_outstanding_io != 0)
+    {
+        STRICT_EXPECTED_CALL(io_admission_create(max_outstanding_io));
+    }
+
+    ASSERT_ARE_EQUAL(int, 0, file_set_io_limit(file_handle, max_outstanding_io, mode));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+    return file_handle;
+}
+
+static void set_io_limit(FILE_HANDLE file_handle, FILE_IO_LIMIT_MODE mode)
+{
+    STRICT_EXPECTED_CALL(io_admission_create(TEST_MAX_OUTSTANDING_IO));
+
+    ASSERT_ARE_EQUAL(int, 0, file_set_io_limit(file_handle, TEST_MAX_OUTSTANDING_IO, mode));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+}
+
+static FILE_HANDLE get_file_handle_with_read_ahead(const char* filename, PTP_WIN32_IO_CALLBACK* captured_callback)
+{
+    FILE_HANDLE file_handle = get_file_handle_and_callback(filename, captured_callback);
+
+    STRICT_EXPECTED_CALL(read_ahead_create(1, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT, IGNORED_ARG, file_handle));
+
+    ASSERT_ARE_EQUAL(int, 0, file_set_read_ahead(file_handle, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+    return file_handle;
+}
+
+static void start_read_ahead(READ_AHEAD_IO* read_ahead_io, LPOVERLAPPED* captured_ov)
+{
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, read_ahead_io->buffer, read_ahead_io->size, IGNORED_ARG, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ASSERT_ARE_EQUAL(int, 0, captured_read_ahead_issue_io(captured_read_ahead_context, read_ahead_io));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+}
+
+static FILE_BATCH_HANDLE get_batch(FILE_HANDLE file_handle, uint32_t max_io_count)
+{
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    FILE_BATCH_HANDLE batch = file_batch_begin(file_handle, max_io_count);
+
+    ASSERT_IS_NOT_NULL(batch);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    umock_c_reset_all_calls();
+    return batch;
+}
+
 
 
 static FILE_HANDLE start_file_io_async(FILE_IO_ASYNC_TYPE type, unsigned char* buffer, uint32_t size, uint64_t position, FILE_CB user_callback, void* user_context, PTP_WIN32_IO_CALLBACK* captured_callback, LPOVERLAPPED* captured_ov)
 {
     FILE_HANDLE file_handle = get_file_handle_and_callback("test_file.txt", captured_callback);
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
     if(type == FILE_WRITE_ASYNC)
@@ -165,26 +529,87 @@ TEST_SUITE_INITIALIZE(suite_init)
     ASSERT_ARE_EQUAL(int, 0, umock_c_init(on_umock_c_error));
     ASSERT_ARE_EQUAL(int, 0, umocktypes_windows_register_types());
     ASSERT_ARE_EQUAL(int, 0, umocktypes_bool_register_types());
+    ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types());
 
     REGISTER_GLOBAL_MOCK_HOOK(malloc, real_malloc);
     REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
+    REGISTER_GLOBAL_MOCK_HOOK(io_context_pool_get, hook_io_context_pool_get);
+    REGISTER_GLOBAL_MOCK_HOOK(io_context_pool_release, hook_io_context_pool_release);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_GetFileSizeEx, hook_mock_GetFileSizeEx);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_GetSystemInfo, hook_mock_GetSystemInfo);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_SetFileInformationByHandle, hook_mock_SetFileInformationByHandle);
+    REGISTER_GLOBAL_MOCK_HOOK(wait_on_address, hook_wait_on_address);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_SetThreadpoolTimer, hook_mock_SetThreadpoolTimer);
+    REGISTER_GLOBAL_MOCK_HOOK(write_aggregator_create, hook_write_aggregator_create);
+    REGISTER_GLOBAL_MOCK_HOOK(read_ahead_create, hook_read_ahead_create);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_DeviceIoControl, hook_mock_DeviceIoControl);
+    REGISTER_GLOBAL_MOCK_HOOK(mock_GetOverlappedResult, hook_mock_GetOverlappedResult);
 
     REGISTER_UMOCK_ALIAS_TYPE(PTP_IO, void*);
     REGISTER_UMOCK_ALIAS_TYPE(PTP_CALLBACK_ENVIRON, void*);
     REGISTER_UMOCK_ALIAS_TYPE(EXECUTION_ENGINE_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(PTP_POOL, void*);
     REGISTER_UMOCK_ALIAS_TYPE(PTP_CLEANUP_GROUP, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_CONTEXT_POOL_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_CONTEXT_POOL_STATISTICS*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PTP_SIMPLE_CALLBACK, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PLARGE_INTEGER, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(LPSYSTEM_INFO, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PWIN32_MEMORY_RANGE_ENTRY, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(SIZE_T, size_t);
+    REGISTER_UMOCK_ALIAS_TYPE(ULONG_PTR, size_t);
+    REGISTER_UMOCK_ALIAS_TYPE(ULONG, uint32_t);
+    REGISTER_UMOCK_ALIAS_TYPE(FILE_INFO_BY_HANDLE_CLASS, int);
+    REGISTER_UMOCK_ALIAS_TYPE(PTP_TIMER, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PTP_TIMER_CALLBACK, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PFILETIME, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(WRITE_AGGREGATOR_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(WRITE_AGGREGATOR_IO*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(WRITE_AGGREGATOR_ISSUE_IO, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(WRITE_AGGREGATOR_START_TIMER, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(WRITE_AGGREGATOR_SET_FILE_SIZE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(WRITE_AGGREGATOR_WRITE_CB, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(READ_AHEAD_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(READ_AHEAD_IO*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(READ_AHEAD_ISSUE_IO, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(READ_AHEAD_READ_CB, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_ADMISSION_HANDLE, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_ADMISSION_WAITER*, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(IO_ADMISSION_STATISTICS*, void*);
 
     REGISTER_TYPE(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_RESULT);
     REGISTER_TYPE(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_RESULT);
+    REGISTER_TYPE(WRITE_AGGREGATOR_ADD_RESULT, WRITE_AGGREGATOR_ADD_RESULT);
+    REGISTER_TYPE(READ_AHEAD_MODE, READ_AHEAD_MODE);
+    REGISTER_TYPE(READ_AHEAD_READ_RESULT, READ_AHEAD_READ_RESULT);
+    REGISTER_TYPE(IO_ADMISSION_RESULT, IO_ADMISSION_RESULT);
 
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
     REGISTER_GLOBAL_MOCK_RETURNS(mock_CreateFileA, fake_handle, INVALID_HANDLE_VALUE);
     REGISTER_GLOBAL_MOCK_RETURNS(mock_SetFileCompletionNotificationModes, TRUE, FALSE);
     REGISTER_GLOBAL_MOCK_RETURNS(execution_engine_win32_get_threadpool, fake_ptp_pool, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(execution_engine_win32_get_numa_node_threadpool, fake_ptp_pool, NULL);
+    REGISTER_GLOBAL_MOCK_RETURN(sysinfo_get_current_numa_node, 0);
     REGISTER_GLOBAL_MOCK_RETURNS(mock_CreateThreadpoolCleanupGroup, fake_ptp_cleanup_group, NULL);
     REGISTER_GLOBAL_MOCK_RETURNS(mock_CreateThreadpoolIo, fake_ptp_io, NULL);
     REGISTER_GLOBAL_MOCK_RETURNS(mock_CreateEvent, fake_h_event, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(io_context_pool_create, test_io_context_pool, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(io_context_pool_get, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(io_context_pool_get_statistics, 0, MU_FAILURE);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_TrySubmitThreadpoolCallback, TRUE, FALSE);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_FlushFileBuffers, TRUE, FALSE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mock_GetFileSizeEx, FALSE);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_CreateFileMappingA, fake_h_mapping, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_MapViewOfFile, test_view, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_PrefetchVirtualMemory, TRUE, FALSE);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_UnmapViewOfFile, TRUE, FALSE);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_SetFileInformationByHandle, TRUE, FALSE);
+    REGISTER_GLOBAL_MOCK_RETURNS(mock_CreateThreadpoolTimer, fake_ptp_timer, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(write_aggregator_create, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(read_ahead_create, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(io_admission_create, test_io_admission, NULL);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mock_DeviceIoControl, FALSE);
+    REGISTER_GLOBAL_MOCK_FAIL_RETURN(mock_GetOverlappedResult, FALSE);
 }
 
 TEST_SUITE_CLEANUP(TestClassCleanup)
@@ -205,6 +630,10 @@ TEST_FUNCTION_INITIALIZE(f)
 
     umock_c_reset_all_calls();
     umock_c_negative_tests_init();
+
+    copy_io_count = 0;
+    (void)memset(test_copy_io_bytes_transferred, 0, sizeof(test_copy_io_bytes_transferred));
+    test_file_growth = 0;
 }
 
 TEST_FUNCTION_CLEANUP(cleans)
@@ -254,15 +683,20 @@ TEST_FUNCTION(file_create_fails_on_empty_full_file_name)
 
 /*Tests_SRS_FILE_WIN32_43_041: [ file_create shall allocate a FILE_HANDLE. ]*/
 /*Tests_SRS_FILE_WIN32_01_001: [ file_create shall increment the reference count of execution_engine in order to hold on to it. ]*/
+/*Tests_SRS_FILE_WIN32_01_031: [ file_create shall create a pool of I/O contexts by calling io_context_pool_create with a context size that fits a vectored operation with up to FILE_WIN32_POOLED_BUFFER_COUNT buffers and FILE_WIN32_IO_CONTEXT_POOL_SIZE as the maximum number of cached contexts. ]*/
 /*Tests_SRS_FILE_WIN32_43_001: [ file_create shall call CreateFileA with full_file_name as lpFileName, GENERIC_READ|GENERIC_WRITE as dwDesiredAccess, FILE_SHARED_READ as dwShareMode, NULL as lpSecurityAttributes, OPEN_ALWAYS as dwCreationDisposition, FILE_FLAG_OVERLAPPED|FILE_FLAG_WRITE_THROUGH as dwFlagsAndAttributes and NULL as hTemplateFile. ]*/
 /*Tests_SRS_FILE_WIN32_43_002: [ file_create shall call SetFileCompletionNotificationModes to disable calling the completion port when an async operations finishes synchrounously. ]*/
 /*Tests_SRS_FILE_WIN32_43_003: [ file_create shall initialize a threadpool environment by calling InitializeThreadpolEnvironment. ]*/
-/*Tests_SRS_FILE_WIN32_43_004: [ file_create shall obtain a PTP_POOL struct by calling execution_engine_win32_get_threadpool on execution_engine. ]*/
+/*Tests_SRS_FILE_WIN32_43_004: [ file_create shall obtain the PTP_POOL of the NUMA node of the calling thread by calling sysinfo_get_current_numa_node and execution_engine_win32_get_numa_node_threadpool on execution_engine. ]*/
 /*Tests_SRS_FILE_WIN32_43_005: [ file_create shall register the threadpool environment by calling SetThreadpoolCallbackPool on the initialized threadpool environment and the obtained ptp_pool ]*/
 /*Tests_SRS_FILE_WIN32_43_006: [ file_create shall create a cleanup group by calling CreateThreadpoolCleanupGroup. ]*/
 /*Tests_SRS_FILE_WIN32_43_007: [ file_create shall register the cleanup group with the threadpool environment by calling SetThreadpoolCallbackCleanupGroup. ]*/
 /*Tests_SRS_FILE_WIN32_43_033: [ file_create shall create a threadpool io with the allocated FILE_HANDLE and on_file_io_complete_win32 as a callback by calling CreateThreadpoolIo ]*/
 /*Tests_SRS_FILE_WIN32_43_009: [ file_create shall succeed and return a non-NULL value. ]*/
+/*Tests_SRS_FILE_WIN32_01_037: [ file_create shall initialize the list of flush requests as empty, mark the flush as not in progress, set the number of pending flushes to 0 and initialize the flush context with the file handle. ]*/
+/*Tests_SRS_FILE_WIN32_01_073: [ file_create shall set no preallocation policy on the file handle and mark the preallocation as not in progress. ]*/
+/*Tests_SRS_FILE_WIN32_01_182: [ file_create shall obtain the I/O limit of the execution engine by calling execution_engine_win32_get_io_admission, set no I/O limit on the file handle, with the mode FILE_IO_LIMIT_MODE_QUEUE, and set the number of queued I/Os to 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_191: [ file_create shall set the admission priority of the file handle to IO_ADMISSION_PRIORITY_NORMAL. ]*/
 TEST_FUNCTION(file_create_succeeds)
 {
     ///arrange
@@ -282,6 +716,43 @@ TEST_FUNCTION(file_create_succeeds)
     file_destroy(file_handle);
 }
 
+/*Tests_SRS_FILE_WIN32_43_069: [ If execution_engine_win32_get_numa_node_threadpool fails, file_create shall obtain the PTP_POOL by calling execution_engine_win32_get_threadpool on execution_engine. ]*/
+TEST_FUNCTION(when_getting_the_numa_node_threadpool_fails_file_create_uses_the_execution_engine_threadpool)
+{
+    ///arrange
+    PTP_CALLBACK_ENVIRON captured_ptpcbe;
+    char* filename = "file_create_succeeds.txt";
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(execution_engine_inc_ref(fake_execution_engine));
+    STRICT_EXPECTED_CALL(io_context_pool_create(IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateFileA(filename, GENERIC_READ|GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_FLAG_OVERLAPPED|FILE_FLAG_WRITE_THROUGH, NULL));
+    STRICT_EXPECTED_CALL(mock_SetFileCompletionNotificationModes(fake_handle, FILE_SKIP_COMPLETION_PORT_ON_SUCCESS));
+    STRICT_EXPECTED_CALL(mock_InitializeThreadpoolEnvironment(IGNORED_ARG))
+        .CaptureArgumentValue_pcbe(&captured_ptpcbe);
+    STRICT_EXPECTED_CALL(sysinfo_get_current_numa_node())
+        .SetReturn(1);
+    STRICT_EXPECTED_CALL(execution_engine_win32_get_numa_node_threadpool(fake_execution_engine, 1))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(execution_engine_win32_get_threadpool(fake_execution_engine));
+    STRICT_EXPECTED_CALL(mock_SetThreadpoolCallbackPool(IGNORED_ARG, fake_ptp_pool))
+        .ValidateArgumentValue_pcbe(&captured_ptpcbe);
+    STRICT_EXPECTED_CALL(mock_CreateThreadpoolCleanupGroup());
+    STRICT_EXPECTED_CALL(mock_SetThreadpoolCallbackCleanupGroup(IGNORED_ARG, fake_ptp_cleanup_group, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateThreadpoolIo(fake_handle, IGNORED_ARG, NULL, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(execution_engine_win32_get_io_admission(fake_execution_engine));
+
+    ///act
+    FILE_HANDLE file_handle = file_create(fake_execution_engine, filename, NULL, NULL);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(file_handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
 /*Tests_SRS_FILE_43_034: [ If there are any failures, file_create shall fail and return NULL. ]*/
 /*Tests_SRS_FILE_WIN32_43_008: [ If there are any failures, file_create shall return NULL. ]*/
 TEST_FUNCTION(file_create_fails)
@@ -328,8 +799,10 @@ TEST_FUNCTION(file_destroy_called_with_null_handle)
 /*Tests_SRS_FILE_WIN32_43_013: [ file_destroy shall destroy the environment by calling DestroyThreadpoolEnvironment.]*/
 /*Tests_SRS_FILE_WIN32_43_016: [ file_destroy shall call CloseHandle on the handle returned by CreateFileA. ]*/
 /*Tests_SRS_FILE_WIN32_43_015: [ file_destroy shall close the threadpool IO by calling CloseThreadPoolIo.]*/
+/*Tests_SRS_FILE_WIN32_01_032: [ file_destroy shall destroy the I/O context pool. ]*/
 /*Tests_SRS_FILE_WIN32_01_002: [ file_destroy shall decrement the reference count for the execution engine. ]*/
 /*Tests_SRS_FILE_WIN32_43_042: [ file_destroy shall free the handle.]*/
+/*Tests_SRS_FILE_WIN32_01_038: [ file_destroy shall wait for the number of pending flushes to reach 0 by calling wait_on_address. ]*/
 TEST_FUNCTION(file_destroy_succeeds)
 {
 
@@ -349,6 +822,7 @@ TEST_FUNCTION(file_destroy_succeeds)
     STRICT_EXPECTED_CALL(mock_DestroyThreadpoolEnvironment(captured_ptpcbe));
     STRICT_EXPECTED_CALL(mock_CloseHandle(fake_handle));
     STRICT_EXPECTED_CALL(mock_CloseThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_destroy(test_io_context_pool));
     STRICT_EXPECTED_CALL(execution_engine_dec_ref(fake_execution_engine));
     STRICT_EXPECTED_CALL(free(file_handle));
 
@@ -452,9 +926,13 @@ TEST_FUNCTION(file_write_async_fails_if_size_is_zero)
 /*Tests_SRS_FILE_WIN32_43_017: [ file_write_async shall call StartThreadpoolIo.]*/
 /*Tests_SRS_FILE_WIN32_43_054: [ file_write_async shall create an event by calling CreateEvent.]*/
 /*Tests_SRS_FILE_WIN32_43_020: [ file_write_async shall allocate an OVERLAPPED struct and populate it with the created event and position.]*/
-/*Tests_SRS_FILE_WIN32_43_018: [ file_write_async shall allocate a context to store the allocated OVERLAPPED struct, handle, size, user_callback and user_context. ]*/
+/*Tests_SRS_FILE_WIN32_43_018: [ file_write_async shall get a context to store the allocated OVERLAPPED struct, handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
 /*Tests_SRS_FILE_WIN32_43_021: [ file_write_async shall call WriteFile with handle, source, size and the allocated OVERLAPPED struct.]*/
 /*Tests_SRS_FILE_WIN32_43_022: [ If WriteFile fails synchronously and GetLastError indicates ERROR_IO_PENDING then file_write_async shall succeed and return FILE_WRITE_ASYNC_OK.]*/
+/*Tests_SRS_FILE_WIN32_01_075: [ If no preallocation policy is set on handle, record_write_end shall return. ]*/
+/*Tests_SRS_FILE_WIN32_01_078: [ If no preallocation policy is set on handle, preallocate_ahead_if_needed shall return. ]*/
+/*Tests_SRS_FILE_WIN32_01_097: [ file_create shall set no write aggregation policy on the file handle. ]*/
+/*Tests_SRS_FILE_WIN32_01_104: [ If no write aggregation policy is set or write_aggregator_add returns WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, file_write_async shall issue the write by itself. ]*/
 TEST_FUNCTION(file_write_async_succeeds_asynchronously)
 {
     ///arrange
@@ -465,7 +943,7 @@ TEST_FUNCTION(file_write_async_succeeds_asynchronously)
     uint32_t size = 10;
     uint64_t position = 5;
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
     STRICT_EXPECTED_CALL(mock_WriteFile(IGNORED_ARG, source, size, NULL, IGNORED_ARG))
@@ -490,7 +968,7 @@ TEST_FUNCTION(file_write_async_succeeds_asynchronously)
 /*Tests_SRS_FILE_WIN32_43_017: [ file_write_async shall call StartThreadpoolIo.]*/
 /*Tests_SRS_FILE_WIN32_43_054: [ file_write_async shall create an event by calling CreateEvent.]*/
 /*Tests_SRS_FILE_WIN32_43_020: [ file_write_async shall allocate an OVERLAPPED struct and populate it with the created event and position.]*/
-/*Tests_SRS_FILE_WIN32_43_018: [ file_write_async shall allocate a context to store the allocated OVERLAPPED struct, handle, size, user_callback and user_context. ]*/
+/*Tests_SRS_FILE_WIN32_43_018: [ file_write_async shall get a context to store the allocated OVERLAPPED struct, handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
 /*Tests_SRS_FILE_WIN32_43_021: [ file_write_async shall call WriteFile with handle, source, size and the allocated OVERLAPPED struct.]*/
 /*Tests_SRS_FILE_WIN32_43_023: [ If WriteFile fails synchronously and GetLastError does not indicate ERROR_IO_PENDING then file_write_async shall fail, call CancelThreadpoolIo and return FILE_WRITE_ASYNC_WRITE_ERROR. ]*/
 TEST_FUNCTION(file_write_async_fails_synchronously)
@@ -502,7 +980,7 @@ TEST_FUNCTION(file_write_async_fails_synchronously)
     uint64_t position = 5;
     void* io;
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
         .CaptureReturn(&io);
     STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
@@ -512,7 +990,7 @@ TEST_FUNCTION(file_write_async_fails_synchronously)
         .SetReturn(ERROR_IO_INCOMPLETE);
     STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
     STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG))
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG))
         .ValidateArgumentValue_ptr(&io);
     ///act
     FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, size, position, mock_user_callback, NULL);
@@ -528,7 +1006,7 @@ TEST_FUNCTION(file_write_async_fails_synchronously)
 /*Tests_SRS_FILE_WIN32_43_017: [ file_write_async shall call StartThreadpoolIo.]*/
 /*Tests_SRS_FILE_WIN32_43_054: [ file_write_async shall create an event by calling CreateEvent.]*/
 /*Tests_SRS_FILE_WIN32_43_020: [ file_write_async shall allocate an OVERLAPPED struct and populate it with the created event and position.]*/
-/*Tests_SRS_FILE_WIN32_43_018: [ file_write_async shall allocate a context to store the allocated OVERLAPPED struct, handle, size, user_callback and user_context. ]*/
+/*Tests_SRS_FILE_WIN32_43_018: [ file_write_async shall get a context to store the allocated OVERLAPPED struct, handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
 /*Tests_SRS_FILE_WIN32_43_021: [ file_write_async shall call WriteFile with handle, source, size and the allocated OVERLAPPED struct.]*/
 /*Tests_SRS_FILE_WIN32_43_024: [ If WriteFile succeeds synchronously then file_write_async shall succeed, call CancelThreadpoolIo, call user_callback and return FILE_WRITE_ASYNC_OK. ]*/
 TEST_FUNCTION(file_write_async_succeeds_synchronously)
@@ -541,7 +1019,7 @@ TEST_FUNCTION(file_write_async_succeeds_synchronously)
     void* user_context = (void*)45;
     void* io;
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
         .CaptureReturn(&io);
     STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
@@ -550,7 +1028,7 @@ TEST_FUNCTION(file_write_async_succeeds_synchronously)
     STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
     STRICT_EXPECTED_CALL(mock_user_callback(user_context, true));
     STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG))
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG))
         .ValidateArgumentValue_ptr(&io);
     
     ///act
@@ -575,7 +1053,7 @@ TEST_FUNCTION(file_write_async_fails)
     uint64_t position = 5;
     void* io;
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
         .CaptureReturn(&io);
     STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
@@ -588,7 +1066,7 @@ TEST_FUNCTION(file_write_async_fails)
     STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
     STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event))
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG))
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG))
         .ValidateArgumentValue_ptr(&io);
 
     umock_c_negative_tests_snapshot();
@@ -684,7 +1162,7 @@ TEST_FUNCTION(file_read_async_fails_if_size_is_zero)
 /*Tests_SRS_FILE_WIN32_43_025: [ file_read_async shall call StartThreadpoolIo.]*/
 /*Tests_SRS_FILE_WIN32_43_055: [ file_read_async shall create an event by calling CreateEvent.]*/
 /*Tests_SRS_FILE_WIN32_43_028: [ file_read_async shall allocate an OVERLAPPED struct and populate it with the created event and position.]*/
-/*Tests_SRS_FILE_WIN32_43_026: [ file_read_async shall allocate a context to store the allocated OVERLAPPED struct, destination, handle, size, user_callback and user_context ]*/
+/*Tests_SRS_FILE_WIN32_43_026: [ file_read_async shall get a context to store the allocated OVERLAPPED struct, destination, handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
 /*Tests_SRS_FILE_WIN32_43_029: [ file_read_async shall call ReadFile with handle, destination, size and the allocated OVERLAPPED struct.]*/
 /*Tests_SRS_FILE_WIN32_43_030: [ If ReadFile fails synchronously and GetLastError indicates ERROR_IO_PENDING then file_read_async shall succeed and return FILE_READ_ASYNC_OK.]*/
 TEST_FUNCTION(file_read_async_succeeds_asynchronously)
@@ -697,7 +1175,7 @@ TEST_FUNCTION(file_read_async_succeeds_asynchronously)
     unsigned char destination[10];
     uint64_t position = 5;
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
     STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, destination, sizeof(destination), NULL, IGNORED_ARG))
@@ -722,7 +1200,7 @@ TEST_FUNCTION(file_read_async_succeeds_asynchronously)
 /*Tests_SRS_FILE_WIN32_43_025: [ file_read_async shall call StartThreadpoolIo.]*/
 /*Tests_SRS_FILE_WIN32_43_055: [ file_read_async shall create an event by calling CreateEvent.]*/
 /*Tests_SRS_FILE_WIN32_43_028: [ file_read_async shall allocate an OVERLAPPED struct and populate it with the created event and position.]*/
-/*Tests_SRS_FILE_WIN32_43_026: [ file_read_async shall allocate a context to store the allocated OVERLAPPED struct, destination, handle, size, user_callback and user_context ]*/
+/*Tests_SRS_FILE_WIN32_43_026: [ file_read_async shall get a context to store the allocated OVERLAPPED struct, destination, handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
 /*Tests_SRS_FILE_WIN32_43_029: [ file_read_async shall call ReadFile with handle, destination, size and the allocated OVERLAPPED struct.]*/
 /*Tests_SRS_FILE_WIN32_43_031: [ If ReadFile fails synchronously and GetLastError does not indicate ERROR_IO_PENDING then file_read_async shall fail, call CancelThreadpoolIo and return FILE_READ_ASYNC_READ_ERROR. ]*/
 TEST_FUNCTION(file_read_async_fails_synchronously)
@@ -733,7 +1211,7 @@ TEST_FUNCTION(file_read_async_fails_synchronously)
     uint64_t position = 5;
     void* io;
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
         .CaptureReturn(&io);
     STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
@@ -743,7 +1221,7 @@ TEST_FUNCTION(file_read_async_fails_synchronously)
         .SetReturn(ERROR_IO_INCOMPLETE);
     STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
     STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG))
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG))
         .ValidateArgumentValue_ptr(&io);
 
     ///act
@@ -760,7 +1238,7 @@ TEST_FUNCTION(file_read_async_fails_synchronously)
 /*Tests_SRS_FILE_WIN32_43_025: [ file_read_async shall call StartThreadpoolIo.]*/
 /*Tests_SRS_FILE_WIN32_43_055: [ file_read_async shall create an event by calling CreateEvent.]*/
 /*Tests_SRS_FILE_WIN32_43_028: [ file_read_async shall allocate an OVERLAPPED struct and populate it with the created event and position.]*/
-/*Tests_SRS_FILE_WIN32_43_026: [ file_read_async shall allocate a context to store the allocated OVERLAPPED struct, destination, handle, size, user_callback and user_context ]*/
+/*Tests_SRS_FILE_WIN32_43_026: [ file_read_async shall get a context to store the allocated OVERLAPPED struct, destination, handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
 /*Tests_SRS_FILE_WIN32_43_029: [ file_read_async shall call ReadFile with handle, destination, size and the allocated OVERLAPPED struct.]*/
 /*Tests_SRS_FILE_WIN32_43_032: [ If ReadFile succeeds synchronously then file_read_async shall succeed, call CancelThreadpoolIo, call user_callback and return FILE_READ_ASYNC_OK. ]*/
 TEST_FUNCTION(file_read_async_succeeds_synchronously)
@@ -772,7 +1250,7 @@ TEST_FUNCTION(file_read_async_succeeds_synchronously)
     void* user_context = (void*)45;
     void* io;
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
         .CaptureReturn(&io);
     STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
@@ -781,7 +1259,7 @@ TEST_FUNCTION(file_read_async_succeeds_synchronously)
     STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
     STRICT_EXPECTED_CALL(mock_user_callback(user_context, true));
     STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG))
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG))
         .ValidateArgumentValue_ptr(&io);
 
     ///act
@@ -805,7 +1283,7 @@ TEST_FUNCTION(file_read_async_fails)
     uint64_t position = 5;
     void* io;
 
-    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
         .CaptureReturn(&io);
     STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
     STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
@@ -818,7 +1296,7 @@ TEST_FUNCTION(file_read_async_fails)
     STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
     STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event))
         .CallCannotFail();
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG))
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG))
         .ValidateArgumentValue_ptr(&io);
 
     umock_c_negative_tests_snapshot();
@@ -856,173 +1334,6573 @@ TEST_FUNCTION(file_extend_returns_zero)
     file_destroy(file_handle);
 }
 
-/*Tests_SRS_FILE_WIN32_43_034: [ on_file_io_complete_win32 shall recover the file handle, the number of bytes requested by the user, user_callback and user_context from the context containing overlapped. ]*/
-/*Tests_SRS_FILE_WIN32_43_066: [ on_file_io_complete_win32 shall call user_callback with is_successful as true if and only if io_result is equal to NO_ERROR and number_of_bytes_transferred is equal to the number of bytes requested by the user. ]*/
-TEST_FUNCTION(on_file_io_complete_win32_calls_callback_successfully_for_write)
+/* file_set_preallocation */
+
+/*Tests_SRS_FILE_01_076: [ If handle is NULL then file_set_preallocation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_preallocation_with_NULL_handle_fails)
 {
     ///arrange
-    unsigned char source[10];
-    uint64_t position = 11;
-    void* user_context = (void*)20;
 
-    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
-    LPOVERLAPPED captured_ov;
+    ///act
+    int result = file_set_preallocation(NULL, TEST_PREALLOCATION_CHUNK_SIZE);
 
-    FILE_HANDLE file_handle = start_file_io_async(FILE_WRITE_ASYNC, source, sizeof(source), position, mock_user_callback, user_context,  &captured_callback, &captured_ov);
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
 
-    STRICT_EXPECTED_CALL(mock_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mock_user_callback(user_context, true));
-    ASSERT_ARE_EQUAL(uint64_t, position, captured_ov->Offset);
+/*Tests_SRS_FILE_01_077: [ If chunk_size is 0 then file_set_preallocation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_preallocation_with_zero_chunk_size_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_preallocation_with_zero_chunk_size_fails.txt");
 
     ///act
-    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    int result = file_set_preallocation(file_handle, 0);
 
     ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///cleanup
     file_destroy(file_handle);
 }
 
-/*Tests_SRS_FILE_WIN32_43_034: [ on_file_io_complete_win32 shall recover the file handle, the number of bytes requested by the user, user_callback and user_context from the context containing overlapped. ]*/
-/*Tests_SRS_FILE_WIN32_43_068: [ If either io_result is not equal to NO_ERROR or number_of_bytes_transferred is not equal to the bytes requested by the user, on_file_io_complete_win32 shall return false. ]*/
-TEST_FUNCTION(on_file_io_complete_win32_calls_callback_unsuccessfully_for_write_because_io_failed)
+/*Tests_SRS_FILE_01_078: [ If chunk_size is greater than INT64_MAX then file_set_preallocation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_preallocation_with_chunk_size_greater_than_INT64_MAX_fails)
 {
     ///arrange
-    unsigned char source[10];
-    uint64_t position = 11;
-    void* user_context = (void*)20;
+    FILE_HANDLE file_handle = get_file_handle("file_set_preallocation_with_chunk_size_greater_than_INT64_MAX_fails.txt");
 
-    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
-    LPOVERLAPPED captured_ov;
+    ///act
+    int result = file_set_preallocation(file_handle, (uint64_t)INT64_MAX + 1);
 
-    FILE_HANDLE file_handle = start_file_io_async(FILE_WRITE_ASYNC, source, sizeof(source), position, mock_user_callback, user_context,  &captured_callback, &captured_ov);
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
-    STRICT_EXPECTED_CALL(mock_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    ///cleanup
+    file_destroy(file_handle);
+}
 
-    STRICT_EXPECTED_CALL(mock_user_callback(user_context, false));
-    ASSERT_ARE_EQUAL(uint64_t, position, captured_ov->Offset);
+/*Tests_SRS_FILE_01_080: [ file_set_preallocation shall set chunk_size as the preallocation chunk size of handle and return 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_093: [ file_set_preallocation shall call GetFileSizeEx to get the size of the file. ]*/
+/*Tests_SRS_FILE_WIN32_01_095: [ file_set_preallocation shall set the end of the furthest write started, the preallocated end of the file and the preallocation target to the size of the file. ]*/
+/*Tests_SRS_FILE_WIN32_01_096: [ file_set_preallocation shall set chunk_size as the preallocation chunk size of handle and return 0. ]*/
+TEST_FUNCTION(file_set_preallocation_succeeds)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_preallocation_succeeds.txt");
+
+    STRICT_EXPECTED_CALL(mock_GetFileSizeEx(fake_handle, IGNORED_ARG));
 
     ///act
-    captured_callback(NULL, NULL, captured_ov, ERROR_IO_INCOMPLETE, sizeof(source), NULL);
+    int result = file_set_preallocation(file_handle, TEST_PREALLOCATION_CHUNK_SIZE);
 
     ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///cleanup
     file_destroy(file_handle);
 }
 
-/*Tests_SRS_FILE_WIN32_43_034: [on_file_io_complete_win32 shall recover the file handle, the number of bytes requested by the user, user_callback and user_context from the context containing overlapped.]*/
-/*Tests_SRS_FILE_WIN32_43_068 : [If either GetOverlappedResult returns false or number_of_bytes_transferred is not equal to the bytes requested by the user, on_file_io_complete_win32 shall return false.]*/
-TEST_FUNCTION(on_file_io_complete_win32_calls_callback_unsuccessfully_for_write_because_num_bytes_is_less)
+/*Tests_SRS_FILE_01_079: [ If a preallocation policy was already set on handle then file_set_preallocation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_preallocation_when_a_policy_is_already_set_fails)
 {
     ///arrange
-    unsigned char source[10];
-    uint64_t position = 11;
-    void* user_context = (void*)20;
-
     PTP_WIN32_IO_CALLBACK captured_callback = NULL;
-    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("file_set_preallocation_when_a_policy_is_already_set_fails.txt", &captured_callback);
 
-    FILE_HANDLE file_handle = start_file_io_async(FILE_WRITE_ASYNC, source, sizeof(source), position, mock_user_callback, user_context,  &captured_callback, &captured_ov);
+    ///act
+    int result = file_set_preallocation(file_handle, TEST_PREALLOCATION_CHUNK_SIZE);
 
-    STRICT_EXPECTED_CALL(mock_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mock_user_callback(user_context, false));
-    ASSERT_ARE_EQUAL(uint64_t, position, captured_ov->Offset);
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_083: [ If there are any other failures, file_set_preallocation shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_094: [ If GetFileSizeEx fails, file_set_preallocation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_preallocation_fails_when_GetFileSizeEx_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_preallocation_fails_when_GetFileSizeEx_fails.txt");
+
+    STRICT_EXPECTED_CALL(mock_GetFileSizeEx(fake_handle, IGNORED_ARG))
+        .SetReturn(FALSE);
 
     ///act
-    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source)-1, NULL);
+    int result = file_set_preallocation(file_handle, TEST_PREALLOCATION_CHUNK_SIZE);
 
     ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     ///cleanup
     file_destroy(file_handle);
 }
 
-/*Tests_SRS_FILE_WIN32_43_034: [ on_file_io_complete_win32 shall recover the file handle, the number of bytes requested by the user, user_callback and user_context from the context containing overlapped. ]*/
-/*Tests_SRS_FILE_WIN32_43_066: [ on_file_io_complete_win32 shall call user_callback with is_successful as true if and only if io_result is equal to NO_ERROR and number_of_bytes_transferred is equal to the number of bytes requested by the user. ]*/
-TEST_FUNCTION(on_file_io_complete_win32_calls_callback_successfully_for_read)
+/*Tests_SRS_FILE_WIN32_01_076: [ record_write_end shall record write_end as the end of the furthest write started if it is greater than it. ]*/
+/*Tests_SRS_FILE_WIN32_01_079: [ If write_end + chunk_size / 2 is not greater than the preallocated end of the file, preallocate_ahead_if_needed shall return. ]*/
+TEST_FUNCTION(file_write_async_far_from_the_preallocated_end_does_not_preallocate)
 {
     ///arrange
-    unsigned char destination[10];
-    uint64_t position = 11;
-    void* user_context = (void*)20;
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("file_write_async_far_from_the_preallocated_end_does_not_preallocate.txt", &captured_callback);
+    unsigned char source[10];
+    LPOVERLAPPED captured_ov;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
 
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_081: [ When a write started by file_write_async, file_write_async_v or file_batch_submit ends less than chunk_size / 2 bytes before the end of the reserved storage and no reservation is in progress, storage shall be reserved in the background, without changing the size of the file, up to chunk_size bytes past the end of the write. ]*/
+/*Tests_SRS_FILE_WIN32_01_087: [ file_write_async shall call record_write_end with position + size. ]*/
+/*Tests_SRS_FILE_WIN32_01_088: [ If the write was issued, file_write_async shall call preallocate_ahead_if_needed with position + size. ]*/
+/*Tests_SRS_FILE_WIN32_01_080: [ preallocate_ahead_if_needed shall mark the preallocation as in progress, and if a preallocation is already in progress it shall return. ]*/
+/*Tests_SRS_FILE_WIN32_01_082: [ preallocate_ahead_if_needed shall call TrySubmitThreadpoolCallback with on_file_preallocate_win32 and the threadpool environment of handle. ]*/
+TEST_FUNCTION(file_write_async_close_to_the_preallocated_end_submits_a_preallocation)
+{
+    ///arrange
     PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("file_write_async_close_to_the_preallocated_end_submits_a_preallocation.txt", &captured_callback);
+    unsigned char source[10];
     LPOVERLAPPED captured_ov;
+    PTP_SIMPLE_CALLBACK captured_preallocate_callback = NULL;
 
-    FILE_HANDLE file_handle = start_file_io_async(FILE_READ_ASYNC, destination, sizeof(destination), position, mock_user_callback, user_context,  &captured_callback, &captured_ov);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, file_handle, IGNORED_ARG))
+        .CaptureArgumentValue_pfns(&captured_preallocate_callback);
 
-    STRICT_EXPECTED_CALL(mock_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mock_user_callback(user_context, true));
-    ASSERT_ARE_EQUAL(uint64_t, position, captured_ov->Offset);
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), test_file_size - sizeof(source), mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_IS_NOT_NULL(captured_preallocate_callback);
+
+    ///cleanup
+    captured_preallocate_callback(NULL, file_handle);
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_082: [ A failure to reserve storage shall not fail the write. ]*/
+/*Tests_SRS_FILE_WIN32_01_083: [ If TrySubmitThreadpoolCallback fails, preallocate_ahead_if_needed shall set the preallocation target back to the preallocated end, mark the preallocation as not in progress and wake up file_destroy by calling wake_by_address_all. ]*/
+TEST_FUNCTION(file_write_async_when_TrySubmitThreadpoolCallback_fails_for_the_preallocation_succeeds)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("file_write_async_when_TrySubmitThreadpoolCallback_fails_for_the_preallocation_succeeds.txt", &captured_callback);
+    unsigned char source[10];
+    LPOVERLAPPED captured_ov;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, file_handle, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
 
     ///act
-    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(destination), NULL);
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), test_file_size - sizeof(source), mock_user_callback, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
 
     ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
     file_destroy(file_handle);
 }
 
-/*Tests_SRS_FILE_WIN32_43_034: [ on_file_io_complete_win32 shall recover the file handle, the number of bytes requested by the user, user_callback and user_context from the context containing overlapped. ]*/
-/*Tests_SRS_FILE_WIN32_43_068: [ If either io_result is not equal to NO_ERROR or number_of_bytes_transferred is not equal to the bytes requested by the user, on_file_io_complete_win32 shall return false. ]*/
-TEST_FUNCTION(on_file_io_complete_win32_calls_callback_unsuccessfully_for_read_because_io_failed)
+/*Tests_SRS_FILE_WIN32_01_080: [ preallocate_ahead_if_needed shall mark the preallocation as in progress, and if a preallocation is already in progress it shall return. ]*/
+TEST_FUNCTION(file_write_async_within_the_target_of_the_preallocation_in_progress_does_not_wait)
 {
     ///arrange
-    unsigned char destination[10];
-    uint64_t position = 11;
-    void* user_context = (void*)20;
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("file_write_async_within_the_target_of_the_preallocation_in_progress_does_not_wait.txt", &captured_callback);
+    unsigned char source[10];
+    LPOVERLAPPED captured_ov_1;
+    LPOVERLAPPED captured_ov_2;
+    PTP_SIMPLE_CALLBACK captured_preallocate_callback = start_write_that_preallocates(file_handle, source, sizeof(source), test_file_size - sizeof(source), &captured_ov_1);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_2)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), test_file_size, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
 
+    ///cleanup
+    captured_preallocate_callback(NULL, file_handle);
+    captured_callback(NULL, NULL, captured_ov_1, NO_ERROR, sizeof(source), NULL);
+    captured_callback(NULL, NULL, captured_ov_2, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_076: [ record_write_end shall record write_end as the end of the furthest write started if it is greater than it. ]*/
+/*Tests_SRS_FILE_WIN32_01_080: [ preallocate_ahead_if_needed shall mark the preallocation as in progress, and if a preallocation is already in progress it shall return. ]*/
+TEST_FUNCTION(file_write_async_past_the_target_of_the_preallocation_in_progress_does_not_wait)
+{
+    ///arrange
     PTP_WIN32_IO_CALLBACK captured_callback = NULL;
-    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("file_write_async_past_the_target_of_the_preallocation_in_progress_does_not_wait.txt", &captured_callback);
+    unsigned char source[10];
+    LPOVERLAPPED captured_ov_1;
+    LPOVERLAPPED captured_ov_2;
+    PTP_SIMPLE_CALLBACK captured_preallocate_callback = start_write_that_preallocates(file_handle, source, sizeof(source), test_file_size - sizeof(source), &captured_ov_1);
 
-    FILE_HANDLE file_handle = start_file_io_async(FILE_READ_ASYNC, destination, sizeof(destination), position, mock_user_callback, user_context,  &captured_callback, &captured_ov);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_2)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
 
-    STRICT_EXPECTED_CALL(mock_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mock_user_callback(user_context, false));
-    ASSERT_ARE_EQUAL(uint64_t, position, captured_ov->Offset);
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), test_file_size + TEST_PREALLOCATION_CHUNK_SIZE, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+
+    ///cleanup
+    captured_preallocate_callback(NULL, file_handle);
+    captured_callback(NULL, NULL, captured_ov_1, NO_ERROR, sizeof(source), NULL);
+    captured_callback(NULL, NULL, captured_ov_2, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_089: [ file_write_async_v shall call record_write_end with position + the sum of the buffer lengths. ]*/
+/*Tests_SRS_FILE_WIN32_01_090: [ If the write was issued, file_write_async_v shall call preallocate_ahead_if_needed with position + the sum of the buffer lengths. ]*/
+TEST_FUNCTION(file_write_async_v_close_to_the_preallocated_end_submits_a_preallocation)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("file_write_async_v_close_to_the_preallocated_end_submits_a_preallocation.txt", &captured_callback);
+    unsigned char header[4];
+    unsigned char payload[10];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+    PTP_SIMPLE_CALLBACK captured_preallocate_callback = NULL;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, header, sizeof(header), NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, payload, sizeof(payload), NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback(NULL, true));
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, file_handle, IGNORED_ARG))
+        .CaptureArgumentValue_pfns(&captured_preallocate_callback);
 
     ///act
-    captured_callback(NULL, NULL, captured_ov, ERROR_IO_INCOMPLETE, sizeof(destination), NULL);
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, test_file_size - sizeof(header) - sizeof(payload), mock_user_callback, NULL);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_IS_NOT_NULL(captured_preallocate_callback);
 
     ///cleanup
+    captured_preallocate_callback(NULL, file_handle);
+    ASSERT_ARE_EQUAL(int64_t, test_file_size + TEST_PREALLOCATION_CHUNK_SIZE, captured_allocation_size);
     file_destroy(file_handle);
 }
 
-/*Tests_SRS_FILE_WIN32_43_034: [on_file_io_complete_win32 shall recover the file handle, the number of bytes requested by the user, user_callback and user_context from the context containing overlapped.]*/
-/*Tests_SRS_FILE_WIN32_43_068 : [If either GetOverlappedResult returns false or number_of_bytes_transferred is not equal to the bytes requested by the user, on_file_io_complete_win32 shall return false.]*/
-TEST_FUNCTION(on_file_io_complete_win32_calls_callback_unsuccessfully_for_read_because_num_bytes_is_less)
+/*Tests_SRS_FILE_WIN32_01_091: [ Before issuing a write, file_batch_submit shall call record_write_end with the end of the write. ]*/
+/*Tests_SRS_FILE_WIN32_01_092: [ If writes were issued, file_batch_submit shall call preallocate_ahead_if_needed with the highest end of the issued writes. ]*/
+TEST_FUNCTION(file_batch_submit_with_a_write_close_to_the_preallocated_end_submits_a_preallocation)
 {
     ///arrange
-    unsigned char destination[10];
-    uint64_t position = 11;
-    void* user_context = (void*)20;
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("file_batch_submit_with_a_write_close_to_the_preallocated_end_submits_a_preallocation.txt", &captured_callback);
+    unsigned char source[10];
+    unsigned char destination[20];
+    uint32_t submitted_count = 0;
+    LPOVERLAPPED captured_ov_1;
+    LPOVERLAPPED captured_ov_2;
+    PTP_SIMPLE_CALLBACK captured_preallocate_callback = NULL;
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), test_file_size - sizeof(source), mock_user_callback, (void*)45));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 0, mock_user_callback, (void*)46));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_1)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, destination, sizeof(destination), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_2)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, file_handle, IGNORED_ARG))
+        .CaptureArgumentValue_pfns(&captured_preallocate_callback);
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, submitted_count);
+    ASSERT_IS_NOT_NULL(captured_preallocate_callback);
 
+    ///cleanup
+    captured_preallocate_callback(NULL, file_handle);
+    ASSERT_ARE_EQUAL(int64_t, test_file_size + TEST_PREALLOCATION_CHUNK_SIZE, captured_allocation_size);
+    captured_callback(NULL, NULL, captured_ov_1, NO_ERROR, sizeof(source), NULL);
+    captured_callback(NULL, NULL, captured_ov_2, NO_ERROR, sizeof(destination), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_074: [ file_destroy shall wait for the preallocation in progress, if any, to complete by calling wait_on_address. ]*/
+TEST_FUNCTION(file_destroy_waits_for_the_preallocation_in_progress)
+{
+    ///arrange
     PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("file_destroy_waits_for_the_preallocation_in_progress.txt", &captured_callback);
+    unsigned char source[10];
     LPOVERLAPPED captured_ov;
+    preallocate_callback_to_run_on_wait = start_write_that_preallocates(file_handle, source, sizeof(source), test_file_size - sizeof(source), &captured_ov);
+    preallocate_context_to_run_on_wait = file_handle;
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    umock_c_reset_all_calls();
 
-    FILE_HANDLE file_handle = start_file_io_async(FILE_READ_ASYNC, destination, sizeof(destination), position, mock_user_callback, user_context,  &captured_callback, &captured_ov);
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 1, UINT32_MAX));
+    STRICT_EXPECTED_CALL(mock_GetFileSizeEx(fake_handle, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_SetFileInformationByHandle(fake_handle, FileAllocationInfo, IGNORED_ARG, sizeof(FILE_ALLOCATION_INFO)));
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_WaitForThreadpoolIoCallbacks(fake_ptp_io, FALSE));
+    STRICT_EXPECTED_CALL(mock_CloseThreadpoolCleanupGroup(fake_ptp_cleanup_group));
+    STRICT_EXPECTED_CALL(mock_DestroyThreadpoolEnvironment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_handle));
+    STRICT_EXPECTED_CALL(mock_CloseThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_destroy(test_io_context_pool));
+    STRICT_EXPECTED_CALL(execution_engine_dec_ref(fake_execution_engine));
+    STRICT_EXPECTED_CALL(free(file_handle));
 
-    STRICT_EXPECTED_CALL(mock_CloseHandle(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
-    STRICT_EXPECTED_CALL(mock_user_callback(user_context, false));
-    ASSERT_ARE_EQUAL(uint64_t, position, captured_ov->Offset);
+    ///act
+    file_destroy(file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* on_file_preallocate_win32 */
+
+/*Tests_SRS_FILE_WIN32_01_218: [ on_file_preallocate_win32 shall call GetFileSizeEx to get the size of the file. ]*/
+/*Tests_SRS_FILE_WIN32_01_084: [ Otherwise, on_file_preallocate_win32 shall call SetFileInformationByHandle with FileAllocationInfo and the preallocation target as allocation size. ]*/
+/*Tests_SRS_FILE_WIN32_01_085: [ on_file_preallocate_win32 shall set the preallocated end of the file to the preallocation target, even if SetFileInformationByHandle failed, so that a failing file system is only asked again once the writes get past the target. ]*/
+/*Tests_SRS_FILE_WIN32_01_086: [ on_file_preallocate_win32 shall mark the preallocation as not in progress and wake up file_destroy by calling wake_by_address_all. ]*/
+/*Tests_SRS_FILE_WIN32_01_081: [ preallocate_ahead_if_needed shall set the preallocation target to the end of the furthest write started + chunk_size, capped at INT64_MAX. ]*/
+TEST_FUNCTION(on_file_preallocate_win32_sets_the_allocation_size_to_the_target)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("on_file_preallocate_win32_sets_the_allocation_size_to_the_target.txt", &captured_callback);
+    unsigned char source[10];
+    LPOVERLAPPED captured_ov;
+    PTP_SIMPLE_CALLBACK captured_preallocate_callback = start_write_that_preallocates(file_handle, source, sizeof(source), test_file_size - sizeof(source), &captured_ov);
+
+    STRICT_EXPECTED_CALL(mock_GetFileSizeEx(fake_handle, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_SetFileInformationByHandle(fake_handle, FileAllocationInfo, IGNORED_ARG, sizeof(FILE_ALLOCATION_INFO)));
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
 
     ///act
-    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(destination) -1, NULL);
+    captured_preallocate_callback(NULL, file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, test_file_size + TEST_PREALLOCATION_CHUNK_SIZE, captured_allocation_size);
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_081: [ preallocate_ahead_if_needed shall set the preallocation target to the end of the furthest write started + chunk_size, capped at INT64_MAX. ]*/
+TEST_FUNCTION(on_file_preallocate_win32_caps_the_allocation_size_at_INT64_MAX)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("on_file_preallocate_win32_caps_the_allocation_size_at_INT64_MAX.txt", &captured_callback);
+    unsigned char source[10];
+    LPOVERLAPPED captured_ov;
+    PTP_SIMPLE_CALLBACK captured_preallocate_callback = start_write_that_preallocates(file_handle, source, sizeof(source), INT64_MAX - TEST_PREALLOCATION_CHUNK_SIZE / 2 - sizeof(source), &captured_ov);
+
+    STRICT_EXPECTED_CALL(mock_GetFileSizeEx(fake_handle, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_SetFileInformationByHandle(fake_handle, FileAllocationInfo, IGNORED_ARG, sizeof(FILE_ALLOCATION_INFO)));
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+
+    ///act
+    captured_preallocate_callback(NULL, file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, INT64_MAX, captured_allocation_size);
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_082: [ A failure to reserve storage shall not fail the write. ]*/
+/*Tests_SRS_FILE_WIN32_01_085: [ on_file_preallocate_win32 shall set the preallocated end of the file to the preallocation target, even if SetFileInformationByHandle failed, so that a failing file system is only asked again once the writes get past the target. ]*/
+TEST_FUNCTION(on_file_preallocate_win32_when_SetFileInformationByHandle_fails_does_not_preallocate_again_before_the_target)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("on_file_preallocate_win32_when_SetFileInformationByHandle_fails_does_not_preallocate_again_before_the_target.txt", &captured_callback);
+    unsigned char source[10];
+    LPOVERLAPPED captured_ov_1;
+    LPOVERLAPPED captured_ov_2;
+    PTP_SIMPLE_CALLBACK captured_preallocate_callback = start_write_that_preallocates(file_handle, source, sizeof(source), test_file_size - sizeof(source), &captured_ov_1);
+
+    STRICT_EXPECTED_CALL(mock_GetFileSizeEx(fake_handle, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_SetFileInformationByHandle(fake_handle, FileAllocationInfo, IGNORED_ARG, sizeof(FILE_ALLOCATION_INFO)))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+    captured_preallocate_callback(NULL, file_handle);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_2)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), test_file_size, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov_1, NO_ERROR, sizeof(source), NULL);
+    captured_callback(NULL, NULL, captured_ov_2, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_082: [ A failure to reserve storage shall not fail the write. ]*/
+/*Tests_SRS_FILE_WIN32_01_220: [ If the preallocation target is not greater than the size of the file or than the end of the furthest write started, on_file_preallocate_win32 shall not call SetFileInformationByHandle. ]*/
+TEST_FUNCTION(on_file_preallocate_win32_does_not_shrink_the_allocation_below_the_furthest_write_started)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("on_file_preallocate_win32_does_not_shrink_the_allocation_below_the_furthest_write_started.txt", &captured_callback);
+    unsigned char source[10];
+    LPOVERLAPPED captured_ov_1;
+    LPOVERLAPPED captured_ov_2;
+    PTP_SIMPLE_CALLBACK captured_preallocate_callback = start_write_that_preallocates(file_handle, source, sizeof(source), test_file_size - sizeof(source), &captured_ov_1);
+
+    /*a write past the target is issued while the reservation is in progress*/
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_2)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), test_file_size + TEST_PREALLOCATION_CHUNK_SIZE, mock_user_callback, NULL));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_GetFileSizeEx(fake_handle, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+
+    ///act
+    captured_preallocate_callback(NULL, file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov_1, NO_ERROR, sizeof(source), NULL);
+    captured_callback(NULL, NULL, captured_ov_2, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_220: [ If the preallocation target is not greater than the size of the file or than the end of the furthest write started, on_file_preallocate_win32 shall not call SetFileInformationByHandle. ]*/
+TEST_FUNCTION(on_file_preallocate_win32_does_not_shrink_the_allocation_below_the_end_of_the_file)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("on_file_preallocate_win32_does_not_shrink_the_allocation_below_the_end_of_the_file.txt", &captured_callback);
+    unsigned char source[10];
+    LPOVERLAPPED captured_ov;
+    PTP_SIMPLE_CALLBACK captured_preallocate_callback = start_write_that_preallocates(file_handle, source, sizeof(source), test_file_size - sizeof(source), &captured_ov);
+    /*the file was extended past the target through another handle*/
+    test_file_growth = TEST_PREALLOCATION_CHUNK_SIZE;
+
+    STRICT_EXPECTED_CALL(mock_GetFileSizeEx(fake_handle, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+
+    ///act
+    captured_preallocate_callback(NULL, file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_219: [ If GetFileSizeEx fails, on_file_preallocate_win32 shall not call SetFileInformationByHandle. ]*/
+TEST_FUNCTION(on_file_preallocate_win32_when_GetFileSizeEx_fails_does_not_set_the_allocation_size)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("on_file_preallocate_win32_when_GetFileSizeEx_fails_does_not_set_the_allocation_size.txt", &captured_callback);
+    unsigned char source[10];
+    LPOVERLAPPED captured_ov;
+    PTP_SIMPLE_CALLBACK captured_preallocate_callback = start_write_that_preallocates(file_handle, source, sizeof(source), test_file_size - sizeof(source), &captured_ov);
+
+    STRICT_EXPECTED_CALL(mock_GetFileSizeEx(fake_handle, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(wake_by_address_all(IGNORED_ARG));
+
+    ///act
+    captured_preallocate_callback(NULL, file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/* file_set_write_aggregation */
+
+/*Tests_SRS_FILE_01_084: [ If handle is NULL then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_write_aggregation_with_NULL_handle_fails)
+{
+    ///arrange
+
+    ///act
+    int result = file_set_write_aggregation(NULL, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_085: [ If max_aggregated_size is 0 then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_write_aggregation_with_zero_max_aggregated_size_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_write_aggregation_with_zero_max_aggregated_size_fails.txt");
+
+    ///act
+    int result = file_set_write_aggregation(file_handle, 0, TEST_MAX_DELAY_MS);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_086: [ If max_delay_ms is 0 then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_write_aggregation_with_zero_max_delay_ms_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_write_aggregation_with_zero_max_delay_ms_fails.txt");
+
+    ///act
+    int result = file_set_write_aggregation(file_handle, TEST_MAX_AGGREGATED_SIZE, 0);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_087: [ If a write aggregation policy was already set on handle then file_set_write_aggregation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_write_aggregation_when_a_policy_is_already_set_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("file_set_write_aggregation_when_a_policy_is_already_set_fails.txt", &captured_callback, &captured_timer_callback);
+
+    ///act
+    int result = file_set_write_aggregation(file_handle, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_088: [ file_set_write_aggregation shall set the write aggregation policy of handle and return 0. ]*/
+/*Tests_SRS_FILE_01_090: [ The aggregation buffer shall be written when it holds max_aggregated_size bytes, when max_delay_ms milliseconds elapsed since it was started, when a write does not continue it, or when the file is destroyed. ]*/
+/*Tests_SRS_FILE_WIN32_01_105: [ file_set_write_aggregation shall create the aggregation timer by calling CreateThreadpoolTimer with on_aggregation_timer_win32, handle and the threadpool environment of handle. ]*/
+/*Tests_SRS_FILE_WIN32_01_107: [ file_set_write_aggregation shall call write_aggregator_create with 1 as alignment, max_aggregated_size, max_delay_ms, 0 as file size, issue_aggregated_write, start_aggregation_timer, NULL as set_file_size and handle. ]*/
+/*Tests_SRS_FILE_WIN32_01_109: [ file_set_write_aggregation shall store the aggregation timer and the write aggregator in handle and return 0. ]*/
+TEST_FUNCTION(file_set_write_aggregation_succeeds)
+{
+    ///arrange
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle("file_set_write_aggregation_succeeds.txt");
+
+    STRICT_EXPECTED_CALL(mock_CreateThreadpoolTimer(IGNORED_ARG, file_handle, IGNORED_ARG))
+        .CaptureArgumentValue_pfnti(&captured_timer_callback);
+    STRICT_EXPECTED_CALL(write_aggregator_create(1, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, 0, IGNORED_ARG, IGNORED_ARG, NULL, file_handle));
+
+    ///act
+    int result = file_set_write_aggregation(file_handle, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_timer_callback);
+    ASSERT_IS_NOT_NULL(captured_issue_io);
+    ASSERT_IS_NOT_NULL(captured_start_timer);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_092: [ If there are any other failures, file_set_write_aggregation shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_106: [ If CreateThreadpoolTimer fails, file_set_write_aggregation shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_write_aggregation_fails_when_CreateThreadpoolTimer_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_write_aggregation_fails_when_CreateThreadpoolTimer_fails.txt");
+
+    STRICT_EXPECTED_CALL(mock_CreateThreadpoolTimer(IGNORED_ARG, file_handle, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    int result = file_set_write_aggregation(file_handle, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_092: [ If there are any other failures, file_set_write_aggregation shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_108: [ If write_aggregator_create fails, file_set_write_aggregation shall call CloseThreadpoolTimer and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_write_aggregation_fails_when_write_aggregator_create_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_write_aggregation_fails_when_write_aggregator_create_fails.txt");
+
+    STRICT_EXPECTED_CALL(mock_CreateThreadpoolTimer(IGNORED_ARG, file_handle, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_create(1, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, 0, IGNORED_ARG, IGNORED_ARG, NULL, file_handle))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(mock_CloseThreadpoolTimer(fake_ptp_timer));
+
+    ///act
+    int result = file_set_write_aggregation(file_handle, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_089: [ When a write aggregation policy is set, file_write_async shall copy writes smaller than max_aggregated_size that continue the previous write or start at an aligned position into the aggregation buffer and return FILE_WRITE_ASYNC_OK. ]*/
+/*Tests_SRS_FILE_WIN32_01_101: [ If a write aggregation policy is set, file_write_async shall call write_aggregator_add with source, size, position, user_callback and user_context. ]*/
+/*Tests_SRS_FILE_WIN32_01_102: [ If write_aggregator_add returns WRITE_AGGREGATOR_ADD_OK, file_write_async shall return FILE_WRITE_ASYNC_OK. ]*/
+TEST_FUNCTION(file_write_async_with_write_aggregation_hands_the_write_to_the_write_aggregator)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("file_write_async_with_write_aggregation_hands_the_write_to_the_write_aggregator.txt", &captured_callback, &captured_timer_callback);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(write_aggregator_add(test_write_aggregator, source, sizeof(source), 5, mock_user_callback, (void*)0x4245));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_103: [ If write_aggregator_add returns WRITE_AGGREGATOR_ADD_ERROR, file_write_async shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
+TEST_FUNCTION(file_write_async_with_write_aggregation_fails_when_write_aggregator_add_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("file_write_async_with_write_aggregation_fails_when_write_aggregator_add_fails.txt", &captured_callback, &captured_timer_callback);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(write_aggregator_add(test_write_aggregator, source, sizeof(source), 5, mock_user_callback, (void*)0x4245))
+        .SetReturn(WRITE_AGGREGATOR_ADD_ERROR);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_104: [ If no write aggregation policy is set or write_aggregator_add returns WRITE_AGGREGATOR_ADD_NOT_AGGREGATED, file_write_async shall issue the write by itself. ]*/
+TEST_FUNCTION(file_write_async_with_write_aggregation_issues_the_writes_that_are_not_aggregated)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("file_write_async_with_write_aggregation_issues_the_writes_that_are_not_aggregated.txt", &captured_callback, &captured_timer_callback);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(write_aggregator_add(test_write_aggregator, source, sizeof(source), 5, mock_user_callback, NULL))
+        .SetReturn(WRITE_AGGREGATOR_ADD_NOT_AGGREGATED);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_098: [ If a write aggregation policy is set, file_destroy shall call write_aggregator_flush to start writing the aggregated data that is not written yet. ]*/
+/*Tests_SRS_FILE_WIN32_01_099: [ If a write aggregation policy is set, file_destroy shall cancel the aggregation timer by calling SetThreadpoolTimer with NULL as due time and wait for its callbacks by calling WaitForThreadpoolTimerCallbacks. ]*/
+/*Tests_SRS_FILE_WIN32_01_100: [ If a write aggregation policy is set, file_destroy shall call write_aggregator_destroy and CloseThreadpoolTimer once all I/O completed. ]*/
+TEST_FUNCTION(file_destroy_with_write_aggregation_flushes_and_destroys_the_write_aggregator)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("file_destroy_with_write_aggregation_flushes_and_destroys_the_write_aggregator.txt", &captured_callback, &captured_timer_callback);
+
+    STRICT_EXPECTED_CALL(write_aggregator_flush(test_write_aggregator));
+    STRICT_EXPECTED_CALL(mock_SetThreadpoolTimer(fake_ptp_timer, NULL, 0, 0));
+    STRICT_EXPECTED_CALL(mock_WaitForThreadpoolTimerCallbacks(fake_ptp_timer, TRUE));
+    STRICT_EXPECTED_CALL(mock_WaitForThreadpoolIoCallbacks(fake_ptp_io, FALSE));
+    STRICT_EXPECTED_CALL(write_aggregator_destroy(test_write_aggregator));
+    STRICT_EXPECTED_CALL(mock_CloseThreadpoolTimer(fake_ptp_timer));
+    STRICT_EXPECTED_CALL(mock_CloseThreadpoolCleanupGroup(fake_ptp_cleanup_group));
+    STRICT_EXPECTED_CALL(mock_DestroyThreadpoolEnvironment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_handle));
+    STRICT_EXPECTED_CALL(mock_CloseThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_destroy(test_io_context_pool));
+    STRICT_EXPECTED_CALL(execution_engine_dec_ref(fake_execution_engine));
+    STRICT_EXPECTED_CALL(free(file_handle));
+
+    ///act
+    file_destroy(file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* issue_aggregated_write */
+
+/*Tests_SRS_FILE_WIN32_01_110: [ issue_aggregated_write shall get a context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_WIN32_01_112: [ issue_aggregated_write_io shall call record_write_end with the position + size of the aggregated write. ]*/
+/*Tests_SRS_FILE_WIN32_01_113: [ issue_aggregated_write_io shall call StartThreadpoolIo and WriteFile with the buffer and size of the aggregated write and the OVERLAPPED struct. ]*/
+/*Tests_SRS_FILE_WIN32_01_114: [ If WriteFile fails synchronously and GetLastError indicates ERROR_IO_PENDING, issue_aggregated_write_io shall call preallocate_ahead_if_needed with the position + size of the aggregated write and return 0. ]*/
+TEST_FUNCTION(issue_aggregated_write_issues_a_WriteFile)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("issue_aggregated_write_issues_a_WriteFile.txt", &captured_callback, &captured_timer_callback);
+    unsigned char buffer[100];
+    WRITE_AGGREGATOR_IO aggregated_io = { 0x100000010, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, buffer, sizeof(buffer), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ///act
+    int result = captured_issue_io(captured_write_aggregator_context, &aggregated_io);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0x10, (uint32_t)captured_ov->Offset);
+    ASSERT_ARE_EQUAL(uint32_t, 1, (uint32_t)captured_ov->OffsetHigh);
+    ASSERT_IS_NULL(captured_ov->hEvent);
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(buffer), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_114: [ If WriteFile fails synchronously and GetLastError indicates ERROR_IO_PENDING, issue_aggregated_write_io shall call preallocate_ahead_if_needed with the position + size of the aggregated write and return 0. ]*/
+TEST_FUNCTION(issue_aggregated_write_close_to_the_preallocated_end_starts_a_preallocation)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_SIMPLE_CALLBACK captured_preallocate_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_preallocation("issue_aggregated_write_close_to_the_preallocated_end_starts_a_preallocation.txt", &captured_callback);
+    STRICT_EXPECTED_CALL(mock_CreateThreadpoolTimer(IGNORED_ARG, file_handle, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_create(1, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS, 0, IGNORED_ARG, IGNORED_ARG, NULL, file_handle));
+    ASSERT_ARE_EQUAL(int, 0, file_set_write_aggregation(file_handle, TEST_MAX_AGGREGATED_SIZE, TEST_MAX_DELAY_MS));
+    umock_c_reset_all_calls();
+    unsigned char buffer[100];
+    WRITE_AGGREGATOR_IO aggregated_io = { test_file_size - sizeof(buffer), buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, buffer, sizeof(buffer), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, file_handle, IGNORED_ARG))
+        .CaptureArgumentValue_pfns(&captured_preallocate_callback);
+
+    ///act
+    int result = captured_issue_io(captured_write_aggregator_context, &aggregated_io);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_preallocate_callback(NULL, file_handle);
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(buffer), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_111: [ If io_context_pool_get fails, issue_aggregated_write shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(issue_aggregated_write_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("issue_aggregated_write_fails_when_io_context_pool_get_fails.txt", &captured_callback, &captured_timer_callback);
+    unsigned char buffer[100];
+    WRITE_AGGREGATOR_IO aggregated_io = { 0, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    int result = captured_issue_io(captured_write_aggregator_context, &aggregated_io);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_115: [ If WriteFile fails synchronously and GetLastError does not indicate ERROR_IO_PENDING, issue_aggregated_write_io shall call CancelThreadpoolIo and return a non-zero value. ]*/
+TEST_FUNCTION(issue_aggregated_write_fails_when_WriteFile_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("issue_aggregated_write_fails_when_WriteFile_fails.txt", &captured_callback, &captured_timer_callback);
+    unsigned char buffer[100];
+    WRITE_AGGREGATOR_IO aggregated_io = { 0, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, buffer, sizeof(buffer), NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_DISK_FULL);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    int result = captured_issue_io(captured_write_aggregator_context, &aggregated_io);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_116: [ If WriteFile succeeds synchronously, issue_aggregated_write_io shall call CancelThreadpoolIo, release the context, call release_io_slots if the write holds slots of the I/O limits, call preallocate_ahead_if_needed with the position + size of the aggregated write, call write_aggregator_io_complete with is_successful as true and return 0. ]*/
+TEST_FUNCTION(issue_aggregated_write_when_WriteFile_succeeds_synchronously_completes_the_aggregated_write)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("issue_aggregated_write_when_WriteFile_succeeds_synchronously_completes_the_aggregated_write.txt", &captured_callback, &captured_timer_callback);
+    unsigned char buffer[100];
+    WRITE_AGGREGATOR_IO aggregated_io = { 0, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, buffer, sizeof(buffer), NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_io_complete(test_write_aggregator, &aggregated_io, true));
+
+    ///act
+    int result = captured_issue_io(captured_write_aggregator_context, &aggregated_io);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_091: [ When the aggregated write completes, the user_callback of every write copied in it shall be called with user_context and the result of the aggregated write. ]*/
+/*Tests_SRS_FILE_WIN32_01_117: [ If the completed operation is an aggregated write, on_file_io_complete_win32 shall release the context to the I/O context pool and call write_aggregator_io_complete with is_successful as true if and only if io_result is NO_ERROR and number_of_bytes_transferred is equal to the size of the aggregated write. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_for_an_aggregated_write_calls_write_aggregator_io_complete_with_true)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("on_file_io_complete_win32_for_an_aggregated_write_calls_write_aggregator_io_complete_with_true.txt", &captured_callback, &captured_timer_callback);
+    unsigned char buffer[100];
+    WRITE_AGGREGATOR_IO aggregated_io = { 0, buffer, sizeof(buffer) };
+    start_aggregated_write(&aggregated_io, &captured_ov);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_io_complete(test_write_aggregator, &aggregated_io, true));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(buffer), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_117: [ If the completed operation is an aggregated write, on_file_io_complete_win32 shall release the context to the I/O context pool and call write_aggregator_io_complete with is_successful as true if and only if io_result is NO_ERROR and number_of_bytes_transferred is equal to the size of the aggregated write. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_for_a_partial_aggregated_write_calls_write_aggregator_io_complete_with_false)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("on_file_io_complete_win32_for_a_partial_aggregated_write_calls_write_aggregator_io_complete_with_false.txt", &captured_callback, &captured_timer_callback);
+    unsigned char buffer[100];
+    WRITE_AGGREGATOR_IO aggregated_io = { 0, buffer, sizeof(buffer) };
+    start_aggregated_write(&aggregated_io, &captured_ov);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_io_complete(test_write_aggregator, &aggregated_io, false));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(buffer) - 1, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_117: [ If the completed operation is an aggregated write, on_file_io_complete_win32 shall release the context to the I/O context pool and call write_aggregator_io_complete with is_successful as true if and only if io_result is NO_ERROR and number_of_bytes_transferred is equal to the size of the aggregated write. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_for_a_failed_aggregated_write_calls_write_aggregator_io_complete_with_false)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("on_file_io_complete_win32_for_a_failed_aggregated_write_calls_write_aggregator_io_complete_with_false.txt", &captured_callback, &captured_timer_callback);
+    unsigned char buffer[100];
+    WRITE_AGGREGATOR_IO aggregated_io = { 0, buffer, sizeof(buffer) };
+    start_aggregated_write(&aggregated_io, &captured_ov);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_io_complete(test_write_aggregator, &aggregated_io, false));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, ERROR_DISK_FULL, sizeof(buffer), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* start_aggregation_timer */
+
+/*Tests_SRS_FILE_WIN32_01_118: [ start_aggregation_timer shall store timer_id and call SetThreadpoolTimer on the aggregation timer with a due time of delay_ms milliseconds from now, no period and no window. ]*/
+/*Tests_SRS_FILE_WIN32_01_119: [ start_aggregation_timer shall succeed and return 0. ]*/
+TEST_FUNCTION(start_aggregation_timer_arms_the_aggregation_timer)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("start_aggregation_timer_arms_the_aggregation_timer.txt", &captured_callback, &captured_timer_callback);
+
+    STRICT_EXPECTED_CALL(mock_SetThreadpoolTimer(fake_ptp_timer, IGNORED_ARG, 0, 0));
+
+    ///act
+    int result = captured_start_timer(captured_write_aggregator_context, 1500, 42);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int64_t, -15000000, captured_timer_due_time);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* on_aggregation_timer_win32 */
+
+/*Tests_SRS_FILE_WIN32_01_120: [ on_aggregation_timer_win32 shall call write_aggregator_on_timer with the timer id the timer was last armed for. ]*/
+TEST_FUNCTION(on_aggregation_timer_win32_calls_write_aggregator_on_timer_with_the_last_timer_id)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("on_aggregation_timer_win32_calls_write_aggregator_on_timer_with_the_last_timer_id.txt", &captured_callback, &captured_timer_callback);
+    ASSERT_ARE_EQUAL(int, 0, captured_start_timer(captured_write_aggregator_context, TEST_MAX_DELAY_MS, 41));
+    ASSERT_ARE_EQUAL(int, 0, captured_start_timer(captured_write_aggregator_context, TEST_MAX_DELAY_MS, 42));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(write_aggregator_on_timer(test_write_aggregator, 42));
+
+    ///act
+    captured_timer_callback(NULL, file_handle, fake_ptp_timer);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* file_set_read_ahead */
+
+/*Tests_SRS_FILE_01_093: [ If handle is NULL then file_set_read_ahead shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_read_ahead_with_NULL_handle_fails)
+{
+    ///arrange
+
+    ///act
+    int result = file_set_read_ahead(NULL, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_094: [ If block_size is 0 then file_set_read_ahead shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_read_ahead_with_zero_block_size_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_read_ahead_with_zero_block_size_fails.txt");
+
+    ///act
+    int result = file_set_read_ahead(file_handle, 0, TEST_READ_AHEAD_BLOCK_COUNT);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_095: [ If block_count is 0 then file_set_read_ahead shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_read_ahead_with_zero_block_count_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_read_ahead_with_zero_block_count_fails.txt");
+
+    ///act
+    int result = file_set_read_ahead(file_handle, TEST_READ_AHEAD_BLOCK_SIZE, 0);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_096: [ If a read-ahead policy was already set on handle then file_set_read_ahead shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_read_ahead_when_a_policy_is_already_set_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_set_read_ahead_when_a_policy_is_already_set_fails.txt", &captured_callback);
+
+    ///act
+    int result = file_set_read_ahead(file_handle, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_097: [ file_set_read_ahead shall set the read-ahead policy of handle and return 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_136: [ file_set_read_ahead shall call read_ahead_create with 1 as alignment, block_size, block_count, issue_read_ahead and handle. ]*/
+/*Tests_SRS_FILE_WIN32_01_138: [ file_set_read_ahead shall store the read-ahead in handle and return 0. ]*/
+TEST_FUNCTION(file_set_read_ahead_succeeds)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_read_ahead_succeeds.txt");
+
+    STRICT_EXPECTED_CALL(read_ahead_create(1, TEST_READ_AHEAD_BLOCK_SIZE + 1, TEST_READ_AHEAD_BLOCK_COUNT, IGNORED_ARG, file_handle));
+
+    ///act
+    int result = file_set_read_ahead(file_handle, TEST_READ_AHEAD_BLOCK_SIZE + 1, TEST_READ_AHEAD_BLOCK_COUNT);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_read_ahead_issue_io);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_101: [ If there are any other failures, file_set_read_ahead shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_137: [ If read_ahead_create fails, file_set_read_ahead shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_read_ahead_fails_when_read_ahead_create_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_read_ahead_fails_when_read_ahead_create_fails.txt");
+
+    STRICT_EXPECTED_CALL(read_ahead_create(1, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT, IGNORED_ARG, file_handle))
+        .SetReturn(NULL);
+
+    ///act
+    int result = file_set_read_ahead(file_handle, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* file_read_async with read-ahead */
+
+/*Tests_SRS_FILE_01_098: [ When a read-ahead policy is set, file_read_async shall serve reads that fit in one block from the blocks of handle and, when the reads are sequential, keep up to block_count blocks following the read in flight. ]*/
+/*Tests_SRS_FILE_WIN32_01_125: [ If a read-ahead policy is set, file_read_async shall call read_ahead_read with destination, size, position, user_callback and user_context. ]*/
+/*Tests_SRS_FILE_WIN32_01_126: [ If read_ahead_read returns READ_AHEAD_READ_OK, file_read_async shall return FILE_READ_ASYNC_OK. ]*/
+TEST_FUNCTION(file_read_async_with_read_ahead_hands_the_read_to_the_read_ahead)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_read_async_with_read_ahead_hands_the_read_to_the_read_ahead.txt", &captured_callback);
+    unsigned char destination[10];
+
+    STRICT_EXPECTED_CALL(read_ahead_read(test_read_ahead, destination, sizeof(destination), 5, mock_user_callback, (void*)0x4245));
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 5, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_127: [ If read_ahead_read returns READ_AHEAD_READ_ERROR, file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+TEST_FUNCTION(file_read_async_with_read_ahead_fails_when_read_ahead_read_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_read_async_with_read_ahead_fails_when_read_ahead_read_fails.txt", &captured_callback);
+    unsigned char destination[10];
+
+    STRICT_EXPECTED_CALL(read_ahead_read(test_read_ahead, destination, sizeof(destination), 5, mock_user_callback, (void*)0x4245))
+        .SetReturn(READ_AHEAD_READ_ERROR);
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 5, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_099: [ A read served from a block shall call user_callback asynchronously, after file_read_async returned. ]*/
+/*Tests_SRS_FILE_WIN32_01_128: [ If read_ahead_read returns READ_AHEAD_READ_COPIED, file_read_async shall get a context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_WIN32_01_130: [ file_read_async shall increment the number of pending copied reads and call TrySubmitThreadpoolCallback with on_read_ahead_copied_win32, the context and the threadpool environment of handle. ]*/
+/*Tests_SRS_FILE_WIN32_01_132: [ file_read_async shall succeed and return FILE_READ_ASYNC_OK. ]*/
+TEST_FUNCTION(file_read_async_with_read_ahead_submits_a_callback_when_the_data_was_copied)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_SIMPLE_CALLBACK captured_copied_callback = NULL;
+    PVOID captured_copied_context = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_read_async_with_read_ahead_submits_a_callback_when_the_data_was_copied.txt", &captured_callback);
+    unsigned char destination[10];
+
+    STRICT_EXPECTED_CALL(read_ahead_read(test_read_ahead, destination, sizeof(destination), 5, mock_user_callback, (void*)0x4245))
+        .SetReturn(READ_AHEAD_READ_COPIED);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CaptureArgumentValue_pfns(&captured_copied_callback)
+        .CaptureArgumentValue_pv(&captured_copied_context);
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 5, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_copied_callback);
+
+    ///cleanup
+    captured_copied_callback(NULL, captured_copied_context);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_129: [ If io_context_pool_get fails, file_read_async shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+TEST_FUNCTION(file_read_async_with_read_ahead_fails_when_io_context_pool_get_fails_for_a_copied_read)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_read_async_with_read_ahead_fails_when_io_context_pool_get_fails_for_a_copied_read.txt", &captured_callback);
+    unsigned char destination[10];
+
+    STRICT_EXPECTED_CALL(read_ahead_read(test_read_ahead, destination, sizeof(destination), 5, mock_user_callback, (void*)0x4245))
+        .SetReturn(READ_AHEAD_READ_COPIED);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 5, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_131: [ If TrySubmitThreadpoolCallback fails, file_read_async shall decrement the number of pending copied reads, release the context and return FILE_READ_ASYNC_ERROR. ]*/
+TEST_FUNCTION(file_read_async_with_read_ahead_fails_when_TrySubmitThreadpoolCallback_fails_for_a_copied_read)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_read_async_with_read_ahead_fails_when_TrySubmitThreadpoolCallback_fails_for_a_copied_read.txt", &captured_callback);
+    unsigned char destination[10];
+
+    STRICT_EXPECTED_CALL(read_ahead_read(test_read_ahead, destination, sizeof(destination), 5, mock_user_callback, (void*)0x4245))
+        .SetReturn(READ_AHEAD_READ_COPIED);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 5, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_133: [ If no read-ahead policy is set or read_ahead_read returns READ_AHEAD_READ_NOT_HANDLED, file_read_async shall issue the read by itself. ]*/
+TEST_FUNCTION(file_read_async_with_read_ahead_issues_the_reads_that_are_not_handled)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_read_async_with_read_ahead_issues_the_reads_that_are_not_handled.txt", &captured_callback);
+    unsigned char destination[10];
+
+    STRICT_EXPECTED_CALL(read_ahead_read(test_read_ahead, destination, sizeof(destination), 5, mock_user_callback, NULL))
+        .SetReturn(READ_AHEAD_READ_NOT_HANDLED);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, destination, sizeof(destination), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(destination), NULL);
+    file_destroy(file_handle);
+}
+
+/* writes with read-ahead */
+
+/*Tests_SRS_FILE_01_100: [ When a read-ahead policy is set, file_write_async, file_write_async_v and file_batch_add_write shall drop the blocks that overlap the written range. ]*/
+/*Tests_SRS_FILE_WIN32_01_124: [ If a read-ahead policy is set, file_write_async shall call read_ahead_invalidate with position and size. ]*/
+TEST_FUNCTION(file_write_async_with_read_ahead_invalidates_the_written_range)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_write_async_with_read_ahead_invalidates_the_written_range.txt", &captured_callback);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 5, sizeof(source)));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_134: [ If a read-ahead policy is set, file_write_async_v shall call read_ahead_invalidate with position and the sum of the buffer lengths. ]*/
+TEST_FUNCTION(file_write_async_v_with_read_ahead_invalidates_the_written_range)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov_1;
+    LPOVERLAPPED captured_ov_2;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_write_async_v_with_read_ahead_invalidates_the_written_range.txt", &captured_callback);
+    unsigned char header[4];
+    unsigned char payload[10];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 100, sizeof(header) + sizeof(payload)));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, header, sizeof(header), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_1)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, payload, sizeof(payload), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_2)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 100, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov_1, NO_ERROR, sizeof(header), NULL);
+    captured_callback(NULL, NULL, captured_ov_2, NO_ERROR, sizeof(payload), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_135: [ If a read-ahead policy is set, file_batch_add_write shall call read_ahead_invalidate with position and size. ]*/
+TEST_FUNCTION(file_batch_add_write_with_read_ahead_invalidates_the_written_range)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_batch_add_write_with_read_ahead_invalidates_the_written_range.txt", &captured_callback);
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 5, sizeof(source)));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    int result = file_batch_add_write(batch, source, sizeof(source), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_batch_cancel(batch);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_142: [ When a read-ahead policy is set, the blocks that overlap the written range shall be dropped again when the write completes, before its user_callback is called, so that a block read while the write was in flight is not served. ]*/
+/*Tests_SRS_FILE_WIN32_01_214: [ If the completed operation is a write and a read-ahead policy is set, on_file_io_complete_win32 shall call read_ahead_invalidate with the position and size of the write before calling user_callback. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_for_a_write_invalidates_the_blocks_read_while_the_write_was_in_flight)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("on_file_io_complete_win32_for_a_write_invalidates_the_blocks_read_while_the_write_was_in_flight.txt", &captured_callback);
+    unsigned char source[10];
+    unsigned char destination[10];
+
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 5, sizeof(source)));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, (void*)0x4245));
+
+    /*the read starts the read of a block over the range of the write while the write is in flight*/
+    STRICT_EXPECTED_CALL(read_ahead_read(test_read_ahead, destination, sizeof(destination), 5, mock_user_callback, (void*)0x4246));
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async(file_handle, destination, sizeof(destination), 5, mock_user_callback, (void*)0x4246));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_CloseHandle(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 5, sizeof(source)));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_214: [ If the completed operation is a write and a read-ahead policy is set, on_file_io_complete_win32 shall call read_ahead_invalidate with the position and size of the write before calling user_callback. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_for_the_parts_of_a_vectored_write_invalidates_the_range_of_each_part)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov_1;
+    LPOVERLAPPED captured_ov_2;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("on_file_io_complete_win32_for_the_parts_of_a_vectored_write_invalidates_the_range_of_each_part.txt", &captured_callback);
+    unsigned char header[4];
+    unsigned char payload[10];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 100, sizeof(header) + sizeof(payload)));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, header, sizeof(header), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_1)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, payload, sizeof(payload), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_2)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async_v(file_handle, buffers, 2, 100, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 100 + sizeof(header), sizeof(payload)));
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 100, sizeof(header)));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov_2, NO_ERROR, sizeof(payload), NULL);
+    captured_callback(NULL, NULL, captured_ov_1, NO_ERROR, sizeof(header), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_214: [ If the completed operation is a write and a read-ahead policy is set, on_file_io_complete_win32 shall call read_ahead_invalidate with the position and size of the write before calling user_callback. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_for_a_batched_write_invalidates_the_written_range)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("on_file_io_complete_win32_for_a_batched_write_invalidates_the_written_range.txt", &captured_callback);
+    unsigned char source[10];
+    uint32_t submitted_count = 0;
+    LPOVERLAPPED captured_ov;
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 5, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(free(batch));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_submit(batch, &submitted_count));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 5, sizeof(source)));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_214: [ If the completed operation is a write and a read-ahead policy is set, on_file_io_complete_win32 shall call read_ahead_invalidate with the position and size of the write before calling user_callback. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_for_a_batched_read_does_not_invalidate)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("on_file_io_complete_win32_for_a_batched_read_does_not_invalidate.txt", &captured_callback);
+    unsigned char destination[10];
+    uint32_t submitted_count = 0;
+    LPOVERLAPPED captured_ov;
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 5, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, destination, sizeof(destination), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(free(batch));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_submit(batch, &submitted_count));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(destination), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_215: [ If the completed operation is an aggregated write and a read-ahead policy is set, on_file_io_complete_win32 shall call read_ahead_invalidate with the position and size of the aggregated write before calling write_aggregator_io_complete. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_for_an_aggregated_write_invalidates_the_aggregated_range)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("on_file_io_complete_win32_for_an_aggregated_write_invalidates_the_aggregated_range.txt", &captured_callback, &captured_timer_callback);
+    unsigned char buffer[100];
+    WRITE_AGGREGATOR_IO aggregated_io = { 200, buffer, sizeof(buffer) };
+    STRICT_EXPECTED_CALL(read_ahead_create(1, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT, IGNORED_ARG, file_handle));
+    ASSERT_ARE_EQUAL(int, 0, file_set_read_ahead(file_handle, TEST_READ_AHEAD_BLOCK_SIZE, TEST_READ_AHEAD_BLOCK_COUNT));
+    umock_c_reset_all_calls();
+    start_aggregated_write(&aggregated_io, &captured_ov);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 200, sizeof(buffer)));
+    STRICT_EXPECTED_CALL(write_aggregator_io_complete(test_write_aggregator, &aggregated_io, true));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(buffer), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_217: [ If a write succeeds synchronously and a read-ahead policy is set, read_ahead_invalidate shall be called with the position and size of the write before its user_callback or write_aggregator_io_complete is called. ]*/
+TEST_FUNCTION(file_write_async_with_read_ahead_that_succeeds_synchronously_invalidates_the_written_range_again)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_write_async_with_read_ahead_that_succeeds_synchronously_invalidates_the_written_range_again.txt", &captured_callback);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 5, sizeof(source)));
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, 5, sizeof(source)));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_121: [ file_create shall set no read-ahead policy on the file handle and set the number of pending copied reads to 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_122: [ file_destroy shall wait for the number of pending copied reads to reach 0 by calling wait_on_address. ]*/
+/*Tests_SRS_FILE_WIN32_01_123: [ If a read-ahead policy is set, file_destroy shall call read_ahead_destroy once all I/O completed. ]*/
+TEST_FUNCTION(file_destroy_with_read_ahead_destroys_the_read_ahead)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_destroy_with_read_ahead_destroys_the_read_ahead.txt", &captured_callback);
+
+    STRICT_EXPECTED_CALL(mock_WaitForThreadpoolIoCallbacks(fake_ptp_io, FALSE));
+    STRICT_EXPECTED_CALL(read_ahead_destroy(test_read_ahead));
+    STRICT_EXPECTED_CALL(mock_CloseThreadpoolCleanupGroup(fake_ptp_cleanup_group));
+    STRICT_EXPECTED_CALL(mock_DestroyThreadpoolEnvironment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_handle));
+    STRICT_EXPECTED_CALL(mock_CloseThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_destroy(test_io_context_pool));
+    STRICT_EXPECTED_CALL(execution_engine_dec_ref(fake_execution_engine));
+    STRICT_EXPECTED_CALL(free(file_handle));
+
+    ///act
+    file_destroy(file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* on_read_ahead_copied_win32 */
+
+/*Tests_SRS_FILE_WIN32_01_151: [ on_read_ahead_copied_win32 shall release the context to the I/O context pool and call user_callback with is_successful as true. ]*/
+/*Tests_SRS_FILE_WIN32_01_152: [ on_read_ahead_copied_win32 shall decrement the number of pending copied reads and wake up file_destroy by calling wake_by_address_single if it reaches 0. ]*/
+TEST_FUNCTION(on_read_ahead_copied_win32_calls_the_user_callback_with_true)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_SIMPLE_CALLBACK captured_copied_callback = NULL;
+    PVOID captured_copied_context = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("on_read_ahead_copied_win32_calls_the_user_callback_with_true.txt", &captured_callback);
+    unsigned char destination[10];
+
+    STRICT_EXPECTED_CALL(read_ahead_read(test_read_ahead, destination, sizeof(destination), 5, mock_user_callback, (void*)0x4245))
+        .SetReturn(READ_AHEAD_READ_COPIED);
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CaptureArgumentValue_pfns(&captured_copied_callback)
+        .CaptureArgumentValue_pv(&captured_copied_context);
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async(file_handle, destination, sizeof(destination), 5, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, captured_copied_context));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_copied_callback(NULL, captured_copied_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* issue_read_ahead */
+
+/*Tests_SRS_FILE_WIN32_01_143: [ issue_read_ahead shall get a context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_WIN32_01_145: [ issue_read_ahead_io shall call StartThreadpoolIo and ReadFile with the buffer and size of the block and the OVERLAPPED struct. ]*/
+/*Tests_SRS_FILE_WIN32_01_146: [ If ReadFile fails synchronously and GetLastError indicates ERROR_IO_PENDING, issue_read_ahead_io shall succeed and return 0. ]*/
+TEST_FUNCTION(issue_read_ahead_issues_a_ReadFile)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("issue_read_ahead_issues_a_ReadFile.txt", &captured_callback);
+    unsigned char buffer[100];
+    READ_AHEAD_IO read_ahead_io = { 0x100000010, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, buffer, sizeof(buffer), IGNORED_ARG, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ///act
+    int result = captured_read_ahead_issue_io(captured_read_ahead_context, &read_ahead_io);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0x10, (uint32_t)captured_ov->Offset);
+    ASSERT_ARE_EQUAL(uint32_t, 1, (uint32_t)captured_ov->OffsetHigh);
+    ASSERT_IS_NULL(captured_ov->hEvent);
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(buffer), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_144: [ If io_context_pool_get fails, issue_read_ahead shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(issue_read_ahead_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("issue_read_ahead_fails_when_io_context_pool_get_fails.txt", &captured_callback);
+    unsigned char buffer[100];
+    READ_AHEAD_IO read_ahead_io = { 0, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    int result = captured_read_ahead_issue_io(captured_read_ahead_context, &read_ahead_io);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_147: [ If ReadFile fails synchronously and GetLastError indicates ERROR_HANDLE_EOF, issue_read_ahead_io shall call CancelThreadpoolIo, release the context, call release_io_slots if the read holds slots of the I/O limits, call read_ahead_io_complete with is_successful as true and 0 bytes read and return 0. ]*/
+TEST_FUNCTION(issue_read_ahead_past_the_end_of_the_file_completes_the_block_with_0_bytes)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("issue_read_ahead_past_the_end_of_the_file_completes_the_block_with_0_bytes.txt", &captured_callback);
+    unsigned char buffer[100];
+    READ_AHEAD_IO read_ahead_io = { 0, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, buffer, sizeof(buffer), IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_HANDLE_EOF);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_io_complete(test_read_ahead, &read_ahead_io, true, 0));
+
+    ///act
+    int result = captured_read_ahead_issue_io(captured_read_ahead_context, &read_ahead_io);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_148: [ If ReadFile fails synchronously and GetLastError indicates any other error, issue_read_ahead_io shall call CancelThreadpoolIo and return a non-zero value. ]*/
+TEST_FUNCTION(issue_read_ahead_fails_when_ReadFile_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("issue_read_ahead_fails_when_ReadFile_fails.txt", &captured_callback);
+    unsigned char buffer[100];
+    READ_AHEAD_IO read_ahead_io = { 0, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, buffer, sizeof(buffer), IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_INVALID_PARAMETER);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    int result = captured_read_ahead_issue_io(captured_read_ahead_context, &read_ahead_io);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_149: [ If ReadFile succeeds synchronously, issue_read_ahead_io shall call CancelThreadpoolIo, release the context, call release_io_slots if the read holds slots of the I/O limits, call read_ahead_io_complete with is_successful as true and the number of bytes read and return 0. ]*/
+TEST_FUNCTION(issue_read_ahead_when_ReadFile_succeeds_synchronously_completes_the_block)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("issue_read_ahead_when_ReadFile_succeeds_synchronously_completes_the_block.txt", &captured_callback);
+    unsigned char buffer[100];
+    READ_AHEAD_IO read_ahead_io = { 0, buffer, sizeof(buffer) };
+    DWORD bytes_read = 60;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, buffer, sizeof(buffer), IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_lpNumberofBytesRead(&bytes_read, sizeof(bytes_read))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_io_complete(test_read_ahead, &read_ahead_io, true, 60));
+
+    ///act
+    int result = captured_read_ahead_issue_io(captured_read_ahead_context, &read_ahead_io);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_150: [ If the completed operation is a read-ahead block read, on_file_io_complete_win32 shall release the context to the I/O context pool and call read_ahead_io_complete with is_successful as true if and only if io_result is NO_ERROR or ERROR_HANDLE_EOF and with number_of_bytes_transferred as the number of bytes read. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_for_a_read_ahead_block_calls_read_ahead_io_complete_with_true)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("on_file_io_complete_win32_for_a_read_ahead_block_calls_read_ahead_io_complete_with_true.txt", &captured_callback);
+    unsigned char buffer[100];
+    READ_AHEAD_IO read_ahead_io = { 0, buffer, sizeof(buffer) };
+    start_read_ahead(&read_ahead_io, &captured_ov);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_io_complete(test_read_ahead, &read_ahead_io, true, sizeof(buffer)));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(buffer), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_150: [ If the completed operation is a read-ahead block read, on_file_io_complete_win32 shall release the context to the I/O context pool and call read_ahead_io_complete with is_successful as true if and only if io_result is NO_ERROR or ERROR_HANDLE_EOF and with number_of_bytes_transferred as the number of bytes read. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_for_a_read_ahead_block_at_the_end_of_the_file_passes_the_bytes_read)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("on_file_io_complete_win32_for_a_read_ahead_block_at_the_end_of_the_file_passes_the_bytes_read.txt", &captured_callback);
+    unsigned char buffer[100];
+    READ_AHEAD_IO read_ahead_io = { 0, buffer, sizeof(buffer) };
+    start_read_ahead(&read_ahead_io, &captured_ov);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_io_complete(test_read_ahead, &read_ahead_io, true, 40));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, ERROR_HANDLE_EOF, 40, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_150: [ If the completed operation is a read-ahead block read, on_file_io_complete_win32 shall release the context to the I/O context pool and call read_ahead_io_complete with is_successful as true if and only if io_result is NO_ERROR or ERROR_HANDLE_EOF and with number_of_bytes_transferred as the number of bytes read. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_for_a_failed_read_ahead_block_calls_read_ahead_io_complete_with_false)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("on_file_io_complete_win32_for_a_failed_read_ahead_block_calls_read_ahead_io_complete_with_false.txt", &captured_callback);
+    unsigned char buffer[100];
+    READ_AHEAD_IO read_ahead_io = { 0, buffer, sizeof(buffer) };
+    start_read_ahead(&read_ahead_io, &captured_ov);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_io_complete(test_read_ahead, &read_ahead_io, false, 0));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, ERROR_INVALID_PARAMETER, 0, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* file_set_access_hint */
+
+/*Tests_SRS_FILE_01_102: [ If handle is NULL then file_set_access_hint shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_access_hint_fails_with_null_handle)
+{
+    ///arrange
+
+    ///act
+    int result = file_set_access_hint(NULL, FILE_ACCESS_HINT_SEQUENTIAL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_103: [ If access_hint is not FILE_ACCESS_HINT_NORMAL, FILE_ACCESS_HINT_SEQUENTIAL or FILE_ACCESS_HINT_RANDOM then file_set_access_hint shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_access_hint_fails_with_FILE_ACCESS_HINT_WILL_NEED)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_set_access_hint_fails_with_FILE_ACCESS_HINT_WILL_NEED.txt", &captured_callback);
+
+    ///act
+    int result = file_set_access_hint(file_handle, FILE_ACCESS_HINT_WILL_NEED);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_103: [ If access_hint is not FILE_ACCESS_HINT_NORMAL, FILE_ACCESS_HINT_SEQUENTIAL or FILE_ACCESS_HINT_RANDOM then file_set_access_hint shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_access_hint_fails_with_invalid_access_hint)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_set_access_hint_fails_with_invalid_access_hint.txt", &captured_callback);
+
+    ///act
+    int result = file_set_access_hint(file_handle, (FILE_ACCESS_HINT)0x42);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_104: [ If no read-ahead policy was set on handle then file_set_access_hint shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_access_hint_fails_when_no_read_ahead_policy_was_set)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_access_hint_fails_when_no_read_ahead_policy_was_set.txt");
+
+    ///act
+    int result = file_set_access_hint(file_handle, FILE_ACCESS_HINT_SEQUENTIAL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_105: [ file_set_access_hint shall apply access_hint to the read-ahead policy of handle and return 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_139: [ file_set_access_hint shall call read_ahead_set_mode with READ_AHEAD_MODE_AUTO for FILE_ACCESS_HINT_NORMAL, READ_AHEAD_MODE_SEQUENTIAL for FILE_ACCESS_HINT_SEQUENTIAL and READ_AHEAD_MODE_OFF for FILE_ACCESS_HINT_RANDOM. ]*/
+TEST_FUNCTION(file_set_access_hint_with_FILE_ACCESS_HINT_NORMAL_sets_READ_AHEAD_MODE_AUTO)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_set_access_hint_with_FILE_ACCESS_HINT_NORMAL_sets_READ_AHEAD_MODE_AUTO.txt", &captured_callback);
+
+    STRICT_EXPECTED_CALL(read_ahead_set_mode(test_read_ahead, READ_AHEAD_MODE_AUTO));
+
+    ///act
+    int result = file_set_access_hint(file_handle, FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_105: [ file_set_access_hint shall apply access_hint to the read-ahead policy of handle and return 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_139: [ file_set_access_hint shall call read_ahead_set_mode with READ_AHEAD_MODE_AUTO for FILE_ACCESS_HINT_NORMAL, READ_AHEAD_MODE_SEQUENTIAL for FILE_ACCESS_HINT_SEQUENTIAL and READ_AHEAD_MODE_OFF for FILE_ACCESS_HINT_RANDOM. ]*/
+TEST_FUNCTION(file_set_access_hint_with_FILE_ACCESS_HINT_SEQUENTIAL_sets_READ_AHEAD_MODE_SEQUENTIAL)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_set_access_hint_with_FILE_ACCESS_HINT_SEQUENTIAL_sets_READ_AHEAD_MODE_SEQUENTIAL.txt", &captured_callback);
+
+    STRICT_EXPECTED_CALL(read_ahead_set_mode(test_read_ahead, READ_AHEAD_MODE_SEQUENTIAL));
+
+    ///act
+    int result = file_set_access_hint(file_handle, FILE_ACCESS_HINT_SEQUENTIAL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_105: [ file_set_access_hint shall apply access_hint to the read-ahead policy of handle and return 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_139: [ file_set_access_hint shall call read_ahead_set_mode with READ_AHEAD_MODE_AUTO for FILE_ACCESS_HINT_NORMAL, READ_AHEAD_MODE_SEQUENTIAL for FILE_ACCESS_HINT_SEQUENTIAL and READ_AHEAD_MODE_OFF for FILE_ACCESS_HINT_RANDOM. ]*/
+TEST_FUNCTION(file_set_access_hint_with_FILE_ACCESS_HINT_RANDOM_sets_READ_AHEAD_MODE_OFF)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_set_access_hint_with_FILE_ACCESS_HINT_RANDOM_sets_READ_AHEAD_MODE_OFF.txt", &captured_callback);
+
+    STRICT_EXPECTED_CALL(read_ahead_set_mode(test_read_ahead, READ_AHEAD_MODE_OFF));
+
+    ///act
+    int result = file_set_access_hint(file_handle, FILE_ACCESS_HINT_RANDOM);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_106: [ If there are any other failures, file_set_access_hint shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_140: [ If read_ahead_set_mode fails, file_set_access_hint shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_access_hint_fails_when_read_ahead_set_mode_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_set_access_hint_fails_when_read_ahead_set_mode_fails.txt", &captured_callback);
+
+    STRICT_EXPECTED_CALL(read_ahead_set_mode(test_read_ahead, READ_AHEAD_MODE_SEQUENTIAL))
+        .SetReturn(MU_FAILURE);
+
+    ///act
+    int result = file_set_access_hint(file_handle, FILE_ACCESS_HINT_SEQUENTIAL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* file_will_need */
+
+/*Tests_SRS_FILE_01_107: [ If handle is NULL then file_will_need shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_will_need_fails_with_null_handle)
+{
+    ///arrange
+
+    ///act
+    int result = file_will_need(NULL, 0, TEST_READ_AHEAD_BLOCK_SIZE);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_108: [ If size is 0 then file_will_need shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_will_need_fails_with_zero_size)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_will_need_fails_with_zero_size.txt", &captured_callback);
+
+    ///act
+    int result = file_will_need(file_handle, 0, 0);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_109: [ If position + size overflows then file_will_need shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_will_need_fails_when_position_plus_size_overflows)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_will_need_fails_when_position_plus_size_overflows.txt", &captured_callback);
+
+    ///act
+    int result = file_will_need(file_handle, UINT64_MAX - 10, 11);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_110: [ If no read-ahead policy was set on handle then file_will_need shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_will_need_fails_when_no_read_ahead_policy_was_set)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_will_need_fails_when_no_read_ahead_policy_was_set.txt");
+
+    ///act
+    int result = file_will_need(file_handle, 0, TEST_READ_AHEAD_BLOCK_SIZE);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_111: [ file_will_need shall start reading the blocks that hold size bytes starting at position, up to block_count blocks, and return 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_141: [ file_will_need shall call read_ahead_will_need with position and size. ]*/
+TEST_FUNCTION(file_will_need_succeeds)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_will_need_succeeds.txt", &captured_callback);
+
+    STRICT_EXPECTED_CALL(read_ahead_will_need(test_read_ahead, 4096, 2 * TEST_READ_AHEAD_BLOCK_SIZE));
+
+    ///act
+    int result = file_will_need(file_handle, 4096, 2 * TEST_READ_AHEAD_BLOCK_SIZE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_112: [ If there are any other failures, file_will_need shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_142: [ If read_ahead_will_need fails, file_will_need shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_will_need_fails_when_read_ahead_will_need_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("file_will_need_fails_when_read_ahead_will_need_fails.txt", &captured_callback);
+
+    STRICT_EXPECTED_CALL(read_ahead_will_need(test_read_ahead, 4096, 2 * TEST_READ_AHEAD_BLOCK_SIZE))
+        .SetReturn(MU_FAILURE);
+
+    ///act
+    int result = file_will_need(file_handle, 4096, 2 * TEST_READ_AHEAD_BLOCK_SIZE);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* file_set_io_limit */
+
+/*Tests_SRS_FILE_01_113: [ If handle is NULL then file_set_io_limit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_io_limit_fails_with_null_handle)
+{
+    ///act
+    int result = file_set_io_limit(NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_114: [ If mode is not FILE_IO_LIMIT_MODE_BUSY or FILE_IO_LIMIT_MODE_QUEUE then file_set_io_limit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_io_limit_fails_with_invalid_mode)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_io_limit_fails_with_invalid_mode.txt");
+
+    ///act
+    int result = file_set_io_limit(file_handle, TEST_MAX_OUTSTANDING_IO, (FILE_IO_LIMIT_MODE)0x42);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_115: [ If an I/O limit was already set on handle then file_set_io_limit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_io_limit_fails_when_an_io_limit_was_already_set)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_set_io_limit_fails_when_an_io_limit_was_already_set.txt", &captured_callback, NULL, 0, FILE_IO_LIMIT_MODE_BUSY);
+
+    ///act
+    int result = file_set_io_limit(file_handle, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_116: [ file_set_io_limit shall set the I/O limit of handle to max_outstanding_io (no limit if max_outstanding_io is 0) and the mode to mode and return 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_186: [ Otherwise file_set_io_limit shall call io_admission_create with max_outstanding_io. ]*/
+/*Tests_SRS_FILE_WIN32_01_188: [ file_set_io_limit shall store the admission and mode in handle, mark the I/O limit as set and return 0. ]*/
+TEST_FUNCTION(file_set_io_limit_succeeds)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_io_limit_succeeds.txt");
+
+    STRICT_EXPECTED_CALL(io_admission_create(TEST_MAX_OUTSTANDING_IO));
+
+    ///act
+    int result = file_set_io_limit(file_handle, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_185: [ If max_outstanding_io is 0, file_set_io_limit shall not create an admission for handle. ]*/
+TEST_FUNCTION(file_set_io_limit_with_0_max_outstanding_io_does_not_create_an_admission)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_io_limit_with_0_max_outstanding_io_does_not_create_an_admission.txt");
+
+    ///act
+    int result = file_set_io_limit(file_handle, 0, FILE_IO_LIMIT_MODE_BUSY);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_121: [ If there are any other failures, file_set_io_limit shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_187: [ If io_admission_create fails, file_set_io_limit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_io_limit_fails_when_io_admission_create_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_io_limit_fails_when_io_admission_create_fails.txt");
+
+    STRICT_EXPECTED_CALL(io_admission_create(TEST_MAX_OUTSTANDING_IO))
+        .SetReturn(NULL);
+
+    ///act
+    int result = file_set_io_limit(file_handle, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_184: [ If an I/O limit is set on the file handle, file_destroy shall call io_admission_destroy once all I/O completed. ]*/
+TEST_FUNCTION(file_destroy_destroys_the_io_limit)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_destroy_destroys_the_io_limit.txt", &captured_callback, NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+
+    STRICT_EXPECTED_CALL(mock_WaitForThreadpoolIoCallbacks(fake_ptp_io, FALSE));
+    STRICT_EXPECTED_CALL(io_admission_destroy(test_io_admission));
+    STRICT_EXPECTED_CALL(mock_CloseThreadpoolCleanupGroup(fake_ptp_cleanup_group));
+    STRICT_EXPECTED_CALL(mock_DestroyThreadpoolEnvironment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_handle));
+    STRICT_EXPECTED_CALL(mock_CloseThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_destroy(test_io_context_pool));
+    STRICT_EXPECTED_CALL(execution_engine_dec_ref(fake_execution_engine));
+    STRICT_EXPECTED_CALL(free(file_handle));
+
+    ///act
+    file_destroy(file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_117: [ An I/O issued by file_write_async or file_read_async shall hold a slot of the I/O limit of handle and of the I/O limit of the execution engine from the moment it is started until it completes. ]*/
+/*Tests_SRS_FILE_WIN32_01_178: [ file_write_async shall call start_io with the mode of the file handle, which calls WriteFile as described above once the write holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+/*Tests_SRS_FILE_WIN32_01_169: [ If the file handle or the execution engine has an I/O limit, acquire_io_slots shall increment the number of queued I/Os before acquiring the slots. ]*/
+/*Tests_SRS_FILE_WIN32_01_168: [ If io_limit_mode is FILE_IO_LIMIT_MODE_BUSY, acquire_io_slots shall call io_admission_try_acquire on the admission of the file handle, if it exists. ]*/
+/*Tests_SRS_FILE_WIN32_01_171: [ If the file handle admission returns IO_ADMISSION_ADMITTED or the file handle has no I/O limit, acquire_io_slots shall call acquire_engine_io_slot, whatever the mode. ]*/
+/*Tests_SRS_FILE_WIN32_01_174: [ If the I/O holds its slots and issue_io succeeds, start_io shall return FILE_WIN32_START_IO_OK. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_busy_takes_the_slots_and_issues_the_write)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_write_async_with_io_limit_busy_takes_the_slots_and_issues_the_write.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_118: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and no slot of the I/O limit of handle is free, file_write_async shall fail and return FILE_WRITE_ASYNC_BUSY and file_read_async shall fail and return FILE_READ_ASYNC_BUSY, without calling user_callback. ]*/
+/*Tests_SRS_FILE_WIN32_01_176: [ If io_admission_try_acquire returns IO_ADMISSION_BUSY, start_io shall return FILE_WIN32_START_IO_BUSY. ]*/
+/*Tests_SRS_FILE_WIN32_01_179: [ If start_io returns FILE_WIN32_START_IO_BUSY, file_write_async shall close the event, release the context and return FILE_WRITE_ASYNC_BUSY. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_busy_returns_BUSY_when_the_file_handle_has_no_free_slot)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_write_async_with_io_limit_busy_returns_BUSY_when_the_file_handle_has_no_free_slot.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission))
+        .SetReturn(IO_ADMISSION_BUSY);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_BUSY, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_119: [ When the mode is FILE_IO_LIMIT_MODE_QUEUE and no slot of the I/O limit of handle is free, or when no slot of the I/O limit of the execution engine is free, file_write_async and file_read_async shall queue the I/O and return FILE_WRITE_ASYNC_OK and FILE_READ_ASYNC_OK, the queued I/Os are started in order as slots are freed. ]*/
+/*Tests_SRS_FILE_WIN32_01_171: [ If the file handle admission returns IO_ADMISSION_ADMITTED or the file handle has no I/O limit, acquire_io_slots shall call acquire_engine_io_slot, whatever the mode. ]*/
+/*Tests_SRS_FILE_WIN32_01_175: [ If the I/O was queued, start_io shall return FILE_WIN32_START_IO_OK. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_busy_queues_the_write_when_the_execution_engine_has_no_free_slot)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    IO_ADMISSION_WAITER* captured_waiter;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_write_async_with_io_limit_busy_queues_the_write_when_the_execution_engine_has_no_free_slot.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_158: [ on_file_io_admitted_by_engine shall call issue_io. ]*/
+/*Tests_SRS_FILE_WIN32_01_160: [ on_file_io_admitted_by_engine shall call end_queued_io. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_busy_issues_the_write_when_the_execution_engine_admits_it)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    IO_ADMISSION_WAITER* captured_waiter;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_write_async_with_io_limit_busy_issues_the_write_when_the_execution_engine_admits_it.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, NULL));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_177: [ If acquiring a slot fails, start_io shall return FILE_WIN32_START_IO_ERROR. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_fails_when_io_admission_try_acquire_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_write_async_with_io_limit_fails_when_io_admission_try_acquire_fails.txt", &captured_callback, NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission))
+        .SetReturn(IO_ADMISSION_ERROR);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_173: [ If issue_io fails, start_io shall call release_io_slots if the I/O holds slots and return FILE_WIN32_START_IO_ISSUE_ERROR. ]*/
+/*Tests_SRS_FILE_WIN32_01_153: [ release_io_slots shall call io_admission_release on the admission of the execution engine and then on the admission of the file handle, for the ones that exist. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_releases_the_slots_when_WriteFile_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_write_async_with_io_limit_releases_the_slots_when_WriteFile_fails.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_INCOMPLETE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_admission_release(test_engine_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_WRITE_ERROR, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_155: [ If the I/O completes synchronously and holds slots of the I/O limits, issue_io shall call release_io_slots before calling user_callback. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_releases_the_slots_when_WriteFile_succeeds_synchronously)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_write_async_with_io_limit_releases_the_slots_when_WriteFile_succeeds_synchronously.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char source[10];
+    void* user_context = (void*)45;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_admission_release(test_engine_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, true));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, user_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_154: [ If the operation holds slots of the I/O limits, on_file_io_complete_win32 shall call release_io_slots before calling user_callback. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_releases_the_slots_before_calling_the_callback)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("on_file_io_complete_win32_releases_the_slots_before_calling_the_callback.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char source[10];
+    void* user_context = (void*)45;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, user_context));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_release(test_engine_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, true));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_167: [ If neither the file handle nor the execution engine have an I/O limit, acquire_io_slots shall return IO_ADMISSION_ADMITTED. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_of_0_and_no_execution_engine_limit_issues_the_write)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_write_async_with_io_limit_of_0_and_no_execution_engine_limit_issues_the_write.txt", &captured_callback, NULL, 0, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_170: [ If io_limit_mode is FILE_IO_LIMIT_MODE_QUEUE, acquire_io_slots shall call io_admission_acquire on the admission of the file handle with on_file_io_admitted_by_handle as on_admitted, if it exists. ]*/
+/*Tests_SRS_FILE_WIN32_01_171: [ If the file handle admission returns IO_ADMISSION_ADMITTED or the file handle has no I/O limit, acquire_io_slots shall call acquire_engine_io_slot, whatever the mode. ]*/
+/*Tests_SRS_FILE_WIN32_01_161: [ acquire_engine_io_slot shall call io_admission_acquire on the admission of the execution engine with on_file_io_admitted_by_engine as on_admitted. ]*/
+/*Tests_SRS_FILE_WIN32_01_172: [ If the I/O was not queued, acquire_io_slots shall call end_queued_io. ]*/
+/*Tests_SRS_FILE_WIN32_01_156: [ end_queued_io shall decrement the number of queued I/Os and wake up file_destroy by calling wake_by_address_single if it reaches 0. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_queue_takes_the_slots_and_issues_the_write)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_write_async_with_io_limit_queue_takes_the_slots_and_issues_the_write.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_119: [ When the mode is FILE_IO_LIMIT_MODE_QUEUE and no slot of the I/O limit of handle is free, or when no slot of the I/O limit of the execution engine is free, file_write_async and file_read_async shall queue the I/O and return FILE_WRITE_ASYNC_OK and FILE_READ_ASYNC_OK, the queued I/Os are started in order as slots are freed. ]*/
+/*Tests_SRS_FILE_WIN32_01_175: [ If the I/O was queued, start_io shall return FILE_WIN32_START_IO_OK. ]*/
+TEST_FUNCTION(file_write_async_with_io_limit_queue_queues_the_write_when_the_file_handle_has_no_free_slot)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    IO_ADMISSION_WAITER* captured_waiter;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_write_async_with_io_limit_queue_queues_the_write_when_the_file_handle_has_no_free_slot.txt", &captured_callback, NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_163: [ on_file_io_admitted_by_handle shall call acquire_engine_io_slot. ]*/
+/*Tests_SRS_FILE_WIN32_01_164: [ If acquire_engine_io_slot returns IO_ADMISSION_ADMITTED, on_file_io_admitted_by_handle shall call on_file_io_admitted_by_engine. ]*/
+/*Tests_SRS_FILE_WIN32_01_158: [ on_file_io_admitted_by_engine shall call issue_io. ]*/
+/*Tests_SRS_FILE_WIN32_01_160: [ on_file_io_admitted_by_engine shall call end_queued_io. ]*/
+TEST_FUNCTION(on_file_io_admitted_by_handle_takes_the_slot_of_the_execution_engine_and_issues_the_write)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    LPOVERLAPPED captured_ov;
+    IO_ADMISSION_WAITER* captured_waiter;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("on_file_io_admitted_by_handle_takes_the_slot_of_the_execution_engine_and_issues_the_write.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, NULL));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_165: [ If acquire_engine_io_slot returns IO_ADMISSION_QUEUED, on_file_io_admitted_by_handle shall return. ]*/
+TEST_FUNCTION(on_file_io_admitted_by_handle_queues_the_write_when_the_execution_engine_has_no_free_slot)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    IO_ADMISSION_WAITER* captured_waiter;
+    IO_ADMISSION_WAITER* captured_engine_waiter;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("on_file_io_admitted_by_handle_queues_the_write_when_the_execution_engine_has_no_free_slot.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char source[10];
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, NULL));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_engine_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_engine_waiter->on_admitted(captured_engine_waiter->on_admitted_context);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_120: [ If a queued I/O fails to start, its user_callback shall be called with user_context and is_successful as false. ]*/
+/*Tests_SRS_FILE_WIN32_01_162: [ If io_admission_acquire fails, acquire_engine_io_slot shall release the slot of the file handle admission. ]*/
+/*Tests_SRS_FILE_WIN32_01_166: [ If acquire_engine_io_slot fails, on_file_io_admitted_by_handle shall call fail_queued_io and end_queued_io. ]*/
+/*Tests_SRS_FILE_WIN32_01_157: [ Otherwise fail_queued_io shall close the event of the OVERLAPPED struct if the I/O has one, release the context and call user_callback with is_successful as false. ]*/
+TEST_FUNCTION(on_file_io_admitted_by_handle_fails_the_write_when_acquiring_the_slot_of_the_execution_engine_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    IO_ADMISSION_WAITER* captured_waiter;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("on_file_io_admitted_by_handle_fails_the_write_when_acquiring_the_slot_of_the_execution_engine_fails.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char source[10];
+    void* user_context = (void*)45;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, user_context));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .SetReturn(IO_ADMISSION_ERROR);
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, false));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_159: [ If issue_io fails, on_file_io_admitted_by_engine shall call release_io_slots and fail_queued_io. ]*/
+TEST_FUNCTION(on_file_io_admitted_by_engine_fails_the_write_when_WriteFile_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    IO_ADMISSION_WAITER* captured_waiter;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("on_file_io_admitted_by_engine_fails_the_write_when_WriteFile_fails.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char source[10];
+    void* user_context = (void*)45;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, user_context));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_INCOMPLETE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_admission_release(test_engine_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, false));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_180: [ file_read_async shall call start_io with the mode of the file handle, which calls ReadFile as described above once the read holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+TEST_FUNCTION(file_read_async_with_io_limit_busy_takes_the_slots_and_issues_the_read)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_read_async_with_io_limit_busy_takes_the_slots_and_issues_the_read.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char destination[10];
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, destination, sizeof(destination), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(destination), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_118: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and no slot of the I/O limit of handle is free, file_write_async shall fail and return FILE_WRITE_ASYNC_BUSY and file_read_async shall fail and return FILE_READ_ASYNC_BUSY, without calling user_callback. ]*/
+/*Tests_SRS_FILE_WIN32_01_181: [ If start_io returns FILE_WIN32_START_IO_BUSY, file_read_async shall close the event, release the context and return FILE_READ_ASYNC_BUSY. ]*/
+TEST_FUNCTION(file_read_async_with_io_limit_busy_returns_BUSY_when_the_file_handle_has_no_free_slot)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_read_async_with_io_limit_busy_returns_BUSY_when_the_file_handle_has_no_free_slot.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char destination[10];
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission))
+        .SetReturn(IO_ADMISSION_BUSY);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_BUSY, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_119: [ When the mode is FILE_IO_LIMIT_MODE_QUEUE and no slot of the I/O limit of handle is free, or when no slot of the I/O limit of the execution engine is free, file_write_async and file_read_async shall queue the I/O and return FILE_WRITE_ASYNC_OK and FILE_READ_ASYNC_OK, the queued I/Os are started in order as slots are freed. ]*/
+/*Tests_SRS_FILE_WIN32_01_171: [ If the file handle admission returns IO_ADMISSION_ADMITTED or the file handle has no I/O limit, acquire_io_slots shall call acquire_engine_io_slot, whatever the mode. ]*/
+TEST_FUNCTION(file_read_async_with_io_limit_busy_and_no_limit_of_its_own_queues_the_read_when_the_execution_engine_has_no_free_slot)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    IO_ADMISSION_WAITER* captured_waiter;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_read_async_with_io_limit_busy_and_no_limit_of_its_own_queues_the_read_when_the_execution_engine_has_no_free_slot.txt", &captured_callback, test_engine_io_admission, 0, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char destination[10];
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_143: [ The I/Os of file_write_async_v, file_read_async_v and of the batches, the aggregated writes, the reads of read-ahead blocks and the flushes of handle shall also hold a slot of the I/O limit of handle and of the I/O limit of the execution engine from the moment they are started until they complete. ]*/
+/*Tests_SRS_FILE_WIN32_01_244: [ file_write_async_v shall call start_io with the first part and the mode of the file handle, which calls start_vectored_io once the write holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+/*Tests_SRS_FILE_WIN32_01_242: [ start_io shall call acquire_io_slots with io_limit_mode. ]*/
+/*Tests_SRS_FILE_WIN32_01_243: [ If acquire_io_slots returns IO_ADMISSION_ADMITTED, start_io shall call issue_io. ]*/
+/*Tests_SRS_FILE_WIN32_01_235: [ If the I/O is a vectored operation, issue_io shall call start_vectored_io. ]*/
+TEST_FUNCTION(file_write_async_v_with_io_limit_busy_takes_one_slot_for_all_the_parts)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    LPOVERLAPPED captured_ov_1;
+    LPOVERLAPPED captured_ov_2;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_write_async_v_with_io_limit_busy_takes_one_slot_for_all_the_parts.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char header[4];
+    unsigned char payload[10];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, header, sizeof(header), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_1)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, payload, sizeof(payload), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_2)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov_1, NO_ERROR, sizeof(header), NULL);
+    captured_callback(NULL, NULL, captured_ov_2, NO_ERROR, sizeof(payload), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_221: [ If the vectored operation holds slots of the I/O limits, on_file_io_complete_win32 shall call release_io_slots when its last part completes, before calling user_callback. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_releases_the_slots_of_a_vectored_write_when_its_last_part_completes)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    LPOVERLAPPED captured_ov_1;
+    LPOVERLAPPED captured_ov_2;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("on_file_io_complete_win32_releases_the_slots_of_a_vectored_write_when_its_last_part_completes.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char header[4];
+    unsigned char payload[10];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+    void* user_context = (void*)45;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, header, sizeof(header), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_1)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, payload, sizeof(payload), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_2)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, user_context));
+    umock_c_reset_all_calls();
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov_1, NO_ERROR, sizeof(header), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///arrange
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_release(test_engine_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, true));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov_2, NO_ERROR, sizeof(payload), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_144: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and no slot of the I/O limit of handle is free, file_write_async_v shall fail and return FILE_WRITE_ASYNC_BUSY and file_read_async_v shall fail and return FILE_READ_ASYNC_BUSY, without calling user_callback. ]*/
+/*Tests_SRS_FILE_WIN32_01_245: [ If start_io returns FILE_WIN32_START_IO_BUSY, file_write_async_v shall release the context and return FILE_WRITE_ASYNC_BUSY. ]*/
+TEST_FUNCTION(file_write_async_v_with_io_limit_busy_returns_BUSY_when_the_file_handle_has_no_free_slot)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_write_async_v_with_io_limit_busy_returns_BUSY_when_the_file_handle_has_no_free_slot.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char header[4];
+    unsigned char payload[10];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission))
+        .SetReturn(IO_ADMISSION_BUSY);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_BUSY, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_144: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and no slot of the I/O limit of handle is free, file_write_async_v shall fail and return FILE_WRITE_ASYNC_BUSY and file_read_async_v shall fail and return FILE_READ_ASYNC_BUSY, without calling user_callback. ]*/
+/*Tests_SRS_FILE_WIN32_01_246: [ file_read_async_v shall call start_io with the first part and the mode of the file handle, which calls start_vectored_io once the read holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+/*Tests_SRS_FILE_WIN32_01_247: [ If start_io returns FILE_WIN32_START_IO_BUSY, file_read_async_v shall release the context and return FILE_READ_ASYNC_BUSY. ]*/
+TEST_FUNCTION(file_read_async_v_with_io_limit_busy_returns_BUSY_when_the_file_handle_has_no_free_slot)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_read_async_v_with_io_limit_busy_returns_BUSY_when_the_file_handle_has_no_free_slot.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char header[4];
+    unsigned char payload[10];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission))
+        .SetReturn(IO_ADMISSION_BUSY);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_BUSY, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_237: [ fail_queued_io shall mark the I/O as not holding slots of the I/O limits. ]*/
+/*Tests_SRS_FILE_WIN32_01_241: [ If the I/O is a vectored operation, fail_queued_io shall release the vectored operation context and call user_callback with is_successful as false. ]*/
+TEST_FUNCTION(on_file_io_admitted_by_engine_fails_the_vectored_write_when_its_first_part_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    IO_ADMISSION_WAITER* captured_waiter;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("on_file_io_admitted_by_engine_fails_the_vectored_write_when_its_first_part_fails.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char header[4];
+    unsigned char payload[10];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+    void* user_context = (void*)45;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, user_context));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, header, sizeof(header), NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_INCOMPLETE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_admission_release(test_engine_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, false));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_143: [ The I/Os of file_write_async_v, file_read_async_v and of the batches, the aggregated writes, the reads of read-ahead blocks and the flushes of handle shall also hold a slot of the I/O limit of handle and of the I/O limit of the execution engine from the moment they are started until they complete. ]*/
+/*Tests_SRS_FILE_WIN32_01_248: [ If the file handle has an I/O limit in FILE_IO_LIMIT_MODE_BUSY, file_batch_submit shall call io_admission_try_acquire on the admission of the file handle once for each I/O in the batch. ]*/
+/*Tests_SRS_FILE_WIN32_01_250: [ If the slots of the file handle were acquired for the batch, file_batch_submit shall increment the number of queued I/Os, call acquire_engine_io_slot for each I/O and call end_queued_io if the I/O was not queued. ]*/
+TEST_FUNCTION(file_batch_submit_with_io_limit_busy_takes_the_slots_of_all_the_ios_before_issuing_them)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_batch_submit_with_io_limit_busy_takes_the_slots_of_all_the_ios_before_issuing_them.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char source[10];
+    unsigned char destination[20];
+    uint32_t submitted_count = 0;
+    LPOVERLAPPED captured_ov_1;
+    LPOVERLAPPED captured_ov_2;
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 100, mock_user_callback, (void*)45));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 200, mock_user_callback, (void*)46));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_1)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, destination, sizeof(destination), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_2)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, submitted_count);
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov_1, NO_ERROR, sizeof(source), NULL);
+    captured_callback(NULL, NULL, captured_ov_2, NO_ERROR, sizeof(destination), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_145: [ When the mode is FILE_IO_LIMIT_MODE_BUSY and the I/O limit of handle does not have a free slot for each of the I/Os of batch, file_batch_submit shall discard all the I/Os of batch without calling their user_callback, set submitted_count to 0, free batch and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_249: [ If io_admission_try_acquire does not return IO_ADMISSION_ADMITTED for each I/O, file_batch_submit shall call io_admission_release for each acquired slot, release the contexts of all the I/Os to the I/O context pool, set submitted_count to 0 and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_submit_with_io_limit_busy_discards_the_batch_when_the_file_handle_has_no_free_slot_for_each_io)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_batch_submit_with_io_limit_busy_discards_the_batch_when_the_file_handle_has_no_free_slot_for_each_io.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char source[10];
+    unsigned char destination[20];
+    uint32_t submitted_count = 42;
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 100, mock_user_callback, (void*)45));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 200, mock_user_callback, (void*)46));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission))
+        .SetReturn(IO_ADMISSION_BUSY);
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, submitted_count);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_146: [ An I/O of a batch that waits for a slot of the I/O limits shall be queued and counted as issued by file_batch_submit. ]*/
+/*Tests_SRS_FILE_WIN32_01_251: [ Otherwise file_batch_submit shall call acquire_io_slots with the mode of the file handle for each I/O. ]*/
+/*Tests_SRS_FILE_WIN32_01_252: [ An I/O queued for a slot shall count as issued, it is issued by issue_io once it holds its slots. ]*/
+/*Tests_SRS_FILE_WIN32_01_236: [ Otherwise issue_io shall call WriteFile or ReadFile for the I/O stored in the context by file_write_async, file_read_async or file_batch_submit. ]*/
+TEST_FUNCTION(file_batch_submit_with_io_limit_queue_counts_a_queued_io_as_issued)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    IO_ADMISSION_WAITER* captured_waiter;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_batch_submit_with_io_limit_queue_counts_a_queued_io_as_issued.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char source[10];
+    unsigned char destination[20];
+    uint32_t submitted_count = 0;
+    LPOVERLAPPED captured_ov_1;
+    LPOVERLAPPED captured_ov_2;
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 100, mock_user_callback, (void*)45));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 200, mock_user_callback, (void*)46));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, destination, sizeof(destination), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_2)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, submitted_count);
+
+    ///arrange
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_1)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 100, captured_ov_1->Offset);
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov_1, NO_ERROR, sizeof(source), NULL);
+    captured_callback(NULL, NULL, captured_ov_2, NO_ERROR, sizeof(destination), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_253: [ If acquiring the slots of an I/O fails, file_batch_submit shall not issue it, release the slots of the file handle acquired for the I/Os that follow it, release the contexts of this I/O and of all the I/Os that follow it to the I/O context pool, set submitted_count to the number of issued I/Os and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_submit_with_io_limit_busy_releases_the_reserved_slots_when_acquiring_the_slot_of_the_execution_engine_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_batch_submit_with_io_limit_busy_releases_the_reserved_slots_when_acquiring_the_slot_of_the_execution_engine_fails.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char source[10];
+    uint32_t submitted_count = 42;
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, (void*)45));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 10, mock_user_callback, (void*)46));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .SetReturn(IO_ADMISSION_ERROR);
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, submitted_count);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_254: [ If WriteFile or ReadFile fails synchronously for an I/O that holds slots of the I/O limits, file_batch_submit shall call release_io_slots and release the slots of the file handle acquired for the I/Os that follow it. ]*/
+TEST_FUNCTION(file_batch_submit_with_io_limit_busy_releases_the_slots_when_WriteFile_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_batch_submit_with_io_limit_busy_releases_the_slots_when_WriteFile_fails.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char source[10];
+    uint32_t submitted_count = 42;
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, (void*)45));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 10, mock_user_callback, (void*)46));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_INCOMPLETE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_admission_release(test_engine_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, submitted_count);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_255: [ If an I/O that holds slots of the I/O limits succeeds synchronously, file_batch_submit shall call release_io_slots before calling its user_callback. ]*/
+TEST_FUNCTION(file_batch_submit_with_io_limit_releases_the_slots_of_an_io_that_completes_synchronously)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_batch_submit_with_io_limit_releases_the_slots_of_an_io_that_completes_synchronously.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char destination[10];
+    uint32_t submitted_count = 0;
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 0, mock_user_callback, (void*)45));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_admission_try_acquire(test_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, destination, sizeof(destination), NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_admission_release(test_engine_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)45, true));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_count);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_147: [ The aggregated writes, the reads of read-ahead blocks and the flushes of handle shall be queued when no slot of the I/O limits is free, whatever the mode of handle. ]*/
+/*Tests_SRS_FILE_WIN32_01_048: [ file_flush_async shall increment the number of pending flushes and call start_io with the flush context of handle and FILE_IO_LIMIT_MODE_QUEUE, which calls TrySubmitThreadpoolCallback with on_file_flush_win32 and the threadpool environment of handle once the flush holds a slot of the I/O limits. ]*/
+/*Tests_SRS_FILE_WIN32_01_232: [ If the I/O is the flush of the file handle, issue_io shall call TrySubmitThreadpoolCallback with on_file_flush_win32 and the threadpool environment of the file handle. ]*/
+TEST_FUNCTION(file_flush_async_with_io_limit_busy_queues_the_flush_when_the_file_handle_has_no_free_slot)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    IO_ADMISSION_WAITER* captured_waiter;
+    PTP_SIMPLE_CALLBACK captured_flush_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_flush_async_with_io_limit_busy_queues_the_flush_when_the_file_handle_has_no_free_slot.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    int result = file_flush_async(file_handle, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///arrange
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, file_handle, IGNORED_ARG))
+        .CaptureArgumentValue_pfns(&captured_flush_callback);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_flush_callback);
+
+    ///cleanup
+    captured_flush_callback(NULL, file_handle);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_223: [ If the flush holds slots of the I/O limits, on_file_flush_win32 shall call release_io_slots before calling the user_callback of the requests. ]*/
+TEST_FUNCTION(on_file_flush_win32_with_io_limit_releases_the_slots_of_the_flush)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    PTP_SIMPLE_CALLBACK captured_flush_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("on_file_flush_win32_with_io_limit_releases_the_slots_of_the_flush.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_BUSY);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, file_handle, IGNORED_ARG))
+        .CaptureArgumentValue_pfns(&captured_flush_callback);
+    ASSERT_ARE_EQUAL(int, 0, file_flush_async(file_handle, mock_user_callback, (void*)0x4245));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_FlushFileBuffers(fake_handle));
+    STRICT_EXPECTED_CALL(io_admission_release(test_engine_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_flush_callback(NULL, file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_120: [ If a queued I/O fails to start, its user_callback shall be called with user_context and is_successful as false. ]*/
+/*Tests_SRS_FILE_WIN32_01_238: [ If the I/O is the flush of the file handle, fail_queued_io shall call the user_callback of all the requests served by the flush with is_successful as false, release them to the I/O context pool, mark the flush as not in progress, start a new flush if requests were added and decrement the number of pending flushes. ]*/
+TEST_FUNCTION(on_file_io_admitted_by_engine_fails_the_flush_when_TrySubmitThreadpoolCallback_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    IO_ADMISSION_WAITER* captured_waiter;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("on_file_io_admitted_by_engine_fails_the_flush_when_TrySubmitThreadpoolCallback_fails.txt", &captured_callback, test_engine_io_admission, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(int, 0, file_flush_async(file_handle, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, file_handle, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(io_admission_release(test_engine_io_admission));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_147: [ The aggregated writes, the reads of read-ahead blocks and the flushes of handle shall be queued when no slot of the I/O limits is free, whatever the mode of handle. ]*/
+/*Tests_SRS_FILE_WIN32_01_224: [ issue_aggregated_write shall populate an OVERLAPPED struct with the position of the aggregated write. ]*/
+/*Tests_SRS_FILE_WIN32_01_225: [ issue_aggregated_write shall start the write by calling start_io with FILE_IO_LIMIT_MODE_QUEUE, which calls issue_aggregated_write_io once the write holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+/*Tests_SRS_FILE_WIN32_01_227: [ issue_aggregated_write shall succeed and return 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_233: [ If the I/O is an aggregated write, issue_io shall call issue_aggregated_write_io. ]*/
+TEST_FUNCTION(issue_aggregated_write_with_io_limit_busy_queues_the_write_when_the_file_handle_has_no_free_slot)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    IO_ADMISSION_WAITER* captured_waiter;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("issue_aggregated_write_with_io_limit_busy_queues_the_write_when_the_file_handle_has_no_free_slot.txt", &captured_callback, &captured_timer_callback);
+    set_io_limit(file_handle, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char buffer[100];
+    WRITE_AGGREGATOR_IO aggregated_io = { 0x100000010, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    int result = captured_issue_io(captured_write_aggregator_context, &aggregated_io);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///arrange
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, buffer, sizeof(buffer), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0x10, (uint32_t)captured_ov->Offset);
+    ASSERT_ARE_EQUAL(uint32_t, 1, (uint32_t)captured_ov->OffsetHigh);
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(buffer), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_226: [ If start_io fails, issue_aggregated_write shall release the context and return a non-zero value. ]*/
+TEST_FUNCTION(issue_aggregated_write_with_io_limit_fails_when_io_admission_acquire_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("issue_aggregated_write_with_io_limit_fails_when_io_admission_acquire_fails.txt", &captured_callback, &captured_timer_callback);
+    set_io_limit(file_handle, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char buffer[100];
+    WRITE_AGGREGATOR_IO aggregated_io = { 0, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .SetReturn(IO_ADMISSION_ERROR);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    int result = captured_issue_io(captured_write_aggregator_context, &aggregated_io);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_222: [ If the completed operation is an aggregated write or a read-ahead block read that holds slots of the I/O limits, on_file_io_complete_win32 shall call release_io_slots before calling write_aggregator_io_complete or read_ahead_io_complete. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_for_an_aggregated_write_with_io_limit_releases_the_slots)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("on_file_io_complete_win32_for_an_aggregated_write_with_io_limit_releases_the_slots.txt", &captured_callback, &captured_timer_callback);
+    set_io_limit(file_handle, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char buffer[100];
+    WRITE_AGGREGATOR_IO aggregated_io = { 0, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, buffer, sizeof(buffer), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    ASSERT_ARE_EQUAL(int, 0, captured_issue_io(captured_write_aggregator_context, &aggregated_io));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(write_aggregator_io_complete(test_write_aggregator, &aggregated_io, true));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(buffer), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_239: [ If the I/O is an aggregated write, fail_queued_io shall release the context and call write_aggregator_io_complete with is_successful as false. ]*/
+TEST_FUNCTION(on_file_io_admitted_by_engine_fails_the_aggregated_write_when_WriteFile_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    PTP_TIMER_CALLBACK captured_timer_callback = NULL;
+    IO_ADMISSION_WAITER* captured_waiter;
+    FILE_HANDLE file_handle = get_file_handle_with_write_aggregation("on_file_io_admitted_by_engine_fails_the_aggregated_write_when_WriteFile_fails.txt", &captured_callback, &captured_timer_callback);
+    set_io_limit(file_handle, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char buffer[100];
+    WRITE_AGGREGATOR_IO aggregated_io = { 0, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(int, 0, captured_issue_io(captured_write_aggregator_context, &aggregated_io));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, buffer, sizeof(buffer), NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_INCOMPLETE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(write_aggregator_io_complete(test_write_aggregator, &aggregated_io, false));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_147: [ The aggregated writes, the reads of read-ahead blocks and the flushes of handle shall be queued when no slot of the I/O limits is free, whatever the mode of handle. ]*/
+/*Tests_SRS_FILE_WIN32_01_228: [ issue_read_ahead shall populate an OVERLAPPED struct with the position of the block. ]*/
+/*Tests_SRS_FILE_WIN32_01_229: [ issue_read_ahead shall start the read by calling start_io with FILE_IO_LIMIT_MODE_QUEUE, which calls issue_read_ahead_io once the read holds a slot of the I/O limits of the file handle and of the execution engine. ]*/
+/*Tests_SRS_FILE_WIN32_01_231: [ issue_read_ahead shall succeed and return 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_234: [ If the I/O is a read-ahead block read, issue_io shall call issue_read_ahead_io. ]*/
+TEST_FUNCTION(issue_read_ahead_with_io_limit_busy_queues_the_read_when_the_file_handle_has_no_free_slot)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    IO_ADMISSION_WAITER* captured_waiter;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("issue_read_ahead_with_io_limit_busy_queues_the_read_when_the_file_handle_has_no_free_slot.txt", &captured_callback);
+    set_io_limit(file_handle, FILE_IO_LIMIT_MODE_BUSY);
+    unsigned char buffer[100];
+    READ_AHEAD_IO read_ahead_io = { 0x100000010, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    int result = captured_read_ahead_issue_io(captured_read_ahead_context, &read_ahead_io);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///arrange
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, buffer, sizeof(buffer), IGNORED_ARG, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0x10, (uint32_t)captured_ov->Offset);
+    ASSERT_ARE_EQUAL(uint32_t, 1, (uint32_t)captured_ov->OffsetHigh);
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(buffer), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_230: [ If start_io fails, issue_read_ahead shall release the context and return a non-zero value. ]*/
+TEST_FUNCTION(issue_read_ahead_with_io_limit_fails_when_io_admission_acquire_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("issue_read_ahead_with_io_limit_fails_when_io_admission_acquire_fails.txt", &captured_callback);
+    set_io_limit(file_handle, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char buffer[100];
+    READ_AHEAD_IO read_ahead_io = { 0, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .SetReturn(IO_ADMISSION_ERROR);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    int result = captured_read_ahead_issue_io(captured_read_ahead_context, &read_ahead_io);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_222: [ If the completed operation is an aggregated write or a read-ahead block read that holds slots of the I/O limits, on_file_io_complete_win32 shall call release_io_slots before calling write_aggregator_io_complete or read_ahead_io_complete. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_for_a_read_ahead_block_with_io_limit_releases_the_slots)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("on_file_io_complete_win32_for_a_read_ahead_block_with_io_limit_releases_the_slots.txt", &captured_callback);
+    set_io_limit(file_handle, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char buffer[100];
+    READ_AHEAD_IO read_ahead_io = { 0, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, buffer, sizeof(buffer), IGNORED_ARG, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    ASSERT_ARE_EQUAL(int, 0, captured_read_ahead_issue_io(captured_read_ahead_context, &read_ahead_io));
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(read_ahead_io_complete(test_read_ahead, &read_ahead_io, true, sizeof(buffer)));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(buffer), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_240: [ If the I/O is a read-ahead block read, fail_queued_io shall release the context and call read_ahead_io_complete with is_successful as false and 0 bytes read. ]*/
+TEST_FUNCTION(on_file_io_admitted_by_engine_fails_the_read_ahead_block_when_ReadFile_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    IO_ADMISSION_WAITER* captured_waiter;
+    FILE_HANDLE file_handle = get_file_handle_with_read_ahead("on_file_io_admitted_by_engine_fails_the_read_ahead_block_when_ReadFile_fails.txt", &captured_callback);
+    set_io_limit(file_handle, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char buffer[100];
+    READ_AHEAD_IO read_ahead_io = { 0, buffer, sizeof(buffer) };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+    ASSERT_ARE_EQUAL(int, 0, captured_read_ahead_issue_io(captured_read_ahead_context, &read_ahead_io));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, buffer, sizeof(buffer), IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_INCOMPLETE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_admission_release(test_io_admission));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_io_complete(test_read_ahead, &read_ahead_io, false, 0));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* file_get_io_admission_statistics */
+
+/*Tests_SRS_FILE_01_122: [ If handle is NULL then file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_get_io_admission_statistics_with_NULL_handle_fails)
+{
+    ///arrange
+    IO_ADMISSION_STATISTICS statistics;
+
+    ///act
+    int result = file_get_io_admission_statistics(NULL, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_123: [ If statistics is NULL then file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_get_io_admission_statistics_with_NULL_statistics_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_get_io_admission_statistics_with_NULL_statistics_fails.txt", &captured_callback, NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+
+    ///act
+    int result = file_get_io_admission_statistics(file_handle, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_124: [ If no I/O limit was set on handle or it was set with max_outstanding_io 0 then file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_get_io_admission_statistics_fails_when_no_io_limit_was_set)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_get_io_admission_statistics_fails_when_no_io_limit_was_set.txt");
+    IO_ADMISSION_STATISTICS statistics;
+
+    ///act
+    int result = file_get_io_admission_statistics(file_handle, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_125: [ file_get_io_admission_statistics shall fill statistics with the counters of the I/O limit of handle and return 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_189: [ file_get_io_admission_statistics shall call io_admission_get_statistics on the admission of handle. ]*/
+TEST_FUNCTION(file_get_io_admission_statistics_succeeds)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_get_io_admission_statistics_succeeds.txt", &captured_callback, NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    IO_ADMISSION_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(io_admission_get_statistics(test_io_admission, &statistics));
+
+    ///act
+    int result = file_get_io_admission_statistics(file_handle, &statistics);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_190: [ If io_admission_get_statistics fails, file_get_io_admission_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_get_io_admission_statistics_fails_when_io_admission_get_statistics_fails)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_get_io_admission_statistics_fails_when_io_admission_get_statistics_fails.txt", &captured_callback, NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    IO_ADMISSION_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(io_admission_get_statistics(test_io_admission, &statistics))
+        .SetReturn(MU_FAILURE);
+
+    ///act
+    int result = file_get_io_admission_statistics(file_handle, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* file_set_io_priority */
+
+/*Tests_SRS_FILE_01_126: [ If handle is NULL then file_set_io_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_io_priority_with_NULL_handle_fails)
+{
+    ///act
+    int result = file_set_io_priority(NULL, FILE_IO_PRIORITY_LOW);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_127: [ If priority is not FILE_IO_PRIORITY_NORMAL or FILE_IO_PRIORITY_LOW then file_set_io_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_io_priority_with_invalid_priority_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_io_priority_with_invalid_priority_fails.txt");
+
+    ///act
+    int result = file_set_io_priority(file_handle, (FILE_IO_PRIORITY)0x42);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_128: [ file_set_io_priority shall set the priority class of the I/Os of handle to priority and return 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_192: [ file_set_io_priority shall call SetFileInformationByHandle with FileIoPriorityHintInfo and IoPriorityHintNormal for FILE_IO_PRIORITY_NORMAL or IoPriorityHintLow for FILE_IO_PRIORITY_LOW. ]*/
+/*Tests_SRS_FILE_WIN32_01_194: [ file_set_io_priority shall set the admission priority of handle to IO_ADMISSION_PRIORITY_NORMAL for FILE_IO_PRIORITY_NORMAL or IO_ADMISSION_PRIORITY_LOW for FILE_IO_PRIORITY_LOW and return 0. ]*/
+TEST_FUNCTION(file_set_io_priority_LOW_sets_the_low_priority_hint)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_io_priority_LOW_sets_the_low_priority_hint.txt");
+    captured_priority_hint = MaximumIoPriorityHintType;
+
+    STRICT_EXPECTED_CALL(mock_SetFileInformationByHandle(fake_handle, FileIoPriorityHintInfo, IGNORED_ARG, sizeof(FILE_IO_PRIORITY_HINT_INFO)));
+
+    ///act
+    int result = file_set_io_priority(file_handle, FILE_IO_PRIORITY_LOW);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, IoPriorityHintLow, captured_priority_hint);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_192: [ file_set_io_priority shall call SetFileInformationByHandle with FileIoPriorityHintInfo and IoPriorityHintNormal for FILE_IO_PRIORITY_NORMAL or IoPriorityHintLow for FILE_IO_PRIORITY_LOW. ]*/
+/*Tests_SRS_FILE_WIN32_01_194: [ file_set_io_priority shall set the admission priority of handle to IO_ADMISSION_PRIORITY_NORMAL for FILE_IO_PRIORITY_NORMAL or IO_ADMISSION_PRIORITY_LOW for FILE_IO_PRIORITY_LOW and return 0. ]*/
+TEST_FUNCTION(file_set_io_priority_NORMAL_sets_the_normal_priority_hint)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_io_priority_NORMAL_sets_the_normal_priority_hint.txt");
+    captured_priority_hint = MaximumIoPriorityHintType;
+
+    STRICT_EXPECTED_CALL(mock_SetFileInformationByHandle(fake_handle, FileIoPriorityHintInfo, IGNORED_ARG, sizeof(FILE_IO_PRIORITY_HINT_INFO)));
+
+    ///act
+    int result = file_set_io_priority(file_handle, FILE_IO_PRIORITY_NORMAL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, IoPriorityHintNormal, captured_priority_hint);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_130: [ If there are any other failures, file_set_io_priority shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_193: [ If SetFileInformationByHandle fails, file_set_io_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_set_io_priority_fails_when_SetFileInformationByHandle_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_set_io_priority_fails_when_SetFileInformationByHandle_fails.txt");
+
+    STRICT_EXPECTED_CALL(mock_SetFileInformationByHandle(fake_handle, FileIoPriorityHintInfo, IGNORED_ARG, sizeof(FILE_IO_PRIORITY_HINT_INFO)))
+        .SetReturn(FALSE);
+
+    ///act
+    int result = file_set_io_priority(file_handle, FILE_IO_PRIORITY_LOW);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_129: [ An I/O of a FILE_IO_PRIORITY_LOW file handle that waits for a slot of an I/O limit shall only be started when no I/O of a FILE_IO_PRIORITY_NORMAL file handle waits for a slot of the same limit. ]*/
+/*Tests_SRS_FILE_WIN32_01_195: [ acquire_io_slots and acquire_engine_io_slot shall call io_admission_acquire with the admission priority of the file handle as priority of the waiter. ]*/
+TEST_FUNCTION(file_write_async_of_a_low_priority_file_handle_waits_for_the_slot_of_the_file_handle_with_low_priority)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    IO_ADMISSION_WAITER* captured_waiter;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_write_async_of_a_low_priority_file_handle_waits_for_the_slot_of_the_file_handle_with_low_priority.txt", &captured_callback, NULL, TEST_MAX_OUTSTANDING_IO, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char source[10];
+    ASSERT_ARE_EQUAL(int, 0, file_set_io_priority(file_handle, FILE_IO_PRIORITY_LOW));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async(file_handle, source, sizeof(source), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, IO_ADMISSION_PRIORITY_LOW, captured_waiter->priority);
+
+    ///cleanup
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_195: [ acquire_io_slots and acquire_engine_io_slot shall call io_admission_acquire with the admission priority of the file handle as priority of the waiter. ]*/
+TEST_FUNCTION(file_read_async_of_a_low_priority_file_handle_waits_for_the_slot_of_the_execution_engine_with_low_priority)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback;
+    IO_ADMISSION_WAITER* captured_waiter;
+    FILE_HANDLE file_handle = get_file_handle_with_io_limit("file_read_async_of_a_low_priority_file_handle_waits_for_the_slot_of_the_execution_engine_with_low_priority.txt", &captured_callback, test_engine_io_admission, 0, FILE_IO_LIMIT_MODE_QUEUE);
+    unsigned char destination[10];
+    ASSERT_ARE_EQUAL(int, 0, file_set_io_priority(file_handle, FILE_IO_PRIORITY_LOW));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_admission_acquire(test_engine_io_admission, IGNORED_ARG))
+        .CaptureArgumentValue_waiter(&captured_waiter)
+        .SetReturn(IO_ADMISSION_QUEUED);
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async(file_handle, destination, sizeof(destination), 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, IO_ADMISSION_PRIORITY_LOW, captured_waiter->priority);
+
+    ///cleanup
+    captured_waiter->on_admitted(captured_waiter->on_admitted_context);
+    file_destroy(file_handle);
+}
+
+/* file_get_io_context_pool_statistics */
+
+/*Tests_SRS_FILE_01_055: [ If handle is NULL then file_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_get_io_context_pool_statistics_with_NULL_handle_fails)
+{
+    ///arrange
+    IO_CONTEXT_POOL_STATISTICS statistics;
+
+    ///act
+    int result = file_get_io_context_pool_statistics(NULL, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_056: [ If statistics is NULL then file_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_get_io_context_pool_statistics_with_NULL_statistics_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_get_io_context_pool_statistics_with_NULL_statistics_fails.txt");
+
+    ///act
+    int result = file_get_io_context_pool_statistics(file_handle, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_057: [ file_get_io_context_pool_statistics shall fill statistics with the hit and miss counters of the I/O context pool of handle and return 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_034: [ file_get_io_context_pool_statistics shall call io_context_pool_get_statistics on the I/O context pool of handle. ]*/
+/*Tests_SRS_FILE_WIN32_01_036: [ Otherwise file_get_io_context_pool_statistics shall succeed and return 0. ]*/
+TEST_FUNCTION(file_get_io_context_pool_statistics_succeeds)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_get_io_context_pool_statistics_succeeds.txt");
+    IO_CONTEXT_POOL_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get_statistics(test_io_context_pool, &statistics));
+
+    ///act
+    int result = file_get_io_context_pool_statistics(file_handle, &statistics);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_035: [ If io_context_pool_get_statistics fails, file_get_io_context_pool_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_get_io_context_pool_statistics_fails_when_io_context_pool_get_statistics_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_get_io_context_pool_statistics_fails_when_io_context_pool_get_statistics_fails.txt");
+    IO_CONTEXT_POOL_STATISTICS statistics;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get_statistics(test_io_context_pool, &statistics))
+        .SetReturn(MU_FAILURE);
+
+    ///act
+    int result = file_get_io_context_pool_statistics(file_handle, &statistics);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_43_034: [ on_file_io_complete_win32 shall recover the file handle, the number of bytes requested by the user, user_callback and user_context from the context containing overlapped. ]*/
+/*Tests_SRS_FILE_WIN32_43_066: [ on_file_io_complete_win32 shall call user_callback with is_successful as true if and only if io_result is equal to NO_ERROR and number_of_bytes_transferred is equal to the number of bytes requested by the user. ]*/
+/*Tests_SRS_FILE_WIN32_01_033: [ on_file_io_complete_win32 shall release the context of the operation to the I/O context pool of the file handle. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_calls_callback_successfully_for_write)
+{
+    ///arrange
+    unsigned char source[10];
+    uint64_t position = 11;
+    void* user_context = (void*)20;
+
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov;
+
+    FILE_HANDLE file_handle = start_file_io_async(FILE_WRITE_ASYNC, source, sizeof(source), position, mock_user_callback, user_context,  &captured_callback, &captured_ov);
+
+    STRICT_EXPECTED_CALL(mock_CloseHandle(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, true));
+    ASSERT_ARE_EQUAL(uint64_t, position, captured_ov->Offset);
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_43_034: [ on_file_io_complete_win32 shall recover the file handle, the number of bytes requested by the user, user_callback and user_context from the context containing overlapped. ]*/
+/*Tests_SRS_FILE_WIN32_43_068: [ If either io_result is not equal to NO_ERROR or number_of_bytes_transferred is not equal to the bytes requested by the user, on_file_io_complete_win32 shall return false. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_calls_callback_unsuccessfully_for_write_because_io_failed)
+{
+    ///arrange
+    unsigned char source[10];
+    uint64_t position = 11;
+    void* user_context = (void*)20;
+
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov;
+
+    FILE_HANDLE file_handle = start_file_io_async(FILE_WRITE_ASYNC, source, sizeof(source), position, mock_user_callback, user_context,  &captured_callback, &captured_ov);
+
+    STRICT_EXPECTED_CALL(mock_CloseHandle(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, false));
+    ASSERT_ARE_EQUAL(uint64_t, position, captured_ov->Offset);
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, ERROR_IO_INCOMPLETE, sizeof(source), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_43_034: [on_file_io_complete_win32 shall recover the file handle, the number of bytes requested by the user, user_callback and user_context from the context containing overlapped.]*/
+/*Tests_SRS_FILE_WIN32_43_068 : [If either GetOverlappedResult returns false or number_of_bytes_transferred is not equal to the bytes requested by the user, on_file_io_complete_win32 shall return false.]*/
+TEST_FUNCTION(on_file_io_complete_win32_calls_callback_unsuccessfully_for_write_because_num_bytes_is_less)
+{
+    ///arrange
+    unsigned char source[10];
+    uint64_t position = 11;
+    void* user_context = (void*)20;
+
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov;
+
+    FILE_HANDLE file_handle = start_file_io_async(FILE_WRITE_ASYNC, source, sizeof(source), position, mock_user_callback, user_context,  &captured_callback, &captured_ov);
+
+    STRICT_EXPECTED_CALL(mock_CloseHandle(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, false));
+    ASSERT_ARE_EQUAL(uint64_t, position, captured_ov->Offset);
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source)-1, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_43_034: [ on_file_io_complete_win32 shall recover the file handle, the number of bytes requested by the user, user_callback and user_context from the context containing overlapped. ]*/
+/*Tests_SRS_FILE_WIN32_43_066: [ on_file_io_complete_win32 shall call user_callback with is_successful as true if and only if io_result is equal to NO_ERROR and number_of_bytes_transferred is equal to the number of bytes requested by the user. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_calls_callback_successfully_for_read)
+{
+    ///arrange
+    unsigned char destination[10];
+    uint64_t position = 11;
+    void* user_context = (void*)20;
+
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov;
+
+    FILE_HANDLE file_handle = start_file_io_async(FILE_READ_ASYNC, destination, sizeof(destination), position, mock_user_callback, user_context,  &captured_callback, &captured_ov);
+
+    STRICT_EXPECTED_CALL(mock_CloseHandle(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, true));
+    ASSERT_ARE_EQUAL(uint64_t, position, captured_ov->Offset);
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(destination), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_43_034: [ on_file_io_complete_win32 shall recover the file handle, the number of bytes requested by the user, user_callback and user_context from the context containing overlapped. ]*/
+/*Tests_SRS_FILE_WIN32_43_068: [ If either io_result is not equal to NO_ERROR or number_of_bytes_transferred is not equal to the bytes requested by the user, on_file_io_complete_win32 shall return false. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_calls_callback_unsuccessfully_for_read_because_io_failed)
+{
+    ///arrange
+    unsigned char destination[10];
+    uint64_t position = 11;
+    void* user_context = (void*)20;
+
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov;
+
+    FILE_HANDLE file_handle = start_file_io_async(FILE_READ_ASYNC, destination, sizeof(destination), position, mock_user_callback, user_context,  &captured_callback, &captured_ov);
+
+    STRICT_EXPECTED_CALL(mock_CloseHandle(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, false));
+    ASSERT_ARE_EQUAL(uint64_t, position, captured_ov->Offset);
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, ERROR_IO_INCOMPLETE, sizeof(destination), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_43_034: [on_file_io_complete_win32 shall recover the file handle, the number of bytes requested by the user, user_callback and user_context from the context containing overlapped.]*/
+/*Tests_SRS_FILE_WIN32_43_068 : [If either GetOverlappedResult returns false or number_of_bytes_transferred is not equal to the bytes requested by the user, on_file_io_complete_win32 shall return false.]*/
+TEST_FUNCTION(on_file_io_complete_win32_calls_callback_unsuccessfully_for_read_because_num_bytes_is_less)
+{
+    ///arrange
+    unsigned char destination[10];
+    uint64_t position = 11;
+    void* user_context = (void*)20;
+
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    LPOVERLAPPED captured_ov;
+
+    FILE_HANDLE file_handle = start_file_io_async(FILE_READ_ASYNC, destination, sizeof(destination), position, mock_user_callback, user_context,  &captured_callback, &captured_ov);
+
+    STRICT_EXPECTED_CALL(mock_CloseHandle(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, false));
+    ASSERT_ARE_EQUAL(uint64_t, position, captured_ov->Offset);
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(destination) -1, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* file_write_async_v */
+
+/*Tests_SRS_FILE_01_001: [ If handle is NULL then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_v_fails_with_null_handle)
+{
+    ///arrange
+    unsigned char source[10];
+    FILE_BUFFER buffers[1] = { { source, sizeof(source) } };
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(NULL, buffers, 1, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+}
+
+/*Tests_SRS_FILE_01_002: [ If buffers is NULL then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_v_fails_with_null_buffers)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_write_async_v_fails_with_null_buffers.txt");
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, NULL, 1, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_003: [ If buffer_count is 0 then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_v_fails_with_zero_buffer_count)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_write_async_v_fails_with_zero_buffer_count.txt");
+    unsigned char source[10];
+    FILE_BUFFER buffers[1] = { { source, sizeof(source) } };
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 0, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_004: [ If user_callback is NULL then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_v_fails_with_null_user_callback)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_write_async_v_fails_with_null_user_callback.txt");
+    unsigned char source[10];
+    FILE_BUFFER buffers[1] = { { source, sizeof(source) } };
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 1, 0, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_005: [ If any of the buffers has a NULL buffer or a length of 0 then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_v_fails_when_a_buffer_length_is_zero)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_write_async_v_fails_when_a_buffer_length_is_zero.txt");
+    unsigned char source[10];
+    FILE_BUFFER buffers[2] = { { source, sizeof(source) }, { source, 0 } };
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_007: [ If position + the sum of the buffer lengths is greater than INT64_MAX, then file_write_async_v shall fail and return FILE_WRITE_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_write_async_v_fails_if_position_plus_size_is_greater_than_INT64_MAX)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_write_async_v_fails_if_position_plus_size_is_greater_than_INT64_MAX.txt");
+    unsigned char source[10];
+    FILE_BUFFER buffers[2] = { { source, 5 }, { source + 5, 5 } };
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, INT64_MAX - 5, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_INVALID_ARGS, result);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_004: [ file_write_async_v shall get a context to store user_callback, user_context, the number of pending parts and an OVERLAPPED struct for each buffer from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_WIN32_01_005: [ The number of pending parts shall be initialized to buffer_count + 1, the extra part being released once all the parts were issued. ]*/
+/*Tests_SRS_FILE_WIN32_01_006: [ For each buffer, an OVERLAPPED struct shall be populated with the position of the buffer, which is position plus the sum of the lengths of the buffers before it. ]*/
+/*Tests_SRS_FILE_WIN32_01_007: [ For each buffer, StartThreadpoolIo shall be called and then WriteFile (for file_write_async_v) or ReadFile (for file_read_async_v) with the buffer, its length and the OVERLAPPED struct. ]*/
+/*Tests_SRS_FILE_01_012: [ file_write_async_v shall succeed and return FILE_WRITE_ASYNC_OK. ]*/
+TEST_FUNCTION(file_write_async_v_succeeds_asynchronously)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_write_async_v_succeeds_asynchronously.txt");
+    unsigned char header[4];
+    unsigned char payload[10];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+    LPOVERLAPPED captured_ov_1;
+    LPOVERLAPPED captured_ov_2;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, header, sizeof(header), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_1)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, payload, sizeof(payload), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_2)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 100, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+    ASSERT_ARE_EQUAL(uint32_t, 100, captured_ov_1->Offset);
+    ASSERT_ARE_EQUAL(uint32_t, 104, captured_ov_2->Offset);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_012: [ If the completed operation is a part of a vectored operation, on_file_io_complete_win32 shall record whether io_result is NO_ERROR and number_of_bytes_transferred is equal to the size of the part. ]*/
+/*Tests_SRS_FILE_WIN32_01_013: [ When the last part of a vectored operation completes, on_file_io_complete_win32 shall release the vectored operation context to the I/O context pool and call user_callback with is_successful as true if and only if all the parts were successful. ]*/
+/*Tests_SRS_FILE_01_010: [ file_write_async_v shall call user_callback passing user_context and is_successful as true if and only if all the bytes of all the buffers were written. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_calls_callback_once_when_all_parts_of_a_vectored_write_complete)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_and_callback("test_file.txt", &captured_callback);
+    unsigned char header[4];
+    unsigned char payload[10];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+    void* user_context = (void*)45;
+    LPOVERLAPPED captured_ov_1;
+    LPOVERLAPPED captured_ov_2;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, header, sizeof(header), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_1)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, payload, sizeof(payload), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_2)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, user_context));
+    umock_c_reset_all_calls();
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov_2, NO_ERROR, sizeof(payload), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///arrange
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, true));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov_1, NO_ERROR, sizeof(header), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_013: [ When the last part of a vectored operation completes, on_file_io_complete_win32 shall release the vectored operation context to the I/O context pool and call user_callback with is_successful as true if and only if all the parts were successful. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_calls_callback_unsuccessfully_when_a_part_of_a_vectored_read_is_short)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_and_callback("test_file.txt", &captured_callback);
+    unsigned char header[4];
+    unsigned char payload[10];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+    void* user_context = (void*)45;
+    LPOVERLAPPED captured_ov_1;
+    LPOVERLAPPED captured_ov_2;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, header, sizeof(header), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_1)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, payload, sizeof(payload), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_2)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_OK, file_read_async_v(file_handle, buffers, 2, 0, mock_user_callback, user_context));
+    umock_c_reset_all_calls();
+
+    captured_callback(NULL, NULL, captured_ov_1, NO_ERROR, sizeof(header), NULL);
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, false));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov_2, NO_ERROR, sizeof(payload) - 1, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_008: [ If WriteFile or ReadFile succeeds synchronously, CancelThreadpoolIo shall be called and the part shall be considered successfully completed. ]*/
+TEST_FUNCTION(file_write_async_v_succeeds_synchronously)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_write_async_v_succeeds_synchronously.txt");
+    unsigned char header[4];
+    unsigned char payload[10];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+    void* user_context = (void*)45;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, header, sizeof(header), NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, payload, sizeof(payload), NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, true));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, user_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_009: [ If WriteFile or ReadFile fails synchronously and GetLastError does not indicate ERROR_IO_PENDING, CancelThreadpoolIo shall be called and no further parts shall be issued. ]*/
+/*Tests_SRS_FILE_WIN32_01_010: [ If the first part fails synchronously, the vectored operation context shall be released to the I/O context pool and the call shall fail. ]*/
+/*Tests_SRS_FILE_01_009: [ If the call to write the file fails, file_write_async_v shall fail and return FILE_WRITE_ASYNC_WRITE_ERROR. ]*/
+TEST_FUNCTION(file_write_async_v_fails_when_the_first_part_fails_synchronously)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_write_async_v_fails_when_the_first_part_fails_synchronously.txt");
+    unsigned char header[4];
+    unsigned char payload[10];
+    FILE_BUFFER buffers[2] = { { header, sizeof(header) }, { payload, sizeof(payload) } };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, header, sizeof(header), NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_INCOMPLETE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_WRITE_ERROR, result);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_011: [ If a part other than the first fails synchronously, the parts that were not issued shall be accounted as failed, and user_callback shall be called with is_successful as false once the issued parts complete. ]*/
+TEST_FUNCTION(file_write_async_v_calls_callback_unsuccessfully_when_the_second_part_fails_synchronously)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_and_callback("test_file.txt", &captured_callback);
+    unsigned char header[4];
+    unsigned char payload[10];
+    unsigned char trailer[4];
+    FILE_BUFFER buffers[3] = { { header, sizeof(header) }, { payload, sizeof(payload) }, { trailer, sizeof(trailer) } };
+    void* user_context = (void*)45;
+    LPOVERLAPPED captured_ov;
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, header, sizeof(header), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, payload, sizeof(payload), NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_INCOMPLETE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 3, 0, mock_user_callback, user_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_OK, result);
+
+    ///arrange
+    umock_c_reset_all_calls();
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback(user_context, false));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(header), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_011: [ If there are any other failures, file_write_async_v shall fail and return FILE_WRITE_ASYNC_ERROR. ]*/
+TEST_FUNCTION(file_write_async_v_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_write_async_v_fails_when_io_context_pool_get_fails.txt");
+    unsigned char source[10];
+    FILE_BUFFER buffers[2] = { { source, 5 }, { source + 5, 5 } };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    FILE_WRITE_ASYNC_RESULT result = file_write_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_WRITE_ASYNC_RESULT, FILE_WRITE_ASYNC_ERROR, result);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* file_read_async_v */
+
+/*Tests_SRS_FILE_01_013: [ If handle is NULL then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_read_async_v_fails_with_null_handle)
+{
+    ///arrange
+    unsigned char destination[10];
+    FILE_BUFFER buffers[1] = { { destination, sizeof(destination) } };
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async_v(NULL, buffers, 1, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_INVALID_ARGS, result);
+}
+
+/*Tests_SRS_FILE_01_017: [ If any of the buffers has a NULL buffer or a length of 0 then file_read_async_v shall fail and return FILE_READ_ASYNC_INVALID_ARGS. ]*/
+TEST_FUNCTION(file_read_async_v_fails_when_a_buffer_is_NULL)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_read_async_v_fails_when_a_buffer_is_NULL.txt");
+    unsigned char destination[10];
+    FILE_BUFFER buffers[2] = { { destination, sizeof(destination) }, { NULL, 5 } };
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_INVALID_ARGS, result);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_015: [ file_read_async_v shall get a context to store user_callback, user_context, the number of pending parts and an OVERLAPPED struct for each buffer from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_01_020: [ If the call to read the file fails, file_read_async_v shall fail and return FILE_READ_ASYNC_READ_ERROR. ]*/
+TEST_FUNCTION(file_read_async_v_fails_when_the_first_part_fails_synchronously)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_read_async_v_fails_when_the_first_part_fails_synchronously.txt");
+    unsigned char destination[10];
+    FILE_BUFFER buffers[2] = { { destination, 5 }, { destination + 5, 5 } };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, destination, 5, NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_INCOMPLETE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_READ_ERROR, result);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_022: [ If there are any other failures, file_read_async_v shall fail and return FILE_READ_ASYNC_ERROR. ]*/
+TEST_FUNCTION(file_read_async_v_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_read_async_v_fails_when_io_context_pool_get_fails.txt");
+    unsigned char destination[10];
+    FILE_BUFFER buffers[2] = { { destination, 5 }, { destination + 5, 5 } };
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    FILE_READ_ASYNC_RESULT result = file_read_async_v(file_handle, buffers, 2, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(FILE_READ_ASYNC_RESULT, FILE_READ_ASYNC_ERROR, result);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* file_batch_begin */
+
+/*Tests_SRS_FILE_01_024: [ If handle is NULL then file_batch_begin shall fail and return NULL. ]*/
+TEST_FUNCTION(file_batch_begin_fails_with_null_handle)
+{
+    ///act
+    FILE_BATCH_HANDLE batch = file_batch_begin(NULL, 4);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(batch);
+}
+
+/*Tests_SRS_FILE_01_025: [ If max_io_count is 0 then file_batch_begin shall fail and return NULL. ]*/
+TEST_FUNCTION(file_batch_begin_fails_with_zero_max_io_count)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_batch_begin_fails_with_zero_max_io_count.txt");
+
+    ///act
+    FILE_BATCH_HANDLE batch = file_batch_begin(file_handle, 0);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(batch);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_026: [ file_batch_begin shall create a batch that can hold up to max_io_count I/Os and return it. ]*/
+/*Tests_SRS_FILE_WIN32_01_016: [ file_batch_begin shall allocate a batch with room for max_io_count I/Os. ]*/
+TEST_FUNCTION(file_batch_begin_succeeds)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_batch_begin_succeeds.txt");
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+
+    ///act
+    FILE_BATCH_HANDLE batch = file_batch_begin(file_handle, 4);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(batch);
+
+    ///cleanup
+    file_batch_cancel(batch);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_027: [ If there are any failures, file_batch_begin shall fail and return NULL. ]*/
+/*Tests_SRS_FILE_WIN32_01_017: [ If there are any failures, file_batch_begin shall fail and return NULL. ]*/
+TEST_FUNCTION(file_batch_begin_fails_when_malloc_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_batch_begin_fails_when_malloc_fails.txt");
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    FILE_BATCH_HANDLE batch = file_batch_begin(file_handle, 4);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(batch);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* file_batch_add_write */
+
+/*Tests_SRS_FILE_01_028: [ If batch is NULL then file_batch_add_write shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_write_fails_with_null_batch)
+{
+    ///arrange
+    unsigned char source[10];
+
+    ///act
+    int result = file_batch_add_write(NULL, source, sizeof(source), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/*Tests_SRS_FILE_01_032: [ If position + size is greater than INT64_MAX then file_batch_add_write shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_write_fails_if_position_plus_size_is_greater_than_INT64_MAX)
+{
+    ///arrange
+    unsigned char source[10];
+    FILE_HANDLE file_handle = get_file_handle("file_batch_add_write_fails_if_position_plus_size_is_greater_than_INT64_MAX.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    ///act
+    int result = file_batch_add_write(batch, source, sizeof(source), INT64_MAX, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///cleanup
+    file_batch_cancel(batch);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_033: [ If batch already holds max_io_count I/Os then file_batch_add_write shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_write_fails_when_the_batch_is_full)
+{
+    ///arrange
+    unsigned char source[10];
+    FILE_HANDLE file_handle = get_file_handle("file_batch_add_write_fails_when_the_batch_is_full.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 1);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, NULL));
+    umock_c_reset_all_calls();
+
+    ///act
+    int result = file_batch_add_write(batch, source, sizeof(source), 10, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///cleanup
+    file_batch_cancel(batch);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_034: [ file_batch_add_write shall queue in batch a write request to write source's content to the position offset in the file. ]*/
+/*Tests_SRS_FILE_WIN32_01_018: [ file_batch_add_write shall get a context to store an OVERLAPPED struct populated with position and no event, the file handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_01_036: [ file_batch_add_write shall succeed and return 0. ]*/
+TEST_FUNCTION(file_batch_add_write_succeeds)
+{
+    ///arrange
+    unsigned char source[10];
+    FILE_HANDLE file_handle = get_file_handle("file_batch_add_write_succeeds.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    int result = file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    ///cleanup
+    file_batch_cancel(batch);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_035: [ If there are any other failures, file_batch_add_write shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_019: [ If there are any failures, file_batch_add_write shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_write_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    unsigned char source[10];
+    FILE_HANDLE file_handle = get_file_handle("file_batch_add_write_fails_when_io_context_pool_get_fails.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    int result = file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///cleanup
+    file_batch_cancel(batch);
+    file_destroy(file_handle);
+}
+
+/* file_batch_add_read */
+
+/*Tests_SRS_FILE_01_038: [ If destination is NULL then file_batch_add_read shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_read_fails_with_null_destination)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_batch_add_read_fails_with_null_destination.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    ///act
+    int result = file_batch_add_read(batch, NULL, 10, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///cleanup
+    file_batch_cancel(batch);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_042: [ file_batch_add_read shall queue in batch a read request to read handle's content at the position offset into destination. ]*/
+/*Tests_SRS_FILE_WIN32_01_020: [ file_batch_add_read shall get a context to store an OVERLAPPED struct populated with position and no event, the file handle, size, user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_01_044: [ file_batch_add_read shall succeed and return 0. ]*/
+TEST_FUNCTION(file_batch_add_read_succeeds)
+{
+    ///arrange
+    unsigned char destination[10];
+    FILE_HANDLE file_handle = get_file_handle("file_batch_add_read_succeeds.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    int result = file_batch_add_read(batch, destination, sizeof(destination), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    ///cleanup
+    file_batch_cancel(batch);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_043: [ If there are any other failures, file_batch_add_read shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_021: [ If there are any failures, file_batch_add_read shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_add_read_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    unsigned char destination[10];
+    FILE_HANDLE file_handle = get_file_handle("file_batch_add_read_fails_when_io_context_pool_get_fails.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    int result = file_batch_add_read(batch, destination, sizeof(destination), 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///cleanup
+    file_batch_cancel(batch);
+    file_destroy(file_handle);
+}
+
+/* file_batch_submit */
+
+/*Tests_SRS_FILE_01_046: [ If submitted_count is NULL then file_batch_submit shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_submit_fails_with_null_submitted_count)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_batch_submit_fails_with_null_submitted_count.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    ///act
+    int result = file_batch_submit(batch, NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    ///cleanup
+    file_batch_cancel(batch);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_047: [ If batch holds no I/Os then file_batch_submit shall set submitted_count to 0, free batch and return 0. ]*/
+TEST_FUNCTION(file_batch_submit_with_an_empty_batch_succeeds)
+{
+    ///arrange
+    uint32_t submitted_count = 42;
+    FILE_HANDLE file_handle = get_file_handle("file_batch_submit_with_an_empty_batch_succeeds.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 0, submitted_count);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_048: [ file_batch_submit shall issue all the I/Os queued in batch, in the order in which they were added. ]*/
+/*Tests_SRS_FILE_WIN32_01_022: [ For each I/O in the batch, in order, file_batch_submit shall call StartThreadpoolIo and then WriteFile or ReadFile with the buffer, the size and the OVERLAPPED struct of the I/O. ]*/
+/*Tests_SRS_FILE_WIN32_01_023: [ If WriteFile or ReadFile fails synchronously and GetLastError indicates ERROR_IO_PENDING, the I/O shall be considered issued and shall complete in on_file_io_complete_win32. ]*/
+/*Tests_SRS_FILE_01_051: [ file_batch_submit shall free batch. ]*/
+/*Tests_SRS_FILE_WIN32_01_026: [ file_batch_submit shall free the batch. ]*/
+/*Tests_SRS_FILE_01_052: [ On success file_batch_submit shall set submitted_count to the number of I/Os in batch and return 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_027: [ If all the I/Os were issued, file_batch_submit shall set submitted_count to the number of I/Os in the batch and return 0. ]*/
+TEST_FUNCTION(file_batch_submit_issues_all_the_ios)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_and_callback("test_file.txt", &captured_callback);
+    unsigned char source[10];
+    unsigned char destination[20];
+    uint32_t submitted_count = 0;
+    LPOVERLAPPED captured_ov_1;
+    LPOVERLAPPED captured_ov_2;
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 100, mock_user_callback, (void*)45));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 200, mock_user_callback, (void*)46));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_1)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, destination, sizeof(destination), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov_2)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 2, submitted_count);
+    ASSERT_ARE_EQUAL(uint32_t, 100, captured_ov_1->Offset);
+    ASSERT_IS_NULL(captured_ov_1->hEvent);
+    ASSERT_ARE_EQUAL(uint32_t, 200, captured_ov_2->Offset);
+    ASSERT_IS_NULL(captured_ov_2->hEvent);
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov_1, NO_ERROR, sizeof(source), NULL);
+    captured_callback(NULL, NULL, captured_ov_2, NO_ERROR, sizeof(destination), NULL);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_049: [ file_batch_submit shall call the user_callback of each issued I/O passing its user_context and is_successful as true if and only if all its bytes were transferred. ]*/
+/*Tests_SRS_FILE_WIN32_01_030: [ on_file_io_complete_win32 shall close the event of the OVERLAPPED struct only if the operation created one. ]*/
+TEST_FUNCTION(on_file_io_complete_win32_calls_the_callback_of_a_batched_io_without_closing_an_event)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_and_callback("test_file.txt", &captured_callback);
+    unsigned char source[10];
+    uint32_t submitted_count = 0;
+    LPOVERLAPPED captured_ov;
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, (void*)45));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(free(batch));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_submit(batch, &submitted_count));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)45, true));
+
+    ///act
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_024: [ If WriteFile or ReadFile succeeds synchronously, file_batch_submit shall call CancelThreadpoolIo, call the user_callback of the I/O with is_successful as true and release its context to the I/O context pool. ]*/
+TEST_FUNCTION(file_batch_submit_calls_the_callback_of_an_io_that_completes_synchronously)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_batch_submit_calls_the_callback_of_an_io_that_completes_synchronously.txt");
+    unsigned char destination[10];
+    uint32_t submitted_count = 0;
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_read(batch, destination, sizeof(destination), 0, mock_user_callback, (void*)45));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, destination, sizeof(destination), NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)45, true));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_count);
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_050: [ If issuing an I/O fails, file_batch_submit shall not issue the I/Os that follow it, discard all the I/Os that were not issued without calling their user_callback, set submitted_count to the number of issued I/Os and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_025: [ If WriteFile or ReadFile fails synchronously and GetLastError does not indicate ERROR_IO_PENDING, file_batch_submit shall call CancelThreadpoolIo, release the contexts of this I/O and of all the I/Os that follow it to the I/O context pool, set submitted_count to the number of issued I/Os and return a non-zero value. ]*/
+TEST_FUNCTION(file_batch_submit_stops_at_the_first_io_that_fails_synchronously)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle_and_callback("test_file.txt", &captured_callback);
+    unsigned char source[10];
+    uint32_t submitted_count = 0;
+    LPOVERLAPPED captured_ov;
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, (void*)45));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 10, mock_user_callback, (void*)46));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 20, mock_user_callback, (void*)47));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .CaptureArgumentValue_lpOverlapped(&captured_ov)
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_StartThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, source, sizeof(source), NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_INCOMPLETE);
+    STRICT_EXPECTED_CALL(mock_CancelThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    int result = file_batch_submit(batch, &submitted_count);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, submitted_count);
+
+    ///cleanup
+    captured_callback(NULL, NULL, captured_ov, NO_ERROR, sizeof(source), NULL);
+    file_destroy(file_handle);
+}
+
+/* file_batch_cancel */
+
+/*Tests_SRS_FILE_01_053: [ If batch is NULL then file_batch_cancel shall return. ]*/
+/*Tests_SRS_FILE_WIN32_01_028: [ If batch is NULL then file_batch_cancel shall return. ]*/
+TEST_FUNCTION(file_batch_cancel_with_null_batch_returns)
+{
+    ///act
+    file_batch_cancel(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_054: [ file_batch_cancel shall discard all the I/Os queued in batch without calling their user_callback and free batch. ]*/
+/*Tests_SRS_FILE_WIN32_01_029: [ file_batch_cancel shall release the contexts of all the I/Os in the batch to the I/O context pool and free the batch. ]*/
+TEST_FUNCTION(file_batch_cancel_frees_the_ios_and_the_batch)
+{
+    ///arrange
+    unsigned char source[10];
+    FILE_HANDLE file_handle = get_file_handle("file_batch_cancel_frees_the_ios_and_the_batch.txt");
+    FILE_BATCH_HANDLE batch = get_batch(file_handle, 4);
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 0, mock_user_callback, NULL));
+    ASSERT_ARE_EQUAL(int, 0, file_batch_add_write(batch, source, sizeof(source), 10, mock_user_callback, NULL));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(batch));
+
+    ///act
+    file_batch_cancel(batch);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* file_flush_async */
+
+/*Tests_SRS_FILE_01_058: [ If handle is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_039: [ If handle is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_flush_async_fails_with_null_handle)
+{
+    ///act
+    int result = file_flush_async(NULL, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_059: [ If user_callback is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_040: [ If user_callback is NULL then file_flush_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_flush_async_fails_with_null_user_callback)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_flush_async_fails_with_null_user_callback.txt");
+
+    ///act
+    int result = file_flush_async(file_handle, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_063: [ If there are any other failures, file_flush_async shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_042: [ If there are any failures, file_flush_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_flush_async_fails_when_io_context_pool_get_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_flush_async_fails_when_io_context_pool_get_fails.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    int result = file_flush_async(file_handle, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_041: [ file_flush_async shall get a flush request to hold user_callback and user_context from the I/O context pool by calling io_context_pool_get. ]*/
+/*Tests_SRS_FILE_WIN32_01_043: [ file_flush_async shall add the request to the list of flush requests of handle by calling interlocked_compare_exchange_pointer. ]*/
+/*Tests_SRS_FILE_WIN32_01_044: [ file_flush_async shall start a flush. ]*/
+/*Tests_SRS_FILE_WIN32_01_045: [ To start a flush, file_flush_async shall mark the flush as in progress, and if another flush is already in progress it shall return, leaving the requests to be served by the next flush. ]*/
+/*Tests_SRS_FILE_WIN32_01_046: [ file_flush_async shall take all the requests from the list of flush requests. ]*/
+/*Tests_SRS_FILE_WIN32_01_048: [ file_flush_async shall increment the number of pending flushes and call start_io with the flush context of handle and FILE_IO_LIMIT_MODE_QUEUE, which calls TrySubmitThreadpoolCallback with on_file_flush_win32 and the threadpool environment of handle once the flush holds a slot of the I/O limits. ]*/
+/*Tests_SRS_FILE_01_064: [ file_flush_async shall succeed and return 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_050: [ file_flush_async shall succeed and return 0. ]*/
+TEST_FUNCTION(file_flush_async_submits_a_threadpool_callback)
+{
+    ///arrange
+    PTP_SIMPLE_CALLBACK captured_flush_callback = NULL;
+    FILE_HANDLE file_handle = get_file_handle("file_flush_async_submits_a_threadpool_callback.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, file_handle, IGNORED_ARG))
+        .CaptureArgumentValue_pfns(&captured_flush_callback);
+
+    ///act
+    int result = file_flush_async(file_handle, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_flush_callback);
+
+    ///cleanup
+    captured_flush_callback(NULL, file_handle);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_061: [ A flush of the file shall serve all the file_flush_async requests that were queued when the flush started. ]*/
+/*Tests_SRS_FILE_WIN32_01_045: [ To start a flush, file_flush_async shall mark the flush as in progress, and if another flush is already in progress it shall return, leaving the requests to be served by the next flush. ]*/
+TEST_FUNCTION(file_flush_async_while_a_flush_is_in_progress_only_queues_the_request)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_flush_async_while_a_flush_is_in_progress_only_queues_the_request.txt");
+    PTP_SIMPLE_CALLBACK flush_callback = start_file_flush_async(file_handle, (void*)0x4245);
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+
+    ///act
+    int result = file_flush_async(file_handle, mock_user_callback, (void*)0x4246);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    flush_callback(NULL, file_handle);
+    flush_callback(NULL, file_handle);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_062: [ If flushing the file fails, file_flush_async shall call user_callback with is_successful as false. ]*/
+/*Tests_SRS_FILE_WIN32_01_049: [ If start_io fails, file_flush_async shall call the user_callback of all the taken requests with is_successful as false, release them to the I/O context pool, mark the flush as not in progress and decrement the number of pending flushes. ]*/
+/*Tests_SRS_FILE_WIN32_01_047: [ If there are no requests, file_flush_async shall mark the flush as not in progress and try again if a request was added in the meantime. ]*/
+TEST_FUNCTION(file_flush_async_when_TrySubmitThreadpoolCallback_fails_calls_user_callback_with_false)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_flush_async_when_TrySubmitThreadpoolCallback_fails_calls_user_callback_with_false.txt");
+
+    STRICT_EXPECTED_CALL(io_context_pool_get(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, file_handle, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    int result = file_flush_async(file_handle, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* on_file_flush_win32 */
+
+/*Tests_SRS_FILE_01_060: [ file_flush_async shall call user_callback with is_successful as true once the data of all the writes that completed before file_flush_async was called is durable. ]*/
+/*Tests_SRS_FILE_WIN32_01_051: [ on_file_flush_win32 shall call FlushFileBuffers on the file. ]*/
+/*Tests_SRS_FILE_WIN32_01_052: [ on_file_flush_win32 shall release all the requests served by the flush to the I/O context pool and call their user_callback, in the order in which file_flush_async was called, with is_successful as true if and only if FlushFileBuffers succeeded. ]*/
+/*Tests_SRS_FILE_WIN32_01_053: [ on_file_flush_win32 shall mark the flush as not in progress and start a new flush if requests were added while the flush was in progress. ]*/
+/*Tests_SRS_FILE_WIN32_01_054: [ on_file_flush_win32 shall decrement the number of pending flushes and wake up file_destroy by calling wake_by_address_single if it reaches 0. ]*/
+TEST_FUNCTION(on_file_flush_win32_calls_user_callback_with_true)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("on_file_flush_win32_calls_user_callback_with_true.txt");
+    PTP_SIMPLE_CALLBACK flush_callback = start_file_flush_async(file_handle, (void*)0x4245);
+
+    STRICT_EXPECTED_CALL(mock_FlushFileBuffers(fake_handle));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    flush_callback(NULL, file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_052: [ on_file_flush_win32 shall release all the requests served by the flush to the I/O context pool and call their user_callback, in the order in which file_flush_async was called, with is_successful as true if and only if FlushFileBuffers succeeded. ]*/
+TEST_FUNCTION(on_file_flush_win32_when_FlushFileBuffers_fails_calls_user_callback_with_false)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("on_file_flush_win32_when_FlushFileBuffers_fails_calls_user_callback_with_false.txt");
+    PTP_SIMPLE_CALLBACK flush_callback = start_file_flush_async(file_handle, (void*)0x4245);
+
+    STRICT_EXPECTED_CALL(mock_FlushFileBuffers(fake_handle))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    flush_callback(NULL, file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_061: [ A flush of the file shall serve all the file_flush_async requests that were queued when the flush started. ]*/
+/*Tests_SRS_FILE_WIN32_01_052: [ on_file_flush_win32 shall release all the requests served by the flush to the I/O context pool and call their user_callback, in the order in which file_flush_async was called, with is_successful as true if and only if FlushFileBuffers succeeded. ]*/
+/*Tests_SRS_FILE_WIN32_01_053: [ on_file_flush_win32 shall mark the flush as not in progress and start a new flush if requests were added while the flush was in progress. ]*/
+TEST_FUNCTION(on_file_flush_win32_serves_the_requests_queued_during_the_flush_with_one_FlushFileBuffers)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("on_file_flush_win32_serves_the_requests_queued_during_the_flush_with_one_FlushFileBuffers.txt");
+    PTP_SIMPLE_CALLBACK flush_callback = start_file_flush_async(file_handle, (void*)0x4245);
+    ASSERT_ARE_EQUAL(int, 0, file_flush_async(file_handle, mock_user_callback, (void*)0x4246));
+    ASSERT_ARE_EQUAL(int, 0, file_flush_async(file_handle, mock_user_callback, (void*)0x4247));
+    umock_c_reset_all_calls();
+
+    /*first flush completes and starts the second one*/
+    STRICT_EXPECTED_CALL(mock_FlushFileBuffers(fake_handle));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, file_handle, IGNORED_ARG));
+
+    /*second flush serves both queued requests*/
+    STRICT_EXPECTED_CALL(mock_FlushFileBuffers(fake_handle));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4246, true));
+    STRICT_EXPECTED_CALL(io_context_pool_release(test_io_context_pool, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4247, true));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    flush_callback(NULL, file_handle);
+    flush_callback(NULL, file_handle);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* file_copy_range_async */
+
+/*Tests_SRS_FILE_01_131: [ If source is NULL then file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_with_NULL_source_fails)
+{
+    ///arrange
+    FILE_HANDLE destination = get_file_handle("file_copy_range_async_with_NULL_source_fails.txt");
+
+    ///act
+    int result = file_copy_range_async(NULL, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, TEST_COPY_CHUNK_SIZE, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_01_132: [ If destination is NULL then file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_with_NULL_destination_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("file_copy_range_async_with_NULL_destination_fails.txt");
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, NULL, TEST_COPY_DESTINATION_POSITION, TEST_COPY_CHUNK_SIZE, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+}
+
+/*Tests_SRS_FILE_01_133: [ If size is 0 then file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_with_size_0_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("file_copy_range_async_with_size_0_fails_source.txt");
+    FILE_HANDLE destination = get_file_handle("file_copy_range_async_with_size_0_fails_destination.txt");
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, 0, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_01_134: [ If source_position + size or destination_position + size is greater than INT64_MAX then file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_with_source_range_past_INT64_MAX_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("file_copy_range_async_with_source_range_past_INT64_MAX_fails_source.txt");
+    FILE_HANDLE destination = get_file_handle("file_copy_range_async_with_source_range_past_INT64_MAX_fails_destination.txt");
+
+    ///act
+    int result = file_copy_range_async(source, INT64_MAX - 4095, destination, TEST_COPY_DESTINATION_POSITION, 4096 + 1, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_01_134: [ If source_position + size or destination_position + size is greater than INT64_MAX then file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_with_destination_range_past_INT64_MAX_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("file_copy_range_async_with_destination_range_past_INT64_MAX_fails_source.txt");
+    FILE_HANDLE destination = get_file_handle("file_copy_range_async_with_destination_range_past_INT64_MAX_fails_destination.txt");
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, INT64_MAX - 4095, 4096 + 1, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_01_140: [ If source and destination are the same file handle and the source and destination ranges overlap then file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_with_overlapping_ranges_of_the_same_file_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_copy_range_async_with_overlapping_ranges_of_the_same_file_fails.txt");
+
+    ///act
+    int result = file_copy_range_async(file_handle, 0, file_handle, 4096, 8192, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_135: [ If user_callback is NULL then file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_with_NULL_user_callback_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("file_copy_range_async_with_NULL_user_callback_fails_source.txt");
+    FILE_HANDLE destination = get_file_handle("file_copy_range_async_with_NULL_user_callback_fails_destination.txt");
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, TEST_COPY_CHUNK_SIZE, NULL, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_01_136: [ file_copy_range_async shall start copying size bytes of source starting at source_position to destination starting at destination_position and return 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_198: [ file_copy_range_async shall allocate a copy context to hold the ranges, user_callback and user_context. ]*/
+/*Tests_SRS_FILE_WIN32_01_201: [ file_copy_range_async shall increment the number of pending copies of source and of destination and call TrySubmitThreadpoolCallback with on_file_copy_range_win32, the copy context and the threadpool environment of destination. ]*/
+/*Tests_SRS_FILE_WIN32_01_203: [ file_copy_range_async shall succeed and return 0. ]*/
+TEST_FUNCTION(file_copy_range_async_submits_the_copy_to_the_threadpool)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("file_copy_range_async_submits_the_copy_to_the_threadpool_source.txt");
+    FILE_HANDLE destination = get_file_handle("file_copy_range_async_submits_the_copy_to_the_threadpool_destination.txt");
+    PTP_SIMPLE_CALLBACK captured_copy_callback = NULL;
+    PVOID captured_copy_context = NULL;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CaptureArgumentValue_pfns(&captured_copy_callback)
+        .CaptureArgumentValue_pv(&captured_copy_context);
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, TEST_COPY_CHUNK_SIZE, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(captured_copy_callback);
+    ASSERT_IS_NOT_NULL(captured_copy_context);
+
+    ///cleanup
+    captured_copy_callback(NULL, captured_copy_context);
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_01_138: [ When a read-ahead policy is set on destination, file_copy_range_async shall drop the blocks of destination that overlap the destination range. ]*/
+/*Tests_SRS_FILE_WIN32_01_200: [ If a read-ahead policy is set on destination, file_copy_range_async shall call read_ahead_invalidate with the destination range. ]*/
+TEST_FUNCTION(file_copy_range_async_drops_the_read_ahead_blocks_of_the_destination_range)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE source = get_file_handle("file_copy_range_async_drops_the_read_ahead_blocks_of_the_destination_range_source.txt");
+    FILE_HANDLE destination = get_file_handle_with_read_ahead("file_copy_range_async_drops_the_read_ahead_blocks_of_the_destination_range_destination.txt", &captured_callback);
+    PTP_SIMPLE_CALLBACK captured_copy_callback = NULL;
+    PVOID captured_copy_context = NULL;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, TEST_COPY_DESTINATION_POSITION, TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CaptureArgumentValue_pfns(&captured_copy_callback)
+        .CaptureArgumentValue_pv(&captured_copy_context);
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, TEST_COPY_CHUNK_SIZE, mock_user_callback, (void*)0x4245);
+
+    ///assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    captured_copy_callback(NULL, captured_copy_context);
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_01_139: [ If there are any other failures, file_copy_range_async shall fail and return a non-zero value. ]*/
+/*Tests_SRS_FILE_WIN32_01_199: [ If there are any failures, file_copy_range_async shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(file_copy_range_async_fails_when_malloc_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("file_copy_range_async_fails_when_malloc_fails_source.txt");
+    FILE_HANDLE destination = get_file_handle("file_copy_range_async_fails_when_malloc_fails_destination.txt");
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG))
+        .SetReturn(NULL);
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, TEST_COPY_CHUNK_SIZE, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_WIN32_01_202: [ If TrySubmitThreadpoolCallback fails, file_copy_range_async shall decrement the number of pending copies of source and of destination, free the copy context and fail. ]*/
+TEST_FUNCTION(file_copy_range_async_fails_when_TrySubmitThreadpoolCallback_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("file_copy_range_async_fails_when_TrySubmitThreadpoolCallback_fails_source.txt");
+    FILE_HANDLE destination = get_file_handle("file_copy_range_async_fails_when_TrySubmitThreadpoolCallback_fails_destination.txt");
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    ///act
+    int result = file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, TEST_COPY_CHUNK_SIZE, mock_user_callback, NULL);
+
+    ///assert
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_WIN32_01_196: [ file_create shall set the number of pending copies to 0. ]*/
+/*Tests_SRS_FILE_WIN32_01_197: [ file_destroy shall wait for the number of pending copies to reach 0 by calling wait_on_address. ]*/
+TEST_FUNCTION(file_destroy_waits_for_the_pending_copies)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("file_destroy_waits_for_the_pending_copies_source.txt");
+    FILE_HANDLE destination = get_file_handle("file_destroy_waits_for_the_pending_copies_destination.txt");
+    preallocate_callback_to_run_on_wait = start_file_copy_range_async(source, destination, TEST_COPY_CHUNK_SIZE, &preallocate_context_to_run_on_wait);
+
+    STRICT_EXPECTED_CALL(wait_on_address(IGNORED_ARG, 1, UINT32_MAX));
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_DeviceIoControl(fake_handle, FSCTL_DUPLICATE_EXTENTS_TO_FILE, IGNORED_ARG, sizeof(DUPLICATE_EXTENTS_DATA), NULL, 0, NULL, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_WaitForThreadpoolIoCallbacks(fake_ptp_io, FALSE));
+    STRICT_EXPECTED_CALL(mock_CloseThreadpoolCleanupGroup(fake_ptp_cleanup_group));
+    STRICT_EXPECTED_CALL(mock_DestroyThreadpoolEnvironment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_handle));
+    STRICT_EXPECTED_CALL(mock_CloseThreadpoolIo(fake_ptp_io));
+    STRICT_EXPECTED_CALL(io_context_pool_destroy(test_io_context_pool));
+    STRICT_EXPECTED_CALL(execution_engine_dec_ref(fake_execution_engine));
+    STRICT_EXPECTED_CALL(free(destination));
+
+    ///act
+    file_destroy(destination);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+}
+
+/* on_file_copy_range_win32 */
+
+/*Tests_SRS_FILE_01_137: [ When the copy ends, user_callback shall be called with user_context and is_successful as true if and only if all size bytes were copied. ]*/
+/*Tests_SRS_FILE_WIN32_01_204: [ on_file_copy_range_win32 shall create an event by calling CreateEvent and use it, with its low-order bit set, in the OVERLAPPED structs of the copy, so that their completion is not queued to the threadpool I/O of the file. ]*/
+/*Tests_SRS_FILE_WIN32_01_206: [ on_file_copy_range_win32 shall call DeviceIoControl on the destination with FSCTL_DUPLICATE_EXTENTS_TO_FILE and a DUPLICATE_EXTENTS_DATA describing the source file and the source and destination ranges, and wait for it by calling GetOverlappedResult. ]*/
+/*Tests_SRS_FILE_WIN32_01_207: [ If duplicating the extents succeeds, the copy shall succeed. ]*/
+/*Tests_SRS_FILE_WIN32_01_211: [ on_file_copy_range_win32 shall close the event by calling CloseHandle. ]*/
+/*Tests_SRS_FILE_WIN32_01_212: [ on_file_copy_range_win32 shall free the copy context and call user_callback with user_context and is_successful. ]*/
+/*Tests_SRS_FILE_WIN32_01_213: [ on_file_copy_range_win32 shall decrement the number of pending copies of source and of destination and wake up file_destroy by calling wake_by_address_single if they reach 0. ]*/
+TEST_FUNCTION(on_file_copy_range_win32_duplicates_the_extents)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("on_file_copy_range_win32_duplicates_the_extents_source.txt");
+    FILE_HANDLE destination = get_file_handle("on_file_copy_range_win32_duplicates_the_extents_destination.txt");
+    PVOID copy_context = NULL;
+    PTP_SIMPLE_CALLBACK copy_callback = start_file_copy_range_async(source, destination, TEST_COPY_CHUNK_SIZE, &copy_context);
+    (void)memset(&captured_duplicate_extents_data, 0, sizeof(captured_duplicate_extents_data));
+
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_DeviceIoControl(fake_handle, FSCTL_DUPLICATE_EXTENTS_TO_FILE, IGNORED_ARG, sizeof(DUPLICATE_EXTENTS_DATA), NULL, 0, NULL, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(free(copy_context));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    copy_callback(NULL, copy_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, fake_handle, captured_duplicate_extents_data.FileHandle);
+    ASSERT_ARE_EQUAL(int64_t, TEST_COPY_SOURCE_POSITION, captured_duplicate_extents_data.SourceFileOffset.QuadPart);
+    ASSERT_ARE_EQUAL(int64_t, TEST_COPY_DESTINATION_POSITION, captured_duplicate_extents_data.TargetFileOffset.QuadPart);
+    ASSERT_ARE_EQUAL(int64_t, TEST_COPY_CHUNK_SIZE, captured_duplicate_extents_data.ByteCount.QuadPart);
+    ASSERT_ARE_EQUAL(void_ptr, (HANDLE)((ULONG_PTR)fake_h_event | 1), captured_duplicate_extents_event);
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_WIN32_01_216: [ If a read-ahead policy is set on destination, on_file_copy_range_win32 shall call read_ahead_invalidate with the destination range before calling user_callback. ]*/
+TEST_FUNCTION(on_file_copy_range_win32_with_read_ahead_on_destination_invalidates_the_destination_range)
+{
+    ///arrange
+    PTP_WIN32_IO_CALLBACK captured_callback = NULL;
+    FILE_HANDLE source = get_file_handle("on_file_copy_range_win32_with_read_ahead_on_destination_invalidates_the_destination_range_source.txt");
+    FILE_HANDLE destination = get_file_handle_with_read_ahead("on_file_copy_range_win32_with_read_ahead_on_destination_invalidates_the_destination_range_destination.txt", &captured_callback);
+    PTP_SIMPLE_CALLBACK copy_callback = NULL;
+    PVOID copy_context = NULL;
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, TEST_COPY_DESTINATION_POSITION, TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(mock_TrySubmitThreadpoolCallback(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .CaptureArgumentValue_pfns(&copy_callback)
+        .CaptureArgumentValue_pv(&copy_context);
+    ASSERT_ARE_EQUAL(int, 0, file_copy_range_async(source, TEST_COPY_SOURCE_POSITION, destination, TEST_COPY_DESTINATION_POSITION, TEST_COPY_CHUNK_SIZE, mock_user_callback, (void*)0x4245));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_DeviceIoControl(fake_handle, FSCTL_DUPLICATE_EXTENTS_TO_FILE, IGNORED_ARG, sizeof(DUPLICATE_EXTENTS_DATA), NULL, 0, NULL, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(read_ahead_invalidate(test_read_ahead, TEST_COPY_DESTINATION_POSITION, TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(free(copy_context));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    copy_callback(NULL, copy_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_WIN32_01_206: [ on_file_copy_range_win32 shall call DeviceIoControl on the destination with FSCTL_DUPLICATE_EXTENTS_TO_FILE and a DUPLICATE_EXTENTS_DATA describing the source file and the source and destination ranges, and wait for it by calling GetOverlappedResult. ]*/
+/*Tests_SRS_FILE_WIN32_01_207: [ If duplicating the extents succeeds, the copy shall succeed. ]*/
+TEST_FUNCTION(on_file_copy_range_win32_waits_for_the_pending_duplication_of_the_extents)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("on_file_copy_range_win32_waits_for_the_pending_duplication_of_the_extents_source.txt");
+    FILE_HANDLE destination = get_file_handle("on_file_copy_range_win32_waits_for_the_pending_duplication_of_the_extents_destination.txt");
+    PVOID copy_context = NULL;
+    PTP_SIMPLE_CALLBACK copy_callback = start_file_copy_range_async(source, destination, TEST_COPY_CHUNK_SIZE, &copy_context);
+
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_DeviceIoControl(fake_handle, FSCTL_DUPLICATE_EXTENTS_TO_FILE, IGNORED_ARG, sizeof(DUPLICATE_EXTENTS_DATA), NULL, 0, NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(free(copy_context));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    copy_callback(NULL, copy_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_WIN32_01_205: [ If CreateEvent fails, the copy shall fail. ]*/
+TEST_FUNCTION(on_file_copy_range_win32_calls_user_callback_with_false_when_CreateEvent_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("on_file_copy_range_win32_calls_user_callback_with_false_when_CreateEvent_fails_source.txt");
+    FILE_HANDLE destination = get_file_handle("on_file_copy_range_win32_calls_user_callback_with_false_when_CreateEvent_fails_destination.txt");
+    PVOID copy_context = NULL;
+    PTP_SIMPLE_CALLBACK copy_callback = start_file_copy_range_async(source, destination, TEST_COPY_CHUNK_SIZE, &copy_context);
+
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(free(copy_context));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    copy_callback(NULL, copy_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_01_137: [ When the copy ends, user_callback shall be called with user_context and is_successful as true if and only if all size bytes were copied. ]*/
+/*Tests_SRS_FILE_WIN32_01_208: [ If duplicating the extents fails, on_file_copy_range_win32 shall copy the data through a buffer. ]*/
+/*Tests_SRS_FILE_WIN32_01_209: [ Otherwise on_file_copy_range_win32 shall allocate a buffer of FILE_WIN32_COPY_CHUNK_SIZE bytes and, chunk by chunk, read the source range with ReadFile and write what was read to the destination range with WriteFile, waiting for each of them by calling GetOverlappedResult. ]*/
+TEST_FUNCTION(on_file_copy_range_win32_copies_through_a_buffer_when_duplicating_the_extents_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("on_file_copy_range_win32_copies_through_a_buffer_when_duplicating_the_extents_fails_source.txt");
+    FILE_HANDLE destination = get_file_handle("on_file_copy_range_win32_copies_through_a_buffer_when_duplicating_the_extents_fails_destination.txt");
+    PVOID copy_context = NULL;
+    PTP_SIMPLE_CALLBACK copy_callback = start_file_copy_range_async(source, destination, TEST_COPY_CHUNK_SIZE + 4096, &copy_context);
+
+    test_copy_io_bytes_transferred[0] = TEST_COPY_CHUNK_SIZE;
+    test_copy_io_bytes_transferred[1] = TEST_COPY_CHUNK_SIZE;
+    test_copy_io_bytes_transferred[2] = 4096;
+    test_copy_io_bytes_transferred[3] = 4096;
+
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_DeviceIoControl(fake_handle, FSCTL_DUPLICATE_EXTENTS_TO_FILE, IGNORED_ARG, sizeof(DUPLICATE_EXTENTS_DATA), NULL, 0, NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_INVALID_FUNCTION);
+    STRICT_EXPECTED_CALL(malloc(TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, IGNORED_ARG, TEST_COPY_CHUNK_SIZE, NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, IGNORED_ARG, TEST_COPY_CHUNK_SIZE, NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, IGNORED_ARG, 4096, NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, IGNORED_ARG, 4096, NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(free(copy_context));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    copy_callback(NULL, copy_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 4, copy_io_count);
+    ASSERT_ARE_EQUAL(uint64_t, TEST_COPY_SOURCE_POSITION, captured_copy_io_offsets[0]);
+    ASSERT_ARE_EQUAL(uint64_t, TEST_COPY_DESTINATION_POSITION, captured_copy_io_offsets[1]);
+    ASSERT_ARE_EQUAL(uint64_t, TEST_COPY_SOURCE_POSITION + TEST_COPY_CHUNK_SIZE, captured_copy_io_offsets[2]);
+    ASSERT_ARE_EQUAL(uint64_t, TEST_COPY_DESTINATION_POSITION + TEST_COPY_CHUNK_SIZE, captured_copy_io_offsets[3]);
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        ASSERT_ARE_EQUAL(void_ptr, (HANDLE)((ULONG_PTR)fake_h_event | 1), captured_copy_io_events[i]);
+    }
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_WIN32_01_208: [ If duplicating the extents fails, on_file_copy_range_win32 shall copy the data through a buffer. ]*/
+TEST_FUNCTION(on_file_copy_range_win32_copies_through_a_buffer_when_waiting_for_the_duplication_of_the_extents_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("on_file_copy_range_win32_copies_through_a_buffer_when_waiting_for_the_duplication_of_the_extents_fails_source.txt");
+    FILE_HANDLE destination = get_file_handle("on_file_copy_range_win32_copies_through_a_buffer_when_waiting_for_the_duplication_of_the_extents_fails_destination.txt");
+    PVOID copy_context = NULL;
+    PTP_SIMPLE_CALLBACK copy_callback = start_file_copy_range_async(source, destination, 4096, &copy_context);
+
+    test_copy_io_bytes_transferred[0] = 4096;
+    test_copy_io_bytes_transferred[1] = 4096;
+
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_DeviceIoControl(fake_handle, FSCTL_DUPLICATE_EXTENTS_TO_FILE, IGNORED_ARG, sizeof(DUPLICATE_EXTENTS_DATA), NULL, 0, NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(malloc(TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, IGNORED_ARG, 4096, NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, IGNORED_ARG, 4096, NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(free(copy_context));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, true));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+
+    ///act
+    copy_callback(NULL, copy_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+static void setup_copy_through_buffer_expected_calls(void)
+{
+    STRICT_EXPECTED_CALL(mock_CreateEvent(IGNORED_ARG, FALSE, FALSE, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_DeviceIoControl(fake_handle, FSCTL_DUPLICATE_EXTENTS_TO_FILE, IGNORED_ARG, sizeof(DUPLICATE_EXTENTS_DATA), NULL, 0, NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_INVALID_FUNCTION);
+}
+
+static void setup_failed_copy_expected_calls(PVOID copy_context)
+{
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_event));
+    STRICT_EXPECTED_CALL(free(copy_context));
+    STRICT_EXPECTED_CALL(mock_user_callback((void*)0x4245, false));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(wake_by_address_single(IGNORED_ARG));
+}
+
+/*Tests_SRS_FILE_WIN32_01_210: [ If malloc fails, ReadFile or WriteFile fail, GetOverlappedResult fails, ReadFile reads 0 bytes or WriteFile writes fewer bytes than were read, the copy shall fail. ]*/
+TEST_FUNCTION(on_file_copy_range_win32_calls_user_callback_with_false_when_malloc_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("on_file_copy_range_win32_calls_user_callback_with_false_when_malloc_fails_source.txt");
+    FILE_HANDLE destination = get_file_handle("on_file_copy_range_win32_calls_user_callback_with_false_when_malloc_fails_destination.txt");
+    PVOID copy_context = NULL;
+    PTP_SIMPLE_CALLBACK copy_callback = start_file_copy_range_async(source, destination, 4096, &copy_context);
+
+    setup_copy_through_buffer_expected_calls();
+    STRICT_EXPECTED_CALL(malloc(TEST_COPY_CHUNK_SIZE))
+        .SetReturn(NULL);
+    setup_failed_copy_expected_calls(copy_context);
+
+    ///act
+    copy_callback(NULL, copy_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_WIN32_01_210: [ If malloc fails, ReadFile or WriteFile fail, GetOverlappedResult fails, ReadFile reads 0 bytes or WriteFile writes fewer bytes than were read, the copy shall fail. ]*/
+TEST_FUNCTION(on_file_copy_range_win32_calls_user_callback_with_false_when_ReadFile_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("on_file_copy_range_win32_calls_user_callback_with_false_when_ReadFile_fails_source.txt");
+    FILE_HANDLE destination = get_file_handle("on_file_copy_range_win32_calls_user_callback_with_false_when_ReadFile_fails_destination.txt");
+    PVOID copy_context = NULL;
+    PTP_SIMPLE_CALLBACK copy_callback = start_file_copy_range_async(source, destination, 4096, &copy_context);
+
+    setup_copy_through_buffer_expected_calls();
+    STRICT_EXPECTED_CALL(malloc(TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, IGNORED_ARG, 4096, NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_ACCESS_DENIED);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_failed_copy_expected_calls(copy_context);
+
+    ///act
+    copy_callback(NULL, copy_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_WIN32_01_210: [ If malloc fails, ReadFile or WriteFile fail, GetOverlappedResult fails, ReadFile reads 0 bytes or WriteFile writes fewer bytes than were read, the copy shall fail. ]*/
+TEST_FUNCTION(on_file_copy_range_win32_calls_user_callback_with_false_when_GetOverlappedResult_fails_for_the_read)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("on_file_copy_range_win32_calls_user_callback_with_false_when_GetOverlappedResult_fails_for_the_read_source.txt");
+    FILE_HANDLE destination = get_file_handle("on_file_copy_range_win32_calls_user_callback_with_false_when_GetOverlappedResult_fails_for_the_read_destination.txt");
+    PVOID copy_context = NULL;
+    PTP_SIMPLE_CALLBACK copy_callback = start_file_copy_range_async(source, destination, 4096, &copy_context);
+
+    setup_copy_through_buffer_expected_calls();
+    STRICT_EXPECTED_CALL(malloc(TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, IGNORED_ARG, 4096, NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_IO_PENDING);
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_failed_copy_expected_calls(copy_context);
+
+    ///act
+    copy_callback(NULL, copy_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_WIN32_01_210: [ If malloc fails, ReadFile or WriteFile fail, GetOverlappedResult fails, ReadFile reads 0 bytes or WriteFile writes fewer bytes than were read, the copy shall fail. ]*/
+TEST_FUNCTION(on_file_copy_range_win32_calls_user_callback_with_false_when_the_source_ends_before_the_range)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("on_file_copy_range_win32_calls_user_callback_with_false_when_the_source_ends_before_the_range_source.txt");
+    FILE_HANDLE destination = get_file_handle("on_file_copy_range_win32_calls_user_callback_with_false_when_the_source_ends_before_the_range_destination.txt");
+    PVOID copy_context = NULL;
+    PTP_SIMPLE_CALLBACK copy_callback = start_file_copy_range_async(source, destination, 4096, &copy_context);
+
+    test_copy_io_bytes_transferred[0] = 0;
+
+    setup_copy_through_buffer_expected_calls();
+    STRICT_EXPECTED_CALL(malloc(TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, IGNORED_ARG, 4096, NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_failed_copy_expected_calls(copy_context);
+
+    ///act
+    copy_callback(NULL, copy_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_WIN32_01_210: [ If malloc fails, ReadFile or WriteFile fail, GetOverlappedResult fails, ReadFile reads 0 bytes or WriteFile writes fewer bytes than were read, the copy shall fail. ]*/
+TEST_FUNCTION(on_file_copy_range_win32_calls_user_callback_with_false_when_WriteFile_fails)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("on_file_copy_range_win32_calls_user_callback_with_false_when_WriteFile_fails_source.txt");
+    FILE_HANDLE destination = get_file_handle("on_file_copy_range_win32_calls_user_callback_with_false_when_WriteFile_fails_destination.txt");
+    PVOID copy_context = NULL;
+    PTP_SIMPLE_CALLBACK copy_callback = start_file_copy_range_async(source, destination, 4096, &copy_context);
+
+    test_copy_io_bytes_transferred[0] = 4096;
+
+    setup_copy_through_buffer_expected_calls();
+    STRICT_EXPECTED_CALL(malloc(TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, IGNORED_ARG, 4096, NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, IGNORED_ARG, 4096, NULL, IGNORED_ARG))
+        .SetReturn(FALSE);
+    STRICT_EXPECTED_CALL(mock_GetLastError())
+        .SetReturn(ERROR_DISK_FULL);
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_failed_copy_expected_calls(copy_context);
+
+    ///act
+    copy_callback(NULL, copy_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/*Tests_SRS_FILE_WIN32_01_210: [ If malloc fails, ReadFile or WriteFile fail, GetOverlappedResult fails, ReadFile reads 0 bytes or WriteFile writes fewer bytes than were read, the copy shall fail. ]*/
+TEST_FUNCTION(on_file_copy_range_win32_calls_user_callback_with_false_when_WriteFile_writes_fewer_bytes)
+{
+    ///arrange
+    FILE_HANDLE source = get_file_handle("on_file_copy_range_win32_calls_user_callback_with_false_when_WriteFile_writes_fewer_bytes_source.txt");
+    FILE_HANDLE destination = get_file_handle("on_file_copy_range_win32_calls_user_callback_with_false_when_WriteFile_writes_fewer_bytes_destination.txt");
+    PVOID copy_context = NULL;
+    PTP_SIMPLE_CALLBACK copy_callback = start_file_copy_range_async(source, destination, 4096, &copy_context);
+
+    test_copy_io_bytes_transferred[0] = 4096;
+    test_copy_io_bytes_transferred[1] = 512;
+
+    setup_copy_through_buffer_expected_calls();
+    STRICT_EXPECTED_CALL(malloc(TEST_COPY_CHUNK_SIZE));
+    STRICT_EXPECTED_CALL(mock_ReadFile(fake_handle, IGNORED_ARG, 4096, NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE));
+    STRICT_EXPECTED_CALL(mock_WriteFile(fake_handle, IGNORED_ARG, 4096, NULL, IGNORED_ARG))
+        .SetReturn(TRUE);
+    STRICT_EXPECTED_CALL(mock_GetOverlappedResult(fake_handle, IGNORED_ARG, IGNORED_ARG, TRUE));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    setup_failed_copy_expected_calls(copy_context);
+
+    ///act
+    copy_callback(NULL, copy_context);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(source);
+    file_destroy(destination);
+}
+
+/* file_map_region */
+
+/*Tests_SRS_FILE_01_065: [ If handle is NULL then file_map_region shall fail and return NULL. ]*/
+/*Tests_SRS_FILE_WIN32_01_055: [ If handle is NULL then file_map_region shall fail and return NULL. ]*/
+TEST_FUNCTION(file_map_region_fails_with_null_handle)
+{
+    ///act
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(NULL, 0, 4096, FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_IS_NULL(region);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_066: [ If size is 0 then file_map_region shall fail and return NULL. ]*/
+/*Tests_SRS_FILE_WIN32_01_056: [ If size is 0 then file_map_region shall fail and return NULL. ]*/
+TEST_FUNCTION(file_map_region_fails_with_zero_size)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_map_region_fails_with_zero_size.txt");
+
+    ///act
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, 0, 0, FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_IS_NULL(region);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_067: [ If position + size is greater than INT64_MAX then file_map_region shall fail and return NULL. ]*/
+/*Tests_SRS_FILE_WIN32_01_057: [ If position + size is greater than INT64_MAX then file_map_region shall fail and return NULL. ]*/
+TEST_FUNCTION(file_map_region_fails_if_position_plus_size_is_greater_than_INT64_MAX)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_map_region_fails_if_position_plus_size_is_greater_than_INT64_MAX.txt");
+
+    ///act
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, INT64_MAX, 1, FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_IS_NULL(region);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_068: [ If position + size is greater than the size of the file then file_map_region shall fail and return NULL. ]*/
+/*Tests_SRS_FILE_WIN32_01_058: [ file_map_region shall call GetFileSizeEx to get the size of the file. ]*/
+/*Tests_SRS_FILE_WIN32_01_059: [ If position + size is greater than the size of the file, file_map_region shall fail and return NULL. ]*/
+TEST_FUNCTION(file_map_region_fails_when_the_region_goes_past_the_end_of_the_file)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_map_region_fails_when_the_region_goes_past_the_end_of_the_file.txt");
+
+    STRICT_EXPECTED_CALL(mock_GetFileSizeEx(fake_handle, IGNORED_ARG));
+
+    ///act
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, (uint64_t)test_file_size - 10, 11, FILE_ACCESS_HINT_NORMAL);
+
+    ///assert
+    ASSERT_IS_NULL(region);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_069: [ file_map_region shall map size bytes of the file starting at position as a read-only view and return a handle to it. ]*/
+/*Tests_SRS_FILE_WIN32_01_058: [ file_map_region shall call GetFileSizeEx to get the size of the file. ]*/
+/*Tests_SRS_FILE_WIN32_01_060: [ file_map_region shall allocate a FILE_MAPPED_REGION. ]*/
+/*Tests_SRS_FILE_WIN32_01_061: [ file_map_region shall call CreateFileMappingA with the file handle, NULL, PAGE_READONLY, 0, 0 and NULL to create a read-only mapping object of the whole file. ]*/
+/*Tests_SRS_FILE_WIN32_01_062: [ file_map_region shall call MapViewOfFile with FILE_MAP_READ, position rounded down to a multiple of the allocation granularity returned by GetSystemInfo as offset and size plus the bytes between offset and position as the number of bytes to map. ]*/
+/*Tests_SRS_FILE_WIN32_01_063: [ If access_hint is FILE_ACCESS_HINT_WILL_NEED, file_map_region shall call PrefetchVirtualMemory on the view. Other hints have no equivalent for views and shall be ignored. ]*/
+/*Tests_SRS_FILE_WIN32_01_066: [ file_map_region shall succeed and return the allocated FILE_MAPPED_REGION. ]*/
+/*Tests_SRS_FILE_01_073: [ file_mapped_region_get_data shall return a pointer to the byte of the view that corresponds to position in the file. ]*/
+/*Tests_SRS_FILE_WIN32_01_068: [ file_mapped_region_get_data shall return the address in the view of the byte at position. ]*/
+TEST_FUNCTION(file_map_region_maps_a_view_aligned_to_the_allocation_granularity)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_map_region_maps_a_view_aligned_to_the_allocation_granularity.txt");
+
+    STRICT_EXPECTED_CALL(mock_GetFileSizeEx(fake_handle, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateFileMappingA(fake_handle, NULL, PAGE_READONLY, 0, 0, NULL));
+    STRICT_EXPECTED_CALL(mock_GetSystemInfo(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_MapViewOfFile(fake_h_mapping, FILE_MAP_READ, 0, TEST_ALLOCATION_GRANULARITY, 100 + 2048));
+
+    ///act
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, TEST_ALLOCATION_GRANULARITY + 100, 2048, FILE_ACCESS_HINT_RANDOM);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(region);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(void_ptr, test_view + 100, file_mapped_region_get_data(region));
+
+    ///cleanup
+    file_unmap_region(region);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_WIN32_01_063: [ If access_hint is FILE_ACCESS_HINT_WILL_NEED, file_map_region shall call PrefetchVirtualMemory on the view. Other hints have no equivalent for views and shall be ignored. ]*/
+TEST_FUNCTION(file_map_region_with_FILE_ACCESS_HINT_WILL_NEED_calls_PrefetchVirtualMemory)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_map_region_with_FILE_ACCESS_HINT_WILL_NEED_calls_PrefetchVirtualMemory.txt");
+
+    STRICT_EXPECTED_CALL(mock_GetFileSizeEx(fake_handle, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateFileMappingA(fake_handle, NULL, PAGE_READONLY, 0, 0, NULL));
+    STRICT_EXPECTED_CALL(mock_GetSystemInfo(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_MapViewOfFile(fake_h_mapping, FILE_MAP_READ, 0, 0, 4096));
+    STRICT_EXPECTED_CALL(mock_PrefetchVirtualMemory(IGNORED_ARG, 1, IGNORED_ARG, 0));
+
+    ///act
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, 0, 4096, FILE_ACCESS_HINT_WILL_NEED);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(region);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_unmap_region(region);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_070: [ Failing to apply access_hint shall not make file_map_region fail. ]*/
+/*Tests_SRS_FILE_WIN32_01_064: [ If PrefetchVirtualMemory fails, file_map_region shall log the failure and continue. ]*/
+TEST_FUNCTION(file_map_region_succeeds_when_PrefetchVirtualMemory_fails)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_map_region_succeeds_when_PrefetchVirtualMemory_fails.txt");
+
+    STRICT_EXPECTED_CALL(mock_GetFileSizeEx(fake_handle, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateFileMappingA(fake_handle, NULL, PAGE_READONLY, 0, 0, NULL));
+    STRICT_EXPECTED_CALL(mock_GetSystemInfo(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_MapViewOfFile(fake_h_mapping, FILE_MAP_READ, 0, 0, 4096));
+    STRICT_EXPECTED_CALL(mock_PrefetchVirtualMemory(IGNORED_ARG, 1, IGNORED_ARG, 0))
+        .SetReturn(FALSE);
+
+    ///act
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, 0, 4096, FILE_ACCESS_HINT_WILL_NEED);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(region);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///cleanup
+    file_unmap_region(region);
+    file_destroy(file_handle);
+}
+
+/*Tests_SRS_FILE_01_071: [ If there are any other failures, file_map_region shall fail and return NULL. ]*/
+/*Tests_SRS_FILE_WIN32_01_065: [ If there are any failures, file_map_region shall fail and return NULL. ]*/
+TEST_FUNCTION(file_map_region_fails_when_underlying_functions_fail)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_map_region_fails_when_underlying_functions_fail.txt");
+
+    STRICT_EXPECTED_CALL(mock_GetFileSizeEx(fake_handle, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mock_CreateFileMappingA(fake_handle, NULL, PAGE_READONLY, 0, 0, NULL));
+    STRICT_EXPECTED_CALL(mock_GetSystemInfo(IGNORED_ARG))
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(mock_MapViewOfFile(fake_h_mapping, FILE_MAP_READ, 0, 0, 4096));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            ///act
+            FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, 0, 4096, FILE_ACCESS_HINT_NORMAL);
+
+            ///assert
+            ASSERT_IS_NULL(region, "On failed call %zu", i);
+        }
+    }
+
+    ///cleanup
+    file_destroy(file_handle);
+}
+
+/* file_mapped_region_get_data */
+
+/*Tests_SRS_FILE_01_072: [ If region is NULL then file_mapped_region_get_data shall return NULL. ]*/
+/*Tests_SRS_FILE_WIN32_01_067: [ If region is NULL then file_mapped_region_get_data shall return NULL. ]*/
+TEST_FUNCTION(file_mapped_region_get_data_with_null_region_returns_NULL)
+{
+    ///act
+    const unsigned char* data = file_mapped_region_get_data(NULL);
+
+    ///assert
+    ASSERT_IS_NULL(data);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* file_unmap_region */
+
+/*Tests_SRS_FILE_01_074: [ If region is NULL then file_unmap_region shall return. ]*/
+/*Tests_SRS_FILE_WIN32_01_069: [ If region is NULL then file_unmap_region shall return. ]*/
+TEST_FUNCTION(file_unmap_region_with_null_region_returns)
+{
+    ///act
+    file_unmap_region(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_FILE_01_075: [ file_unmap_region shall unmap the view and free region. ]*/
+/*Tests_SRS_FILE_WIN32_01_070: [ file_unmap_region shall call UnmapViewOfFile on the view. ]*/
+/*Tests_SRS_FILE_WIN32_01_071: [ file_unmap_region shall call CloseHandle on the mapping object. ]*/
+/*Tests_SRS_FILE_WIN32_01_072: [ file_unmap_region shall free region. ]*/
+TEST_FUNCTION(file_unmap_region_unmaps_the_view_and_frees_the_region)
+{
+    ///arrange
+    FILE_HANDLE file_handle = get_file_handle("file_unmap_region_unmaps_the_view_and_frees_the_region.txt");
+    FILE_MAPPED_REGION_HANDLE region = file_map_region(file_handle, 0, 4096, FILE_ACCESS_HINT_NORMAL);
+    ASSERT_IS_NOT_NULL(region);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_UnmapViewOfFile(test_view));
+    STRICT_EXPECTED_CALL(mock_CloseHandle(fake_h_mapping));
+    STRICT_EXPECTED_CALL(free(region));
+
+    ///act
+    file_unmap_region(region);
 
     ///assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
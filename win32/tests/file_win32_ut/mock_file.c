@@ -22,5 +22,20 @@
 #define ReadFile mock_ReadFile
 #define GetLastError mock_GetLastError
 #define CancelThreadpoolIo mock_CancelThreadpoolIo
+#define TrySubmitThreadpoolCallback mock_TrySubmitThreadpoolCallback
+#define FlushFileBuffers mock_FlushFileBuffers
+#define GetFileSizeEx mock_GetFileSizeEx
+#define CreateFileMappingA mock_CreateFileMappingA
+#define GetSystemInfo mock_GetSystemInfo
+#define MapViewOfFile mock_MapViewOfFile
+#define PrefetchVirtualMemory mock_PrefetchVirtualMemory
+#define UnmapViewOfFile mock_UnmapViewOfFile
+#define SetFileInformationByHandle mock_SetFileInformationByHandle
+#define CreateThreadpoolTimer mock_CreateThreadpoolTimer
+#define SetThreadpoolTimer mock_SetThreadpoolTimer
+#define WaitForThreadpoolTimerCallbacks mock_WaitForThreadpoolTimerCallbacks
+#define CloseThreadpoolTimer mock_CloseThreadpoolTimer
+#define DeviceIoControl mock_DeviceIoControl
+#define GetOverlappedResult mock_GetOverlappedResult
 
 #include "../../src/file_win32.c"
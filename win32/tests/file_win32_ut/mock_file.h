@@ -27,6 +27,21 @@ MOCKABLE_FUNCTION(, BOOL, mock_WriteFile, HANDLE, hFile, LPCVOID, lpBuffer, DWOR
 MOCKABLE_FUNCTION(, BOOL, mock_ReadFile, HANDLE, hFile, LPVOID, lpBuffer, DWORD, nNumberOfBytesToRead, LPDWORD, lpNumberofBytesRead, LPOVERLAPPED, lpOverlapped);
 MOCKABLE_FUNCTION(, DWORD, mock_GetLastError);
 MOCKABLE_FUNCTION(, void, mock_CancelThreadpoolIo, PTP_IO, pio);
+MOCKABLE_FUNCTION(, BOOL, mock_TrySubmitThreadpoolCallback, PTP_SIMPLE_CALLBACK, pfns, PVOID, pv, PTP_CALLBACK_ENVIRON, pcbe);
+MOCKABLE_FUNCTION(, BOOL, mock_FlushFileBuffers, HANDLE, hFile);
+MOCKABLE_FUNCTION(, BOOL, mock_GetFileSizeEx, HANDLE, hFile, PLARGE_INTEGER, lpFileSize);
+MOCKABLE_FUNCTION(, HANDLE, mock_CreateFileMappingA, HANDLE, hFile, LPSECURITY_ATTRIBUTES, lpFileMappingAttributes, DWORD, flProtect, DWORD, dwMaximumSizeHigh, DWORD, dwMaximumSizeLow, LPCSTR, lpName);
+MOCKABLE_FUNCTION(, void, mock_GetSystemInfo, LPSYSTEM_INFO, lpSystemInfo);
+MOCKABLE_FUNCTION(, LPVOID, mock_MapViewOfFile, HANDLE, hFileMappingObject, DWORD, dwDesiredAccess, DWORD, dwFileOffsetHigh, DWORD, dwFileOffsetLow, SIZE_T, dwNumberOfBytesToMap);
+MOCKABLE_FUNCTION(, BOOL, mock_PrefetchVirtualMemory, HANDLE, hProcess, ULONG_PTR, NumberOfEntries, PWIN32_MEMORY_RANGE_ENTRY, VirtualAddresses, ULONG, Flags);
+MOCKABLE_FUNCTION(, BOOL, mock_UnmapViewOfFile, LPCVOID, lpBaseAddress);
+MOCKABLE_FUNCTION(, BOOL, mock_SetFileInformationByHandle, HANDLE, hFile, FILE_INFO_BY_HANDLE_CLASS, FileInformationClass, LPVOID, lpFileInformation, DWORD, dwBufferSize);
+MOCKABLE_FUNCTION(, PTP_TIMER, mock_CreateThreadpoolTimer, PTP_TIMER_CALLBACK, pfnti, PVOID, pv, PTP_CALLBACK_ENVIRON, pcbe);
+MOCKABLE_FUNCTION(, void, mock_SetThreadpoolTimer, PTP_TIMER, pti, PFILETIME, pftDueTime, DWORD, msPeriod, DWORD, msWindowLength);
+MOCKABLE_FUNCTION(, void, mock_WaitForThreadpoolTimerCallbacks, PTP_TIMER, pti, BOOL, fCancelPendingCallbacks);
+MOCKABLE_FUNCTION(, void, mock_CloseThreadpoolTimer, PTP_TIMER, pti);
+MOCKABLE_FUNCTION(, BOOL, mock_DeviceIoControl, HANDLE, hDevice, DWORD, dwIoControlCode, LPVOID, lpInBuffer, DWORD, nInBufferSize, LPVOID, lpOutBuffer, DWORD, nOutBufferSize, LPDWORD, lpBytesReturned, LPOVERLAPPED, lpOverlapped);
+MOCKABLE_FUNCTION(, BOOL, mock_GetOverlappedResult, HANDLE, hFile, LPOVERLAPPED, lpOverlapped, LPDWORD, lpNumberOfBytesTransferred, BOOL, bWait);
 
 #ifdef __cplusplus
 }
@@ -63,6 +63,7 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GLOBAL_MOCK_RETURN(gballoc_ll_malloc, pretend_to_be_allocated);
     REGISTER_GLOBAL_MOCK_RETURN(gballoc_ll_realloc, pretend_to_be_allocated);
     REGISTER_GLOBAL_MOCK_RETURN(gballoc_ll_calloc, pretend_to_be_allocated);
+    REGISTER_GLOBAL_MOCK_RETURN(gballoc_ll_aligned_malloc, pretend_to_be_allocated);
 
     REGISTER_LAZY_INIT_GLOBAL_MOCK_HOOK();
     REGISTER_INTERLOCKED_GLOBAL_MOCK_HOOK();
@@ -832,6 +833,222 @@ TEST_FUNCTION(gballoc_hl_free_when_not_initialized_returns)
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 }
 
+/* gballoc_hl_aligned_malloc */
+
+/* Tests_SRS_GBALLOC_HL_METRICS_01_040: [ gballoc_hl_aligned_malloc shall call lazy_init to initialize. ]*/
+/* Tests_SRS_GBALLOC_HL_METRICS_01_042: [ gballoc_hl_aligned_malloc shall call timer_global_get_elapsed_us to obtain the start time of the allocate. ]*/
+/* Tests_SRS_GBALLOC_HL_METRICS_01_043: [ gballoc_hl_aligned_malloc shall call gballoc_ll_aligned_malloc(alignment, size) and return the result of gballoc_ll_aligned_malloc. ]*/
+/* Tests_SRS_GBALLOC_HL_METRICS_01_044: [ gballoc_hl_aligned_malloc shall call timer_global_get_elapsed_us to obtain the end time of the allocate. ]*/
+TEST_FUNCTION(gballoc_hl_aligned_malloc_calls_gballoc_ll_aligned_malloc_and_returns_the_result)
+{
+    // arrange
+    void* result;
+    void* gballoc_ll_aligned_malloc_result;
+    STRICT_EXPECTED_CALL(gballoc_ll_init(NULL));
+    (void)gballoc_hl_init(NULL, NULL);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(gballoc_ll_aligned_malloc(64, 42))
+        .CaptureReturn(&gballoc_ll_aligned_malloc_result);
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+
+    // act
+    result = gballoc_hl_aligned_malloc(64, 42);
+
+    // assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(void_ptr, result, gballoc_ll_aligned_malloc_result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    gballoc_hl_aligned_free(result);
+    gballoc_hl_deinit();
+}
+
+/* Tests_SRS_GBALLOC_HL_METRICS_01_043: [ gballoc_hl_aligned_malloc shall call gballoc_ll_aligned_malloc(alignment, size) and return the result of gballoc_ll_aligned_malloc. ]*/
+TEST_FUNCTION(when_gballoc_ll_aligned_malloc_fails_gballoc_hl_aligned_malloc_also_fails)
+{
+    // arrange
+    void* result;
+    STRICT_EXPECTED_CALL(gballoc_ll_init(NULL));
+    (void)gballoc_hl_init(NULL, NULL);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(gballoc_ll_aligned_malloc(64, 42))
+        .SetReturn(NULL);
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+
+    // act
+    result = gballoc_hl_aligned_malloc(64, 42);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    gballoc_hl_deinit();
+}
+
+/* Tests_SRS_GBALLOC_HL_METRICS_01_041: [ If the module was not initialized, gballoc_hl_aligned_malloc shall return NULL. ]*/
+TEST_FUNCTION(gballoc_hl_aligned_malloc_when_not_initialized_returns_NULL)
+{
+    // arrange
+    void* result;
+
+    // act
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, NULL))
+        .SetReturn(LAZY_INIT_ERROR);
+    result = gballoc_hl_aligned_malloc(64, 1);
+
+    // assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_HL_METRICS_01_045: [ gballoc_hl_aligned_malloc shall record the latency in the latency buckets of the malloc API. ]*/
+TEST_FUNCTION(gballoc_hl_aligned_malloc_records_the_latency_in_the_malloc_latency_buckets)
+{
+    // arrange
+    void* ptr;
+
+    STRICT_EXPECTED_CALL(gballoc_ll_init(NULL));
+    (void)gballoc_hl_init(NULL, NULL);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1.0);
+    STRICT_EXPECTED_CALL(gballoc_ll_aligned_malloc(64, 1));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(43.0);
+    ptr = gballoc_hl_aligned_malloc(64, 1);
+    umock_c_reset_all_calls();
+
+    GBALLOC_LATENCY_BUCKETS malloc_latency_buckets;
+
+    // act
+    int result = gballoc_hl_get_malloc_latency_buckets(&malloc_latency_buckets);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, malloc_latency_buckets.buckets[0].count);
+    ASSERT_ARE_EQUAL(uint32_t, 42, malloc_latency_buckets.buckets[0].latency_min);
+    ASSERT_ARE_EQUAL(uint32_t, 42, malloc_latency_buckets.buckets[0].latency_max);
+    ASSERT_ARE_EQUAL(uint32_t, 42, malloc_latency_buckets.buckets[0].latency_avg);
+
+    for (size_t i = 1; i < GBALLOC_LATENCY_BUCKET_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(uint32_t, 0, malloc_latency_buckets.buckets[i].count);
+    }
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    gballoc_hl_aligned_free(ptr);
+    gballoc_hl_deinit();
+}
+
+/* gballoc_hl_aligned_free */
+
+/* Tests_SRS_GBALLOC_HL_METRICS_01_047: [ gballoc_hl_aligned_free shall call timer_global_get_elapsed_us to obtain the start time of the free. ]*/
+/* Tests_SRS_GBALLOC_HL_METRICS_01_048: [ gballoc_hl_aligned_free shall call gballoc_ll_aligned_size to obtain the size of the allocation (used for latency counters). ]*/
+/* Tests_SRS_GBALLOC_HL_METRICS_01_049: [ gballoc_hl_aligned_free shall call gballoc_ll_aligned_free(ptr). ]*/
+/* Tests_SRS_GBALLOC_HL_METRICS_01_050: [ gballoc_hl_aligned_free shall call timer_global_get_elapsed_us to obtain the end time of the free. ]*/
+TEST_FUNCTION(gballoc_hl_aligned_free_calls_gballoc_ll_aligned_free)
+{
+    // arrange
+    void* ptr;
+    STRICT_EXPECTED_CALL(gballoc_ll_init(NULL));
+    (void)gballoc_hl_init(NULL, NULL);
+    ptr = gballoc_hl_aligned_malloc(64, 42);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(gballoc_ll_aligned_size(ptr));
+    STRICT_EXPECTED_CALL(gballoc_ll_aligned_free(ptr));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+
+    // act
+    gballoc_hl_aligned_free(ptr);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    gballoc_hl_deinit();
+}
+
+/* Tests_SRS_GBALLOC_HL_METRICS_01_046: [ If the module was not initialized, gballoc_hl_aligned_free shall return. ]*/
+TEST_FUNCTION(gballoc_hl_aligned_free_when_not_initialized_returns)
+{
+    // arrange
+    void* ptr;
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, NULL));
+    STRICT_EXPECTED_CALL(gballoc_ll_init(NULL));
+    (void)gballoc_hl_init(NULL, NULL);
+    ptr = gballoc_hl_aligned_malloc(64, 1);
+    gballoc_hl_aligned_free(ptr);
+    gballoc_hl_deinit();
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+
+    // act
+    gballoc_hl_aligned_free(ptr);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_GBALLOC_HL_METRICS_01_051: [ gballoc_hl_aligned_free shall record the latency in the latency buckets of the free API. ]*/
+TEST_FUNCTION(gballoc_hl_aligned_free_records_the_latency_in_the_free_latency_buckets)
+{
+    // arrange
+    void* ptr;
+
+    STRICT_EXPECTED_CALL(gballoc_ll_init(NULL));
+    (void)gballoc_hl_init(NULL, NULL);
+    ptr = gballoc_hl_aligned_malloc(64, 1);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(interlocked_add(IGNORED_ARG, 0));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1.0);
+    STRICT_EXPECTED_CALL(gballoc_ll_aligned_size(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(gballoc_ll_aligned_free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(43.0);
+    gballoc_hl_aligned_free(ptr);
+    umock_c_reset_all_calls();
+
+    GBALLOC_LATENCY_BUCKETS free_latency_buckets;
+
+    // act
+    int result = gballoc_hl_get_free_latency_buckets(&free_latency_buckets);
+
+    // assert
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 1, free_latency_buckets.buckets[0].count);
+    ASSERT_ARE_EQUAL(uint32_t, 42, free_latency_buckets.buckets[0].latency_min);
+    ASSERT_ARE_EQUAL(uint32_t, 42, free_latency_buckets.buckets[0].latency_max);
+    ASSERT_ARE_EQUAL(uint32_t, 42, free_latency_buckets.buckets[0].latency_avg);
+
+    for (size_t i = 1; i < GBALLOC_LATENCY_BUCKET_COUNT; i++)
+    {
+        ASSERT_ARE_EQUAL(uint32_t, 0, free_latency_buckets.buckets[i].count);
+    }
+
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    gballoc_hl_deinit();
+}
+
 /* Tests_SRS_GBALLOC_HL_METRICS_01_036: [ gballoc_hl_reset_counters shall reset the latency counters for all buckets for the APIs (malloc, calloc, realloc and free). ]*/
 TEST_FUNCTION(gballoc_hl_reset_counters_resets_the_counters)
 {
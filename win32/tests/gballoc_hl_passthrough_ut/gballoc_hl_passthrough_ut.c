@@ -2,8 +2,10 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #ifdef __cplusplus
+#include <cstdint>
 #include <cstdlib>
 #else
+#include <stdint.h>
 #include <stdlib.h>
 #endif
 
@@ -283,6 +285,96 @@ TEST_FUNCTION(gballoc_hl_free_with_non_NULL_succeeds)
     TEST_gballoc_hl_deinit();
 }
 
+/*Tests_SRS_GBALLOC_HL_PASSTHROUGH_01_001: [ gballoc_hl_aligned_malloc shall call lazy_init passing as execution function do_init and NULL for argument. ]*/
+/*Tests_SRS_GBALLOC_HL_PASSTHROUGH_01_003: [ gballoc_hl_aligned_malloc shall call gballoc_ll_aligned_malloc(alignment, size) and return what gballoc_ll_aligned_malloc returned. ]*/
+TEST_FUNCTION(gballoc_hl_aligned_malloc_succeeds)
+{
+    ///arrange
+    TEST_gballoc_hl_init();
+    void* result;
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, NULL));
+
+    STRICT_EXPECTED_CALL(gballoc_ll_aligned_malloc(4096, 3));
+
+    ///act
+    result = gballoc_hl_aligned_malloc(4096, 3);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(result);
+    ASSERT_ARE_EQUAL(size_t, 0, (uintptr_t)result % 4096);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    gballoc_hl_aligned_free(result);
+    TEST_gballoc_hl_deinit();
+}
+
+/*Tests_SRS_GBALLOC_HL_PASSTHROUGH_01_003: [ gballoc_hl_aligned_malloc shall call gballoc_ll_aligned_malloc(alignment, size) and return what gballoc_ll_aligned_malloc returned. ]*/
+TEST_FUNCTION(gballoc_hl_aligned_malloc_unhappy_path_1)
+{
+    ///arrange
+    TEST_gballoc_hl_init();
+    void* result;
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, NULL));
+
+    STRICT_EXPECTED_CALL(gballoc_ll_aligned_malloc(4096, 3))
+        .SetReturn(NULL);
+
+    ///act
+    result = gballoc_hl_aligned_malloc(4096, 3);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    TEST_gballoc_hl_deinit();
+}
+
+/*Tests_SRS_GBALLOC_HL_PASSTHROUGH_01_002: [ If lazy_init fail then gballoc_hl_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_hl_aligned_malloc_unhappy_path_2)
+{
+    ///arrange
+    TEST_gballoc_hl_init();
+    void* result;
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, NULL))
+        .SetReturn(LAZY_INIT_ERROR);
+
+    ///act
+    result = gballoc_hl_aligned_malloc(4096, 3);
+
+    ///assert
+    ASSERT_IS_NULL(result);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    TEST_gballoc_hl_deinit();
+}
+
+/*Tests_SRS_GBALLOC_HL_PASSTHROUGH_01_004: [ gballoc_hl_aligned_free shall call gballoc_ll_aligned_free(ptr). ]*/
+TEST_FUNCTION(gballoc_hl_aligned_free_calls_gballoc_ll_aligned_free)
+{
+    ///arrange
+    TEST_gballoc_hl_init();
+    void* ptr = gballoc_hl_aligned_malloc(4096, 3);
+    ASSERT_IS_NOT_NULL(ptr);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(gballoc_ll_aligned_free(ptr));
+
+    ///act
+    gballoc_hl_aligned_free(ptr);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    TEST_gballoc_hl_deinit();
+}
+
 /*Tests_SRS_GBALLOC_HL_PASSTHROUGH_02_024: [ gballoc_hl_calloc shall call lazy_init passing as execution function do_init and NULL for argument. ]*/
 /*Tests_SRS_GBALLOC_HL_PASSTHROUGH_02_007: [ gballoc_hl_calloc shall call gballoc_ll_calloc(nmemb, size) and return what gballoc_ll_calloc returned. ]*/
 TEST_FUNCTION(gballoc_ll_calloc_succeeds)
@@ -17,6 +17,7 @@ static TEST_MUTEX_HANDLE g_testByTest;
 static void* TEST_MALLOC_RESULT = (void*)0x1;
 static void* TEST_CALLOC_RESULT = (void*)0x2;
 static void* TEST_REALLOC_RESULT = (void*)0x3;
+static void* TEST_ALIGNED_MALLOC_RESULT = (void*)0x1000;
 
 #include "umock_c/umock_c.h"
 
@@ -31,6 +32,7 @@ extern "C" {
     MOCKABLE_FUNCTION(, void, mock_je_free, void*, ptr);
 
     MOCKABLE_FUNCTION(, size_t, mock_je_malloc_usable_size, void*, ptr);
+    MOCKABLE_FUNCTION(, void*, mock_je_mallocx, size_t, size, int, flags);
 #ifdef __cplusplus
 }
 #endif
@@ -40,6 +42,8 @@ MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
 #include "c_pal/gballoc_ll.h"
 
+#include "jemalloc/jemalloc.h" // for MALLOCX_ALIGN
+
 static void on_umock_c_error(UMOCK_C_ERROR_CODE error_code)
 {
     ASSERT_FAIL("umock_c reported error :%" PRI_MU_ENUM "", MU_ENUM_VALUE(UMOCK_C_ERROR_CODE, error_code));
@@ -57,6 +61,7 @@ TEST_SUITE_INITIALIZE(TestClassInitialize)
     REGISTER_GLOBAL_MOCK_RETURN(mock_je_malloc, TEST_MALLOC_RESULT);
     REGISTER_GLOBAL_MOCK_RETURN(mock_je_calloc, TEST_CALLOC_RESULT);
     REGISTER_GLOBAL_MOCK_RETURN(mock_je_realloc, TEST_REALLOC_RESULT);
+    REGISTER_GLOBAL_MOCK_RETURN(mock_je_mallocx, TEST_ALIGNED_MALLOC_RESULT);
 }
 
 TEST_SUITE_CLEANUP(TestClassCleanup)
@@ -217,4 +222,109 @@ TEST_FUNCTION(gballoc_ll_size_calls_mi_usable_size)
     ASSERT_ARE_EQUAL(size_t, 32, size);
 }
 
+/*Tests_SRS_GBALLOC_LL_JEMALLOC_01_008: [ If alignment is 0 or is not a power of 2, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_alignment_0_fails)
+{
+    ///arrange
+    void* ptr;
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(0, 10);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_JEMALLOC_01_008: [ If alignment is 0 or is not a power of 2, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_alignment_not_power_of_2_fails)
+{
+    ///arrange
+    void* ptr;
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(4095, 10);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_JEMALLOC_01_009: [ If size is 0, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_size_0_fails)
+{
+    ///arrange
+    void* ptr;
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(4096, 0);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_JEMALLOC_01_010: [ gballoc_ll_aligned_malloc shall call je_mallocx(size, MALLOCX_ALIGN(alignment)) and return what je_mallocx returned. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_calls_je_mallocx)
+{
+    ///arrange
+    void* ptr;
+
+    STRICT_EXPECTED_CALL(mock_je_mallocx(10, MALLOCX_ALIGN(4096)));
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(4096, 10);
+
+    ///assert
+    ASSERT_ARE_EQUAL(void_ptr, TEST_ALIGNED_MALLOC_RESULT, ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_JEMALLOC_01_010: [ gballoc_ll_aligned_malloc shall call je_mallocx(size, MALLOCX_ALIGN(alignment)) and return what je_mallocx returned. ]*/
+TEST_FUNCTION(when_je_mallocx_fails_gballoc_ll_aligned_malloc_fails)
+{
+    ///arrange
+    void* ptr;
+
+    STRICT_EXPECTED_CALL(mock_je_mallocx(10, MALLOCX_ALIGN(4096)))
+        .SetReturn(NULL);
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(4096, 10);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_JEMALLOC_01_011: [ gballoc_ll_aligned_free shall call je_free(ptr). ]*/
+TEST_FUNCTION(gballoc_ll_aligned_free_calls_je_free)
+{
+    ///arrange
+    STRICT_EXPECTED_CALL(mock_je_free(TEST_ALIGNED_MALLOC_RESULT));
+
+    ///act
+    gballoc_ll_aligned_free(TEST_ALIGNED_MALLOC_RESULT);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_JEMALLOC_01_012: [ gballoc_ll_aligned_size shall call je_malloc_usable_size and return what je_malloc_usable_size returned. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_size_calls_je_malloc_usable_size)
+{
+    ///arrange
+    size_t size;
+
+    STRICT_EXPECTED_CALL(mock_je_malloc_usable_size(TEST_ALIGNED_MALLOC_RESULT))
+        .SetReturn(4096);
+
+    ///act
+    size = gballoc_ll_aligned_size(TEST_ALIGNED_MALLOC_RESULT);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 4096, size);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
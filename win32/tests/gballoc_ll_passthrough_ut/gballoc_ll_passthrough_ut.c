@@ -2,8 +2,10 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #ifdef __cplusplus
+#include <cstdint>
 #include <cstdlib>
 #else
+#include <stdint.h>
 #include <stdlib.h>
 #endif
 
@@ -16,6 +18,9 @@ static void* TEST_MALLOC_RESULT = (void*)0x1;
 static void* TEST_CALLOC_RESULT = (void*)0x2;
 static void* TEST_REALLOC_RESULT = (void*)0x3;
 
+/*backing memory for the aligned allocation tests, malloc is mocked to return it*/
+static unsigned char test_aligned_block[2 * 4096 + 64];
+
 #include "umock_c/umock_c.h"
 
 #define ENABLE_MOCKS
@@ -212,4 +217,176 @@ TEST_FUNCTION(gballoc_ll_size_returns)
     ASSERT_ARE_EQUAL(size_t, 32, size);
 }
 
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_001: [ If alignment is 0 or is not a power of 2, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_alignment_0_fails)
+{
+    ///arrange
+    void* ptr;
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(0, 10);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_001: [ If alignment is 0 or is not a power of 2, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_alignment_not_power_of_2_fails)
+{
+    ///arrange
+    void* ptr;
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(4095, 10);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_002: [ If size is 0, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_size_0_fails)
+{
+    ///arrange
+    void* ptr;
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(4096, 0);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_004: [ On Windows, gballoc_ll_aligned_malloc shall call malloc for size + alignment - 1 + sizeof(void*) bytes (with alignment rounded up to sizeof(void*)) and store the pointer returned by malloc immediately before the first aligned address that leaves room for it. ]*/
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_005: [ gballoc_ll_aligned_malloc shall succeed and return the aligned memory block. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_calls_malloc_and_returns_an_aligned_pointer)
+{
+    ///arrange
+    void* ptr;
+
+    STRICT_EXPECTED_CALL(mock_malloc(10 + sizeof(void*) + 4096 - 1))
+        .SetReturn(test_aligned_block);
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(4096, 10);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(ptr);
+    ASSERT_ARE_EQUAL(size_t, 0, (uintptr_t)ptr % 4096);
+    ASSERT_IS_TRUE((unsigned char*)ptr >= test_aligned_block + sizeof(void*));
+    ASSERT_IS_TRUE((unsigned char*)ptr + 10 <= test_aligned_block + 10 + sizeof(void*) + 4096 - 1);
+    ASSERT_ARE_EQUAL(void_ptr, test_aligned_block, ((void**)ptr)[-1]);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_004: [ On Windows, gballoc_ll_aligned_malloc shall call malloc for size + alignment - 1 + sizeof(void*) bytes (with alignment rounded up to sizeof(void*)) and store the pointer returned by malloc immediately before the first aligned address that leaves room for it. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_alignment_1_aligns_at_sizeof_void_ptr)
+{
+    ///arrange
+    void* ptr;
+
+    STRICT_EXPECTED_CALL(mock_malloc(10 + sizeof(void*) + sizeof(void*) - 1))
+        .SetReturn(test_aligned_block);
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(1, 10);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(ptr);
+    ASSERT_ARE_EQUAL(size_t, 0, (uintptr_t)ptr % sizeof(void*));
+    ASSERT_ARE_EQUAL(void_ptr, test_aligned_block, ((void**)ptr)[-1]);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_006: [ If any error occurs, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_size_that_overflows_fails)
+{
+    ///arrange
+    void* ptr;
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(4096, SIZE_MAX - 4096);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_006: [ If any error occurs, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(when_malloc_fails_gballoc_ll_aligned_malloc_fails)
+{
+    ///arrange
+    void* ptr;
+
+    STRICT_EXPECTED_CALL(mock_malloc(10 + sizeof(void*) + 4096 - 1))
+        .SetReturn(NULL);
+
+    ///act
+    ptr = gballoc_ll_aligned_malloc(4096, 10);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_007: [ If ptr is NULL, gballoc_ll_aligned_free shall return. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_free_with_NULL_returns)
+{
+    ///arrange
+
+    ///act
+    gballoc_ll_aligned_free(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_009: [ On Windows, gballoc_ll_aligned_free shall call free on the pointer stored immediately before ptr. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_free_frees_the_malloc_block)
+{
+    ///arrange
+    void* ptr;
+
+    STRICT_EXPECTED_CALL(mock_malloc(IGNORED_ARG))
+        .SetReturn(test_aligned_block);
+    ptr = gballoc_ll_aligned_malloc(4096, 10);
+    ASSERT_IS_NOT_NULL(ptr);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_free(test_aligned_block));
+
+    ///act
+    gballoc_ll_aligned_free(ptr);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_GBALLOC_LL_PASSTHROUGH_01_011: [ On Windows, gballoc_ll_aligned_size shall return what _msize returns for the pointer stored immediately before ptr, minus the offset of ptr in that block. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_size_returns_the_size_after_the_aligned_pointer)
+{
+    ///arrange
+    void* ptr;
+    size_t size;
+
+    STRICT_EXPECTED_CALL(mock_malloc(IGNORED_ARG))
+        .SetReturn(test_aligned_block);
+    ptr = gballoc_ll_aligned_malloc(4096, 10);
+    ASSERT_IS_NOT_NULL(ptr);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock__msize(test_aligned_block))
+        .SetReturn(10 + sizeof(void*) + 4096 - 1);
+
+    ///act
+    size = gballoc_ll_aligned_size(ptr);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 10 + sizeof(void*) + 4096 - 1 - (size_t)((unsigned char*)ptr - test_aligned_block), size);
+    ASSERT_IS_TRUE(size >= 10);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
@@ -2,8 +2,10 @@
 // Licensed under the MIT license. See LICENSE file in the project root for full license information.
 
 #ifdef __cplusplus
+#include <cstdint>
 #include <cstdlib>
 #else
+#include <stdint.h>
 #include <stdlib.h>
 #endif
 
@@ -18,6 +20,9 @@ static void* TEST_MALLOC_RESULT = (void*)0x1;
 static void* TEST_REALLOC_RESULT = (void*)0x3;
 static HANDLE TEST_HEAP = (HANDLE)0x4;
 
+/*backing memory for the aligned allocation tests, HeapAlloc is mocked to return it*/
+static unsigned char test_aligned_block[2 * 4096 + 64];
+
 #include "umock_c/umock_c.h"
 #include "umock_c/umocktypes_windows.h"
 
@@ -475,4 +480,250 @@ TEST_FUNCTION(gballoc_ll_size_returns_what_HeapSize_returned_when_it_fails)
     ///clean
 }
 
+/*Tests_SRS_GBALLOC_LL_WIN32HEAP_01_001: [ If alignment is 0 or is not a power of 2, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_alignment_0_fails)
+{
+    ///arrange
+
+    ///act
+    void* ptr = gballoc_ll_aligned_malloc(0, 10);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+}
+
+/*Tests_SRS_GBALLOC_LL_WIN32HEAP_01_001: [ If alignment is 0 or is not a power of 2, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_alignment_not_power_of_2_fails)
+{
+    ///arrange
+
+    ///act
+    void* ptr = gballoc_ll_aligned_malloc(4095, 10);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+}
+
+/*Tests_SRS_GBALLOC_LL_WIN32HEAP_01_002: [ If size is 0, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_size_0_fails)
+{
+    ///arrange
+
+    ///act
+    void* ptr = gballoc_ll_aligned_malloc(4096, 0);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+}
+
+/*Tests_SRS_GBALLOC_LL_WIN32HEAP_01_003: [ gballoc_ll_aligned_malloc shall call lazy_init with parameter do_init set to heap_init. ]*/
+/*Tests_SRS_GBALLOC_LL_WIN32HEAP_01_005: [ gballoc_ll_aligned_malloc shall call HeapAlloc for size + alignment - 1 + sizeof(void*) bytes (with alignment rounded up to sizeof(void*)) and store the pointer returned by HeapAlloc immediately before the first aligned address that leaves room for it. ]*/
+/*Tests_SRS_GBALLOC_LL_WIN32HEAP_01_006: [ gballoc_ll_aligned_malloc shall succeed and return the aligned memory block. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_succeeds)
+{
+    ///arrange
+    TEST_gballoc_ll_init();
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(mock_HeapAlloc(TEST_HEAP, 0, 10 + sizeof(void*) + 4096 - 1))
+        .SetReturn(test_aligned_block);
+
+    ///act
+    void* ptr = gballoc_ll_aligned_malloc(4096, 10);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(ptr);
+    ASSERT_ARE_EQUAL(size_t, 0, (uintptr_t)ptr % 4096);
+    ASSERT_IS_TRUE((unsigned char*)ptr >= test_aligned_block + sizeof(void*));
+    ASSERT_IS_TRUE((unsigned char*)ptr + 10 <= test_aligned_block + 10 + sizeof(void*) + 4096 - 1);
+    ASSERT_ARE_EQUAL(void_ptr, test_aligned_block, ((void**)ptr)[-1]);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    gballoc_ll_deinit();
+}
+
+/*Tests_SRS_GBALLOC_LL_WIN32HEAP_01_005: [ gballoc_ll_aligned_malloc shall call HeapAlloc for size + alignment - 1 + sizeof(void*) bytes (with alignment rounded up to sizeof(void*)) and store the pointer returned by HeapAlloc immediately before the first aligned address that leaves room for it. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_alignment_1_aligns_at_sizeof_void_ptr)
+{
+    ///arrange
+    TEST_gballoc_ll_init();
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(mock_HeapAlloc(TEST_HEAP, 0, 10 + sizeof(void*) + sizeof(void*) - 1))
+        .SetReturn(test_aligned_block);
+
+    ///act
+    void* ptr = gballoc_ll_aligned_malloc(1, 10);
+
+    ///assert
+    ASSERT_IS_NOT_NULL(ptr);
+    ASSERT_ARE_EQUAL(size_t, 0, (uintptr_t)ptr % sizeof(void*));
+    ASSERT_ARE_EQUAL(void_ptr, test_aligned_block, ((void**)ptr)[-1]);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    gballoc_ll_deinit();
+}
+
+/*Tests_SRS_GBALLOC_LL_WIN32HEAP_01_004: [ If lazy_init fails then gballoc_ll_aligned_malloc shall return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_fails_when_lazy_init_fails)
+{
+    ///arrange
+    TEST_gballoc_ll_init();
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .SetReturn(LAZY_INIT_ERROR);
+
+    ///act
+    void* ptr = gballoc_ll_aligned_malloc(4096, 10);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    gballoc_ll_deinit();
+}
+
+/*Tests_SRS_GBALLOC_LL_WIN32HEAP_01_007: [ If any error occurs, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_with_size_that_overflows_fails)
+{
+    ///arrange
+    TEST_gballoc_ll_init();
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    ///act
+    void* ptr = gballoc_ll_aligned_malloc(4096, SIZE_MAX - 4096);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    gballoc_ll_deinit();
+}
+
+/*Tests_SRS_GBALLOC_LL_WIN32HEAP_01_007: [ If any error occurs, gballoc_ll_aligned_malloc shall fail and return NULL. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_malloc_fails_when_HeapAlloc_fails)
+{
+    ///arrange
+    TEST_gballoc_ll_init();
+
+    STRICT_EXPECTED_CALL(lazy_init(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+
+    STRICT_EXPECTED_CALL(mock_HeapAlloc(TEST_HEAP, 0, 10 + sizeof(void*) + 4096 - 1))
+        .SetReturn(NULL);
+
+    ///act
+    void* ptr = gballoc_ll_aligned_malloc(4096, 10);
+
+    ///assert
+    ASSERT_IS_NULL(ptr);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    gballoc_ll_deinit();
+}
+
+/*Tests_SRS_GBALLOC_LL_WIN32HEAP_01_008: [ If ptr is NULL, gballoc_ll_aligned_free shall return. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_free_with_NULL_returns)
+{
+    ///arrange
+
+    ///act
+    gballoc_ll_aligned_free(NULL);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+}
+
+/*Tests_SRS_GBALLOC_LL_WIN32HEAP_01_009: [ gballoc_ll_aligned_free shall call HeapFree on the pointer stored immediately before ptr. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_free_frees_the_HeapAlloc_block)
+{
+    ///arrange
+    TEST_gballoc_ll_init();
+    STRICT_EXPECTED_CALL(mock_HeapAlloc(TEST_HEAP, 0, IGNORED_ARG))
+        .SetReturn(test_aligned_block);
+    void* ptr = gballoc_ll_aligned_malloc(4096, 10);
+    ASSERT_IS_NOT_NULL(ptr);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_HeapFree(TEST_HEAP, 0, test_aligned_block));
+
+    ///act
+    gballoc_ll_aligned_free(ptr);
+
+    ///assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    gballoc_ll_deinit();
+}
+
+/*Tests_SRS_GBALLOC_LL_WIN32HEAP_01_010: [ gballoc_ll_aligned_size shall call HeapSize on the pointer stored immediately before ptr and return that size minus the offset of ptr in the block. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_size_returns_the_size_after_the_aligned_pointer)
+{
+    ///arrange
+    TEST_gballoc_ll_init();
+    STRICT_EXPECTED_CALL(mock_HeapAlloc(TEST_HEAP, 0, IGNORED_ARG))
+        .SetReturn(test_aligned_block);
+    void* ptr = gballoc_ll_aligned_malloc(4096, 10);
+    ASSERT_IS_NOT_NULL(ptr);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_HeapSize(TEST_HEAP, 0, test_aligned_block))
+        .SetReturn(10 + sizeof(void*) + 4096 - 1);
+
+    ///act
+    size_t size = gballoc_ll_aligned_size(ptr);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, 10 + sizeof(void*) + 4096 - 1 - (size_t)((unsigned char*)ptr - test_aligned_block), size);
+    ASSERT_IS_TRUE(size >= 10);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    gballoc_ll_deinit();
+}
+
+/*Tests_SRS_GBALLOC_LL_WIN32HEAP_01_010: [ gballoc_ll_aligned_size shall call HeapSize on the pointer stored immediately before ptr and return that size minus the offset of ptr in the block. ]*/
+TEST_FUNCTION(gballoc_ll_aligned_size_returns_what_HeapSize_returned_when_it_fails)
+{
+    ///arrange
+    TEST_gballoc_ll_init();
+    STRICT_EXPECTED_CALL(mock_HeapAlloc(TEST_HEAP, 0, IGNORED_ARG))
+        .SetReturn(test_aligned_block);
+    void* ptr = gballoc_ll_aligned_malloc(4096, 10);
+    ASSERT_IS_NOT_NULL(ptr);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mock_HeapSize(TEST_HEAP, 0, test_aligned_block))
+        .SetReturn((SIZE_T)(-1));
+
+    ///act
+    size_t size = gballoc_ll_aligned_size(ptr);
+
+    ///assert
+    ASSERT_ARE_EQUAL(size_t, (size_t)(-1), size);
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    ///clean
+    gballoc_ll_deinit();
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
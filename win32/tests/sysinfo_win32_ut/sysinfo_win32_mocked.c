@@ -3,7 +3,13 @@
 #include "windows.h"
 
 #define GetSystemInfo mocked_GetSystemInfo
+#define GetNumaHighestNodeNumber mocked_GetNumaHighestNodeNumber
+#define GetCurrentProcessorNumberEx mocked_GetCurrentProcessorNumberEx
+#define GetNumaProcessorNodeEx mocked_GetNumaProcessorNodeEx
 
 extern void mocked_GetSystemInfo(LPSYSTEM_INFO lpSystemInfo);
+extern BOOL mocked_GetNumaHighestNodeNumber(PULONG HighestNodeNumber);
+extern void mocked_GetCurrentProcessorNumberEx(PPROCESSOR_NUMBER ProcNumber);
+extern BOOL mocked_GetNumaProcessorNodeEx(PPROCESSOR_NUMBER Processor, PUSHORT NodeNumber);
 
 #include "../../src/sysinfo_win32.c"
@@ -23,6 +23,9 @@
 extern "C" {
 #endif
     MOCKABLE_FUNCTION(, void, mocked_GetSystemInfo, LPSYSTEM_INFO, lpSystemInfo)
+    MOCKABLE_FUNCTION(, BOOL, mocked_GetNumaHighestNodeNumber, PULONG, HighestNodeNumber)
+    MOCKABLE_FUNCTION(, void, mocked_GetCurrentProcessorNumberEx, PPROCESSOR_NUMBER, ProcNumber)
+    MOCKABLE_FUNCTION(, BOOL, mocked_GetNumaProcessorNodeEx, PPROCESSOR_NUMBER, Processor, PUSHORT, NodeNumber)
 #ifdef __cplusplus
 }
 #endif
@@ -53,6 +56,13 @@ TEST_SUITE_INITIALIZE(suite_init)
     ASSERT_ARE_EQUAL(int, 0, umocktypes_stdint_register_types(), "umocktypes_stdint_register_types failed");
 
     REGISTER_UMOCK_ALIAS_TYPE(LPSYSTEM_INFO, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(BOOL, int);
+    REGISTER_UMOCK_ALIAS_TYPE(PULONG, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PPROCESSOR_NUMBER, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(PUSHORT, void*);
+
+    REGISTER_GLOBAL_MOCK_RETURN(mocked_GetNumaHighestNodeNumber, TRUE);
+    REGISTER_GLOBAL_MOCK_RETURN(mocked_GetNumaProcessorNodeEx, TRUE);
 }
 
 TEST_SUITE_CLEANUP(suite_cleanup)
@@ -113,4 +123,119 @@ TEST_FUNCTION(sysinfo_get_processor_count_returns_the_processor_count_33)
     ASSERT_ARE_EQUAL(uint32_t, 33, proc_count);
 }
 
+/* sysinfo_get_numa_node_count */
+
+/* Tests_SRS_SYSINFO_WIN32_01_003: [ sysinfo_get_numa_node_count shall call GetNumaHighestNodeNumber to obtain the highest NUMA node number. ]*/
+/* Tests_SRS_SYSINFO_WIN32_01_005: [ Otherwise sysinfo_get_numa_node_count shall return the highest NUMA node number plus 1. ]*/
+TEST_FUNCTION(sysinfo_get_numa_node_count_returns_the_highest_node_number_plus_1)
+{
+    //arrange
+    ULONG test_highest_node_number = 3;
+    STRICT_EXPECTED_CALL(mocked_GetNumaHighestNodeNumber(IGNORED_ARG))
+        .CopyOutArgumentBuffer_HighestNodeNumber(&test_highest_node_number, sizeof(test_highest_node_number));
+
+    //act
+    uint32_t numa_node_count = sysinfo_get_numa_node_count();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 4, numa_node_count);
+}
+
+/* Tests_SRS_SYSINFO_WIN32_01_005: [ Otherwise sysinfo_get_numa_node_count shall return the highest NUMA node number plus 1. ]*/
+TEST_FUNCTION(sysinfo_get_numa_node_count_on_a_non_NUMA_host_returns_1)
+{
+    //arrange
+    ULONG test_highest_node_number = 0;
+    STRICT_EXPECTED_CALL(mocked_GetNumaHighestNodeNumber(IGNORED_ARG))
+        .CopyOutArgumentBuffer_HighestNodeNumber(&test_highest_node_number, sizeof(test_highest_node_number));
+
+    //act
+    uint32_t numa_node_count = sysinfo_get_numa_node_count();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, numa_node_count);
+}
+
+/* Tests_SRS_SYSINFO_WIN32_01_004: [ If GetNumaHighestNodeNumber fails, sysinfo_get_numa_node_count shall return 1. ]*/
+TEST_FUNCTION(when_GetNumaHighestNodeNumber_fails_sysinfo_get_numa_node_count_returns_1)
+{
+    //arrange
+    ULONG test_highest_node_number = 3;
+    STRICT_EXPECTED_CALL(mocked_GetNumaHighestNodeNumber(IGNORED_ARG))
+        .CopyOutArgumentBuffer_HighestNodeNumber(&test_highest_node_number, sizeof(test_highest_node_number))
+        .SetReturn(FALSE);
+
+    //act
+    uint32_t numa_node_count = sysinfo_get_numa_node_count();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 1, numa_node_count);
+}
+
+/* sysinfo_get_current_numa_node */
+
+/* Tests_SRS_SYSINFO_WIN32_01_006: [ sysinfo_get_current_numa_node shall call GetCurrentProcessorNumberEx to obtain the processor the calling thread is running on. ]*/
+/* Tests_SRS_SYSINFO_WIN32_01_007: [ sysinfo_get_current_numa_node shall call GetNumaProcessorNodeEx to obtain the NUMA node of the processor. ]*/
+/* Tests_SRS_SYSINFO_WIN32_01_009: [ Otherwise sysinfo_get_current_numa_node shall return the NUMA node returned by GetNumaProcessorNodeEx. ]*/
+TEST_FUNCTION(sysinfo_get_current_numa_node_returns_the_node_of_the_current_processor)
+{
+    //arrange
+    PROCESSOR_NUMBER test_processor_number = { 1, 7, 0 };
+    USHORT test_node_number = 2;
+    STRICT_EXPECTED_CALL(mocked_GetCurrentProcessorNumberEx(IGNORED_ARG))
+        .CopyOutArgumentBuffer_ProcNumber(&test_processor_number, sizeof(test_processor_number));
+    STRICT_EXPECTED_CALL(mocked_GetNumaProcessorNodeEx(IGNORED_ARG, IGNORED_ARG))
+        .ValidateArgumentBuffer(1, &test_processor_number, sizeof(test_processor_number))
+        .CopyOutArgumentBuffer_NodeNumber(&test_node_number, sizeof(test_node_number));
+
+    //act
+    uint32_t numa_node = sysinfo_get_current_numa_node();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 2, numa_node);
+}
+
+/* Tests_SRS_SYSINFO_WIN32_01_008: [ If GetNumaProcessorNodeEx fails, sysinfo_get_current_numa_node shall return 0. ]*/
+TEST_FUNCTION(when_GetNumaProcessorNodeEx_fails_sysinfo_get_current_numa_node_returns_0)
+{
+    //arrange
+    PROCESSOR_NUMBER test_processor_number = { 1, 7, 0 };
+    USHORT test_node_number = 2;
+    STRICT_EXPECTED_CALL(mocked_GetCurrentProcessorNumberEx(IGNORED_ARG))
+        .CopyOutArgumentBuffer_ProcNumber(&test_processor_number, sizeof(test_processor_number));
+    STRICT_EXPECTED_CALL(mocked_GetNumaProcessorNodeEx(IGNORED_ARG, IGNORED_ARG))
+        .CopyOutArgumentBuffer_NodeNumber(&test_node_number, sizeof(test_node_number))
+        .SetReturn(FALSE);
+
+    //act
+    uint32_t numa_node = sysinfo_get_current_numa_node();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 0, numa_node);
+}
+
+/* sysinfo_get_current_processor */
+
+/* Tests_SRS_SYSINFO_WIN32_01_010: [ sysinfo_get_current_processor shall call GetCurrentProcessorNumberEx to obtain the processor the calling thread is running on. ]*/
+/* Tests_SRS_SYSINFO_WIN32_01_011: [ sysinfo_get_current_processor shall return the group of the processor multiplied by 64 plus the number of the processor in its group. ]*/
+TEST_FUNCTION(sysinfo_get_current_processor_returns_the_processor_numbered_across_groups)
+{
+    //arrange
+    PROCESSOR_NUMBER test_processor_number = { 1, 7, 0 };
+    STRICT_EXPECTED_CALL(mocked_GetCurrentProcessorNumberEx(IGNORED_ARG))
+        .CopyOutArgumentBuffer_ProcNumber(&test_processor_number, sizeof(test_processor_number));
+
+    //act
+    uint32_t processor = sysinfo_get_current_processor();
+
+    //assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(uint32_t, 71, processor);
+}
+
 END_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
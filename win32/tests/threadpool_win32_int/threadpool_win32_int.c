@@ -252,6 +252,100 @@ TEST_FUNCTION(MU_C3(scheduling_, N_WORK_ITEMS, _work_items_works))
     execution_engine_dec_ref(execution_engine);
 }
 
+TEST_FUNCTION(MU_C3(scheduling_a_batch_of_, N_WORK_ITEMS, _work_items_works))
+{
+    // assert
+    // create an execution engine
+    volatile LONG call_count;
+    size_t i;
+    THREADPOOL_WORK_BATCH_ITEM work_items[N_WORK_ITEMS];
+    EXECUTION_ENGINE_PARAMETERS_WIN32 execution_engine_parameters = { 4, 0 };
+    EXECUTION_ENGINE_HANDLE execution_engine = execution_engine_create(&execution_engine_parameters);
+    ASSERT_IS_NOT_NULL(execution_engine);
+
+    // create the threadpool
+    THREADPOOL_HANDLE threadpool = threadpool_create(execution_engine);
+    ASSERT_IS_NOT_NULL(threadpool);
+
+    // open
+    HANDLE open_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+    ASSERT_IS_NOT_NULL(open_event);
+
+    ASSERT_ARE_EQUAL(int, 0, threadpool_open_async(threadpool, on_open_complete, &open_event));
+
+    // wait for open to complete
+    ASSERT_IS_TRUE(WaitForSingleObject(open_event, INFINITE) == WAIT_OBJECT_0);
+
+    (void)InterlockedExchange(&call_count, 0);
+
+    for (i = 0; i < N_WORK_ITEMS; i++)
+    {
+        work_items[i].work_function = work_function;
+        work_items[i].work_function_context = (void*)&call_count;
+    }
+
+    LogInfo("Scheduling a batch of " MU_TOSTRING(N_WORK_ITEMS) " work items");
+    // act (schedule all the work items at once)
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_batch(threadpool, work_items, N_WORK_ITEMS));
+
+    // assert
+    wait_for_equal(&call_count, N_WORK_ITEMS, INFINITE);
+    LogInfo("Work completed");
+
+    // cleanup
+    (void)CloseHandle(open_event);
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
+TEST_FUNCTION(MU_C3(scheduling_one_work_item_, N_WORK_ITEMS, _times_works))
+{
+    // assert
+    // create an execution engine
+    volatile LONG call_count;
+    size_t i;
+    EXECUTION_ENGINE_PARAMETERS_WIN32 execution_engine_parameters = { 4, 0 };
+    EXECUTION_ENGINE_HANDLE execution_engine = execution_engine_create(&execution_engine_parameters);
+    ASSERT_IS_NOT_NULL(execution_engine);
+
+    // create the threadpool
+    THREADPOOL_HANDLE threadpool = threadpool_create(execution_engine);
+    ASSERT_IS_NOT_NULL(threadpool);
+
+    // open
+    HANDLE open_event = CreateEvent(NULL, FALSE, FALSE, NULL);
+    ASSERT_IS_NOT_NULL(open_event);
+
+    ASSERT_ARE_EQUAL(int, 0, threadpool_open_async(threadpool, on_open_complete, &open_event));
+
+    // wait for open to complete
+    ASSERT_IS_TRUE(WaitForSingleObject(open_event, INFINITE) == WAIT_OBJECT_0);
+
+    (void)InterlockedExchange(&call_count, 0);
+
+    THREADPOOL_WORK_ITEM_HANDLE work_item = threadpool_create_work_item(threadpool, work_function, (void*)&call_count);
+    ASSERT_IS_NOT_NULL(work_item);
+
+    LogInfo("Scheduling the same work item " MU_TOSTRING(N_WORK_ITEMS) " times");
+    // act (schedule the work item repeatedly)
+    for (i = 0; i < N_WORK_ITEMS; i++)
+    {
+        ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_item(threadpool, work_item));
+    }
+
+    // assert
+    wait_for_equal(&call_count, N_WORK_ITEMS, INFINITE);
+    LogInfo("Work completed");
+
+    // cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    (void)CloseHandle(open_event);
+    threadpool_close(threadpool);
+    threadpool_destroy(threadpool);
+    execution_engine_dec_ref(execution_engine);
+}
+
 TEST_FUNCTION(one_start_timer_works_runs_once)
 {
     // assert
@@ -8,6 +8,7 @@
 #define CreateThreadpoolTimer mocked_CreateThreadpoolTimer
 #define InitializeThreadpoolEnvironment mocked_InitializeThreadpoolEnvironment
 #define SetThreadpoolCallbackPool mocked_SetThreadpoolCallbackPool
+#define SetThreadpoolCallbackPriority mocked_SetThreadpoolCallbackPriority
 #define CreateThreadpoolCleanupGroup mocked_CreateThreadpoolCleanupGroup
 #define SetThreadpoolCallbackCleanupGroup mocked_SetThreadpoolCallbackCleanupGroup
 #define CloseThreadpoolCleanupGroupMembers mocked_CloseThreadpoolCleanupGroupMembers
@@ -18,11 +19,13 @@
 #define SubmitThreadpoolWork mocked_SubmitThreadpoolWork
 #define SetThreadpoolTimer mocked_SetThreadpoolTimer
 #define WaitForThreadpoolTimerCallbacks mocked_WaitForThreadpoolTimerCallbacks
+#define WaitForThreadpoolWorkCallbacks mocked_WaitForThreadpoolWorkCallbacks
 
 PTP_WORK mocked_CreateThreadpoolWork(PTP_WORK_CALLBACK pfnwk, PVOID pv, PTP_CALLBACK_ENVIRON pcbe);
 PTP_TIMER mocked_CreateThreadpoolTimer(PTP_TIMER_CALLBACK pfnti, PVOID pv, PTP_CALLBACK_ENVIRON pcbe);
 void mocked_InitializeThreadpoolEnvironment(PTP_CALLBACK_ENVIRON pcbe);
 void mocked_SetThreadpoolCallbackPool(PTP_CALLBACK_ENVIRON pcbe, PTP_POOL ptpp);
+void mocked_SetThreadpoolCallbackPriority(PTP_CALLBACK_ENVIRON pcbe, TP_CALLBACK_PRIORITY Priority);
 PTP_CLEANUP_GROUP mocked_CreateThreadpoolCleanupGroup(void);
 VOID mocked_SetThreadpoolCallbackCleanupGroup(PTP_CALLBACK_ENVIRON pcbe, PTP_CLEANUP_GROUP ptpcg, PTP_CLEANUP_GROUP_CANCEL_CALLBACK pfng);
 void mocked_CloseThreadpoolCleanupGroupMembers(PTP_CLEANUP_GROUP ptpcg, BOOL fCancelPendingCallbacks, PVOID pvCleanupContext);
@@ -33,5 +36,6 @@ void mocked_DestroyThreadpoolEnvironment(PTP_CALLBACK_ENVIRON pcbe);
 void mocked_SubmitThreadpoolWork(PTP_WORK pwk);
 void mocked_SetThreadpoolTimer(PTP_TIMER pti, PFILETIME pftDueTime, DWORD msPeriod, DWORD msWindowLength);
 void mocked_WaitForThreadpoolTimerCallbacks(PTP_TIMER pti, BOOL fCancelPendingCallbacks);
+void mocked_WaitForThreadpoolWorkCallbacks(PTP_WORK pwk, BOOL fCancelPendingCallbacks);
 
 #include "../../src/threadpool_win32.c"
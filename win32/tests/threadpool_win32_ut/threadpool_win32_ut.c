@@ -1,11 +1,15 @@
 // Copyright (c) Microsoft. All rights reserved.
 
 #ifdef __cplusplus
+#include <climits>
 #include <cstdlib>
 #include <cinttypes>
+#include <cstring>
 #else
+#include <limits.h>
 #include <stdlib.h>
 #include <inttypes.h>
+#include <string.h>
 #endif
 
 #include "winsock2.h"
@@ -37,6 +41,7 @@ void real_free(void* ptr)
 #include "c_pal/gballoc_hl_redirect.h"
 #include "c_pal/execution_engine.h"
 #include "c_pal/execution_engine_win32.h"
+#include "c_pal/timer.h"
 
 #undef ENABLE_MOCKS
 
@@ -45,9 +50,16 @@ void real_free(void* ptr)
 #include "c_pal/string_utils.h"
 #include "c_pal/threadpool.h"
 
+/*threadpool.h is already included, so only the statistics functions are mocked*/
+#define ENABLE_MOCKS
+#include "c_pal/threadpool_statistics.h"
+#undef ENABLE_MOCKS
+
 static TEST_MUTEX_HANDLE test_serialize_mutex;
 static EXECUTION_ENGINE_HANDLE test_execution_engine = (EXECUTION_ENGINE_HANDLE)0x4243;
 static PTP_POOL test_pool = (PTP_POOL)0x4244;
+static PTP_POOL test_numa_node_pool = (PTP_POOL)0x4245;
+static THREADPOOL_STATISTICS_RECORDER_HANDLE test_statistics_recorder = (THREADPOOL_STATISTICS_RECORDER_HANDLE)0x4246;
 
 MU_DEFINE_ENUM_STRINGS(UMOCK_C_ERROR_CODE, UMOCK_C_ERROR_CODE_VALUES)
 
@@ -188,6 +200,9 @@ MOCK_FUNCTION_END()
 MOCK_FUNCTION_WITH_CODE(, void, mocked_SetThreadpoolCallbackPool, PTP_CALLBACK_ENVIRON, pcbe, PTP_POOL, ptpp)
 MOCK_FUNCTION_END()
 
+MOCK_FUNCTION_WITH_CODE(, void, mocked_SetThreadpoolCallbackPriority, PTP_CALLBACK_ENVIRON, pcbe, TP_CALLBACK_PRIORITY, Priority)
+MOCK_FUNCTION_END()
+
 MOCK_FUNCTION_WITH_CODE(, PTP_CLEANUP_GROUP, mocked_CreateThreadpoolCleanupGroup)
 MOCK_FUNCTION_END((PTP_CLEANUP_GROUP)real_malloc(1))
 
@@ -229,6 +244,9 @@ MOCK_FUNCTION_END()
 MOCK_FUNCTION_WITH_CODE(, void, mocked_WaitForThreadpoolTimerCallbacks, PTP_TIMER, pti, BOOL, fCancelPendingCallbacks)
 MOCK_FUNCTION_END()
 
+MOCK_FUNCTION_WITH_CODE(, void, mocked_WaitForThreadpoolWorkCallbacks, PTP_WORK, pwk, BOOL, fCancelPendingCallbacks)
+MOCK_FUNCTION_END()
+
 MOCK_FUNCTION_WITH_CODE(, void, test_on_open_complete, void*, context, THREADPOOL_OPEN_RESULT, open_result)
 MOCK_FUNCTION_END()
 MOCK_FUNCTION_WITH_CODE(, void, test_work_function, void*, context)
@@ -238,6 +256,14 @@ MOCK_FUNCTION_END()
 }
 #endif
 
+static const THREADPOOL_WORK_BATCH_ITEM test_batch_work_items[] =
+{
+    { test_work_function, (void*)0x4243 },
+    { test_work_function, (void*)0x4244 },
+    { test_work_function, (void*)0x4245 }
+};
+#define TEST_BATCH_WORK_ITEM_COUNT 3
+
 static THREADPOOL_HANDLE test_create_and_open_threadpool(PTP_CALLBACK_ENVIRON* cbe)
 {
     THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
@@ -252,6 +278,68 @@ static THREADPOOL_HANDLE test_create_and_open_threadpool(PTP_CALLBACK_ENVIRON* c
     return threadpool;
 }
 
+static THREADPOOL_HANDLE test_create_and_open_threadpool_with_statistics(PTP_CALLBACK_ENVIRON* cbe)
+{
+    THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(threadpool);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_enable_statistics(threadpool));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mocked_InitializeThreadpoolEnvironment(IGNORED_ARG))
+        .CaptureArgumentValue_pcbe(cbe);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_open_async(threadpool, test_on_open_complete, (void*)0x4242));
+    umock_c_reset_all_calls();
+
+    return threadpool;
+}
+
+static void setup_open_expected_calls(PTP_CALLBACK_ENVIRON* cbe, PTP_CALLBACK_ENVIRON* cbe_high_priority, PTP_CALLBACK_ENVIRON* cbe_low_priority, PTP_CLEANUP_GROUP* test_cleanup_group)
+{
+    STRICT_EXPECTED_CALL(mocked_InitializeThreadpoolEnvironment(IGNORED_ARG))
+        .CaptureArgumentValue_pcbe(cbe);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackPool(IGNORED_ARG, test_pool))
+        .ValidateArgumentValue_pcbe(cbe);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackPriority(IGNORED_ARG, TP_CALLBACK_PRIORITY_NORMAL))
+        .ValidateArgumentValue_pcbe(cbe);
+    STRICT_EXPECTED_CALL(mocked_InitializeThreadpoolEnvironment(IGNORED_ARG))
+        .CaptureArgumentValue_pcbe(cbe_high_priority);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackPool(IGNORED_ARG, test_pool))
+        .ValidateArgumentValue_pcbe(cbe_high_priority);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackPriority(IGNORED_ARG, TP_CALLBACK_PRIORITY_HIGH))
+        .ValidateArgumentValue_pcbe(cbe_high_priority);
+    STRICT_EXPECTED_CALL(mocked_InitializeThreadpoolEnvironment(IGNORED_ARG))
+        .CaptureArgumentValue_pcbe(cbe_low_priority);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackPool(IGNORED_ARG, test_pool))
+        .ValidateArgumentValue_pcbe(cbe_low_priority);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackPriority(IGNORED_ARG, TP_CALLBACK_PRIORITY_LOW))
+        .ValidateArgumentValue_pcbe(cbe_low_priority);
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolCleanupGroup())
+        .CaptureReturn(test_cleanup_group);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackCleanupGroup(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .ValidateArgumentValue_pcbe(cbe)
+        .ValidateArgumentValue_ptpcg(test_cleanup_group);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackCleanupGroup(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .ValidateArgumentValue_pcbe(cbe_high_priority)
+        .ValidateArgumentValue_ptpcg(test_cleanup_group);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackCleanupGroup(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .ValidateArgumentValue_pcbe(cbe_low_priority)
+        .ValidateArgumentValue_ptpcg(test_cleanup_group);
+}
+
+static THREADPOOL_HANDLE test_create_and_open_threadpool_with_priorities(PTP_CALLBACK_ENVIRON* cbe, PTP_CALLBACK_ENVIRON* cbe_high_priority, PTP_CALLBACK_ENVIRON* cbe_low_priority)
+{
+    PTP_CLEANUP_GROUP test_cleanup_group;
+    THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(threadpool);
+    umock_c_reset_all_calls();
+
+    setup_open_expected_calls(cbe, cbe_high_priority, cbe_low_priority, &test_cleanup_group);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_open_async(threadpool, test_on_open_complete, (void*)0x4242));
+    umock_c_reset_all_calls();
+
+    return threadpool;
+}
+
 static void test_create_threadpool_and_start_timer(uint32_t start_delay_ms, uint32_t timer_period_ms, void* work_function_context, THREADPOOL_HANDLE* threadpool, PTP_TIMER* ptp_timer, PTP_TIMER_CALLBACK* test_timer_callback, PVOID* test_timer_callback_context, TIMER_INSTANCE_HANDLE* timer_instance)
 {
     PTP_CALLBACK_ENVIRON cbe;
@@ -268,6 +356,33 @@ static void test_create_threadpool_and_start_timer(uint32_t start_delay_ms, uint
     umock_c_reset_all_calls();
 }
 
+static THREADPOOL_WORK_ITEM_HANDLE test_create_work_item(THREADPOOL_HANDLE threadpool, PTP_CALLBACK_ENVIRON cbe, void* work_function_context, PTP_WORK* ptp_work, PTP_WORK_CALLBACK* test_work_callback, PVOID* test_work_callback_context)
+{
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureArgumentValue_pfnwk(test_work_callback)
+        .CaptureArgumentValue_pv(test_work_callback_context)
+        .CaptureReturn(ptp_work);
+
+    THREADPOOL_WORK_ITEM_HANDLE work_item = threadpool_create_work_item(threadpool, test_work_function, work_function_context);
+    ASSERT_IS_NOT_NULL(work_item);
+    umock_c_reset_all_calls();
+
+    return work_item;
+}
+
+static void test_schedule_work_batch(THREADPOOL_HANDLE threadpool, PTP_CALLBACK_ENVIRON cbe, PTP_WORK* ptp_work, PTP_WORK_CALLBACK* test_work_callback, PVOID* test_work_callback_context)
+{
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureArgumentValue_pfnwk(test_work_callback)
+        .CaptureArgumentValue_pv(test_work_callback_context)
+        .CaptureReturn(ptp_work);
+
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_batch(threadpool, test_batch_work_items, TEST_BATCH_WORK_ITEM_COUNT));
+    umock_c_reset_all_calls();
+}
+
 BEGIN_TEST_SUITE(TEST_SUITE_NAME_FROM_CMAKE)
 
 TEST_SUITE_INITIALIZE(suite_init)
@@ -286,15 +401,19 @@ TEST_SUITE_INITIALIZE(suite_init)
     REGISTER_GLOBAL_MOCK_HOOK(free, real_free);
 
     REGISTER_GLOBAL_MOCK_RETURN(execution_engine_win32_get_threadpool, test_pool);
+    REGISTER_GLOBAL_MOCK_RETURNS(threadpool_statistics_recorder_create, test_statistics_recorder, NULL);
 
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(malloc, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(execution_engine_win32_get_threadpool, NULL);
+    REGISTER_GLOBAL_MOCK_RETURNS(execution_engine_win32_get_numa_node_threadpool, test_pool, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(mocked_CreateThreadpoolCleanupGroup, NULL);
     REGISTER_GLOBAL_MOCK_FAIL_RETURN(mocked_CreateThreadpoolWork, NULL);
 
     REGISTER_UMOCK_ALIAS_TYPE(EXECUTION_ENGINE_HANDLE, void*);
     REGISTER_UMOCK_ALIAS_TYPE(PTP_TIMER, void*);
     REGISTER_UMOCK_ALIAS_TYPE(PTP_TIMER_CALLBACK, void*);
+    REGISTER_UMOCK_ALIAS_TYPE(TP_CALLBACK_PRIORITY, int);
+    REGISTER_UMOCK_ALIAS_TYPE(THREADPOOL_STATISTICS_RECORDER_HANDLE, void*);
 
     REGISTER_TYPE(THREADPOOL_OPEN_RESULT, THREADPOOL_OPEN_RESULT);
 }
@@ -427,15 +546,12 @@ TEST_FUNCTION(threadpool_destroy_performs_an_implicit_close)
     // arrange
     THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
     PTP_CALLBACK_ENVIRON cbe;
+    PTP_CALLBACK_ENVIRON cbe_high_priority;
+    PTP_CALLBACK_ENVIRON cbe_low_priority;
     PTP_CLEANUP_GROUP test_cleanup_group;
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(mocked_InitializeThreadpoolEnvironment(IGNORED_ARG))
-        .CaptureArgumentValue_pcbe(&cbe);
-    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackPool(IGNORED_ARG, test_pool))
-        .ValidateArgumentValue_pcbe(&cbe);
-    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolCleanupGroup())
-        .CaptureReturn(&test_cleanup_group);
+    setup_open_expected_calls(&cbe, &cbe_high_priority, &cbe_low_priority, &test_cleanup_group);
     (void)threadpool_open_async(threadpool, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
@@ -443,6 +559,8 @@ TEST_FUNCTION(threadpool_destroy_performs_an_implicit_close)
     STRICT_EXPECTED_CALL(mocked_CloseThreadpoolCleanupGroupMembers(test_cleanup_group, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_CloseThreadpoolCleanupGroup(test_cleanup_group));
     STRICT_EXPECTED_CALL(mocked_DestroyThreadpoolEnvironment(cbe));
+    STRICT_EXPECTED_CALL(mocked_DestroyThreadpoolEnvironment(cbe_high_priority));
+    STRICT_EXPECTED_CALL(mocked_DestroyThreadpoolEnvironment(cbe_low_priority));
 
     // destroy calls
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
@@ -490,10 +608,12 @@ TEST_FUNCTION(threadpool_open_async_with_NULL_on_open_complete_fails)
 }
 
 /* Tests_SRS_THREADPOOL_WIN32_01_011: [ Otherwise, threadpool_open_async shall switch the state to OPENING. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_078: [ threadpool_open_async shall initialize one thread pool environment for each of the normal, high and low priorities. ]*/
 /* Tests_SRS_THREADPOOL_WIN32_01_026: [ threadpool_open_async shall initialize a thread pool environment by calling InitializeThreadpoolEnvironment. ]*/
 /* Tests_SRS_THREADPOOL_WIN32_01_027: [ threadpool_open_async shall set the thread pool for the environment to the pool obtained from the execution engine by calling SetThreadpoolCallbackPool. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_079: [ threadpool_open_async shall set the callback priority of each environment by calling SetThreadpoolCallbackPriority with TP_CALLBACK_PRIORITY_NORMAL, TP_CALLBACK_PRIORITY_HIGH and TP_CALLBACK_PRIORITY_LOW respectively. ]*/
 /* Tests_SRS_THREADPOOL_WIN32_01_028: [ threadpool_open_async shall create a threadpool cleanup group by calling CreateThreadpoolCleanupGroup. ]*/
-/* Tests_SRS_THREADPOOL_WIN32_01_029: [ threadpool_open_async shall associate the cleanup group with the just created environment by calling SetThreadpoolCallbackCleanupGroup. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_029: [ threadpool_open_async shall associate the cleanup group with each of the just created environments by calling SetThreadpoolCallbackCleanupGroup. ]*/
 /* Tests_SRS_THREADPOOL_WIN32_01_015: [ threadpool_open_async shall set the state to OPEN. ]*/
 /* Tests_SRS_THREADPOOL_WIN32_01_012: [ On success, threadpool_open_async shall return 0. ]*/
 /* Tests_SRS_THREADPOOL_WIN32_01_014: [ On success, threadpool_open_async shall call on_open_complete_context shall with THREADPOOL_OPEN_OK. ]*/
@@ -502,18 +622,13 @@ TEST_FUNCTION(threadpool_open_async_succeeds)
     // arrange
     THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
     PTP_CALLBACK_ENVIRON cbe;
+    PTP_CALLBACK_ENVIRON cbe_high_priority;
+    PTP_CALLBACK_ENVIRON cbe_low_priority;
     PTP_CLEANUP_GROUP test_cleanup_group;
     int result;
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(mocked_InitializeThreadpoolEnvironment(IGNORED_ARG))
-        .CaptureArgumentValue_pcbe(&cbe);
-    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackPool(IGNORED_ARG, test_pool))
-        .ValidateArgumentValue_pcbe(&cbe);
-    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolCleanupGroup())
-        .CaptureReturn(&test_cleanup_group);
-    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackCleanupGroup(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-        .ValidateArgumentValue_ptpcg(&test_cleanup_group);
+    setup_open_expected_calls(&cbe, &cbe_high_priority, &cbe_low_priority, &test_cleanup_group);
     STRICT_EXPECTED_CALL(test_on_open_complete((void*)0x4242, THREADPOOL_OPEN_OK));
 
     // act
@@ -533,18 +648,13 @@ TEST_FUNCTION(threadpool_open_async_succeeds_with_NULL_context)
     // arrange
     THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
     PTP_CALLBACK_ENVIRON cbe;
+    PTP_CALLBACK_ENVIRON cbe_high_priority;
+    PTP_CALLBACK_ENVIRON cbe_low_priority;
     PTP_CLEANUP_GROUP test_cleanup_group;
     int result;
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(mocked_InitializeThreadpoolEnvironment(IGNORED_ARG))
-        .CaptureArgumentValue_pcbe(&cbe);
-    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackPool(IGNORED_ARG, test_pool))
-        .ValidateArgumentValue_pcbe(&cbe);
-    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolCleanupGroup())
-        .CaptureReturn(&test_cleanup_group);
-    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackCleanupGroup(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-        .ValidateArgumentValue_ptpcg(&test_cleanup_group);
+    setup_open_expected_calls(&cbe, &cbe_high_priority, &cbe_low_priority, &test_cleanup_group);
     STRICT_EXPECTED_CALL(test_on_open_complete(NULL, THREADPOOL_OPEN_OK));
 
     // act
@@ -564,19 +674,14 @@ TEST_FUNCTION(when_underlying_calls_fail_threadpool_open_async_fails)
     // arrange
     THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
     PTP_CALLBACK_ENVIRON cbe;
+    PTP_CALLBACK_ENVIRON cbe_high_priority;
+    PTP_CALLBACK_ENVIRON cbe_low_priority;
     PTP_CLEANUP_GROUP test_cleanup_group;
     int result;
     size_t i;
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(mocked_InitializeThreadpoolEnvironment(IGNORED_ARG))
-        .CaptureArgumentValue_pcbe(&cbe);
-    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackPool(IGNORED_ARG, test_pool))
-        .ValidateArgumentValue_pcbe(&cbe);
-    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolCleanupGroup())
-        .CaptureReturn(&test_cleanup_group);
-    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackCleanupGroup(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
-        .ValidateArgumentValue_ptpcg(&test_cleanup_group);
+    setup_open_expected_calls(&cbe, &cbe_high_priority, &cbe_low_priority, &test_cleanup_group);
     STRICT_EXPECTED_CALL(test_on_open_complete((void*)0x4242, THREADPOOL_OPEN_OK));
 
     umock_c_negative_tests_snapshot();
@@ -637,27 +742,26 @@ TEST_FUNCTION(threadpool_close_with_NULL_handle_returns)
 /* Tests_SRS_THREADPOOL_WIN32_01_017: [ Otherwise, threadpool_close shall switch the state to CLOSING. ]*/
 /* Tests_SRS_THREADPOOL_WIN32_01_030: [ threadpool_close shall wait for any executing callbacks by calling CloseThreadpoolCleanupGroupMembers, passing FALSE as fCancelPendingCallbacks. ]*/
 /* Tests_SRS_THREADPOOL_WIN32_01_032: [ threadpool_close shall close the threadpool cleanup group by calling CloseThreadpoolCleanupGroup. ]*/
-/* Tests_SRS_THREADPOOL_WIN32_01_033: [ threadpool_close shall destroy the thread pool environment created in threadpool_open_async. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_033: [ threadpool_close shall destroy the thread pool environments created in threadpool_open_async. ]*/
 TEST_FUNCTION(threadpool_close_reverses_the_open_actions)
 {
     // arrange
     THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
     PTP_CALLBACK_ENVIRON cbe;
+    PTP_CALLBACK_ENVIRON cbe_high_priority;
+    PTP_CALLBACK_ENVIRON cbe_low_priority;
     PTP_CLEANUP_GROUP test_cleanup_group;
     umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(mocked_InitializeThreadpoolEnvironment(IGNORED_ARG))
-        .CaptureArgumentValue_pcbe(&cbe);
-    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackPool(IGNORED_ARG, test_pool))
-        .ValidateArgumentValue_pcbe(&cbe);
-    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolCleanupGroup())
-        .CaptureReturn(&test_cleanup_group);
+    setup_open_expected_calls(&cbe, &cbe_high_priority, &cbe_low_priority, &test_cleanup_group);
     (void)threadpool_open_async(threadpool, test_on_open_complete, (void*)0x4242);
     umock_c_reset_all_calls();
 
     STRICT_EXPECTED_CALL(mocked_CloseThreadpoolCleanupGroupMembers(test_cleanup_group, FALSE, NULL));
     STRICT_EXPECTED_CALL(mocked_CloseThreadpoolCleanupGroup(test_cleanup_group));
     STRICT_EXPECTED_CALL(mocked_DestroyThreadpoolEnvironment(cbe));
+    STRICT_EXPECTED_CALL(mocked_DestroyThreadpoolEnvironment(cbe_high_priority));
+    STRICT_EXPECTED_CALL(mocked_DestroyThreadpoolEnvironment(cbe_low_priority));
 
     // act
     threadpool_close(threadpool);
@@ -743,6 +847,8 @@ TEST_FUNCTION(threadpool_schedule_work_with_NULL_work_function_fails)
 /* Tests_SRS_THREADPOOL_WIN32_01_023: [ Otherwise threadpool_schedule_work shall allocate a context where work_function and context shall be saved. ]*/
 /* Tests_SRS_THREADPOOL_WIN32_01_034: [ threadpool_schedule_work shall call CreateThreadpoolWork to schedule execution the callback while passing to it the on_work_callback function and the newly created context. ]*/
 /* Tests_SRS_THREADPOOL_WIN32_01_041: [ threadpool_schedule_work shall call SubmitThreadpoolWork to submit the work item for execution. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_080: [ threadpool_schedule_work shall save in the context the time the work item is scheduled, obtained by calling timer_global_get_elapsed_us. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_083: [ threadpool_schedule_work shall schedule the work item with THREADPOOL_PRIORITY_NORMAL, creating the PTP_WORK in the normal priority environment. ]*/
 TEST_FUNCTION(threadpool_schedule_work_succeeds)
 {
     // arrange
@@ -755,6 +861,7 @@ TEST_FUNCTION(threadpool_schedule_work_succeeds)
     PTP_WORK ptp_work;
 
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
     STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe))
         .CaptureArgumentValue_pfnwk(&test_work_callback)
         .CaptureArgumentValue_pv(&test_work_callback_context)
@@ -787,6 +894,7 @@ TEST_FUNCTION(threadpool_schedule_work_succeeds_with_NULL_work_function_context)
     PTP_WORK ptp_work;
 
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
     STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe))
         .CaptureArgumentValue_pfnwk(&test_work_callback)
         .CaptureArgumentValue_pv(&test_work_callback_context)
@@ -818,6 +926,8 @@ TEST_FUNCTION(when_underlying_calls_fail_threadpool_schedule_work_fails)
     PTP_WORK ptp_work;
 
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .CallCannotFail();
     STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe))
         .CaptureReturn(&ptp_work);
     STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
@@ -844,6 +954,160 @@ TEST_FUNCTION(when_underlying_calls_fail_threadpool_schedule_work_fails)
     threadpool_destroy(threadpool);
 }
 
+/* threadpool_schedule_work_on_node */
+
+/* Tests_SRS_THREADPOOL_WIN32_01_101: [ If threadpool is NULL, threadpool_schedule_work_on_node shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_on_node_with_NULL_threadpool_fails)
+{
+    // arrange
+
+    // act
+    int result = threadpool_schedule_work_on_node(NULL, 1, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_102: [ If work_function is NULL, threadpool_schedule_work_on_node shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_on_node_with_NULL_work_function_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    // act
+    int result = threadpool_schedule_work_on_node(threadpool, 1, NULL, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_104: [ threadpool_schedule_work_on_node shall obtain the PTP_POOL of numa_node by calling execution_engine_win32_get_numa_node_threadpool. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_105: [ threadpool_schedule_work_on_node shall schedule the work item like threadpool_schedule_work, creating the PTP_WORK in an environment using the PTP_POOL of numa_node. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_106: [ If the threadpool of numa_node is not the threadpool of the execution engine, threadpool_schedule_work_on_node shall initialize a thread pool environment for it by calling InitializeThreadpoolEnvironment, SetThreadpoolCallbackPool and SetThreadpoolCallbackCleanupGroup with the cleanup group of the threadpool. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_107: [ threadpool_schedule_work_on_node shall destroy the thread pool environment by calling DestroyThreadpoolEnvironment once the PTP_WORK is created. ]*/
+TEST_FUNCTION(threadpool_schedule_work_on_node_creates_the_work_on_the_pool_of_the_node)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    PTP_CALLBACK_ENVIRON node_cbe;
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    PTP_WORK ptp_work;
+
+    STRICT_EXPECTED_CALL(execution_engine_win32_get_numa_node_threadpool(test_execution_engine, 1))
+        .SetReturn(test_numa_node_pool);
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(mocked_InitializeThreadpoolEnvironment(IGNORED_ARG))
+        .CaptureArgumentValue_pcbe(&node_cbe);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackPool(IGNORED_ARG, test_numa_node_pool))
+        .ValidateArgumentValue_pcbe(&node_cbe);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackCleanupGroup(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .ValidateArgumentValue_pcbe(&node_cbe);
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG))
+        .ValidateArgumentValue_pcbe(&node_cbe)
+        .CaptureArgumentValue_pfnwk(&test_work_callback)
+        .CaptureArgumentValue_pv(&test_work_callback_context)
+        .CaptureReturn(&ptp_work);
+    STRICT_EXPECTED_CALL(mocked_DestroyThreadpoolEnvironment(IGNORED_ARG))
+        .ValidateArgumentValue_pcbe(&node_cbe);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work);
+
+    // act
+    int result = threadpool_schedule_work_on_node(threadpool, 1, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_103: [ work_function_context shall be allowed to be NULL. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_105: [ threadpool_schedule_work_on_node shall schedule the work item like threadpool_schedule_work, creating the PTP_WORK in an environment using the PTP_POOL of numa_node. ]*/
+TEST_FUNCTION(threadpool_schedule_work_on_node_on_a_non_NUMA_host_uses_the_normal_priority_environment)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    PTP_WORK ptp_work;
+
+    STRICT_EXPECTED_CALL(execution_engine_win32_get_numa_node_threadpool(test_execution_engine, 0));
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureArgumentValue_pfnwk(&test_work_callback)
+        .CaptureArgumentValue_pv(&test_work_callback_context)
+        .CaptureReturn(&ptp_work);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work);
+
+    // act
+    int result = threadpool_schedule_work_on_node(threadpool, 0, test_work_function, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_108: [ If any error occurs, threadpool_schedule_work_on_node shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_schedule_work_on_node_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    STRICT_EXPECTED_CALL(execution_engine_win32_get_numa_node_threadpool(test_execution_engine, 1))
+        .SetReturn(test_numa_node_pool);
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(mocked_InitializeThreadpoolEnvironment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackPool(IGNORED_ARG, test_numa_node_pool));
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolCallbackCleanupGroup(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_DestroyThreadpoolEnvironment(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG));
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            int result = threadpool_schedule_work_on_node(threadpool, 1, test_work_function, (void*)0x4243);
+
+            // assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
 /* on_work_callback */
 
 /* Tests_SRS_THREADPOOL_WIN32_01_035: [ If context is NULL, on_work_callback shall return. ]*/
@@ -880,6 +1144,7 @@ TEST_FUNCTION(on_work_callback_with_NULL_context_returns)
 /* Tests_SRS_THREADPOOL_WIN32_01_037: [ The work_function callback passed to threadpool_schedule_work shall be called, passing to it the work_function_context argument passed to threadpool_schedule_work. ]*/
 /* Tests_SRS_THREADPOOL_WIN32_01_038: [ on_work_callback shall call CloseThreadpoolWork. ]*/
 /* Tests_SRS_THREADPOOL_WIN32_01_039: [ on_work_callback shall free the context allocated in threadpool_schedule_work. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_082: [ on_work_callback shall add the time the work item waited between being scheduled and starting to execute, obtained by calling timer_global_get_elapsed_us, to the queue wait statistics of its priority. ]*/
 TEST_FUNCTION(on_work_callback_triggers_the_user_work_function)
 {
     // arrange
@@ -898,6 +1163,7 @@ TEST_FUNCTION(on_work_callback_triggers_the_user_work_function)
     threadpool_schedule_work(threadpool, test_work_function, (void*)0x4243);
     umock_c_reset_all_calls();
 
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
     STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
     STRICT_EXPECTED_CALL(mocked_CloseThreadpoolWork(ptp_work));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
@@ -948,10 +1214,12 @@ TEST_FUNCTION(on_work_callback_triggers_2_user_work_functions)
     threadpool_schedule_work(threadpool, test_work_function, (void*)0x4244);
     umock_c_reset_all_calls();
 
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
     STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
     STRICT_EXPECTED_CALL(mocked_CloseThreadpoolWork(ptp_work_1));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
 
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
     STRICT_EXPECTED_CALL(test_work_function((void*)0x4244));
     STRICT_EXPECTED_CALL(mocked_CloseThreadpoolWork(ptp_work_2));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
@@ -989,6 +1257,7 @@ TEST_FUNCTION(on_work_callback_triggers_the_user_work_function_with_NULL_work_fu
     threadpool_schedule_work(threadpool, test_work_function, NULL);
     umock_c_reset_all_calls();
 
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
     STRICT_EXPECTED_CALL(test_work_function(NULL));
     STRICT_EXPECTED_CALL(mocked_CloseThreadpoolWork(ptp_work));
     STRICT_EXPECTED_CALL(free(IGNORED_ARG));
@@ -1003,33 +1272,95 @@ TEST_FUNCTION(on_work_callback_triggers_the_user_work_function_with_NULL_work_fu
     threadpool_destroy(threadpool);
 }
 
-/* threadpool_timer_start */
+/* Tests_SRS_THREADPOOL_WIN32_01_082: [ on_work_callback shall add the time the work item waited between being scheduled and starting to execute, obtained by calling timer_global_get_elapsed_us, to the queue wait statistics of its priority. ]*/
+TEST_FUNCTION(on_work_callback_records_the_queue_wait_of_the_priority)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    PTP_CALLBACK_ENVIRON cbe_high_priority;
+    PTP_CALLBACK_ENVIRON cbe_low_priority;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_priorities(&cbe, &cbe_high_priority, &cbe_low_priority);
 
-/* Tests_SRS_THREADPOOL_WIN32_42_001: [ If threadpool is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(threadpool_timer_start_with_NULL_threadpool_fails)
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context_1;
+    PVOID test_work_callback_context_2;
+    PTP_WORK ptp_work_1;
+    PTP_WORK ptp_work_2;
+    THREADPOOL_QUEUE_WAIT_STATISTICS high_priority_statistics;
+    THREADPOOL_QUEUE_WAIT_STATISTICS normal_priority_statistics;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1000.0);
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe_high_priority))
+        .CaptureArgumentValue_pfnwk(&test_work_callback)
+        .CaptureArgumentValue_pv(&test_work_callback_context_1)
+        .CaptureReturn(&ptp_work_1);
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1100.0);
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe_high_priority))
+        .CaptureArgumentValue_pfnwk(&test_work_callback)
+        .CaptureArgumentValue_pv(&test_work_callback_context_2)
+        .CaptureReturn(&ptp_work_2);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4243));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4244));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1500.0);
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+    STRICT_EXPECTED_CALL(mocked_CloseThreadpoolWork(ptp_work_1));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(1300.0);
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4244));
+    STRICT_EXPECTED_CALL(mocked_CloseThreadpoolWork(ptp_work_2));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    test_work_callback(NULL, test_work_callback_context_1, ptp_work_1);
+    test_work_callback(NULL, test_work_callback_context_2, ptp_work_2);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, threadpool_get_queue_wait_statistics(threadpool, THREADPOOL_PRIORITY_HIGH, &high_priority_statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 2, high_priority_statistics.work_item_count);
+    ASSERT_ARE_EQUAL(uint64_t, 700, high_priority_statistics.total_queue_wait_us);
+    ASSERT_ARE_EQUAL(uint64_t, 500, high_priority_statistics.max_queue_wait_us);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_get_queue_wait_statistics(threadpool, THREADPOOL_PRIORITY_NORMAL, &normal_priority_statistics));
+    ASSERT_ARE_EQUAL(uint64_t, 0, normal_priority_statistics.work_item_count);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_schedule_work_with_priority */
+
+/* Tests_SRS_THREADPOOL_WIN32_01_084: [ If threadpool is NULL, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_with_priority_with_NULL_threadpool_fails)
 {
     // arrange
-    TIMER_INSTANCE_HANDLE timer_instance;
+    int result;
 
     // act
-    int result = threadpool_timer_start(NULL, 42, 2000, test_work_function, (void*)0x4243, &timer_instance);
+    result = threadpool_schedule_work_with_priority(NULL, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4243);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_NOT_EQUAL(int, 0, result);
 }
 
-/* Tests_SRS_THREADPOOL_WIN32_42_002: [ If work_function is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(threadpool_timer_start_with_NULL_work_function_fails)
+/* Tests_SRS_THREADPOOL_WIN32_01_085: [ If priority is not THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL or THREADPOOL_PRIORITY_LOW, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_with_priority_with_invalid_priority_fails)
 {
     // arrange
     PTP_CALLBACK_ENVIRON cbe;
     THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
-
-    TIMER_INSTANCE_HANDLE timer_instance;
+    int result;
 
     // act
-    int result = threadpool_timer_start(threadpool, 42, 2000, NULL, (void*)0x4243, &timer_instance);
+    result = threadpool_schedule_work_with_priority(threadpool, (THREADPOOL_PRIORITY)0x42, test_work_function, (void*)0x4243);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -1039,15 +1370,16 @@ TEST_FUNCTION(threadpool_timer_start_with_NULL_work_function_fails)
     threadpool_destroy(threadpool);
 }
 
-/* Tests_SRS_THREADPOOL_WIN32_42_003: [ If timer_handle is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(threadpool_timer_start_with_NULL_timer_handle_fails)
+/* Tests_SRS_THREADPOOL_WIN32_01_086: [ If work_function is NULL, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_with_priority_with_NULL_work_function_fails)
 {
     // arrange
     PTP_CALLBACK_ENVIRON cbe;
     THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    int result;
 
     // act
-    int result = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243, NULL);
+    result = threadpool_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, NULL, (void*)0x4243);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
@@ -1057,35 +1389,2049 @@ TEST_FUNCTION(threadpool_timer_start_with_NULL_timer_handle_fails)
     threadpool_destroy(threadpool);
 }
 
-/* Tests_SRS_THREADPOOL_WIN32_42_005: [ threadpool_timer_start shall allocate a context for the timer being started and store work_function and work_function_context in it. ]*/
-/* Tests_SRS_THREADPOOL_WIN32_42_006: [ threadpool_timer_start shall call CreateThreadpoolTimer to schedule execution the callback while passing to it the on_timer_callback function and the newly created context. ]*/
-/* Tests_SRS_THREADPOOL_WIN32_42_007: [ threadpool_timer_start shall call SetThreadpoolTimer, passing negative start_delay_ms as pftDueTime, timer_period_ms as msPeriod, and 0 as msWindowLength. ]*/
-/* Tests_SRS_THREADPOOL_WIN32_42_009: [ threadpool_timer_start shall return the allocated handle in timer_handle. ]*/
-/* Tests_SRS_THREADPOOL_WIN32_42_010: [ threadpool_timer_start shall succeed and return 0. ]*/
-TEST_FUNCTION(threadpool_timer_start_succeeds)
+/* Tests_SRS_THREADPOOL_WIN32_01_088: [ Otherwise threadpool_schedule_work_with_priority shall schedule the work item like threadpool_schedule_work, creating the PTP_WORK in the environment of priority. ]*/
+TEST_FUNCTION(threadpool_schedule_work_with_priority_creates_the_work_in_the_environment_of_each_priority)
 {
     // arrange
     PTP_CALLBACK_ENVIRON cbe;
-    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
-
-    PTP_TIMER_CALLBACK test_timer_callback;
-    PVOID test_timer_callback_context;
-    PTP_TIMER ptp_timer;
+    PTP_CALLBACK_ENVIRON cbe_high_priority;
+    PTP_CALLBACK_ENVIRON cbe_low_priority;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_priorities(&cbe, &cbe_high_priority, &cbe_low_priority);
 
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context_1;
+    PVOID test_work_callback_context_2;
+    PVOID test_work_callback_context_3;
+    PTP_WORK ptp_work_1;
+    PTP_WORK ptp_work_2;
+    PTP_WORK ptp_work_3;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe_high_priority))
+        .CaptureArgumentValue_pfnwk(&test_work_callback)
+        .CaptureArgumentValue_pv(&test_work_callback_context_1)
+        .CaptureReturn(&ptp_work_1);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work_1);
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureArgumentValue_pv(&test_work_callback_context_2)
+        .CaptureReturn(&ptp_work_2);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work_2);
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe_low_priority))
+        .CaptureArgumentValue_pv(&test_work_callback_context_3)
+        .CaptureReturn(&ptp_work_3);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work_3);
+
+    // act
+    int result_1 = threadpool_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4243);
+    int result_2 = threadpool_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_NORMAL, test_work_function, (void*)0x4244);
+    int result_3 = threadpool_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_LOW, test_work_function, (void*)0x4245);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result_1);
+    ASSERT_ARE_EQUAL(int, 0, result_2);
+    ASSERT_ARE_EQUAL(int, 0, result_3);
+
+    // cleanup
+    test_work_callback(NULL, test_work_callback_context_1, ptp_work_1);
+    test_work_callback(NULL, test_work_callback_context_2, ptp_work_2);
+    test_work_callback(NULL, test_work_callback_context_3, ptp_work_3);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_087: [ work_function_context shall be allowed to be NULL. ]*/
+TEST_FUNCTION(threadpool_schedule_work_with_priority_with_NULL_work_function_context_succeeds)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    PTP_CALLBACK_ENVIRON cbe_high_priority;
+    PTP_CALLBACK_ENVIRON cbe_low_priority;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_priorities(&cbe, &cbe_high_priority, &cbe_low_priority);
+
+    int result;
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    PTP_WORK ptp_work;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe_low_priority))
+        .CaptureArgumentValue_pfnwk(&test_work_callback)
+        .CaptureArgumentValue_pv(&test_work_callback_context)
+        .CaptureReturn(&ptp_work);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work);
+
+    // act
+    result = threadpool_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_LOW, test_work_function, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_089: [ If any error occurs, threadpool_schedule_work_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_schedule_work_with_priority_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    PTP_CALLBACK_ENVIRON cbe_high_priority;
+    PTP_CALLBACK_ENVIRON cbe_low_priority;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_priorities(&cbe, &cbe_high_priority, &cbe_low_priority);
+
+    int result;
+    size_t i;
+    PTP_WORK ptp_work;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .CallCannotFail();
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe_high_priority))
+        .CaptureReturn(&ptp_work);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work);
+
+    umock_c_negative_tests_snapshot();
+
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            result = threadpool_schedule_work_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, test_work_function, (void*)0x4243);
+
+            // assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_schedule_work_batch */
+
+/* Tests_SRS_THREADPOOL_WIN32_01_062: [ If threadpool is NULL, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_with_NULL_threadpool_fails)
+{
+    // arrange
+    int result;
+
+    // act
+    result = threadpool_schedule_work_batch(NULL, test_batch_work_items, TEST_BATCH_WORK_ITEM_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_063: [ If work_items is NULL, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_with_NULL_work_items_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    int result;
+
+    // act
+    result = threadpool_schedule_work_batch(threadpool, NULL, TEST_BATCH_WORK_ITEM_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_064: [ If work_item_count is 0 or greater than LONG_MAX, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_with_0_work_item_count_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    int result;
+
+    // act
+    result = threadpool_schedule_work_batch(threadpool, test_batch_work_items, 0);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_064: [ If work_item_count is 0 or greater than LONG_MAX, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_with_work_item_count_greater_than_LONG_MAX_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    int result;
+
+    // act
+    result = threadpool_schedule_work_batch(threadpool, test_batch_work_items, (uint32_t)LONG_MAX + 1);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_065: [ If the work_function of any of the work items is NULL, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_with_a_NULL_work_function_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    THREADPOOL_WORK_BATCH_ITEM work_items[] =
+    {
+        { test_work_function, (void*)0x4243 },
+        { NULL, (void*)0x4244 }
+    };
+    int result;
+
+    // act
+    result = threadpool_schedule_work_batch(threadpool, work_items, MU_COUNT_ARRAY_ITEMS(work_items));
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_076: [ If threadpool is not OPEN, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_when_not_open_fails)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(threadpool);
+    umock_c_reset_all_calls();
+    int result;
+
+    // act
+    result = threadpool_schedule_work_batch(threadpool, test_batch_work_items, TEST_BATCH_WORK_ITEM_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_066: [ Otherwise threadpool_schedule_work_batch shall allocate in a single allocation a batch where the work_function and work_function_context of all the work items shall be saved. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_067: [ threadpool_schedule_work_batch shall call CreateThreadpoolWork once for the whole batch, passing to it the on_work_batch_callback function and the batch. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_068: [ threadpool_schedule_work_batch shall call SubmitThreadpoolWork work_item_count times, so that the PTP_WORK executes once for each work item. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_077: [ threadpool_schedule_work_batch shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_succeeds)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    int result;
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    PTP_WORK ptp_work;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureArgumentValue_pfnwk(&test_work_callback)
+        .CaptureArgumentValue_pv(&test_work_callback_context)
+        .CaptureReturn(&ptp_work);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work);
+
+    // act
+    result = threadpool_schedule_work_batch(threadpool, test_batch_work_items, TEST_BATCH_WORK_ITEM_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_069: [ If any error occurs, threadpool_schedule_work_batch shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_schedule_work_batch_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    int result;
+    size_t i;
+    PTP_WORK ptp_work;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureReturn(&ptp_work);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work);
+
+    umock_c_negative_tests_snapshot();
+
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            result = threadpool_schedule_work_batch(threadpool, test_batch_work_items, TEST_BATCH_WORK_ITEM_COUNT);
+
+            // assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* on_work_batch_callback */
+
+/* Tests_SRS_THREADPOOL_WIN32_01_070: [ If context is NULL, on_work_batch_callback shall return. ]*/
+TEST_FUNCTION(on_work_batch_callback_with_NULL_context_returns)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    PTP_WORK ptp_work;
+
+    test_schedule_work_batch(threadpool, cbe, &ptp_work, &test_work_callback, &test_work_callback_context);
+
+    // act
+    test_work_callback(NULL, NULL, ptp_work);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_071: [ Otherwise context shall be used as the batch created in threadpool_schedule_work_batch. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_072: [ on_work_batch_callback shall take the next work item of the batch by calling InterlockedIncrement on the index of the next work item. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_073: [ on_work_batch_callback shall call the work_function of the work item, passing to it the work_function_context of the work item. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_074: [ on_work_batch_callback shall decrement the count of work items of the batch not executed yet. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_075: [ If the count reached 0, on_work_batch_callback shall call CloseThreadpoolWork and free the batch. ]*/
+TEST_FUNCTION(on_work_batch_callback_runs_each_work_item_once_and_the_last_one_frees_the_batch)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    PTP_WORK ptp_work;
+
+    test_schedule_work_batch(threadpool, cbe, &ptp_work, &test_work_callback, &test_work_callback_context);
+
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4244));
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(mocked_CloseThreadpoolWork(ptp_work));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_create_work_item */
+
+/* Tests_SRS_THREADPOOL_WIN32_01_042: [ If threadpool is NULL, threadpool_create_work_item shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_create_work_item_with_NULL_threadpool_fails)
+{
+    // arrange
+    THREADPOOL_WORK_ITEM_HANDLE work_item;
+
+    // act
+    work_item = threadpool_create_work_item(NULL, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(work_item);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_043: [ If work_function is NULL, threadpool_create_work_item shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_create_work_item_with_NULL_work_function_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    THREADPOOL_WORK_ITEM_HANDLE work_item;
+
+    // act
+    work_item = threadpool_create_work_item(threadpool, NULL, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(work_item);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_045: [ If threadpool is not OPEN, threadpool_create_work_item shall fail and return NULL. ]*/
+TEST_FUNCTION(threadpool_create_work_item_when_not_open_fails)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(threadpool);
+    umock_c_reset_all_calls();
+    THREADPOOL_WORK_ITEM_HANDLE work_item;
+
+    // act
+    work_item = threadpool_create_work_item(threadpool, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NULL(work_item);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_046: [ threadpool_create_work_item shall allocate a work item where work_function and work_function_context shall be saved. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_047: [ threadpool_create_work_item shall call CreateThreadpoolWork, passing to it the on_work_item_callback function and the newly created work item, so that the PTP_WORK is created only once for all the schedules of the work item. ]*/
+TEST_FUNCTION(threadpool_create_work_item_succeeds)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    THREADPOOL_WORK_ITEM_HANDLE work_item;
+    PVOID test_work_callback_context;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureArgumentValue_pv(&test_work_callback_context);
+
+    // act
+    work_item = threadpool_create_work_item(threadpool, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(work_item);
+    ASSERT_ARE_EQUAL(void_ptr, work_item, test_work_callback_context);
+
+    // cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_044: [ work_function_context shall be allowed to be NULL. ]*/
+TEST_FUNCTION(threadpool_create_work_item_with_NULL_work_function_context_succeeds)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    THREADPOOL_WORK_ITEM_HANDLE work_item;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe));
+
+    // act
+    work_item = threadpool_create_work_item(threadpool, test_work_function, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_IS_NOT_NULL(work_item);
+
+    // cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_048: [ If any error occurs, threadpool_create_work_item shall fail and return NULL. ]*/
+TEST_FUNCTION(when_underlying_calls_fail_threadpool_create_work_item_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    THREADPOOL_WORK_ITEM_HANDLE work_item;
+    size_t i;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe));
+
+    umock_c_negative_tests_snapshot();
+
+    for (i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            work_item = threadpool_create_work_item(threadpool, test_work_function, (void*)0x4243);
+
+            // assert
+            ASSERT_IS_NULL(work_item, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_schedule_work_item */
+
+/* Tests_SRS_THREADPOOL_WIN32_01_049: [ If threadpool is NULL, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_item_with_NULL_threadpool_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    PTP_WORK ptp_work;
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, cbe, (void*)0x4243, &ptp_work, &test_work_callback, &test_work_callback_context);
+    int result;
+
+    // act
+    result = threadpool_schedule_work_item(NULL, work_item);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_050: [ If work_item is NULL, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_item_with_NULL_work_item_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    int result;
+
+    // act
+    result = threadpool_schedule_work_item(threadpool, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_051: [ threadpool_schedule_work_item shall call SubmitThreadpoolWork with the PTP_WORK of work_item and succeed, without allocating memory. ]*/
+TEST_FUNCTION(threadpool_schedule_work_item_succeeds)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    PTP_WORK ptp_work;
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, cbe, (void*)0x4243, &ptp_work, &test_work_callback, &test_work_callback_context);
+    int result;
+
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(ptp_work));
+
+    // act
+    result = threadpool_schedule_work_item(threadpool, work_item);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_051: [ threadpool_schedule_work_item shall call SubmitThreadpoolWork with the PTP_WORK of work_item and succeed, without allocating memory. ]*/
+TEST_FUNCTION(threadpool_schedule_work_item_twice_submits_the_same_PTP_WORK)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    PTP_WORK ptp_work;
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, cbe, (void*)0x4243, &ptp_work, &test_work_callback, &test_work_callback_context);
+    int result_1;
+    int result_2;
+
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(ptp_work));
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(ptp_work));
+
+    // act
+    result_1 = threadpool_schedule_work_item(threadpool, work_item);
+    result_2 = threadpool_schedule_work_item(threadpool, work_item);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result_1);
+    ASSERT_ARE_EQUAL(int, 0, result_2);
+
+    // cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_056: [ If threadpool is not OPEN, threadpool_schedule_work_item shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_schedule_work_item_when_not_open_fails)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
+    ASSERT_IS_NOT_NULL(threadpool);
+    umock_c_reset_all_calls();
+    int result;
+
+    // act
+    result = threadpool_schedule_work_item(threadpool, (THREADPOOL_WORK_ITEM_HANDLE)0x4245);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_destroy_work_item */
+
+/* Tests_SRS_THREADPOOL_WIN32_01_057: [ If threadpool is NULL, threadpool_destroy_work_item shall return. ]*/
+TEST_FUNCTION(threadpool_destroy_work_item_with_NULL_threadpool_returns)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    PTP_WORK ptp_work;
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, cbe, (void*)0x4243, &ptp_work, &test_work_callback, &test_work_callback_context);
+
+    // act
+    threadpool_destroy_work_item(NULL, work_item);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_058: [ If work_item is NULL, threadpool_destroy_work_item shall return. ]*/
+TEST_FUNCTION(threadpool_destroy_work_item_with_NULL_work_item_returns)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    // act
+    threadpool_destroy_work_item(threadpool, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_059: [ threadpool_destroy_work_item shall wait for all the scheduled executions of work_item to complete by calling WaitForThreadpoolWorkCallbacks, passing FALSE as fCancelPendingCallbacks. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_060: [ threadpool_destroy_work_item shall call CloseThreadpoolWork. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_061: [ threadpool_destroy_work_item shall free the work item. ]*/
+TEST_FUNCTION(threadpool_destroy_work_item_waits_closes_and_frees)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    PTP_WORK ptp_work;
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, cbe, (void*)0x4243, &ptp_work, &test_work_callback, &test_work_callback_context);
+
+    STRICT_EXPECTED_CALL(mocked_WaitForThreadpoolWorkCallbacks(ptp_work, FALSE));
+    STRICT_EXPECTED_CALL(mocked_CloseThreadpoolWork(ptp_work));
+    STRICT_EXPECTED_CALL(free(work_item));
+
+    // act
+    threadpool_destroy_work_item(threadpool, work_item);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* on_work_item_callback */
+
+/* Tests_SRS_THREADPOOL_WIN32_01_052: [ If context is NULL, on_work_item_callback shall return. ]*/
+TEST_FUNCTION(on_work_item_callback_with_NULL_context_returns)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    PTP_WORK ptp_work;
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, cbe, (void*)0x4243, &ptp_work, &test_work_callback, &test_work_callback_context);
+
+    // act
+    test_work_callback(NULL, NULL, ptp_work);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_053: [ Otherwise context shall be used as the work item created in threadpool_create_work_item. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_054: [ The work_function callback passed to threadpool_create_work_item shall be called, passing to it the work_function_context argument passed to threadpool_create_work_item. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_055: [ on_work_item_callback shall not close the PTP_WORK and shall not free the work item. ]*/
+TEST_FUNCTION(on_work_item_callback_triggers_the_user_work_function_each_time)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    PTP_WORK ptp_work;
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, cbe, (void*)0x4243, &ptp_work, &test_work_callback, &test_work_callback_context);
+
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(ptp_work));
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(ptp_work));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_item(threadpool, work_item));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_item(threadpool, work_item));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+
+    // act
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_start */
+
+/* Tests_SRS_THREADPOOL_WIN32_42_001: [ If threadpool is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_NULL_threadpool_fails)
+{
+    // arrange
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    // act
+    int result = threadpool_timer_start(NULL, 42, 2000, test_work_function, (void*)0x4243, &timer_instance);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_42_002: [ If work_function is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_NULL_work_function_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    // act
+    int result = threadpool_timer_start(threadpool, 42, 2000, NULL, (void*)0x4243, &timer_instance);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_42_003: [ If timer_handle is NULL, threadpool_schedule_work shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_NULL_timer_handle_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    // act
+    int result = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_42_005: [ threadpool_timer_start shall allocate a context for the timer being started and store work_function and work_function_context in it. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_42_006: [ threadpool_timer_start shall call CreateThreadpoolTimer to schedule execution the callback while passing to it the on_timer_callback function and the newly created context. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_42_007: [ threadpool_timer_start shall call SetThreadpoolTimer, passing negative start_delay_ms as pftDueTime, timer_period_ms as msPeriod, and 0 as msWindowLength. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_42_009: [ threadpool_timer_start shall return the allocated handle in timer_handle. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_42_010: [ threadpool_timer_start shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_timer_start_succeeds)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    PTP_TIMER_CALLBACK test_timer_callback;
+    PVOID test_timer_callback_context;
+    PTP_TIMER ptp_timer;
+
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    ULARGE_INTEGER ularge_due_time;
+    ularge_due_time.QuadPart = (ULONGLONG)-((int64_t)42 * 10000);
+    FILETIME filetime_expected;
+    filetime_expected.dwHighDateTime = ularge_due_time.HighPart;
+    filetime_expected.dwLowDateTime = ularge_due_time.LowPart;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureArgumentValue_pfnti(&test_timer_callback)
+        .CaptureArgumentValue_pv(&test_timer_callback_context)
+        .CaptureReturn(&ptp_timer);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, &filetime_expected, 2000, 0))
+        .ValidateArgumentValue_pti(&ptp_timer);
+
+    // act
+    int result = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243, &timer_instance);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(timer_instance);
+
+    // cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_42_004: [ work_function_context shall be allowed to be NULL. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_NULL_work_function_context_succeeds)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    PTP_TIMER_CALLBACK test_timer_callback;
+    PVOID test_timer_callback_context;
+    PTP_TIMER ptp_timer;
+
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    ULARGE_INTEGER ularge_due_time;
+    ularge_due_time.QuadPart = (ULONGLONG)-((int64_t)42 * 10000);
+    FILETIME filetime_expected;
+    filetime_expected.dwHighDateTime = ularge_due_time.HighPart;
+    filetime_expected.dwLowDateTime = ularge_due_time.LowPart;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureArgumentValue_pfnti(&test_timer_callback)
+        .CaptureArgumentValue_pv(&test_timer_callback_context)
+        .CaptureReturn(&ptp_timer);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, &filetime_expected, 2000, 0))
+        .ValidateArgumentValue_pti(&ptp_timer);
+
+    // act
+    int result = threadpool_timer_start(threadpool, 42, 2000, test_work_function, NULL, &timer_instance);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(timer_instance);
+
+    // cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_42_008: [ If any error occurs, threadpool_timer_start shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_fails_when_underlying_functions_fail)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    PTP_TIMER_CALLBACK test_timer_callback;
+    PVOID test_timer_callback_context;
+    PTP_TIMER ptp_timer;
+
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    ULARGE_INTEGER ularge_due_time;
+    ularge_due_time.QuadPart = (ULONGLONG)-((int64_t)42 * 10000);
+    FILETIME filetime_expected;
+    filetime_expected.dwHighDateTime = ularge_due_time.HighPart;
+    filetime_expected.dwLowDateTime = ularge_due_time.LowPart;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureArgumentValue_pfnti(&test_timer_callback)
+        .CaptureArgumentValue_pv(&test_timer_callback_context)
+        .CaptureReturn(&ptp_timer);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, &filetime_expected, 2000, 0))
+        .ValidateArgumentValue_pti(&ptp_timer);
+
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            int result = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243, &timer_instance);
+
+            // assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_start_with_priority */
+
+/* Tests_SRS_THREADPOOL_WIN32_01_090: [ If threadpool is NULL, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_priority_with_NULL_threadpool_fails)
+{
+    // arrange
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    // act
+    int result = threadpool_timer_start_with_priority(NULL, THREADPOOL_PRIORITY_HIGH, 42, 2000, test_work_function, (void*)0x4243, &timer_instance);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_091: [ If priority is not THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL or THREADPOOL_PRIORITY_LOW, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_priority_with_invalid_priority_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    // act
+    int result = threadpool_timer_start_with_priority(threadpool, (THREADPOOL_PRIORITY)0x42, 42, 2000, test_work_function, (void*)0x4243, &timer_instance);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_092: [ If work_function is NULL, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_priority_with_NULL_work_function_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    // act
+    int result = threadpool_timer_start_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, 42, 2000, NULL, (void*)0x4243, &timer_instance);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_093: [ If timer_handle is NULL, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_priority_with_NULL_timer_handle_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    // act
+    int result = threadpool_timer_start_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, 42, 2000, test_work_function, (void*)0x4243, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_095: [ Otherwise threadpool_timer_start_with_priority shall start the timer like threadpool_timer_start, creating the PTP_TIMER in the environment of priority. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_priority_creates_the_timer_in_the_environment_of_the_priority)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    PTP_CALLBACK_ENVIRON cbe_high_priority;
+    PTP_CALLBACK_ENVIRON cbe_low_priority;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_priorities(&cbe, &cbe_high_priority, &cbe_low_priority);
+
+    PTP_TIMER ptp_timer;
+
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    ULARGE_INTEGER ularge_due_time;
+    ularge_due_time.QuadPart = (ULONGLONG)-((int64_t)42 * 10000);
+    FILETIME filetime_expected;
+    filetime_expected.dwHighDateTime = ularge_due_time.HighPart;
+    filetime_expected.dwLowDateTime = ularge_due_time.LowPart;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, cbe_high_priority))
+        .CaptureReturn(&ptp_timer);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, &filetime_expected, 2000, 0))
+        .ValidateArgumentValue_pti(&ptp_timer);
+
+    // act
+    int result = threadpool_timer_start_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, 42, 2000, test_work_function, (void*)0x4243, &timer_instance);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(timer_instance);
+
+    // cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_094: [ work_function_context shall be allowed to be NULL. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_priority_with_NULL_work_function_context_succeeds)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    PTP_CALLBACK_ENVIRON cbe_high_priority;
+    PTP_CALLBACK_ENVIRON cbe_low_priority;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_priorities(&cbe, &cbe_high_priority, &cbe_low_priority);
+
+    PTP_TIMER ptp_timer;
+
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, cbe_low_priority))
+        .CaptureReturn(&ptp_timer);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, 2000, 0))
+        .ValidateArgumentValue_pti(&ptp_timer);
+
+    // act
+    int result = threadpool_timer_start_with_priority(threadpool, THREADPOOL_PRIORITY_LOW, 42, 2000, test_work_function, NULL, &timer_instance);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(timer_instance);
+
+    // cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_096: [ If any error occurs, threadpool_timer_start_with_priority shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_priority_fails_when_underlying_functions_fail)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    PTP_CALLBACK_ENVIRON cbe_high_priority;
+    PTP_CALLBACK_ENVIRON cbe_low_priority;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_priorities(&cbe, &cbe_high_priority, &cbe_low_priority);
+
+    PTP_TIMER ptp_timer;
+
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, cbe_high_priority))
+        .CaptureReturn(&ptp_timer);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, 2000, 0))
+        .ValidateArgumentValue_pti(&ptp_timer);
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            int result = threadpool_timer_start_with_priority(threadpool, THREADPOOL_PRIORITY_HIGH, 42, 2000, test_work_function, (void*)0x4243, &timer_instance);
+
+            // assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_start_with_tolerance */
+
+/* Tests_SRS_THREADPOOL_WIN32_01_142: [ If threadpool is NULL, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_tolerance_with_NULL_threadpool_fails)
+{
+    // arrange
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    // act
+    int result = threadpool_timer_start_with_tolerance(NULL, 42, 2000, 50, test_work_function, (void*)0x4243, &timer_instance);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_143: [ If work_function is NULL, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_tolerance_with_NULL_work_function_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    // act
+    int result = threadpool_timer_start_with_tolerance(threadpool, 42, 2000, 50, NULL, (void*)0x4243, &timer_instance);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_144: [ If timer_handle is NULL, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_tolerance_with_NULL_timer_handle_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    // act
+    int result = threadpool_timer_start_with_tolerance(threadpool, 42, 2000, 50, test_work_function, (void*)0x4243, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_146: [ Otherwise threadpool_timer_start_with_tolerance shall start the timer like threadpool_timer_start, passing tolerance_ms as msWindowLength to SetThreadpoolTimer. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_tolerance_passes_the_tolerance_as_the_window_length)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    PTP_TIMER ptp_timer;
+
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    ULARGE_INTEGER ularge_due_time;
+    ularge_due_time.QuadPart = (ULONGLONG)-((int64_t)42 * 10000);
+    FILETIME filetime_expected;
+    filetime_expected.dwHighDateTime = ularge_due_time.HighPart;
+    filetime_expected.dwLowDateTime = ularge_due_time.LowPart;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureReturn(&ptp_timer);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, &filetime_expected, 2000, 50))
+        .ValidateArgumentValue_pti(&ptp_timer);
+
+    // act
+    int result = threadpool_timer_start_with_tolerance(threadpool, 42, 2000, 50, test_work_function, (void*)0x4243, &timer_instance);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(timer_instance);
+
+    // cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_145: [ work_function_context shall be allowed to be NULL. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_tolerance_with_NULL_work_function_context_succeeds)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    PTP_TIMER ptp_timer;
+
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureReturn(&ptp_timer);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, 2000, 50))
+        .ValidateArgumentValue_pti(&ptp_timer);
+
+    // act
+    int result = threadpool_timer_start_with_tolerance(threadpool, 42, 2000, 50, test_work_function, NULL, &timer_instance);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_IS_NOT_NULL(timer_instance);
+
+    // cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_147: [ If any error occurs, threadpool_timer_start_with_tolerance shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_tolerance_fails_when_underlying_functions_fail)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    PTP_TIMER ptp_timer;
+
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureReturn(&ptp_timer);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, 2000, 50))
+        .ValidateArgumentValue_pti(&ptp_timer);
+
+    umock_c_negative_tests_snapshot();
+
+    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
+    {
+        if (umock_c_negative_tests_can_call_fail(i))
+        {
+            umock_c_negative_tests_reset();
+            umock_c_negative_tests_fail_call(i);
+
+            // act
+            int result = threadpool_timer_start_with_tolerance(threadpool, 42, 2000, 50, test_work_function, (void*)0x4243, &timer_instance);
+
+            // assert
+            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
+        }
+    }
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_restart */
+
+/* Tests_SRS_THREADPOOL_WIN32_42_019: [ If timer is NULL, threadpool_timer_restart shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_restart_with_NULL_timer_fails)
+{
+    // arrange
+
+    // act
+    int result = threadpool_timer_restart(NULL, 43, 1000);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_42_022: [ threadpool_timer_restart shall call SetThreadpoolTimer, passing negative start_delay_ms as pftDueTime, timer_period_ms as msPeriod, and the tolerance of the timer as msWindowLength. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_42_023: [ threadpool_timer_restart shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_timer_restart_succeeds)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool;
+    PTP_TIMER_CALLBACK test_timer_callback;
+    PVOID test_timer_callback_context;
+    PTP_TIMER ptp_timer;
+    TIMER_INSTANCE_HANDLE timer_instance;
+    test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool, &ptp_timer, &test_timer_callback, &test_timer_callback_context, &timer_instance);
+
+    ULARGE_INTEGER ularge_due_time;
+    ularge_due_time.QuadPart = (ULONGLONG)-((int64_t)43 * 10000);
+    FILETIME filetime_expected;
+    filetime_expected.dwHighDateTime = ularge_due_time.HighPart;
+    filetime_expected.dwLowDateTime = ularge_due_time.LowPart;
+
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, &filetime_expected, 1000, 0))
+        .ValidateArgumentValue_pti(&ptp_timer);
+
+    // act
+    int result = threadpool_timer_restart(timer_instance, 43, 1000);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_42_022: [ threadpool_timer_restart shall call SetThreadpoolTimer, passing negative start_delay_ms as pftDueTime, timer_period_ms as msPeriod, and the tolerance of the timer as msWindowLength. ]*/
+TEST_FUNCTION(threadpool_timer_restart_keeps_the_tolerance_of_the_timer)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    PTP_TIMER ptp_timer;
+    TIMER_INSTANCE_HANDLE timer_instance;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureReturn(&ptp_timer);
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, 2000, 50));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start_with_tolerance(threadpool, 42, 2000, 50, test_work_function, (void*)0x4243, &timer_instance));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, 1000, 50))
+        .ValidateArgumentValue_pti(&ptp_timer);
+
+    // act
+    int result = threadpool_timer_restart(timer_instance, 43, 1000);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_restart_with_tolerance */
+
+/* Tests_SRS_THREADPOOL_WIN32_01_148: [ If timer is NULL, threadpool_timer_restart_with_tolerance shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_restart_with_tolerance_with_NULL_timer_fails)
+{
+    // arrange
+
+    // act
+    int result = threadpool_timer_restart_with_tolerance(NULL, 43, 1000, 50);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_149: [ Otherwise threadpool_timer_restart_with_tolerance shall save tolerance_ms as the tolerance of the timer and restart the timer like threadpool_timer_restart. ]*/
+TEST_FUNCTION(threadpool_timer_restart_with_tolerance_passes_the_tolerance_as_the_window_length)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool;
+    PTP_TIMER_CALLBACK test_timer_callback;
+    PVOID test_timer_callback_context;
+    PTP_TIMER ptp_timer;
+    TIMER_INSTANCE_HANDLE timer_instance;
+    test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool, &ptp_timer, &test_timer_callback, &test_timer_callback_context, &timer_instance);
+
+    ULARGE_INTEGER ularge_due_time;
+    ularge_due_time.QuadPart = (ULONGLONG)-((int64_t)43 * 10000);
+    FILETIME filetime_expected;
+    filetime_expected.dwHighDateTime = ularge_due_time.HighPart;
+    filetime_expected.dwLowDateTime = ularge_due_time.LowPart;
+
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, &filetime_expected, 1000, 50))
+        .ValidateArgumentValue_pti(&ptp_timer);
+
+    // act
+    int result = threadpool_timer_restart_with_tolerance(timer_instance, 43, 1000, 50);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_cancel */
+
+/*Tests_SRS_THREADPOOL_WIN32_42_024: [ If timer is NULL, threadpool_timer_cancel shall fail and return. ]*/
+TEST_FUNCTION(threadpool_timer_cancel_with_NULL_timer_fails)
+{
+    // arrange
+
+    // act
+    threadpool_timer_cancel(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/*Tests_SRS_THREADPOOL_WIN32_42_025: [ threadpool_timer_cancel shall call SetThreadpoolTimer with NULL for pftDueTime and 0 for msPeriod and msWindowLength to cancel ongoing timers. ]*/
+/*Tests_SRS_THREADPOOL_WIN32_42_026: [ threadpool_timer_cancel shall call WaitForThreadpoolTimerCallbacks. ]*/
+TEST_FUNCTION(threadpool_timer_cancel_succeeds)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool;
+    PTP_TIMER_CALLBACK test_timer_callback;
+    PVOID test_timer_callback_context;
+    PTP_TIMER ptp_timer;
+    TIMER_INSTANCE_HANDLE timer_instance;
+    test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool, &ptp_timer, &test_timer_callback, &test_timer_callback_context, &timer_instance);
+
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(ptp_timer, NULL, 0, 0));
+    STRICT_EXPECTED_CALL(mocked_WaitForThreadpoolTimerCallbacks(ptp_timer, TRUE));
+
+    // act
+    threadpool_timer_cancel(timer_instance);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_timer_destroy */
+
+/* Tests_SRS_THREADPOOL_WIN32_42_011: [ If timer is NULL, threadpool_timer_destroy shall fail and return. ]*/
+TEST_FUNCTION(threadpool_timer_destroy_with_NULL_timer_fails)
+{
+    // arrange
+
+    // act
+    threadpool_timer_destroy(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_42_012: [ threadpool_timer_destroy shall call SetThreadpoolTimer with NULL for pftDueTime and 0 for msPeriod and msWindowLength to cancel ongoing timers. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_42_013: [ threadpool_timer_destroy shall call WaitForThreadpoolTimerCallbacks. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_42_014: [ threadpool_timer_destroy shall call CloseThreadpoolTimer. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_42_015: [ threadpool_timer_destroy shall free all resources in timer. ]*/
+TEST_FUNCTION(threadpool_timer_destroy_succeeds)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool;
+    PTP_TIMER_CALLBACK test_timer_callback;
+    PVOID test_timer_callback_context;
+    PTP_TIMER ptp_timer;
+    TIMER_INSTANCE_HANDLE timer_instance;
+    test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool, &ptp_timer, &test_timer_callback, &test_timer_callback_context, &timer_instance);
+
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(ptp_timer, NULL, 0, 0));
+    STRICT_EXPECTED_CALL(mocked_WaitForThreadpoolTimerCallbacks(ptp_timer, TRUE));
+    STRICT_EXPECTED_CALL(mocked_CloseThreadpoolTimer(ptp_timer));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    threadpool_timer_destroy(timer_instance);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* on_timer_callback */
+
+/* Tests_SRS_THREADPOOL_WIN32_42_016: [ If context is NULL, on_work_callback shall return. ]*/
+TEST_FUNCTION(on_timer_callback_with_NULL_context_returns)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool;
+    PTP_TIMER_CALLBACK test_timer_callback;
+    PVOID test_timer_callback_context;
+    PTP_TIMER ptp_timer;
+    TIMER_INSTANCE_HANDLE timer_instance;
+    test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool, &ptp_timer, &test_timer_callback, &test_timer_callback_context, &timer_instance);
+
+    // act
+    test_timer_callback(NULL, NULL, ptp_timer);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_42_017: [ Otherwise context shall be used as the context created in threadpool_schedule_work. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_42_018: [ The work_function callback passed to threadpool_schedule_work shall be called, passing to it the work_function_context argument passed to threadpool_schedule_work. ]*/
+TEST_FUNCTION(on_timer_callback_calls_user_callback)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool;
+    PTP_TIMER_CALLBACK test_timer_callback;
+    PVOID test_timer_callback_context;
+    PTP_TIMER ptp_timer;
+    TIMER_INSTANCE_HANDLE timer_instance;
+    test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool, &ptp_timer, &test_timer_callback, &test_timer_callback_context, &timer_instance);
+
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+
+    // act
+    test_timer_callback(NULL, test_timer_callback_context, ptp_timer);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_42_017: [ Otherwise context shall be used as the context created in threadpool_schedule_work. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_42_018: [ The work_function callback passed to threadpool_schedule_work shall be called, passing to it the work_function_context argument passed to threadpool_schedule_work. ]*/
+TEST_FUNCTION(on_timer_callback_calls_user_callback_multiple_times_as_timer_fires)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool;
+    PTP_TIMER_CALLBACK test_timer_callback;
+    PVOID test_timer_callback_context;
+    PTP_TIMER ptp_timer;
     TIMER_INSTANCE_HANDLE timer_instance;
+    test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool, &ptp_timer, &test_timer_callback, &test_timer_callback_context, &timer_instance);
+
+    uint32_t timer_fire_count = 10;
+
+    for (uint32_t i = 0; i < timer_fire_count; i++)
+    {
+        STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+    }
+
+    // act
+    for (uint32_t i = 0; i < timer_fire_count; i++)
+    {
+        test_timer_callback(NULL, test_timer_callback_context, ptp_timer);
+    }
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_timer_destroy(timer_instance);
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_get_queue_wait_statistics */
+
+/* Tests_SRS_THREADPOOL_WIN32_01_097: [ If threadpool is NULL, threadpool_get_queue_wait_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_get_queue_wait_statistics_with_NULL_threadpool_fails)
+{
+    // arrange
+    THREADPOOL_QUEUE_WAIT_STATISTICS statistics;
+
+    // act
+    int result = threadpool_get_queue_wait_statistics(NULL, THREADPOOL_PRIORITY_NORMAL, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_098: [ If priority is not THREADPOOL_PRIORITY_HIGH, THREADPOOL_PRIORITY_NORMAL or THREADPOOL_PRIORITY_LOW, threadpool_get_queue_wait_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_get_queue_wait_statistics_with_invalid_priority_fails)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
+    THREADPOOL_QUEUE_WAIT_STATISTICS statistics;
+    umock_c_reset_all_calls();
+
+    // act
+    int result = threadpool_get_queue_wait_statistics(threadpool, (THREADPOOL_PRIORITY)0x42, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_099: [ If statistics is NULL, threadpool_get_queue_wait_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_get_queue_wait_statistics_with_NULL_statistics_fails)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
+    umock_c_reset_all_calls();
+
+    // act
+    int result = threadpool_get_queue_wait_statistics(threadpool, THREADPOOL_PRIORITY_NORMAL, NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_081: [ threadpool_create shall initialize the queue wait statistics of all the priorities to 0. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_100: [ Otherwise threadpool_get_queue_wait_statistics shall fill statistics with the count of work items of priority that started executing and the total and maximum time in microseconds they waited, and return 0. ]*/
+TEST_FUNCTION(threadpool_get_queue_wait_statistics_on_a_new_threadpool_returns_0s)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
+    THREADPOOL_QUEUE_WAIT_STATISTICS statistics;
+    umock_c_reset_all_calls();
+
+    // act
+    int result = threadpool_get_queue_wait_statistics(threadpool, THREADPOOL_PRIORITY_LOW, &statistics);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.work_item_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.total_queue_wait_us);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.max_queue_wait_us);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* threadpool_enable_statistics */
+
+/* Tests_SRS_THREADPOOL_WIN32_01_123: [ If threadpool is NULL, threadpool_enable_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_enable_statistics_with_NULL_threadpool_fails)
+{
+    // arrange
+
+    // act
+    int result = threadpool_enable_statistics(NULL);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_125: [ If threadpool is not CLOSED, threadpool_enable_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_enable_statistics_when_open_fails)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+
+    // act
+    int result = threadpool_enable_statistics(threadpool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_109: [ threadpool_create shall create the threadpool with the statistics disabled. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_124: [ threadpool_enable_statistics shall switch the state from CLOSED to OPENING, so that the threadpool cannot be opened while the statistics are enabled. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_127: [ Otherwise threadpool_enable_statistics shall create the statistics recorder by calling threadpool_statistics_recorder_create. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_128: [ threadpool_enable_statistics shall set the state back to CLOSED. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_129: [ threadpool_enable_statistics shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_enable_statistics_creates_the_statistics_recorder)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_create());
+
+    // act
+    int result = threadpool_enable_statistics(threadpool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_open_async(threadpool, test_on_open_complete, (void*)0x4242));
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_126: [ If the statistics are already enabled, threadpool_enable_statistics shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_enable_statistics_when_already_enabled_succeeds)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_enable_statistics(threadpool));
+    umock_c_reset_all_calls();
+
+    // act
+    int result = threadpool_enable_statistics(threadpool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_130: [ If any error occurs, threadpool_enable_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(when_threadpool_statistics_recorder_create_fails_threadpool_enable_statistics_fails)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_create())
+        .SetReturn(NULL);
+
+    // act
+    int result = threadpool_enable_statistics(threadpool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_open_async(threadpool, test_on_open_complete, (void*)0x4242));
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_110: [ If the statistics are enabled, threadpool_destroy shall destroy the statistics recorder by calling threadpool_statistics_recorder_destroy. ]*/
+TEST_FUNCTION(threadpool_destroy_destroys_the_statistics_recorder)
+{
+    // arrange
+    THREADPOOL_HANDLE threadpool = threadpool_create(test_execution_engine);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_enable_statistics(threadpool));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_destroy(test_statistics_recorder));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    threadpool_destroy(threadpool);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_111: [ If the statistics are enabled, threadpool_schedule_work shall count the work item as queued by calling threadpool_statistics_recorder_on_queued. ]*/
+TEST_FUNCTION(threadpool_schedule_work_with_statistics_counts_the_work_item_as_queued)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics(&cbe);
+
+    int result;
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    PTP_WORK ptp_work;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureArgumentValue_pfnwk(&test_work_callback)
+        .CaptureArgumentValue_pv(&test_work_callback_context)
+        .CaptureReturn(&ptp_work);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work);
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_queued(test_statistics_recorder, 1));
+
+    // act
+    result = threadpool_schedule_work(threadpool, test_work_function, (void*)0x4243);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_112: [ If the statistics are enabled, on_work_callback shall call threadpool_statistics_recorder_on_started with the time the work item was scheduled before calling work_function and threadpool_statistics_recorder_on_completed after it. ]*/
+TEST_FUNCTION(on_work_callback_with_statistics_records_the_start_and_the_completion_of_the_work_function)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics(&cbe);
+
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    PTP_WORK ptp_work;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(100.0);
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureArgumentValue_pfnwk(&test_work_callback)
+        .CaptureArgumentValue_pv(&test_work_callback_context)
+        .CaptureReturn(&ptp_work);
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work(threadpool, test_work_function, (void*)0x4243));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(150.0);
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_started(test_statistics_recorder, 100.0))
+        .SetReturn(150.0);
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_completed(test_statistics_recorder, 150.0));
+    STRICT_EXPECTED_CALL(mocked_CloseThreadpoolWork(ptp_work));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_113: [ If the statistics are enabled, threadpool_schedule_work_batch shall save in the batch the time it is scheduled, obtained by calling timer_global_get_elapsed_us. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_114: [ If the statistics are enabled, threadpool_schedule_work_batch shall count the work items as queued by calling threadpool_statistics_recorder_on_queued with work_item_count. ]*/
+TEST_FUNCTION(threadpool_schedule_work_batch_with_statistics_counts_the_work_items_as_queued)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics(&cbe);
+
+    int result;
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    PTP_WORK ptp_work;
+
+    STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(mocked_CreateThreadpoolWork(IGNORED_ARG, IGNORED_ARG, cbe))
+        .CaptureArgumentValue_pfnwk(&test_work_callback)
+        .CaptureArgumentValue_pv(&test_work_callback_context)
+        .CaptureReturn(&ptp_work);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(IGNORED_ARG))
+        .ValidateArgumentValue_pwk(&ptp_work);
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_queued(test_statistics_recorder, TEST_BATCH_WORK_ITEM_COUNT));
+
+    // act
+    result = threadpool_schedule_work_batch(threadpool, test_batch_work_items, TEST_BATCH_WORK_ITEM_COUNT);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    threadpool_destroy(threadpool);
+}
 
-    ULARGE_INTEGER ularge_due_time;
-    ularge_due_time.QuadPart = (ULONGLONG)-((int64_t)42 * 10000);
-    FILETIME filetime_expected;
-    filetime_expected.dwHighDateTime = ularge_due_time.HighPart;
-    filetime_expected.dwLowDateTime = ularge_due_time.LowPart;
+/* Tests_SRS_THREADPOOL_WIN32_01_115: [ If the statistics are enabled, on_work_batch_callback shall call threadpool_statistics_recorder_on_started with the time the batch was scheduled before calling work_function and threadpool_statistics_recorder_on_completed after it. ]*/
+TEST_FUNCTION(on_work_batch_callback_with_statistics_records_the_start_and_the_completion_of_each_work_function)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics(&cbe);
+
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    PTP_WORK ptp_work;
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(100.0);
+    test_schedule_work_batch(threadpool, cbe, &ptp_work, &test_work_callback, &test_work_callback_context);
+
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_started(test_statistics_recorder, 100.0))
+        .SetReturn(150.0);
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_completed(test_statistics_recorder, 150.0));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_started(test_statistics_recorder, 100.0))
+        .SetReturn(160.0);
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4244));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_completed(test_statistics_recorder, 160.0));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_started(test_statistics_recorder, 100.0))
+        .SetReturn(170.0);
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4245));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_completed(test_statistics_recorder, 170.0));
+    STRICT_EXPECTED_CALL(mocked_CloseThreadpoolWork(ptp_work));
+    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+
+    // act
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_116: [ If the statistics are enabled, threadpool_schedule_work_item shall save in work_item the time it is submitted, obtained by calling timer_global_get_elapsed_us. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_117: [ If the statistics are enabled, threadpool_schedule_work_item shall count the work item as queued by calling threadpool_statistics_recorder_on_queued. ]*/
+TEST_FUNCTION(threadpool_schedule_work_item_with_statistics_counts_the_work_item_as_queued)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics(&cbe);
+    PTP_WORK ptp_work;
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, cbe, (void*)0x4243, &ptp_work, &test_work_callback, &test_work_callback_context);
+    int result;
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us());
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(ptp_work));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_queued(test_statistics_recorder, 1));
+
+    // act
+    result = threadpool_schedule_work_item(threadpool, work_item);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_118: [ If the statistics are enabled, on_work_item_callback shall call threadpool_statistics_recorder_on_started with the time the work item was last submitted before calling work_function and threadpool_statistics_recorder_on_completed after it. ]*/
+TEST_FUNCTION(on_work_item_callback_with_statistics_uses_the_time_of_the_last_submission)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics(&cbe);
+    PTP_WORK ptp_work;
+    PTP_WORK_CALLBACK test_work_callback;
+    PVOID test_work_callback_context;
+    THREADPOOL_WORK_ITEM_HANDLE work_item = test_create_work_item(threadpool, cbe, (void*)0x4243, &ptp_work, &test_work_callback, &test_work_callback_context);
+
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(100.0);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(ptp_work));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_queued(test_statistics_recorder, 1));
+    STRICT_EXPECTED_CALL(timer_global_get_elapsed_us())
+        .SetReturn(120.0);
+    STRICT_EXPECTED_CALL(mocked_SubmitThreadpoolWork(ptp_work));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_queued(test_statistics_recorder, 1));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_item(threadpool, work_item));
+    ASSERT_ARE_EQUAL(int, 0, threadpool_schedule_work_item(threadpool, work_item));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_started(test_statistics_recorder, 120.0))
+        .SetReturn(150.0);
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_on_completed(test_statistics_recorder, 150.0));
+
+    // act
+    test_work_callback(NULL, test_work_callback_context, ptp_work);
+
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+
+    // cleanup
+    threadpool_destroy_work_item(threadpool, work_item);
+    threadpool_destroy(threadpool);
+}
+
+/* Tests_SRS_THREADPOOL_WIN32_01_119: [ If the statistics are enabled, threadpool_timer_start shall initialize the lateness of the timer by calling threadpool_timer_lateness_init. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_120: [ If the statistics are enabled, threadpool_timer_start shall compute when the timer is due by calling threadpool_timer_lateness_set_due_time with start_delay_ms and timer_period_ms before calling SetThreadpoolTimer. ]*/
+TEST_FUNCTION(threadpool_timer_start_with_statistics_records_the_lateness_of_the_timer)
+{
+    // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics(&cbe);
+
+    PTP_TIMER_CALLBACK test_timer_callback;
+    PVOID test_timer_callback_context;
+    PTP_TIMER ptp_timer;
+
+    TIMER_INSTANCE_HANDLE timer_instance;
 
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, cbe))
         .CaptureArgumentValue_pfnti(&test_timer_callback)
         .CaptureArgumentValue_pv(&test_timer_callback_context)
         .CaptureReturn(&ptp_timer);
-    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, &filetime_expected, 2000, 0))
+    STRICT_EXPECTED_CALL(threadpool_timer_lateness_init(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(threadpool_timer_lateness_set_due_time(IGNORED_ARG, 42, 2000));
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, 2000, 0))
         .ValidateArgumentValue_pti(&ptp_timer);
 
     // act
@@ -1094,237 +3440,207 @@ TEST_FUNCTION(threadpool_timer_start_succeeds)
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_IS_NOT_NULL(timer_instance);
 
     // cleanup
     threadpool_timer_destroy(timer_instance);
     threadpool_destroy(threadpool);
 }
 
-/* Tests_SRS_THREADPOOL_WIN32_42_004: [ work_function_context shall be allowed to be NULL. ]*/
-TEST_FUNCTION(threadpool_timer_start_with_NULL_work_function_context_succeeds)
+/* Tests_SRS_THREADPOOL_WIN32_01_121: [ If the lateness of the timer is recorded, threadpool_timer_restart shall compute when the timer is due by calling threadpool_timer_lateness_set_due_time with start_delay_ms and timer_period_ms before calling SetThreadpoolTimer. ]*/
+TEST_FUNCTION(threadpool_timer_restart_with_statistics_computes_when_the_timer_is_due)
 {
     // arrange
     PTP_CALLBACK_ENVIRON cbe;
-    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
-
-    PTP_TIMER_CALLBACK test_timer_callback;
-    PVOID test_timer_callback_context;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics(&cbe);
     PTP_TIMER ptp_timer;
-
     TIMER_INSTANCE_HANDLE timer_instance;
 
-    ULARGE_INTEGER ularge_due_time;
-    ularge_due_time.QuadPart = (ULONGLONG)-((int64_t)42 * 10000);
-    FILETIME filetime_expected;
-    filetime_expected.dwHighDateTime = ularge_due_time.HighPart;
-    filetime_expected.dwLowDateTime = ularge_due_time.LowPart;
-
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, cbe))
-        .CaptureArgumentValue_pfnti(&test_timer_callback)
-        .CaptureArgumentValue_pv(&test_timer_callback_context)
         .CaptureReturn(&ptp_timer);
-    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, &filetime_expected, 2000, 0))
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243, &timer_instance));
+    umock_c_reset_all_calls();
+
+    STRICT_EXPECTED_CALL(threadpool_timer_lateness_set_due_time(IGNORED_ARG, 43, 1000));
+    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, 1000, 0))
         .ValidateArgumentValue_pti(&ptp_timer);
 
     // act
-    int result = threadpool_timer_start(threadpool, 42, 2000, test_work_function, NULL, &timer_instance);
+    int result = threadpool_timer_restart(timer_instance, 43, 1000);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_EQUAL(int, 0, result);
-    ASSERT_IS_NOT_NULL(timer_instance);
 
     // cleanup
     threadpool_timer_destroy(timer_instance);
     threadpool_destroy(threadpool);
 }
 
-/* Tests_SRS_THREADPOOL_WIN32_42_008: [ If any error occurs, threadpool_timer_start shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(threadpool_timer_start_fails_when_underlying_functions_fail)
+/* Tests_SRS_THREADPOOL_WIN32_01_122: [ If the lateness of the timer is recorded, on_timer_callback shall record it by calling threadpool_timer_lateness_on_fired before calling work_function. ]*/
+TEST_FUNCTION(on_timer_callback_with_statistics_records_the_lateness_and_calls_the_user_callback)
 {
     // arrange
     PTP_CALLBACK_ENVIRON cbe;
-    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
-
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics(&cbe);
     PTP_TIMER_CALLBACK test_timer_callback;
     PVOID test_timer_callback_context;
     PTP_TIMER ptp_timer;
-
     TIMER_INSTANCE_HANDLE timer_instance;
 
-    ULARGE_INTEGER ularge_due_time;
-    ularge_due_time.QuadPart = (ULONGLONG)-((int64_t)42 * 10000);
-    FILETIME filetime_expected;
-    filetime_expected.dwHighDateTime = ularge_due_time.HighPart;
-    filetime_expected.dwLowDateTime = ularge_due_time.LowPart;
-
     STRICT_EXPECTED_CALL(malloc(IGNORED_ARG));
     STRICT_EXPECTED_CALL(mocked_CreateThreadpoolTimer(IGNORED_ARG, IGNORED_ARG, cbe))
         .CaptureArgumentValue_pfnti(&test_timer_callback)
         .CaptureArgumentValue_pv(&test_timer_callback_context)
         .CaptureReturn(&ptp_timer);
-    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, &filetime_expected, 2000, 0))
-        .ValidateArgumentValue_pti(&ptp_timer);
-
-
-    umock_c_negative_tests_snapshot();
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243, &timer_instance));
+    umock_c_reset_all_calls();
 
-    for (size_t i = 0; i < umock_c_negative_tests_call_count(); i++)
-    {
-        if (umock_c_negative_tests_can_call_fail(i))
-        {
-            umock_c_negative_tests_reset();
-            umock_c_negative_tests_fail_call(i);
+    STRICT_EXPECTED_CALL(threadpool_timer_lateness_on_fired(IGNORED_ARG));
+    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
 
-            // act
-            int result = threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243, &timer_instance);
+    // act
+    test_timer_callback(NULL, test_timer_callback_context, ptp_timer);
 
-            // assert
-            ASSERT_ARE_NOT_EQUAL(int, 0, result, "On failed call %zu", i);
-        }
-    }
+    // assert
+    ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
 
     // cleanup
+    threadpool_timer_destroy(timer_instance);
     threadpool_destroy(threadpool);
 }
 
-/* threadpool_timer_restart */
+/* threadpool_get_statistics */
 
-/* Tests_SRS_THREADPOOL_WIN32_42_019: [ If timer is NULL, threadpool_timer_restart shall fail and return a non-zero value. ]*/
-TEST_FUNCTION(threadpool_timer_restart_with_NULL_timer_fails)
+/* Tests_SRS_THREADPOOL_WIN32_01_131: [ If threadpool is NULL, threadpool_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_get_statistics_with_NULL_threadpool_fails)
 {
     // arrange
+    THREADPOOL_STATISTICS statistics;
 
     // act
-    int result = threadpool_timer_restart(NULL, 43, 1000);
+    int result = threadpool_get_statistics(NULL, &statistics);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
     ASSERT_ARE_NOT_EQUAL(int, 0, result);
 }
 
-/* Tests_SRS_THREADPOOL_WIN32_42_022: [ threadpool_timer_restart shall call SetThreadpoolTimer, passing negative start_delay_ms as pftDueTime, timer_period_ms as msPeriod, and 0 as msWindowLength. ]*/
-/* Tests_SRS_THREADPOOL_WIN32_42_023: [ threadpool_timer_restart shall succeed and return 0. ]*/
-TEST_FUNCTION(threadpool_timer_restart_succeeds)
+/* Tests_SRS_THREADPOOL_WIN32_01_132: [ If statistics is NULL, threadpool_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_get_statistics_with_NULL_statistics_fails)
 {
     // arrange
-    THREADPOOL_HANDLE threadpool;
-    PTP_TIMER_CALLBACK test_timer_callback;
-    PVOID test_timer_callback_context;
-    PTP_TIMER ptp_timer;
-    TIMER_INSTANCE_HANDLE timer_instance;
-    test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool, &ptp_timer, &test_timer_callback, &test_timer_callback_context, &timer_instance);
-
-    ULARGE_INTEGER ularge_due_time;
-    ularge_due_time.QuadPart = (ULONGLONG)-((int64_t)43 * 10000);
-    FILETIME filetime_expected;
-    filetime_expected.dwHighDateTime = ularge_due_time.HighPart;
-    filetime_expected.dwLowDateTime = ularge_due_time.LowPart;
-
-    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(IGNORED_ARG, &filetime_expected, 1000, 0))
-        .ValidateArgumentValue_pti(&ptp_timer);
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics(&cbe);
 
     // act
-    int result = threadpool_timer_restart(timer_instance, 43, 1000);
+    int result = threadpool_get_statistics(threadpool, NULL);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
     // cleanup
-    threadpool_timer_destroy(timer_instance);
     threadpool_destroy(threadpool);
 }
 
-/* threadpool_timer_cancel */
-
-/*Tests_SRS_THREADPOOL_WIN32_42_024: [ If timer is NULL, threadpool_timer_cancel shall fail and return. ]*/
-TEST_FUNCTION(threadpool_timer_cancel_with_NULL_timer_fails)
+/* Tests_SRS_THREADPOOL_WIN32_01_133: [ If the statistics are not enabled, threadpool_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_get_statistics_when_the_statistics_are_not_enabled_fails)
 {
     // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool(&cbe);
+    THREADPOOL_STATISTICS statistics;
 
     // act
-    threadpool_timer_cancel(NULL);
+    int result = threadpool_get_statistics(threadpool, &statistics);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
+
+    // cleanup
+    threadpool_destroy(threadpool);
 }
 
-/*Tests_SRS_THREADPOOL_WIN32_42_025: [ threadpool_timer_cancel shall call SetThreadpoolTimer with NULL for pftDueTime and 0 for msPeriod and msWindowLength to cancel ongoing timers. ]*/
-/*Tests_SRS_THREADPOOL_WIN32_42_026: [ threadpool_timer_cancel shall call WaitForThreadpoolTimerCallbacks. ]*/
-TEST_FUNCTION(threadpool_timer_cancel_succeeds)
+/* Tests_SRS_THREADPOOL_WIN32_01_134: [ threadpool_get_statistics shall fill statistics by calling threadpool_statistics_recorder_get. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_135: [ threadpool_get_statistics shall obtain the minimum number of threads of the execution engine by calling execution_engine_win32_get_min_thread_count. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_136: [ threadpool_get_statistics shall set the idle worker count in statistics to the minimum number of threads minus the number of threads executing work items, or 0 if more threads are executing work items, and return 0. ]*/
+TEST_FUNCTION(threadpool_get_statistics_estimates_the_idle_worker_count_from_the_minimum_thread_count)
 {
     // arrange
-    THREADPOOL_HANDLE threadpool;
-    PTP_TIMER_CALLBACK test_timer_callback;
-    PVOID test_timer_callback_context;
-    PTP_TIMER ptp_timer;
-    TIMER_INSTANCE_HANDLE timer_instance;
-    test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool, &ptp_timer, &test_timer_callback, &test_timer_callback_context, &timer_instance);
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics(&cbe);
+    THREADPOOL_STATISTICS statistics;
+    THREADPOOL_STATISTICS recorded_statistics;
+    (void)memset(&recorded_statistics, 0, sizeof(recorded_statistics));
+    recorded_statistics.active_worker_count = 3;
 
-    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(ptp_timer, NULL, 0, 0));
-    STRICT_EXPECTED_CALL(mocked_WaitForThreadpoolTimerCallbacks(ptp_timer, TRUE));
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_get(test_statistics_recorder, &statistics))
+        .CopyOutArgumentBuffer_statistics(&recorded_statistics, sizeof(recorded_statistics));
+    STRICT_EXPECTED_CALL(execution_engine_win32_get_min_thread_count(test_execution_engine))
+        .SetReturn(8);
 
     // act
-    threadpool_timer_cancel(timer_instance);
+    int result = threadpool_get_statistics(threadpool, &statistics);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 3, statistics.active_worker_count);
+    ASSERT_ARE_EQUAL(uint32_t, 5, statistics.idle_worker_count);
 
     // cleanup
-    threadpool_timer_destroy(timer_instance);
     threadpool_destroy(threadpool);
 }
 
-/* threadpool_timer_destroy */
-
-/* Tests_SRS_THREADPOOL_WIN32_42_011: [ If timer is NULL, threadpool_timer_destroy shall fail and return. ]*/
-TEST_FUNCTION(threadpool_timer_destroy_with_NULL_timer_fails)
+/* Tests_SRS_THREADPOOL_WIN32_01_136: [ threadpool_get_statistics shall set the idle worker count in statistics to the minimum number of threads minus the number of threads executing work items, or 0 if more threads are executing work items, and return 0. ]*/
+TEST_FUNCTION(threadpool_get_statistics_with_more_active_workers_than_the_minimum_thread_count_reports_0_idle_workers)
 {
     // arrange
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics(&cbe);
+    THREADPOOL_STATISTICS statistics;
+    THREADPOOL_STATISTICS recorded_statistics;
+    (void)memset(&recorded_statistics, 0, sizeof(recorded_statistics));
+    recorded_statistics.active_worker_count = 10;
+
+    STRICT_EXPECTED_CALL(threadpool_statistics_recorder_get(test_statistics_recorder, &statistics))
+        .CopyOutArgumentBuffer_statistics(&recorded_statistics, sizeof(recorded_statistics));
+    STRICT_EXPECTED_CALL(execution_engine_win32_get_min_thread_count(test_execution_engine))
+        .SetReturn(4);
 
     // act
-    threadpool_timer_destroy(NULL);
+    int result = threadpool_get_statistics(threadpool, &statistics);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint32_t, 10, statistics.active_worker_count);
+    ASSERT_ARE_EQUAL(uint32_t, 0, statistics.idle_worker_count);
+
+    // cleanup
+    threadpool_destroy(threadpool);
 }
 
-/* Tests_SRS_THREADPOOL_WIN32_42_012: [ threadpool_timer_destroy shall call SetThreadpoolTimer with NULL for pftDueTime and 0 for msPeriod and msWindowLength to cancel ongoing timers. ]*/
-/* Tests_SRS_THREADPOOL_WIN32_42_013: [ threadpool_timer_destroy shall call WaitForThreadpoolTimerCallbacks. ]*/
-/* Tests_SRS_THREADPOOL_WIN32_42_014: [ threadpool_timer_destroy shall call CloseThreadpoolTimer. ]*/
-/* Tests_SRS_THREADPOOL_WIN32_42_015: [ threadpool_timer_destroy shall free all resources in timer. ]*/
-TEST_FUNCTION(threadpool_timer_destroy_succeeds)
+/* threadpool_timer_get_statistics */
+
+/* Tests_SRS_THREADPOOL_WIN32_01_137: [ If timer is NULL, threadpool_timer_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_get_statistics_with_NULL_timer_fails)
 {
     // arrange
-    THREADPOOL_HANDLE threadpool;
-    PTP_TIMER_CALLBACK test_timer_callback;
-    PVOID test_timer_callback_context;
-    PTP_TIMER ptp_timer;
-    TIMER_INSTANCE_HANDLE timer_instance;
-    test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool, &ptp_timer, &test_timer_callback, &test_timer_callback_context, &timer_instance);
-
-    STRICT_EXPECTED_CALL(mocked_SetThreadpoolTimer(ptp_timer, NULL, 0, 0));
-    STRICT_EXPECTED_CALL(mocked_WaitForThreadpoolTimerCallbacks(ptp_timer, TRUE));
-    STRICT_EXPECTED_CALL(mocked_CloseThreadpoolTimer(ptp_timer));
-    STRICT_EXPECTED_CALL(free(IGNORED_ARG));
+    THREADPOOL_TIMER_STATISTICS statistics;
 
     // act
-    threadpool_timer_destroy(timer_instance);
+    int result = threadpool_timer_get_statistics(NULL, &statistics);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
-
-    // cleanup
-    threadpool_destroy(threadpool);
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 }
 
-/* on_timer_callback */
-
-/* Tests_SRS_THREADPOOL_WIN32_42_016: [ If context is NULL, on_work_callback shall return. ]*/
-TEST_FUNCTION(on_timer_callback_with_NULL_context_returns)
+/* Tests_SRS_THREADPOOL_WIN32_01_138: [ If statistics is NULL, threadpool_timer_get_statistics shall fail and return a non-zero value. ]*/
+TEST_FUNCTION(threadpool_timer_get_statistics_with_NULL_statistics_fails)
 {
     // arrange
     THREADPOOL_HANDLE threadpool;
@@ -1335,44 +3651,46 @@ TEST_FUNCTION(on_timer_callback_with_NULL_context_returns)
     test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool, &ptp_timer, &test_timer_callback, &test_timer_callback_context, &timer_instance);
 
     // act
-    test_timer_callback(NULL, NULL, ptp_timer);
+    int result = threadpool_timer_get_statistics(timer_instance, NULL);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_NOT_EQUAL(int, 0, result);
 
     // cleanup
     threadpool_timer_destroy(timer_instance);
     threadpool_destroy(threadpool);
 }
 
-/* Tests_SRS_THREADPOOL_WIN32_42_017: [ Otherwise context shall be used as the context created in threadpool_schedule_work. ]*/
-/* Tests_SRS_THREADPOOL_WIN32_42_018: [ The work_function callback passed to threadpool_schedule_work shall be called, passing to it the work_function_context argument passed to threadpool_schedule_work. ]*/
-TEST_FUNCTION(on_timer_callback_calls_user_callback)
+/* Tests_SRS_THREADPOOL_WIN32_01_139: [ If the lateness of timer is recorded, threadpool_timer_get_statistics shall fill statistics by calling threadpool_timer_lateness_get. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_141: [ threadpool_timer_get_statistics shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_timer_get_statistics_fills_the_lateness_of_the_timer)
 {
     // arrange
-    THREADPOOL_HANDLE threadpool;
-    PTP_TIMER_CALLBACK test_timer_callback;
-    PVOID test_timer_callback_context;
-    PTP_TIMER ptp_timer;
+    PTP_CALLBACK_ENVIRON cbe;
+    THREADPOOL_HANDLE threadpool = test_create_and_open_threadpool_with_statistics(&cbe);
     TIMER_INSTANCE_HANDLE timer_instance;
-    test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool, &ptp_timer, &test_timer_callback, &test_timer_callback_context, &timer_instance);
+    THREADPOOL_TIMER_STATISTICS statistics;
+    ASSERT_ARE_EQUAL(int, 0, threadpool_timer_start(threadpool, 42, 2000, test_work_function, (void*)0x4243, &timer_instance));
+    umock_c_reset_all_calls();
 
-    STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
+    STRICT_EXPECTED_CALL(threadpool_timer_lateness_get(IGNORED_ARG, &statistics));
 
     // act
-    test_timer_callback(NULL, test_timer_callback_context, ptp_timer);
+    int result = threadpool_timer_get_statistics(timer_instance, &statistics);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
 
     // cleanup
     threadpool_timer_destroy(timer_instance);
     threadpool_destroy(threadpool);
 }
 
-/* Tests_SRS_THREADPOOL_WIN32_42_017: [ Otherwise context shall be used as the context created in threadpool_schedule_work. ]*/
-/* Tests_SRS_THREADPOOL_WIN32_42_018: [ The work_function callback passed to threadpool_schedule_work shall be called, passing to it the work_function_context argument passed to threadpool_schedule_work. ]*/
-TEST_FUNCTION(on_timer_callback_calls_user_callback_multiple_times_as_timer_fires)
+/* Tests_SRS_THREADPOOL_WIN32_01_140: [ Otherwise threadpool_timer_get_statistics shall fill statistics with an empty histogram. ]*/
+/* Tests_SRS_THREADPOOL_WIN32_01_141: [ threadpool_timer_get_statistics shall succeed and return 0. ]*/
+TEST_FUNCTION(threadpool_timer_get_statistics_of_a_timer_started_without_statistics_returns_an_empty_histogram)
 {
     // arrange
     THREADPOOL_HANDLE threadpool;
@@ -1380,23 +3698,18 @@ TEST_FUNCTION(on_timer_callback_calls_user_callback_multiple_times_as_timer_fire
     PVOID test_timer_callback_context;
     PTP_TIMER ptp_timer;
     TIMER_INSTANCE_HANDLE timer_instance;
+    THREADPOOL_TIMER_STATISTICS statistics;
     test_create_threadpool_and_start_timer(42, 2000, (void*)0x4243, &threadpool, &ptp_timer, &test_timer_callback, &test_timer_callback_context, &timer_instance);
-
-    uint32_t timer_fire_count = 10;
-
-    for (uint32_t i = 0; i < timer_fire_count; i++)
-    {
-        STRICT_EXPECTED_CALL(test_work_function((void*)0x4243));
-    }
+    (void)memset(&statistics, 0x42, sizeof(statistics));
 
     // act
-    for (uint32_t i = 0; i < timer_fire_count; i++)
-    {
-        test_timer_callback(NULL, test_timer_callback_context, ptp_timer);
-    }
+    int result = threadpool_timer_get_statistics(timer_instance, &statistics);
 
     // assert
     ASSERT_ARE_EQUAL(char_ptr, umock_c_get_expected_calls(), umock_c_get_actual_calls());
+    ASSERT_ARE_EQUAL(int, 0, result);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.lateness.sample_count);
+    ASSERT_ARE_EQUAL(uint64_t, 0, statistics.lateness.max_us);
 
     // cleanup
     threadpool_timer_destroy(timer_instance);